@@ -24,6 +24,7 @@ using namespace yarp::sig;
 #include <iCub/iKin/iKinInv.h>
 #include <iCub/iKin/iKinIpOpt.h>
 #include <iCub/iKin/iKinSlv.h>
+#include <iCub/iKin/iKinBatch.h>
 
 // ctrlLib
 #include <iCub/ctrl/adaptWinPolyEstimator.h>
@@ -68,12 +69,145 @@ using namespace yarp::sig;
 
 %include <std_vector.i>
 
+#ifdef SWIGPYTHON
+%{
+#include <cstring>
+
+// true if the buffer holds native doubles
+static bool icub_isDoubleBuffer(const Py_buffer &view)
+{
+    if (view.itemsize!=sizeof(double))
+        return false;
+
+    const char *f=(view.format!=NULL)?view.format:"B";
+    if ((f[0]=='@') || (f[0]=='=') || (f[0]=='<'))
+        f++;
+
+    return (strcmp(f,"d")==0);
+}
+
+// true if obj exports a C-contiguous buffer of doubles with a suitable
+// number of dimensions, so that overloads taking vectors and matrices
+// can be told apart
+static bool icub_checkBuffer(PyObject *obj, const bool isMatrix)
+{
+    if (!PyObject_CheckBuffer(obj))
+        return false;
+
+    Py_buffer view;
+    if (PyObject_GetBuffer(obj,&view,PyBUF_C_CONTIGUOUS|PyBUF_FORMAT)!=0)
+    {
+        PyErr_Clear();
+        return false;
+    }
+
+    bool ok=icub_isDoubleBuffer(view) && (isMatrix?(view.ndim==2):(view.ndim<=1));
+    PyBuffer_Release(&view);
+    return ok;
+}
+
+// a writable memoryview onto the storage of a vector or a matrix;
+// NULL storage (empty objects) is given as an empty bytearray
+static PyObject *icub_memoryView(double *data, size_t n)
+{
+    if ((data==NULL) || (n==0))
+        return PyByteArray_FromStringAndSize(NULL,0);
+
+    return PyMemoryView_FromMemory(reinterpret_cast<char*>(data),
+                                   (Py_ssize_t)(n*sizeof(double)),PyBUF_WRITE);
+}
+%}
+
+// Any C-contiguous buffer of doubles (e.g. a float64 NumPy array) is
+// accepted where a const Vector or Matrix is expected: it is copied
+// once into a temporary, since yarp objects cannot wrap foreign memory.
+// The yarp objects themselves still go through the usual conversion.
+%typemap(in) const yarp::sig::Vector & (yarp::sig::Vector temp, void *argp=0, int res=0)
+{
+    res=SWIG_ConvertPtr($input,&argp,$descriptor,0);
+    if (SWIG_IsOK(res) && (argp!=0))
+        $1=reinterpret_cast<$1_ltype>(argp);
+    else
+    {
+        Py_buffer view;
+        if (PyObject_GetBuffer($input,&view,PyBUF_C_CONTIGUOUS|PyBUF_FORMAT)!=0)
+            SWIG_exception_fail(SWIG_TypeError,"expected a yarp.Vector or a contiguous 1-D buffer of doubles");
+
+        bool ok=icub_isDoubleBuffer(view) && (view.ndim<=1);
+        if (ok)
+        {
+            temp.resize((size_t)(view.len/sizeof(double)));
+            if (view.len>0)
+                memcpy(temp.data(),view.buf,view.len);
+        }
+        PyBuffer_Release(&view);
+        if (!ok)
+            SWIG_exception_fail(SWIG_TypeError,"expected a yarp.Vector or a contiguous 1-D buffer of doubles");
+
+        $1=&temp;
+    }
+}
+
+%typemap(typecheck,precedence=SWIG_TYPECHECK_POINTER) const yarp::sig::Vector &
+{
+    void *vptr=0;
+    $1=(SWIG_IsOK(SWIG_ConvertPtr($input,&vptr,$descriptor,SWIG_POINTER_NO_NULL)) ||
+        icub_checkBuffer($input,false))?1:0;
+}
+
+%typemap(in) const yarp::sig::Matrix & (yarp::sig::Matrix temp, void *argp=0, int res=0)
+{
+    res=SWIG_ConvertPtr($input,&argp,$descriptor,0);
+    if (SWIG_IsOK(res) && (argp!=0))
+        $1=reinterpret_cast<$1_ltype>(argp);
+    else
+    {
+        Py_buffer view;
+        if (PyObject_GetBuffer($input,&view,PyBUF_C_CONTIGUOUS|PyBUF_FORMAT)!=0)
+            SWIG_exception_fail(SWIG_TypeError,"expected a yarp.Matrix or a contiguous 2-D buffer of doubles");
+
+        bool ok=icub_isDoubleBuffer(view) && (view.ndim==2);
+        if (ok)
+        {
+            temp.resize((int)view.shape[0],(int)view.shape[1]);
+            if (view.len>0)
+                memcpy(temp.data(),view.buf,view.len);
+        }
+        PyBuffer_Release(&view);
+        if (!ok)
+            SWIG_exception_fail(SWIG_TypeError,"expected a yarp.Matrix or a contiguous 2-D buffer of doubles");
+
+        $1=&temp;
+    }
+}
+
+%typemap(typecheck,precedence=SWIG_TYPECHECK_POINTER) const yarp::sig::Matrix &
+{
+    void *vptr=0;
+    $1=(SWIG_IsOK(SWIG_ConvertPtr($input,&vptr,$descriptor,SWIG_POINTER_NO_NULL)) ||
+        icub_checkBuffer($input,true))?1:0;
+}
+
+%inline %{
+PyObject *_vectorView(yarp::sig::Vector &v)
+{
+    return icub_memoryView(v.data(),v.size());
+}
+
+PyObject *_matrixView(yarp::sig::Matrix &m)
+{
+    return icub_memoryView(m.data(),(size_t)m.rows()*m.cols());
+}
+%}
+#endif
+
 // iKin
 %include <iCub/iKin/iKinFwd.h>
 %include <iCub/iKin/iKinHlp.h>
 %include <iCub/iKin/iKinInv.h>
 %include <iCub/iKin/iKinIpOpt.h>
 %include <iCub/iKin/iKinSlv.h>
+%include <iCub/iKin/iKinBatch.h>
 
 // ctrlLib
 %include <iCub/ctrl/adaptWinPolyEstimator.h>
@@ -166,6 +300,87 @@ typedef yarp::os::BufferedPort<iCub::skinDynLib::dynContactList> BufferedPortDyn
 
 %template(dequeIControlLimitsPtr) std::deque<yarp::dev::IControlLimits*>;
 
+#ifdef SWIGPYTHON
+%pythoncode %{
+_NumPyView = None
+
+def asarray(obj):
+    """
+    Returns a float64 NumPy array sharing the memory of a yarp.Vector
+    (1-D) or of a yarp.Matrix (2-D, row-major): nothing is copied and
+    writing the array writes the object. The array keeps obj alive, but
+    it is no longer valid once obj is resized.
+    """
+    global _NumPyView
+    import numpy
+    if _NumPyView is None:
+        class _View(numpy.ndarray):
+            pass
+        _NumPyView = _View
+
+    if hasattr(obj, 'rows') and hasattr(obj, 'cols'):
+        shape = (obj.rows(), obj.cols())
+        buf = _matrixView(obj)
+    else:
+        shape = (obj.size(),)
+        buf = _vectorView(obj)
+
+    if len(buf) == 0:
+        return numpy.zeros(shape)
+
+    a = numpy.frombuffer(buf, dtype=numpy.float64).reshape(shape).view(_NumPyView)
+    a.owner = obj
+    return a
+
+
+def _batchOf(chain):
+    if hasattr(chain, 'asChain'):
+        chain = chain.asChain()
+    return iKinBatchFwd(chain)
+
+
+def endEffPoses(chain, Q, axisRep=True, nThreads=1):
+    """
+    Forward kinematics of chain (an iKinChain or an iKinLimb) for the
+    MxDOF joint configurations Q [rad], which can be a NumPy array.
+    Returns the Mx7 (axis/angle) or Mx6 (Euler angles) poses as an
+    array viewing the output of iKinBatchFwd.
+    """
+    import yarp
+    poses = yarp.Matrix()
+    if not _batchOf(chain).computeEndEffPoses(Q, poses, axisRep, nThreads):
+        raise ValueError('Q must have as many columns as the DOF of the chain')
+    return asarray(poses)
+
+
+def geoJacobians(chain, Q, nThreads=1):
+    """
+    Geometric Jacobians of chain for the MxDOF joint configurations Q
+    [rad]. Returns an Mx6xDOF array viewing the output of iKinBatchFwd.
+    """
+    import yarp
+    b = _batchOf(chain)
+    jacobians = yarp.Matrix()
+    if not b.computeGeoJacobians(Q, jacobians, nThreads):
+        raise ValueError('Q must have as many columns as the DOF of the chain')
+    return asarray(jacobians).reshape(-1, 6, b.getDOF())
+
+
+def computeBatch(chain, Q, axisRep=True, nThreads=1):
+    """
+    Poses and Jacobians in one pass: returns the tuple of the arrays
+    given by endEffPoses() and geoJacobians().
+    """
+    import yarp
+    b = _batchOf(chain)
+    poses = yarp.Matrix()
+    jacobians = yarp.Matrix()
+    if not b.compute(Q, poses, jacobians, axisRep, nThreads):
+        raise ValueError('Q must have as many columns as the DOF of the chain')
+    return asarray(poses), asarray(jacobians).reshape(-1, 6, b.getDOF())
+%}
+#endif
+
 bool init();
 
 %{
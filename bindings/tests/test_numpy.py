@@ -0,0 +1,53 @@
+#!/usr/bin/python
+
+# Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+# All rights reserved.
+# This software may be modified and distributed under the terms of the
+# BSD-3-Clause license. See the accompanying LICENSE file for details.
+
+import sys
+
+import yarp
+
+import icub
+
+try:
+    import numpy
+except ImportError:
+    print('numpy not available, skipping')
+    sys.exit(0)
+
+yarp.Network.init()
+icub.init()
+
+# the views share the memory of the yarp objects
+v = yarp.Vector(3, 0.0)
+a = icub.asarray(v)
+a[1] = 2.0
+assert v[1] == 2.0
+
+m = yarp.Matrix(2, 3)
+m.zero()
+b = icub.asarray(m)
+b[1, 2] = 5.0
+assert b.shape == (2, 3) and m[1, 2] == 5.0
+
+# the batch entry points against the single evaluations
+arm = icub.iCubArm('left')
+chain = arm.asChain()
+dof = chain.getDOF()
+
+Q = numpy.random.uniform(-0.3, 0.3, (10, dof))
+poses, jacobians = icub.computeBatch(arm, Q, True, 2)
+assert poses.shape == (10, 7) and jacobians.shape == (10, 6, dof)
+
+for i in range(Q.shape[0]):
+    # numpy rows go in where a yarp.Vector is expected
+    chain.setAng(Q[i])
+    x = icub.asarray(chain.EndEffPose())
+    J = icub.asarray(chain.GeoJacobian())
+    assert numpy.allclose(x, poses[i])
+    assert numpy.allclose(J, jacobians[i])
+
+assert numpy.allclose(icub.endEffPoses(chain, Q), poses)
+assert numpy.allclose(icub.geoJacobians(chain, Q), jacobians)
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD-3-Clause license. See the accompanying LICENSE file for
+ * details.
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <yarp/sig/Vector.h>
+#include <yarp/sig/Matrix.h>
+#include <yarp/math/Math.h>
+#include <iCub/ctrl/math.h>
+#include <iCub/ctrl/fixedSizeMath.h>
+
+#include "benchmarks.h"
+
+using namespace yarp::sig;
+using namespace yarp::math;
+using namespace iCub::ctrl;
+
+namespace
+{
+    // the same rotation and transformation for both representations
+    Vector axisAngle()
+    {
+        Vector v(4);
+        v[0]=0.267; v[1]=0.535; v[2]=0.802; v[3]=0.7;
+        return v;
+    }
+
+    Matrix transformation()
+    {
+        Matrix H=axis2dcm(axisAngle());
+        H(0,3)=0.1; H(1,3)=-0.2; H(2,3)=0.3;
+        return H;
+    }
+
+    void benchYarpAxis2dcm(benchmark::State &state)
+    {
+        Vector v=axisAngle();
+        for (auto _ : state)
+            benchmark::DoNotOptimize(axis2dcm(v));
+    }
+
+    void benchFixedAxis2dcm(benchmark::State &state)
+    {
+        Vector4 v;
+        fromYarp(axisAngle(),v);
+        for (auto _ : state)
+            benchmark::DoNotOptimize(axis2dcm(v));
+    }
+
+    void benchYarpDcm2axis(benchmark::State &state)
+    {
+        Matrix H=transformation();
+        for (auto _ : state)
+            benchmark::DoNotOptimize(dcm2axis(H));
+    }
+
+    void benchFixedDcm2axis(benchmark::State &state)
+    {
+        Matrix4 H;
+        fromYarp(transformation(),H);
+        for (auto _ : state)
+            benchmark::DoNotOptimize(dcm2axis(H));
+    }
+
+    void benchYarpSE3inv(benchmark::State &state)
+    {
+        Matrix H=transformation();
+        for (auto _ : state)
+            benchmark::DoNotOptimize(SE3inv(H));
+    }
+
+    void benchFixedSE3inv(benchmark::State &state)
+    {
+        Matrix4 H;
+        fromYarp(transformation(),H);
+        for (auto _ : state)
+            benchmark::DoNotOptimize(SE3inv(H));
+    }
+
+    void benchYarpAdjoint(benchmark::State &state)
+    {
+        Matrix H=transformation();
+        for (auto _ : state)
+            benchmark::DoNotOptimize(adjoint(H));
+    }
+
+    void benchFixedAdjoint(benchmark::State &state)
+    {
+        Matrix4 H;
+        fromYarp(transformation(),H);
+        for (auto _ : state)
+            benchmark::DoNotOptimize(adjoint(H));
+    }
+
+    // the typical composition of the forward kinematics
+    void benchYarpChain(benchmark::State &state)
+    {
+        Matrix H=transformation();
+        for (auto _ : state)
+            benchmark::DoNotOptimize(H*H*H*H*H*H*H);
+    }
+
+    void benchFixedChain(benchmark::State &state)
+    {
+        Matrix4 H;
+        fromYarp(transformation(),H);
+        for (auto _ : state)
+            benchmark::DoNotOptimize(H*H*H*H*H*H*H);
+    }
+}
+
+
+void registerCtrlMathBenchmarks()
+{
+    benchmark::RegisterBenchmark("yarp::math/axis2dcm",benchYarpAxis2dcm);
+    benchmark::RegisterBenchmark("FixedSizeMath/axis2dcm",benchFixedAxis2dcm);
+    benchmark::RegisterBenchmark("yarp::math/dcm2axis",benchYarpDcm2axis);
+    benchmark::RegisterBenchmark("FixedSizeMath/dcm2axis",benchFixedDcm2axis);
+    benchmark::RegisterBenchmark("yarp::math/SE3inv",benchYarpSE3inv);
+    benchmark::RegisterBenchmark("FixedSizeMath/SE3inv",benchFixedSE3inv);
+    benchmark::RegisterBenchmark("yarp::math/adjoint",benchYarpAdjoint);
+    benchmark::RegisterBenchmark("FixedSizeMath/adjoint",benchFixedAdjoint);
+    benchmark::RegisterBenchmark("yarp::math/chain",benchYarpChain);
+    benchmark::RegisterBenchmark("FixedSizeMath/chain",benchFixedChain);
+}
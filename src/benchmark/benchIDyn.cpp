@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD-3-Clause license. See the accompanying LICENSE file for
+ * details.
+*/
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <yarp/sig/Vector.h>
+#include <iCub/iDyn/iDyn.h>
+#include <iCub/iDyn/iDynBody.h>
+#include <iCub/skinDynLib/common.h>
+
+#include "benchmarks.h"
+
+using namespace std;
+using namespace yarp::sig;
+using namespace iCub::iDyn;
+using namespace iCub::skinDynLib;
+
+namespace
+{
+    // the base at rest with gravity along -z
+    Vector gravityAcc()
+    {
+        Vector ddp0(3,0.0);
+        ddp0[2]=9.81;
+        return ddp0;
+    }
+
+    // a moving configuration within the joints bounds
+    void setMotion(iDynChain &chain, const double alpha)
+    {
+        chain.setAng(benchmarkConfiguration(chain,alpha));
+        chain.setDAng(Vector(chain.getDOF(),0.5));
+        chain.setD2Ang(Vector(chain.getDOF(),0.2));
+    }
+
+    template<class Limb>
+    void benchNewtonEuler(benchmark::State &state, const string &type)
+    {
+        Limb limb(type);
+        setMotion(limb,0.3);
+
+        Vector w0(3,0.0), dw0(3,0.0), ddp0=gravityAcc();
+        Vector Fend(3,0.0), Muend(3,0.0);
+        for (auto _ : state)
+            benchmark::DoNotOptimize(limb.computeNewtonEuler(w0,dw0,ddp0,Fend,Muend));
+    }
+
+    void benchWholeBodySolve(benchmark::State &state, const version_tag &tag)
+    {
+        iCubWholeBody icub(tag,DYNAMIC,NO_VERBOSE);
+        icub.setNumThreads((unsigned int)state.range(0));
+
+        iDynLimb *limbs[]={ icub.upperTorso->up, icub.upperTorso->left, icub.upperTorso->right,
+                            icub.lowerTorso->up, icub.lowerTorso->left, icub.lowerTorso->right };
+        for (iDynLimb *limb : limbs)
+            setMotion(*limb,0.3);
+
+        Vector w0(3,0.0), dw0(3,0.0), ddp0=gravityAcc();
+        Vector FM_zero(6,0.0);
+        for (auto _ : state)
+        {
+            icub.upperTorso->setInertialMeasure(w0,dw0,ddp0);
+            icub.upperTorso->setSensorMeasurement(FM_zero,FM_zero,FM_zero);
+            benchmark::DoNotOptimize(icub.solve(FM_zero,FM_zero));
+        }
+    }
+
+    version_tag makeTag(const int head_version, const int head_subversion,
+                        const int legs_version)
+    {
+        version_tag tag;
+        tag.head_version=head_version;
+        tag.head_subversion=head_subversion;
+        tag.legs_version=legs_version;
+        return tag;
+    }
+}
+
+
+void registerIDynBenchmarks()
+{
+    for (const char *type : { "left", "right" })
+    {
+        benchmark::RegisterBenchmark((string("iCubArmDyn/computeNewtonEuler/")+type).c_str(),
+                                     benchNewtonEuler<iCubArmDyn>,string(type));
+        benchmark::RegisterBenchmark((string("iCubLegDyn/computeNewtonEuler/")+type).c_str(),
+                                     benchNewtonEuler<iCubLegDyn>,string(type));
+        benchmark::RegisterBenchmark((string("iCubLegDynV2/computeNewtonEuler/")+type).c_str(),
+                                     benchNewtonEuler<iCubLegDynV2>,string(type));
+    }
+
+    benchmark::RegisterBenchmark("iCubWholeBody/solve/head_v1_legs_v1",
+                                 benchWholeBodySolve,makeTag(1,0,1))
+                                 ->ArgName("threads")->Arg(1)->Arg(2)->UseRealTime()
+                                 ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("iCubWholeBody/solve/head_v2.7_legs_v2",
+                                 benchWholeBodySolve,makeTag(2,7,2))
+                                 ->ArgName("threads")->Arg(1)->Arg(2)->UseRealTime()
+                                 ->Unit(benchmark::kMicrosecond);
+}
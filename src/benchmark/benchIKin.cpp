@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD-3-Clause license. See the accompanying LICENSE file for
+ * details.
+*/
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include <yarp/sig/Vector.h>
+#include <iCub/iKin/iKinFwd.h>
+#ifdef ICUB_BENCHMARK_IPOPT
+    #include <iCub/iKin/iKinIpOpt.h>
+#endif
+
+#include "benchmarks.h"
+
+using namespace std;
+using namespace yarp::sig;
+using namespace iCub::iKin;
+
+namespace
+{
+    // v1, v2 and v3 kinematics of the limbs
+    const char *versions[]={ "", "_v2", "_v3" };
+
+    template<class Limb>
+    void benchEndEffPose(benchmark::State &state, const string &type)
+    {
+        Limb limb(type);
+        iKinChain &chain=*limb.asChain();
+        chain.setAng(benchmarkConfiguration(chain,0.3));
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(chain.EndEffPose());
+    }
+
+    template<class Limb>
+    void benchGeoJacobian(benchmark::State &state, const string &type)
+    {
+        Limb limb(type);
+        iKinChain &chain=*limb.asChain();
+        chain.setAng(benchmarkConfiguration(chain,0.3));
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(chain.GeoJacobian());
+    }
+
+#ifdef ICUB_BENCHMARK_IPOPT
+    void benchIpOptSolve(benchmark::State &state, const string &type)
+    {
+        iCubArm arm(type);
+        iKinChain &chain=*arm.asChain();
+
+        // the target is a reachable full pose, solved from a
+        // configuration far from it
+        chain.setAng(benchmarkConfiguration(chain,0.3));
+        Vector xd=chain.EndEffPose();
+        Vector q0=benchmarkConfiguration(chain,0.5);
+
+        iKinIpOptMin slv(chain,IKINCTRL_POSE_FULL,1e-3,1e-6,150);
+        for (auto _ : state)
+            benchmark::DoNotOptimize(slv.solve(q0,xd));
+    }
+#endif
+
+    template<class Limb>
+    void registerLimb(const string &className, const string &side)
+    {
+        for (const char *v : versions)
+        {
+            string type=side+v;
+            benchmark::RegisterBenchmark((className+"/EndEffPose/"+type).c_str(),
+                                         benchEndEffPose<Limb>,type);
+            benchmark::RegisterBenchmark((className+"/GeoJacobian/"+type).c_str(),
+                                         benchGeoJacobian<Limb>,type);
+        }
+    }
+}
+
+
+void registerIKinBenchmarks()
+{
+    registerLimb<iCubArm>("iCubArm","left");
+    registerLimb<iCubLeg>("iCubLeg","left");
+
+#ifdef ICUB_BENCHMARK_IPOPT
+    for (const char *v : versions)
+    {
+        string type=string("left")+v;
+        benchmark::RegisterBenchmark(("iKinIpOptMin/solve/"+type).c_str(),
+                                     benchIpOptSolve,type)->Unit(benchmark::kMicrosecond);
+    }
+#endif
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD-3-Clause license. See the accompanying LICENSE file for
+ * details.
+*/
+
+#include <cmath>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <yarp/sig/Vector.h>
+#include <yarp/sig/Matrix.h>
+#include <yarp/math/Math.h>
+#include <iCub/learningMachine/RLSLearner.h>
+#include <iCub/learningMachine/Math.h>
+
+#include "benchmarks.h"
+
+using namespace yarp::sig;
+using namespace yarp::math;
+using namespace iCub::learningmachine;
+
+namespace
+{
+    // the update of RLSLearner before the incremental one: rank 1 update
+    // of the Cholesky factor, then a full solve for all the outputs
+    class PreviousRLS
+    {
+        Matrix R;
+        Matrix B;
+        Matrix W;
+
+    public:
+        PreviousRLS(unsigned int dom, unsigned int cod, double lambda) :
+            R(eye(dom,dom)*sqrt(lambda)), B(zeros(cod,dom)), W(zeros(cod,dom)) { }
+
+        void feedSample(const Vector &input, const Vector &output)
+        {
+            math::cholupdate(R,input);
+            B=B+math::outerprod(output,input);
+            math::cholsolve(R,B,W);
+        }
+
+        Vector predict(const Vector &input) const { return W*input; }
+    };
+
+    // the same pseudo-random samples for both paths
+    struct Samples
+    {
+        static const size_t count=256;
+        std::vector<Vector> inputs;
+        std::vector<Vector> outputs;
+
+        Samples(unsigned int dom, unsigned int cod)
+        {
+            unsigned int seed=12345;
+            auto next=[&seed]() {
+                seed=seed*1103515245U+12345U;
+                return (double)((seed>>8)&0xffff)/65536.0-0.5;
+            };
+
+            for (size_t i=0; i<count; i++)
+            {
+                Vector x(dom), y(cod);
+                for (unsigned int j=0; j<dom; j++)
+                    x[j]=next();
+                for (unsigned int j=0; j<cod; j++)
+                    y[j]=next();
+                inputs.push_back(x);
+                outputs.push_back(y);
+            }
+        }
+    };
+
+    template<class Learner>
+    void benchFeedSample(benchmark::State &state)
+    {
+        unsigned int dom=(unsigned int)state.range(0);
+        unsigned int cod=(unsigned int)state.range(1);
+        Samples samples(dom,cod);
+        Learner learner(dom,cod,1.0);
+
+        size_t i=0;
+        for (auto _ : state)
+        {
+            learner.feedSample(samples.inputs[i],samples.outputs[i]);
+            i=(i+1)%Samples::count;
+        }
+    }
+
+    template<class Learner>
+    void benchPredict(benchmark::State &state)
+    {
+        unsigned int dom=(unsigned int)state.range(0);
+        unsigned int cod=(unsigned int)state.range(1);
+        Samples samples(dom,cod);
+        Learner learner(dom,cod,1.0);
+        for (size_t i=0; i<Samples::count; i++)
+            learner.feedSample(samples.inputs[i],samples.outputs[i]);
+
+        size_t i=0;
+        for (auto _ : state)
+        {
+            benchmark::DoNotOptimize(learner.predict(samples.inputs[i]));
+            i=(i+1)%Samples::count;
+        }
+    }
+
+    void sizes(benchmark::internal::Benchmark *b)
+    {
+        b->ArgNames({"dom","cod"});
+        for (int dom : {100, 500})
+            for (int cod : {1, 10})
+                b->Args({dom,cod});
+    }
+}
+
+
+void registerLearningMachineBenchmarks()
+{
+    benchmark::RegisterBenchmark("RLSLearner/feedSample",benchFeedSample<RLSLearner>)->Apply(sizes);
+    benchmark::RegisterBenchmark("RLSLearnerPrevious/feedSample",benchFeedSample<PreviousRLS>)->Apply(sizes);
+    benchmark::RegisterBenchmark("RLSLearner/predict",benchPredict<RLSLearner>)->Apply(sizes);
+    benchmark::RegisterBenchmark("RLSLearnerPrevious/predict",benchPredict<PreviousRLS>)->Apply(sizes);
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD-3-Clause license. See the accompanying LICENSE file for
+ * details.
+*/
+
+#ifndef __ICUB_BENCHMARKS_H__
+#define __ICUB_BENCHMARKS_H__
+
+#include <yarp/sig/Vector.h>
+#include <iCub/iKin/iKinFwd.h>
+
+/**
+* Registers the benchmarks of the iKin library.
+*/
+void registerIKinBenchmarks();
+
+/**
+* Registers the benchmarks of the iDyn library.
+*/
+void registerIDynBenchmarks();
+
+/**
+* Registers the benchmarks of the fixed-size maths of ctrlLib
+* against their yarp::math counterparts.
+*/
+void registerCtrlMathBenchmarks();
+
+/**
+* Registers the benchmarks of RLSLearner against its previous
+* update rule (only if learningMachine is built).
+*/
+void registerLearningMachineBenchmarks();
+
+/**
+* Returns a configuration within the joints bounds of a chain,
+* away from singularities: each joint is placed at the fraction
+* alpha of its range.
+* @param chain is the chain.
+* @param alpha is the fraction of the range in [0,1].
+* @return the joints configuration [rad].
+*/
+inline yarp::sig::Vector benchmarkConfiguration(iCub::iKin::iKinChain &chain,
+                                                const double alpha)
+{
+    yarp::sig::Vector q(chain.getDOF());
+    for (unsigned int i=0; i<chain.getDOF(); i++)
+        q[i]=chain(i).getMin()+alpha*(chain(i).getMax()-chain(i).getMin());
+    return q;
+}
+
+#endif
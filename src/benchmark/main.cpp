@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD-3-Clause license. See the accompanying LICENSE file for
+ * details.
+*/
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+
+#include <benchmark/benchmark.h>
+
+#include "benchmarks.h"
+
+#ifndef ICUB_BENCHMARK_VERSION
+    #define ICUB_BENCHMARK_VERSION  "unknown"
+#endif
+
+namespace
+{
+    // the global operator new is replaced to count the allocations
+    // performed while the memory manager is recording
+    std::atomic<bool>    recording(false);
+    std::atomic<int64_t> numAllocs(0);
+    std::atomic<int64_t> bytesUsed(0);
+    std::atomic<int64_t> maxBytesUsed(0);
+    std::atomic<int64_t> totalBytes(0);
+
+    // the size is stored ahead of each block to keep track of the heap
+    // usage; the header is large enough to preserve the alignment
+    const size_t header=alignof(std::max_align_t);
+
+    void *allocate(size_t size)
+    {
+        void *p=std::malloc(size+header);
+        if (p==nullptr)
+            throw std::bad_alloc();
+
+        *static_cast<size_t*>(p)=size;
+        if (recording.load(std::memory_order_relaxed))
+        {
+            numAllocs++;
+            totalBytes+=size;
+            int64_t used=(bytesUsed+=size);
+            int64_t max=maxBytesUsed.load();
+            while ((used>max) && !maxBytesUsed.compare_exchange_weak(max,used));
+        }
+
+        return static_cast<char*>(p)+header;
+    }
+
+    void deallocate(void *ptr)
+    {
+        if (ptr==nullptr)
+            return;
+
+        void *p=static_cast<char*>(ptr)-header;
+        if (recording.load(std::memory_order_relaxed))
+            bytesUsed-=*static_cast<size_t*>(p);
+
+        std::free(p);
+    }
+
+    class AllocationCounter : public benchmark::MemoryManager
+    {
+    public:
+        void Start() override
+        {
+            numAllocs=0;
+            bytesUsed=0;
+            maxBytesUsed=0;
+            totalBytes=0;
+            recording=true;
+        }
+
+        void Stop(Result &result) override
+        {
+            recording=false;
+            result.num_allocs=numAllocs;
+            result.max_bytes_used=maxBytesUsed;
+            result.total_allocated_bytes=totalBytes;
+            result.net_heap_growth=bytesUsed;
+        }
+    };
+}
+
+void *operator new(size_t size)                                    { return allocate(size); }
+void *operator new[](size_t size)                                  { return allocate(size); }
+void *operator new(size_t size, const std::nothrow_t&) noexcept    { try { return allocate(size); } catch (...) { return nullptr; } }
+void *operator new[](size_t size, const std::nothrow_t&) noexcept  { try { return allocate(size); } catch (...) { return nullptr; } }
+void operator delete(void *ptr) noexcept                           { deallocate(ptr); }
+void operator delete[](void *ptr) noexcept                         { deallocate(ptr); }
+void operator delete(void *ptr, size_t) noexcept                   { deallocate(ptr); }
+void operator delete[](void *ptr, size_t) noexcept                 { deallocate(ptr); }
+void operator delete(void *ptr, const std::nothrow_t&) noexcept    { deallocate(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t&) noexcept  { deallocate(ptr); }
+
+
+int main(int argc, char *argv[])
+{
+    AllocationCounter counter;
+    benchmark::RegisterMemoryManager(&counter);
+    benchmark::AddCustomContext("icub_version",ICUB_BENCHMARK_VERSION);
+
+    registerIKinBenchmarks();
+    registerIDynBenchmarks();
+    registerCtrlMathBenchmarks();
+#ifdef ICUB_BENCHMARK_LEARNINGMACHINE
+    registerLearningMachineBenchmarks();
+#endif
+
+    benchmark::Initialize(&argc,argv);
+    if (benchmark::ReportUnrecognizedArguments(argc,argv))
+        return 1;
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    benchmark::RegisterMemoryManager(nullptr);
+    return 0;
+}
@@ -11,6 +11,7 @@
 #include <cstdlib>
 #include <bitset>
 #include <iomanip>
+#include <algorithm>
 #include <yarp/os/ResourceFinder.h>
 #include <yarp/dev/IControlMode.h>
 #include <yarp/dev/IControlLimits.h>
@@ -82,6 +83,10 @@ void printHelp (yarp::os::Bottle& reply) {
 EmotionInterfaceModule::EmotionInterfaceModule() : emotionInitReport(this) {
 }
 
+EmotionInterfaceModule::~EmotionInterfaceModule() {
+    stopSender();
+}
+
 bool EmotionInterfaceModule::configure(ResourceFinder& config){
 
     std::string modName = config.find("name").asString();
@@ -99,6 +104,7 @@ bool EmotionInterfaceModule::configure(ResourceFinder& config){
     _mouthmaskemotions = config.check("bitmask_mouth_emotions", Value(0), "Number of predefined bitmask eyebrow expressions").asInt32();
     _auto = config.check("auto");
     _period = config.check("period", Value(10.0), "Period for expression switching in auto mode").asFloat64();
+    _separateSegments = config.check("separate_segments", "if present, send each segment of an expression in a message of its own");
     if(_highlevelemotions == 0)
     {
         _emotion_table = nullptr;
@@ -287,11 +293,17 @@ bool EmotionInterfaceModule::configure(ResourceFinder& config){
     _initEmotionTrigger=0;
     attach(_inputPort);
 
+    _quit = false;
+    _sender = std::thread(&EmotionInterfaceModule::senderLoop, this);
+
     return true;
 }
 
 bool EmotionInterfaceModule::close(){
 
+    // what is still pending is sent before the ports are closed
+    stopSender();
+
     if(_inputPort.isOpen())
         _inputPort.close();
     if(!_outputPort.isClosed())
@@ -471,15 +483,115 @@ int EmotionInterfaceModule::getIndex(const std::string cmd)
     return i;
 }
 
-//send the actual string to the port
+//queue the string for the port
 bool EmotionInterfaceModule::writePort(const char* cmd)
 {
+    if (cmd == nullptr || cmd[0] == 0)
+        return false;
+
+    std::lock_guard<std::mutex> lck(_queueMutex);
+    const char key = cmd[0];
+    auto it = std::find_if(_pending.begin(), _pending.end(),
+                           [key](const std::pair<char, std::string>& p) { return p.first == key; });
+    // superseded: the new command goes at the end, after the ones which were given after the old one
+    if (it != _pending.end())
+        _pending.erase(it);
+    _pending.emplace_back(key, cmd);
+
+    if (_expressionDepth == 0)
+        _queueCv.notify_one();
+    return true;
+}
+
+void EmotionInterfaceModule::beginExpression()
+{
+    std::lock_guard<std::mutex> lck(_queueMutex);
+    _expressionDepth++;
+}
+
+void EmotionInterfaceModule::endExpression()
+{
+    std::lock_guard<std::mutex> lck(_queueMutex);
+    _expressionDepth--;
+    if (_expressionDepth == 0)
+        _queueCv.notify_one();
+}
+
+void EmotionInterfaceModule::moveEyelids(double target)
+{
+    std::lock_guard<std::mutex> lck(_queueMutex);
+    _eyelidsTarget = target;
+    _eyelidsPending = true;
+    if (_expressionDepth == 0)
+        _queueCv.notify_one();
+}
+
+void EmotionInterfaceModule::senderLoop()
+{
+    std::vector<std::pair<char, std::string>> cmds;
+    while (true)
+    {
+        bool eyelids;
+        double target;
+        {
+            std::unique_lock<std::mutex> lck(_queueMutex);
+            _queueCv.wait(lck, [this] {
+                return _quit || (_expressionDepth == 0 && (!_pending.empty() || _eyelidsPending));
+            });
+            if (_pending.empty() && !_eyelidsPending)
+                return;
+
+            cmds.swap(_pending);
+            eyelids = _eyelidsPending;
+            target = _eyelidsTarget;
+            _eyelidsPending = false;
+        }
+
+        if (!cmds.empty())
+            sendCommands(cmds);
+        cmds.clear();
+
+        if (eyelids && _iPos && !_iPos->positionMove(_joint_eylids, target))
+            yWarning() << "Failed to move the eyelids to" << target;
+    }
+}
+
+//send the actual strings to the port
+void EmotionInterfaceModule::sendCommands(const std::vector<std::pair<char, std::string>>& cmds)
+{
+    if (_separateSegments)
+    {
+        for (const auto& cmd : cmds)
+        {
+            Bottle &btmp = _outputPort.prepare();
+            btmp.clear();
+            btmp.addString(cmd.second);
+            _outputPort.write(true);
+            Time::delay(0.001);
+        }
+        return;
+    }
+
+    // the face reads a stream of commands, one after the other, thus they can go in the same string
+    std::string msg;
+    for (const auto& cmd : cmds)
+        msg += cmd.second;
+
     Bottle &btmp = _outputPort.prepare();
     btmp.clear();
-    btmp.addString(cmd);
+    btmp.addString(msg);
     _outputPort.write(true);
-    Time::delay(0.001);
-    return true;
+}
+
+void EmotionInterfaceModule::stopSender()
+{
+    {
+        std::lock_guard<std::mutex> lck(_queueMutex);
+        _quit = true;
+    }
+    _queueCv.notify_one();
+    if (_sender.joinable())
+        _sender.join();
 }
 
 
@@ -551,8 +663,7 @@ bool EmotionInterfaceModule::setEyelids(const std::string cmd)
         return true;  //leave it in the same state
     if (_iPos)
     {
-        auto target_pos = getEyelidsTarget(_emotion_table[i].eli[0], _emotion_table[i].eli[1]);
-        res = _iPos->positionMove(_joint_eylids, target_pos);
+        moveEyelids(getEyelidsTarget(_emotion_table[i].eli[0], _emotion_table[i].eli[1]));
     }
     else
     {
@@ -567,10 +678,12 @@ bool EmotionInterfaceModule::setEyelids(const std::string cmd)
 
 bool EmotionInterfaceModule::setAll(const std::string cmd)
 {
+    beginExpression();
     setLeftEyebrow(cmd);
     setRightEyebrow(cmd);
     setMouth(cmd);
     setEyelids(cmd);
+    endExpression();
     return true;
 }
 
@@ -579,8 +692,7 @@ bool EmotionInterfaceModule::setRaw(const std::string cmd)
     bool res{ true };
     if (cmd.size() == 3 && cmd.at(0) == 'p' && _iPos)
     {
-        const auto target_pos = getEyelidsTarget(cmd[1], cmd[2]);
-        res = _iPos->positionMove(_joint_eylids, target_pos);
+        moveEyelids(getEyelidsTarget(cmd[1], cmd[2]));
     }
     else {
         res &= writePort(cmd.c_str());
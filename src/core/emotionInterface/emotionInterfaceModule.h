@@ -16,6 +16,11 @@
 #include <cstdio>
 #include <string>
 #include <iostream>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 
 // yarp
@@ -104,16 +109,34 @@ private:
     double _min{ 0.0 }, _max{ 0.0 };
     size_t _joint_eylids{ 0 };
 
-
+    // the commands for the face wait here to be sent by _sender, thus the callers never wait for the face:
+    // a command replaces the pending one of the same subsystem (its first character), and the commands
+    // of an expression are sent together, by default in a single message
+    std::mutex _queueMutex;
+    std::condition_variable _queueCv;
+    std::vector<std::pair<char, std::string>> _pending;
+    bool   _eyelidsPending{ false };
+    double _eyelidsTarget{ 0.0 };
+    int    _expressionDepth{ 0 };
+    bool   _quit{ false };
+    bool   _separateSegments{ false };
+    std::thread _sender;
 
     int getIndex(std::string cmd);
     bool writePort(const char* cmd);
     double getEyelidsTarget(const char eli0, const char eli1);
 
+    void beginExpression();
+    void endExpression();
+    void moveEyelids(double target);
+    void senderLoop();
+    void sendCommands(const std::vector<std::pair<char, std::string>>& cmds);
+    void stopSender();
+
 public:
 
     EmotionInterfaceModule();
-    ~EmotionInterfaceModule() override = default;
+    ~EmotionInterfaceModule() override;
     
     bool configure(ResourceFinder& config) override;//virtual bool open(Searchable& config);
     bool close() override;
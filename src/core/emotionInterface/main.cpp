@@ -17,6 +17,12 @@ using namespace iCub::contrib;
  *
  * Emotion interface module: commands facial expressions
  *
+ * The commands are queued and sent to the face by a thread of the module, thus
+ * the callers of the rpc port never wait for the face: a command replaces the
+ * pending one for the same part, and the parts of an expression are sent in a
+ * single message. With --separate_segments each part goes in a message of its
+ * own, for the drivers which take one command per message.
+ *
  * \author Alexandre Bernardino
  *
  * Copyright (C) 2007 Alex Bernardino 
@@ -236,6 +236,9 @@ protected:
     double latchTimerWait;
     double latchTimerReach;
     double latchTimerReachLog;
+    double overlapReachTol;
+    double overlapHandTol;
+    double reachErr;
 
     int jHandMin;
     int jHandMax;
@@ -322,6 +325,9 @@ protected:
     virtual void init();
     virtual bool execQueuedAction();
     virtual bool execPendingHandSequences();
+    virtual bool isArmInOverlap() const;
+    virtual bool isHandInOverlap();
+    virtual bool execOverlappedAction();
     virtual void run();
 
 public:
@@ -369,6 +375,15 @@ public:
     *  
     * @b reach_tol <double>: the reaching tolerance [m]. 
     *  
+    * @b overlap_reach_tol <double>: the distance [m] from the 
+    *    reaching target within which the next queued action is
+    *    started without waiting for the arm to complete; 0 (the
+    *    default) disables the overlapping.
+    *  
+    * @b overlap_hand_tol <double>: the error [deg] of the moving 
+    *    fingers joints within which the hand is considered close
+    *    enough to its way point to let the next action be started.
+    *  
     * @b tracking_mode <string>: enable/disable the tracking mode; 
     *    possible values: "on"/"off".
     * @note In tracking mode the cartesian position is mantained on 
@@ -827,6 +842,27 @@ public:
     */
     virtual bool getTrackingMode() const;
 
+    /**
+    * Set the tolerances within which the next queued action is 
+    * started while the current one is still converging, so that
+    * e.g. the hand pre-shape overlaps the end of the approach.
+    * @param reachTol the distance [m] from the reaching target; 
+    *                 0 disables the overlapping.
+    * @param handTol the error [deg] of the moving fingers joints. 
+    * @return true/false on success/failure. 
+    *  
+    * @note the actions are never overlapped across a wait, a 
+    *       way points action or an action-end callback.
+    */
+    virtual bool setOverlapTolerances(const double reachTol, const double handTol);
+
+    /**
+    * Get the current overlap tolerances.
+    * @param reachTol the distance [m] from the reaching target. 
+    * @param handTol the error [deg] of the moving fingers joints. 
+    */
+    virtual void getOverlapTolerances(double &reachTol, double &handTol) const;
+
     /**
     * Enable the waving mode that keeps on moving the arm around a 
     * predefined position. 
@@ -37,6 +37,8 @@
 #define ACTIONPRIM_DEFAULT_PER                      50      // [ms]
 #define ACTIONPRIM_DEFAULT_EXECTIME                 2.0     // [s]
 #define ACTIONPRIM_DEFAULT_REACHTOL                 0.005   // [m]
+#define ACTIONPRIM_DEFAULT_OVERLAPREACHTOL          0.0     // [m]
+#define ACTIONPRIM_DEFAULT_OVERLAPHANDTOL           5.0     // [deg]
 #define ACTIONPRIM_DUMP_PERIOD                      1.0     // [s]
 #define ACTIONPRIM_DEFAULT_PART                     "right_arm"
 #define ACTIONPRIM_DEFAULT_TRACKINGMODE             "off"
@@ -359,6 +361,8 @@ void ActionPrimitives::init()
     latchTimerReach=reachTmo=0.0;
     latchTimerHand=curHandTmo=0.0;
     latchTimerReachLog=0.0;
+    overlapReachTol=reachErr=0.0;
+    overlapHandTol=ACTIONPRIM_DEFAULT_OVERLAPHANDTOL;
 }
 
 
@@ -604,6 +608,8 @@ bool ActionPrimitives::open(Property &opt)
 
     int period=opt.check("thread_period",Value(ACTIONPRIM_DEFAULT_PER)).asInt32();    
     double reach_tol=opt.check("reach_tol",Value(ACTIONPRIM_DEFAULT_REACHTOL)).asFloat64();
+    overlapReachTol=opt.check("overlap_reach_tol",Value(ACTIONPRIM_DEFAULT_OVERLAPREACHTOL)).asFloat64();
+    overlapHandTol=opt.check("overlap_hand_tol",Value(ACTIONPRIM_DEFAULT_OVERLAPHANDTOL)).asFloat64();
 
     // create the model for grasp detection (if any)
     if (!configGraspModel(opt))
@@ -818,6 +824,7 @@ bool ActionPrimitives::isHandSeqEnded()
 void ActionPrimitives::postReachCallback()
 {
     latchArmMoveDone=armMoveDone=false;
+    reachErr=std::numeric_limits<double>::max();
 }
 
 
@@ -1268,6 +1275,70 @@ bool ActionPrimitives::execPendingHandSequences()
 }
 
 
+/************************************************************************/
+bool ActionPrimitives::isArmInOverlap() const
+{
+    return (armMoveDone || (reachErr<overlapReachTol));
+}
+
+
+/************************************************************************/
+bool ActionPrimitives::isHandInOverlap()
+{
+    if (handMoveDone)
+        return true;
+
+    for (set<int>::iterator i=fingersMovingJntsSet.begin(); i!=fingersMovingJntsSet.end(); ++i)
+    {
+        double fb;
+        if (!encCtrl->getEncoder(*i,&fb))
+            return false;
+
+        if (fabs(curHandFinalPoss[*i-jHandMin]-fb)>=std::max(overlapHandTol,curHandTols[*i-jHandMin]))
+            return false;
+    }
+
+    return true;
+}
+
+
+/************************************************************************/
+bool ActionPrimitives::execOverlappedAction()
+{
+    // the callback, the wait and the way points need the action to be over
+    if ((overlapReachTol<=0.0) || (actionClb!=NULL) || (actionWP!=NULL))
+        return false;
+
+    if (!isArmInOverlap() || !isHandInOverlap())
+        return false;
+
+    Action action;
+    {
+        lock_guard<mutex> lck(mtx);
+        if (actionsQueue.size()==0)
+            return false;
+
+        action=actionsQueue.front();
+        if (action.waitState || action.execWayPoints)
+            return false;
+
+        actionsQueue.pop_front();
+    }
+
+    printMessage(log::no_info,"overlapping the next action (|e|=%.3f [m])",reachErr);
+
+    if (action.execArm)
+        cmdArm(action);
+
+    if (action.execHand)
+        cmdHand(action);
+
+    actionClb=action.clb;
+
+    return true;
+}
+
+
 /************************************************************************/
 void ActionPrimitives::run()
 {
@@ -1278,6 +1349,7 @@ void ActionPrimitives::run()
         Vector x,o,xdhat,odhat,qdhat;
         cartCtrl->getPose(x,o);
         cartCtrl->getDesired(xdhat,odhat,qdhat);
+        reachErr=norm(xdhat-x);
 
         if ((t-latchTimerReachLog)>ACTIONPRIM_DUMP_PERIOD)
         {
@@ -1332,6 +1404,11 @@ void ActionPrimitives::run()
         }
     }
 
+    // start the next action while the current one is converging
+    if (!(armMoveDone && handMoveDone) && (t-latchTimerWait>waitTmo))
+        if (execOverlappedAction())
+            cv_motionStartEvent.notify_all();
+
     latchArmMoveDone=armMoveDone;
     latchHandMoveDone=handMoveDone;
 
@@ -1912,6 +1989,28 @@ double ActionPrimitives::getDefaultExecTime() const
 }
 
 
+/************************************************************************/
+bool ActionPrimitives::setOverlapTolerances(const double reachTol, const double handTol)
+{
+    if (configured && (reachTol>=0.0) && (handTol>=0.0))
+    {
+        overlapReachTol=reachTol;
+        overlapHandTol=handTol;
+        return true;
+    }
+    else
+        return false;
+}
+
+
+/************************************************************************/
+void ActionPrimitives::getOverlapTolerances(double &reachTol, double &handTol) const
+{
+    reachTol=overlapReachTol;
+    handTol=overlapHandTol;
+}
+
+
 /************************************************************************/
 bool ActionPrimitives::setTrackingMode(const bool f)
 {
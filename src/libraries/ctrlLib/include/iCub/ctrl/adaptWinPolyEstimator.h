@@ -26,6 +26,7 @@
 #define __ADAPTWINPOLYESTIMATOR_H__
 
 #include <deque>
+#include <vector>
 
 #include <yarp/sig/Vector.h>
 #include <iCub/ctrl/math.h>
@@ -213,6 +214,163 @@ public:
     AWQuadEstimator(unsigned int _N, const double _D) : AWPolyEstimator(2,_N,_D) { }
 };
 
+
+/**
+* \ingroup adaptWinPolyEstimator
+*
+* Adaptive window polynomial fitting with an incremental 
+* implementation, meant for estimating the derivatives of many 
+* signals at high rate. 
+* Abstract class. 
+*  
+* The algorithm is the same of AWPolyEstimator and yields the 
+* same estimates up to round-off, but: 
+* - the last N samples are stored in a preallocated ring buffer 
+*   and no dynamic memory is allocated after the first sample;
+* - the moments of the least-squares problem are accumulated for
+*   all the window lengths at once with loops running across the
+*   data components, and the candidate windows of each component
+*   are then fitted in constant time solving the normal
+*   equations, instead of factorizing the regressor matrix;
+* - the MSE is computed in constant time from the moments, so that
+*   the test of the max deviation can stop at the first sample
+*   exceeding the threshold.
+*  
+* Times are referred to the most recent sample and normalized 
+* by the time span of the buffer, whereas data are referred to 
+* the most recent sample, so that the normal equations stay 
+* well-conditioned. 
+*/
+class FastAWPolyEstimator
+{
+protected:
+    unsigned int order;
+    unsigned int N;
+    double D;
+    unsigned int dim;
+    unsigned int len;
+    unsigned int head;
+
+    std::vector<double> times;
+    std::vector<double> samples;
+    std::vector<double> powers;
+    std::vector<double> dx;
+    std::vector<double> timeMoments;
+    std::vector<double> dataMoments;
+    std::vector<double> G;
+    std::vector<double> a;
+
+    yarp::sig::Vector coeff;
+    yarp::sig::Vector winLen;
+    yarp::sig::Vector mse;
+
+    /**
+    * Fit the polynomial upon the last n samples of the i-th 
+    * component and fill coeff. 
+    * @param i the data component.
+    * @param n the window length.
+    * @param T the time normalization factor.
+    * @return the sum of the squared residuals.
+    */
+    double fit(const unsigned int i, const unsigned int n, const double T);
+
+    /** 
+    * Return the current estimation. 
+    * @note needs to be defined. 
+    * @return esteeme.
+    */ 
+    virtual double getEsteeme() = 0;
+
+public:
+    /**
+    * Create a polynomial estimator object of order _order on an 
+    * adaptive window of a maximum length _N an threshold _D.
+    * @param _order is the order of polynomial fitting.
+    * @param _N is the maximum windows length.
+    * @param _D is the threshold.
+    */ 
+    FastAWPolyEstimator(unsigned int _order, unsigned int _N, const double _D);
+
+    /**
+    * Feed data into the algorithm.
+    * @param el is the new data of type AWPolyElement.
+    * @note A change of the data size resets the estimator.
+    */
+    void feedData(const AWPolyElement &el);
+
+    /**
+    * Return the current windows lengths.
+    * @return the current windows lengths. 
+    */
+    yarp::sig::Vector getWinLen() { return winLen; }
+
+    /**
+    * Return the mean squared error (MSE) computed over the current 
+    * windows lengths between the predictions and the real data.
+    * @return the MSE. 
+    */
+    yarp::sig::Vector getMSE() { return mse; }
+
+    /**
+    * Execute the algorithm upon the buffered samples, with the max 
+    * deviation threshold given by D. 
+    * @return the current estimation. 
+    */
+    yarp::sig::Vector estimate();
+
+    /**
+    * Execute the algorithm upon the buffered samples, with the max 
+    * deviation threshold given by D. 
+    * @param el is the new data of type AWPolyElement. 
+    * @return the current estimation. 
+    */
+    yarp::sig::Vector estimate(const AWPolyElement &el);
+
+    /**
+    * Reinitialize the internal state. 
+    * @note Windows lengths are brought to the maximum value N and 
+    *       output remains zero as long as fed data size reaches N.
+    */
+    void reset();
+
+    /**
+     * Destructor.
+     */
+    virtual ~FastAWPolyEstimator() { }
+};
+
+
+/**
+* \ingroup adaptWinPolyEstimator
+*
+* Incremental adaptive window linear fitting to estimate the 
+* first derivative (see AWLinEstimator). 
+*/
+class FastAWLinEstimator : public FastAWPolyEstimator
+{
+protected:
+    virtual double getEsteeme() { return coeff[1]; }
+
+public:
+    FastAWLinEstimator(unsigned int _N, const double _D) : FastAWPolyEstimator(1,_N,_D) { }
+};
+
+
+/**
+* \ingroup adaptWinPolyEstimator
+*
+* Incremental adaptive window quadratic fitting to estimate the 
+* second derivative (see AWQuadEstimator). 
+*/
+class FastAWQuadEstimator : public FastAWPolyEstimator
+{
+protected:
+    virtual double getEsteeme() { return 2.0*coeff[2]; }
+
+public:
+    FastAWQuadEstimator(unsigned int _N, const double _D) : FastAWPolyEstimator(2,_N,_D) { }
+};
+
 }
 
 }
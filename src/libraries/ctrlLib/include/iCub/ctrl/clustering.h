@@ -64,25 +64,44 @@ public:
 *
 * Data clustering based on DBSCAN algorithm. 
 * 
-* @note This implementation is based on the code available at
-*       https://github.com/gyaikhom/dbscan.
+* @note This implementation gives the clusters of the code available at
+*       https://github.com/gyaikhom/dbscan. The neighbours are found
+*       through a uniform grid for points of up to 3 dimensions and
+*       through a kd-tree otherwise.
 */
 class DBSCAN : public Clustering
 {
 public:
     /**
     * Cluster the provided data.
-    * @param data contains points to be clustered. 
+    * @param data contains points to be clustered, all of the same
+    *             size.
     * @param options contains clustering options. The available 
     *                options are: "epsilon" representing the
     *                proximity sensitivity; "minpts" representing
-    *                the minimum number of neighbours.
+    *                the minimum number of neighbours; "threads"
+    *                representing the number of threads looking for
+    *                the neighbours (1 by default).
     * @return clusters as a mapping between classes and the sets of
     *         elements indexes wrt the original data.
     */
     std::map<size_t,std::set<size_t>> cluster(const std::vector<yarp::sig::Vector> &data,
                                               const yarp::os::Property &options) override;
 
+    /**
+    * Cluster the provided data, stored one point after the other 
+    * (e.g. a point cloud). 
+    * @param data points to the num*dim coordinates of the points:
+    *             point i is data[i*dim] ... data[i*dim+dim-1].
+    * @param num is the number of points.
+    * @param dim is the size of each point.
+    * @param options contains clustering options (see above).
+    * @return clusters as a mapping between classes and the sets of
+    *         elements indexes wrt the original data.
+    */
+    std::map<size_t,std::set<size_t>> cluster(const float *data, const size_t num,
+                                              const size_t dim, const yarp::os::Property &options);
+
     /**
     * Virtual destructor.
     */
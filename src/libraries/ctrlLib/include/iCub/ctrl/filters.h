@@ -23,8 +23,10 @@
 #define __FILTERS_H__
 
 #include <deque>
+#include <vector>
 
 #include <yarp/sig/Vector.h>
+#include <yarp/sig/Matrix.h>
 #include <iCub/ctrl/math.h>
 
 
@@ -80,11 +82,18 @@ protected:
    yarp::sig::Vector a;
    yarp::sig::Vector y;
 
-   std::deque<yarp::sig::Vector> uold;
-   std::deque<yarp::sig::Vector> yold;
+   // the past inputs and outputs in circular buffers, one sample (all the
+   // channels) after the other; the k-th last input is the sample
+   // (uhead+k)%(m-1) and the k-th last output is the sample (yhead+k)%(n-1)
+   std::vector<double> uold;
+   std::vector<double> yold;
+   size_t uhead;
+   size_t yhead;
    size_t n;
    size_t m;
 
+   void resizeStates(const size_t channels);
+
 public:
    /**
    * Creates a filter with specified numerator and denominator 
@@ -172,6 +181,65 @@ public:
 };
 
 
+/**
+* \ingroup Filters
+*
+* IIR as a cascade of second-order sections (biquads), which is
+* numerically more robust than a single high-order Filter (e.g. for
+* filters with poles close to the unit circle).
+*/
+class SOSFilter : public IFilter
+{
+protected:
+   std::vector<double> coeffs;  // b0 b1 b2 a1 a2 of each section, normalized by a0
+   std::vector<double> states;  // the two states of each section (direct form II transposed), channel after channel
+   double gain;
+   size_t sections;
+   yarp::sig::Vector y;
+
+public:
+   /**
+   * Creates a filter with specified second-order sections.
+   * @param sos matrix whose rows are the sections [b0 b1 b2 a0 a1 a2], 
+   *            whose coefficients are given as increasing power of
+   *            z^-1 (as returned by the MATLAB tf2sos()).
+   * @param g the gain applied to the input of the first section.
+   * @param y0 initial output.
+   * @note a0 of each section shall not be 0.
+   */
+   SOSFilter(const yarp::sig::Matrix &sos, const double g=1.0,
+             const yarp::sig::Vector &y0=yarp::sig::Vector(1,0.0));
+
+   /**
+   * Internal state reset. 
+   * @param y0 new internal state.
+   * @note the states are those of a constant input giving the output 
+   *       y0, or zero if the DC gain of the filter is zero or
+   *       infinite.
+   */
+   virtual void init(const yarp::sig::Vector &y0);
+
+   /**
+   * Returns the number of second-order sections.
+   * @return the number of sections. 
+   */
+   size_t getNumSections() const { return sections; }
+
+   /**
+   * Performs filtering on the actual input.
+   * @param u reference to the actual input. 
+   * @return the corresponding output. 
+   */
+   virtual const yarp::sig::Vector& filt(const yarp::sig::Vector &u);
+
+   /**
+   * Return current filter output.
+   * @return the filter output. 
+   */
+   virtual const yarp::sig::Vector& output() const { return y; }
+};
+
+
 /**
 * \ingroup Filters
 *
@@ -318,13 +386,20 @@ public:
 class MedianFilter : public IFilter
 {
 protected:
-   std::deque<std::deque<double> > uold;
+   // the window of the last n+1 samples of each channel, channel after
+   // channel; the samples are kept in two heaps, the lower half in a max-heap
+   // and the upper half in a min-heap, so that each sample costs O(log n)
+   std::vector<double> uold;    // the samples by slot, the oldest one is in slot head
+   std::vector<size_t> heaps;   // the slots in the lower heap and then in the upper heap
+   std::vector<int> where;      // position of each slot in its heap: pos in the lower, -pos-1 in the upper
+   std::vector<size_t> loSize;
+   std::vector<size_t> hiSize;
+   size_t head;
+   size_t count;                // number of samples in the window
    yarp::sig::Vector y;
    size_t n;
    size_t m;
 
-   double median(std::deque<double>& v);
-
 public:
    /**
    * Creates a median filter of the specified order.
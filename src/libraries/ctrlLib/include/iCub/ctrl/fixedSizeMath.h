@@ -0,0 +1,564 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD-3-Clause license. See the accompanying LICENSE file for
+ * details.
+*/
+
+/**
+ * \defgroup FixedSizeMaths FixedSizeMaths
+ *
+ * @ingroup Maths
+ *
+ * Vectors and matrices of fixed size, stored in place, together
+ * with the versions of the small kinematic operations of
+ * yarp::math (axis2dcm, dcm2axis, dcm2rpy, rpy2dcm, SE3inv,
+ * adjoint, cross, ...) working on them with the same semantics:
+ * no memory is ever allocated, and whatever does not call a
+ * transcendental function is constexpr.
+ *
+ * The conversions from and to yarp::sig::Vector and
+ * yarp::sig::Matrix allow moving the code to these types
+ * incrementally.
+ */
+
+#ifndef __CTRLFIXEDSIZEMATH_H__
+#define __CTRLFIXEDSIZEMATH_H__
+
+#include <cstddef>
+#include <cmath>
+
+#include <yarp/sig/Vector.h>
+#include <yarp/sig/Matrix.h>
+
+
+namespace iCub
+{
+
+namespace ctrl
+{
+
+/**
+* \ingroup FixedSizeMaths
+*
+* A vector of N elements.
+*/
+template<size_t N>
+struct FixedVector
+{
+    double v[N];
+
+    constexpr size_t length() const                    { return N;    }
+    constexpr double &operator[](const size_t i)       { return v[i]; }
+    constexpr const double &operator[](const size_t i) const { return v[i]; }
+    double *data()                                     { return v;    }
+    const double *data() const                         { return v;    }
+};
+
+/**
+* \ingroup FixedSizeMaths
+*
+* A matrix of RxC elements, stored by rows as yarp::sig::Matrix.
+*/
+template<size_t R, size_t C>
+struct FixedMatrix
+{
+    double m[R*C];
+
+    constexpr size_t rows() const                      { return R; }
+    constexpr size_t cols() const                      { return C; }
+    constexpr double &operator()(const size_t r, const size_t c)             { return m[r*C+c]; }
+    constexpr const double &operator()(const size_t r, const size_t c) const { return m[r*C+c]; }
+    double *data()                                     { return m; }
+    const double *data() const                         { return m; }
+};
+
+typedef FixedVector<3>   Vector3;
+typedef FixedVector<4>   Vector4;
+typedef FixedVector<6>   Vector6;
+typedef FixedMatrix<3,3> Matrix3;
+typedef FixedMatrix<4,4> Matrix4;
+typedef FixedMatrix<6,6> Matrix6;
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the NxN identity matrix.
+*/
+template<size_t N>
+constexpr FixedMatrix<N,N> eye()
+{
+    FixedMatrix<N,N> I{};
+    for (size_t i=0; i<N; i++)
+        I(i,i)=1.0;
+    return I;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the dot product <a,b>.
+*/
+template<size_t N>
+constexpr double dot(const FixedVector<N> &a, const FixedVector<N> &b)
+{
+    double s=0.0;
+    for (size_t i=0; i<N; i++)
+        s+=a[i]*b[i];
+    return s;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the squared norm ||a||^2.
+*/
+template<size_t N>
+constexpr double norm2(const FixedVector<N> &a)
+{
+    return dot(a,a);
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the norm ||a||.
+*/
+template<size_t N>
+inline double norm(const FixedVector<N> &a)
+{
+    return std::sqrt(norm2(a));
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the cross product axb.
+*/
+constexpr Vector3 cross(const Vector3 &a, const Vector3 &b)
+{
+    return Vector3{{ a[1]*b[2]-a[2]*b[1],
+                     a[2]*b[0]-a[0]*b[2],
+                     a[0]*b[1]-a[1]*b[0] }};
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the skew-symmetric matrix S such that S*b=axb, as
+* yarp::math::crossProductMatrix().
+*/
+constexpr Matrix3 crossProductMatrix(const Vector3 &a)
+{
+    return Matrix3{{  0.0, -a[2],  a[1],
+                     a[2],   0.0, -a[0],
+                    -a[1],  a[0],   0.0 }};
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the transpose of A.
+*/
+template<size_t R, size_t C>
+constexpr FixedMatrix<C,R> transposed(const FixedMatrix<R,C> &A)
+{
+    FixedMatrix<C,R> At{};
+    for (size_t r=0; r<R; r++)
+        for (size_t c=0; c<C; c++)
+            At(c,r)=A(r,c);
+    return At;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the product A*B.
+*/
+template<size_t R, size_t K, size_t C>
+constexpr FixedMatrix<R,C> operator*(const FixedMatrix<R,K> &A, const FixedMatrix<K,C> &B)
+{
+    FixedMatrix<R,C> P{};
+    for (size_t r=0; r<R; r++)
+        for (size_t k=0; k<K; k++)
+            for (size_t c=0; c<C; c++)
+                P(r,c)+=A(r,k)*B(k,c);
+    return P;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the product A*b.
+*/
+template<size_t R, size_t C>
+constexpr FixedVector<R> operator*(const FixedMatrix<R,C> &A, const FixedVector<C> &b)
+{
+    FixedVector<R> p{};
+    for (size_t r=0; r<R; r++)
+        for (size_t c=0; c<C; c++)
+            p[r]+=A(r,c)*b[c];
+    return p;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the product k*a.
+*/
+template<size_t N>
+constexpr FixedVector<N> operator*(const double k, const FixedVector<N> &a)
+{
+    FixedVector<N> p{};
+    for (size_t i=0; i<N; i++)
+        p[i]=k*a[i];
+    return p;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the sum a+b.
+*/
+template<size_t N>
+constexpr FixedVector<N> operator+(const FixedVector<N> &a, const FixedVector<N> &b)
+{
+    FixedVector<N> s{};
+    for (size_t i=0; i<N; i++)
+        s[i]=a[i]+b[i];
+    return s;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the difference a-b.
+*/
+template<size_t N>
+constexpr FixedVector<N> operator-(const FixedVector<N> &a, const FixedVector<N> &b)
+{
+    FixedVector<N> d{};
+    for (size_t i=0; i<N; i++)
+        d[i]=a[i]-b[i];
+    return d;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the rotational part of a 3x3 or 4x4 matrix.
+*/
+template<size_t R, size_t C>
+constexpr Matrix3 rotation(const FixedMatrix<R,C> &H)
+{
+    static_assert((R>=3) && (C>=3),"the matrix must be at least 3x3");
+    Matrix3 Rot{};
+    for (size_t r=0; r<3; r++)
+        for (size_t c=0; c<3; c++)
+            Rot(r,c)=H(r,c);
+    return Rot;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the translational part of a 4x4 matrix.
+*/
+constexpr Vector3 translation(const Matrix4 &H)
+{
+    return Vector3{{ H(0,3), H(1,3), H(2,3) }};
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the 4x4 homogeneous matrix of the rotation R and the
+* translation p.
+*/
+constexpr Matrix4 homogeneous(const Matrix3 &R, const Vector3 &p)
+{
+    return Matrix4{{ R(0,0), R(0,1), R(0,2), p[0],
+                     R(1,0), R(1,1), R(1,2), p[1],
+                     R(2,0), R(2,1), R(2,2), p[2],
+                        0.0,    0.0,    0.0,  1.0 }};
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the inverse of the rigid transformation H, as
+* yarp::math::SE3inv().
+*/
+constexpr Matrix4 SE3inv(const Matrix4 &H)
+{
+    const Matrix3 Rt=transposed(rotation(H));
+    const Vector3 p=Rt*translation(H);
+    return homogeneous(Rt,Vector3{{ -p[0], -p[1], -p[2] }});
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the 6x6 adjoint matrix of H, [R S(p)*R; 0 R], as
+* yarp::math::adjoint().
+*/
+constexpr Matrix6 adjoint(const Matrix4 &H)
+{
+    const Matrix3 Rot=rotation(H);
+    const Matrix3 SR=crossProductMatrix(translation(H))*Rot;
+    Matrix6 A{};
+    for (size_t r=0; r<3; r++)
+    {
+        for (size_t c=0; c<3; c++)
+        {
+            A(r,c)=A(3+r,3+c)=Rot(r,c);
+            A(r,3+c)=SR(r,c);
+        }
+    }
+    return A;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the inverse of the adjoint matrix of H,
+* [R' -R'*S(p); 0 R'], as yarp::math::adjointInv().
+*/
+constexpr Matrix6 adjointInv(const Matrix4 &H)
+{
+    const Matrix3 Rt=transposed(rotation(H));
+    const Matrix3 RtS=Rt*crossProductMatrix(translation(H));
+    Matrix6 A{};
+    for (size_t r=0; r<3; r++)
+    {
+        for (size_t c=0; c<3; c++)
+        {
+            A(r,c)=A(3+r,3+c)=Rt(r,c);
+            A(r,3+c)=-RtS(r,c);
+        }
+    }
+    return A;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the 4x4 rotation matrix given in the axis/angle
+* notation v=(x,y,z,theta), as yarp::math::axis2dcm().
+*/
+inline Matrix4 axis2dcm(const Vector4 &v)
+{
+    Matrix4 R=eye<4>();
+
+    const double theta=v[3];
+    if (theta==0.0)
+        return R;
+
+    const double c=std::cos(theta);
+    const double s=std::sin(theta);
+    const double C=1.0-c;
+
+    const double xs=v[0]*s,  ys=v[1]*s,  zs=v[2]*s;
+    const double xC=v[0]*C,  yC=v[1]*C,  zC=v[2]*C;
+    const double xyC=v[0]*yC, yzC=v[1]*zC, zxC=v[2]*xC;
+
+    R(0,0)=v[0]*xC+c; R(0,1)=xyC-zs;    R(0,2)=zxC+ys;
+    R(1,0)=xyC+zs;    R(1,1)=v[1]*yC+c; R(1,2)=yzC-xs;
+    R(2,0)=zxC-ys;    R(2,1)=yzC+xs;    R(2,2)=v[2]*zC+c;
+
+    return R;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the axis/angle notation (x,y,z,theta) of the rotational
+* part of a 3x3 or 4x4 matrix, as yarp::math::dcm2axis().
+* @note For rotations of 180 degrees the sign of the axis is not
+*       defined; without any rotation the axis is (0,0,1).
+*/
+template<size_t R, size_t C>
+inline Vector4 dcm2axis(const FixedMatrix<R,C> &H)
+{
+    static_assert((R>=3) && (C>=3),"the matrix must be at least 3x3");
+
+    Vector4 v{{ H(2,1)-H(1,2), H(0,2)-H(2,0), H(1,0)-H(0,1), 0.0 }};
+    double r=std::sqrt(v[0]*v[0]+v[1]*v[1]+v[2]*v[2]);
+    const double trace=H(0,0)+H(1,1)+H(2,2);
+    const double theta=std::atan2(0.5*r,0.5*(trace-1.0));
+
+    if (r<1e-9)
+    {
+        // H is symmetric: either there is no rotation, or it is
+        // of 180 degrees and (H+I)/2 is the outer product of the
+        // axis with itself, of which the largest column is taken
+        if (trace>1.0)
+        {
+            v[0]=v[1]=0.0;
+            v[2]=1.0;
+        }
+        else
+        {
+            size_t k=0;
+            for (size_t i=1; i<3; i++)
+                if (H(i,i)>H(k,k))
+                    k=i;
+
+            for (size_t i=0; i<3; i++)
+                v[i]=0.5*(H(i,k)+(i==k?1.0:0.0));
+        }
+
+        r=std::sqrt(v[0]*v[0]+v[1]*v[1]+v[2]*v[2]);
+    }
+
+    for (size_t i=0; i<3; i++)
+        v[i]/=r;
+    v[3]=theta;
+
+    return v;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the 4x4 rotation matrix of the roll-pitch-yaw angles
+* (Rz(yaw)*Ry(pitch)*Rx(roll)), as yarp::math::rpy2dcm().
+*/
+inline Matrix4 rpy2dcm(const Vector3 &rpy)
+{
+    const double cr=std::cos(rpy[0]), sr=std::sin(rpy[0]);
+    const double cp=std::cos(rpy[1]), sp=std::sin(rpy[1]);
+    const double cy=std::cos(rpy[2]), sy=std::sin(rpy[2]);
+
+    return Matrix4{{ cy*cp, cy*sp*sr-sy*cr, cy*sp*cr+sy*sr, 0.0,
+                     sy*cp, sy*sp*sr+cy*cr, sy*sp*cr-cy*sr, 0.0,
+                       -sp,          cp*sr,          cp*cr, 0.0,
+                       0.0,            0.0,            0.0, 1.0 }};
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns the roll-pitch-yaw angles of the rotational part of a
+* 3x3 or 4x4 matrix, as yarp::math::dcm2rpy().
+*/
+template<size_t R, size_t C>
+inline Vector3 dcm2rpy(const FixedMatrix<R,C> &H)
+{
+    static_assert((R>=3) && (C>=3),"the matrix must be at least 3x3");
+
+    if (H(2,0)<1.0)
+    {
+        if (H(2,0)>-1.0)
+            return Vector3{{ std::atan2(H(2,1),H(2,2)), std::asin(-H(2,0)), std::atan2(H(1,0),H(0,0)) }};
+        else
+            return Vector3{{ 0.0, M_PI/2.0, -std::atan2(-H(1,2),H(1,1)) }};
+    }
+    else
+        return Vector3{{ 0.0, -M_PI/2.0, std::atan2(-H(1,2),H(1,1)) }};
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Copies the first N elements of a yarp vector.
+* @return false if the yarp vector is shorter than N.
+*/
+template<size_t N>
+inline bool fromYarp(const yarp::sig::Vector &in, FixedVector<N> &out)
+{
+    if (in.length()<N)
+        return false;
+
+    for (size_t i=0; i<N; i++)
+        out[i]=in[i];
+    return true;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Copies the top-left RxC block of a yarp matrix, e.g. the
+* rotational part of a 4x4 matrix into a Matrix3.
+* @return false if the yarp matrix is smaller than RxC.
+*/
+template<size_t R, size_t C>
+inline bool fromYarp(const yarp::sig::Matrix &in, FixedMatrix<R,C> &out)
+{
+    if ((in.rows()<R) || (in.cols()<C))
+        return false;
+
+    for (size_t r=0; r<R; r++)
+        for (size_t c=0; c<C; c++)
+            out(r,c)=in(r,c);
+    return true;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Copies a fixed-size vector into a yarp vector, which is resized
+* only if it has not the right length.
+*/
+template<size_t N>
+inline void toYarp(const FixedVector<N> &in, yarp::sig::Vector &out)
+{
+    if (out.length()!=N)
+        out.resize(N);
+
+    for (size_t i=0; i<N; i++)
+        out[i]=in[i];
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Copies a fixed-size matrix into a yarp matrix, which is resized
+* only if it has not the right size.
+*/
+template<size_t R, size_t C>
+inline void toYarp(const FixedMatrix<R,C> &in, yarp::sig::Matrix &out)
+{
+    if ((out.rows()!=R) || (out.cols()!=C))
+        out.resize(R,C);
+
+    for (size_t r=0; r<R; r++)
+        for (size_t c=0; c<C; c++)
+            out(r,c)=in(r,c);
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns a fixed-size vector as a new yarp vector.
+*/
+template<size_t N>
+inline yarp::sig::Vector toYarp(const FixedVector<N> &in)
+{
+    yarp::sig::Vector out(N);
+    toYarp(in,out);
+    return out;
+}
+
+/**
+* \ingroup FixedSizeMaths
+*
+* Returns a fixed-size matrix as a new yarp matrix.
+*/
+template<size_t R, size_t C>
+inline yarp::sig::Matrix toYarp(const FixedMatrix<R,C> &in)
+{
+    yarp::sig::Matrix out(R,C);
+    toYarp(in,out);
+    return out;
+}
+
+}
+
+}
+
+#endif
+
+
@@ -30,6 +30,9 @@
 #ifndef __FUNCTIONENCODER_H__
 #define __FUNCTIONENCODER_H__
 
+#include <vector>
+#include <deque>
+
 #include <yarp/os/Property.h>
 #include <yarp/sig/Vector.h>
 
@@ -109,21 +112,30 @@ public:
 *
 * Encode any given function as a set of wavelet coefficients. 
 * The father wavelet used here is the \b db4.
+*  
+* Since both the wavelet and the sampled function are linearly 
+* interpolated, each coefficient is a linear combination of the 
+* samples whose weights are integrated exactly once for a given
+* number of samples, so that encoding is linear in the length of
+* the function. 
 */
 class WaveletEncoder : public FunctionEncoder
 {
 protected:
-    void *w;
-    void *F;
-    const yarp::sig::Vector *pVal;
-
-    unsigned int iCoeff;
     double resolution;
 
-    double interpWavelet(const double x);
-    double interpFunction(const yarp::sig::Vector &values, const double x);
+    // weights of the samples within the coefficients, computed for
+    // weightsLength samples: the coefficient n has the weights
+    // weights[weightsOffset[n]...weightsOffset[n+1]-1] of the 
+    // samples starting from weightsFirst[n]
+    size_t weightsLength;
+    double weightsResolution;
+    std::vector<size_t> weightsFirst;
+    std::vector<size_t> weightsOffset;
+    std::vector<double> weights;
 
-    friend double waveletIntegrand(double, void*);
+    double interpWavelet(const double x);
+    void computeWeights(const size_t length);
 
 public:
     /**
@@ -163,6 +175,17 @@ public:
     */
     virtual Code encode(const yarp::sig::Vector &values);
 
+    /**
+    * Encode several functions at once, e.g. the channels of a 
+    * multidimensional signal. 
+    * @param values is the list of the vectors containing the 
+    *               samples of each function, as in
+    *               encode(const yarp::sig::Vector&).
+    * @return the list of the codes; the weights are computed once 
+    *         for the functions having the same number of samples.
+    */
+    virtual std::deque<Code> encode(const std::deque<yarp::sig::Vector> &values);
+
     /**
     * Compute the approximated value of function in \b x, given the 
     * input set of wavelet coefficients. 
@@ -175,11 +198,6 @@ public:
     * @note It shall hold that coefficients.length()>=floor(R)+2.
     */
     virtual double decode(const Code &code, const double x);
-
-    /**
-    * Destructor. 
-    */
-    virtual ~WaveletEncoder();
 };
 
 }
@@ -22,6 +22,10 @@
 #ifndef __KALMAN_H__
 #define __KALMAN_H__
 
+#include <cmath>
+#include <cstddef>
+
+#include <yarp/os/Log.h>
 #include <yarp/sig/Vector.h>
 #include <yarp/sig/Matrix.h>
 #include <iCub/ctrl/math.h>
@@ -265,6 +269,1161 @@ public:
     bool set_R(const yarp::sig::Matrix &_R);
 };
 
+
+/**
+* \ingroup Kalman
+*
+* The model shared by FixedKalman and BatchKalman: N states, M
+* measurements and U inputs, stored row-major in fixed-size arrays.
+*/
+template<size_t N, size_t M, size_t U=N>
+class FixedKalmanModel
+{
+protected:
+    double A[N][N];
+    double B[N][U];
+    double H[M][N];
+    double Q[N][N];
+    double R[M][M];
+
+    static bool assign(double *dst, const yarp::sig::Matrix &src,
+                       const size_t rows, const size_t cols)
+    {
+        if ((src.rows()!=rows) || (src.cols()!=cols))
+            return false;
+
+        for (size_t r=0; r<rows; r++)
+            for (size_t c=0; c<cols; c++)
+                dst[r*cols+c]=src(r,c);
+        return true;
+    }
+
+    static yarp::sig::Matrix toMatrix(const double *src, const size_t rows,
+                                      const size_t cols)
+    {
+        yarp::sig::Matrix dst(rows,cols);
+        for (size_t r=0; r<rows; r++)
+            for (size_t c=0; c<cols; c++)
+                dst(r,c)=src[r*cols+c];
+        return dst;
+    }
+
+    void initialize(const yarp::sig::Matrix &_A, const yarp::sig::Matrix &_H,
+                    const yarp::sig::Matrix &_Q, const yarp::sig::Matrix &_R)
+    {
+        yAssert((_A.rows()==N) && (_A.cols()==N));
+        yAssert((_H.rows()==M) && (_H.cols()==N));
+        yAssert((_Q.rows()==N) && (_Q.cols()==N));
+        yAssert((_R.rows()==M) && (_R.cols()==M));
+        set_A(_A); set_H(_H); set_Q(_Q); set_R(_R);
+        for (size_t i=0; i<N; i++)
+            for (size_t j=0; j<U; j++)
+                B[i][j]=0.0;
+    }
+
+    // Cholesky factorization S=L*L', false if S is not positive definite
+    static bool cholesky(const double S[M][M], double L[M][M])
+    {
+        for (size_t j=0; j<M; j++)
+        {
+            double d=S[j][j];
+            for (size_t k=0; k<j; k++)
+                d-=L[j][k]*L[j][k];
+            if (!(d>0.0))
+                return false;
+
+            L[j][j]=std::sqrt(d);
+            for (size_t i=j+1; i<M; i++)
+            {
+                double s=S[i][j];
+                for (size_t k=0; k<j; k++)
+                    s-=L[i][k]*L[j][k];
+                L[i][j]=s/L[j][j];
+                L[j][i]=0.0;
+            }
+        }
+        return true;
+    }
+
+    // solves L*w=b in place
+    static void forward(const double L[M][M], double w[M])
+    {
+        for (size_t i=0; i<M; i++)
+        {
+            for (size_t k=0; k<i; k++)
+                w[i]-=L[i][k]*w[k];
+            w[i]/=L[i][i];
+        }
+    }
+
+    // solves L'*w=b in place
+    static void backward(const double L[M][M], double w[M])
+    {
+        for (size_t i=M; i-->0;)
+        {
+            for (size_t k=i+1; k<M; k++)
+                w[i]-=L[k][i]*w[k];
+            w[i]/=L[i][i];
+        }
+    }
+
+public:
+    static_assert((N>0) && (M>0) && (U>0), "the dimensions of the Kalman filter must be positive");
+
+    /**
+     * Returns the state transition matrix.
+     *
+     * @return State transition matrix.
+     */
+    yarp::sig::Matrix get_A() const { return toMatrix(&A[0][0],N,N); }
+
+    /**
+     * Returns the input matrix.
+     *
+     * @return Input matrix.
+     */
+    yarp::sig::Matrix get_B() const { return toMatrix(&B[0][0],N,U); }
+
+    /**
+     * Returns the measurement matrix.
+     *
+     * @return Measurement matrix.
+     */
+    yarp::sig::Matrix get_H() const { return toMatrix(&H[0][0],M,N); }
+
+    /**
+     * Returns the process noise covariance matrix.
+     *
+     * @return Process noise covariance matrix.
+     */
+    yarp::sig::Matrix get_Q() const { return toMatrix(&Q[0][0],N,N); }
+
+    /**
+     * Returns the measurement noise covariance matrix.
+     *
+     * @return Measurement noise covariance matrix.
+     */
+    yarp::sig::Matrix get_R() const { return toMatrix(&R[0][0],M,M); }
+
+    /**
+     * Sets the state transition matrix.
+     *
+     * @param _A State transition matrix.
+     * @return true/false on success/failure.
+     */
+    bool set_A(const yarp::sig::Matrix &_A) { return assign(&A[0][0],_A,N,N); }
+
+    /**
+     * Sets the input matrix.
+     *
+     * @param _B Input matrix.
+     * @return true/false on success/failure.
+     */
+    bool set_B(const yarp::sig::Matrix &_B) { return assign(&B[0][0],_B,N,U); }
+
+    /**
+     * Sets the measurement matrix.
+     *
+     * @param _H Measurement matrix.
+     * @return true/false on success/failure.
+     */
+    bool set_H(const yarp::sig::Matrix &_H) { return assign(&H[0][0],_H,M,N); }
+
+    /**
+     * Sets the process noise covariance matrix.
+     *
+     * @param _Q Process noise covariance matrix.
+     * @return true/false on success/failure.
+     */
+    bool set_Q(const yarp::sig::Matrix &_Q) { return assign(&Q[0][0],_Q,N,N); }
+
+    /**
+     * Sets the measurement noise covariance matrix.
+     *
+     * @param _R Measurement noise covariance matrix.
+     * @return true/false on success/failure.
+     */
+    bool set_R(const yarp::sig::Matrix &_R) { return assign(&R[0][0],_R,M,M); }
+};
+
+
+/**
+* \ingroup Kalman
+*
+* Kalman estimator of fixed dimensions (N states, M measurements
+* and U inputs), meant for the small filters run at high rate. All
+* the matrices live in the object and the steps allocate nothing:
+* the innovation covariance S is factorized by Cholesky rather than
+* inverted and the covariance is updated in the Joseph form
+* P=(I-K*H)*P*(I-K*H)'+K*R*K', which keeps it symmetric and
+* positive definite. The vectors and the matrices are row-major
+* arrays.
+*/
+template<size_t N, size_t M, size_t U=N>
+class FixedKalman : public FixedKalmanModel<N,M,U>
+{
+protected:
+    using FixedKalmanModel<N,M,U>::A;
+    using FixedKalmanModel<N,M,U>::B;
+    using FixedKalmanModel<N,M,U>::H;
+    using FixedKalmanModel<N,M,U>::Q;
+    using FixedKalmanModel<N,M,U>::R;
+
+    double x[N];
+    double P[N][N];
+    double K[N][M];
+    double S[M][M];
+    double validationGate;
+
+    void step(const double *u)
+    {
+        double xn[N];
+        for (size_t i=0; i<N; i++)
+        {
+            double s=0.0;
+            for (size_t j=0; j<N; j++)
+                s+=A[i][j]*x[j];
+            if (u!=NULL)
+                for (size_t j=0; j<U; j++)
+                    s+=B[i][j]*u[j];
+            xn[i]=s;
+        }
+
+        double AP[N][N];
+        for (size_t i=0; i<N; i++)
+        {
+            x[i]=xn[i];
+            for (size_t j=0; j<N; j++)
+            {
+                double s=0.0;
+                for (size_t k=0; k<N; k++)
+                    s+=A[i][k]*P[k][j];
+                AP[i][j]=s;
+            }
+        }
+
+        for (size_t i=0; i<N; i++)
+        {
+            for (size_t j=0; j<N; j++)
+            {
+                double s=Q[i][j];
+                for (size_t k=0; k<N; k++)
+                    s+=AP[i][k]*A[j][k];
+                P[i][j]=s;
+            }
+        }
+
+        double HP[M][N];
+        multiply_HP(HP);
+        for (size_t i=0; i<M; i++)
+        {
+            for (size_t j=0; j<M; j++)
+            {
+                double s=R[i][j];
+                for (size_t k=0; k<N; k++)
+                    s+=HP[i][k]*H[j][k];
+                S[i][j]=s;
+            }
+        }
+
+        validationGate=0.0;
+    }
+
+    void multiply_HP(double HP[M][N]) const
+    {
+        for (size_t i=0; i<M; i++)
+        {
+            for (size_t j=0; j<N; j++)
+            {
+                double s=0.0;
+                for (size_t k=0; k<N; k++)
+                    s+=H[i][k]*P[k][j];
+                HP[i][j]=s;
+            }
+        }
+    }
+
+public:
+    /**
+     * Init a Kalman state estimator.
+     *
+     * @param _A State transition matrix (NxN).
+     * @param _H Measurement matrix (MxN).
+     * @param _Q Process noise covariance (NxN).
+     * @param _R Measurement noise covariance (MxM).
+     */
+    FixedKalman(const yarp::sig::Matrix &_A, const yarp::sig::Matrix &_H,
+                const yarp::sig::Matrix &_Q, const yarp::sig::Matrix &_R)
+    {
+        this->initialize(_A,_H,_Q,_R);
+        reset();
+    }
+
+    /**
+     * Init a Kalman state estimator.
+     *
+     * @param _A State transition matrix (NxN).
+     * @param _B Input matrix (NxU).
+     * @param _H Measurement matrix (MxN).
+     * @param _Q Process noise covariance (NxN).
+     * @param _R Measurement noise covariance (MxM).
+     */
+    FixedKalman(const yarp::sig::Matrix &_A, const yarp::sig::Matrix &_B,
+                const yarp::sig::Matrix &_H, const yarp::sig::Matrix &_Q,
+                const yarp::sig::Matrix &_R)
+    {
+        this->initialize(_A,_H,_Q,_R);
+        yAssert((_B.rows()==N) && (_B.cols()==U));
+        this->set_B(_B);
+        reset();
+    }
+
+    /**
+     * Zeroes the state, the error covariance, the gain and the
+     * measurement covariance.
+     */
+    void reset()
+    {
+        for (size_t i=0; i<N; i++)
+        {
+            x[i]=0.0;
+            for (size_t j=0; j<N; j++)
+                P[i][j]=0.0;
+            for (size_t j=0; j<M; j++)
+                K[i][j]=0.0;
+        }
+        for (size_t i=0; i<M; i++)
+            for (size_t j=0; j<M; j++)
+                S[i][j]=0.0;
+        validationGate=0.0;
+    }
+
+    /**
+     * Set initial state and error covariance.
+     *
+     * @param _x0 Initial condition for estimated state (N values).
+     * @param _P0 Initial condition for estimated error covariance
+     *            (NxN values, row-major).
+     */
+    void init(const double *_x0, const double *_P0)
+    {
+        for (size_t i=0; i<N; i++)
+        {
+            x[i]=_x0[i];
+            for (size_t j=0; j<N; j++)
+                P[i][j]=_P0[i*N+j];
+        }
+    }
+
+    /**
+     * Set initial state and error covariance.
+     *
+     * @param _x0 Initial condition for estimated state.
+     * @param _P0 Initial condition for estimated error covariance.
+     * @return true/false on success/failure.
+     */
+    bool init(const yarp::sig::Vector &_x0, const yarp::sig::Matrix &_P0)
+    {
+        double P0[N][N];
+        if ((_x0.length()!=N) || !this->assign(&P0[0][0],_P0,N,N))
+            return false;
+
+        init(_x0.data(),&P0[0][0]);
+        return true;
+    }
+
+    /**
+     * Predicts the next state vector given the current input.
+     *
+     * @param u Current input (U values).
+     *
+     * @return Estimated state vector.
+     */
+    const double* predict(const double *u)
+    {
+        step(u);
+        return x;
+    }
+
+    /**
+     * Predicts the next state vector.
+     *
+     * @return Estimated state vector.
+     */
+    const double* predict()
+    {
+        step(NULL);
+        return x;
+    }
+
+    /**
+     * Corrects the current estimation of the state vector given the
+     * current measurement.
+     *
+     * @param z Current measurement (M values).
+     *
+     * @return true if the estimation has been corrected, false if S
+     *         is not positive definite, in which case the state and
+     *         its covariance are left unchanged.
+     */
+    bool correct(const double *z)
+    {
+        double L[M][M];
+        if (!this->cholesky(S,L))
+            return false;
+
+        // K'=S^-1*(H*P), since both S and P are symmetric
+        double HP[M][N];
+        multiply_HP(HP);
+        for (size_t c=0; c<N; c++)
+        {
+            double w[M];
+            for (size_t i=0; i<M; i++)
+                w[i]=HP[i][c];
+            this->forward(L,w);
+            this->backward(L,w);
+            for (size_t i=0; i<M; i++)
+                K[c][i]=w[i];
+        }
+
+        double e[M];
+        for (size_t i=0; i<M; i++)
+        {
+            double s=z[i];
+            for (size_t k=0; k<N; k++)
+                s-=H[i][k]*x[k];
+            e[i]=s;
+        }
+
+        for (size_t i=0; i<N; i++)
+            for (size_t k=0; k<M; k++)
+                x[i]+=K[i][k]*e[k];
+
+        double IKH[N][N], KR[N][M], T[N][N];
+        for (size_t i=0; i<N; i++)
+        {
+            for (size_t j=0; j<N; j++)
+            {
+                double s=(i==j ? 1.0 : 0.0);
+                for (size_t k=0; k<M; k++)
+                    s-=K[i][k]*H[k][j];
+                IKH[i][j]=s;
+            }
+            for (size_t j=0; j<M; j++)
+            {
+                double s=0.0;
+                for (size_t k=0; k<M; k++)
+                    s+=K[i][k]*R[k][j];
+                KR[i][j]=s;
+            }
+        }
+
+        for (size_t i=0; i<N; i++)
+        {
+            for (size_t j=0; j<N; j++)
+            {
+                double s=0.0;
+                for (size_t k=0; k<N; k++)
+                    s+=IKH[i][k]*P[k][j];
+                T[i][j]=s;
+            }
+        }
+
+        for (size_t i=0; i<N; i++)
+        {
+            for (size_t j=0; j<N; j++)
+            {
+                double s=0.0;
+                for (size_t k=0; k<N; k++)
+                    s+=T[i][k]*IKH[j][k];
+                for (size_t k=0; k<M; k++)
+                    s+=KR[i][k]*K[j][k];
+                P[i][j]=s;
+            }
+        }
+
+        // e'*S^-1*e=|L^-1*e|^2
+        this->forward(L,e);
+        validationGate=0.0;
+        for (size_t i=0; i<M; i++)
+            validationGate+=e[i]*e[i];
+
+        return true;
+    }
+
+    /**
+     * Performs a prediction given the current input and then
+     * corrects the result with the current measurement.
+     *
+     * @param u Current input (U values).
+     * @param z Current measurement (M values).
+     *
+     * @return Estimated state vector.
+     */
+    const double* filt(const double *u, const double *z)
+    {
+        predict(u);
+        correct(z);
+        return x;
+    }
+
+    /**
+     * Performs a prediction and then corrects the result with the
+     * current measurement.
+     *
+     * @param z Current measurement (M values).
+     *
+     * @return Estimated state vector.
+     */
+    const double* filt(const double *z)
+    {
+        predict();
+        correct(z);
+        return x;
+    }
+
+    /**
+     * Returns the estimated state (N values).
+     *
+     * @return Estimated state.
+     */
+    const double* get_x() const { return x; }
+
+    /**
+     * Returns the estimated output.
+     *
+     * @param y The M values of the estimated output.
+     */
+    void get_y(double *y) const
+    {
+        for (size_t i=0; i<M; i++)
+        {
+            y[i]=0.0;
+            for (size_t k=0; k<N; k++)
+                y[i]+=H[i][k]*x[k];
+        }
+    }
+
+    /**
+     * Returns the estimated state covariance (NxN values).
+     *
+     * @return Estimated state covariance.
+     */
+    const double* get_P() const { return &P[0][0]; }
+
+    /**
+     * Returns the estimated measurement covariance (MxM values).
+     *
+     * @return Estimated measurement covariance.
+     */
+    const double* get_S() const { return &S[0][0]; }
+
+    /**
+     * Returns the Kalman gain matrix (NxM values).
+     *
+     * @return Kalman gain matrix.
+     */
+    const double* get_K() const { return &K[0][0]; }
+
+    /**
+     * Returns the validation gate.
+     * @note The validation gate is meaningful only after
+     *       correction.
+     * @see correct
+     * @return validation gate.
+     */
+    double get_ValidationGate() const { return validationGate; }
+};
+
+
+/**
+* \ingroup Kalman
+*
+* A batch of F independent FixedKalman estimators which share the
+* same model and are stepped together. The values of the filters
+* are interleaved, i.e. the element (i,j) of the filter f is at
+* (i*cols+j)*F+f, so that the innermost loops run across the
+* filters over contiguous memory and can be vectorized by the
+* compiler. All the storage lives in the object, which can be
+* large: allocate it on the heap.
+*/
+template<size_t N, size_t M, size_t U, size_t F>
+class BatchKalman : public FixedKalmanModel<N,M,U>
+{
+protected:
+    using FixedKalmanModel<N,M,U>::A;
+    using FixedKalmanModel<N,M,U>::B;
+    using FixedKalmanModel<N,M,U>::H;
+    using FixedKalmanModel<N,M,U>::Q;
+    using FixedKalmanModel<N,M,U>::R;
+
+    double x[N*F];
+    double P[N*N*F];
+    double K[N*M*F];
+    double S[M*M*F];
+    double gate[F];
+    double ok[F];           // 1 if S is positive definite, 0 otherwise
+
+    // scratch
+    double xn[N*F], AP[N*N*F], HP[M*N*F], L[M*M*F], w[M*F], e[M*F];
+    double IKH[N*N*F], KR[N*M*F], T[N*N*F], Pn[N*N*F];
+
+    void step(const double *u)
+    {
+        double *xn_=xn, *x_=x, *AP_=AP, *P_=P;
+        double *HP_=HP, *S_=S;
+        for (size_t i=0; i<N; i++)
+        {
+            double *dst=xn_+i*F;
+            for (size_t f=0; f<F; f++)
+            {
+                double s=0.0;
+                for (size_t j=0; j<N; j++)
+                    s+=A[i][j]*x_[j*F+f];
+                dst[f]=s;
+            }
+            if (u!=NULL)
+            {
+                for (size_t f=0; f<F; f++)
+                {
+                    double s=dst[f];
+                    for (size_t j=0; j<U; j++)
+                        s+=B[i][j]*u[j*F+f];
+                    dst[f]=s;
+                }
+            }
+        }
+        for (size_t i=0; i<N*F; i++)
+            x[i]=xn[i];
+
+        for (size_t i=0; i<N; i++)
+        {
+            for (size_t j=0; j<N; j++)
+            {
+                double *dst=AP_+(i*N+j)*F;
+                const double *src=P_+j*F;
+                for (size_t f=0; f<F; f++)
+                {
+                    double s=0.0;
+                    for (size_t k=0; k<N; k++)
+                        s+=A[i][k]*src[k*N*F+f];
+                    dst[f]=s;
+                }
+            }
+        }
+
+        for (size_t i=0; i<N; i++)
+        {
+            for (size_t j=0; j<N; j++)
+            {
+                double *dst=P_+(i*N+j)*F;
+                const double *src=AP_+i*N*F;
+                for (size_t f=0; f<F; f++)
+                {
+                    double s=Q[i][j];
+                    for (size_t k=0; k<N; k++)
+                        s+=src[k*F+f]*A[j][k];
+                    dst[f]=s;
+                }
+            }
+        }
+
+        multiply_HP();
+        for (size_t i=0; i<M; i++)
+        {
+            for (size_t j=0; j<M; j++)
+            {
+                double *dst=S_+(i*M+j)*F;
+                const double *src=HP_+i*N*F;
+                for (size_t f=0; f<F; f++)
+                {
+                    double s=R[i][j];
+                    for (size_t k=0; k<N; k++)
+                        s+=src[k*F+f]*H[j][k];
+                    dst[f]=s;
+                }
+            }
+        }
+
+        for (size_t f=0; f<F; f++)
+            gate[f]=0.0;
+    }
+
+    void multiply_HP()
+    {
+        double *HP_=HP; const double *P_=P;
+        for (size_t i=0; i<M; i++)
+        {
+            for (size_t j=0; j<N; j++)
+            {
+                double *dst=HP_+(i*N+j)*F;
+                const double *src=P_+j*F;
+                for (size_t f=0; f<F; f++)
+                {
+                    double s=0.0;
+                    for (size_t k=0; k<N; k++)
+                        s+=H[i][k]*src[k*N*F+f];
+                    dst[f]=s;
+                }
+            }
+        }
+    }
+
+    // Cholesky factorization of S for all the filters: those whose S
+    // is not positive definite are flagged in ok and factorized as I
+    void cholesky()
+    {
+        for (size_t f=0; f<F; f++)
+            ok[f]=1.0;
+
+        for (size_t j=0; j<M; j++)
+        {
+            double *Ljj=L+(j*M+j)*F;
+            const double *Sjj=S+(j*M+j)*F;
+            for (size_t f=0; f<F; f++)
+                Ljj[f]=Sjj[f];
+            for (size_t k=0; k<j; k++)
+            {
+                const double *Ljk=L+(j*M+k)*F;
+                for (size_t f=0; f<F; f++)
+                    Ljj[f]-=Ljk[f]*Ljk[f];
+            }
+            for (size_t f=0; f<F; f++)
+            {
+                const double d=Ljj[f];
+                const bool pd=(d>0.0);
+                ok[f]=(pd ? ok[f] : 0.0);
+                Ljj[f]=std::sqrt(pd ? d : 1.0);
+            }
+
+            for (size_t i=j+1; i<M; i++)
+            {
+                double *Lij=L+(i*M+j)*F;
+                double *Lji=L+(j*M+i)*F;
+                const double *Sij=S+(i*M+j)*F;
+                for (size_t f=0; f<F; f++)
+                    Lij[f]=Sij[f];
+                for (size_t k=0; k<j; k++)
+                {
+                    const double *Lik=L+(i*M+k)*F, *Ljk=L+(j*M+k)*F;
+                    for (size_t f=0; f<F; f++)
+                        Lij[f]-=Lik[f]*Ljk[f];
+                }
+                for (size_t f=0; f<F; f++)
+                {
+                    const double l=Lij[f]/Ljj[f];
+                    Lij[f]=(ok[f]!=0.0 ? l : 0.0);
+                    Lji[f]=0.0;
+                }
+            }
+        }
+    }
+
+    // solves L*w=w in place
+    void forward(double *w_)
+    {
+        const double *L_=L;
+        for (size_t i=0; i<M; i++)
+        {
+            double *wi=w_+i*F;
+            for (size_t k=0; k<i; k++)
+            {
+                const double *Lik=L_+(i*M+k)*F, *wk=w_+k*F;
+                for (size_t f=0; f<F; f++)
+                    wi[f]-=Lik[f]*wk[f];
+            }
+            const double *Lii=L_+(i*M+i)*F;
+            for (size_t f=0; f<F; f++)
+                wi[f]/=Lii[f];
+        }
+    }
+
+    // solves L'*w=w in place
+    void backward(double *w_)
+    {
+        const double *L_=L;
+        for (size_t i=M; i-->0;)
+        {
+            double *wi=w_+i*F;
+            for (size_t k=i+1; k<M; k++)
+            {
+                const double *Lki=L_+(k*M+i)*F, *wk=w_+k*F;
+                for (size_t f=0; f<F; f++)
+                    wi[f]-=Lki[f]*wk[f];
+            }
+            const double *Lii=L_+(i*M+i)*F;
+            for (size_t f=0; f<F; f++)
+                wi[f]/=Lii[f];
+        }
+    }
+
+public:
+    static_assert(F>0, "the batch must contain at least one filter");
+
+    /**
+     * Init a batch of Kalman state estimators.
+     *
+     * @param _A State transition matrix (NxN).
+     * @param _H Measurement matrix (MxN).
+     * @param _Q Process noise covariance (NxN).
+     * @param _R Measurement noise covariance (MxM).
+     */
+    BatchKalman(const yarp::sig::Matrix &_A, const yarp::sig::Matrix &_H,
+                const yarp::sig::Matrix &_Q, const yarp::sig::Matrix &_R)
+    {
+        this->initialize(_A,_H,_Q,_R);
+        reset();
+    }
+
+    /**
+     * Init a batch of Kalman state estimators.
+     *
+     * @param _A State transition matrix (NxN).
+     * @param _B Input matrix (NxU).
+     * @param _H Measurement matrix (MxN).
+     * @param _Q Process noise covariance (NxN).
+     * @param _R Measurement noise covariance (MxM).
+     */
+    BatchKalman(const yarp::sig::Matrix &_A, const yarp::sig::Matrix &_B,
+                const yarp::sig::Matrix &_H, const yarp::sig::Matrix &_Q,
+                const yarp::sig::Matrix &_R)
+    {
+        this->initialize(_A,_H,_Q,_R);
+        yAssert((_B.rows()==N) && (_B.cols()==U));
+        this->set_B(_B);
+        reset();
+    }
+
+    /**
+     * Zeroes the states, the error covariances, the gains and the
+     * measurement covariances of all the filters.
+     */
+    void reset()
+    {
+        for (size_t i=0; i<N*F; i++)
+            x[i]=0.0;
+        for (size_t i=0; i<N*N*F; i++)
+            P[i]=0.0;
+        for (size_t i=0; i<N*M*F; i++)
+            K[i]=0.0;
+        for (size_t i=0; i<M*M*F; i++)
+            S[i]=0.0;
+        for (size_t f=0; f<F; f++)
+        {
+            gate[f]=0.0;
+            ok[f]=1.0;
+        }
+    }
+
+    /**
+     * Set initial state and error covariance of one filter.
+     *
+     * @param f The filter.
+     * @param _x0 Initial condition for estimated state.
+     * @param _P0 Initial condition for estimated error covariance.
+     * @return true/false on success/failure.
+     */
+    bool init(const size_t f, const yarp::sig::Vector &_x0,
+              const yarp::sig::Matrix &_P0)
+    {
+        if ((f>=F) || (_x0.length()!=N) || (_P0.rows()!=N) || (_P0.cols()!=N))
+            return false;
+
+        for (size_t i=0; i<N; i++)
+        {
+            x[i*F+f]=_x0[i];
+            for (size_t j=0; j<N; j++)
+                P[(i*N+j)*F+f]=_P0(i,j);
+        }
+        return true;
+    }
+
+    /**
+     * Set the same initial state and error covariance to all the
+     * filters.
+     *
+     * @param _x0 Initial condition for estimated state.
+     * @param _P0 Initial condition for estimated error covariance.
+     * @return true/false on success/failure.
+     */
+    bool init(const yarp::sig::Vector &_x0, const yarp::sig::Matrix &_P0)
+    {
+        for (size_t f=0; f<F; f++)
+            if (!init(f,_x0,_P0))
+                return false;
+        return true;
+    }
+
+    /**
+     * Predicts the next state vectors given the current inputs.
+     *
+     * @param u Current inputs (U x F values, interleaved).
+     */
+    void predict(const double *u) { step(u); }
+
+    /**
+     * Predicts the next state vectors.
+     */
+    void predict() { step(NULL); }
+
+    /**
+     * Corrects the current estimation of the state vectors given
+     * the current measurements.
+     *
+     * @param z Current measurements (M x F values,
+     *          interleaved).
+     *
+     * @return true if all the filters have been corrected; the
+     *         filters whose S is not positive definite are left
+     *         unchanged (see is_Corrected()).
+     */
+    bool correct(const double *z)
+    {
+        cholesky();
+
+        // K'=S^-1*(H*P), since both S and P are symmetric
+        multiply_HP();
+        double *w_=w, *K_=K;
+        const double *HP_=HP;
+        for (size_t c=0; c<N; c++)
+        {
+            for (size_t i=0; i<M; i++)
+            {
+                const double *src=HP_+(i*N+c)*F; double *dst=w_+i*F;
+                for (size_t f=0; f<F; f++)
+                    dst[f]=src[f];
+            }
+            forward(w_);
+            backward(w_);
+            for (size_t i=0; i<M; i++)
+            {
+                const double *src=w_+i*F; double *dst=K_+(c*M+i)*F;
+                for (size_t f=0; f<F; f++)
+                    dst[f]=src[f];
+            }
+        }
+
+        double *e_=e, *x_=x;
+        for (size_t i=0; i<M; i++)
+        {
+            double *ei=e_+i*F; const double *zi=z+i*F;
+            for (size_t f=0; f<F; f++)
+            {
+                double s=zi[f];
+                for (size_t k=0; k<N; k++)
+                    s-=H[i][k]*x_[k*F+f];
+                ei[f]=s;
+            }
+        }
+
+        for (size_t i=0; i<N; i++)
+        {
+            double *xi=x_+i*F; const double *Ki=K_+i*M*F;
+            for (size_t f=0; f<F; f++)
+            {
+                double s=xi[f];
+                for (size_t k=0; k<M; k++)
+                    s+=Ki[k*F+f]*e_[k*F+f];
+                const double old=xi[f];
+                xi[f]=(ok[f]!=0.0 ? s : old);
+            }
+        }
+
+        double *IKH_=IKH, *KR_=KR;
+        for (size_t i=0; i<N; i++)
+        {
+            for (size_t j=0; j<N; j++)
+            {
+                double *dst=IKH_+(i*N+j)*F;
+                const double *Ki=K_+i*M*F;
+                for (size_t f=0; f<F; f++)
+                {
+                    double s=(i==j ? 1.0 : 0.0);
+                    for (size_t k=0; k<M; k++)
+                        s-=Ki[k*F+f]*H[k][j];
+                    dst[f]=s;
+                }
+            }
+            for (size_t j=0; j<M; j++)
+            {
+                double *dst=KR_+(i*M+j)*F;
+                const double *Ki=K_+i*M*F;
+                for (size_t f=0; f<F; f++)
+                {
+                    double s=0.0;
+                    for (size_t k=0; k<M; k++)
+                        s+=Ki[k*F+f]*R[k][j];
+                    dst[f]=s;
+                }
+            }
+        }
+
+        double *T_=T, *P_=P, *Pn_=Pn;
+        for (size_t i=0; i<N; i++)
+        {
+            for (size_t j=0; j<N; j++)
+            {
+                double *dst=T_+(i*N+j)*F;
+                const double *a=IKH_+i*N*F, *b=P_+j*F;
+                for (size_t f=0; f<F; f++)
+                {
+                    double s=0.0;
+                    for (size_t k=0; k<N; k++)
+                        s+=a[k*F+f]*b[k*N*F+f];
+                    dst[f]=s;
+                }
+            }
+        }
+
+        for (size_t i=0; i<N; i++)
+        {
+            for (size_t j=0; j<N; j++)
+            {
+                double *dst=Pn_+(i*N+j)*F;
+                const double *old=P_+(i*N+j)*F;
+                const double *a=T_+i*N*F, *b=IKH_+j*N*F;
+                const double *c=KR_+i*M*F, *d=K_+j*M*F;
+                for (size_t f=0; f<F; f++)
+                {
+                    double s=0.0;
+                    for (size_t k=0; k<N; k++)
+                        s+=a[k*F+f]*b[k*F+f];
+                    for (size_t k=0; k<M; k++)
+                        s+=c[k*F+f]*d[k*F+f];
+                    const double o=old[f];
+                    dst[f]=(ok[f]!=0.0 ? s : o);
+                }
+            }
+        }
+        for (size_t i=0; i<N*N*F; i++)
+            P[i]=Pn[i];
+
+        // e'*S^-1*e=|L^-1*e|^2
+        forward(e_);
+        bool all=true;
+        for (size_t f=0; f<F; f++)
+        {
+            double s=0.0;
+            for (size_t i=0; i<M; i++)
+                s+=e_[i*F+f]*e_[i*F+f];
+            gate[f]=(ok[f]!=0.0 ? s : 0.0);
+            all&=(ok[f]!=0.0);
+        }
+
+        return all;
+    }
+
+    /**
+     * Performs a prediction given the current inputs and then
+     * corrects the result with the current measurements.
+     *
+     * @param u Current inputs (U x F values, interleaved).
+     * @param z Current measurements (M x F values,
+     *          interleaved).
+     *
+     * @return true if all the filters have been corrected.
+     */
+    bool filt(const double *u, const double *z)
+    {
+        predict(u);
+        return correct(z);
+    }
+
+    /**
+     * Performs a prediction and then corrects the result with the
+     * current measurements.
+     *
+     * @param z Current measurements (M x F values,
+     *          interleaved).
+     *
+     * @return true if all the filters have been corrected.
+     */
+    bool filt(const double *z)
+    {
+        predict();
+        return correct(z);
+    }
+
+    /**
+     * Returns whether a filter has been corrected by the last call
+     * to correct().
+     *
+     * @param f The filter.
+     * @return true if its S was positive definite.
+     */
+    bool is_Corrected(const size_t f) const { return (ok[f]!=0.0); }
+
+    /**
+     * Returns the estimated states (N x F values,
+     * interleaved).
+     *
+     * @return Estimated states.
+     */
+    const double* get_x() const { return x; }
+
+    /**
+     * Returns the estimated state of one filter.
+     *
+     * @param f The filter.
+     * @return Estimated state.
+     */
+    yarp::sig::Vector get_x(const size_t f) const
+    {
+        yarp::sig::Vector x_(N);
+        for (size_t i=0; i<N; i++)
+            x_[i]=x[i*F+f];
+        return x_;
+    }
+
+    /**
+     * Returns the estimated state covariance of one filter.
+     *
+     * @param f The filter.
+     * @return Estimated state covariance.
+     */
+    yarp::sig::Matrix get_P(const size_t f) const
+    {
+        yarp::sig::Matrix P_(N,N);
+        for (size_t i=0; i<N; i++)
+            for (size_t j=0; j<N; j++)
+                P_(i,j)=P[(i*N+j)*F+f];
+        return P_;
+    }
+
+    /**
+     * Returns the estimated state covariances (N x N x F values,
+     * interleaved).
+     *
+     * @return Estimated state covariances.
+     */
+    const double* get_P() const { return P; }
+
+    /**
+     * Returns the estimated measurement covariances (M x M x F
+     * values, interleaved).
+     *
+     * @return Estimated measurement covariances.
+     */
+    const double* get_S() const { return S; }
+
+    /**
+     * Returns the Kalman gain matrices (N x M x F values,
+     * interleaved).
+     *
+     * @return Kalman gain matrices.
+     */
+    const double* get_K() const { return K; }
+
+    /**
+     * Returns the validation gates (one per filter).
+     * @note The validation gates are meaningful only after
+     *       correction.
+     * @see correct
+     * @return validation gates.
+     */
+    const double* get_ValidationGate() const { return gate; }
+};
+
 }
 
 }
@@ -24,6 +24,9 @@
 
 #include <string>
 #include <deque>
+#include <map>
+#include <utility>
+#include <vector>
 
 #include <yarp/os/Property.h>
 #include <yarp/sig/Vector.h>
@@ -456,6 +459,135 @@ public:
                                    const yarp::sig::Vector &yd);
 };
 
+
+/**
+* \ingroup minJerkCtrl
+*
+* Bank of independent generators of approximately minimum jerk
+* trajectories, one per channel, each with its own trajectory
+* reference time. Every channel behaves as a minJerkTrajGen of
+* dimension 1, but all of them are advanced together by one loop
+* over coefficients and states stored channel by channel (one
+* array per coefficient and per state), and the discretized
+* coefficients are cached on (T,Ts), so that one bank can drive
+* all the joints of a part at no allocation cost per step.
+*/
+class minJerkTrajGenBank
+{
+protected:
+    // the coefficients of a channel: the numerators of the position,
+    // velocity and acceleration filters and their common denominator
+    enum { bp0, bp1, bp2, bp3, bv0, bv1, bv2, bv3, ba0, ba1, ba2, ba3,
+           a0, a1, a2, a3, numCoeffs };
+
+    // the states of a channel: the past inputs of the position filter,
+    // the past inputs of the velocity and acceleration filters and
+    // the past outputs of the three filters
+    enum { up1, up2, up3, uv1, uv2, uv3, yp1, yp2, yp3, yv1, yv2, yv3,
+           ya1, ya2, ya3, numStates };
+
+    struct Coeffs { double c[numCoeffs]; };
+    std::map<std::pair<double,double>,Coeffs> cache;    // coefficients by (T,Ts)
+
+    std::vector<double> coeffs;     // numCoeffs arrays of dim values
+    std::vector<double> states;     // numStates arrays of dim values
+
+    yarp::sig::Vector pos;          // current position
+    yarp::sig::Vector vel;          // current velocity
+    yarp::sig::Vector acc;          // current acceleration
+    yarp::sig::Vector T;            // trajectory reference times in seconds
+
+    double Ts;                      // sample time in seconds
+    unsigned int dim;               // number of channels
+
+    double *coeff(const int k) { return &coeffs[k*dim]; }
+    double *state(const int k) { return &states[k*dim]; }
+    const Coeffs &getCoeffs(const double _T);
+    void computeCoeffs(const unsigned int i);
+
+public:
+    /**
+    * Constructor.
+    * @param _dim number of channels.
+    * @param _Ts sample time in seconds.
+    * @param _T trajectory reference time of all the channels (90% of
+    *           steady-state value in t=_T, transient extinguished for
+    *           t>=1.5*_T).
+    */
+    minJerkTrajGenBank(const unsigned int _dim, const double _Ts, const double _T);
+
+    /**
+    * Constructor with initial value.
+    * @param _y0 initial value of the trajectories.
+    * @param _Ts sample time in seconds.
+    * @param _T trajectory reference times of the channels.
+    */
+    minJerkTrajGenBank(const yarp::sig::Vector &_y0, const double _Ts,
+                       const yarp::sig::Vector &_T);
+
+    /**
+    * Initialize the trajectories.
+    * @param y0 initial value of the trajectories.
+    */
+    void init(const yarp::sig::Vector &y0);
+
+    /**
+    * Compute the next position, velocity and acceleration of all
+    * the channels.
+    * @param yd desired final values of the trajectories.
+    */
+    void computeNextValues(const yarp::sig::Vector &yd);
+
+    /**
+    * Get the current positions.
+    */
+    const yarp::sig::Vector& getPos() const { return pos; }
+
+    /**
+    * Get the current velocities.
+    */
+    const yarp::sig::Vector& getVel() const { return vel; }
+
+    /**
+    * Get the current accelerations.
+    */
+    const yarp::sig::Vector& getAcc() const { return acc; }
+
+    /**
+    * Get the trajectory reference times in seconds.
+    */
+    const yarp::sig::Vector& getT() const { return T; }
+
+    /**
+    * Get the sample time in seconds.
+    */
+    double getTs() const { return Ts; }
+
+    /**
+    * Set the trajectory reference time of one channel; as for 
+    * minJerkTrajGen, its velocity and acceleration filters are 
+    * reinitialized. 
+    * @param i the channel.
+    * @param _T trajectory reference time in seconds.
+    * @return true if operation succeeded, false otherwise.
+    */
+    bool setT(const unsigned int i, const double _T);
+
+    /**
+    * Set the trajectory reference times of all the channels.
+    * @param _T trajectory reference times in seconds.
+    * @return true if operation succeeded, false otherwise.
+    */
+    bool setT(const yarp::sig::Vector &_T);
+
+    /**
+    * Set the sample time.
+    * @param _Ts sample time in seconds.
+    * @return true if operation succeeded, false otherwise.
+    */
+    bool setTs(const double _Ts);
+};
+
 }
 
 }
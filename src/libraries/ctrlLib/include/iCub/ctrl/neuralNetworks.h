@@ -25,9 +25,12 @@
 #include <iostream>
 #include <string>
 #include <deque>
+#include <cmath>
+#include <cstddef>
 
 #include <yarp/os/Property.h>
 #include <yarp/sig/Vector.h>
+#include <yarp/sig/Matrix.h>
 #include <iCub/ctrl/math.h>
 
 
@@ -37,6 +40,33 @@ namespace iCub
 namespace ctrl
 {
 
+/**
+* \ingroup neuralNetworks
+*
+* Hyperbolic tangent computed only with arithmetic operations, so 
+* that the loops calling it can be vectorized by the compiler. 
+* @param x is the input.
+* @return tanh(x), with an absolute error below 1e-15. 
+*/
+inline double fastTanh(const double x)
+{
+    // expm1(2|x|) is obtained from the Taylor series of expm1(2|x|/128)
+    // squaring 7 times (e^2-1=u*(2+u)); tanh=u/(u+2) is written as
+    // 1/(1+2/u) so that it is 1 when u overflows, without any branch
+    const double z=std::fabs(x)*(2.0/128.0);
+    double u=z*(1.0+z*(1.0/2.0+z*(1.0/6.0+z*(1.0/24.0+z*(1.0/120.0+
+             z*(1.0/720.0+z*(1.0/5040.0)))))));
+    for (int i=0; i<7; i++)
+        u*=2.0+u;
+
+    return std::copysign(1.0/(1.0+2.0/u),x);
+}
+
+
+template<size_t I, size_t H, size_t O>
+class ff2LayNN_tansig_purelin_fixed;
+
+
 /**
 * \ingroup neuralNetworks
 *
@@ -83,6 +113,31 @@ protected:
     void setItem(yarp::os::Property &options, const std::string &tag, const yarp::sig::Vector &item) const;
     bool getItem(const yarp::os::Property &options, const std::string &tag, yarp::sig::Vector &item) const;
 
+    /**
+    * Hidden Layer Function applied in place to a batch of inputs.
+    * @param x points to rows inputs of cols elements each, stored 
+    *          one after the other.
+    * @param rows is the number of inputs. 
+    * @param cols is the number of hidden nodes. 
+    * @note the default implementation calls hiddenLayerFcn() on 
+    *       each input.
+    */ 
+    virtual void hiddenLayerFcnBatch(double *x, const size_t rows, const size_t cols) const;
+
+    /**
+    * Output Layer Function applied in place to a batch of inputs.
+    * @param x points to rows inputs of cols elements each, stored 
+    *          one after the other.
+    * @param rows is the number of inputs. 
+    * @param cols is the number of output nodes. 
+    * @note the default implementation calls outputLayerFcn() on 
+    *       each input.
+    */ 
+    virtual void outputLayerFcnBatch(double *x, const size_t rows, const size_t cols) const;
+
+    template<size_t I, size_t H, size_t O>
+    friend class ff2LayNN_tansig_purelin_fixed;
+
 public:
     /**
     * Create an empty network.
@@ -155,6 +210,16 @@ public:
     */ 
     virtual yarp::sig::Vector predict(const yarp::sig::Vector &x) const;
 
+    /**
+    * Predict the outputs given a batch of inputs to the network.
+    * @param X is the matrix whose rows are the inputs.
+    * @return the matrix whose rows are the predicted outputs. 
+    * @note the products are accumulated in a different order than 
+    *       predict(const yarp::sig::Vector&) does, hence the two
+    *       results agree up to the rounding errors.
+    */ 
+    virtual yarp::sig::Matrix predict(const yarp::sig::Matrix &X) const;
+
     /**
     * Retrieve the network structure as a Property object.
     * @param options is the output stream. 
@@ -301,6 +366,174 @@ public:
     * @return the output vector.
     */ 
     virtual yarp::sig::Vector outputLayerGrad(const yarp::sig::Vector &x) const;
+
+protected:
+    /**
+    * The tansig of the whole batch through fastTanh().
+    */ 
+    virtual void hiddenLayerFcnBatch(double *x, const size_t rows, const size_t cols) const;
+
+    /**
+    * The purelin leaves the batch untouched.
+    */ 
+    virtual void outputLayerFcnBatch(double *x, const size_t rows, const size_t cols) const;
+};
+
+
+/**
+* \ingroup neuralNetworks
+*
+* Copy of a ff2LayNN_tansig_purelin network with I inputs, H 
+* hidden nodes and O outputs, whose prediction of one input does
+* not allocate memory. 
+*  
+* @note the network is copied by assign(), hence later changes 
+*       to the original one (e.g. through get_IW()) require a new
+*       assign().
+*/
+template<size_t I, size_t H, size_t O>
+class ff2LayNN_tansig_purelin_fixed
+{
+protected:
+    double inMinX[I];
+    double inMinY[I];
+    double inRatio[I];
+
+    double IW[H][I];
+    double b1[H];
+
+    double LW[O][H];
+    double b2[O];
+
+    double outMinX[O];
+    double outMinY[O];
+    double outRatio[O];
+
+    bool configured;
+
+public:
+    /**
+    * Create an empty network.
+    */ 
+    ff2LayNN_tansig_purelin_fixed() : configured(false) { }
+
+    /**
+    * Create the network as a copy of another one.
+    * @param net is the network to be copied.
+    * @see assign
+    */ 
+    ff2LayNN_tansig_purelin_fixed(const ff2LayNN_tansig_purelin &net) :
+                                  configured(false)
+    {
+        assign(net);
+    }
+
+    /**
+    * Copy a network.
+    * @param net is the network to be copied.
+    * @return true/false on success/fail, which happens if net is 
+    *         not configured or its sizes are not I, H and O.
+    */ 
+    bool assign(const ff2LayNN_tansig_purelin &net)
+    {
+        const ff2LayNN &src=net;
+        configured=false;
+
+        if (!src.configured || (src.inMinX.length()!=I) || (src.IW.size()!=H) ||
+            (src.b1.length()!=H) || (src.LW.size()!=O) || (src.b2.length()!=O) ||
+            (src.outMinX.length()!=O))
+            return false;
+
+        for (size_t h=0; h<H; h++)
+            if (src.IW[h].length()!=I)
+                return false;
+
+        for (size_t o=0; o<O; o++)
+            if (src.LW[o].length()!=H)
+                return false;
+
+        for (size_t i=0; i<I; i++)
+        {
+            inMinX[i]=src.inMinX[i];
+            inMinY[i]=src.inMinY[i];
+            inRatio[i]=src.inRatio[i];
+        }
+
+        for (size_t h=0; h<H; h++)
+        {
+            for (size_t i=0; i<I; i++)
+                IW[h][i]=src.IW[h][i];
+            b1[h]=src.b1[h];
+        }
+
+        for (size_t o=0; o<O; o++)
+        {
+            for (size_t h=0; h<H; h++)
+                LW[o][h]=src.LW[o][h];
+            b2[o]=src.b2[o];
+
+            outMinX[o]=src.outMinX[o];
+            outMinY[o]=src.outMinY[o];
+            outRatio[o]=src.outRatio[o];
+        }
+
+        return configured=true;
+    }
+
+    /**
+    * Return the internal status after the copy.
+    * @return true/false on success/fail.
+    */ 
+    bool isValid() const { return configured; }
+
+    /**
+    * Predict the output given a certain input to the network.
+    * @param x points to the I elements of the input.
+    * @param y points to the O elements where to store the output. 
+    * @note the network must be valid. 
+    */ 
+    void predict(const double *x, double *y) const
+    {
+        double x1[I];
+        for (size_t i=0; i<I; i++)
+            x1[i]=inRatio[i]*(x[i]-inMinX[i])+inMinY[i];
+
+        double a1[H];
+        for (size_t h=0; h<H; h++)
+        {
+            double n1=b1[h];
+            for (size_t i=0; i<I; i++)
+                n1+=IW[h][i]*x1[i];
+            a1[h]=fastTanh(n1);
+        }
+
+        for (size_t o=0; o<O; o++)
+        {
+            double n2=b2[o];
+            for (size_t h=0; h<H; h++)
+                n2+=LW[o][h]*a1[h];
+            y[o]=outRatio[o]*(n2-outMinY[o])+outMinX[o];
+        }
+    }
+
+    /**
+    * Predict the output given a certain input to the network.
+    * @param x is the actual input to the network.
+    * @param y is the predicted output, resized to O only if its 
+    *          size differs.
+    * @return true/false on success/fail. 
+    */ 
+    bool predict(const yarp::sig::Vector &x, yarp::sig::Vector &y) const
+    {
+        if (!configured || (x.length()!=I))
+            return false;
+
+        if (y.length()!=O)
+            y.resize(O);
+
+        predict(x.data(),y.data());
+        return true;
+    }
 };
 
 }
@@ -48,6 +48,22 @@
  *    x=A*x+B*u;
  * } 
  * \endcode 
+ *
+ * For time-invariant problems with a long horizon, the stationary
+ * solution \f$ T \f$ of the DARE and its gain \f$ L \f$ can be computed
+ * directly by solveStationaryRiccati(), which uses the structure-preserving
+ * doubling algorithm and is warm-started from the previous stationary
+ * solution when the problem data change slightly:
+ *
+ * \code
+ * Riccati r(A,B,V,P,VN);
+ * r.solveStationaryRiccati();
+ * while (running)
+ * {
+ *    r.doStationaryLQcontrol(x,u);
+ *    x=A*x+B*u;
+ * }
+ * \endcode
  * 
  * \author Serena Ivaldi
  * 
@@ -87,6 +103,10 @@ protected:
     yarp::sig::Matrix TN, lastT;
     yarp::sig::Matrix *Ti;
     yarp::sig::Matrix *Li;
+
+    yarp::sig::Matrix Ts, Ls;   // stationary solution and its gain
+    bool stationary;
+    double convTol;
     
     yarp::sig::Vector x;
 
@@ -96,6 +116,9 @@ protected:
 
     bool verbose;
 
+    bool iterateStationary(double tol, int maxIter);
+    bool doubleStationary(double tol, int maxIter);
+
 public:
      /**
      * Constructor, with initialization of algebraic Riccati equation
@@ -110,6 +133,11 @@ public:
              const yarp::sig::Matrix &_V, const yarp::sig::Matrix &_P,
              const yarp::sig::Matrix &_VN, bool verb=false);
 
+     /**
+     * Destructor
+     */
+     ~Riccati();
+
      /**
      * Get stored L_i matrix; call this function only after solveRiccati()
      * 
@@ -146,6 +174,45 @@ public:
      */
      void solveRiccati(int steps);
 
+     /**
+     * Set the tolerance used by solveRiccati() to detect the
+     * convergence of the backward recursion: once two consecutive
+     * Ti differ (in Frobenius norm) by less than tol times their
+     * norm, the earlier matrices are taken equal and not computed.
+     * 
+     * @param tol The relative tolerance; 0 (the default) disables 
+     *            the detection.
+     */
+     void setConvergenceTolerance(double tol);
+
+     /**
+     * Solve the stationary discrete algebraic Riccati equation 
+     * T = V + A'*(T - T*B*(P + B'*T*B)^-1*B'*T)*A of the 
+     * infinite-horizon problem through the structure-preserving 
+     * doubling algorithm, and compute its gain L. If a previous 
+     * stationary solution exists (e.g. the problem data have 
+     * changed slightly through setProblemData()), the recursion is 
+     * first iterated from it for a few steps. 
+     *  
+     * @param tol The relative tolerance on the change of T between 
+     *            two iterations.
+     * @param maxIter The maximum number of iterations.
+     * @return true if the solution has converged. 
+     */
+     bool solveStationaryRiccati(double tol=1e-10, int maxIter=100);
+
+     /**
+     * Get the stationary gain matrix; call this function only after
+     * solveStationaryRiccati()
+     */
+     const yarp::sig::Matrix& stationaryL() const { return Ls; }
+
+     /**
+     * Get the stationary solution of the DARE; call this function 
+     * only after solveStationaryRiccati()
+     */
+     const yarp::sig::Matrix& stationaryT() const { return Ts; }
+
      /**
      * Compute the LQ feedback control, in the form: ret= - L(i) * x 
      * 
@@ -155,7 +222,8 @@ public:
      yarp::sig::Vector doLQcontrol(int step, const yarp::sig::Vector &x);
 
      /**
-     * Compute the LQ feedback control, in the form: u= - L(i) * x 
+     * Compute the LQ feedback control, in the form: u= - L(i) * x;
+     * nothing is allocated once ret has the right size
      * 
      * @param step The time index i
      * @param x The state vector
@@ -163,6 +231,17 @@ public:
      */
      void doLQcontrol(int step, const yarp::sig::Vector &x, yarp::sig::Vector &ret);
 
+     /**
+     * Compute the stationary LQ feedback control, in the form: u= 
+     * - L * x, where L is the gain given by 
+     * solveStationaryRiccati(). Nothing is allocated once ret has 
+     * the right size. 
+     * 
+     * @param x The state vector
+     * @param ret The control vector
+     */
+     void doStationaryLQcontrol(const yarp::sig::Vector &x, yarp::sig::Vector &ret);
+
      /**
      * Enable or disable verbose feedback (that is, printing additional information) 
      * 
@@ -24,6 +24,7 @@
 
 #include <map>
 #include <set>
+#include <deque>
 
 #include <yarp/os/Property.h>
 #include <yarp/sig/Vector.h>
@@ -69,6 +70,8 @@ protected:
     std::map<size_t,double> tauLUP;
     std::set<size_t> recurIdx;
 
+    double getTau(const size_t N) const;
+
 public:
     /**
     * Default constructor.
@@ -92,16 +95,107 @@ public:
     *                outcome of the previous instance until no more
     *                outliers are found.
     * @return set containing the outliers indexes.
+    *
+    * @note The <i>recursive</i> detection without <i>mean</i> and
+    *       <i>std</i> is carried out by detectBatch().
     */
     std::set<size_t> detect(const yarp::sig::Vector &data,
                             const yarp::os::Property &options);
 
+    /**
+    * Perform the recursive outliers detection over the provided 
+    * data. \n 
+    * The data are sorted once, so that the candidate outlier is 
+    * always at one end of the remaining samples, whose mean and 
+    * standard deviation are updated in O(1) as outliers are 
+    * removed: the cost is O(n*log(n)) instead of O(n*k), for k 
+    * outliers. 
+    * @param data contains points to be verified. 
+    * @return set containing the outliers indexes.
+    */
+    std::set<size_t> detectBatch(const yarp::sig::Vector &data) const;
+
     /**
     * Virtual destructor.
     */
     virtual ~ModifiedThompsonTau() { }
 };
 
+
+/**
+* \ingroup outliersDetection
+*
+* Perform modified Thompson tau technique for outlier detection
+* over a sliding window of streaming data. \n 
+* Each new sample is tested against the samples of the window 
+* and itself; mean and standard deviation are kept up to date 
+* with Welford's algorithm, i.e. in O(1) per sample.
+*/
+class OnlineModifiedThompsonTau : public ModifiedThompsonTau
+{
+protected:
+    std::deque<double> window;
+    size_t windowLength;
+    bool   admitOutliers;
+    size_t updates;
+    double mean;
+    double M2;
+
+    void insert(const double x, const double mean1, const double M21);
+    void recompute();
+
+public:
+    /**
+    * Constructor.
+    * @param windowLength_ the maximum number of samples of the 
+    *                      window (at least 2).
+    * @param admitOutliers_ if true the outliers are admitted in the
+    *                       window too, so that the detector follows
+    *                       persistent changes of the signal;
+    *                       otherwise they are discarded.
+    */
+    OnlineModifiedThompsonTau(const size_t windowLength_,
+                              const bool admitOutliers_=false);
+
+    /**
+    * Test a new sample and add it to the window, dropping the 
+    * oldest sample if the window is full. \n 
+    * No detection is carried out until the window holds at least 
+    * two samples.
+    * @param x the new sample.
+    * @return true if the sample is an outlier.
+    */
+    bool add(const double x);
+
+    /**
+    * Empty the window.
+    */
+    void reset();
+
+    /**
+    * Return the number of samples of the window.
+    * @return the number of samples.
+    */
+    size_t size() const { return window.size(); }
+
+    /**
+    * Return the mean of the samples of the window.
+    * @return the mean.
+    */
+    double getMean() const { return mean; }
+
+    /**
+    * Return the standard deviation of the samples of the window.
+    * @return the standard deviation.
+    */
+    double getStd() const;
+
+    /**
+    * Virtual destructor.
+    */
+    virtual ~OnlineModifiedThompsonTau() { }
+};
+
 }
 
 }
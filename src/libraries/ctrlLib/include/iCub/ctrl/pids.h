@@ -23,6 +23,7 @@
 #define __PIDS_H__
 
 #include <deque>
+#include <mutex>
 
 #include <yarp/os/Bottle.h>
 #include <yarp/sig/Vector.h>
@@ -100,6 +101,7 @@ public:
     * To be called each Ts seconds.
     * @param x is the input vector to be integrated.
     * @return the current output vector.
+    * @note The output is updated in place, with no allocation.
     */
     const yarp::sig::Vector& integrate(const yarp::sig::Vector &x);
 
@@ -238,6 +240,16 @@ protected:
     Integrator          *Int;
     std::deque<Filter*>  Der;
 
+    // preallocated inputs of the integrator and of the derivative filters
+    yarp::sig::Vector inputI;
+    yarp::sig::Vector inputD;
+
+    // held by compute() and by the methods changing the configuration,
+    // so that new options take effect between two cycles
+    std::recursive_mutex mtx;
+
+    void update(const yarp::sig::Vector &ref, const yarp::sig::Vector &fb);
+
 public:
     /**
     * Constructor. 
@@ -268,6 +280,19 @@ public:
     */
     virtual const yarp::sig::Vector& compute(const yarp::sig::Vector &ref, const yarp::sig::Vector &fb);
 
+    /**
+    * Computes the PID output into a given vector. 
+    * @param ref the actual reference to track. 
+    * @param fb the actual plant feedback. 
+    * @param out the actual PID output. 
+    * @note No memory is allocated once out has the size of the 
+    *       pid, therefore this is the method to be used within
+    *       control loops, also when the options may be changed by
+    *       another thread.
+    */
+    virtual void compute(const yarp::sig::Vector &ref, const yarp::sig::Vector &fb,
+                         yarp::sig::Vector &out);
+
     /**
     * Resets the internal state of integral and derivative part. 
     * @param u0 is the new value of output vector. 
@@ -347,6 +372,15 @@ protected:
     std::deque<Filter*> Int;
     std::deque<Filter*> Der;
 
+    // preallocated input of the scalar filters
+    yarp::sig::Vector input;
+
+    // held by compute() and by the methods changing the configuration,
+    // so that new options take effect between two cycles
+    std::recursive_mutex mtx;
+
+    void update(const yarp::sig::Vector &ref, const yarp::sig::Vector &fb);
+
 public:
     /**
     * Constructor. 
@@ -372,6 +406,19 @@ public:
     */
     virtual const yarp::sig::Vector& compute(const yarp::sig::Vector &ref, const yarp::sig::Vector &fb);
 
+    /**
+    * Computes the PID output into a given vector. 
+    * @param ref the actual reference to track. 
+    * @param fb the actual plant feedback. 
+    * @param out the actual PID output. 
+    * @note No memory is allocated once out has the size of the 
+    *       pid, therefore this is the method to be used within
+    *       control loops, also when the options may be changed by
+    *       another thread.
+    */
+    virtual void compute(const yarp::sig::Vector &ref, const yarp::sig::Vector &fb,
+                         yarp::sig::Vector &out);
+
     /**
     * Resets the internal state of integral and derivative part. 
     */
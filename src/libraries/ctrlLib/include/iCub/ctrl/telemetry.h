@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD-3-Clause license. See the accompanying LICENSE file for
+ * details.
+*/
+
+/**
+ * \defgroup telemetry Telemetry
+ *
+ * @ingroup ctrlLib
+ *
+ * Classes for monitoring the timing of periodic control loops.
+ */
+
+#ifndef __CTRL_TELEMETRY_H__
+#define __CTRL_TELEMETRY_H__
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <yarp/os/Bottle.h>
+
+namespace iCub
+{
+
+namespace ctrl
+{
+
+/**
+* \ingroup telemetry
+*
+* Collects the timing statistics of a periodic thread: the
+* duration of each run, the jitter of the start instant with
+* respect to the nominal period, the number of overruns and the
+* time spent within named sections of the cycle (e.g. solver,
+* kinematics, ports I/O).
+*
+* Durations and jitters are binned in fixed-width histograms
+* spanning [0,2*period] and [-period,period] respectively; out of
+* range samples are accumulated in the extreme bins.
+*
+* Timings are taken from the system clock, regardless of the
+* network clock possibly in use.
+*
+* @note beginCycle(), endCycle(), tic() and toc() are meant to be
+*       called by the monitored thread, whereas getInfo() and
+*       reset() can be safely called by any other thread.
+*/
+class CycleTelemetry
+{
+protected:
+    struct Histogram
+    {
+        double lo;
+        double width;
+        unsigned long cnt;
+        double sum;
+        double min;
+        double max;
+        std::vector<unsigned long> bins;
+
+        void init(const double lo, const double hi, const int nBins);
+        void reset();
+        void add(const double x);
+        void toBottle(yarp::os::Bottle &b) const;
+    };
+
+    struct Section
+    {
+        std::string name;
+        double t0;
+        double acc;
+        unsigned long cnt;
+        double sum;
+        double max;
+    };
+
+    std::mutex mtx;
+    double period;
+    int nBins;
+    double tStart;
+    double tPrevStart;
+    unsigned long cycles;
+    unsigned long overruns;
+
+    Histogram duration;
+    Histogram jitter;
+    std::vector<Section> sections;
+
+public:
+    /**
+    * Constructor.
+    * @param period is the nominal period of the thread [s].
+    * @param nBins is the number of bins of the histograms.
+    */
+    CycleTelemetry(const double period, const int nBins=20);
+
+    /**
+    * Changes the nominal period; statistics are reset.
+    * @param period is the new nominal period [s].
+    * @note To be called while the monitored thread is not
+    *       running.
+    */
+    void setPeriod(const double period);
+
+    /**
+    * Returns the nominal period.
+    * @return the nominal period [s].
+    */
+    double getPeriod() const { return period; }
+
+    /**
+    * Registers a new section of the cycle to be timed.
+    * @param name is the section name.
+    * @return the section id to be used with tic() and toc().
+    * @note Sections are supposed to be registered before the
+    *       thread is started.
+    */
+    int addSection(const std::string &name);
+
+    /**
+    * Marks the beginning of a run.
+    */
+    void beginCycle();
+
+    /**
+    * Marks the end of a run and commits the statistics.
+    */
+    void endCycle();
+
+    /**
+    * Starts timing a section. A section can be entered several
+    * times within the same run: the elapsed times are summed up.
+    * @param id is the section id.
+    */
+    void tic(const int id);
+
+    /**
+    * Stops timing a section.
+    * @param id is the section id.
+    */
+    void toc(const int id);
+
+    /**
+    * Clears all the statistics.
+    */
+    void reset();
+
+    /**
+    * Returns the number of overruns, i.e. the runs lasting more
+    * than the nominal period.
+    * @return the number of overruns.
+    */
+    unsigned long getOverruns();
+
+    /**
+    * Fills a property-like bottle with the current statistics.
+    * Times are expressed in [ms]. The format is the following:
+    * (period <T>) (cycles <n>) (overruns <n>)
+    * (duration ((mean <x>) (min <x>) (max <x>) (lo <x>) (width
+    * <x>) (bins (<n0> <n1> ...)))) (jitter (...)) (sections
+    * ((<name> (mean <x>) (max <x>) (runs <n>)) ...)), where the
+    * mean time of a section is computed over all the runs and
+    * runs is the number of cycles the section was entered in.
+    * @param info is the bottle to be filled.
+    */
+    void getInfo(yarp::os::Bottle &info);
+};
+
+}
+
+}
+
+#endif
+
+
@@ -22,6 +22,7 @@
 #ifndef __TUNING_H__
 #define __TUNING_H__
 
+#include <deque>
 #include <mutex>
 #include <condition_variable>
 
@@ -64,7 +65,6 @@ protected:
     yarp::sig::Matrix F;
     yarp::sig::Vector B;
     yarp::sig::Matrix C;
-    yarp::sig::Matrix Ct;
     yarp::sig::Matrix Q;
     yarp::sig::Matrix P;
     yarp::sig::Vector x;
@@ -114,8 +114,10 @@ public:
      * 
      * @return Estimated state vector composed of position, 
      *         velocity, \f$ \tau \f$ and \f$ K. \f$
+     *  
+     * @note the update does not allocate memory. 
      */
-    yarp::sig::Vector estimate(const double u, const double y);
+    const yarp::sig::Vector& estimate(const double u, const double y);
 
     /**
      * Return the estimated state.
@@ -123,14 +125,14 @@ public:
      * @return Estimated state vector composed of position, 
      *         velocity, \f$ \tau \f$ and \f$ K. \f$
      */
-    yarp::sig::Vector get_x() const { return _x; }
+    const yarp::sig::Vector& get_x() const { return _x; }
 
     /**
      * Return the estimated error covariance.
      * 
      * @return Estimated error covariance.
      */
-    yarp::sig::Matrix get_P() const { return P; }
+    const yarp::sig::Matrix& get_P() const { return P; }
 
     /**
      * Return the system parameters.
@@ -165,11 +167,16 @@ protected:
     std::mutex              mtx;
     std::mutex              mtx_doneEvent;
     std::condition_variable cv_doneEvent;
+    bool                    doneEvent;
     yarp::sig::Vector       gamma;
     yarp::sig::Vector       stiction;
     yarp::os::Property      info;
     yarp::sig::Vector       done;
 
+    // preallocated arguments of the calls made by run()
+    yarp::sig::Vector pos1,ref1,tg1;
+    yarp::sig::Vector adaptErr;
+
     AWLinEstimator   velEst;
     AWQuadEstimator  accEst;
     parallelPID     *pid;
@@ -195,6 +202,7 @@ protected:
     } state;
 
     void applyStictionLimit();
+    void notifyDoneEvent();
     bool threadInit();
     void run();
     void threadRelease();
@@ -366,6 +374,7 @@ protected:
     std::mutex mtx;
     std::mutex mtx_doneEvent;
     std::condition_variable cv_doneEvent;
+    bool doneEvent;
     yarp::os::BufferedPort<yarp::sig::Vector> port;
 
     yarp::sig::Vector x0;
@@ -668,12 +677,183 @@ public:
      */
     virtual bool getResults(yarp::os::Property &results);
 
+    /**
+     * Retrieve the joint being designed.
+     *  
+     * @return the joint index.
+     */
+    virtual int getJoint() const { return joint; }
+
     /**
      * Destructor.
      */
     virtual ~OnlineCompensatorDesign();
 };
 
+
+/**
+* \ingroup Tuning
+*
+* Bank of \ref OnlineCompensatorDesign, one per joint of the same 
+* part, whose operations run concurrently so that the whole part 
+* is designed within one experiment. 
+*/
+class OnlineCompensatorDesignBank
+{
+protected:
+    std::deque<OnlineCompensatorDesign*> designers;
+    bool configured;
+
+    void dispose();
+    yarp::os::Property jointOptions(const yarp::os::Property &options, const int j) const;
+
+    typedef bool (OnlineCompensatorDesign::*Operation)(const yarp::os::Property&);
+    bool startOperation(Operation operation, const yarp::os::Property &options);
+
+    // the designers are threads owned by the bank
+    OnlineCompensatorDesignBank(const OnlineCompensatorDesignBank&) = delete;
+    void operator=(const OnlineCompensatorDesignBank&) = delete;
+
+public:
+    /**
+     * Default constructor.
+     */
+    OnlineCompensatorDesignBank();
+
+    /**
+     * Configure the bank.
+     *  
+     * @param driver the device driver to control the robot part.
+     * @param options the configuration options, which are the ones 
+     *                of \ref OnlineCompensatorDesign except for the
+     *                [general] group, where (@b joints (<int>
+     *                <int> ...)) lists the joints to be designed
+     *                and @b port <string>, if given, is the prefix
+     *                of the ports opened by each designer, whose
+     *                names are completed with "/<joint>".
+     *  
+     * @return true/false on success/failure. 
+     */
+    virtual bool configure(yarp::dev::PolyDriver &driver, const yarp::os::Property &options);
+
+    /**
+     * Check the configuration status.
+     *  
+     * @return true iff configured successfully.
+     */
+    virtual bool isConfigured() const { return configured; }
+
+    /**
+     * Return the number of designers.
+     *  
+     * @return the number of joints.
+     */
+    size_t size() const { return designers.size(); }
+
+    /**
+     * Access the designer of one joint, e.g. to run an operation on 
+     * that joint only. 
+     *  
+     * @param i the position of the joint within the list given to 
+     *          configure().
+     * @return the designer.
+     */
+    OnlineCompensatorDesign& operator[](const size_t i) { return *designers[i]; }
+
+    /**
+     * Start off the plant estimation procedure on all the joints. 
+     *  
+     * @param options property containing the estimation options; 
+     *                the options of the joint j are overridden by
+     *                the ones within the group [joint_<j>], if any.
+     * @return true iff all started successfully; otherwise the 
+     *         started ones are stopped.
+     *  
+     * @see OnlineCompensatorDesign::startPlantEstimation
+     */
+    virtual bool startPlantEstimation(const yarp::os::Property &options);
+
+    /**
+     * Start off the plant validation procedure on all the joints. 
+     *  
+     * @param options property containing the validation options; 
+     *                the options of the joint j (e.g. @b tau and
+     *                @b K) are overridden by the ones within the
+     *                group [joint_<j>], if any.
+     * @return true iff all started successfully; otherwise the 
+     *         started ones are stopped.
+     *  
+     * @see OnlineCompensatorDesign::startPlantValidation
+     */
+    virtual bool startPlantValidation(const yarp::os::Property &options);
+
+    /**
+     * Start off the stiction estimation procedure on all the 
+     * joints. 
+     *  
+     * @param options property containing the estimation options; 
+     *                the options of the joint j are overridden by
+     *                the ones within the group [joint_<j>], if any.
+     * @return true iff all started successfully; otherwise the 
+     *         started ones are stopped.
+     *  
+     * @see OnlineCompensatorDesign::startStictionEstimation
+     */
+    virtual bool startStictionEstimation(const yarp::os::Property &options);
+
+    /**
+     * Start off the controller validation procedure on all the 
+     * joints. 
+     *  
+     * @param options property containing the validation options; 
+     *                the options of the joint j (e.g. the gains)
+     *                are overridden by the ones within the group
+     *                [joint_<j>], if any.
+     * @return true iff all started successfully; otherwise the 
+     *         started ones are stopped.
+     *  
+     * @see OnlineCompensatorDesign::startControllerValidation
+     */
+    virtual bool startControllerValidation(const yarp::os::Property &options);
+
+    /**
+     * Check the status of the current ongoing operations.
+     *  
+     * @return true iff the operations of all the joints are 
+     *         finished.
+     */
+    virtual bool isDone();
+
+    /**
+     * Wait until the current ongoing operations are accomplished.
+     *  
+     * @return true iff the operations of all the joints are 
+     *         finished.
+     */
+    virtual bool waitUntilDone();
+
+    /**
+     * Stop any ongoing operation.
+     */
+    virtual void stopOperation();
+
+    /**
+     * Retrieve the results of the current ongoing operations.
+     *  
+     * @param results the results of each joint, in the order given 
+     *                to configure().
+     * @return true/false on success/failure. 
+     *  
+     * @see OnlineCompensatorDesign::getResults
+     */
+    virtual bool getResults(std::deque<yarp::os::Property> &results);
+
+    /**
+     * Destructor.
+     */
+    virtual ~OnlineCompensatorDesignBank();
+};
+
 }
 
 }
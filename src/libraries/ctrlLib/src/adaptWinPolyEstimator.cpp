@@ -241,3 +241,258 @@ Vector AWLinEstimator::fit(const Vector &x, const Vector &y, const unsigned int
 
 
 
+
+
+/***************************************************************************/
+FastAWPolyEstimator::FastAWPolyEstimator(unsigned int _order, unsigned int _N,
+                                         const double _D) :
+                                         order(_order), N(_N), D(_D)
+{
+    order=std::max(order,1U);
+    N=N<=order ? N+1 : N;
+
+    const unsigned int nk=2*order+1;
+    times.resize(N);
+    powers.resize(N*nk);
+    timeMoments.resize(N*nk);
+    G.resize((order+1)*(order+1));
+    a.resize(order+1);
+    coeff.resize(order+1,0.0);
+
+    dim=len=head=0;
+}
+
+
+/***************************************************************************/
+void FastAWPolyEstimator::feedData(const AWPolyElement &el)
+{
+    if ((unsigned int)el.data.length()!=dim)
+    {
+        dim=(unsigned int)el.data.length();
+        samples.resize(N*dim);
+        dx.resize(N*dim);
+        dataMoments.resize(N*(order+2)*dim);
+        winLen.resize(dim);
+        mse.resize(dim);
+        std::fill(winLen.begin(),winLen.end(),(double)N);
+        mse.zero();
+        len=0;
+    }
+
+    head=(len>0)?(head+1)%N:0;
+
+    times[head]=el.time;
+    std::copy(el.data.begin(),el.data.end(),samples.begin()+head*dim);
+    len=std::min(len+1,N);
+}
+
+
+/***************************************************************************/
+double FastAWPolyEstimator::fit(const unsigned int i, const unsigned int n,
+                                const double T)
+{
+    const unsigned int m=order+1;
+    const unsigned int nk=2*order+1;
+    const double *tm=&timeMoments[(n-1)*nk];
+    const double *dm=&dataMoments[(n-1)*(order+2)*dim];
+
+    // normal equations G*a=b, solved through Cholesky
+    // (G is the Hankel matrix of the time moments)
+    bool ok=true;
+    for (unsigned int r=0; r<m; r++)
+    {
+        for (unsigned int c=0; c<=r; c++)
+        {
+            double sum=tm[r+c];
+            for (unsigned int k=0; k<c; k++)
+                sum-=G[r*m+k]*G[c*m+k];
+
+            if (r==c)
+            {
+                if (sum<=0.0)
+                {
+                    ok=false;
+                    break;
+                }
+
+                G[r*m+r]=sqrt(sum);
+            }
+            else
+                G[r*m+c]=sum/G[c*m+c];
+        }
+
+        if (!ok)
+            break;
+    }
+
+    if (!ok)
+    {
+        std::fill(a.begin(),a.end(),0.0);
+        coeff.zero();
+        return dm[(order+1)*dim+i];
+    }
+
+    for (unsigned int r=0; r<m; r++)
+    {
+        double sum=dm[r*dim+i];
+        for (unsigned int k=0; k<r; k++)
+            sum-=G[r*m+k]*a[k];
+        a[r]=sum/G[r*m+r];
+    }
+
+    for (int r=m-1; r>=0; r--)
+    {
+        double sum=a[r];
+        for (unsigned int k=r+1; k<m; k++)
+            sum-=G[k*m+r]*a[k];
+        a[r]=sum/G[r*m+r];
+    }
+
+    // the residual of the least-squares solution
+    // is x'*x-a'*b; restore the physical units
+    double sse=dm[(order+1)*dim+i];
+    double scale=1.0;
+    for (unsigned int k=0; k<m; k++)
+    {
+        sse-=a[k]*dm[k*dim+i];
+        coeff[k]=a[k]/scale;
+        scale*=T;
+    }
+    coeff[0]+=samples[head*dim+i];
+
+    return std::max(sse,0.0);
+}
+
+
+/***************************************************************************/
+Vector FastAWPolyEstimator::estimate()
+{
+    yAssert(len>0);
+
+    Vector esteem(dim,0.0);
+    if (len<N)
+        return esteem;
+
+    // enforce condition on time vector
+    // with respect to the oldest sample
+    const double tN=times[(head+1)%N];
+    for (unsigned int j=1; j<N; j++)
+    {
+        if (times[(head+1+j)%N]<=tN)
+        {
+            yWarning()<<"Provided non-increasing time vector";
+            return esteem;
+        }
+    }
+
+    const unsigned int nk=2*order+1;
+    const unsigned int nm=order+2;
+    const double t0=times[head];
+    const double T=t0-tN;
+    const double *x0=&samples[head*dim];
+
+    // go through the samples from the most recent one backwards,
+    // accumulating the moments for all the window lengths
+    for (unsigned int r=0; r<N; r++)
+    {
+        const unsigned int slot=(head+N-r)%N;
+        const double *xs=&samples[slot*dim];
+        double *p=&powers[r*nk];
+        double *tm=&timeMoments[r*nk];
+        double *d=&dx[r*dim];
+        double *dm=&dataMoments[r*nm*dim];
+
+        p[0]=1.0;
+        p[1]=(times[slot]-t0)/T;
+        for (unsigned int k=2; k<nk; k++)
+            p[k]=p[k-1]*p[1];
+
+        for (unsigned int j=0; j<dim; j++)
+            d[j]=xs[j]-x0[j];
+
+        if (r==0)
+        {
+            std::copy(p,p+nk,tm);
+            for (unsigned int k=0; k<=order; k++)
+                for (unsigned int j=0; j<dim; j++)
+                    dm[k*dim+j]=p[k]*d[j];
+            for (unsigned int j=0; j<dim; j++)
+                dm[(order+1)*dim+j]=d[j]*d[j];
+        }
+        else
+        {
+            const double *tm_=tm-nk;
+            const double *dm_=dm-nm*dim;
+            for (unsigned int k=0; k<nk; k++)
+                tm[k]=tm_[k]+p[k];
+            for (unsigned int k=0; k<=order; k++)
+                for (unsigned int j=0; j<dim; j++)
+                    dm[k*dim+j]=dm_[k*dim+j]+p[k]*d[j];
+            for (unsigned int j=0; j<dim; j++)
+                dm[(order+1)*dim+j]=dm_[(order+1)*dim+j]+d[j]*d[j];
+        }
+    }
+
+    // cycle upon all elements
+    for (unsigned int i=0; i<dim; i++)
+    {
+        // change the window length of two units, back and forth
+        unsigned int n1=(unsigned int)((winLen[i]>(order+1))?(winLen[i]-1):(order+1));
+        unsigned int n2=(unsigned int)((winLen[i]<N)?(winLen[i]+1):N);
+
+        // cycle upon all possibile window's length
+        for (unsigned int n=n1; n<=n2; n++)
+        {
+            mse[i]=fit(i,n,T)/n;
+
+            // test the regressor upon the elements belonging
+            // to the actual window, up to the first crossing
+            // of the max deviation threshold
+            bool _stop=false;
+            for (unsigned int r=0; r<n; r++)
+            {
+                const double *p=&powers[r*nk];
+                double y=a[order];
+                for (int k=order-1; k>=0; k--)
+                    y=y*p[1]+a[k];
+
+                if (fabs(dx[r*dim+i]-y)>D)
+                {
+                    _stop=true;
+                    break;
+                }
+            }
+
+            // set the new window's length in case of
+            // crossing of max deviation threshold
+            if (_stop)
+            {
+                winLen[i]=n;
+                break;
+            }
+        }
+
+        esteem[i]=getEsteeme();
+    }
+
+    return esteem;
+}
+
+
+/***************************************************************************/
+Vector FastAWPolyEstimator::estimate(const AWPolyElement &el)
+{
+    feedData(el);
+    return estimate();
+}
+
+
+/***************************************************************************/
+void FastAWPolyEstimator::reset()
+{
+    if (len>0)
+    {
+        std::fill(winLen.begin(),winLen.end(),(double)N);
+        len=0;
+    }
+}
@@ -8,16 +8,18 @@
  * details.
 */
 
-#include <memory>
-#include <vector>
+#include <cstdint>
 #include <cmath>
-#include <yarp/math/Math.h>
+#include <algorithm>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #include <iCub/ctrl/clustering.h>
 
 using namespace std;
 using namespace yarp::os;
 using namespace yarp::sig;
-using namespace yarp::math;
 using namespace iCub::ctrl;
 
 namespace iCub {
@@ -28,119 +30,471 @@ namespace iCub {
                 noise=-2
             };
 
-            struct Data_t {
-                const vector<Vector> &points;
-                const double epsilon;
-                const size_t minpts;
-                vector<int> ids;
-                Data_t(const vector<Vector> &points_,
-                       const double epsilon_,
-                       const size_t minpts_) :
-                       points(points_), epsilon(epsilon_), minpts(minpts_) {
-                    ids.assign(points.size(),(int)PointType::unclassified);
-                }
+            // the points are stored one after the other
+            template<typename T>
+            struct Points_t {
+                const T *data;
+                const size_t num;
+                const size_t dim;
+                Points_t(const T *data_, const size_t num_, const size_t dim_) :
+                         data(data_), num(num_), dim(dim_) { }
+                const T *operator[](const size_t i) const { return data+i*dim; }
             };
 
-            struct Node_t {
-                size_t index;
-                shared_ptr<Node_t> next;
-            };
-
-            struct Epsilon_neighbours_t {
-                size_t num_members;
-                shared_ptr<Node_t> head;
-                weak_ptr<Node_t> tail;
-            };
+            // the points whose pruning tests are done with a radius slightly
+            // larger than epsilon never miss a point which passes the test
+            // below, whose rounding errors are much smaller than this margin
+            const double radius_margin=1.0+1e-9;
 
             /**********************************************************************/
-            shared_ptr<Node_t> create_node(const size_t index)
+            template<typename T>
+            inline bool is_neighbour(const T *a, const T *b, const size_t dim,
+                                     const double epsilon)
             {
-                shared_ptr<Node_t> node(new Node_t());
-                node->index=index;
-                node->next=nullptr;
-                return node;
+                double d=0.0;
+                for (size_t j=0; j<dim; j++)
+                {
+                    double e=(double)a[j]-(double)b[j];
+                    d+=e*e;
+                }
+                return (sqrt(d)<=epsilon);
             }
 
             /**********************************************************************/
-            void append(const size_t index, shared_ptr<Epsilon_neighbours_t> en)
-            {
-                shared_ptr<Node_t> node=create_node(index);
-                if (en->head==nullptr)
+            // the reference search over all the points, used when the others
+            // cannot be (e.g. with infinite or NaN values)
+            template<typename T>
+            class BruteForce_t {
+                const Points_t<T> &points;
+                const double epsilon;
+            public:
+                struct Scratch_t { };
+                BruteForce_t(const Points_t<T> &points_, const double epsilon_) :
+                             points(points_), epsilon(epsilon_) { }
+
+                // f(i) is called for each neighbour i of the point index,
+                // and the search stops as soon as it returns false
+                template<class F>
+                void query(const size_t index, F f, Scratch_t &scratch) const
                 {
-                    en->head=node;
-                    en->tail=node;
+                    const T *p=points[index];
+                    for (size_t i=0; i<points.num; i++)
+                    {
+                        if ((i!=index) && is_neighbour(p,points[i],points.dim,epsilon))
+                        {
+                            if (!f(i))
+                            {
+                                return;
+                            }
+                        }
+                    }
                 }
-                else
+            };
+
+            /**********************************************************************/
+            // uniform grid of cells whose side is epsilon, for 1, 2 or 3 dimensions
+            template<typename T>
+            class Grid_t {
+                struct Key_t {
+                    int64_t c[3];
+                    bool operator==(const Key_t &k) const { return (c[0]==k.c[0]) && (c[1]==k.c[1]) && (c[2]==k.c[2]); }
+                    bool operator<(const Key_t &k) const
+                    {
+                        return (c[0]!=k.c[0]) ? (c[0]<k.c[0]) : ((c[1]!=k.c[1]) ? (c[1]<k.c[1]) : (c[2]<k.c[2]));
+                    }
+                };
+
+                struct KeyHash_t {
+                    size_t operator()(const Key_t &k) const
+                    {
+                        return (size_t)(((uint64_t)k.c[0]*73856093ULL)^((uint64_t)k.c[1]*19349663ULL)^((uint64_t)k.c[2]*83492791ULL));
+                    }
+                };
+
+                struct Range_t {
+                    size_t begin,end;
+                };
+
+                const Points_t<T> &points;
+                const double epsilon;
+                const double radius;
+                vector<size_t> order;   // the points sorted by cell
+                unordered_map<Key_t,Range_t,KeyHash_t> cells;
+
+                int64_t cell_of(const double x) const { return (int64_t)floor(x/radius); }
+
+            public:
+                struct Scratch_t { };
+
+                // the grid needs finite coordinates whose cells fit in 64 bits
+                static bool usable(const Points_t<T> &points, const double epsilon)
                 {
-                    en->tail.lock()->next=node;
-                    en->tail=node;
+                    if ((points.dim<1) || (points.dim>3) || !(epsilon>0.0) || !isfinite(epsilon*radius_margin))
+                    {
+                        return false;
+                    }
+                    const double limit=epsilon*radius_margin*1e15;
+                    for (size_t i=0; i<points.num*points.dim; i++)
+                    {
+                        if (!(fabs((double)points.data[i])<limit))
+                        {
+                            return false;
+                        }
+                    }
+                    return true;
                 }
-                en->num_members++;
-            }
 
-            /**********************************************************************/
-            shared_ptr<Epsilon_neighbours_t> get_epsilon_neighbours(const size_t index,
-                                                                    shared_ptr<Data_t> augData)
-            {
-                shared_ptr<Epsilon_neighbours_t> en(new Epsilon_neighbours_t());
-                for (size_t i=0; i<augData->points.size(); i++)
+                Grid_t(const Points_t<T> &points_, const double epsilon_) :
+                       points(points_), epsilon(epsilon_), radius(epsilon_*radius_margin)
                 {
-                    double d=0.0;
-                    for (size_t j=0; j<augData->points[index].length(); j++)
+                    vector<Key_t> keys(points.num);
+                    order.resize(points.num);
+                    for (size_t i=0; i<points.num; i++)
                     {
-                        d+=pow(augData->points[index][j]-augData->points[i][j],2.0);
+                        Key_t &k=keys[i];
+                        for (size_t j=0; j<3; j++)
+                        {
+                            k.c[j]=(j<points.dim) ? cell_of((double)points[i][j]) : 0;
+                        }
+                        order[i]=i;
                     }
-                    if ((i!=index) && (sqrt(d)<=augData->epsilon))
+                    sort(order.begin(),order.end(),[&keys](const size_t a, const size_t b) {
+                        return (keys[a]<keys[b]) || (!(keys[b]<keys[a]) && (a<b));
+                    });
+
+                    cells.reserve(points.num);
+                    for (size_t begin=0; begin<order.size(); )
                     {
-                        append(i,en);
+                        size_t end=begin+1;
+                        while ((end<order.size()) && (keys[order[end]]==keys[order[begin]]))
+                        {
+                            end++;
+                        }
+                        Range_t r;
+                        r.begin=begin;
+                        r.end=end;
+                        cells[keys[order[begin]]]=r;
+                        begin=end;
                     }
                 }
-                return en;
-            }
+
+                template<class F>
+                void query(const size_t index, F f, Scratch_t &scratch) const
+                {
+                    const T *p=points[index];
+                    int64_t lo[3]={0,0,0};
+                    int64_t hi[3]={0,0,0};
+                    for (size_t j=0; j<points.dim; j++)
+                    {
+                        lo[j]=cell_of((double)p[j]-radius);
+                        hi[j]=cell_of((double)p[j]+radius);
+                    }
+
+                    Key_t k;
+                    for (k.c[0]=lo[0]; k.c[0]<=hi[0]; k.c[0]++)
+                    {
+                        for (k.c[1]=lo[1]; k.c[1]<=hi[1]; k.c[1]++)
+                        {
+                            for (k.c[2]=lo[2]; k.c[2]<=hi[2]; k.c[2]++)
+                            {
+                                auto c=cells.find(k);
+                                if (c==cells.end())
+                                {
+                                    continue;
+                                }
+                                for (size_t n=c->second.begin; n<c->second.end; n++)
+                                {
+                                    size_t i=order[n];
+                                    if ((i!=index) && is_neighbour(p,points[i],points.dim,epsilon))
+                                    {
+                                        if (!f(i))
+                                        {
+                                            return;
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            };
 
             /**********************************************************************/
-            void spread(const size_t index, shared_ptr<Epsilon_neighbours_t> seeds,
-                        const size_t id, shared_ptr<Data_t> augData)
-            {
-                shared_ptr<Epsilon_neighbours_t> spread=get_epsilon_neighbours(index,augData);
-                if (spread->num_members>=augData->minpts)
+            // kd-tree, for any number of dimensions
+            template<typename T>
+            class KdTree_t {
+                static const size_t leaf_size=16;
+
+                struct Node_t {
+                    size_t begin,end;   // the points of the node: order[begin] ... order[end-1]
+                    size_t dim;         // the points of left have coordinate dim <= split,
+                    double split;       // the ones of right >= split
+                    int left,right;     // -1 for the leaves
+                };
+
+                const Points_t<T> &points;
+                const double epsilon;
+                const double radius;
+                vector<size_t> order;
+                vector<Node_t> nodes;
+
+                int build(const size_t begin, const size_t end)
                 {
-                    for (shared_ptr<Node_t> node=spread->head; node!=nullptr; node=node->next)
+                    Node_t node;
+                    node.begin=begin;
+                    node.end=end;
+                    node.dim=0;
+                    node.split=0.0;
+                    node.left=node.right=-1;
+
+                    int id=(int)nodes.size();
+                    nodes.push_back(node);
+                    if (end-begin<=leaf_size)
+                    {
+                        return id;
+                    }
+
+                    // split along the dimension of largest extent
+                    double extent=-1.0;
+                    for (size_t j=0; j<points.dim; j++)
                     {
-                        if ((augData->ids[node->index]==(int)PointType::noise) ||
-                            (augData->ids[node->index]==(int)PointType::unclassified))
+                        double lo=points[order[begin]][j];
+                        double hi=lo;
+                        for (size_t n=begin+1; n<end; n++)
                         {
-                            if (augData->ids[node->index]==(int)PointType::unclassified)
+                            double x=points[order[n]][j];
+                            lo=std::min(lo,x);
+                            hi=std::max(hi,x);
+                        }
+                        if (hi-lo>extent)
+                        {
+                            extent=hi-lo;
+                            node.dim=j;
+                        }
+                    }
+
+                    const size_t dim=node.dim;
+                    const size_t mid=begin+(end-begin)/2;
+                    nth_element(order.begin()+begin,order.begin()+mid,order.begin()+end,
+                                [this,dim](const size_t a, const size_t b) {
+                                    return (points[a][dim]<points[b][dim]);
+                                });
+                    node.split=points[order[mid]][dim];
+                    node.left=build(begin,mid);
+                    node.right=build(mid,end);
+                    nodes[id]=node;
+                    return id;
+                }
+
+            public:
+                struct Scratch_t {
+                    vector<int> stack;
+                };
+
+                // the tree needs coordinates which can be ordered
+                static bool usable(const Points_t<T> &points, const double epsilon)
+                {
+                    if (!isfinite(epsilon*radius_margin))
+                    {
+                        return false;
+                    }
+                    for (size_t i=0; i<points.num*points.dim; i++)
+                    {
+                        if (!isfinite((double)points.data[i]))
+                        {
+                            return false;
+                        }
+                    }
+                    return true;
+                }
+
+                KdTree_t(const Points_t<T> &points_, const double epsilon_) :
+                         points(points_), epsilon(epsilon_), radius(epsilon_*radius_margin)
+                {
+                    order.resize(points.num);
+                    for (size_t i=0; i<points.num; i++)
+                    {
+                        order[i]=i;
+                    }
+                    if (points.num>0)
+                    {
+                        nodes.reserve(2*(points.num/leaf_size+1));
+                        build(0,points.num);
+                    }
+                }
+
+                template<class F>
+                void query(const size_t index, F f, Scratch_t &scratch) const
+                {
+                    if (nodes.empty())
+                    {
+                        return;
+                    }
+
+                    const T *p=points[index];
+                    scratch.stack.clear();
+                    scratch.stack.push_back(0);
+                    while (!scratch.stack.empty())
+                    {
+                        const Node_t &node=nodes[scratch.stack.back()];
+                        scratch.stack.pop_back();
+                        if (node.left<0)
+                        {
+                            for (size_t n=node.begin; n<node.end; n++)
                             {
-                                append(node->index,seeds);
+                                size_t i=order[n];
+                                if ((i!=index) && is_neighbour(p,points[i],points.dim,epsilon))
+                                {
+                                    if (!f(i))
+                                    {
+                                        return;
+                                    }
+                                }
                             }
-                            augData->ids[node->index]=(int)id;
+                            continue;
+                        }
+
+                        double x=p[node.dim];
+                        if (x+radius>=node.split)
+                        {
+                            scratch.stack.push_back(node.right);
+                        }
+                        if (x-radius<=node.split)
+                        {
+                            scratch.stack.push_back(node.left);
                         }
                     }
                 }
-            }
+            };
 
             /**********************************************************************/
-            bool expand(const size_t index, const size_t id, shared_ptr<Data_t> augData)
+            // the result is the one of the original recursive algorithm (see
+            // https://github.com/gyaikhom/dbscan): the core points, i.e. the ones
+            // with at least minpts neighbours, are found first (in parallel), then
+            // each cluster is grown from its first core point through its core points
+            template<typename T, class Index>
+            map<size_t,set<size_t>> run(const Points_t<T> &points, const Index &index,
+                                        const size_t minpts, const int threads)
             {
-                shared_ptr<Epsilon_neighbours_t> seeds=get_epsilon_neighbours(index,augData);
-                if (seeds->num_members<augData->minpts)
+                vector<unsigned char> core(points.num,0);
+                auto find_core=[&](const size_t begin, const size_t end) {
+                    typename Index::Scratch_t scratch;
+                    for (size_t i=begin; i<end; i++)
+                    {
+                        size_t num=0;
+                        if (num>=minpts)
+                        {
+                            core[i]=1;
+                            continue;
+                        }
+                        index.query(i,[&num,minpts](const size_t) { return (++num<minpts); },scratch);
+                        core[i]=(num>=minpts);
+                    }
+                };
+
+                size_t tasks=std::max(1,threads);
+                tasks=std::min(tasks,std::max<size_t>(1,points.num/1024));
+                if (tasks>1)
                 {
-                    augData->ids[index]=(int)PointType::noise;
-                    return false;
+                    vector<thread> workers;
+                    const size_t chunk=(points.num+tasks-1)/tasks;
+                    for (size_t t=1; t<tasks; t++)
+                    {
+                        workers.push_back(thread(find_core,std::min(points.num,t*chunk),
+                                                 std::min(points.num,(t+1)*chunk)));
+                    }
+                    find_core(0,std::min(points.num,chunk));
+                    for (auto &w : workers)
+                    {
+                        w.join();
+                    }
                 }
                 else
                 {
-                    augData->ids[index]=(int)id;
-                    for (shared_ptr<Node_t> h=seeds->head; h!=nullptr; h=h->next)
+                    find_core(0,points.num);
+                }
+
+                vector<int> ids(points.num,(int)PointType::unclassified);
+                vector<size_t> seeds;
+                typename Index::Scratch_t scratch;
+                int id=0;
+                for (size_t i=0; i<points.num; i++)
+                {
+                    if (ids[i]!=(int)PointType::unclassified)
                     {
-                        augData->ids[h->index]=(int)id;
+                        continue;
                     }
-                    for (shared_ptr<Node_t> h=seeds->head; h!=nullptr; h=h->next)
+                    if (!core[i])
                     {
-                        spread(h->index,seeds,id,augData);
+                        ids[i]=(int)PointType::noise;
+                        continue;
                     }
-                    return true;
+
+                    // the neighbours of the first point are taken also from
+                    // the clusters found so far, the others only if free
+                    ids[i]=id;
+                    seeds.clear();
+                    index.query(i,[&](const size_t j) {
+                        ids[j]=id;
+                        if (core[j])
+                        {
+                            seeds.push_back(j);
+                        }
+                        return true;
+                    },scratch);
+
+                    for (size_t s=0; s<seeds.size(); s++)
+                    {
+                        index.query(seeds[s],[&](const size_t j) {
+                            if (ids[j]==(int)PointType::unclassified)
+                            {
+                                ids[j]=id;
+                                if (core[j])
+                                {
+                                    seeds.push_back(j);
+                                }
+                            }
+                            else if (ids[j]==(int)PointType::noise)
+                            {
+                                ids[j]=id;
+                            }
+                            return true;
+                        },scratch);
+                    }
+                    id++;
+                }
+
+                map<size_t,set<size_t>> clusters;
+                for (size_t i=0; i<points.num; i++)
+                {
+                    if (ids[i]!=(int)PointType::noise)
+                    {
+                        clusters[ids[i]].insert(i);
+                    }
+                }
+                return clusters;
+            }
+
+            /**********************************************************************/
+            template<typename T>
+            map<size_t,set<size_t>> cluster(const Points_t<T> &points,
+                                            const Property &options)
+            {
+                double epsilon=options.check("epsilon",Value(1.0)).asFloat64();
+                size_t minpts=(size_t)options.check("minpts",Value(2)).asInt32();
+                int threads=options.check("threads",Value(1)).asInt32();
+
+                if (Grid_t<T>::usable(points,epsilon))
+                {
+                    return run(points,Grid_t<T>(points,epsilon),minpts,threads);
+                }
+                else if (KdTree_t<T>::usable(points,epsilon))
+                {
+                    return run(points,KdTree_t<T>(points,epsilon),minpts,threads);
+                }
+                else
+                {
+                    return run(points,BruteForce_t<T>(points,epsilon),minpts,threads);
                 }
             }
         }
@@ -152,30 +506,26 @@ namespace iCub {
 map<size_t,set<size_t>> DBSCAN::cluster(const vector<Vector> &data,
                                         const Property &options)
 {
-    double epsilon=options.check("epsilon",Value(1.0)).asFloat64();
-    size_t minpts=(size_t)options.check("minpts",Value(2)).asInt32();
-    shared_ptr<dbscan::Data_t> augData(new dbscan::Data_t(data,epsilon,minpts));
-
-    size_t id=0;
-    for (size_t i=0; i<augData->points.size(); i++)
+    size_t dim=data.empty() ? 0 : data[0].length();
+    vector<double> buffer(data.size()*dim);
+    for (size_t i=0; i<data.size(); i++)
     {
-        if (augData->ids[i]==(int)dbscan::PointType::unclassified)
+        for (size_t j=0; j<std::min(dim,data[i].length()); j++)
         {
-            if (dbscan::expand(i,id,augData))
-            {
-                id++;
-            }
+            buffer[i*dim+j]=data[i][j];
         }
     }
 
-    map<size_t,set<size_t>> clusters;
-    for (size_t i=0; i<augData->points.size(); i++)
-    {
-        if (augData->ids[i]!=(int)dbscan::PointType::noise)
-        {
-            clusters[augData->ids[i]].insert(i);
-        }
-    }
-    return clusters;
+    dbscan::Points_t<double> points(buffer.data(),data.size(),dim);
+    return dbscan::cluster(points,options);
+}
+
+
+/**********************************************************************/
+map<size_t,set<size_t>> DBSCAN::cluster(const float *data, const size_t num,
+                                        const size_t dim, const Property &options)
+{
+    dbscan::Points_t<float> points(data,num,dim);
+    return dbscan::cluster(points,options);
 }
 
@@ -31,20 +31,32 @@ Filter::Filter(const Vector &num, const Vector &den, const Vector &y0)
     m=b.length(); n=a.length();
     yAssert((m>0)&&(n>0));
 
-    uold.insert(uold.begin(),m-1,zeros((int)y0.length()));
-    yold.insert(yold.begin(),n-1,zeros((int)y0.length()));
-
+    resizeStates(y0.length());
     init(y0);    
 }
 
 
+/***************************************************************************/
+void Filter::resizeStates(const size_t channels)
+{
+    uold.assign((m-1)*channels,0.0);
+    yold.assign((n-1)*channels,0.0);
+    uhead=yhead=0;
+}
+
+
 /***************************************************************************/
 void Filter::init(const Vector &y0)
 {
     // take the last input
     // as guess for the next input
-    if (uold.size()>0)
-        init(y0,uold[0]);
+    if ((m>1) && (uold.size()==(m-1)*y0.length()))
+    {
+        Vector u0(y0.length());
+        for (size_t j=0; j<u0.length(); j++)
+            u0[j]=uold[uhead*y0.length()+j];
+        init(y0,u0);
+    }
     else    // otherwise use zero
         init(y0,zeros((int)y0.length()));    
 }
@@ -79,11 +91,15 @@ void Filter::init(const Vector &y0, const Vector &u0)
         // if sum_a==a[0] then the filter can only be initialized to zero
     }
     
-    for (size_t i=0; i<yold.size(); i++)
-        yold[i]=y_init;
+    const size_t len=y0.length();
+    resizeStates(len);
+    for (size_t i=0; i<n-1; i++)
+        for (size_t j=0; j<len; j++)
+            yold[i*len+j]=y_init[j];
     
-    for (size_t i=0; i<uold.size(); i++)
-        uold[i]=u_init;
+    for (size_t i=0; i<m-1; i++)
+        for (size_t j=0; j<std::min(len,u_init.length()); j++)
+            uold[i*len+j]=u_init[j];
 }
 
 
@@ -101,15 +117,10 @@ void Filter::setCoeffs(const Vector &num, const Vector &den)
     b=num;
     a=den;
 
-    uold.clear();
-    yold.clear();
-
     m=b.length(); n=a.length();
     yAssert((m>0)&&(n>0));
 
-    uold.insert(uold.begin(),m-1,zeros((int)y.length()));
-    yold.insert(yold.begin(),n-1,zeros((int)y.length()));
-
+    resizeStates(y.length());
     init(y);
 }
 
@@ -131,8 +142,22 @@ bool Filter::adjustCoeffs(const Vector &num, const Vector &den)
 /***************************************************************************/
 void Filter::getStates(deque<Vector> &u, deque<Vector> &y)
 {
-    u=uold;
-    y=yold;
+    const size_t len=this->y.length();
+    u.assign(m-1,Vector(len));
+    for (size_t i=0; i<m-1; i++)
+    {
+        const double *pold=&uold[((uhead+i)%(m-1))*len];
+        for (size_t j=0; j<len; j++)
+            u[i][j]=pold[j];
+    }
+
+    y.assign(n-1,Vector(len));
+    for (size_t i=0; i<n-1; i++)
+    {
+        const double *pold=&yold[((yhead+i)%(n-1))*len];
+        for (size_t j=0; j<len; j++)
+            y[i][j]=pold[j];
+    }
 }
 
 
@@ -140,30 +165,140 @@ void Filter::getStates(deque<Vector> &u, deque<Vector> &y)
 const Vector& Filter::filt(const Vector &u)
 {
     yAssert(y.length()==u.length());
-    for (size_t j=0; j<y.length(); j++)
-        y[j]=b[0]*u[j];
+    const size_t len=y.length();
+    double *py=y.data();
+    const double *pu=u.data();
+
+    // the loops run over the channels, which are contiguous in the buffers
+    for (size_t j=0; j<len; j++)
+        py[j]=b[0]*pu[j];
     
     for (size_t i=1; i<m; i++)
-        for (size_t j=0; j<y.length(); j++)
-            y[j]+=b[i]*uold[i-1][j];
+    {
+        const double bi=b[i];
+        const double *pold=&uold[((uhead+i-1)%(m-1))*len];
+        for (size_t j=0; j<len; j++)
+            py[j]+=bi*pold[j];
+    }
     
     for (size_t i=1; i<n; i++)
-        for (size_t j=0; j<y.length(); j++)
-            y[j]-=a[i]*yold[i-1][j];
+    {
+        const double ai=a[i];
+        const double *pold=&yold[((yhead+i-1)%(n-1))*len];
+        for (size_t j=0; j<len; j++)
+            py[j]-=ai*pold[j];
+    }
     
-    for (size_t j=0; j<y.length(); j++)
-        y[j]/=a[0];
+    const double a0=a[0];
+    for (size_t j=0; j<len; j++)
+        py[j]/=a0;
     
-    uold.push_front(u);
-    uold.pop_back();
+    // the oldest samples are overwritten by the new ones, which become the first
+    if (m>1)
+    {
+        uhead=(uhead+m-2)%(m-1);
+        std::copy(pu,pu+len,uold.begin()+uhead*len);
+    }
     
-    yold.push_front(y);
-    yold.pop_back();
+    if (n>1)
+    {
+        yhead=(yhead+n-2)%(n-1);
+        std::copy(py,py+len,yold.begin()+yhead*len);
+    }
     
     return y;
 }
 
 
+/***************************************************************************/
+SOSFilter::SOSFilter(const Matrix &sos, const double g, const Vector &y0)
+{
+    yAssert(sos.cols()==6);
+    sections=sos.rows();
+    gain=g;
+
+    coeffs.resize(5*sections);
+    for (size_t s=0; s<sections; s++)
+    {
+        const double a0=sos(s,3);
+        yAssert(a0!=0.0);
+        coeffs[5*s]  =sos(s,0)/a0;
+        coeffs[5*s+1]=sos(s,1)/a0;
+        coeffs[5*s+2]=sos(s,2)/a0;
+        coeffs[5*s+3]=sos(s,4)/a0;
+        coeffs[5*s+4]=sos(s,5)/a0;
+    }
+
+    init(y0);
+}
+
+
+/***************************************************************************/
+void SOSFilter::init(const Vector &y0)
+{
+    const size_t len=y0.length();
+    y=y0;
+    states.assign(2*sections*len,0.0);
+
+    // DC gain of the whole cascade
+    double dc=gain;
+    for (size_t s=0; s<sections; s++)
+    {
+        const double *c=&coeffs[5*s];
+        dc*=(c[0]+c[1]+c[2])/(1.0+c[3]+c[4]);
+    }
+    if (!std::isfinite(dc) || (fabs(dc)<=std::numeric_limits<double>::epsilon()))
+        return;
+
+    // the states of each section with the constant input leading to y0
+    for (size_t j=0; j<len; j++)
+    {
+        double x=gain*y0[j]/dc;
+        for (size_t s=0; s<sections; s++)
+        {
+            const double *c=&coeffs[5*s];
+            const double ys=x*(c[0]+c[1]+c[2])/(1.0+c[3]+c[4]);
+            double *z=&states[2*s*len];
+            z[len+j]=c[2]*x-c[4]*ys;
+            z[j]=c[1]*x-c[3]*ys+z[len+j];
+            x=ys;
+        }
+    }
+}
+
+
+/***************************************************************************/
+const Vector& SOSFilter::filt(const Vector &u)
+{
+    yAssert(y.length()==u.length());
+    const size_t len=y.length();
+    double *py=y.data();
+    const double *pu=u.data();
+
+    for (size_t j=0; j<len; j++)
+        py[j]=gain*pu[j];
+
+    // each section takes the output of the previous one, in place
+    for (size_t s=0; s<sections; s++)
+    {
+        const double b0=coeffs[5*s], b1=coeffs[5*s+1], b2=coeffs[5*s+2];
+        const double a1=coeffs[5*s+3], a2=coeffs[5*s+4];
+        double *z1=&states[2*s*len];
+        double *z2=z1+len;
+        for (size_t j=0; j<len; j++)
+        {
+            const double x=py[j];
+            const double out=b0*x+z1[j];
+            z1[j]=b1*x-a1*out+z2[j];
+            z2[j]=b2*x-a2*out;
+            py[j]=out;
+        }
+    }
+
+    return y;
+}
+
+
 /**********************************************************************/
 RateLimiter::RateLimiter(const Vector &rL, const Vector &rU) :
                          rateLowerLim(rL), rateUpperLim(rU)
@@ -292,6 +427,88 @@ void FirstOrderLowPassFilter::computeCoeff()
 }
 
 
+namespace iCub {
+    namespace ctrl {
+        namespace median {
+            // the heaps contain the slots of the window, ordered by their
+            // values: the lower heap is a max-heap, the upper one a min-heap
+
+            /***************************************************************************/
+            inline bool before(const double *val, const bool upper, const size_t a,
+                               const size_t b)
+            {
+                return (upper ? (val[a]<val[b]) : (val[a]>val[b]));
+            }
+
+            /***************************************************************************/
+            inline void place(size_t *slots, int *where, const bool upper,
+                              const size_t pos, const size_t slot)
+            {
+                slots[pos]=slot;
+                where[slot]=(upper ? -(int)pos-1 : (int)pos);
+            }
+
+            /***************************************************************************/
+            void sift_up(const double *val, size_t *slots, int *where,
+                         const bool upper, size_t pos)
+            {
+                const size_t slot=slots[pos];
+                while (pos>0)
+                {
+                    size_t parent=(pos-1)>>1;
+                    if (!before(val,upper,slot,slots[parent]))
+                        break;
+                    place(slots,where,upper,pos,slots[parent]);
+                    pos=parent;
+                }
+                place(slots,where,upper,pos,slot);
+            }
+
+            /***************************************************************************/
+            void sift_down(const double *val, size_t *slots, int *where,
+                           const bool upper, const size_t size, size_t pos)
+            {
+                const size_t slot=slots[pos];
+                while (true)
+                {
+                    size_t child=(pos<<1)+1;
+                    if (child>=size)
+                        break;
+                    if ((child+1<size) && before(val,upper,slots[child+1],slots[child]))
+                        child++;
+                    if (!before(val,upper,slots[child],slot))
+                        break;
+                    place(slots,where,upper,pos,slots[child]);
+                    pos=child;
+                }
+                place(slots,where,upper,pos,slot);
+            }
+
+            /***************************************************************************/
+            void push(const double *val, size_t *slots, int *where, const bool upper,
+                      size_t &size, const size_t slot)
+            {
+                place(slots,where,upper,size,slot);
+                sift_up(val,slots,where,upper,size++);
+            }
+
+            /***************************************************************************/
+            void erase(const double *val, size_t *slots, int *where, const bool upper,
+                       size_t &size, const size_t pos)
+            {
+                const size_t last=slots[--size];
+                if (pos<size)
+                {
+                    place(slots,where,upper,pos,last);
+                    sift_up(val,slots,where,upper,pos);
+                    sift_down(val,slots,where,upper,size,(size_t)(upper ? -where[last]-1 : where[last]));
+                }
+            }
+        }
+    }
+}
+
+
 /***************************************************************************/
 MedianFilter::MedianFilter(const size_t n, const Vector &y0)
 {
@@ -306,7 +523,14 @@ void MedianFilter::init(const Vector &y0)
     yAssert(y0.length()>0);
     y=y0;
     m=y.length();
-    uold.assign(m,deque<double>());
+
+    const size_t W=n+1;
+    uold.assign(m*W,0.0);
+    heaps.assign(2*m*W,0);
+    where.assign(m*W,0);
+    loSize.assign(m,0);
+    hiSize.assign(m,0);
+    head=count=0;
 }
 
 
@@ -319,39 +543,68 @@ void MedianFilter::setOrder(const size_t n)
 }
 
 
-/***************************************************************************/
-double MedianFilter::median(deque<double>& v)
-{
-    size_t L=v.size()>>1;
-    nth_element(v.begin(),v.begin()+L,v.end());
-    if (v.size()&0x01)
-        return v[L];
-    else
-    {
-        nth_element(v.begin(),v.begin()+L-1,v.end());
-        return 0.5*(v[L]+v[L-1]);
-    }
-}
-
-
 /***************************************************************************/
 const Vector& MedianFilter::filt(const Vector &u)
 {
     yAssert(y.length()==u.length());
-    for (size_t i=0; i<m; i++)
-        uold[i].push_front(u[i]);
+    const size_t W=n+1;
+    const bool full=(count==W);
+    const size_t slot=(full ? head : count);
+    const size_t total=(full ? W : count+1);
 
-    if (uold[0].size()>n)
+    for (size_t i=0; i<m; i++)
     {
-        for (size_t i=0; i<m; i++)
+        double *val=&uold[i*W];
+        size_t *lo=&heaps[2*i*W];
+        size_t *hi=lo+W;
+        int *wh=&where[i*W];
+        size_t &nlo=loSize[i];
+        size_t &nhi=hiSize[i];
+
+        // the new sample replaces the oldest one
+        if (full)
+        {
+            if (wh[slot]>=0)
+                median::erase(val,lo,wh,false,nlo,wh[slot]);
+            else
+                median::erase(val,hi,wh,true,nhi,-wh[slot]-1);
+        }
+
+        val[slot]=u[i];
+        if (((nlo>0) && (val[slot]<=val[lo[0]])) ||
+            ((nlo==0) && ((nhi==0) || (val[slot]<=val[hi[0]]))))
+            median::push(val,lo,wh,false,nlo,slot);
+        else
+            median::push(val,hi,wh,true,nhi,slot);
+
+        // the lower heap holds the median (or the lower of the two middle samples)
+        while (nlo>total-(total>>1))
         {
-            deque<double> tmp=uold[i];
-            y[i]=median(tmp);
-            uold[i].pop_back();
+            size_t top=lo[0];
+            median::erase(val,lo,wh,false,nlo,0);
+            median::push(val,hi,wh,true,nhi,top);
+        }
+        while (nlo<total-(total>>1))
+        {
+            size_t top=hi[0];
+            median::erase(val,hi,wh,true,nhi,0);
+            median::push(val,lo,wh,false,nlo,top);
+        }
+
+        if (total==W)
+        {
+            if (W&0x01)
+                y[i]=val[lo[0]];
+            else
+                y[i]=0.5*(val[hi[0]]+val[lo[0]]);
         }
     }
 
+    if (full)
+        head=(head+1)%W;
+    else
+        count++;
+
     return y;
 }
 
-
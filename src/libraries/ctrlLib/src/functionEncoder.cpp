@@ -17,14 +17,11 @@
 */
 
 #include <algorithm>
-
-#include <gsl/gsl_integration.h>
+#include <cmath>
 
 #include <yarp/math/Math.h>
 #include <iCub/ctrl/functionEncoder.h>
 
-#define CAST_GSLFUNC(x)     (static_cast<gsl_function*>(x))
-#define CAST_GSLWS(x)       (static_cast<gsl_integration_workspace*>(x))
 #define WAVELET_LUP_SIZE    57
 
 using namespace yarp::os;
@@ -94,16 +91,6 @@ namespace ctrl
                                           { 6.750,                   0.0 },
                                           { 6.875,                   0.0 },
                                           { 7.000,                   0.0 } };
-
-    /************************************************************************/
-    double waveletIntegrand(double x, void *params)
-    {
-        WaveletEncoder *pWavEnc=(WaveletEncoder*)params;
-        const Vector &values=*pWavEnc->pVal;
-        unsigned int n=pWavEnc->iCoeff;
-        double R=pWavEnc->resolution;
-        return (pWavEnc->interpFunction(values,x)-values[0]) * (R*pWavEnc->interpWavelet(R*x-n));
-    }
 }
 
 }
@@ -113,11 +100,8 @@ namespace ctrl
 WaveletEncoder::WaveletEncoder()
 {
     resolution=(WAVELET_LUP_SIZE-1)/2.0;
-    w=gsl_integration_workspace_alloc(1000);
-    F=new gsl_function;
-
-    CAST_GSLFUNC(F)->function=&waveletIntegrand;
-    CAST_GSLFUNC(F)->params=(void*)this;
+    weightsLength=0;
+    weightsResolution=0.0;
 }
 
 
@@ -140,29 +124,83 @@ double WaveletEncoder::interpWavelet(const double x)
 
 
 /************************************************************************/
-double WaveletEncoder::interpFunction(const Vector &values, const double x)
+void WaveletEncoder::computeWeights(const size_t length)
 {
-    // x shall be in [0,1]
-    double L=(double)values.size()-1.0;
+    if ((length==weightsLength) && (resolution==weightsResolution))
+        return;
 
-    if (x<=0.0)
-        return values[0];
-    else if (x>=1.0)
-        return values[(size_t)L];
-    else
+    unsigned int N=(unsigned int)resolution+1;
+    double R=resolution;
+    double L=(double)length-1.0;
+    double uMax=waveLUP[WAVELET_LUP_SIZE-1][0];
+    double du=uMax/(double)(WAVELET_LUP_SIZE-1);
+
+    weightsFirst.assign(N,0);
+    weightsOffset.assign(N+1,0);
+    weights.clear();
+
+    // the coefficient n is the integral of f(x)*R*psi(R*x-n) over the
+    // support of the wavelet, i.e. of f((u+n)/R)*psi(u) in du, where f
+    // interpolates the samples linearly over [0,1] and holds the last
+    // one beyond; on each interval between the breakpoints of f and
+    // psi the integrand is quadratic, hence Simpson's rule is exact
+    for (unsigned int n=0; n<N; n++)
     {
-        size_t i=(size_t)(x*L);
-        double x0=((double)i)/L;
-        double y0=values[i];
-
-        if (++i>L)
-            i=(size_t)L;
-
-        double x1=((double)i)/L;
-        double y1=values[i];
-
-        return ((x-x0)/(x1-x0))*(y1-y0)+y0;
+        weightsOffset[n]=weights.size();
+        if ((length<2) || (R<=0.0))
+        {
+            weightsFirst[n]=0;
+            weights.push_back(0.0);
+            continue;
+        }
+
+        double x0=n/R;
+        size_t i=(x0>=1.0)?(size_t)L:(size_t)(x0*L);
+        size_t first=i;
+        weightsFirst[n]=first;
+
+        unsigned int j=0;
+        double a=0.0;
+        while ((a<uMax) && (j<WAVELET_LUP_SIZE-1))
+        {
+            double bLUP=(j+1)*du;
+            double bGrid=(i<(size_t)L)?(R*(i+1))/L-n:uMax;
+            double b=std::min(std::min(bLUP,bGrid),uMax);
+
+            // psi and the hat function of the sample i+1 at a, (a+b)/2, b
+            double uu[3]={a, 0.5*(a+b), b};
+            double psi[3],t[3];
+            for (int k=0; k<3; k++)
+            {
+                psi[k]=waveLUP[j][1]+(uu[k]-j*du)*(waveLUP[j+1][1]-waveLUP[j][1])/du;
+                t[k]=(i<(size_t)L)?((uu[k]+n)*L/R-i):0.0;
+            }
+
+            double h=(b-a)/6.0;
+            double wi=h*(psi[0]*(1.0-t[0])+4.0*psi[1]*(1.0-t[1])+psi[2]*(1.0-t[2]));
+            double wn=h*(psi[0]*t[0]+4.0*psi[1]*t[1]+psi[2]*t[2]);
+
+            size_t pos=weightsOffset[n]+(i-first);
+            if (weights.size()<pos+2)
+                weights.resize(pos+2,0.0);
+            weights[pos]+=wi;
+            weights[pos+1]+=wn;
+
+            if (bLUP<=b)
+                j++;
+            if ((bGrid<=b) && (i<(size_t)L))
+                i++;
+            a=b;
+        }
+
+        // drop the trailing weight beyond the last sample
+        if (weightsFirst[n]+(weights.size()-weightsOffset[n])>length)
+            weights.pop_back();
     }
+    weightsOffset[N]=weights.size();
+
+    weightsLength=length;
+    weightsResolution=resolution;
 }
 
 
@@ -195,19 +233,20 @@ Property WaveletEncoder::getEncoderOptions()
 Code WaveletEncoder::encode(const Vector &values)
 {
     Code code;
-    pVal=&values;
     unsigned int N=(unsigned int)resolution+1;    
     code.coefficients.resize(N+1);
-    double error;
+    computeWeights(values.length());
 
+    // the function is encoded with respect to f(0)
     code.coefficients[0]=values[0];
-    for (iCoeff=0; iCoeff<N; iCoeff++)
+    for (unsigned int n=0; n<N; n++)
     {
-        double tau1=(waveLUP[0][0]+iCoeff)/resolution;
-        double tau2=(waveLUP[WAVELET_LUP_SIZE-1][0]+iCoeff)/resolution;
+        const double *v=values.data()+weightsFirst[n];
+        double c=0.0;
+        for (size_t k=weightsOffset[n]; k<weightsOffset[n+1]; k++, v++)
+            c+=weights[k]*(*v-values[0]);
 
-        gsl_integration_qag(CAST_GSLFUNC(F),tau1,tau2,1e-3,1e-2,1000,GSL_INTEG_GAUSS61,CAST_GSLWS(w),
-                            &code.coefficients[iCoeff+1],&error);
+        code.coefficients[n+1]=c;
     }
 
     return code;
@@ -215,25 +254,31 @@ Code WaveletEncoder::encode(const Vector &values)
 
 
 /************************************************************************/
-double WaveletEncoder::decode(const Code &code, const double x)
+std::deque<Code> WaveletEncoder::encode(const std::deque<Vector> &values)
 {
-    unsigned int N=(unsigned int)resolution+1;
-    double decodedVal=code.coefficients[0];
+    std::deque<Code> codes;
+    for (size_t i=0; i<values.size(); i++)
+        codes.push_back(encode(values[i]));
 
-    // compute the linear combination of wavelets
-    for (unsigned int n=0; n<N; n++)
-        decodedVal+=code.coefficients[n+1]*interpWavelet(resolution*x-n);
-
-    return decodedVal;
+    return codes;
 }
 
 
 /************************************************************************/
-WaveletEncoder::~WaveletEncoder()
+double WaveletEncoder::decode(const Code &code, const double x)
 {
-    gsl_integration_workspace_free(CAST_GSLWS(w));
-    delete CAST_GSLFUNC(F);
-}
+    unsigned int N=(unsigned int)resolution+1;
+    double decodedVal=code.coefficients[0];
 
+    // compute the linear combination of the wavelets whose
+    // support [n,n+7] contains resolution*x
+    double u=resolution*x;
+    double uMax=waveLUP[WAVELET_LUP_SIZE-1][0];
+    unsigned int n0=(u>uMax)?(unsigned int)std::ceil(u-uMax):0;
+    unsigned int n1=(u<0.0)?0:std::min(N,(unsigned int)std::floor(u)+1);
+    for (unsigned int n=n0; n<n1; n++)
+        decodedVal+=code.coefficients[n+1]*interpWavelet(u-n);
 
+    return decodedVal;
+}
 
@@ -11,6 +11,7 @@
 #include <sstream>
 #include <cmath>
 
+#include <yarp/os/Log.h>
 #include <yarp/os/Time.h>
 #include <yarp/math/Math.h>
 #include <iCub/ctrl/minJerkCtrl.h>
@@ -565,3 +566,196 @@ void minJerkRefGen::computeNextValues(const yarp::sig::Vector &y, const yarp::si
 }
 
 
+/*******************************************************************************************/
+minJerkTrajGenBank::minJerkTrajGenBank(const unsigned int _dim, const double _Ts, const double _T)
+    :T(_dim,_T), Ts(_Ts), dim(_dim)
+{
+    coeffs.assign(numCoeffs*dim,0.0);
+    states.assign(numStates*dim,0.0);
+    for (unsigned int i=0; i<dim; i++)
+        computeCoeffs(i);
+    init(zeros(dim));
+}
+
+
+/*******************************************************************************************/
+minJerkTrajGenBank::minJerkTrajGenBank(const Vector &_y0, const double _Ts, const Vector &_T)
+    :T(_T), Ts(_Ts), dim((unsigned int)_y0.size())
+{
+    yAssert(T.length()==dim);
+    coeffs.assign(numCoeffs*dim,0.0);
+    states.assign(numStates*dim,0.0);
+    for (unsigned int i=0; i<dim; i++)
+        computeCoeffs(i);
+    init(_y0);
+}
+
+
+/*******************************************************************************************/
+const minJerkTrajGenBank::Coeffs &minJerkTrajGenBank::getCoeffs(const double _T)
+{
+    pair<double,double> key(_T,Ts);
+    map<pair<double,double>,Coeffs>::iterator it=cache.find(key);
+    if (it!=cache.end())
+        return it->second;
+
+    // the reference times may keep changing: bound the cache
+    if (cache.size()>=64)
+        cache.clear();
+
+    // the same discretization as minJerkTrajGen::computeCoeffs()
+    double a = -150.765868956161/(_T*_T*_T);
+    double b = -84.9812819469538/(_T*_T);
+    double c = -15.9669610709384/_T;
+
+    Coeffs &C=cache[key];
+
+    // implementing F(s)=-a/(s^3-c*s^2-b*s-a)
+    double m = 4.0*c*Ts;
+    double n = 2.0*b*Ts*Ts;
+    double p = a*Ts*Ts*Ts;
+    C.c[bp0]=p; C.c[bp1]=3.0*p; C.c[bp2]=3.0*p; C.c[bp3]=p;
+    C.c[a0]=m+n+p-8.0; C.c[a1]=-m+n+3.0*p+24.0; C.c[a2]=-m-n+3.0*p-24.0; C.c[a3]=m-n+p+8.0;
+
+    // implementing F(s)=-a*s/(s^3-c*s^2-b*s-a)
+    p = 2.0*a*Ts*Ts;
+    C.c[bv0]=p; C.c[bv1]=p; C.c[bv2]=-p; C.c[bv3]=-p;
+
+    // implementing F(s)=-a*s^2/(s^3-c*s^2-b*s-a)
+    p = 4.0*a*Ts;
+    C.c[ba0]=p; C.c[ba1]=-p; C.c[ba2]=-p; C.c[ba3]=p;
+
+    return C;
+}
+
+
+/*******************************************************************************************/
+void minJerkTrajGenBank::computeCoeffs(const unsigned int i)
+{
+    const Coeffs &C=getCoeffs(T[i]);
+    for (int k=0; k<numCoeffs; k++)
+        coeff(k)[i]=C.c[k];
+}
+
+
+/*******************************************************************************************/
+void minJerkTrajGenBank::init(const Vector &y0)
+{
+    yAssert(y0.length()==dim);
+    pos=y0;
+    vel=acc=zeros(dim);
+
+    for (unsigned int i=0; i<dim; i++)
+    {
+        // as Filter::init(): the position filter starts from its steady
+        // state, the velocity and acceleration filters (whose DC gain is
+        // zero) from a null output and from y0 as last input
+        double sum_b=0.0, sum_a=0.0;
+        for (int k=0; k<4; k++)
+        {
+            sum_b+=coeff(bp0+k)[i];
+            sum_a+=coeff(a0+k)[i];
+        }
+        double u0=(sum_a/sum_b)*y0[i];
+
+        state(up1)[i]=state(up2)[i]=state(up3)[i]=u0;
+        state(uv1)[i]=state(uv2)[i]=state(uv3)[i]=y0[i];
+        state(yp1)[i]=state(yp2)[i]=state(yp3)[i]=y0[i];
+        state(yv1)[i]=state(yv2)[i]=state(yv3)[i]=0.0;
+        state(ya1)[i]=state(ya2)[i]=state(ya3)[i]=0.0;
+    }
+}
+
+
+/*******************************************************************************************/
+void minJerkTrajGenBank::computeNextValues(const Vector &yd)
+{
+    yAssert(yd.length()==dim);
+    const double *u=yd.data();
+    double *p=pos.data(), *v=vel.data(), *ac=acc.data();
+
+    const double *Bp0=coeff(bp0), *Bp1=coeff(bp1), *Bp2=coeff(bp2), *Bp3=coeff(bp3);
+    const double *Bv0=coeff(bv0), *Bv1=coeff(bv1), *Bv2=coeff(bv2), *Bv3=coeff(bv3);
+    const double *Ba0=coeff(ba0), *Ba1=coeff(ba1), *Ba2=coeff(ba2), *Ba3=coeff(ba3);
+    const double *A0=coeff(a0), *A1=coeff(a1), *A2=coeff(a2), *A3=coeff(a3);
+    double *Up1=state(up1), *Up2=state(up2), *Up3=state(up3);
+    double *Uv1=state(uv1), *Uv2=state(uv2), *Uv3=state(uv3);
+    double *Yp1=state(yp1), *Yp2=state(yp2), *Yp3=state(yp3);
+    double *Yv1=state(yv1), *Yv2=state(yv2), *Yv3=state(yv3);
+    double *Ya1=state(ya1), *Ya2=state(ya2), *Ya3=state(ya3);
+
+    // the operations are the ones of Filter::filt(), in the same order
+    for (unsigned int i=0; i<dim; i++)
+    {
+        double yp=Bp0[i]*u[i];
+        yp+=Bp1[i]*Up1[i]; yp+=Bp2[i]*Up2[i]; yp+=Bp3[i]*Up3[i];
+        yp-=A1[i]*Yp1[i]; yp-=A2[i]*Yp2[i]; yp-=A3[i]*Yp3[i];
+        yp/=A0[i];
+
+        double yv=Bv0[i]*u[i];
+        yv+=Bv1[i]*Uv1[i]; yv+=Bv2[i]*Uv2[i]; yv+=Bv3[i]*Uv3[i];
+        yv-=A1[i]*Yv1[i]; yv-=A2[i]*Yv2[i]; yv-=A3[i]*Yv3[i];
+        yv/=A0[i];
+
+        double ya=Ba0[i]*u[i];
+        ya+=Ba1[i]*Uv1[i]; ya+=Ba2[i]*Uv2[i]; ya+=Ba3[i]*Uv3[i];
+        ya-=A1[i]*Ya1[i]; ya-=A2[i]*Ya2[i]; ya-=A3[i]*Ya3[i];
+        ya/=A0[i];
+
+        Up3[i]=Up2[i]; Up2[i]=Up1[i]; Up1[i]=u[i];
+        Uv3[i]=Uv2[i]; Uv2[i]=Uv1[i]; Uv1[i]=u[i];
+        Yp3[i]=Yp2[i]; Yp2[i]=Yp1[i]; Yp1[i]=yp;
+        Yv3[i]=Yv2[i]; Yv2[i]=Yv1[i]; Yv1[i]=yv;
+        Ya3[i]=Ya2[i]; Ya2[i]=Ya1[i]; Ya1[i]=ya;
+
+        p[i]=yp; v[i]=yv; ac[i]=ya;
+    }
+}
+
+
+/*******************************************************************************************/
+bool minJerkTrajGenBank::setT(const unsigned int i, const double _T)
+{
+    if ((i>=dim) || (_T<=0.0))
+        return false;
+
+    T[i]=_T;
+    computeCoeffs(i);
+
+    // as minJerkTrajGen, init the velocity and acceleration filters
+    // to avoid spikes
+    state(uv1)[i]=state(uv2)[i]=state(uv3)[i]=pos[i];
+    state(yv1)[i]=state(yv2)[i]=state(yv3)[i]=0.0;
+    state(ya1)[i]=state(ya2)[i]=state(ya3)[i]=0.0;
+    return true;
+}
+
+
+/*******************************************************************************************/
+bool minJerkTrajGenBank::setT(const Vector &_T)
+{
+    if (_T.length()!=dim)
+        return false;
+
+    for (unsigned int i=0; i<dim; i++)
+        if (_T[i]<=0.0)
+            return false;
+
+    for (unsigned int i=0; i<dim; i++)
+        setT(i,_T[i]);
+    return true;
+}
+
+
+/*******************************************************************************************/
+bool minJerkTrajGenBank::setTs(const double _Ts)
+{
+    if (_Ts<=0.0)
+        return false;
+
+    Ts=_Ts;
+    for (unsigned int i=0; i<dim; i++)
+        setT(i,T[i]);
+    return true;
+}
+
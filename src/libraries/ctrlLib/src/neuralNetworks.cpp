@@ -12,6 +12,7 @@
 #include <iomanip>
 #include <cmath>
 
+#include <yarp/os/Log.h>
 #include <yarp/math/Math.h>
 #include <iCub/ctrl/neuralNetworks.h>
 
@@ -256,6 +257,150 @@ Vector ff2LayNN::predict(const Vector &x) const
 }
 
 
+/***************************************************************************/
+static void layer(const Matrix &in, const Matrix &W, const Matrix &WT,
+                  const Vector &bias, Matrix &out)
+{
+    // out=in*W^T+bias row by row: the nodes are taken in blocks of 8
+    // whose sums are kept in registers while running over the inputs
+    // (through WT), whereas each of the remaining nodes is a dot
+    // product split in 8 partial sums (through W)
+    const size_t N=in.rows();
+    const size_t I=in.cols();
+    const size_t H=W.rows();
+    for (size_t n=0; n<N; n++)
+    {
+        const double *x=in[n];
+        double *y=out[n];
+
+        size_t h=0;
+        for (; h+8<=H; h+=8)
+        {
+            double s[8];
+            for (size_t k=0; k<8; k++)
+                s[k]=bias[h+k];
+
+            for (size_t i=0; i<I; i++)
+            {
+                const double *w=WT[i]+h;
+                for (size_t k=0; k<8; k++)
+                    s[k]+=w[k]*x[i];
+            }
+
+            for (size_t k=0; k<8; k++)
+                y[h+k]=s[k];
+        }
+
+        for (; h<H; h++)
+        {
+            const double *w=W[h];
+            double s[8]={0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+
+            size_t i=0;
+            for (; i+8<=I; i+=8)
+                for (size_t k=0; k<8; k++)
+                    s[k]+=w[i+k]*x[i+k];
+
+            double sum=bias[h];
+            for (; i<I; i++)
+                sum+=w[i]*x[i];
+
+            y[h]=sum+((s[0]+s[1])+(s[2]+s[3]))+((s[4]+s[5])+(s[6]+s[7]));
+        }
+    }
+}
+
+
+/***************************************************************************/
+Matrix ff2LayNN::predict(const Matrix &X) const
+{
+    if (configured)
+    {
+        const size_t N=X.rows();
+        const size_t I=inMinX.length();
+        const size_t H=IW.size();
+        const size_t O=LW.size();
+        yAssert(X.cols()==I);
+
+        // the weights are also transposed so that the nodes fed by
+        // the same input are contiguous
+        Matrix W(H,I),WT(I,H);
+        for (size_t h=0; h<H; h++)
+            for (size_t i=0; i<I; i++)
+                WT(i,h)=W(h,i)=IW[h][i];
+
+        Matrix V(O,H),VT(H,O);
+        for (size_t o=0; o<O; o++)
+            for (size_t h=0; h<H; h++)
+                VT(h,o)=V(o,h)=LW[o][h];
+
+        // input preprocessing
+        Matrix X1(N,I);
+        for (size_t n=0; n<N; n++)
+        {
+            const double *x=X[n];
+            double *x1=X1[n];
+            for (size_t i=0; i<I; i++)
+                x1[i]=inRatio[i]*(x[i]-inMinX[i])+inMinY[i];
+        }
+
+        // compute the output a1 of hidden layer
+        Matrix A1(N,H);
+        layer(X1,W,WT,b1,A1);
+        hiddenLayerFcnBatch(A1.data(),N,H);
+
+        // compute the output a2 of the network
+        Matrix A2(N,O);
+        layer(A1,V,VT,b2,A2);
+        outputLayerFcnBatch(A2.data(),N,O);
+
+        // output postprocessing
+        for (size_t n=0; n<N; n++)
+        {
+            double *a2=A2[n];
+            for (size_t o=0; o<O; o++)
+                a2[o]=outRatio[o]*(a2[o]-outMinY[o])+outMinX[o];
+        }
+
+        return A2;
+    }
+    else
+        return Matrix(1,1);
+}
+
+
+/***************************************************************************/
+void ff2LayNN::hiddenLayerFcnBatch(double *x, const size_t rows, const size_t cols) const
+{
+    Vector n(cols);
+    for (size_t r=0; r<rows; r++, x+=cols)
+    {
+        for (size_t c=0; c<cols; c++)
+            n[c]=x[c];
+
+        Vector a=hiddenLayerFcn(n);
+        for (size_t c=0; c<cols; c++)
+            x[c]=a[c];
+    }
+}
+
+
+/***************************************************************************/
+void ff2LayNN::outputLayerFcnBatch(double *x, const size_t rows, const size_t cols) const
+{
+    Vector n(cols);
+    for (size_t r=0; r<rows; r++, x+=cols)
+    {
+        for (size_t c=0; c<cols; c++)
+            n[c]=x[c];
+
+        Vector a=outputLayerFcn(n);
+        for (size_t c=0; c<cols; c++)
+            x[c]=a[c];
+    }
+}
+
+
 /***************************************************************************/
 bool ff2LayNN::getStructure(Property &options) const
 {
@@ -388,6 +533,22 @@ Vector ff2LayNN_tansig_purelin::outputLayerFcn(const Vector &x) const
 }
 
 
+/***************************************************************************/
+void ff2LayNN_tansig_purelin::hiddenLayerFcnBatch(double *x, const size_t rows,
+                                                  const size_t cols) const
+{
+    const size_t len=rows*cols;
+    for (size_t i=0; i<len; i++)
+        x[i]=fastTanh(x[i]);
+}
+
+
+/***************************************************************************/
+void ff2LayNN_tansig_purelin::outputLayerFcnBatch(double*, const size_t, const size_t) const
+{
+}
+
+
 /***************************************************************************/
 Vector ff2LayNN_tansig_purelin::hiddenLayerGrad(const Vector &x) const
 {
@@ -22,6 +22,40 @@ using namespace yarp::math;
 using namespace iCub::ctrl;
 
 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+static double frobenius(const Matrix &M)
+{
+    double s=0.0;
+    for (size_t r=0; r<M.rows(); r++)
+        for (size_t c=0; c<M.cols(); c++)
+            s+=M(r,c)*M(r,c);
+    return sqrt(s);
+}
+
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+static bool converged(const Matrix &Tnew, const Matrix &Told, double tol)
+{
+    return (frobenius(Tnew-Told)<=tol*frobenius(Tnew));
+}
+
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+static void mulNeg(const Matrix &L, const Vector &x, Vector &ret)
+{
+    if (ret.length()!=L.rows())
+        ret.resize(L.rows());
+
+    for (size_t r=0; r<L.rows(); r++)
+    {
+        double s=0.0;
+        for (size_t c=0; c<L.cols(); c++)
+            s-=L(r,c)*x[c];
+        ret[r]=s;
+    }
+}
+
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 Riccati::Riccati(const Matrix &_A, const Matrix &_B, const Matrix &_V,
                  const Matrix &_P, const Matrix &_VN, bool verb) 
@@ -36,15 +70,26 @@ Riccati::Riccati(const Matrix &_A, const Matrix &_B, const Matrix &_V,
     Li = new Matrix[1]; Li[0].resize(1,1); Li[0].zero();
 
     n=A.rows();
-    m=B.rows();
+    m=B.cols();
     N=-1;
 
+    stationary=false;
+    convTol=0.0;
+
     verbose=verb;
     if (verbose)
         yWarning("Riccati: problem defined, unsolved.");
 }
 
 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+Riccati::~Riccati()
+{
+    delete [] Ti;
+    delete [] Li;
+}
+
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void Riccati::setVerbose(bool verb)
 {
@@ -101,9 +146,12 @@ void Riccati::setProblemData(const Matrix &_A, const Matrix &_B, const Matrix &_
     VN = _VN;
 
     n=A.rows();
-    m=B.rows();
+    m=B.cols();
     N=-1;
 
+    // Ts is kept to warm-start the next stationary solution
+    stationary=false;
+
     if (verbose)
         yWarning("Riccati: problem defined, unsolved.");
 }
@@ -122,22 +170,119 @@ void Riccati::solveRiccati(int steps)
         Ti[i].resize(VN.rows(),VN.cols());		
     //init TN=VN
     Ti[steps]=VN;
-    //compute backward all Ti
+    //compute backward all Ti, until they converge (if detection is enabled)
+    int c=-1;
     for(i=steps-1; i>=0; i--)
     {
+        if (c>=0)
+        {
+            Ti[i]=Ti[c];
+            continue;
+        }
         lastT=Ti[i+1]; 
         //Ti = V + A' * (Ti+1 - Ti+1 * B * (P + B' * Ti+1 * B)^-1 * B' * Ti+1 )* A;
         Ti[i] = V + At *(lastT - lastT * B* pinv(P+Bt*lastT*B)*Bt*lastT )* A; 
+        if ((convTol>0.0) && converged(Ti[i],lastT,convTol))
+            c=i;
     }
-    //compute forward all Li
-    for(i=0;i<steps; i++)
+    //compute all Li, which are equal where Ti+1 has converged
+    for(i=steps-1; i>=0; i--)
     {
+        if (i+2<=c)
+        {
+            Li[i]=Li[i+1];
+            continue;
+        }
         //Li = (P + B' * Ti+1 * B)^-1 * B' * Ti+1 * A
         Li[i] = pinv(P + Bt*Ti[i+1]*B) *Bt * Ti[i+1] * A;	
     }
 
     if (verbose)
+    {
         yInfo("Riccati: DARE solved, matrices Li and Ti computed and stored.");
+        if (c>=0)
+            yInfo("Riccati: DARE converged at step %d.",c);
+    }
+}
+
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void Riccati::setConvergenceTolerance(double tol)
+{
+    convTol=tol;
+}
+
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool Riccati::iterateStationary(double tol, int maxIter)
+{
+    // the recursion converges linearly, hence it is worth only
+    // from a solution which is already close: give up as soon as
+    // the remaining iterations are not enough at the current rate
+    double prev=0.0;
+    for (int k=0; k<maxIter; k++)
+    {
+        lastT=Ts;
+        Ts = V + At *(lastT - lastT * B* pinv(P+Bt*lastT*B)*Bt*lastT )* A;
+        double d=frobenius(Ts-lastT);
+        double lim=tol*frobenius(Ts);
+        if (d<=lim)
+            return true;
+        if ((k>0) && ((d>=prev) || (d*pow(d/prev,maxIter-1-k)>lim)))
+            return false;
+        prev=d;
+    }
+    return false;
+}
+
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool Riccati::doubleStationary(double tol, int maxIter)
+{
+    // structure-preserving doubling algorithm:
+    // Ak+1 = Ak*(I+Gk*Hk)^-1*Ak
+    // Gk+1 = Gk + Ak*(I+Gk*Hk)^-1*Gk*Ak'
+    // Hk+1 = Hk + Ak'*Hk*(I+Gk*Hk)^-1*Ak
+    // with A0=A, G0=B*P^-1*B', H0=V; Hk converges quadratically to T
+    Matrix I=eye((int)n,(int)n);
+    Matrix Ak=A;
+    Matrix Gk=B*pinv(P)*Bt;
+    Ts=V;
+    for (int k=0; k<maxIter; k++)
+    {
+        Matrix W=luinv(I+Gk*Ts);
+        Matrix AkW=Ak*W;
+        Matrix Akt=Ak.transposed();
+        lastT=Ts;
+        Ts=lastT+Akt*lastT*W*Ak;
+        Gk=Gk+AkW*Gk*Akt;
+        Ak=AkW*Ak;
+        if (converged(Ts,lastT,tol))
+            return true;
+    }
+    return false;
+}
+
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool Riccati::solveStationaryRiccati(double tol, int maxIter)
+{
+    bool warm=(Ts.rows()==n) && (Ts.cols()==n) && iterateStationary(tol,10);
+    stationary=warm || doubleStationary(tol,maxIter);
+
+    Ts=0.5*(Ts+Ts.transposed());
+    //L = (P + B' * T * B)^-1 * B' * T * A
+    Ls=pinv(P+Bt*Ts*B)*Bt*Ts*A;
+
+    if (verbose)
+    {
+        if (stationary)
+            yInfo("Riccati: stationary DARE solved%s.",warm?" from the previous solution":"");
+        else
+            yWarning("Riccati: stationary DARE not converged.");
+    }
+
+    return stationary;
 }
 
 
@@ -151,7 +296,7 @@ Vector Riccati::doLQcontrol(int step, const Vector &x)
         Vector ret(1,0.0);
         return ret;
     }
-    if(step>=0 && step>N)
+    if(step>=0 && step>=N)
     {
         if (verbose)
             yError("Riccati: Index for DARE matrix out of bound.");
@@ -171,17 +316,28 @@ void Riccati::doLQcontrol(int step, const Vector &x, Vector &ret)
             yError("Riccati: DARE has not been solved yet.");
         ret.zero();
     }
-    else if(step>=0 && step>N)
+    else if(step>=0 && step>=N)
     {
         if (verbose)
             yError("Riccati: Index for DARE matrix out of bound.");
         ret.zero();
     }
     else
+        mulNeg(Li[step],x,ret);
+}
+
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void Riccati::doStationaryLQcontrol(const Vector &x, Vector &ret)
+{
+    if (!stationary)
     {
-        ret.resize(m);
-        ret = Li[step] * (-1.0*x);
+        if (verbose)
+            yError("Riccati: stationary DARE has not been solved yet.");
+        ret.zero();
     }
+    else
+        mulNeg(Ls,x,ret);
 }
 
 
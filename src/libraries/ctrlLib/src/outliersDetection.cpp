@@ -9,6 +9,10 @@
 */
 
 #include <cmath>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
 #include <iCub/ctrl/outliersDetection.h>
 
 using namespace std;
@@ -133,6 +137,30 @@ ModifiedThompsonTau::ModifiedThompsonTau()
 }
 
 
+/**********************************************************************/
+double ModifiedThompsonTau::getTau(const size_t N) const
+{
+    size_t n;
+    if (N>5000)
+        return 1.96;
+    else if (N>1000)
+        n=5000;
+    else if (N>500)
+        n=1000;
+    else if (N>200)
+        n=500;
+    else if (N>150)
+        n=200;
+    else if (N>100)
+        n=150;
+    else
+        n=N;
+
+    map<size_t,double>::const_iterator it=tauLUP.find(n);
+    return (it!=tauLUP.end()?it->second:0.0);
+}
+
+
 /**********************************************************************/
 set<size_t> ModifiedThompsonTau::detect(const Vector &data, const Property &options)
 {
@@ -140,16 +168,27 @@ set<size_t> ModifiedThompsonTau::detect(const Vector &data, const Property &opti
     if (data.length()<3)
         return res;
 
+    bool givenStats=options.check("mean") && options.check("std");
+    if (options.check("recursive") && !givenStats)
+        return detectBatch(data);
+
     double mean=0.0;
     double stdev=0.0;
     size_t N=data.length()-recurIdx.size();
 
-    if (options.check("mean") && options.check("std"))
+    // tau is not defined for less than 3 samples
+    if (N<3)
+    {
+        recurIdx.clear();
+        return res;
+    }
+
+    if (givenStats)
     {
         mean=options.find("mean").asFloat64();
         stdev=options.find("std").asFloat64();
     }
-    else if (N>0)
+    else
     {
         // find mean and standard deviation
         for (size_t i=0; i<data.length(); i++)
@@ -166,7 +205,7 @@ set<size_t> ModifiedThompsonTau::detect(const Vector &data, const Property &opti
         stdev=sqrt(stdev/N-mean*mean);
     }
 
-    size_t i_check;
+    size_t i_check=0;
     double delta_check=0.0;
     if (options.check("sorted"))
     {
@@ -203,25 +242,8 @@ set<size_t> ModifiedThompsonTau::detect(const Vector &data, const Property &opti
         }
     }
 
-    // choose tau
-    double tau;
-    if (N>5000)
-        tau=1.96;
-    else if (N>1000)
-        tau=tauLUP[5000];
-    else if (N>500)
-        tau=tauLUP[1000];
-    else if (N>200)
-        tau=tauLUP[500];
-    else if (N>150)
-        tau=tauLUP[200];
-    else if (N>100)
-        tau=tauLUP[150];
-    else
-        tau=tauLUP[N];
-
     // perform detection
-    if (delta_check>tau*stdev)
+    if (delta_check>getTau(N)*stdev)
     {
         // account for current instance
         res.insert(i_check);
@@ -250,3 +272,186 @@ set<size_t> ModifiedThompsonTau::detect(const Vector &data, const Property &opti
 }
 
 
+/**********************************************************************/
+set<size_t> ModifiedThompsonTau::detectBatch(const Vector &data) const
+{
+    set<size_t> res;
+    size_t n=data.length();
+    if (n<3)
+        return res;
+
+    // sort the indexes by value and then by index, so that
+    // the first sample of a run of equal values has the lowest index
+    vector<size_t> idx(n);
+    iota(idx.begin(),idx.end(),0);
+    sort(idx.begin(),idx.end(),[&](const size_t a, const size_t b) {
+        return ((data[a]<data[b]) || ((data[a]==data[b]) && (a<b)));
+    });
+
+    // the remaining samples are the sorted ones in [lo,hi];
+    // the sums are taken relative to a pivot to limit the cancellation
+    size_t lo=0;
+    size_t hi=n-1;
+    double pivot,sum,sum2,sum2Ref;
+    auto compute_sums=[&]() {
+        pivot=data[idx[(lo+hi)>>1]];
+        sum=sum2=0.0;
+        for (size_t i=lo; i<=hi; i++)
+        {
+            double y=data[idx[i]]-pivot;
+            sum+=y;
+            sum2+=y*y;
+        }
+        sum2Ref=sum2;
+    };
+    compute_sums();
+
+    // the outliers at the top of the range are removed from the end,
+    // whereas their indexes are taken from the beginning of the run
+    // of equal values [top,topEnd], which are interchangeable
+    size_t topEnd=hi;
+    size_t top=hi;
+    while ((top>lo) && (data[idx[top-1]]==data[idx[hi]]))
+        top--;
+
+    for (size_t N=n; N>=3; N--)
+    {
+        double x_lo=data[idx[lo]];
+        double x_hi=data[idx[hi]];
+        if (x_lo==x_hi)
+            break;
+
+        double mean=sum/N;
+        double stdev=sqrt(std::max(sum2/N-mean*mean,0.0));
+        double delta_lo=fabs(x_lo-pivot-mean);
+        double delta_hi=fabs(x_hi-pivot-mean);
+        size_t i_lo=idx[lo];
+        size_t i_hi=idx[top+(topEnd-hi)];
+
+        // same choice of detect(), i.e. the lowest index
+        // among the points at the largest distance
+        bool lower=(delta_lo>delta_hi) || ((delta_lo==delta_hi) && (i_lo<i_hi));
+        if (!((lower?delta_lo:delta_hi)>getTau(N)*stdev))
+            break;
+
+        double y;
+        if (lower)
+        {
+            res.insert(i_lo);
+            y=x_lo-pivot;
+            lo++;
+        }
+        else
+        {
+            res.insert(i_hi);
+            y=x_hi-pivot;
+            if (--hi<top)
+            {
+                topEnd=top=hi;
+                while ((top>lo) && (data[idx[top-1]]==data[idx[hi]]))
+                    top--;
+            }
+        }
+
+        sum-=y;
+        sum2-=y*y;
+
+        // when the outliers dominated the sums, recompute them
+        if (sum2<1e-6*sum2Ref)
+            compute_sums();
+    }
+
+    return res;
+}
+
+
+/**********************************************************************/
+OnlineModifiedThompsonTau::OnlineModifiedThompsonTau(const size_t windowLength_,
+                                                     const bool admitOutliers_) :
+                                                     windowLength(std::max(windowLength_,(size_t)2)),
+                                                     admitOutliers(admitOutliers_)
+{
+    reset();
+}
+
+
+/**********************************************************************/
+void OnlineModifiedThompsonTau::reset()
+{
+    window.clear();
+    updates=0;
+    mean=M2=0.0;
+}
+
+
+/**********************************************************************/
+void OnlineModifiedThompsonTau::recompute()
+{
+    mean=M2=0.0;
+    size_t n=0;
+    for (deque<double>::const_iterator it=window.begin(); it!=window.end(); it++)
+    {
+        double d=*it-mean;
+        mean+=d/(++n);
+        M2+=d*(*it-mean);
+    }
+    updates=0;
+}
+
+
+/**********************************************************************/
+void OnlineModifiedThompsonTau::insert(const double x, const double mean1,
+                                       const double M21)
+{
+    window.push_back(x);
+    mean=mean1;
+    M2=M21;
+
+    if (window.size()>windowLength)
+    {
+        double y=window.front();
+        window.pop_front();
+
+        size_t n=window.size();
+        double M2_=M2;
+        double d=y-mean;
+        mean-=d/n;
+        M2-=d*(y-mean);
+
+        // the removal of a sample which dominated M2
+        // loses precision, hence start over
+        if ((M2<1e-6*M2_) || (++updates>=windowLength))
+            recompute();
+    }
+}
+
+
+/**********************************************************************/
+bool OnlineModifiedThompsonTau::add(const double x)
+{
+    // statistics of the window plus the new sample
+    size_t N=window.size()+1;
+    double d=x-mean;
+    double mean1=mean+d/N;
+    double M21=M2+d*(x-mean1);
+
+    bool outlier=false;
+    if (N>=3)
+    {
+        double stdev=sqrt(std::max(M21/N,0.0));
+        outlier=(fabs(x-mean1)>getTau(N)*stdev);
+    }
+
+    if (!outlier || admitOutliers)
+        insert(x,mean1,M21);
+
+    return outlier;
+}
+
+
+/**********************************************************************/
+double OnlineModifiedThompsonTau::getStd() const
+{
+    return (window.empty()?0.0:sqrt(std::max(M2/window.size(),0.0)));
+}
+
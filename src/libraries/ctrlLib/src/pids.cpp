@@ -117,8 +117,21 @@ const Vector& Integrator::integrate(const Vector &x)
     yAssert(x.length()==dim);
 
     // implements the Tustin formula
-    y=saturate(y+(x+x_old)*(Ts/2));
-    x_old=x;
+    const double k=Ts/2.0;
+    for (unsigned int i=0; i<dim; i++)
+    {
+        double yi=y[i]+k*(x[i]+x_old[i]);
+        if (applySat)
+        {
+            if (yi<lim(i,0))
+                yi=lim(i,0);
+            else if (yi>lim(i,1))
+                yi=lim(i,1);
+        }
+
+        x_old[i]=x[i];
+        y[i]=yi;
+    }
 
     return y;
 }
@@ -206,46 +219,67 @@ parallelPID::parallelPID(const double _Ts,
     P.resize(dim,0.0);
     I.resize(dim,0.0);
     D.resize(dim,0.0);
+
+    inputI.resize(dim,0.0);
+    inputD.resize(1,0.0);
 }
 
 
 /************************************************************************/
-const Vector& parallelPID::compute(const Vector &ref, const Vector &fb)
+void parallelPID::update(const Vector &ref, const Vector &fb)
 {
-    // proportional part
-    P=Kp*(Wp*ref-fb);
-
-    // integral part
-    I=Int->integrate(Ki*(Wi*ref-fb)+(uSat-u)/Tt);
+    yAssert((ref.length()==dim) && (fb.length()==dim));
 
-    // enforce zero ouput of a disabled integrator
-    for (unsigned int i=0; i<dim; i++)
-        if (Ki[i]==0.0)
-            I[i]=0.0;
-
-    // derivative part
-    Vector inputD=Kd*(Wd*ref-fb);
+    // proportional part and input of the integral part
     for (unsigned int i=0; i<dim; i++)
     {
-        Vector inputDi(1,inputD[i]);
-        Vector outputDi=Der[i]->filt(inputDi);
-        D[i]=outputDi[0];
+        P[i]=Kp[i]*(Wp[i]*ref[i]-fb[i]);
+        inputI[i]=Ki[i]*(Wi[i]*ref[i]-fb[i])+(uSat[i]-u[i])/Tt[i];
     }
 
-    // cumul output
-    u=P+I+D;
+    // integral part
+    const Vector &y=Int->integrate(inputI);
 
-    // saturation stage
     for (unsigned int i=0; i<dim; i++)
+    {
+        // enforce zero ouput of a disabled integrator
+        I[i]=(Ki[i]!=0.0)?y[i]:0.0;
+
+        // derivative part
+        inputD[0]=Kd[i]*(Wd[i]*ref[i]-fb[i]);
+        D[i]=Der[i]->filt(inputD)[0];
+
+        // cumul output and saturation stage
+        u[i]=P[i]+I[i]+D[i];
         uSat[i]=PID_SAT(u[i],satLim(i,0),satLim(i,1));
+    }
+}
+
+
+/************************************************************************/
+const Vector& parallelPID::compute(const Vector &ref, const Vector &fb)
+{
+    lock_guard<recursive_mutex> lck(mtx);
+    update(ref,fb);
 
     return uSat;
 }
 
 
+/************************************************************************/
+void parallelPID::compute(const Vector &ref, const Vector &fb, Vector &out)
+{
+    lock_guard<recursive_mutex> lck(mtx);
+    update(ref,fb);
+
+    out=uSat;
+}
+
+
 /************************************************************************/
 void parallelPID::reset(const Vector &u0)
 {
+    lock_guard<recursive_mutex> lck(mtx);
     size_t len=u0.length()>(size_t)dim?(size_t)dim:u0.length();
 
     Vector y=Int->get();
@@ -263,6 +297,7 @@ void parallelPID::reset(const Vector &u0)
 /************************************************************************/
 void parallelPID::getOptions(Bottle &options)
 {
+    lock_guard<recursive_mutex> lck(mtx);
     Vector satLimVect(satLim.rows()*satLim.cols());
     for (int r=0; r<satLim.rows(); r++)
         for (int c=0; c<satLim.cols(); c++)
@@ -288,6 +323,7 @@ void parallelPID::getOptions(Bottle &options)
 /************************************************************************/
 void parallelPID::setOptions(const Bottle &options)
 {
+    lock_guard<recursive_mutex> lck(mtx);
     Vector satLimVect(satLim.rows()*satLim.cols());
     for (int r=0; r<satLim.rows(); r++)
         for (int c=0; c<satLim.cols(); c++)
@@ -421,52 +457,63 @@ seriesPID::seriesPID(const double _Ts,
     P.resize(dim,0.0);
     I.resize(dim,0.0);
     D.resize(dim,0.0);
+
+    input.resize(1,0.0);
 }
 
 
 /************************************************************************/
-const Vector& seriesPID::compute(const Vector &ref, const Vector &fb)
+void seriesPID::update(const Vector &ref, const Vector &fb)
 {
-    // compute error
-    e=ref-fb;
+    yAssert((ref.length()==dim) && (fb.length()==dim));
 
-    // derivative part
     for (unsigned int i=0; i<dim; i++)
     {
-        Vector inputDi(1,Kd[i]*e[i]);
-        Vector outputDi=Der[i]->filt(inputDi);
-        D[i]=outputDi[0];
-    }
+        // compute error
+        e[i]=ref[i]-fb[i];
 
-    // proportional part
-    P=Kp*(e+D);
+        // derivative part
+        input[0]=Kd[i]*e[i];
+        D[i]=Der[i]->filt(input)[0];
 
-    // integral part
-    for (unsigned int i=0; i<dim; i++)
-    {
-        Vector inputIi(1);
-        Vector outputIi(1);
-        
-        inputIi[0]=uSat[i];
-        outputIi=Int[i]->filt(inputIi);
+        // proportional part
+        P[i]=Kp[i]*(e[i]+D[i]);
+
+        // integral part
+        input[0]=uSat[i];
+        I[i]=Int[i]->filt(input)[0];
 
-        I[i]=outputIi[0];
+        // cumul output and saturation stage
+        u[i]=P[i]+I[i];
+        uSat[i]=PID_SAT(u[i],satLim(i,0),satLim(i,1));
     }
+}
 
-    // cumul output
-    u=P+I;
 
-    // saturation stage
-    for (unsigned int i=0; i<dim; i++)
-        uSat[i]=PID_SAT(u[i],satLim(i,0),satLim(i,1));
+/************************************************************************/
+const Vector& seriesPID::compute(const Vector &ref, const Vector &fb)
+{
+    lock_guard<recursive_mutex> lck(mtx);
+    update(ref,fb);
 
     return uSat;
 }
 
 
+/************************************************************************/
+void seriesPID::compute(const Vector &ref, const Vector &fb, Vector &out)
+{
+    lock_guard<recursive_mutex> lck(mtx);
+    update(ref,fb);
+
+    out=uSat;
+}
+
+
 /************************************************************************/
 void seriesPID::reset()
 {
+    lock_guard<recursive_mutex> lck(mtx);
     Vector u0(1,0.0);
     for (unsigned int i=0; i<dim; i++)
     {
@@ -479,6 +526,7 @@ void seriesPID::reset()
 /************************************************************************/
 void seriesPID::getOptions(Bottle &options)
 {
+    lock_guard<recursive_mutex> lck(mtx);
     Vector satLimVect(satLim.rows()*satLim.cols());
     for (int r=0; r<satLim.rows(); r++)
         for (int c=0; c<satLim.cols(); c++)
@@ -500,6 +548,7 @@ void seriesPID::getOptions(Bottle &options)
 /************************************************************************/
 void seriesPID::setOptions(const Bottle &options)
 {
+    lock_guard<recursive_mutex> lck(mtx);
     Vector satLimVect(satLim.rows()*satLim.cols());
     for (int r=0; r<satLim.rows(); r++)
         for (int c=0; c<satLim.cols(); c++)
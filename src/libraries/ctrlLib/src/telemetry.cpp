@@ -0,0 +1,246 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD-3-Clause license. See the accompanying LICENSE file for
+ * details.
+*/
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include <yarp/os/SystemClock.h>
+#include <iCub/ctrl/telemetry.h>
+
+using namespace std;
+using namespace yarp::os;
+using namespace iCub::ctrl;
+
+
+/**********************************************************************/
+void CycleTelemetry::Histogram::init(const double lo, const double hi,
+                                     const int nBins)
+{
+    this->lo=lo;
+    width=(hi-lo)/nBins;
+    bins.assign(nBins,0);
+    reset();
+}
+
+
+/**********************************************************************/
+void CycleTelemetry::Histogram::reset()
+{
+    std::fill(bins.begin(),bins.end(),0);
+    cnt=0;
+    sum=0.0;
+    min=numeric_limits<double>::infinity();
+    max=-numeric_limits<double>::infinity();
+}
+
+
+/**********************************************************************/
+void CycleTelemetry::Histogram::add(const double x)
+{
+    int i=(width>0.0)?(int)floor((x-lo)/width):0;
+    i=std::min(std::max(i,0),(int)bins.size()-1);
+    bins[i]++;
+
+    cnt++;
+    sum+=x;
+    min=std::min(min,x);
+    max=std::max(max,x);
+}
+
+
+/**********************************************************************/
+void CycleTelemetry::Histogram::toBottle(Bottle &b) const
+{
+    Bottle &mean=b.addList();
+    mean.addString("mean");
+    mean.addFloat64((cnt>0)?1e3*sum/cnt:0.0);
+
+    Bottle &bmin=b.addList();
+    bmin.addString("min");
+    bmin.addFloat64((cnt>0)?1e3*min:0.0);
+
+    Bottle &bmax=b.addList();
+    bmax.addString("max");
+    bmax.addFloat64((cnt>0)?1e3*max:0.0);
+
+    Bottle &blo=b.addList();
+    blo.addString("lo");
+    blo.addFloat64(1e3*lo);
+
+    Bottle &bwidth=b.addList();
+    bwidth.addString("width");
+    bwidth.addFloat64(1e3*width);
+
+    Bottle &bbins=b.addList();
+    bbins.addString("bins");
+    Bottle &values=bbins.addList();
+    for (auto &n : bins)
+        values.addInt64((int64_t)n);
+}
+
+
+/**********************************************************************/
+CycleTelemetry::CycleTelemetry(const double period, const int nBins) :
+                               nBins(std::max(nBins,1))
+{
+    setPeriod(period);
+}
+
+
+/**********************************************************************/
+void CycleTelemetry::setPeriod(const double period)
+{
+    lock_guard<mutex> lck(mtx);
+    this->period=period;
+    duration.init(0.0,2.0*period,nBins);
+    jitter.init(-period,period,nBins);
+
+    tStart=tPrevStart=-1.0;
+    cycles=overruns=0;
+    for (auto &s : sections)
+        s.cnt=0, s.sum=s.max=0.0;
+}
+
+
+/**********************************************************************/
+int CycleTelemetry::addSection(const string &name)
+{
+    lock_guard<mutex> lck(mtx);
+    Section s;
+    s.name=name;
+    s.t0=s.acc=0.0;
+    s.cnt=0;
+    s.sum=s.max=0.0;
+    sections.push_back(s);
+    return (int)sections.size()-1;
+}
+
+
+/**********************************************************************/
+void CycleTelemetry::beginCycle()
+{
+    tPrevStart=tStart;
+    tStart=SystemClock::nowSystem();
+
+    for (auto &s : sections)
+        s.acc=0.0;
+}
+
+
+/**********************************************************************/
+void CycleTelemetry::endCycle()
+{
+    double dt=SystemClock::nowSystem()-tStart;
+
+    lock_guard<mutex> lck(mtx);
+    cycles++;
+    duration.add(dt);
+    if (dt>period)
+        overruns++;
+
+    if (tPrevStart>=0.0)
+        jitter.add((tStart-tPrevStart)-period);
+
+    for (auto &s : sections)
+    {
+        if (s.acc>0.0)
+        {
+            s.cnt++;
+            s.sum+=s.acc;
+            s.max=std::max(s.max,s.acc);
+        }
+    }
+}
+
+
+/**********************************************************************/
+void CycleTelemetry::tic(const int id)
+{
+    sections[id].t0=SystemClock::nowSystem();
+}
+
+
+/**********************************************************************/
+void CycleTelemetry::toc(const int id)
+{
+    Section &s=sections[id];
+    s.acc+=SystemClock::nowSystem()-s.t0;
+}
+
+
+/**********************************************************************/
+void CycleTelemetry::reset()
+{
+    lock_guard<mutex> lck(mtx);
+    duration.reset();
+    jitter.reset();
+
+    // keep tPrevStart to measure the next jitter
+    cycles=overruns=0;
+    for (auto &s : sections)
+        s.cnt=0, s.sum=s.max=0.0;
+}
+
+
+/**********************************************************************/
+unsigned long CycleTelemetry::getOverruns()
+{
+    lock_guard<mutex> lck(mtx);
+    return overruns;
+}
+
+
+/**********************************************************************/
+void CycleTelemetry::getInfo(Bottle &info)
+{
+    lock_guard<mutex> lck(mtx);
+
+    Bottle &bperiod=info.addList();
+    bperiod.addString("period");
+    bperiod.addFloat64(1e3*period);
+
+    Bottle &bcycles=info.addList();
+    bcycles.addString("cycles");
+    bcycles.addInt64((int64_t)cycles);
+
+    Bottle &boverruns=info.addList();
+    boverruns.addString("overruns");
+    boverruns.addInt64((int64_t)overruns);
+
+    Bottle &bduration=info.addList();
+    bduration.addString("duration");
+    duration.toBottle(bduration.addList());
+
+    Bottle &bjitter=info.addList();
+    bjitter.addString("jitter");
+    jitter.toBottle(bjitter.addList());
+
+    Bottle &bsections=info.addList();
+    bsections.addString("sections");
+    Bottle &list=bsections.addList();
+    for (auto &s : sections)
+    {
+        Bottle &bs=list.addList();
+        bs.addString(s.name);
+
+        Bottle &mean=bs.addList();
+        mean.addString("mean");
+        mean.addFloat64((cycles>0)?1e3*s.sum/cycles:0.0);
+
+        Bottle &bmax=bs.addList();
+        bmax.addString("max");
+        bmax.addFloat64(1e3*s.max);
+
+        Bottle &runs=bs.addList();
+        runs.addString("runs");
+        runs.addInt64((int64_t)s.cnt);
+    }
+}
+
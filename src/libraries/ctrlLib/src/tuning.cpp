@@ -46,7 +46,6 @@ bool OnlineDCMotorEstimator::init(const double Ts, const double Q,
     A=F=eye(4,4);
     B.resize(4,0.0);
     C.resize(1,4); C(0,0)=1.0;
-    Ct=C.transposed();
 
     P=P0*eye(4,4);
     this->Q=Q*eye(4,4);
@@ -81,9 +80,8 @@ bool OnlineDCMotorEstimator::init(const double P0, const Vector &x0)
 
 
 /**********************************************************************/
-Vector OnlineDCMotorEstimator::estimate(const double u, const double y)
+const Vector& OnlineDCMotorEstimator::estimate(const double u, const double y)
 {
-    double &x1=x[0];
     double &x2=x[1];
     double &x3=x[2];
     double &x4=x[3];
@@ -108,17 +106,70 @@ Vector OnlineDCMotorEstimator::estimate(const double u, const double y)
     F(0,3)=uOld*_tmp_1;
     F(1,3)=uOld*A(0,1);
 
+    // the products are carried out on the 4x4 storage
+    // without any temporary matrix
+    double tmp[4][4];
+
     // prediction
-    x=A*x+B*uOld;
-    P=F*P*F.transposed()+Q;
+    double xp[4];
+    for (int i=0; i<4; i++)
+    {
+        double s=0.0;
+        for (int k=0; k<4; k++)
+            s+=A(i,k)*x[k];
+        xp[i]=s+B[i]*uOld;
+    }
+
+    for (int i=0; i<4; i++)
+        for (int j=0; j<4; j++)
+        {
+            double s=0.0;
+            for (int k=0; k<4; k++)
+                s+=F(i,k)*P(k,j);
+            tmp[i][j]=s;
+        }
+
+    for (int i=0; i<4; i++)
+        for (int j=0; j<4; j++)
+        {
+            double s=0.0;
+            for (int k=0; k<4; k++)
+                s+=tmp[i][k]*F(j,k);
+            P(i,j)=s+Q(i,j);
+        }
+
+    // Kalman gain: the measurement is scalar, hence the
+    // correction is a rank-1 update as in recursive least squares
+    double PCt[4],CP[4];
+    for (int i=0; i<4; i++)
+    {
+        double s1=0.0,s2=0.0;
+        for (int k=0; k<4; k++)
+        {
+            s1+=P(i,k)*C(0,k);
+            s2+=C(0,k)*P(k,i);
+        }
+        PCt[i]=s1;
+        CP[i]=s2;
+    }
 
-    // Kalman gain
-    Matrix tmpMat=C*P*Ct;
-    Matrix K=P*Ct/(tmpMat(0,0)+R);
+    double CPCt=0.0;
+    for (int i=0; i<4; i++)
+        CPCt+=C(0,i)*PCt[i];
+    CPCt+=R;
 
     // correction
-    x+=K*(y-C*x);
-    P=(eye(4,4)-K*C)*P;
+    double e=y;
+    for (int i=0; i<4; i++)
+        e-=C(0,i)*xp[i];
+
+    for (int i=0; i<4; i++)
+        x[i]=xp[i]+(PCt[i]/CPCt)*e;
+
+    // P=(I-K*C)*P
+    for (int i=0; i<4; i++)
+        for (int j=0; j<4; j++)
+            P(i,j)-=(PCt[i]/CPCt)*CP[j];
 
     _x[0]=x[0];
     _x[1]=x[1];
@@ -134,8 +185,10 @@ Vector OnlineDCMotorEstimator::estimate(const double u, const double y)
 /**********************************************************************/
 OnlineStictionEstimator::OnlineStictionEstimator() :
                          PeriodicThread(1.0),   velEst(32,4.0), accEst(32,4.0),
-                         trajGen(1,1.0,1.0), intErr(1.0,Vector(2,0.0)), done(2)
+                         trajGen(1,1.0,1.0), intErr(1.0,Vector(2,0.0)), done(2),
+                         pos1(1), ref1(1), tg1(1), adaptErr(2)
 {
+    doneEvent=true;
     imod=NULL;
     ilim=NULL;
     ienc=NULL;
@@ -259,12 +312,28 @@ void OnlineStictionEstimator::applyStictionLimit()
 }
 
 
+/**********************************************************************/
+void OnlineStictionEstimator::notifyDoneEvent()
+{
+    {
+        lock_guard<mutex> lck(mtx_doneEvent);
+        doneEvent=true;
+    }
+    cv_doneEvent.notify_all();
+}
+
+
 /**********************************************************************/
 bool OnlineStictionEstimator::threadInit()
 {
     if (!configured)
         return false;
 
+    {
+        lock_guard<mutex> lck(mtx_doneEvent);
+        doneEvent=false;
+    }
+
     ilim->getLimits(joint,&x_min,&x_max);
     double x_range=x_max-x_min;
     x_min+=0.1*x_range;
@@ -317,8 +386,9 @@ void OnlineStictionEstimator::run()
     mtx.lock();
 
     ienc->getEncoder(joint,&x_pos);
+    pos1[0]=x_pos;
 
-    AWPolyElement el(Vector(1,x_pos),Time::now());
+    AWPolyElement el(pos1,Time::now());
     Vector vel=velEst.estimate(el); x_vel=vel[0];
     Vector acc=accEst.estimate(el); x_acc=acc[0];
 
@@ -331,21 +401,23 @@ void OnlineStictionEstimator::run()
         t0=Time::now();
     }
 
-    trajGen.computeNextValues(Vector(1,tg));
+    tg1[0]=tg;
+    trajGen.computeNextValues(tg1);
     xd_pos=trajGen.getPos()[0];        
+    ref1[0]=xd_pos;
 
-    Vector pid_out=pid->compute(Vector(1,xd_pos),Vector(1,x_pos));
+    const Vector &pid_out=pid->compute(ref1,pos1);
     double e_pos=xd_pos-x_pos;
     double fw=(state==rising)?stiction[0]:stiction[1];
     double u=fw+pid_out[0];
 
-    Vector adaptGate(stiction.length(),0.0);
+    adaptErr=0.0;
     if ((fabs(x_vel)<vel_thres) && adapt)
-        adaptGate[(state==rising)?0:1]=1.0;
+        adaptErr[(state==rising)?0:1]=e_pos;
     else
         adapt=false;
 
-    Vector cumErr=intErr.integrate(e_pos*adaptGate);
+    const Vector &cumErr=intErr.integrate(adaptErr);
 
     // trigger on falling edge
     if (!adapt && adaptOld)
@@ -371,10 +443,11 @@ void OnlineStictionEstimator::run()
     info.unput("position");  info.put("position",x_pos);
     info.unput("reference"); info.put("reference",xd_pos);
 
+    bool accomplished=(done[0]*done[1]!=0.0);
     mtx.unlock();
 
-    if (done[0]*done[1]!=0.0)
-        cv_doneEvent.notify_all();
+    if (accomplished)
+        notifyDoneEvent();
 }
 
 
@@ -385,7 +458,7 @@ void OnlineStictionEstimator::threadRelease()
     imod->setControlMode(joint,VOCAB_CM_POSITION);
     delete pid;
 
-    cv_doneEvent.notify_all();
+    notifyDoneEvent();
 }
 
 
@@ -407,8 +480,10 @@ bool OnlineStictionEstimator::waitUntilDone()
     if (!configured)
         return false;
 
+    // the flag is checked since the event may have already occurred
     unique_lock<mutex> lck(mtx_doneEvent);
-    cv_doneEvent.wait(lck);
+    cv_doneEvent.wait(lck,[this]() { return doneEvent; });
+    lck.unlock();
 
     return isDone();
 }
@@ -451,6 +526,7 @@ OnlineCompensatorDesign::OnlineCompensatorDesign() : PeriodicThread(1.0),
     ipid=NULL;
     ipwm=NULL;
     icur=NULL;
+    doneEvent=true;
     configured=false;
 }
 
@@ -609,6 +685,12 @@ bool OnlineCompensatorDesign::threadInit()
 
     t0=Time::now();
 
+    if (ret)
+    {
+        lock_guard<mutex> lck(mtx_doneEvent);
+        doneEvent=false;
+    }
+
     return ret;
 }
 
@@ -658,12 +740,12 @@ void OnlineCompensatorDesign::run()
         {
             double enc,u;
             commandJoint(enc,u);
-            plant.estimate(u,enc);
+            const Vector &x=plant.estimate(u,enc);
 
             // average parameters tau and K
-            meanParams*=meanCnt;
-            meanParams+=plant.get_parameters();
-            meanParams/=++meanCnt;
+            meanParams[0]=(meanParams[0]*meanCnt+x[2])/(meanCnt+1);
+            meanParams[1]=(meanParams[1]*meanCnt+x[3])/(meanCnt+1);
+            meanCnt++;
 
             if (port.getOutputCount()>0)
             {
@@ -830,6 +912,10 @@ void OnlineCompensatorDesign::threadRelease()
         }
     }
 
+    {
+        lock_guard<mutex> lck(mtx_doneEvent);
+        doneEvent=true;
+    }
     cv_doneEvent.notify_all();
 }
 
@@ -1037,8 +1123,11 @@ bool OnlineCompensatorDesign::waitUntilDone()
     if (!configured)
         return false;
 
+    // the flag is checked since the operation may have already
+    // finished, as it happens when waiting for several designers
     unique_lock<mutex> lck(mtx_doneEvent);
-    cv_doneEvent.wait(lck);
+    cv_doneEvent.wait(lck,[this]() { return doneEvent; });
+    lck.unlock();
 
     return isDone();
 }
@@ -1118,5 +1207,230 @@ OnlineCompensatorDesign::~OnlineCompensatorDesign()
 }
 
 
+/**********************************************************************/
+OnlineCompensatorDesignBank::OnlineCompensatorDesignBank()
+{
+    configured=false;
+}
+
+
+/**********************************************************************/
+void OnlineCompensatorDesignBank::dispose()
+{
+    for (size_t i=0; i<designers.size(); i++)
+    {
+        designers[i]->stopOperation();
+        delete designers[i];
+    }
+
+    designers.clear();
+    configured=false;
+}
+
+
+/**********************************************************************/
+bool OnlineCompensatorDesignBank::configure(PolyDriver &driver, const Property &options)
+{
+    dispose();
+
+    Bottle &optGeneral=options.findGroup("general");
+    if (optGeneral.isNull())
+        return false;
+
+    Bottle *joints=optGeneral.find("joints").asList();
+    if ((joints==NULL) || (joints->size()==0))
+        return false;
+
+    string port;
+    if (optGeneral.check("port"))
+    {
+        port=optGeneral.find("port").asString();
+        if (port[0]!='/')
+            port="/"+port;
+    }
+
+    // the [general] group of each designer carries its joint
+    Property optOthers(options.toString().c_str());
+    optOthers.unput("general");
+
+    for (size_t i=0; i<joints->size(); i++)
+    {
+        int j=joints->get(i).asInt32();
+
+        Bottle general;
+        general.addString("general");
+        for (size_t k=1; k<optGeneral.size(); k++)
+        {
+            if (Bottle *item=optGeneral.get(k).asList())
+            {
+                string key=item->get(0).asString();
+                if ((key!="joints") && (key!="joint") && (key!="port"))
+                    general.addList()=*item;
+            }
+        }
+
+        Bottle &joint=general.addList();
+        joint.addString("joint");
+        joint.addInt32(j);
+
+        if (!port.empty())
+        {
+            ostringstream name;
+            name<<port<<"/"<<j;
+
+            Bottle &portName=general.addList();
+            portName.addString("port");
+            portName.addString(name.str());
+        }
+
+        Property opt((optOthers.toString()+" ("+general.toString()+")").c_str());
+
+        OnlineCompensatorDesign *designer=new OnlineCompensatorDesign;
+        designers.push_back(designer);
+        if (!designer->configure(driver,opt))
+        {
+            dispose();
+            return false;
+        }
+    }
+
+    return configured=true;
+}
+
+
+/**********************************************************************/
+Property OnlineCompensatorDesignBank::jointOptions(const Property &options,
+                                                   const int j) const
+{
+    Property opt=options;
+
+    ostringstream tag;
+    tag<<"joint_"<<j;
 
+    Bottle &group=options.findGroup(tag.str());
+    for (size_t k=1; k<group.size(); k++)
+    {
+        if (Bottle *item=group.get(k).asList())
+        {
+            if (item->size()>=2)
+            {
+                string key=item->get(0).asString();
+                opt.unput(key);
+                opt.put(key,item->get(1));
+            }
+        }
+    }
+
+    opt.unput(tag.str());
+    return opt;
+}
+
+
+/**********************************************************************/
+bool OnlineCompensatorDesignBank::startOperation(Operation operation,
+                                                 const Property &options)
+{
+    if (!configured)
+        return false;
+
+    for (size_t i=0; i<designers.size(); i++)
+    {
+        OnlineCompensatorDesign *designer=designers[i];
+        if (!(designer->*operation)(jointOptions(options,designer->getJoint())))
+        {
+            for (size_t k=0; k<i; k++)
+                designers[k]->stopOperation();
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/**********************************************************************/
+bool OnlineCompensatorDesignBank::startPlantEstimation(const Property &options)
+{
+    return startOperation(&OnlineCompensatorDesign::startPlantEstimation,options);
+}
+
+
+/**********************************************************************/
+bool OnlineCompensatorDesignBank::startPlantValidation(const Property &options)
+{
+    return startOperation(&OnlineCompensatorDesign::startPlantValidation,options);
+}
+
+
+/**********************************************************************/
+bool OnlineCompensatorDesignBank::startStictionEstimation(const Property &options)
+{
+    return startOperation(&OnlineCompensatorDesign::startStictionEstimation,options);
+}
+
+
+/**********************************************************************/
+bool OnlineCompensatorDesignBank::startControllerValidation(const Property &options)
+{
+    return startOperation(&OnlineCompensatorDesign::startControllerValidation,options);
+}
+
+
+/**********************************************************************/
+bool OnlineCompensatorDesignBank::isDone()
+{
+    if (!configured)
+        return false;
+
+    for (size_t i=0; i<designers.size(); i++)
+        if (!designers[i]->isDone())
+            return false;
+
+    return true;
+}
+
+
+/**********************************************************************/
+bool OnlineCompensatorDesignBank::waitUntilDone()
+{
+    if (!configured)
+        return false;
+
+    for (size_t i=0; i<designers.size(); i++)
+        designers[i]->waitUntilDone();
+
+    return isDone();
+}
+
+
+/**********************************************************************/
+void OnlineCompensatorDesignBank::stopOperation()
+{
+    for (size_t i=0; i<designers.size(); i++)
+        designers[i]->stopOperation();
+}
+
+
+/**********************************************************************/
+bool OnlineCompensatorDesignBank::getResults(deque<Property> &results)
+{
+    if (!configured)
+        return false;
+
+    results.resize(designers.size());
+
+    bool ret=true;
+    for (size_t i=0; i<designers.size(); i++)
+        ret&=designers[i]->getResults(results[i]);
+
+    return ret;
+}
+
+
+/**********************************************************************/
+OnlineCompensatorDesignBank::~OnlineCompensatorDesignBank()
+{
+    dispose();
+}
 
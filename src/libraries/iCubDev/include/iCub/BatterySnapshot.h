@@ -0,0 +1,114 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+/**
+ * @file BatterySnapshot.h
+ * @brief All the readings of a battery at once, and their publication on change.
+ */
+
+#ifndef __BATTERYSNAPSHOT__
+#define __BATTERYSNAPSHOT__
+
+#include <stdint.h>
+#include <string>
+
+#include <yarp/dev/IBattery.h>
+
+namespace iCub {
+    namespace dev {
+        struct BatterySnapshot;
+        class IBatterySnapshot;
+        class BatteryPublisher;
+    }
+}
+
+/**
+ * The values that the getters of yarp::dev::IBattery give one at a time,
+ * read together under the lock of the device, thus all of the same update.
+ */
+struct iCub::dev::BatterySnapshot
+{
+    double voltage;         /** V */
+    double current;         /** A */
+    double charge;          /** % */
+    double temperature;     /** degrees Celsius, NaN if the battery has no sensor */
+    yarp::dev::IBattery::Battery_status status;
+    double stamp;           /** seconds, the time of the reading */
+    uint32_t sequence;      /** incremented by the device whenever a value other than the stamp changes */
+
+    BatterySnapshot() : voltage(0.0), current(0.0), charge(0.0), temperature(0.0),
+                        status(yarp::dev::IBattery::BATTERY_OK_STANBY), stamp(0.0), sequence(0) { }
+};
+
+/**
+ * The interface of the battery devices which give a BatterySnapshot, to be
+ * taken with view() next to yarp::dev::IBattery.
+ */
+class iCub::dev::IBatterySnapshot
+{
+public:
+    virtual ~IBatterySnapshot() { }
+
+    /**
+     * Copies all the values of the battery at once.
+     * @return false if the device has no readings yet
+     */
+    virtual bool getBatterySnapshot(BatterySnapshot& snapshot) = 0;
+};
+
+/**
+ * The port on which a battery device writes its snapshot only when it has
+ * changed, i.e. when its sequence is not the one written last, and anyway
+ * once every heartbeat, so that a reader can tell a steady battery from a
+ * dead device.
+ *
+ * The message is the list (voltage current charge temperature status), with
+ * the envelope stamped with the sequence and the time of the reading.
+ */
+class iCub::dev::BatteryPublisher
+{
+public:
+    BatteryPublisher();
+    ~BatteryPublisher();
+
+    /**
+     * @param name the name of the port
+     * @param heartbeat seconds between two writes of an unchanged snapshot, 0 to never repeat it
+     */
+    bool open(const std::string& name, double heartbeat = 5.0);
+    void close();
+
+    bool isOpen() const { return impl != NULL; }
+
+    /**
+     * Writes snapshot if it has changed since the last write or if the
+     * heartbeat has expired. It does not wait for the readers.
+     * @return true if it has been written
+     */
+    bool publish(const BatterySnapshot& snapshot);
+
+private:
+    struct Impl;
+
+    BatteryPublisher(const BatteryPublisher&);
+    BatteryPublisher& operator=(const BatteryPublisher&);
+
+    Impl *impl;
+};
+
+#endif
@@ -0,0 +1,185 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+/**
+ * @file CanCapture.h
+ * @brief Capture of raw CAN frames in a memory mapped ring file.
+ */
+
+#ifndef __CANCAPTURE__
+#define __CANCAPTURE__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <bitset>
+#include <string>
+
+namespace iCub {
+    namespace dev {
+        struct CanCaptureFrame;
+        class CanIdFilter;
+        class CanCaptureRing;
+    }
+}
+
+/**
+ * A captured frame, as it is laid out in the ring file.
+ */
+struct iCub::dev::CanCaptureFrame
+{
+    double   stamp;     /** seconds, from the hardware if the driver has it */
+    uint32_t id;        /** 11 bits identifier */
+    uint8_t  len;       /** data length */
+    uint8_t  flags;     /** CAN_CAPTURE_* flags */
+    uint8_t  reserved[2];
+    uint8_t  data[8];
+};
+
+#define CAN_CAPTURE_HW_STAMP  0x01  // the stamp comes from the CAN hardware
+#define CAN_CAPTURE_LOST      0x02  // the driver reported lost frames before this one
+#define CAN_CAPTURE_ERROR     0x04  // error frame or frame without data
+
+/**
+ * The set of the accepted identifiers, kept as a bitset of the 2048 standard
+ * identifiers so that the test costs the same for any number of ranges.
+ */
+class iCub::dev::CanIdFilter
+{
+public:
+    enum { MAX_ID = 0x800 };
+
+    /**
+     * Builds a filter which accepts every identifier.
+     */
+    CanIdFilter() { ids.set(); }
+
+    void clear() { ids.reset(); }
+    void acceptAll() { ids.set(); }
+
+    /**
+     * Accepts the identifiers from first to last, both included.
+     */
+    void add(unsigned int first, unsigned int last);
+
+    /**
+     * Replaces the filter with the identifiers of a list like
+     * "0x100-0x1ff,0x35a" (commas or blanks between the items, any base
+     * accepted by strtoul).
+     * @return false if the list cannot be parsed, the filter is then left unchanged.
+     */
+    bool parse(const std::string& spec);
+
+    inline bool accepts(unsigned int id) const { return id < MAX_ID && ids.test(id); }
+
+    size_t count() const { return ids.count(); }
+
+private:
+    std::bitset<MAX_ID> ids;
+};
+
+/**
+ * A ring of CanCaptureFrame mapped on a file.
+ *
+ * The frames are written by one thread (the one that reads the bus) without
+ * any lock or copy other than the one into the mapped memory; the ones that
+ * decode or print them read behind it at their own pace, and find out with
+ * read() about the frames which have been overwritten in the meanwhile. The
+ * header of the file keeps the number of frames written so far, so that the
+ * file can be decoded later by openForReading().
+ */
+class iCub::dev::CanCaptureRing
+{
+public:
+    CanCaptureRing();
+    ~CanCaptureRing();
+
+    /**
+     * Creates (or truncates) the file and maps it.
+     * @param path the name of the file
+     * @param frames the capacity of the ring
+     * @return false if the file cannot be created or mapped
+     */
+    bool open(const std::string& path, size_t frames);
+
+    /**
+     * Maps an existing capture file, to decode it.
+     * @return false if the file is missing or is not a capture file
+     */
+    bool openForReading(const std::string& path);
+
+    /**
+     * Unmaps, and flushes, the file.
+     */
+    void close();
+
+    bool isOpen() const { return base != NULL; }
+
+    /**
+     * Appends a frame, overwriting the oldest one if the ring is full. Only
+     * one thread may push.
+     */
+    void push(double stamp, unsigned int id, unsigned int len, const unsigned char *data, unsigned int flags = 0);
+
+    /**
+     * The number of frames pushed since the file was created.
+     */
+    uint64_t written() const { return count.load(std::memory_order_acquire); }
+
+    /**
+     * The capacity of the ring.
+     */
+    size_t capacity() const { return frames; }
+
+    /**
+     * Copies the frame with the index given (counting from the creation of
+     * the file).
+     * @return false if the frame has not been written yet, or if it has
+     * already been overwritten
+     */
+    bool read(uint64_t index, CanCaptureFrame& frame) const;
+
+    /**
+     * The index of the oldest frame still in the ring.
+     */
+    uint64_t oldest() const;
+
+private:
+    struct Header;
+
+    CanCaptureRing(const CanCaptureRing&);
+    CanCaptureRing& operator=(const CanCaptureRing&);
+
+    bool map(const std::string& path, size_t bytes, bool create);
+
+    unsigned char *base;
+    size_t bytes;
+    Header *header;
+    CanCaptureFrame *ring;
+    size_t frames;
+    std::atomic<uint64_t> count;
+
+#ifdef _WIN32
+    void *file;
+    void *mapping;
+#else
+    int fd;
+#endif
+};
+
+#endif
@@ -0,0 +1,137 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+/**
+ * @file SharedJointState.h
+ * @brief Snapshot of the state of the joints of a device in a memory mapped file.
+ */
+
+#ifndef __SHAREDJOINTSTATE__
+#define __SHAREDJOINTSTATE__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <string>
+
+namespace iCub {
+    namespace dev {
+        struct SharedJointSample;
+        class SharedJointState;
+    }
+}
+
+/**
+ * The state of a joint, as it is laid out in the file: the same values, in
+ * the same units and with the same index of the joint, that the interfaces
+ * of the device give (IEncodersTimed, ITorqueControl).
+ */
+struct iCub::dev::SharedJointSample
+{
+    double position;        /** deg or m */
+    double velocity;        /** deg/s or m/s */
+    double acceleration;    /** deg/s^2 or m/s^2 */
+    double torque;          /** Nm or N */
+    double stamp;           /** seconds, the time stamp of the encoder */
+};
+
+/**
+ * The state of all the joints of a motion control device, mapped on a file
+ * (e.g. under /dev/shm) so that the processes running on the same machine,
+ * typically the controllers, read it with a copy of memory instead of
+ * through the ports of the network wrapper.
+ *
+ * The device is the only writer and it is never blocked: the snapshot is
+ * protected by a sequence counter (seqlock) in the header of the file, thus
+ * a reader copies the snapshot again if the device has changed it in the
+ * meanwhile and it always gets the joints of the same update. The commands
+ * still go through the wrapper, which checks them.
+ */
+class iCub::dev::SharedJointState
+{
+public:
+    SharedJointState();
+    ~SharedJointState();
+
+    /**
+     * Creates (or truncates) the file and maps it, to write the state.
+     * @param path the name of the file
+     * @param joints the number of joints
+     * @return false if the file cannot be created or mapped
+     */
+    bool open(const std::string& path, size_t joints);
+
+    /**
+     * Maps an existing file, to read the state.
+     * @return false if the file is missing or is not a state file
+     */
+    bool openForReading(const std::string& path);
+
+    /**
+     * Unmaps the file. The file is left where it is, so that the readers
+     * keep the last state.
+     */
+    void close();
+
+    bool isOpen() const { return base != NULL; }
+
+    /**
+     * The number of joints in the file.
+     */
+    size_t joints() const { return njoints; }
+
+    /**
+     * Writes the state of all the joints. Only one thread (of one process)
+     * may write.
+     * @param samples joints() samples
+     */
+    void write(const SharedJointSample *samples);
+
+    /**
+     * Copies the latest state of all the joints. It can be called by any
+     * thread of any process, concurrently with write().
+     * @param samples room for joints() samples
+     * @param updates if not NULL, it gets the number of writes done so far,
+     * which tells whether there is a new state since the previous read
+     * @return false if nothing has been written yet
+     */
+    bool read(SharedJointSample *samples, uint64_t *updates = NULL) const;
+
+private:
+    struct Header;
+
+    SharedJointState(const SharedJointState&);
+    SharedJointState& operator=(const SharedJointState&);
+
+    bool map(const std::string& path, size_t bytes, bool create);
+
+    unsigned char *base;
+    size_t bytes;
+    Header *header;
+    SharedJointSample *samples;
+    size_t njoints;
+
+#ifdef _WIN32
+    void *file;
+    void *mapping;
+#else
+    int fd;
+#endif
+};
+
+#endif
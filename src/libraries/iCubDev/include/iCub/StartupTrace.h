@@ -0,0 +1,108 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+/**
+ * @file StartupTrace.h
+ * @brief Spans of the bring-up of the devices, written as a Chrome trace.
+ */
+
+#ifndef __STARTUPTRACE__
+#define __STARTUPTRACE__
+
+#include <string>
+
+namespace iCub {
+    namespace dev {
+        class StartupTrace;
+        class TraceSpan;
+    }
+}
+
+/**
+ * The trace of the phases of the startup (opening of the devices, verification
+ * of the boards, calibration, ...), enabled by setting the environment variable
+ * ICUB_STARTUP_TRACE to the name of the file to write.
+ *
+ * The file is in the JSON array format of the Chrome trace events, which can be
+ * loaded in chrome://tracing or in Perfetto: every span is a complete event
+ * ("ph":"X") on the line of the thread which ran it. Each event is written as
+ * soon as its span ends, so that the file is usable even if the process does
+ * not terminate cleanly. Without the variable a span costs a test of a flag.
+ */
+class iCub::dev::StartupTrace
+{
+public:
+    /**
+     * @return true if ICUB_STARTUP_TRACE is set and its file could be created
+     */
+    static bool enabled();
+
+    /**
+     * Microseconds since the start of the trace.
+     */
+    static double now();
+
+    /**
+     * Writes a complete event.
+     * @param category the group of the event, e.g. "eth" or "calibration"
+     * @param name the name of the event, e.g. the function and the board
+     * @param start the start, from now()
+     * @param end the end, from now()
+     */
+    static void complete(const char *category, const std::string& name, double start, double end);
+};
+
+/**
+ * A span of the trace: it starts when it is built and it ends when it is
+ * destroyed or when end() is called.
+ */
+class iCub::dev::TraceSpan
+{
+public:
+    TraceSpan(const char *category, const std::string& name) :
+        active(StartupTrace::enabled()), category(category)
+    {
+        if (active)
+        {
+            this->name=name;
+            start=StartupTrace::now();
+        }
+    }
+
+    ~TraceSpan() { end(); }
+
+    void end()
+    {
+        if (active)
+        {
+            StartupTrace::complete(category, name, start, StartupTrace::now());
+            active=false;
+        }
+    }
+
+private:
+    TraceSpan(const TraceSpan&);
+    TraceSpan& operator=(const TraceSpan&);
+
+    bool active;
+    const char *category;
+    std::string name;
+    double start;
+};
+
+#endif
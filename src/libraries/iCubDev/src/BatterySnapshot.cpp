@@ -0,0 +1,109 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+#include <iCub/BatterySnapshot.h>
+
+#include <mutex>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Stamp.h>
+#include <yarp/os/Time.h>
+
+using namespace iCub::dev;
+
+struct BatteryPublisher::Impl
+{
+    std::mutex mtx;
+    yarp::os::BufferedPort<yarp::os::Bottle> port;
+    double heartbeat;
+    bool written;
+    uint32_t sequence;      // of the last snapshot written
+    double lastWrite;
+};
+
+
+BatteryPublisher::BatteryPublisher() : impl(NULL)
+{
+}
+
+BatteryPublisher::~BatteryPublisher()
+{
+    close();
+}
+
+bool BatteryPublisher::open(const std::string& name, double heartbeat)
+{
+    close();
+
+    Impl *p=new Impl;
+    if (!p->port.open(name))
+    {
+        delete p;
+        return false;
+    }
+
+    p->heartbeat=heartbeat;
+    p->written=false;
+    p->sequence=0;
+    p->lastWrite=0.0;
+    impl=p;
+    return true;
+}
+
+void BatteryPublisher::close()
+{
+    if (impl!=NULL)
+    {
+        impl->port.interrupt();
+        impl->port.close();
+        delete impl;
+        impl=NULL;
+    }
+}
+
+bool BatteryPublisher::publish(const BatterySnapshot& snapshot)
+{
+    if (impl==NULL)
+        return false;
+
+    std::lock_guard<std::mutex> lck(impl->mtx);
+
+    double now=yarp::os::Time::now();
+    bool changed=!impl->written || (snapshot.sequence!=impl->sequence);
+    bool expired=(impl->heartbeat>0.0) && (now-impl->lastWrite>=impl->heartbeat);
+    if (!changed && !expired)
+        return false;
+
+    yarp::os::Bottle& b=impl->port.prepare();
+    b.clear();
+    b.addFloat64(snapshot.voltage);
+    b.addFloat64(snapshot.current);
+    b.addFloat64(snapshot.charge);
+    b.addFloat64(snapshot.temperature);
+    b.addInt32((int)snapshot.status);
+
+    yarp::os::Stamp stamp((int)snapshot.sequence, snapshot.stamp);
+    impl->port.setEnvelope(stamp);
+    impl->port.write();
+
+    impl->written=true;
+    impl->sequence=snapshot.sequence;
+    impl->lastWrite=now;
+    return true;
+}
@@ -0,0 +1,281 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+#include <iCub/CanCapture.h>
+
+#include <string.h>
+#include <stdlib.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace iCub::dev;
+
+static const char CAN_CAPTURE_MAGIC[8] = { 'I','C','U','B','C','A','N','1' };
+
+struct CanCaptureRing::Header
+{
+    char     magic[8];
+    uint32_t frameSize;
+    uint32_t reserved;
+    uint64_t capacity;
+    uint64_t written;
+    unsigned char padding[32];
+};
+
+
+void CanIdFilter::add(unsigned int first, unsigned int last)
+{
+    if (last >= MAX_ID)
+        last = MAX_ID-1;
+    for (unsigned int id=first; id<=last; id++)
+        ids.set(id);
+}
+
+bool CanIdFilter::parse(const std::string& spec)
+{
+    std::bitset<MAX_ID> saved=ids;
+    ids.reset();
+
+    const char *p=spec.c_str();
+    while (*p)
+    {
+        if (*p==',' || *p==' ' || *p=='\t')
+        {
+            p++;
+            continue;
+        }
+
+        char *end;
+        unsigned long first=strtoul(p, &end, 0);
+        unsigned long last=first;
+        if (end==p)
+        {
+            ids=saved;
+            return false;
+        }
+        p=end;
+        if (*p=='-')
+        {
+            last=strtoul(p+1, &end, 0);
+            if (end==p+1)
+            {
+                ids=saved;
+                return false;
+            }
+            p=end;
+        }
+        if (first>last || first>=MAX_ID)
+        {
+            ids=saved;
+            return false;
+        }
+        add((unsigned int)first, (unsigned int)last);
+    }
+    return true;
+}
+
+
+CanCaptureRing::CanCaptureRing() :
+    base(NULL), bytes(0), header(NULL), ring(NULL), frames(0), count(0),
+#ifdef _WIN32
+    file(INVALID_HANDLE_VALUE), mapping(NULL)
+#else
+    fd(-1)
+#endif
+{
+}
+
+CanCaptureRing::~CanCaptureRing()
+{
+    close();
+}
+
+bool CanCaptureRing::map(const std::string& path, size_t size, bool create)
+{
+#ifdef _WIN32
+    file=CreateFileA(path.c_str(), GENERIC_READ|GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                     create?CREATE_ALWAYS:OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file==INVALID_HANDLE_VALUE)
+        return false;
+    if (!create)
+    {
+        LARGE_INTEGER len;
+        GetFileSizeEx(file, &len);
+        size=(size_t)len.QuadPart;
+    }
+    mapping=CreateFileMappingA(file, NULL, PAGE_READWRITE,
+                               (DWORD)((uint64_t)size>>32), (DWORD)(size&0xffffffff), NULL);
+    if (mapping==NULL)
+    {
+        CloseHandle(file);
+        file=INVALID_HANDLE_VALUE;
+        return false;
+    }
+    base=(unsigned char*)MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (base==NULL)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        mapping=NULL;
+        file=INVALID_HANDLE_VALUE;
+        return false;
+    }
+#else
+    fd=::open(path.c_str(), create?(O_RDWR|O_CREAT|O_TRUNC):O_RDWR, 0644);
+    if (fd<0)
+        return false;
+    if (create)
+    {
+        if (ftruncate(fd, (off_t)size)!=0)
+        {
+            ::close(fd);
+            fd=-1;
+            return false;
+        }
+    }
+    else
+    {
+        struct stat st;
+        fstat(fd, &st);
+        size=(size_t)st.st_size;
+    }
+    void *p=mmap(NULL, size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p==MAP_FAILED)
+    {
+        ::close(fd);
+        fd=-1;
+        return false;
+    }
+    base=(unsigned char*)p;
+#endif
+    bytes=size;
+    header=(Header*)base;
+    ring=(CanCaptureFrame*)(base+sizeof(Header));
+    return true;
+}
+
+bool CanCaptureRing::open(const std::string& path, size_t capacity)
+{
+    close();
+    if (capacity==0)
+        return false;
+
+    if (!map(path, sizeof(Header)+capacity*sizeof(CanCaptureFrame), true))
+        return false;
+
+    memset(header, 0, sizeof(Header));
+    memcpy(header->magic, CAN_CAPTURE_MAGIC, sizeof(CAN_CAPTURE_MAGIC));
+    header->frameSize=sizeof(CanCaptureFrame);
+    header->capacity=capacity;
+    frames=capacity;
+    count.store(0);
+    return true;
+}
+
+bool CanCaptureRing::openForReading(const std::string& path)
+{
+    close();
+    if (!map(path, 0, false))
+        return false;
+
+    if (bytes<sizeof(Header) || memcmp(header->magic, CAN_CAPTURE_MAGIC, sizeof(CAN_CAPTURE_MAGIC))!=0 ||
+        header->frameSize!=sizeof(CanCaptureFrame) ||
+        sizeof(Header)+header->capacity*sizeof(CanCaptureFrame)>bytes)
+    {
+        close();
+        return false;
+    }
+    frames=(size_t)header->capacity;
+    count.store(header->written);
+    return true;
+}
+
+void CanCaptureRing::close()
+{
+    if (base==NULL)
+        return;
+
+#ifdef _WIN32
+    FlushViewOfFile(base, bytes);
+    UnmapViewOfFile(base);
+    CloseHandle(mapping);
+    CloseHandle(file);
+    mapping=NULL;
+    file=INVALID_HANDLE_VALUE;
+#else
+    msync(base, bytes, MS_SYNC);
+    munmap(base, bytes);
+    ::close(fd);
+    fd=-1;
+#endif
+    base=NULL;
+    header=NULL;
+    ring=NULL;
+    bytes=0;
+    frames=0;
+}
+
+void CanCaptureRing::push(double stamp, unsigned int id, unsigned int len, const unsigned char *data, unsigned int flags)
+{
+    uint64_t n=count.load(std::memory_order_relaxed);
+    CanCaptureFrame& f=ring[n%frames];
+
+    if (len>8)
+        len=8;
+    f.stamp=stamp;
+    f.id=id;
+    f.len=(uint8_t)len;
+    f.flags=(uint8_t)flags;
+    f.reserved[0]=f.reserved[1]=0;
+    memcpy(f.data, data, len);
+    memset(f.data+len, 0, 8-len);
+
+    count.store(n+1, std::memory_order_release);
+    header->written=n+1;
+}
+
+uint64_t CanCaptureRing::oldest() const
+{
+    // the slot of the oldest frame is the next one to be written, hence it
+    // is not safe to read it while capturing
+    uint64_t n=written();
+    return n>=frames ? n-frames+1 : 0;
+}
+
+bool CanCaptureRing::read(uint64_t index, CanCaptureFrame& frame) const
+{
+    if (ring==NULL)
+        return false;
+
+    uint64_t n=written();
+    if (index>=n || n-index>=frames)
+        return false;
+
+    frame=ring[index%frames];
+
+    // the writer might have lapped the reader during the copy
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return count.load(std::memory_order_relaxed)-index<frames;
+}
@@ -0,0 +1,233 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+#include <iCub/SharedJointState.h>
+
+#include <string.h>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace iCub::dev;
+
+static const char SHARED_JOINT_STATE_MAGIC[8] = { 'I','C','U','B','J','S','T','1' };
+
+// a reader gives up if the writer is always in the middle of a write, e.g. because its process has died there
+static const int SHARED_JOINT_STATE_MAX_TRIES = 1000;
+
+struct SharedJointState::Header
+{
+    char     magic[8];
+    uint32_t sampleSize;
+    uint32_t joints;
+    std::atomic<uint64_t> sequence;     // odd while the writer changes the samples, twice the number of writes
+    unsigned char padding[40];
+};
+
+
+SharedJointState::SharedJointState() :
+    base(NULL), bytes(0), header(NULL), samples(NULL), njoints(0),
+#ifdef _WIN32
+    file(INVALID_HANDLE_VALUE), mapping(NULL)
+#else
+    fd(-1)
+#endif
+{
+}
+
+SharedJointState::~SharedJointState()
+{
+    close();
+}
+
+bool SharedJointState::map(const std::string& path, size_t size, bool create)
+{
+#ifdef _WIN32
+    file=CreateFileA(path.c_str(), GENERIC_READ|GENERIC_WRITE, FILE_SHARE_READ|FILE_SHARE_WRITE, NULL,
+                     create?CREATE_ALWAYS:OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file==INVALID_HANDLE_VALUE)
+        return false;
+    if (!create)
+    {
+        LARGE_INTEGER len;
+        GetFileSizeEx(file, &len);
+        size=(size_t)len.QuadPart;
+    }
+    mapping=CreateFileMappingA(file, NULL, PAGE_READWRITE,
+                               (DWORD)((uint64_t)size>>32), (DWORD)(size&0xffffffff), NULL);
+    if (mapping==NULL)
+    {
+        CloseHandle(file);
+        file=INVALID_HANDLE_VALUE;
+        return false;
+    }
+    base=(unsigned char*)MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (base==NULL)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        mapping=NULL;
+        file=INVALID_HANDLE_VALUE;
+        return false;
+    }
+#else
+    // the readers only map the file for reading, thus they cannot disturb the writer
+    fd=::open(path.c_str(), create?(O_RDWR|O_CREAT|O_TRUNC):O_RDONLY, 0644);
+    if (fd<0)
+        return false;
+    if (create)
+    {
+        if (ftruncate(fd, (off_t)size)!=0)
+        {
+            ::close(fd);
+            fd=-1;
+            return false;
+        }
+    }
+    else
+    {
+        struct stat st;
+        fstat(fd, &st);
+        size=(size_t)st.st_size;
+    }
+    void *p=mmap(NULL, size, create?(PROT_READ|PROT_WRITE):PROT_READ, MAP_SHARED, fd, 0);
+    if (p==MAP_FAILED)
+    {
+        ::close(fd);
+        fd=-1;
+        return false;
+    }
+    base=(unsigned char*)p;
+#endif
+    bytes=size;
+    header=(Header*)base;
+    samples=(SharedJointSample*)(base+sizeof(Header));
+    return true;
+}
+
+bool SharedJointState::open(const std::string& path, size_t joints)
+{
+    close();
+    if (joints==0)
+        return false;
+
+    if (!map(path, sizeof(Header)+joints*sizeof(SharedJointSample), true))
+        return false;
+
+    memset(base, 0, bytes);
+    new (&header->sequence) std::atomic<uint64_t>(0);
+    header->sampleSize=sizeof(SharedJointSample);
+    header->joints=(uint32_t)joints;
+    njoints=joints;
+
+    // the magic goes last, so that a reader which finds it finds a complete header
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(header->magic, SHARED_JOINT_STATE_MAGIC, sizeof(SHARED_JOINT_STATE_MAGIC));
+    return true;
+}
+
+bool SharedJointState::openForReading(const std::string& path)
+{
+    close();
+    if (!map(path, 0, false))
+        return false;
+
+    if (bytes<sizeof(Header) || memcmp(header->magic, SHARED_JOINT_STATE_MAGIC, sizeof(SHARED_JOINT_STATE_MAGIC))!=0 ||
+        header->sampleSize!=sizeof(SharedJointSample) || header->joints==0 ||
+        sizeof(Header)+header->joints*sizeof(SharedJointSample)>bytes)
+    {
+        close();
+        return false;
+    }
+    njoints=header->joints;
+    return true;
+}
+
+void SharedJointState::close()
+{
+    if (base==NULL)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(base);
+    CloseHandle(mapping);
+    CloseHandle(file);
+    mapping=NULL;
+    file=INVALID_HANDLE_VALUE;
+#else
+    munmap(base, bytes);
+    ::close(fd);
+    fd=-1;
+#endif
+    base=NULL;
+    header=NULL;
+    samples=NULL;
+    bytes=0;
+    njoints=0;
+}
+
+void SharedJointState::write(const SharedJointSample *values)
+{
+    if (header==NULL)
+        return;
+
+    uint64_t s=header->sequence.load(std::memory_order_relaxed);
+    header->sequence.store(s+1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    memcpy(samples, values, njoints*sizeof(SharedJointSample));
+
+    header->sequence.store(s+2, std::memory_order_release);
+}
+
+bool SharedJointState::read(SharedJointSample *values, uint64_t *updates) const
+{
+    if (header==NULL)
+        return false;
+
+    for (int i=0; i<SHARED_JOINT_STATE_MAX_TRIES; i++)
+    {
+        uint64_t s1=header->sequence.load(std::memory_order_acquire);
+        if (s1 & 1)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        if (s1==0)
+            return false;
+
+        memcpy(values, samples, njoints*sizeof(SharedJointSample));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (s1==header->sequence.load(std::memory_order_relaxed))
+        {
+            if (updates!=NULL)
+                *updates=s1/2;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,124 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+#include <iCub/StartupTrace.h>
+
+#include <stdio.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <map>
+
+#include <yarp/conf/environment.h>
+
+using namespace iCub::dev;
+
+namespace {
+
+struct Trace
+{
+    FILE *file;
+    std::mutex mtx;
+    std::chrono::steady_clock::time_point origin;
+    std::map<std::thread::id, int> threads;    // the threads get small ids, in order of appearance
+
+    Trace() : file(NULL), origin(std::chrono::steady_clock::now())
+    {
+        std::string path=yarp::conf::environment::get_string("ICUB_STARTUP_TRACE");
+        if (path.empty())
+            return;
+
+        file=fopen(path.c_str(), "w");
+        if (file!=NULL)
+        {
+            // the closing bracket is optional in the array format, thus a trace cut short can still be loaded
+            fprintf(file, "[\n");
+            fflush(file);
+        }
+    }
+
+    // the trace ends with the process, it is never closed
+    static Trace& instance()
+    {
+        static Trace *trace=new Trace();
+        return *trace;
+    }
+};
+
+std::string escape(const std::string& s)
+{
+    std::string out;
+    out.reserve(s.size());
+    for (size_t i=0; i<s.size(); i++)
+    {
+        char c=s[i];
+        if (c=='"' || c=='\\')
+        {
+            out+='\\';
+            out+=c;
+        }
+        else if ((unsigned char)c<0x20)
+        {
+            out+=' ';
+        }
+        else
+        {
+            out+=c;
+        }
+    }
+    return out;
+}
+
+}
+
+
+bool StartupTrace::enabled()
+{
+    static const bool on=(Trace::instance().file!=NULL);
+    return on;
+}
+
+double StartupTrace::now()
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now()-Trace::instance().origin).count();
+}
+
+void StartupTrace::complete(const char *category, const std::string& name, double start, double end)
+{
+    if (!enabled())
+        return;
+
+    Trace& trace=Trace::instance();
+    std::lock_guard<std::mutex> lck(trace.mtx);
+
+    std::map<std::thread::id, int>::iterator it=trace.threads.find(std::this_thread::get_id());
+    int tid;
+    if (it==trace.threads.end())
+    {
+        tid=(int)trace.threads.size()+1;
+        trace.threads[std::this_thread::get_id()]=tid;
+    }
+    else
+    {
+        tid=it->second;
+    }
+
+    fprintf(trace.file, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.0f,\"dur\":%.0f,\"pid\":1,\"tid\":%d},\n",
+            escape(name).c_str(), escape(category).c_str(), start, end-start, tid);
+    fflush(trace.file);
+}
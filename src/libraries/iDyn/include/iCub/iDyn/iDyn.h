@@ -73,6 +73,7 @@
 
 #include <deque>
 #include <string>
+#include <vector>
 
 
 namespace iCub
@@ -118,6 +119,7 @@ class iDynLink : public iKin::iKinLink
 {
     friend class iDynChain;
     friend class OneLinkNewtonEuler;
+    friend class OneChainNewtonEuler;
 
 protected:
     // DH rototranslation matrix (it's the same matrix you get calling iKinLink->getH(true) but it's stored here for performance reason)
@@ -555,6 +557,43 @@ protected:
 
     const yarp::sig::Vector zero0;
 
+    ///buffers of the joint space dynamics: link rotations, translations and composite terms
+    std::vector<double> jsR;
+    std::vector<double> jsRp;
+    std::vector<double> jsWork;
+
+    /**
+    * Fills jsR and jsRp with the rotations and the translations (projected
+    * in the link frame) of all the links, as used by the Newton-Euler recursion.
+    */
+    void jointSpaceTransforms();
+
+    /**
+    * Rotates a vector from the base reference frame to the 0th frame (via H0).
+    * @param v the input 3x1 array
+    * @param v0 the output 3x1 array
+    */
+    void baseToFrame0(const double *v, double *v0) const;
+
+    /**
+    * Runs a Newton-Euler recursion with null joint accelerations on the
+    * internal buffers, without touching the state of the links.
+    * @param ddp0 the base linear acceleration (3x1), i.e. minus gravity
+    * @param useVel if false the joint velocities are considered null
+    * @return a DOF-dim vector of torques
+    */
+    yarp::sig::Vector jointSpaceRNEA(const yarp::sig::Vector &ddp0, const bool useVel);
+
+    /**
+    * Computes the gravity torques on the internal buffers, with an optional
+    * payload rigidly attached to the end-effector.
+    * @param ddp0 the base linear acceleration (3x1), i.e. minus gravity
+    * @param mEnd the payload mass
+    * @param sEnd the 3x1 array of the payload first moment of mass in the end-effector frame
+    * @return a DOF-dim vector of torques
+    */
+    yarp::sig::Vector gravityTorques(const yarp::sig::Vector &ddp0, const double mEnd, const double *sEnd);
+
     /**
     * Clone function
     */
@@ -1093,6 +1132,10 @@ public:
 
     /**
     * Compute the joint space mass matrix considering only the active joints.
+    * The Composite Rigid Body Algorithm is used, with the same inertial
+    * parameters of the Newton-Euler recursion (the rotor inertia is not
+    * considered); the velocities and accelerations of the chain are 
+    * left untouched.
     * @return a DOF-by-DOF symmetric positive-definite matrix
     */
     yarp::sig::Matrix computeMassMatrix();
@@ -1105,7 +1148,8 @@ public:
     yarp::sig::Matrix computeMassMatrix(const yarp::sig::Vector& q);
 
     /**
-    * Compute the torques due to centrifugal and coriolis effects considering only the active joints.
+    * Compute the torques due to centrifugal and coriolis effects considering only the active joints,
+    * i.e. C(q,dq)dq. The joint accelerations are considered null, but they are not modified.
     * @return a DOF-dim vector
     */
     yarp::sig::Vector computeCcTorques();
@@ -1120,9 +1164,11 @@ public:
 
     /**
     * Compute the torques generated by gravity considering only the active joints.
+    * A dedicated pass over the composite masses of the links is performed, whose
+    * cost is linear in the number of links.
     * @param ddp0 a vector that is equal and opposite to gravity expressed in the base reference frame (not the 0th frame)
     * @return a DOF-dim vector
-    * @note After calling this method the NewtonEulerMode is set to STATIC
+    * @note Neither the Newton-Euler mode nor the state of the links are modified.
     */
     yarp::sig::Vector computeGravityTorques(const yarp::sig::Vector& ddp0);
 
@@ -1131,10 +1177,54 @@ public:
     * @param ddp0 a vector that is equal and opposite to gravity expressed in the base reference frame (not the 0th frame)
     * @param q vector of the active joint positions
     * @return a DOF-dim vector
-    * @note After calling this method the NewtonEulerMode is set to STATIC
+    * @note Neither the Newton-Euler mode nor the state of the links are modified.
     */
     yarp::sig::Vector computeGravityTorques(const yarp::sig::Vector& ddp0, const yarp::sig::Vector& q);
 
+    /**
+    * Compute the torques generated by gravity considering only the active joints,
+    * when a payload is rigidly attached to the end-effector (e.g. the rest of a
+    * kinematic tree whose configuration is currently fixed): under gravity the
+    * payload acts as a point mass placed in its COM.
+    * @param ddp0 a vector that is equal and opposite to gravity expressed in the base reference frame (not the 0th frame)
+    * @param mEnd the mass of the payload
+    * @param sEnd the first moment of mass of the payload, i.e. its mass times its COM,
+    *             expressed in the end-effector frame (3x1)
+    * @return a DOF-dim vector
+    * @note Neither the Newton-Euler mode nor the state of the links are modified.
+    */
+    yarp::sig::Vector computeGravityTorques(const yarp::sig::Vector& ddp0, const double mEnd, const yarp::sig::Vector& sEnd);
+
+    /**
+    * Compute the total mass of the chain and its first moment of mass, i.e. the
+    * total mass times the position of the COM, in the current configuration.
+    * @param s the 3x1 first moment of mass, expressed in the base reference frame (not the 0th frame)
+    * @return the total mass
+    * @note Neither the Newton-Euler mode nor the state of the links are modified.
+    */
+    double computeFirstMomentOfMass(yarp::sig::Vector &s);
+
+    /**
+    * Compute in one sweep the total mass of the chain, its first moment of mass and the
+    * Jacobian of the latter, reusing the transforms of the links cached by the chain, i.e. the
+    * ones of getH(i,true). A payload rigidly attached to the end-effector (e.g. the rest of a
+    * kinematic tree) is accounted for in the Jacobian.
+    * @param B the 4x4 roto-translation from the frame of the results to the base reference frame
+    * @param mEnd the mass of the payload
+    * @param sEnd the first moment of mass of the payload, in the frame of the results (3 doubles)
+    * @param s the first moment of mass of the links, in the frame of the results (3 doubles)
+    * @param J the matrix, at least 6-by-(c0+DOF), whose columns c0...c0+DOF-1 get the Jacobian:
+    *          the rows 0-2 are the derivatives of the first moment of mass of links and payload
+    *          with respect to the active joints, the rows 3-5 the axes of the joints times the
+    *          mass they move
+    * @param c0 the first column of J to be filled
+    * @return the total mass of the links
+    * @note Neither the Newton-Euler mode nor the state of the links are modified, and no memory
+    *       is allocated once the buffers of the chain have been sized.
+    */
+    double computeFirstMomentOfMassJacobian(const yarp::sig::Matrix &B, const double mEnd, const double *sEnd,
+                                            double *s, yarp::sig::Matrix &J, const unsigned int c0);
+
     /**
     * Compute the torques generated by gravity and centrifugal and coriolis forces, considering only the active joints.
     * @param ddp0 a vector that is equal and opposite to gravity expressed in the base reference frame (not the 0th frame)
@@ -1154,6 +1244,77 @@ public:
     yarp::sig::Vector computeCcGravityTorques(const yarp::sig::Vector& ddp0, const yarp::sig::Vector& q, const yarp::sig::Vector& dq);
 
 
+    //---------------------------
+    // Dynamic regressor
+    //---------------------------
+
+    /**
+    * Returns the number of inertial parameters of the chain, i.e. 10 for each link 
+    * (blocked links included).
+    * @return 10*N
+    */
+    unsigned int getNumInertialParameters() const { return 10*N; }
+
+    /**
+    * Returns the inertial parameters of the chain, stacked link after link in the form 
+    * [m, m*rCx, m*rCy, m*rCz, Ixx, Ixy, Ixz, Iyy, Iyz, Izz], where the inertia tensor
+    * is expressed with respect to the origin of the link frame.
+    * @return a (10*N)-dim vector such that tau = Y*pi
+    */
+    yarp::sig::Vector getInertialParameters() const;
+
+    /**
+    * Sets the inertial parameters of the chain, in the same form of getInertialParameters().
+    * Links with a null mass keep their COM and get the inertia tensor as it is.
+    * @param pi the (10*N)-dim vector of parameters
+    * @return true if operation is successful, false otherwise
+    */
+    bool setInertialParameters(const yarp::sig::Vector &pi);
+
+    /**
+    * Compute the dynamic regressor of the active joints in the current configuration.
+    * @param ddp0 a vector that is equal and opposite to gravity expressed in the base reference frame (not the 0th frame)
+    * @return the DOF-by-(10*N) matrix Y such that the torques are Y*getInertialParameters()
+    * @note The rotor dynamics and the friction are not considered, and the end-effector wrench is null.
+    */
+    yarp::sig::Matrix computeRegressor(const yarp::sig::Vector &ddp0) const;
+
+    /**
+    * Compute the dynamic regressor of the active joints for a given state, without modifying the chain.
+    * @param q vector of the active joint positions (angles constraints are not evaluated)
+    * @param dq vector of the active joint velocities
+    * @param ddq vector of the active joint accelerations
+    * @param ddp0 a vector that is equal and opposite to gravity expressed in the base reference frame (not the 0th frame)
+    * @param Y the output DOF-by-(10*N) regressor
+    * @return true if operation is successful, false otherwise
+    */
+    bool computeRegressor(const yarp::sig::Vector &q, const yarp::sig::Vector &dq, const yarp::sig::Vector &ddq,
+                          const yarp::sig::Vector &ddp0, yarp::sig::Matrix &Y) const;
+
+    /**
+    * Compute the stacked dynamic regressor for a set of samples, without modifying the chain.
+    * @param Q the M-by-DOF matrix of joint positions, one sample per row
+    * @param dQ the M-by-DOF matrix of joint velocities
+    * @param ddQ the M-by-DOF matrix of joint accelerations
+    * @param ddp0 a vector that is equal and opposite to gravity expressed in the base reference frame (not the 0th frame)
+    * @param Y the output (M*DOF)-by-(10*N) regressor, where rows from k*DOF to (k+1)*DOF-1 belong to the k-th sample
+    * @param nThreads the number of threads the samples are split into (1 by default)
+    * @return true if operation is successful, false otherwise
+    */
+    bool computeRegressorBatch(const yarp::sig::Matrix &Q, const yarp::sig::Matrix &dQ, const yarp::sig::Matrix &ddQ,
+                               const yarp::sig::Vector &ddp0, yarp::sig::Matrix &Y, unsigned int nThreads=1) const;
+
+    /**
+    * The core of the regressor computation: it works on plain arrays and
+    * private scratch storage, hence it can be called concurrently.
+    * @param q, dq, ddq the DOF-dim arrays of joint positions, velocities and accelerations
+    * @param ddp0 the 3-dim array of the base linear acceleration, i.e. minus gravity
+    * @param Y points to the first of DOF rows of length 10*N, separated by stride values
+    * @param stride the distance between two consecutive rows of Y
+    * @param work is the scratch storage, resized as needed
+    */
+    void computeRegressor(const double *q, const double *dq, const double *ddq, const double *ddp0,
+                          double *Y, const size_t stride, std::vector<double> &work) const;
 
 };
 
@@ -54,6 +54,11 @@
 #include <iCub/iDyn/iDynContact.h>
 #include <deque>
 #include <string>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 
 namespace iCub
@@ -121,6 +126,61 @@ struct version_tag
 
 //enum partEnum{ LEFT_ARM=0, RIGHT_ARM, LEFT_LEG, RIGHT_LEG, TORSO, HEAD, ALL }; 
 
+/**
+* \ingroup iDynBody
+*
+* A small pool of persistent threads used by the nodes to solve the 
+* limbs concurrently. The thread calling run() takes part in the 
+* computation while waiting, hence jobs can safely submit nested 
+* batches to the same pool (e.g. the whole body running two nodes, 
+* each one running its limbs). 
+* The join is deterministic: run() returns only when all the jobs 
+* of the batch are over, and each job is supposed to write its own 
+* results only, so that they can be combined afterwards in a fixed 
+* order.
+*/
+class iDynWorkerPool
+{
+protected:
+    /// the persistent workers
+    std::vector<std::thread> workers;
+    /// the jobs waiting for a thread
+    std::deque<std::function<void()> > jobs;
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool closing;
+
+    /**
+    * The workers loop.
+    */
+    void loop();
+
+public:
+
+    /**
+    * Constructor
+    * @param nThreads the overall number of threads, including the 
+    * caller of run(): nThreads-1 workers are thus spawned
+    */
+    iDynWorkerPool(unsigned int nThreads);
+
+    /**
+    * Destructor: stops and joins the workers
+    */
+    ~iDynWorkerPool();
+
+    /**
+    * @return the overall number of threads, including the caller
+    */
+    unsigned int getNumThreads() const;
+
+    /**
+    * Runs a batch of jobs and waits for their completion.
+    * @param batch the list of jobs
+    */
+    void run(const std::deque<std::function<void()> > &batch);
+};
+
 /**
 * \ingroup iDynBody
 *
@@ -602,6 +662,15 @@ protected:
     */
     unsigned int howManyKinematicInputs(bool afterAttach=false) const;
 
+    /// the pool solving the limbs concurrently (not owned, NULL if sequential)
+    iDynWorkerPool *pool;
+
+    /**
+    * Run a batch of limb computations, on the worker pool if any or
+    * sequentially otherwise.
+    */
+    void runLimbJobs(const std::deque<std::function<void()> > &batch);
+
 public:
 
     /**
@@ -636,6 +705,21 @@ public:
     */
     yarp::sig::Matrix getRBT(unsigned int iLimb) const;
 
+    /**
+    * Set the pool of threads used to solve the limbs concurrently: the 
+    * limbs sharing the same information flow are solved in parallel, 
+    * whereas the node balance is always summed up in the limbs order, 
+    * hence the results do not depend on the pool.
+    * @param _pool the pool (not owned by the node); NULL restores the 
+    * sequential computation
+    */
+    void setWorkerPool(iDynWorkerPool *_pool);
+
+    /**
+    * @return the pool of threads in use, or NULL
+    */
+    iDynWorkerPool *getWorkerPool() const;
+
     /**
     * Main function to manage the exchange of kinematic information among the limbs attached to the node.
     * One single limb with kinematic flow of input type must exist: this limb is initilized with the kinematic variables
@@ -1475,6 +1559,19 @@ protected:
     /// defining the connection between Upper and Lower Torso
     RigidBodyTransformation * rbt;
     version_tag tag;
+    /// the pool shared by the nodes for concurrent solving (NULL if sequential)
+    iDynWorkerPool * pool;
+
+    /**
+    * Pass the kinematics of the torso from the upper to the lower torso.
+    */
+    void attachLowerTorsoKinematics();
+
+    /**
+    * Pass the wrench of the torso from the upper to the lower torso, 
+    * along with the legs measurements.
+    */
+    void attachLowerTorsoWrench(const yarp::sig::Vector &FM_right_leg, const yarp::sig::Vector &FM_left_leg);
 
 public:
 
@@ -1491,6 +1588,7 @@ public:
     yarp::sig::Vector upper_COM;
     yarp::sig::Vector lower_COM;
     yarp::sig::Matrix COM_Jacob;
+    yarp::sig::Matrix whole_COM_Jacob;
     double sw_getcom;
     /**
     * Constructor: build the nodes and creates the whole body
@@ -1510,6 +1608,45 @@ public:
     */
     void attachLowerTorso(const yarp::sig::Vector &FM_right_leg, const yarp::sig::Vector &FM_left_leg);
 
+    /**
+    * Set the number of threads used to solve the whole body. With more 
+    * than one thread, a persistent pool is shared by the upper and lower 
+    * torso: the limbs of each node are solved concurrently and, within 
+    * solve(), the wrench phase of the upper torso overlaps the kinematic 
+    * phase of the lower torso. Results are the same as the sequential 
+    * computation.
+    * @param nThreads the number of threads, including the caller (0 or 1 
+    * means sequential)
+    * @note not to be called while solving
+    */
+    void setNumThreads(unsigned int nThreads);
+
+    /**
+    * @return the number of threads used to solve the whole body
+    */
+    unsigned int getNumThreads() const;
+
+    /**
+    * Solve kinematics and wrenches of the whole body, assuming the 
+    * upper torso measurements (inertial and FT sensors) are already set.
+    * It is equivalent to upperTorso->solveKinematics(), upperTorso->solveWrench(), 
+    * attachLowerTorso(), lowerTorso->solveKinematics(), lowerTorso->solveWrench().
+    * @param FM_right_leg the measured wrench of the right leg FT sensor
+    * @param FM_left_leg the measured wrench of the left leg FT sensor
+    * @return true if succeeds, false otherwise
+    */
+    bool solve(const yarp::sig::Vector &FM_right_leg, const yarp::sig::Vector &FM_left_leg);
+
+    /**
+    * Same as solve(), but starting after upperTorso->solveKinematics(): this
+    * is useful to update the contacts of the upper torso, which depend on
+    * its kinematics, before solving the wrenches.
+    * @param FM_right_leg the measured wrench of the right leg FT sensor
+    * @param FM_left_leg the measured wrench of the left leg FT sensor
+    * @return true if succeeds, false otherwise
+    */
+    bool solveAfterUpperKinematics(const yarp::sig::Vector &FM_right_leg, const yarp::sig::Vector &FM_left_leg);
+
     /**
     * Performs the computation of the center of mass (COM) of the whole iCub
     * @return true if succeeds, false otherwise
@@ -1525,6 +1662,23 @@ public:
     */
     bool getCOM(iCub::skinDynLib::BodyPart which_part, yarp::sig::Vector &COM, double & mass);
 
+    /**
+    * Performs the computation of the COM of the whole iCub and of its Jacobian in one sweep
+    * over the limbs, reusing the transforms of the links cached by the kinematics; it is meant
+    * to be called at every cycle. The COM and the mass are those of getCOM(BODY_PART_ALL,...).
+    * @return true if succeeds, false otherwise
+    */
+    bool computeCOMJacobian();
+
+    /**
+    * Retrieves the result of the last computeCOMJacobian()
+    * @param jac the 6x32 jacobian, whose columns are ordered as in getAllVelocities(): the rows
+    *            0-2 give the velocity of the COM, the rows 3-5 the axes of the joints weighted
+    *            by the fraction of the whole mass which they move
+    * @return true if succeeds, false otherwise
+    */
+    bool getCOMJacobian(yarp::sig::Matrix &jac) const;
+
     /**
     * Retrieves a vector containing the velocities of all the iCub joints, ordered in this way:
     * left leg (6), right leg (6), torso (3), left arm (7), right arm (7), head (3).
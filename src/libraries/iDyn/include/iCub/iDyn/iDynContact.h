@@ -30,6 +30,7 @@
 #ifndef __IDYNCONT_H__
 #define __IDYNCONT_H__
 
+#include <vector>
 #include <iCub/iDyn/iDyn.h>
 #include "iCub/skinDynLib/dynContactList.h"
 
@@ -59,8 +60,43 @@ protected:
     // body part related to this solver
     iCub::skinDynLib::BodyPart      bodyPart;
 
+    /**
+     * Columns of the linear system related to a single contact, together with the
+     * data they have been computed from. A block is reused as long as the contact
+     * (identified by its id) keeps the same link, unknowns, CoP, force direction
+     * and the same pose w.r.t. the reference frame of the system.
+     */
+    struct ContactBlock
+    {
+        unsigned long       id;
+        unsigned int        linkNumber;
+        bool                momentKnown;
+        bool                forceDirectionKnown;
+        yarp::sig::Vector   CoP;
+        yarp::sig::Vector   forceDirection;
+        yarp::sig::Matrix   H;      // pose of the contact link w.r.t. the reference frame
+        yarp::sig::Matrix   A;      // 6 x unknowns columns of the system matrix
+        yarp::sig::Matrix   G;      // contribution A*A^T to the Gram matrix
+    };
+
+    /// reference frame (i.e. <firstContactLink-1>) of the cached system
+    int                             cacheRefLink;
+    /// poses of the links of the contact sub-chain w.r.t. the reference frame
+    std::vector<yarp::sig::Matrix>  Hsub;
+    /// blocks of the current contact set, in the same order of the contact list
+    std::vector<ContactBlock>       blocks;
+    /// Gram matrix of the system, i.e. the sum of the contributions of all the blocks
+    yarp::sig::Matrix               Gsum;
+    /// pseudo-inverse of the Gram matrix
+    yarp::sig::Matrix               pinvG;
+
     void findContactSubChain(unsigned int &firstLink, unsigned int &lastLink);
     
+    void computeSubChainPoses(unsigned int firstContactLink, unsigned int lastContactLink);
+    bool isBlockValid(const ContactBlock &b, const iCub::skinDynLib::dynContact &c) const;
+    void buildBlock(ContactBlock &b, const iCub::skinDynLib::dynContact &c) const;
+    void updateBlocks(unsigned int firstContactLink);
+    // buildA() and buildB() use the poses computed by computeSubChainPoses()
     yarp::sig::Matrix buildA(unsigned int firstContactLink, unsigned int lastContactLink);
     yarp::sig::Vector buildB(unsigned int firstContactLink, unsigned int lastContactLink);
     
@@ -138,6 +174,10 @@ public:
 
     /**
      * Compute an estimate of the external contact wrenches.
+     * The least-squares solution is computed as X = A^T*pinv(A*A^T)*B, where the
+     * 6x6 Gram matrix A*A^T is the sum of the contributions of the single contacts:
+     * these are cached and, when contacts appear or disappear (or move) while the others
+     * stay still, the Gram matrix is updated only with the contributions that changed.
      * @param FMsens the wrench measured by the F/T sensor
      * @return A copy of the external contact list
      */
@@ -51,6 +51,7 @@
 #include <iCub/skinDynLib/common.h>
 #include <deque>
 #include <string>
+#include <vector>
 
 
 namespace iCub
@@ -490,6 +491,8 @@ public:
 */
 class BaseLinkNewtonEuler : public OneLinkNewtonEuler
 {
+    friend class OneChainNewtonEuler;
+
 protected:
     ///initial angular velocity
     yarp::sig::Vector w;    
@@ -901,6 +904,33 @@ protected:
     /// verbosity flag
     unsigned int verbose;
 
+    /// the links of the chain, cached for the flat recursion
+    std::vector<iDyn::iDynLink*> flatLinks;
+    /// link rotations (3x3 row-major, one per link) and origins
+    /// projected in the link frame
+    std::vector<double> flatR, flatRp;
+    /// per-frame 3-vectors of the flat recursion (base, links, final)
+    std::vector<double> flatW, flatDw, flatDdpC, flatF, flatMu;
+
+    /**
+     * Computes the link rotations and the projected origins straight
+     * from the DH parameters into the flat buffers.
+     */
+    void flatTransforms();
+
+    /**
+     * [classic] Forward kinematic phase on flat buffers: same result 
+     * of the link-wise recursion, without temporaries.
+     */
+    void flatForwardKinematicFromBase();
+
+    /**
+     * [classic] Backward wrench phase on flat buffers, torques included: 
+     * same result of the link-wise recursion, without temporaries.
+     * @note not available in DYNAMIC_W_ROTOR mode.
+     */
+    void flatBackwardWrenchFromEnd();
+
 public:
 
   /**
@@ -0,0 +1,201 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * CopyPolicy: Released under the terms of the GNU GPL v2.0.
+ *
+ */
+
+/**
+ * \defgroup iDynRegressor
+ *
+ * @ingroup iDyn
+ *
+ * Classes for the identification of the inertial parameters of a chain
+ * from logged data.
+ *
+ * \section intro_sec Description
+ *
+ * The joint torques of an iDynChain are linear in the inertial parameters
+ * of its links, i.e. tau = Y(q,dq,ddq)*pi (see iDynChain::computeRegressor()).
+ * The class iDynRegressorStream feeds samples from files recorded with the
+ * DatasetRecorder of the learningMachine library (or one sample at a time)
+ * and accumulates the normal equations of the least-squares problem, so
+ * that datasets of any length can be processed with constant memory.
+ *
+ * \section tested_os_sec Tested OS
+ *
+ * Windows and Linux
+ *
+ **/
+
+#ifndef __IDYNREGRESSOR_H__
+#define __IDYNREGRESSOR_H__
+
+#include <string>
+#include <vector>
+
+#include <yarp/sig/Vector.h>
+#include <yarp/sig/Matrix.h>
+
+#include <iCub/iDyn/iDyn.h>
+
+
+namespace iCub
+{
+
+namespace iDyn
+{
+
+/**
+* \ingroup iDynRegressor
+*
+* Accumulates the normal equations Y'*Y*pi = Y'*tau over a stream of
+* samples (q,dq,ddq,tau) of the active joints of a chain.
+*
+* Each line of a DatasetRecorder file stores the input vector followed
+* by the output vector; by default the input is assumed to be [q dq ddq]
+* and the output tau, but the column where each block starts can be
+* configured with setLayout(), counting the columns across the whole
+* line. Samples are processed in blocks split among several threads.
+*
+* @note The chain is only read, hence its state is not modified; its
+*       structure (e.g. blocked links) and the base acceleration have
+*       to stay the same during the whole stream.
+*/
+class iDynRegressorStream
+{
+protected:
+    const iDynChain *chain;
+    yarp::sig::Vector ddp0;
+    unsigned int verbose;
+    unsigned int nThreads;
+    unsigned int blockSize;
+    unsigned int qCol;
+    unsigned int dqCol;
+    unsigned int ddqCol;
+    unsigned int tauCol;
+    double jntScale;
+
+    unsigned long nSamples;
+    double tauSq;
+    yarp::sig::Matrix YtY;
+    yarp::sig::Vector Ytau;
+
+    std::vector<double> block;
+    unsigned int blockLen;
+
+    void processBlock();
+    void processChunk(const unsigned int s0, const unsigned int s1,
+                      std::vector<double> &A, std::vector<double> &b, double &c) const;
+
+public:
+    /**
+    * Constructor.
+    * @param _chain is the chain whose parameters are to be identified.
+    * @param _ddp0 is the base linear acceleration, i.e. minus gravity,
+    *              expressed in the base reference frame.
+    * @param verb is the verbosity level.
+    */
+    iDynRegressorStream(const iDynChain *_chain, const yarp::sig::Vector &_ddp0,
+                        const unsigned int verb=0);
+
+    /**
+    * Sets the column of the recorded lines where each block of DOF values
+    * starts (by default 0, DOF, 2*DOF and 3*DOF).
+    * @param _qCol is the first column of the joint positions.
+    * @param _dqCol is the first column of the joint velocities.
+    * @param _ddqCol is the first column of the joint accelerations.
+    * @param _tauCol is the first column of the joint torques.
+    */
+    void setLayout(const unsigned int _qCol, const unsigned int _dqCol,
+                   const unsigned int _ddqCol, const unsigned int _tauCol);
+
+    /**
+    * Specifies whether the recorded joint quantities are in degrees
+    * (false by default, i.e. radians).
+    * @param deg true for degrees.
+    */
+    void setDegrees(const bool deg);
+
+    /**
+    * Sets the number of threads the samples are processed with.
+    * @param _nThreads is the number of threads (1 by default).
+    * @param _blockSize is the number of samples processed together.
+    */
+    void setNumThreads(const unsigned int _nThreads, const unsigned int _blockSize=1024);
+
+    /**
+    * Clears the accumulated normal equations.
+    */
+    void reset();
+
+    /**
+    * Feeds one sample. Samples are buffered and processed in blocks.
+    * @param q are the joint positions.
+    * @param dq are the joint velocities.
+    * @param ddq are the joint accelerations.
+    * @param tau are the joint torques.
+    * @return true/false on success/failure.
+    */
+    bool feedSample(const yarp::sig::Vector &q, const yarp::sig::Vector &dq,
+                    const yarp::sig::Vector &ddq, const yarp::sig::Vector &tau);
+
+    /**
+    * Feeds all the samples of a file recorded by DatasetRecorder. Empty
+    * lines, lines starting with '#' and lines with too few columns are
+    * skipped.
+    * @param filename is the name of the file.
+    * @return the number of samples read, -1 if the file cannot be opened.
+    */
+    int feedFile(const std::string &filename);
+
+    /**
+    * Processes the samples still buffered.
+    */
+    void flush();
+
+    /**
+    * Returns the number of processed samples.
+    * @return the number of samples.
+    */
+    unsigned long getNumSamples() const { return nSamples; }
+
+    /**
+    * Returns the accumulated Y'*Y (pending samples are processed).
+    * @return the (10*N)x(10*N) matrix.
+    */
+    const yarp::sig::Matrix &getNormalMatrix();
+
+    /**
+    * Returns the accumulated Y'*tau (pending samples are processed).
+    * @return the (10*N)-dim vector.
+    */
+    const yarp::sig::Vector &getNormalVector();
+
+    /**
+    * Solves the regularized least-squares problem
+    * min |Y*pi-tau|^2+lambda*|pi-pi0|^2, where pi0 are the current
+    * parameters of the chain: the regularization copes with the
+    * parameters that are not identifiable from the data.
+    * @param pi is the output vector of parameters, in the form of
+    *           iDynChain::getInertialParameters().
+    * @param lambda is the regularization weight.
+    * @return true/false on success/failure.
+    */
+    bool solve(yarp::sig::Vector &pi, const double lambda=1e-6);
+
+    /**
+    * Returns the RMS torque error of a set of parameters over the
+    * processed samples.
+    * @param pi is the vector of parameters.
+    * @return the RMS error.
+    */
+    double getResidual(const yarp::sig::Vector &pi);
+};
+
+}
+
+}
+
+#endif
+
+
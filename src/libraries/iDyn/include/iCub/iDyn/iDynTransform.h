@@ -81,6 +81,7 @@ example code:
 #include <iCub/iDyn/iDynInv.h>
 
 #include <string>
+#include <vector>
 //#include <deque>
 
 
@@ -317,7 +318,17 @@ private:
 
     bool ownLimb;
 
+    // cache of projectWrench(): rotation (row-major) and position of the sensor
+    // in the end-effector frame, valid as long as the links beyond the sensor
+    // keep the revisions they had when it was computed
+    double Rse[9];
+    double pse[3];
+    unsigned int firstRev;
+    std::vector<unsigned long> revs;
+    bool cacheValid;
+
     void initiFTransformation();
+    void updateProjection();
 
 public:
     iFTransformation();
@@ -349,6 +360,25 @@ public:
     yarp::sig::Matrix getHs(){return Hs;}
     yarp::sig::Matrix getHe(){return He;}
 
+    /**
+    * Projects a wrench measured by the sensor onto the end-effector, as
+    * getEndEffWrench(_FT) does, without touching the state of the object.
+    * The transformation from the sensor to the end-effector is cached and
+    * recomputed only when the links beyond the sensor change, thus the
+    * calls in between cost a few products and allocate nothing.
+    * @param in the 6x1 wrench (force, moment) in the sensor frame
+    * @param out the 6x1 wrench in the end-effector frame
+    * @return true/false on success/failure (wrong size of in)
+    * @note The sensor placement and the HN of the chain are taken as
+    *       constant: after changing them call refreshProjection().
+    */
+    bool projectWrench(const yarp::sig::Vector &in, yarp::sig::Vector &out);
+
+    /**
+    * Forces projectWrench() to recompute its transformation at the next call.
+    */
+    void refreshProjection() { cacheValid=false; }
+
     
 };
 
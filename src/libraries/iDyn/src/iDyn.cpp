@@ -20,6 +20,8 @@
 #include <cstdio>
 #include <iostream>
 #include <iomanip>
+#include <thread>
+#include <algorithm>
 
 #include <yarp/os/Log.h>
 #include <iCub/iDyn/iDyn.h>
@@ -1602,39 +1604,258 @@ Matrix iDynChain::getHCOM(unsigned int iLink)
     return getH(iLink,true) * allList[iLink]->getCOM();
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+namespace
+{
+    // fixed-size helpers of the joint space dynamics: 3x3 matrices are row-major
+
+    inline void mul3(const double *R, const double *v, double *out)
+    {
+        out[0]=R[0]*v[0]+R[1]*v[1]+R[2]*v[2];
+        out[1]=R[3]*v[0]+R[4]*v[1]+R[5]*v[2];
+        out[2]=R[6]*v[0]+R[7]*v[1]+R[8]*v[2];
+    }
+
+    inline void mul4(const double *A, const double *B, double *out)
+    {
+        for(int r=0; r<4; r++)
+            for(int c=0; c<4; c++)
+                out[4*r+c]=A[4*r]*B[c]+A[4*r+1]*B[4+c]+A[4*r+2]*B[8+c]+A[4*r+3]*B[12+c];
+    }
+
+    inline void mulTransp3(const double *R, const double *v, double *out)
+    {
+        out[0]=R[0]*v[0]+R[3]*v[1]+R[6]*v[2];
+        out[1]=R[1]*v[0]+R[4]*v[1]+R[7]*v[2];
+        out[2]=R[2]*v[0]+R[5]*v[1]+R[8]*v[2];
+    }
+
+    inline void addCross3(const double *a, const double *b, double *out)
+    {
+        out[0]+=a[1]*b[2]-a[2]*b[1];
+        out[1]+=a[2]*b[0]-a[0]*b[2];
+        out[2]+=a[0]*b[1]-a[1]*b[0];
+    }
+
+    inline void addCentripetal3(const double *w, const double *dw, const double *r, double *out)
+    {
+        // out += dw x r + w x (w x r)
+        double wr[3]={ w[1]*r[2]-w[2]*r[1], w[2]*r[0]-w[0]*r[2], w[0]*r[1]-w[1]*r[0] };
+        addCross3(dw,r,out);
+        addCross3(w,wr,out);
+    }
+
+    inline void linkTransform(const iKinLink *l, const double q, double *R, double *rp)
+    {
+        double theta = q+l->getOffset();
+        double ct = cos(theta), st = sin(theta);
+        double ca = cos(l->getAlpha()), sa = sin(l->getAlpha());
+
+        R[0]=ct; R[1]=-st*ca; R[2]=st*sa;
+        R[3]=st; R[4]=ct*ca;  R[5]=-ct*sa;
+        R[6]=0.0; R[7]=sa;    R[8]=ca;
+
+        //r projected in the link frame: R^T*[A*ct, A*st, D]
+        rp[0]=l->getA(); rp[1]=l->getD()*sa; rp[2]=l->getD()*ca;
+    }
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynChain::jointSpaceTransforms()
+{
+    jsR.resize(9*N);
+    jsRp.resize(3*N);
+    for(unsigned int i=0; i<N; i++)
+    {
+        const iKinLink *l = allList[i];
+        linkTransform(l,l->getAng(),&jsR[9*i],&jsRp[3*i]);
+    }
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynChain::baseToFrame0(const double *v, double *v0) const
+{
+    //same as BaseLinkNewtonEuler: R0^T*v
+    const double *H = H0.data();
+    v0[0]=H[0]*v[0]+H[4]*v[1]+H[8]*v[2];
+    v0[1]=H[1]*v[0]+H[5]*v[1]+H[9]*v[2];
+    v0[2]=H[2]*v[0]+H[6]*v[1]+H[10]*v[2];
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+Vector iDynChain::jointSpaceRNEA(const Vector &ddp0, const bool useVel)
+{
+    Vector tau(DOF,0.0);
+    if(ddp0.length()!=3)
+    {
+        if(verbose) yError("iDynChain error: could not compute the torques due to wrong size of ddp0: %d instead of 3 \n",(int)ddp0.length());
+        return tau;
+    }
+
+    jointSpaceTransforms();
+    jsWork.resize(9*N);
+    double *W = &jsWork[0];
+    double *Dw = &jsWork[3*N];
+    double *DdpC = &jsWork[6*N];
+
+    //forward kinematics with null joint accelerations
+    //ddp0 is expressed in the base reference frame, before H0
+    double w[3]={ 0.0, 0.0, 0.0 };
+    double dw[3]={ 0.0, 0.0, 0.0 };
+    double ddp[3];
+    baseToFrame0(ddp0.data(),ddp);
+    for(unsigned int i=0; i<N; i++)
+    {
+        const iDynLink *l = static_cast<const iDynLink*>(allList[i]);
+        const double *R = &jsR[9*i];
+        double dq = useVel ? l->dq : 0.0;
+        double v[3]={ w[0], w[1], w[2]+dq };
+        double a[3]={ dw[0]+dq*w[1], dw[1]-dq*w[0], dw[2] };
+        double t[3];
+
+        mulTransp3(R,v,w);
+        mulTransp3(R,a,dw);
+
+        mulTransp3(R,ddp,t);
+        addCentripetal3(w,dw,&jsRp[3*i],t);
+        ddp[0]=t[0]; ddp[1]=t[1]; ddp[2]=t[2];
+
+        addCentripetal3(w,dw,l->rc.data(),t);
+        for(int k=0; k<3; k++)
+        {
+            W[3*i+k] = w[k];
+            Dw[3*i+k] = dw[k];
+            DdpC[3*i+k] = t[k];
+        }
+    }
+
+    //backward wrench with null end-effector wrench
+    double F[3]={ 0.0, 0.0, 0.0 };
+    double Mu[3]={ 0.0, 0.0, 0.0 };
+    int j = DOF-1;
+    for(int i=N-1; i>=0; i--)
+    {
+        const iDynLink *l = static_cast<const iDynLink*>(allList[i]);
+        const double *R = &jsR[9*i];
+        const double *rp = &jsRp[3*i];
+        const double *rc = l->rc.data();
+        const double *In = l->I.data();
+        const double *wn = &W[3*i];
+        const double *dwn = &Dw[3*i];
+        const double *ddpCn = &DdpC[3*i];
+
+        double mac[3]={ l->m*ddpCn[0], l->m*ddpCn[1], l->m*ddpCn[2] };
+        double f[3]={ mac[0]+F[0], mac[1]+F[1], mac[2]+F[2] };
+
+        double rr[3]={ rp[0]+rc[0], rp[1]+rc[1], rp[2]+rc[2] };
+        double mu[3]={ Mu[0], Mu[1], Mu[2] };
+        double t[3];
+        addCross3(rp,F,mu);
+        addCross3(rr,mac,mu);
+        mul3(In,dwn,t);
+        mu[0]+=t[0]; mu[1]+=t[1]; mu[2]+=t[2];
+        mul3(In,wn,t);
+        addCross3(wn,t,mu);
+
+        mul3(R,f,F);
+        mul3(R,mu,Mu);
+
+        //the torque is the z-component of the moment in the previous frame
+        if((j>=0) && (hash[j]==(unsigned int)i))
+            tau[j--] = Mu[2];
+    }
+
+    return tau;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 Matrix iDynChain::computeMassMatrix()
 {
     Matrix M(DOF,DOF);          // mass matrix
-    iKinLink* l;
-    int hash_i;
-    setDAng(zeros(DOF));        // set to zero the joint vel
-    setD2Ang(zeros(DOF));       // set to zero the joint acc
-
-    if(NE==NULL || NE->getMode()!=DYNAMIC)
-        prepareNewtonEuler(DYNAMIC);
-    initNewtonEuler();                  // init with zero w, dw, ddp, F, Mu
-    NE->ForwardKinematicFromBase();     // propagate zero kinematics from base
-    
-    for(int i=DOF-1; i>=0; i--) // start from the end of the chain
-    {
-        l = quickList[hash_dof[i]];
-        hash_i = hash[i];
-        l->setD2Ang(1.0);       // set i-th accelleration to 1
-        
-        // forward kinematics from link i-1 to end
-        for(unsigned int j=1+hash_i; j<N+1; j++)
-            NE->neChain[j]->ForwardKinematics(NE->neChain[j-1]);
+    M.zero();
+    if(DOF==0)
+        return M;
+
+    jointSpaceTransforms();
+
+    // composite rigid bodies: C_i gathers links i..N-1 and is expressed
+    // in frame i-1 with respect to its origin (mass, first moment, inertia)
+    jsWork.resize(13*N);
+    double Mc = 0.0;
+    double h[3]={ 0.0, 0.0, 0.0 };
+    double Ic[9]={ 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    for(int i=N-1; i>=0; i--)
+    {
+        const iDynLink *l = static_cast<const iDynLink*>(allList[i]);
+        const double *R = &jsR[9*i];
+        const double *rc = l->rc.data();
+        const double *In = l->I.data();
+
+        // add link i to C_{i+1}, both in frame i: the inertia is moved
+        // from the COM to the origin (parallel axis theorem)
+        double rc2 = rc[0]*rc[0]+rc[1]*rc[1]+rc[2]*rc[2];
+        Mc += l->m;
+        for(int r=0; r<3; r++)
+        {
+            h[r] += l->m*rc[r];
+            for(int c=0; c<3; c++)
+                Ic[3*r+c] += In[3*r+c] + l->m*((r==c?rc2:0.0) - rc[r]*rc[c]);
+        }
 
-        // backward wrench from end to link i
-        for(int j=N; j>=hash_i; j--)
-            NE->neChain[j]->BackwardWrench(NE->neChain[j+1]);
+        // rotate in frame i-1: hR=R*h, IR=R*Ic*R^T
+        double hR[3], RI[9], IR[9];
+        mul3(R,h,hR);
+        for(int r=0; r<3; r++)
+            for(int c=0; c<3; c++)
+                RI[3*r+c] = R[3*r]*Ic[c] + R[3*r+1]*Ic[3+c] + R[3*r+2]*Ic[6+c];
+        for(int r=0; r<3; r++)
+            for(int c=0; c<3; c++)
+                IR[3*r+c] = RI[3*r]*R[3*c] + RI[3*r+1]*R[3*c+1] + RI[3*r+2]*R[3*c+2];
+
+        // translate from the origin of frame i to the one of frame i-1
+        double p[3];
+        mul3(R,&jsRp[3*i],p);
+        double ph = p[0]*hR[0]+p[1]*hR[1]+p[2]*hR[2];
+        double p2 = p[0]*p[0]+p[1]*p[1]+p[2]*p[2];
+        for(int r=0; r<3; r++)
+        {
+            for(int c=0; c<3; c++)
+                Ic[3*r+c] = IR[3*r+c] - hR[r]*p[c] - p[r]*hR[c] - Mc*p[r]*p[c]
+                          + (r==c ? 2.0*ph + Mc*p2 : 0.0);
+            h[r] = hR[r] + Mc*p[r];
+        }
 
-        // copy the joint torques in the i-th column of M
-        for(unsigned int j=i; j<DOF; j++)
-            M(j,i) = M(i,j) = NE->neChain[hash[j]]->getMoment(true)[2]; 
-        //same as quickList[hash_dof[j]]->getTorque(), but in this way you do not need to call computeTorque
+        double *C = &jsWork[13*i];
+        C[0] = Mc;
+        for(int k=0; k<3; k++)
+            C[1+k] = h[k];
+        for(int k=0; k<9; k++)
+            C[4+k] = Ic[k];
+    }
 
-        l->setD2Ang(0.0);          // set i-th accelleration to 0
+    // the unit acceleration of joint j spins C_j around the z-axis of frame j-1:
+    // the resulting wrench is carried back to the previous joints
+    for(int b=DOF-1; b>=0; b--)
+    {
+        unsigned int j = hash[b];
+        const double *C = &jsWork[13*j];
+        double f[3]={ -C[2], C[1], 0.0 };
+        double mu[3]={ C[4+2], C[4+5], C[4+8] };
+        M(b,b) = mu[2];
+
+        int a = b-1;
+        for(int k=(int)j-1; (k>=0) && (a>=0); k--)
+        {
+            const double *R = &jsR[9*k];
+            double t[3], p[3];
+            mul3(R,f,t);
+            f[0]=t[0]; f[1]=t[1]; f[2]=t[2];
+            mul3(R,mu,t);
+            mul3(R,&jsRp[3*k],p);
+            addCross3(p,f,t);
+            mu[0]=t[0]; mu[1]=t[1]; mu[2]=t[2];
+
+            if(hash[a]==(unsigned int)k)
+            {
+                M(a,b) = M(b,a) = mu[2];
+                a--;
+            }
+        }
     }
 
     return M;
@@ -1646,9 +1867,9 @@ Matrix iDynChain::computeMassMatrix(const Vector& q)
     return computeMassMatrix();
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-// This is a simpler version of the method, just to understand what the method does.
-// The new version is about 2 times faster than this, because it exploits the fact that
-// the mass matrix is symmetric (but it is a little harder to understand the code).
+// This is the plain Newton-Euler version of the method, just to understand what the method does:
+// each column of the mass matrix is the vector of torques obtained with a unit acceleration of
+// the corresponding joint. The CRBA version above is roughly one order of magnitude faster.
 //Matrix iDynChain::computeMassMatrix()
 //{
 //    // mass matrix
@@ -1672,17 +1893,8 @@ Matrix iDynChain::computeMassMatrix(const Vector& q)
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 Vector iDynChain::computeCcTorques()
 {
-    Vector cc(DOF);             // cc torque vector
-    setD2Ang(zeros(DOF));       // set to zero the joint acc
-
-    if(NE==NULL || NE->getMode()!=DYNAMIC)
-        prepareNewtonEuler(DYNAMIC);
-    initNewtonEuler();                  // init with zero w, dw, ddp, F, Mu
-    computeNewtonEuler();
-    for(unsigned int i=0; i<DOF; i++)
-        cc(i) = quickList[hash_dof[i]]->getTorque();
-    
-    return cc;
+    Vector zero3(3,0.0);
+    return jointSpaceRNEA(zero3,true);
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 Vector iDynChain::computeCcTorques(const Vector& q, const Vector& dq)
@@ -1694,13 +1906,72 @@ Vector iDynChain::computeCcTorques(const Vector& q, const Vector& dq)
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 Vector iDynChain::computeGravityTorques(const Vector& ddp0)
 {
-    Vector g(DOF), zero3(3, 0.0);
-    if(NE==NULL || NE->getMode()!=STATIC)
-        prepareNewtonEuler(STATIC);
-    initNewtonEuler(zero3, zero3, ddp0, zero3, zero3);      // init with zero w, dw, F, Mu
-    computeNewtonEuler();
-    for(unsigned int i=0; i<DOF; i++)
-        g(i) = quickList[hash_dof[i]]->getTorque();
+    const double s0[3]={ 0.0, 0.0, 0.0 };
+    return gravityTorques(ddp0,0.0,s0);
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+Vector iDynChain::computeGravityTorques(const Vector& ddp0, const double mEnd, const Vector& sEnd)
+{
+    if(sEnd.length()!=3)
+    {
+        if(verbose) yError("iDynChain error: computeGravityTorques() failed due to wrong size of sEnd: %d instead of 3 \n",(int)sEnd.length());
+        return Vector(DOF,0.0);
+    }
+
+    return gravityTorques(ddp0,mEnd,sEnd.data());
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+Vector iDynChain::gravityTorques(const Vector& ddp0, const double mEnd, const double *sEnd)
+{
+    Vector g(DOF,0.0);
+    if(ddp0.length()!=3)
+    {
+        if(verbose) yError("iDynChain error: computeGravityTorques() failed due to wrong size of ddp0: %d instead of 3 \n",(int)ddp0.length());
+        return g;
+    }
+
+    jointSpaceTransforms();
+
+    // ddp0 seen by each link, expressed in the previous frame
+    jsWork.resize(3*N);
+    double a[3];
+    baseToFrame0(ddp0.data(),a);
+    for(unsigned int i=0; i<N; i++)
+    {
+        double *A = &jsWork[3*i];
+        A[0]=a[0]; A[1]=a[1]; A[2]=a[2];
+        mulTransp3(&jsR[9*i],A,a);
+    }
+
+    // composite mass and first moment of links i..N-1 (plus the payload,
+    // moved from the end-effector to the last link frame): joint i only
+    // feels the moment of the composite weight around its axis
+    const double *HNd = HN.data();
+    double Mc = mEnd;
+    double h[3];
+    for(int k=0; k<3; k++)
+        h[k] = HNd[4*k]*sEnd[0] + HNd[4*k+1]*sEnd[1] + HNd[4*k+2]*sEnd[2] + mEnd*HNd[4*k+3];
+
+    int j = DOF-1;
+    for(int i=N-1; (i>=0) && (j>=0); i--)
+    {
+        const iDynLink *l = static_cast<const iDynLink*>(allList[i]);
+        const double *rp = &jsRp[3*i];
+        const double *rc = l->rc.data();
+
+        Mc += l->m;
+        double t[3];
+        for(int k=0; k<3; k++)
+            t[k] = h[k] + l->m*rc[k] + Mc*rp[k];
+        mul3(&jsR[9*i],t,h);
+
+        if(hash[j]==(unsigned int)i)
+        {
+            const double *A = &jsWork[3*i];
+            g[j--] = h[0]*A[1] - h[1]*A[0];
+        }
+    }
+
     return g;
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -1710,18 +1981,118 @@ Vector iDynChain::computeGravityTorques(const Vector& ddp0, const Vector& q)
     return computeGravityTorques(ddp0);
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-Vector iDynChain::computeCcGravityTorques(const Vector& ddp0)
+double iDynChain::computeFirstMomentOfMass(Vector &s)
 {
-    Vector ccg(DOF), zero3(3, 0.0);
-    setD2Ang(zeros(DOF));       // set to zero the joint acc
+    jointSpaceTransforms();
 
-    if(NE==NULL || NE->getMode()!=DYNAMIC)
-        prepareNewtonEuler(DYNAMIC);
-    initNewtonEuler(zero3, zero3, ddp0, zero3, zero3);  // init with zero w, dw, F, Mu
-    computeNewtonEuler();
-    for(unsigned int i=0; i<DOF; i++)
-        ccg(i) = quickList[hash_dof[i]]->getTorque();
-    return ccg;
+    // same backward sweep of the gravity torques, down to the 0th frame
+    double Mc = 0.0;
+    double h[3]={ 0.0, 0.0, 0.0 };
+    for(int i=N-1; i>=0; i--)
+    {
+        const iDynLink *l = static_cast<const iDynLink*>(allList[i]);
+        const double *rp = &jsRp[3*i];
+        const double *rc = l->rc.data();
+
+        Mc += l->m;
+        double t[3];
+        for(int k=0; k<3; k++)
+            t[k] = h[k] + l->m*rc[k] + Mc*rp[k];
+        mul3(&jsR[9*i],t,h);
+    }
+
+    // from the 0th frame to the base reference frame
+    const double *H = H0.data();
+    s.resize(3);
+    for(int k=0; k<3; k++)
+        s[k] = H[4*k]*h[0] + H[4*k+1]*h[1] + H[4*k+2]*h[2] + Mc*H[4*k+3];
+
+    return Mc;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+double iDynChain::computeFirstMomentOfMassJacobian(const Matrix &B, const double mEnd, const double *sEnd,
+                                                   double *s, Matrix &J, const unsigned int c0)
+{
+    s[0]=s[1]=s[2]=0.0;
+    if((B.rows()!=4) || (B.cols()!=4) || (J.rows()<6) || (J.cols()<(int)(c0+DOF)))
+    {
+        if(verbose) yError("iDynChain error: computeFirstMomentOfMassJacobian() failed due to wrong sizes \n");
+        return 0.0;
+    }
+
+    // forward sweep over the cached transforms of the chain, the same of getH(i,true):
+    // the axis and the origin of every joint and the COM of every link, in the frame of the results
+    updateIntH(N);
+    jsWork.resize(9*N);
+    double *Z = &jsWork[0];
+    double *P = &jsWork[6*N];
+
+    const double *b = B.data();
+    double TN[16];
+    for(unsigned int i=0; i<N; i++)
+    {
+        const double *F = fwd_intH[i].data();
+        double *z = &Z[6*i];
+        for(int k=0; k<3; k++)
+        {
+            z[k]   = b[4*k]*F[2] + b[4*k+1]*F[6] + b[4*k+2]*F[10];
+            z[3+k] = b[4*k]*F[3] + b[4*k+1]*F[7] + b[4*k+2]*F[11] + b[4*k+3];
+        }
+
+        F = fwd_intH[i+1].data();
+        if(i==N-1)
+        {
+            mul4(F,HN.data(),TN);
+            F = TN;
+        }
+
+        const double *rc = static_cast<const iDynLink*>(allList[i])->rc.data();
+        double pl[3];
+        for(int k=0; k<3; k++)
+            pl[k] = F[4*k]*rc[0] + F[4*k+1]*rc[1] + F[4*k+2]*rc[2] + F[4*k+3];
+
+        double *p = &P[3*i];
+        for(int k=0; k<3; k++)
+            p[k] = b[4*k]*pl[0] + b[4*k+1]*pl[1] + b[4*k+2]*pl[2] + b[4*k+3];
+    }
+
+    // backward sweep: every joint moves the links beyond it, and the payload
+    double M = 0.0;
+    double Mc = mEnd;
+    double h[3]={ sEnd[0], sEnd[1], sEnd[2] };
+    unsigned int j = DOF;
+    for(int i=N-1; i>=0; i--)
+    {
+        double m = static_cast<const iDynLink*>(allList[i])->m;
+        const double *p = &P[3*i];
+        M += m;
+        Mc += m;
+        for(int k=0; k<3; k++)
+        {
+            s[k] += m*p[k];
+            h[k] += m*p[k];
+        }
+
+        if(allList[i]->isBlocked())
+            continue;
+
+        const double *z = &Z[6*i];
+        double d[3]={ h[0]-Mc*z[3], h[1]-Mc*z[4], h[2]-Mc*z[5] };
+        unsigned int c = c0 + (--j);
+        J(0,c) = z[1]*d[2] - z[2]*d[1];
+        J(1,c) = z[2]*d[0] - z[0]*d[2];
+        J(2,c) = z[0]*d[1] - z[1]*d[0];
+        J(3,c) = Mc*z[0];
+        J(4,c) = Mc*z[1];
+        J(5,c) = Mc*z[2];
+    }
+
+    return M;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+Vector iDynChain::computeCcGravityTorques(const Vector& ddp0)
+{
+    return jointSpaceRNEA(ddp0,true);
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 Vector iDynChain::computeCcGravityTorques(const Vector& ddp0, const Vector& q, const Vector& dq)
@@ -1730,6 +2101,262 @@ Vector iDynChain::computeCcGravityTorques(const Vector& ddp0, const Vector& q, c
     setDAng(dq);
     return computeCcGravityTorques(ddp0);
 }
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+Vector iDynChain::getInertialParameters() const
+{
+    Vector pi(10*N);
+    for(unsigned int i=0; i<N; i++)
+    {
+        const iDynLink *l = static_cast<const iDynLink*>(allList[i]);
+        const double *rc = l->rc.data();
+        const Matrix &I = l->I;
+        double m = l->m;
+        double rc2 = rc[0]*rc[0]+rc[1]*rc[1]+rc[2]*rc[2];
+        double *p = &pi[10*i];
+
+        p[0] = m;
+        p[1] = m*rc[0]; p[2] = m*rc[1]; p[3] = m*rc[2];
+        // inertia with respect to the link origin (parallel axis theorem)
+        p[4] = I(0,0) + m*(rc2-rc[0]*rc[0]);
+        p[5] = I(0,1) - m*rc[0]*rc[1];
+        p[6] = I(0,2) - m*rc[0]*rc[2];
+        p[7] = I(1,1) + m*(rc2-rc[1]*rc[1]);
+        p[8] = I(1,2) - m*rc[1]*rc[2];
+        p[9] = I(2,2) + m*(rc2-rc[2]*rc[2]);
+    }
+    return pi;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool iDynChain::setInertialParameters(const Vector &pi)
+{
+    if(pi.length()!=10*N)
+    {
+        if(verbose) yError("iDynChain error: setInertialParameters() failed due to wrong size: %d instead of %d \n",(int)pi.length(),10*N);
+        return false;
+    }
+
+    for(unsigned int i=0; i<N; i++)
+    {
+        iDynLink *l = static_cast<iDynLink*>(allList[i]);
+        const double *p = &pi[10*i];
+        double m = p[0];
+
+        Vector rc = l->rc;
+        if(m!=0.0)
+        {
+            rc[0]=p[1]/m; rc[1]=p[2]/m; rc[2]=p[3]/m;
+        }
+        else
+            m = 0.0;
+        double rc2 = rc[0]*rc[0]+rc[1]*rc[1]+rc[2]*rc[2];
+
+        l->setMass(m);
+        l->setCOM(rc);
+        l->setInertia(p[4] - m*(rc2-rc[0]*rc[0]), p[5] + m*rc[0]*rc[1], p[6] + m*rc[0]*rc[2],
+                      p[7] - m*(rc2-rc[1]*rc[1]), p[8] + m*rc[1]*rc[2], p[9] - m*(rc2-rc[2]*rc[2]));
+    }
+    return true;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynChain::computeRegressor(const double *q, const double *dq, const double *ddq, const double *ddp0,
+                                 double *Y, const size_t stride, std::vector<double> &work) const
+{
+    const size_t P = 10*N;
+    work.resize(21*N+60);
+    double *Rs = &work[0];
+    double *Rps = &work[9*N];
+    double *Ws = &work[12*N];
+    double *Dws = &work[15*N];
+    double *As = &work[18*N];
+    double *Wr = &work[21*N];       // 10 wrenches (f,n) of the unit parameters
+
+    for(unsigned int r=0; r<DOF; r++)
+        std::fill(Y+r*stride,Y+r*stride+P,0.0);
+
+    //forward kinematics on the given state: blocked links are still
+    double w[3]={ 0.0, 0.0, 0.0 };
+    double dw[3]={ 0.0, 0.0, 0.0 };
+    double ddp[3];
+    baseToFrame0(ddp0,ddp);
+    unsigned int j = 0;
+    for(unsigned int i=0; i<N; i++)
+    {
+        const iKinLink *l = allList[i];
+        double qi = l->getAng(), dqi = 0.0, ddqi = 0.0;
+        if((j<DOF) && (hash[j]==i))
+        {
+            qi = q[j]; dqi = dq[j]; ddqi = ddq[j];
+            j++;
+        }
+
+        double *R = &Rs[9*i];
+        double *rp = &Rps[3*i];
+        linkTransform(l,qi,R,rp);
+
+        double v[3]={ w[0], w[1], w[2]+dqi };
+        double a[3]={ dw[0]+dqi*w[1], dw[1]-dqi*w[0], dw[2]+ddqi };
+        double t[3];
+        mulTransp3(R,v,w);
+        mulTransp3(R,a,dw);
+        mulTransp3(R,ddp,t);
+        addCentripetal3(w,dw,rp,t);
+        ddp[0]=t[0]; ddp[1]=t[1]; ddp[2]=t[2];
+
+        for(int k=0; k<3; k++)
+        {
+            Ws[3*i+k] = w[k];
+            Dws[3*i+k] = dw[k];
+            As[3*i+k] = ddp[k];
+        }
+    }
+
+    // order of the inertia parameters: xx, xy, xz, yy, yz, zz
+    static const int Irow[6]={ 0, 0, 0, 1, 1, 2 };
+    static const int Icol[6]={ 0, 1, 2, 1, 2, 2 };
+
+    //the wrench of each link is linear in its parameters: carry each column back
+    int jd = DOF-1;
+    for(int i=N-1; (i>=0) && (jd>=0); i--)
+    {
+        while((jd>=0) && (hash[jd]>(unsigned int)i))
+            jd--;
+        if(jd<0)
+            break;
+
+        const double *wi = &Ws[3*i];
+        const double *dwi = &Dws[3*i];
+        const double *ai = &As[3*i];
+        std::fill(Wr,Wr+60,0.0);
+
+        // mass: f=a
+        Wr[0]=ai[0]; Wr[1]=ai[1]; Wr[2]=ai[2];
+
+        // first moments: f=dw x e+w x (w x e), n=e x a
+        for(int k=0; k<3; k++)
+        {
+            double e[3]={ 0.0, 0.0, 0.0 };
+            e[k] = 1.0;
+            double *c = &Wr[6*(1+k)];
+            addCentripetal3(wi,dwi,e,c);
+            addCross3(e,ai,c+3);
+        }
+
+        // inertia: n=I*dw+w x (I*w)
+        for(int k=0; k<6; k++)
+        {
+            int r = Irow[k], s = Icol[k];
+            double Iw[3]={ 0.0, 0.0, 0.0 };
+            double *n = &Wr[6*(4+k)+3];
+            n[r] += dwi[s]; Iw[r] += wi[s];
+            if(r!=s)
+            {
+                n[s] += dwi[r]; Iw[s] += wi[r];
+            }
+            addCross3(wi,Iw,n);
+        }
+
+        int a = jd;
+        for(int k=i; (k>=0) && (a>=0); k--)
+        {
+            const double *R = &Rs[9*k];
+            double p[3];
+            mul3(R,&Rps[3*k],p);
+
+            bool isJoint = (hash[a]==(unsigned int)k);
+            double *y = Y+a*stride+10*i;
+            for(int c=0; c<10; c++)
+            {
+                double *f = &Wr[6*c];
+                double *n = f+3;
+                double ft[3], nt[3];
+                mul3(R,f,ft);
+                mul3(R,n,nt);
+                addCross3(p,ft,nt);
+                f[0]=ft[0]; f[1]=ft[1]; f[2]=ft[2];
+                n[0]=nt[0]; n[1]=nt[1]; n[2]=nt[2];
+                if(isJoint)
+                    y[c] = nt[2];
+            }
+
+            if(isJoint)
+                a--;
+        }
+    }
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool iDynChain::computeRegressor(const Vector &q, const Vector &dq, const Vector &ddq,
+                                 const Vector &ddp0, Matrix &Y) const
+{
+    if((q.length()!=DOF) || (dq.length()!=DOF) || (ddq.length()!=DOF) || (ddp0.length()!=3))
+    {
+        if(verbose) yError("iDynChain error: computeRegressor() failed due to wrong sized vectors: q,dq,ddq,ddp0 have size %d,%d,%d,%d instead of %d,%d,%d,3 \n",
+                           (int)q.length(),(int)dq.length(),(int)ddq.length(),(int)ddp0.length(),DOF,DOF,DOF);
+        return false;
+    }
+
+    Y.resize(DOF,10*N);
+    if(DOF>0)
+    {
+        std::vector<double> work;
+        computeRegressor(q.data(),dq.data(),ddq.data(),ddp0.data(),Y.data(),10*N,work);
+    }
+    return true;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+Matrix iDynChain::computeRegressor(const Vector &ddp0) const
+{
+    Vector q(DOF), dq(DOF), ddq(DOF);
+    for(unsigned int j=0; j<DOF; j++)
+    {
+        const iDynLink *l = static_cast<const iDynLink*>(allList[hash[j]]);
+        q[j] = l->getAng();
+        dq[j] = l->dq;
+        ddq[j] = l->ddq;
+    }
+
+    Matrix Y;
+    computeRegressor(q,dq,ddq,ddp0,Y);
+    return Y;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool iDynChain::computeRegressorBatch(const Matrix &Q, const Matrix &dQ, const Matrix &ddQ,
+                                      const Vector &ddp0, Matrix &Y, unsigned int nThreads) const
+{
+    const int M = Q.rows();
+    if((Q.cols()!=(int)DOF) || (dQ.cols()!=(int)DOF) || (ddQ.cols()!=(int)DOF) ||
+       (dQ.rows()!=M) || (ddQ.rows()!=M) || (ddp0.length()!=3) || (DOF==0))
+    {
+        if(verbose) yError("iDynChain error: computeRegressorBatch() failed due to wrong sized inputs: Q,dQ,ddQ must be %d-by-%d and ddp0 3-dim \n",M,DOF);
+        return false;
+    }
+
+    const size_t P = 10*N;
+    Y.resize(M*DOF,P);
+
+    auto processChunk=[&](const int r0, const int r1)
+    {
+        std::vector<double> work;
+        for(int k=r0; k<r1; k++)
+            computeRegressor(Q[k],dQ[k],ddQ[k],ddp0.data(),Y[k*DOF],P,work);
+    };
+
+    nThreads = std::max(1U,std::min(nThreads,(unsigned int)M));
+    if(nThreads==1)
+        processChunk(0,M);
+    else
+    {
+        const int samplesPerThread = (M+nThreads-1)/nThreads;
+
+        std::vector<std::thread> workers;
+        for(int r0=0; r0<M; r0+=samplesPerThread)
+            workers.push_back(std::thread(processChunk,r0,std::min(M,r0+samplesPerThread)));
+
+        for(auto &w : workers)
+            w.join();
+    }
+
+    return true;
+}
 
 
 //================================
@@ -34,6 +34,93 @@ using namespace iCub::iDyn;
 using namespace iCub::skinDynLib;
 
 // #define DEBUG_FOOT_COM
+//====================================
+//
+//      WORKER POOL
+//
+//====================================
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+iDynWorkerPool::iDynWorkerPool(unsigned int nThreads)
+{
+    closing = false;
+    for(unsigned int i=1; i<nThreads; i++)
+        workers.push_back(thread(&iDynWorkerPool::loop,this));
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+iDynWorkerPool::~iDynWorkerPool()
+{
+    {
+        lock_guard<mutex> lck(mtx);
+        closing = true;
+    }
+    cv.notify_all();
+    for(size_t i=0; i<workers.size(); i++)
+        workers[i].join();
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+unsigned int iDynWorkerPool::getNumThreads() const
+{
+    return (unsigned int)workers.size()+1;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynWorkerPool::loop()
+{
+    unique_lock<mutex> lck(mtx);
+    while(true)
+    {
+        cv.wait(lck,[this](){ return closing || !jobs.empty(); });
+        if(jobs.empty())
+            return;
+
+        function<void()> job = jobs.front();
+        jobs.pop_front();
+        lck.unlock();
+        job();
+        lck.lock();
+    }
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynWorkerPool::run(const deque<function<void()> > &batch)
+{
+    if(workers.empty() || (batch.size()<2))
+    {
+        for(size_t i=0; i<batch.size(); i++)
+            batch[i]();
+        return;
+    }
+
+    size_t pending = batch.size();
+    unique_lock<mutex> lck(mtx);
+    for(size_t i=0; i<batch.size(); i++)
+    {
+        const function<void()> *job = &batch[i];
+        jobs.push_back([this,job,&pending]()
+        {
+            (*job)();
+            lock_guard<mutex> l(mtx);
+            if(--pending==0)
+                cv.notify_all();
+        });
+    }
+    cv.notify_all();
+
+    // the caller helps while waiting: this way nested batches cannot starve
+    while(pending>0)
+    {
+        if(!jobs.empty())
+        {
+            function<void()> job = jobs.front();
+            jobs.pop_front();
+            lck.unlock();
+            job();
+            lck.lock();
+        }
+        else
+            cv.wait(lck);
+    }
+}
+
 //====================================
 //
 //      RIGID BODY TRANSFORMATION
@@ -418,6 +505,7 @@ iDynNode::iDynNode(const NewEulMode _mode)
     rbtList.clear();
     mode = _mode;
     verbose = iCub::skinDynLib::VERBOSE;
+    pool = NULL;
     zero();
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -427,6 +515,7 @@ iDynNode::iDynNode(const string &_info, const NewEulMode _mode, unsigned int ver
     rbtList.clear();
     mode = _mode;
     verbose = verb;
+    pool = NULL;
     zero();
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -446,6 +535,27 @@ void iDynNode::addLimb(iDynLimb *limb, const Matrix &H, const FlowType kinFlow,
     rbtList.push_back(rbt);
 }    
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynNode::setWorkerPool(iDynWorkerPool *_pool)
+{
+    pool = _pool;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+iDynWorkerPool *iDynNode::getWorkerPool() const
+{
+    return pool;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynNode::runLimbJobs(const deque<function<void()> > &batch)
+{
+    if(pool!=NULL)
+        pool->run(batch);
+    else
+    {
+        for(size_t i=0; i<batch.size(); i++)
+            batch[i]();
+    }
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 Matrix iDynNode::getRBT(unsigned int iLimb) const
 {
     if(iLimb<rbtList.size())
@@ -483,16 +593,23 @@ bool iDynNode::solveKinematics()
     if(inputNode==1)
     {
         //now forward the kinematic input from limbs whose kinematic flow is input type
+        //they only read the node kinematics, hence they can be solved concurrently
+        deque<function<void()> > batch;
         for(unsigned int i=0; i<rbtList.size(); i++)
         {
             if(rbtList[i].getKinematicFlow()==RBT_NODE_OUT)
             {
-                //init the kinematics with the node information
-                rbtList[i].setKinematic(w,dw,ddp);
-                //solve kinematics in that limb/chain
-                rbtList[i].computeLimbKinematic();
+                RigidBodyTransformation *rbt = &rbtList[i];
+                batch.push_back([this,rbt]()
+                {
+                    //init the kinematics with the node information
+                    rbt->setKinematic(w,dw,ddp);
+                    //solve kinematics in that limb/chain
+                    rbt->computeLimbKinematic();
+                });
             }
         }
+        runLimbJobs(batch);
         return true;
     
     }
@@ -532,16 +649,23 @@ bool iDynNode::solveKinematics(const Vector &w0, const Vector &dw0, const Vector
     if(inputNode==1)
     {
         //now forward the kinematic input from limbs whose kinematic flow is input type
+        //they only read the node kinematics, hence they can be solved concurrently
+        deque<function<void()> > batch;
         for(unsigned int i=0; i<rbtList.size(); i++)
         {
             if(rbtList[i].getKinematicFlow()==RBT_NODE_OUT)
             {
-                //init the kinematics with the node information
-                rbtList[i].setKinematic(w,dw,ddp);
-                //solve kinematics in that limb/chain
-                rbtList[i].computeLimbKinematic();
+                RigidBodyTransformation *rbt = &rbtList[i];
+                batch.push_back([this,rbt]()
+                {
+                    //init the kinematics with the node information
+                    rbt->setKinematic(w,dw,ddp);
+                    //solve kinematics in that limb/chain
+                    rbt->computeLimbKinematic();
+                });
             }
         }
+        runLimbJobs(batch);
         return true;
     
     }
@@ -595,12 +719,24 @@ bool iDynNode::solveWrench()
     //first get the forces/moments from each limb
     //assuming that each limb has been properly set with the outcoming measured
     //forces/moments which are necessary for the wrench computation
+    //the limbs are solved concurrently, whereas the node summation
+    //is performed afterwards in the limbs order
+    deque<function<void()> > batch;
     for(unsigned int i=0; i<rbtList.size(); i++)
     {
         if(rbtList[i].getWrenchFlow()==RBT_NODE_IN)         
         {
             //compute the wrench pass in that limb
-            rbtList[i].computeLimbWrench();
+            RigidBodyTransformation *rbt = &rbtList[i];
+            batch.push_back([rbt](){ rbt->computeLimbWrench(); });
+        }
+    }
+    runLimbJobs(batch);
+
+    for(unsigned int i=0; i<rbtList.size(); i++)
+    {
+        if(rbtList[i].getWrenchFlow()==RBT_NODE_IN)         
+        {
             //update the node force/moment with the wrench coming from the limb base/end
             // note that getWrench sum the result to F,Mu - because they are passed by reference
             // F = F + F[i], Mu = Mu + Mu[i]
@@ -628,16 +764,22 @@ bool iDynNode::solveWrench()
     }
 
     //now forward the wrench output from the node to limbs whose wrench flow is output type
+    batch.clear();
     for(unsigned int i=0; i<rbtList.size(); i++)
     {
         if(rbtList[i].getWrenchFlow()==RBT_NODE_OUT)
         {
-            //init the wrench with the node information
-            rbtList[i].setWrench(F,Mu);
-            //solve wrench in that limb/chain
-            rbtList[i].computeLimbWrench();
+            RigidBodyTransformation *rbt = &rbtList[i];
+            batch.push_back([this,rbt]()
+            {
+                //init the wrench with the node information
+                rbt->setWrench(F,Mu);
+                //solve wrench in that limb/chain
+                rbt->computeLimbWrench();
+            });
         }
     }
+    runLimbJobs(batch);
     return true;
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -1358,6 +1500,9 @@ bool iDynSensorNode::solveWrench()
     //first get the forces/moments from each limb
     //assuming that each limb has been properly set with the outcoming measured
     //forces/moments which are necessary for the wrench computation
+    //the limbs are solved concurrently, whereas the node summation
+    //is performed afterwards in the limbs order
+    deque<function<void()> > batch;
     for(unsigned int i=0; i<rbtList.size(); i++)
     {
         if(rbtList[i].getWrenchFlow()==RBT_NODE_IN)         
@@ -1365,11 +1510,23 @@ bool iDynSensorNode::solveWrench()
             //compute the wrench pass in that limb
             // if there's a sensor, we must use iDynSensor
             // otherwise we use the limb method as usual
-            if(rbtList[i].isSensorized()==true)
-                sensorList[i]->computeWrenchFromSensorNewtonEuler();
-            else
-                rbtList[i].computeLimbWrench();
+            RigidBodyTransformation *rbt = &rbtList[i];
+            iDynSensor *sensor = rbt->isSensorized() ? sensorList[i] : NULL;
+            batch.push_back([rbt,sensor]()
+            {
+                if(sensor!=NULL)
+                    sensor->computeWrenchFromSensorNewtonEuler();
+                else
+                    rbt->computeLimbWrench();
+            });
+        }
+    }
+    runLimbJobs(batch);
 
+    for(unsigned int i=0; i<rbtList.size(); i++)
+    {
+        if(rbtList[i].getWrenchFlow()==RBT_NODE_IN)         
+        {
             //update the node force/moment with the wrench coming from the limb base/end
             // note that getWrench sum the result to F,Mu - because they are passed by reference
             // F = F + F[i], Mu = Mu + Mu[i]
@@ -1397,16 +1554,22 @@ bool iDynSensorNode::solveWrench()
 
     //now forward the wrench output from the node to limbs whose wrench flow is output type
     // assuming they don't have a FT sensor
+    batch.clear();
     for(unsigned int i=0; i<rbtList.size(); i++)
     {
         if(rbtList[i].getWrenchFlow()==RBT_NODE_OUT)
         {
-            //init the wrench with the node information
-            rbtList[i].setWrench(F,Mu);
-            //solve wrench in that limb/chain
-            rbtList[i].computeLimbWrench();
+            RigidBodyTransformation *rbt = &rbtList[i];
+            batch.push_back([this,rbt]()
+            {
+                //init the wrench with the node information
+                rbt->setWrench(F,Mu);
+                //solve wrench in that limb/chain
+                rbt->computeLimbWrench();
+            });
         }
     }
+    runLimbJobs(batch);
     return true;
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -2409,6 +2572,9 @@ iCubWholeBody::iCubWholeBody(version_tag _tag, const NewEulMode mode, unsigned i
     H.eye();
     //H  is no used currently since the transformation is an identity
     rbt = new RigidBodyTransformation(lowerTorso->up,H,"connection between lower and upper torso",false,RBT_NODE_OUT,RBT_NODE_OUT,mode,verbose);
+
+    //sequential by default
+    pool = NULL;
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 iCubWholeBody::~iCubWholeBody()
@@ -2416,21 +2582,24 @@ iCubWholeBody::~iCubWholeBody()
     if (upperTorso) delete upperTorso; upperTorso = NULL;
     if (lowerTorso) delete lowerTorso; lowerTorso = NULL;
     if (rbt)        delete rbt;        rbt        = NULL;
+    if (pool)       delete pool;       pool       = NULL;
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void iCubWholeBody::attachLowerTorso(const Vector &FM_right_leg, const Vector &FM_left_leg)
+{
+    attachLowerTorsoKinematics();
+    attachLowerTorsoWrench(FM_right_leg,FM_left_leg);
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iCubWholeBody::attachLowerTorsoKinematics()
 {
     Vector in_w   = upperTorso->getTorsoAngVel();
     Vector in_dw  = upperTorso->getTorsoAngAcc();
     Vector in_ddp = upperTorso->getTorsoLinAcc();
-    Vector in_F   = upperTorso->getTorsoForce();
-    Vector in_M   = upperTorso->getTorsoMoment();
 
     Vector out_w;   out_w.resize(3);
     Vector out_dw;  out_dw.resize(3);
     Vector out_ddp; out_ddp.resize(3);
-    Vector out_F;   out_F.resize(3);
-    Vector out_M;   out_M.resize(3);
     
     //kinematics: 
     out_w[0]= in_w[0];
@@ -2445,28 +2614,74 @@ void iCubWholeBody::attachLowerTorso(const Vector &FM_right_leg, const Vector &F
     out_ddp[1]= in_ddp[1];
     out_ddp[2]= in_ddp[2];
 
-    //wrenches:
-    out_F[0]= in_F[0];
-    out_F[1]= in_F[1];
-    out_F[2]= in_F[2];
-
-    out_M[0]= in_M[0];
-    out_M[1]= in_M[1];
-    out_M[2]= in_M[2];
+    lowerTorso->setKinematicMeasure(out_w,out_dw,out_ddp);
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iCubWholeBody::attachLowerTorsoWrench(const Vector &FM_right_leg, const Vector &FM_left_leg)
+{
+    Vector in_F   = upperTorso->getTorsoForce();
+    Vector in_M   = upperTorso->getTorsoMoment();
 
     Vector FUP ;
-    Vector FLL ;
-    Vector FRL ;
     FUP.resize(6);
-    FUP[0] = out_F[0];
-    FUP[1] = out_F[1];
-    FUP[2] = out_F[2];
-    FUP[3] = out_M[0];
-    FUP[4] = out_M[1];
-    FUP[5] = out_M[2];
-    lowerTorso->setKinematicMeasure(out_w,out_dw,out_ddp);
+    //wrenches:
+    FUP[0] = in_F[0];
+    FUP[1] = in_F[1];
+    FUP[2] = in_F[2];
+    FUP[3] = in_M[0];
+    FUP[4] = in_M[1];
+    FUP[5] = in_M[2];
     lowerTorso->setSensorMeasurement(FM_right_leg,FM_left_leg,FUP);
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iCubWholeBody::setNumThreads(unsigned int nThreads)
+{
+    upperTorso->setWorkerPool(NULL);
+    lowerTorso->setWorkerPool(NULL);
+    if (pool) delete pool; pool = NULL;
+
+    if (nThreads>1)
+    {
+        pool = new iDynWorkerPool(nThreads);
+        upperTorso->setWorkerPool(pool);
+        lowerTorso->setWorkerPool(pool);
+    }
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+unsigned int iCubWholeBody::getNumThreads() const
+{
+    return (pool!=NULL) ? pool->getNumThreads() : 1;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool iCubWholeBody::solve(const Vector &FM_right_leg, const Vector &FM_left_leg)
+{
+    if (!upperTorso->solveKinematics())
+        return false;
+    return solveAfterUpperKinematics(FM_right_leg,FM_left_leg);
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool iCubWholeBody::solveAfterUpperKinematics(const Vector &FM_right_leg, const Vector &FM_left_leg)
+{
+    // the lower torso kinematics only needs the upper torso kinematics, 
+    // thus it can overlap the upper torso wrench phase
+    attachLowerTorsoKinematics();
+
+    bool upOk = false;
+    bool lowOk = false;
+    deque<function<void()> > batch;
+    batch.push_back([this,&upOk](){ upOk = upperTorso->solveWrench(); });
+    batch.push_back([this,&lowOk](){ lowOk = lowerTorso->solveKinematics(); });
+    if (pool)
+        pool->run(batch);
+    else
+    {
+        batch[0]();
+        batch[1]();
+    }
 
+    // the lower torso wrench phase needs the torso wrench
+    attachLowerTorsoWrench(FM_right_leg,FM_left_leg);
+    return (lowerTorso->solveWrench() && upOk && lowOk);
 }
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -2603,6 +2818,74 @@ bool iCubWholeBody::getCOM(BodyPart which_part, Vector &COM, double & mass)
     return true;
 }
 
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool iCubWholeBody::computeCOMJacobian()
+{
+    // the limbs in the order of getAllVelocities()
+    iDynLimb *limbs[6] = { lowerTorso->left, lowerTorso->right, lowerTorso->up,
+                           upperTorso->left, upperTorso->right, upperTorso->up };
+    const Matrix *origs[6] = { &lowerTorso->HLeft, &lowerTorso->HRight, &lowerTorso->HUp,
+                               &upperTorso->HLeft, &upperTorso->HRight, &upperTorso->HUp };
+    unsigned int cols[6];
+    unsigned int nCols = 0;
+    for (int k=0; k<6; k++)
+    {
+        cols[k] = nCols;
+        nCols += limbs[k]->getDOF();
+    }
+
+    if ((whole_COM_Jacob.rows()!=6) || (whole_COM_Jacob.cols()!=(int)nCols))
+        whole_COM_Jacob.resize(6,nCols);
+
+    const double zero3[3] = { 0.0, 0.0, 0.0 };
+    double s[3];
+
+    // the upper body seen from the root, through the end of the torso
+    Matrix T0T1 = lowerTorso->HUp * lowerTorso->up->getH(lowerTorso->up->getN()-1,true);
+    double mUp = 0.0;
+    double sUp[3] = { 0.0, 0.0, 0.0 };
+    for (int k=3; k<6; k++)
+    {
+        mUp += limbs[k]->computeFirstMomentOfMassJacobian(T0T1*(*origs[k]),0.0,zero3,s,whole_COM_Jacob,cols[k]);
+        for (int r=0; r<3; r++)
+            sUp[r] += s[r];
+    }
+
+    // the torso carries the upper body, the legs nothing
+    double m = mUp;
+    double sAll[3] = { sUp[0], sUp[1], sUp[2] };
+    for (int k=0; k<3; k++)
+    {
+        m += limbs[k]->computeFirstMomentOfMassJacobian(*origs[k],(k==2)?mUp:0.0,(k==2)?sUp:zero3,
+                                                        s,whole_COM_Jacob,cols[k]);
+        for (int r=0; r<3; r++)
+            sAll[r] += s[r];
+    }
+
+    if (fabs(m) < 0.00001)
+    {
+        whole_mass = 0.0;
+        whole_COM.resize(3,0.0);
+        whole_COM_Jacob.zero();
+        return false;
+    }
+
+    whole_mass = m;
+    whole_COM.resize(3);
+    for (int r=0; r<3; r++)
+        whole_COM[r] = sAll[r]/m;
+    whole_COM_Jacob /= m;
+
+    return true;
+}
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool iCubWholeBody::getCOMJacobian(Matrix &jac) const
+{
+    jac = whole_COM_Jacob;
+    return (jac.rows()==6);
+}
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 bool iCubWholeBody::getAllPositions(Vector &pos)
 {
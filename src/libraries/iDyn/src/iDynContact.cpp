@@ -37,11 +37,11 @@ using namespace iCub::skinDynLib;
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 iDynContactSolver::iDynContactSolver(iDynChain *_c, const string &_info, const NewEulMode _mode, BodyPart _bodyPart, unsigned int verb)
-:iDynSensor(_c, _info, _mode, verb), bodyPart(_bodyPart){}
+:iDynSensor(_c, _info, _mode, verb), bodyPart(_bodyPart), cacheRefLink(-1), Gsum(zeros(6,6)), pinvG(zeros(6,6)){}
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 iDynContactSolver::iDynContactSolver(iDynChain *_c, unsigned int sensLink, SensorLinkNewtonEuler *sensor, 
                                     const string &_info, const NewEulMode _mode, BodyPart _bodyPart, unsigned int verb)
-:iDynSensor(_c, _info, _mode, verb), bodyPart(_bodyPart)
+:iDynSensor(_c, _info, _mode, verb), bodyPart(_bodyPart), cacheRefLink(-1), Gsum(zeros(6,6)), pinvG(zeros(6,6))
 {
     lSens = sensLink;
     sens = sensor;
@@ -49,7 +49,7 @@ iDynContactSolver::iDynContactSolver(iDynChain *_c, unsigned int sensLink, Senso
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 iDynContactSolver::iDynContactSolver(iDynChain *_c, unsigned int sensLink, const Matrix &_H, const Matrix &_HC, double _m, 
                                      const Matrix &_I, const string &_info, const NewEulMode _mode, BodyPart _bodyPart, unsigned int verb)
-:iDynSensor(_c, sensLink, _H, _HC, _m, _I, _info, _mode, verb), bodyPart(_bodyPart){}
+:iDynSensor(_c, sensLink, _H, _HC, _m, _I, _info, _mode, verb), bodyPart(_bodyPart), cacheRefLink(-1), Gsum(zeros(6,6)), pinvG(zeros(6,6)){}
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 iDynContactSolver::~iDynContactSolver(){}
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -138,29 +138,27 @@ const dynContactList& iDynContactSolver::computeExternalContacts()
 
     // BUILD AND SOLVE THE LINEAR SYSTEM AX=B RELATIVE TO THE CONTACT SUB-CHAIN
     // the reference frame is the <firstContactLink-1> 
-    Matrix A = buildA(firstContactLink, lastContactLink);
+    // the least-squares solution is X = pinv(A)*B = A^T*pinv(A*A^T)*B
+    computeSubChainPoses(firstContactLink, lastContactLink);
+    updateBlocks(firstContactLink);
     Vector B = buildB(firstContactLink, lastContactLink);
-    Matrix pinv_A = pinv(A, TOLLERANCE);
-    Vector X = pinv_A * B;
+    Vector y = pinvG * B;
     
     // SET THE COMPUTED VALUES IN THE CONTACT LIST
-    unsigned int unknownInd = 0;
-    Matrix H, R;
-    for(dynContactList::iterator it = contactList.begin(); it!=contactList.end(); it++)
+    Matrix R;
+    Vector X;
+    for(unsigned int k=0; k<contactList.size(); k++)
     {
-        if(it->isForceDirectionKnown())
-            it->setForceModule( X(unknownInd++));
+        dynContact &c = contactList[k];
+        X = blocks[k].A.transposed() * y;
+        if(c.isForceDirectionKnown())
+            c.setForceModule(X(0));
         else
         {
-            H = getHFromAtoB(it->getLinkNumber(), firstContactLink-1);
-            R = H.submatrix(0,2,0,2);
-            it->setForce( R * X.subVector(unknownInd, unknownInd+2));
-            unknownInd += 3;
-            if(!it->isMomentKnown())
-            {
-                it->setMoment(R * X.subVector(unknownInd, unknownInd+2));
-                unknownInd += 3;
-            }
+            R = blocks[k].H.submatrix(0,2,0,2).transposed();
+            c.setForce(R * X.subVector(0,2));
+            if(!c.isMomentKnown())
+                c.setMoment(R * X.subVector(3,5));
         }
     }
 
@@ -185,6 +183,127 @@ void iDynContactSolver::computeWrenchFromSensorNewtonEuler()
     chain->NE->computeTorques();
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynContactSolver::computeSubChainPoses(unsigned int firstContactLink, unsigned int lastContactLink)
+{
+    // Hsub[i] is the rototranslation from <firstContactLink-1> to <i>, computed in a single pass
+    Hsub.resize(chain->getN());
+    Hsub[firstContactLink-1] = eye(4,4);
+    for(unsigned int i=firstContactLink; i<=lastContactLink; i++)
+        Hsub[i] = Hsub[i-1] * chain->refLink(i)->getH();
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool iDynContactSolver::isBlockValid(const ContactBlock &b, const dynContact &c) const
+{
+    if(b.linkNumber!=c.getLinkNumber() || b.momentKnown!=c.isMomentKnown() ||
+       b.forceDirectionKnown!=c.isForceDirectionKnown())
+        return false;
+
+    if(b.forceDirectionKnown && !(b.forceDirection==c.getForceDirection()))
+        return false;
+
+    return (b.CoP==c.getCoP()) && (b.H==Hsub[b.linkNumber]);
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynContactSolver::buildBlock(ContactBlock &b, const dynContact &c) const
+{
+    b.id = c.getId();
+    b.linkNumber = c.getLinkNumber();
+    b.momentKnown = c.isMomentKnown();
+    b.forceDirectionKnown = c.isForceDirectionKnown();
+    b.CoP = c.getCoP();
+    b.forceDirection = c.getForceDirection();
+    b.H = Hsub[b.linkNumber];
+
+    // the columns of A related to this contact (see buildA)
+    Matrix R = b.H.submatrix(0,2,0,2);
+    Vector p = R*b.CoP;
+    p += b.H.subcol(0,3,3);
+
+    if(b.forceDirectionKnown)
+    {
+        Vector u = R*b.forceDirection;
+        b.A.resize(6,1);
+        b.A.setSubcol(u, 0, 0);
+        b.A.setSubcol(cross(p, u), 3, 0);
+    }
+    else
+    {
+        b.A.resize(6, b.momentKnown ? 3 : 6);
+        b.A.zero();
+        b.A.setSubmatrix(eye(3,3), 0, 0);
+        b.A.setSubmatrix(crossProductMatrix(p), 3, 0);
+        if(!b.momentKnown)
+            b.A.setSubmatrix(eye(3,3), 3, 3);
+    }
+
+    b.G = b.A * b.A.transposed();
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynContactSolver::updateBlocks(unsigned int firstContactLink)
+{
+    // the blocks are expressed w.r.t. <firstContactLink-1>, so they are all invalid if it changes
+    if(cacheRefLink!=(int)firstContactLink-1)
+    {
+        blocks.clear();
+        cacheRefLink = firstContactLink-1;
+    }
+
+    // match the contacts with the cached blocks through their id:
+    // a block is reused only once and only if the contact has not changed
+    vector<ContactBlock> newBlocks(contactList.size());
+    vector<bool> used(blocks.size(), false);
+    Matrix dG = zeros(6,6);
+    unsigned int reused = 0;
+    bool changed = false;
+
+    for(unsigned int k=0; k<contactList.size(); k++)
+    {
+        const dynContact &c = contactList[k];
+        unsigned int j = 0;
+        for(; j<blocks.size(); j++)
+            if(!used[j] && blocks[j].id==c.getId() && isBlockValid(blocks[j], c))
+                break;
+
+        if(j<blocks.size())
+        {
+            used[j] = true;
+            newBlocks[k] = blocks[j];
+            reused++;
+        }
+        else
+        {
+            buildBlock(newBlocks[k], c);
+            dG += newBlocks[k].G;
+            changed = true;
+        }
+    }
+
+    if(reused==0)
+    {
+        // nothing to reuse (e.g. the chain moved): rebuild the Gram matrix from scratch,
+        // which also discards the round-off accumulated by the incremental updates
+        Gsum = dG;
+    }
+    else
+    {
+        // downdate the contributions of the contacts that disappeared or changed
+        for(unsigned int j=0; j<blocks.size(); j++)
+        {
+            if(!used[j])
+            {
+                dG -= blocks[j].G;
+                changed = true;
+            }
+        }
+        Gsum += dG;
+    }
+    blocks.swap(newBlocks);
+
+    // the singular values of A*A^T are the squares of those of A
+    if(changed)
+        pinvG = pinv(Gsum, TOLLERANCE*TOLLERANCE);
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 Matrix iDynContactSolver::buildA(unsigned int firstContactLink, unsigned int lastContactLink)
 {
     unsigned int unknownNum = getUnknownNumber();
@@ -196,7 +315,7 @@ Matrix iDynContactSolver::buildA(unsigned int firstContactLink, unsigned int las
     //    * force module: add 1 column composed by the force direction unit vector above and the cross product between 
     //          the contact point and the force direction unit vector below    
     unsigned int colInd = 0;
-    Matrix H, R;
+    Matrix R;
     Matrix eye3x3 = eye(3,3);
     Matrix zero3x3 = zeros(3,3);
     Vector r, temp1, temp2;
@@ -204,8 +323,8 @@ Matrix iDynContactSolver::buildA(unsigned int firstContactLink, unsigned int las
 
     for(; it!=contactList.end(); it++)
     {
-        // compute the rototranslation matrix from <firstContactLink-1> to the current link
-        H = getHFromAtoB(firstContactLink-1, it->getLinkNumber());
+        // the rototranslation matrix from <firstContactLink-1> to the current link
+        const Matrix &H = Hsub[it->getLinkNumber()];
         R = H.submatrix(0,2,0,2);
         r = H.subcol(0,3,3);
 
@@ -244,7 +363,7 @@ Vector iDynContactSolver::buildB(unsigned int firstContactLink, unsigned int las
     // Initialize the force part of the B vector (first 3 components) as:
     //    * minus the force applied on the first link
     //    * plus the force exchanged by the last link on the next one
-    Matrix Hlast = getHFromAtoB(firstContactLink-1, lastContactLink);
+    const Matrix &Hlast = Hsub[lastContactLink];
     Matrix Rlast = Hlast.submatrix(0,2,0,2);
     Vector rLast = Hlast.subcol(0,3,3);
     //Vector rLast = Hlast.submatrix(0,2,3,3).getCol(0);
@@ -254,8 +373,7 @@ Vector iDynContactSolver::buildB(unsigned int firstContactLink, unsigned int las
     // For each link add the mass multiplied by the linear accelleration of the COM
     for(unsigned int i=firstContactLink; i<=lastContactLink; i++)
     {
-        H = getHFromAtoB(firstContactLink-1, i);
-        R = H.submatrix(0,2,0,2);
+        R = Hsub[i].submatrix(0,2,0,2);
         Bforce += chain->getMass(i) * R * chain->getLinAccCOM(i);
     }
 
@@ -277,8 +395,7 @@ Vector iDynContactSolver::buildB(unsigned int firstContactLink, unsigned int las
     {
         link = chain->refLink(i);
 
-        H = getHFromAtoB(firstContactLink-1, i);
-        H *= link->getCOM();
+        H = Hsub[i] * link->getCOM();
         R = H.submatrix(0,2,0,2);
         r = H.subcol(0,3,3);        // vector from <firstContactLink-1> to COM of i
         
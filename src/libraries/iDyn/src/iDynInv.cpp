@@ -1669,6 +1669,45 @@ string SensorLinkNewtonEuler::getType() const
 //
 //================================
 
+namespace
+{
+    // fixed-size helpers of the flat recursion: 3x3 matrices are row-major
+
+    inline void copy3(const double *a, double *b)
+    {
+        b[0]=a[0]; b[1]=a[1]; b[2]=a[2];
+    }
+
+    inline void mul3(const double *R, const double *v, double *out)
+    {
+        out[0]=R[0]*v[0]+R[1]*v[1]+R[2]*v[2];
+        out[1]=R[3]*v[0]+R[4]*v[1]+R[5]*v[2];
+        out[2]=R[6]*v[0]+R[7]*v[1]+R[8]*v[2];
+    }
+
+    inline void mulTransp3(const double *R, const double *v, double *out)
+    {
+        out[0]=R[0]*v[0]+R[3]*v[1]+R[6]*v[2];
+        out[1]=R[1]*v[0]+R[4]*v[1]+R[7]*v[2];
+        out[2]=R[2]*v[0]+R[5]*v[1]+R[8]*v[2];
+    }
+
+    inline void addCross3(const double *a, const double *b, double *out)
+    {
+        out[0]+=a[1]*b[2]-a[2]*b[1];
+        out[1]+=a[2]*b[0]-a[0]*b[2];
+        out[2]+=a[0]*b[1]-a[1]*b[0];
+    }
+
+    inline void addCentripetal3(const double *w, const double *dw, const double *r, double *out)
+    {
+        // out += dw x r + w x (w x r)
+        double wr[3]={ w[1]*r[2]-w[2]*r[1], w[2]*r[0]-w[0]*r[2], w[0]*r[1]-w[1]*r[0] };
+        addCross3(dw,r,out);
+        addCross3(w,wr,out);
+    }
+}
+
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 OneChainNewtonEuler::OneChainNewtonEuler(iDynChain *_c, string _info, const NewEulMode _mode, unsigned int verb)
 {
@@ -1708,6 +1747,17 @@ OneChainNewtonEuler::OneChainNewtonEuler(iDynChain *_c, string _info, const NewE
     //the end effector is the last (nLinks+2-1 because it's an index)
     nEndEff = nLinks+1;
 
+    //buffers of the flat recursion, allocated once for all
+    flatLinks.resize(nLinks);
+    for(unsigned int i=0; i<nLinks; i++)
+        flatLinks[i] = chain->refLink(i);
+    flatR.assign(9*nLinks,0.0);
+    flatRp.assign(3*nLinks,0.0);
+    flatW.assign(3*(nEndEff+1),0.0);
+    flatDw.assign(3*(nEndEff+1),0.0);
+    flatDdpC.assign(3*(nEndEff+1),0.0);
+    flatF.assign(3*(nEndEff+1),0.0);
+    flatMu.assign(3*(nEndEff+1),0.0);
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 OneChainNewtonEuler::~OneChainNewtonEuler()
@@ -1850,10 +1900,7 @@ NewEulMode  OneChainNewtonEuler::getMode()      const       {return mode;}
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void OneChainNewtonEuler::ForwardKinematicFromBase()
 {
-    for(unsigned int i=1;i<nEndEff;i++)
-    {
-        neChain[i]->ForwardKinematics(neChain[i-1]);
-    }
+    flatForwardKinematicFromBase();
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void OneChainNewtonEuler::ForwardKinematicFromBase(const Vector &_w, const Vector &_dw, const Vector &_ddp)
@@ -1882,6 +1929,13 @@ void OneChainNewtonEuler::BackwardKinematicFromEnd(const Vector &_w, const Vecto
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void OneChainNewtonEuler::BackwardWrenchFromEnd()
 {    
+    //the rotor dynamics is only handled by the link-wise recursion
+    if(mode!=DYNAMIC_W_ROTOR)
+    {
+        flatBackwardWrenchFromEnd();
+        return;
+    }
+
     for(int i=nEndEff-1; i>=0; i--)
         neChain[i]->BackwardWrench(neChain[i+1]);
 
@@ -1905,6 +1959,149 @@ void OneChainNewtonEuler::BackwardWrenchFromEnd(const Vector &F, const Vector &M
     BackwardWrenchFromEnd();
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void OneChainNewtonEuler::flatTransforms()
+{
+    for(unsigned int i=0; i<nLinks; i++)
+    {
+        const iDynLink *l = flatLinks[i];
+        double theta = l->getAng()+l->getOffset();
+        double ct = cos(theta), st = sin(theta);
+        double ca = cos(l->getAlpha()), sa = sin(l->getAlpha());
+
+        double *R = &flatR[9*i];
+        R[0]=ct; R[1]=-st*ca; R[2]=st*sa;
+        R[3]=st; R[4]=ct*ca;  R[5]=-ct*sa;
+        R[6]=0.0; R[7]=sa;    R[8]=ca;
+
+        //r projected in the link frame: R^T*[A*ct, A*st, D]
+        double *rp = &flatRp[3*i];
+        rp[0]=l->getA(); rp[1]=l->getD()*sa; rp[2]=l->getD()*ca;
+    }
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void OneChainNewtonEuler::flatForwardKinematicFromBase()
+{
+    flatTransforms();
+
+    double w[3], dw[3], ddp[3];
+    copy3(neChain[0]->getAngVel().data(),w);
+    copy3(neChain[0]->getAngAcc().data(),dw);
+    copy3(neChain[0]->getLinAcc().data(),ddp);
+
+    for(unsigned int i=0; i<nLinks; i++)
+    {
+        iDynLink *l = flatLinks[i];
+        const double *R = &flatR[9*i];
+        double *ddpC = &flatDdpC[3*(i+1)];
+        double t[3];
+
+        if(mode==STATIC)
+        {
+            w[0]=w[1]=w[2]=0.0;
+            dw[0]=dw[1]=dw[2]=0.0;
+            mulTransp3(R,ddp,t);
+            copy3(t,ddp);
+            copy3(t,ddpC);
+        }
+        else
+        {
+            double v[3]={ w[0], w[1], w[2]+l->dq };
+            double a[3]={ dw[0]+l->dq*w[1], dw[1]-l->dq*w[0], dw[2] };
+            if(mode!=DYNAMIC_CORIOLIS_GRAVITY)
+                a[2]+=l->ddq;
+
+            mulTransp3(R,v,w);
+            mulTransp3(R,a,dw);
+
+            mulTransp3(R,ddp,t);
+            addCentripetal3(w,dw,&flatRp[3*i],t);
+            copy3(t,ddp);
+
+            addCentripetal3(w,dw,l->rc.data(),t);
+            copy3(t,ddpC);
+        }
+
+        copy3(w,&flatW[3*(i+1)]);
+        copy3(dw,&flatDw[3*(i+1)]);
+
+        copy3(w,l->w.data());
+        copy3(dw,l->dw.data());
+        copy3(ddp,l->ddp.data());
+        copy3(ddpC,l->ddpC.data());
+    }
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void OneChainNewtonEuler::flatBackwardWrenchFromEnd()
+{
+    flatTransforms();
+
+    //the kinematics may come from a different phase: gather it from the links
+    for(unsigned int i=0; i<nLinks; i++)
+    {
+        const iDynLink *l = flatLinks[i];
+        copy3(l->w.data(),&flatW[3*(i+1)]);
+        copy3(l->dw.data(),&flatDw[3*(i+1)]);
+        copy3(l->ddpC.data(),&flatDdpC[3*(i+1)]);
+    }
+
+    //the final frame has no mass and identity transform: the last link gets its wrench
+    copy3(neChain[nEndEff]->getForce().data(),&flatF[3*(nEndEff-1)]);
+    copy3(neChain[nEndEff]->getMoment(false).data(),&flatMu[3*(nEndEff-1)]);
+
+    //frame i collects the wrench of frame i+1, i.e. link i
+    for(int i=nEndEff-2; i>=0; i--)
+    {
+        const iDynLink *l = flatLinks[i];
+        const double *R = &flatR[9*i];
+        const double *rp = &flatRp[3*i];
+        const double *rc = l->rc.data();
+        const double *In = l->I.data();
+        const double *wn = &flatW[3*(i+1)];
+        const double *dwn = &flatDw[3*(i+1)];
+        const double *ddpCn = &flatDdpC[3*(i+1)];
+        const double *Fn = &flatF[3*(i+1)];
+        const double *Mun = &flatMu[3*(i+1)];
+
+        double mac[3]={ l->m*ddpCn[0], l->m*ddpCn[1], l->m*ddpCn[2] };
+        double t[3]={ mac[0]+Fn[0], mac[1]+Fn[1], mac[2]+Fn[2] };
+        mul3(R,t,&flatF[3*i]);
+
+        double rr[3]={ rp[0]+rc[0], rp[1]+rc[1], rp[2]+rc[2] };
+        double mu[3]={ Mun[0], Mun[1], Mun[2] };
+        addCross3(rp,Fn,mu);
+        addCross3(rr,mac,mu);
+        if(mode!=STATIC)
+        {
+            mul3(In,dwn,t);
+            mu[0]+=t[0]; mu[1]+=t[1]; mu[2]+=t[2];
+            mul3(In,wn,t);
+            addCross3(wn,t,mu);
+        }
+        mul3(R,mu,&flatMu[3*i]);
+    }
+
+    //write back: frame i+1 is link i
+    for(unsigned int i=0; i<nLinks; i++)
+    {
+        iDynLink *l = flatLinks[i];
+        copy3(&flatF[3*(i+1)],l->F.data());
+        copy3(&flatMu[3*(i+1)],l->Mu.data());
+        //the torque is the z-component of the moment of the previous frame 
+        // (the base one is not rotated by H0)
+        l->Tau = flatMu[3*i+2];
+    }
+
+    //the base stores its wrench rotated by H0, except for Mu0
+    BaseLinkNewtonEuler *base = static_cast<BaseLinkNewtonEuler*>(neChain[0]);
+    const double *H0 = base->H0.data();
+    const double R0[9]={ H0[0], H0[1], H0[2], H0[4], H0[5], H0[6], H0[8], H0[9], H0[10] };
+    mul3(R0,&flatF[0],base->F.data());
+    mul3(R0,&flatMu[0],base->Mu.data());
+    if(base->Mu0.length()!=3)
+        base->Mu0.resize(3);
+    copy3(&flatMu[0],base->Mu0.data());
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 void OneChainNewtonEuler::ForwardWrenchFromBase()
 {
     fprintf(stderr,"ForwardWrenchFromBase: not implemented yet \n");
@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * CopyPolicy: Released under the terms of the GNU GPL v2.0.
+ *
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+#include <algorithm>
+
+#include <yarp/os/Log.h>
+#include <yarp/math/Math.h>
+#include <iCub/iDyn/iDynRegressor.h>
+
+using namespace std;
+using namespace yarp::sig;
+using namespace yarp::math;
+using namespace iCub::ctrl;
+using namespace iCub::iDyn;
+
+
+//================================
+//
+//      I DYN REGRESSOR STREAM
+//
+//================================
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+iDynRegressorStream::iDynRegressorStream(const iDynChain *_chain, const Vector &_ddp0, const unsigned int verb)
+: chain(_chain), ddp0(_ddp0), verbose(verb), nThreads(1), blockSize(1024), jntScale(1.0)
+{
+    if(ddp0.length()!=3)
+    {
+        if(verbose) yError("iDynRegressorStream error: wrong size of ddp0: %d instead of 3, zero is set \n",(int)ddp0.length());
+        ddp0.resize(3,0.0);
+    }
+
+    unsigned int dof = chain->getDOF();
+    setLayout(0,dof,2*dof,3*dof);
+    reset();
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynRegressorStream::setLayout(const unsigned int _qCol, const unsigned int _dqCol,
+                                    const unsigned int _ddqCol, const unsigned int _tauCol)
+{
+    qCol = _qCol;
+    dqCol = _dqCol;
+    ddqCol = _ddqCol;
+    tauCol = _tauCol;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynRegressorStream::setDegrees(const bool deg)
+{
+    jntScale = deg ? CTRL_DEG2RAD : 1.0;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynRegressorStream::setNumThreads(const unsigned int _nThreads, const unsigned int _blockSize)
+{
+    flush();
+    nThreads = std::max(1U,_nThreads);
+    blockSize = std::max(1U,_blockSize);
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynRegressorStream::reset()
+{
+    unsigned int P = chain->getNumInertialParameters();
+    YtY.resize(P,P);
+    YtY.zero();
+    Ytau.resize(P,0.0);
+    Ytau.zero();
+    tauSq = 0.0;
+    nSamples = 0;
+    block.clear();
+    blockLen = 0;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynRegressorStream::processChunk(const unsigned int s0, const unsigned int s1,
+                                       vector<double> &A, vector<double> &b, double &c) const
+{
+    const unsigned int dof = chain->getDOF();
+    const size_t P = chain->getNumInertialParameters();
+    vector<double> work, Y(dof*P);
+
+    A.assign(P*P,0.0);
+    b.assign(P,0.0);
+    c = 0.0;
+
+    for(unsigned int s=s0; s<s1; s++)
+    {
+        const double *x = &block[4*dof*s];
+        const double *tau = x+3*dof;
+        chain->computeRegressor(x,x+dof,x+2*dof,ddp0.data(),Y.data(),P,work);
+
+        // only the upper triangle of Y'*Y is accumulated
+        for(unsigned int r=0; r<dof; r++)
+        {
+            const double *y = &Y[r*P];
+            for(size_t i=0; i<P; i++)
+            {
+                if(y[i]==0.0)
+                    continue;
+
+                double *a = &A[i*P];
+                for(size_t j=i; j<P; j++)
+                    a[j] += y[i]*y[j];
+                b[i] += y[i]*tau[r];
+            }
+            c += tau[r]*tau[r];
+        }
+    }
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynRegressorStream::processBlock()
+{
+    if(blockLen==0)
+        return;
+
+    const size_t P = chain->getNumInertialParameters();
+    unsigned int n = std::min(nThreads,blockLen);
+    const unsigned int samplesPerThread = (blockLen+n-1)/n;
+
+    vector<vector<double> > A(n), b(n);
+    vector<double> c(n,0.0);
+
+    if(n==1)
+        processChunk(0,blockLen,A[0],b[0],c[0]);
+    else
+    {
+        vector<thread> workers;
+        for(unsigned int k=0; k<n; k++)
+        {
+            unsigned int s0 = std::min(blockLen,k*samplesPerThread);
+            unsigned int s1 = std::min(blockLen,s0+samplesPerThread);
+            workers.push_back(thread(&iDynRegressorStream::processChunk,this,s0,s1,
+                                     std::ref(A[k]),std::ref(b[k]),std::ref(c[k])));
+        }
+
+        for(auto &w : workers)
+            w.join();
+    }
+
+    // sum up the partial contributions always in the same order
+    for(unsigned int k=0; k<n; k++)
+    {
+        for(size_t i=0; i<P; i++)
+        {
+            for(size_t j=i; j<P; j++)
+                YtY(i,j) += A[k][i*P+j];
+            Ytau[i] += b[k][i];
+        }
+        tauSq += c[k];
+    }
+
+    for(size_t i=0; i<P; i++)
+        for(size_t j=0; j<i; j++)
+            YtY(i,j) = YtY(j,i);
+
+    nSamples += blockLen;
+    blockLen = 0;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool iDynRegressorStream::feedSample(const Vector &q, const Vector &dq, const Vector &ddq, const Vector &tau)
+{
+    const unsigned int dof = chain->getDOF();
+    if((q.length()!=dof) || (dq.length()!=dof) || (ddq.length()!=dof) || (tau.length()!=dof))
+    {
+        if(verbose) yError("iDynRegressorStream error: feedSample() failed due to wrong sized vectors: q,dq,ddq,tau have size %d,%d,%d,%d instead of %d \n",
+                           (int)q.length(),(int)dq.length(),(int)ddq.length(),(int)tau.length(),dof);
+        return false;
+    }
+
+    block.resize(4*dof*blockSize);
+    double *x = &block[4*dof*blockLen];
+    for(unsigned int i=0; i<dof; i++)
+    {
+        x[i] = jntScale*q[i];
+        x[dof+i] = jntScale*dq[i];
+        x[2*dof+i] = jntScale*ddq[i];
+        x[3*dof+i] = tau[i];
+    }
+
+    if(++blockLen>=blockSize)
+        processBlock();
+
+    return true;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+int iDynRegressorStream::feedFile(const string &filename)
+{
+    ifstream fin(filename.c_str());
+    if(!fin.is_open())
+    {
+        if(verbose) yError("iDynRegressorStream error: unable to open %s \n",filename.c_str());
+        return -1;
+    }
+
+    const unsigned int dof = chain->getDOF();
+    const unsigned int nCols = std::max(std::max(qCol,dqCol),std::max(ddqCol,tauCol))+dof;
+    Vector q(dof), dq(dof), ddq(dof), tau(dof);
+    vector<double> values;
+    string line;
+    int nRead = 0;
+    int nSkipped = 0;
+
+    while(getline(fin,line))
+    {
+        const char *str = line.c_str();
+        while((*str==' ') || (*str=='\t'))
+            str++;
+        if((*str=='\0') || (*str=='#') || (*str=='\r'))
+            continue;
+
+        values.clear();
+        char *end;
+        for(double v=strtod(str,&end); end!=str; v=strtod(str,&end))
+        {
+            values.push_back(v);
+            str = end;
+        }
+
+        if(values.size()<nCols)
+        {
+            nSkipped++;
+            continue;
+        }
+
+        for(unsigned int i=0; i<dof; i++)
+        {
+            q[i] = values[qCol+i];
+            dq[i] = values[dqCol+i];
+            ddq[i] = values[ddqCol+i];
+            tau[i] = values[tauCol+i];
+        }
+
+        if(feedSample(q,dq,ddq,tau))
+            nRead++;
+    }
+
+    if(verbose && (nSkipped>0))
+        yWarning("iDynRegressorStream: %d lines of %s skipped because of less than %d columns \n",
+                 nSkipped,filename.c_str(),nCols);
+
+    return nRead;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void iDynRegressorStream::flush()
+{
+    processBlock();
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+const Matrix &iDynRegressorStream::getNormalMatrix()
+{
+    flush();
+    return YtY;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+const Vector &iDynRegressorStream::getNormalVector()
+{
+    flush();
+    return Ytau;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool iDynRegressorStream::solve(Vector &pi, const double lambda)
+{
+    flush();
+    if(nSamples==0)
+    {
+        if(verbose) yError("iDynRegressorStream error: no samples to solve for \n");
+        return false;
+    }
+
+    Vector pi0 = chain->getInertialParameters();
+    Matrix A = YtY;
+    for(int i=0; i<A.rows(); i++)
+        A(i,i) += lambda;
+
+    pi = luinv(A)*(Ytau+lambda*pi0);
+    return true;
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+double iDynRegressorStream::getResidual(const Vector &pi)
+{
+    flush();
+    if((nSamples==0) || (pi.length()!=Ytau.length()))
+        return 0.0;
+
+    // |Y*pi-tau|^2 = pi'*Y'*Y*pi - 2*pi'*Y'*tau + tau'*tau
+    double e2 = dot(pi,YtY*pi)-2.0*dot(pi,Ytau)+tauSq;
+    return sqrt(std::max(e2,0.0)/(nSamples*chain->getDOF()));
+}
+
@@ -270,10 +270,12 @@ void iFTransformation::attach(iKinChain *_Limb)
     Limb=_Limb;
     Sensor->attach(_Limb);
     ownLimb=false;
+    cacheValid=false;
 }
 void iFTransformation::attach(iGenericFrame *_Sensor)
 {    
     Sensor->attach(_Sensor);
+    cacheValid=false;
 }
 void iFTransformation::initiFTransformation()
 {
@@ -302,11 +304,18 @@ void iFTransformation::initiFTransformation()
     R=0.0;
 
     SensorFrame=0;
+
+    for(int i=0; i<9; i++)
+        Rse[i]=0.0;
+    pse[0]=pse[1]=pse[2]=0.0;
+    firstRev=0;
+    cacheValid=false;
 }
 void iFTransformation::setLink(int _l)
 {
     Sensor->setLink(_l);
     l=_l;
+    cacheValid=false;
 }
 void iFTransformation::setSensor(const Vector &_FT)
 {
@@ -317,6 +326,8 @@ void iFTransformation::setSensor(const Vector &_FT)
 void iFTransformation::setSensor(int _l, const Vector &_FT)
 {
     Fs=_FT;
+    if (l!=_l)
+        cacheValid=false;
     l=_l;
     Sensor->setSensor(_l, _FT);
     Hs=Sensor->getH();
@@ -412,6 +423,67 @@ void iFTransformation::setTse()
     }
 
 }
+void iFTransformation::updateProjection()
+{
+    // same transformation of setTse(), from the full kinematics
+    Matrix Hsens=Limb->getH(l)*Sensor->getHs();
+    Matrix Hee=Limb->getH();
+    for(int i=0; i<3; i++)
+    {
+        for(int j=0; j<3; j++)
+            Rse[3*i+j]=Hee(0,i)*Hsens(0,j)+Hee(1,i)*Hsens(1,j)+Hee(2,i)*Hsens(2,j);
+        pse[i]=Hee(0,i)*(Hsens(0,3)-Hee(0,3))+Hee(1,i)*(Hsens(1,3)-Hee(1,3))+Hee(2,i)*(Hsens(2,3)-Hee(2,3));
+    }
+
+    // only the links beyond the one of the sensor move the sensor with respect to the end-effector
+    unsigned int N=Limb->getN();
+    firstRev=0;
+    if ((l>=0) && ((unsigned int)l<Limb->getDOF()))
+    {
+        iKinLink *lnk=&(*Limb)((unsigned int)l);
+        for(unsigned int i=0; i<N; i++)
+        {
+            if (&(*Limb)[i]==lnk)
+            {
+                firstRev=i+1;
+                break;
+            }
+        }
+    }
+
+    revs.resize(N);
+    for(unsigned int i=0; i<N; i++)
+        revs[i]=(*Limb)[i].getRevision();
+    cacheValid=true;
+}
+bool iFTransformation::projectWrench(const Vector &in, Vector &out)
+{
+    if (in.length()!=6)
+        return false;
+
+    bool valid=cacheValid && (revs.size()==Limb->getN());
+    for(unsigned int i=firstRev; valid && (i<revs.size()); i++)
+        valid=(revs[i]==(*Limb)[i].getRevision());
+    if (!valid)
+        updateProjection();
+
+    if (out.length()!=6)
+        out.resize(6);
+
+    // out = Tse*in, with Tse = [R 0; S(p)*R R]
+    double f[3], mu[3];
+    for(int i=0; i<3; i++)
+    {
+        f[i]=Rse[3*i]*in[0]+Rse[3*i+1]*in[1]+Rse[3*i+2]*in[2];
+        mu[i]=Rse[3*i]*in[3]+Rse[3*i+1]*in[4]+Rse[3*i+2]*in[5];
+    }
+    out[0]=f[0]; out[1]=f[1]; out[2]=f[2];
+    out[3]=mu[0]+pse[1]*f[2]-pse[2]*f[1];
+    out[4]=mu[1]+pse[2]*f[0]-pse[0]*f[2];
+    out[5]=mu[2]+pse[0]*f[1]-pse[1]*f[0];
+
+    return true;
+}
 iFTransformation::~iFTransformation()
 {
     if (Limb && ownLimb)
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD-3-Clause license. See the accompanying LICENSE file for
+ * details.
+*/
+
+/**
+ * \defgroup iKinBatch iKinBatch
+ *
+ * @ingroup iKin
+ *
+ * Batched forward kinematics over large sets of joint
+ * configurations.
+ */
+
+#ifndef __IKINBATCH_H__
+#define __IKINBATCH_H__
+
+#include <deque>
+
+#include <yarp/sig/Vector.h>
+#include <yarp/sig/Matrix.h>
+
+#include <iCub/iKin/iKinFwd.h>
+
+
+namespace iCub
+{
+
+namespace iKin
+{
+
+/**
+* \ingroup iKinBatch
+*
+* A class for computing the forward kinematics and the geometric
+* Jacobian of a chain over thousands of joint configurations at
+* once.
+*
+* The kinematic structure is imported from an iKinChain, folding
+* the blocked links into constant transformations. Configurations
+* are then processed in blocks laid out as structure-of-arrays,
+* so that the DH products run as plain loops over contiguous
+* memory the compiler can vectorize; blocks can be further
+* distributed across several threads.
+*
+* @note The object does not keep any reference to the source
+*       chain, therefore changes in the chain structure (e.g.
+*       blocking/releasing links) require a new call to
+*       fromChain().
+*/
+class iKinBatchFwd
+{
+protected:
+    struct Link
+    {
+        double A;
+        double D;
+        double c_alpha;
+        double s_alpha;
+        double Offset;
+        double Min;
+        double Max;
+        bool   constrained;
+        bool   hasPre;
+        double pre[12];
+    };
+
+    std::deque<Link> links;
+    double H0[12];
+    double HN[12];
+    unsigned int dof;
+
+    void processChunk(const yarp::sig::Matrix &Q, const int r0, const int r1,
+                      yarp::sig::Matrix *poses, const bool axisRep,
+                      yarp::sig::Matrix *jacobians) const;
+    bool process(const yarp::sig::Matrix &Q, yarp::sig::Matrix *poses,
+                 const bool axisRep, yarp::sig::Matrix *jacobians,
+                 unsigned int nThreads) const;
+
+public:
+    /**
+    * Default constructor.
+    */
+    iKinBatchFwd();
+
+    /**
+    * Constructor.
+    * @param chain is the chain from which to import the kinematic
+    *              structure.
+    */
+    iKinBatchFwd(iKinChain &chain);
+
+    /**
+    * Imports the kinematic structure from an iKinChain.
+    * @param chain is the source chain.
+    * @return true/false on success/failure.
+    */
+    bool fromChain(iKinChain &chain);
+
+    /**
+    * Returns the number of DOF.
+    * @return the number of DOF.
+    */
+    unsigned int getDOF() const { return dof; }
+
+    /**
+    * Computes the end-effector poses for a set of joint
+    * configurations.
+    * @param Q is the Mxdof matrix of joint configurations, one per
+    *          row [rad] (angles constraints are evaluated).
+    * @param poses is the output Mx7 (axis/angle notation) or Mx6
+    *              (Euler Angles) matrix.
+    * @param axisRep if true returns the axis/angle notation.
+    * @param nThreads is the number of threads the work is split
+    *                 into (1 by default).
+    * @return true/false on success/failure.
+    */
+    bool computeEndEffPoses(const yarp::sig::Matrix &Q, yarp::sig::Matrix &poses,
+                            const bool axisRep=true, unsigned int nThreads=1) const;
+
+    /**
+    * Computes the geometric Jacobians of the end-effector for a set
+    * of joint configurations.
+    * @param Q is the Mxdof matrix of joint configurations, one per
+    *          row [rad].
+    * @param jacobians is the output Mx(6*dof) matrix, where each row
+    *                  stores the corresponding 6xdof Jacobian
+    *                  row-wise.
+    * @param nThreads is the number of threads the work is split
+    *                 into (1 by default).
+    * @return true/false on success/failure.
+    */
+    bool computeGeoJacobians(const yarp::sig::Matrix &Q, yarp::sig::Matrix &jacobians,
+                             unsigned int nThreads=1) const;
+
+    /**
+    * Computes both the end-effector poses and the geometric
+    * Jacobians for a set of joint configurations in one pass.
+    * @param Q is the Mxdof matrix of joint configurations.
+    * @param poses is the output matrix of poses.
+    * @param jacobians is the output matrix of Jacobians.
+    * @param axisRep if true returns the axis/angle notation.
+    * @param nThreads is the number of threads.
+    * @return true/false on success/failure.
+    * @see computeEndEffPoses
+    * @see computeGeoJacobians
+    */
+    bool compute(const yarp::sig::Matrix &Q, yarp::sig::Matrix &poses,
+                 yarp::sig::Matrix &jacobians, const bool axisRep=true,
+                 unsigned int nThreads=1) const;
+};
+
+}
+
+}
+
+#endif
+
+
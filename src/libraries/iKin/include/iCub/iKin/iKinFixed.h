@@ -0,0 +1,432 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD-3-Clause license. See the accompanying LICENSE file for
+ * details.
+*/
+
+/**
+ * \defgroup iKinFixed iKinFixed
+ *
+ * @ingroup iKin
+ *
+ * Fixed-size serial-links chains whose number of DOF is known at
+ * compile time.
+ */
+
+#ifndef __IKINFIXED_H__
+#define __IKINFIXED_H__
+
+#include <cmath>
+#include <array>
+#include <algorithm>
+
+#include <yarp/sig/Vector.h>
+#include <yarp/sig/Matrix.h>
+
+#include <iCub/iKin/iKinFwd.h>
+
+
+namespace iCub
+{
+
+namespace iKin
+{
+
+/**
+* \ingroup iKinFixed
+*
+* A class for defining a Serial Link Chain with N DOF fixed at
+* compile time.
+*
+* All the quantities live on the stack (4x4 homogeneous
+* transformations and 6xN Jacobians stored row-wise as plain
+* arrays), thus the compiler is free to unroll the forward
+* kinematics and the Jacobian computation.
+*
+* The chain is fed by an existing iKinChain (e.g. one of the
+* iCub limbs built from the iKinLimbVersion tables): the blocked
+* links of the source chain are absorbed into constant
+* transformations, so that N has to match the number of DOF of
+* the source chain.
+*
+* @code
+* iCubArm arm("right");             // 7 DOF: torso blocked
+* iKinFixedChain<7> fixedArm(arm);
+* iKinFixedChain<7>::Transform H;
+* fixedArm.setAng(q);
+* fixedArm.getH(H);
+* @endcode
+*/
+template<unsigned int N>
+class iKinFixedChain
+{
+public:
+    /**
+    * 4x4 homogeneous transformation stored row-wise.
+    */
+    typedef std::array<double,16> Transform;
+
+    /**
+    * 6xN geometric Jacobian stored row-wise.
+    */
+    typedef std::array<double,6*N> Jacobian;
+
+protected:
+    struct Link
+    {
+        double A;
+        double D;
+        double c_alpha;
+        double s_alpha;
+        double Offset;
+        double Min;
+        double Max;
+        bool   constrained;
+        bool   hasPre;
+        Transform pre;
+    };
+
+    std::array<Link,N>   links;
+    std::array<double,N> q;
+    Transform H0;
+    Transform HN;
+
+    /************************************************************************/
+    static void eye(Transform &T)
+    {
+        T.fill(0.0);
+        T[0]=T[5]=T[10]=T[15]=1.0;
+    }
+
+    /************************************************************************/
+    static void fromMatrix(const yarp::sig::Matrix &M, Transform &T)
+    {
+        for (int r=0; r<4; r++)
+            for (int c=0; c<4; c++)
+                T[4*r+c]=M(r,c);
+    }
+
+    /************************************************************************/
+    static void mul(const Transform &A, const Transform &B, Transform &C)
+    {
+        // homogeneous transformations: the last row is always (0 0 0 1)
+        for (int r=0; r<3; r++)
+        {
+            const double *a=&A[4*r];
+            C[4*r+0]=a[0]*B[0]+a[1]*B[4]+a[2]*B[8];
+            C[4*r+1]=a[0]*B[1]+a[1]*B[5]+a[2]*B[9];
+            C[4*r+2]=a[0]*B[2]+a[1]*B[6]+a[2]*B[10];
+            C[4*r+3]=a[0]*B[3]+a[1]*B[7]+a[2]*B[11]+a[3];
+        }
+
+        C[12]=C[13]=C[14]=0.0;
+        C[15]=1.0;
+    }
+
+    /************************************************************************/
+    static void mulDH(const Transform &T, const Link &l, const double theta,
+                      Transform &C)
+    {
+        // C=T*H(theta), exploiting the structure of the DH matrix
+        double c_theta=cos(theta);
+        double s_theta=sin(theta);
+
+        double h00=c_theta,  h01=-s_theta*l.c_alpha, h02=s_theta*l.s_alpha,  h03=c_theta*l.A;
+        double h10=s_theta,  h11=c_theta*l.c_alpha,  h12=-c_theta*l.s_alpha, h13=s_theta*l.A;
+        double                h21=l.s_alpha,          h22=l.c_alpha,          h23=l.D;
+
+        for (int r=0; r<3; r++)
+        {
+            const double *t=&T[4*r];
+            C[4*r+0]=t[0]*h00+t[1]*h10;
+            C[4*r+1]=t[0]*h01+t[1]*h11+t[2]*h21;
+            C[4*r+2]=t[0]*h02+t[1]*h12+t[2]*h22;
+            C[4*r+3]=t[0]*h03+t[1]*h13+t[2]*h23+t[3];
+        }
+
+        C[12]=C[13]=C[14]=0.0;
+        C[15]=1.0;
+    }
+
+    /************************************************************************/
+    void forward(std::array<Transform,N+1> &frames, Transform &H) const
+    {
+        // frames[i] is the frame the ith joint axis is expressed in
+        Transform T=H0;
+        for (unsigned int i=0; i<N; i++)
+        {
+            const Link &l=links[i];
+            if (l.hasPre)
+                mul(T,l.pre,frames[i]);
+            else
+                frames[i]=T;
+
+            mulDH(frames[i],l,q[i]+l.Offset,T);
+        }
+
+        frames[N]=T;
+        mul(T,HN,H);
+    }
+
+public:
+    /**
+    * Default constructor: all the links are null and the base and
+    * end-effector transformations are identities.
+    */
+    iKinFixedChain()
+    {
+        for (unsigned int i=0; i<N; i++)
+        {
+            Link &l=links[i];
+            l.A=l.D=l.Offset=0.0;
+            l.c_alpha=1.0;
+            l.s_alpha=0.0;
+            l.Min=-iCub::ctrl::CTRL_PI;
+            l.Max=iCub::ctrl::CTRL_PI;
+            l.constrained=true;
+            l.hasPre=false;
+            eye(l.pre);
+        }
+
+        q.fill(0.0);
+        eye(H0);
+        eye(HN);
+    }
+
+    /**
+    * Constructor.
+    * @param chain is the chain from which to import the kinematic
+    *              structure.
+    * @see fromChain
+    */
+    explicit iKinFixedChain(iKinChain &chain) : iKinFixedChain()
+    {
+        fromChain(chain);
+    }
+
+    /**
+    * Imports the kinematic structure, the joints bounds and the
+    * current configuration from an iKinChain.
+    * @param chain is the source chain.
+    * @return true/false on success/failure (the number of DOF of
+    *         chain has to be equal to N).
+    */
+    bool fromChain(iKinChain &chain)
+    {
+        if (chain.getDOF()!=N)
+            return false;
+
+        fromMatrix(chain.getH0(),H0);
+
+        yarp::sig::Matrix pending=yarp::math::eye(4,4);
+        bool isPending=false;
+        unsigned int j=0;
+
+        for (unsigned int i=0; i<chain.getN(); i++)
+        {
+            iKinLink &link=chain[i];
+            if (link.isBlocked())
+            {
+                pending*=link.getH(true);
+                isPending=true;
+                continue;
+            }
+
+            Link &l=links[j];
+            l.A=link.getA();
+            l.D=link.getD();
+            l.c_alpha=cos(link.getAlpha());
+            l.s_alpha=sin(link.getAlpha());
+            l.Offset=link.getOffset();
+            l.Min=link.getMin();
+            l.Max=link.getMax();
+            l.constrained=link.getConstraint();
+            l.hasPre=isPending;
+            fromMatrix(pending,l.pre);
+            q[j]=link.getAng();
+
+            pending=yarp::math::eye(4,4);
+            isPending=false;
+            j++;
+        }
+
+        fromMatrix(pending*chain.getHN(),HN);
+        return true;
+    }
+
+    /**
+    * Exports the current configuration into an iKinChain having
+    * the same structure.
+    * @param chain is the destination chain.
+    * @return true/false on success/failure (the number of DOF of
+    *         chain has to be equal to N).
+    */
+    bool toChain(iKinChain &chain) const
+    {
+        if (chain.getDOF()!=N)
+            return false;
+
+        chain.setAng(getAng());
+        return true;
+    }
+
+    /**
+    * Returns the number of DOF.
+    * @return N.
+    */
+    static constexpr unsigned int getDOF() { return N; }
+
+    /**
+    * Sets the joint angles.
+    * @param _q points to the N joint angles [rad].
+    *
+    * @note Angles constraints are evaluated.
+    */
+    void setAng(const double *_q)
+    {
+        for (unsigned int i=0; i<N; i++)
+        {
+            const Link &l=links[i];
+            q[i]=l.constrained?std::min(std::max(_q[i],l.Min),l.Max):_q[i];
+        }
+    }
+
+    /**
+    * Sets the joint angles.
+    * @param _q is the vector of N joint angles [rad].
+    * @return true/false on success/failure (wrong size).
+    */
+    bool setAng(const yarp::sig::Vector &_q)
+    {
+        if (_q.length()<N)
+            return false;
+
+        setAng(_q.data());
+        return true;
+    }
+
+    /**
+    * Retrieves the joint angles.
+    * @param _q points to the storage for the N joint angles.
+    */
+    void getAng(double *_q) const
+    {
+        std::copy(q.begin(),q.end(),_q);
+    }
+
+    /**
+    * Returns the joint angles.
+    * @return the vector of N joint angles [rad].
+    */
+    yarp::sig::Vector getAng() const
+    {
+        yarp::sig::Vector _q(N);
+        getAng(_q.data());
+        return _q;
+    }
+
+    /**
+    * Computes the rigid roto-translation matrix from the root
+    * reference frame to the end-effector frame (HN is taken into
+    * account).
+    * @param H is the output transformation.
+    */
+    void getH(Transform &H) const
+    {
+        Transform T=H0,C;
+        for (unsigned int i=0; i<N; i++)
+        {
+            const Link &l=links[i];
+            if (l.hasPre)
+            {
+                mul(T,l.pre,C);
+                T=C;
+            }
+
+            mulDH(T,l,q[i]+l.Offset,C);
+            T=C;
+        }
+
+        mul(T,HN,H);
+    }
+
+    /**
+    * Computes the end-effector position.
+    * @param p is the 3x1 output array.
+    */
+    void getEndEffPosition(std::array<double,3> &p) const
+    {
+        Transform H;
+        getH(H);
+
+        p[0]=H[3];
+        p[1]=H[7];
+        p[2]=H[11];
+    }
+
+    /**
+    * Computes the geometric Jacobian of the end-effector.
+    * @param J is the 6xN output Jacobian.
+    * @param H if not NULL is filled with the end-effector
+    *          transformation computed along.
+    */
+    void getGeoJacobian(Jacobian &J, Transform *H=NULL) const
+    {
+        std::array<Transform,N+1> frames;
+        Transform PN;
+        forward(frames,PN);
+
+        for (unsigned int i=0; i<N; i++)
+        {
+            const Transform &Z=frames[i];
+            double dx=PN[3]-Z[3];
+            double dy=PN[7]-Z[7];
+            double dz=PN[11]-Z[11];
+
+            J[0*N+i]=Z[6]*dz-Z[10]*dy;
+            J[1*N+i]=Z[10]*dx-Z[2]*dz;
+            J[2*N+i]=Z[2]*dy-Z[6]*dx;
+            J[3*N+i]=Z[2];
+            J[4*N+i]=Z[6];
+            J[5*N+i]=Z[10];
+        }
+
+        if (H!=NULL)
+            *H=PN;
+    }
+
+    /**
+    * Converts a transformation into a YARP matrix.
+    * @param T is the input transformation.
+    * @return the 4x4 matrix.
+    */
+    static yarp::sig::Matrix toMatrix(const Transform &T)
+    {
+        yarp::sig::Matrix M(4,4);
+        std::copy(T.begin(),T.end(),M.data());
+        return M;
+    }
+
+    /**
+    * Converts a Jacobian into a YARP matrix.
+    * @param J is the input Jacobian.
+    * @return the 6xN matrix.
+    */
+    static yarp::sig::Matrix toMatrix(const Jacobian &J)
+    {
+        yarp::sig::Matrix M(6,N);
+        std::copy(J.begin(),J.end(),M.data());
+        return M;
+    }
+};
+
+}
+
+}
+
+#endif
+
+
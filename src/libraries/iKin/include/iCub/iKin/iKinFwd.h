@@ -55,6 +55,7 @@
 
 #include <string>
 #include <deque>
+#include <vector>
 
 #include <yarp/os/Property.h>
 #include <yarp/dev/ControlBoardInterfaces.h>
@@ -99,6 +100,9 @@ protected:
     bool         constrained;
     unsigned int verbose;
 
+    // incremented whenever the link transformation may change
+    unsigned long revision{0};
+
     yarp::sig::Matrix H;
     yarp::sig::Matrix cumH;
     yarp::sig::Matrix DnH;
@@ -112,6 +116,8 @@ protected:
     iKinLink();
 
     virtual void clone(const iKinLink &l);    
+    const yarp::sig::Matrix &getRawH();
+    const yarp::sig::Matrix &getRawDH();
     bool         isCumulative()     { return cumulative;          }
     void         block()            { blocked=true;               }
     void         block(double _Ang) { setAng(_Ang); blocked=true; }
@@ -181,6 +187,14 @@ public:
     */
     bool isBlocked() const { return blocked; }
 
+    /**
+    * Returns the revision of the Link, which changes whenever 
+    * its transformation may change (angle, DH parameters), thus
+    * allowing to cache quantities depending on it. 
+    * @return the revision counter.
+    */
+    unsigned long getRevision() const { return revision; }
+
     /**
     * Returns the Link length A.
     * @return Link length A.
@@ -191,7 +205,7 @@ public:
     * Sets the Link length A. 
     * @param new Link length _A. 
     */
-    void setA(const double _A) { A=_A; }
+    void setA(const double _A) { A=_A; revision++; }
 
     /**
     * Returns the Link offset D.
@@ -227,7 +241,7 @@ public:
     * Sets the joint angle offset. 
     * @param new joint angle offset _Offset. 
     */
-    void setOffset(const double _Offset) { Offset=_Offset; }
+    void setOffset(const double _Offset) { Offset=_Offset; revision++; }
 
     /**
     * Returns the joint angle lower bound.
@@ -346,6 +360,33 @@ public:
 };
 
 
+/**
+* \ingroup iKinFwd
+*
+* The scratch storage of the const kinematics methods of 
+* iKinChain. 
+*  
+* Each thread evaluating a chain through those methods needs a 
+* workspace of its own, whereas the chain itself can be shared: 
+* the workspace is sized at its first use and then reused with 
+* no further memory allocation. 
+*/
+class iKinChainWorkspace
+{
+protected:
+    friend class iKinChain;
+
+    // intH[16*(i+1)] holds H0*H_0*...*H_i row-wise, over all the links
+    std::vector<double> intH;
+
+public:
+    /**
+    * Default constructor.
+    */
+    iKinChainWorkspace() { }
+};
+
+
 /**
 * \ingroup iKinFwd
 *
@@ -370,10 +411,27 @@ protected:
     yarp::sig::Matrix hess_J;
     yarp::sig::Matrix hess_Jlnk;
 
+    // scratch storage for the allocation-free kinematics
+    yarp::sig::Matrix fwd_H;
+    yarp::sig::Matrix fwd_dH;
+    yarp::sig::Matrix fwd_tmp;
+    yarp::sig::Matrix fwd_J;
+    std::deque<yarp::sig::Matrix> fwd_intH;
+
+    // fwd_intH[i+1] caches H0*H_0*...*H_i over all the links;
+    // entries are refreshed starting from the first link whose
+    // revision has changed since the last computation
+    std::deque<unsigned long> fwd_rev;
+    unsigned int fwd_valid;
+
     virtual void clone(const iKinChain &c);
     virtual void build();
     virtual void dispose();
 
+    void applyAng(const yarp::sig::Vector &q);
+    void updateIntH(const unsigned int n);
+    void evalIntH(const yarp::sig::Vector &q, iKinChainWorkspace &ws) const;
+
     yarp::sig::Vector RotAng(const yarp::sig::Matrix &R);
     yarp::sig::Vector dRotAng(const yarp::sig::Matrix &R, const yarp::sig::Matrix &dR);
     yarp::sig::Vector d2RotAng(const yarp::sig::Matrix &R, const yarp::sig::Matrix &dRi,
@@ -625,6 +683,11 @@ public:
     * @param allLink if true enables the spanning over the full set 
     *                of links (false by default).
     * @return Hi 
+    *  
+    * @note When allLink is true, the intermediate transformations 
+    *       are cached and only the links following the first one
+    *       whose joint angle (or DH parameter) has changed are
+    *       recomputed.
     */
     yarp::sig::Matrix getH(const unsigned int i, const bool allLink=false);
 
@@ -645,6 +708,18 @@ public:
     */
     yarp::sig::Matrix getH(const yarp::sig::Vector &q);
 
+    /**
+    * Retrieves the rigid roto-translation matrix from the root 
+    * reference frame to the end-effector frame in 
+    * Denavit-Hartenberg notation (HN is taken into account). 
+    * @param H is the 4x4 output matrix. 
+    * @return true/false on success/failure. 
+    *  
+    * @note No memory allocation takes place once H has been sized 
+    *       as 4x4 by a previous call.
+    */
+    bool getH(yarp::sig::Matrix &H);
+
     /**
     * Returns the coordinates of ith Link. Two notations are
     * provided: the first with Euler Angles (XYZ form=>6x1 output 
@@ -697,6 +772,49 @@ public:
     */
     yarp::sig::Vector EndEffPosition(const yarp::sig::Vector &q);
 
+    /**
+    * Retrieves the coordinates of end-effector. 
+    * @param pose is the output vector (7x1 with axis/angle 
+    *             notation, 6x1 with Euler Angles).
+    * @param axisRep if true returns the axis/angle notation. 
+    * @return true/false on success/failure. 
+    *  
+    * @note Allocation-free version of EndEffPose(): the chain 
+    *       relies on internal scratch storage and no memory
+    *       allocation takes place once pose has been sized by a
+    *       previous call.
+    */
+    bool getEndEffPose(yarp::sig::Vector &pose, const bool axisRep=true);
+
+    /**
+    * Retrieves the coordinates of end-effector computed in q. 
+    * @param q is the vector of new DOF values. 
+    * @param pose is the output vector. 
+    * @param axisRep if true returns the axis/angle notation. 
+    * @return true/false on success/failure. 
+    * @see getEndEffPose 
+    */
+    bool getEndEffPose(const yarp::sig::Vector &q, yarp::sig::Vector &pose,
+                       const bool axisRep=true);
+
+    /**
+    * Retrieves the 3D coordinates of end-effector position. 
+    * @param pos is the 3x1 output vector. 
+    * @return true/false on success/failure. 
+    * @see getEndEffPose 
+    */
+    bool getEndEffPosition(yarp::sig::Vector &pos);
+
+    /**
+    * Retrieves the 3D coordinates of end-effector position 
+    * computed in q. 
+    * @param q is the vector of new DOF values. 
+    * @param pos is the 3x1 output vector. 
+    * @return true/false on success/failure. 
+    * @see getEndEffPose 
+    */
+    bool getEndEffPosition(const yarp::sig::Vector &q, yarp::sig::Vector &pos);
+
     /**
     * Returns the analitical Jacobian of the ith link.
     * @param i is the Link number. 
@@ -727,6 +845,33 @@ public:
     */
     yarp::sig::Matrix AnaJacobian(const yarp::sig::Vector &q, unsigned int col=3);
 
+    /**
+    * Retrieves the analitical Jacobian of the end-effector.
+    * @param J is the 6xDOF output matrix. 
+    * @param col selects the part of the derived homogeneous matrix 
+    *            to be put in the upper side of the Jacobian
+    *            matrix: 0 => x, 1 => y, 2 => z, 3 => p (default)
+    * @return true/false on success/failure (e.g. DOF==0). 
+    *  
+    * @note Allocation-free version of AnaJacobian(): no memory 
+    *       allocation takes place once J has been sized by a
+    *       previous call.
+    */
+    bool getAnaJacobian(yarp::sig::Matrix &J, unsigned int col=3);
+
+    /**
+    * Retrieves the analitical Jacobian of the end-effector computed
+    * in q. 
+    * @param q is the vector of new DOF values. 
+    * @param J is the 6xDOF output matrix. 
+    * @param col selects the part of the derived homogeneous matrix 
+    *            to be put in the upper side of the Jacobian matrix.
+    * @return true/false on success/failure (e.g. DOF==0). 
+    * @see getAnaJacobian 
+    */
+    bool getAnaJacobian(const yarp::sig::Vector &q, yarp::sig::Matrix &J,
+                        unsigned int col=3);
+
     /**
     * Returns the geometric Jacobian of the ith link. 
     * @param i is the Link number.
@@ -751,6 +896,76 @@ public:
     */
     yarp::sig::Matrix GeoJacobian(const yarp::sig::Vector &q);
 
+    /**
+    * Retrieves the geometric Jacobian of the end-effector.
+    * @param J is the 6xDOF output matrix. 
+    * @return true/false on success/failure (e.g. DOF==0). 
+    * @note The blocked links are not considered. 
+    * @note Allocation-free version of GeoJacobian(): no memory 
+    *       allocation takes place once J has been sized by a
+    *       previous call.
+    */
+    bool getGeoJacobian(yarp::sig::Matrix &J);
+
+    /**
+    * Retrieves the geometric Jacobian of the end-effector computed 
+    * in q. 
+    * @param q is the vector of new DOF values. 
+    * @param J is the 6xDOF output matrix. 
+    * @return true/false on success/failure (e.g. DOF==0). 
+    * @see getGeoJacobian 
+    */
+    bool getGeoJacobian(const yarp::sig::Vector &q, yarp::sig::Matrix &J);
+
+    /**
+    * Retrieves the rigid roto-translation matrix from the root 
+    * reference frame to the end-effector frame computed in q, 
+    * without changing the chain. 
+    * @param q is the vector of DOF values (the ones it lacks are 
+    *          taken from the current configuration, the joint
+    *          limits are applied as setAng() would do).
+    * @param ws is the scratch storage of the calling thread. 
+    * @param H is the 4x4 output matrix. 
+    * @return true/false on success/failure (e.g. DOF==0). 
+    *  
+    * @note The const methods taking a workspace neither change the 
+    *       chain nor its cached quantities, hence any number of
+    *       threads can call them on the same chain at the same
+    *       time, each one with its own workspace, as long as no
+    *       thread modifies the chain meanwhile (e.g. through
+    *       setAng(), setH0(), blockLink(), ...). No memory
+    *       allocation takes place once the workspace and the
+    *       output have been sized by a previous call.
+    */
+    bool getH(const yarp::sig::Vector &q, iKinChainWorkspace &ws,
+              yarp::sig::Matrix &H) const;
+
+    /**
+    * Retrieves the coordinates of end-effector computed in q, 
+    * without changing the chain. 
+    * @param q is the vector of DOF values. 
+    * @param ws is the scratch storage of the calling thread. 
+    * @param pose is the output vector (7x1 with axis/angle 
+    *             notation, 6x1 with Euler Angles).
+    * @param axisRep if true returns the axis/angle notation. 
+    * @return true/false on success/failure (e.g. DOF==0). 
+    * @see getH(const yarp::sig::Vector&,iKinChainWorkspace&,yarp::sig::Matrix&)
+    */
+    bool getEndEffPose(const yarp::sig::Vector &q, iKinChainWorkspace &ws,
+                       yarp::sig::Vector &pose, const bool axisRep=true) const;
+
+    /**
+    * Retrieves the geometric Jacobian of the end-effector computed 
+    * in q, without changing the chain. 
+    * @param q is the vector of DOF values. 
+    * @param ws is the scratch storage of the calling thread. 
+    * @param J is the 6xDOF output matrix. 
+    * @return true/false on success/failure (e.g. DOF==0). 
+    * @see getH(const yarp::sig::Vector&,iKinChainWorkspace&,yarp::sig::Matrix&)
+    */
+    bool getGeoJacobian(const yarp::sig::Vector &q, iKinChainWorkspace &ws,
+                        yarp::sig::Matrix &J) const;
+
     /**
     * Returns the 6x1 vector \f$ 
     * \partial{^2}F\left(q\right)/\partial q_i \partial q_j, \f$
@@ -789,6 +1004,30 @@ public:
     */
     yarp::sig::Vector fastHessian_ij(const unsigned int i, const unsigned int j);
 
+    /**
+    * Computes the whole 6xDOFxDOF Hessian tensor of the forward 
+    * kinematics in one sweep. 
+    * @param H is the output list of DOF 6xDOF matrices, where 
+    *          H[k] is the derivative of the geometric Jacobian with
+    *          respect to the kth DOF, i.e. its ith column is \f$
+    *          \partial{^2}F\left(q\right)/\partial q_k \partial
+    *          q_i. \f$ (the same as fastHessian_ij(k,i)).
+    * @return true/false on success/failure.
+    * @note Storage in H is reused if already of the right size.
+    */
+    bool Hessian(std::deque<yarp::sig::Matrix> &H);
+
+    /**
+    * Computes the whole Hessian tensor of the forward kinematics. 
+    * <i>Fast Version</i>: to be used in conjunction with 
+    * prepareForHessian(). 
+    * @param H is the output list of DOF 6xDOF matrices.
+    * @return true/false on success/failure.
+    * @see Hessian 
+    * @see prepareForHessian
+    */
+    bool fastHessian(std::deque<yarp::sig::Matrix> &H);
+
     /**
     * Returns the 6x1 vector \f$ 
     * \partial{^2}F\left(q\right)/\partial q_i \partial q_j, \f$
@@ -846,13 +1085,24 @@ public:
     */
     yarp::sig::Matrix DJacobian(const yarp::sig::Vector &dq);
 
+    /**
+    * Computes the time derivative of the geometric Jacobian in 
+    * O(DOF) operations, without allocating memory. 
+    * @param dq the joint velocities.
+    * @param dJ the 6xDOF output matrix (storage is reused if 
+    *           already of the right size).
+    * @return true/false on success/failure.
+    * @see DJacobian
+    */
+    bool getDJacobian(const yarp::sig::Vector &dq, yarp::sig::Matrix &dJ);
+
     /**
     * Compute the time derivative of the geometric Jacobian
     * (link version).
     * @param lnk is the Link number up to which consider the 
     *            computation. 
-    * @param dq the (lnk-1)x1 joint velocity vector.
-    * @return the 6x(lnk-1) matrix \f$ 
+    * @param dq the (lnk+1)x1 joint velocity vector.
+    * @return the 6x(lnk+1) matrix \f$ 
     *         \partial{^2}F\left(q\right)/\partial t \partial q.
     *                 \f$
     */
@@ -1340,6 +1590,144 @@ public:
 };
 
 
+/**
+* \ingroup iKinFwd
+*
+* A class for evaluating at once the fingertips of an iCub hand. \n
+* It holds the iCubArm and the five iCubFinger objects of the 
+* hand: the frame of the palm is computed once from the arm 
+* encoders, then all the fingertips (and, on request, their 
+* Jacobians) are derived from it. The outcomes are relative to 
+* the root reference frame of the arm. 
+*  
+* @note The angles of the links are never changed, thus the 
+*       torso, if released, is taken at the current angles of
+*       the arm links. Once the first computation is done, no
+*       further memory is allocated.
+*/
+class iCubHand
+{
+protected:
+    iCubArm    arm;
+    iCubFinger fingers[5];
+
+    iKinChainWorkspace armWs;
+    iKinChainWorkspace fingersWs[5];
+
+    yarp::sig::Vector qArm;
+    yarp::sig::Vector qFinger;
+    yarp::sig::Matrix Hpalm;
+    yarp::sig::Matrix Hfinger;
+    yarp::sig::Matrix Jarm;
+    yarp::sig::Matrix Jfinger;
+    yarp::sig::Vector tips[5];
+    yarp::sig::Matrix jacobians[5];
+
+    void allocate(const std::string &_type, const std::string &thumbVersion);
+    bool computeFingertips(const yarp::sig::Vector &motorEncoders,
+                           const yarp::sig::Vector *jointEncoders,
+                           const yarp::sig::Matrix &jointEncodersBounds,
+                           const bool wantJacobians);
+
+public:
+    /**
+    * Default constructor. 
+    */
+    iCubHand();
+
+    /**
+    * Constructor. 
+    * @param _type is the type of the arm, as for iCubArm, e.g. 
+    *              "left" or "right_v2".
+    * @param thumbVersion is the version of the thumb, as for 
+    *                     iCubFinger ("a"|"b").
+    */
+    iCubHand(const std::string &_type, const std::string &thumbVersion="b");
+
+    /**
+    * Returns the arm of the hand, e.g. to release the torso links 
+    * or to set their angles.
+    * @return a reference to the iCubArm.
+    */
+    iCubArm &getArm() { return arm; }
+
+    /**
+    * Returns a finger of the hand.
+    * @param i is the finger in the order thumb, index, middle, 
+    *          ring and little.
+    * @return a reference to the iCubFinger.
+    */
+    iCubFinger &getFinger(const unsigned int i) { return fingers[i<5?i:4]; }
+
+    /**
+    * Alignes the joints bounds of the arm and of the fingers with 
+    * current values set aboard the iCub. 
+    * @param lim is the ordered list of control interfaces that 
+    *            allows to access the Torso and the Arm limits.
+    * @return true/false on success/failure. 
+    */
+    bool alignJointsBounds(const std::deque<yarp::dev::IControlLimits*> &lim);
+
+    /**
+    * Computes the palm frame and the position of all the 
+    * fingertips from the motor encoders. 
+    * @param motorEncoders the 16 motor encoders of the arm, in 
+    *                      degrees.
+    * @param wantJacobians if true, the Jacobians of the fingertips
+    *                      are computed as well.
+    * @return true/false on success/failure. 
+    */
+    bool computeFingertips(const yarp::sig::Vector &motorEncoders,
+                           const bool wantJacobians=false);
+
+    /**
+    * Computes the palm frame and the position of all the 
+    * fingertips from the motor encoders and the joint encoders of 
+    * the hand, as for iCubFinger::getChainJoints(). 
+    * @param motorEncoders the 16 motor encoders of the arm, in 
+    *                      degrees.
+    * @param jointEncoders the 15 analog joint encoders of the 
+    *                      hand.
+    * @param wantJacobians if true, the Jacobians of the fingertips
+    *                      are computed as well.
+    * @param jointEncodersBounds the 15-by-2 calibration bounds of 
+    *                            the analog readings.
+    * @return true/false on success/failure. 
+    */
+    bool computeFingertips(const yarp::sig::Vector &motorEncoders,
+                           const yarp::sig::Vector &jointEncoders,
+                           const bool wantJacobians=false,
+                           const yarp::sig::Matrix &jointEncodersBounds=yarp::math::zeros(1,2));
+
+    /**
+    * Returns the rigid roto-translation matrix of the palm, as 
+    * given by the last computation. 
+    * @return the 4x4 palm frame. 
+    */
+    const yarp::sig::Matrix &getPalmH() const { return Hpalm; }
+
+    /**
+    * Returns the position of a fingertip, as given by the last 
+    * computation. 
+    * @param i is the finger in the order thumb, index, middle, 
+    *          ring and little.
+    * @return the 3x1 position. 
+    */
+    const yarp::sig::Vector &getFingertip(const unsigned int i) const { return tips[i<5?i:4]; }
+
+    /**
+    * Returns the geometric Jacobian of a fingertip, as given by 
+    * the last computation done with the Jacobians. 
+    * @param i is the finger in the order thumb, index, middle, 
+    *          ring and little.
+    * @return the 6x(n+m) Jacobian, whose first n columns account 
+    *         for the DOF of the arm and the last m for the DOF of
+    *         the finger.
+    */
+    const yarp::sig::Matrix &getFingertipJacobian(const unsigned int i) const { return jacobians[i<5?i:4]; }
+};
+
+
 /**
 * \ingroup iKinFwd
 *
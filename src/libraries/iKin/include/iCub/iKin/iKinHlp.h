@@ -25,8 +25,12 @@
 #define __IKINHLP_H__
 
 #define IKIN_ALMOST_ZERO    1e-6
+#define IKIN_STATE_VER      1.0
+
+#include <deque>
 
 #include <yarp/os/Bottle.h>
+#include <yarp/os/Stamp.h>
 #include <yarp/sig/all.h>
 
 #include <iCub/iKin/iKinFwd.h>
@@ -48,8 +52,12 @@ class CartesianHelper
 {
 protected:
     static void addVectorOption(yarp::os::Bottle &b, const int vcb, const yarp::sig::Vector &v);
+    static void addVectorsOption(yarp::os::Bottle &b, const int vcb,
+                                 const std::deque<yarp::sig::Vector> &v);
     static bool getDesiredOption(const yarp::os::Bottle &reply, yarp::sig::Vector &xdhat,
                                  yarp::sig::Vector &odhat, yarp::sig::Vector &qdhat);
+    static bool getDesiredOption(const yarp::os::Bottle &reply, std::deque<yarp::sig::Vector> &xdhat,
+                                 std::deque<yarp::sig::Vector> &odhat, std::deque<yarp::sig::Vector> &qdhat);
 
 public:
     /**
@@ -59,6 +67,14 @@ public:
     */
     static void addTargetOption(yarp::os::Bottle &b, const yarp::sig::Vector &xd);
 
+    /**
+    * Appends to a bottle all data needed to ask for a batch of 
+    * targets, which are solved independently of each other. 
+    * @param b is the bottle where to append the data.
+    * @param xd is the list of targets [7-components vectors].
+    */
+    static void addTargetsOption(yarp::os::Bottle &b, const std::deque<yarp::sig::Vector> &xd);
+
     /**
     * Appends to a bottle all data needed to reconfigure chain's 
     * dof. 
@@ -117,6 +133,14 @@ public:
     */
     static yarp::os::Bottle *getTargetOption(const yarp::os::Bottle &b);
 
+    /**
+    * Retrieves the batch of targets data from a bottle.
+    * @param b is the bottle containing the data to be retrieved.
+    * @return a pointer to the sub-bottle containing one list per 
+    *         target.
+    */
+    static yarp::os::Bottle *getTargetsOption(const yarp::os::Bottle &b);
+
     /**
     * Retrieves the end-effector pose data.
     * @param b is the bottle containing the data to be retrieved.
@@ -169,6 +193,187 @@ public:
     */
     static bool computeFixationPointData(iKinChain &eyeL, iKinChain &eyeR,
                                          yarp::sig::Vector &fp, yarp::sig::Matrix &J);
+
+    /**
+    * Packs a list of fields in one vector, as streamed out once per
+    * cycle by the controllers to publish their state. The layout is 
+    * [ver n len_0 ... len_(n-1) field_0 ... field_(n-1)]. 
+    * @param fields the list of fields. 
+    * @param state the Vector where to store the packed fields. 
+    */
+    static void packState(const std::deque<yarp::sig::Vector> &fields,
+                          yarp::sig::Vector &state);
+
+    /**
+    * Unpacks a list of fields packed by packState(). 
+    * @param state the packed fields. 
+    * @param fields the list where to store the fields. 
+    * @return true iff the version and the layout are consistent.
+    */
+    static bool unpackState(const yarp::sig::Vector &state,
+                            std::deque<yarp::sig::Vector> &fields);
+};
+
+
+/**
+* \ingroup iKinHlp
+*
+* Interface exposed by the Cartesian Controllers to solve a
+* batch of inverse kinematics queries within one request; 
+* it can be retrieved from the client device through 
+* yarp::dev::PolyDriver::view(). 
+*/
+class ICartesianBatchQuery
+{
+public:
+    /**
+    * Asks for the inverse kinematics of a list of full poses, 
+    * which are solved independently of each other (in parallel 
+    * if the solver has been configured for it). 
+    * @param q0 the starting joints configuration in [deg]; if 
+    *           empty, the current configuration is used.
+    * @param xd the list of desired positions. 
+    * @param od the list of desired orientations (axis-angle), 
+    *           as long as xd.
+    * @param xdhat the list where to store the reachable 
+    *              positions.
+    * @param odhat the list where to store the reachable 
+    *              orientations.
+    * @param qdhat the list where to store the joints 
+    *              configurations in [deg].
+    * @return true/false on success/failure.
+    */
+    virtual bool askForPoses(const yarp::sig::Vector &q0,
+                             const std::deque<yarp::sig::Vector> &xd,
+                             const std::deque<yarp::sig::Vector> &od,
+                             std::deque<yarp::sig::Vector> &xdhat,
+                             std::deque<yarp::sig::Vector> &odhat,
+                             std::deque<yarp::sig::Vector> &qdhat)=0;
+
+    /**
+    * Asks for the inverse kinematics of a list of positions, 
+    * which are solved independently of each other. 
+    * @param q0 the starting joints configuration in [deg]; if 
+    *           empty, the current configuration is used.
+    * @param xd the list of desired positions. 
+    * @param xdhat the list where to store the reachable 
+    *              positions.
+    * @param odhat the list where to store the reachable 
+    *              orientations.
+    * @param qdhat the list where to store the joints 
+    *              configurations in [deg].
+    * @return true/false on success/failure.
+    */
+    virtual bool askForPositions(const yarp::sig::Vector &q0,
+                                 const std::deque<yarp::sig::Vector> &xd,
+                                 std::deque<yarp::sig::Vector> &xdhat,
+                                 std::deque<yarp::sig::Vector> &odhat,
+                                 std::deque<yarp::sig::Vector> &qdhat)=0;
+
+    /**
+    * Destructor.
+    */
+    virtual ~ICartesianBatchQuery() { }
+};
+
+
+/**
+* \ingroup iKinHlp
+*
+* Interface exposed by the Gaze Controller client to project and 
+* triangulate a batch of points within one request, using the 
+* same eyes configuration for all of them; it can be retrieved 
+* from the client device through yarp::dev::PolyDriver::view(). 
+*/
+class IGazeBatchQuery
+{
+public:
+    /**
+    * Projects a list of 3D points onto the image plane.
+    * @param camSel selects the image plane: 0 for the left, 1 for 
+    *               the right.
+    * @param x the points wrt the root frame, one point per row 
+    *          [N x 3].
+    * @param px the Matrix where to store the pixels [N x 2].
+    * @return true/false on success/failure.
+    */
+    virtual bool get2DPixels(const int camSel, const yarp::sig::Matrix &x,
+                             yarp::sig::Matrix &px)=0;
+
+    /**
+    * Retrieves a list of 3D points from their pixels in one image 
+    * plane and their depths in the eye reference frame. 
+    * @param camSel selects the image plane: 0 for the left, 1 for 
+    *               the right.
+    * @param px the pixels, one per row [N x 2].
+    * @param z the depths [N].
+    * @param x the Matrix where to store the points [N x 3].
+    * @return true/false on success/failure.
+    */
+    virtual bool get3DPoints(const int camSel, const yarp::sig::Matrix &px,
+                             const yarp::sig::Vector &z, yarp::sig::Matrix &x)=0;
+
+    /**
+    * Triangulates a list of 3D points from their pixels in the two 
+    * image planes. 
+    * @param pxl the pixels in the left image, one per row [N x 2].
+    * @param pxr the pixels in the right image, one per row [N x 2].
+    * @param x the Matrix where to store the points [N x 3].
+    * @return true/false on success/failure.
+    */
+    virtual bool triangulate3DPoints(const yarp::sig::Matrix &pxl, const yarp::sig::Matrix &pxr,
+                                     yarp::sig::Matrix &x)=0;
+
+    /**
+    * Destructor.
+    */
+    virtual ~IGazeBatchQuery() { }
+};
+
+
+/**
+* \ingroup iKinHlp
+*
+* Interface exposed by the Gaze Controller client to retrieve 
+* the eyes and head poses at past time instants, e.g. at the 
+* stamps of the camera frames, which the server interpolates 
+* from the recent joints feedback; it can be retrieved from the 
+* client device through yarp::dev::PolyDriver::view(). 
+*/
+class IGazePoseHistory
+{
+public:
+    /**
+    * Returns the left eye pose at a given time instant.
+    * @param t the time instant, e.g. the stamp of a frame.
+    * @param x the Vector where to store the position.
+    * @param o the Vector where to store the orientation 
+    *          (axis-angle).
+    * @param stamp the stamp of the returned pose.
+    * @return true/false on success/failure; it fails if t is 
+    *         older than the history retained by the server.
+    */
+    virtual bool getLeftEyePoseAt(const double t, yarp::sig::Vector &x, yarp::sig::Vector &o,
+                                  yarp::os::Stamp *stamp=NULL)=0;
+
+    /**
+    * Returns the right eye pose at a given time instant.
+    * @see getLeftEyePoseAt()
+    */
+    virtual bool getRightEyePoseAt(const double t, yarp::sig::Vector &x, yarp::sig::Vector &o,
+                                   yarp::os::Stamp *stamp=NULL)=0;
+
+    /**
+    * Returns the head-centered pose at a given time instant.
+    * @see getLeftEyePoseAt()
+    */
+    virtual bool getHeadPoseAt(const double t, yarp::sig::Vector &x, yarp::sig::Vector &o,
+                               yarp::os::Stamp *stamp=NULL)=0;
+
+    /**
+    * Destructor.
+    */
+    virtual ~IGazePoseHistory() { }
 };
 
 }
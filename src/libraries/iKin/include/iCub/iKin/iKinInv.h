@@ -240,6 +240,33 @@ public:
                                     const int max_iter=IKINCTRL_DISABLED, const unsigned int verbose=0,
                                     int *exit_code=NULL, bool *exhalt=NULL);
 
+    /**
+    * Anytime version of solve() meant for control loops: performs 
+    * at most n_iter iterations towards the target and returns, 
+    * keeping the state of the algorithm for the next call, so that
+    * the time spent at each tick is bounded. 
+    * @param xd is the End-Effector target Pose to be tracked; a 
+    *           target different from the previous one releases the
+    *           algorithm from the deadLock state.
+    * @param n_iter is the maximum number of iterations performed 
+    *               within the call (1 by default).
+    * @param tol_size as in solve(). 
+    * @param verbose as in solve(); with the default value no 
+    *                message is formatted.
+    * @param exit_code stores the exit code when the call returns 
+    *                  true (NULL by default), one of the following:
+    *                 IKINCTRL_RET_TOLX
+    *                 IKINCTRL_RET_TOLSIZE
+    *                 IKINCTRL_RET_TOLQ
+    * @return true as soon as the algorithm has terminated, false if
+    *         it is still running.
+    * @note Unlike solve(), this method can be called again once 
+    *       terminated, e.g. to track a moving target.
+    */
+    virtual bool step(yarp::sig::Vector &xd, const int n_iter=1,
+                      const double tol_size=IKINCTRL_DISABLED,
+                      const unsigned int verbose=0, int *exit_code=NULL);
+
     /**
     * Tests convergence by comparing the size of the algorithm 
     * internal structure (may be the gradient norm or the simplex
@@ -802,6 +829,8 @@ protected:
     virtual yarp::sig::Vector iterate(yarp::sig::Vector&, const unsigned int)    { return yarp::sig::Vector(0); }
     virtual yarp::sig::Vector solve(yarp::sig::Vector&, const double,
                                     const int, const unsigned int, int*, bool *) { return yarp::sig::Vector(0); }
+    virtual bool step(yarp::sig::Vector&, const int, const double,
+                      const unsigned int, int*)                                  { return false; }
 
 public:
     /**
@@ -26,6 +26,11 @@
 #ifndef __IKINIPOPT_H__
 #define __IKINIPOPT_H__
 
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <unordered_map>
+
 #include <iCub/iKin/iKinInv.h>
 
 
@@ -167,6 +172,11 @@ public:
 * \ingroup iKinIpOpt
 *
 * Class for dealing with additional iCub arm's constraints
+*  
+* @note The constraints depend only on the hardware version, on 
+*       the blocked/released status of the torso and arm links and
+*       on the representations of the infinities, thus update()
+*       rebuilds them only when one of these has changed.
 */
 class iCubAdditionalArmConstraints : public iKinLinIneqConstr
 {
@@ -177,6 +187,12 @@ protected:
     iKinChain *chain;
     double     hw_version;
 
+    bool       cached;
+    bool       cachedActive;
+    int        cachedBlocked;
+    double     cachedLowerBoundInf;
+    double     cachedUpperBoundInf;
+
     void clone(const iKinLinIneqConstr *obj);
 
 public:
@@ -190,6 +206,90 @@ public:
 };
 
 
+/**
+* \ingroup iKinIpOpt
+*
+* Class for caching the solutions found by the optimizer, indexed
+* by the target position through a voxel hash, so that targets
+* close to previously solved ones are given a good initial guess.
+*
+* The cache keeps track of the chain's structure (blocked links
+* and joints bounds) and gets invalidated as soon as it changes. 
+*  
+* @note The object is thread-safe, therefore it can be shared 
+*       among different optimizers working on chains with the same
+*       structure.
+*/
+class iKinSolutionCache
+{
+protected:
+    struct Entry
+    {
+        yarp::sig::Vector xd;
+        yarp::sig::Vector qd;
+    };
+
+    std::unordered_map<unsigned long long,std::deque<Entry>> voxels;
+    std::deque<unsigned long long> history;
+    yarp::sig::Vector signature;
+    std::mutex mtx;
+
+    double voxelSize;
+    double maxAngle;
+    size_t maxEntries;
+
+    unsigned long long getKey(const long ix, const long iy, const long iz) const;
+    void checkStructure(iKinChain &chain);
+
+public:
+    /**
+    * Constructor. 
+    * @param _voxelSize is the size of the voxels [m]; a cached 
+    *                   solution is retrieved only if its target
+    *                   is closer than this distance.
+    * @param _maxAngle is the maximum orientation distance [rad] 
+    *                  between targets for full-pose problems.
+    * @param _maxEntries is the maximum number of solutions stored; 
+    *                    the oldest ones are discarded first.
+    */
+    iKinSolutionCache(const double _voxelSize=0.02,
+                      const double _maxAngle=30.0*iCub::ctrl::CTRL_DEG2RAD,
+                      const size_t _maxEntries=1000);
+
+    /**
+    * Retrieves the solution of the closest cached target. 
+    * @param chain is the chain the problem refers to.
+    * @param xd is the target pose. 
+    * @param ctrlPose is the pose control settings (targets are 
+    *                 never retrieved for IKINCTRL_POSE_ANG).
+    * @param q0 is filled with the cached solution.
+    * @return true if a solution has been found.
+    */
+    bool lookup(iKinChain &chain, const yarp::sig::Vector &xd,
+                const unsigned int ctrlPose, yarp::sig::Vector &q0);
+
+    /**
+    * Stores a solution in the cache.
+    * @param chain is the chain the problem refers to.
+    * @param xd is the target pose.
+    * @param qd is the solution.
+    */
+    void insert(iKinChain &chain, const yarp::sig::Vector &xd,
+                const yarp::sig::Vector &qd);
+
+    /**
+    * Removes all the stored solutions.
+    */
+    void clear();
+
+    /**
+    * Returns the number of stored solutions.
+    * @return the number of stored solutions.
+    */
+    size_t size();
+};
+
+
 /**
 * \ingroup iKinIpOpt
 *
@@ -214,6 +314,8 @@ protected:
     iKinLinIneqConstr  noLIC;
     iKinLinIneqConstr *pLIC;
 
+    iKinSolutionCache *cache;
+
     unsigned int ctrlPose;    
 
     double obj_scaling;
@@ -223,6 +325,12 @@ protected:
     double upperBoundInf;
     std::string posePriority;
 
+    yarp::sig::Vector optimize(const yarp::sig::Vector &q0, yarp::sig::Vector &xd,
+                               double weight2ndTask, yarp::sig::Vector &xd_2nd, yarp::sig::Vector &w_2nd,
+                               double weight3rdTask, yarp::sig::Vector &qd_3rd, yarp::sig::Vector &w_3rd,
+                               int *exit_code, bool *exhalt, const std::atomic<bool> *exhaltShared,
+                               iKinIterateCallback *iterate);
+
 public:
     /**
     * Constructor. 
@@ -295,6 +403,26 @@ public:
     */
     iKinLinIneqConstr &getLIC() { return *pLIC; }
 
+    /**
+    * Attach a iKinSolutionCache object: the cached solution of the 
+    * closest target, if any, is then the initial guess of each 
+    * problem, provided that it lies within 30 degrees (norm in the 
+    * joints space) from the given guess or that no guess of the 
+    * chain size is given; the given guess is used only if the one 
+    * from the cache does not converge. Successful solutions are 
+    * stored back.
+    * @param _cache is the iKinSolutionCache object to attach (NULL 
+    *               detaches the current one).
+    * @see iKinSolutionCache
+    */
+    void attachSolutionCache(iKinSolutionCache *_cache) { cache=_cache; }
+
+    /**
+    * Returns a pointer to the attached solution cache.
+    * @return the attached cache (NULL if none).
+    */
+    iKinSolutionCache *getSolutionCache() { return cache; }
+
     /**
     * Selects the End-Effector of the 2nd task by giving the ordinal
     * number n of last joint pointing at it. 
@@ -376,6 +504,29 @@ public:
     */
     void setHessianOpt(const bool useHessian);
 
+    /**
+    * Returns whether the exact Hessian computation is enabled. 
+    * @return true if Hessian computation is enabled, false if the 
+    *         Quasi-Newton approximation is in use.
+    */
+    bool getHessianOpt() const;
+
+    /**
+    * Selects the linear solver used by IpOpt.
+    * @param linear_solver the name of the solver (e.g. "mumps", 
+    *                      "ma57", "pardiso").
+    * @note The default solver MUMPS is not re-entrant, hence 
+    *       instances running concurrently shall rely on a
+    *       thread-safe solver.
+    */
+    void setLinearSolver(const std::string &linear_solver);
+
+    /**
+    * Returns the name of the linear solver used by IpOpt. 
+    * @return the name of the solver. 
+    */
+    std::string getLinearSolver() const;
+
     /**
     * Enables/disables user scaling factors.
     * @param useUserScaling true if user scaling is enabled. 
@@ -454,6 +605,20 @@ public:
                                     double weight3rdTask, yarp::sig::Vector &qd_3rd, yarp::sig::Vector &w_3rd,
                                     int *exit_code=NULL, bool *exhalt=NULL, iKinIterateCallback *iterate=NULL);
 
+    /**
+    * Executes the IpOpt algorithm trying to converge on target, as 
+    * the method above, with an exit request which may be raised by 
+    * another thread while the solver is running. 
+    * @param exhalt is read at each iteration with acquire semantics; 
+    *               the requester shall store true with release
+    *               semantics.
+    * @return estimated joint angles.
+    */
+    virtual yarp::sig::Vector solve(const yarp::sig::Vector &q0, yarp::sig::Vector &xd,
+                                    double weight2ndTask, yarp::sig::Vector &xd_2nd, yarp::sig::Vector &w_2nd,
+                                    double weight3rdTask, yarp::sig::Vector &qd_3rd, yarp::sig::Vector &w_3rd,
+                                    int *exit_code, const std::atomic<bool> &exhalt, iKinIterateCallback *iterate=NULL);
+
     /**
     * Executes the IpOpt algorithm trying to converge on target. 
     * @param q0 is the vector of initial joint angles values. 
@@ -485,6 +650,124 @@ public:
     virtual ~iKinIpOptMin();
 };
 
+
+/**
+* \ingroup iKinIpOpt
+*
+* Class for inverting the kinematics of two chains which share 
+* their first joints (e.g. the arms, which both comprise the 
+* torso) as one problem, so that the shared joints serve both 
+* End-Effectors at once instead of being contended by two 
+* independent solvers. 
+*  
+* The unknowns are the shared joints followed by the joints owned 
+* by the first chain and then by those owned by the second chain. 
+* The translational parts of the targets are enforced as 
+* constraints, whereas the rotational parts and the rest posture 
+* are minimized. 
+*/
+class iKinBimanualIpOptMin
+{
+private:
+    // Default constructor: not implemented.
+    iKinBimanualIpOptMin();
+    // Copy constructor: not implemented.
+    iKinBimanualIpOptMin(const iKinBimanualIpOptMin&);
+    // Assignment operator: not implemented.
+    iKinBimanualIpOptMin &operator=(const iKinBimanualIpOptMin&);
+
+protected:
+    void *App;
+
+    iKinChain &chain1;
+    iKinChain &chain2;
+    unsigned int nShared;
+
+public:
+    /**
+    * Constructor. 
+    * @param c1 is the first Chain object. 
+    * @param c2 is the second Chain object. 
+    * @param _nShared is the number of leading DOFs shared by the 
+    *                 two chains, which shall be unblocked in both
+    *                 of them. Do not change Chains DOF from this
+    *                 point onwards!!
+    * @param tol        cost function tolerance. 
+    * @param constr_tol constraints tolerance.
+    * @param max_iter   exits if iter>=max_iter (max_iter<0 disables
+    *                   this check, IKINCTRL_DISABLED(==-1) by
+    *                   default).
+    * @param verbose    integer which progressively enables different
+    *                   levels of warning messages or status dump.
+    *                   The larger this value the more detailed the
+    *                   output (0=>off by default).
+    */
+    iKinBimanualIpOptMin(iKinChain &c1, iKinChain &c2, const unsigned int _nShared,
+                         const double tol, const double constr_tol,
+                         const int max_iter=IKINCTRL_DISABLED,
+                         const unsigned int verbose=0);
+
+    /**
+    * Returns the number of unknowns of the problem. 
+    * @return the shared DOFs plus the DOFs owned by either chain. 
+    */
+    unsigned int getDOF() const;
+
+    /**
+    * Sets Maximum Iteration.
+    * @param max_iter exits if iter>=max_iter (max_iter<0 
+    *                 (IKINCTRL_DISABLED) disables this check).
+    */ 
+    void setMaxIter(const int max_iter);
+
+    /**
+    * Sets Maximum CPU seconds.
+    * @param max_cpu_time exits if cpu_time>=max_cpu_time given in 
+    *                     seconds.
+    */
+    void setMaxCpuTime(const double max_cpu_time);
+
+    /**
+    * Executes the IpOpt algorithm trying to converge on both 
+    * targets. 
+    * @param q0 is the vector of initial joint angles values, 
+    *           arranged as the unknowns.
+    * @param xd1 is the target of the first End-Effector: only its 
+    *            position is attained if it has 3 components,
+    *            otherwise it comprises the orientation in
+    *            axis-angle representation.
+    * @param xd2 is the target of the second End-Effector. 
+    * @param weight3rdTask weights the rest posture task (disabled 
+    *                      if 0.0).
+    * @param qd_3rd is the rest posture, arranged as the unknowns. 
+    * @param w_3rd weights each component of the distance vector 
+    *              qd-q.
+    * @param exit_code stores the exit code (NULL by default), as 
+    *                  for iKinIpOptMin::solve().
+    * @return estimated joint angles, arranged as the unknowns.
+    */
+    virtual yarp::sig::Vector solve(const yarp::sig::Vector &q0, yarp::sig::Vector &xd1,
+                                    yarp::sig::Vector &xd2, double weight3rdTask,
+                                    yarp::sig::Vector &qd_3rd, yarp::sig::Vector &w_3rd,
+                                    int *exit_code=NULL);
+
+    /**
+    * Executes the IpOpt algorithm trying to converge on both 
+    * targets. 
+    * @param q0 is the vector of initial joint angles values. 
+    * @param xd1 is the target of the first End-Effector. 
+    * @param xd2 is the target of the second End-Effector. 
+    * @return estimated joint angles.
+    */
+    virtual yarp::sig::Vector solve(const yarp::sig::Vector &q0, yarp::sig::Vector &xd1,
+                                    yarp::sig::Vector &xd2);
+
+    /**
+    * Default destructor.
+    */
+    virtual ~iKinBimanualIpOptMin();
+};
+
 }
 
 }
@@ -178,6 +178,12 @@ given rest
  *    0.001)), [get] [conv]. Set/get the options for specifying
  *    solver's convergence.
  *
+ * \b tele request: example [get] [tele], [set] [tele] reset.
+ *    Get/clear the timing statistics of the solver thread (see
+ *    iCub::ctrl::CycleTelemetry), which separate the time spent
+ *    within the optimizer ("ipopt") from the forward kinematics
+ *    ("fk") and the ports and encoders I/O ("io").
+ *
  * Commands issued through the [ask] vocab:
  *
  * \b xd request: example [ask] ([xd] (x y z ax ay az theta))
@@ -188,6 +194,14 @@ given rest
  *    found configuration q is returned as well as the final
  *    attained pose x.
  *
+ * \b xds request: example [ask] ([xds] ((x y z ...) (x y z ...)))
+ *    ([pose] [xyz]) ([q] (...)). Ask to solve for a batch of
+ *    targets, each one independently from the same starting
+ *    configuration. The targets are distributed over the
+ *    parallel optimizers (see the batch_workers option). The
+ *    reply will contain [ack] ([x] ((...) (...))) ([q] ((...)
+ *    (...))), with one pose and one configuration per target.
+ *
  * Commands concerning the thread status:
  *
  * \b susp request: example [susp], suspend the thread.
@@ -239,8 +253,11 @@ given rest
 
 #include <mutex>
 #include <condition_variable>
+#include <thread>
+#include <functional>
 #include <string>
 #include <deque>
+#include <map>
 
 #include <yarp/os/BufferedPort.h>
 #include <yarp/os/PeriodicThread.h>
@@ -250,6 +267,7 @@ given rest
 #include <yarp/dev/ControlBoardInterfaces.h>
 #include <yarp/dev/PolyDriver.h>
 
+#include <iCub/ctrl/telemetry.h>
 #include <iCub/iKin/iKinHlp.h>
 #include <iCub/iKin/iKinIpOpt.h>
 
@@ -310,6 +328,8 @@ public:
     bool handleDOF(yarp::os::Bottle *b);
     bool handlePose(const int newPose);
     bool handleMode(const int newMode);    
+
+    friend class CartesianSolver;
 };
 
 
@@ -325,6 +345,31 @@ public:
 };
 
 
+/**
+* \ingroup iKinSlv
+*
+* Class to be inherited in order to receive the solutions directly 
+* from a solver hosted in the same process, rather than reading 
+* them from the port /<solverName>/out. 
+*/
+class CartesianSolverReceiver
+{
+public:
+    /**
+    * Called by the solver's thread each time a solution is 
+    * available. 
+    * @param b contains the solution, formatted as the content 
+    *          streamed out on the port /<solverName>/out.
+    */
+    virtual void onSolution(const yarp::os::Bottle &b)=0;
+
+    /**
+    * Default destructor.
+    */
+    virtual ~CartesianSolverReceiver() { }
+};
+
+
 struct PartDescriptor
 {
     iKinLimb                      *lmb;
@@ -336,6 +381,42 @@ struct PartDescriptor
 };
 
 
+// One optimization instance along with the persistent thread
+// that runs the jobs posted to it
+struct MultiStartWorker
+{
+    iKinLimb          *lmb;
+    iKinLinIneqConstr *cns;
+    iKinIpOptMin      *slv;
+    yarp::sig::Vector  q0;
+    yarp::sig::Vector  xd;
+    yarp::sig::Vector  qd;
+    int                exit_code;
+
+    std::thread             thr;
+    std::mutex              mtx;
+    std::condition_variable cv;
+    std::function<void()>   job;
+    bool                    busy;
+    bool                    quit;
+
+    void start();
+    void post(const std::function<void()> &_job);
+    void stop();
+
+private:
+    void loop();
+};
+
+
+// The solutions retained for one dof configuration
+struct DOFContext
+{
+    iKinSolutionCache            *cache;
+    std::deque<yarp::sig::Vector> msPool;
+};
+
+
 /**
 * \ingroup iKinSlv
 *
@@ -352,8 +433,29 @@ protected:
     std::deque<int>                        jnt;
     std::deque<int*>                       rmp;
 
-    iKinIpOptMin   *slv;
-    SolverCallback *clb;
+    iKinIpOptMin      *slv;
+    SolverCallback    *clb;
+    iKinSolutionCache *cache;
+
+    CartesianSolverReceiver *receiver;
+
+    std::deque<MultiStartWorker*> msWorkers;
+    std::deque<MultiStartWorker*> batchWorkers;
+    std::deque<yarp::sig::Vector> msPool;
+    double                        msDeadline;
+    std::mutex                    mtx_linSolver;
+    bool                          linSolverSerial;
+
+    std::map<std::string,DOFContext> dofContexts;
+    std::deque<std::string>          dofContextsLRU;
+    std::string                      dofKey;
+    size_t                           cacheSize;
+    double                           cacheVoxel;
+
+    iCub::ctrl::CycleTelemetry telemetry;
+    int                        tmSectionIpOpt;
+    int                        tmSectionFk;
+    int                        tmSectionIO;
 
     RpcProcessor                             *cmdProcessor;
     yarp::os::Port                           *rpcPort;
@@ -400,6 +502,9 @@ protected:
 
     virtual PartDescriptor *getPartDesc(yarp::os::Searchable &options)=0;
     virtual yarp::sig::Vector solve(yarp::sig::Vector &xd);
+    virtual yarp::sig::Vector solveMultiStart(yarp::sig::Vector &xd);
+    virtual void solveBatch(const std::deque<yarp::sig::Vector> &xd,
+                            std::deque<yarp::sig::Vector> &qd);
 
     virtual yarp::sig::Vector &encodeDOF();
     virtual bool decodeDOF(const yarp::sig::Vector &_dof);
@@ -413,8 +518,16 @@ protected:
     
     bool isNewDOF(const yarp::sig::Vector &_dof);
     bool changeDOF(const yarp::sig::Vector &_dof);
+    void switchDOFContext();
+    void disposeDOFContexts();
 
     bool alignJointsBounds();
+    MultiStartWorker *allocWorker(const double tol, const double constr_tol,
+                                  const int maxIter);
+    void allocMultiStart(const int nSeeds, const double tol,
+                         const double constr_tol, const int maxIter);
+    void alignMultiStartWorker(MultiStartWorker &w);
+    void disposeMultiStart();
     bool setLimits(int axis, double min, double max);
     void countUncontrolledJoints();
     void latchUncontrolledJoints(yarp::sig::Vector &joints);
@@ -516,6 +629,11 @@ public:
     * \b maxIter <int>: example (maxIter 200), specifies the maximum
     *    number of iterations allowed for one optimization instance.
     *  
+    * \b exact_hessian <vocab>: example (exact_hessian off), selects
+    *    whether the optimizer relies on the exact Hessian of the
+    *    problem [on] (default) or on its Quasi-Newton approximation
+    *    [off].
+    *  
     * \b interPoints <vocab>: example (interPoints on), selects 
     *    whether to force or not the solver to output on the port
     *    all intermediate points of optimization instance; allowed
@@ -526,6 +644,53 @@ public:
     *    ports are pinged prior to connecting; a timeout equal to
     *    zero disables this option.
     *  
+    * \b multistart <int>: example (multistart 4), specifies the
+    *    number of optimization instances run in parallel from
+    *    different seeds (current configuration, cached solution,
+    *    last solutions and rest posture) for each request; a value
+    *    of 1 (default) disables this option. The instances are
+    *    halted as soon as one has converged and the one of the
+    *    current configuration has finished; among the converged
+    *    solutions the closest to the current configuration is
+    *    retained; intermediate points are not streamed in this
+    *    mode. The instances are kept in a pool of threads that
+    *    wake up on each request and solve in parallel only if the
+    *    linear solver is thread-safe (see linear_solver).
+    *  
+    * \b multistart_deadline <double>: example (multistart_deadline
+    *    0.05), specifies in seconds the maximum time the parallel
+    *    instances are given to converge, after which they are
+    *    halted and the best solution achieved so far is retained; a
+    *    value equal to zero (default) disables the deadline.
+    *  
+    * \b batch_workers <int>: example (batch_workers 4), specifies
+    *    the number of optimization instances dedicated to the
+    *    batches of [ask] requests; if zero (default), the batches
+    *    are shared among the multistart instances, if any, or
+    *    solved one target after the other otherwise.
+    *  
+    * \b linear_solver <string>: example (linear_solver ma57),
+    *    selects the linear solver used by IpOpt; if not given, the
+    *    IpOpt default is retained. The parallel instances of the
+    *    multistart and batch_workers options run concurrently only
+    *    with a thread-safe solver among ma27, ma57, ma77, ma86,
+    *    ma97, pardiso, pardisomkl and spral; otherwise, as with the
+    *    default MUMPS, which is not re-entrant, their calls to
+    *    IpOpt are serialized.
+    *  
+    * \b cache_size <int>: example (cache_size 1000), specifies the
+    *    maximum number of solutions stored to provide the initial
+    *    guess to requests whose target is close to a previously
+    *    solved one; a value equal to zero (default) disables the
+    *    cache. A separate cache is retained for each of the dof
+    *    configurations used most recently, so that switching the
+    *    dof back and forth preserves the solutions, whereas the
+    *    cache is flushed whenever the joints bounds change.
+    *  
+    * \b cache_voxel <double>: example (cache_voxel 0.02),
+    *    specifies in meters the distance within which a cached
+    *    target is considered close to the requested one.
+    *  
     * @return true/false if successful/failed
     */
     virtual bool open(yarp::os::Searchable &options);
@@ -558,6 +723,35 @@ public:
     */
     virtual bool &getTimeoutFlag() { return timeout_detected; }
 
+    /**
+    * Send a request to the solver by means of a direct call, as if 
+    * it was received on the port /<solverName>/in. 
+    * @param b contains the request. 
+    * @return true/false on success/failure. 
+    *  
+    * @note Intended to be used along with setReceiver() when the 
+    *       solver is hosted in the same process of the client,
+    *       which saves the ports round trips.
+    */
+    virtual bool sendRequest(yarp::os::Bottle &b);
+
+    /**
+    * Send a command to the solver by means of a direct call, as if 
+    * it was received on the port /<solverName>/rpc. 
+    * @param command contains the command. 
+    * @param reply is filled with the reply. 
+    * @return true/false on success/failure. 
+    */
+    virtual bool sendCommand(const yarp::os::Bottle &command, yarp::os::Bottle &reply);
+
+    /**
+    * Register the object receiving the solutions by means of 
+    * direct calls. The port /<solverName>/out keeps streaming the 
+    * solutions only if someone is connected to it. 
+    * @param r the receiver; NULL to detach it. 
+    */
+    virtual void setReceiver(CartesianSolverReceiver *r);
+
     /**
     * Suspend the solver's main loop.
     */
@@ -28,6 +28,7 @@
 #define IKINSLV_VOCAB_OPT_DOF           yarp::os::createVocab32('d','o','f')
 #define IKINSLV_VOCAB_OPT_LIM           yarp::os::createVocab32('l','i','m')
 #define IKINSLV_VOCAB_OPT_XD            yarp::os::createVocab32('x','d')
+#define IKINSLV_VOCAB_OPT_XDS           yarp::os::createVocab32('x','d','s')
 #define IKINSLV_VOCAB_OPT_X             yarp::os::createVocab32('x')
 #define IKINSLV_VOCAB_OPT_Q             yarp::os::createVocab32('q')
 #define IKINSLV_VOCAB_OPT_TOKEN         yarp::os::createVocab32('t','o','k')
@@ -37,6 +38,7 @@
 #define IKINSLV_VOCAB_OPT_TIP_FRAME     yarp::os::createVocab32('t','i','p')
 #define IKINSLV_VOCAB_OPT_TASK2         yarp::os::createVocab32('t','s','k','2')
 #define IKINSLV_VOCAB_OPT_CONVERGENCE   yarp::os::createVocab32('c','o','n','v')
+#define IKINSLV_VOCAB_OPT_TELEMETRY     yarp::os::createVocab32('t','e','l','e')
 #define IKINSLV_VOCAB_VAL_POSE_FULL     yarp::os::createVocab32('f','u','l','l')
 #define IKINSLV_VOCAB_VAL_POSE_XYZ      yarp::os::createVocab32('x','y','z')
 #define IKINSLV_VOCAB_VAL_PRIO_XYZ      yarp::os::createVocab32('x','y','z')
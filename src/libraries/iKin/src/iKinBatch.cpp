@@ -0,0 +1,389 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms
+ * of the BSD-3-Clause license. See the accompanying LICENSE file for
+ * details.
+*/
+
+#include <cmath>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include <yarp/os/Log.h>
+#include <yarp/math/Math.h>
+
+#include <iCub/iKin/iKinBatch.h>
+
+// number of configurations processed together
+#define IKINBATCH_BLOCK     64
+
+using namespace std;
+using namespace yarp::sig;
+using namespace yarp::math;
+using namespace iCub::iKin;
+
+namespace
+{
+    // 3x4 transformations (the last row is implicitly 0 0 0 1)
+    // stored as structure-of-arrays over the block
+    struct Block
+    {
+        double t[12][IKINBATCH_BLOCK];
+    };
+
+    /************************************************************************/
+    inline void toArray(const Matrix &M, double *a)
+    {
+        for (int r=0; r<3; r++)
+            for (int c=0; c<4; c++)
+                a[4*r+c]=M(r,c);
+    }
+
+    /************************************************************************/
+    inline void setConst(Block &B, const double *a, const int m)
+    {
+        for (int k=0; k<12; k++)
+            std::fill(B.t[k],B.t[k]+m,a[k]);
+    }
+
+    /************************************************************************/
+    inline void mulConst(const Block &A, const double *c, Block &B, const int m)
+    {
+        // B=A*C, with C constant across the block
+        for (int r=0; r<3; r++)
+        {
+            const double *a0=A.t[4*r+0];
+            const double *a1=A.t[4*r+1];
+            const double *a2=A.t[4*r+2];
+            const double *a3=A.t[4*r+3];
+            double *b0=B.t[4*r+0];
+            double *b1=B.t[4*r+1];
+            double *b2=B.t[4*r+2];
+            double *b3=B.t[4*r+3];
+
+            for (int k=0; k<m; k++)
+            {
+                b0[k]=a0[k]*c[0]+a1[k]*c[4]+a2[k]*c[8];
+                b1[k]=a0[k]*c[1]+a1[k]*c[5]+a2[k]*c[9];
+                b2[k]=a0[k]*c[2]+a1[k]*c[6]+a2[k]*c[10];
+                b3[k]=a0[k]*c[3]+a1[k]*c[7]+a2[k]*c[11]+a3[k];
+            }
+        }
+    }
+
+    /************************************************************************/
+    inline void mulDH(const Block &A, const double *ct, const double *st,
+                      const double ca, const double sa, const double a,
+                      const double d, Block &B, const int m)
+    {
+        // B=A*H(theta), exploiting the structure of the DH matrix
+        for (int r=0; r<3; r++)
+        {
+            const double *a0=A.t[4*r+0];
+            const double *a1=A.t[4*r+1];
+            const double *a2=A.t[4*r+2];
+            const double *a3=A.t[4*r+3];
+            double *b0=B.t[4*r+0];
+            double *b1=B.t[4*r+1];
+            double *b2=B.t[4*r+2];
+            double *b3=B.t[4*r+3];
+
+            for (int k=0; k<m; k++)
+            {
+                double c=ct[k];
+                double s=st[k];
+                b0[k]=a0[k]*c+a1[k]*s;
+                b1[k]=(-a0[k]*s+a1[k]*c)*ca+a2[k]*sa;
+                b2[k]=(a0[k]*s-a1[k]*c)*sa+a2[k]*ca;
+                b3[k]=(a0[k]*c+a1[k]*s)*a+a2[k]*d+a3[k];
+            }
+        }
+    }
+}
+
+
+/************************************************************************/
+iKinBatchFwd::iKinBatchFwd() : dof(0)
+{
+    std::fill(H0,H0+12,0.0);
+    H0[0]=H0[5]=H0[10]=1.0;
+    std::copy(H0,H0+12,HN);
+}
+
+
+/************************************************************************/
+iKinBatchFwd::iKinBatchFwd(iKinChain &chain) : iKinBatchFwd()
+{
+    fromChain(chain);
+}
+
+
+/************************************************************************/
+bool iKinBatchFwd::fromChain(iKinChain &chain)
+{
+    links.clear();
+    dof=0;
+
+    if (chain.getDOF()==0)
+        return false;
+
+    toArray(chain.getH0(),H0);
+
+    Matrix pending=eye(4,4);
+    bool isPending=false;
+
+    for (unsigned int i=0; i<chain.getN(); i++)
+    {
+        iKinLink &link=chain[i];
+        if (link.isBlocked())
+        {
+            pending*=link.getH(true);
+            isPending=true;
+            continue;
+        }
+
+        Link l;
+        l.A=link.getA();
+        l.D=link.getD();
+        l.c_alpha=cos(link.getAlpha());
+        l.s_alpha=sin(link.getAlpha());
+        l.Offset=link.getOffset();
+        l.Min=link.getMin();
+        l.Max=link.getMax();
+        l.constrained=link.getConstraint();
+        l.hasPre=isPending;
+        toArray(pending,l.pre);
+        links.push_back(l);
+
+        pending=eye(4,4);
+        isPending=false;
+    }
+
+    toArray(pending*chain.getHN(),HN);
+    dof=(unsigned int)links.size();
+
+    return true;
+}
+
+
+/************************************************************************/
+void iKinBatchFwd::processChunk(const Matrix &Q, const int r0, const int r1,
+                                Matrix *poses, const bool axisRep,
+                                Matrix *jacobians) const
+{
+    const int n=(int)dof;
+
+    // ping-pong buffers
+    Block buf[2];
+    Block *T=&buf[0];
+    Block *tmp=&buf[1];
+    vector<double> q(n*IKINBATCH_BLOCK);
+    vector<double> ct(IKINBATCH_BLOCK),st(IKINBATCH_BLOCK);
+
+    // joint axes and origins in the root frame, needed by the Jacobian
+    vector<double> z((jacobians!=NULL)?3*n*IKINBATCH_BLOCK:0);
+    vector<double> p((jacobians!=NULL)?3*n*IKINBATCH_BLOCK:0);
+
+    for (int b=r0; b<r1; b+=IKINBATCH_BLOCK)
+    {
+        const int m=std::min(IKINBATCH_BLOCK,r1-b);
+
+        // transpose the block of configurations into SoA
+        for (int k=0; k<m; k++)
+        {
+            const double *row=Q[b+k];
+            for (int i=0; i<n; i++)
+            {
+                const Link &l=links[i];
+                double qi=row[i];
+                if (l.constrained)
+                    qi=std::min(std::max(qi,l.Min),l.Max);
+                q[i*IKINBATCH_BLOCK+k]=qi;
+            }
+        }
+
+        setConst(*T,H0,m);
+        for (int i=0; i<n; i++)
+        {
+            const Link &l=links[i];
+            if (l.hasPre)
+            {
+                mulConst(*T,l.pre,*tmp,m);
+                std::swap(T,tmp);
+            }
+
+            if (jacobians!=NULL)
+            {
+                for (int r=0; r<3; r++)
+                {
+                    std::copy(T->t[4*r+2],T->t[4*r+2]+m,&z[(3*i+r)*IKINBATCH_BLOCK]);
+                    std::copy(T->t[4*r+3],T->t[4*r+3]+m,&p[(3*i+r)*IKINBATCH_BLOCK]);
+                }
+            }
+
+            const double *qi=&q[i*IKINBATCH_BLOCK];
+            for (int k=0; k<m; k++)
+            {
+                double theta=qi[k]+l.Offset;
+                ct[k]=cos(theta);
+                st[k]=sin(theta);
+            }
+
+            mulDH(*T,ct.data(),st.data(),l.c_alpha,l.s_alpha,l.A,l.D,*tmp,m);
+            std::swap(T,tmp);
+        }
+
+        mulConst(*T,HN,*tmp,m);
+        const double (&H)[12][IKINBATCH_BLOCK]=tmp->t;
+
+        if (poses!=NULL)
+        {
+            for (int k=0; k<m; k++)
+            {
+                double *x=(*poses)[b+k];
+                x[0]=H[3][k];
+                x[1]=H[7][k];
+                x[2]=H[11][k];
+
+                if (axisRep)
+                {
+                    double ax=H[9][k]-H[6][k];
+                    double ay=H[2][k]-H[8][k];
+                    double az=H[4][k]-H[1][k];
+                    double r=sqrt(ax*ax+ay*ay+az*az);
+
+                    if (r<1e-9)
+                    {
+                        Matrix R(3,3);
+                        for (int i=0; i<3; i++)
+                            for (int j=0; j<3; j++)
+                                R(i,j)=H[4*i+j][k];
+
+                        Vector v=dcm2axis(R);
+                        std::copy(v.begin(),v.end(),x+3);
+                    }
+                    else
+                    {
+                        x[3]=ax/r;
+                        x[4]=ay/r;
+                        x[5]=az/r;
+                        x[6]=atan2(0.5*r,0.5*(H[0][k]+H[5][k]+H[10][k]-1.0));
+                    }
+                }
+                else
+                {
+                    // Euler Angles as XYZ (see dcm2angle.m)
+                    x[3]=atan2(-H[9][k],H[10][k]);
+                    x[4]=asin(H[8][k]);
+                    x[5]=atan2(-H[4][k],H[0][k]);
+                }
+            }
+        }
+
+        if (jacobians!=NULL)
+        {
+            for (int i=0; i<n; i++)
+            {
+                const double *zx=&z[(3*i+0)*IKINBATCH_BLOCK];
+                const double *zy=&z[(3*i+1)*IKINBATCH_BLOCK];
+                const double *zz=&z[(3*i+2)*IKINBATCH_BLOCK];
+                const double *px=&p[(3*i+0)*IKINBATCH_BLOCK];
+                const double *py=&p[(3*i+1)*IKINBATCH_BLOCK];
+                const double *pz=&p[(3*i+2)*IKINBATCH_BLOCK];
+
+                for (int k=0; k<m; k++)
+                {
+                    double dx=H[3][k]-px[k];
+                    double dy=H[7][k]-py[k];
+                    double dz=H[11][k]-pz[k];
+
+                    double *J=(*jacobians)[b+k];
+                    J[0*n+i]=zy[k]*dz-zz[k]*dy;
+                    J[1*n+i]=zz[k]*dx-zx[k]*dz;
+                    J[2*n+i]=zx[k]*dy-zy[k]*dx;
+                    J[3*n+i]=zx[k];
+                    J[4*n+i]=zy[k];
+                    J[5*n+i]=zz[k];
+                }
+            }
+        }
+    }
+}
+
+
+/************************************************************************/
+bool iKinBatchFwd::process(const Matrix &Q, Matrix *poses, const bool axisRep,
+                           Matrix *jacobians, unsigned int nThreads) const
+{
+    if (dof==0)
+    {
+        yError("iKinBatchFwd: chain not configured");
+        return false;
+    }
+
+    if (Q.cols()!=(int)dof)
+    {
+        yError("iKinBatchFwd: wrong number of columns of the joints matrix: %d!=%u",
+               Q.cols(),dof);
+        return false;
+    }
+
+    const int M=Q.rows();
+    if (poses!=NULL)
+        poses->resize(M,axisRep?7:6);
+
+    if (jacobians!=NULL)
+        jacobians->resize(M,6*dof);
+
+    // split rows in chunks of whole blocks
+    const int nBlocks=(M+IKINBATCH_BLOCK-1)/IKINBATCH_BLOCK;
+    nThreads=std::max(1U,std::min(nThreads,(unsigned int)nBlocks));
+
+    if (nThreads==1)
+        processChunk(Q,0,M,poses,axisRep,jacobians);
+    else
+    {
+        const int blocksPerThread=(nBlocks+nThreads-1)/nThreads;
+
+        vector<thread> workers;
+        for (int r0=0; r0<M; r0+=blocksPerThread*IKINBATCH_BLOCK)
+        {
+            int r1=std::min(M,r0+blocksPerThread*IKINBATCH_BLOCK);
+            workers.push_back(thread(&iKinBatchFwd::processChunk,this,std::cref(Q),
+                                     r0,r1,poses,axisRep,jacobians));
+        }
+
+        for (auto &w : workers)
+            w.join();
+    }
+
+    return true;
+}
+
+
+/************************************************************************/
+bool iKinBatchFwd::computeEndEffPoses(const Matrix &Q, Matrix &poses,
+                                      const bool axisRep, unsigned int nThreads) const
+{
+    return process(Q,&poses,axisRep,NULL,nThreads);
+}
+
+
+/************************************************************************/
+bool iKinBatchFwd::computeGeoJacobians(const Matrix &Q, Matrix &jacobians,
+                                       unsigned int nThreads) const
+{
+    return process(Q,NULL,true,&jacobians,nThreads);
+}
+
+
+/************************************************************************/
+bool iKinBatchFwd::compute(const Matrix &Q, Matrix &poses, Matrix &jacobians,
+                           const bool axisRep, unsigned int nThreads) const
+{
+    return process(Q,&poses,axisRep,&jacobians,nThreads);
+}
+
@@ -27,6 +27,133 @@ using namespace iCub::ctrl;
 using namespace iCub::iKin;
 
 
+/************************************************************************/
+inline void mul4x4(const double *a, const double *b, double *c)
+{
+    // c must not alias a or b
+    for (int r=0; r<4; r++, a+=4, c+=4)
+    {
+        c[0]=a[0]*b[0]+a[1]*b[4]+a[2]*b[8] +a[3]*b[12];
+        c[1]=a[0]*b[1]+a[1]*b[5]+a[2]*b[9] +a[3]*b[13];
+        c[2]=a[0]*b[2]+a[1]*b[6]+a[2]*b[10]+a[3]*b[14];
+        c[3]=a[0]*b[3]+a[1]*b[7]+a[2]*b[11]+a[3]*b[15];
+    }
+}
+
+
+/************************************************************************/
+inline void mul4x4(const Matrix &A, const Matrix &B, Matrix &C)
+{
+    mul4x4(A.data(),B.data(),C.data());
+}
+
+
+/************************************************************************/
+inline void mulInPlace4x4(Matrix &A, const Matrix &B, Matrix &tmp)
+{
+    // A=A*B, where tmp is a 4x4 buffer
+    mul4x4(A,B,tmp);
+    A=tmp;
+}
+
+
+/************************************************************************/
+inline void fillPose(const double *h, const bool axisRep, Vector &v)
+{
+    // h is a 4x4 matrix stored row-wise
+    if (v.length()!=(axisRep?7:6))
+        v.resize(axisRep?7:6);
+    v[0]=h[3];
+    v[1]=h[7];
+    v[2]=h[11];
+
+    if (axisRep)
+    {
+        double x=h[9]-h[6];
+        double y=h[2]-h[8];
+        double z=h[4]-h[1];
+        double r=sqrt(x*x+y*y+z*z);
+
+        if (r<1e-9)
+        {
+            // symmetric rotation: rely on the full-fledged conversion
+            Matrix H(4,4);
+            std::copy(h,h+16,H.data());
+            Vector ax=dcm2axis(H);
+            v[3]=ax[0];
+            v[4]=ax[1];
+            v[5]=ax[2];
+            v[6]=ax[3];
+        }
+        else
+        {
+            double ir=1.0/r;
+            v[3]=ir*x;
+            v[4]=ir*y;
+            v[5]=ir*z;
+            v[6]=atan2(0.5*r,0.5*(h[0]+h[5]+h[10]-1.0));
+        }
+    }
+    else
+    {
+        // Euler Angles as XYZ (see dcm2angle.m)
+        v[3]=atan2(-h[9],h[10]);
+        v[4]=asin(h[8]);
+        v[5]=atan2(-h[4],h[0]);
+    }
+}
+
+
+/************************************************************************/
+inline void fillPose(const Matrix &H, const bool axisRep, Vector &v)
+{
+    fillPose(H.data(),axisRep,v);
+}
+
+
+/************************************************************************/
+inline void djacobian(const Matrix &J, const Vector &dq, Matrix &dJ)
+{
+    // given the columns (l_i,z_i) of the geometric Jacobian:
+    // dl_i/dt=w_i x l_i + z_i x v_i and dz_i/dt=w_i x z_i, where
+    // w_i=sum_{j<i} dq_j z_j and v_i=sum_{j>=i} dq_j l_j
+    const int n=J.cols();
+    if ((dJ.rows()!=6) || (dJ.cols()!=n))
+        dJ.resize(6,n);
+
+    // the backward sweep stores v_i in the linear part
+    double vx=0.0, vy=0.0, vz=0.0;
+    for (int i=n-1; i>=0; i--)
+    {
+        vx+=dq[i]*J(0,i);
+        vy+=dq[i]*J(1,i);
+        vz+=dq[i]*J(2,i);
+        dJ(0,i)=vx;
+        dJ(1,i)=vy;
+        dJ(2,i)=vz;
+    }
+
+    double wx=0.0, wy=0.0, wz=0.0;
+    for (int i=0; i<n; i++)
+    {
+        double lx=J(0,i), ly=J(1,i), lz=J(2,i);
+        double zx=J(3,i), zy=J(4,i), zz=J(5,i);
+        vx=dJ(0,i); vy=dJ(1,i); vz=dJ(2,i);
+
+        dJ(0,i)=wy*lz-wz*ly+zy*vz-zz*vy;
+        dJ(1,i)=wz*lx-wx*lz+zz*vx-zx*vz;
+        dJ(2,i)=wx*ly-wy*lx+zx*vy-zy*vx;
+        dJ(3,i)=wy*zz-wz*zy;
+        dJ(4,i)=wz*zx-wx*zz;
+        dJ(5,i)=wx*zy-wy*zx;
+
+        wx+=dq[i]*zx;
+        wy+=dq[i]*zy;
+        wz+=dq[i]*zz;
+    }
+}
+
+
 /************************************************************************/
 void iCub::iKin::notImplemented(const unsigned int verbose)
 {
@@ -92,6 +219,8 @@ void iKinLink::clone(const iKinLink &l)
     H   =l.H;
     cumH=l.cumH;
     DnH =l.DnH;
+
+    revision++;
 }
 
 
@@ -117,7 +246,10 @@ void iKinLink::setMin(const double _Min)
     Min=_Min;
 
     if (Ang<Min)
+    {
         Ang=Min;
+        revision++;
+    }
 }
 
 
@@ -127,7 +259,10 @@ void iKinLink::setMax(const double _Max)
     Max=_Max;
 
     if (Ang>Max)
+    {
         Ang=Max;
+        revision++;
+    }
 }
 
 
@@ -135,6 +270,7 @@ void iKinLink::setMax(const double _Max)
 void iKinLink::setD(const double _D)
 {
     H(2,3)=D=_D;
+    revision++;
 }
 
 
@@ -145,6 +281,7 @@ void iKinLink::setAlpha(const double _Alpha)
 
     H(2,2)=c_alpha=cos(Alpha);
     H(2,1)=s_alpha=sin(Alpha);
+    revision++;
 }
 
 
@@ -153,10 +290,15 @@ double iKinLink::setAng(double _Ang)
 {
     if (!blocked)
     {
+        double prevAng=Ang;
+
         if (constrained)
             Ang=(_Ang<Min) ? Min : ((_Ang>Max) ? Max : _Ang);
         else
             Ang=_Ang;
+
+        if (Ang!=prevAng)
+            revision++;
     }
     else if (verbose)
         yWarning("Attempt to set joint angle to %g while blocked",_Ang);
@@ -166,7 +308,7 @@ double iKinLink::setAng(double _Ang)
 
 
 /************************************************************************/
-Matrix iKinLink::getH(bool c_override)
+const Matrix &iKinLink::getRawH()
 {
     double theta=Ang+Offset;
     double c_theta=cos(theta);
@@ -182,6 +324,36 @@ Matrix iKinLink::getH(bool c_override)
     H(1,2)=-c_theta*s_alpha;
     H(1,3)=s_theta*A;
 
+    return H;
+}
+
+
+/************************************************************************/
+const Matrix &iKinLink::getRawDH()
+{
+    double theta=Ang+Offset;
+    double c_theta=cos(theta);
+    double s_theta=sin(theta);
+
+    DnH(0,0)=-s_theta;
+    DnH(0,1)=-c_theta*c_alpha;
+    DnH(0,2)=c_theta*s_alpha;
+    DnH(0,3)=-s_theta*A;
+
+    DnH(1,0)=c_theta;
+    DnH(1,1)=-s_theta*c_alpha;
+    DnH(1,2)=s_theta*s_alpha;
+    DnH(1,3)=c_theta*A;
+
+    return DnH;
+}
+
+
+/************************************************************************/
+Matrix iKinLink::getH(bool c_override)
+{
+    getRawH();
+
     if (cumulative && !c_override)
         return cumH*H;
     else
@@ -257,6 +429,9 @@ iKinChain::iKinChain()
 {
     N=DOF=verbose=0;
     H0=HN=eye(4,4);
+    fwd_H=fwd_dH=fwd_tmp=eye(4,4);
+    fwd_intH.assign(1,eye(4,4));
+    fwd_valid=0;
 }
 
 
@@ -271,6 +446,12 @@ void iKinChain::clone(const iKinChain &c)
     verbose  =c.verbose;
     hess_J   =c.hess_J;
     hess_Jlnk=c.hess_Jlnk;
+    fwd_H    =c.fwd_H;
+    fwd_dH   =c.fwd_dH;
+    fwd_tmp  =c.fwd_tmp;
+    fwd_intH =c.fwd_intH;
+    fwd_rev  =c.fwd_rev;
+    fwd_valid=0;
 
     allList.assign(c.allList.begin(),c.allList.end());
     quickList.assign(c.quickList.begin(),c.quickList.end());
@@ -359,6 +540,7 @@ void iKinChain::clear()
 
     N=DOF=0;
     H0=HN=eye(4,4);
+    fwd_valid=0;
 }
 
 
@@ -555,6 +737,12 @@ void iKinChain::build()
 
     if (DOF>0)
         curr_q.resize(DOF,0);
+
+    if (fwd_intH.size()<N+1)
+        fwd_intH.resize(N+1,eye(4,4));
+
+    fwd_rev.assign(N,0);
+    fwd_valid=0;
 }
 
 
@@ -595,14 +783,20 @@ bool iKinChain::setHN(const Matrix &_HN)
 
 
 /************************************************************************/
-Vector iKinChain::setAng(const Vector &q)
+void iKinChain::applyAng(const Vector &q)
 {
-    yAssert(DOF>0);
-
     size_t sz=std::min(q.length(),(size_t)DOF);
     for (size_t i=0; i<sz; i++)
         curr_q[i]=quickList[hash_dof[i]]->setAng(q[i]);
+}
 
+
+/************************************************************************/
+Vector iKinChain::setAng(const Vector &q)
+{
+    yAssert(DOF>0);
+
+    applyAng(q);
     return curr_q;
 }
 
@@ -655,6 +849,170 @@ double iKinChain::getAng(const unsigned int i)
 }
 
 
+/************************************************************************/
+void iKinChain::updateIntH(const unsigned int n)
+{
+    // the cached H0 might be outdated since it can be
+    // modified without passing through setH0()
+    const double *h0=H0.data();
+    const double *cachedH0=fwd_intH[0].data();
+    if (!std::equal(h0,h0+16,cachedH0))
+    {
+        fwd_intH[0]=H0;
+        fwd_valid=0;
+    }
+
+    // look for the first link that has changed
+    unsigned int upTo=std::min(fwd_valid,n);
+    unsigned int first=upTo;
+    for (unsigned int i=0; i<upTo; i++)
+    {
+        if (fwd_rev[i]!=allList[i]->revision)
+        {
+            first=i;
+            break;
+        }
+    }
+
+    for (unsigned int i=first; i<n; i++)
+    {
+        mul4x4(fwd_intH[i],allList[i]->getRawH(),fwd_intH[i+1]);
+        fwd_rev[i]=allList[i]->revision;
+    }
+
+    // whatever lies beyond n is stale if some link before n has changed
+    if (first<upTo)
+        fwd_valid=n;
+    else
+        fwd_valid=std::max(fwd_valid,n);
+}
+
+
+/************************************************************************/
+void iKinChain::evalIntH(const Vector &q, iKinChainWorkspace &ws) const
+{
+    // the same products of updateIntH(), on the angles q rather
+    // than on the ones of the links, which are only read
+    if (ws.intH.size()<16*(N+1))
+        ws.intH.resize(16*(N+1));
+
+    double *intH=ws.intH.data();
+    std::copy(H0.data(),H0.data()+16,intH);
+
+    double h[16]={0.0};
+    h[15]=1.0;
+
+    size_t dof=0;
+    for (unsigned int i=0; i<N; i++, intH+=16)
+    {
+        const iKinLink &l=*allList[i];
+
+        double ang=l.Ang;
+        if (!l.blocked)
+        {
+            if (dof<q.length())
+            {
+                ang=q[dof];
+                if (l.constrained)
+                    ang=(ang<l.Min) ? l.Min : ((ang>l.Max) ? l.Max : ang);
+            }
+            dof++;
+        }
+
+        double theta=ang+l.Offset;
+        double c_theta=cos(theta);
+        double s_theta=sin(theta);
+
+        h[0]=c_theta;  h[1]=-s_theta*l.c_alpha; h[2] =s_theta*l.s_alpha;  h[3] =c_theta*l.A;
+        h[4]=s_theta;  h[5]=c_theta*l.c_alpha;  h[6] =-c_theta*l.s_alpha; h[7] =s_theta*l.A;
+                       h[9]=l.s_alpha;          h[10]=l.c_alpha;          h[11]=l.D;
+
+        mul4x4(intH,h,intH+16);
+    }
+}
+
+
+/************************************************************************/
+bool iKinChain::getH(const Vector &q, iKinChainWorkspace &ws, Matrix &H) const
+{
+    if (DOF==0)
+    {
+        if (verbose)
+            yError("getH() failed since DOF==0");
+
+        return false;
+    }
+
+    if ((H.rows()!=4) || (H.cols()!=4))
+        H.resize(4,4);
+
+    evalIntH(q,ws);
+    mul4x4(ws.intH.data()+16*N,HN.data(),H.data());
+
+    return true;
+}
+
+
+/************************************************************************/
+bool iKinChain::getEndEffPose(const Vector &q, iKinChainWorkspace &ws,
+                              Vector &pose, const bool axisRep) const
+{
+    if (DOF==0)
+    {
+        if (verbose)
+            yError("getEndEffPose() failed since DOF==0");
+
+        return false;
+    }
+
+    double PN[16];
+    evalIntH(q,ws);
+    mul4x4(ws.intH.data()+16*N,HN.data(),PN);
+    fillPose(PN,axisRep,pose);
+
+    return true;
+}
+
+
+/************************************************************************/
+bool iKinChain::getGeoJacobian(const Vector &q, iKinChainWorkspace &ws,
+                               Matrix &J) const
+{
+    if (DOF==0)
+    {
+        if (verbose)
+            yError("getGeoJacobian() failed since DOF==0");
+
+        return false;
+    }
+
+    if ((J.rows()!=6) || (J.cols()!=(int)DOF))
+        J.resize(6,DOF);
+
+    double PN[16];
+    evalIntH(q,ws);
+    mul4x4(ws.intH.data()+16*N,HN.data(),PN);
+
+    for (unsigned int i=0; i<DOF; i++)
+    {
+        const double *Z=ws.intH.data()+16*hash[i];
+
+        double dx=PN[3]-Z[3];
+        double dy=PN[7]-Z[7];
+        double dz=PN[11]-Z[11];
+
+        J(0,i)=Z[6]*dz-Z[10]*dy;
+        J(1,i)=Z[10]*dx-Z[2]*dz;
+        J(2,i)=Z[2]*dy-Z[6]*dx;
+        J(3,i)=Z[2];
+        J(4,i)=Z[6];
+        J(5,i)=Z[10];
+    }
+
+    return true;
+}
+
+
 /************************************************************************/
 Vector iKinChain::RotAng(const Matrix &R)
 {
@@ -731,41 +1089,33 @@ Vector iKinChain::d2RotAng(const Matrix &R, const Matrix &dRi,
 /************************************************************************/
 Matrix iKinChain::getH(const unsigned int i, const bool allLink)
 {
-    Matrix H=H0;
-    unsigned int _i,n;
-    deque<iKinLink*> *l;
-    bool cumulHN=false;
-    bool c_override;
-
     if (allLink)
     {
-        n=N;
-        l=&allList;
-        c_override=true;
+        yAssert(i<N);
 
-        _i=i;
-        if (_i>=N-1)
-            cumulHN=true;
+        updateIntH(i+1);
+        if (i>=N-1)
+            return fwd_intH[i+1]*HN;
+        else
+            return fwd_intH[i+1];
     }
-    else
-    {
-        n=DOF;
-        l=&quickList;
-        c_override=false;
 
-        if (i==DOF)
-            _i=(unsigned int)quickList.size();
-        else
-            _i=i;
+    Matrix H=H0;
+    unsigned int _i;
+    bool cumulHN=false;
 
-        if (hash[_i]>=N-1)
-            cumulHN=true;
-    }
+    if (i==DOF)
+        _i=(unsigned int)quickList.size();
+    else
+        _i=i;
+
+    if (hash[_i]>=N-1)
+        cumulHN=true;
 
-    yAssert(i<n);
+    yAssert(i<DOF);
 
     for (unsigned int j=0; j<=_i; j++)
-        H*=((*l)[j]->getH(c_override));
+        H*=quickList[j]->getH();
 
     if (cumulHN)
         H*=HN;
@@ -775,17 +1125,27 @@ Matrix iKinChain::getH(const unsigned int i, const bool allLink)
 
 
 /************************************************************************/
-Matrix iKinChain::getH()
+bool iKinChain::getH(Matrix &H)
 {
-    // may be different from DOF since one blocked link may lie
-    // at the end of the chain.
-    unsigned int n=(unsigned int)quickList.size();
-    Matrix H=H0;
+    // blocked links are accounted for as well by spanning
+    // the whole chain, which lets us exploit the cache
+    if ((H.rows()!=4) || (H.cols()!=4))
+        H.resize(4,4);
 
-    for (unsigned int i=0; i<n; i++)
-        H*=quickList[i]->getH();
+    updateIntH(N);
+    mul4x4(fwd_intH[N],HN,H);
+
+    return true;
+}
+
+
+/************************************************************************/
+Matrix iKinChain::getH()
+{
+    Matrix H;
+    getH(H);
 
-    return H*HN;
+    return H;
 }
 
 
@@ -849,32 +1209,8 @@ Vector iKinChain::Position(const unsigned int i)
 /************************************************************************/
 Vector iKinChain::EndEffPose(const bool axisRep)
 {
-    Matrix H=getH();
     Vector v;
-
-    if (axisRep)
-    {
-        v.resize(7);
-        Vector r=dcm2axis(H);
-        v[0]=H(0,3);
-        v[1]=H(1,3);
-        v[2]=H(2,3);
-        v[3]=r[0];
-        v[4]=r[1];
-        v[5]=r[2];
-        v[6]=r[3];
-    }
-    else
-    {
-        v.resize(6);
-        Vector r=RotAng(H);
-        v[0]=H(0,3);
-        v[1]=H(1,3);
-        v[2]=H(2,3);
-        v[3]=r[0];
-        v[4]=r[1];
-        v[5]=r[2];
-    }
+    getEndEffPose(v,axisRep);
 
     return v;
 }
@@ -893,7 +1229,10 @@ Vector iKinChain::EndEffPose(const Vector &q, const bool axisRep)
 /************************************************************************/
 Vector iKinChain::EndEffPosition()
 {
-    return getH().subcol(0,3,3);
+    Vector v;
+    getEndEffPosition(v);
+
+    return v;
 }
 
 
@@ -907,6 +1246,62 @@ Vector iKinChain::EndEffPosition(const Vector &q)
 }
 
 
+/************************************************************************/
+bool iKinChain::getEndEffPose(Vector &pose, const bool axisRep)
+{
+    getH(fwd_H);
+    fillPose(fwd_H,axisRep,pose);
+
+    return true;
+}
+
+
+/************************************************************************/
+bool iKinChain::getEndEffPose(const Vector &q, Vector &pose, const bool axisRep)
+{
+    if (DOF==0)
+    {
+        if (verbose)
+            yError("getEndEffPose() failed since DOF==0");
+
+        return false;
+    }
+
+    applyAng(q);
+    return getEndEffPose(pose,axisRep);
+}
+
+
+/************************************************************************/
+bool iKinChain::getEndEffPosition(Vector &pos)
+{
+    getH(fwd_H);
+
+    pos.resize(3);
+    pos[0]=fwd_H(0,3);
+    pos[1]=fwd_H(1,3);
+    pos[2]=fwd_H(2,3);
+
+    return true;
+}
+
+
+/************************************************************************/
+bool iKinChain::getEndEffPosition(const Vector &q, Vector &pos)
+{
+    if (DOF==0)
+    {
+        if (verbose)
+            yError("getEndEffPosition() failed since DOF==0");
+
+        return false;
+    }
+
+    applyAng(q);
+    return getEndEffPosition(pos);
+}
+
+
 /************************************************************************/
 Matrix iKinChain::AnaJacobian(const unsigned int i, unsigned int col)
 {
@@ -958,43 +1353,80 @@ Matrix iKinChain::AnaJacobian(unsigned int col)
 {
     yAssert(DOF>0);
 
+    Matrix J;
+    getAnaJacobian(J,col);
+
+    return J;
+}
+
+
+/************************************************************************/
+bool iKinChain::getAnaJacobian(Matrix &J, unsigned int col)
+{
+    if (DOF==0)
+    {
+        if (verbose)
+            yError("getAnaJacobian() failed since DOF==0");
+
+        return false;
+    }
+
     col=col>3 ? 3 : col;
 
     // may be different from DOF since one blocked link may lie
     // at the end of the chain.
     unsigned int n=(unsigned int)quickList.size();
-    Matrix J(6,DOF);
-    Matrix H,dH,_H;
-    Vector dr;
+    if ((J.rows()!=6) || (J.cols()!=(int)DOF))
+        J.resize(6,DOF);
+
+    // the links transformations get refreshed here once for all
+    for (unsigned int j=0; j<n; j++)
+        quickList[j]->getRawH();
+
+    const Matrix &H=fwd_H;
+    getH(fwd_H);
 
     for (unsigned int i=0; i<DOF; i++)
     {
-        H=dH=H0;
+        Matrix &dH=fwd_dH;
+        dH=H0;
 
         for (unsigned int j=0; j<n; j++)
         {
-            _H=quickList[j]->getH();
-            H*=_H;
+            iKinLink *l=quickList[j];
+            if (l->cumulative)
+                mulInPlace4x4(dH,l->cumH,fwd_tmp);
 
-            if (hash_dof[i]==j)
-                dH*=quickList[j]->getDnH();
-            else
-                dH*=_H;
+            mulInPlace4x4(dH,(hash_dof[i]==j)?l->getRawDH():l->H,fwd_tmp);
         }
 
-        H*=HN;
-        dH*=HN;
-        dr=dRotAng(H,dH);
+        mulInPlace4x4(dH,HN,fwd_tmp);
 
         J(0,i)=dH(0,col);
         J(1,i)=dH(1,col);
         J(2,i)=dH(2,col);
-        J(3,i)=dr[0];
-        J(4,i)=dr[1];
-        J(5,i)=dr[2];
+        J(3,i)=(H(2,1)*dH(2,2) - H(2,2)*dH(2,1)) / (H(2,1)*H(2,1) + H(2,2)*H(2,2));
+        J(4,i)=dH(2,0)/sqrt(fabs(1-H(2,0)*H(2,0)));
+        J(5,i)=(H(1,0)*dH(0,0) - H(0,0)*dH(1,0)) / (H(1,0)*H(1,0) + H(0,0)*H(0,0));
     }
 
-    return J;
+    return true;
+}
+
+
+/************************************************************************/
+bool iKinChain::getAnaJacobian(const Vector &q, Matrix &J, unsigned int col)
+{
+    if (DOF==0)
+    {
+        if (verbose)
+            yError("getAnaJacobian() failed since DOF==0");
+
+        return false;
+    }
+
+    applyAng(q);
+    return getAnaJacobian(J,col);
 }
 
 
@@ -1017,19 +1449,15 @@ Matrix iKinChain::GeoJacobian(const unsigned int i)
     Matrix PN,Z;
     Vector w;
 
-    deque<Matrix> intH;
-    intH.push_back(H0);
-
-    for (unsigned int j=0; j<=i; j++)
-        intH.push_back(intH[j]*allList[j]->getH(true));
+    updateIntH(i+1);
 
-    PN=intH[i+1];
+    PN=fwd_intH[i+1];
     if (i>=N-1)
         PN=PN*HN;
 
     for (unsigned int j=0; j<=i; j++)
     {
-        Z=intH[j];
+        Z=fwd_intH[j];
         w=cross(Z,2,PN-Z,3);
 
         J(0,j)=w[0];
@@ -1049,34 +1477,65 @@ Matrix iKinChain::GeoJacobian()
 {
     yAssert(DOF>0);
 
-    Matrix J(6,DOF);
-    Matrix PN,Z;
-    Vector w;
+    Matrix J;
+    getGeoJacobian(J);
 
-    deque<Matrix> intH;
-    intH.push_back(H0);
+    return J;
+}
 
-    for (unsigned int i=0; i<N; i++)
-        intH.push_back(intH[i]*allList[i]->getH(true));
 
-    PN=intH[N]*HN;
+/************************************************************************/
+bool iKinChain::getGeoJacobian(Matrix &J)
+{
+    if (DOF==0)
+    {
+        if (verbose)
+            yError("getGeoJacobian() failed since DOF==0");
+
+        return false;
+    }
+
+    if ((J.rows()!=6) || (J.cols()!=(int)DOF))
+        J.resize(6,DOF);
+
+    updateIntH(N);
+
+    Matrix &PN=fwd_H;
+    mul4x4(fwd_intH[N],HN,PN);
 
     for (unsigned int i=0; i<DOF; i++)
     {
-        unsigned int j=hash[i];
+        const Matrix &Z=fwd_intH[hash[i]];
 
-        Z=intH[j];
-        w=cross(Z,2,PN-Z,3);
+        double dx=PN(0,3)-Z(0,3);
+        double dy=PN(1,3)-Z(1,3);
+        double dz=PN(2,3)-Z(2,3);
 
-        J(0,i)=w[0];
-        J(1,i)=w[1];
-        J(2,i)=w[2];
+        J(0,i)=Z(1,2)*dz-Z(2,2)*dy;
+        J(1,i)=Z(2,2)*dx-Z(0,2)*dz;
+        J(2,i)=Z(0,2)*dy-Z(1,2)*dx;
         J(3,i)=Z(0,2);
         J(4,i)=Z(1,2);
         J(5,i)=Z(2,2);
     }
 
-    return J;
+    return true;
+}
+
+
+/************************************************************************/
+bool iKinChain::getGeoJacobian(const Vector &q, Matrix &J)
+{
+    if (DOF==0)
+    {
+        if (verbose)
+            yError("getGeoJacobian() failed since DOF==0");
+
+        return false;
+    }
+
+    applyAng(q);
+    return getGeoJacobian(J);
 }
 
 
@@ -1109,7 +1568,62 @@ void iKinChain::prepareForHessian()
         return;
     }
 
-    hess_J=GeoJacobian();
+    getGeoJacobian(hess_J);
+}
+
+
+/************************************************************************/
+bool iKinChain::fastHessian(deque<Matrix> &H)
+{
+    if ((DOF==0) || (hess_J.cols()!=(int)DOF))
+    {
+        if (verbose)
+            yError("fastHessian() failed since prepareForHessian() has not been called");
+
+        return false;
+    }
+
+    H.resize(DOF);
+    for (unsigned int k=0; k<DOF; k++)
+    {
+        Matrix &Hk=H[k];
+        if ((Hk.rows()!=6) || (Hk.cols()!=(int)DOF))
+            Hk.resize(6,DOF);
+
+        double zx=hess_J(3,k), zy=hess_J(4,k), zz=hess_J(5,k);
+        double lx=hess_J(0,k), ly=hess_J(1,k), lz=hess_J(2,k);
+
+        // column i is fastHessian_ij(k,i)
+        for (unsigned int i=0; i<DOF; i++)
+        {
+            if (k<i)
+            {
+                Hk(0,i)=zy*hess_J(2,i)-zz*hess_J(1,i);
+                Hk(1,i)=zz*hess_J(0,i)-zx*hess_J(2,i);
+                Hk(2,i)=zx*hess_J(1,i)-zy*hess_J(0,i);
+                Hk(3,i)=zy*hess_J(5,i)-zz*hess_J(4,i);
+                Hk(4,i)=zz*hess_J(3,i)-zx*hess_J(5,i);
+                Hk(5,i)=zx*hess_J(4,i)-zy*hess_J(3,i);
+            }
+            else
+            {
+                Hk(0,i)=hess_J(4,i)*lz-hess_J(5,i)*ly;
+                Hk(1,i)=hess_J(5,i)*lx-hess_J(3,i)*lz;
+                Hk(2,i)=hess_J(3,i)*ly-hess_J(4,i)*lx;
+                Hk(3,i)=Hk(4,i)=Hk(5,i)=0.0;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/************************************************************************/
+bool iKinChain::Hessian(deque<Matrix> &H)
+{
+    prepareForHessian();
+    return fastHessian(H);
 }
 
 
@@ -1201,50 +1715,32 @@ Vector iKinChain::fastHessian_ij(const unsigned int lnk, const unsigned int i,
 
 
 /************************************************************************/
-Matrix iKinChain::DJacobian(const Vector &dq)
+bool iKinChain::getDJacobian(const Vector &dq, Matrix &dJ)
 {
-    Matrix J=GeoJacobian();
-    Matrix dJ(6,DOF); dJ.zero();
-    double dqj,dqi,a,b,c;
-    for (unsigned int i=0; i<DOF; i++)  // i: col
+    if (!getGeoJacobian(fwd_J))
+        return false;
+
+    if (dq.length()<DOF)
     {
-        for (unsigned int j=0; j<=i; j++)  // j: row
-        {
-            dqj=dq[j];
-
-            a=J(4,j)*J(2,i)-J(5,j)*J(1,i);
-            b=J(5,j)*J(0,i)-J(3,j)*J(2,i);
-            c=J(3,j)*J(1,i)-J(4,j)*J(0,i);
-            dJ(0,i)+=dqj*a;
-            dJ(1,i)+=dqj*b;
-            dJ(2,i)+=dqj*c;
-            dJ(3,i)+=dqj*(J(4,j)*J(5,i)-J(5,j)*J(4,i));
-            dJ(4,i)+=dqj*(J(5,j)*J(3,i)-J(3,j)*J(5,i));
-            dJ(5,i)+=dqj*(J(3,j)*J(4,i)-J(4,j)*J(3,i));
-
-            if (i!=j)
-            {
-                dqi     =dq[i];
-                dJ(0,j)+=dqi*a;
-                dJ(1,j)+=dqi*b;
-                dJ(2,j)+=dqi*c;
-            }
-        }
+        if (verbose)
+            yError("getDJacobian() failed due to wrong size of dq: %d<%d",
+                   (int)dq.length(),DOF);
+
+        return false;
     }
 
-    return dJ;
+    djacobian(fwd_J,dq,dJ);
+    return true;
+}
 
-    /* OLD IMPLEMENTATION (SLOWER, BUT CLEARER)
-    prepareForHessian();
-    Vector tmp(6,0.0);
-    for (unsigned int i=0; i<DOF; i++)
-    {
-        for (unsigned int j=0; j<DOF; j++)
-            tmp+=fastHessian_ij(j,i)*dq(j);
 
-        dJ.setCol(i,tmp);
-        tmp.zero();
-    }*/
+/************************************************************************/
+Matrix iKinChain::DJacobian(const Vector &dq)
+{
+    Matrix dJ;
+    getDJacobian(dq,dJ);
+
+    return dJ;
 }
 
 
@@ -1252,47 +1748,12 @@ Matrix iKinChain::DJacobian(const Vector &dq)
 Matrix iKinChain::DJacobian(const unsigned int lnk, const Vector &dq)
 {
     Matrix J=GeoJacobian(lnk);
-    Matrix dJ(6,lnk-1); dJ.zero();
-    double dqj,dqi,a,b,c;
-    for (unsigned int i=0; i<lnk; i++)  // i: col
-    {
-        for (unsigned int j=0; j<=i; j++)  // j: row
-        {
-            dqj=dq[j];
-
-            a=J(4,j)*J(2,i)-J(5,j)*J(1,i);
-            b=J(5,j)*J(0,i)-J(3,j)*J(2,i);
-            c=J(3,j)*J(1,i)-J(4,j)*J(0,i);
-            dJ(0,i)+=dqj*a;
-            dJ(1,i)+=dqj*b;
-            dJ(2,i)+=dqj*c;
-            dJ(3,i)+=dqj*(J(4,j)*J(5,i)-J(5,j)*J(4,i));
-            dJ(4,i)+=dqj*(J(5,j)*J(3,i)-J(3,j)*J(5,i));
-            dJ(5,i)+=dqj*(J(3,j)*J(4,i)-J(4,j)*J(3,i));
-
-            if (i!=j)
-            {
-                dqi     =dq[i];
-                dJ(0,j)+=dqi*a;
-                dJ(1,j)+=dqi*b;
-                dJ(2,j)+=dqi*c;
-            }
-        }
-    }
-
-    return dJ;
+    Matrix dJ;
 
-    // OLD IMPLEMENTATION (SLOWER, BUT CLEARER)
-    /*prepareForHessian(lnk);
-    Vector tmp(6,0.0);
-    for (unsigned int i=0; i<lnk; i++)
-    {
-        for (unsigned int j=0; j<lnk; j++)
-            tmp+=fastHessian_ij(lnk,j,i)*dq(j);
+    yAssert(dq.length()>=(size_t)J.cols());
+    djacobian(J,dq,dJ);
 
-        dJ.setCol(i,tmp);
-        tmp.zero();
-    }*/
+    return dJ;
 }
 
 
@@ -2382,6 +2843,174 @@ bool iCubFinger::getChainJoints(const Vector &motorEncoders,
 }
 
 
+/************************************************************************/
+iCubHand::iCubHand()
+{
+    allocate("right","b");
+}
+
+
+/************************************************************************/
+iCubHand::iCubHand(const string &_type, const string &thumbVersion)
+{
+    allocate(_type,thumbVersion);
+}
+
+
+/************************************************************************/
+void iCubHand::allocate(const string &_type, const string &thumbVersion)
+{
+    arm=iCubArm(_type);
+
+    string hand=_type.substr(0,_type.find('_'));
+    if (hand!="left")
+        hand="right";
+
+    fingers[0]=iCubFinger(hand+"_thumb_"+thumbVersion);
+    fingers[1]=iCubFinger(hand+"_index");
+    fingers[2]=iCubFinger(hand+"_middle");
+    fingers[3]=iCubFinger(hand+"_ring");
+    fingers[4]=iCubFinger(hand+"_little");
+
+    Hpalm=eye(4,4);
+    for (int i=0; i<5; i++)
+        tips[i].resize(3,0.0);
+}
+
+
+/************************************************************************/
+bool iCubHand::alignJointsBounds(const deque<IControlLimits*> &lim)
+{
+    if (lim.size()<2)
+        return false;
+
+    if (!arm.alignJointsBounds(lim))
+        return false;
+
+    deque<IControlLimits*> limFinger;
+    limFinger.push_back(lim[1]);
+    for (int i=0; i<5; i++)
+        if (!fingers[i].alignJointsBounds(limFinger))
+            return false;
+
+    return true;
+}
+
+
+/************************************************************************/
+bool iCubHand::computeFingertips(const Vector &motorEncoders,
+                                 const bool wantJacobians)
+{
+    return computeFingertips(motorEncoders,NULL,zeros(1,2),wantJacobians);
+}
+
+
+/************************************************************************/
+bool iCubHand::computeFingertips(const Vector &motorEncoders,
+                                 const Vector &jointEncoders,
+                                 const bool wantJacobians,
+                                 const Matrix &jointEncodersBounds)
+{
+    return computeFingertips(motorEncoders,&jointEncoders,jointEncodersBounds,
+                             wantJacobians);
+}
+
+
+/************************************************************************/
+bool iCubHand::computeFingertips(const Vector &motorEncoders,
+                                 const Vector *jointEncoders,
+                                 const Matrix &jointEncodersBounds,
+                                 const bool wantJacobians)
+{
+    if (motorEncoders.length()!=16)
+        return false;
+
+    // the arm joints follow the 3 torso links; the torso, as well
+    // as any blocked link, keeps the angles of the links
+    unsigned int dofArm=arm.getDOF();
+    if (qArm.length()!=dofArm)
+        qArm.resize(dofArm);
+
+    for (unsigned int i=0, dof=0; i<arm.getN(); i++)
+    {
+        if (!arm.isLinkBlocked(i))
+            qArm[dof++]=(i<3?arm[i].getAng():CTRL_DEG2RAD*motorEncoders[i-3]);
+    }
+
+    if (!arm.getH(qArm,armWs,Hpalm))
+        return false;
+
+    if (wantJacobians)
+    {
+        if (!arm.getGeoJacobian(qArm,armWs,Jarm))
+            return false;
+    }
+
+    for (int f=0; f<5; f++)
+    {
+        iCubFinger &finger=fingers[f];
+
+        bool ok=(jointEncoders!=NULL ?
+                 finger.getChainJoints(motorEncoders,*jointEncoders,qFinger,jointEncodersBounds) :
+                 finger.getChainJoints(motorEncoders,qFinger));
+        if (!ok)
+            return false;
+
+        for (size_t i=0; i<qFinger.length(); i++)
+            qFinger[i]*=CTRL_DEG2RAD;
+
+        if (!finger.getH(qFinger,fingersWs[f],Hfinger))
+            return false;
+
+        // tip = Hpalm * Hfinger, translation only
+        Vector &tip=tips[f];
+        for (int r=0; r<3; r++)
+            tip[r]=Hpalm(r,0)*Hfinger(0,3)+Hpalm(r,1)*Hfinger(1,3)+
+                   Hpalm(r,2)*Hfinger(2,3)+Hpalm(r,3);
+
+        if (!wantJacobians)
+            continue;
+
+        if (!finger.getGeoJacobian(qFinger,fingersWs[f],Jfinger))
+            return false;
+
+        unsigned int dofFinger=finger.getDOF();
+        Matrix &J=jacobians[f];
+        if ((J.rows()!=6) || (J.cols()!=(int)(dofArm+dofFinger)))
+            J.resize(6,dofArm+dofFinger);
+
+        // the arm moves the fingertip as a point rigidly attached
+        // to the palm: v=v_palm+w x (tip-palm)
+        double dx=tip[0]-Hpalm(0,3);
+        double dy=tip[1]-Hpalm(1,3);
+        double dz=tip[2]-Hpalm(2,3);
+        for (unsigned int c=0; c<dofArm; c++)
+        {
+            J(0,c)=Jarm(0,c)+Jarm(4,c)*dz-Jarm(5,c)*dy;
+            J(1,c)=Jarm(1,c)+Jarm(5,c)*dx-Jarm(3,c)*dz;
+            J(2,c)=Jarm(2,c)+Jarm(3,c)*dy-Jarm(4,c)*dx;
+            J(3,c)=Jarm(3,c);
+            J(4,c)=Jarm(4,c);
+            J(5,c)=Jarm(5,c);
+        }
+
+        // the finger Jacobian is rotated from the palm frame
+        for (unsigned int c=0; c<dofFinger; c++)
+        {
+            for (int r=0; r<3; r++)
+            {
+                J(r,dofArm+c)=Hpalm(r,0)*Jfinger(0,c)+Hpalm(r,1)*Jfinger(1,c)+
+                              Hpalm(r,2)*Jfinger(2,c);
+                J(3+r,dofArm+c)=Hpalm(r,0)*Jfinger(3,c)+Hpalm(r,1)*Jfinger(4,c)+
+                                Hpalm(r,2)*Jfinger(5,c);
+            }
+        }
+    }
+
+    return true;
+}
+
+
 /************************************************************************/
 iCubLeg::iCubLeg() : iKinLimb(string("right"))
 {
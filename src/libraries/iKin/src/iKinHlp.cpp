@@ -34,6 +34,23 @@ void CartesianHelper::addVectorOption(Bottle &b, const int vcb, const Vector &v)
 }
 
 
+/************************************************************************/
+void CartesianHelper::addVectorsOption(Bottle &b, const int vcb,
+                                       const std::deque<Vector> &v)
+{
+    Bottle &part=b.addList();
+    part.addVocab32(vcb);
+    Bottle &list=part.addList();
+
+    for (size_t i=0; i<v.size(); i++)
+    {
+        Bottle &vect=list.addList();
+        for (size_t j=0; j<v[i].length(); j++)
+            vect.addFloat64(v[i][j]);
+    }
+}
+
+
 /************************************************************************/
 bool CartesianHelper::getDesiredOption(const Bottle &reply, Vector &xdhat,
                                        Vector &odhat, Vector &qdhat)
@@ -82,6 +99,50 @@ bool CartesianHelper::getDesiredOption(const Bottle &reply, Vector &xdhat,
 }
 
 
+/************************************************************************/
+bool CartesianHelper::getDesiredOption(const Bottle &reply, std::deque<Vector> &xdhat,
+                                       std::deque<Vector> &odhat, std::deque<Vector> &qdhat)
+{
+    if (reply.size()==0)
+        return false;
+
+    if (reply.get(0).asVocab32()!=IKINSLV_VOCAB_REP_ACK)
+        return false;
+
+    Bottle *xData=getEndEffectorPoseOption(reply);
+    Bottle *qData=getJointsOption(reply);
+    if ((xData==NULL) || (qData==NULL) || (xData->size()!=qData->size()))
+        return false;
+
+    size_t n=xData->size();
+    xdhat.resize(n);
+    odhat.resize(n);
+    qdhat.resize(n);
+
+    for (size_t k=0; k<n; k++)
+    {
+        Bottle *x=xData->get(k).asList();
+        Bottle *q=qData->get(k).asList();
+        if ((x==NULL) || (q==NULL) || (x->size()<7))
+            return false;
+
+        xdhat[k].resize(3);
+        for (size_t i=0; i<xdhat[k].length(); i++)
+            xdhat[k][i]=x->get(i).asFloat64();
+
+        odhat[k].resize(4);
+        for (size_t i=0; i<odhat[k].length(); i++)
+            odhat[k][i]=x->get(xdhat[k].length()+i).asFloat64();
+
+        qdhat[k].resize(q->size());
+        for (size_t i=0; i<qdhat[k].length(); i++)
+            qdhat[k][i]=q->get(i).asFloat64();
+    }
+
+    return true;
+}
+
+
 /************************************************************************/
 void CartesianHelper::addTargetOption(Bottle &b, const Vector &xd)
 {
@@ -89,6 +150,13 @@ void CartesianHelper::addTargetOption(Bottle &b, const Vector &xd)
 }
 
 
+/************************************************************************/
+void CartesianHelper::addTargetsOption(Bottle &b, const std::deque<Vector> &xd)
+{
+    addVectorsOption(b,IKINSLV_VOCAB_OPT_XDS,xd);
+}
+
+
 /************************************************************************/
 void CartesianHelper::addDOFOption(Bottle &b, const Vector &dof)
 {
@@ -159,6 +227,13 @@ Bottle *CartesianHelper::getEndEffectorPoseOption(const Bottle &b)
 }
 
 
+/************************************************************************/
+Bottle *CartesianHelper::getTargetsOption(const Bottle &b)
+{
+    return b.find(Vocab32::decode(IKINSLV_VOCAB_OPT_XDS)).asList();
+}
+
+
 /************************************************************************/
 Bottle *CartesianHelper::getJointsOption(const Bottle &b)
 {
@@ -335,3 +410,50 @@ bool CartesianHelper::computeFixationPointData(iKinChain &eyeL,
 }
 
 
+/************************************************************************/
+void CartesianHelper::packState(const std::deque<Vector> &fields, Vector &state)
+{
+    size_t len=2+fields.size();
+    for (size_t i=0; i<fields.size(); i++)
+        len+=fields[i].length();
+
+    state.resize(len);
+    state[0]=IKIN_STATE_VER;
+    state[1]=(double)fields.size();
+
+    size_t k=2+fields.size();
+    for (size_t i=0; i<fields.size(); i++)
+    {
+        state[2+i]=(double)fields[i].length();
+        for (size_t j=0; j<fields[i].length(); j++)
+            state[k++]=fields[i][j];
+    }
+}
+
+
+/************************************************************************/
+bool CartesianHelper::unpackState(const Vector &state, std::deque<Vector> &fields)
+{
+    if ((state.length()<2) || (state[0]!=IKIN_STATE_VER) || (state[1]<0.0))
+        return false;
+
+    size_t n=(size_t)state[1];
+    if (state.length()<2+n)
+        return false;
+
+    size_t k=2+n;
+    fields.resize(n);
+    for (size_t i=0; i<n; i++)
+    {
+        size_t len=(size_t)state[2+i];
+        if (k+len>state.length())
+            return false;
+
+        fields[i].resize(len);
+        for (size_t j=0; j<len; j++)
+            fields[i][j]=state[k++];
+    }
+
+    return (k==state.length());
+}
+
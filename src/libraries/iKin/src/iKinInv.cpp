@@ -10,6 +10,7 @@
 
 #include <typeinfo>
 #include <cstdio>
+#include <cstring>
 #include <cmath>
 #include <algorithm>
 
@@ -22,6 +23,10 @@
 #define IKINCTRL_WATCHDOG_TOL       1e-4
 #define IKINCTRL_WATCHDOG_MAXITER   200
 
+// below this ratio between the smallest and the largest eigenvalue of the
+// Gram matrix of J, pinvJ is computed through the SVD of J
+#define IKINCTRL_GRAM_MINRATIO      1e-8
+
 using namespace std;
 using namespace yarp::os;
 using namespace yarp::sig;
@@ -30,6 +35,173 @@ using namespace iCub::ctrl;
 using namespace iCub::iKin;
 
 
+// The damped least squares of the controllers are solved on the small
+// (at most 6x6) symmetric matrices of the task space, which are kept in
+// arrays on the stack, so that the iterations do not allocate them.
+
+/************************************************************************/
+inline void transposeInto(const Matrix &A, Matrix &At)
+{
+    if ((At.rows()!=A.cols()) || (At.cols()!=A.rows()))
+        At.resize(A.cols(),A.rows());
+
+    for (size_t r=0; r<A.rows(); r++)
+        for (size_t c=0; c<A.cols(); c++)
+            At(c,r)=A(r,c);
+}
+
+
+/************************************************************************/
+inline void gramMatrix(const Matrix &J, const bool wide, double *G)
+{
+    // G=J*J' if wide, G=J'*J otherwise
+    int n=(int)(wide?J.rows():J.cols());
+    int m=(int)(wide?J.cols():J.rows());
+    for (int a=0; a<n; a++)
+    {
+        for (int b=0; b<=a; b++)
+        {
+            double s=0.0;
+            for (int k=0; k<m; k++)
+                s+=wide?J(a,k)*J(b,k):J(k,a)*J(k,b);
+            G[a*n+b]=G[b*n+a]=s;
+        }
+    }
+}
+
+
+/************************************************************************/
+inline bool choleskyFactor(double *A, const int n)
+{
+    // A=L*L', with L overwriting the lower triangle of A;
+    // false if A is not positive definite
+    for (int c=0; c<n; c++)
+    {
+        double d=A[c*n+c];
+        for (int k=0; k<c; k++)
+            d-=A[c*n+k]*A[c*n+k];
+        if (!(d>0.0))
+            return false;
+
+        d=sqrt(d);
+        A[c*n+c]=d;
+        for (int r=c+1; r<n; r++)
+        {
+            double s=A[r*n+c];
+            for (int k=0; k<c; k++)
+                s-=A[r*n+k]*A[c*n+k];
+            A[r*n+c]=s/d;
+        }
+    }
+
+    return true;
+}
+
+
+/************************************************************************/
+inline void choleskySolve(const double *L, const int n, double *b)
+{
+    // b=inv(L*L')*b
+    for (int r=0; r<n; r++)
+    {
+        for (int k=0; k<r; k++)
+            b[r]-=L[r*n+k]*b[k];
+        b[r]/=L[r*n+r];
+    }
+
+    for (int r=n-1; r>=0; r--)
+    {
+        for (int k=r+1; k<n; k++)
+            b[r]-=L[k*n+r]*b[k];
+        b[r]/=L[r*n+r];
+    }
+}
+
+
+/************************************************************************/
+inline void choleskyPinv(const Matrix &J, const double *L, const bool wide,
+                         Matrix &X)
+{
+    // wide: X=J'*inv(G), with G=L*L' the 6x6 (possibly damped) J*J';
+    // otherwise: X=inv(G)*J', with G the Gram matrix J'*J
+    int n=(int)(wide?J.rows():J.cols());
+    int m=(int)(wide?J.cols():J.rows());
+    if ((X.rows()!=J.cols()) || (X.cols()!=J.rows()))
+        X.resize(J.cols(),J.rows());
+
+    double b[6];
+    for (int i=0; i<m; i++)
+    {
+        for (int k=0; k<n; k++)
+            b[k]=wide?J(k,i):J(i,k);
+
+        choleskySolve(L,n,b);
+
+        for (int k=0; k<n; k++)
+        {
+            if (wide)
+                X(i,k)=b[k];
+            else
+                X(k,i)=b[k];
+        }
+    }
+}
+
+
+/************************************************************************/
+inline void symEigenvalues(double *A, const int n, double *ev)
+{
+    // cyclic Jacobi on the symmetric A, which is destroyed
+    for (int sweep=0; sweep<50; sweep++)
+    {
+        double off=0.0,diag=0.0;
+        for (int p=0; p<n; p++)
+        {
+            diag+=A[p*n+p]*A[p*n+p];
+            for (int q=p+1; q<n; q++)
+                off+=A[p*n+q]*A[p*n+q];
+        }
+
+        if (off<=1e-32*diag)
+            break;
+
+        for (int p=0; p<n-1; p++)
+        {
+            for (int q=p+1; q<n; q++)
+            {
+                double apq=A[p*n+q];
+                if (apq==0.0)
+                    continue;
+
+                double theta=(A[q*n+q]-A[p*n+p])/(2.0*apq);
+                double t=(theta>=0.0?1.0:-1.0)/(fabs(theta)+sqrt(theta*theta+1.0));
+                double c=1.0/sqrt(t*t+1.0);
+                double s=t*c;
+
+                for (int k=0; k<n; k++)
+                {
+                    double akp=A[k*n+p];
+                    double akq=A[k*n+q];
+                    A[k*n+p]=c*akp-s*akq;
+                    A[k*n+q]=s*akp+c*akq;
+                }
+
+                for (int k=0; k<n; k++)
+                {
+                    double apk=A[p*n+k];
+                    double aqk=A[q*n+k];
+                    A[p*n+k]=c*apk-s*aqk;
+                    A[q*n+k]=s*apk+c*aqk;
+                }
+            }
+        }
+    }
+
+    for (int i=0; i<n; i++)
+        ev[i]=A[i*n+i];
+}
+
+
 /************************************************************************/
 iKinCtrl::iKinCtrl(iKinChain &c, unsigned int _ctrlPose) : chain(c)
 {
@@ -266,6 +438,41 @@ Vector iKinCtrl::solve(Vector &xd, const double tol_size, const int max_iter,
 }
 
 
+/************************************************************************/
+bool iKinCtrl::step(Vector &xd, const int n_iter, const double tol_size,
+                    const unsigned int verbose, int *exit_code)
+{
+    // a new target gives the algorithm a chance to move again
+    if ((state==IKINCTRL_STATE_DEADLOCK) && !(xd==x_set))
+    {
+        state=IKINCTRL_STATE_RUNNING;
+        watchDogCnt=0;
+    }
+
+    for (int i=0; i<std::max(n_iter,1); i++)
+    {
+        iterate(xd,verbose);
+
+        int code;
+        if (isInTarget())
+            code=IKINCTRL_RET_TOLX;
+        else if (test_convergence(tol_size))
+            code=IKINCTRL_RET_TOLSIZE;
+        else if (state==IKINCTRL_STATE_DEADLOCK)
+            code=IKINCTRL_RET_TOLQ;
+        else
+            continue;
+
+        if (exit_code)
+            *exit_code=code;
+
+        return true;
+    }
+
+    return false;
+}
+
+
 /************************************************************************/
 SteepCtrl::SteepCtrl(iKinChain &c, unsigned int _type, unsigned int _ctrlPose,
                      double _Ts, double _Kp) : iKinCtrl(c,_ctrlPose)
@@ -579,26 +786,61 @@ Vector LMCtrl::iterate(Vector &xd, const unsigned int verbose)
         calc_e();
 
         J=chain.GeoJacobian();
-        Jt=J.transposed();
-        grad=-1.0*(Jt*e);
+        transposeInto(J,Jt);
 
-        Matrix LM=J*Jt;
+        for (unsigned int i=0; i<dim; i++)
+        {
+            double s=0.0;
+            for (size_t k=0; k<e.length(); k++)
+                s+=J(k,i)*e[k];
+            grad[i]=-s;
+        }
+
+        // LM=J*Jt+mu*diag(J*Jt) is positive definite as long as no row of J
+        // is null: pinvLM=Jt*inv(LM) is then solved by Cholesky
+        double LM[36];
+        gramMatrix(J,true,LM);
         for (int i=0; i<6; i++)
-            LM(i,i)+=mu*LM(i,i);
+            LM[i*6+i]+=mu*LM[i*6+i];
 
-        if (LM.rows()>=LM.cols())
-            pinvLM=Jt*pinv(LM);
+        if (choleskyFactor(LM,6))
+            choleskyPinv(J,LM,true,pinvLM);
         else
-            pinvLM=Jt*pinv(LM.transposed()).transposed();
+        {
+            Matrix _LM=J*Jt;
+            for (int i=0; i<6; i++)
+                _LM(i,i)+=mu*_LM(i,i);
 
-        if (J.rows()>=J.cols())
+            pinvLM=Jt*pinv(_LM);
+        }
+
+        // pinvJ and svMin come from the Gram matrix of J, unless it is
+        // too badly conditioned to be inverted without the SVD
+        bool wide=(J.rows()<J.cols());
+        int n=(int)(wide?J.rows():J.cols());
+        double G[36],L[36],ev[6];
+        gramMatrix(J,wide,G);
+        memcpy(L,G,n*n*sizeof(double));
+        symEigenvalues(G,n,ev);
+        double evMin=*std::min_element(ev,ev+n);
+        double evMax=*std::max_element(ev,ev+n);
+
+        if ((evMin>IKINCTRL_GRAM_MINRATIO*evMax) && choleskyFactor(L,n))
+        {
+            choleskyPinv(J,L,wide,pinvJ);
+            svMin=sqrt(evMin);
+        }
+        else if (J.rows()>=J.cols())
             pinvJ=LMCtrl::pinv(J);
         else
             pinvJ=LMCtrl::pinv(J.transposed()).transposed();
 
         gpm=computeGPM();
 
-        Vector _qdot=pinvLM*e+gpm;
+        Vector _qdot=gpm;
+        for (unsigned int i=0; i<dim; i++)
+            for (size_t k=0; k<e.length(); k++)
+                _qdot[i]+=pinvLM(i,k)*e[k];
 
         if (constrained)
             qdot=checkVelocity(_qdot,Ts);
@@ -841,12 +1083,48 @@ Vector MultiRefMinJerkCtrl::iterate(Vector &xd, Vector &qd, Vector *xdot_set,
             _xdot=mjCtrlTask->computeCmd(execTime,e);
    
         J =chain.GeoJacobian();
-        Jt=J.transposed();
+        transposeInto(J,Jt);
 
         computeWeight();
 
-        qdot=_qdot+W*(Jt*(pinv(Eye6+J*W*Jt)*(_xdot-J*_qdot)));        
-        xdot=J*qdot;
+        // qdot=_qdot+W*Jt*inv(Eye6+J*W*Jt)*(_xdot-J*_qdot), where W is
+        // diagonal and Eye6+J*W*Jt is positive definite
+        double A[36],r[6];
+        for (int a=0; a<6; a++)
+        {
+            for (int b=0; b<=a; b++)
+            {
+                double s=(a==b)?1.0:0.0;
+                for (unsigned int i=0; i<dim; i++)
+                    s+=J(a,i)*W(i,i)*J(b,i);
+                A[a*6+b]=A[b*6+a]=s;
+            }
+
+            r[a]=_xdot[a];
+            for (unsigned int i=0; i<dim; i++)
+                r[a]-=J(a,i)*_qdot[i];
+        }
+
+        if (choleskyFactor(A,6))
+        {
+            choleskySolve(A,6,r);
+            for (unsigned int i=0; i<dim; i++)
+            {
+                double s=0.0;
+                for (int a=0; a<6; a++)
+                    s+=J(a,i)*r[a];
+                qdot[i]=_qdot[i]+W(i,i)*s;
+            }
+        }
+        else
+            qdot=_qdot+W*(Jt*(pinv(Eye6+J*W*Jt)*(_xdot-J*_qdot)));
+
+        for (int a=0; a<6; a++)
+        {
+            xdot[a]=0.0;
+            for (unsigned int i=0; i<dim; i++)
+                xdot[a]+=J(a,i)*qdot[i];
+        }
         q=chain.setAng(I->integrate(qdot));
         x=chain.EndEffPose();
     }
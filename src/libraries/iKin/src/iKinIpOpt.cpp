@@ -9,8 +9,11 @@
 */
 
 #include <cstdlib>
+#include <cmath>
 #include <limits>
 #include <string>
+#include <vector>
+#include <algorithm>
 
 #include <IpTNLP.hpp>
 #include <IpIpoptApplication.hpp>
@@ -19,6 +22,8 @@
 
 #define CAST_IPOPTAPP(x)                    (static_cast<IpoptApplication*>(x))
 #define IKINIPOPT_SHOULDER_MAXABDUCTION     (100.0*CTRL_DEG2RAD)
+#define IKINIPOPT_CACHE_KEYBITS             21
+#define IKINIPOPT_CACHE_MAXJOINTDIST        (30.0*CTRL_DEG2RAD)
 
 using namespace std;
 using namespace yarp::sig;
@@ -90,6 +95,12 @@ void iCubAdditionalArmConstraints::clone(const iKinLinIneqConstr *obj)
     
     chain=ptr->chain;
     hw_version=ptr->hw_version;
+
+    cached=ptr->cached;
+    cachedActive=ptr->cachedActive;
+    cachedBlocked=ptr->cachedBlocked;
+    cachedLowerBoundInf=ptr->cachedLowerBoundInf;
+    cachedUpperBoundInf=ptr->cachedUpperBoundInf;
 }
 
 
@@ -120,6 +131,7 @@ iCubAdditionalArmConstraints::iCubAdditionalArmConstraints(iCubArm &arm) :
     elb_m=(joint4_1-joint4_0)/(joint3_1-joint3_0);
     elb_n=joint4_0-elb_m*joint3_0;
 
+    cached=false;
     update(NULL);
 }
 
@@ -127,6 +139,21 @@ iCubAdditionalArmConstraints::iCubAdditionalArmConstraints(iCubArm &arm) :
 /************************************************************************/
 void iCubAdditionalArmConstraints::update(void*)
 {
+    // the constraints involve only the torso and the
+    // first five joints of the arm
+    int blocked=0;
+    for (unsigned int i=0; (i<3+5) && (i<chain->getN()); i++)
+        if ((*chain)[i].isBlocked())
+            blocked|=1<<i;
+
+    if (cached && (blocked==cachedBlocked) &&
+        (lowerBoundInf==cachedLowerBoundInf) &&
+        (upperBoundInf==cachedUpperBoundInf))
+    {
+        setActive(cachedActive);
+        return;
+    }
+
     // optimization won't use LinIneqConstr by default
     setActive(false);
 
@@ -224,6 +251,12 @@ void iCubAdditionalArmConstraints::update(void*)
         getuB()=_uB;
         setActive(true);
     }
+
+    cached=true;
+    cachedActive=isActive();
+    cachedBlocked=blocked;
+    cachedLowerBoundInf=lowerBoundInf;
+    cachedUpperBoundInf=upperBoundInf;
 }
 
 
@@ -255,6 +288,7 @@ protected:
     yarp::sig::Vector  q0;
     yarp::sig::Vector  q;
     bool              *exhalt;
+    const std::atomic<bool> *exhaltShared;
 
     yarp::sig::Vector  e_zero;
     yarp::sig::Vector  e_xyz;
@@ -274,6 +308,12 @@ protected:
 
     yarp::sig::Vector linC;
 
+    // nonzero entries of the linear constraints, taken once
+    // when the problem is set up
+    std::vector<Index>  licRow;
+    std::vector<Index>  licCol;
+    std::vector<Number> licVal;
+
     double __obj_scaling;
     double __x_scaling;
     double __g_scaling;
@@ -345,7 +385,11 @@ protected:
                     e_3rd[i]=w_3rd[i]*(qd_3rd[i]-q[i]);
 
             if (LIC.isActive())
-                linC=LIC.getC()*q;
+            {
+                linC.zero();
+                for (size_t k=0; k<licVal.size(); k++)
+                    linC[licRow[k]]+=licVal[k]*q[licCol[k]];
+            }
         }
     }
 
@@ -356,12 +400,12 @@ public:
              yarp::sig::Vector &_xd, double _weight2ndTask, iKinChain &_chain2ndTask,
              yarp::sig::Vector &_xd_2nd, yarp::sig::Vector &_w_2nd, double _weight3rdTask,
              yarp::sig::Vector &_qd_3rd, yarp::sig::Vector &_w_3rd, iKinLinIneqConstr &_LIC,
-             bool *_exhalt=NULL) :
+             bool *_exhalt=NULL, const std::atomic<bool> *_exhaltShared=NULL) :
              chain(c), q0(_q0), xd(_xd),
              chain2ndTask(_chain2ndTask),   xd_2nd(_xd_2nd), w_2nd(_w_2nd),
              weight3rdTask(_weight3rdTask), qd_3rd(_qd_3rd), w_3rd(_w_3rd),
              LIC(_LIC), 
-             exhalt(_exhalt)
+             exhalt(_exhalt), exhaltShared(_exhaltShared)
     {
         dim=chain.getDOF();
         dim_2nd=chain2ndTask.getDOF();
@@ -501,8 +545,27 @@ public:
 
             if (lenLower && (lenLower==lenUpper) && (LIC.getC().cols()==dim))
             {
+                const yarp::sig::Matrix &C=LIC.getC();
+
+                licRow.clear();
+                licCol.clear();
+                licVal.clear();
+                for (int r=0; r<lenLower; r++)
+                {
+                    for (unsigned int c=0; c<dim; c++)
+                    {
+                        if (C(r,c)!=0.0)
+                        {
+                            licRow.push_back(r);
+                            licCol.push_back(c);
+                            licVal.push_back(C(r,c));
+                        }
+                    }
+                }
+
+                linC.resize(lenLower,0.0);
                 m+=lenLower;
-                nnz_jac_g+=lenLower*dim;
+                nnz_jac_g+=(Index)licVal.size();
             }
             else
                 LIC.setActive(false);
@@ -616,16 +679,25 @@ public:
     {
         if (m!=0)
         {
+            // the first constraint is dense, while the linear
+            // ones are given by their nonzero entries only
             if (values==NULL)
             {
                 Index idx=0;
-        
-                for (Index row=0; row<m; row++)
+
+                for (Index col=0; col<n; col++)
                 {
-                    for (Index col=0; col<n; col++)
+                    iRow[idx]=0;
+                    jCol[idx]=col;
+                    idx++;
+                }
+
+                if (m>1)
+                {
+                    for (size_t k=0; k<licVal.size(); k++)
                     {
-                        iRow[idx]=row;
-                        jCol[idx]=col;
+                        iRow[idx]=1+licRow[k];
+                        jCol[idx]=licCol[k];
                         idx++;
                     }
                 }
@@ -636,23 +708,15 @@ public:
             
                 yarp::sig::Vector grad=-2.0*(J_cst->transposed() * *e_cst);
 
-                Index idx =0;
-                Index offs=0;
+                Index idx=0;
+
+                for (Index col=0; col<n; col++)
+                    values[idx++]=grad[col];
 
-                for (Index row=0; row<m; row++)
+                if (m>1)
                 {
-                    for (Index col=0; col<n; col++)
-                    {    
-                        if (row==0)
-                        {
-                            values[idx]=grad[idx];                    
-                            offs=1;
-                        }
-                        else
-                            values[idx]=LIC.getC()(row-offs,col);
-                    
-                        idx++;
-                    }
+                    for (size_t k=0; k<licVal.size(); k++)
+                        values[idx++]=licVal[k];
                 }
             }
         }
@@ -683,12 +747,26 @@ public:
         {
             // Given the task: min f(q)=||xd-F(q)||^2
             // the Hessian Hij is: 2 * (<dF/dqi,dF/dqj> - <d2F/dqidqj,e>)
+            // while the linear inequality constraints do not contribute
             computeQuantities(x);
             chain.prepareForHessian();
 
             if (weight2ndTask!=0.0)
                 chain2ndTask.prepareForHessian();
 
+            yarp::sig::Vector h_xyz(3), h_ang(3), h_zero(3,0.0), h_2nd(3);
+            yarp::sig::Vector *h_1st,*h_cst;
+            if (e_cst==&e_xyz)
+            {
+                h_1st=(ctrlPose==IKINCTRL_POSE_FULL)?&h_ang:&h_zero;
+                h_cst=&h_xyz;
+            }
+            else
+            {
+                h_1st=(ctrlPose==IKINCTRL_POSE_FULL)?&h_xyz:&h_zero;
+                h_cst=&h_ang;
+            }
+
             Index idx=0;
             for (Index row=0; row<n; row++)
             {
@@ -697,7 +775,6 @@ public:
                     // warning: row and col are swapped due to asymmetry
                     // of orientation part within the hessian 
                     yarp::sig::Vector h=chain.fastHessian_ij(col,row);
-                    yarp::sig::Vector h_xyz(3), h_ang(3), h_zero(3,0.0);
                     h_xyz[0]=h[0];
                     h_xyz[1]=h[1];
                     h_xyz[2]=h[2];
@@ -705,18 +782,6 @@ public:
                     h_ang[1]=h[4];
                     h_ang[2]=h[5];
 
-                    yarp::sig::Vector *h_1st,*h_cst;
-                    if (e_cst==&e_xyz)
-                    {
-                        h_1st=(ctrlPose==IKINCTRL_POSE_FULL)?&h_ang:&h_zero;
-                        h_cst=&h_xyz;
-                    }
-                    else
-                    {
-                        h_1st=(ctrlPose==IKINCTRL_POSE_FULL)?&h_xyz:&h_zero;
-                        h_cst=&h_ang;
-                    }
-
                     values[idx]=2.0*(obj_factor*(dot(*J_1st,row,*J_1st,col)-dot(*h_1st,*e_1st))+
                                      lambda[0]*(dot(*J_cst,row,*J_cst,col)-dot(*h_cst,*e_cst)));
                 
@@ -725,13 +790,16 @@ public:
                         // warning: row and col are swapped due to asymmetry
                         // of orientation part within the hessian 
                         yarp::sig::Vector h2=chain2ndTask.fastHessian_ij(col,row);
-                        yarp::sig::Vector h_2nd(3);
                         h_2nd[0]=(w_2nd[0]*w_2nd[0])*h2[0];
                         h_2nd[1]=(w_2nd[1]*w_2nd[1])*h2[1];
                         h_2nd[2]=(w_2nd[2]*w_2nd[2])*h2[2];
                 
                         values[idx]+=2.0*obj_factor*weight2ndTask*(dot(J_2nd,row,J_2nd,col)-dot(h_2nd,e_2nd));
                     }
+
+                    // the 3rd task min ||w*(qd-q)||^2 is quadratic in q
+                    if ((weight3rdTask!=0.0) && (row==col))
+                        values[idx]+=2.0*obj_factor*weight3rdTask*(w_3rd[row]*w_3rd[row]);
                 
                     idx++;
                 }
@@ -751,6 +819,9 @@ public:
         if (callback!=NULL)
             callback->exec(xd,q);
 
+        if ((exhaltShared!=NULL) && exhaltShared->load(std::memory_order_acquire))
+            return false;
+
         if (exhalt!=NULL)
             return !(*exhalt);
         else
@@ -792,6 +863,167 @@ public:
 };
 
 
+/************************************************************************/
+iKinSolutionCache::iKinSolutionCache(const double _voxelSize, const double _maxAngle,
+                                     const size_t _maxEntries) :
+                                     voxelSize(_voxelSize), maxAngle(_maxAngle),
+                                     maxEntries(_maxEntries)
+{
+    if (voxelSize<=0.0)
+        voxelSize=0.02;
+}
+
+
+/************************************************************************/
+unsigned long long iKinSolutionCache::getKey(const long ix, const long iy,
+                                             const long iz) const
+{
+    // pack the three voxel indexes into one value
+    const unsigned long long mask=(1ULL<<IKINIPOPT_CACHE_KEYBITS)-1;
+    return ((((unsigned long long)ix)&mask)<<(2*IKINIPOPT_CACHE_KEYBITS))|
+           ((((unsigned long long)iy)&mask)<<IKINIPOPT_CACHE_KEYBITS)|
+            (((unsigned long long)iz)&mask);
+}
+
+
+/************************************************************************/
+void iKinSolutionCache::checkStructure(iKinChain &chain)
+{
+    // the structure is given by the blocked links and the joints bounds
+    yarp::sig::Vector sig(2+4*chain.getN());
+    sig[0]=chain.getN();
+    sig[1]=chain.getDOF();
+    for (unsigned int i=0; i<chain.getN(); i++)
+    {
+        sig[2+4*i]  =chain[i].isBlocked()?1.0:0.0;
+        sig[2+4*i+1]=chain[i].isBlocked()?chain[i].getAng():0.0;
+        sig[2+4*i+2]=chain[i].getMin();
+        sig[2+4*i+3]=chain[i].getMax();
+    }
+
+    if (!(sig==signature))
+    {
+        voxels.clear();
+        history.clear();
+        signature=sig;
+    }
+}
+
+
+/************************************************************************/
+bool iKinSolutionCache::lookup(iKinChain &chain, const yarp::sig::Vector &xd,
+                               const unsigned int ctrlPose, yarp::sig::Vector &q0)
+{
+    if ((ctrlPose==IKINCTRL_POSE_ANG) || (xd.length()<3))
+        return false;
+
+    lock_guard<mutex> lck(mtx);
+    checkStructure(chain);
+
+    bool checkAng=(ctrlPose==IKINCTRL_POSE_FULL) && (xd.length()>=7);
+    Matrix Rd;
+    if (checkAng)
+        Rd=axis2dcm(xd.subVector(3,6)).submatrix(0,2,0,2);
+
+    long ix=(long)floor(xd[0]/voxelSize);
+    long iy=(long)floor(xd[1]/voxelSize);
+    long iz=(long)floor(xd[2]/voxelSize);
+
+    const Entry *best=NULL;
+    double bestDist=voxelSize;
+
+    // scan the neighbouring voxels too
+    for (long dx=-1; dx<=1; dx++)
+    {
+        for (long dy=-1; dy<=1; dy++)
+        {
+            for (long dz=-1; dz<=1; dz++)
+            {
+                auto it=voxels.find(getKey(ix+dx,iy+dy,iz+dz));
+                if (it==voxels.end())
+                    continue;
+
+                for (auto &e : it->second)
+                {
+                    double dist=norm(xd.subVector(0,2)-e.xd.subVector(0,2));
+                    if (dist>bestDist)
+                        continue;
+
+                    if (checkAng && (e.xd.length()>=7))
+                    {
+                        Matrix R=Rd*axis2dcm(e.xd.subVector(3,6)).submatrix(0,2,0,2).transposed();
+                        if (fabs(dcm2axis(R)[3])>maxAngle)
+                            continue;
+                    }
+
+                    bestDist=dist;
+                    best=&e;
+                }
+            }
+        }
+    }
+
+    if (best!=NULL)
+    {
+        q0=best->qd;
+        return true;
+    }
+    else
+        return false;
+}
+
+
+/************************************************************************/
+void iKinSolutionCache::insert(iKinChain &chain, const yarp::sig::Vector &xd,
+                               const yarp::sig::Vector &qd)
+{
+    if ((maxEntries==0) || (xd.length()<3) || (qd.length()!=chain.getDOF()))
+        return;
+
+    lock_guard<mutex> lck(mtx);
+    checkStructure(chain);
+
+    unsigned long long key=getKey((long)floor(xd[0]/voxelSize),
+                                  (long)floor(xd[1]/voxelSize),
+                                  (long)floor(xd[2]/voxelSize));
+
+    Entry e;
+    e.xd=xd;
+    e.qd=qd;
+    voxels[key].push_back(e);
+    history.push_back(key);
+
+    // entries within a voxel are in insertion order as well,
+    // hence the oldest one stays always in front
+    while (history.size()>maxEntries)
+    {
+        auto it=voxels.find(history.front());
+        it->second.pop_front();
+        if (it->second.empty())
+            voxels.erase(it);
+
+        history.pop_front();
+    }
+}
+
+
+/************************************************************************/
+void iKinSolutionCache::clear()
+{
+    lock_guard<mutex> lck(mtx);
+    voxels.clear();
+    history.clear();
+}
+
+
+/************************************************************************/
+size_t iKinSolutionCache::size()
+{
+    lock_guard<mutex> lck(mtx);
+    return history.size();
+}
+
+
 /************************************************************************/
 iKinIpOptMin::iKinIpOptMin(iKinChain &c, const unsigned int _ctrlPose, const double tol,
                            const double constr_tol, const int max_iter,
@@ -801,6 +1033,7 @@ iKinIpOptMin::iKinIpOptMin(iKinChain &c, const unsigned int _ctrlPose, const dou
     ctrlPose=_ctrlPose;
     posePriority="position";
     pLIC=&noLIC;
+    cache=NULL;
 
     if (ctrlPose>IKINCTRL_POSE_ANG)
         ctrlPose=IKINCTRL_POSE_ANG;
@@ -969,6 +1202,33 @@ void iKinIpOptMin::setHessianOpt(const bool useHessian)
 }
 
 
+/************************************************************************/
+bool iKinIpOptMin::getHessianOpt() const
+{
+    string hessian_approximation;
+    CAST_IPOPTAPP(App)->Options()->GetStringValue("hessian_approximation",hessian_approximation,"");
+    return (hessian_approximation!="limited-memory");
+}
+
+
+/************************************************************************/
+void iKinIpOptMin::setLinearSolver(const string &linear_solver)
+{
+    CAST_IPOPTAPP(App)->Options()->SetStringValue("linear_solver",linear_solver);
+
+    CAST_IPOPTAPP(App)->Initialize();
+}
+
+
+/************************************************************************/
+string iKinIpOptMin::getLinearSolver() const
+{
+    string linear_solver;
+    CAST_IPOPTAPP(App)->Options()->GetStringValue("linear_solver",linear_solver,"");
+    return linear_solver;
+}
+
+
 /************************************************************************/
 void iKinIpOptMin::setUserScaling(const bool useUserScaling, const double _obj_scaling,
                                   const double _x_scaling, const double _g_scaling)
@@ -1033,21 +1293,74 @@ yarp::sig::Vector iKinIpOptMin::solve(const yarp::sig::Vector &q0, yarp::sig::Ve
                                       yarp::sig::Vector &qd_3rd, yarp::sig::Vector &w_3rd,
                                       int *exit_code, bool *exhalt, iKinIterateCallback *iterate)
 {
-    SmartPtr<iKin_NLP> nlp=new iKin_NLP(chain,ctrlPose,q0,xd,
-                                        weight2ndTask,chain2ndTask,xd_2nd,w_2nd,
-                                        weight3rdTask,qd_3rd,w_3rd,
-                                        *pLIC,exhalt);
-    
-    nlp->set_scaling(obj_scaling,x_scaling,g_scaling);
-    nlp->set_bound_inf(lowerBoundInf,upperBoundInf);
-    nlp->set_posePriority(posePriority);
-    nlp->set_callback(iterate);
+    return optimize(q0,xd,weight2ndTask,xd_2nd,w_2nd,weight3rdTask,qd_3rd,w_3rd,
+                    exit_code,exhalt,NULL,iterate);
+}
 
-    ApplicationReturnStatus status=CAST_IPOPTAPP(App)->OptimizeTNLP(GetRawPtr(nlp));
+
+/************************************************************************/
+yarp::sig::Vector iKinIpOptMin::solve(const yarp::sig::Vector &q0, yarp::sig::Vector &xd,
+                                      double weight2ndTask, yarp::sig::Vector &xd_2nd,
+                                      yarp::sig::Vector &w_2nd, double weight3rdTask,
+                                      yarp::sig::Vector &qd_3rd, yarp::sig::Vector &w_3rd,
+                                      int *exit_code, const std::atomic<bool> &exhalt,
+                                      iKinIterateCallback *iterate)
+{
+    return optimize(q0,xd,weight2ndTask,xd_2nd,w_2nd,weight3rdTask,qd_3rd,w_3rd,
+                    exit_code,NULL,&exhalt,iterate);
+}
+
+
+/************************************************************************/
+yarp::sig::Vector iKinIpOptMin::optimize(const yarp::sig::Vector &q0, yarp::sig::Vector &xd,
+                                         double weight2ndTask, yarp::sig::Vector &xd_2nd,
+                                         yarp::sig::Vector &w_2nd, double weight3rdTask,
+                                         yarp::sig::Vector &qd_3rd, yarp::sig::Vector &w_3rd,
+                                         int *exit_code, bool *exhalt, const std::atomic<bool> *exhaltShared,
+                                         iKinIterateCallback *iterate)
+{
+    auto run=[&](const yarp::sig::Vector &seed, ApplicationReturnStatus &status)
+    {
+        SmartPtr<iKin_NLP> nlp=new iKin_NLP(chain,ctrlPose,seed,xd,
+                                            weight2ndTask,chain2ndTask,xd_2nd,w_2nd,
+                                            weight3rdTask,qd_3rd,w_3rd,
+                                            *pLIC,exhalt,exhaltShared);
+
+        nlp->set_scaling(obj_scaling,x_scaling,g_scaling);
+        nlp->set_bound_inf(lowerBoundInf,upperBoundInf);
+        nlp->set_posePriority(posePriority);
+        nlp->set_callback(iterate);
+
+        status=CAST_IPOPTAPP(App)->OptimizeTNLP(GetRawPtr(nlp));
+        return nlp;
+    };
+
+    auto succeeded=[](const ApplicationReturnStatus status)
+    {
+        return (status==Solve_Succeeded) || (status==Solved_To_Acceptable_Level);
+    };
+
+    // the cached solution of the closest target is the initial guess
+    // if it lies near q0, or if q0 is not given; q0 is tried only if
+    // the cached guess does not converge
+    bool given=(q0.length()==chain.getDOF());
+    yarp::sig::Vector seed=given?q0:chain.getAng();
+    yarp::sig::Vector qc;
+    bool cached=(cache!=NULL) && cache->lookup(chain,xd,ctrlPose,qc) &&
+                (qc.length()==chain.getDOF()) &&
+                (!given || (norm(qc-q0)<=IKINIPOPT_CACHE_MAXJOINTDIST));
+
+    ApplicationReturnStatus status;
+    SmartPtr<iKin_NLP> nlp=run(cached?qc:seed,status);
+    if (cached && !succeeded(status) && (status!=User_Requested_Stop))
+        nlp=run(seed,status);
 
     if (exit_code!=NULL)
         *exit_code=status;
 
+    if ((cache!=NULL) && succeeded(status))
+        cache->insert(chain,xd,nlp->get_qd());
+
     return nlp->get_qd();
 }
 
@@ -1077,3 +1390,410 @@ iKinIpOptMin::~iKinIpOptMin()
 }
 
 
+
+
+/************************************************************************/
+class iKinBimanual_NLP : public TNLP
+{
+private:
+    // Copy constructor: not implemented.
+    iKinBimanual_NLP(const iKinBimanual_NLP&);
+    // Assignment operator: not implemented.
+    iKinBimanual_NLP &operator=(const iKinBimanual_NLP&);
+
+protected:
+    iKinChain &chain1;
+    iKinChain &chain2;
+
+    unsigned int nShared;
+    unsigned int dim1;
+    unsigned int dim2;
+    unsigned int dim;
+
+    yarp::sig::Vector &xd1;
+    yarp::sig::Vector &xd2;
+    yarp::sig::Vector &qd_3rd;
+    yarp::sig::Vector &w_3rd;
+    yarp::sig::Vector  qd;
+    yarp::sig::Vector  q0;
+    yarp::sig::Vector  q;
+
+    yarp::sig::Vector  e_xyz1, e_ang1;
+    yarp::sig::Vector  e_xyz2, e_ang2;
+    yarp::sig::Vector  e_3rd;
+    yarp::sig::Matrix  J_xyz1, J_ang1;
+    yarp::sig::Matrix  J_xyz2, J_ang2;
+
+    double weight3rdTask;
+    bool   firstGo;
+
+    /************************************************************************/
+    // the unknowns are [shared, own of chain1, own of chain2]
+    unsigned int var2(const unsigned int col) const
+    {
+        return (col<nShared)?col:(dim1+col-nShared);
+    }
+
+    /************************************************************************/
+    void computeErrors(iKinChain &chain, const yarp::sig::Vector &xd,
+                       yarp::sig::Vector &e_xyz, yarp::sig::Vector &e_ang,
+                       yarp::sig::Matrix &J_xyz, yarp::sig::Matrix &J_ang)
+    {
+        yarp::sig::Matrix H=chain.getH();
+        e_xyz[0]=xd[0]-H(0,3);
+        e_xyz[1]=xd[1]-H(1,3);
+        e_xyz[2]=xd[2]-H(2,3);
+
+        yarp::sig::Matrix J=chain.GeoJacobian();
+        J_xyz=J.submatrix(0,2,0,J.cols()-1);
+
+        if (xd.length()>=7)
+        {
+            yarp::sig::Vector v(4);
+            v[0]=xd[3]; v[1]=xd[4]; v[2]=xd[5]; v[3]=xd[6];
+            yarp::sig::Matrix E=axis2dcm(v)*H.transposed();
+            v=dcm2axis(E);
+
+            e_ang[0]=v[3]*v[0];
+            e_ang[1]=v[3]*v[1];
+            e_ang[2]=v[3]*v[2];
+            J_ang=J.submatrix(3,5,0,J.cols()-1);
+        }
+        else
+        {
+            e_ang=0.0;
+            J_ang.resize(3,J.cols());
+            J_ang.zero();
+        }
+    }
+
+    /************************************************************************/
+    void computeQuantities(const Number *x)
+    {
+        yarp::sig::Vector new_q(dim);
+        for (Index i=0; i<(int)dim; i++)
+            new_q[i]=x[i];
+
+        if (!(q==new_q) || firstGo)
+        {
+            firstGo=false;
+            q=new_q;
+
+            yarp::sig::Vector q1(dim1),q2(dim2);
+            for (unsigned int i=0; i<dim1; i++)
+                q1[i]=q[i];
+            for (unsigned int i=0; i<dim2; i++)
+                q2[i]=q[var2(i)];
+
+            chain1.setAng(q1);
+            chain2.setAng(q2);
+
+            computeErrors(chain1,xd1,e_xyz1,e_ang1,J_xyz1,J_ang1);
+            computeErrors(chain2,xd2,e_xyz2,e_ang2,J_xyz2,J_ang2);
+
+            if (weight3rdTask!=0.0)
+                for (unsigned int i=0; i<dim; i++)
+                    e_3rd[i]=w_3rd[i]*(qd_3rd[i]-q[i]);
+        }
+    }
+
+public:
+    /************************************************************************/
+    iKinBimanual_NLP(iKinChain &c1, iKinChain &c2, const unsigned int _nShared,
+                     const yarp::sig::Vector &_q0, yarp::sig::Vector &_xd1,
+                     yarp::sig::Vector &_xd2, double _weight3rdTask,
+                     yarp::sig::Vector &_qd_3rd, yarp::sig::Vector &_w_3rd) :
+                     chain1(c1), chain2(c2), nShared(_nShared), xd1(_xd1),
+                     xd2(_xd2), qd_3rd(_qd_3rd), w_3rd(_w_3rd), q0(_q0),
+                     weight3rdTask(_weight3rdTask)
+    {
+        dim1=chain1.getDOF();
+        dim2=chain2.getDOF();
+        dim=dim1+dim2-nShared;
+
+        qd.resize(dim,0.0);
+        size_t n=std::min(q0.length(),(size_t)dim);
+        for (size_t i=0; i<n; i++)
+            qd[i]=q0[i];
+
+        q0=q=qd;
+
+        if ((qd_3rd.length()<dim) || (w_3rd.length()<dim))
+            weight3rdTask=0.0;
+
+        e_xyz1.resize(3,0.0); e_ang1.resize(3,0.0);
+        e_xyz2.resize(3,0.0); e_ang2.resize(3,0.0);
+        e_3rd.resize(dim,0.0);
+
+        firstGo=true;
+    }
+
+    /************************************************************************/
+    yarp::sig::Vector get_qd() { return qd; }
+
+    /************************************************************************/
+    bool get_nlp_info(Index& n, Index& m, Index& nnz_jac_g, Index& nnz_h_lag,
+                      IndexStyleEnum& index_style)
+    {
+        n=dim;
+        m=2;
+        nnz_jac_g=dim1+dim2;
+        nnz_h_lag=0;
+        index_style=TNLP::C_STYLE;
+
+        return true;
+    }
+
+    /************************************************************************/
+    bool get_bounds_info(Index n, Number* x_l, Number* x_u, Index m, Number* g_l,
+                         Number* g_u)
+    {
+        for (unsigned int i=0; i<dim1; i++)
+        {
+            x_l[i]=chain1(i).getMin();
+            x_u[i]=chain1(i).getMax();
+        }
+
+        // the shared joints satisfy the bounds of both chains
+        for (unsigned int i=0; i<dim2; i++)
+        {
+            unsigned int j=var2(i);
+            if (i<nShared)
+            {
+                x_l[j]=std::max(x_l[j],chain2(i).getMin());
+                x_u[j]=std::min(x_u[j],chain2(i).getMax());
+            }
+            else
+            {
+                x_l[j]=chain2(i).getMin();
+                x_u[j]=chain2(i).getMax();
+            }
+        }
+
+        g_l[0]=g_u[0]=0.0;
+        g_l[1]=g_u[1]=0.0;
+
+        return true;
+    }
+
+    /************************************************************************/
+    bool get_starting_point(Index n, bool init_x, Number* x, bool init_z,
+                            Number* z_L, Number* z_U, Index m, bool init_lambda,
+                            Number* lambda)
+    {
+        for (Index i=0; i<n; i++)
+            x[i]=q0[i];
+
+        return true;
+    }
+
+    /************************************************************************/
+    bool eval_f(Index n, const Number* x, bool new_x, Number& obj_value)
+    {
+        computeQuantities(x);
+
+        obj_value=norm2(e_ang1)+norm2(e_ang2);
+
+        if (weight3rdTask!=0.0)
+            obj_value+=weight3rdTask*norm2(e_3rd);
+
+        return true;
+    }
+
+    /************************************************************************/
+    bool eval_grad_f(Index n, const Number* x, bool new_x, Number* grad_f)
+    {
+        computeQuantities(x);
+
+        yarp::sig::Vector grad1=-2.0*(J_ang1.transposed()*e_ang1);
+        yarp::sig::Vector grad2=-2.0*(J_ang2.transposed()*e_ang2);
+
+        for (Index i=0; i<n; i++)
+            grad_f[i]=0.0;
+
+        for (unsigned int i=0; i<dim1; i++)
+            grad_f[i]+=grad1[i];
+
+        for (unsigned int i=0; i<dim2; i++)
+            grad_f[var2(i)]+=grad2[i];
+
+        if (weight3rdTask!=0.0)
+            for (Index i=0; i<n; i++)
+                grad_f[i]-=2.0*weight3rdTask*w_3rd[i]*e_3rd[i];
+
+        return true;
+    }
+
+    /************************************************************************/
+    bool eval_g(Index n, const Number* x, bool new_x, Index m, Number* g)
+    {
+        computeQuantities(x);
+
+        g[0]=norm2(e_xyz1);
+        g[1]=norm2(e_xyz2);
+
+        return true;
+    }
+
+    /************************************************************************/
+    bool eval_jac_g(Index n, const Number* x, bool new_x, Index m, Index nele_jac,
+                    Index* iRow, Index *jCol, Number* values)
+    {
+        if (values==NULL)
+        {
+            Index idx=0;
+
+            for (unsigned int i=0; i<dim1; i++, idx++)
+            {
+                iRow[idx]=0;
+                jCol[idx]=i;
+            }
+
+            for (unsigned int i=0; i<dim2; i++, idx++)
+            {
+                iRow[idx]=1;
+                jCol[idx]=var2(i);
+            }
+        }
+        else
+        {
+            computeQuantities(x);
+
+            yarp::sig::Vector grad1=-2.0*(J_xyz1.transposed()*e_xyz1);
+            yarp::sig::Vector grad2=-2.0*(J_xyz2.transposed()*e_xyz2);
+
+            Index idx=0;
+            for (unsigned int i=0; i<dim1; i++)
+                values[idx++]=grad1[i];
+
+            for (unsigned int i=0; i<dim2; i++)
+                values[idx++]=grad2[i];
+        }
+
+        return true;
+    }
+
+    /************************************************************************/
+    bool eval_h(Index n, const Number* x, bool new_x, Number obj_factor,
+                Index m, const Number* lambda, bool new_lambda,
+                Index nele_hess, Index* iRow, Index* jCol, Number* values)
+    {
+        // the Hessian is approximated
+        return true;
+    }
+
+    /************************************************************************/
+    void finalize_solution(SolverReturn status, Index n, const Number* x,
+                           const Number* z_L, const Number* z_U, Index m,
+                           const Number* g, const Number* lambda, Number obj_value,
+                           const IpoptData* ip_data, IpoptCalculatedQuantities* ip_cq)
+    {
+        for (Index i=0; i<n; i++)
+            qd[i]=x[i];
+
+        firstGo=true;
+        computeQuantities(x);
+    }
+};
+
+
+/************************************************************************/
+iKinBimanualIpOptMin::iKinBimanualIpOptMin(iKinChain &c1, iKinChain &c2,
+                                           const unsigned int _nShared,
+                                           const double tol, const double constr_tol,
+                                           const int max_iter, const unsigned int verbose) :
+                                           chain1(c1), chain2(c2)
+{
+    nShared=std::min(_nShared,std::min(chain1.getDOF(),chain2.getDOF()));
+
+    // this is required since IpOpt initially relaxes constraints
+    chain1.setAllConstraints(false);
+    chain2.setAllConstraints(false);
+
+    App=new IpoptApplication();
+
+    CAST_IPOPTAPP(App)->Options()->SetNumericValue("tol",tol);
+    CAST_IPOPTAPP(App)->Options()->SetNumericValue("constr_viol_tol",constr_tol);
+    CAST_IPOPTAPP(App)->Options()->SetIntegerValue("acceptable_iter",0);
+    CAST_IPOPTAPP(App)->Options()->SetStringValue("mu_strategy","adaptive");
+    CAST_IPOPTAPP(App)->Options()->SetIntegerValue("print_level",verbose);
+    CAST_IPOPTAPP(App)->Options()->SetStringValue("hessian_approximation","limited-memory");
+
+    if (max_iter>0)
+        CAST_IPOPTAPP(App)->Options()->SetIntegerValue("max_iter",max_iter);
+    else
+        CAST_IPOPTAPP(App)->Options()->SetIntegerValue("max_iter",std::numeric_limits<int>::max());
+
+    CAST_IPOPTAPP(App)->Initialize();
+}
+
+
+/************************************************************************/
+unsigned int iKinBimanualIpOptMin::getDOF() const
+{
+    return chain1.getDOF()+chain2.getDOF()-nShared;
+}
+
+
+/************************************************************************/
+void iKinBimanualIpOptMin::setMaxIter(const int max_iter)
+{
+    if (max_iter>0)
+        CAST_IPOPTAPP(App)->Options()->SetIntegerValue("max_iter",max_iter);
+    else
+        CAST_IPOPTAPP(App)->Options()->SetIntegerValue("max_iter",std::numeric_limits<int>::max());
+
+    CAST_IPOPTAPP(App)->Initialize();
+}
+
+
+/************************************************************************/
+void iKinBimanualIpOptMin::setMaxCpuTime(const double max_cpu_time)
+{
+    CAST_IPOPTAPP(App)->Options()->SetNumericValue("max_cpu_time",max_cpu_time);
+    CAST_IPOPTAPP(App)->Initialize();
+}
+
+
+/************************************************************************/
+yarp::sig::Vector iKinBimanualIpOptMin::solve(const yarp::sig::Vector &q0, yarp::sig::Vector &xd1,
+                                              yarp::sig::Vector &xd2, double weight3rdTask,
+                                              yarp::sig::Vector &qd_3rd, yarp::sig::Vector &w_3rd,
+                                              int *exit_code)
+{
+    if ((xd1.length()<3) || (xd2.length()<3))
+    {
+        if (exit_code!=NULL)
+            *exit_code=Invalid_Problem_Definition;
+
+        return q0;
+    }
+
+    SmartPtr<iKinBimanual_NLP> nlp=new iKinBimanual_NLP(chain1,chain2,nShared,q0,xd1,xd2,
+                                                        weight3rdTask,qd_3rd,w_3rd);
+
+    ApplicationReturnStatus status=CAST_IPOPTAPP(App)->OptimizeTNLP(GetRawPtr(nlp));
+
+    if (exit_code!=NULL)
+        *exit_code=status;
+
+    return nlp->get_qd();
+}
+
+
+/************************************************************************/
+yarp::sig::Vector iKinBimanualIpOptMin::solve(const yarp::sig::Vector &q0, yarp::sig::Vector &xd1,
+                                              yarp::sig::Vector &xd2)
+{
+    yarp::sig::Vector dummy(1);
+    return solve(q0,xd1,xd2,0.0,dummy,dummy);
+}
+
+
+/************************************************************************/
+iKinBimanualIpOptMin::~iKinBimanualIpOptMin()
+{
+    delete CAST_IPOPTAPP(App);
+}
+
+
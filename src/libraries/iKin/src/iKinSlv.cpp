@@ -10,7 +10,15 @@
 
 #include <cstdlib>
 #include <cmath>
+#include <limits>
 #include <algorithm>
+#include <iterator>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+#include <IpReturnCodes.hpp>
 
 #include <yarp/os/Log.h>
 #include <yarp/os/Network.h>
@@ -26,6 +34,12 @@
 #define CARTSLV_WEIGHT_2ND_TASK             0.01
 #define CARTSLV_WEIGHT_3RD_TASK             0.01
 #define CARTSLV_UNCTRLEDJNTS_THRES          1.0     // [deg]
+#define CARTSLV_DEFAULT_MULTISTART          1
+#define CARTSLV_DEFAULT_MULTISTART_DEADLINE 0.0     // [s]
+#define CARTSLV_DEFAULT_BATCH_WORKERS       0
+#define CARTSLV_DEFAULT_CACHE_SIZE          0
+#define CARTSLV_DEFAULT_CACHE_VOXEL         0.02    // [m]
+#define CARTSLV_MAX_DOF_CONTEXTS            8
 
 using namespace std;
 using namespace yarp::os;
@@ -36,6 +50,26 @@ using namespace iCub::ctrl;
 using namespace iCub::iKin;
 
 
+/************************************************************************/
+inline double multiStartCost(const iKinChain &chain, iKinChainWorkspace &ws,
+                             const Vector &xd, const Vector &q,
+                             const unsigned int ctrlPose)
+{
+    Vector x;
+    chain.getEndEffPose(q,ws,x);
+    double cost=norm(xd.subVector(0,2)-x.subVector(0,2));
+
+    if ((ctrlPose==IKINCTRL_POSE_FULL) && (xd.length()>=7))
+    {
+        Matrix R=axis2dcm(xd.subVector(3,6)).submatrix(0,2,0,2)*
+                 axis2dcm(x.subVector(3,6)).submatrix(0,2,0,2).transposed();
+        cost+=fabs(dcm2axis(R)[3]);
+    }
+
+    return cost;
+}
+
+
 /************************************************************************/
 bool RpcProcessor::read(ConnectionReader &connection)
 {
@@ -265,7 +299,8 @@ void SolverCallback::exec(const Vector &xd, const Vector &q)
 
 /************************************************************************/
 CartesianSolver::CartesianSolver(const string &_slvName) :
-                                PeriodicThread((double)CARTSLV_DEFAULT_PER/1000.0)
+                                PeriodicThread((double)CARTSLV_DEFAULT_PER/1000.0),
+                                telemetry((double)CARTSLV_DEFAULT_PER/1000.0)
 {          
     // initialization
     slvName=_slvName;
@@ -282,8 +317,18 @@ CartesianSolver::CartesianSolver(const string &_slvName) :
     prt=NULL;
     slv=NULL;
     clb=NULL;
+    cache=NULL;
+    cacheSize=0;
+    cacheVoxel=CARTSLV_DEFAULT_CACHE_VOXEL;
     inPort=NULL;
     outPort=NULL;
+    receiver=NULL;
+    msDeadline=CARTSLV_DEFAULT_MULTISTART_DEADLINE;
+    linSolverSerial=false;
+
+    tmSectionIpOpt=telemetry.addSection("ipopt");
+    tmSectionFk=telemetry.addSection("fk");
+    tmSectionIO=telemetry.addSection("io");
 
     // open rpc port
     rpcPort=new Port;
@@ -668,6 +713,14 @@ void CartesianSolver::respond(const Bottle &command, Bottle &reply)
                             break;
                         }
 
+                        //-----------------
+                        case IKINSLV_VOCAB_OPT_TELEMETRY:
+                        {
+                            reply.addVocab32(IKINSLV_VOCAB_REP_ACK);
+                            telemetry.getInfo(reply.addList());
+                            break;
+                        }
+
                         //-----------------
                         default:
                             reply.addVocab32(IKINSLV_VOCAB_REP_NACK);
@@ -924,6 +977,20 @@ void CartesianSolver::respond(const Bottle &command, Bottle &reply)
                             break;
                         }
 
+                        //-----------------
+                        case IKINSLV_VOCAB_OPT_TELEMETRY:
+                        {
+                            if (command.get(2).asString()=="reset")
+                            {
+                                telemetry.reset();
+                                reply.addVocab32(IKINSLV_VOCAB_REP_ACK);
+                            }
+                            else
+                                reply.addVocab32(IKINSLV_VOCAB_REP_NACK);
+
+                            break;
+                        }
+
                         //-----------------
                         default:
                             reply.addVocab32(IKINSLV_VOCAB_REP_NACK);
@@ -939,10 +1006,36 @@ void CartesianSolver::respond(const Bottle &command, Bottle &reply)
             case IKINSLV_VOCAB_CMD_ASK:
             {
                 Bottle *b_xd=getTargetOption(command);
+                Bottle *b_xds=getTargetsOption(command);
                 Bottle *b_q=getJointsOption(command);
-            
-                // some integrity checks
-                if (b_xd==NULL)
+
+                // some integrity checks; in case of a batch,
+                // all the targets are retrieved in advance
+                deque<Vector> xds;
+                if (b_xds!=NULL)
+                {
+                    for (size_t k=0; k<b_xds->size(); k++)
+                    {
+                        Bottle *b_tg=b_xds->get(k).asList();
+                        if ((b_tg==NULL) || (b_tg->size()<3))
+                        {
+                            xds.clear();
+                            break;
+                        }
+
+                        Vector tg(b_tg->size());
+                        for (size_t i=0; i<tg.length(); i++)
+                            tg[i]=b_tg->get(i).asFloat64();
+                        xds.push_back(tg);
+                    }
+
+                    if (xds.empty())
+                    {
+                        reply.addVocab32(IKINSLV_VOCAB_REP_NACK);
+                        break;
+                    }
+                }
+                else if (b_xd==NULL)
                 {
                     reply.addVocab32(IKINSLV_VOCAB_REP_NACK);
                     break;
@@ -955,11 +1048,6 @@ void CartesianSolver::respond(const Bottle &command, Bottle &reply)
             
                 lock();
             
-                // get the target
-                Vector xd(b_xd->size());
-                for (size_t i=0; i<xd.length(); i++)
-                    xd[i]=b_xd->get(i).asFloat64();
-            
                 // accounts for the starting DOF
                 // if different from the actual one
                 if (b_q!=NULL)
@@ -986,6 +1074,41 @@ void CartesianSolver::respond(const Bottle &command, Bottle &reply)
                 for (unsigned int i=0; i<prt->chn->getDOF(); i++)
                     if (idx_3rdTask[i]!=0.0)
                         qd_3rdTask[i]=(*prt->chn)(i).getAng();
+
+                if (xds.size()>0)
+                {
+                    // solve the whole batch
+                    double t0=Time::now();
+                    deque<Vector> qs;
+                    solveBatch(xds,qs);
+                    double t1=Time::now();
+
+                    deque<Vector> xs(qs.size()),_qs(qs.size());
+                    for (size_t k=0; k<qs.size(); k++)
+                    {
+                        xs[k]=prt->chn->EndEffPose(qs[k]);
+
+                        // prepare the complete joints configuration
+                        _qs[k].resize(prt->chn->getN());
+                        for (unsigned int i=0; i<prt->chn->getN(); i++)
+                            _qs[k][i]=CTRL_RAD2DEG*prt->chn->getAng(i);
+                    }
+
+                    if (verbosity)
+                        yInfo("ask: %d targets solved in %g [s]",(int)xds.size(),t1-t0);
+
+                    reply.addVocab32(IKINSLV_VOCAB_REP_ACK);
+                    addVectorsOption(reply,IKINSLV_VOCAB_OPT_X,xs);
+                    addVectorsOption(reply,IKINSLV_VOCAB_OPT_Q,_qs);
+
+                    unlock();
+                    break;
+                }
+
+                // get the target
+                Vector xd(b_xd->size());
+                for (size_t i=0; i<xd.length(); i++)
+                    xd[i]=b_xd->get(i).asFloat64();
             
                 // call the solver to converge
                 double t0=Time::now();
@@ -1092,6 +1215,7 @@ void CartesianSolver::respond(const Bottle &command, Bottle &reply)
                 reply.addVocab32(IKINSLV_VOCAB_OPT_TIP_FRAME);
                 reply.addVocab32(IKINSLV_VOCAB_OPT_TASK2);
                 reply.addVocab32(IKINSLV_VOCAB_OPT_XD);
+                reply.addVocab32(IKINSLV_VOCAB_OPT_XDS);
                 reply.addVocab32(IKINSLV_VOCAB_OPT_X);
                 reply.addVocab32(IKINSLV_VOCAB_OPT_Q);
                 reply.addString("***** values");
@@ -1126,7 +1250,12 @@ void CartesianSolver::respond(const Bottle &command, Bottle &reply)
 void CartesianSolver::send(const Vector &xd, const Vector &x, const Vector &q,
                            double *tok)
 {       
-    Bottle &b=outPort->prepare();
+    // the port is used unless the solution is delivered
+    // by direct call only
+    bool toPort=(receiver==NULL) || (outPort->getOutputCount()>0);
+
+    Bottle local;
+    Bottle &b=toPort?outPort->prepare():local;
     b.clear();
 
     addVectorOption(b,IKINSLV_VOCAB_OPT_XD,xd);
@@ -1136,7 +1265,42 @@ void CartesianSolver::send(const Vector &xd, const Vector &x, const Vector &q,
     if (tok!=NULL)
         addTokenOption(b,*tok);
 
-    outPort->writeStrict();
+    if (receiver!=NULL)
+        receiver->onSolution(b);
+
+    if (toPort)
+        outPort->writeStrict();
+}
+
+
+/************************************************************************/
+bool CartesianSolver::sendRequest(Bottle &b)
+{
+    if (closed || (inPort==NULL))
+        return false;
+
+    inPort->onRead(b);
+    return true;
+}
+
+
+/************************************************************************/
+bool CartesianSolver::sendCommand(const Bottle &command, Bottle &reply)
+{
+    if (closed)
+        return false;
+
+    reply.clear();
+    respond(command,reply);
+    return true;
+}
+
+
+/************************************************************************/
+void CartesianSolver::setReceiver(CartesianSolverReceiver *r)
+{
+    lock_guard<mutex> lck(mtx);
+    receiver=r;
 }
 
 
@@ -1376,6 +1540,7 @@ bool CartesianSolver::open(Searchable &options)
     // parse configuration options
     period=options.check("period",Value(CARTSLV_DEFAULT_PER)).asInt32();
     setPeriod((double)period/1000.0);
+    telemetry.setPeriod(getPeriod());
 
     ctrlPose=IKINCTRL_POSE_FULL;
     if (options.check(Vocab32::decode(IKINSLV_VOCAB_OPT_POSE)))
@@ -1395,8 +1560,13 @@ bool CartesianSolver::open(Searchable &options)
     double constr_tol=options.check("constr_tol",Value(CARTSLV_DEFAULT_CONSTR_TOL)).asFloat64();
     int maxIter=options.check("maxIter",Value(CARTSLV_DEFAULT_MAXITER)).asInt32();
 
+    bool exactHessian=true;
+    if (options.check("exact_hessian"))
+        if (options.find("exact_hessian").asVocab32()==IKINSLV_VOCAB_VAL_OFF)
+            exactHessian=false;
+
     // instantiate the optimizer
-    slv=new iKinIpOptMin(*prt->chn,ctrlPose,tol,constr_tol,maxIter);
+    slv=new iKinIpOptMin(*prt->chn,ctrlPose,tol,constr_tol,maxIter,0,exactHessian);
 
     // instantiate solver callback object if required    
     if (options.check("interPoints"))
@@ -1406,6 +1576,10 @@ bool CartesianSolver::open(Searchable &options)
     // enable scaling
     slv->setUserScaling(true,100.0,100.0,100.0);
 
+    // select the linear solver, if required
+    if (options.check("linear_solver"))
+        slv->setLinearSolver(options.find("linear_solver").asString());
+
     // enforce linear inequalities constraints, if any
     if (prt->cns!=NULL)
     {
@@ -1418,6 +1592,30 @@ bool CartesianSolver::open(Searchable &options)
         slv->getLIC().update(NULL);
     }
 
+    // instantiate the solutions cache of the current dof, if required
+    cacheSize=(size_t)std::max(options.check("cache_size",Value(CARTSLV_DEFAULT_CACHE_SIZE)).asInt32(),0);
+    cacheVoxel=options.check("cache_voxel",Value(CARTSLV_DEFAULT_CACHE_VOXEL)).asFloat64();
+    switchDOFContext();
+
+    // instantiate the parallel optimizers, if required
+    int nSeeds=options.check("multistart",Value(CARTSLV_DEFAULT_MULTISTART)).asInt32();
+    msDeadline=options.check("multistart_deadline",Value(CARTSLV_DEFAULT_MULTISTART_DEADLINE)).asFloat64();
+    if (nSeeds>1)
+        allocMultiStart(nSeeds,tol,constr_tol,maxIter);
+
+    int nBatch=options.check("batch_workers",Value(CARTSLV_DEFAULT_BATCH_WORKERS)).asInt32();
+    for (int i=0; i<nBatch; i++)
+        batchWorkers.push_back(allocWorker(tol,constr_tol,maxIter));
+
+    // the parallel instances can share only a re-entrant linear solver
+    string linSolver=slv->getLinearSolver();
+    const char *reentrant[]={"ma27","ma57","ma77","ma86","ma97",
+                             "pardiso","pardisomkl","spral"};
+    linSolverSerial=(std::find(std::begin(reentrant),std::end(reentrant),linSolver)==std::end(reentrant));
+    if (linSolverSerial && ((msWorkers.size()>0) || (batchWorkers.size()>0)))
+        yWarning("%s: linear solver \"%s\" is not re-entrant, the parallel instances will be serialized",
+                 slvName.c_str(),linSolver.c_str());
+
     // set up 2nd task
     xd_2ndTask.resize(3,0.0);
     w_2ndTask.resize(3,0.0);
@@ -1471,6 +1669,9 @@ bool CartesianSolver::changeDOF(const Vector &_dof)
         if (prt->cns!=NULL)
             prt->cns->update(NULL);
 
+        // cached postures refer to the old dof
+        switchDOFContext();
+
         // count uncontrolled joints
         countUncontrolledJoints();
 
@@ -1485,6 +1686,63 @@ bool CartesianSolver::changeDOF(const Vector &_dof)
 }
 
 
+/************************************************************************/
+void CartesianSolver::switchDOFContext()
+{
+    string key;
+    for (size_t i=0; i<dof.length(); i++)
+        key+=(dof[i]!=0.0)?'1':'0';
+
+    if (key==dofKey)
+        return;
+
+    // park the solutions of the current dof
+    if (!dofKey.empty())
+        dofContexts[dofKey].msPool.swap(msPool);
+    msPool.clear();
+
+    auto it=dofContexts.find(key);
+    if (it!=dofContexts.end())
+    {
+        msPool.swap(it->second.msPool);
+        dofContextsLRU.erase(std::find(dofContextsLRU.begin(),dofContextsLRU.end(),key));
+    }
+    else
+    {
+        DOFContext &ctx=dofContexts[key];
+        ctx.cache=(cacheSize>0)?new iKinSolutionCache(cacheVoxel,30.0*CTRL_DEG2RAD,cacheSize):NULL;
+
+        // drop the least recently used dof
+        if (dofContexts.size()>CARTSLV_MAX_DOF_CONTEXTS)
+        {
+            auto lru=dofContexts.find(dofContextsLRU.front());
+            delete lru->second.cache;
+            dofContexts.erase(lru);
+            dofContextsLRU.pop_front();
+        }
+    }
+
+    dofContextsLRU.push_back(key);
+    dofKey=key;
+
+    cache=dofContexts[key].cache;
+    slv->attachSolutionCache(cache);
+}
+
+
+/************************************************************************/
+void CartesianSolver::disposeDOFContexts()
+{
+    for (auto &ctx : dofContexts)
+        delete ctx.second.cache;
+
+    dofContexts.clear();
+    dofContextsLRU.clear();
+    dofKey.clear();
+    cache=NULL;
+}
+
+
 /************************************************************************/
 void CartesianSolver::prepareJointsRestTask()
 {
@@ -1511,9 +1769,358 @@ void CartesianSolver::prepareJointsRestTask()
 }
 
 
+/************************************************************************/
+void MultiStartWorker::start()
+{
+    busy=quit=false;
+    thr=thread(&MultiStartWorker::loop,this);
+}
+
+
+/************************************************************************/
+void MultiStartWorker::post(const function<void()> &_job)
+{
+    unique_lock<mutex> lck(mtx);
+    cv.wait(lck,[this]() { return !busy; });
+    job=_job;
+    busy=true;
+    cv.notify_all();
+}
+
+
+/************************************************************************/
+void MultiStartWorker::stop()
+{
+    {
+        lock_guard<mutex> lck(mtx);
+        quit=true;
+        cv.notify_all();
+    }
+
+    if (thr.joinable())
+        thr.join();
+}
+
+
+/************************************************************************/
+void MultiStartWorker::loop()
+{
+    unique_lock<mutex> lck(mtx);
+    while (true)
+    {
+        cv.wait(lck,[this]() { return quit || busy; });
+        if (quit)
+            break;
+
+        // run the job without holding the lock
+        function<void()> _job;
+        _job.swap(job);
+        lck.unlock();
+        _job();
+        lck.lock();
+
+        busy=false;
+        cv.notify_all();
+    }
+}
+
+
+/************************************************************************/
+MultiStartWorker *CartesianSolver::allocWorker(const double tol, const double constr_tol,
+                                               const int maxIter)
+{
+    MultiStartWorker *w=new MultiStartWorker;
+    w->lmb=new iKinLimb(*prt->lmb);
+    w->cns=(prt->cns!=NULL)?new iKinLinIneqConstr(*prt->cns):NULL;
+    w->slv=new iKinIpOptMin(*w->lmb->asChain(),ctrlPose,tol,constr_tol,maxIter,
+                            0,slv->getHessianOpt());
+    w->slv->setUserScaling(true,100.0,100.0,100.0);
+    string linSolver=slv->getLinearSolver();
+    if (!linSolver.empty())
+        w->slv->setLinearSolver(linSolver);
+    if (w->cns!=NULL)
+        w->slv->attachLIC(*w->cns);
+    w->exit_code=Ipopt::Internal_Error;
+    w->start();
+
+    return w;
+}
+
+
+/************************************************************************/
+void CartesianSolver::allocMultiStart(const int nSeeds, const double tol,
+                                      const double constr_tol, const int maxIter)
+{
+    for (int i=0; i<nSeeds; i++)
+        msWorkers.push_back(allocWorker(tol,constr_tol,maxIter));
+}
+
+
+/************************************************************************/
+void CartesianSolver::alignMultiStartWorker(MultiStartWorker &w)
+{
+    // links get reallocated, hence the 2nd task
+    // chain needs to be specified anew
+    *w.lmb=*prt->lmb;
+    w.slv->specify2ndTaskEndEff(slv->get2ndTaskChain().getN());
+
+    if (w.cns!=NULL)
+        *w.cns=*prt->cns;
+
+    w.slv->set_ctrlPose(slv->get_ctrlPose());
+    w.slv->set_posePriority(slv->get_posePriority());
+
+    // avoid re-initializing ipopt when not needed
+    if (w.slv->getTol()!=slv->getTol())
+        w.slv->setTol(slv->getTol());
+    if (w.slv->getConstrTol()!=slv->getConstrTol())
+        w.slv->setConstrTol(slv->getConstrTol());
+    if (w.slv->getMaxIter()!=slv->getMaxIter())
+        w.slv->setMaxIter(slv->getMaxIter());
+}
+
+
+/************************************************************************/
+void CartesianSolver::disposeMultiStart()
+{
+    for (size_t i=0; i<msWorkers.size(); i++)
+    {
+        msWorkers[i]->stop();
+        delete msWorkers[i]->slv;
+        delete msWorkers[i]->cns;
+        delete msWorkers[i]->lmb;
+        delete msWorkers[i];
+    }
+
+    for (size_t i=0; i<batchWorkers.size(); i++)
+    {
+        batchWorkers[i]->stop();
+        delete batchWorkers[i]->slv;
+        delete batchWorkers[i]->cns;
+        delete batchWorkers[i]->lmb;
+        delete batchWorkers[i];
+    }
+
+    msWorkers.clear();
+    batchWorkers.clear();
+    msPool.clear();
+}
+
+
+/************************************************************************/
+Vector CartesianSolver::solveMultiStart(Vector &xd)
+{
+    // seeds in order of preference: the current configuration,
+    // the cached solution of the closest target, the last solutions,
+    // the rest posture and the middle of the range; the cached one is
+    // only a further candidate and does not replace the current one
+    deque<Vector> seeds;
+    seeds.push_back(prt->chn->getAng());
+
+    Vector qc;
+    if ((cache!=NULL) && cache->lookup(*prt->chn,xd,slv->get_ctrlPose(),qc))
+        seeds.push_back(qc);
+
+    for (size_t i=0; i<msPool.size(); i++)
+        seeds.push_back(msPool[i]);
+    seeds.push_back(qd_3rdTask);
+
+    Vector mid(prt->chn->getDOF());
+    for (unsigned int i=0; i<prt->chn->getDOF(); i++)
+        mid[i]=0.5*((*prt->chn)(i).getMin()+(*prt->chn)(i).getMax());
+    seeds.push_back(mid);
+
+    size_t K=std::min(msWorkers.size(),seeds.size());
+    double weight2ndTask=slv->get2ndTaskChain().getN()>0?CARTSLV_WEIGHT_2ND_TASK:0.0;
+
+    mutex mtx_ms;
+    condition_variable cv_ms;
+    atomic<bool> halt(false);
+    size_t nDone=0;
+    int winner=-1;
+    bool converged=false;
+    bool doneCurrent=false;
+    vector<bool> succeeded(K,false);
+
+    for (size_t k=0; k<K; k++)
+    {
+        MultiStartWorker *w=msWorkers[k];
+        alignMultiStartWorker(*w);
+        w->q0=seeds[k];
+        w->xd=xd;
+
+        w->post([&,w,k]()
+        {
+            {
+                unique_lock<mutex> lck(mtx_linSolver,defer_lock);
+                if (linSolverSerial)
+                    lck.lock();
+
+                w->qd=w->slv->solve(w->q0,w->xd,weight2ndTask,xd_2ndTask,w_2ndTask,
+                                    CARTSLV_WEIGHT_3RD_TASK,qd_3rdTask,w_3rdTask,
+                                    &w->exit_code,halt);
+            }
+
+            lock_guard<mutex> lck(mtx_ms);
+            succeeded[k]=(w->exit_code==Ipopt::Solve_Succeeded) ||
+                         (w->exit_code==Ipopt::Solved_To_Acceptable_Level);
+            converged=converged || succeeded[k];
+            doneCurrent=doneCurrent || (k==0);
+
+            // the other seeds do not cut short the current configuration
+            if (converged && doneCurrent)
+                halt.store(true,memory_order_release);
+
+            nDone++;
+            cv_ms.notify_all();
+        });
+    }
+
+    // wait for an instance to converge along with the one of the
+    // current configuration, or for the deadline
+    {
+        unique_lock<mutex> lck(mtx_ms);
+        auto ready=[&]() { return (converged && doneCurrent) || (nDone==K); };
+        if (msDeadline>0.0)
+            cv_ms.wait_for(lck,chrono::duration<double>(msDeadline),ready);
+        else
+            cv_ms.wait(lck,ready);
+
+        halt.store(true,memory_order_release);
+
+        // the jobs refer to the local variables
+        cv_ms.wait(lck,[&]() { return (nDone==K); });
+    }
+
+    // retain the converged solution closest to the current
+    // configuration, or the best one if no instance converged
+    if (converged)
+    {
+        double bestDist=std::numeric_limits<double>::max();
+        for (size_t k=0; k<K; k++)
+        {
+            if (!succeeded[k])
+                continue;
+
+            double dist=norm(msWorkers[k]->qd-seeds[0]);
+            if (dist<bestDist)
+            {
+                bestDist=dist;
+                winner=(int)k;
+            }
+        }
+    }
+    else
+    {
+        // the solutions are evaluated on the chain of the solver, which stays untouched
+        iKinChainWorkspace ws;
+        double bestCost=std::numeric_limits<double>::max();
+        for (size_t k=0; k<K; k++)
+        {
+            MultiStartWorker *w=msWorkers[k];
+            double cost=multiStartCost(*prt->chn,ws,xd,w->qd,w->slv->get_ctrlPose());
+            if (cost<bestCost)
+            {
+                bestCost=cost;
+                winner=(int)k;
+            }
+        }
+    }
+
+    Vector qd=msWorkers[winner]->qd;
+    prt->chn->setAng(qd);
+
+    if ((cache!=NULL) && converged)
+        cache->insert(*prt->chn,xd,qd);
+
+    // keep the last solutions as seeds for the next requests
+    msPool.push_front(qd);
+    if (msPool.size()>msWorkers.size())
+        msPool.pop_back();
+
+    return qd;
+}
+
+
+/************************************************************************/
+void CartesianSolver::solveBatch(const deque<Vector> &xd, deque<Vector> &qd)
+{
+    // all the targets start from the current configuration
+    Vector q0=prt->chn->getAng();
+    qd.assign(xd.size(),q0);
+
+    double weight2ndTask=slv->get2ndTaskChain().getN()>0?CARTSLV_WEIGHT_2ND_TASK:0.0;
+    deque<MultiStartWorker*> &pool=(batchWorkers.size()>0)?batchWorkers:msWorkers;
+
+    // no parallel instances: solve the targets one after the other
+    if (pool.size()==0)
+    {
+        for (size_t i=0; i<xd.size(); i++)
+        {
+            Vector xd_i=xd[i];
+            qd[i]=slv->solve(q0,xd_i,weight2ndTask,xd_2ndTask,w_2ndTask,
+                             CARTSLV_WEIGHT_3RD_TASK,qd_3rdTask,w_3rdTask);
+        }
+
+        return;
+    }
+
+    mutex mtx_batch;
+    condition_variable cv_batch;
+    size_t next=0;
+    size_t nDone=0;
+
+    size_t K=std::min(pool.size(),xd.size());
+    for (size_t k=0; k<K; k++)
+    {
+        MultiStartWorker *w=pool[k];
+        alignMultiStartWorker(*w);
+
+        w->post([&,w]()
+        {
+            while (true)
+            {
+                size_t i;
+                {
+                    lock_guard<mutex> lck(mtx_batch);
+                    if (next>=xd.size())
+                        break;
+                    i=next++;
+                }
+
+                w->q0=q0;
+                w->xd=xd[i];
+                {
+                    unique_lock<mutex> lck(mtx_linSolver,defer_lock);
+                    if (linSolverSerial)
+                        lck.lock();
+
+                    w->qd=w->slv->solve(w->q0,w->xd,weight2ndTask,xd_2ndTask,w_2ndTask,
+                                        CARTSLV_WEIGHT_3RD_TASK,qd_3rdTask,w_3rdTask,
+                                        &w->exit_code);
+                }
+
+                // each target has its own slot
+                qd[i]=w->qd;
+            }
+
+            lock_guard<mutex> lck(mtx_batch);
+            nDone++;
+            cv_batch.notify_all();
+        });
+    }
+
+    unique_lock<mutex> lck(mtx_batch);
+    cv_batch.wait(lck,[&]() { return (nDone==K); });
+}
+
+
 /************************************************************************/
 Vector CartesianSolver::solve(Vector &xd)
 {
+    if (msWorkers.size()>1)
+        return solveMultiStart(xd);
+
     return slv->solve(prt->chn->getAng(),xd,
                       slv->get2ndTaskChain().getN()>0?CARTSLV_WEIGHT_2ND_TASK:0.0,xd_2ndTask,w_2ndTask,
                       CARTSLV_WEIGHT_3RD_TASK,qd_3rdTask,w_3rdTask,
@@ -1555,6 +2162,10 @@ void CartesianSolver::close()
         outPort=NULL;
     }
 
+    disposeMultiStart();
+
+    disposeDOFContexts();
+
     delete slv;
     delete clb;
     slv=NULL;
@@ -1643,6 +2254,7 @@ void CartesianSolver::resume()
 /************************************************************************/
 void CartesianSolver::run()
 {
+    telemetry.beginCycle();
     lock();
 
     // init conditions
@@ -1655,7 +2267,9 @@ void CartesianSolver::run()
     postDOFHandling();
 
     // get the current configuration
+    telemetry.tic(tmSectionIO);
     getFeedback();
+    telemetry.toc(tmSectionIO);
 
     // acquire uncontrolled joints configuration
     Vector unctrlJoints;
@@ -1710,18 +2324,24 @@ void CartesianSolver::run()
 
         // call the solver to converge
         double t0=Time::now();
+        telemetry.tic(tmSectionIpOpt);
         Vector q=solve(xd);
+        telemetry.toc(tmSectionIpOpt);
         double t1=Time::now();
 
         // q is the estimation of the real qd,
         // so that x is the actual achieved pose
+        telemetry.tic(tmSectionFk);
         Vector x=prt->chn->EndEffPose(q);
+        telemetry.toc(tmSectionFk);
         
         // change to degrees
         q*=CTRL_RAD2DEG;
 
         // send data
+        telemetry.tic(tmSectionIO);
         send(xd,x,q,pToken);
+        telemetry.toc(tmSectionIO);
 
         // dump on screen
         if (verbosity)
@@ -1735,6 +2355,7 @@ void CartesianSolver::run()
     contModeOld=inPort->get_contMode();
 
     unlock();
+    telemetry.endCycle();
 }
 
 
@@ -85,6 +85,15 @@ bool BcbBattery::open(yarp::os::Searchable& config)
     // Other options
     batteryReader->verboseEnable = group_general.check("verbose", Value(0), "enable/disable the verbose mode").asBool();
     batteryReader->screenEnable = group_general.check("screen", Value(0), "enable/disable the screen output").asBool();
+    if (group_general.check("publish_port"))
+    {
+        std::string name = group_general.find("publish_port").asString();
+        double heartbeat = group_general.check("publish_heartbeat", Value(5.0), "seconds between two writes of unchanged readings").asFloat64();
+        if (!batteryReader->publisher.open(name, heartbeat))
+        {
+            yWarning() << "BcbBattery cannot open the port" << name << ", the readings will not be published";
+        }
+    }
 
     //start the thread
     batteryReader->start();
@@ -155,17 +164,8 @@ void batteryReaderThread::run()
     }
 
     //parse battery data
-    std::cmatch cmatch;
-    bool b = std::regex_search((const char*)tmp_buff, (const char*)tmp_buff+recb, cmatch, r_exp);
-
-    if (b)
+    if (findLastPacket(recb))
     {
-        //get the data
-        for (size_t i=0; i< packet_len; i++)
-        {
-            packet[i] = cmatch.str().c_str()[i];
-        }
-
         //add checksum verification.
         //...
 
@@ -182,17 +182,24 @@ void batteryReaderThread::run()
         }
 
         //parse values
+        double voltage = (((unsigned int)(packet[1])) << 8 | packet[2]) / 1000.0;
+        double current = (((unsigned int)(packet[3])) << 8 | packet[4]) / 1000.0;
+        double charge  = (((unsigned int)(packet[5])) << 8 | packet[6]);
+        int    status  = (unsigned int)(packet[7]);
+
         datamut.lock();
-        battery_voltage  = ((unsigned int)(packet[1])) << 8;
-        battery_voltage += (unsigned char)(packet[2]);
-        battery_voltage /= 1000.0;
-        battery_current = ((unsigned int)(packet[3])) << 8;
-        battery_current += (unsigned char)(packet[4]);
-        battery_current /= 1000.0;
-        battery_charge  = ((unsigned int)(packet[5])) << 8;
-        battery_charge += (unsigned char)(packet[6]);
-        backpack_status = (unsigned int)(packet[7]);
+        if (!received || voltage != battery_voltage || current != battery_current ||
+            charge != battery_charge || status != backpack_status)
+        {
+            sequence++;
+        }
+        battery_voltage = voltage;
+        battery_current = current;
+        battery_charge = charge;
+        backpack_status = status;
         battery_status = IBattery::Battery_status::BATTERY_OK_IN_USE;
+        timeStamp = timeNow;
+        received = true;
         datamut.unlock();
     }
     else
@@ -200,6 +207,14 @@ void batteryReaderThread::run()
         //do nothing
     }
 
+    // only when the readings change, or at the heartbeat
+    if (publisher.isOpen() && received)
+    {
+        iCub::dev::BatterySnapshot snapshot;
+        getSnapshot(snapshot);
+        publisher.publish(snapshot);
+    }
+
     // print data to screen
     if (screenEnable)
     {
@@ -261,6 +276,15 @@ bool BcbBattery::getBatteryTemperature(double &temperature)
     return false;
 }
 
+bool BcbBattery::getBatterySnapshot(iCub::dev::BatterySnapshot &snapshot)
+{
+    if (!batteryReader) return false;
+    std::lock_guard<std::mutex> lg(batteryReader->datamut);
+    if (!batteryReader->received) return false;
+    batteryReader->getSnapshot(snapshot);
+    return true;
+}
+
 bool BcbBattery::getBatteryInfo(string &info)
 {
     if (!batteryReader) return false;
@@ -272,6 +296,34 @@ bool BcbBattery::getBatteryInfo(string &info)
 void batteryReaderThread::threadRelease()
 {
     stopTransmission();
+    publisher.close();
+}
+
+bool batteryReaderThread::findLastPacket(int recb)
+{
+    // the packet is \0, seven bytes of data and \r\n: the last complete one in the buffer is the most recent.
+    // the data are binary, a \0, \r or \n among them does not end the packet
+    for (int i = recb - packet_len; i >= 0; i--)
+    {
+        if (tmp_buff[i] == '\0' && tmp_buff[i + packet_len - 2] == '\r' && tmp_buff[i + packet_len - 1] == '\n')
+        {
+            memcpy(packet, tmp_buff + i, packet_len);
+            return true;
+        }
+    }
+    return false;
+}
+
+void batteryReaderThread::getSnapshot(iCub::dev::BatterySnapshot &snapshot)
+{
+    // the caller holds datamut, unless it is run(), which is the only writer
+    snapshot.voltage = battery_voltage;
+    snapshot.current = battery_current;
+    snapshot.charge = battery_charge;
+    snapshot.temperature = std::nan("");
+    snapshot.status = battery_status;
+    snapshot.stamp = timeStamp;
+    snapshot.sequence = sequence;
 }
 
 void batteryReaderThread::startTransmission()
@@ -14,7 +14,7 @@
 #include <yarp/dev/ISerialDevice.h>
 #include <yarp/os/ResourceFinder.h>
 #include <yarp/sig/Vector.h>
-#include <regex>
+#include <iCub/BatterySnapshot.h>
 
 using namespace yarp::os;
 using namespace yarp::dev;
@@ -31,12 +31,10 @@ class batteryReaderThread : public PeriodicThread
     bool               screenEnable = true;
 
     //the buffer
-    double             timeStamp;
     static const int   buff_len = 10000;
     unsigned char      tmp_buff[buff_len];
     static const int   packet_len =10;
     unsigned char      packet[packet_len];
-    std::regex         r_exp;
 
     ISerialDevice*     iSerial = nullptr;
     std::mutex         datamut;
@@ -46,28 +44,29 @@ class batteryReaderThread : public PeriodicThread
     std::string        battery_info = "icub battery system v1.0";
     int                backpack_status = 0;
     IBattery::Battery_status     battery_status = IBattery::Battery_status::BATTERY_OK_STANBY;
+    double             timeStamp = 0;           // of the last packet
+    uint32_t           sequence = 0;            // incremented when the values of a packet differ from the previous ones
+    bool               received = false;
+
+    //optional publication of the readings when they change
+    iCub::dev::BatteryPublisher publisher;
 
     batteryReaderThread (ISerialDevice *_iSerial, double period) :
     PeriodicThread((double)period),
     iSerial(_iSerial)
     {
-       // the following regedit expressions means: search for an occurrence of the pattern:
-       // \0........\r\n which is not followed by any other occurrence of the same pattern.
-       // See for example: https://docs.pexip.com/admin/regex_reference.htm
-       //
-       //                    01234567  8  9*****  01234567  8  9
-       std::string c_exp ("\\0.......\\r\\n(?!.*\\0.......\\r\\n)");
-       r_exp=c_exp;
     }
 
     void startTransmission();
     void stopTransmission();
+    bool findLastPacket(int recb);
+    void getSnapshot(iCub::dev::BatterySnapshot &snapshot);
     virtual bool threadInit() override;
     virtual void threadRelease() override;
     virtual void run() override;
 };
 
-class BcbBattery: public yarp::dev::IBattery, public DeviceDriver
+class BcbBattery: public yarp::dev::IBattery, public iCub::dev::IBatterySnapshot, public DeviceDriver
 {
 protected:
     batteryReaderThread* batteryReader =nullptr;
@@ -89,6 +88,8 @@ public:
     virtual bool getBatteryStatus      (Battery_status &status) override;
     virtual bool getBatteryInfo        (std::string &info) override;
     virtual bool getBatteryTemperature (double &temperature) override;
+
+    virtual bool getBatterySnapshot    (iCub::dev::BatterySnapshot &snapshot) override;
 };
 
 
@@ -48,6 +48,7 @@
 
 #include "canControlConstants.h"
 #include "canControlUtils.h"
+#include "canMessageTimestamp.h"
 
 #ifdef WIN32
     #pragma warning(once:4355)
@@ -377,6 +378,12 @@ public:
 
     bool writePacket ();
 
+    // queue the latest setpoint of a joint, it is sent by flushSetpoints().
+    // it is sent at once if the tx scheduler is not running.
+    bool queueSetpoint (int msg_id, int joint, const unsigned char *payload, int len);
+    // send all the queued setpoints with a single write
+    bool flushSetpoints ();
+
     bool printMessage (const CanMessage &m);
     bool dumpBuffers (void);
     inline int getJoints (void) const { return _njoints; }
@@ -398,6 +405,15 @@ public:
     char buffer[DEBUG_PRINTF_BUFFER_LENGTH];
 public:
     enum { CAN_TIMEOUT = 20, CAN_POLLING_INTERVAL = 10 };
+    enum { TX_SETPOINTS = 4 };/// streaming messages which can be queued for each joint.
+
+    struct TxSetpoint
+    {
+        int msg;/// -1 if the slot is free.
+        int len;
+        unsigned char payload[7];
+        bool pending;
+    };
 
     // HANDLE _handle;/// the actual ddriver handle.
     bool _initialized;
@@ -420,6 +436,16 @@ public:
     CanBuffer _writeBuffer;/// write buffer.
     CanBuffer _replyBuffer;/// reply buffer.
     CanBuffer _echoBuffer;/// echo buffer.
+    CanBuffer _txBuffer;/// buffer of the queued setpoints.
+
+    TxSetpoint *_txSetpoints;/// TX_SETPOINTS slots for each joint.
+    unsigned int _txPending;/// number of setpoints to be sent.
+    bool _txScheduled;/// true when the tx scheduler sends the setpoints.
+
+    unsigned int _txQueued;/// setpoints queued since the last report.
+    unsigned int _txCoalesced;/// setpoints replaced by a newer one before being sent.
+    unsigned int _txFrames;/// frames sent by the tx scheduler.
+    unsigned int _txWrites;/// writes of the tx scheduler.
 
     BCastBufferElement *_bcastRecvBuffer;/// local storage for bcast messages.
 
@@ -441,6 +467,20 @@ public:
 };
 inline CanBusResources& RES(void *res) { return *(CanBusResources *)res; }
 
+// sends the queued setpoints at its own rate, while the thread of CanBusMotionControl reads and decodes the bus
+class CanBusTxScheduler: public PeriodicThread
+{
+    CanBusMotionControl *owner;
+
+public:
+    CanBusTxScheduler(CanBusMotionControl *o, double period) : PeriodicThread(period), owner(o) {}
+
+    void run() override
+    {
+        owner->txRun();
+    }
+};
+
 class TBR_CanBackDoor: public BufferedPort<Bottle>
 {
     CanBusResources *bus;
@@ -727,6 +767,11 @@ data(0)
     status=IAnalogSensor::AS_OK;
     useCalibration=0;
     scaleFactor=0;
+    decodeGain=0;
+    decodeOffset=0;
+    work=0;
+    boardMsgId=0xfff;
+    memset(decodePlan, 0, sizeof(decodePlan));
 
     counterSat=0;
     counterError=0;
@@ -736,10 +781,11 @@ data(0)
 
 TBR_AnalogSensor::~TBR_AnalogSensor()
 {
-    if (!data)
-        delete data;
-    if (!scaleFactor)
-        delete scaleFactor;
+    delete data;
+    delete [] scaleFactor;
+    delete [] decodeGain;
+    delete [] decodeOffset;
+    delete [] work;
 }
 
 int TBR_AnalogSensor::getState(int ch)
@@ -756,8 +802,12 @@ bool TBR_AnalogSensor::open(int channels, AnalogDataFormat f, short bId, short u
 
     data=new TBR_AnalogData(channels, channels+1);
     scaleFactor=new double[channels];
+    decodeGain=new double[channels];
+    decodeOffset=new double[channels];
+    work=new double[channels+1];
     int i=0;
     for (i=0; i<channels; i++) scaleFactor[i]=1;
+    for (i=0; i<channels+1; i++) work[i]=0;
     dataFormat=f;
     boardId=bId;
     useCalibration=useCalib;
@@ -772,9 +822,64 @@ bool TBR_AnalogSensor::open(int channels, AnalogDataFormat f, short bId, short u
         scaleFactor[5]=1;
     }
 
+    buildDecodePlan();
     return true;
 }
 
+void TBR_AnalogSensor::buildDecodePlan()
+{
+    const int channels=data->size();
+
+    // the 16 bits boards send channels 0-2 in group 0xA and 3-5 in 0xB,
+    // the 8 bits boards send channels 0-6 in group 0xC and 7-14 in 0xD.
+    // the groups of the other format are not for us, all the others are unexpected.
+    memset(decodePlan, 0, sizeof(decodePlan));
+    for (int g=0xA; g<=0xD; g++)
+        decodePlan[g].expected=true;
+
+    if (dataFormat==ANALOG_FORMAT_16)
+    {
+        decodePlan[0xA].first=0;
+        decodePlan[0xA].count=3;
+        decodePlan[0xB].first=3;
+        decodePlan[0xB].count=3;
+    }
+    else
+    {
+        decodePlan[0xC].first=0;
+        decodePlan[0xC].count=7;
+        decodePlan[0xD].first=7;
+        decodePlan[0xD].count=8;
+    }
+
+    // do not write beyond the configured channels
+    for (int g=0; g<16; g++)
+    {
+        DecodeGroup &d=decodePlan[g];
+        if (d.first+d.count>channels)
+            d.count=(d.first<channels) ? channels-d.first : 0;
+    }
+
+    for (int k=0; k<channels; k++)
+    {
+        if (dataFormat==ANALOG_FORMAT_16)
+        {
+            decodeOffset[k]=-0x8000;
+            decodeGain[k]=(useCalibration==1) ? scaleFactor[k]/double(0x8000) : 1.0;
+        }
+        else
+        {
+            decodeOffset[k]=0;
+            decodeGain[k]=1.0;
+        }
+    }
+
+    if (boardId>=0 && boardId<=0xf)
+        boardMsgId=0x300|(boardId<<4);
+    else
+        boardMsgId=0xfff; // never matches a message id masked with 0x7f0
+}
+
 
 int TBR_AnalogSensor::getChannels()
 {
@@ -837,101 +942,27 @@ int TBR_AnalogSensor::calibrateSensor()
     return AS_OK;
 }
 
-bool TBR_AnalogSensor::decode16(const unsigned char *msg, int id, double *data)
+// the decoding kernels: fixed per-channel gain and offset, no branches, so that the compiler can vectorize them
+static inline void decodeWords16(const unsigned char *msg, int count, const double *offset, const double *gain, double *out)
 {
-    
-    const char groupId=(id&0x00f);
-    int baseIndex=0;
-    {
-        switch (groupId)
-        {
-        case 0xA:
-            {
-                for(int k=0;k<3;k++)
-                    {
-                        data[k]=(((unsigned short)(msg[2*k+1]))<<8)+msg[2*k]-0x8000;
-                        if (useCalibration==1)
-                        {
-                            data[k]=data[k]*scaleFactor[k]/float(0x8000);
-                        }
-                    }
-            }
-            break;
-        case 0xB:
-            {
-                for(int k=0;k<3;k++)
-                    {
-                        data[k+3]=(((unsigned short)(msg[2*k+1]))<<8)+msg[2*k]-0x8000;
-                        if (useCalibration==1)
-                        {
-                            data[k+3]=data[k+3]*scaleFactor[k+3]/float(0x8000);
-                        }
-                    }
-            }
-            break;
-        case 0xC:
-            {} //skip these, they are not for us
-            break;
-        case 0xD:
-            {} //skip these, they are not for us
-            break;
-        default:
-            yError("Got unexpected class 0x3 msg(s)\n");
-            return false;
-            break;
-        }
-        //@@@DEBUG ONLY
-        //yDebug("   %+8.1f %+8.1f %+8.1f %+8.1f %+8.1f %+8.1f\n",data[0],data[1],data[2],data[3],data[4],data[5],data[6]);
-    }
-
-    return true;
+    for (int k=0; k<count; k++)
+        out[k]=(double((msg[2*k+1]<<8)|msg[2*k])+offset[k])*gain[k];
 }
 
-bool TBR_AnalogSensor::decode8(const unsigned char *msg, int id, double *data)
+static inline void decodeBytes8(const unsigned char *msg, int count, const double *offset, const double *gain, double *out)
 {
-    const char groupId=(id&0x00f);
-    int baseIndex=0;
-    {
-        switch (groupId)
-        {
-        case 0xC:
-            {
-                for(int k=0;k<=6;k++)
-                    data[k]=msg[k];
-            }
-            break;
-        case 0xD:
-            {
-                for(int k=0;k<=7;k++)
-                    data[7+k]=msg[k];
-            }
-            break;
-        case 0xA:
-            {} //skip these, they are not for us
-            break;
-        case 0xB:
-            {} //skip these, they are not for us
-            break;
-        default:
-            yWarning("Got unexpected class 0x3 msg(s): groupId 0x%x\n", groupId);
-            return false;
-            break;
-        }
-    }
-    return true;
+    for (int k=0; k<count; k++)
+        out[k]=(double(msg[k])+offset[k])*gain[k];
 }
 
-
 bool TBR_AnalogSensor::handleAnalog(void *canbus)
 {
     CanBusResources& r = RES (canbus);
 
-    unsigned int i=0;
-    const int _networkN=r._networkN;
-
     bool ret=true; //return true by default
-
-    std::lock_guard<std::mutex> lck(mtx);
+    bool updated=false;
+    short newStatus=IAnalogSensor::AS_OK;
+    double newStamp=0;
 
     double timeNow=Time::now();
     for (unsigned int buff_num=0; buff_num<2; buff_num++)
@@ -949,58 +980,65 @@ bool TBR_AnalogSensor::handleAnalog(void *canbus)
             buffer_pointer = &r._echoBuffer;
         }
 
-        for (i = 0; i < size; i++)
+        for (unsigned int i = 0; i < size; i++)
         {
-            unsigned int len=0;
-            unsigned int msgid=0;
-            unsigned char *buff=0;
             CanMessage& m = (*buffer_pointer)[i];
-            buff=m.getData();
-            msgid=m.getId();
-            len=m.getLen();
-        
-            status=IAnalogSensor::AS_OK;
-            const char type=((msgid&0x700)>>8);
-            const char id=((msgid&0x0f0)>>4);
+            const unsigned int msgid=m.getId();
 
-            if (type==0x03) //analog data
-                {
-                    if (id==boardId)
-                    {
-                        timeStamp=Time::now();
-                        switch (dataFormat)
-                        {
-                            case ANALOG_FORMAT_8:
-                                ret=decode8(buff, msgid, data->getBuffer());
-                                status=IAnalogSensor::AS_OK;
-                                break;
-                            case ANALOG_FORMAT_16:
-                                if (len==6) 
-                                {
-                                    ret=decode16(buff, msgid, data->getBuffer());
-                                    status=IAnalogSensor::AS_OK;
-                                }
-                                else
-                                {
-                                    if (len==7 && buff[6] == 1)
-                                    {
-                                        status=IAnalogSensor::AS_OVF;
-                                    }
-                                    else
-                                    {
-                                        status=IAnalogSensor::AS_ERROR;
-                                    }
-                                    ret=decode16(buff, msgid, data->getBuffer());
-                                }
-                                break;
-                            default:
-                                ret=false;
-                        }
-                    }
-                }
+            // class 3 (analog data) from our board
+            if ((msgid&0x7f0)!=boardMsgId)
+                continue;
+
+            timeStamp=timeNow;
+            const char groupId=(msgid&0x00f);
+            const DecodeGroup &g=decodePlan[(int)groupId];
+            if (!g.expected)
+            {
+                if (dataFormat==ANALOG_FORMAT_16)
+                    yError("Got unexpected class 0x3 msg(s)\n");
+                else
+                    yWarning("Got unexpected class 0x3 msg(s): groupId 0x%x\n", groupId);
+                ret=false;
+                continue;
+            }
+
+            if (g.count==0)
+                continue; //skip these, they are not for us
+
+            const unsigned char *buff=m.getData();
+            if (dataFormat==ANALOG_FORMAT_16)
+            {
+                const unsigned int len=m.getLen();
+                if (len==6)
+                    newStatus=IAnalogSensor::AS_OK;
+                else if (len==7 && buff[6] == 1)
+                    newStatus=IAnalogSensor::AS_OVF;
+                else
+                    newStatus=IAnalogSensor::AS_ERROR;
+
+                decodeWords16(buff, g.count, decodeOffset+g.first, decodeGain+g.first, work+g.first);
+            }
+            else
+            {
+                newStatus=IAnalogSensor::AS_OK;
+                decodeBytes8(buff, g.count, decodeOffset+g.first, decodeGain+g.first, work+g.first);
+            }
+
+            newStamp=getRxTimestamp(m, timeNow);
+            updated=true;
         }
     }
 
+    // the values have been decoded into work without holding the lock: now they are published
+    std::lock_guard<std::mutex> lck(mtx);
+
+    if (updated)
+    {
+        memcpy(data->getBuffer(), work, sizeof(double)*data->size());
+        lastStamp.update(newStamp);
+        status=newStatus;
+    }
+
     //if 100ms have passed since the last received message
     if (timeStamp+0.1<timeNow)
         {
@@ -1010,6 +1048,12 @@ bool TBR_AnalogSensor::handleAnalog(void *canbus)
     return ret;
 }
 
+yarp::os::Stamp TBR_AnalogSensor::getLastInputStamp()
+{
+    std::lock_guard<std::mutex> lck(mtx);
+    return lastStamp;
+}
+
 
 bool CanBusMotionControlParameters:: setBroadCastMask(Bottle &list, int MASK)
 {
@@ -1253,6 +1297,11 @@ bool CanBusMotionControlParameters::fromConfig(yarp::os::Searchable &p)
 
     _polling_interval=canGroup.check("CanPollingInterval",Value(20),
                                         "polling period").asInt32();
+
+    _txPeriod=canGroup.check("CanTxPeriod",Value(0),
+                                "period of the tx scheduler of the setpoints, 0 to send them at once").asInt32();
+    if (_txPeriod<0)
+        _txPeriod=0;
     
     _timeout=canGroup.check("CanTimeout",Value(20),"timeout period").asInt32();
 
@@ -1907,6 +1956,7 @@ CanBusMotionControlParameters::CanBusMotionControlParameters()
 
     _my_address = 0;
     _polling_interval = 10;
+    _txPeriod = 0;
     _timeout = 20;
     _njoints = 0;
 
@@ -1966,6 +2016,7 @@ bool CanBusMotionControlParameters::alloc(int nj)
 
     _my_address = 0;
     _polling_interval = 10;
+    _txPeriod = 0;
     _timeout = 20;
     _njoints = nj;
 
@@ -2052,6 +2103,14 @@ CanBusResources::CanBusResources ()
     _echoMessages = 0;
     _bcastRecvBuffer = NULL;
 
+    _txSetpoints = 0;
+    _txPending = 0;
+    _txScheduled = false;
+    _txQueued = 0;
+    _txCoalesced = 0;
+    _txFrames = 0;
+    _txWrites = 0;
+
     _error_status = true;
     requestsQueue=0;
 }
@@ -2200,6 +2259,15 @@ bool CanBusResources::initialize (const CanBusMotionControlParameters& parms)
     _echoBuffer=iBufferFactory->createBuffer(BUF_SIZE);
     yDebug("Can read/write buffers created, buffer size: %d\n", BUF_SIZE);
 
+    _txBuffer=iBufferFactory->createBuffer(_njoints*TX_SETPOINTS);
+    _txSetpoints=allocAndCheck<TxSetpoint>(_njoints*TX_SETPOINTS);
+    for (int k = 0; k < _njoints*TX_SETPOINTS; k++)
+    {
+        _txSetpoints[k].msg=-1;
+        _txSetpoints[k].pending=false;
+    }
+    _txPending=0;
+
     requestsQueue = new RequestsQueue(_njoints, ICUBCANPROTO_POL_MC_CMD_MAXNUM);
 
     _initialized=true;
@@ -2225,9 +2293,14 @@ bool CanBusResources::uninitialize ()
         iBufferFactory->destroyBuffer(_writeBuffer);
         iBufferFactory->destroyBuffer(_replyBuffer);
         iBufferFactory->destroyBuffer(_echoBuffer);
+        iBufferFactory->destroyBuffer(_txBuffer);
         _initialized=false;
     }
 
+    checkAndDestroy<TxSetpoint> (_txSetpoints);
+    _txPending=0;
+    _txScheduled=false;
+
     if (requestsQueue!=0)
     {
         delete requestsQueue;
@@ -2310,6 +2383,10 @@ bool CanBusResources::writePacket ()
     if (_writeMessages < 1)
         return false;
 
+    // the queued setpoints were asked before this packet, they must reach the boards first
+    if (_txPending > 0)
+        flushSetpoints();
+
     unsigned int sent=0;
 
     DEBUG_FUNC("Sending buffer:\n");
@@ -2328,6 +2405,73 @@ bool CanBusResources::writePacket ()
     return true;
 }
 
+bool CanBusResources::queueSetpoint (int msg_id, int joint, const unsigned char *payload, int len)
+{
+    TxSetpoint *slot=0;
+    if (_txScheduled)
+    {
+        TxSetpoint *slots=&_txSetpoints[joint*TX_SETPOINTS];
+        for (int k=0; k<TX_SETPOINTS && slot==0; k++)
+        {
+            if (slots[k].msg==msg_id || slots[k].msg==-1)
+                slot=&slots[k];
+        }
+    }
+
+    if (slot==0)
+    {
+        startPacket();
+        addMessage (msg_id, joint);
+        memcpy(_writeBuffer[0].getData()+1, payload, len);
+        _writeBuffer[0].setLen(1+len);
+        return writePacket();
+    }
+
+    _txQueued++;
+    if (slot->pending)
+        _txCoalesced++;
+    else
+        _txPending++;
+
+    slot->msg=msg_id;
+    slot->len=len;
+    memcpy(slot->payload, payload, len);
+    slot->pending=true;
+    return true;
+}
+
+bool CanBusResources::flushSetpoints ()
+{
+    if (_txPending == 0)
+        return true;
+
+    unsigned int n=0;
+    for (int k=0; k<_njoints*TX_SETPOINTS; k++)
+    {
+        TxSetpoint &s=_txSetpoints[k];
+        if (!s.pending)
+            continue;
+
+        const int joint=k/TX_SETPOINTS;
+        CanMessage &m=_txBuffer[n++];
+        unsigned char *data=m.getData();
+        data[0]=s.msg;
+        if ((joint % 2) == 1)
+            data[0] |= 0x80;
+        memcpy(data+1, s.payload, s.len);
+        m.setId(_destinations[joint/2] & 0x0f);
+        m.setLen(1+s.len);
+        s.pending=false;
+    }
+    _txPending=0;
+
+    unsigned int sent=0;
+    bool res=iCanBus->canWrite(_txBuffer, n, &sent);
+    _txFrames+=sent;
+    _txWrites++;
+    return res;
+}
+
 bool CanBusResources::printMessage (const CanMessage& m)
 {
     unsigned int id;
@@ -2425,6 +2569,8 @@ ImplementCurrentControl(this)
     _ref_torques=0;
     _last_position_move_time = 0;
     mServerLogger = NULL;
+    threadPool = 0;
+    txScheduler = 0;
 }
 
 
@@ -2676,11 +2822,23 @@ bool CanBusMotionControl::open (Searchable &config)
 
         }
 
-    threadPool = new ThreadPool2(res.iBufferFactory);
+    // run() times out the requests after CanTimeout: the threads wait longer only if run() has stopped
+    threadPool = new ThreadPool2(res.iBufferFactory, 1.0 + 10.0*p._timeout/1000.0);
 
     PeriodicThread::setPeriod((double)p._polling_interval/1000.0);
     PeriodicThread::start();
 
+    if (p._txPeriod>0)
+    {
+        txScheduler = new CanBusTxScheduler(this, (double)p._txPeriod/1000.0);
+        res._txScheduled=true;
+        if (!txScheduler->start())
+        {
+            yError("%s [%d] cannot start the tx scheduler, the setpoints are sent at once\n", canDevName.c_str(), p._networkN);
+            res._txScheduled=false;
+        }
+    }
+
     //get firmware versions
     firmware_info* info = new firmware_info[p._njoints];
     can_protocol_info icub_interface_protocol;
@@ -2699,6 +2857,8 @@ bool CanBusMotionControl::open (Searchable &config)
     ////////////////////////////
     if (!_firmwareVersionHelper->checkFirmwareVersions())
     {
+        if (txScheduler != 0)
+            txScheduler->stop();
         PeriodicThread::stop();
         _opened = false;
         yError() << "checkFirmwareVersions() failed. CanBusMotionControl::open returning false,";
@@ -2933,6 +3093,10 @@ TBR_AnalogSensor *CanBusMotionControl::instantiateAnalog(yarp::os::Searchable& c
                         analogSensor->getScaleFactor()[5]);
             #endif
         }
+
+        // the scale factors are known only now
+        if (analogSensor->isOpen())
+            analogSensor->buildDecodePlan();
     }
     return analogSensor;
 }
@@ -2991,6 +3155,14 @@ bool CanBusMotionControl::close (void)
                 setBCastMessages(i, 0x00);
         }
 
+        if (txScheduler != 0)
+        {
+            txScheduler->stop();
+            std::lock_guard<std::recursive_mutex> lck(_mutex);
+            res._txScheduled=false;
+            res.flushSetpoints();
+        }
+
         PeriodicThread::stop ();/// stops the thread first (joins too).
 
         ImplementPositionControl::uninitialize();
@@ -3033,6 +3205,8 @@ bool CanBusMotionControl::close (void)
 
     if (threadPool != 0)
        {delete threadPool; threadPool = 0;}
+    if (txScheduler != 0)
+       {delete txScheduler; txScheduler = 0;}
     if (_axisTorqueHelper != 0)
        {delete _axisTorqueHelper; _axisTorqueHelper = 0;}
     if (_firmwareVersionHelper != 0)
@@ -3084,6 +3258,8 @@ void CanBusMotionControl::handleBroadcasts()
             data=m.getData();
             id=m.getId();
             len=m.getLen();
+            // the time of reception given by the driver, if it has one (e.g. socketcan with canRxTimestamps)
+            const double rxstamp=getRxTimestamp(m, before);
 
             if ((id & 0x700) == 0x300) // class = 3 These messages come from analog sensors
             {
@@ -3107,7 +3283,7 @@ void CanBusMotionControl::handleBroadcasts()
                                     r._bcastRecvBuffer[axis]._torque=(((unsigned short)(data[2*chan+1]))<<8)+data[2*chan]-0x8000;
                                     r._bcastRecvBuffer[axis]._torque=r._bcastRecvBuffer[axis]._torque*scaleFactor;
                                     //r._bcastRecvBuffer[axis]._torque=0;
-                                    r._bcastRecvBuffer[axis]._update_t = before;
+                                    r._bcastRecvBuffer[axis]._update_t = rxstamp;
                                 }
                             }
                         }
@@ -3182,17 +3358,17 @@ void CanBusMotionControl::handleBroadcasts()
                     case ICUBCANPROTO_PER_MC_MSG__POSITION:
                         {
                             // r._bcastRecvBuffer[j]._position = *((int *)(data));
-                            // r._bcastRecvBuffer[j]._update_p = before;
+                            // r._bcastRecvBuffer[j]._update_p = rxstamp;
                             int tmp=*((int *)(data));
-                            r._bcastRecvBuffer[j]._position_joint.update(tmp, before);
+                            r._bcastRecvBuffer[j]._position_joint.update(tmp, rxstamp);
 
                             j++;
                             if (j < r.getJoints())
                                 {
                                     tmp =*((int *)(data+4));
                                     //r._bcastRecvBuffer[j]._position = *((int *)(data+4));
-                                    //r._bcastRecvBuffer[j]._update_p = before;
-                                    r._bcastRecvBuffer[j]._position_joint.update(tmp, before);
+                                    //r._bcastRecvBuffer[j]._update_p = rxstamp;
+                                    r._bcastRecvBuffer[j]._position_joint.update(tmp, rxstamp);
                                 }
                         }
                         break;
@@ -3200,17 +3376,17 @@ void CanBusMotionControl::handleBroadcasts()
                     case ICUBCANPROTO_PER_MC_MSG__MOTOR_POSITION:
                         {
                             // r._bcastRecvBuffer[j]._position = *((int *)(data));
-                            // r._bcastRecvBuffer[j]._update_p = before;
+                            // r._bcastRecvBuffer[j]._update_p = rxstamp;
                             int tmp=*((int *)(data));
-                            r._bcastRecvBuffer[j]._position_rotor.update(tmp, before);
+                            r._bcastRecvBuffer[j]._position_rotor.update(tmp, rxstamp);
 
                             j++;
                             if (j < r.getJoints())
                                 {
                                     tmp =*((int *)(data+4));
                                     //r._bcastRecvBuffer[j]._position = *((int *)(data+4));
-                                    //r._bcastRecvBuffer[j]._update_p = before;
-                                    r._bcastRecvBuffer[j]._position_rotor.update(tmp, before);
+                                    //r._bcastRecvBuffer[j]._update_p = rxstamp;
+                                    r._bcastRecvBuffer[j]._position_rotor.update(tmp, rxstamp);
                                 }
                         }
                         break;
@@ -3219,18 +3395,18 @@ void CanBusMotionControl::handleBroadcasts()
                     {
                         int tmp;
                         tmp =*((short *)(data));
-                        r._bcastRecvBuffer[j]._speed_rotor.update(tmp, before);
+                        r._bcastRecvBuffer[j]._speed_rotor.update(tmp, rxstamp);
                         tmp =*((short *)(data+4));
-                        r._bcastRecvBuffer[j]._accel_rotor.update(tmp, before);
-                        r._bcastRecvBuffer[j]._update_s = before;
+                        r._bcastRecvBuffer[j]._accel_rotor.update(tmp, rxstamp);
+                        r._bcastRecvBuffer[j]._update_s = rxstamp;
                         j++;
                         if (j < r.getJoints())
                         {
                             tmp =*((short *)(data+2));
-                            r._bcastRecvBuffer[j]._speed_rotor.update(tmp, before);
+                            r._bcastRecvBuffer[j]._speed_rotor.update(tmp, rxstamp);
                             tmp =*((short *)(data+6));
-                            r._bcastRecvBuffer[j]._accel_rotor.update(tmp, before);
-                            r._bcastRecvBuffer[j]._update_s = before;
+                            r._bcastRecvBuffer[j]._accel_rotor.update(tmp, rxstamp);
+                            r._bcastRecvBuffer[j]._update_s = rxstamp;
                         }
                         break;
                     }
@@ -3240,27 +3416,27 @@ void CanBusMotionControl::handleBroadcasts()
                         {
                             int tmp=0; //*((int *)(data));
                             r._bcastRecvBuffer[j]._torque=tmp;
-                            r._bcastRecvBuffer[j]._update_t=before;
+                            r._bcastRecvBuffer[j]._update_t=rxstamp;
 
                             j++;
                             if (j < r.getJoints())
                                 {
                                     tmp = 0;//*((int *)(data+4));
                                     r._bcastRecvBuffer[j]._torque=tmp;
-                                    r._bcastRecvBuffer[j]._update_t=before;
+                                    r._bcastRecvBuffer[j]._update_t=rxstamp;
                                 }
                         }
     #endif
 
                     case ICUBCANPROTO_PER_MC_MSG__PID_VAL:
                         r._bcastRecvBuffer[j]._pid_value = *((short *)(data));
-                        r._bcastRecvBuffer[j]._update_v = before;
+                        r._bcastRecvBuffer[j]._update_v = rxstamp;
 
                         j++;
                         if (j < r.getJoints())
                         {
                             r._bcastRecvBuffer[j]._pid_value = *((short *)(data+2));
-                            r._bcastRecvBuffer[j]._update_v = before;
+                            r._bcastRecvBuffer[j]._update_v = rxstamp;
                         }
                         break;
 
@@ -3269,7 +3445,7 @@ void CanBusMotionControl::handleBroadcasts()
                         r._bcastRecvBuffer[j]._axisStatus= *((short *)(data));
                         r._bcastRecvBuffer[j]._canStatus= *((char *)(data+4));
                         r._bcastRecvBuffer[j]._boardStatus= *((char *)(data+5));
-                        r._bcastRecvBuffer[j]._update_e = before;
+                        r._bcastRecvBuffer[j]._update_e = rxstamp;
                         r._bcastRecvBuffer[j]._controlmodeStatus=*((char *)(data+1));
                         r._bcastRecvBuffer[j]._address=addr;
                         r._bcastRecvBuffer[j]._canTxError+=*((char *) (data+6));
@@ -3356,7 +3532,7 @@ void CanBusMotionControl::handleBroadcasts()
                         {
                             r._bcastRecvBuffer[j]._address=addr;
                             r._bcastRecvBuffer[j]._axisStatus= *((short *)(data+2));
-                            r._bcastRecvBuffer[j]._update_e = before;    
+                            r._bcastRecvBuffer[j]._update_e = rxstamp;    
                             r._bcastRecvBuffer[j]._controlmodeStatus=*((char *)(data+3));
                             // r._bcastRecvBuffer[j].ControlStatus(r._networkN, r._bcastRecvBuffer[j]._controlmodeStatus,addr); 
                         
@@ -3388,36 +3564,36 @@ void CanBusMotionControl::handleBroadcasts()
 
                     case ICUBCANPROTO_PER_MC_MSG__ADDITIONAL_STATUS:
                         r._bcastRecvBuffer[j]._interactionmodeStatus=*((char *)(data)) & 0x0F;
-                        r._bcastRecvBuffer[j]._update_e2 = before;
+                        r._bcastRecvBuffer[j]._update_e2 = rxstamp;
                         j++;
                         if (j < r.getJoints())
                         {
                             r._bcastRecvBuffer[j]._interactionmodeStatus=(*((char *)(data)) >> 4) & 0x0F;
-                            r._bcastRecvBuffer[j]._update_e2 = before;
+                            r._bcastRecvBuffer[j]._update_e2 = rxstamp;
                         }
                         break;
 
                     case ICUBCANPROTO_PER_MC_MSG__CURRENT:
                         r._bcastRecvBuffer[j]._current = *((short *)(data));
-                        r._bcastRecvBuffer[j]._update_c = before;
+                        r._bcastRecvBuffer[j]._update_c = rxstamp;
                         j++;
                         if (j < r.getJoints())
                         {
                             r._bcastRecvBuffer[j]._current = *((short *)(data+2));
-                            r._bcastRecvBuffer[j]._update_c = before;
+                            r._bcastRecvBuffer[j]._update_c = rxstamp;
                         }
                         break;
 
                     case ICUBCANPROTO_PER_MC_MSG__PID_ERROR:
                         r._bcastRecvBuffer[j]._position_error = *((short *)(data));
                         r._bcastRecvBuffer[j]._torque_error =   *((short *)(data+4));
-                        r._bcastRecvBuffer[j]._update_r = before;
+                        r._bcastRecvBuffer[j]._update_r = rxstamp;
                         j++;
                         if (j < r.getJoints())
                         {
                             r._bcastRecvBuffer[j]._position_error = *((short *)(data+2));
                             r._bcastRecvBuffer[j]._torque_error = *((short *)(data+6));
-                            r._bcastRecvBuffer[j]._update_r = before;
+                            r._bcastRecvBuffer[j]._update_r = rxstamp;
                         }
                         break;
 
@@ -3425,13 +3601,13 @@ void CanBusMotionControl::handleBroadcasts()
                         // also receives the acceleration values.
                         r._bcastRecvBuffer[j]._speed_joint = *((short *)(data));
                         r._bcastRecvBuffer[j]._accel_joint = *((short *)(data+4));
-                        r._bcastRecvBuffer[j]._update_s = before;
+                        r._bcastRecvBuffer[j]._update_s = rxstamp;
                         j++;
                         if (j < r.getJoints())
                         {
                             r._bcastRecvBuffer[j]._speed_joint = *((short *)(data+2));
                             r._bcastRecvBuffer[j]._accel_joint = *((short *)(data+6));
-                            r._bcastRecvBuffer[j]._update_s = before;
+                            r._bcastRecvBuffer[j]._update_s = rxstamp;
                         }
                         break;
 
@@ -3463,6 +3639,9 @@ bool CanBusMotionControl::threadInit()
     currentRun=0;
     myCount=-1;
     lastReportTime=Time::now();
+    rxFrames=0;
+    rxMaxFrames=0;
+    lastTxReportTime=lastReportTime;
 
     return true;
 }
@@ -3539,13 +3718,17 @@ void CanBusMotionControl:: run()
             double avThTime=1000.0*getEstimatedUsed();//averageThreadTime/myCount;
             unsigned int it=getIterations();
             resetStat();
-            yDebug("%s [%d] thread ran %d times, req.dT:%d[ms], av.dT:%.2lf[ms] av.loopT :%.2lf[ms]\n", 
+            yDebug("%s [%d] rx thread ran %d times, req.dT:%d[ms], av.dT:%.2lf[ms] av.loopT :%.2lf[ms], frames:%u max/cycle:%u\n", 
                     canDevName.c_str(),
                     r._networkN, 
                     it, 
                     r._polling_interval,
                     avPeriod,
-                    avThTime);
+                    avThTime,
+                    rxFrames,
+                    rxMaxFrames);
+            rxFrames=0;
+            rxMaxFrames=0;
 
             const char *can=canDevName.c_str();
             logNetworkData(can,r._networkN,10,yarp::os::Value(r._polling_interval));
@@ -3737,13 +3920,19 @@ void CanBusMotionControl:: run()
             averageThreadTime=0;
         }
 
+    // the bus is read before taking the mutex: the commands of the other threads and of
+    // the tx scheduler do not wait for the driver. only this thread uses _readBuffer.
+    if (r.read () != true)
+        r.printMessage("%s [%d] CAN: read failed\n", canDevName.c_str(), r._networkN);
+
+    rxFrames+=r._readMessages;
+    if (r._readMessages>rxMaxFrames)
+        rxMaxFrames=r._readMessages;
+
     //DEBUG_FUNC("CanBusMotionControl::thread running [%d]: wait\n", mycount);
     _mutex.lock();
     //DEBUG_FUNC("posted\n");
 
-    if (r.read () != true)
-        r.printMessage("%s [%d] CAN: read failed\n", canDevName.c_str(), r._networkN);
-
     // handle all broadcast messages.
     // (class 1, 8 bits of the ID used to define the message type and source address).
 
@@ -3828,6 +4017,38 @@ void CanBusMotionControl:: run()
     previousRun=before; //save last run time
 }
 
+void CanBusMotionControl::txRun()
+{
+    CanBusResources& r = RES (system_resources);
+    std::lock_guard<std::recursive_mutex> lck(_mutex);
+
+    if (!r.flushSetpoints())
+        r.printMessage("%s [%d] CAN: write of the setpoints failed\n", canDevName.c_str(), r._networkN);
+
+    double now = Time::now();
+    if ((now-lastTxReportTime)>REPORT_PERIOD)
+    {
+        yDebug("%s [%d] tx thread ran %d times, req.dT:%d[ms], av.dT:%.2lf[ms] av.loopT :%.2lf[ms], setpoints:%u coalesced:%u frames:%u writes:%u\n",
+                canDevName.c_str(),
+                r._networkN,
+                txScheduler->getIterations(),
+                (int)(1000.0*txScheduler->getPeriod()+0.5),
+                1000.0*txScheduler->getEstimatedPeriod(),
+                1000.0*txScheduler->getEstimatedUsed(),
+                r._txQueued,
+                r._txCoalesced,
+                r._txFrames,
+                r._txWrites);
+
+        txScheduler->resetStat();
+        r._txQueued=0;
+        r._txCoalesced=0;
+        r._txFrames=0;
+        r._txWrites=0;
+        lastTxReportTime=now;
+    }
+}
+
 
     // ControlMode
 bool CanBusMotionControl::getControlModesRaw(int *v)
@@ -4832,7 +5053,8 @@ bool CanBusMotionControl::setRefTorqueRaw (int j, double ref_trq)
         return false;
 
     //I'm sending a DWORD but the value MUST be clamped to S_16. Do not change.
-    return _writeDWord (ICUBCANPROTO_POL_MC_CMD__SET_DESIRED_TORQUE, axis, S_16(ref_trq));
+    int value = S_16(ref_trq);
+    return _writeSetpoint (ICUBCANPROTO_POL_MC_CMD__SET_DESIRED_TORQUE, axis, &value, sizeof(value));
 }
 
 bool CanBusMotionControl::setRefTorquesRaw(const int n_joint, const int *joints, const double *t)
@@ -4868,7 +5090,8 @@ bool CanBusMotionControl::setRefTorquesRaw (const double *ref_trqs)
     for (i = 0; i < r.getJoints(); i++)
     {
         //I'm sending a DWORD but the value MUST be clamped to S_16. Do not change.
-        if (_writeDWord (ICUBCANPROTO_POL_MC_CMD__SET_DESIRED_TORQUE, i, S_16(ref_trqs[i])) != true)
+        int value = S_16(ref_trqs[i]);
+        if (_writeSetpoint (ICUBCANPROTO_POL_MC_CMD__SET_DESIRED_TORQUE, i, &value, sizeof(value)) != true)
             return false;
     }
 
@@ -5934,29 +6157,17 @@ bool CanBusMotionControl::velocityMoveRaw (int axis, double sp)
 
     std::lock_guard<std::recursive_mutex> lck(_mutex);
 
-    r.startPacket();
+    _ref_command_speeds[axis] = sp / 1000.0;
 
-    if (ENABLED (axis))
-    {
-        r.addMessage (ICUBCANPROTO_POL_MC_CMD__VELOCITY_MOVE, axis);
-        const int j = r._writeMessages - 1;
-        _ref_command_speeds[axis] = sp / 1000.0;
-
-        *((short*)(r._writeBuffer[j].getData() + 1)) = S_16(r._velShifts[axis] * _ref_command_speeds[axis]);/// speed
-
-        if (r._velShifts[axis]*_ref_accs[axis]>1)
-            *((short*)(r._writeBuffer[j].getData()+3)) = S_16(r._velShifts[axis]*_ref_accs[axis]);/// accel
-        else
-            *((short*)(r._writeBuffer[j].getData()+3)) = S_16(1);
+    short payload[2];
+    payload[0] = S_16(r._velShifts[axis] * _ref_command_speeds[axis]);/// speed
 
-        r._writeBuffer[j].setLen(5);
-    }
+    if (r._velShifts[axis]*_ref_accs[axis]>1)
+        payload[1] = S_16(r._velShifts[axis]*_ref_accs[axis]);/// accel
     else
-    {
-        _ref_command_speeds[axis] = sp / 1000.0;
-    }
+        payload[1] = S_16(1);
 
-    r.writePacket();
+    _writeSetpoint (ICUBCANPROTO_POL_MC_CMD__VELOCITY_MOVE, axis, payload, sizeof(payload));
     return true;
 }
 
@@ -6669,7 +6880,8 @@ bool CanBusMotionControl::setPositionRaw(int j, double ref)
             yError() << "setPositionRaw: skipping command because " << networkName.c_str() << " joint " << j << "is not in VOCAB_CM_POSITION_DIRECT mode";
             return true;
         }
-        return _writeDWord (ICUBCANPROTO_POL_MC_CMD__SET_COMMAND_POSITION, j, S_32(ref));
+        int value = S_32(ref);
+        return _writeSetpoint (ICUBCANPROTO_POL_MC_CMD__SET_COMMAND_POSITION, j, &value, sizeof(value));
     }
     else
     { 
@@ -6860,6 +7072,24 @@ bool CanBusMotionControl::_writeDWord (int msg, int axis, int value)
     return true;
 }
 
+/// write a streaming setpoint, queued for the tx scheduler if it is running.
+bool CanBusMotionControl::_writeSetpoint (int msg, int axis, const void *payload, int len)
+{
+    CanBusResources& r = RES(system_resources);
+    if (!(axis >= 0 && axis <= (CAN_MAX_CARDS-1)*2))
+        return false;
+
+    DEBUG_FUNC("Writing setpoint msg:%d axis:%d\n", msg, axis);
+
+    if (!ENABLED(axis))
+        return true;
+
+    std::lock_guard<std::recursive_mutex> lck(_mutex);
+
+    r.queueSetpoint (msg, axis, (const unsigned char *)payload, len);
+    return true;
+}
+
 /// two shorts in a single Can message (both must belong to the same control card).
 bool CanBusMotionControl::_writeWord16Ex (int msg, int axis, short s1, short s2, bool checkAxisEven)
 {
@@ -7438,7 +7668,8 @@ bool CanBusMotionControl::setRefDutyCycleRaw(int j, double v)
     if (!(j >= 0 && j <= (CAN_MAX_CARDS - 1) * 2))
         return false;
 
-    return _writeWord16(ICUBCANPROTO_POL_MC_CMD__SET_OPENLOOP_PARAMS, j, S_16(v));
+    short value = S_16(v);
+    return _writeSetpoint(ICUBCANPROTO_POL_MC_CMD__SET_OPENLOOP_PARAMS, j, &value, sizeof(value));
 }
 
 bool CanBusMotionControl::setRefDutyCyclesRaw(const double *v)
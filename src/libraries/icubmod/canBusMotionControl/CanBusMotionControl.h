@@ -37,6 +37,7 @@ namespace yarp{
 
 class ThreadPool2;
 class RequestsQueue;
+class CanBusTxScheduler;
 struct SpeedEstimationParameters
 {
     double jnt_Vel_estimator_shift;
@@ -154,6 +155,7 @@ public:
     unsigned char *_destinations;               /** destination addresses */
     unsigned char _my_address;                  /** my address */
     int _polling_interval;                      /** thread polling interval [ms] */
+    int _txPeriod;                              /** period of the tx scheduler [ms], 0 sends the setpoints at once */
     int _timeout;                               /** number of cycles before timing out */
 
     std::string *_axisName;                     /** axis name */
@@ -225,6 +227,7 @@ typedef int AnalogDataFormat;
 class TBR_CanBackDoor;
 
 class TBR_AnalogSensor: public yarp::dev::IAnalogSensor,
+                    public yarp::dev::IPreciselyTimed,
                     public yarp::dev::DeviceDriver
 {
 public:
@@ -251,11 +254,25 @@ private:
     int rate;
 
     ////////////////////
-    TBR_AnalogData *data;
+    TBR_AnalogData *data;                       /** the last published sample, protected by mtx */
     short status;
-    double timeStamp;
+    double timeStamp;                           /** last message received from the board */
+    yarp::os::Stamp lastStamp;                  /** time of reception of the published sample */
     double* scaleFactor;
     std::mutex mtx;
+
+    // decoding plan of the class 3 messages of the board, indexed by the last nibble of the id
+    struct DecodeGroup
+    {
+        short first;                            /** first channel carried by the message */
+        short count;                            /** channels carried by the message, 0 if it is not for us */
+        bool  expected;                         /** false if the board is not supposed to send it */
+    };
+    DecodeGroup decodePlan[16];
+    unsigned int boardMsgId;                    /** id of the class 3 messages of the board, without the group */
+    double* decodeGain;                         /** value = (raw + decodeOffset) * decodeGain */
+    double* decodeOffset;
+    double* work;                               /** values decoded outside the lock, then published into data */
     AnalogDataFormat dataFormat;
     yarp::os::Bottle initMsg;
     yarp::os::Bottle speedMsg;
@@ -265,9 +282,6 @@ private:
     short useCalibration;
     bool  isVirtualSensor; //RANDAZ
 
-    bool decode8(const unsigned char *msg, int id, double *data);
-    bool decode16(const unsigned char *msg, int id, double *data);
-
 public:
     TBR_CanBackDoor* backDoor; //RANDAZ
 
@@ -327,6 +341,9 @@ public:
 
     bool open(int channels, AnalogDataFormat f, short bId, short useCalib, bool isVirtualSensor);
 
+    // it must be called again after changing the scale factors
+    void buildDecodePlan();
+
     //IAnalogSensor interface
     virtual int read(yarp::sig::Vector &out);
     virtual int getState(int ch);
@@ -343,6 +360,9 @@ public:
         return calibrateChannel(ch, 0);
     }
     /////////////////////////////////
+
+    //IPreciselyTimed interface
+    virtual yarp::os::Stamp getLastInputStamp();
 };
 
 class speedEstimationHelper
@@ -641,7 +661,14 @@ class axisTorqueHelper
  * the motor control boards on a CAN bus. It
  * converts requests from function calls into CAN bus messages for
  * the motor control boards. A thread monitors the bus for incoming
- * messages and dispatches replies to calling threads.
+ * messages, decodes the broadcasts into the state of the joints and
+ * dispatches replies to calling threads.
+ *
+ * If CanTxPeriod is set (in ms) the streaming setpoints (velocity, position
+ * direct, torque and pwm references) are queued and a second thread sends
+ * them once per period, all in a single write: a newer setpoint of a joint
+ * replaces the one not yet sent. Any other command sends the queued
+ * setpoints first, hence the order of the commands is kept.
  *
  * Communication with the CAN bus is done through the standard
  * YARP ICanBus interface.
@@ -729,6 +756,8 @@ private:
     void operator=(const CanBusMotionControl&);
 
     void handleBroadcasts();
+    void txRun();
+    friend class ::CanBusTxScheduler;
  
     double previousRun;
     double averagePeriod;
@@ -736,6 +765,9 @@ private:
     double currentRun;
     int myCount;
     double lastReportTime;
+    unsigned int rxFrames;
+    unsigned int rxMaxFrames;
+    double lastTxReportTime;
     os::Stamp stampEncoders;
 
     char _buff[256];
@@ -1123,6 +1155,7 @@ protected:
     bool _noreply;
     bool _opened;
     ThreadPool2 *threadPool;
+    CanBusTxScheduler *txScheduler;
 
     /**
     * filter for recurrent messages.
@@ -1154,6 +1187,7 @@ protected:
     bool _writeByte8 (int msg, int axis, int value);
     bool _readByte8(int msg, int axis, int& value);
     bool _writeByteWords16(int msg, int axis, unsigned char value, short s1, short s2, short s3);
+    bool _writeSetpoint (int msg, int axis, const void *payload, int len);
     axisTorqueHelper      *_axisTorqueHelper;
     axisImpedanceHelper   *_axisImpedanceHelper;
     firmwareVersionHelper *_firmwareVersionHelper;
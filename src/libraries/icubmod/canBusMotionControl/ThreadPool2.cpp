@@ -19,16 +19,20 @@
 
 #include "ThreadPool2.h"
 
-ThreadPool2::ThreadPool2(yarp::dev::ICanBufferFactory *ic)
+ThreadPool2::ThreadPool2(yarp::dev::ICanBufferFactory *ic, double maxWait)
 {
     index=0;
-    pool=new ThreadTable2[CANCONTROL_MAX_THREADS];
-    for(int k=0;k<CANCONTROL_MAX_THREADS;k++)
-        pool[k].init(ic);
+    factory=ic;
+    this->maxWait=maxWait;
+    // the tables are allocated on demand: allocating CANCONTROL_MAX_THREADS buffers of BUF_SIZE messages
+    // at once made the startup slow, while only a few threads of the robotInterface ever issue requests
+    pool.resize(CANCONTROL_MAX_THREADS, 0);
+    handles.resize(CANCONTROL_MAX_THREADS);
 }
 
 ThreadPool2::~ThreadPool2()
 {
-    delete [] pool;
+    for(int k=0;k<index;k++)
+        delete pool[k];
 }
 
@@ -17,17 +17,19 @@
  * Public License for more details
 */
 
-#include <ace/config.h>
-#include <ace/Thread.h>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "canControlConstants.h"
 #include "ThreadTable2.h"
 
 /*
- * This list contains the association between each thread and a consecutive id. */
+ * This list contains the association between each thread and a consecutive id.
+ * The table of a thread is allocated when the thread issues its first request. */
 class ThreadPool2
 {
 private:
-    inline bool getNew(const ACE_thread_t &s, int &i)
+    inline bool getNew(const std::thread::id &s, int &i)
     {
         fprintf(stderr, "Registering new thread %d out of %d\n", index, CANCONTROL_MAX_THREADS);
         if (index>=CANCONTROL_MAX_THREADS)
@@ -38,40 +40,44 @@ private:
             }
 
         i=index;
+        pool[i]=new ThreadTable2;
+        pool[i]->init(factory, maxWait);
+        handles[i]=s;
         index++;
-        pool[i].handle()=s;
         return true;
     }
 
-    inline int checkExists(const ACE_thread_t &s)
+    inline int checkExists(const std::thread::id &s)
     {
         for(int i=0; i<index; i++)
             {
-                if (pool[i].handle()==s)
+                if (handles[i]==s)
                     return i;
             }
         return -1;
 
     }
 
-    ThreadTable2 *pool;
+    std::vector<ThreadTable2 *> pool;
+    std::vector<std::thread::id> handles;
     int index;
+    std::mutex mtx;
+    yarp::dev::ICanBufferFactory *factory;
+    double maxWait;
 
 public:
-    ThreadPool2(yarp::dev::ICanBufferFactory *ic);
+    // maxWait [s] is the longest wait of a thread for its replies, see ThreadTable2::synch()
+    ThreadPool2(yarp::dev::ICanBufferFactory *ic, double maxWait);
 
     ~ThreadPool2();
 
-    inline void reset()
-    {
-        index=0;
-    }
-
     inline bool getId(int &i)
     {
-        ACE_thread_t self=ACE_Thread::self();
+        std::thread::id self=std::this_thread::get_id();
         int id;
         bool ret=true;
+
+        std::lock_guard<std::mutex> lck(mtx);
         id=checkExists(self);
 
         if (id==-1)
@@ -82,12 +88,14 @@ public:
         return ret;
     }
 
+    // it is called after getId() by the same thread or by the receiving thread for an id taken from
+    // the queue of requests: the table exists and it is never moved nor deleted until the pool is
     inline ThreadTable2 *getThreadTable(int id)
     {
-        if ((id<0) || (id>CANCONTROL_MAX_THREADS))
+        if ((id<0) || (id>=CANCONTROL_MAX_THREADS))
             return 0;
 
-        return pool+id;
+        return pool[id];
     }
 };
 
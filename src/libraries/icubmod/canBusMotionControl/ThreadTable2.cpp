@@ -23,6 +23,8 @@
 ThreadTable2::ThreadTable2()
 {
     ic=0;
+    _timedOut=0;
+    _maxWait=1.0;
     clear();
 }
 
@@ -41,9 +43,10 @@ void ThreadTable2::clear()
     unlock();
 }
 
-void ThreadTable2::init(yarp::dev::ICanBufferFactory *i)
+void ThreadTable2::init(yarp::dev::ICanBufferFactory *i, double maxWait)
 {
     ic=i;
+    _maxWait=maxWait;
     _replies=ic->createBuffer(BUF_SIZE);
 }
 
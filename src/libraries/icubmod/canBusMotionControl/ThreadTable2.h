@@ -22,13 +22,15 @@
 
 #include <mutex>
 #include <condition_variable>
-#include <ace/config.h>
-#include <ace/Thread.h>
+#include <chrono>
 #include <yarp/dev/CanBusInterface.h>
 
 #include "canControlConstants.h"
 #include "canControlUtils.h"
 
+// The replies awaited by one thread. The thread sends its requests, calls
+// setPending() with their number and sleeps in synch() until the receiving
+// thread has pushed all the replies or has timed out the missing ones.
 class ThreadTable2
 {
 private:
@@ -36,11 +38,10 @@ private:
     int _timedOut;
     yarp::dev::CanBuffer _replies;
     yarp::dev::ICanBufferFactory *ic;
-    std::mutex mtx_synch;
     std::condition_variable cv_synch;
     int _replied;
-    ACE_thread_t _handle;
     std::mutex _mutex;
+    double _maxWait;
 
     inline void lock()
     { _mutex.lock(); }
@@ -55,18 +56,28 @@ public:
     void clear();
 
     // initialize, need factory to create internal buffer of 
-    // messages which will store replies
-    void init(yarp::dev::ICanBufferFactory *i);
+    // messages which will store replies. maxWait [s] bounds synch()
+    void init(yarp::dev::ICanBufferFactory *i, double maxWait);
 
     // set number of pending requests, reset
     inline void setPending(int pend);
 
-    // wait on semaphore, usually thread sleeps here after
-    // has issued a list of requests to the can 
+    // wait until all the requests are replied or timed out, usually thread sleeps
+    // here after has issued a list of requests to the can. the wakeup cannot be
+    // lost because the state is checked under the same mutex of push() and timeout().
+    // the receiving thread times out the requests after CanTimeout, maxWait only
+    // protects from a receiving thread which has stopped: the missing replies are
+    // then counted as timed out
     void synch()
     {
-        std::unique_lock<std::mutex> lck(mtx_synch);
-        cv_synch.wait(lck);
+        std::unique_lock<std::mutex> lck(_mutex);
+        if (!cv_synch.wait_for(lck, std::chrono::duration<double>(_maxWait), [this]{ return _pending<=0; }))
+        {
+            fprintf(stderr, "Warning: ThreadTable2::synch() gave up after %.3f s with %d replies missing\n", _maxWait, _pending);
+            _timedOut+=_pending;
+            _replied+=_pending;
+            _pending=0;
+        }
     }
 
     // true if there are pending requests
@@ -96,9 +107,6 @@ public:
     // wake up wating thread when all messages are received
     inline bool push(const yarp::dev::CanMessage &m);
 
-    ACE_thread_t &handle()
-    { return _handle; }
-
 
     //get can message from joint number
     inline yarp::dev::CanMessage *getByJoint(int j, const unsigned char *destInv);
@@ -126,6 +134,13 @@ yarp::dev::CanMessage *ThreadTable2::getByJoint(int j, const unsigned char *dest
 bool ThreadTable2::push(const yarp::dev::CanMessage &m)
 {
     lock();
+    if (_pending<=0)
+        {
+            // a late reply of a request which synch() has already given up
+            unlock();
+            return false;
+        }
+
     if (_replied>=BUF_SIZE)
         {
             unlock();
@@ -154,6 +169,11 @@ bool ThreadTable2::push(const yarp::dev::CanMessage &m)
 bool ThreadTable2::timeout()
 {
     lock();
+    if (_pending<=0)
+        {
+            unlock();
+            return false;
+        }
     _replied++;
     _pending--;
     _timedOut++;
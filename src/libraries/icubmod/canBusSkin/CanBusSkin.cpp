@@ -5,6 +5,7 @@
 // CopyPolicy: Released under the terms of the GNU GPL v2.0.
 
 #include <CanBusSkin.h>
+#include "canMessageTimestamp.h"
 
 #include <iCubCanProtocol.h>
 #include <yarp/os/Time.h>
@@ -33,7 +34,8 @@ using yarp::dev::CanMessage;
 
 CanBusSkin::CanBusSkin() :  PeriodicThread(0.02),
                             _verbose(false),
-                            _isDiagnosticPresent(false)
+                            _isDiagnosticPresent(false),
+                            listener(NULL)
 { }
 
 
@@ -549,6 +551,19 @@ int CanBusSkin::read(yarp::sig::Vector &out)
     return yarp::dev::IAnalogSensor::AS_OK;
 }
 
+yarp::os::Stamp CanBusSkin::getLastInputStamp()
+{
+    lock_guard<mutex> lck(mtx);
+    return lastStamp;
+}
+
+bool CanBusSkin::setUpdateListener(iCub::skin::ISkinUpdateListener *l)
+{
+    lock_guard<mutex> lck(mtx);
+    listener = l;
+    return true;
+}
+
 int CanBusSkin::getState(int ch)
 {
     return yarp::dev::IAnalogSensor::AS_OK;;
@@ -607,6 +622,9 @@ void CanBusSkin::run() {
         // Allocate error vector
         errors.resize(canMessages);
 
+        const double now = yarp::os::Time::now();
+        double newest = 0;
+
         for (unsigned int i = 0; i < canMessages; i++) {
 
             CanMessage &msg = inBuffer[i];
@@ -643,6 +661,10 @@ void CanBusSkin::run() {
                             data[index + k + 7] = msg.getData()[k + 1];
                         }
 
+                        double rxstamp = getRxTimestamp(msg, now);
+                        if (rxstamp > newest)
+                            newest = rxstamp;
+
                         // Skin diagnostics
                         if (_brdCfg.useDiagnostic)  // if user requests to check the diagnostic
                         {
@@ -694,6 +716,13 @@ void CanBusSkin::run() {
           //        }
             }
         }
+
+        if (newest > 0)
+        {
+            lastStamp.update(newest);
+            if (listener != NULL)
+                listener->skinUpdated(lastStamp);
+        }
     }
 }
 
@@ -15,15 +15,19 @@
 #include <yarp/dev/IAnalogSensor.h>
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/CanBusInterface.h>
+#include <yarp/dev/IPreciselyTimed.h>
+#include <yarp/os/Stamp.h>
 #include <yarp/sig/Vector.h>
 #include <yarp/os/BufferedPort.h>
 
 
 #include "SkinConfigReader.h"
 #include <SkinDiagnostics.h>
+#include <SkinUpdate.h>
 
 
-class CanBusSkin : public yarp::os::PeriodicThread, public yarp::dev::IAnalogSensor, public yarp::dev::DeviceDriver 
+class CanBusSkin : public yarp::os::PeriodicThread, public yarp::dev::IAnalogSensor, public yarp::dev::IPreciselyTimed, public yarp::dev::DeviceDriver,
+                   public iCub::skin::ISkinUpdateNotifier
 {
 private:
 
@@ -80,6 +84,12 @@ protected:
 
     yarp::sig::Vector data;
 
+    /** The time of reception of the latest taxel data, from the CAN driver if it has it. */
+    yarp::os::Stamp lastStamp;
+
+    /** Told at the end of each run() which has received taxels, under mtx. */
+    iCub::skin::ISkinUpdateListener *listener;
+
     /** The detected skin errors. These are used for diagnostics purposes. */
     yarp::sig::VectorOf<iCub::skin::diagnostics::DetectedError> errors;
 
@@ -103,6 +113,12 @@ public:
     virtual int calibrateSensor(const yarp::sig::Vector& v);
     virtual int calibrateChannel(int ch);
 
+    //IPreciselyTimed interface
+    virtual yarp::os::Stamp getLastInputStamp();
+
+    //ISkinUpdateNotifier interface
+    virtual bool setUpdateListener(iCub::skin::ISkinUpdateListener *l);
+
 private:
     /**
      * Extracts the detected errors and prints them out on a dedicated YARP port.
@@ -70,6 +70,7 @@ bool CanBusVirtualAnalogSensor::open(yarp::os::Searchable& config)
     driver.view(pCanBufferFactory);
     outBuffer=pCanBufferFactory->createBuffer(CAN_DRIVER_BUFFER_SIZE);
     inBuffer=pCanBufferFactory->createBuffer(CAN_DRIVER_BUFFER_SIZE);
+    measureBuffer=pCanBufferFactory->createBuffer(FRAMES);
 
     //select the communication speed
     pCanBus->canSetBaudRate(0); //default 1MB/s
@@ -81,6 +82,8 @@ bool CanBusVirtualAnalogSensor::open(yarp::os::Searchable& config)
     this->canId             = config.find("canDeviceNum").asInt32();
     this->channelsNum       = config.find("channels").asInt32();
     this->useCalibration    = (config.find("useCalibration").asInt32()==1);
+    if (config.check("refreshPeriod"))
+        this->refreshPeriod = config.find("refreshPeriod").asInt32()/1000.0;
     unsigned int tmpFormat  = config.find("format").asInt32();
     if      (tmpFormat == 8)
         this->dataFormat = ANALOG_FORMAT_8_BIT;
@@ -156,35 +159,42 @@ bool CanBusVirtualAnalogSensor::updateVirtualAnalogSensorMeasure(yarp::sig::Vect
         val[i] = (short int)(dval[i] / fullScale * 0x7fff)+0x8000; //check this!
     }
 
-    unsigned int canMessages=0;
-
-    CanMessage &msg0=outBuffer[0];
-    canMessages=0;
-    fakeId = 0x300 + (boardId<<4)+ 0x0A;
-    msg0.setId(fakeId);
-    msg0.getData()[1]=(val[0] >> 8) & 0xFF;
-    msg0.getData()[0]= val[0] & 0xFF;
-    msg0.getData()[3]=(val[1] >> 8) & 0xFF;
-    msg0.getData()[2]= val[1] & 0xFF;
-    msg0.getData()[5]=(val[2] >> 8) & 0xFF;
-    msg0.getData()[4]= val[2] & 0xFF;
-    msg0.setLen(6);
-    pCanBus->canWrite(outBuffer, 1, &canMessages);
+    // the strain protocol fixes the frames: 0x0A carries the channels 0-2, 0x0B the channels 3-5.
+    // The ones to be sent are queued and written with a single canWrite()
+    double now=Time::now();
+    unsigned int toSend=0;
+    for (int f=0; f<FRAMES; f++)
+    {
+        const short int *v=&val[f*CHANNELS_PER_FRAME];
+        bool changed=(lastSentTime[f]<0.0) || (now-lastSentTime[f]>=refreshPeriod);
+        for (int k=0; k<CHANNELS_PER_FRAME && !changed; k++)
+            changed=(v[k]!=lastSent[f*CHANNELS_PER_FRAME+k]);
+        if (!changed)
+            continue;
+
+        CanMessage &msg=measureBuffer[toSend++];
+        fakeId = 0x300 + (boardId<<4)+ 0x0A + f;
+        msg.setId(fakeId);
+        for (int k=0; k<CHANNELS_PER_FRAME; k++)
+        {
+            msg.getData()[2*k+1]=(v[k] >> 8) & 0xFF;
+            msg.getData()[2*k]  = v[k] & 0xFF;
+            lastSent[f*CHANNELS_PER_FRAME+k]=v[k];
+        }
+        msg.setLen(6);
+        lastSentTime[f]=now;
+    }
 
-    CanMessage &msg1=outBuffer[0];
-    canMessages=0;
-    fakeId = 0x300 + (boardId<<4)+ 0x0B;
-    msg1.setId(fakeId);
-    msg1.getData()[1]=(val[3] >> 8) & 0xFF;
-    msg1.getData()[0]= val[3] & 0xFF;
-    msg1.getData()[3]=(val[4] >> 8) & 0xFF;
-    msg1.getData()[2]= val[4] & 0xFF;
-    msg1.getData()[5]=(val[5] >> 8) & 0xFF;
-    msg1.getData()[4]= val[5] & 0xFF;
-    msg1.setLen(6);
-    canMessages=0;
-    pCanBus->canWrite(outBuffer, 1, &canMessages);
+    if (toSend==0)
+        return true;
 
+    // what has not gone out is sent again at the next call
+    unsigned int canMessages=0;
+    if (!pCanBus->canWrite(measureBuffer, toSend, &canMessages) || canMessages<toSend)
+    {
+        for (int f=0; f<FRAMES; f++)
+            lastSentTime[f]=-1.0;
+    }
     return true;
 }
 
@@ -360,6 +370,7 @@ bool CanBusVirtualAnalogSensor::close()
     {
         pCanBufferFactory->destroyBuffer(inBuffer);
         pCanBufferFactory->destroyBuffer(outBuffer);
+        pCanBufferFactory->destroyBuffer(measureBuffer);
     }
     driver.close();
 
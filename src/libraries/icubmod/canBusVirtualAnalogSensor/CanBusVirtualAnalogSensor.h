@@ -44,6 +44,7 @@ protected:
     ICanBufferFactory  *pCanBufferFactory;
     CanBuffer          inBuffer;
     CanBuffer          outBuffer;
+    CanBuffer          measureBuffer;   // the frames of updateVirtualAnalogSensorMeasure(), apart from the replies of run()
    
     std::mutex         mtx;
 
@@ -58,9 +59,19 @@ protected:
     yarp::sig::Vector  scaleFactor;
     bool               useCalibration;
 
+    // a frame is sent only if one of its channels has changed once quantized, or if it has not been sent
+    // for refreshPeriod seconds, since the boards take the silence of the sensor as a fault
+    enum { FRAMES = 2, CHANNELS_PER_FRAME = 3 };
+    short int          lastSent[FRAMES*CHANNELS_PER_FRAME];
+    double             lastSentTime[FRAMES];
+    double             refreshPeriod;
+
 public:
-    CanBusVirtualAnalogSensor(int period=20) : PeriodicThread((double)period/1000.0)
-    {}
+    CanBusVirtualAnalogSensor(int period=20) : PeriodicThread((double)period/1000.0), refreshPeriod(0.05)
+    {
+        for (int f=0; f<FRAMES; f++)
+            lastSentTime[f]=-1.0;
+    }
     
 
     ~CanBusVirtualAnalogSensor()
@@ -79,6 +79,9 @@ void ClientCartesianController::init()
 
     timeout=CARTCTRL_DEFAULT_TMO;
     lastPoseMsgArrivalTime=0.0;
+    lastStateMsgArrivalTime=0.0;
+    stateAvailable=false;
+    motionDoneStale=false;
 
     pose.resize(7,0.0);
 
@@ -109,6 +112,7 @@ bool ClientCartesianController::open(Searchable &config)
     
     portCmd.open(local+"/command:o");
     portState.open(local+"/state:i");
+    portStateFull.open(local+"/state_full:i");
     portEvents.open(local+"/events:i");
     portRpc.open(local+"/rpc:o");    
 
@@ -143,6 +147,11 @@ bool ClientCartesianController::open(Searchable &config)
     ok&=Network::connect(remote+"/state:o",portState.getName(),carrier);
     ok&=Network::connect(remote+"/events:o",portEvents.getName(),carrier);    
 
+    // the getters fall back to rpc if the server does not stream its full state
+    stateAvailable=Network::connect(remote+"/state_full:o",portStateFull.getName(),carrier);
+    if (!stateAvailable)
+        yWarning("unable to connect to the server state_full port; getters will rely on rpc");
+
     // check whether the solver is alive and connected
     if (ok)
     {
@@ -189,11 +198,13 @@ bool ClientCartesianController::close()
 
     portCmd.interrupt();
     portState.interrupt();
+    portStateFull.interrupt();
     portEvents.interrupt();
     portRpc.interrupt();
 
     portCmd.close();
     portState.close();
+    portStateFull.close();
     portEvents.close();
     portRpc.close();
 
@@ -361,6 +372,37 @@ bool ClientCartesianController::getPosePriority(string &p)
 }
 
 
+/************************************************************************/
+bool ClientCartesianController::getState()
+{
+    if (!stateAvailable)
+        return false;
+
+    double now=Time::now();
+
+    // receive from network in streaming mode (non-blocking)
+    if (Vector *v=portStateFull.read(false))
+    {
+        deque<Vector> fields;
+        if (unpackState(*v,fields) && (fields.size()>=IKINCARTCTRL_STATE_NUM) &&
+            (fields[IKINCARTCTRL_STATE_DES_POSE].length()>3) &&
+            (fields[IKINCARTCTRL_STATE_XDOT].length()>3) &&
+            (fields[IKINCARTCTRL_STATE_MOTIONDONE].length()>0))
+        {
+            state=fields;
+            lastStateMsgArrivalTime=now;
+
+            // the server has handled the last motion command
+            // as soon as it reports a motion in progress
+            if (state[IKINCARTCTRL_STATE_MOTIONDONE][0]==0.0)
+                motionDoneStale=false;
+        }
+    }
+
+    return (now-lastStateMsgArrivalTime<timeout);
+}
+
+
 /************************************************************************/
 bool ClientCartesianController::getPose(Vector &x, Vector &o, Stamp *stamp)
 {
@@ -466,6 +508,7 @@ bool ClientCartesianController::goToPose(const Vector &xd, const Vector &od,
 
     // send command
     portCmd.writeStrict();
+    motionDoneStale=true;
     return true;
 }
 
@@ -489,6 +532,7 @@ bool ClientCartesianController::goToPosition(const Vector &xd, const double t)
 
     // send command
     portCmd.writeStrict();
+    motionDoneStale=true;
     return true;
 }
 
@@ -512,6 +556,7 @@ bool ClientCartesianController::goToPoseSync(const Vector &xd, const Vector &od,
     for (int i=0; i<4; i++)
         xdesPart.addFloat64(od[i]);
 
+    motionDoneStale=true;
     if (!portRpc.write(command,reply))
     {
         yError("unable to get reply from server!");
@@ -537,6 +582,7 @@ bool ClientCartesianController::goToPositionSync(const Vector &xd, const double
     for (int i=0; i<3; i++)
         xdesPart.addFloat64(xd[i]);
 
+    motionDoneStale=true;
     if (!portRpc.write(command,reply))
     {
         yError("unable to get reply from server!");
@@ -554,6 +600,15 @@ bool ClientCartesianController::getDesired(Vector &xdhat, Vector &odhat,
     if (!connected)
         return false;
 
+    if (getState())
+    {
+        const Vector &des=state[IKINCARTCTRL_STATE_DES_POSE];
+        xdhat=des.subVector(0,2);
+        odhat=des.subVector(3,(unsigned int)des.length()-1);
+        qdhat=state[IKINCARTCTRL_STATE_DES_JOINTS];
+        return true;
+    }
+
     Bottle command, reply;
     command.addVocab32(IKINCARTCTRL_VOCAB_CMD_GET);
     command.addVocab32(IKINCARTCTRL_VOCAB_OPT_DES);
@@ -675,6 +730,62 @@ bool ClientCartesianController::askForPosition(const Vector &q0, const Vector &x
 }
 
 
+/************************************************************************/
+bool ClientCartesianController::askForPoses(const Vector &q0, const deque<Vector> &xd,
+                                            const deque<Vector> &od, deque<Vector> &xdhat,
+                                            deque<Vector> &odhat, deque<Vector> &qdhat)
+{
+    if (!connected || xd.empty() || (xd.size()!=od.size()))
+        return false;
+
+    deque<Vector> tg;
+    for (size_t i=0; i<xd.size(); i++)
+        tg.push_back(cat(xd[i],od[i]));
+
+    Bottle command, reply;
+    command.addVocab32(IKINCARTCTRL_VOCAB_CMD_ASK);
+    addTargetsOption(command,tg);
+    if (q0.length()>0)
+        addVectorOption(command,IKINCARTCTRL_VOCAB_OPT_Q,q0);
+    addPoseOption(command,IKINCTRL_POSE_FULL);
+
+    // send command and wait for reply
+    if (!portRpc.write(command,reply))
+    {
+        yError("unable to get reply from server!");
+        return false;
+    }
+
+    return getDesiredOption(reply,xdhat,odhat,qdhat);
+}
+
+
+/************************************************************************/
+bool ClientCartesianController::askForPositions(const Vector &q0, const deque<Vector> &xd,
+                                                deque<Vector> &xdhat, deque<Vector> &odhat,
+                                                deque<Vector> &qdhat)
+{
+    if (!connected || xd.empty())
+        return false;
+
+    Bottle command, reply;
+    command.addVocab32(IKINCARTCTRL_VOCAB_CMD_ASK);
+    addTargetsOption(command,xd);
+    if (q0.length()>0)
+        addVectorOption(command,IKINCARTCTRL_VOCAB_OPT_Q,q0);
+    addPoseOption(command,IKINCTRL_POSE_XYZ);
+
+    // send command and wait for reply
+    if (!portRpc.write(command,reply))
+    {
+        yError("unable to get reply from server!");
+        return false;
+    }
+
+    return getDesiredOption(reply,xdhat,odhat,qdhat);
+}
+
+
 /************************************************************************/
 bool ClientCartesianController::getDOF(Vector &curDof)
 {
@@ -1039,6 +1150,12 @@ bool ClientCartesianController::getJointsVelocities(Vector &qdot)
     if (!connected)
         return false;
 
+    if (getState())
+    {
+        qdot=state[IKINCARTCTRL_STATE_QDOT];
+        return true;
+    }
+
     Bottle command, reply;
     command.addVocab32(IKINCARTCTRL_VOCAB_CMD_GET);
     command.addVocab32(IKINCARTCTRL_VOCAB_OPT_QDOT);
@@ -1072,6 +1189,14 @@ bool ClientCartesianController::getTaskVelocities(Vector &xdot, Vector &odot)
     if (!connected)
         return false;
 
+    if (getState())
+    {
+        const Vector &vel=state[IKINCARTCTRL_STATE_XDOT];
+        xdot=vel.subVector(0,2);
+        odot=vel.subVector(3,(unsigned int)vel.length()-1);
+        return true;
+    }
+
     Bottle command, reply;
     command.addVocab32(IKINCARTCTRL_VOCAB_CMD_GET);
     command.addVocab32(IKINCARTCTRL_VOCAB_OPT_XDOT);
@@ -1124,6 +1249,7 @@ bool ClientCartesianController::setTaskVelocities(const Vector &xdot,
 
     // send command
     portCmd.writeStrict();
+    motionDoneStale=true;
     return true;
 }
 
@@ -1218,6 +1344,14 @@ bool ClientCartesianController::checkMotionDone(bool *f)
     if (!connected || (f==NULL))
         return false;
 
+    // the cached flag is not used until the server has
+    // handled the last motion command
+    if (getState() && !motionDoneStale)
+    {
+        *f=(state[IKINCARTCTRL_STATE_MOTIONDONE][0]!=0.0);
+        return true;
+    }
+
     Bottle command, reply;
     command.addVocab32(IKINCARTCTRL_VOCAB_CMD_GET);
     command.addVocab32(IKINCARTCTRL_VOCAB_OPT_MOTIONDONE);
@@ -1237,7 +1371,10 @@ bool ClientCartesianController::checkMotionDone(bool *f)
             if (flag==IKINCARTCTRL_VOCAB_VAL_TRUE)
                 *f=true;
             else if (flag==IKINCARTCTRL_VOCAB_VAL_FALSE)
+            {
                 *f=false;
+                motionDoneStale=false;
+            }
 
             return true;
         }
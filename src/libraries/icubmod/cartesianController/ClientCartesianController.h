@@ -22,6 +22,7 @@
 #include <string>
 #include <set>
 #include <map>
+#include <deque>
 
 #include <yarp/os/all.h>
 #include <yarp/dev/all.h>
@@ -62,6 +63,7 @@ public:
 */
 class ClientCartesianController : public    yarp::dev::DeviceDriver,
                                   public    yarp::dev::ICartesianControl,
+                                  public    iCub::iKin::ICartesianBatchQuery,
                                   protected iCub::iKin::CartesianHelper
 {
 protected:
@@ -70,11 +72,17 @@ protected:
 
     double timeout;
     double lastPoseMsgArrivalTime;
+    double lastStateMsgArrivalTime;
+    bool   stateAvailable;
+    bool   motionDoneStale;
 
     yarp::sig::Vector pose;
     yarp::os::Stamp   poseStamp;
 
+    std::deque<yarp::sig::Vector> state;
+
     yarp::os::BufferedPort<yarp::sig::Vector> portState;
+    yarp::os::BufferedPort<yarp::sig::Vector> portStateFull;
     yarp::os::BufferedPort<yarp::os::Bottle>  portCmd;
     yarp::os::RpcClient                       portRpc;
 
@@ -87,6 +95,7 @@ protected:
     bool deleteContexts();
     void eventHandling(yarp::os::Bottle &event);
     bool getInfoHelper(yarp::os::Bottle &info);
+    bool getState();
 
 public:
     ClientCartesianController();
@@ -116,6 +125,12 @@ public:
                         yarp::sig::Vector &qdhat);
     bool askForPosition(const yarp::sig::Vector &q0, const yarp::sig::Vector &xd, yarp::sig::Vector &xdhat,
                         yarp::sig::Vector &odhat, yarp::sig::Vector &qdhat);
+    bool askForPoses(const yarp::sig::Vector &q0, const std::deque<yarp::sig::Vector> &xd,
+                     const std::deque<yarp::sig::Vector> &od, std::deque<yarp::sig::Vector> &xdhat,
+                     std::deque<yarp::sig::Vector> &odhat, std::deque<yarp::sig::Vector> &qdhat);
+    bool askForPositions(const yarp::sig::Vector &q0, const std::deque<yarp::sig::Vector> &xd,
+                         std::deque<yarp::sig::Vector> &xdhat, std::deque<yarp::sig::Vector> &odhat,
+                         std::deque<yarp::sig::Vector> &qdhat);
     bool getDOF(yarp::sig::Vector &curDof);
     bool setDOF(const yarp::sig::Vector &newDof, yarp::sig::Vector &curDof);
     bool getRestPos(yarp::sig::Vector &curRestPos);
@@ -55,6 +55,7 @@
 #define IKINCARTCTRL_VOCAB_OPT_REGISTER         yarp::os::createVocab32('r','e','g','i')
 #define IKINCARTCTRL_VOCAB_OPT_UNREGISTER       yarp::os::createVocab32('u','n','r','e')
 #define IKINCARTCTRL_VOCAB_OPT_LIST             yarp::os::createVocab32('l','i','s','t')
+#define IKINCARTCTRL_VOCAB_OPT_TELEMETRY        yarp::os::createVocab32('t','e','l','e')
 #define IKINCARTCTRL_VOCAB_VAL_POSE_FULL        yarp::os::createVocab32('f','u','l','l')
 #define IKINCARTCTRL_VOCAB_VAL_POSE_XYZ         yarp::os::createVocab32('x','y','z')
 #define IKINCARTCTRL_VOCAB_VAL_MODE_TRACK       yarp::os::createVocab32('c','o','n','t')
@@ -65,5 +66,14 @@
 #define IKINCARTCTRL_VOCAB_REP_ACK              yarp::os::createVocab32('a','c','k')
 #define IKINCARTCTRL_VOCAB_REP_NACK             yarp::os::createVocab32('n','a','c','k')
 
+// fields of the state streamed out on the state_full:o port
+#define IKINCARTCTRL_STATE_POSE                 0
+#define IKINCARTCTRL_STATE_DES_POSE             1
+#define IKINCARTCTRL_STATE_DES_JOINTS           2
+#define IKINCARTCTRL_STATE_QDOT                 3
+#define IKINCARTCTRL_STATE_XDOT                 4
+#define IKINCARTCTRL_STATE_MOTIONDONE           5
+#define IKINCARTCTRL_STATE_NUM                  6
+
 #endif
 
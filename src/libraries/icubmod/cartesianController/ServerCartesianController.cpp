@@ -30,6 +30,10 @@
 
 #include <iCub/iKin/iKinVocabs.h>
 
+#ifdef CARTCTRL_USE_LOCAL_SOLVER
+    #include <iCub/iKin/iKinSlv.h>
+#endif
+
 #define CARTCTRL_SERVER_VER                 "2.0"
 #define CARTCTRL_DEFAULT_PER                0.01    // [s]
 #define CARTCTRL_DEFAULT_TASKVEL_PERFACTOR  4
@@ -38,6 +42,9 @@
 #define CARTCTRL_DEFAULT_POSCTRL            "on"
 #define CARTCTRL_DEFAULT_MULJNTCTRL         "on"
 #define CARTCTRL_CONNECT_SOLVER_PING        1.0     // [s]
+#define CARTCTRL_TELEMETRY_PER              1.0     // [s]
+#define CARTCTRL_EVENT_POLL_PER             0.001   // [s]
+#define CARTCTRL_DEFAULT_EVENT_TMO_FACTOR   2.0
 
 using namespace std;
 using namespace yarp::os;
@@ -70,6 +77,48 @@ bool CartesianCtrlRpcProcessor::read(ConnectionReader &connection)
 }
 
 
+#ifdef CARTCTRL_USE_LOCAL_SOLVER
+/************************************************************************/
+class CartesianCtrlSolverReceiver : public CartesianSolverReceiver
+{
+protected:
+    mutex mtx;
+    Bottle pending;
+    Bottle latest;
+    bool isNew;
+
+public:
+    CartesianCtrlSolverReceiver() : isNew(false) { }
+    void onSolution(const Bottle &b);
+    Bottle *read();
+};
+
+
+/************************************************************************/
+void CartesianCtrlSolverReceiver::onSolution(const Bottle &b)
+{
+    lock_guard<mutex> lck(mtx);
+    pending=b;
+    isNew=true;
+}
+
+
+/************************************************************************/
+Bottle *CartesianCtrlSolverReceiver::read()
+{
+    lock_guard<mutex> lck(mtx);
+    if (isNew)
+    {
+        latest=pending;
+        isNew=false;
+        return &latest;
+    }
+    else
+        return NULL;
+}
+#endif
+
+
 /************************************************************************/
 CartesianCtrlCommandPort::CartesianCtrlCommandPort(ServerCartesianController *server)
 {
@@ -170,7 +219,8 @@ TaskRefVelTargetGenerator::~TaskRefVelTargetGenerator()
 
 /************************************************************************/
 ServerCartesianController::ServerCartesianController() :
-                           PeriodicThread(CARTCTRL_DEFAULT_PER)
+                           PeriodicThread(CARTCTRL_DEFAULT_PER),
+                           telemetry(CARTCTRL_DEFAULT_PER)
 {
     init();
 }
@@ -178,7 +228,8 @@ ServerCartesianController::ServerCartesianController() :
 
 /************************************************************************/
 ServerCartesianController::ServerCartesianController(Searchable &config) :
-                           PeriodicThread(CARTCTRL_DEFAULT_PER)
+                           PeriodicThread(CARTCTRL_DEFAULT_PER),
+                           telemetry(CARTCTRL_DEFAULT_PER)
 {
     init();
     open(config);
@@ -196,6 +247,10 @@ void ServerCartesianController::init()
     portCmd     =NULL;
     rpcProcessor=NULL;
 
+    localSolver        =NULL;
+    localSolverReceiver=NULL;
+    localSolverEnabled =false;
+
     attached     =false;
     connected    =false;
     closed       =true;
@@ -221,6 +276,21 @@ void ServerCartesianController::init()
     syncEventEnabled=false;
 
     contextIdCnt=0;
+    configVersion=0;
+    activeVersion=0;
+
+    tmSectionFk=telemetry.addSection("fk");
+    tmSectionCtrl=telemetry.addSection("ctrl");
+    tmSectionIO=telemetry.addSection("io");
+    telemetryTxTime=0.0;
+
+    eventDrivenEnabled=false;
+    ctrlPeriod=CARTCTRL_DEFAULT_PER;
+    eventTimeout=CARTCTRL_DEFAULT_EVENT_TMO_FACTOR*ctrlPeriod;
+    lastFbStamp=-1.0;
+    lastCycleTime=0.0;
+    eventFreshCnt=0;
+    eventTimeoutCnt=0;
 }
 
 
@@ -234,14 +304,21 @@ void ServerCartesianController::openPorts()
     string prefixName="/";
     prefixName=prefixName+ctrlName;
 
-    portSlvIn.open(prefixName+"/"+slvName+"/in");
-    portSlvOut.open(prefixName+"/"+slvName+"/out");
-    portSlvRpc.open(prefixName+"/"+slvName+"/rpc");
+    // a local solver is reached by direct calls
+    if (!localSolverEnabled)
+    {
+        portSlvIn.open(prefixName+"/"+slvName+"/in");
+        portSlvOut.open(prefixName+"/"+slvName+"/out");
+        portSlvRpc.open(prefixName+"/"+slvName+"/rpc");
+    }
     portCmd->open(prefixName+"/command:i");
     portState.open(prefixName+"/state:o");
+    portStateFull.open(prefixName+"/state_full:o");
     portEvent.open(prefixName+"/events:o");
     portRpc.open(prefixName+"/rpc:i");
 
+    portTelemetry.open(prefixName+"/telemetry:o");
+
     if (debugInfoEnabled)
         portDebugInfo.open(prefixName+"/dbg:o");
 }
@@ -264,15 +341,19 @@ void ServerCartesianController::closePorts()
     portSlvOut.interrupt();
     portSlvRpc.interrupt();
     portState.interrupt();
+    portStateFull.interrupt();
     portEvent.interrupt();
     portRpc.interrupt();
+    portTelemetry.interrupt();
 
     portSlvIn.close();
     portSlvOut.close();
     portSlvRpc.close();
     portState.close();
+    portStateFull.close();
     portEvent.close();
     portRpc.close();
+    portTelemetry.close();
 
     if (debugInfoEnabled)
     {
@@ -351,7 +432,7 @@ bool ServerCartesianController::respond(const Bottle &command, Bottle &reply)
                 // just behave as a relay
                 Bottle slvCommand=command;
 
-                if (!portSlvRpc.write(slvCommand,reply))
+                if (!writeToSolver(slvCommand,reply))
                 {
                     yError("%s: unable to get reply from solver!",ctrlName.c_str());
                     reply.addVocab32(IKINCARTCTRL_VOCAB_REP_NACK);
@@ -724,6 +805,16 @@ bool ServerCartesianController::respond(const Bottle &command, Bottle &reply)
                             break;
                         }
 
+                        //-----------------
+                        case IKINCARTCTRL_VOCAB_OPT_TELEMETRY:
+                        {
+                            Bottle info;
+                            getTelemetryHelper(info);
+                            reply.addVocab32(IKINCARTCTRL_VOCAB_REP_ACK);
+                            reply.addList()=info;
+                            break;
+                        }
+
                         //-----------------
                         case IKINCARTCTRL_VOCAB_OPT_TWEAK:
                         {
@@ -971,6 +1062,22 @@ bool ServerCartesianController::respond(const Bottle &command, Bottle &reply)
                             break;
                         }
 
+                        //-----------------
+                        case IKINCARTCTRL_VOCAB_OPT_TELEMETRY:
+                        {
+                            if (command.get(2).asString()=="reset")
+                            {
+                                telemetry.reset();
+                                eventFreshCnt=0;
+                                eventTimeoutCnt=0;
+                                reply.addVocab32(IKINCARTCTRL_VOCAB_REP_ACK);
+                            }
+                            else
+                                reply.addVocab32(IKINCARTCTRL_VOCAB_REP_NACK);
+
+                            break;
+                        }
+
                         //-----------------
                         default:
                             reply.addVocab32(IKINCARTCTRL_VOCAB_REP_NACK);
@@ -1143,6 +1250,74 @@ double ServerCartesianController::getFeedback(Vector &_fb)
 }
 
 
+/************************************************************************/
+double ServerCartesianController::getFeedbackStamp()
+{
+    if (useReferences || !encTimedEnabled)
+        return -1.0;
+
+    Vector fbTmp(maxPartJoints);
+    Vector stamps(maxPartJoints);
+    double timeStamp=-1.0;
+
+    for (int i=0; i<numDrv; i++)
+        if (lEnt[i]->getEncodersTimed(fbTmp.data(),stamps.data()))
+            timeStamp=std::max(timeStamp,findMax(stamps.subVector(0,lJnt[i]-1)));
+
+    return timeStamp;
+}
+
+
+/************************************************************************/
+bool ServerCartesianController::isCycleTriggered()
+{
+    // the thread polls at a finer period, but the control cycle is
+    // never run faster than the nominal period, which is the sample
+    // time of the controller and of the Smith Predictor
+    double t=Time::now();
+    double elapsed=t-lastCycleTime;
+    if (elapsed<ctrlPeriod-0.5*CARTCTRL_EVENT_POLL_PER)
+        return false;
+
+    // without stamps (e.g. when the references are used
+    // as feedback) the cycle is run at the nominal period
+    double stamp=getFeedbackStamp();
+    if ((stamp<0.0) || (stamp>lastFbStamp))
+        eventFreshCnt++;
+    else if (elapsed>=eventTimeout)
+        eventTimeoutCnt++;
+    else
+        return false;
+
+    lastCycleTime=t;
+    return true;
+}
+
+
+/************************************************************************/
+void ServerCartesianController::getTelemetryHelper(Bottle &info)
+{
+    telemetry.getInfo(info);
+    if (eventDrivenEnabled)
+    {
+        Bottle &event=info.addList();
+        event.addString("event_driven");
+
+        Bottle &timeout=event.addList();
+        timeout.addString("timeout");
+        timeout.addFloat64(1000.0*eventTimeout);
+
+        Bottle &fresh=event.addList();
+        fresh.addString("fresh");
+        fresh.addInt64(eventFreshCnt);
+
+        Bottle &expired=event.addList();
+        expired.addString("expired");
+        expired.addInt64(eventTimeoutCnt);
+    }
+}
+
+
 /************************************************************************/
 void ServerCartesianController::createController()
 {
@@ -1167,14 +1342,14 @@ void ServerCartesianController::createController()
 
     // instantiate new controller
     if (posDirectEnabled)
-        ctrl=new MultiRefMinJerkCtrl(*chainPlan,ctrlPose,getPeriod());
+        ctrl=new MultiRefMinJerkCtrl(*chainPlan,ctrlPose,ctrlPeriod);
     else if (plantModelProperties.check("plant_compensator",Value("off")).asString()=="on")
     {
-        ctrl=new MultiRefMinJerkCtrl(*chainState,ctrlPose,getPeriod(),true);
+        ctrl=new MultiRefMinJerkCtrl(*chainState,ctrlPose,ctrlPeriod,true);
         ctrl->setPlantParameters(plantModelProperties,"joint");
     }
     else
-        ctrl=new MultiRefMinJerkCtrl(*chainState,ctrlPose,getPeriod());
+        ctrl=new MultiRefMinJerkCtrl(*chainState,ctrlPose,ctrlPeriod);
 
     // set tolerance
     ctrl->setInTargetTol(targetTol);
@@ -1191,7 +1366,12 @@ void ServerCartesianController::createController()
 /************************************************************************/
 bool ServerCartesianController::getNewTarget()
 {
-    if (Bottle *b1=portSlvIn.read(false))
+#ifdef CARTCTRL_USE_LOCAL_SOLVER
+    Bottle *b1=localSolverEnabled?localSolverReceiver->read():portSlvIn.read(false);
+#else
+    Bottle *b1=portSlvIn.read(false);
+#endif
+    if (b1!=NULL)
     {
         bool tokened=getTokenOption(*b1,&rxToken);
 
@@ -1591,7 +1771,7 @@ void ServerCartesianController::stopLimb(const bool execStopPosition)
 /************************************************************************/
 bool ServerCartesianController::threadInit()
 {
-    yInfo("Starting %s at %d ms",ctrlName.c_str(),(int)(1000.0*getPeriod()));
+    yInfo("Starting %s at %d ms",ctrlName.c_str(),(int)(1000.0*ctrlPeriod));
     return true;
 }
 
@@ -1611,10 +1791,19 @@ void ServerCartesianController::run()
 {    
     if (connected)
     {
+        // in event-driven mode the cycle is triggered
+        // by the arrival of fresh encoders
+        if (eventDrivenEnabled && !isCycleTriggered())
+            return;
+
+        telemetry.beginCycle();
         lock_guard<mutex> lck(mtx);
 
         // read the feedback
+        telemetry.tic(tmSectionIO);
         double stamp=getFeedback(fb);
+        lastFbStamp=stamp;
+        telemetry.toc(tmSectionIO);
 
         // update the stamp anyway
         if (stamp>=0.0)
@@ -1675,6 +1864,7 @@ void ServerCartesianController::run()
         if (executingTraj)
         {
             // add the contribution of the Smith Predictor block
+            telemetry.tic(tmSectionCtrl);
             ctrl->add_compensation(-1.0*smithPredictor.computeCmd(ctrl->get_qdot()));
 
             // limb control loop
@@ -1682,6 +1872,7 @@ void ServerCartesianController::run()
                 ctrl->iterate(xdes,qdes,xdot_set);
             else
                 ctrl->iterate(xdes,qdes);
+            telemetry.toc(tmSectionCtrl);
 
             // handle the end-trajectory event
             bool inTarget=ctrl->isInTarget();
@@ -1704,6 +1895,7 @@ void ServerCartesianController::run()
             else
             {
                 // send commands to the robot                
+                telemetry.tic(tmSectionIO);
                 if (debugInfoEnabled && (portDebugInfo.getOutputCount()>0))
                 {
                     portDebugInfo.prepare()=(this->*sendCtrlCmd)();
@@ -1713,15 +1905,45 @@ void ServerCartesianController::run()
                 }
                 else
                     (this->*sendCtrlCmd)();
+                telemetry.toc(tmSectionIO);
             }
         }        
 
         // stream out the end-effector pose
         if (portState.getOutputCount()>0)
         {
-            portState.prepare()=chainState->EndEffPose();
+            telemetry.tic(tmSectionFk);
+            Vector &pose=portState.prepare();
+            pose=chainState->EndEffPose();
+            telemetry.toc(tmSectionFk);
+
+            telemetry.tic(tmSectionIO);
             portState.setEnvelope(txInfo);
             portState.write();
+            telemetry.toc(tmSectionIO);
+        }
+
+        // stream out the full state, which the clients
+        // cache to serve the getters without rpc
+        if (portStateFull.getOutputCount()>0)
+        {
+            Vector xdhat,odhat,qdhat,xdot,odot;
+            getDesiredHelper(xdhat,odhat,qdhat);
+            getTaskVelocitiesHelper(xdot,odot);
+
+            deque<Vector> fields(IKINCARTCTRL_STATE_NUM);
+            fields[IKINCARTCTRL_STATE_POSE]=chainState->EndEffPose();
+            fields[IKINCARTCTRL_STATE_DES_POSE]=cat(xdhat,odhat);
+            fields[IKINCARTCTRL_STATE_DES_JOINTS]=qdhat;
+            fields[IKINCARTCTRL_STATE_QDOT]=velCmd;
+            fields[IKINCARTCTRL_STATE_XDOT]=cat(xdot,odot);
+            fields[IKINCARTCTRL_STATE_MOTIONDONE]=Vector(1,motionDone?1.0:0.0);
+
+            telemetry.tic(tmSectionIO);
+            packState(fields,portStateFull.prepare());
+            portStateFull.setEnvelope(txInfo);
+            portStateFull.write();
+            telemetry.toc(tmSectionIO);
         }
 
         if (event=="motion-onset")
@@ -1734,6 +1956,19 @@ void ServerCartesianController::run()
             motionOngoingEventsFlush();
             notifyEvent(event);
         }
+
+        telemetry.endCycle();
+
+        // stream out the timing statistics
+        double t=Time::now();
+        if ((t-telemetryTxTime>=CARTCTRL_TELEMETRY_PER) && (portTelemetry.getOutputCount()>0))
+        {
+            Bottle &info=portTelemetry.prepare();
+            info.clear();
+            getTelemetryHelper(info);
+            portTelemetry.write();
+            telemetryTxTime=t;
+        }
     }
     else if ((++connectCnt)*getPeriod()>CARTCTRL_CONNECT_SOLVER_PING)
     {
@@ -1857,7 +2092,14 @@ bool ServerCartesianController::open(Searchable &config)
     }
 
     if (optGeneral.check("ControllerPeriod"))
-        setPeriod((double)optGeneral.find("ControllerPeriod").asInt32()/1000.0);
+        ctrlPeriod=(double)optGeneral.find("ControllerPeriod").asInt32()/1000.0;
+    setPeriod(ctrlPeriod);
+    telemetry.setPeriod(ctrlPeriod);
+
+    eventDrivenEnabled=optGeneral.check("EventDriven",Value("off")).asString()=="on";
+    eventTimeout=optGeneral.check("EventTimeout",
+                                  Value(1000.0*CARTCTRL_DEFAULT_EVENT_TMO_FACTOR*ctrlPeriod)).asFloat64()/1000.0;
+    eventTimeout=std::max(eventTimeout,ctrlPeriod);
 
     taskRefVelPeriodFactor=optGeneral.check("TaskRefVelPeriodFactor",
                                             Value(CARTCTRL_DEFAULT_TASKVEL_PERFACTOR)).asInt32();
@@ -1872,6 +2114,39 @@ bool ServerCartesianController::open(Searchable &config)
     if (debugInfoEnabled)
         yDebug("Commands to robot will be also streamed out on debug port");
 
+    localSolverEnabled=optGeneral.check("LocalSolver",Value("off")).asString()=="on";
+    if (localSolverEnabled)
+    {
+    #ifndef CARTCTRL_USE_LOCAL_SOLVER
+        yError("LocalSolver is not available since the solver has not been compiled");
+        close();
+        return false;
+    #endif
+
+        if ((kinPart!="arm") && (kinPart!="leg"))
+        {
+            yError("LocalSolver is available only for the arm and leg kinematic parts");
+            close();
+            return false;
+        }
+
+        // the SOLVER group is given to the solver as its configuration,
+        // as done by the iKinCartesianSolver module
+        Bottle &optSolver=config.findGroup("SOLVER");
+        if (optSolver.isNull())
+        {
+            yError("SOLVER group is missing");
+            close();
+            return false;
+        }
+
+        localSolverOptions.fromString(optSolver.toString());
+        if (!localSolverOptions.check("type"))
+            localSolverOptions.put("type",kinType);
+
+        yInfo("Solver %s will be hosted in this process",slvName.c_str());
+    }
+
     // scan DRIVER groups
     for (int i=0; i<numDrv; i++)
     {
@@ -1955,7 +2230,7 @@ bool ServerCartesianController::open(Searchable &config)
         // append information about the predictor's period,
         // that must match the controller's period
         plantModelProperties.unput("Ts");
-        plantModelProperties.put("Ts",getPeriod());
+        plantModelProperties.put("Ts",ctrlPeriod);
     }
     else
         plantModelProperties.clear();
@@ -2021,8 +2296,10 @@ bool ServerCartesianController::close()
         unregisterEvent(*eventsMap.begin()->second);
 
     closePorts();
+    closeLocalSolver();
 
     contextMap.clear();
+    activeContext.reset();
 
     return closed=true;
 }
@@ -2148,6 +2425,25 @@ bool ServerCartesianController::attachAll(const PolyDriverList &p)
     yInfo("%s: IPidControl %s",ctrlName.c_str(),
           pidAvailable?"available":"not available");
 
+    // the cycle can be triggered only by timed encoders
+    if (eventDrivenEnabled && !encTimedEnabled)
+    {
+        yWarning("%s: EventDriven requires IEncodersTimed, the cycle will be periodic",
+                 ctrlName.c_str());
+        eventDrivenEnabled=false;
+    }
+
+    if (eventDrivenEnabled)
+    {
+        yInfo("%s: cycle triggered by fresh encoders with timeout at %d ms",
+              ctrlName.c_str(),(int)(1000.0*eventTimeout));
+        setPeriod(CARTCTRL_EVENT_POLL_PER);
+        lastFbStamp=-1.0;
+        lastCycleTime=0.0;
+    }
+    else
+        setPeriod(ctrlPeriod);
+
     yInfo("%s: IPositionDirect %s",ctrlName.c_str(),
           posDirectAvailable?"available":"not available");
 
@@ -2200,7 +2496,7 @@ bool ServerCartesianController::attachAll(const PolyDriverList &p)
 
     // create the target generator for
     // task-space reference velocity
-    taskRefVelTargetGen=new TaskRefVelTargetGenerator(taskRefVelPeriodFactor*getPeriod(),ctrl->get_x());
+    taskRefVelTargetGen=new TaskRefVelTargetGenerator(taskRefVelPeriodFactor*ctrlPeriod,ctrl->get_x());
     taskRefVelPeriodCnt=0;
 
     start();
@@ -2247,6 +2543,9 @@ bool ServerCartesianController::detachAll()
 /************************************************************************/
 bool ServerCartesianController::pingSolver()
 {    
+    if (localSolverEnabled)
+        return (localSolver!=NULL) || openLocalSolver();
+
     string portSlvName="/";
     portSlvName=portSlvName+slvName+"/in";    
 
@@ -2263,23 +2562,28 @@ bool ServerCartesianController::connectToSolver()
 {
     if (attached && !connected && pingSolver())
     {        
-        yInfo("%s: Connecting to cartesian solver %s...",ctrlName.c_str(),slvName.c_str());
+        if (localSolverEnabled)
+            yInfo("%s: Using local cartesian solver %s",ctrlName.c_str(),slvName.c_str());
+        else
+        {
+            yInfo("%s: Connecting to cartesian solver %s...",ctrlName.c_str(),slvName.c_str());
 
-        string portSlvName="/";
-        portSlvName=portSlvName+slvName;
+            string portSlvName="/";
+            portSlvName=portSlvName+slvName;
 
-        bool ok=true;
+            bool ok=true;
 
-        ok&=Network::connect(portSlvName+"/out",portSlvIn.getName(),"udp");
-        ok&=Network::connect(portSlvOut.getName(),portSlvName+"/in","udp");
-        ok&=Network::connect(portSlvRpc.getName(),portSlvName+"/rpc");
+            ok&=Network::connect(portSlvName+"/out",portSlvIn.getName(),"udp");
+            ok&=Network::connect(portSlvOut.getName(),portSlvName+"/in","udp");
+            ok&=Network::connect(portSlvRpc.getName(),portSlvName+"/rpc");
 
-        if (ok)
-            yInfo("%s: Connections established with %s",ctrlName.c_str(),slvName.c_str());
-        else
-        {
-            yError("%s: Problems detected while connecting to %s",ctrlName.c_str(),slvName.c_str());
-            return false;
+            if (ok)
+                yInfo("%s: Connections established with %s",ctrlName.c_str(),slvName.c_str());
+            else
+            {
+                yError("%s: Problems detected while connecting to %s",ctrlName.c_str(),slvName.c_str());
+                return false;
+            }
         }
 
         // this line shall be put before any
@@ -2292,7 +2596,7 @@ bool ServerCartesianController::connectToSolver()
         command.addVocab32(IKINSLV_VOCAB_OPT_DOF);
 
         // send command to solver and wait for reply
-        if (!portSlvRpc.write(command,reply))
+        if (!writeToSolver(command,reply))
         {
             yError("%s: unable to get reply from solver!",ctrlName.c_str());         
             return false;
@@ -2323,6 +2627,69 @@ bool ServerCartesianController::connectToSolver()
 }
 
 
+/************************************************************************/
+bool ServerCartesianController::openLocalSolver()
+{
+#ifdef CARTCTRL_USE_LOCAL_SOLVER
+    yInfo("%s: Opening local cartesian solver %s...",ctrlName.c_str(),slvName.c_str());
+
+    if (kinPart=="arm")
+        localSolver=new iCubArmCartesianSolver(slvName);
+    else
+        localSolver=new iCubLegCartesianSolver(slvName);
+
+    if (!localSolver->open(localSolverOptions))
+    {
+        yError("%s: Unable to open local cartesian solver %s",ctrlName.c_str(),slvName.c_str());
+        delete localSolver;
+        localSolver=NULL;
+        return false;
+    }
+
+    localSolverReceiver=new CartesianCtrlSolverReceiver;
+    localSolver->setReceiver(localSolverReceiver);
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+/************************************************************************/
+void ServerCartesianController::closeLocalSolver()
+{
+#ifdef CARTCTRL_USE_LOCAL_SOLVER
+    if (localSolver!=NULL)
+    {
+        localSolver->setReceiver(NULL);
+        localSolver->close();
+        delete localSolver;
+        localSolver=NULL;
+    }
+
+    delete localSolverReceiver;
+    localSolverReceiver=NULL;
+#endif
+}
+
+
+/************************************************************************/
+bool ServerCartesianController::writeToSolver(const Bottle &command, Bottle &reply)
+{
+    // any set command invalidates the knowledge of the active context
+    if (command.get(0).asVocab32()==IKINSLV_VOCAB_CMD_SET)
+        configVersion++;
+
+#ifdef CARTCTRL_USE_LOCAL_SOLVER
+    if (localSolverEnabled)
+        return (localSolver!=NULL) && localSolver->sendCommand(command,reply);
+#endif
+
+    return portSlvRpc.write(command,reply);
+}
+
+
 /************************************************************************/
 bool ServerCartesianController::goTo(unsigned int _ctrlPose, const Vector &xd,
                                      const double t, const bool latchToken)
@@ -2337,7 +2704,7 @@ bool ServerCartesianController::goTo(unsigned int _ctrlPose, const Vector &xd,
         if (t>0.0)
             setTrajTimeHelper(t);
 
-        Bottle &b=portSlvOut.prepare();
+        Bottle &b=localSolverEnabled?localSolverRequest:portSlvOut.prepare();
         b.clear();
     
         // xd part
@@ -2358,7 +2725,12 @@ bool ServerCartesianController::goTo(unsigned int _ctrlPose, const Vector &xd,
         if (latchToken)
             txTokenLatchedGoToRpc=txToken;
 
-        portSlvOut.writeStrict();
+    #ifdef CARTCTRL_USE_LOCAL_SOLVER
+        if (localSolverEnabled)
+            localSolver->sendRequest(b);
+        else
+    #endif
+            portSlvOut.writeStrict();
         return true;
     }
     else
@@ -2378,7 +2750,7 @@ bool ServerCartesianController::setTrackingModeHelper(const bool f)
 
         // send command to solver and wait for reply
         bool ret=false;
-        if (!portSlvRpc.write(command,reply))
+        if (!writeToSolver(command,reply))
             yError("%s: unable to get reply from solver!",ctrlName.c_str());         
         else if (reply.get(0).asVocab32()==IKINSLV_VOCAB_REP_ACK)
         {
@@ -2454,7 +2826,7 @@ bool ServerCartesianController::setPosePriority(const string &p)
         command.addVocab32(p=="position"?IKINSLV_VOCAB_VAL_PRIO_XYZ:IKINSLV_VOCAB_VAL_PRIO_ANG);
 
         // send command to solver and wait for reply
-        if (portSlvRpc.write(command,reply))
+        if (writeToSolver(command,reply))
             ret=(reply.get(0).asVocab32()==IKINSLV_VOCAB_REP_ACK);
         else
             yError("%s: unable to get reply from solver!",ctrlName.c_str());
@@ -2475,7 +2847,7 @@ bool ServerCartesianController::getPosePriority(string &p)
         command.addVocab32(IKINSLV_VOCAB_OPT_PRIO);
 
         // send command to solver and wait for reply
-        if (portSlvRpc.write(command,reply))
+        if (writeToSolver(command,reply))
         {
             if (ret=(reply.get(0).asVocab32()==IKINSLV_VOCAB_REP_ACK))
                 p=(reply.get(1).asVocab32()==IKINSLV_VOCAB_VAL_PRIO_XYZ)?
@@ -2603,33 +2975,39 @@ bool ServerCartesianController::goToPositionSync(const Vector &xd, const double
 
 
 /************************************************************************/
-bool ServerCartesianController::getDesired(Vector &xdhat, Vector &odhat,
-                                           Vector &qdhat)
+void ServerCartesianController::getDesiredHelper(Vector &xdhat, Vector &odhat,
+                                                 Vector &qdhat)
 {
-    if (connected)
-    {
-        lock_guard<mutex> lck(mtx);
+    xdhat.resize(3);
+    odhat.resize(xdes.length()-3);
 
-        xdhat.resize(3);
-        odhat.resize(xdes.length()-3);
+    for (size_t i=0; i<xdhat.length(); i++)
+        xdhat[i]=xdes[i];
 
-        for (size_t i=0; i<xdhat.length(); i++)
-            xdhat[i]=xdes[i];
+    for (size_t i=0; i<odhat.length(); i++)
+        odhat[i]=xdes[xdhat.length()+i];
 
-        for (size_t i=0; i<odhat.length(); i++)
-            odhat[i]=xdes[xdhat.length()+i];
+    qdhat.resize(chainState->getN());
+    int cnt=0;
 
-        qdhat.resize(chainState->getN());
-        int cnt=0;
+    for (unsigned int i=0; i<chainState->getN(); i++)
+    {
+        if ((*chainState)[i].isBlocked())
+            qdhat[i]=CTRL_RAD2DEG*chainState->getAng(i);
+        else
+            qdhat[i]=CTRL_RAD2DEG*qdes[cnt++];
+    }
+}
 
-        for (unsigned int i=0; i<chainState->getN(); i++)
-        {
-            if ((*chainState)[i].isBlocked())
-                qdhat[i]=CTRL_RAD2DEG*chainState->getAng(i);
-            else
-                qdhat[i]=CTRL_RAD2DEG*qdes[cnt++];
-        }
 
+/************************************************************************/
+bool ServerCartesianController::getDesired(Vector &xdhat, Vector &odhat,
+                                           Vector &qdhat)
+{
+    if (connected)
+    {
+        lock_guard<mutex> lck(mtx);
+        getDesiredHelper(xdhat,odhat,qdhat);
         return true;
     }
     else
@@ -2661,7 +3039,7 @@ bool ServerCartesianController::askForPose(const Vector &xd, const Vector &od,
 
     // send command and wait for reply
     bool ret=false;
-    if (portSlvRpc.write(command,reply))
+    if (writeToSolver(command,reply))
         ret=getDesiredOption(reply,xdhat,odhat,qdhat);
     else
         yError("%s: unable to get reply from solver!",ctrlName.c_str());         
@@ -2695,7 +3073,7 @@ bool ServerCartesianController::askForPose(const Vector &q0, const Vector &xd,
 
     // send command and wait for reply
     bool ret=false;
-    if (portSlvRpc.write(command,reply))
+    if (writeToSolver(command,reply))
         ret=getDesiredOption(reply,xdhat,odhat,qdhat);
     else
         yError("%s: unable to get reply from solver!",ctrlName.c_str());         
@@ -2720,7 +3098,7 @@ bool ServerCartesianController::askForPosition(const Vector &xd, Vector &xdhat,
 
     // send command and wait for reply
     bool ret=false;
-    if (portSlvRpc.write(command,reply))
+    if (writeToSolver(command,reply))
         ret=getDesiredOption(reply,xdhat,odhat,qdhat);
     else
         yError("%s: unable to get reply from solver!",ctrlName.c_str());         
@@ -2747,7 +3125,67 @@ bool ServerCartesianController::askForPosition(const Vector &q0, const Vector &x
 
     // send command and wait for reply
     bool ret=false;
-    if (portSlvRpc.write(command,reply))
+    if (writeToSolver(command,reply))
+        ret=getDesiredOption(reply,xdhat,odhat,qdhat);
+    else
+        yError("%s: unable to get reply from solver!",ctrlName.c_str());         
+
+    return ret;
+}
+
+
+/************************************************************************/
+bool ServerCartesianController::askForPoses(const Vector &q0, const deque<Vector> &xd,
+                                            const deque<Vector> &od, deque<Vector> &xdhat,
+                                            deque<Vector> &odhat, deque<Vector> &qdhat)
+{
+    if (!connected || xd.empty() || (xd.size()!=od.size()))
+        return false;
+
+    lock_guard<mutex> lck(mtx);
+
+    deque<Vector> tg;
+    for (size_t i=0; i<xd.size(); i++)
+        tg.push_back(cat(xd[i],od[i]));
+
+    Bottle command, reply;
+    command.addVocab32(IKINSLV_VOCAB_CMD_ASK);
+    addTargetsOption(command,tg);
+    if (q0.length()>0)
+        addVectorOption(command,IKINSLV_VOCAB_OPT_Q,q0);
+    addPoseOption(command,IKINCTRL_POSE_FULL);
+
+    // send command and wait for reply
+    bool ret=false;
+    if (writeToSolver(command,reply))
+        ret=getDesiredOption(reply,xdhat,odhat,qdhat);
+    else
+        yError("%s: unable to get reply from solver!",ctrlName.c_str());         
+
+    return ret;
+}
+
+
+/************************************************************************/
+bool ServerCartesianController::askForPositions(const Vector &q0, const deque<Vector> &xd,
+                                                deque<Vector> &xdhat, deque<Vector> &odhat,
+                                                deque<Vector> &qdhat)
+{
+    if (!connected || xd.empty())
+        return false;
+
+    lock_guard<mutex> lck(mtx);
+
+    Bottle command, reply;
+    command.addVocab32(IKINSLV_VOCAB_CMD_ASK);
+    addTargetsOption(command,xd);
+    if (q0.length()>0)
+        addVectorOption(command,IKINSLV_VOCAB_OPT_Q,q0);
+    addPoseOption(command,IKINCTRL_POSE_XYZ);
+
+    // send command and wait for reply
+    bool ret=false;
+    if (writeToSolver(command,reply))
         ret=getDesiredOption(reply,xdhat,odhat,qdhat);
     else
         yError("%s: unable to get reply from solver!",ctrlName.c_str());         
@@ -2790,7 +3228,7 @@ bool ServerCartesianController::setDOF(const Vector &newDof, Vector &curDof)
     
         // send command to solver and wait for reply
         bool ret=false;
-        if (portSlvRpc.write(command,reply))
+        if (writeToSolver(command,reply))
         {
             // update chain's links
             // skip the first ack/nack vocab
@@ -2838,7 +3276,7 @@ bool ServerCartesianController::getRestPos(Vector &curRestPos)
     
         // send command to solver and wait for reply
         bool ret=false;
-        if (portSlvRpc.write(command,reply))
+        if (writeToSolver(command,reply))
         {
             Bottle *rxRestPart=reply.get(1).asList();
             curRestPos.resize(rxRestPart->size());
@@ -2872,7 +3310,7 @@ bool ServerCartesianController::setRestPos(const Vector &newRestPos,
     
         // send command to solver and wait for reply
         bool ret=false;
-        if (portSlvRpc.write(command,reply))
+        if (writeToSolver(command,reply))
         {
             Bottle *rxRestPart=reply.get(1).asList();
             curRestPos.resize(rxRestPart->size());
@@ -2904,7 +3342,7 @@ bool ServerCartesianController::getRestWeights(Vector &curRestWeights)
     
         // send command to solver and wait for reply
         bool ret=false;
-        if (portSlvRpc.write(command,reply))
+        if (writeToSolver(command,reply))
         {
             Bottle *rxRestPart=reply.get(1).asList();
             curRestWeights.resize(rxRestPart->size());
@@ -2938,7 +3376,7 @@ bool ServerCartesianController::setRestWeights(const Vector &newRestWeights,
     
         // send command to solver and wait for reply
         bool ret=false;
-        if (portSlvRpc.write(command,reply))
+        if (writeToSolver(command,reply))
         {
             Bottle *rxRestPart=reply.get(1).asList();
             curRestWeights.resize(rxRestPart->size());
@@ -2973,7 +3411,7 @@ bool ServerCartesianController::getLimits(const int axis, double *min,
             command.addInt32(axis);
 
             // send command to solver and wait for reply
-            if (!portSlvRpc.write(command,reply))
+            if (!writeToSolver(command,reply))
                 yError("%s: unable to get reply from solver!",ctrlName.c_str());         
             else if (reply.get(0).asVocab32()==IKINSLV_VOCAB_REP_ACK)
             {
@@ -3005,7 +3443,7 @@ bool ServerCartesianController::setLimits(const int axis, const double min,
         command.addFloat64(max);
 
         // send command to solver and wait for reply        
-        if (portSlvRpc.write(command,reply))
+        if (writeToSolver(command,reply))
             ret=(reply.get(0).asVocab32()==IKINSLV_VOCAB_REP_ACK);
         else
             yError("%s: unable to get reply from solver!",ctrlName.c_str());
@@ -3125,39 +3563,44 @@ bool ServerCartesianController::getJointsVelocities(Vector &qdot)
 
 
 /************************************************************************/
-bool ServerCartesianController::getTaskVelocities(Vector &xdot, Vector &odot)
+void ServerCartesianController::getTaskVelocitiesHelper(Vector &xdot, Vector &odot)
 {
-    if (connected)
+    Matrix J=ctrl->get_J();
+    Vector taskVel(7,0.0);
+
+    if ((J.rows()>0) && (J.cols()==velCmd.length()))
     {
-        lock_guard<mutex> lck(mtx);
+        taskVel=J*(CTRL_DEG2RAD*velCmd);
 
-        Matrix J=ctrl->get_J();
-        Vector taskVel(7,0.0);
+        Vector _odot=taskVel.subVector(3,(unsigned int)taskVel.length()-1);
+        double thetadot=norm(_odot);
+        if (thetadot>0.0)
+            _odot/=thetadot;
 
-        if ((J.rows()>0) && (J.cols()==velCmd.length()))
-        {
-            taskVel=J*(CTRL_DEG2RAD*velCmd);
+        taskVel[3]=_odot[0];
+        taskVel[4]=_odot[1];
+        taskVel[5]=_odot[2];
+        taskVel.push_back(thetadot);
+    }
 
-            Vector _odot=taskVel.subVector(3,(unsigned int)taskVel.length()-1);
-            double thetadot=norm(_odot);
-            if (thetadot>0.0)
-                _odot/=thetadot;
+    xdot.resize(3);
+    odot.resize(taskVel.length()-xdot.length());
 
-            taskVel[3]=_odot[0];
-            taskVel[4]=_odot[1];
-            taskVel[5]=_odot[2];
-            taskVel.push_back(thetadot);
-        }
+    for (size_t i=0; i<xdot.length(); i++)
+        xdot[i]=taskVel[i];
 
-        xdot.resize(3);
-        odot.resize(taskVel.length()-xdot.length());
-    
-        for (size_t i=0; i<xdot.length(); i++)
-            xdot[i]=taskVel[i];
-    
-        for (size_t i=0; i<odot.length(); i++)
-            odot[i]=taskVel[xdot.length()+i];
+    for (size_t i=0; i<odot.length(); i++)
+        odot[i]=taskVel[xdot.length()+i];
+}
 
+
+/************************************************************************/
+bool ServerCartesianController::getTaskVelocities(Vector &xdot, Vector &odot)
+{
+    if (connected)
+    {
+        lock_guard<mutex> lck(mtx);
+        getTaskVelocitiesHelper(xdot,odot);
         return true;
     }
     else
@@ -3219,7 +3662,7 @@ bool ServerCartesianController::attachTipFrame(const Vector &x, const Vector &o)
 
         // send command to solver and wait for reply
         bool ret=false;
-        if (portSlvRpc.write(command,reply))
+        if (writeToSolver(command,reply))
         {
             if (ret=(reply.get(0).asVocab32()==IKINSLV_VOCAB_REP_ACK))
             {
@@ -3345,6 +3788,31 @@ bool ServerCartesianController::storeContext(int *id)
     {
         mtx.lock();
         unsigned int N=chainState->getN();
+        unsigned long version=configVersion;
+
+        // the solver part is already known: no need to query it
+        if (activeContext && (activeVersion==version))
+        {
+            shared_ptr<const Context> context=activeContext;
+            if ((context->trajTime!=trajTime) || (context->tol!=targetTol) ||
+                (context->mode!=trackingMode) || (context->useReferences!=useReferences) ||
+                (context->straightness!=ctrl->get_gamma()))
+            {
+                shared_ptr<Context> modified=make_shared<Context>(*context);
+                modified->trajTime=trajTime;
+                modified->tol=targetTol;
+                modified->mode=trackingMode;
+                modified->useReferences=useReferences;
+                modified->straightness=ctrl->get_gamma();
+                activeContext=context=modified;
+            }
+
+            contextMap[contextIdCnt]=context;
+            *id=contextIdCnt++;
+            mtx.unlock();
+            return true;
+        }
+
         mtx.unlock();
 
         Vector _dof,_restPos,_restWeights;
@@ -3374,21 +3842,29 @@ bool ServerCartesianController::storeContext(int *id)
 
         lock_guard<mutex> lck(mtx);
 
-        Context &context=contextMap[contextIdCnt];
-        context.dof=_dof;
-        context.restPos=_restPos;
-        context.restWeights=_restWeights;
-        context.limits=_limits;
-        context.tip_x=_tip_x;
-        context.tip_o=_tip_o;
-        context.trajTime=_trajTime;
-        context.tol=_tol;
-        context.mode=_mode;
-        context.useReferences=_useReference;
-        context.straightness=ctrl->get_gamma();
-        getPosePriority(context.posePriority);
-        getTask2ndOptions(context.task_2);
-        getSolverConvergenceOptions(context.solverConvergence);
+        shared_ptr<Context> context=make_shared<Context>();
+        context->dof=_dof;
+        context->restPos=_restPos;
+        context->restWeights=_restWeights;
+        context->limits=_limits;
+        context->tip_x=_tip_x;
+        context->tip_o=_tip_o;
+        context->trajTime=_trajTime;
+        context->tol=_tol;
+        context->mode=_mode;
+        context->useReferences=_useReference;
+        context->straightness=ctrl->get_gamma();
+        getPosePriority(context->posePriority);
+        getTask2ndOptions(context->task_2);
+        getSolverConvergenceOptions(context->solverConvergence);
+        contextMap[contextIdCnt]=context;
+
+        // the snapshot is reliable only if nothing changed meanwhile
+        if (configVersion==version)
+        {
+            activeContext=context;
+            activeVersion=version;
+        }
 
         *id=contextIdCnt++;
         return true;
@@ -3405,32 +3881,78 @@ bool ServerCartesianController::restoreContext(const int id)
     {
         mtx.lock();
 
-        map<int,Context>::iterator itr=contextMap.find(id);
-        bool valid=(itr!=contextMap.end());
-        Context context;
-        if (valid)
+        map<int,shared_ptr<const Context>>::iterator itr=contextMap.find(id);
+        shared_ptr<const Context> context;
+        if (itr!=contextMap.end())
             context=itr->second;
 
+        // without a known active context everything is applied
+        shared_ptr<const Context> cur;
+        if (activeVersion==configVersion)
+            cur=activeContext;
+
         mtx.unlock();
 
-        if (valid)
+        if (context)
         {
-            setDOF(context.dof,context.dof);
-            setRestPos(context.restPos,context.restPos);
-            setRestWeights(context.restWeights,context.restWeights);
-            attachTipFrame(context.tip_x,context.tip_o);
+            // nothing to do if the context is already active
+            if (cur==context)
+                return true;
 
-            for (unsigned int axis=0; axis<chainState->getN(); axis++)
-                setLimits(axis,context.limits(axis,0),context.limits(axis,1));
+            bool ok=true;
+            if (!cur || !(cur->dof==context->dof))
+            {
+                Vector curDof;
+                ok&=setDOF(context->dof,curDof);
+            }
+
+            if (!cur || !(cur->restPos==context->restPos))
+            {
+                Vector curRestPos;
+                ok&=setRestPos(context->restPos,curRestPos);
+            }
 
-            setTrackingMode(context.mode);
-            setReferenceMode(context.useReferences);
-            setTrajTime(context.trajTime);
-            setInTargetTol(context.tol);
-            ctrl->set_gamma(context.straightness);
-            setPosePriority(context.posePriority);
-            setTask2ndOptions(context.task_2);
-            setSolverConvergenceOptions(context.solverConvergence);
+            if (!cur || !(cur->restWeights==context->restWeights))
+            {
+                Vector curRestWeights;
+                ok&=setRestWeights(context->restWeights,curRestWeights);
+            }
+
+            if (!cur || !(cur->tip_x==context->tip_x) || !(cur->tip_o==context->tip_o))
+                ok&=attachTipFrame(context->tip_x,context->tip_o);
+
+            for (unsigned int axis=0; axis<chainState->getN(); axis++)
+                if (!cur || (cur->limits(axis,0)!=context->limits(axis,0)) ||
+                    (cur->limits(axis,1)!=context->limits(axis,1)))
+                    ok&=setLimits(axis,context->limits(axis,0),context->limits(axis,1));
+
+            // the controller part is cheap to check against the live values
+            if (trackingMode!=context->mode)
+                ok&=setTrackingMode(context->mode);
+            if (useReferences!=context->useReferences)
+                ok&=setReferenceMode(context->useReferences);
+            if (trajTime!=context->trajTime)
+                ok&=setTrajTime(context->trajTime);
+            if (targetTol!=context->tol)
+                ok&=setInTargetTol(context->tol);
+            if (ctrl->get_gamma()!=context->straightness)
+                ctrl->set_gamma(context->straightness);
+
+            if (!cur || (cur->posePriority!=context->posePriority))
+                ok&=setPosePriority(context->posePriority);
+            if (!cur || (cur->task_2.toString()!=context->task_2.toString()))
+                ok&=setTask2ndOptions(context->task_2);
+            if (!cur || (cur->solverConvergence.toString()!=context->solverConvergence.toString()))
+                ok&=setSolverConvergenceOptions(context->solverConvergence);
+
+            lock_guard<mutex> lck(mtx);
+            if (ok)
+            {
+                activeContext=context;
+                activeVersion=configVersion;
+            }
+            else
+                activeContext.reset();
 
             return true;
         }
@@ -3445,7 +3967,7 @@ bool ServerCartesianController::restoreContext(const int id)
 /************************************************************************/
 bool ServerCartesianController::deleteContext(const int id)
 {
-    map<int,Context>::iterator itr=contextMap.find(id);
+    map<int,shared_ptr<const Context>>::iterator itr=contextMap.find(id);
     if (itr!=contextMap.end())
     {
         contextMap.erase(itr);
@@ -3466,7 +3988,7 @@ bool ServerCartesianController::deleteContexts(Bottle *contextIdList)
         for (int i=0; i<contextIdList->size(); i++)
         {
             int id=contextIdList->get(i).asInt32();
-            map<int,Context>::iterator itr=contextMap.find(id);
+            map<int,shared_ptr<const Context>>::iterator itr=contextMap.find(id);
             if (itr!=contextMap.end())
                 contextMap.erase(itr);
         }
@@ -3715,7 +4237,7 @@ bool ServerCartesianController::getTask2ndOptions(Value &v)
         command.addVocab32(IKINSLV_VOCAB_OPT_TASK2);
 
         // send command to solver and wait for reply
-        if (portSlvRpc.write(command,reply))
+        if (writeToSolver(command,reply))
         {
             if (ret=(reply.get(0).asVocab32()==IKINSLV_VOCAB_REP_ACK))
                 v=reply.get(1);
@@ -3742,7 +4264,7 @@ bool ServerCartesianController::setTask2ndOptions(const Value &v)
         command.add(v);
 
         // send command to solver and wait for reply
-        if (portSlvRpc.write(command,reply))
+        if (writeToSolver(command,reply))
             ret=(reply.get(0).asVocab32()==IKINSLV_VOCAB_REP_ACK);
         else
             yError("%s: unable to get reply from solver!",ctrlName.c_str());
@@ -3763,7 +4285,7 @@ bool ServerCartesianController::getSolverConvergenceOptions(Bottle &options)
         command.addVocab32(IKINSLV_VOCAB_OPT_CONVERGENCE);
 
         // send command to solver and wait for reply
-        if (portSlvRpc.write(command,reply))
+        if (writeToSolver(command,reply))
         {
             if (ret=(reply.get(0).asVocab32()==IKINSLV_VOCAB_REP_ACK))
                 options=*reply.get(1).asList();
@@ -3790,7 +4312,7 @@ bool ServerCartesianController::setSolverConvergenceOptions(const Bottle &option
         command.addList()=options;
 
         // send command to solver and wait for reply
-        if (portSlvRpc.write(command,reply))
+        if (writeToSolver(command,reply))
             ret=(reply.get(0).asVocab32()==IKINSLV_VOCAB_REP_ACK);
         else
             yError("%s: unable to get reply from solver!",ctrlName.c_str());        
@@ -20,6 +20,8 @@
 #define __SERVERCARTESIANCONTROLLER_H__
 
 #include <mutex>
+#include <atomic>
+#include <memory>
 #include <condition_variable>
 #include <string>
 #include <vector>
@@ -32,6 +34,7 @@
 #include <yarp/sig/all.h>
 
 #include <iCub/ctrl/pids.h>
+#include <iCub/ctrl/telemetry.h>
 #include <iCub/iKin/iKinHlp.h>
 #include <iCub/iKin/iKinFwd.h>
 #include <iCub/iKin/iKinInv.h>
@@ -40,6 +43,9 @@
 
 
 class ServerCartesianController;
+class CartesianCtrlSolverReceiver;
+
+namespace iCub { namespace iKin { class CartesianSolver; } }
 
 
 struct DriverDescriptor
@@ -105,6 +111,7 @@ class ServerCartesianController : public    yarp::dev::DeviceDriver,
                                   public    yarp::dev::IMultipleWrapper,
                                   public    yarp::dev::ICartesianControl,
                                   public    yarp::os::PeriodicThread,
+                                  public    iCub::iKin::ICartesianBatchQuery,
                                   protected iCub::iKin::CartesianHelper
 {
 protected:
@@ -126,6 +133,8 @@ protected:
     bool useReferences;
     bool jointsHealthy;
     bool debugInfoEnabled;
+    bool localSolverEnabled;
+    bool eventDrivenEnabled;
 
     std::string ctrlName;
     std::string slvName;
@@ -177,6 +186,19 @@ protected:
     yarp::os::Stamp eventInfo;
     yarp::os::Stamp debugInfo;
 
+    iCub::ctrl::CycleTelemetry telemetry;
+    int    tmSectionFk;
+    int    tmSectionCtrl;
+    int    tmSectionIO;
+    double telemetryTxTime;
+
+    double ctrlPeriod;
+    double eventTimeout;
+    double lastFbStamp;
+    double lastCycleTime;
+    std::atomic<unsigned long> eventFreshCnt;
+    std::atomic<unsigned long> eventTimeoutCnt;
+
     yarp::sig::Vector xdes;
     yarp::sig::Vector qdes;
     yarp::sig::Vector xdot_set;
@@ -188,9 +210,16 @@ protected:
     yarp::os::BufferedPort<yarp::os::Bottle>   portSlvOut;
     yarp::os::RpcClient                        portSlvRpc;
 
+    iCub::iKin::CartesianSolver               *localSolver;
+    CartesianCtrlSolverReceiver               *localSolverReceiver;
+    yarp::os::Property                         localSolverOptions;
+    yarp::os::Bottle                           localSolverRequest;
+
     yarp::os::BufferedPort<yarp::sig::Vector>  portState;
+    yarp::os::BufferedPort<yarp::sig::Vector>  portStateFull;
     yarp::os::BufferedPort<yarp::os::Bottle>   portEvent;
     yarp::os::BufferedPort<yarp::os::Bottle>   portDebugInfo;
+    yarp::os::BufferedPort<yarp::os::Bottle>   portTelemetry;
     yarp::os::RpcServer                        portRpc;
 
     CartesianCtrlCommandPort                  *portCmd;
@@ -214,8 +243,14 @@ protected:
         yarp::os::Bottle  solverConvergence;
     };
 
+    // contexts are immutable and shared among the ids storing the
+    // same configuration; activeContext describes the current one as
+    // long as no set command has reached the solver afterwards
     int contextIdCnt;
-    std::map<int,Context> contextMap;
+    std::map<int,std::shared_ptr<const Context>> contextMap;
+    std::shared_ptr<const Context> activeContext;
+    std::atomic<unsigned long> configVersion;
+    unsigned long activeVersion;
     std::map<std::string,yarp::dev::CartesianEvent*> eventsMap;
 
     std::multiset<double> motionOngoingEvents;
@@ -231,8 +266,14 @@ protected:
     void   openPorts();
     void   closePorts();
     bool   respond(const yarp::os::Bottle &command, yarp::os::Bottle &reply);    
+    bool   openLocalSolver();
+    void   closeLocalSolver();
+    bool   writeToSolver(const yarp::os::Bottle &command, yarp::os::Bottle &reply);
     bool   alignJointsBounds();
     double getFeedback(yarp::sig::Vector &_fb);
+    double getFeedbackStamp();
+    bool   isCycleTriggered();
+    void   getTelemetryHelper(yarp::os::Bottle &info);
     void   createController();
     bool   getNewTarget();
     bool   areJointsHealthyAndSet(std::vector<int> &jointsToSet);
@@ -261,6 +302,9 @@ protected:
     bool setInTargetTolHelper(const double tol);
     bool isInTargetHelper();
 
+    void getDesiredHelper(yarp::sig::Vector &xdhat, yarp::sig::Vector &odhat, yarp::sig::Vector &qdhat);
+    void getTaskVelocitiesHelper(yarp::sig::Vector &xdot, yarp::sig::Vector &odot);
+
     bool getTask2ndOptions(yarp::os::Value &v);
     bool setTask2ndOptions(const yarp::os::Value &v);
     bool getSolverConvergenceOptions(yarp::os::Bottle &options);
@@ -300,6 +344,12 @@ public:
                         yarp::sig::Vector &qdhat);
     bool askForPosition(const yarp::sig::Vector &q0, const yarp::sig::Vector &xd, yarp::sig::Vector &xdhat,
                         yarp::sig::Vector &odhat, yarp::sig::Vector &qdhat);
+    bool askForPoses(const yarp::sig::Vector &q0, const std::deque<yarp::sig::Vector> &xd,
+                     const std::deque<yarp::sig::Vector> &od, std::deque<yarp::sig::Vector> &xdhat,
+                     std::deque<yarp::sig::Vector> &odhat, std::deque<yarp::sig::Vector> &qdhat);
+    bool askForPositions(const yarp::sig::Vector &q0, const std::deque<yarp::sig::Vector> &xd,
+                         std::deque<yarp::sig::Vector> &xdhat, std::deque<yarp::sig::Vector> &odhat,
+                         std::deque<yarp::sig::Vector> &qdhat);
     bool getDOF(yarp::sig::Vector &curDof);
     bool setDOF(const yarp::sig::Vector &newDof, yarp::sig::Vector &curDof);
     bool getRestPos(yarp::sig::Vector &curRestPos);
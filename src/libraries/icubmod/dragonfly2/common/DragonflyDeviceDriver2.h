@@ -79,6 +79,14 @@ PGRFlyCapture (Windows)
 
 --feature          // camera feature setting, normalized between 0.0 and 1.0 (features listed below)
 
+--use_network_time // 0: stamp the frames with the cycle timer embedded by the camera, shared by the cameras on the same bus (Linux only)
+
+--debayer_threads  // number of threads the software Bayer decoding is split on, 1 by default (Linux only)
+
+--external_trigger // GPIO pin (0-3) of the external trigger: each frame is exposed on a trigger edge, so that cameras wired to the same line take their frames together (Linux only)
+
+--trigger_polarity // 1: the external trigger is active high, 0 (default): active low (Linux only)
+
 
 \subsection video_type The video_type parameter
 
@@ -15,8 +15,10 @@
 
 #include <stdlib.h>
 #include <string>
+#include <algorithm>
 #include "linux/FirewireCameraDC1394-DR2_2.h"
 #include <arpa/inet.h>
+#include <yarp/os/SystemClock.h>
 #include <yarp/os/Log.h>
 #include <yarp/os/LogStream.h>
 
@@ -61,7 +63,14 @@ CFWCamera_DR2_2::CFWCamera_DR2_2(bool raw): mRawDriver(raw),
     m_pCameraList(NULL),
     m_dc1394_handle(NULL),
     m_LastSecond(0),
-    m_SecondOffset(0)
+    m_SecondOffset(0),
+    m_bExternalTrigger(false),
+    m_nDebayerThreads(1),
+    m_DebayerJob(0),
+    m_DebayerPending(0),
+    m_bDebayerQuit(false),
+    m_pDebayerFrame(NULL),
+    m_pDebayerBuffer(NULL)
 {
     configFx = false;
     configFy = false;
@@ -298,6 +307,8 @@ bool CFWCamera_DR2_2::Create(yarp::os::Searchable& config)
         mUseHardwareTimestamp = !checkInt(config,"use_network_time");
     }
 
+    int nDebayerThreads=config.check("debayer_threads",yarp::os::Value(1)).asInt32();
+
     unsigned int idCamera=0;
 
     m_Framerate=checkInt(config,"framerate");
@@ -597,6 +608,15 @@ bool CFWCamera_DR2_2::Create(yarp::os::Searchable& config)
         return false;
     }
 
+    if (!SetupTrigger(config))
+    {
+        yError("can't setup the external trigger\n");
+        dc1394_capture_stop(m_pCamera);
+        dc1394_camera_free(m_pCamera);
+        m_pCamera=NULL;
+        return false;
+    }
+
     error=dc1394_video_set_transmission(m_pCamera,DC1394_ON);
     if (error!=DC1394_SUCCESS)
     {
@@ -637,11 +657,200 @@ bool CFWCamera_DR2_2::Create(yarp::os::Searchable& config)
         set_embedded_timestamp(m_pCamera,true);
     }
 
+    StartDebayerWorkers(nDebayerThreads);
+
     return true;
 }
 
+bool CFWCamera_DR2_2::SetupTrigger(yarp::os::Searchable& config)
+{
+    m_bExternalTrigger=config.check("external_trigger");
+
+    if (!m_bExternalTrigger)
+    {
+        // the trigger setting survives in the camera, make sure it is free running
+        dc1394bool_t bPresent=DC1394_FALSE;
+        dc1394_feature_is_present(m_pCamera,DC1394_FEATURE_TRIGGER,&bPresent);
+        if (bPresent) dc1394_external_trigger_set_power(m_pCamera,DC1394_OFF);
+        return true;
+    }
+
+    // mode 0: the exposure starts on the trigger edge and lasts the shutter time,
+    // hence cameras wired to the same trigger line take their frames together
+    int source=config.find("external_trigger").asInt32();
+    if (source<0 || source>DC1394_TRIGGER_SOURCE_3-DC1394_TRIGGER_SOURCE_0)
+    {
+        yError("external_trigger source %d out of range\n",source);
+        return false;
+    }
+
+    dc1394trigger_polarity_t polarity=checkInt(config,"trigger_polarity")?
+        DC1394_TRIGGER_ACTIVE_HIGH:DC1394_TRIGGER_ACTIVE_LOW;
+
+    dc1394error_t error;
+    error=dc1394_external_trigger_set_mode(m_pCamera,DC1394_TRIGGER_MODE_0);
+    if (manage(error)) { yError("LINE: %d\n",__LINE__); return false; }
+    error=dc1394_external_trigger_set_source(m_pCamera,(dc1394trigger_source_t)(DC1394_TRIGGER_SOURCE_0+source));
+    if (manage(error)) { yError("LINE: %d\n",__LINE__); return false; }
+    error=dc1394_external_trigger_set_polarity(m_pCamera,polarity);
+    if (manage(error)) { yError("LINE: %d\n",__LINE__); return false; }
+    error=dc1394_external_trigger_set_power(m_pCamera,DC1394_ON);
+    if (manage(error)) { yError("LINE: %d\n",__LINE__); return false; }
+
+    yInfo("external trigger on source %d, active %s\n",source,polarity==DC1394_TRIGGER_ACTIVE_HIGH?"high":"low");
+
+    return true;
+}
+
+void CFWCamera_DR2_2::StartDebayerWorkers(int nThreads)
+{
+    StopDebayerWorkers();
+
+    m_nDebayerThreads=std::max(1,std::min(nThreads,DEBAYER_MAX_THREADS));
+    m_DebayerStripes.resize(m_nDebayerThreads);
+    m_bDebayerQuit=false;
+
+    for (int i=1; i<m_nDebayerThreads; ++i)
+    {
+        m_DebayerWorkers.push_back(std::thread(&CFWCamera_DR2_2::DebayerWorker,this,i));
+    }
+}
+
+void CFWCamera_DR2_2::StopDebayerWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lck(m_DebayerMutex);
+        m_bDebayerQuit=true;
+        m_DebayerStart.notify_all();
+    }
+
+    for (size_t i=0; i<m_DebayerWorkers.size(); ++i)
+    {
+        m_DebayerWorkers[i].join();
+    }
+
+    m_DebayerWorkers.clear();
+}
+
+void CFWCamera_DR2_2::DebayerWorker(int stripe)
+{
+    std::unique_lock<std::mutex> lck(m_DebayerMutex);
+    unsigned int job=m_DebayerJob;
+
+    while (true)
+    {
+        m_DebayerStart.wait(lck,[&]{ return m_bDebayerQuit || m_DebayerJob!=job; });
+
+        // a pending stripe is decoded anyway, the caller is waiting for it
+        if (m_DebayerJob==job) return;
+
+        job=m_DebayerJob;
+        lck.unlock();
+        DebayerStripe(stripe);
+        lck.lock();
+
+        if (--m_DebayerPending==0) m_DebayerDone.notify_one();
+    }
+}
+
+void CFWCamera_DR2_2::DebayerStripe(int stripe)
+{
+    const dc1394video_frame_t *pFrame=m_pDebayerFrame;
+    int w=pFrame->size[0];
+    int h=pFrame->size[1];
+
+    // an even number of rows per stripe keeps the same Bayer tile
+    int rows=((h/m_nDebayerThreads)+1)&~1;
+    int y0=stripe*rows;
+    int y1=std::min(h,y0+rows);
+    if (y0>=y1) return;
+
+    // the rows shared with the neighbours are decoded twice, so that
+    // the border handling of the decoder does not show at the seams
+    int top=std::max(0,y0-DEBAYER_HALO_ROWS);
+    int bottom=std::min(h,y1+DEBAYER_HALO_ROWS);
+
+    std::vector<unsigned char> &tmp=m_DebayerStripes[stripe];
+    tmp.resize(3*w*(bottom-top));
+
+    dc1394_bayer_decoding_8bit(pFrame->image+w*top,tmp.data(),w,bottom-top,
+                               pFrame->color_filter,DC1394_BAYER_METHOD_BILINEAR);
+
+    memcpy(m_pDebayerBuffer+3*w*y0,tmp.data()+3*w*(y0-top),3*w*(y1-y0));
+}
+
+void CFWCamera_DR2_2::Debayer(const dc1394video_frame_t *pFrame,unsigned char *pBuffer)
+{
+    std::unique_lock<std::mutex> lck(m_DebayerMutex);
+
+    if (m_nDebayerThreads<=1 || m_bDebayerQuit)
+    {
+        lck.unlock();
+        dc1394_bayer_decoding_8bit(pFrame->image,pBuffer,pFrame->size[0],pFrame->size[1],
+                                   pFrame->color_filter,DC1394_BAYER_METHOD_BILINEAR);
+        return;
+    }
+
+    m_pDebayerFrame=pFrame;
+    m_pDebayerBuffer=pBuffer;
+    m_DebayerPending=m_nDebayerThreads-1;
+    ++m_DebayerJob;
+    m_DebayerStart.notify_all();
+    lck.unlock();
+
+    DebayerStripe(0);
+
+    lck.lock();
+    m_DebayerDone.wait(lck,[this]{ return m_DebayerPending==0; });
+}
+
+void CFWCamera_DR2_2::UpdateStamp(dc1394video_frame_t *pFrame)
+{
+    if (mUseHardwareTimestamp) {
+        uint32_t v = ntohl(*((uint32_t*)pFrame->image));
+        int nSecond = (v >> 25) & 0x7f;
+        int nCycleCount  = (v >> 12) & 0x1fff;
+        int nCycleOffset = (v >> 0) & 0xfff;
+
+        if (m_LastSecond>nSecond) {
+            // we got a wrap-around event, losing 128 seconds
+            m_SecondOffset += 128;
+        }
+        m_LastSecond = nSecond;
+
+        m_Stamp.update(m_SecondOffset+(double)nSecond + (((double)nCycleCount+((double)nCycleOffset/3072.0))/8000.0));
+    } else {
+        // the kernel stamps the frame as its last packet arrives, so the
+        // time spent until the frame is dequeued is taken out
+        double age=yarp::os::SystemClock::nowSystem()-1e-6*(double)pFrame->timestamp;
+        if (age>=0.0 && age<1.0) {
+            m_Stamp.update(yarp::os::Time::now()-age);
+        } else {
+            m_Stamp.update();
+        }
+    }
+}
+
+dc1394video_frame_t* CFWCamera_DR2_2::ReleaseFrame(dc1394video_frame_t *pFrame)
+{
+    // a fast copy gives the DMA buffer back to the ring straight away,
+    // so that the conversion does not hold it while the bus goes on
+    if (m_RawImage.size()<pFrame->image_bytes) m_RawImage.resize(pFrame->image_bytes);
+
+    m_RawFrame=*pFrame;
+    m_RawFrame.image=m_RawImage.data();
+    m_RawFrame.allocated_image_bytes=m_RawImage.size();
+    memcpy(m_RawFrame.image,pFrame->image,pFrame->image_bytes);
+
+    dc1394_capture_enqueue(m_pCamera,pFrame);
+
+    return &m_RawFrame;
+}
+
 void CFWCamera_DR2_2::Close()
 {
+    StopDebayerWorkers();
+
     if (m_pCamera)
     {
         dc1394_video_set_transmission(m_pCamera,DC1394_OFF);
@@ -1168,23 +1377,7 @@ bool CFWCamera_DR2_2::Capture(yarp::sig::ImageOf<yarp::sig::PixelRgb>* pImage,un
         return false;
     }
 
-    if (mUseHardwareTimestamp) {
-        uint32_t v = ntohl(*((uint32_t*)m_pFrame->image));
-        int nSecond = (v >> 25) & 0x7f;
-        int nCycleCount  = (v >> 12) & 0x1fff;
-        int nCycleOffset = (v >> 0) & 0xfff;
-
-        if (m_LastSecond>nSecond) {
-            // we got a wrap-around event, losing 128 seconds
-            m_SecondOffset += 128;
-        }
-        m_LastSecond = nSecond;
-
-        m_Stamp.update(m_SecondOffset+(double)nSecond + (((double)nCycleCount+((double)nCycleOffset/3072.0))/8000.0));
-        //m_Stamp.update(m_pFrame->timestamp/1000000.0);
-    } else {
-        m_Stamp.update();
-    }
+    UpdateStamp(m_pFrame);
 
     if (pImage)
     {
@@ -1195,49 +1388,52 @@ bool CFWCamera_DR2_2::Capture(yarp::sig::ImageOf<yarp::sig::PixelRgb>* pImage,un
     if (m_pFrame->color_coding==DC1394_COLOR_CODING_RGB8 || bRaw)
     {
         memcpy(pBuffer,m_pFrame->image,m_pFrame->size[0]*m_pFrame->size[1]*(bRaw?1:3));
+        dc1394_capture_enqueue(m_pCamera,m_pFrame);
+        return true;
     }
-    else if (m_pFrame->color_coding==DC1394_COLOR_CODING_RAW8)
+
+    dc1394video_frame_t *pFrame=ReleaseFrame(m_pFrame);
+
+    if (pFrame->color_coding==DC1394_COLOR_CODING_RAW8)
     {
-        dc1394_debayer_frames(m_pFrame,&m_ConvFrame,DC1394_BAYER_METHOD_BILINEAR);
-        memcpy(pBuffer,m_ConvFrame.image,m_ConvFrame.size[0]*m_ConvFrame.size[1]*3);
+        Debayer(pFrame,pBuffer);
     }
-    else if (m_pFrame->color_coding==DC1394_COLOR_CODING_RAW16)
+    else if (pFrame->color_coding==DC1394_COLOR_CODING_RAW16)
     {
-        dc1394_debayer_frames(m_pFrame,&m_ConvFrame,DC1394_BAYER_METHOD_BILINEAR);
-        m_ConvFrame_tmp.size[0]=m_pFrame->size[0];
-        m_ConvFrame_tmp.size[1]=m_pFrame->size[1];
+        dc1394_debayer_frames(pFrame,&m_ConvFrame,DC1394_BAYER_METHOD_BILINEAR);
+        m_ConvFrame_tmp.size[0]=pFrame->size[0];
+        m_ConvFrame_tmp.size[1]=pFrame->size[1];
         m_ConvFrame_tmp.position[0]=0;
         m_ConvFrame_tmp.position[1]=0;
         m_ConvFrame_tmp.color_coding=DC1394_COLOR_CODING_RGB8;
         m_ConvFrame_tmp.data_depth=24;
-        m_ConvFrame_tmp.image_bytes=m_ConvFrame_tmp.total_bytes=3*m_pFrame->size[0]*m_pFrame->size[1];
+        m_ConvFrame_tmp.image_bytes=m_ConvFrame_tmp.total_bytes=3*pFrame->size[0]*pFrame->size[1];
         m_ConvFrame_tmp.padding_bytes=0;
-        m_ConvFrame_tmp.stride=3*m_pFrame->size[0];
+        m_ConvFrame_tmp.stride=3*pFrame->size[0];
         m_ConvFrame_tmp.data_in_padding=DC1394_FALSE;
-        m_ConvFrame_tmp.little_endian=m_pFrame->little_endian;
+        m_ConvFrame_tmp.little_endian=pFrame->little_endian;
         dc1394_convert_frames(&m_ConvFrame,&m_ConvFrame_tmp);
         memcpy(pBuffer,m_ConvFrame_tmp.image,m_ConvFrame_tmp.size[0]*m_ConvFrame_tmp.size[1]*3);
     }
     else
     {
-        m_ConvFrame.size[0]=m_pFrame->size[0];
-        m_ConvFrame.size[1]=m_pFrame->size[1];
+        m_ConvFrame.size[0]=pFrame->size[0];
+        m_ConvFrame.size[1]=pFrame->size[1];
         m_ConvFrame.position[0]=0;
         m_ConvFrame.position[1]=0;
         m_ConvFrame.color_coding=DC1394_COLOR_CODING_RGB8;
         m_ConvFrame.data_depth=24;
-        m_ConvFrame.image_bytes=m_ConvFrame.total_bytes=3*m_pFrame->size[0]*m_pFrame->size[1];
+        m_ConvFrame.image_bytes=m_ConvFrame.total_bytes=3*pFrame->size[0]*pFrame->size[1];
         m_ConvFrame.padding_bytes=0;
-        m_ConvFrame.stride=3*m_pFrame->size[0];
+        m_ConvFrame.stride=3*pFrame->size[0];
         m_ConvFrame.data_in_padding=DC1394_FALSE;
-        m_ConvFrame.little_endian=m_pFrame->little_endian;
+        m_ConvFrame.little_endian=pFrame->little_endian;
 
-        dc1394_convert_frames(m_pFrame,&m_ConvFrame);
+        dc1394_convert_frames(pFrame,&m_ConvFrame);
 
         memcpy(pBuffer,m_ConvFrame.image,m_ConvFrame.size[0]*m_ConvFrame.size[1]*3);
     }
 
-    dc1394_capture_enqueue(m_pCamera,m_pFrame);
     return true;
 }
 
@@ -1265,23 +1461,7 @@ bool CFWCamera_DR2_2::Capture(yarp::sig::ImageOf<yarp::sig::PixelMono>* pImage)
         return false;
     }
 
-    if (mUseHardwareTimestamp) {
-        uint32_t v = ntohl(*((uint32_t*)m_pFrame->image));
-        int nSecond = (v >> 25) & 0x7f;
-        int nCycleCount  = (v >> 12) & 0x1fff;
-        int nCycleOffset = (v >> 0) & 0xfff;
-
-        if (m_LastSecond>nSecond) {
-            // we got a wrap-around event, losing 128 seconds
-            m_SecondOffset += 128;
-        }
-        m_LastSecond = nSecond;
-
-        m_Stamp.update(m_SecondOffset+(double)nSecond + (((double)nCycleCount+((double)nCycleOffset/3072.0))/8000.0));
-        //m_Stamp.update(m_pFrame->timestamp/1000000.0);
-    } else {
-        m_Stamp.update();
-    }
+    UpdateStamp(m_pFrame);
 
     if (pImage)
     {
@@ -20,7 +20,10 @@
 
 #include <stdio.h>
 #include <memory.h>
+#include <vector>
 #include <mutex>
+#include <thread>
+#include <condition_variable>
 #include <dc1394/dc1394.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/Stamp.h>
@@ -32,6 +35,11 @@
 
 #define NUM_DMA_BUFFERS 4
 
+// the Bayer decoding is split in horizontal stripes,
+// each one overlapping its neighbours by a few rows
+#define DEBAYER_MAX_THREADS 8
+#define DEBAYER_HALO_ROWS   2
+
 // formats
 
 #define DR_UNINIT                0
@@ -85,6 +93,16 @@ public:
     bool Capture(yarp::sig::ImageOf<yarp::sig::PixelMono>* pImage);
 
 protected:
+    void UpdateStamp(dc1394video_frame_t *pFrame);
+    dc1394video_frame_t* ReleaseFrame(dc1394video_frame_t *pFrame);
+    bool SetupTrigger(yarp::os::Searchable& config);
+
+    void Debayer(const dc1394video_frame_t *pFrame,unsigned char *pBuffer);
+    void DebayerStripe(int stripe);
+    void DebayerWorker(int stripe);
+    void StartDebayerWorkers(int nThreads);
+    void StopDebayerWorkers();
+
     bool mRawDriver;
 
     dc1394_t *m_dc1394_handle;
@@ -110,7 +128,23 @@ protected:
     uint32_t m_iMin[DC1394_FEATURE_NUM],m_iMax[DC1394_FEATURE_NUM];
 
     dc1394video_frame_t *m_pFrame,*m_pFramePoll;
+    dc1394video_frame_t m_RawFrame;
+    std::vector<unsigned char> m_RawImage;
+    bool m_bExternalTrigger;
     std::mutex m_AcqMutex;
+
+    // the calling thread decodes the first stripe, the workers the others
+    int m_nDebayerThreads;
+    std::vector<std::thread> m_DebayerWorkers;
+    std::vector<std::vector<unsigned char> > m_DebayerStripes;
+    std::mutex m_DebayerMutex;
+    std::condition_variable m_DebayerStart,m_DebayerDone;
+    unsigned int m_DebayerJob;
+    int m_DebayerPending;
+    bool m_bDebayerQuit;
+    const dc1394video_frame_t *m_pDebayerFrame;
+    unsigned char *m_pDebayerBuffer;
+
     yarp::os::Stamp m_Stamp;
     int m_LastSecond;
     double m_SecondOffset;
@@ -37,6 +37,7 @@
 
 #include <yarp/os/NetType.h>
 #include <yarp/conf/environment.h>
+#include <iCub/StartupTrace.h>
 
 #ifdef WIN32
 #pragma warning(once:4355)
@@ -278,6 +279,8 @@ bool embObjAnalogSensor::initialised()
 
 bool embObjAnalogSensor::open(yarp::os::Searchable &config)
 {
+    iCub::dev::TraceSpan span("open", "embObjAnalogSensor::open");
+
     // - first thing to do is verify if the eth manager is available. then i parse info about the eth board.
 
     ethManager = eth::TheEthManager::instance();
@@ -22,6 +22,7 @@
 #include "EoProtocol.h"
 #include "EoProtocolAS.h"
 #include "EoProtocolMN.h"
+#include <iCub/StartupTrace.h>
 
 #ifdef WIN32
 #pragma warning(once : 4355)
@@ -63,6 +64,8 @@ bool embObjBattery::initialised()
 
 bool embObjBattery::open(yarp::os::Searchable &config)
 {
+    iCub::dev::TraceSpan span("open", "embObjBattery::open");
+
     yInfo() << "embObjBattery::open(): preparing ETH resource";
     if (!device_->prerareEthService(config, this))
         return false;
@@ -135,6 +138,17 @@ bool embObjBattery::open(yarp::os::Searchable &config)
         return false;
     }
 
+    if (config.check("publish_port"))
+    {
+        // the readings are written only when they change, instead of being polled one getter at a time
+        std::string name = config.find("publish_port").asString();
+        double heartbeat = config.check("publish_heartbeat", yarp::os::Value(5.0)).asFloat64();
+        if (!publisher_.open(name, heartbeat))
+        {
+            yWarning() << device_->getBoardInfo() << " open() cannot open the port" << name << ": the readings will not be published";
+        }
+    }
+
     device_->setOpen(true);
     return true;
 }
@@ -251,15 +265,33 @@ bool embObjBattery::update(eOprotID32_t id32, double timestamp, void *rxdata)
         return false;
     }
 
-    std::unique_lock<std::shared_mutex> lck(mutex_);
-    canBatteryData_.decode(data, calculateBoardTime(data->age));
+    iCub::dev::BatterySnapshot snapshot;
+    {
+        std::unique_lock<std::shared_mutex> lck(mutex_);
+        CanBatteryData previous = canBatteryData_;
+        canBatteryData_.decode(data, calculateBoardTime(data->age));
+        previous.timeStamp_ = canBatteryData_.timeStamp_;
+        if (previous != canBatteryData_)
+        {
+            sequence_++;
+        }
+        if (!publisher_.isOpen())
+        {
+            return true;
+        }
+        fillSnapshot(snapshot);
+    }
 
+    // outside the lock, the getters are not held by the port
+    publisher_.publish(snapshot);
     return true;
 }
 
 bool embObjBattery::close()
 {
     cleanup();
+    // after cleanup(), which stops the calls of update()
+    publisher_.close();
     return true;
 }
 
@@ -307,30 +339,35 @@ double embObjBattery::calculateBoardTime(eOabstime_t current)
 
 bool embObjBattery::getBatteryVoltage(double &voltage)
 {
+    std::shared_lock<std::shared_mutex> lck(mutex_);
     voltage = canBatteryData_.voltage_;
     return true;
 }
 
 bool embObjBattery::getBatteryCurrent(double &current)
 {
+    std::shared_lock<std::shared_mutex> lck(mutex_);
     current = canBatteryData_.current_;
     return true;
 }
 
 bool embObjBattery::getBatteryCharge(double &charge)
 {
+    std::shared_lock<std::shared_mutex> lck(mutex_);
     charge = canBatteryData_.charge_;
     return true;
 }
 
 bool embObjBattery::getBatteryStatus(Battery_status &status)
 {
+    std::shared_lock<std::shared_mutex> lck(mutex_);
     status = static_cast<Battery_status>(canBatteryData_.status_);
     return true;
 }
 
 bool embObjBattery::getBatteryTemperature(double &temperature)
 {
+    std::shared_lock<std::shared_mutex> lck(mutex_);
     temperature = canBatteryData_.temperature_;
     return true;
 }
@@ -338,13 +375,33 @@ bool embObjBattery::getBatteryTemperature(double &temperature)
 bool embObjBattery::getBatteryInfo(std::string &battery_info)
 {
     std::stringstream ss;
+    std::shared_lock<std::shared_mutex> lck(mutex_);
     ss << "{\"temperature\":" << canBatteryData_.temperature_ << ",\"voltage\":" << canBatteryData_.voltage_ << ",\"charge\":" << canBatteryData_.charge_ << ",\"status\":" << canBatteryData_.status_
        << ",\"ts\":" << canBatteryData_.timeStamp_ << "}" << std::endl;
+    lck.unlock();
 
     battery_info = ss.str();
     return true;
 }
 
+bool embObjBattery::getBatterySnapshot(iCub::dev::BatterySnapshot &snapshot)
+{
+    std::shared_lock<std::shared_mutex> lck(mutex_);
+    fillSnapshot(snapshot);
+    return true;
+}
+
+void embObjBattery::fillSnapshot(iCub::dev::BatterySnapshot &snapshot) const
+{
+    snapshot.voltage = canBatteryData_.voltage_;
+    snapshot.current = canBatteryData_.current_;
+    snapshot.charge = canBatteryData_.charge_;
+    snapshot.temperature = canBatteryData_.temperature_;
+    snapshot.status = static_cast<Battery_status>(canBatteryData_.status_);
+    snapshot.stamp = canBatteryData_.timeStamp_;
+    snapshot.sequence = sequence_;
+}
+
 bool CanBatteryData::operator==(const CanBatteryData &other) const
 {
     if (temperature_ != other.temperature_)
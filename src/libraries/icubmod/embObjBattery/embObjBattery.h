@@ -22,6 +22,8 @@
 #include "embObjGeneralDevPrivData.h"
 #include "serviceParserCanBattery.h"
 
+#include <iCub/BatterySnapshot.h>
+
 namespace yarp::dev
 {
 class embObjBattery;
@@ -43,7 +45,7 @@ class CanBatteryData
     bool operator!=(const CanBatteryData &other) const;
 };
 
-class yarp::dev::embObjBattery : public yarp::dev::DeviceDriver, public eth::IethResource, public yarp::dev::IBattery
+class yarp::dev::embObjBattery : public yarp::dev::DeviceDriver, public eth::IethResource, public yarp::dev::IBattery, public iCub::dev::IBatterySnapshot
 {
    public:
     embObjBattery();
@@ -66,12 +68,17 @@ class yarp::dev::embObjBattery : public yarp::dev::DeviceDriver, public eth::Iet
     bool getBatteryTemperature(double &temperature) override;
     bool getBatteryInfo(std::string &battery_info) override;
 
+    // IBatterySnapshot
+    bool getBatterySnapshot(iCub::dev::BatterySnapshot &snapshot) override;
+
     virtual double calculateBoardTime(eOabstime_t current);
 
    protected:
     std::shared_ptr<yarp::dev::embObjDevPrivData> device_;
     mutable std::shared_mutex mutex_;
     CanBatteryData canBatteryData_;
+    uint32_t sequence_{0};  // incremented by update() when the values, but the time stamp, change
+    iCub::dev::BatteryPublisher publisher_;
     std::map<eOprotID32_t, eOabstime_t> timeoutUpdate_;
 
     bool sendConfig2boards(ServiceParserCanBattery &parser, eth::AbstractEthResource *deviceRes);
@@ -79,6 +86,7 @@ class yarp::dev::embObjBattery : public yarp::dev::DeviceDriver, public eth::Iet
     bool initRegulars(ServiceParserCanBattery &parser, eth::AbstractEthResource *deviceRes);
     void cleanup(void);
     bool checkUpdateTimeout(eOprotID32_t id32, eOabstime_t current);
+    void fillSnapshot(iCub::dev::BatterySnapshot &snapshot) const;  // with mutex_ held
     static constexpr eOabstime_t updateTimeout_{11000};
     std::vector<yarp::dev::MAS_status> masStatus_{MAS_OK, MAS_OK, MAS_OK, MAS_OK};
 
@@ -23,6 +23,7 @@
 #include "EoAnalogSensors.h"
 #include "EOconstarray.h"
 #include "EoProtocolAS.h"
+#include <iCub/StartupTrace.h>
 
 
 #ifdef WIN32
@@ -89,6 +90,8 @@ bool embObjFTsensor::enableTemperatureTransmission(bool enable)
 
 bool embObjFTsensor::open(yarp::os::Searchable &config)
 {
+    iCub::dev::TraceSpan span("open", "embObjFTsensor::open");
+
     // - first thing to do is verify if the eth manager is available then i parse info about the eth board.
 
     if(! GET_privData(mPriv).prerareEthService(config, this))
@@ -22,6 +22,7 @@
 
 #include "FeatureInterface.h"
 #include "eo_imu_privData.h"
+#include <iCub/StartupTrace.h>
 
 
 
@@ -68,6 +69,8 @@ void embObjIMU::cleanup(void)
 
 bool embObjIMU::open(yarp::os::Searchable &config)
 {
+    iCub::dev::TraceSpan span("open", "embObjIMU::open");
+
     // - first thing to do is verify if the eth manager is available then i parse info about the eth board.
 
     if(! GET_privData(mPriv).prerareEthService(config, this))
@@ -270,6 +273,21 @@ bool embObjIMU::getOrientationSensorMeasureAsRollPitchYaw(size_t sens_index, yar
 }
 
 
+bool embObjIMU::getLatestSensorSamples(std::vector<eth::SensorSample> &samples) const
+{
+    if(!GET_privData(mPriv).isOpen())
+        return false;
+    return GET_privData(mPriv).sens.getLatestSamples(samples);
+}
+
+bool embObjIMU::getNewSensorSamples(std::vector<eth::SensorSample> &samples, uint64_t &lost)
+{
+    if(!GET_privData(mPriv).isOpen())
+        return false;
+    return GET_privData(mPriv).sens.getNewSamples(samples, lost);
+}
+
+
 bool embObjIMU::initialised()
 {
     return GET_privData(mPriv).behFlags.opened;
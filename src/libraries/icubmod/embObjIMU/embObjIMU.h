@@ -16,6 +16,7 @@
 #include <yarp/dev/MultipleAnalogSensorsInterfaces.h>
 
 #include "IethResource.h"
+#include "sensorsBuffer.h"
 
 
 
@@ -46,7 +47,8 @@ class yarp::dev::embObjIMU :            public DeviceDriver,
                                         public yarp::dev::IThreeAxisLinearAccelerometers,
                                         public yarp::dev::IThreeAxisMagnetometers,
                                         public yarp::dev::IOrientationSensors,
-                                        public eth::IethResource
+                                        public eth::IethResource,
+                                        public eth::IbulkSensors
 {
 
 public:
@@ -86,6 +88,10 @@ public:
     virtual bool getOrientationSensorMeasureAsRollPitchYaw(size_t sens_index, yarp::sig::Vector& rpy, double& timestamp) const override;
 
 
+    /* IbulkSensors methods: the type of a sample is its eOas_sensor_t, the values are in metric units */
+    virtual bool getLatestSensorSamples(std::vector<eth::SensorSample> &samples) const override;
+    virtual bool getNewSensorSamples(std::vector<eth::SensorSample> &samples, uint64_t &lost) override;
+
     /* Iethresource methods */
     virtual bool initialised();
     virtual eth::iethresType_t type();
@@ -147,6 +147,15 @@ void SensorsData::init(servConfigImu_t &servCfg, string error_string)
             }
         }
     }
+
+    size_t numberofsensors = 0;
+    firstIndex.resize(eoas_sensors_numberof);
+    for(int t=0; t<eoas_sensors_numberof; t++)
+    {
+        firstIndex[t] = numberofsensors;
+        numberofsensors += mysens[t].size();
+    }
+    samples.reset(new eth::SensorsBuffer(numberofsensors, samplesHistory));
 }
 
 bool SensorsData::outOfRangeErrorHandler(const std::out_of_range& oor) const
@@ -206,37 +215,34 @@ bool SensorsData::getSensorFrameName(size_t sens_index, eOas_sensor_t type, std:
 }
 
 
-bool SensorsData::getSensorMeasure(size_t sens_index, eOas_sensor_t type, yarp::sig::Vector& out, double& timestamp) const
+double SensorsData::toMetric(eOas_sensor_t type, double raw) const
 {
-    try
-    {   std::lock_guard<std::mutex> lck (mutex);
-        out = mysens[type].at(sens_index).values;
-        switch(type)
-        {
-            case eoas_imu_acc:
-            {
-                for(int i=0; i<out.size(); i++)
-                    out[i] = measConverter.convertAcc_raw2metric(out[i]);
-            }break;
+    switch(type)
+    {
+        case eoas_imu_acc:
+            return measConverter.convertAcc_raw2metric(raw);
 
-            case  eoas_imu_mag:
-            {    for(int i=0; i<out.size(); i++)
-                out[i] = measConverter.convertMag_raw2metric(out[i]);
-            }break;
+        case  eoas_imu_mag:
+            return measConverter.convertMag_raw2metric(raw);
 
-            case eoas_imu_gyr:
-            {    for(int i=0; i<out.size(); i++)
-                out[i] = measConverter.convertGyr_raw2metric(out[i]);
-            }break;
+        case eoas_imu_gyr:
+            return measConverter.convertGyr_raw2metric(raw);
 
-            case eoas_imu_eul:
-            {
-                for(int i=0; i<out.size(); i++)
-                    out[i] = measConverter.convertEul_raw2metric(out[i]);
-            }
+        case eoas_imu_eul:
+            return measConverter.convertEul_raw2metric(raw);
 
-            default: break;
-        };
+        default:
+            return raw;
+    };
+}
+
+bool SensorsData::getSensorMeasure(size_t sens_index, eOas_sensor_t type, yarp::sig::Vector& out, double& timestamp) const
+{
+    try
+    {   std::lock_guard<std::mutex> lck (mutex);
+        out = mysens[type].at(sens_index).values;
+        for(int i=0; i<out.size(); i++)
+            out[i] = toMetric(type, out[i]);
         timestamp = mysens[type].at(sens_index).timestamp;
     }
     catch (const std::out_of_range& oor)
@@ -247,16 +253,53 @@ bool SensorsData::getSensorMeasure(size_t sens_index, eOas_sensor_t type, yarp::
 
 }
 
+bool SensorsData::getLatestSamples(std::vector<eth::SensorSample> &out) const
+{
+    if(nullptr == samples)
+    {
+        out.clear();
+        return false;
+    }
+    samples->latest(out);
+    return true;
+}
+
+bool SensorsData::getNewSamples(std::vector<eth::SensorSample> &out, uint64_t &lost)
+{
+    if(nullptr == samples)
+    {
+        out.clear();
+        lost = 0;
+        return false;
+    }
+    samples->history(out, lost);
+    return true;
+}
+
 bool SensorsData::update(eOas_sensor_t type, uint8_t index, eOas_inertial3_data_t *newdata)
 {
-    std::lock_guard<std::mutex> lck (mutex);
+    eth::SensorSample sample;
+    {
+        std::lock_guard<std::mutex> lck (mutex);
 
-    sensorInfo_t *info = &(mysens[type][index]);
+        sensorInfo_t *info = &(mysens[type][index]);
+
+        info->values[0] = newdata->x;
+        info->values[1] = newdata->y;
+        info->values[2] = newdata->z;
+        info->timestamp = yarp::os::Time::now();
+
+        sample.type = type;
+        sample.size = info->values.size();
+        sample.sensor = index;
+        for(size_t i=0; i<info->values.size(); i++)
+            sample.values[i] = toMetric(type, info->values[i]);
+        sample.timestamp = info->timestamp;
+    }
 
-    info->values[0] = newdata->x;
-    info->values[1] = newdata->y;
-    info->values[2] = newdata->z;
-    info->timestamp = yarp::os::Time::now();
+    // the bulk readers do not take the mutex: only this thread (the ethReceiver) writes
+    if(nullptr != samples)
+        samples->put(firstIndex[type] + index, sample);
 
     return true;
 
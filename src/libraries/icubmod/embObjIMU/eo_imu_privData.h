@@ -11,7 +11,9 @@
 
 #include "embObjGeneralDevPrivData.h"
 #include "imuMeasureConverter.h"
+#include "sensorsBuffer.h"
 #include <yarp/sig/Vector.h>
+#include <memory>
 #include <mutex>
 #include <yarp/dev/MultipleAnalogSensorsInterfaces.h>
 
@@ -58,6 +60,14 @@ private:
     mutable std::mutex mutex;
     string errorstring;
 
+    // the converted samples of all the sensors, for the bulk read. the sensors of a type
+    // start at firstIndex[type]
+    std::unique_ptr<eth::SensorsBuffer> samples;
+    std::vector<size_t> firstIndex;
+    static constexpr size_t samplesHistory = 4096;
+
+    double toMetric(eOas_sensor_t type, double raw) const;
+
 public:
     ImuMeasureConverter measConverter;
     SensorsData();
@@ -71,6 +81,8 @@ public:
     bool getSensorName(size_t sens_index, eOas_sensor_t type, std::string &name) const;
     bool getSensorFrameName(size_t sens_index, eOas_sensor_t type, std::string &frameName) const;
     bool getSensorMeasure(size_t sens_index, eOas_sensor_t type, yarp::sig::Vector& out, double& timestamp) const;
+    bool getLatestSamples(std::vector<eth::SensorSample> &out) const;
+    bool getNewSamples(std::vector<eth::SensorSample> &out, uint64_t &lost);
 };
 
 
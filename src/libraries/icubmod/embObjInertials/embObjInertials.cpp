@@ -37,6 +37,7 @@
 
 #include <yarp/os/NetType.h>
 #include <yarp/conf/environment.h>
+#include <iCub/StartupTrace.h>
 
 #ifdef WIN32
 #pragma warning(once:4355)
@@ -383,6 +384,8 @@ bool embObjInertials::initialised()
 
 bool embObjInertials::open(yarp::os::Searchable &config)
 {
+    iCub::dev::TraceSpan span("open", "embObjInertials::open");
+
     // - first thing to do is verify if the eth manager is available. then i parse info about the eth board.
 
     ethManager = eth::TheEthManager::instance();
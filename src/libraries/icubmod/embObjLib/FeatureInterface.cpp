@@ -132,7 +132,8 @@ eObool_t feat_manage_motioncontrol_data(eOipv4addr_t ipv4, eOprotID32_t id32, vo
     }
     else
     {
-        mc->update(id32, yarp::os::Time::now(), rxdata);
+        mc->update(id32, _interface2ethManager->ethBoards->rx_timestamp(ipv4), rxdata);
+        _interface2ethManager->ethBoards->rx_updated(ipv4, mc);
     }
 
     return eobool_true;
@@ -166,7 +167,8 @@ eObool_t feat_manage_motioncontrol_addinfo_multienc(eOipv4addr_t ipv4, eOprotID3
     }
     else
     {
-        multienc->update(id32, yarp::os::Time::now(), rxdata);
+        multienc->update(id32, _interface2ethManager->ethBoards->rx_timestamp(ipv4), rxdata);
+        _interface2ethManager->ethBoards->rx_updated(ipv4, multienc);
     }
 
     return eobool_true;
@@ -200,7 +202,8 @@ eObool_t feat_manage_skin_data(eOipv4addr_t ipv4, eOprotID32_t id32, void *array
     }
     else
     {
-        skin->update(id32, yarp::os::Time::now(), (void *)arrayofcandata);
+        skin->update(id32, _interface2ethManager->ethBoards->rx_timestamp(ipv4), (void *)arrayofcandata);
+        _interface2ethManager->ethBoards->rx_updated(ipv4, skin);
     }
 
     return eobool_true;
@@ -234,7 +237,8 @@ eObool_t feat_manage_analogsensors_data(eOipv4addr_t ipv4, eOprotID32_t id32, vo
     }
     else
     {   // data is a EOarray* in case of mais or strain but it is a eOas_inertial_status_t* in case of inertial sensor
-        sensor->update(id32, yarp::os::Time::now(), data);
+        sensor->update(id32, _interface2ethManager->ethBoards->rx_timestamp(ipv4), data);
+        _interface2ethManager->ethBoards->rx_updated(ipv4, sensor);
     }
 
     return eobool_true;
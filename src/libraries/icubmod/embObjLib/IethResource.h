@@ -50,6 +50,19 @@
 //          the rxdata passed from eoprot_fun_UPDT_sk_skin_status_arrayof10canframes() upto embObjSkin::update() does not need to be
 //          protected vs concurrent use because ... the only thread which writes into it is the caller of teh function: the ethReceiver thread
 //
+// about the lifetime of rxdata: it points to the ROP which is being decoded by HostTransceiver::parseUDP() and it is valid only
+// until update() returns, thus update() must use it directly (as embObjSkin, embObjMultipleFTsensors and embObjIMU do) and must
+// not keep it. there is no need to call getLocalValue() inside update(): it would just copy again, under lock_nvs, what rxdata
+// already contains. the received UDP packet is not copied by parseUDP(): its payload is given as it is to the transceiver.
+// the copies of the ROP inside the rx EOrop and into the ram of the EOnv are done by the embobj transceiver (EOtheAgent), which
+// is not part of this tree.
+//
+// about onFrameParsed(): a board can put in the same UDP frame several ROPs for the same device (e.g. the status of every joint
+// of embObjMotionControl), hence update() is called several times in a row. a device which prefers to do its bookkeeping once per
+// frame (e.g. to take its mutex once) can keep in update() what it receives and publish it in onFrameParsed(), which is called by
+// the ethReceiver thread at the end of every frame in which update() was called at least once. all the update() of a frame get
+// the same timestamp, which is also given to onFrameParsed(). the devices which do not override it keep working per ROP.
+//
 // the name of the class is IethResource because this class acts as an interface from ethResource which is the one which
 // manages decoding of received UDP packets and calls the callbacks of the EOnv which in turn call IethResource::update().
 //
@@ -88,6 +101,7 @@ namespace eth {
             virtual bool initialised() = 0;
             virtual bool update(eOprotID32_t id32, double timestamp, void *rxdata) = 0;
             virtual iethresType_t type() = 0;
+            virtual void onFrameParsed(double timestamp) {}
 
     public:
             const char * stringOfType();
@@ -76,12 +76,23 @@ namespace eth {
        
         virtual bool setRemoteValue(const eOprotID32_t id32, void *value) = 0;
 
+        // as setRemoteValue() for many variables, which the board receives in the same ropframe and thus applies in the same cycle
+        virtual bool setRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values) = 0;
+
         virtual bool setcheckRemoteValue(const eOprotID32_t id32, void *value, const unsigned int retries = 10, const double waitbeforecheck = 0.001, const double timeout = 0.050) = 0;
 
+        // as setcheckRemoteValue() for many variables, but all the set<> / ask<> are in flight at the same time. only the variables
+        // which fail to verify go through the retries of setcheckRemoteValue()
+        virtual bool setcheckRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const unsigned int retries = 10, const double waitbeforecheck = 0.001, const double timeout = 0.050) = 0;
+
         virtual bool getLocalValue(const eOprotID32_t id32, void *value) = 0;
 
         virtual bool setLocalValue(eOprotID32_t id32, const void *value, bool overrideROprotection = false) = 0;
 
+        // it verifies the board (presence, transceiver, behaviour, timing) and asks its version. verifyEPprotocol() does it as well
+        // if needed, but TheEthManager may call it in advance from one of its workers
+        virtual bool bringUp() = 0;
+
         virtual bool verifyEPprotocol(eOprot_endpoint_t ep) = 0;
 
         virtual bool CANPrintHandler(eOmn_info_basic_t* infobasic) = 0;
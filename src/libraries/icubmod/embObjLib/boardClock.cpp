@@ -0,0 +1,112 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - public interface
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "boardClock.h"
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - external dependencies
+// --------------------------------------------------------------------------------------------------------------------
+
+#include <cmath>
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - the class
+// --------------------------------------------------------------------------------------------------------------------
+
+
+// - class eth::BoardClock
+
+eth::BoardClock::BoardClock()
+{
+    reset();
+}
+
+
+void eth::BoardClock::reset()
+{
+    started = false;
+    valid = false;
+    lastboardtime = 0;
+    windowstart = 0;
+    currentmin = 0;
+    previousmin = 0;
+}
+
+
+double eth::BoardClock::update(double reception, uint64_t boardtime)
+{
+    const double board = static_cast<double>(boardtime) * 1e-6;
+    const double delta = reception - board;
+
+    if(started)
+    {
+        const double current = valid ? offset() : currentmin;
+        if((boardtime < lastboardtime) || (std::fabs(delta - current) > maxjump))
+        {
+            reset();
+        }
+    }
+
+    if(!started)
+    {
+        started = true;
+        windowstart = boardtime;
+        currentmin = delta;
+    }
+    else if(static_cast<double>(boardtime - windowstart) * 1e-6 >= window)
+    {
+        previousmin = currentmin;
+        currentmin = delta;
+        windowstart = boardtime;
+        valid = true;
+    }
+    else if(delta < currentmin)
+    {
+        currentmin = delta;
+    }
+
+    lastboardtime = boardtime;
+
+    return valid ? (board + offset()) : reception;
+}
+
+
+bool eth::BoardClock::synced() const
+{
+    return valid;
+}
+
+
+double eth::BoardClock::offset() const
+{
+    return (previousmin < currentmin) ? previousmin : currentmin;
+}
+
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
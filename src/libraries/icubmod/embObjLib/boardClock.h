@@ -0,0 +1,81 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+// - include guard ----------------------------------------------------------------------------------------------------
+
+#ifndef _BOARDCLOCK_H_
+#define _BOARDCLOCK_H_
+
+// -- class BoardClock
+// -- it maps the time of a board, which is the ageofframe in the header of every ropframe (usec since the bootstrap of
+// -- the board), into the time of the host, so that the values of a frame can be stamped with the time at which the
+// -- board has built the frame rather than with the time at which the host has parsed it.
+// -- the host time of reception of a frame is its board time + offset + a delay which is never negative (the transmission
+// -- and the scheduling of the receiver), hence the offset is estimated as the minimum of (reception - board time) over
+// -- the last one or two windows: the delays of a late frame do not count and a drift of the clocks is followed one
+// -- window after another.
+// -- a board time which goes back (the board has restarted) or an offset which jumps (the host clock has been set)
+// -- restart the estimation. until the first window has ended the time of reception is used as it is.
+// -- it is used by EthBoards under the rx lock of the board, thus it is not protected.
+
+#include <cstdint>
+
+
+namespace eth {
+
+    class BoardClock
+    {
+    public:
+
+        // the length of a window of the estimation of the offset [s]
+        static constexpr double window = 1.0;
+
+        // a difference from the current offset above which the estimation restarts [s]
+        static constexpr double maxjump = 0.5;
+
+        BoardClock();
+
+        void reset();
+
+        // reception is the host time of reception of the frame [s], boardtime its ageofframe [usec].
+        // it gives the estimated host time of the creation of the frame
+        double update(double reception, uint64_t boardtime);
+
+        // true when the offset is estimated
+        bool synced() const;
+
+        // host time - board time [s]
+        double offset() const;
+
+    private:
+
+        bool started;
+        bool valid;
+        uint64_t lastboardtime;
+        uint64_t windowstart;       // the board time at the start of the current window
+        double currentmin;          // the minimum of (reception - board time) in the current window
+        double previousmin;         // and in the previous one
+    };
+
+} // namespace eth
+
+
+#endif  // include-guard
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
@@ -0,0 +1,125 @@
+// -*- Mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - public interface
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "configIndex.h"
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - the class
+// --------------------------------------------------------------------------------------------------------------------
+
+
+// - class eth::ConfigIndex
+
+eth::ConfigIndex::ConfigIndex() : source(nullptr)
+{
+}
+
+
+eth::ConfigIndex::~ConfigIndex()
+{
+}
+
+
+void eth::ConfigIndex::clear()
+{
+    lists.clear();
+    root.clear();
+    source = nullptr;
+}
+
+
+void eth::ConfigIndex::build(yarp::os::Searchable &config)
+{
+    if(source == &config)
+    {
+        return;
+    }
+
+    clear();
+
+    // a Property is already hashed at its first level, but its groups are Bottles: so we index a Bottle copy of it
+    // where the groups of every level are reachable in the same way.
+    root.fromString(config.toString());
+    add(root);
+    source = &config;
+}
+
+
+void eth::ConfigIndex::add(yarp::os::Bottle &list)
+{
+    Groups *groups = nullptr;
+
+    for(size_t i=0; i<list.size(); i++)
+    {
+        yarp::os::Value &v = list.get(i);
+        if(!v.isList())
+        {
+            continue;
+        }
+
+        yarp::os::Bottle *b = v.asList();
+        if(b->size() > 0)
+        {
+            if(nullptr == groups)
+            {
+                groups = &lists[&list];
+            }
+            // the first one wins, as in Bottle::findGroup()
+            groups->insert(Groups::value_type(b->get(0).toString(), b));
+        }
+
+        add(*b);
+    }
+}
+
+
+yarp::os::Bottle & eth::ConfigIndex::findGroup(const std::string &key)
+{
+    return findGroup(root, key);
+}
+
+
+yarp::os::Bottle & eth::ConfigIndex::findGroup(yarp::os::Bottle &group, const std::string &key)
+{
+    auto l = lists.find(&group);
+    if(l == lists.end())
+    {
+        // either a list without groups or a list which is not ours
+        return group.findGroup(key);
+    }
+
+    auto g = l->second.find(key);
+    if(g == l->second.end())
+    {
+        return yarp::os::Bottle::getNullBottle();
+    }
+
+    return *(g->second);
+}
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
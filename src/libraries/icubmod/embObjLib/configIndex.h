@@ -0,0 +1,79 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+// - include guard ----------------------------------------------------------------------------------------------------
+
+#ifndef _CONFIGINDEX_H_
+#define _CONFIGINDEX_H_
+
+// -- class ConfigIndex
+// -- it is a copy of the configuration of a device together with a hash table of the groups of each of its lists, built
+// -- in a single pass. the parsers (eomc::Parser, ServiceParser) look the same groups up many times, e.g. GENERAL or
+// -- LIMITS once per parameter, and every Bottle::findGroup() is a linear scan of the list with string comparisons.
+// -- findGroup(group, key) gives the same result as group.findGroup(key): it is a hash lookup when group is a list of
+// -- the index (i.e. it has been obtained from the index itself), and it falls back to group.findGroup(key) otherwise.
+// -- the references given by the index stay valid until the next build() and must not be modified.
+
+#include <string>
+#include <unordered_map>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Searchable.h>
+
+
+namespace eth {
+
+    class ConfigIndex
+    {
+    public:
+
+        ConfigIndex();
+        ~ConfigIndex();
+
+        // copies config and indexes it. it does nothing if config is the one already indexed.
+        void build(yarp::os::Searchable &config);
+        void clear();
+
+        // as config.findGroup(key), for the config given to build()
+        yarp::os::Bottle & findGroup(const std::string &key);
+
+        // as group.findGroup(key)
+        yarp::os::Bottle & findGroup(yarp::os::Bottle &group, const std::string &key);
+
+    private:
+
+        // the tables point into root
+        ConfigIndex(const ConfigIndex &) = delete;
+        ConfigIndex & operator=(const ConfigIndex &) = delete;
+
+        typedef std::unordered_map<std::string, yarp::os::Bottle*> Groups;
+
+        void add(yarp::os::Bottle &list);
+
+        const yarp::os::Searchable *source;
+        yarp::os::Bottle root;
+        std::unordered_map<const yarp::os::Bottle*, Groups> lists;
+    };
+
+} // namespace eth
+
+
+#endif  // include-guard
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
@@ -34,6 +34,7 @@
 
 
 //#include <yarp/os/SystemClock.h>
+#include <yarp/os/Time.h>
 //#include <yarp/os/Log.h>
 //#include <yarp/os/LogStream.h>
 //using yarp::os::Log;
@@ -72,6 +73,7 @@ const string eth::EthBoards::errorname[1] =
 eth::EthBoards::EthBoards()
 {
     memset(LUT, 0, sizeof(LUT));
+    memset(rxFrames, 0, sizeof(rxFrames));
     sizeofLUT = 0;
 }
 
@@ -148,6 +150,9 @@ bool eth::EthBoards::add(eth::AbstractEthResource* res)
         LUT[index].interfaces[i] = NULL;
     }
 
+    // the caller holds the txrx lock of the board
+    rxClocks[index].reset();
+
     sizeofLUT++;
 
     return true;
@@ -282,6 +287,77 @@ eth::AbstractEthResource* eth::EthBoards::get_resource(eOipv4addr_t ipv4)
     return(ret);
 }
 
+bool eth::EthBoards::get_index(eOipv4addr_t ipv4, uint8_t &index)
+{
+    index = 0;
+    eo_common_ipv4addr_to_decimal(ipv4, NULL, NULL, NULL, &index);
+    index --;
+
+    return(index<maxEthBoards);
+}
+
+bool eth::EthBoards::lockTX(eOipv4addr_t ipv4, bool on)
+{
+    uint8_t index = 0;
+    if(!get_index(ipv4, index))
+    {
+        return false;
+    }
+
+    if(on)
+    {
+        txLocks[index].lock();
+    }
+    else
+    {
+        txLocks[index].unlock();
+    }
+
+    return true;
+}
+
+bool eth::EthBoards::lockRX(eOipv4addr_t ipv4, bool on)
+{
+    uint8_t index = 0;
+    if(!get_index(ipv4, index))
+    {
+        return false;
+    }
+
+    if(on)
+    {
+        rxLocks[index].lock();
+    }
+    else
+    {
+        rxLocks[index].unlock();
+    }
+
+    return true;
+}
+
+bool eth::EthBoards::lockTXRX(eOipv4addr_t ipv4, bool on)
+{
+    uint8_t index = 0;
+    if(!get_index(ipv4, index))
+    {
+        return false;
+    }
+
+    if(on)
+    {
+        txLocks[index].lock();
+        rxLocks[index].lock();
+    }
+    else
+    {
+        rxLocks[index].unlock();
+        txLocks[index].unlock();
+    }
+
+    return true;
+}
+
 bool eth::EthBoards::get_LUTindex(eOipv4addr_t ipv4, uint8_t &index)
 {
     index = 0;
@@ -300,6 +376,70 @@ bool eth::EthBoards::get_LUTindex(eOipv4addr_t ipv4, uint8_t &index)
     return true;
 }
 
+void eth::EthBoards::rx_begin(eOipv4addr_t ipv4, double timestamp, uint64_t boardtime)
+{
+    uint8_t index = 0;
+    if(!get_index(ipv4, index))
+    {
+        return;
+    }
+
+    rxFrames[index].timestamp = (0 != boardtime) ? rxClocks[index].update(timestamp, boardtime) : timestamp;
+    rxFrames[index].updated = 0;
+}
+
+double eth::EthBoards::rx_timestamp(eOipv4addr_t ipv4)
+{
+    uint8_t index = 0;
+    if(get_index(ipv4, index) && (0 != rxFrames[index].timestamp))
+    {
+        return rxFrames[index].timestamp;
+    }
+
+    return yarp::os::Time::now();
+}
+
+void eth::EthBoards::rx_updated(eOipv4addr_t ipv4, eth::IethResource* interface)
+{
+    uint8_t index = 0;
+    if((NULL == interface) || !get_index(ipv4, index) || (0 == rxFrames[index].timestamp))
+    {
+        return;
+    }
+
+    iethresType_t type = interface->type();
+    if((type < iethresType_numberof) && (interface == LUT[index].interfaces[type]))
+    {
+        rxFrames[index].updated |= (1 << type);
+    }
+}
+
+void eth::EthBoards::rx_end(eOipv4addr_t ipv4)
+{
+    uint8_t index = 0;
+    if(!get_index(ipv4, index))
+    {
+        return;
+    }
+
+    rxFrame_t &frame = rxFrames[index];
+    for(int t=0; (t<iethresType_numberof) && (0 != frame.updated); t++)
+    {
+        if(0 != (frame.updated & (1 << t)))
+        {
+            frame.updated &= ~(1 << t);
+            if(NULL != LUT[index].interfaces[t])
+            {
+                LUT[index].interfaces[t]->onFrameParsed(frame.timestamp);
+            }
+        }
+    }
+
+    frame.timestamp = 0;
+    frame.updated = 0;
+}
+
+
 eth::IethResource* eth::EthBoards::get_interface(eOipv4addr_t ipv4, iethresType_t type)
 {
     eth::IethResource *dev = NULL;
@@ -421,7 +561,7 @@ const string & eth::EthBoards::name(eOipv4addr_t ipv4)
 
 
 
-bool eth::EthBoards::execute(void (*action)(eth::AbstractEthResource* res, void* p), void* par)
+bool eth::EthBoards::execute(void (*action)(eth::AbstractEthResource* res, void* p), void* par, Lock lock)
 {
     if(NULL == action)
     {
@@ -430,12 +570,22 @@ bool eth::EthBoards::execute(void (*action)(eth::AbstractEthResource* res, void*
 
     for(int i=0; i<maxEthBoards; i++)
     {
+        std::mutex *mtx = (Lock::tx == lock) ? &txLocks[i] : ((Lock::rx == lock) ? &rxLocks[i] : nullptr);
+        if(nullptr != mtx)
+        {
+            mtx->lock();
+        }
+
         eth::AbstractEthResource* res = LUT[i].resource;
         if(NULL != res)
         {
             action(res, par);
         }
 
+        if(nullptr != mtx)
+        {
+            mtx->unlock();
+        }
     }
 
     return(true);
@@ -27,6 +27,10 @@
 #include "IethResource.h"
 #include "EoProtocol.h"
 #include <abstractEthResource.h>
+#include "boardClock.h"
+
+#include <atomic>
+#include <mutex>
 
 namespace eth {
 
@@ -36,6 +40,7 @@ namespace eth {
     // -- services of EthResource to transmit or receive.
     // -- it is responsibility of the object which owns EthBoards (it is ethManager) to protect the class EthBoards vs concurrent use.
     // -- examples of concurrent use are: transmit or receive using an ethresource and ... attempting to create or destroy a resource.
+    // -- for this purpose each board has its own tx and rx locks, so that the use of a board never contends with the use of another one.
 
     typedef struct
     {
@@ -50,6 +55,9 @@ namespace eth {
 
         enum { maxEthBoards = 32 };
 
+        // the lock taken by execute() on each board
+        enum class Lock { none, tx, rx };
+
     public:
 
         EthBoards();
@@ -70,12 +78,28 @@ namespace eth {
         // the name of the board
         const string & name(eOipv4addr_t ipv4);
 
-        // executes an action on all EthResource which have been added in the class.
-        bool execute(void (*action)(eth::AbstractEthResource* res, void* p), void* par);
+        // executes an action on all EthResource which have been added in the class. each action is done holding the chosen lock of its board.
+        bool execute(void (*action)(eth::AbstractEthResource* res, void* p), void* par, Lock lock = Lock::none);
 
         // executes an action on the ethResource having a specific ipv4.
         bool execute(eOipv4addr_t ipv4, void (*action)(eth::AbstractEthResource* res, void* p), void* par);
 
+        // the locks of the board with a given ipv4: the rx lock protects the parsing of its packets, the tx lock the preparation of its frames
+        // and the txrx lock any change of its resource or interfaces. they return false if the ipv4 cannot be a board.
+        bool lockTX(eOipv4addr_t ipv4, bool on);
+        bool lockRX(eOipv4addr_t ipv4, bool on);
+        bool lockTXRX(eOipv4addr_t ipv4, bool on);
+
+        // they bracket the parsing of a frame of the board and must be called with its rx lock taken. in between, the callbacks get the
+        // time of the frame with rx_timestamp() and tell which interface they have updated with rx_updated(). rx_end() calls
+        // IethResource::onFrameParsed() of the updated interfaces. out of a frame rx_timestamp() gives the current time.
+        // timestamp is the time of reception and boardtime the ageofframe of the frame, 0 if unknown: the time of the frame is the
+        // board time mapped into the host time by the BoardClock of the board, or the time of reception until it is synced.
+        void rx_begin(eOipv4addr_t ipv4, double timestamp, uint64_t boardtime = 0);
+        double rx_timestamp(eOipv4addr_t ipv4);
+        void rx_updated(eOipv4addr_t ipv4, eth::IethResource* interface);
+        void rx_end(eOipv4addr_t ipv4);
+
 
     private:
 
@@ -99,13 +123,29 @@ namespace eth {
         static const string defaultnames[EthBoards::maxEthBoards];
         static const string errorname[1];
 
-        int sizeofLUT;
+        std::atomic<int> sizeofLUT;
         ethboardProperties_t LUT[EthBoards::maxEthBoards];
 
+        std::mutex txLocks[EthBoards::maxEthBoards];
+        std::mutex rxLocks[EthBoards::maxEthBoards];
+
+        // the frame being parsed for each board: it is protected by the rx lock
+        typedef struct
+        {
+            double      timestamp;      // 0 out of a frame
+            uint32_t    updated;        // bit t is set if interfaces[t] has been updated in the frame
+        } rxFrame_t;
+
+        rxFrame_t rxFrames[EthBoards::maxEthBoards];
+
+        // the clocks of the boards: they are protected by the rx lock and restarted when a resource is added
+        BoardClock rxClocks[EthBoards::maxEthBoards];
+
     private:
 
         // private functions
         bool get_LUTindex(eOipv4addr_t ipv4, uint8_t &index);
+        bool get_index(eOipv4addr_t ipv4, uint8_t &index);
     };
 
 } // namespace eth
@@ -0,0 +1,346 @@
+// -*- Mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - public interface
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "ethCapture.h"
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - external dependencies
+// --------------------------------------------------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+#if defined(ETHCAPTURE_USE_MMAP)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <yarp/os/Log.h>
+#include <yarp/os/LogStream.h>
+using yarp::os::Log;
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - pimpl: private implementation (see scott meyers: item 22 of effective modern c++, item 31 of effective c++
+// --------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+    const char captureMagic[8] = { 'E', 'O', 'C', 'A', 'P', 'T', 'U', 'R' };
+
+    // the slots start after the header, at an offset which keeps them aligned to a cache line
+    const size_t slotsOffset = 64;
+
+    static_assert(sizeof(eth::EthCapture::Header) <= slotsOffset, "the header of the capture file does not fit its room");
+    static_assert(0 == (sizeof(eth::EthCapture::Slot) % 8), "the slots of the capture file must keep the frames 8-byte aligned");
+    static_assert(0 == (offsetof(eth::EthCapture::Slot, data) % 8), "the frames of the capture file must be 8-byte aligned");
+}
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - the class
+// --------------------------------------------------------------------------------------------------------------------
+
+
+// - class eth::EthCapture
+
+eth::EthCapture::EthCapture()
+{
+    header = nullptr;
+    slots = nullptr;
+    mappedsize = 0;
+}
+
+
+eth::EthCapture::~EthCapture()
+{
+    close();
+}
+
+
+bool eth::EthCapture::open(const std::string &filename, uint32_t numberofslots)
+{
+    close();
+
+#if defined(ETHCAPTURE_USE_MMAP)
+
+    if(0 == numberofslots)
+    {
+        yError() << "EthCapture::open() cannot record into" << filename << "with zero slots";
+        return false;
+    }
+
+    int fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+    {
+        yError() << "EthCapture::open() cannot create" << filename << ":" << strerror(errno);
+        return false;
+    }
+
+    size_t size = slotsOffset + static_cast<size_t>(numberofslots)*sizeof(Slot);
+
+    // the file is sparse: the disk is used only for the slots which are actually written
+    if(0 != ftruncate(fd, size))
+    {
+        yError() << "EthCapture::open() cannot resize" << filename << "to" << size << "bytes:" << strerror(errno);
+        ::close(fd);
+        return false;
+    }
+
+    void *m = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(MAP_FAILED == m)
+    {
+        yError() << "EthCapture::open() cannot map" << filename << ":" << strerror(errno);
+        return false;
+    }
+
+    // the pages of a new file are zero, hence all the slots are empty and the counter is 0
+    Header *h = static_cast<Header*>(m);
+    memcpy(h->magic, captureMagic, sizeof(h->magic));
+    h->version = version;
+    h->slotsize = sizeof(Slot);
+    h->numberofslots = numberofslots;
+    h->reserved = 0;
+    h->next.store(0, std::memory_order_relaxed);
+
+    slots = reinterpret_cast<Slot*>(static_cast<uint8_t*>(m) + slotsOffset);
+    mappedsize = size;
+    name = filename;
+    std::atomic_thread_fence(std::memory_order_release);
+    header = h;
+
+    yDebug() << "EthCapture::open() records the received frames into" << filename << "which keeps the latest" << numberofslots << "of them";
+
+    return true;
+
+#else
+
+    yError() << "EthCapture::open() cannot record into" << filename << "because the capture is not supported on this platform";
+    return false;
+
+#endif
+}
+
+
+void eth::EthCapture::close()
+{
+    if(nullptr == header)
+    {
+        return;
+    }
+
+#if defined(ETHCAPTURE_USE_MMAP)
+    uint64_t recorded = header->next.load(std::memory_order_acquire);
+    uint32_t numberofslots = header->numberofslots;
+
+    // the receivers must not record anymore: TheEthManager closes the capture only after having stopped them
+    Header *h = header;
+    header = nullptr;
+    msync(h, mappedsize, MS_ASYNC);
+    munmap(h, mappedsize);
+
+    yDebug() << "EthCapture::close() has recorded" << recorded << "frames into" << name << "and kept the latest" << std::min<uint64_t>(recorded, numberofslots);
+#endif
+
+    slots = nullptr;
+    mappedsize = 0;
+    name.clear();
+}
+
+
+void eth::EthCapture::record(eOipv4addr_t from, const void *data, size_t size, uint64_t timestamp)
+{
+    if(nullptr == header)
+    {
+        return;
+    }
+
+    if(0 == timestamp)
+    {
+        timestamp = now();
+    }
+
+    if(size > maxframesize)
+    {
+        size = maxframesize;
+    }
+
+    // the slot is reserved with an atomic increment. its sequence is zeroed while it is filled and it is published at the end,
+    // thus the reader skips a slot which was interrupted (e.g. by a crash) in the middle of the copy
+    uint64_t n = header->next.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots[n % header->numberofslots];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.timestamp = timestamp;
+    slot.ipv4 = from;
+    slot.size = static_cast<uint32_t>(size);
+    memcpy(slot.data, data, size);
+    slot.sequence.store(n+1, std::memory_order_release);
+}
+
+
+uint64_t eth::EthCapture::now()
+{
+    // SO_TIMESTAMPNS uses CLOCK_REALTIME, which is what system_clock reads
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+
+
+// - class eth::EthCaptureReader
+
+eth::EthCaptureReader::EthCaptureReader()
+{
+    mapped = nullptr;
+    mappedsize = 0;
+    slots = nullptr;
+}
+
+
+eth::EthCaptureReader::~EthCaptureReader()
+{
+    close();
+}
+
+
+bool eth::EthCaptureReader::open(const std::string &filename, eOipv4addr_t ipv4)
+{
+    close();
+
+#if defined(ETHCAPTURE_USE_MMAP)
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd < 0)
+    {
+        yError() << "EthCaptureReader::open() cannot open" << filename << ":" << strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if((0 != fstat(fd, &st)) || (static_cast<size_t>(st.st_size) < slotsOffset))
+    {
+        yError() << "EthCaptureReader::open() cannot use" << filename << "because it is too small";
+        ::close(fd);
+        return false;
+    }
+
+    size_t size = st.st_size;
+    void *m = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(MAP_FAILED == m)
+    {
+        yError() << "EthCaptureReader::open() cannot map" << filename << ":" << strerror(errno);
+        return false;
+    }
+
+    const EthCapture::Header *h = static_cast<const EthCapture::Header*>(m);
+    if((0 != memcmp(h->magic, captureMagic, sizeof(captureMagic))) || (EthCapture::version != h->version) || (sizeof(EthCapture::Slot) != h->slotsize) ||
+       (size < slotsOffset + static_cast<size_t>(h->numberofslots)*sizeof(EthCapture::Slot)))
+    {
+        yError() << "EthCaptureReader::open() cannot use" << filename << "because it is not a capture file of version" << static_cast<int>(EthCapture::version);
+        munmap(m, size);
+        return false;
+    }
+
+    mapped = static_cast<const uint8_t*>(m);
+    mappedsize = size;
+    slots = reinterpret_cast<const EthCapture::Slot*>(mapped + slotsOffset);
+
+    // the slots are in order of arrival modulo the wrap around of the ring, hence we sort them by sequence
+    std::vector<std::pair<uint64_t, uint32_t>> sequences;
+    sequences.reserve(h->numberofslots);
+    for(uint32_t i=0; i<h->numberofslots; i++)
+    {
+        uint64_t s = slots[i].sequence.load(std::memory_order_relaxed);
+        if((0 != s) && ((0 == ipv4) || (ipv4 == slots[i].ipv4)) && (slots[i].size <= EthCapture::maxframesize))
+        {
+            sequences.push_back(std::make_pair(s, i));
+        }
+    }
+    std::sort(sequences.begin(), sequences.end());
+
+    order.reserve(sequences.size());
+    for(const auto &s : sequences)
+    {
+        order.push_back(s.second);
+    }
+
+    return true;
+
+#else
+
+    yError() << "EthCaptureReader::open() cannot read" << filename << "because the capture is not supported on this platform";
+    return false;
+
+#endif
+}
+
+
+void eth::EthCaptureReader::close()
+{
+#if defined(ETHCAPTURE_USE_MMAP)
+    if(nullptr != mapped)
+    {
+        munmap(const_cast<uint8_t*>(mapped), mappedsize);
+    }
+#endif
+
+    mapped = nullptr;
+    mappedsize = 0;
+    slots = nullptr;
+    order.clear();
+}
+
+
+bool eth::EthCaptureReader::get(size_t i, Frame &frame) const
+{
+    if(i >= order.size())
+    {
+        return false;
+    }
+
+    const EthCapture::Slot &slot = slots[order[i]];
+    frame.timestamp = slot.timestamp;
+    frame.ipv4 = slot.ipv4;
+    frame.size = slot.size;
+    frame.data = reinterpret_cast<const uint64_t*>(slot.data);
+
+    return true;
+}
+
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
+
+
+
@@ -0,0 +1,144 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+// - include guard ----------------------------------------------------------------------------------------------------
+
+#ifndef _ETHCAPTURE_H_
+#define _ETHCAPTURE_H_
+
+// -- class EthCapture
+// -- it records the udp frames received from the boards into a memory-mapped file. the file is a header followed by a ring of
+// -- fixed size slots: every receiver reserves the next slot with an atomic increment and fills it, thus the recording never
+// -- waits for a lock nor for the disk. when the ring is full the oldest frames are overwritten, hence the file always keeps
+// -- the most recent numberofslots frames.
+// -- class EthCaptureReader
+// -- it opens a file written by EthCapture and gives its frames in order of arrival. it is used by FakeEthResource to replay
+// -- a session when embBoardsConnected is false.
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "EoCommon.h"
+
+// the capture uses mmap(), which is available on posix systems only
+#if defined(__unix__)
+#define ETHCAPTURE_USE_MMAP
+#endif
+
+
+namespace eth {
+
+    class EthCapture
+    {
+    public:
+
+        // it is the same as TheEthManager::maxRXpacketsize: longer frames are truncated
+        enum { maxframesize = 1496 };
+
+        struct Header
+        {
+            char                    magic[8];           // "EOCAPTUR"
+            uint32_t                version;
+            uint32_t                slotsize;           // sizeof(Slot)
+            uint32_t                numberofslots;
+            uint32_t                reserved;
+            std::atomic<uint64_t>   next;               // number of frames recorded so far (overwritten ones included)
+        };
+
+        struct Slot
+        {
+            std::atomic<uint64_t>   sequence;           // 1 + order of arrival. it is 0 while the slot is being filled
+            uint64_t                timestamp;          // time of reception [ns] since the epoch: kernel rx time if available
+            uint32_t                ipv4;               // the board which has sent the frame
+            uint32_t                size;               // the recorded bytes in data
+            uint8_t                 data[maxframesize];
+        };
+
+        enum { version = 1 };
+
+        EthCapture();
+        ~EthCapture();
+
+        // it creates the file (which is overwritten if it exists) with room for numberofslots frames
+        bool open(const std::string &filename, uint32_t numberofslots);
+        void close();
+        bool isopen() const { return (nullptr != header); }
+
+        // it can be called concurrently by several receivers. timestamp is in ns since the epoch: if 0, the current time is used
+        void record(eOipv4addr_t from, const void *data, size_t size, uint64_t timestamp);
+
+        // the current time in ns since the epoch, on the same clock used by the kernel for SO_TIMESTAMPNS
+        static uint64_t now();
+
+    private:
+
+        Header *header;
+        Slot *slots;
+        size_t mappedsize;
+        std::string name;
+    };
+
+
+    class EthCaptureReader
+    {
+    public:
+
+        struct Frame
+        {
+            uint64_t        timestamp;  // [ns] since the epoch
+            eOipv4addr_t    ipv4;
+            size_t          size;
+            const uint64_t *data;       // 8-byte aligned: it stays valid until the reader is closed
+        };
+
+        EthCaptureReader();
+        ~EthCaptureReader();
+
+        // it opens the file and sorts its frames in order of arrival. if ipv4 is not 0 it keeps only the frames of that board
+        bool open(const std::string &filename, eOipv4addr_t ipv4 = 0);
+        void close();
+
+        size_t numberofframes() const { return order.size(); }
+        bool get(size_t i, Frame &frame) const;
+
+    private:
+
+        const uint8_t *mapped;
+        size_t mappedsize;
+        const EthCapture::Slot *slots;
+        std::vector<uint32_t> order;
+    };
+
+
+} // namespace eth
+
+
+#endif  // include-guard
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
+
+
+
+
+
+
@@ -43,7 +43,14 @@
 #include <stdexcept>      // std::out_of_range
 #include <yarp/os/Network.h>
 #include <yarp/os/NetType.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/os/ConnectionReader.h>
+#include <yarp/os/ConnectionWriter.h>
+#include <yarp/conf/environment.h>
 #include <ace/Time_Value.h>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
 
 #if defined(__unix__)
 #include <pthread.h>
@@ -58,6 +65,7 @@ using namespace yarp::os::impl;
 #include <fakeEthResource.h>
 #include <ethResource.h>
 #include <ethParser.h>
+#include <iCub/StartupTrace.h>
 
 using namespace eth;
 
@@ -67,6 +75,8 @@ using namespace eth;
 // - pimpl: private implementation (see scott meyers: item 22 of effective modern c++, item 31 of effective c++
 // --------------------------------------------------------------------------------------------------------------------
 
+// the capture must be able to record every frame we can receive
+static_assert(static_cast<int>(eth::EthCapture::maxframesize) == static_cast<int>(TheEthManager::maxRXpacketsize), "the slots of EthCapture do not fit the rx packets");
 
 
 // --------------------------------------------------------------------------------------------------------------------
@@ -82,7 +92,6 @@ using namespace eth;
 //               that is the same behaviour of the former yarp::os::Semaphore initted w/ value 1
 std::mutex TheEthManager::managerSem {}; 
 std::mutex TheEthManager::txSem {};
-std::mutex TheEthManager::rxSem {};
 
 TheEthManager* TheEthManager::handle {nullptr};
 
@@ -104,6 +113,42 @@ TheEthManager::TheEthManager()
 
     // the time of creation according to yarp
     startUpTime = yarp::os::Time::now();
+
+    // the queue of the tx frames
+#if defined(ETHMANAGER_USE_SENDMMSG)
+    txqueuesize = 0;
+    memset(txmessages, 0, sizeof(txmessages));
+    for(int i=0; i<maxBoards; i++)
+    {
+        txmessages[i].msg_hdr.msg_iov = &txiovectors[i];
+        txmessages[i].msg_hdr.msg_iovlen = 1;
+        txmessages[i].msg_hdr.msg_name = &txaddresses[i];
+        txmessages[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+    }
+#endif
+
+    // by default the boards are brought up serially by the callers of requestResource2()
+    bringUpMaxWorkers = 0;
+    bringUpIdleWorkers = 0;
+    bringUpRunning = 0;
+    bringUpQuit = false;
+    bringUpBatchStart = 0.0;
+
+    // the user can have the tx statistics printed by environment variable ETHSTAT_PRINT_INTERVAL [sec]
+    txstats.reset();
+    txstatsPrint.reset();
+    txstatPrintInterval = 0.0;
+    txstatLastPrint = 0.0;
+    std::string tmp = yarp::conf::environment::get_string("ETHSTAT_PRINT_INTERVAL");
+    if (tmp != "")
+    {
+        txstatPrintInterval = yarp::conf::numeric::from_string(tmp, 0.);
+    }
+
+    // the same interval prints the rx statistics of every board
+    rxstats.enable(txstatPrintInterval > 0);
+    rxstatLastPrint = 0.0;
+    statisticsReader.owner = this;
 }
 
 
@@ -121,6 +166,12 @@ TheEthManager::~TheEthManager()
     // Deinitialize feature interface
     feat_DeInitialise();
 
+    // the workers of the bring-up use the resources, thus they must be terminated before anything else
+    stopBringUp();
+
+    // nobody must ask for statistics while we destroy the objects
+    statisticsPort.close();
+
     // close communication (tx and rx threads, socket) BUT only if they were created and initted
     if(isCommunicationInitted())
     {
@@ -137,7 +188,22 @@ TheEthManager::~TheEthManager()
 
 
         delete sender;
-        delete receiver;
+        for(eth::EthReceiver *receiver : receivers)
+        {
+            delete receiver;
+        }
+        receivers.clear();
+
+        // the sockets of the further shards
+        for(ACE_SOCK_Dgram *socket : RX_sockets)
+        {
+            socket->close();
+            delete socket;
+        }
+        RX_sockets.clear();
+
+        // the receivers are stopped, hence nobody records anymore
+        capture.close();
 
         lock(false);
     }
@@ -145,7 +211,7 @@ TheEthManager::~TheEthManager()
 
     lock(true);
 
-    // remove all ethresource ... we dont need to call lockTXRX() because we are not transmitting now
+    // remove all ethresource ... we dont need to lock the boards because we are not transmitting now
     ethBoards->execute(delete_resources, NULL);
     delete ethBoards;
 
@@ -243,7 +309,7 @@ void ethEvalTXropframe(eth::AbstractEthResource *r, void* p)
 
     if(nullptr != data2send)
     {
-        ethman->sendPacket(data2send, numofbytes, ipv4addressing);
+        ethman->queuePacket(data2send, numofbytes, ipv4addressing);
     }
 
 #endif
@@ -254,7 +320,35 @@ bool TheEthManager::Transmission(void)
 {
     lockTX(true);
 
-    ethBoards->execute(ethEvalTXropframe, this);
+    double t0 = yarp::os::SystemClock::nowSystem();
+
+    // each board is locked only while its frame is prepared. a board is removed only with lockTX() taken,
+    // thus the queued frames are valid until they are flushed
+    ethBoards->execute(ethEvalTXropframe, this, eth::EthBoards::Lock::tx);
+    flushPackets();
+
+    double t1 = yarp::os::SystemClock::nowSystem();
+    double duration = t1 - t0;
+    for(TXstatistics *st : {&txstats, &txstatsPrint})
+    {
+        st->durationMin = (0 == st->cycles) ? duration : std::min(st->durationMin, duration);
+        st->durationMax = std::max(st->durationMax, duration);
+        st->durationSum += duration;
+        st->cycles++;
+    }
+
+    if((txstatPrintInterval > 0) && ((t1 - txstatLastPrint) >= txstatPrintInterval))
+    {
+        if(txstatsPrint.cycles > 0)
+        {
+            yDebug() << "TheEthManager::Transmission(): in the last" << t1 - txstatLastPrint << "sec there were" << txstatsPrint.cycles
+                     << "tx cycles of duration [min mean max] = [" << 1000.0*txstatsPrint.durationMin << 1000.0*txstatsPrint.durationSum/txstatsPrint.cycles
+                     << 1000.0*txstatsPrint.durationMax << "] ms with" << (double)txstatsPrint.frames/txstatsPrint.cycles << "frames per cycle and"
+                     << txstatsPrint.errors << "frames not sent";
+        }
+        txstatsPrint.reset();
+        txstatLastPrint = t1;
+    }
 
     lockTX(false);
 
@@ -262,6 +356,91 @@ bool TheEthManager::Transmission(void)
 }
 
 
+void TheEthManager::queuePacket(const void *udpframe, size_t len, const eOipv4addressing_t &toaddressing)
+{
+#if defined(ETHMANAGER_USE_SENDMMSG)
+    if(txqueuesize >= maxBoards)
+    {   // it cannot happen because we have one frame per board, but ... in such a case we make room
+        flushPackets();
+    }
+
+    ACE_INET_Addr inetaddr = toaceinet(toaddressing);
+    memcpy(&txaddresses[txqueuesize], inetaddr.get_addr(), sizeof(struct sockaddr_in));
+    txiovectors[txqueuesize].iov_base = const_cast<void*>(udpframe);
+    txiovectors[txqueuesize].iov_len = len;
+    txqueuesize++;
+#else
+    int ret = sendPacket(udpframe, len, toaddressing);
+    txstats.frames++;
+    txstatsPrint.frames++;
+    if(ret < 0)
+    {
+        txstats.errors++;
+        txstatsPrint.errors++;
+    }
+#endif
+}
+
+
+void TheEthManager::flushPackets(void)
+{
+#if defined(ETHMANAGER_USE_SENDMMSG)
+    ACE_HANDLE sockfd = UDP_socket->get_handle();
+    int sent = 0;
+    int errors = 0;
+    while(sent < txqueuesize)
+    {
+        int r = sendmmsg(sockfd, &txmessages[sent], txqueuesize - sent, 0);
+        if(r > 0)
+        {
+            sent += r;
+            continue;
+        }
+
+        if((r < 0) && (errno == EINTR))
+        {
+            continue;
+        }
+
+        if((r < 0) && (errno == ENOSYS))
+        {   // no sendmmsg() in the kernel: we send the frames one by one
+            for(; sent < txqueuesize; sent++)
+            {
+                if(::sendto(sockfd, txiovectors[sent].iov_base, txiovectors[sent].iov_len, 0,
+                            reinterpret_cast<struct sockaddr*>(&txaddresses[sent]), sizeof(struct sockaddr_in)) < 0)
+                {
+                    errors++;
+                }
+            }
+            break;
+        }
+
+        // the frame which fails is dropped, as a failing sendto() would do, and we go on with the others
+        errors++;
+        sent++;
+    }
+
+    txstats.frames += txqueuesize;
+    txstatsPrint.frames += txqueuesize;
+    txstats.errors += errors;
+    txstatsPrint.errors += errors;
+    txqueuesize = 0;
+#endif
+}
+
+
+void TheEthManager::getTXstatistics(TXstatistics &stats, bool reset)
+{
+    lockTX(true);
+    stats = txstats;
+    if(reset)
+    {
+        txstats.reset();
+    }
+    lockTX(false);
+}
+
+
 void ethEvalPresence(eth::AbstractEthResource *r, void* p)
 {
     if((NULL == r) || (NULL == p))
@@ -274,7 +453,120 @@ void ethEvalPresence(eth::AbstractEthResource *r, void* p)
 
 bool TheEthManager::CheckPresence(void)
 {
-    ethBoards->execute(ethEvalPresence, this);
+    // in event mode the packets are received by another thread
+    ethBoards->execute(ethEvalPresence, this, eth::EthBoards::Lock::rx);
+
+    double now = yarp::os::Time::now();
+    if((txstatPrintInterval > 0) && ((now - rxstatLastPrint) >= txstatPrintInterval))
+    {
+        // the statistics have their own locks, thus we dont stop the reception of the boards
+        ethBoards->execute([](eth::AbstractEthResource *r, void *p)
+        {
+            TheEthManager *m = static_cast<TheEthManager*>(p);
+            eth::EthRXstatistics::Board b;
+            if((NULL == r) || (false == m->rxstats.get(r->getProperties().ipv4addr, b, eth::EthRXstatistics::Period::sinceprint, true)))
+            {
+                return;
+            }
+            yDebug() << "TheEthManager::CheckPresence(): in the last" << yarp::os::Time::now() - m->rxstatLastPrint << "sec BOARD" << r->getProperties().boardnameString
+                     << "with IP" << r->getProperties().ipv4addrString << "has sent" << b.frames << "frames," << b.lost << "lost and" << b.disordered << "out of order"
+                     << "with inter-arrival [mean max] = [" << b.interarrival.mean() << b.interarrival.max << "] usec and parsing [mean max] = ["
+                     << b.parsing.mean() << b.parsing.max << "] usec";
+        }, this);
+        rxstatLastPrint = now;
+    }
+
+    return true;
+}
+
+
+void TheEthManager::getStatistics(yarp::os::Bottle &stats, bool reset)
+{
+    stats.clear();
+
+    TXstatistics tx;
+    getTXstatistics(tx, reset);
+    yarp::os::Bottle &btx = stats.addList();
+    btx.addString("tx");
+    const char *names[] = { "cycles", "frames", "errors" };
+    const unsigned long values[] = { tx.cycles, tx.frames, tx.errors };
+    for(int i=0; i<3; i++)
+    {
+        yarp::os::Bottle &v = btx.addList();
+        v.addString(names[i]);
+        v.addInt64(values[i]);
+    }
+    yarp::os::Bottle &d = btx.addList();
+    d.addString("duration");
+    d.addFloat64(1000.0*tx.durationMin);
+    d.addFloat64((tx.cycles > 0) ? (1000.0*tx.durationSum/tx.cycles) : 0.0);
+    d.addFloat64(1000.0*tx.durationMax);
+
+    yarp::os::Bottle &boards = stats.addList();
+    boards.addString("boards");
+
+    struct Request { TheEthManager *manager; yarp::os::Bottle *boards; bool reset; } request = { this, &boards, reset };
+    ethBoards->execute([](eth::AbstractEthResource *r, void *p)
+    {
+        Request *q = static_cast<Request*>(p);
+        eth::EthRXstatistics::Board b;
+        if((NULL == r) || (false == q->manager->rxstats.get(r->getProperties().ipv4addr, b, eth::EthRXstatistics::Period::sincereset, q->reset)))
+        {
+            return;
+        }
+        yarp::os::Bottle &board = q->boards->addList();
+        yarp::os::Bottle &name = board.addList();
+        name.addString("name");
+        name.addString(r->getProperties().boardnameString);
+        yarp::os::Bottle &ip = board.addList();
+        ip.addString("ip");
+        ip.addString(r->getProperties().ipv4addrString);
+        b.toBottle(board);
+    }, &request);
+}
+
+
+void TheEthManager::enableRXstatistics(bool on)
+{
+    if(true == communicationIsInitted)
+    {
+        yWarning() << "TheEthManager::enableRXstatistics() is called after the communication is initialised, thus the interarrival times may lack the kernel timestamps";
+    }
+    rxstats.enable(on);
+}
+
+
+bool TheEthManager::getRXstatistics(eOipv4addr_t ipv4, eth::EthRXstatistics::Board &board, bool reset)
+{
+    return rxstats.get(ipv4, board, eth::EthRXstatistics::Period::sincereset, reset);
+}
+
+
+bool TheEthManager::StatisticsReader::read(yarp::os::ConnectionReader &connection)
+{
+    yarp::os::Bottle command;
+    yarp::os::Bottle reply;
+    if(false == command.read(connection))
+    {
+        return false;
+    }
+
+    std::string cmd = command.get(0).asString();
+    if((cmd == "get") || (cmd == "reset"))
+    {
+        owner->getStatistics(reply, (cmd == "reset"));
+    }
+    else
+    {
+        reply.addString("unknown command: use get or reset (which replies the statistics and then clears them)");
+    }
+
+    yarp::os::ConnectionWriter *returnToSender = connection.getWriter();
+    if(NULL != returnToSender)
+    {
+        reply.write(*returnToSender);
+    }
+
     return true;
 }
 
@@ -302,6 +594,8 @@ bool TheEthManager::verifyEthBoardInfo(yarp::os::Searchable &cfgtotal, eOipv4add
 
 bool TheEthManager::initCommunication(yarp::os::Searchable &cfgtotal)
 {
+    iCub::dev::TraceSpan span("eth", "TheEthManager::initCommunication");
+
     eth::parser::pc104Data pc104data;
     if(false == eth::parser::read(cfgtotal, pc104data))
     {
@@ -316,9 +610,25 @@ bool TheEthManager::initCommunication(yarp::os::Searchable &cfgtotal)
     int rxrate = pc104data.rxrate;
     eOipv4addressing_t tmpaddress = pc104data.localaddressing;
     embBoardsConnected = pc104data.embBoardsConnected;
+    bringUpMaxWorkers = (true == embBoardsConnected) ? pc104data.bringupworkers : 0;
+
+    // the capture and the statistics must be enabled before the receivers are configured, because they ask the kernel for the
+    // timestamps only if needed
+    if(!pc104data.statisticsport.empty())
+    {
+        rxstats.enable(true);
+    }
+
+    if(!pc104data.capturefile.empty())
+    {
+        if(false == capture.open(pc104data.capturefile, pc104data.captureframes))
+        {
+            yWarning() << "TheEthManager::initCommunication() cannot open PC104CaptureFile" << pc104data.capturefile << "thus the received frames are not recorded";
+        }
+    }
 
     // localaddress
-    if(false == createCommunicationObjects(tmpaddress, txrate, rxrate) )
+    if(false == createCommunicationObjects(tmpaddress, txrate, rxrate, pc104data.rxevent, pc104data.rxcore, pc104data.rxshards) )
     {
         yError () << "TheEthManager::initCommunication() cannot create communication objects";
         return false;
@@ -328,6 +638,15 @@ bool TheEthManager::initCommunication(yarp::os::Searchable &cfgtotal)
     ipv4local.addr = tmpaddress.addr;
     ipv4local.port = tmpaddress.port;
 
+    if(!pc104data.statisticsport.empty())
+    {
+        statisticsPort.setReader(statisticsReader);
+        if(false == statisticsPort.open(pc104data.statisticsport))
+        {
+            yWarning() << "TheEthManager::initCommunication() cannot open PC104StatisticsPort" << pc104data.statisticsport << "thus the statistics can only be printed with ETHSTAT_PRINT_INTERVAL";
+        }
+    }
+
     return true;
 }
 
@@ -355,12 +674,14 @@ eth::AbstractEthResource *TheEthManager::requestResource2(IethResource *interfac
 
     eOipv4addr_t ipv4addr = bdata.properties.ipv4addressing.addr;
 
-    // i want to lock the use of resources managed by ethBoards to avoid that we attempt to use for TX a ethres not completely initted
+    // i want to lock the use of resources managed by ethBoards to avoid that we attempt to use for TX a ethres not completely initted.
+    // only the board being configured is locked: the other boards go on transmitting and receiving
 
-    lockTXRX(true);
+    ethBoards->lockTXRX(ipv4addr, true);
 
     // i do an attempt to get the resource.
     eth::AbstractEthResource *rr = ethBoards->get_resource(ipv4addr);
+    bool isnew = (NULL == rr);
 
     if(NULL == rr)
     {
@@ -389,6 +710,7 @@ eth::AbstractEthResource *TheEthManager::requestResource2(IethResource *interfac
             }
 
             rr = NULL;
+            ethBoards->lockTXRX(ipv4addr, false);
             return NULL;
         }
 
@@ -399,7 +721,14 @@ eth::AbstractEthResource *TheEthManager::requestResource2(IethResource *interfac
     ethBoards->add(rr, interface);
 
 
-    lockTXRX(false);
+    ethBoards->lockTXRX(ipv4addr, false);
+
+    // the new board can be brought up while the caller goes on with its own configuration: the caller waits for it in
+    // verifyEPprotocol(). the board must be unlocked because its bring-up needs to transmit and receive
+    if((true == isnew) && (bringUpMaxWorkers > 0) && (false == rr->isFake()))
+    {
+        startBringUp(rr);
+    }
 
     return(rr);
 }
@@ -418,6 +747,9 @@ int TheEthManager::releaseResource2(eth::AbstractEthResource* ethresource, IethR
 
     eth::AbstractEthResource* rr = ethresource;
 
+    // a board still being brought up cannot be stopped
+    waitBringUp(rr->getProperties().ipv4addr);
+
     iethresType_t type = interface->type();
 
     // but you must change later on with eomn_serv_category_mc or ...
@@ -482,8 +814,11 @@ int TheEthManager::releaseResource2(eth::AbstractEthResource* ethresource, IethR
     // the ropframe sent now do not contain any regular for the interface anymore, thus we can just removing the interface in list of those assciated
     // to the resource, without any harm. only thing is: protect ethBoards with a mutex.
 
-    // now we change internal data structure of ethBoards, thus .. must disable tx and rx
-    lockTXRX(true);
+    // now we change internal data structure of ethBoards, thus .. must disable tx and rx of the board. we also wait for the end
+    // of the current tx cycle because its frame may be queued for sending
+    eOipv4addr_t ipv4addr = rr->getProperties().ipv4addr;
+    lockTX(true);
+    ethBoards->lockTXRX(ipv4addr, true);
 
     // remove the interface
     ethBoards->rem(rr, type);
@@ -501,7 +836,8 @@ int TheEthManager::releaseResource2(eth::AbstractEthResource* ethresource, IethR
         ret = -1;
     }
 
-    lockTXRX(false);
+    ethBoards->lockTXRX(ipv4addr, false);
+    lockTX(false);
 
 
     return(ret);
@@ -510,6 +846,141 @@ int TheEthManager::releaseResource2(eth::AbstractEthResource* ethresource, IethR
 
 
 
+void TheEthManager::startBringUp(eth::AbstractEthResource *resource)
+{
+    eOipv4addr_t ipv4addr = resource->getProperties().ipv4addr;
+
+    std::lock_guard<std::mutex> lck(bringUpMtx);
+
+    if((0 == bringUpRunning) && (true == bringUpQueue.empty()))
+    {   // a new batch of boards begins
+        bringUpBatchStart = yarp::os::Time::now();
+    }
+
+    BringUpItem item = {resource, BringUpState::queued, 0.0, false};
+    bringUpItems[ipv4addr] = item;
+    bringUpQueue.push_back(ipv4addr);
+
+    // a further worker is created only if all the existing ones are busy
+    if((0 == bringUpIdleWorkers) && (bringUpThreads.size() < static_cast<size_t>(bringUpMaxWorkers)))
+    {
+        bringUpThreads.push_back(std::thread(&TheEthManager::runBringUp, this));
+    }
+
+    bringUpCond.notify_all();
+}
+
+
+void TheEthManager::runBringUp(void)
+{
+    std::unique_lock<std::mutex> lck(bringUpMtx);
+
+    for(;;)
+    {
+        bringUpIdleWorkers++;
+        bringUpCond.wait(lck, [this]{ return bringUpQuit || !bringUpQueue.empty(); });
+        bringUpIdleWorkers--;
+
+        if(true == bringUpQuit)
+        {
+            return;
+        }
+
+        eOipv4addr_t ipv4addr = bringUpQueue.front();
+        bringUpQueue.pop_front();
+        BringUpItem &item = bringUpItems[ipv4addr];
+        item.state = BringUpState::running;
+        bringUpRunning++;
+        eth::AbstractEthResource *resource = item.resource;
+
+        // the bring-up of the board waits for its replies, thus it is done w/out holding the lock
+        lck.unlock();
+        double t0 = yarp::os::Time::now();
+        bool ok = resource->bringUp();
+        double duration = yarp::os::Time::now() - t0;
+        lck.lock();
+
+        item.state = ok ? BringUpState::succeeded : BringUpState::failed;
+        item.duration = duration;
+        bringUpRunning--;
+
+        if((0 == bringUpRunning) && (true == bringUpQueue.empty()))
+        {   // the batch is over: i report about all its boards at once, so that the failures do not get lost among the other prints
+            int numofok = 0;
+            int numoffailed = 0;
+            for(auto &it : bringUpItems)
+            {
+                if((true == it.second.reported) || (BringUpState::queued == it.second.state) || (BringUpState::running == it.second.state))
+                {
+                    continue;
+                }
+                it.second.reported = true;
+                if(BringUpState::succeeded == it.second.state)
+                {
+                    numofok++;
+                }
+                else
+                {
+                    numoffailed++;
+                    yError() << "TheEthManager::runBringUp(): the bring-up of BOARD" << it.second.resource->getProperties().boardnameString << "with IP" << it.second.resource->getProperties().ipv4addrString << "has FAILED after" << it.second.duration << "seconds";
+                }
+            }
+
+            double elapsed = yarp::os::Time::now() - bringUpBatchStart;
+            if(0 == numoffailed)
+            {
+                yInfo() << "TheEthManager::runBringUp(): the bring-up of" << numofok << "boards has succeeded in" << elapsed << "seconds using up to" << bringUpThreads.size() << "workers";
+            }
+            else
+            {
+                yError() << "TheEthManager::runBringUp(): the bring-up of" << numoffailed << "boards out of" << numofok+numoffailed << "has FAILED. it took" << elapsed << "seconds using up to" << bringUpThreads.size() << "workers";
+            }
+        }
+
+        bringUpCond.notify_all();
+    }
+}
+
+
+bool TheEthManager::waitBringUp(eOipv4addr_t ipv4)
+{
+    std::unique_lock<std::mutex> lck(bringUpMtx);
+
+    std::map<eOipv4addr_t, BringUpItem>::iterator it = bringUpItems.find(ipv4);
+    if(it == bringUpItems.end())
+    {
+        return true;
+    }
+
+    bringUpCond.wait(lck, [it]{ return (BringUpState::succeeded == it->second.state) || (BringUpState::failed == it->second.state); });
+
+    return (BringUpState::succeeded == it->second.state);
+}
+
+
+void TheEthManager::stopBringUp(void)
+{
+    {
+        std::lock_guard<std::mutex> lck(bringUpMtx);
+        bringUpQuit = true;
+        for(eOipv4addr_t ipv4addr : bringUpQueue)
+        {
+            bringUpItems[ipv4addr].state = BringUpState::failed;
+        }
+        bringUpQueue.clear();
+        bringUpCond.notify_all();
+    }
+
+    // a worker in the middle of a bring-up ends it before quitting
+    for(std::thread &t : bringUpThreads)
+    {
+        t.join();
+    }
+    bringUpThreads.clear();
+    bringUpItems.clear();
+}
+
+
 const eOipv4addressing_t& TheEthManager::getLocalIPV4addressing(void)
 {
     return(ipv4local);
@@ -531,24 +1002,95 @@ double TheEthManager::getLifeTime(void)
 
 
 
-bool TheEthManager::createCommunicationObjects(const eOipv4addressing_t &localaddress, int txrate, int rxrate)
+ACE_SOCK_Dgram* TheEthManager::openSharedSocket(const ACE_INET_Addr &inetaddr)
+{
+#if defined(__linux__)
+    // the sockets of a SO_REUSEPORT group are bound to the same address. the kernel delivers the packets coming from a given
+    // sender always to the same socket of the group, thus all the packets of a board are received by the same shard
+    ACE_HANDLE sockfd = ACE_OS::socket(AF_INET, SOCK_DGRAM, 0);
+    if(ACE_INVALID_HANDLE == sockfd)
+    {
+        return NULL;
+    }
+
+    int one = 1;
+    if((0 != ACE_OS::setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT, (char *)&one, sizeof(one))) ||
+       (0 != ACE_OS::bind(sockfd, reinterpret_cast<struct sockaddr*>(inetaddr.get_addr()), inetaddr.get_size())))
+    {
+        ACE_OS::closesocket(sockfd);
+        return NULL;
+    }
+
+    ACE_SOCK_Dgram *socket = new ACE_SOCK_Dgram();
+    socket->set_handle(sockfd);
+    return socket;
+#else
+    return NULL;
+#endif
+}
+
+
+bool TheEthManager::createCommunicationObjects(const eOipv4addressing_t &localaddress, int txrate, int rxrate, bool rxevent, int rxcore, int rxshards)
 {
     lock(true);
 
     ACE_INET_Addr inetaddr = toaceinet(localaddress);
 
+#if !defined(__linux__)
+    if(rxshards > 1)
+    {
+        yWarning() << "TheEthManager::createCommunicationObjects(): the reception cannot be sharded on this platform, thus using a single receiver";
+        rxshards = 1;
+    }
+#endif
+    if((rxshards < 1) || (false == embBoardsConnected))
+    {
+        rxshards = 1;
+    }
+
     if(!communicationIsInitted)
     {
-        UDP_socket = new ACE_SOCK_Dgram();
-        if((embBoardsConnected)  && (-1 == UDP_socket->open(inetaddr)))
+        bool opened = true;
+        if(rxshards > 1)
+        {   // the first socket of the group is also used for transmission
+            UDP_socket = openSharedSocket(inetaddr);
+            opened = (NULL != UDP_socket);
+            for(int i=1; (i<rxshards) && opened; i++)
+            {
+                ACE_SOCK_Dgram *socket = openSharedSocket(inetaddr);
+                if(NULL == socket)
+                {
+                    opened = false;
+                    break;
+                }
+                RX_sockets.push_back(socket);
+            }
+        }
+        else
+        {
+            UDP_socket = new ACE_SOCK_Dgram();
+            opened = (false == embBoardsConnected) || (-1 != UDP_socket->open(inetaddr));
+        }
+
+        if(false == opened)
         {
             char tmp[64] = {0};
             inetaddr.addr_to_string(tmp, 64);
             yError() <<   "\n/--------------------------------------------------------------------------------------------------------------\\"
                      <<   "\n| TheEthManager::createCommunicationObjects() is unable to bind to local IP address " << tmp
                      <<   "\n\\--------------------------------------------------------------------------------------------------------------/";
-            delete UDP_socket;
+            if(NULL != UDP_socket)
+            {
+                UDP_socket->close();
+                delete UDP_socket;
+            }
             UDP_socket = NULL;
+            for(ACE_SOCK_Dgram *socket : RX_sockets)
+            {
+                socket->close();
+                delete socket;
+            }
+            RX_sockets.clear();
             communicationIsInitted = false;
         }
         else
@@ -565,10 +1107,21 @@ bool TheEthManager::createCommunicationObjects(const eOipv4addressing_t &localad
                 rxrate = EthReceiver::EthReceiverDefaultRate;
             }
             sender = new eth::EthSender(txrate);
-            receiver = new eth::EthReceiver(rxrate);
-
             sender->config(UDP_socket, this);
-            receiver->config(UDP_socket, this);
+
+            // one receiver per shard, each one with its own socket and core. only the first one checks the presence of the boards
+            for(int i=0; i<rxshards; i++)
+            {
+                int core = (rxcore >= 0) ? (rxcore + i) : -1;
+                eth::EthReceiver *receiver = new eth::EthReceiver(rxrate, rxevent ? EthReceiver::Mode::event : EthReceiver::Mode::periodic, core, (0 == i));
+                receiver->config((0 == i) ? UDP_socket : RX_sockets[i-1], this);
+                receivers.push_back(receiver);
+            }
+
+            if(rxshards > 1)
+            {
+                yDebug() << "TheEthManager::createCommunicationObjects(): the reception is sharded across" << rxshards << "receivers";
+            }
 
             /* Start the threads sending to and receiving messages from the boards.
              * It will execute the threadInit and pass its return value to the following calls
@@ -576,7 +1129,11 @@ bool TheEthManager::createCommunicationObjects(const eOipv4addressing_t &localad
              */
             bool ret1, ret2;
             ret1 = sender->start();
-            ret2 = receiver->start();
+            ret2 = true;
+            for(eth::EthReceiver *receiver : receivers)
+            {
+                ret2 = ret2 && receiver->start();
+            }
 
             if(!ret1 || !ret2)
             {
@@ -587,6 +1144,7 @@ bool TheEthManager::createCommunicationObjects(const eOipv4addressing_t &localad
 
                 delete UDP_socket;
                 communicationIsInitted = false;
+                lock(false);
                 return false;
             }
             else
@@ -622,9 +1180,12 @@ bool TheEthManager::stopCommunicationThreads()
     {
         sender->stop();
     }
-    if(receiver->isRunning())
+    for(eth::EthReceiver *receiver : receivers)
     {
-        receiver->stop();
+        if(receiver->isRunning())
+        {
+            receiver->stop();
+        }
     }
     return ret;
 }
@@ -661,9 +1222,19 @@ ACE_INET_Addr TheEthManager::toaceinet(const eOipv4addressing_t &ipv4addressing)
 }
 
 
-bool TheEthManager::Reception(eOipv4addr_t from, uint64_t* data, ssize_t size)
+bool TheEthManager::Reception(eOipv4addr_t from, uint64_t* data, ssize_t size, uint64_t rxtimestamp)
 {
-    lockRX(true);
+    // the frame is recorded as it is, even if it comes from an unknown board
+    if((true == capture.isopen()) && (size > 0))
+    {
+        capture.record(from, data, size, rxtimestamp);
+    }
+
+    // we lock only the board which has sent the packet
+    if(false == ethBoards->lockRX(from, true))
+    {
+        return(true);
+    }
 
     eth::AbstractEthResource* r = ethBoards->get_resource(from);
 
@@ -671,10 +1242,36 @@ bool TheEthManager::Reception(eOipv4addr_t from, uint64_t* data, ssize_t size)
     {
         r->Tick();
 
+        const bool measure = rxstats.isenabled();
+        uint64_t arrival = 0;
+        std::chrono::steady_clock::time_point start;
+        if(true == measure)
+        {
+            arrival = (0 != rxtimestamp) ? rxtimestamp : eth::EthCapture::now();
+            start = std::chrono::steady_clock::now();
+        }
+
+        // the ageofframe of the header of the ropframe: startofframe (4 bytes), ropssizeof (2), ropsnumberof (2), ageofframe (8)
+        uint64_t boardtime = 0;
+        if(size >= 16)
+        {
+            memcpy(&boardtime, reinterpret_cast<const uint8_t*>(data) + 8, sizeof(boardtime));
+        }
+
+        // all the update() called while parsing the frame get the same timestamp, the time at which the board has built the
+        // frame as estimated by its BoardClock, then the devices get onFrameParsed()
+        ethBoards->rx_begin(from, yarp::os::Time::now(), boardtime);
         if(false == r->processRXpacket(data, size))
         {   // cannot give packet to ethresource
             yError() << "TheEthManager::Reception() cannot give a received packet of size" << size << "to EthResource because EthResource::processRXpacket() returns false.";
         }
+        ethBoards->rx_end(from);
+
+        if(true == measure)
+        {
+            uint64_t parsing = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            rxstats.update(from, data, size, arrival, parsing);
+        }
 
     }
     else
@@ -683,7 +1280,7 @@ bool TheEthManager::Reception(eOipv4addr_t from, uint64_t* data, ssize_t size)
     //    yError() << "TheEthManager::Reception cannot get a ethres associated to address" << address;
     }
 
-    lockRX(false);
+    ethBoards->lockRX(from, false);
 
 
     return(true);
@@ -691,6 +1288,12 @@ bool TheEthManager::Reception(eOipv4addr_t from, uint64_t* data, ssize_t size)
 
 
 
+bool TheEthManager::needsRXtimestamps(void) const
+{
+    return (capture.isopen() || rxstats.isenabled());
+}
+
+
 int TheEthManager::getNumberOfResources(void)
 {
     return(ethBoards->number_of_resources());
@@ -739,37 +1342,6 @@ bool TheEthManager::lockTX(bool on)
 }
 
 
-bool TheEthManager::lockRX(bool on)
-{
-    if(on)
-    {
-        rxSem.lock();
-    }
-    else
-    {
-        rxSem.unlock();
-    }
-
-    return true;
-}
-
-bool TheEthManager::lockTXRX(bool on)
-{
-    if(on)
-    {
-        txSem.lock();
-        rxSem.lock();
-    }
-    else
-    {
-        rxSem.unlock();
-        txSem.unlock();
-    }
-
-    return true;
-}
-
-
 // - end-of-file (leave a blank line after)----------------------------------------------------------------------------
 
 
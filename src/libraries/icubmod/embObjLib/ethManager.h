@@ -30,6 +30,10 @@
 #include <string>
 #include <stdio.h>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <map>
 //#include <map>
 
 
@@ -46,6 +50,7 @@
 #include <yarp/os/Bottle.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/Port.h>
+#include <yarp/os/PortReader.h>
 
 // embobjlib includes
 #include "hostTransceiver.hpp"
@@ -70,6 +75,15 @@ using namespace std;
 #include <ethBoards.h>
 #include <ethSender.h>
 #include <ethReceiver.h>
+#include <ethCapture.h>
+#include <ethStatistics.h>
+
+// on linux the frames of a tx cycle are sent all together with sendmmsg(), elsewhere one sendto() per frame is used
+#if defined(__linux__)
+#define ETHMANAGER_USE_SENDMMSG
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
 
 
 // -- class TheEthManager
@@ -89,9 +103,21 @@ namespace eth {
 
         enum { maxRXpacketsize = 1496, maxTXpacketsize = 1496 };
 
-        // these are the boards, their use is protected by txSem or rxSem or both of them.
+        // these are the boards, their use is protected by their own tx and rx locks and by txSem for the removal of a board.
         eth::EthBoards* ethBoards;
 
+        // timing of the tx cycles executed by Transmission()
+        struct TXstatistics
+        {
+            unsigned long cycles;   // number of tx cycles
+            unsigned long frames;   // number of frames sent
+            unsigned long errors;   // number of frames which could not be sent
+            double durationMin;     // min duration of a cycle [sec]
+            double durationMax;     // max duration of a cycle [sec]
+            double durationSum;     // sum of the durations of the cycles [sec]
+            void reset() { cycles = frames = errors = 0; durationMin = durationMax = durationSum = 0.0; }
+        };
+
     private:
 
         // singletons have private constructor / destructor
@@ -123,7 +149,13 @@ namespace eth {
 
         bool CheckPresence(void);
 
-        bool Reception(eOipv4addr_t from, uint64_t* data, ssize_t size);
+        // rxtimestamp is the time of reception in ns since the epoch (e.g., from SO_TIMESTAMPNS). it is used only by the capture
+        // and it can be 0, in which case the capture takes the current time
+        bool Reception(eOipv4addr_t from, uint64_t* data, ssize_t size, uint64_t rxtimestamp = 0);
+
+        // it tells if the receivers must ask the kernel for the time of reception of the packets: it is used by the capture
+        // (PC104CaptureFile) and by the rx statistics
+        bool needsRXtimestamps(void) const;
 
         eth::AbstractEthResource* getEthResource(eOipv4addr_t ipv4);
 
@@ -135,6 +167,29 @@ namespace eth {
 
         int sendPacket(const void *udpframe, size_t len, const eOipv4addressing_t &toaddressing);
 
+        // it is used by Transmission() for the frames of the boards: on linux the frame is queued and it is sent together with the others
+        // at the end of the tx cycle, thus the frame must stay valid until then. elsewhere it is the same as sendPacket().
+        void queuePacket(const void *udpframe, size_t len, const eOipv4addressing_t &toaddressing);
+
+        // it gets the statistics of the tx cycles since the last reset.
+        void getTXstatistics(TXstatistics &stats, bool reset);
+
+        // it gets the statistics of the tx cycles and of the reception of every board since the last reset, in the format given
+        // by the rpc port PC104StatisticsPort: (tx (cycles n) (frames n) (errors n) (duration min mean max)) (boards ((name s) (ip s) ...) ...)
+        void getStatistics(yarp::os::Bottle &stats, bool reset);
+
+        // it collects the rx statistics even without PC104StatisticsPort or ETHSTAT_PRINT_INTERVAL. it must be called before the
+        // communication is initialised, because only then the receivers decide whether to ask the kernel for the timestamps
+        void enableRXstatistics(bool on);
+
+        // it gets the rx statistics of a board since the last reset, and optionally resets them. false if the board has sent nothing
+        bool getRXstatistics(eOipv4addr_t ipv4, eth::EthRXstatistics::Board &board, bool reset);
+
+        // if the boards are brought up concurrently (PC104BringUpWorkers > 0), it waits for the end of the bring-up of the board:
+        // presence, transceiver, cleaning of its behaviour, timing and version. it returns false if the bring-up has failed.
+        // it returns true if the board was not brought up concurrently, because then the caller verifies it directly.
+        bool waitBringUp(eOipv4addr_t ipv4);
+
         eOipv4addr_t toipv4addr(const ACE_INET_Addr &aceinetaddr);
 
         ACE_INET_Addr toaceinet(const eOipv4addressing_t &ipv4addressing);
@@ -144,17 +199,25 @@ namespace eth {
 
         bool isCommunicationInitted(void);
 
-        bool createCommunicationObjects(const eOipv4addressing_t &localaddress, int txrate, int rxrate);
+        bool createCommunicationObjects(const eOipv4addressing_t &localaddress, int txrate, int rxrate, bool rxevent, int rxcore, int rxshards);
+
+        ACE_SOCK_Dgram* openSharedSocket(const ACE_INET_Addr &inetaddr);
 
         bool initCommunication(yarp::os::Searchable &cfgtotal);
 
         bool stopCommunicationThreads(void);
 
+        void startBringUp(eth::AbstractEthResource *resource);
+
+        void runBringUp(void);
+
+        void stopBringUp(void);
+
+        void flushPackets(void);
+
         bool lock(bool on);
 
         bool lockTX(bool on);
-        bool lockRX(bool on);
-        bool lockTXRX(bool on);
 
 
     private:
@@ -163,9 +226,8 @@ namespace eth {
 
         // this semaphore is used to ....
         static std::mutex managerSem;
-        // the following two semaphore are used separately or together to stop tx and rx if a change is done on ethboards (in startup and shutdown phases)
+        // this semaphore protects the tx cycle (its queue of frames and statistics). the boards are protected by their own locks inside ethBoards
         static std::mutex txSem;
-        static std::mutex rxSem;
 
         static eth::TheEthManager* handle;
 
@@ -176,12 +238,66 @@ namespace eth {
 
         bool communicationIsInitted;
 
-        // periodic threads which use methods of class TheEthManager to transmit / receive + the udp socket
+        // periodic threads which use methods of class TheEthManager to transmit / receive + the udp socket.
+        // the reception can be sharded across several receivers: the first one uses UDP_socket and the others the RX_sockets
         eth::EthSender* sender;
-        eth::EthReceiver* receiver;
+        std::vector<eth::EthReceiver*> receivers;
         ACE_SOCK_Dgram* UDP_socket;
+        std::vector<ACE_SOCK_Dgram*> RX_sockets;
         bool embBoardsConnected;
 
+        // the optional recording of the received frames. it is lock-free, thus it is used by all the receivers without protection
+        eth::EthCapture capture;
+
+        // the frames queued in a tx cycle, at most one per board. their use is protected by txSem
+#if defined(ETHMANAGER_USE_SENDMMSG)
+        int txqueuesize;
+        struct mmsghdr txmessages[maxBoards];
+        struct iovec txiovectors[maxBoards];
+        struct sockaddr_in txaddresses[maxBoards];
+#endif
+
+        // the statistics of the tx cycles, protected by txSem. they are printed every txstatPrintInterval sec if it is positive.
+        TXstatistics txstats;
+        TXstatistics txstatsPrint;
+        double txstatPrintInterval;
+        double txstatLastPrint;
+
+        // the statistics of reception of the boards. they are enabled by ETHSTAT_PRINT_INTERVAL, which also prints them
+        // every txstatPrintInterval sec, or by PC104StatisticsPort, the rpc port which replies to "get" and "reset"
+        class StatisticsReader : public yarp::os::PortReader
+        {
+        public:
+            TheEthManager *owner {nullptr};
+            bool read(yarp::os::ConnectionReader &connection) override;
+        };
+        eth::EthRXstatistics rxstats;
+        double rxstatLastPrint;
+        yarp::os::Port statisticsPort;
+        StatisticsReader statisticsReader;
+
+        // the concurrent bring-up of the boards. the queued boards are served by at most bringUpMaxWorkers threads, created
+        // when needed. when the queue empties, a single report about all the boards brought up since the former one is printed.
+        // everything is protected by bringUpMtx
+        enum class BringUpState { queued, running, succeeded, failed };
+        struct BringUpItem
+        {
+            eth::AbstractEthResource *resource;
+            BringUpState state;
+            double duration;
+            bool reported;
+        };
+        std::mutex bringUpMtx;
+        std::condition_variable bringUpCond;
+        std::deque<eOipv4addr_t> bringUpQueue;
+        std::map<eOipv4addr_t, BringUpItem> bringUpItems;
+        std::vector<std::thread> bringUpThreads;
+        int bringUpMaxWorkers;
+        int bringUpIdleWorkers;
+        int bringUpRunning;
+        bool bringUpQuit;
+        double bringUpBatchStart;
+
     };
 
 } // namespace eth
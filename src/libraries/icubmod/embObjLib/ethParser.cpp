@@ -62,6 +62,18 @@ bool eth::parser::print(const pc104Data &pc104data)
     yDebug() << "PC104/PC104IpAddress:PC104IpPort = " << pc104data.addressingstring;
     yDebug() << "PC104/PC104TXrate = " << pc104data.txrate;
     yDebug() << "PC104/PC104RXrate = " << pc104data.rxrate;
+    yDebug() << "PC104/PC104RXmode = " << (pc104data.rxevent ? "event" : "periodic");
+    yDebug() << "PC104/PC104RXcore = " << pc104data.rxcore;
+    yDebug() << "PC104/PC104RXshards = " << pc104data.rxshards;
+    yDebug() << "PC104/PC104BringUpWorkers = " << pc104data.bringupworkers;
+    yDebug() << "PC104/PC104CaptureFile = " << (pc104data.capturefile.empty() ? "none" : pc104data.capturefile);
+    yDebug() << "PC104/PC104CaptureFrames = " << pc104data.captureframes;
+    yDebug() << "PC104/PC104StatisticsPort = " << (pc104data.statisticsport.empty() ? "none" : pc104data.statisticsport);
+    if(!pc104data.embBoardsConnected)
+    {
+        yDebug() << "DEBUG/replayFile = " << (pc104data.replayfile.empty() ? "none" : pc104data.replayfile);
+        yDebug() << "DEBUG/replaySpeed = " << pc104data.replayspeed;
+    }
 
     return true;
 }
@@ -104,6 +116,21 @@ bool eth::parser::read(yarp::os::Searchable &cfgtotal, pc104Data &pc104data)
         yError() << "ATTENTION: NO EMBEDDED BOARDS CONNECTED. YOU ARE IN DEBUG MODE";
     }
 
+    // replayFile: in debug mode the fake boards can replay the frames recorded with PC104CaptureFile. replaySpeed scales their
+    // original timing (1.0 is real time). 0 replays them as fast as possible
+    if ((! groupDEBUG.isNull()) && (groupDEBUG.check("replayFile")))
+    {
+        pc104data.replayfile = groupDEBUG.find("replayFile").asString();
+    }
+    if ((! groupDEBUG.isNull()) && (groupDEBUG.check("replaySpeed")))
+    {
+        double value = groupDEBUG.find("replaySpeed").asFloat64();
+        if(value >= 0)
+        {
+            pc104data.replayspeed = value;
+        }
+    }
+
     // localaddress
 
     Bottle groupPC104  = Bottle(cfgtotal.findGroup("PC104"));
@@ -173,6 +200,66 @@ bool eth::parser::read(yarp::os::Searchable &cfgtotal, pc104Data &pc104data)
         yWarning () << "eth::parser::read() cannot find ETH/PC104RXrate. thus using default value" << pc104data.rxrate;
     }
 
+    // rxmode: periodic (default) or event
+    if(cfgtotal.findGroup("PC104").check("PC104RXmode"))
+    {
+        std::string value = cfgtotal.findGroup("PC104").find("PC104RXmode").asString();
+        if(value == "event")
+        {
+            pc104data.rxevent = true;
+        }
+        else if(value != "periodic")
+        {
+            yWarning () << "eth::parser::read() has found an unknown ETH/PC104RXmode" << value << "thus using periodic";
+        }
+    }
+
+    // rxcore
+    if(cfgtotal.findGroup("PC104").check("PC104RXcore"))
+    {
+        pc104data.rxcore = cfgtotal.findGroup("PC104").find("PC104RXcore").asInt32();
+    }
+
+    // rxshards: the number of receivers the boards are distributed across
+    if(cfgtotal.findGroup("PC104").check("PC104RXshards"))
+    {
+        int value = cfgtotal.findGroup("PC104").find("PC104RXshards").asInt32();
+        if(value > 0)
+        {
+            pc104data.rxshards = value;
+        }
+    }
+
+    // bringupworkers: if positive, the boards are brought up concurrently by up to so many threads. 0 keeps the serial bring-up
+    if(cfgtotal.findGroup("PC104").check("PC104BringUpWorkers"))
+    {
+        int value = cfgtotal.findGroup("PC104").find("PC104BringUpWorkers").asInt32();
+        if(value >= 0)
+        {
+            pc104data.bringupworkers = value;
+        }
+    }
+
+    // capturefile: if present, the received frames are recorded into this memory-mapped file. it keeps the latest captureframes of them
+    if(cfgtotal.findGroup("PC104").check("PC104CaptureFile"))
+    {
+        pc104data.capturefile = cfgtotal.findGroup("PC104").find("PC104CaptureFile").asString();
+    }
+    if(cfgtotal.findGroup("PC104").check("PC104CaptureFrames"))
+    {
+        int value = cfgtotal.findGroup("PC104").find("PC104CaptureFrames").asInt32();
+        if(value > 0)
+        {
+            pc104data.captureframes = value;
+        }
+    }
+
+    // statisticsport: if present, the statistics of tx and of the reception of every board are collected and given by this rpc port
+    if(cfgtotal.findGroup("PC104").check("PC104StatisticsPort"))
+    {
+        pc104data.statisticsport = cfgtotal.findGroup("PC104").find("PC104StatisticsPort").asString();
+    }
+
     // now i print all the found values
 
     //print(pc104data);
@@ -100,17 +100,28 @@ namespace eth { namespace parser {
         eOipv4addressing_t localaddressing;
         std::uint16_t  txrate;
         std::uint16_t rxrate;
+        bool rxevent;
+        int rxcore;
+        int rxshards;
+        int bringupworkers;
+        std::string capturefile;
+        int captureframes;
+        std::string replayfile;
+        double replayspeed;
+        std::string statisticsport;
         std::string addressingstring;
         void reset() {
             embBoardsConnected = true;
             localaddressing.addr = eo_common_ipv4addr(10, 0, 1, 104); localaddressing.port = 12345;
-            txrate = 1; rxrate = 5;
+            txrate = 1; rxrate = 5; rxevent = false; rxcore = -1; rxshards = 1; bringupworkers = 0;
+            capturefile = ""; captureframes = 65536; replayfile = ""; replayspeed = 1.0; statisticsport = "";
             addressingstring = "10.0.1.104:12345";
         }
         void setdefault() {
             embBoardsConnected = true;
             localaddressing.addr = eo_common_ipv4addr(10, 0, 1, 104); localaddressing.port = 12345;
-            txrate = 1; rxrate = 5;
+            txrate = 1; rxrate = 5; rxevent = false; rxcore = -1; rxshards = 1; bringupworkers = 0;
+            capturefile = ""; captureframes = 65536; replayfile = ""; replayspeed = 1.0; statisticsport = "";
             addressingstring = "10.0.1.104:12345";
         }
     };
@@ -32,11 +32,23 @@
 // - external dependencies
 // --------------------------------------------------------------------------------------------------------------------
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if defined(ETHRECEIVER_USE_EVENTS)
+#include <poll.h>
+#endif
+#if defined(__unix__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
 #include <yarp/os/Network.h>
 #include <yarp/os/NetType.h>
 #include <yarp/conf/environment.h>
 
-//#include <yarp/os/SystemClock.h>
+#include <yarp/os/SystemClock.h>
 #include <yarp/os/Log.h>
 #include <yarp/os/LogStream.h>
 using yarp::os::Log;
@@ -62,10 +74,63 @@ using namespace eth;
 
 
 
-EthReceiver::EthReceiver(int raterx): PeriodicThread((double)raterx/1000.0)
+#if defined(ETHRECEIVER_USE_RECVMMSG)
+// the control buffer of each message can accomodate one timestamp. it is counted in uint64_t so that it stays aligned
+static const size_t rxControlStride = (CMSG_SPACE(sizeof(struct timespec))+7)/8;
+#endif
+
+
+static void makeRealTime(int core)
+{
+#if defined(__unix__)
+    /**
+     * Make it realtime (works on both RT and Standard linux kernels)
+     * - increase the priority upto the system IRQ's priorities (< 50)
+     * - set the scheduler to FIFO
+     */
+    struct sched_param thread_param;
+    thread_param.sched_priority = sched_get_priority_max(SCHED_FIFO)/2; // = 49
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &thread_param);
+#endif
+
+#if defined(ETHRECEIVER_USE_EVENTS)
+    if(core >= 0)
+    {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(core, &cpuset);
+        if(0 != pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset))
+        {
+            yWarning() << "EthReceiver cannot pin the thread to cpu core" << core;
+        }
+    }
+#endif
+}
+
+
+EthReceiver::EthReceiver(int raterx, Mode rxmode, int rxcore, bool rxhousekeeping): PeriodicThread((double)raterx/1000.0)
 {
     rateofthread = raterx;
-    yDebug() << "EthReceiver is a PeriodicThread with rxrate =" << rateofthread << "ms";
+    mode = rxmode;
+    core = rxcore;
+    housekeeping = rxhousekeeping;
+#if defined(ETHRECEIVER_USE_RECVMMSG)
+    useBatched = false;
+    useTimestamps = false;
+#endif
+#if defined(ETHRECEIVER_USE_EVENTS)
+    eventThread = nullptr;
+#else
+    if(Mode::event == mode)
+    {
+        yWarning() << "EthReceiver: the event mode is not available on this platform, thus using the periodic mode";
+        mode = Mode::periodic;
+    }
+#endif
+    if(Mode::event == mode)
+        yDebug() << "EthReceiver receives packets as they arrive and it is a PeriodicThread with rxrate =" << rateofthread << "ms for the check on presence";
+    else
+        yDebug() << "EthReceiver is a PeriodicThread with rxrate =" << rateofthread << "ms";
     // ok, and now i get it from xml file ... if i find it.
 
 //    std::string tmp = yarp::conf::environment::get_string("ETHSTAT_PRINT_INTERVAL");
@@ -132,6 +197,47 @@ bool EthReceiver::config(ACE_SOCK_Dgram *pSocket, TheEthManager* _ethManager)
 
     yWarning() << "in EthReceiver::config() the config socket has queue size = "<< sock_input_buf_size<< "; you request ETHRECEIVER_BUFFER_SIZE=" << _dgram_buffer_size;
 
+#if defined(ETHRECEIVER_USE_RECVMMSG)
+    // the buffers are allocated once in here: each of them is 8-byte aligned and can accomodate the max size of packet
+    const size_t stride = TheEthManager::maxRXpacketsize/8;
+    rxBuffers.assign(rxBatchSize*stride, 0);
+    rxMessages.assign(rxBatchSize, mmsghdr());
+    rxIOvectors.resize(rxBatchSize);
+    rxSenders.resize(rxBatchSize);
+    for(int i=0; i<rxBatchSize; i++)
+    {
+        rxIOvectors[i].iov_base = &rxBuffers[i*stride];
+        rxIOvectors[i].iov_len = TheEthManager::maxRXpacketsize;
+        rxMessages[i].msg_hdr.msg_iov = &rxIOvectors[i];
+        rxMessages[i].msg_hdr.msg_iovlen = 1;
+        rxMessages[i].msg_hdr.msg_name = &rxSenders[i];
+    }
+    useBatched = true;
+
+    // the kernel timestamps cost a little for every packet, thus we ask for them only if the frames are captured or the statistics
+    // of reception are collected
+    useTimestamps = false;
+#if defined(SO_TIMESTAMPNS)
+    if(true == ethManager->needsRXtimestamps())
+    {
+        int enable = 1;
+        if(0 == ACE_OS::setsockopt(sockfd, SOL_SOCKET, SO_TIMESTAMPNS, (char *)&enable, sizeof(enable)))
+        {
+            rxControls.assign(rxBatchSize*rxControlStride, 0);
+            for(int i=0; i<rxBatchSize; i++)
+            {
+                rxMessages[i].msg_hdr.msg_control = &rxControls[i*rxControlStride];
+            }
+            useTimestamps = true;
+        }
+        else
+        {
+            yWarning() << "EthReceiver::config() cannot enable SO_TIMESTAMPNS, thus the frames have the time of their parsing";
+        }
+    }
+#endif
+#endif
+
     return true;
 }
 
@@ -140,21 +246,74 @@ bool EthReceiver::threadInit()
 {
     yTrace() << "Do some initialization here if needed";
 
-#if defined(__unix__)
-    /**
-     * Make it realtime (works on both RT and Standard linux kernels)
-     * - increase the priority upto the system IRQ's priorities (< 50)
-     * - set the scheduler to FIFO
-     */
-    struct sched_param thread_param;
-    thread_param.sched_priority = sched_get_priority_max(SCHED_FIFO)/2; // = 49
-    pthread_setschedparam(pthread_self(), SCHED_FIFO, &thread_param);
+    // in event mode the core is reserved to the reception
+    makeRealTime((Mode::event == mode) ? -1 : core);
+
+#if defined(ETHRECEIVER_USE_EVENTS)
+    if(Mode::event == mode)
+    {
+        eventThread = new EventThread(this);
+        if(false == eventThread->start())
+        {
+            yError() << "EthReceiver::threadInit() cannot start the thread of the event mode";
+            delete eventThread;
+            eventThread = nullptr;
+            return false;
+        }
+    }
+#endif
+
+    return true;
+}
+
+
+void EthReceiver::threadRelease()
+{
+#if defined(ETHRECEIVER_USE_EVENTS)
+    if(nullptr != eventThread)
+    {
+        eventThread->stop();
+        delete eventThread;
+        eventThread = nullptr;
+    }
 #endif
+}
 
+
+#if defined(ETHRECEIVER_USE_EVENTS)
+bool EthReceiver::EventThread::threadInit()
+{
+    makeRealTime(owner->core);
     return true;
 }
 
 
+void EthReceiver::EventThread::run()
+{
+    struct pollfd pfd;
+    pfd.fd = owner->recv_socket->get_handle();
+    pfd.events = POLLIN;
+
+    while(!isStopping())
+    {
+        // the timeout lets the thread see the stop request also if no packet arrives
+        pfd.revents = 0;
+        int r = poll(&pfd, 1, 100);
+        if((r > 0) && (pfd.revents & POLLIN))
+        {
+            // we get at most one batch, then we poll again: the packets still in the socket wake us up immediately
+            owner->receive(EthReceiver::rxBatchSize);
+        }
+        else if((r < 0) && (errno != EINTR))
+        {
+            yError() << "EthReceiver: poll() on the socket fails with errno" << errno;
+            yarp::os::SystemClock::delaySystem(0.001);
+        }
+    }
+}
+#endif
+
+
 uint64_t getRopFrameAge(char *pck)
 {
     return(eo_ropframedata_age_Get((EOropframeData*)pck));
@@ -162,23 +321,132 @@ uint64_t getRopFrameAge(char *pck)
 
 
 
-void EthReceiver::run()
+int EthReceiver::receiveSingle(int maxUDPpackets)
 {
     ssize_t       incoming_msg_size = 0;
     ACE_INET_Addr sender_addr;
     uint64_t      incoming_msg_data[TheEthManager::maxRXpacketsize/8];   // 8-byte aligned local buffer for incoming packet: it must be able to accomodate max size of packet
     const ssize_t incoming_msg_capacity = TheEthManager::maxRXpacketsize;
 
-#ifdef NETWORK_PERFORMANCE_BENCHMARK
-    m_perEvtVerifier.tick(yarp::os::Time::now());
-#endif
-    
-    
     int flags = 0;
 #ifndef WIN32
     flags |= MSG_DONTWAIT;
 #endif
 
+    int i = 0;
+    for(i=0; i<maxUDPpackets; i++)
+    {
+        incoming_msg_size = recv_socket->recv((void *) incoming_msg_data, incoming_msg_capacity, sender_addr, flags);
+        if(incoming_msg_size <= 0)
+        { // marco.accame: i prefer using <= 0.
+            break;
+        }
+
+        // we have a packet ... we give it to the ethmanager for it parsing
+        //bool collectStatistics = (statPrintInterval > 0) ? true : false;
+        ethManager->Reception(ethManager->toipv4addr(sender_addr), incoming_msg_data, incoming_msg_size);
+    }
+
+    return i;
+}
+
+
+#if defined(ETHRECEIVER_USE_RECVMMSG)
+// it gets the time of reception given by the kernel with SO_TIMESTAMPNS, in ns since the epoch. it returns 0 if it is not there
+static uint64_t kernelTimestamp(struct msghdr &hdr)
+{
+#if defined(SO_TIMESTAMPNS)
+    for(struct cmsghdr *cmsg = CMSG_FIRSTHDR(&hdr); NULL != cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg))
+    {
+        if((SOL_SOCKET == cmsg->cmsg_level) && (SCM_TIMESTAMPNS == cmsg->cmsg_type))
+        {
+            struct timespec ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+            return static_cast<uint64_t>(ts.tv_sec)*1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+        }
+    }
+#endif
+    return 0;
+}
+
+
+int EthReceiver::receiveBatched(int maxUDPpackets)
+{
+    const size_t stride = TheEthManager::maxRXpacketsize/8;
+    int received = 0;
+
+    while(received < maxUDPpackets)
+    {
+        unsigned int n = std::min(maxUDPpackets-received, static_cast<int>(rxBatchSize));
+        for(unsigned int i=0; i<n; i++)
+        {
+            // the kernel overwrites the length of the sender address, hence we restore it at every call
+            rxMessages[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+            // and so it does with the length of the control buffer
+            rxMessages[i].msg_hdr.msg_controllen = useTimestamps ? rxControlStride*sizeof(uint64_t) : 0;
+        }
+
+        int r = recvmmsg(recv_socket->get_handle(), rxMessages.data(), n, MSG_DONTWAIT, nullptr);
+        if(r <= 0)
+        {
+            if((r < 0) && (errno == ENOSYS))
+            {   // the kernel does not support recvmmsg(): we use the single receive from now on
+                yWarning() << "EthReceiver: recvmmsg() is not available, using one recv() per packet";
+                useBatched = false;
+                received += receiveSingle(maxUDPpackets-received);
+            }
+            break; // the socket is empty
+        }
+
+        for(int i=0; i<r; i++)
+        {
+            if(rxMessages[i].msg_len == 0)
+            {
+                continue;
+            }
+
+            ACE_INET_Addr sender_addr(&rxSenders[i], sizeof(struct sockaddr_in));
+            uint64_t rxtimestamp = useTimestamps ? kernelTimestamp(rxMessages[i].msg_hdr) : 0;
+            ethManager->Reception(ethManager->toipv4addr(sender_addr), &rxBuffers[i*stride], rxMessages[i].msg_len, rxtimestamp);
+        }
+
+        received += r;
+        if(static_cast<unsigned int>(r) < n)
+        {
+            break; // the socket has been drained
+        }
+    }
+
+    return received;
+}
+#endif
+
+
+int EthReceiver::receive(int maxUDPpackets)
+{
+#if defined(ETHRECEIVER_USE_RECVMMSG)
+    if(useBatched)
+        return receiveBatched(maxUDPpackets);
+#endif
+    return receiveSingle(maxUDPpackets);
+}
+
+
+void EthReceiver::run()
+{
+#ifdef NETWORK_PERFORMANCE_BENCHMARK
+    m_perEvtVerifier.tick(yarp::os::Time::now());
+#endif
+    
+    if(Mode::event == mode)
+    {   // the packets are received by the event thread: we are just the timer of the housekeeping
+        if(housekeeping)
+        {
+            ethManager->CheckPresence();
+        }
+        return;
+    }
+    
     static uint8_t earlyexit_prev = 0;
     static uint8_t earlyexit_prevprev = 0;
 
@@ -195,22 +463,18 @@ void EthReceiver::run()
     earlyexit_prevprev = earlyexit_prev;    // save previous early exit
     earlyexit_prev = 0;                     // consider no early exit this time
 
-    for(int i=0; i<maxUDPpackets; i++)
-    {
-        incoming_msg_size = recv_socket->recv((void *) incoming_msg_data, incoming_msg_capacity, sender_addr, flags);
-        if(incoming_msg_size <= 0)
-        { // marco.accame: i prefer using <= 0.
-            earlyexit_prev = 1; // yes, we have an early exit
-            break; // we break and do not return because we want to be sure to execute what is after the for() loop
-        }
+    int received = receive(maxUDPpackets);
 
-        // we have a packet ... we give it to the ethmanager for it parsing
-        //bool collectStatistics = (statPrintInterval > 0) ? true : false;
-        ethManager->Reception(ethManager->toipv4addr(sender_addr), incoming_msg_data, incoming_msg_size);
+    if(received < maxUDPpackets)
+    {
+        earlyexit_prev = 1; // yes, we have an early exit
     }
 
     // execute the check on presence of all eth boards.
-    ethManager->CheckPresence();
+    if(housekeeping)
+    {
+        ethManager->CheckPresence();
+    }
 }
 
 
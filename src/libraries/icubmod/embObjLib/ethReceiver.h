@@ -25,13 +25,26 @@
 
 // -- class EthReceiver
 // -- it is a rate thread created by singleton TheEthManager.
-// -- it regularly wakes up to see if a packet is in its listening socket and it parses that with methods made available by TheEthManager.
+// -- in periodic mode it regularly wakes up to see if a packet is in its listening socket and it parses that with methods made available by TheEthManager.
+// -- in event mode (linux only) a further thread blocks on the socket and parses the packets as soon as they arrive, whereas the rate thread
+// -- just executes the check on presence of the boards.
 
 //#include <ethManager.h>
 
 #include <ace/SOCK_Dgram.h>
 
 #include <yarp/os/PeriodicThread.h>
+#include <yarp/os/Thread.h>
+
+#include <vector>
+
+// on linux the packets are received in batches with recvmmsg(), elsewhere one recv() per packet is used
+#if defined(__linux__)
+#define ETHRECEIVER_USE_RECVMMSG
+#define ETHRECEIVER_USE_EVENTS
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
 
 
 #ifdef NETWORK_PERFORMANCE_BENCHMARK 
@@ -45,8 +58,15 @@ namespace eth {
 
     class EthReceiver : public yarp::os::PeriodicThread
     {
+    public:
+
+        enum class Mode { periodic, event };
+
     private:
         int rateofthread;
+        Mode mode;
+        int core;
+        bool housekeeping;
 
         ACE_SOCK_Dgram *recv_socket;
         eth::TheEthManager *ethManager;
@@ -55,16 +75,53 @@ namespace eth {
         Tools::Emb_PeriodicEventVerifier m_perEvtVerifier;
 #endif
 
+        // it gets up to maxUDPpackets packets from the socket and gives them to the ethManager. it returns the number of packets
+        int receiveSingle(int maxUDPpackets);
+#if defined(ETHRECEIVER_USE_RECVMMSG)
+        // the preallocated ring of packet buffers filled by recvmmsg(): one message header, io vector and sender address per buffer
+        enum { rxBatchSize = 64 };
+        bool useBatched;
+        std::vector<uint64_t> rxBuffers;
+        std::vector<struct mmsghdr> rxMessages;
+        std::vector<struct iovec> rxIOvectors;
+        std::vector<struct sockaddr_in> rxSenders;
+        // when the frames are captured or the statistics collected, the kernel gives the time of reception of each packet in these control buffers
+        bool useTimestamps;
+        std::vector<uint64_t> rxControls;
+        // as receiveSingle() but with one recvmmsg() for up to rxBatchSize packets
+        int receiveBatched(int maxUDPpackets);
+#endif
+        // it uses the batched reception if available
+        int receive(int maxUDPpackets);
+
+#if defined(ETHRECEIVER_USE_EVENTS)
+        // the thread of the event mode: it waits for the socket to be readable and then it gets the packets
+        class EventThread : public yarp::os::Thread
+        {
+        private:
+            EthReceiver *owner;
+        public:
+            EventThread(EthReceiver *_owner) : owner(_owner) {}
+            bool threadInit() override;
+            void run() override;
+        };
+        EventThread *eventThread;
+#endif
+
     public:
 
         enum { EthReceiverDefaultRate = 5, EthReceiverMaxRate = 20 };
 
-        EthReceiver(int rxrate);
+        // rxrate is the period of the thread in ms. in event mode the packets are received as they arrive and rxrate is the period of the
+        // check on presence. rxcore is the cpu core the event thread is pinned to (-1 for no pinning). when the reception is sharded
+        // across several receivers, only one of them must have rxhousekeeping, i.e. must execute the check on presence
+        EthReceiver(int rxrate, Mode rxmode = Mode::periodic, int rxcore = -1, bool rxhousekeeping = true);
         ~EthReceiver();
         bool config(ACE_SOCK_Dgram *pSocket, eth::TheEthManager* _ethManager);
         bool threadInit();
         void run();
         void onStop();
+        void threadRelease();
     };
 
 } // namespace eth
@@ -27,9 +27,13 @@ using namespace yarp::os;
 using namespace yarp::os::impl;
 
 #include <theNVmanager.h>
+#include <theDiagnosticsSink.h>
+#include <iCub/StartupTrace.h>
 #include "ethParser.h"
 using namespace eth;
 
+static std::string formatCANprint(const eth::DiagnosticEvent &event);
+
 
 
 
@@ -64,6 +68,7 @@ EthResource::EthResource()
     {
         c_string_handler[i] = NULL;
     }
+    canprintsource = eth::theDiagnosticsSink::noSource;
 
     std::string tmp = yarp::conf::environment::get_string("ETH_VERBOSEWHENOK");
     if (tmp != "")
@@ -111,6 +116,9 @@ bool EthResource::open2(eOipv4addr_t remIP, yarp::os::Searchable &cfgtotal)
 {
     ethManager = eth::TheEthManager::instance();
 
+    iCub::dev::TraceSpan span("eth", "EthResource::open2");
+    iCub::dev::TraceSpan parsespan("parser", "EthResource::open2 parse");
+
     eth::parser::pc104Data pc104data;
     eth::parser::read(cfgtotal, pc104data);
 //    eth::parser::print(pc104data);
@@ -120,6 +128,8 @@ bool EthResource::open2(eOipv4addr_t remIP, yarp::os::Searchable &cfgtotal)
     eth::parser::read(cfgtotal, brddata);
     eth::parser::print(brddata);
 
+    parsespan.end();
+
     txconfig = brddata.settings.txconfig;
 
     properties.ipv4addr = remIP;
@@ -130,6 +140,9 @@ bool EthResource::open2(eOipv4addr_t remIP, yarp::os::Searchable &cfgtotal)
     properties.boardtypeString = brddata.properties.typestring;
     properties.boardnameString = brddata.settings.name;
 
+    // the CAN prints are formatted and logged by the thread of the sink, not by the ethReceiver which gets them
+    canprintsource = eth::theDiagnosticsSink::getInstance().addSource("from BOARD " + properties.ipv4addrString + " (" + properties.boardnameString + "),", 20, formatCANprint);
+
 
     eth::EthMonitorPresence::Config mpConfig;
 
@@ -494,6 +507,15 @@ bool EthResource::verifyEPprotocol(eOprot_endpoint_t ep)
         return(true);
     }
 
+    iCub::dev::TraceSpan span("eth", "EthResource::verifyEPprotocol " + properties.boardnameString + " " + std::to_string(ep));
+
+    // the board may be still being brought up by one of the workers of TheEthManager. if so, we wait for it
+    if(false == ethManager->waitBringUp(properties.ipv4addr))
+    {
+        yError() << "EthResource::verifyEPprotocol() had a failed bring-up of BOARD" << getProperties().boardnameString << "with IP" << getProperties().ipv4addrString << ": cannot proceed any further";
+        return(false);
+    }
+
     if(false == verifyBoard())
     {
         yError() << "EthResource::verifyEPprotocol() cannot verify BOARD" << getProperties().boardnameString << "with IP" << getProperties().ipv4addrString << ": cannot proceed any further";
@@ -600,6 +622,13 @@ bool EthResource::verifyEPprotocol(eOprot_endpoint_t ep)
 
 
 
+bool EthResource::bringUp()
+{
+    iCub::dev::TraceSpan span("eth", "EthResource::bringUp " + properties.boardnameString);
+    return (true == verifyBoard()) && (true == askBoardVersion());
+}
+
+
 bool EthResource::verifyBoard(void)
 {
     if((true == verifyBoardPresence())      &&
@@ -774,16 +803,60 @@ bool EthResource::setRemoteValue(const eOprotID32_t id32, void *value)
     return nvman.set(properties.ipv4addr, id32, value);
 }
 
+bool EthResource::setRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values)
+{
+    theNVmanager& nvman = theNVmanager::getInstance();
+    return nvman.set(properties.ipv4addr, id32s, values);
+}
+
 bool EthResource::setcheckRemoteValue(const eOprotID32_t id32, void *value, const unsigned int retries, const double waitbeforecheck, const double timeout)
 {
     theNVmanager& nvman = theNVmanager::getInstance();
     return nvman.setcheck(properties.ipv4addr, id32, value, retries, waitbeforecheck, timeout);
 }
 
-bool EthResource::CANPrintHandler(eOmn_info_basic_t *infobasic)
+bool EthResource::setcheckRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const unsigned int retries, const double waitbeforecheck, const double timeout)
+{
+    if(id32s.size() != values.size())
+    {
+        yError() << "EthResource::setcheckRemoteValues() called with" << id32s.size() << "ids and" << values.size() << "values for BOARD" << getProperties().boardnameString << "with IP" << getProperties().ipv4addrString;
+        return false;
+    }
+
+    theNVmanager& nvman = theNVmanager::getInstance();
+
+    // first pass: all the set<> + ask<> are sent at once and then awaited together. the deadline accounts for the tx cycles
+    // required to send them (about one variable per cycle in the worst case)
+    const double deadline = SystemClock::nowSystem() + timeout + 0.001*id32s.size();
+    std::vector<std::shared_future<bool>> results;
+    results.reserve(id32s.size());
+    for(size_t i=0; i<id32s.size(); i++)
+    {
+        results.push_back(nvman.setcheck_async(properties.ipv4addr, id32s[i], values[i], deadline));
+    }
+
+    // second pass: the variables which did not verify are set and checked one by one, with retries
+    bool ok = true;
+    for(size_t i=0; i<id32s.size(); i++)
+    {
+        if(true == results[i].get())
+        {
+            continue;
+        }
+
+        if(false == nvman.setcheck(properties.ipv4addr, id32s[i], values[i], retries, waitbeforecheck, timeout))
+        {
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+// the args of the events of the CAN prints: source, address, timestamp of the board, id of the message
+static std::string formatCANprint(const eth::DiagnosticEvent &event)
 {
     char str[256];
-    char canfullmessage[128];
 
     static const char * sourcestrings[] =
     {
@@ -792,35 +865,43 @@ bool EthResource::CANPrintHandler(eOmn_info_basic_t *infobasic)
         "CAN2",
         "UNKNOWN"
     };
+    int source                      = static_cast<int>(event.args[0]);
+    const char * str_source         = ((source < 0) || (source > eomn_info_source_can2)) ? (sourcestrings[3]) : (sourcestrings[source]);
+    uint64_t timestamp              = static_cast<uint64_t>(event.args[2]);
+
+    uint32_t sec = timestamp / 1000000;
+    uint32_t msec = (timestamp % 1000000) / 1000;
+    uint32_t usec = timestamp % 1000;
+
+    snprintf(str, sizeof(str), "src %s, adr %d, time %ds %dm %du: CAN PRINT MESSAGE[id %d] -> %s",
+                                str_source,
+                                static_cast<int>(event.args[1]),
+                                sec,
+                                msec,
+                                usec,
+                                static_cast<int>(event.args[3]),
+                                event.text
+                                );
+    return str;
+}
+
+bool EthResource::CANPrintHandler(eOmn_info_basic_t *infobasic)
+{
+    char canfullmessage[128];
+
     int source                      = EOMN_INFO_PROPERTIES_FLAGS_get_source(infobasic->properties.flags);
-    const char * str_source         = (source > eomn_info_source_can2) ? (sourcestrings[3]) : (sourcestrings[source]);
     uint16_t address                = EOMN_INFO_PROPERTIES_FLAGS_get_address(infobasic->properties.flags);
     uint8_t *p64 = (uint8_t*)&(infobasic->properties.par64);
 
     int msg_id = (p64[1]&0xF0) >> 4;
 
-    uint32_t sec = infobasic->timestamp / 1000000;
-    uint32_t msec = (infobasic->timestamp % 1000000) / 1000;
-    uint32_t usec = infobasic->timestamp % 1000;
-
-    const char *boardstr = properties.boardnameString.c_str();
+    int64_t args[4] = { source, address, static_cast<int64_t>(infobasic->timestamp), msg_id };
 
     // Validity check
     if(address > 15)
     {
-        snprintf(canfullmessage, sizeof(canfullmessage), "Error while parsing the message: CAN address detected is out of allowed range");
-        snprintf(str, sizeof(str), "from BOARD %s (%s), src %s, adr %d, time %ds %dm %du: CAN PRINT MESSAGE[id %d] -> %s",
-                                    properties.ipv4addrString.c_str(),
-                                    boardstr,
-                                    str_source,
-                                    address,
-                                    sec,
-                                    msec,
-                                    usec,
-                                    msg_id,
-                                    canfullmessage
-                                    );
-        feat_PrintError(str);
+        eth::theDiagnosticsSink::getInstance().post(canprintsource, eth::theDiagnosticsSink::Level::error, args, 4,
+                                                    "Error while parsing the message: CAN address detected is out of allowed range");
     }
     else
     {
@@ -842,18 +923,7 @@ bool EthResource::CANPrintHandler(eOmn_info_basic_t *infobasic)
             canfullmessage[63] = 0;
             c_string_handler[address]->clear_string(ret);
 
-            snprintf(str,sizeof(str), "from BOARD %s (%s), src %s, adr %d, time %ds %dm %du: CAN PRINT MESSAGE[id %d] -> %s",
-                                        properties.ipv4addrString.c_str(),
-                                        boardstr,
-                                        str_source,
-                                        address,
-                                        sec,
-                                        msec,
-                                        usec,
-                                        msg_id,
-                                        canfullmessage
-                                        );
-            feat_PrintInfo(str);
+            eth::theDiagnosticsSink::getInstance().post(canprintsource, eth::theDiagnosticsSink::Level::info, args, 4, canfullmessage);
         }
     }
     return true;
@@ -914,12 +984,15 @@ bool EthResource::serviceCommand(eOmn_serv_operation_t operation, eOmn_serv_cate
 
 bool EthResource::serviceVerifyActivate(eOmn_serv_category_t category, const eOmn_serv_parameter_t* param, double timeout)
 {
+    iCub::dev::TraceSpan span("eth", "EthResource::serviceVerifyActivate " + properties.boardnameString + " " + std::to_string(category));
     return(serviceCommand(eomn_serv_operation_verifyactivate, category, param, timeout, 3));
 }
 
 
 bool EthResource::serviceSetRegulars(eOmn_serv_category_t category, vector<eOprotID32_t> &id32vector, double timeout)
 {
+    iCub::dev::TraceSpan span("eth", "EthResource::serviceSetRegulars " + properties.boardnameString + " " + std::to_string(category));
+
     eOmn_serv_parameter_t param = {0};
     EOarray *array = eo_array_New(eOmn_serv_capacity_arrayof_id32, 4, &param.arrayofid32);
     for(int i=0; i<id32vector.size(); i++)
@@ -937,6 +1010,7 @@ bool EthResource::serviceSetRegulars(eOmn_serv_category_t category, vector<eOpro
 
 bool EthResource::serviceStart(eOmn_serv_category_t category, double timeout)
 {
+    iCub::dev::TraceSpan span("eth", "EthResource::serviceStart " + properties.boardnameString + " " + std::to_string(category));
     bool ret = serviceCommand(eomn_serv_operation_start, category, NULL, timeout, 3);
 
     if(ret)
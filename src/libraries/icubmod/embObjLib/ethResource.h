@@ -68,9 +68,13 @@ namespace eth {
         // FAKE: it just returns true or ... does the same
         bool setRemoteValue(const eOprotID32_t id32, void *value);
 
+        bool setRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values);
+
         // FAKE: it just returns true.
         bool setcheckRemoteValue(const eOprotID32_t id32, void *value, const unsigned int retries = 10, const double waitbeforecheck = 0.001, const double timeout = 0.050);
 
+        bool setcheckRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const unsigned int retries = 10, const double waitbeforecheck = 0.001, const double timeout = 0.050);
+
         // FAKE: it just returns true.
         bool getLocalValue(const eOprotID32_t id32, void *value);
 
@@ -78,6 +82,8 @@ namespace eth {
         bool setLocalValue(eOprotID32_t id32, const void *value, bool overrideROprotection = false);
 
 
+        bool bringUp();
+
         // FAKE: it just returns true.
         bool verifyEPprotocol(eOprot_endpoint_t ep);
 
@@ -122,6 +128,7 @@ namespace eth {
         uint16_t            usedNumberOfRegularROPs;
 
         can_string_eth*     c_string_handler[16];
+        uint16_t            canprintsource;     // the source of the CAN prints in theDiagnosticsSink
 
         eth::TheEthManager *ethManager;
 
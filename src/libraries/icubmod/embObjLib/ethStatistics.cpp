@@ -0,0 +1,230 @@
+// -*- Mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - public interface
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "ethStatistics.h"
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - external dependencies
+// --------------------------------------------------------------------------------------------------------------------
+
+#include <cstring>
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - pimpl: private implementation (see scott meyers: item 22 of effective modern c++, item 31 of effective c++
+// --------------------------------------------------------------------------------------------------------------------
+
+namespace {
+
+    // the header of the ropframe: startofframe (4 bytes), ropssizeof (2), ropsnumberof (2), ageofframe (8), sequencenumber (8)
+    const size_t ropframeHeaderSize = 24;
+    const size_t ropframeSequenceOffset = 16;
+}
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - the class
+// --------------------------------------------------------------------------------------------------------------------
+
+
+// - class eth::EthRXstatistics
+
+void eth::EthRXstatistics::Histogram::reset()
+{
+    memset(bins, 0, sizeof(bins));
+    count = sum = max = 0;
+}
+
+
+void eth::EthRXstatistics::Histogram::add(uint64_t usec)
+{
+    uint8_t bin = 0;
+    for(uint64_t v = usec; (v > 0) && (bin < numberofbins-1); v >>= 1)
+    {
+        bin++;
+    }
+
+    bins[bin]++;
+    count++;
+    sum += usec;
+    if(usec > max)
+    {
+        max = usec;
+    }
+}
+
+
+void eth::EthRXstatistics::Histogram::toBottle(yarp::os::Bottle &b) const
+{
+    yarp::os::Bottle &m = b.addList();
+    m.addString("mean");
+    m.addFloat64(mean());
+    yarp::os::Bottle &x = b.addList();
+    x.addString("max");
+    x.addInt64(max);
+    yarp::os::Bottle &h = b.addList();
+    h.addString("bins");
+    yarp::os::Bottle &values = h.addList();
+    for(int i=0; i<numberofbins; i++)
+    {
+        values.addInt64(bins[i]);
+    }
+}
+
+
+void eth::EthRXstatistics::Board::reset()
+{
+    frames = bytes = lost = disordered = 0;
+    interarrival.reset();
+    parsing.reset();
+}
+
+
+void eth::EthRXstatistics::Board::toBottle(yarp::os::Bottle &b) const
+{
+    const char *names[] = { "frames", "bytes", "lost", "disordered" };
+    const uint64_t values[] = { frames, bytes, lost, disordered };
+    for(int i=0; i<4; i++)
+    {
+        yarp::os::Bottle &v = b.addList();
+        v.addString(names[i]);
+        v.addInt64(values[i]);
+    }
+    yarp::os::Bottle &ia = b.addList();
+    ia.addString("interarrival");
+    interarrival.toBottle(ia);
+    yarp::os::Bottle &pa = b.addList();
+    pa.addString("parsing");
+    parsing.toBottle(pa);
+}
+
+
+eth::EthRXstatistics::EthRXstatistics()
+{
+    enabled = false;
+    for(int i=0; i<maxBoards; i++)
+    {
+        entries[i].active = false;
+        entries[i].lastsequence = 0;
+        entries[i].lastarrival = 0;
+        entries[i].periods[0].reset();
+        entries[i].periods[1].reset();
+    }
+}
+
+
+eth::EthRXstatistics::~EthRXstatistics()
+{
+}
+
+
+bool eth::EthRXstatistics::index(eOipv4addr_t ipv4, uint8_t &i)
+{
+    i = 0;
+    eo_common_ipv4addr_to_decimal(ipv4, NULL, NULL, NULL, &i);
+    i--;
+
+    return(i<maxBoards);
+}
+
+
+void eth::EthRXstatistics::update(eOipv4addr_t from, const void *frame, size_t size, uint64_t arrival, uint64_t parsing)
+{
+    uint8_t i = 0;
+    if((false == enabled) || (false == index(from, i)) || (size < ropframeHeaderSize))
+    {
+        return;
+    }
+
+    uint64_t sequence = 0;
+    memcpy(&sequence, static_cast<const uint8_t*>(frame) + ropframeSequenceOffset, sizeof(sequence));
+
+    Entry &e = entries[i];
+    std::lock_guard<std::mutex> lck(e.mtx);
+
+    uint64_t lost = 0;
+    bool disordered = false;
+    uint64_t interarrival = 0;
+    bool first = !e.active;
+    if(false == first)
+    {
+        if(sequence > e.lastsequence)
+        {
+            lost = sequence - e.lastsequence - 1;
+        }
+        else
+        {   // we restart from this sequence number, also if the board has rebooted
+            disordered = true;
+        }
+        interarrival = (arrival > e.lastarrival) ? (arrival - e.lastarrival) : 0;
+    }
+
+    e.active = true;
+    e.lastsequence = sequence;
+    e.lastarrival = arrival;
+
+    for(Board &b : e.periods)
+    {
+        b.frames++;
+        b.bytes += size;
+        b.lost += lost;
+        b.disordered += (disordered ? 1 : 0);
+        if(false == first)
+        {
+            b.interarrival.add(interarrival/1000);
+        }
+        b.parsing.add(parsing/1000);
+    }
+}
+
+
+bool eth::EthRXstatistics::get(eOipv4addr_t ipv4, Board &board, Period period, bool reset)
+{
+    uint8_t i = 0;
+    if(false == index(ipv4, i))
+    {
+        return false;
+    }
+
+    Entry &e = entries[i];
+    std::lock_guard<std::mutex> lck(e.mtx);
+
+    board = e.periods[static_cast<int>(period)];
+    if(true == reset)
+    {
+        e.periods[static_cast<int>(period)].reset();
+    }
+
+    return e.active;
+}
+
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
+
+
+
@@ -0,0 +1,123 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+// - include guard ----------------------------------------------------------------------------------------------------
+
+#ifndef _ETHSTATISTICS_H_
+#define _ETHSTATISTICS_H_
+
+// -- class EthRXstatistics
+// -- it collects the statistics of reception of every board: number of frames, frames lost or out of order as seen from the
+// -- sequence number in the header of the ropframe, and histograms of the inter-arrival time and of the parsing time.
+// -- it is updated by TheEthManager::Reception() and read by the periodic report and by the rpc port of TheEthManager.
+// -- the statistics are kept twice: since the last reset asked by the user and since the last periodic report.
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include <yarp/os/Bottle.h>
+
+#include "EoCommon.h"
+
+
+namespace eth {
+
+    class EthRXstatistics
+    {
+    public:
+
+        // it is the same as EthBoards::maxEthBoards: a board is identified by the last byte of its address
+        enum { maxBoards = 32 };
+
+        // bin 0 is [0, 1) usec, bin i is [2^(i-1), 2^i) usec, the last bin also holds all the longer times
+        enum { numberofbins = 16 };
+
+        struct Histogram
+        {
+            uint64_t bins[numberofbins];
+            uint64_t count;
+            uint64_t sum;       // [usec]
+            uint64_t max;       // [usec]
+            void reset();
+            void add(uint64_t usec);
+            double mean() const { return (count > 0) ? (static_cast<double>(sum)/count) : 0.0; }
+            void toBottle(yarp::os::Bottle &b) const;
+        };
+
+        struct Board
+        {
+            uint64_t frames;        // frames received
+            uint64_t bytes;         // bytes received
+            uint64_t lost;          // frames missing in the sequence numbers
+            uint64_t disordered;    // frames with a sequence number not greater than the previous one (duplicates or reboot of the board)
+            Histogram interarrival;
+            Histogram parsing;
+            void reset();
+            void toBottle(yarp::os::Bottle &b) const;
+        };
+
+        enum class Period { sincereset = 0, sinceprint = 1 };
+
+        EthRXstatistics();
+        ~EthRXstatistics();
+
+        void enable(bool on) { enabled = on; }
+        bool isenabled() const { return enabled; }
+
+        // it is called for each frame of a board, with the board's rx lock taken. arrival is the time of reception in ns since
+        // the epoch (kernel timestamp if available) and parsing is the time spent to parse the frame in ns
+        void update(eOipv4addr_t from, const void *frame, size_t size, uint64_t arrival, uint64_t parsing);
+
+        // it gets the statistics of a board over the chosen period, and optionally starts a new period. it returns false if the board
+        // has never sent a frame
+        bool get(eOipv4addr_t ipv4, Board &board, Period period, bool reset);
+
+    private:
+
+        struct Entry
+        {
+            std::mutex mtx;
+            bool active;
+            uint64_t lastsequence;
+            uint64_t lastarrival;
+            Board periods[2];
+        };
+
+        std::atomic<bool> enabled;
+        Entry entries[maxBoards];
+
+        static bool index(eOipv4addr_t ipv4, uint8_t &i);
+    };
+
+
+} // namespace eth
+
+
+#endif  // include-guard
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
+
+
+
+
+
+
@@ -16,6 +16,7 @@
 #include "ethResource.h"
 #include <ethManager.h>
 #include <yarp/os/Time.h>
+#include <yarp/os/SystemClock.h>
 #include <yarp/os/Network.h>
 #include <yarp/os/NetType.h>
 
@@ -29,6 +30,8 @@
 
 #include "ethParser.h"
 
+#include <algorithm>
+
 using namespace yarp::os;
 using namespace yarp::os::impl;
 
@@ -58,11 +61,14 @@ FakeEthResource::FakeEthResource()
     usedNumberOfRegularROPs     = 0;
     memset(&boardCommStatus, 0, sizeof(boardCommStatus));
 
+    replaySpeed                 = 1.0;
+    replayQuit                  = false;
 }
 
 
 FakeEthResource::~FakeEthResource()
 {
+    stopReplay();
     ethManager = NULL;
 }
 
@@ -143,6 +149,21 @@ bool FakeEthResource::open2(eOipv4addr_t remIP, yarp::os::Searchable &cfgtotal)
 
     lock(false);
 
+    // 3. the frames to be replayed, if any
+
+    if(!pc104data.replayfile.empty())
+    {
+        if(true == replayFrames.open(pc104data.replayfile, remIP))
+        {
+            replaySpeed = pc104data.replayspeed;
+            yDebug() << "FakeEthResource::open2() will replay" << replayFrames.numberofframes() << "frames of BOARD" << boardName << "IP" << ipv4addrstring << "from" << pc104data.replayfile;
+        }
+        else
+        {
+            yWarning() << "FakeEthResource::open2() cannot replay" << pc104data.replayfile << "for BOARD" << boardName << "IP" << ipv4addrstring;
+        }
+    }
+
     return true;
 }
 
@@ -195,6 +216,12 @@ bool FakeEthResource::isRunning(void)
 
 
 
+bool FakeEthResource::bringUp()
+{
+    return true;
+}
+
+
 bool FakeEthResource::verifyEPprotocol(eOprot_endpoint_t ep)
 {
     if((uint8_t)ep >= eoprot_endpoints_numberof)
@@ -244,11 +271,21 @@ bool FakeEthResource::setRemoteValue(const eOprotID32_t id32, void *value)
     return true;
 }
 
+bool FakeEthResource::setRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values)
+{
+    return true;
+}
+
 bool FakeEthResource::setcheckRemoteValue(const eOprotID32_t id32, void *value, const unsigned int retries, const double waitbeforecheck, const double timeout)
 {
     return true;
 }
 
+bool FakeEthResource::setcheckRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const unsigned int retries, const double waitbeforecheck, const double timeout)
+{
+    return true;
+}
+
 
 
 bool FakeEthResource::CANPrintHandler(eOmn_info_basic_t *infobasic)
@@ -272,15 +309,88 @@ bool FakeEthResource::serviceSetRegulars(eOmn_serv_category_t category, vector<e
 bool FakeEthResource::serviceStart(eOmn_serv_category_t category, double timeout)
 {
     isInRunningMode = true;
+    startReplay();
     return true;
 }
 
 
 bool FakeEthResource::serviceStop(eOmn_serv_category_t category, double timeout)
 {
+    // TheEthManager::releaseResource2() calls it before locking the board, thus the replay can take the rx lock till then
+    if(eomn_serv_category_all == category)
+    {
+        stopReplay();
+    }
     return true; 
 }
 
+
+void FakeEthResource::startReplay()
+{
+    if((0 == replayFrames.numberofframes()) || (true == replayThread.joinable()))
+    {
+        return;
+    }
+
+    replayQuit = false;
+    replayThread = std::thread(&FakeEthResource::runReplay, this);
+}
+
+
+void FakeEthResource::stopReplay()
+{
+    replayQuit = true;
+    if(true == replayThread.joinable())
+    {
+        replayThread.join();
+    }
+}
+
+
+void FakeEthResource::runReplay()
+{
+    // we parse the frames as TheEthManager::Reception() does for a real board: under the rx lock of the board
+    const size_t numberofframes = replayFrames.numberofframes();
+    const double start = SystemClock::nowSystem();
+    double parsing = 0.0;
+    uint64_t first = 0;
+    size_t i = 0;
+
+    for(i=0; (i<numberofframes) && (false == replayQuit); i++)
+    {
+        eth::EthCaptureReader::Frame frame;
+        replayFrames.get(i, frame);
+
+        if(0 == i)
+        {
+            first = frame.timestamp;
+        }
+
+        if(replaySpeed > 0)
+        {   // we wait in small steps so that a stop is not delayed by long pauses of the recorded traffic
+            const double due = start + 1.0e-9*static_cast<double>(frame.timestamp - first)/replaySpeed;
+            for(double wait = due - SystemClock::nowSystem(); (wait > 0) && (false == replayQuit); wait = due - SystemClock::nowSystem())
+            {
+                SystemClock::delaySystem(std::min(wait, 0.100));
+            }
+        }
+
+        const double t0 = SystemClock::nowSystem();
+        if(true == ethManager->ethBoards->lockRX(ipv4addr, true))
+        {
+            ethManager->ethBoards->rx_begin(ipv4addr, yarp::os::Time::now());
+            transceiver.parseUDP(frame.data, frame.size);
+            ethManager->ethBoards->rx_end(ipv4addr);
+            ethManager->ethBoards->lockRX(ipv4addr, false);
+        }
+        parsing += SystemClock::nowSystem() - t0;
+    }
+
+    const double duration = SystemClock::nowSystem() - start;
+    yDebug() << "FakeEthResource::runReplay() has replayed" << i << "of" << numberofframes << "frames of BOARD" << boardName << "in" << duration << "sec with"
+             << ((i > 0) ? (1.0e6*parsing/i) : 0.0) << "usec of parsing per frame";
+}
+
 bool FakeEthResource::getLocalValue(const eOprotID32_t id32, void *data)
 {
     bool ret = transceiver.read(id32, data);
@@ -25,10 +25,13 @@
 
 
 #include <mutex>
+#include <thread>
+#include <atomic>
 
 #include<abstractEthResource.h>
 
 #include <ethManager.h>
+#include <ethCapture.h>
 
 
 namespace eth {
@@ -59,12 +62,20 @@ namespace eth {
 
         bool setRemoteValue(const eOprotID32_t id32, void *value);
 
+        // FAKE: it just returns true.
+        bool setRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values);
+
         bool setcheckRemoteValue(const eOprotID32_t id32, void *value, const unsigned int retries = 10, const double waitbeforecheck = 0.001, const double timeout = 0.050);
 
+        bool setcheckRemoteValues(const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const unsigned int retries = 10, const double waitbeforecheck = 0.001, const double timeout = 0.050);
+
         bool getLocalValue(const eOprotID32_t id32,  void *value);
 
         bool setLocalValue(const eOprotID32_t id32,  const void *value, bool overrideROprotection = false);
 
+        // FAKE: it just returns true.
+        bool bringUp();
+
         bool verifyEPprotocol(eOprot_endpoint_t ep);
 
         bool CANPrintHandler(eOmn_info_basic_t* infobasic);
@@ -118,12 +129,23 @@ namespace eth {
 
         Properties properties;
 
+        // the replay of the frames of this board recorded in DEBUG/replayFile. it starts with the first serviceStart(), as the regulars
+        // of a real board would, and it feeds the frames to the transceiver at their original timing scaled by replaySpeed
+        eth::EthCaptureReader replayFrames;
+        double replaySpeed;
+        std::thread replayThread;
+        std::atomic<bool> replayQuit;
+
 
     private:
 
 
         bool verifyBoard();
 
+        void startReplay();
+        void runReplay();
+        void stopReplay();
+
 
 
         bool cleanBoardBehaviour(void);
@@ -27,6 +27,8 @@ using namespace std;
 #include <stdio.h>
 #include <string.h>
 
+#include <algorithm>
+
 #include "hostTransceiver.hpp"
 #include "FeatureInterface.h"
 
@@ -109,6 +111,8 @@ HostTransceiver::HostTransceiver():delayAfterROPloadingFailure(0.001) // 1ms
 
     capacityofTXpacket = defMaxSizeOfTXpacket;
     maxSizeOfROP = defMaxSizeOfROP;
+
+    ropqueueStalled = false;
 }
 
 
@@ -183,6 +187,16 @@ bool HostTransceiver::init2(AbstractEthResource *owner, yarp::os::Searchable &cf
         return false;
     }
 
+    // maxSizeOfROP is now the one of the board
+    if(false == ropqueue.init(capacityOfROPqueue, maxSizeOfROP))
+    {
+        yError() << "HostTransceiver::init() -> the queue of the ROPs cannot be initialised for BOARD w/ IP" << remoteipstring;
+        return false;
+    }
+    pendingROPs.reserve(ropqueue.capacity());
+    supersededROPs.reserve(ropqueue.capacity());
+    latestSetROPs.reserve(ropqueue.capacity());
+
 
     // now hosttxrxcfg is ready, thus ...
     // initialise the transceiver: it creates a EOhostTransceiver and its EOnvSet
@@ -292,10 +306,6 @@ bool HostTransceiver::write(const eOprotID32_t id32, const void* data, bool forc
 bool HostTransceiver::addSetROP__(const eOprotID32_t id32, const void* data, const uint32_t signature, bool writelocalrxcache)
 {
     eOresult_t eores = eores_NOK_generic;
-    int32_t err = -1;
-    int32_t info0 = -1;
-    int32_t info1 = -1;
-    int32_t info2 = -1;
 
     if(eobool_false == eoprot_id_isvalid(protboardnumber, id32))
     {
@@ -311,6 +321,16 @@ bool HostTransceiver::addSetROP__(const eOprotID32_t id32, const void* data, con
         yError() << "HostTransceiver::addSetROP__() called w/ with NULL data";
         return false;
     }
+
+    uint16_t size = eoprot_variable_sizeof_get(protboardnumber, id32);
+    if((0 == size) || (size > maxSizeOfROP))
+    {
+        char nvinfo[128];
+        eoprot_ID2information(id32, nvinfo, sizeof(nvinfo));
+        yError() << "HostTransceiver::addSetROP__() called for a variable of size" << size << "but the max size of a ROP is" << maxSizeOfROP <<
+                    "on BOARD /w IP" << remoteipstring << "with id: " << nvinfo;
+        return false;
+    }
     
     if(true == writelocalrxcache)
     {
@@ -340,68 +360,77 @@ bool HostTransceiver::addSetROP__(const eOprotID32_t id32, const void* data, con
         
     }
 
-    eOropdescriptor_t ropdesc = {0};
-    
-    // marco.accame: use eok_ropdesc_basic to have a basic valid descriptor which is modified later
-    memcpy(&ropdesc, &eok_ropdesc_basic, sizeof(eOropdescriptor_t));
+    ROPqueue::ROP rop;
+    rop.ropcode     = eo_ropcode_set;
+    rop.id32        = id32;
+    rop.signature   = signature;
+    rop.size        = size;
+    rop.data        = data;
+
+    return queueROPs__(&rop, 1, "addSetROP__");
+}
 
-    ropdesc.control.plustime    = 1;
-    ropdesc.control.plussign    = (eo_rop_SIGNATUREdummy == signature) ? 0 : 1;
-    ropdesc.ropcode             = eo_ropcode_set;
-    ropdesc.id32                = id32;
-    ropdesc.size                = 0;        // marco.accame: the size is internally computed from the id32
-    ropdesc.data                = reinterpret_cast<uint8_t *>(const_cast<void*>(data));
-    ropdesc.signature           = signature;
 
-    bool ret = false;
 
-    for(int i=0; ( (i<maxNumberOfROPloadingAttempts) && (!ret) ); i++)
+bool HostTransceiver::addROPset(const eOprotID32_t id32, const void* data, const uint32_t signature)
+{
+   return(HostTransceiver::addSetROP__(id32, data, signature, false));
+}
+
+
+bool HostTransceiver::addROPsets(const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &data)
+{
+    if(id32s.size() != data.size())
     {
-        lock_transceiver(true);
-        eores = eo_transceiver_OccasionalROP_Load(pc104txrx, &ropdesc);
-        lock_transceiver(false);
+        yError() << "HostTransceiver::addROPsets() called w/" << id32s.size() << "ids and" << data.size() << "data for BOARD /w IP" << remoteipstring;
+        return false;
+    }
 
-        if(eores_OK != eores)
+    std::vector<ROPqueue::ROP> rops(id32s.size());
+
+    for(size_t n=0; n<id32s.size(); n++)
+    {
+        if(eobool_false == eoprot_id_isvalid(protboardnumber, id32s[n]))
         {
             char nvinfo[128];
-            eoprot_ID2information(id32, nvinfo, sizeof(nvinfo));
-            yWarning() << "HostTransceiver::addSetROP__(): eo_transceiver_OccasionalROP_Load() for BOARD /w IP" << remoteipstring << "unsuccessful at attempt num " << i+1 <<
-                          "with id: " << nvinfo;
-
-            eo_transceiver_lasterror_tx_Get(pc104txrx, &err, &info0, &info1, &info2);
-            yWarning() << "HostTransceiver::addSetROP__(): eo_transceiver_lasterror_tx_Get() detected: err=" << err << "infos = " << info0 << info1 << info2;
-
-            yarp::os::Time::delay(delayAfterROPloadingFailure);
+            eoprot_ID2information(id32s[n], nvinfo, sizeof(nvinfo));
+            yError() << "HostTransceiver::addROPsets() called w/ invalid id on BOARD /w IP" << remoteipstring <<
+                        "with id: " << nvinfo;
+            return false;
         }
-        else
+
+        if(NULL == data[n])
         {
-            if(i!=0)
-            {
-                char nvinfo[128];
-                eoprot_ID2information(id32, nvinfo, sizeof(nvinfo));
-                yDebug() << "HostTransceiver::addSetROP__(): eo_transceiver_OccasionalROP_Load() for BOARD /w IP" << remoteipstring << "successful ONLY at attempt num " << i+1 <<
-                              "with id: " << nvinfo;                
-            }
+            yError() << "HostTransceiver::addROPsets() called w/ with NULL data";
+            return false;
+        }
 
-            ret = true;
+        uint16_t size = eoprot_variable_sizeof_get(protboardnumber, id32s[n]);
+        if((0 == size) || (size > maxSizeOfROP))
+        {
+            char nvinfo[128];
+            eoprot_ID2information(id32s[n], nvinfo, sizeof(nvinfo));
+            yError() << "HostTransceiver::addROPsets() called for a variable of size" << size << "but the max size of a ROP is" << maxSizeOfROP <<
+                        "on BOARD /w IP" << remoteipstring << "with id: " << nvinfo;
+            return false;
         }
+
+        ROPqueue::ROP &rop = rops[n];
+        rop.ropcode     = eo_ropcode_set;
+        rop.id32        = id32s[n];
+        rop.signature   = eo_rop_SIGNATUREdummy;
+        rop.size        = size;
+        rop.data        = data[n];
     }
-    if(!ret)
+
+    if(rops.size() > ropqueue.capacity())
     {
-        char nvinfo[128];
-        eoprot_ID2information(id32, nvinfo, sizeof(nvinfo));
-        yError() << "HostTransceiver::addSetROP__(): ERROR in eo_transceiver_OccasionalROP_Load() for BOARD w/ IP" << remoteipstring+1 << "after all attempts" <<
-                    "with id: " << nvinfo;
+        yError() << "HostTransceiver::addROPsets() called w/" << rops.size() << "ROPs for BOARD /w IP" << remoteipstring <<
+                    "but at most" << ropqueue.capacity() << "can be queued";
+        return false;
     }
 
-    return ret;
-}
-
-
-
-bool HostTransceiver::addROPset(const eOprotID32_t id32, const void* data, const uint32_t signature)
-{
-   return(HostTransceiver::addSetROP__(id32, data, signature, false));
+    return queueROPs__(rops.data(), rops.size(), "addROPsets");
 }
 
 
@@ -412,12 +441,6 @@ bool HostTransceiver::isID32supported(const eOprotID32_t id32)
 
 bool HostTransceiver::addROPask(const eOprotID32_t id32, const uint32_t signature)
 {
-    eOresult_t eores = eores_NOK_generic;
-    int32_t err = -1;
-    int32_t info0 = -1;
-    int32_t info1 = -1;
-    int32_t info2 = -1;
-
     if(eobool_false == eoprot_id_isvalid(protboardnumber, id32))
     {
         char nvinfo[128];
@@ -427,60 +450,149 @@ bool HostTransceiver::addROPask(const eOprotID32_t id32, const uint32_t signatur
         return false;
     }
 
-    eOropdescriptor_t ropdesc = {0};
-    // marco.accame: recommend to use eok_ropdesc_basic
-    memcpy(&ropdesc, &eok_ropdesc_basic, sizeof(eOropdescriptor_t));
-    ropdesc.control.plustime    = 1;
-    ropdesc.control.plussign    = (eo_rop_SIGNATUREdummy == signature) ? 0 : 1;
-    ropdesc.ropcode             = eo_ropcode_ask;
-    ropdesc.id32                = id32;
-    ropdesc.size                = 0;
-    ropdesc.data                = NULL;
-    ropdesc.signature           = signature;
+    ROPqueue::ROP rop;
+    rop.ropcode     = eo_ropcode_ask;
+    rop.id32        = id32;
+    rop.signature   = signature;
+    rop.size        = 0;
+    rop.data        = NULL;
 
+    return queueROPs__(&rop, 1, "addROPask");
+}
 
-    bool ret = false;
 
-    for(int i=0; ( (i<maxNumberOfROPloadingAttempts) && (!ret) ); i++)
+// the queue is full only if the thread of the transmission is late by several cycles, thus we wait for it as we used to do
+// when the transceiver was full
+bool HostTransceiver::queueROPs__(const ROPqueue::ROP *rops, size_t n, const char *caller)
+{
+    for(int i=0; i<maxNumberOfROPloadingAttempts; i++)
     {
-        lock_transceiver(true);
-        eores = eo_transceiver_OccasionalROP_Load(pc104txrx, &ropdesc);
-        lock_transceiver(false);
-
-        if(eores_OK != eores)
-        {
-            char nvinfo[128];
-            eoprot_ID2information(id32, nvinfo, sizeof(nvinfo));
-            yWarning() << "HostTransceiver::addROPask(): eo_transceiver_OccasionalROP_Load() for BOARD w/ IP" << remoteipstring<< "unsuccessfull at attempt num " << i+1 <<
-                          "with id: " << nvinfo;
-
-            eo_transceiver_lasterror_tx_Get(pc104txrx, &err, &info0, &info1, &info2);
-            yWarning() << "HostTransceiver::addROPask(): eo_transceiver_lasterror_tx_Get() detected: err=" << err << "infos = " << info0 << info1 << info2;
-
-            yarp::os::Time::delay(delayAfterROPloadingFailure);
-        }
-        else
+        if(true == ropqueue.pushmany(rops, n))
         {
             if(i!=0)
             {
                 char nvinfo[128];
-                eoprot_ID2information(id32, nvinfo, sizeof(nvinfo));
-                yDebug() << "HostTransceiver::addROPask(): eo_transceiver_OccasionalROP_Load() for BOARD /w IP" << remoteipstring << "succesful ONLY at attempt num " << i+1 <<
-                              "with id: " << nvinfo;
+                eoprot_ID2information(rops[0].id32, nvinfo, sizeof(nvinfo));
+                yDebug() << "HostTransceiver::" << caller << "(): the ROPs for BOARD /w IP" << remoteipstring << "are queued ONLY at attempt num " << i+1 <<
+                            "with id: " << nvinfo;
+            }
+            return true;
+        }
+
+        char nvinfo[128];
+        eoprot_ID2information(rops[0].id32, nvinfo, sizeof(nvinfo));
+        yWarning() << "HostTransceiver::" << caller << "(): the queue of the ROPs for BOARD /w IP" << remoteipstring << "is full at attempt num " << i+1 <<
+                      "with id: " << nvinfo;
+
+        yarp::os::Time::delay(delayAfterROPloadingFailure);
+    }
+
+    char nvinfo[128];
+    eoprot_ID2information(rops[0].id32, nvinfo, sizeof(nvinfo));
+    yError() << "HostTransceiver::" << caller << "(): ERROR the queue of the ROPs for BOARD w/ IP" << remoteipstring << "is still full after all attempts" <<
+                "with id: " << nvinfo;
 
+    return false;
+}
+
+
+// called by getUDP() only. the ROPs are loaded in the order they were queued and they leave the queue once loaded, thus if the
+// transceiver gets full the others stay queued for the next packet
+void HostTransceiver::loadQueuedROPs()
+{
+    pendingROPs.clear();
+    ROPqueue::ROP rop;
+    while(ropqueue.peek(pendingROPs.size(), rop))
+    {
+        pendingROPs.push_back(rop);
+    }
+
+    if(pendingROPs.empty())
+    {
+        return;
+    }
+
+    // walking backwards: an unsigned set<> is superseded if a later unsigned set<> of the same variable comes with no ask<> or
+    // signed set<> of that variable in between, as the signed ones and the ask<> expect a reply of their own
+    supersededROPs.assign(pendingROPs.size(), 0);
+    latestSetROPs.clear();
+    for(size_t i=pendingROPs.size(); i>0; i--)
+    {
+        const ROPqueue::ROP &r = pendingROPs[i-1];
+        std::vector<eOprotID32_t>::iterator it = std::find(latestSetROPs.begin(), latestSetROPs.end(), r.id32);
+        bool unsignedset = (eo_ropcode_set == r.ropcode) && (eo_rop_SIGNATUREdummy == r.signature);
+
+        if(true == unsignedset)
+        {
+            if(it != latestSetROPs.end())
+            {
+                supersededROPs[i-1] = 1;
+            }
+            else
+            {
+                latestSetROPs.push_back(r.id32);
             }
-            ret = true;
+        }
+        else if(it != latestSetROPs.end())
+        {
+            latestSetROPs.erase(it);
         }
     }
-    if(!ret)
+
+    eOresult_t eores = eores_OK;
+    size_t done = 0;
+
+    lock_transceiver(true);
+    for(; done < pendingROPs.size(); done++)
     {
-        char nvinfo[128];
-        eoprot_ID2information(id32, nvinfo, sizeof(nvinfo));
-        yError() << "HostTransceiver::addROPask(): ERROR in eo_transceiver_OccasionalROP_Load() for BOARD w/ IP" << remoteipstring << "after all attempts " <<
-                    "with id: " << nvinfo;
+        if(1 == supersededROPs[done])
+        {
+            continue;
+        }
+
+        const ROPqueue::ROP &r = pendingROPs[done];
+
+        eOropdescriptor_t ropdesc = {0};
+        memcpy(&ropdesc, &eok_ropdesc_basic, sizeof(eOropdescriptor_t));
+        ropdesc.control.plustime    = 1;
+        ropdesc.control.plussign    = (eo_rop_SIGNATUREdummy == r.signature) ? 0 : 1;
+        ropdesc.ropcode             = r.ropcode;
+        ropdesc.id32                = r.id32;
+        ropdesc.size                = 0;        // the size is internally computed from the id32
+        ropdesc.data                = reinterpret_cast<uint8_t *>(const_cast<void*>(r.data));
+        ropdesc.signature           = r.signature;
+
+        // the transceiver copies the data, thus the ROP can leave the queue
+        eores = eo_transceiver_OccasionalROP_Load(pc104txrx, &ropdesc);
+        if(eores_OK != eores)
+        {
+            break;
+        }
     }
+    lock_transceiver(false);
 
-    return ret;
+    ropqueue.release(done);
+
+    if(done < pendingROPs.size())
+    {
+        if(false == ropqueueStalled)
+        {
+            int32_t err = -1;
+            int32_t info0 = -1;
+            int32_t info1 = -1;
+            int32_t info2 = -1;
+            char nvinfo[128];
+            eoprot_ID2information(pendingROPs[done].id32, nvinfo, sizeof(nvinfo));
+            eo_transceiver_lasterror_tx_Get(pc104txrx, &err, &info0, &info1, &info2);
+            yWarning() << "HostTransceiver::loadQueuedROPs(): eo_transceiver_OccasionalROP_Load() for BOARD /w IP" << remoteipstring << "has loaded only" << done << "of" << pendingROPs.size() <<
+                          "queued ROPs: the others go in a later packet. first waiting id: " << nvinfo << "err=" << err << "infos = " << info0 << info1 << info2;
+        }
+        ropqueueStalled = true;
+    }
+    else
+    {
+        ropqueueStalled = false;
+    }
 }
 
 
@@ -592,6 +704,9 @@ const void * HostTransceiver::getUDP(size_t &size, uint16_t &numofrops)
     uint8_t *data = NULL;
     eOresult_t res;
 
+    // the ROPs of the application threads enter the transceiver only here, thus they never contend with the packet
+    loadQueuedROPs();
+
 
 #if !defined(HOSTTRANSCEIVER_EmptyROPframesAreTransmitted)
     // marco.accame: robotInterface uses only occasionals, thus we dont need to pass arguments for replies and regulars
@@ -45,7 +45,10 @@
 //#include "EOpacket.h"
 #include "EoProtocol.h"
 
+#include "ropQueue.h"
+
 #include <mutex>
+#include <vector>
 
 #include <yarp/os/Searchable.h>
 
@@ -85,10 +88,16 @@ namespace eth {
         // writes locally
         bool write(const eOprotID32_t id32, const void* data, bool forcewriteOfReadOnly);
 
-        // adds a set<> ROP to the UDP packet
+        // adds a set<> ROP to the UDP packet. the data is copied into the queue of the ROPs, which getUDP() loads into the transceiver,
+        // thus the caller never waits for the thread of the transmission. an unsigned set<> is superseded by a later unsigned set<> of
+        // the same variable which is queued before the next packet, unless there is an ask<> or a signed set<> of it in between.
         bool addROPset(const eOprotID32_t id32, const void* data, const uint32_t signature = eo_rop_SIGNATUREdummy);
 
-        // adds a ask<> ROP to the UDP packet
+        // adds many set<> ROPs to the UDP packet. they are queued all at once, thus they all leave in the same UDP packet and reach the
+        // board in the same cycle, unless they do not fit its free capacity
+        bool addROPsets(const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &data);
+
+        // adds a ask<> ROP to the UDP packet. it is queued as the set<> ROPs, thus their order is kept
         bool addROPask(const eOprotID32_t id32, const uint32_t signature = eo_rop_SIGNATUREdummy);
 
         // called inside the thread ethReceiver (by a call to TheEthManager::Reception() which calls ... etc.) to process incoming UDP packet.
@@ -99,6 +108,7 @@ namespace eth {
 
 
         // returns the pointer of the udp packet formed inside the transceiver. if nullptr then no data to transmit.
+        // it is called by the thread of the transmission only, which first loads the queued ROPs into the transceiver.
         const void * getUDP(size_t &size, uint16_t &numofrops);
 
 
@@ -131,6 +141,14 @@ namespace eth {
         enum { maxNumberOfROPloadingAttempts = 5 };
         double delayAfterROPloadingFailure;
 
+        // the ROPs of the application threads, waiting for getUDP(). the vectors are used only by the thread of the transmission
+        enum { capacityOfROPqueue = 128 };
+        ROPqueue ropqueue;
+        std::vector<ROPqueue::ROP> pendingROPs;
+        std::vector<uint8_t> supersededROPs;
+        std::vector<eOprotID32_t> latestSetROPs;
+        bool ropqueueStalled;
+
 
     private:
 
@@ -149,6 +167,10 @@ namespace eth {
 
 
         bool addSetROP__(const eOprotID32_t id32, const void* data, const uint32_t signature, bool writelocalrxcache = false);
+
+        bool queueROPs__(const ROPqueue::ROP *rops, size_t n, const char *caller);
+
+        void loadQueuedROPs();
 //        bool addGetROP__(eOprotID32_t id32, uint32_t signature);
 
         bool initProtocol();
@@ -0,0 +1,195 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - public interface
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "ropQueue.h"
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - external dependencies
+// --------------------------------------------------------------------------------------------------------------------
+
+#include <cstring>
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - the class
+// --------------------------------------------------------------------------------------------------------------------
+
+bool eth::ROPqueue::init(size_t capacity, size_t maxdatasize)
+{
+    if((0 == capacity) || (!cells.empty()))
+    {
+        return false;
+    }
+
+    size_t size = 1;
+    while(size < capacity)
+    {
+        size <<= 1;
+    }
+
+    // the cells hold atomics, thus they are built in place and never moved
+    std::vector<Cell> tmp(size);
+    cells.swap(tmp);
+    for(size_t i=0; i<size; i++)
+    {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    storage.assign(size*maxdatasize, 0);
+    mask = size - 1;
+    this->maxdatasize = maxdatasize;
+    enqueuepos.store(0, std::memory_order_relaxed);
+    dequeuepos = 0;
+
+    return true;
+}
+
+
+void eth::ROPqueue::fill(Cell &cell, size_t index, const ROP &rop)
+{
+    cell.rop = rop;
+    if((nullptr == rop.data) || (0 == rop.size))
+    {
+        cell.rop.size = 0;
+        cell.rop.data = nullptr;
+        return;
+    }
+
+    uint8_t *slot = &storage[index*maxdatasize];
+    memcpy(slot, rop.data, rop.size);
+    cell.rop.data = slot;
+}
+
+
+bool eth::ROPqueue::push(const ROP &rop)
+{
+    return pushmany(&rop, 1);
+}
+
+
+bool eth::ROPqueue::pushmany(const ROP *rops, size_t n)
+{
+    if((nullptr == rops) || (0 == n) || (n > cells.size()))
+    {
+        return false;
+    }
+
+    for(size_t i=0; i<n; i++)
+    {
+        if((nullptr != rops[i].data) && (rops[i].size > maxdatasize))
+        {
+            return false;
+        }
+    }
+
+    // reserve n consecutive cells, all of which must be free
+    size_t pos = enqueuepos.load(std::memory_order_relaxed);
+    for(;;)
+    {
+        bool available = true;
+        bool stale = false;
+        for(size_t i=0; i<n; i++)
+        {
+            size_t seq = cells[(pos+i) & mask].sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos+i);
+            if(diff < 0)
+            {
+                available = false;  // not yet released by the consumer: the queue is full
+                break;
+            }
+            if(diff > 0)
+            {
+                stale = true;       // another producer has taken it
+                break;
+            }
+        }
+
+        if(!available)
+        {
+            return false;
+        }
+
+        if(!stale && enqueuepos.compare_exchange_weak(pos, pos+n, std::memory_order_relaxed))
+        {
+            break;
+        }
+
+        if(stale)
+        {
+            pos = enqueuepos.load(std::memory_order_relaxed);
+        }
+    }
+
+    for(size_t i=0; i<n; i++)
+    {
+        size_t index = (pos+i) & mask;
+        fill(cells[index], index, rops[i]);
+    }
+
+    // the consumer stops at the first cell not yet published, thus publishing the first cell last makes the whole
+    // group visible at once
+    for(size_t i=n; i>0; i--)
+    {
+        cells[(pos+i-1) & mask].sequence.store(pos+i, std::memory_order_release);
+    }
+
+    return true;
+}
+
+
+bool eth::ROPqueue::peek(size_t n, ROP &rop) const
+{
+    if(cells.empty() || (n >= cells.size()))
+    {
+        return false;
+    }
+
+    size_t pos = dequeuepos + n;
+    const Cell &cell = cells[pos & mask];
+    if(cell.sequence.load(std::memory_order_acquire) != pos+1)
+    {
+        return false;
+    }
+
+    rop = cell.rop;
+    return true;
+}
+
+
+void eth::ROPqueue::release(size_t n)
+{
+    for(size_t i=0; i<n; i++)
+    {
+        Cell &cell = cells[dequeuepos & mask];
+        cell.sequence.store(dequeuepos + cells.size(), std::memory_order_release);
+        dequeuepos++;
+    }
+}
+
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
@@ -0,0 +1,104 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+// - include guard ----------------------------------------------------------------------------------------------------
+
+#ifndef _ROPQUEUE_H_
+#define _ROPQUEUE_H_
+
+// -- class ROPqueue
+// -- the ROPs which the application threads address to a board, waiting for the thread of the transmission to load them
+// -- into the transceiver of the board just before it forms the UDP packet:
+// -- - push() and pushmany() can be called by any thread at the same time. they never block: they copy the ROP and
+// --   fail only if the queue is full. the ROPs of a pushmany() become visible all at once, thus they are loaded together.
+// -- - peek() and release() are called by one thread only, the thread of the transmission. the ROPs are peeked in the
+// --   order they were pushed, and they stay in the queue until they are released, e.g. when the transceiver is full.
+// -- it is a bounded queue whose slots carry a sequence number (as in the MPMC queue of D. Vyukov), hence the producers
+// -- only contend on one atomic counter and the consumer does not contend at all.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "EoProtocol.h"
+
+
+namespace eth {
+
+    class ROPqueue
+    {
+    public:
+
+        struct ROP
+        {
+            uint8_t         ropcode {0};        // an eOropcode_t
+            eOprotID32_t    id32 {0};
+            uint32_t        signature {0};
+            uint16_t        size {0};           // of data
+            const void      *data {nullptr};    // nullptr if no data. in peek() it points inside the queue
+        };
+
+        ROPqueue() = default;
+        ~ROPqueue() = default;
+
+        // capacity is rounded up to a power of two. maxdatasize is the largest data of a ROP
+        bool init(size_t capacity, size_t maxdatasize);
+
+        bool push(const ROP &rop);
+        bool pushmany(const ROP *rops, size_t n);
+        bool pushmany(const std::vector<ROP> &rops) { return rops.empty() || pushmany(rops.data(), rops.size()); }
+
+        // the n-th ROP from the head, which must have been pushed completely. false if there is no such a ROP
+        bool peek(size_t n, ROP &rop) const;
+
+        // removes the first n ROPs, which must have been peeked
+        void release(size_t n);
+
+        size_t capacity() const { return cells.size(); }
+
+    private:
+
+        struct Cell
+        {
+            std::atomic<size_t> sequence {0};
+            ROP rop;
+        };
+
+        void fill(Cell &cell, size_t index, const ROP &rop);
+
+        std::vector<Cell> cells;
+        std::vector<uint8_t> storage;
+        size_t mask {0};
+        size_t maxdatasize {0};
+
+        std::atomic<size_t> enqueuepos {0};
+        size_t dequeuepos {0};                  // used only by the consumer
+
+        ROPqueue(const ROPqueue&) = delete;
+        ROPqueue& operator=(const ROPqueue&) = delete;
+    };
+
+} // namespace eth
+
+
+#endif  // include-guard
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
@@ -0,0 +1,174 @@
+// -*- Mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - public interface
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "sensorsBuffer.h"
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - external dependencies
+// --------------------------------------------------------------------------------------------------------------------
+
+#include <cstring>
+#include <thread>
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - the class
+// --------------------------------------------------------------------------------------------------------------------
+
+
+// - class eth::SensorsBuffer
+
+eth::SensorsBuffer::SensorsBuffer(size_t numberofsensors, size_t historysize) :
+    version(0), latestsamples(numberofsensors), historysize(historysize), slots(new Slot[historysize]), head(0), tail(0)
+{
+    for(auto &l : latestsamples)
+    {
+        l.valid = false;
+        memset(&l.sample, 0, sizeof(l.sample));
+    }
+
+    for(size_t i=0; i<historysize; i++)
+    {
+        slots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+}
+
+
+eth::SensorsBuffer::~SensorsBuffer()
+{
+}
+
+
+void eth::SensorsBuffer::put(size_t index, const SensorSample &sample)
+{
+    if(index >= latestsamples.size())
+    {
+        return;
+    }
+
+    // the latest sample
+    uint64_t v = version.load(std::memory_order_relaxed);
+    version.store(v+1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    latestsamples[index].sample = sample;
+    latestsamples[index].valid = true;
+    version.store(v+2, std::memory_order_release);
+
+    // the history, as done by EthCapture::record() but with a single writer
+    if(0 == historysize)
+    {
+        return;
+    }
+
+    uint64_t n = head.load(std::memory_order_relaxed);
+    Slot &slot = slots[n % historysize];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.sample = sample;
+    slot.sequence.store(n+1, std::memory_order_release);
+    head.store(n+1, std::memory_order_release);
+}
+
+
+void eth::SensorsBuffer::latest(std::vector<SensorSample> &samples) const
+{
+    std::vector<Latest> copy(latestsamples.size());
+
+    for(;;)
+    {
+        uint64_t v1 = version.load(std::memory_order_acquire);
+        if(0 == (v1 & 1))
+        {
+            memcpy(copy.data(), latestsamples.data(), latestsamples.size()*sizeof(Latest));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if(v1 == version.load(std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        // the writer holds the table only for the copy of a sample
+        std::this_thread::yield();
+    }
+
+    samples.clear();
+    for(const auto &l : copy)
+    {
+        if(true == l.valid)
+        {
+            samples.push_back(l.sample);
+        }
+    }
+}
+
+
+void eth::SensorsBuffer::history(std::vector<SensorSample> &samples, uint64_t &lost)
+{
+    samples.clear();
+    lost = 0;
+
+    if(0 == historysize)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lck(readermtx);
+
+    uint64_t h = head.load(std::memory_order_acquire);
+    if(h - tail > historysize)
+    {
+        lost += h - historysize - tail;
+        tail = h - historysize;
+    }
+
+    samples.reserve(h - tail);
+    for(uint64_t n=tail; n<h; n++)
+    {
+        const Slot &slot = slots[n % historysize];
+        SensorSample s;
+        uint64_t s1 = slot.sequence.load(std::memory_order_acquire);
+        memcpy(&s, &slot.sample, sizeof(s));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t s2 = slot.sequence.load(std::memory_order_relaxed);
+        if((n+1 == s1) && (s1 == s2))
+        {
+            samples.push_back(s);
+        }
+        else
+        {   // the writer has reused the slot while we were reading
+            lost++;
+        }
+    }
+    tail = h;
+}
+
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
+
+
+
@@ -0,0 +1,129 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+// - include guard ----------------------------------------------------------------------------------------------------
+
+#ifndef _SENSORSBUFFER_H_
+#define _SENSORSBUFFER_H_
+
+// -- struct SensorSample
+// -- a sample of one sensor of a device: its values and its timestamp.
+// -- class IbulkSensors
+// -- it is implemented by the devices with many sensors (embObjMultipleFTsensors, embObjIMU) to give the samples of all of
+// -- them in a single call, rather than one locked call per sensor.
+// -- class SensorsBuffer
+// -- it keeps the samples written by the update() of the device, which runs in the ethReceiver thread, and gives them to
+// -- any number of readers without blocking the writer:
+// -- - the latest sample of every sensor is kept in a table protected by a sequence counter (seqlock): the writer never
+// --   waits, a reader copies the table and copies it again if the writer has changed it in the meantime.
+// -- - every sample is also kept in a ring of historysize samples, so that a consumer can get all the samples received
+// --   since its previous read, e.g. the full 1 kHz stream of the FT sensors. the ring has a single read position, thus
+// --   it is meant for a single consumer.
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+namespace eth {
+
+    struct SensorSample
+    {
+        enum { maxvalues = 6 };
+
+        uint8_t     type;                  // the kind of sensor, as defined by the device (e.g. the eOas_sensor_t for embObjIMU)
+        uint8_t     size;                  // number of valid values
+        uint16_t    sensor;                // the index of the sensor, as used by the per-sensor getters of the device for its type
+        double      values[maxvalues];
+        double      timestamp;             // the same timestamp given by the per-sensor getters of the device
+    };
+
+
+    class IbulkSensors
+    {
+    public:
+        virtual ~IbulkSensors() {}
+
+        // it gives the latest sample of every sensor which has received at least one
+        virtual bool getLatestSensorSamples(std::vector<SensorSample> &samples) const = 0;
+
+        // it gives in order of arrival the samples received since the previous call, up to the size of the history.
+        // lost is the number of samples which were overwritten before being read
+        virtual bool getNewSensorSamples(std::vector<SensorSample> &samples, uint64_t &lost) = 0;
+    };
+
+
+    class SensorsBuffer
+    {
+    public:
+
+        SensorsBuffer(size_t numberofsensors, size_t historysize);
+        ~SensorsBuffer();
+
+        // it must be called by a single thread. a sample with index >= numberofsensors is discarded
+        void put(size_t index, const SensorSample &sample);
+
+        // they can be called by any thread, concurrently with put()
+        void latest(std::vector<SensorSample> &samples) const;
+        void history(std::vector<SensorSample> &samples, uint64_t &lost);
+
+    private:
+
+        struct Latest
+        {
+            bool valid;
+            SensorSample sample;
+        };
+
+        struct Slot
+        {
+            std::atomic<uint64_t> sequence;        // 1 + number of the sample in the slot, 0 while it is written
+            SensorSample sample;
+        };
+
+        // the latest samples: version is odd while the writer changes them
+        std::atomic<uint64_t> version;
+        std::vector<Latest> latestsamples;
+
+        // the history: head is the number of samples written so far
+        size_t historysize;
+        std::unique_ptr<Slot[]> slots;
+        std::atomic<uint64_t> head;
+
+        // the read position of the history, shared by its readers
+        std::mutex readermtx;
+        uint64_t tail;
+    };
+
+
+} // namespace eth
+
+
+#endif  // include-guard
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
+
+
+
+
+
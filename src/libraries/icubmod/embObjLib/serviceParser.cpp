@@ -566,7 +566,10 @@ bool ServiceParser::check_analog(Searchable &config, eOmn_serv_type_t type)
 
     // format is SERVICE{ type, PROPERTIES{ CANBOARDS, SENSORS }, SETTINGS }
 
-    Bottle b_SERVICE(config.findGroup("SERVICE"));
+    _config.clear();
+    _config.build(config);
+
+    Bottle &b_SERVICE = _config.findGroup("SERVICE");
     if(b_SERVICE.isNull())
     {
         yError() << "ServiceParser::check_analog() cannot find SERVICE group";
@@ -597,7 +600,7 @@ bool ServiceParser::check_analog(Searchable &config, eOmn_serv_type_t type)
 
     // check whether we have the proper groups
 
-    Bottle b_PROPERTIES = Bottle(b_SERVICE.findGroup("PROPERTIES"));
+    Bottle &b_PROPERTIES = _config.findGroup(b_SERVICE, "PROPERTIES");
     if(b_PROPERTIES.isNull())
     {
         yError() << "ServiceParser::check_analog() cannot find PROPERTIES";
@@ -605,7 +608,7 @@ bool ServiceParser::check_analog(Searchable &config, eOmn_serv_type_t type)
     }
     else
     {
-        Bottle b_PROPERTIES_CANBOARDS = Bottle(b_PROPERTIES.findGroup("CANBOARDS"));
+        Bottle &b_PROPERTIES_CANBOARDS = _config.findGroup(b_PROPERTIES, "CANBOARDS");
         if(b_PROPERTIES_CANBOARDS.isNull())
         {
             yError() << "ServiceParser::check() cannot find PROPERTIES.CANBOARDS";
@@ -616,49 +619,49 @@ bool ServiceParser::check_analog(Searchable &config, eOmn_serv_type_t type)
             // now get type, PROTOCOL.major/minor, FIRMWARE.major/minor/build and see their sizes. the must be all equal.
             // for mais and strain and so far for intertials it must be numboards = 1.
 
-            Bottle b_PROPERTIES_CANBOARDS_type = b_PROPERTIES_CANBOARDS.findGroup("type");
+            Bottle &b_PROPERTIES_CANBOARDS_type = _config.findGroup(b_PROPERTIES_CANBOARDS, "type");
             if(b_PROPERTIES_CANBOARDS_type.isNull())
             {
                 yError() << "ServiceParser::check() cannot find PROPERTIES.CANBOARDS.type";
                 return false;
             }
-            Bottle b_PROPERTIES_CANBOARDS_PROTOCOL = Bottle(b_PROPERTIES_CANBOARDS.findGroup("PROTOCOL"));
+            Bottle &b_PROPERTIES_CANBOARDS_PROTOCOL = _config.findGroup(b_PROPERTIES_CANBOARDS, "PROTOCOL");
             if(b_PROPERTIES_CANBOARDS_PROTOCOL.isNull())
             {
                 yError() << "ServiceParser::check() cannot find PROPERTIES.CANBOARDS.PROTOCOL";
                 return false;
             }
-            Bottle b_PROPERTIES_CANBOARDS_PROTOCOL_major = Bottle(b_PROPERTIES_CANBOARDS_PROTOCOL.findGroup("major"));
+            Bottle &b_PROPERTIES_CANBOARDS_PROTOCOL_major = _config.findGroup(b_PROPERTIES_CANBOARDS_PROTOCOL, "major");
             if(b_PROPERTIES_CANBOARDS_PROTOCOL_major.isNull())
             {
                 yError() << "ServiceParser::check() cannot find PROPERTIES.CANBOARDS.PROTOCOL.major";
                 return false;
             }
-            Bottle b_PROPERTIES_CANBOARDS_PROTOCOL_minor = Bottle(b_PROPERTIES_CANBOARDS_PROTOCOL.findGroup("minor"));
+            Bottle &b_PROPERTIES_CANBOARDS_PROTOCOL_minor = _config.findGroup(b_PROPERTIES_CANBOARDS_PROTOCOL, "minor");
             if(b_PROPERTIES_CANBOARDS_PROTOCOL_minor.isNull())
             {
                 yError() << "ServiceParser::check() cannot find PROPERTIES.CANBOARDS.PROTOCOL.minor";
                 return false;
             }
-            Bottle b_PROPERTIES_CANBOARDS_FIRMWARE = Bottle(b_PROPERTIES_CANBOARDS.findGroup("FIRMWARE"));
+            Bottle &b_PROPERTIES_CANBOARDS_FIRMWARE = _config.findGroup(b_PROPERTIES_CANBOARDS, "FIRMWARE");
             if(b_PROPERTIES_CANBOARDS_FIRMWARE.isNull())
             {
                 yError() << "ServiceParser::check() cannot find PROPERTIES.CANBOARDS.FIRMWARE";
                 return false;
             }
-            Bottle b_PROPERTIES_CANBOARDS_FIRMWARE_major = Bottle(b_PROPERTIES_CANBOARDS_FIRMWARE.findGroup("major"));
+            Bottle &b_PROPERTIES_CANBOARDS_FIRMWARE_major = _config.findGroup(b_PROPERTIES_CANBOARDS_FIRMWARE, "major");
             if(b_PROPERTIES_CANBOARDS_FIRMWARE_major.isNull())
             {
                 yError() << "ServiceParser::check() cannot find PROPERTIES.CANBOARDS.FIRMWARE.major";
                 return false;
             }
-            Bottle b_PROPERTIES_CANBOARDS_FIRMWARE_minor = Bottle(b_PROPERTIES_CANBOARDS_FIRMWARE.findGroup("minor"));
+            Bottle &b_PROPERTIES_CANBOARDS_FIRMWARE_minor = _config.findGroup(b_PROPERTIES_CANBOARDS_FIRMWARE, "minor");
             if(b_PROPERTIES_CANBOARDS_FIRMWARE_minor.isNull())
             {
                 yError() << "ServiceParser::check() cannot find PROPERTIES.CANBOARDS.FIRMWARE.minor";
                 return false;
             }
-            Bottle b_PROPERTIES_CANBOARDS_FIRMWARE_build = Bottle(b_PROPERTIES_CANBOARDS_FIRMWARE.findGroup("build"));
+            Bottle &b_PROPERTIES_CANBOARDS_FIRMWARE_build = _config.findGroup(b_PROPERTIES_CANBOARDS_FIRMWARE, "build");
             if(b_PROPERTIES_CANBOARDS_FIRMWARE_build.isNull())
             {
                 yError() << "ServiceParser::check() cannot find PROPERTIES.CANBOARDS.FIRMWARE.build";
@@ -709,7 +712,7 @@ bool ServiceParser::check_analog(Searchable &config, eOmn_serv_type_t type)
             }
         }
 
-        Bottle b_PROPERTIES_SENSORS = Bottle(b_PROPERTIES.findGroup("SENSORS"));
+        Bottle &b_PROPERTIES_SENSORS = _config.findGroup(b_PROPERTIES, "SENSORS");
         if(b_PROPERTIES_SENSORS.isNull())
         {
             yError() << "ServiceParser::check_analog() cannot find PROPERTIES.SENSORS";
@@ -718,25 +721,25 @@ bool ServiceParser::check_analog(Searchable &config, eOmn_serv_type_t type)
         else
         {
 
-            Bottle b_PROPERTIES_SENSORS_id = Bottle(b_PROPERTIES_SENSORS.findGroup("id"));
+            Bottle &b_PROPERTIES_SENSORS_id = _config.findGroup(b_PROPERTIES_SENSORS, "id");
             if(b_PROPERTIES_SENSORS_id.isNull())
             {
                 yError() << "ServiceParser::check_analog() cannot find PROPERTIES.SENSORS.id";
                 return false;
             }
-            Bottle b_PROPERTIES_SENSORS_type = Bottle(b_PROPERTIES_SENSORS.findGroup("type"));
+            Bottle &b_PROPERTIES_SENSORS_type = _config.findGroup(b_PROPERTIES_SENSORS, "type");
             if(b_PROPERTIES_SENSORS_type.isNull())
             {
                 yError() << "ServiceParser::check_analog() cannot find PROPERTIES.SENSORS.type";
                 return false;
             }
-            Bottle b_PROPERTIES_SENSORS_location = Bottle(b_PROPERTIES_SENSORS.findGroup("location"));
+            Bottle &b_PROPERTIES_SENSORS_location = _config.findGroup(b_PROPERTIES_SENSORS, "location");
             if(b_PROPERTIES_SENSORS_location.isNull())
             {
                 yError() << "ServiceParser::check_analog() cannot find PROPERTIES.SENSORS.location";
                 return false;
             }
-            Bottle b_PROPERTIES_SENSORS_frameName = Bottle(b_PROPERTIES_SENSORS.findGroup("framename"));
+            Bottle &b_PROPERTIES_SENSORS_frameName = _config.findGroup(b_PROPERTIES_SENSORS, "framename");
             if(b_PROPERTIES_SENSORS_frameName.isNull() && eoas_string2sensor(b_PROPERTIES_SENSORS_type.get(1).asString().c_str())==eoas_strain)
             {
                 yWarning() << "ServiceParser::check_analog() cannot find PROPERTIES.SENSORS.framename";
@@ -745,7 +748,7 @@ bool ServiceParser::check_analog(Searchable &config, eOmn_serv_type_t type)
             if((eomn_serv_AS_inertials3 == type) || (eomn_serv_AS_pos == type))
             {
                 
-                b_PROPERTIES_SENSORS_boardType = Bottle(b_PROPERTIES_SENSORS.findGroup("boardType"));
+                b_PROPERTIES_SENSORS_boardType = Bottle(_config.findGroup(b_PROPERTIES_SENSORS, "boardType"));
                 if(b_PROPERTIES_SENSORS_boardType.isNull())
                 {
                     yError() << "ServiceParser::check_analog() cannot find PROPERTIES.SENSORS.boardType";
@@ -768,44 +771,44 @@ bool ServiceParser::check_analog(Searchable &config, eOmn_serv_type_t type)
             // add params proper only of POS
             if(type == eomn_serv_AS_pos)
             {
-                b_PROPERTIES_SENSORS_pos_port = Bottle(b_PROPERTIES_SENSORS.findGroup("port"));
+                b_PROPERTIES_SENSORS_pos_port = Bottle(_config.findGroup(b_PROPERTIES_SENSORS, "port"));
                 if(b_PROPERTIES_SENSORS_pos_port.isNull())
                 {
                     yError() << "ServiceParser::check_analog() cannot find PROPERTIES.SENSORS.port";
                     return false;
                 }
 
-                b_PROPERTIES_SENSORS_pos_connector = Bottle(b_PROPERTIES_SENSORS.findGroup("connector"));
+                b_PROPERTIES_SENSORS_pos_connector = Bottle(_config.findGroup(b_PROPERTIES_SENSORS, "connector"));
                 if(b_PROPERTIES_SENSORS_pos_connector.isNull())
                 {
                     yError() << "ServiceParser::check_analog() cannot find PROPERTIES.SENSORS.connector";
                     return false;
                 }
 
-                b_PROPERTIES_SENSORS_pos_CALIBRATION = Bottle(b_PROPERTIES_SENSORS.findGroup("CALIBRATION"));
+                b_PROPERTIES_SENSORS_pos_CALIBRATION = Bottle(_config.findGroup(b_PROPERTIES_SENSORS, "CALIBRATION"));
                 if(b_PROPERTIES_SENSORS_pos_CALIBRATION.isNull())
                 {
                     yWarning() << "ServiceParser::check_analog() cannot find PROPERTIES.SENSORS.CALIBRATION. Using neutral values (ROT:zero, 0.0, false)";
                 }
                 else
                 {
-                    b_PROPERTIES_SENSORS_pos_CALIBRATION_type = Bottle(b_PROPERTIES_SENSORS_pos_CALIBRATION.findGroup("type"));
+                    b_PROPERTIES_SENSORS_pos_CALIBRATION_type = Bottle(_config.findGroup(b_PROPERTIES_SENSORS_pos_CALIBRATION, "type"));
                     if(b_PROPERTIES_SENSORS_pos_CALIBRATION_type.isNull())
                     {
                         yWarning() << "ServiceParser::check_analog() cannot find PROPERTIES.SENSORS.CALIBRATION.type. Using value TYPE::decideg";
                     }
 
-                    b_PROPERTIES_SENSORS_pos_CALIBRATION_rotation = Bottle(b_PROPERTIES_SENSORS_pos_CALIBRATION.findGroup("rotation"));
+                    b_PROPERTIES_SENSORS_pos_CALIBRATION_rotation = Bottle(_config.findGroup(b_PROPERTIES_SENSORS_pos_CALIBRATION, "rotation"));
                     if(b_PROPERTIES_SENSORS_pos_CALIBRATION_rotation.isNull())
                     {
                         yWarning() << "ServiceParser::check_analog() cannot find PROPERTIES.SENSORS.CALIBRATION.rotation. Using value ROT::zero";
                     }
-                    b_PROPERTIES_SENSORS_pos_CALIBRATION_offset = Bottle(b_PROPERTIES_SENSORS_pos_CALIBRATION.findGroup("offset"));
+                    b_PROPERTIES_SENSORS_pos_CALIBRATION_offset = Bottle(_config.findGroup(b_PROPERTIES_SENSORS_pos_CALIBRATION, "offset"));
                     if(b_PROPERTIES_SENSORS_pos_CALIBRATION_offset.isNull())
                     {
                         yWarning() << "ServiceParser::check_analog() cannot find PROPERTIES.SENSORS.CALIBRATION.offset. Using value 0.0";
                     }
-                    b_PROPERTIES_SENSORS_pos_CALIBRATION_invertDirection = Bottle(b_PROPERTIES_SENSORS_pos_CALIBRATION.findGroup("invertDirection"));
+                    b_PROPERTIES_SENSORS_pos_CALIBRATION_invertDirection = Bottle(_config.findGroup(b_PROPERTIES_SENSORS_pos_CALIBRATION, "invertDirection"));
                     if(b_PROPERTIES_SENSORS_pos_CALIBRATION_invertDirection.isNull())
                     {
                         yWarning() << "ServiceParser::check_analog() cannot find PROPERTIES.SENSORS.CALIBRATION.invertDirection. Using value false";
@@ -918,7 +921,7 @@ bool ServiceParser::check_analog(Searchable &config, eOmn_serv_type_t type)
 
     }
 
-    Bottle b_SETTINGS = Bottle(b_SERVICE.findGroup("SETTINGS"));
+    Bottle &b_SETTINGS = _config.findGroup(b_SERVICE, "SETTINGS");
     if(b_SETTINGS.isNull())
     {
         yError() << "ServiceParser::check_analog() cannot find SETTINGS";
@@ -927,13 +930,13 @@ bool ServiceParser::check_analog(Searchable &config, eOmn_serv_type_t type)
     else
     {
 
-        Bottle b_SETTINGS_acquisitionRate = Bottle(b_SETTINGS.findGroup("acquisitionRate"));
+        Bottle &b_SETTINGS_acquisitionRate = _config.findGroup(b_SETTINGS, "acquisitionRate");
         if(b_SETTINGS_acquisitionRate.isNull())
         {
             yError() << "ServiceParser::check_analog() cannot find SETTINGS.acquisitionRate";
             return false;
         }
-        Bottle b_SETTINGS_enabledSensors = Bottle(b_SETTINGS.findGroup("enabledSensors"));
+        Bottle &b_SETTINGS_enabledSensors = _config.findGroup(b_SETTINGS, "enabledSensors");
         if(b_SETTINGS_enabledSensors.isNull())
         {
             yError() << "ServiceParser::check_analog() cannot find SETTINGS.enabledSensors";
@@ -1003,7 +1006,7 @@ bool ServiceParser::check_analog(Searchable &config, eOmn_serv_type_t type)
 
     if(eomn_serv_AS_strain == type)
     {
-        Bottle b_STRAIN_SETTINGS = Bottle(b_SERVICE.findGroup("STRAIN_SETTINGS"));
+        Bottle &b_STRAIN_SETTINGS = _config.findGroup(b_SERVICE, "STRAIN_SETTINGS");
         if(b_STRAIN_SETTINGS.isNull())
         {
             yError() << "ServiceParser::check_analog() cannot find STRAIN_SETTINGS";
@@ -1012,7 +1015,7 @@ bool ServiceParser::check_analog(Searchable &config, eOmn_serv_type_t type)
         else
         {
 
-            Bottle b_STRAIN_SETTINGS_useCalibration = Bottle(b_STRAIN_SETTINGS.findGroup("useCalibration"));
+            Bottle &b_STRAIN_SETTINGS_useCalibration = _config.findGroup(b_STRAIN_SETTINGS, "useCalibration");
             if(b_STRAIN_SETTINGS_useCalibration.isNull())
             {
                 yError() << "ServiceParser::check_analog() cannot find STRAIN_SETTINGS.useCalibration";
@@ -1051,7 +1054,10 @@ bool ServiceParser::check_skin(Searchable &config)
     // however: if w dont have the SERVICE group we return false so that the caller can use default values
 
 
-    Bottle b_SERVICE(config.findGroup("SERVICE"));
+    _config.clear();
+    _config.build(config);
+
+    Bottle &b_SERVICE = _config.findGroup("SERVICE");
     if(b_SERVICE.isNull())
     {
         // yWarning() << "ServiceParser::check_skin() cannot find SERVICE group";
@@ -1082,7 +1088,7 @@ bool ServiceParser::check_skin(Searchable &config)
 
     // check whether we have the proper groups
 
-    Bottle b_PROPERTIES = Bottle(b_SERVICE.findGroup("PROPERTIES"));
+    Bottle &b_PROPERTIES = _config.findGroup(b_SERVICE, "PROPERTIES");
     if(b_PROPERTIES.isNull())
     {
         yWarning() << "ServiceParser::check_skin() cannot find PROPERTIES";
@@ -1090,7 +1096,7 @@ bool ServiceParser::check_skin(Searchable &config)
     }
     else
     {
-        Bottle b_PROPERTIES_CANBOARDS = Bottle(b_PROPERTIES.findGroup("CANBOARDS"));
+        Bottle &b_PROPERTIES_CANBOARDS = _config.findGroup(b_PROPERTIES, "CANBOARDS");
         if(b_PROPERTIES_CANBOARDS.isNull())
         {
             yWarning() << "ServiceParser::check() cannot find PROPERTIES.CANBOARDS";
@@ -1101,49 +1107,49 @@ bool ServiceParser::check_skin(Searchable &config)
             // now get type, PROTOCOL.major/minor, FIRMWARE.major/minor/build and see their sizes. the must be all equal.
             // for skin it must be numboards = 1.
 
-            Bottle b_PROPERTIES_CANBOARDS_type = b_PROPERTIES_CANBOARDS.findGroup("type");
+            Bottle &b_PROPERTIES_CANBOARDS_type = _config.findGroup(b_PROPERTIES_CANBOARDS, "type");
             if(b_PROPERTIES_CANBOARDS_type.isNull())
             {
                 yError() << "ServiceParser::check_skin() cannot find PROPERTIES.CANBOARDS.type";
                 return false;
             }
-            Bottle b_PROPERTIES_CANBOARDS_PROTOCOL = Bottle(b_PROPERTIES_CANBOARDS.findGroup("PROTOCOL"));
+            Bottle &b_PROPERTIES_CANBOARDS_PROTOCOL = _config.findGroup(b_PROPERTIES_CANBOARDS, "PROTOCOL");
             if(b_PROPERTIES_CANBOARDS_PROTOCOL.isNull())
             {
                 yError() << "ServiceParser::check_skin() cannot find PROPERTIES.CANBOARDS.PROTOCOL";
                 return false;
             }
-            Bottle b_PROPERTIES_CANBOARDS_PROTOCOL_major = Bottle(b_PROPERTIES_CANBOARDS_PROTOCOL.findGroup("major"));
+            Bottle &b_PROPERTIES_CANBOARDS_PROTOCOL_major = _config.findGroup(b_PROPERTIES_CANBOARDS_PROTOCOL, "major");
             if(b_PROPERTIES_CANBOARDS_PROTOCOL_major.isNull())
             {
                 yError() << "ServiceParser::check_skin() cannot find PROPERTIES.CANBOARDS.PROTOCOL.major";
                 return false;
             }
-            Bottle b_PROPERTIES_CANBOARDS_PROTOCOL_minor = Bottle(b_PROPERTIES_CANBOARDS_PROTOCOL.findGroup("minor"));
+            Bottle &b_PROPERTIES_CANBOARDS_PROTOCOL_minor = _config.findGroup(b_PROPERTIES_CANBOARDS_PROTOCOL, "minor");
             if(b_PROPERTIES_CANBOARDS_PROTOCOL_minor.isNull())
             {
                 yError() << "ServiceParser::check_skin() cannot find PROPERTIES.CANBOARDS.PROTOCOL.minor";
                 return false;
             }
-            Bottle b_PROPERTIES_CANBOARDS_FIRMWARE = Bottle(b_PROPERTIES_CANBOARDS.findGroup("FIRMWARE"));
+            Bottle &b_PROPERTIES_CANBOARDS_FIRMWARE = _config.findGroup(b_PROPERTIES_CANBOARDS, "FIRMWARE");
             if(b_PROPERTIES_CANBOARDS_FIRMWARE.isNull())
             {
                 yError() << "ServiceParser::check_skin() cannot find PROPERTIES.CANBOARDS.FIRMWARE";
                 return false;
             }
-            Bottle b_PROPERTIES_CANBOARDS_FIRMWARE_major = Bottle(b_PROPERTIES_CANBOARDS_FIRMWARE.findGroup("major"));
+            Bottle &b_PROPERTIES_CANBOARDS_FIRMWARE_major = _config.findGroup(b_PROPERTIES_CANBOARDS_FIRMWARE, "major");
             if(b_PROPERTIES_CANBOARDS_FIRMWARE_major.isNull())
             {
                 yError() << "ServiceParser::check_skin() cannot find PROPERTIES.CANBOARDS.FIRMWARE.major";
                 return false;
             }
-            Bottle b_PROPERTIES_CANBOARDS_FIRMWARE_minor = Bottle(b_PROPERTIES_CANBOARDS_FIRMWARE.findGroup("minor"));
+            Bottle &b_PROPERTIES_CANBOARDS_FIRMWARE_minor = _config.findGroup(b_PROPERTIES_CANBOARDS_FIRMWARE, "minor");
             if(b_PROPERTIES_CANBOARDS_FIRMWARE_minor.isNull())
             {
                 yError() << "ServiceParser::check_skin() cannot find PROPERTIES.CANBOARDS.FIRMWARE.minor";
                 return false;
             }
-            Bottle b_PROPERTIES_CANBOARDS_FIRMWARE_build = Bottle(b_PROPERTIES_CANBOARDS_FIRMWARE.findGroup("build"));
+            Bottle &b_PROPERTIES_CANBOARDS_FIRMWARE_build = _config.findGroup(b_PROPERTIES_CANBOARDS_FIRMWARE, "build");
             if(b_PROPERTIES_CANBOARDS_FIRMWARE_build.isNull())
             {
                 yError() << "ServiceParser::check_skin() cannot find PROPERTIES.CANBOARDS.FIRMWARE.build";
@@ -1198,7 +1204,7 @@ bool ServiceParser::check_skin(Searchable &config)
 #if 0
         // we dont have this group yet
 
-        Bottle b_PROPERTIES_SENSORS = Bottle(b_PROPERTIES.findGroup("SENSORS"));
+        Bottle &b_PROPERTIES_SENSORS = _config.findGroup(b_PROPERTIES, "SENSORS");
         if(b_PROPERTIES_SENSORS.isNull())
         {
             yError() << "ServiceParser::check() cannot find PROPERTIES.SENSORS";
@@ -1207,19 +1213,19 @@ bool ServiceParser::check_skin(Searchable &config)
         else
         {
 
-            Bottle b_PROPERTIES_SENSORS_id = Bottle(b_PROPERTIES_SENSORS.findGroup("id"));
+            Bottle &b_PROPERTIES_SENSORS_id = _config.findGroup(b_PROPERTIES_SENSORS, "id");
             if(b_PROPERTIES_SENSORS_id.isNull())
             {
                 yError() << "ServiceParser::check() cannot find PROPERTIES.SENSORS.id";
                 return false;
             }
-            Bottle b_PROPERTIES_SENSORS_type = Bottle(b_PROPERTIES_SENSORS.findGroup("type"));
+            Bottle &b_PROPERTIES_SENSORS_type = _config.findGroup(b_PROPERTIES_SENSORS, "type");
             if(b_PROPERTIES_SENSORS_type.isNull())
             {
                 yError() << "ServiceParser::check() cannot find PROPERTIES.SENSORS.type";
                 return false;
             }
-            Bottle b_PROPERTIES_SENSORS_location = Bottle(b_PROPERTIES_SENSORS.findGroup("location"));
+            Bottle &b_PROPERTIES_SENSORS_location = _config.findGroup(b_PROPERTIES_SENSORS, "location");
             if(b_PROPERTIES_SENSORS_location.isNull())
             {
                 yError() << "ServiceParser::check() cannot find PROPERTIES.SENSORS.location";
@@ -1229,7 +1235,7 @@ bool ServiceParser::check_skin(Searchable &config)
             if(type == eomn_serv_AS_inertials3)
             {
 
-                b_PROPERTIES_SENSORS_boardtype = Bottle(b_PROPERTIES_SENSORS.findGroup("boardType"));
+                b_PROPERTIES_SENSORS_boardtype = Bottle(_config.findGroup(b_PROPERTIES_SENSORS, "boardType"));
                 if(b_PROPERTIES_SENSORS_boardtype.isNull())
                 {
                     yError() << "ServiceParser::check() cannot find PROPERTIES.SENSORS.boardType";
@@ -1298,7 +1304,7 @@ bool ServiceParser::check_skin(Searchable &config)
 
     // we dont have this group yet
 
-    Bottle b_SETTINGS = Bottle(b_SERVICE.findGroup("SETTINGS"));
+    Bottle &b_SETTINGS = _config.findGroup(b_SERVICE, "SETTINGS");
     if(b_SETTINGS.isNull())
     {
         yError() << "ServiceParser::check() cannot find SETTINGS";
@@ -1307,13 +1313,13 @@ bool ServiceParser::check_skin(Searchable &config)
     else
     {
 
-        Bottle b_SETTINGS_acquisitionRate = Bottle(b_SETTINGS.findGroup("acquisitionRate"));
+        Bottle &b_SETTINGS_acquisitionRate = _config.findGroup(b_SETTINGS, "acquisitionRate");
         if(b_SETTINGS_acquisitionRate.isNull())
         {
             yError() << "ServiceParser::check() cannot find SETTINGS.acquisitionRate";
             return false;
         }
-        Bottle b_SETTINGS_enabledSensors = Bottle(b_SETTINGS.findGroup("enabledSensors"));
+        Bottle &b_SETTINGS_enabledSensors = _config.findGroup(b_SETTINGS, "enabledSensors");
         if(b_SETTINGS_enabledSensors.isNull())
         {
             yError() << "ServiceParser::check() cannot find SETTINGS.enabledSensors";
@@ -1387,7 +1393,7 @@ bool ServiceParser::check_skin(Searchable &config)
 
     if(eomn_serv_AS_strain == type)
     {
-        Bottle b_STRAIN_SETTINGS = Bottle(b_SERVICE.findGroup("STRAIN_SETTINGS"));
+        Bottle &b_STRAIN_SETTINGS = _config.findGroup(b_SERVICE, "STRAIN_SETTINGS");
         if(b_STRAIN_SETTINGS.isNull())
         {
             yError() << "ServiceParser::check() cannot find STRAIN_SETTINGS";
@@ -1396,7 +1402,7 @@ bool ServiceParser::check_skin(Searchable &config)
         else
         {
 
-            Bottle b_STRAIN_SETTINGS_useCalibration = Bottle(b_STRAIN_SETTINGS.findGroup("useCalibration"));
+            Bottle &b_STRAIN_SETTINGS_useCalibration = _config.findGroup(b_STRAIN_SETTINGS, "useCalibration");
             if(b_STRAIN_SETTINGS_useCalibration.isNull())
             {
                 yError() << "ServiceParser::check() cannot find STRAIN_SETTINGS.useCalibration";
@@ -1558,9 +1564,10 @@ bool ServiceParser::parseService(Searchable &config, servConfigFTsensor_t &ftcon
 
 
     
-    Bottle b_SERVICE(config.findGroup("SERVICE")); //b_SERVICE and b_SETTINGS could not be null, otherwise parseService function would have returned false
-    Bottle b_SETTINGS = Bottle(b_SERVICE.findGroup("SETTINGS"));
-    Bottle b_SETTINGS_temp = Bottle(b_SETTINGS.findGroup("temperature-acquisitionRate"));
+    _config.build(config);
+    Bottle &b_SERVICE = _config.findGroup("SERVICE"); //b_SERVICE and b_SETTINGS could not be null, otherwise parseService function would have returned false
+    Bottle &b_SETTINGS = _config.findGroup(b_SERVICE, "SETTINGS");
+    Bottle &b_SETTINGS_temp = _config.findGroup(b_SETTINGS, "temperature-acquisitionRate");
     if(b_SETTINGS_temp.isNull())
     {
         yError() << "ServiceParser::parseService() for embObjFTsensor device cannot find SETTINGS.temperature-acquisitionRate";
@@ -2700,7 +2707,10 @@ bool ServiceParser::check_motion(Searchable &config)
 
     const bool itisOKifwedontfindtheXMLgroup = true;
 
-    Bottle b_SERVICE(config.findGroup("SERVICE"));
+    _config.clear();
+    _config.build(config);
+
+    Bottle &b_SERVICE = _config.findGroup("SERVICE");
     if(b_SERVICE.isNull())
     {
         if(false == itisOKifwedontfindtheXMLgroup)
@@ -2748,7 +2758,7 @@ bool ServiceParser::check_motion(Searchable &config)
 
     // check whether we have the proper groups at first level.
 
-    Bottle b_PROPERTIES = Bottle(b_SERVICE.findGroup("PROPERTIES"));
+    Bottle &b_PROPERTIES = _config.findGroup(b_SERVICE, "PROPERTIES");
     if(b_PROPERTIES.isNull())
     {
         yError() << "ServiceParser::check_motion() cannot find PROPERTIES";
@@ -2758,28 +2768,28 @@ bool ServiceParser::check_motion(Searchable &config)
 
     // now, inside PROPERTIES there are groups which depend on mc_service.type.
     // i prefer to check them all in here rather to go on and check them one after another.
-    Bottle b_PROPERTIES_ETHBOARD = Bottle(b_PROPERTIES.findGroup("ETHBOARD"));
+    Bottle &b_PROPERTIES_ETHBOARD = _config.findGroup(b_PROPERTIES, "ETHBOARD");
     bool has_PROPERTIES_ETHBOARD = !b_PROPERTIES_ETHBOARD.isNull();
 
-    Bottle b_PROPERTIES_MAIS = Bottle(b_PROPERTIES.findGroup("MAIS"));
+    Bottle &b_PROPERTIES_MAIS = _config.findGroup(b_PROPERTIES, "MAIS");
     bool has_PROPERTIES_MAIS = !b_PROPERTIES_MAIS.isNull();
 
-    Bottle b_PROPERTIES_PSC = Bottle(b_PROPERTIES.findGroup("PSC"));
+    Bottle &b_PROPERTIES_PSC = _config.findGroup(b_PROPERTIES, "PSC");
     bool has_PROPERTIES_PSC = !b_PROPERTIES_PSC.isNull();
 
-    Bottle b_PROPERTIES_POS = Bottle(b_PROPERTIES.findGroup("POS"));
+    Bottle &b_PROPERTIES_POS = _config.findGroup(b_PROPERTIES, "POS");
     bool has_PROPERTIES_POS = !b_PROPERTIES_POS.isNull();
 
-    Bottle b_PROPERTIES_MC4 = Bottle(b_PROPERTIES.findGroup("MC4"));
+    Bottle &b_PROPERTIES_MC4 = _config.findGroup(b_PROPERTIES, "MC4");
     bool has_PROPERTIES_MC4 = !b_PROPERTIES_MC4.isNull();
 
-    Bottle b_PROPERTIES_CANBOARDS = Bottle(b_PROPERTIES.findGroup("CANBOARDS"));
+    Bottle &b_PROPERTIES_CANBOARDS = _config.findGroup(b_PROPERTIES, "CANBOARDS");
     bool has_PROPERTIES_CANBOARDS = !b_PROPERTIES_CANBOARDS.isNull();
 
-    Bottle b_PROPERTIES_JOINTMAPPING = Bottle(b_PROPERTIES.findGroup("JOINTMAPPING"));
+    Bottle &b_PROPERTIES_JOINTMAPPING = _config.findGroup(b_PROPERTIES, "JOINTMAPPING");
     bool has_PROPERTIES_JOINTMAPPING = !b_PROPERTIES_JOINTMAPPING.isNull();
 
-    Bottle b_PROPERTIES_DIAGNOSTICS = Bottle(b_PROPERTIES.findGroup("DIAGNOSTICS"));
+    Bottle &b_PROPERTIES_DIAGNOSTICS = _config.findGroup(b_PROPERTIES, "DIAGNOSTICS");
     bool has_PROPERTIES_DIAGNOSTICS = !b_PROPERTIES_DIAGNOSTICS.isNull();
 
 
@@ -3019,7 +3029,7 @@ bool ServiceParser::check_motion(Searchable &config)
     {
         // i get type
 
-        Bottle b_PROPERTIES_ETHBOARD_type = b_PROPERTIES_ETHBOARD.findGroup("type");
+        Bottle &b_PROPERTIES_ETHBOARD_type = _config.findGroup(b_PROPERTIES_ETHBOARD, "type");
         if(b_PROPERTIES_ETHBOARD_type.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.ETHBOARD.type";
@@ -3046,49 +3056,49 @@ bool ServiceParser::check_motion(Searchable &config)
     {
         // i get type, PROTOCOL.major/minor, FIRMWARE.major/minor/build and see their sizes. they must be all equal. i can have more than one board
 
-        Bottle b_PROPERTIES_CANBOARDS_type = b_PROPERTIES_CANBOARDS.findGroup("type");
+        Bottle &b_PROPERTIES_CANBOARDS_type = _config.findGroup(b_PROPERTIES_CANBOARDS, "type");
         if(b_PROPERTIES_CANBOARDS_type.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.CANBOARDS.type";
             return false;
         }
-        Bottle b_PROPERTIES_CANBOARDS_PROTOCOL = Bottle(b_PROPERTIES_CANBOARDS.findGroup("PROTOCOL"));
+        Bottle &b_PROPERTIES_CANBOARDS_PROTOCOL = _config.findGroup(b_PROPERTIES_CANBOARDS, "PROTOCOL");
         if(b_PROPERTIES_CANBOARDS_PROTOCOL.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.CANBOARDS.PROTOCOL";
             return false;
         }
-        Bottle b_PROPERTIES_CANBOARDS_PROTOCOL_major = Bottle(b_PROPERTIES_CANBOARDS_PROTOCOL.findGroup("major"));
+        Bottle &b_PROPERTIES_CANBOARDS_PROTOCOL_major = _config.findGroup(b_PROPERTIES_CANBOARDS_PROTOCOL, "major");
         if(b_PROPERTIES_CANBOARDS_PROTOCOL_major.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.CANBOARDS.PROTOCOL.major";
             return false;
         }
-        Bottle b_PROPERTIES_CANBOARDS_PROTOCOL_minor = Bottle(b_PROPERTIES_CANBOARDS_PROTOCOL.findGroup("minor"));
+        Bottle &b_PROPERTIES_CANBOARDS_PROTOCOL_minor = _config.findGroup(b_PROPERTIES_CANBOARDS_PROTOCOL, "minor");
         if(b_PROPERTIES_CANBOARDS_PROTOCOL_minor.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.CANBOARDS.PROTOCOL.minor";
             return false;
         }
-        Bottle b_PROPERTIES_CANBOARDS_FIRMWARE = Bottle(b_PROPERTIES_CANBOARDS.findGroup("FIRMWARE"));
+        Bottle &b_PROPERTIES_CANBOARDS_FIRMWARE = _config.findGroup(b_PROPERTIES_CANBOARDS, "FIRMWARE");
         if(b_PROPERTIES_CANBOARDS_FIRMWARE.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.CANBOARDS.FIRMWARE";
             return false;
         }
-        Bottle b_PROPERTIES_CANBOARDS_FIRMWARE_major = Bottle(b_PROPERTIES_CANBOARDS_FIRMWARE.findGroup("major"));
+        Bottle &b_PROPERTIES_CANBOARDS_FIRMWARE_major = _config.findGroup(b_PROPERTIES_CANBOARDS_FIRMWARE, "major");
         if(b_PROPERTIES_CANBOARDS_FIRMWARE_major.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.CANBOARDS.FIRMWARE.major";
             return false;
         }
-        Bottle b_PROPERTIES_CANBOARDS_FIRMWARE_minor = Bottle(b_PROPERTIES_CANBOARDS_FIRMWARE.findGroup("minor"));
+        Bottle &b_PROPERTIES_CANBOARDS_FIRMWARE_minor = _config.findGroup(b_PROPERTIES_CANBOARDS_FIRMWARE, "minor");
         if(b_PROPERTIES_CANBOARDS_FIRMWARE_minor.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.CANBOARDS.FIRMWARE.minor";
             return false;
         }
-        Bottle b_PROPERTIES_CANBOARDS_FIRMWARE_build = Bottle(b_PROPERTIES_CANBOARDS_FIRMWARE.findGroup("build"));
+        Bottle &b_PROPERTIES_CANBOARDS_FIRMWARE_build = _config.findGroup(b_PROPERTIES_CANBOARDS_FIRMWARE, "build");
         if(b_PROPERTIES_CANBOARDS_FIRMWARE_build.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.CANBOARDS.FIRMWARE.build";
@@ -3145,7 +3155,7 @@ bool ServiceParser::check_motion(Searchable &config)
     {
         // i get .location and nothing else
 
-        Bottle b_PROPERTIES_MAIS_location = b_PROPERTIES_MAIS.findGroup("location");
+        Bottle &b_PROPERTIES_MAIS_location = _config.findGroup(b_PROPERTIES_MAIS, "location");
         if(b_PROPERTIES_MAIS_location.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.MAIS.location";
@@ -3197,66 +3207,66 @@ bool ServiceParser::check_motion(Searchable &config)
         // SHIFTS.velocity/estimJointVelocity/estimJointAcceleration/estimMotorVelocity/estimMotorAcceleration,
         // BROADCASTPOLICY, JOINT2BOARD)
 
-        Bottle b_PROPERTIES_MC4_SHIFTS = Bottle(b_PROPERTIES_MC4.findGroup("SHIFTS"));
+        Bottle &b_PROPERTIES_MC4_SHIFTS = _config.findGroup(b_PROPERTIES_MC4, "SHIFTS");
         if(b_PROPERTIES_MC4_SHIFTS.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.MC4.SHIFTS";
             return false;
         }
 
-        Bottle b_PROPERTIES_MC4_SHIFTS_velocity = Bottle(b_PROPERTIES_MC4_SHIFTS.findGroup("velocity"));
+        Bottle &b_PROPERTIES_MC4_SHIFTS_velocity = _config.findGroup(b_PROPERTIES_MC4_SHIFTS, "velocity");
         if(b_PROPERTIES_MC4_SHIFTS_velocity.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.MC4.SHIFTS.velocity";
             return false;
         }
-        Bottle b_PROPERTIES_MC4_SHIFTS_estimJointVelocity = Bottle(b_PROPERTIES_MC4_SHIFTS.findGroup("estimJointVelocity"));
+        Bottle &b_PROPERTIES_MC4_SHIFTS_estimJointVelocity = _config.findGroup(b_PROPERTIES_MC4_SHIFTS, "estimJointVelocity");
         if(b_PROPERTIES_MC4_SHIFTS_estimJointVelocity.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.MC4.SHIFTS.estimJointVelocity";
             return false;
         }
-        Bottle b_PROPERTIES_MC4_SHIFTS_estimJointAcceleration = Bottle(b_PROPERTIES_MC4_SHIFTS.findGroup("estimJointAcceleration"));
+        Bottle &b_PROPERTIES_MC4_SHIFTS_estimJointAcceleration = _config.findGroup(b_PROPERTIES_MC4_SHIFTS, "estimJointAcceleration");
         if(b_PROPERTIES_MC4_SHIFTS_estimJointAcceleration.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.MC4.SHIFTS.estimJointAcceleration";
             return false;
         }
-        Bottle b_PROPERTIES_MC4_SHIFTS_estimMotorVelocity = Bottle(b_PROPERTIES_MC4_SHIFTS.findGroup("estimMotorVelocity"));
+        Bottle &b_PROPERTIES_MC4_SHIFTS_estimMotorVelocity = _config.findGroup(b_PROPERTIES_MC4_SHIFTS, "estimMotorVelocity");
         if(b_PROPERTIES_MC4_SHIFTS_estimMotorVelocity.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.MC4.SHIFTS.estimMotorVelocity";
             return false;
         }
-        Bottle b_PROPERTIES_MC4_SHIFTS_estimMotorAcceleration = Bottle(b_PROPERTIES_MC4_SHIFTS.findGroup("estimMotorAcceleration"));
+        Bottle &b_PROPERTIES_MC4_SHIFTS_estimMotorAcceleration = _config.findGroup(b_PROPERTIES_MC4_SHIFTS, "estimMotorAcceleration");
         if(b_PROPERTIES_MC4_SHIFTS_estimMotorAcceleration.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.MC4.SHIFTS.estimMotorAcceleration";
             return false;
         }
 
-        Bottle b_PROPERTIES_MC4_BROADCASTPOLICY = Bottle(b_PROPERTIES_MC4.findGroup("BROADCASTPOLICY"));
+        Bottle &b_PROPERTIES_MC4_BROADCASTPOLICY = _config.findGroup(b_PROPERTIES_MC4, "BROADCASTPOLICY");
         if(b_PROPERTIES_MC4_BROADCASTPOLICY.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.MC4.BROADCASTPOLICY";
             return false;
         }
 
-        Bottle b_PROPERTIES_MC4_BROADCASTPOLICY_enable = Bottle(b_PROPERTIES_MC4_BROADCASTPOLICY.findGroup("enable"));
+        Bottle &b_PROPERTIES_MC4_BROADCASTPOLICY_enable = _config.findGroup(b_PROPERTIES_MC4_BROADCASTPOLICY, "enable");
         if(b_PROPERTIES_MC4_BROADCASTPOLICY_enable.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.MC4.BROADCASTPOLICY.enable";
             return false;
         }
 
-/*        Bottle b_PROPERTIES_MC4_JOINT2BOARD = Bottle(b_PROPERTIES_MC4.findGroup("JOINT2BOARD"));
+/*        Bottle &b_PROPERTIES_MC4_JOINT2BOARD = _config.findGroup(b_PROPERTIES_MC4, "JOINT2BOARD");
         if(b_PROPERTIES_MC4_JOINT2BOARD.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.MC4.JOINT2BOARD";
             return false;
         }
 
-        Bottle b_PROPERTIES_MC4_JOINT2BOARD_location = Bottle(b_PROPERTIES_MC4_JOINT2BOARD.findGroup("location"));
+        Bottle &b_PROPERTIES_MC4_JOINT2BOARD_location = _config.findGroup(b_PROPERTIES_MC4_JOINT2BOARD, "location");
         if(b_PROPERTIES_MC4_JOINT2BOARD_location.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.MC4.JOINT2BOARD.location";
@@ -3380,7 +3390,7 @@ bool ServiceParser::check_motion(Searchable &config)
     {
         // i get .location and nothing else
 
-        Bottle b_PROPERTIES_PSC_location = b_PROPERTIES_PSC.findGroup("location");
+        Bottle &b_PROPERTIES_PSC_location = _config.findGroup(b_PROPERTIES_PSC, "location");
         if(b_PROPERTIES_PSC_location.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.PSC.location";
@@ -3435,7 +3445,7 @@ bool ServiceParser::check_motion(Searchable &config)
     {
         // i get .location and nothing else
 
-        Bottle b_PROPERTIES_POS_location = b_PROPERTIES_POS.findGroup("location");
+        Bottle &b_PROPERTIES_POS_location = _config.findGroup(b_PROPERTIES_POS, "location");
         if(b_PROPERTIES_POS_location.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.POS.location";
@@ -3492,21 +3502,21 @@ bool ServiceParser::check_motion(Searchable &config)
 
         // actuator, encoder1, encoder2 must all be present. the params contained inside must be all of equal length and equal to numberofjoints
 
-        Bottle b_PROPERTIES_JOINTMAPPING_ACTUATOR = Bottle(b_PROPERTIES_JOINTMAPPING.findGroup("ACTUATOR"));
+        Bottle &b_PROPERTIES_JOINTMAPPING_ACTUATOR = _config.findGroup(b_PROPERTIES_JOINTMAPPING, "ACTUATOR");
         if(b_PROPERTIES_JOINTMAPPING_ACTUATOR.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.JOINTMAPPING.ACTUATOR";
             return false;
         }
 
-        Bottle b_PROPERTIES_JOINTMAPPING_ENCODER1 = Bottle(b_PROPERTIES_JOINTMAPPING.findGroup("ENCODER1"));
+        Bottle &b_PROPERTIES_JOINTMAPPING_ENCODER1 = _config.findGroup(b_PROPERTIES_JOINTMAPPING, "ENCODER1");
         if(b_PROPERTIES_JOINTMAPPING_ENCODER1.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.JOINTMAPPING.ENCODER1";
             return false;
         }
 
-        Bottle b_PROPERTIES_JOINTMAPPING_ENCODER2 = Bottle(b_PROPERTIES_JOINTMAPPING.findGroup("ENCODER2"));
+        Bottle &b_PROPERTIES_JOINTMAPPING_ENCODER2 = _config.findGroup(b_PROPERTIES_JOINTMAPPING, "ENCODER2");
         if(b_PROPERTIES_JOINTMAPPING_ENCODER2.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.JOINTMAPPING.ENCODER2";
@@ -3515,44 +3525,44 @@ bool ServiceParser::check_motion(Searchable &config)
 
         // now the vectors the above three contain ...
 
-        Bottle b_PROPERTIES_JOINTMAPPING_ACTUATOR_type = Bottle(b_PROPERTIES_JOINTMAPPING_ACTUATOR.findGroup("type"));
+        Bottle &b_PROPERTIES_JOINTMAPPING_ACTUATOR_type = _config.findGroup(b_PROPERTIES_JOINTMAPPING_ACTUATOR, "type");
         if(b_PROPERTIES_JOINTMAPPING_ACTUATOR_type.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.JOINTMAPPING.ACTUATOR.type";
             return false;
         }
-        Bottle b_PROPERTIES_JOINTMAPPING_ACTUATOR_port = Bottle(b_PROPERTIES_JOINTMAPPING_ACTUATOR.findGroup("port"));
+        Bottle &b_PROPERTIES_JOINTMAPPING_ACTUATOR_port = _config.findGroup(b_PROPERTIES_JOINTMAPPING_ACTUATOR, "port");
         if(b_PROPERTIES_JOINTMAPPING_ACTUATOR_port.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.JOINTMAPPING.ACTUATOR.port";
             return false;
         }
 
-        Bottle b_PROPERTIES_JOINTMAPPING_ENCODER1_type = Bottle(b_PROPERTIES_JOINTMAPPING_ENCODER1.findGroup("type"));
+        Bottle &b_PROPERTIES_JOINTMAPPING_ENCODER1_type = _config.findGroup(b_PROPERTIES_JOINTMAPPING_ENCODER1, "type");
         if(b_PROPERTIES_JOINTMAPPING_ENCODER1_type.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.JOINTMAPPING.ENCODER1.type";
             return false;
         }
-        Bottle b_PROPERTIES_JOINTMAPPING_ENCODER1_port = Bottle(b_PROPERTIES_JOINTMAPPING_ENCODER1.findGroup("port"));
+        Bottle &b_PROPERTIES_JOINTMAPPING_ENCODER1_port = _config.findGroup(b_PROPERTIES_JOINTMAPPING_ENCODER1, "port");
         if(b_PROPERTIES_JOINTMAPPING_ENCODER1_port.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.JOINTMAPPING.ENCODER1.port";
             return false;
         }
-        Bottle b_PROPERTIES_JOINTMAPPING_ENCODER1_position = Bottle(b_PROPERTIES_JOINTMAPPING_ENCODER1.findGroup("position"));
+        Bottle &b_PROPERTIES_JOINTMAPPING_ENCODER1_position = _config.findGroup(b_PROPERTIES_JOINTMAPPING_ENCODER1, "position");
         if(b_PROPERTIES_JOINTMAPPING_ENCODER1_position.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.JOINTMAPPING.ENCODER1.position";
             return false;
         }
-        Bottle b_PROPERTIES_JOINTMAPPING_ENCODER1_resolution = Bottle(b_PROPERTIES_JOINTMAPPING_ENCODER1.findGroup("resolution"));
+        Bottle &b_PROPERTIES_JOINTMAPPING_ENCODER1_resolution = _config.findGroup(b_PROPERTIES_JOINTMAPPING_ENCODER1, "resolution");
         if(b_PROPERTIES_JOINTMAPPING_ENCODER1_resolution.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.JOINTMAPPING.ENCODER1.resolution";
             return false;
         }
-        Bottle b_PROPERTIES_JOINTMAPPING_ENCODER1_tolerance = Bottle(b_PROPERTIES_JOINTMAPPING_ENCODER1.findGroup("tolerance"));
+        Bottle &b_PROPERTIES_JOINTMAPPING_ENCODER1_tolerance = _config.findGroup(b_PROPERTIES_JOINTMAPPING_ENCODER1, "tolerance");
         if(b_PROPERTIES_JOINTMAPPING_ENCODER1_tolerance.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.JOINTMAPPING.ENCODER1.tolerance";
@@ -3561,31 +3571,31 @@ bool ServiceParser::check_motion(Searchable &config)
 
 
 
-        Bottle b_PROPERTIES_JOINTMAPPING_ENCODER2_type = Bottle(b_PROPERTIES_JOINTMAPPING_ENCODER2.findGroup("type"));
+        Bottle &b_PROPERTIES_JOINTMAPPING_ENCODER2_type = _config.findGroup(b_PROPERTIES_JOINTMAPPING_ENCODER2, "type");
         if(b_PROPERTIES_JOINTMAPPING_ENCODER2_type.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.JOINTMAPPING.ENCODER2.type";
             return false;
         }
-        Bottle b_PROPERTIES_JOINTMAPPING_ENCODER2_port = Bottle(b_PROPERTIES_JOINTMAPPING_ENCODER2.findGroup("port"));
+        Bottle &b_PROPERTIES_JOINTMAPPING_ENCODER2_port = _config.findGroup(b_PROPERTIES_JOINTMAPPING_ENCODER2, "port");
         if(b_PROPERTIES_JOINTMAPPING_ENCODER2_port.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.JOINTMAPPING.ENCODER2.port";
             return false;
         }
-        Bottle b_PROPERTIES_JOINTMAPPING_ENCODER2_position = Bottle(b_PROPERTIES_JOINTMAPPING_ENCODER2.findGroup("position"));
+        Bottle &b_PROPERTIES_JOINTMAPPING_ENCODER2_position = _config.findGroup(b_PROPERTIES_JOINTMAPPING_ENCODER2, "position");
         if(b_PROPERTIES_JOINTMAPPING_ENCODER2_position.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.JOINTMAPPING.ENCODER2.position";
             return false;
         }
-        Bottle b_PROPERTIES_JOINTMAPPING_ENCODER2_resolution = Bottle(b_PROPERTIES_JOINTMAPPING_ENCODER2.findGroup("resolution"));
+        Bottle &b_PROPERTIES_JOINTMAPPING_ENCODER2_resolution = _config.findGroup(b_PROPERTIES_JOINTMAPPING_ENCODER2, "resolution");
         if(b_PROPERTIES_JOINTMAPPING_ENCODER2_resolution.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.JOINTMAPPING.ENCODER2.resolution";
             return false;
         }
-        Bottle b_PROPERTIES_JOINTMAPPING_ENCODER2_tolerance = Bottle(b_PROPERTIES_JOINTMAPPING_ENCODER2.findGroup("tolerance"));
+        Bottle &b_PROPERTIES_JOINTMAPPING_ENCODER2_tolerance = _config.findGroup(b_PROPERTIES_JOINTMAPPING_ENCODER2, "tolerance");
         if(b_PROPERTIES_JOINTMAPPING_ENCODER2_tolerance.isNull())
         {
             yError() << "ServiceParser::check_motion() cannot find PROPERTIES.JOINTMAPPING.ENCODER2.tolerance";
@@ -3766,8 +3776,8 @@ bool ServiceParser::check_motion(Searchable &config)
 
     if(true == has_PROPERTIES_DIAGNOSTICS)
     {
-        Bottle b_PROPERTIES_DIAGNOSTICS_mode = b_PROPERTIES_DIAGNOSTICS.findGroup("mode");
-        Bottle b_PROPERTIES_DIAGNOSTICS_par16 = b_PROPERTIES_DIAGNOSTICS.findGroup("par16");
+        Bottle &b_PROPERTIES_DIAGNOSTICS_mode = _config.findGroup(b_PROPERTIES_DIAGNOSTICS, "mode");
+        Bottle &b_PROPERTIES_DIAGNOSTICS_par16 = _config.findGroup(b_PROPERTIES_DIAGNOSTICS, "par16");
         if(!b_PROPERTIES_DIAGNOSTICS_mode.isNull() && !b_PROPERTIES_DIAGNOSTICS_par16.isNull())
         {
             // if we have both of them ... and they contain at least (only) one we get the values
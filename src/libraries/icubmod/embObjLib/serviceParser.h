@@ -16,6 +16,8 @@
 #include "EoAnalogSensors.h"
 #include "EoMotionControl.h"
 
+#include "configIndex.h"
+
 
 
 
@@ -369,6 +371,8 @@ public:
 
 private:
 
+    eth::ConfigIndex _config; // the config given to the last check_*(), indexed
+
     bool check_analog(yarp::os::Searchable &config, eOmn_serv_type_t type);
 
     bool check_skin(yarp::os::Searchable &config);
@@ -0,0 +1,314 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - public interface
+// --------------------------------------------------------------------------------------------------------------------
+
+#include "theDiagnosticsSink.h"
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - external dependencies
+// --------------------------------------------------------------------------------------------------------------------
+
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <yarp/os/Time.h>
+#include <yarp/os/Log.h>
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - pimpl: private implementation (see scott meyers: item 22 of effective modern c++, item 31 of effective c++
+// --------------------------------------------------------------------------------------------------------------------
+
+struct eth::theDiagnosticsSink::Impl
+{
+    struct Source
+    {
+        std::string name;
+        size_t maxpersecond {0};
+        Formatter formatter {nullptr};
+        Counters counters {};
+        double windowstart {0};     // the rate is counted over the second started at windowstart
+        size_t inwindow {0};
+        uint64_t notlogged {0};     // suppressed + dropped at the time of the last report
+    };
+
+    static constexpr size_t capacity = 1024;
+    static constexpr double period = 0.05;
+    static constexpr double reportperiod = 1.0;
+
+    // the sources do not move in the deque, thus their name and formatter, which never change, are used without lock
+    mutable std::mutex mtx;
+    std::condition_variable cv;
+    std::deque<Source> sources;
+    std::vector<DiagnosticEvent> queue;
+    size_t head {0};
+    size_t count {0};
+    bool quit {false};
+
+    // only one drain() at a time, either from the thread or from flush(), so that the order of the events is kept
+    std::mutex drainmtx;
+    std::vector<DiagnosticEvent> events;
+    double lastreport {0};
+
+    std::thread thread;
+
+    Impl()
+    {
+        queue.resize(capacity);
+        sources.emplace_back();
+        sources.back().name = "diagnostics";
+        sources.back().maxpersecond = 100;
+        lastreport = yarp::os::Time::now();
+        thread = std::thread(&Impl::loop, this);
+    }
+
+    ~Impl()
+    {
+        {
+            std::lock_guard<std::mutex> lck(mtx);
+            quit = true;
+        }
+        cv.notify_one();
+        if(thread.joinable())
+        {
+            thread.join();
+        }
+        drain();
+    }
+
+    void loop()
+    {
+        for(;;)
+        {
+            {
+                std::unique_lock<std::mutex> lck(mtx);
+                cv.wait_for(lck, std::chrono::duration<double>(period), [this]{ return quit; });
+                if(quit)
+                {
+                    return;
+                }
+            }
+            drain();
+        }
+    }
+
+    static void log(uint8_t level, const std::string &line)
+    {
+        switch(static_cast<Level>(level))
+        {
+            case Level::error:      yError("%s", line.c_str());     break;
+            case Level::warning:    yWarning("%s", line.c_str());   break;
+            default:                yInfo("%s", line.c_str());      break;
+        }
+    }
+
+    static std::string plain(const DiagnosticEvent &e)
+    {
+        std::string str = e.text;
+        for(uint8_t i=0; i<e.nargs; i++)
+        {
+            str += " " + std::to_string(e.args[i]);
+        }
+        return str;
+    }
+
+    void drain()
+    {
+        std::lock_guard<std::mutex> dlck(drainmtx);
+
+        events.clear();
+        {
+            std::lock_guard<std::mutex> lck(mtx);
+            for(; count > 0; count--)
+            {
+                events.push_back(queue[head]);
+                head = (head+1) % capacity;
+            }
+        }
+
+        for(const auto &e : events)
+        {
+            const Source &s = sources[e.source];
+            log(e.level, s.name + " " + ((nullptr != s.formatter) ? s.formatter(e) : plain(e)));
+        }
+
+        double now = yarp::os::Time::now();
+        if(now - lastreport >= reportperiod)
+        {
+            report(now - lastreport);
+            lastreport = now;
+        }
+    }
+
+    // the aggregated report of what has not been logged since the previous one
+    void report(double elapsed)
+    {
+        std::vector<std::string> lines;
+        {
+            std::lock_guard<std::mutex> lck(mtx);
+            for(auto &s : sources)
+            {
+                uint64_t notlogged = s.counters.suppressed + s.counters.dropped;
+                if(notlogged != s.notlogged)
+                {
+                    lines.push_back(s.name + " - " + std::to_string(notlogged - s.notlogged) + " events not logged in the last " +
+                                    std::to_string(static_cast<int>(elapsed + 0.5)) + " s (" +
+                                    std::to_string(s.counters.posted) + " posted, " +
+                                    std::to_string(s.counters.suppressed) + " over the rate limit, " +
+                                    std::to_string(s.counters.dropped) + " with the queue full, since the start)");
+                    s.notlogged = notlogged;
+                }
+            }
+        }
+
+        for(const auto &l : lines)
+        {
+            yWarning("%s", l.c_str());
+        }
+    }
+};
+
+
+
+// --------------------------------------------------------------------------------------------------------------------
+// - the class
+// --------------------------------------------------------------------------------------------------------------------
+
+
+eth::theDiagnosticsSink& eth::theDiagnosticsSink::getInstance()
+{
+    // never destroyed, as theNVmanager: the devices may post until the very end
+    static theDiagnosticsSink* p = new theDiagnosticsSink();
+    return *p;
+}
+
+eth::theDiagnosticsSink::theDiagnosticsSink()
+: pImpl(new Impl)
+{
+}
+
+eth::theDiagnosticsSink::~theDiagnosticsSink()
+{
+    delete pImpl;
+}
+
+uint16_t eth::theDiagnosticsSink::addSource(const std::string &name, size_t maxpersecond, Formatter formatter)
+{
+    std::lock_guard<std::mutex> lck(pImpl->mtx);
+    if(pImpl->sources.size() >= noSource)
+    {
+        return noSource;
+    }
+
+    pImpl->sources.emplace_back();
+    Impl::Source &s = pImpl->sources.back();
+    s.name = name;
+    s.maxpersecond = maxpersecond;
+    s.formatter = formatter;
+    return static_cast<uint16_t>(pImpl->sources.size() - 1);
+}
+
+bool eth::theDiagnosticsSink::post(uint16_t source, Level level, const int64_t *args, uint8_t nargs, const char *text)
+{
+    double now = yarp::os::Time::now();
+
+    std::lock_guard<std::mutex> lck(pImpl->mtx);
+
+    if(source >= pImpl->sources.size())
+    {
+        source = 0;
+    }
+    Impl::Source &s = pImpl->sources[source];
+    s.counters.posted++;
+
+    if(now - s.windowstart >= 1.0)
+    {
+        s.windowstart = now;
+        s.inwindow = 0;
+    }
+    if(s.inwindow >= s.maxpersecond)
+    {
+        s.counters.suppressed++;
+        return false;
+    }
+    if(pImpl->count >= Impl::capacity)
+    {
+        s.counters.dropped++;
+        return false;
+    }
+    s.inwindow++;
+
+    DiagnosticEvent &e = pImpl->queue[(pImpl->head + pImpl->count) % Impl::capacity];
+    pImpl->count++;
+
+    e.source = source;
+    e.level = static_cast<uint8_t>(level);
+    e.timestamp = now;
+    e.nargs = (nargs > DiagnosticEvent::maxargs) ? DiagnosticEvent::maxargs : nargs;
+    if(nullptr != args)
+    {
+        memcpy(e.args, args, e.nargs*sizeof(int64_t));
+    }
+    else
+    {
+        e.nargs = 0;
+    }
+    if(nullptr != text)
+    {
+        strncpy(e.text, text, DiagnosticEvent::maxtext-1);
+        e.text[DiagnosticEvent::maxtext-1] = 0;
+    }
+    else
+    {
+        e.text[0] = 0;
+    }
+
+    return true;
+}
+
+bool eth::theDiagnosticsSink::getCounters(uint16_t source, Counters &counters) const
+{
+    std::lock_guard<std::mutex> lck(pImpl->mtx);
+    if(source >= pImpl->sources.size())
+    {
+        return false;
+    }
+    counters = pImpl->sources[source].counters;
+    return true;
+}
+
+void eth::theDiagnosticsSink::flush()
+{
+    pImpl->drain();
+}
+
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
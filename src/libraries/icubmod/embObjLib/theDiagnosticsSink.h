@@ -0,0 +1,109 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+// - include guard ----------------------------------------------------------------------------------------------------
+
+#ifndef _THEDIAGNOSTICSSINK_H_
+#define _THEDIAGNOSTICSSINK_H_
+
+// -- struct DiagnosticEvent
+// -- a diagnostic event as it is posted: a few numbers and an optional short text, still to be formatted.
+// -- class theDiagnosticsSink
+// -- it takes the diagnostic events posted by the devices in the ethReceiver thread (or any other thread) and logs them
+// -- from a thread of its own, so that the poster pays only a lock and the copy of the event, never the formatting or
+// -- the yarp log:
+// -- - every source of events is registered once with addSource(), with the function which formats its events and the
+// --   number of events per second which it may log.
+// -- - the events beyond that number are only counted, and once per second the sink logs how many of them there have
+// --   been for each source. the same happens to the events which do not find room in the queue.
+// -- - the counters of every source can be read with getCounters().
+// -- it generalises what mced::mcEventDownsampler does for the motion control, which only needs to know whether to print.
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+
+namespace eth {
+
+    struct DiagnosticEvent
+    {
+        enum { maxargs = 4, maxtext = 64 };
+
+        uint16_t    source;
+        uint8_t     level;                  // a theDiagnosticsSink::Level
+        uint8_t     nargs;
+        double      timestamp;              // the yarp time of the post
+        int64_t     args[maxargs];
+        char        text[maxtext];          // zero terminated, possibly truncated
+    };
+
+
+    class theDiagnosticsSink
+    {
+    public:
+
+        enum class Level : uint8_t { info = 0, warning = 1, error = 2 };
+
+        // it is called only by the thread of the sink
+        using Formatter = std::function<std::string(const DiagnosticEvent &event)>;
+
+        struct Counters
+        {
+            uint64_t posted {0};            // all the events posted by the source
+            uint64_t suppressed {0};        // not logged because of the rate limit of the source
+            uint64_t dropped {0};           // not logged because the queue was full
+        };
+
+        static constexpr uint16_t noSource = 0xffff;
+
+        static theDiagnosticsSink& getInstance();
+
+        // it gives the id of the new source. name prefixes the reports of the source. a null formatter logs the text
+        // and the numbers of the events as they are
+        uint16_t addSource(const std::string &name, size_t maxpersecond, Formatter formatter = nullptr);
+
+        // it can be called by any thread. the events of noSource, or of an unknown source, go to a generic source.
+        // it returns false if the event will not be logged, which has been counted anyway
+        bool post(uint16_t source, Level level, const int64_t *args = nullptr, uint8_t nargs = 0, const char *text = nullptr);
+
+        bool getCounters(uint16_t source, Counters &counters) const;
+
+        // it logs at once what has been posted so far
+        void flush();
+
+    private:
+        theDiagnosticsSink();
+        ~theDiagnosticsSink();
+
+        theDiagnosticsSink(const theDiagnosticsSink&) = delete;
+        theDiagnosticsSink& operator=(const theDiagnosticsSink&) = delete;
+
+        struct Impl;
+        Impl *pImpl;
+    };
+
+
+} // namespace eth
+
+
+#endif  // include-guard
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
@@ -39,6 +39,7 @@
 #include <chrono>
 #include <map>
 #include <cstring>
+#include <thread>
 
 #include "EoProtocol.h"
 #include "EoProtocolMN.h"
@@ -55,8 +56,6 @@
     
 struct eth::theNVmanager::Impl
 {
-    static std::mutex mtx;
-
     struct askTransaction
     {
         std::uint16_t           expectedrops {0};
@@ -127,6 +126,23 @@ struct eth::theNVmanager::Impl
     };
 
 
+    // a transaction of the asynchronous api. nobody waits on it: it is completed either by onarrival() or by the reaper thread
+    struct asyncTransaction
+    {
+        eth::HostTransceiver *      t {nullptr};
+        std::vector<eOprotID32_t>   id32s {};
+        std::vector<void*>          values {};
+        std::vector<std::uint8_t>   expected {};    // used only by setcheck_async(): the value which was set
+        std::vector<std::uint8_t>   readback {};    // used only by setcheck_async(): the value which is read back
+        std::uint16_t               expectedrops {0};
+        std::uint16_t               receivedrops {0};
+        std::uint32_t               signature {eo_rop_SIGNATUREdummy};
+        double                      deadline {0};
+        std::promise<bool>          promise {};
+        theNVmanager::onCompletion  callback {};
+    };
+
+
     struct Data
     {
         std::mutex locker {};
@@ -233,6 +249,64 @@ struct eth::theNVmanager::Impl
             return true;
         }
 
+        // the transactions of the asynchronous api: they are keyed by signature and ordered by deadline for the reaper.
+        // their signatures are taken from the same sequence of the blocking transactions, so they never clash
+        std::map<std::uint32_t, asyncTransaction*> asyncmap {};
+        std::multimap<double, std::uint32_t> asyncdeadlines {};
+        std::condition_variable asynccv {};
+        std::thread asyncreaper {};
+        bool asyncreaperstop {false};
+
+        void insert(asyncTransaction *transaction)
+        {
+            transaction->signature = uniquesignature();
+            asyncmap.insert(std::make_pair(transaction->signature, transaction));
+            asyncdeadlines.insert(std::make_pair(transaction->deadline, transaction->signature));
+        }
+
+        // it removes the transaction from the containers and returns it, or nullptr if it is not in flight
+        asyncTransaction * extract(const std::uint32_t signature)
+        {
+            std::map<std::uint32_t, asyncTransaction*>::iterator it = asyncmap.find(signature);
+            if(asyncmap.end() == it)
+            {
+                return nullptr;
+            }
+            asyncTransaction *transaction = (*it).second;
+            asyncmap.erase(it);
+
+            auto range = asyncdeadlines.equal_range(transaction->deadline);
+            for(auto d = range.first; d != range.second; ++d)
+            {
+                if((*d).second == signature)
+                {
+                    asyncdeadlines.erase(d);
+                    break;
+                }
+            }
+            return transaction;
+        }
+
+        // it returns false if the signature does not belong to an asynchronous transaction. if the reply is the last one
+        // expected, the transaction is removed and returned in completed so that it can be completed w/out holding the lock
+        bool alertasync(const std::uint32_t signature, asyncTransaction * &completed)
+        {
+            completed = nullptr;
+            std::map<std::uint32_t, asyncTransaction*>::iterator it = asyncmap.find(signature);
+            if(asyncmap.end() == it)
+            {
+                return false;
+            }
+
+            asyncTransaction *transaction = (*it).second;
+            transaction->receivedrops++;
+            if(transaction->receivedrops >= transaction->expectedrops)
+            {
+                completed = extract(signature);
+            }
+            return true;
+        }
+
         void lock()
         {
             locker.lock();
@@ -262,6 +336,20 @@ struct eth::theNVmanager::Impl
         data.reset();
     }
 
+    ~Impl()
+    {
+        // the reaper is stopped and joined before the members it uses are destroyed
+        data.lock();
+        data.asyncreaperstop = true;
+        data.asynccv.notify_one();
+        data.unlock();
+
+        if(true == data.asyncreaper.joinable())
+        {
+            data.asyncreaper.join();
+        }
+    }
+
 
 
     
@@ -288,6 +376,7 @@ struct eth::theNVmanager::Impl
     bool validparameters(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values);
 
     bool set(eth::HostTransceiver *t, const eOprotID32_t id32, const void *value);
+    bool set(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values);
     bool setcheck(eth::HostTransceiver *t, const eOprotID32_t id32, const void *value, const unsigned int retries, double waitbeforecheck, double timeout);
     
 
@@ -301,6 +390,18 @@ struct eth::theNVmanager::Impl
 
     bool check(eth::HostTransceiver *t, const eOprotID32_t id32, const void *value, const double timeout, const unsigned int retries);
 
+    std::shared_future<bool> ask_async(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const double deadline, const theNVmanager::onCompletion &callback, std::uint32_t *signature);
+
+    std::shared_future<bool> setcheck_async(eth::HostTransceiver *t, const eOprotID32_t id32, const void *value, const double deadline, const theNVmanager::onCompletion &callback, std::uint32_t *signature);
+
+    std::shared_future<bool> launch(asyncTransaction *transaction, const eOprotID32_t id32set, std::uint32_t *signature);
+
+    void complete(asyncTransaction *transaction, bool replied);
+
+    bool cancel(const std::uint32_t signature);
+
+    void reaper();
+
     bool signatureisvalid(const std::uint32_t signature);
     bool onarrival(const ropCode ropcode, const eOprotIP_t ipv4, const eOprotID32_t id32, const std::uint32_t signature);
 
@@ -315,9 +416,6 @@ struct eth::theNVmanager::Impl
 };
 
 
-std::mutex eth::theNVmanager::Impl::mtx {};
-
-
 //bool eth::theNVmanager::Impl::initialise(const Config &_config)
 //{
 //    config = _config;
@@ -1011,6 +1109,240 @@ bool eth::theNVmanager::Impl::set(eth::HostTransceiver *t, const eOprotID32_t id
 }
 
 
+bool eth::theNVmanager::Impl::set(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values)
+{
+    if(false == validparameters(t, id32s, values))
+    {
+        return false;
+    }
+
+    if(false == t->addROPsets(id32s, values))
+    {
+        const AbstractEthResource::Properties & props = getboardproperties(t);
+        yError() << "theNVmanager::Impl::set(vector<>) fails t->addROPsets() to BOARD" << props.boardnameString << "IP" << props.ipv4addrString << "for" << id32s.size() << "nvs";
+        return false;
+    }
+
+    return true;
+}
+
+
+std::shared_future<bool> eth::theNVmanager::Impl::ask_async(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const double deadline, const theNVmanager::onCompletion &callback, std::uint32_t *signature)
+{
+    asyncTransaction *transaction = new asyncTransaction;
+    transaction->t = t;
+    transaction->deadline = deadline;
+    transaction->callback = callback;
+
+    if(false == validparameters(t, id32s, values))
+    {
+        yError() << "theNVmanager::Impl::ask_async() called with invalid parameters";
+        transaction->callback = nullptr;
+        std::shared_future<bool> f = transaction->promise.get_future().share();
+        transaction->promise.set_value(false);
+        delete transaction;
+        return f;
+    }
+
+    transaction->id32s = id32s;
+    transaction->values = values;
+    transaction->expectedrops = static_cast<std::uint16_t>(id32s.size()); // ok to downcast
+
+    return launch(transaction, eo_prot_ID32dummy, signature);
+}
+
+
+std::shared_future<bool> eth::theNVmanager::Impl::setcheck_async(eth::HostTransceiver *t, const eOprotID32_t id32, const void *value, const double deadline, const theNVmanager::onCompletion &callback, std::uint32_t *signature)
+{
+    asyncTransaction *transaction = new asyncTransaction;
+    transaction->t = t;
+    transaction->deadline = deadline;
+    transaction->callback = callback;
+
+    if(false == validparameters(t, id32, value))
+    {
+        yError() << "theNVmanager::Impl::setcheck_async() called with invalid parameters";
+        transaction->callback = nullptr;
+        std::shared_future<bool> f = transaction->promise.get_future().share();
+        transaction->promise.set_value(false);
+        delete transaction;
+        return f;
+    }
+
+    // the value is copied, so that the caller can release it at once
+    std::uint16_t size = sizeofnv(id32);
+    const std::uint8_t *v = reinterpret_cast<const std::uint8_t*>(value);
+    transaction->expected.assign(v, v+size);
+    transaction->readback.resize(size);
+    transaction->id32s.push_back(id32);
+    transaction->values.push_back(transaction->readback.data());
+    transaction->expectedrops = 1;
+
+    return launch(transaction, id32, signature);
+}
+
+
+std::shared_future<bool> eth::theNVmanager::Impl::launch(asyncTransaction *transaction, const eOprotID32_t id32set, std::uint32_t *signature)
+{
+    std::shared_future<bool> f = transaction->promise.get_future().share();
+
+    // once in flight, the transaction may be completed at any time by another thread (e.g., by the reaper if the deadline
+    // is already expired), thus i take now whatever i need to send the ROPs
+    eth::HostTransceiver *t = transaction->t;
+    const std::vector<eOprotID32_t> id32s = transaction->id32s;
+    const std::vector<std::uint8_t> setvalue = transaction->expected;
+
+    // 1. the transaction is in flight before its ROPs are sent, otherwise a quick reply could find nobody
+    data.lock();
+
+    data.insert(transaction);
+    std::uint32_t assignedsignature = transaction->signature;
+
+    if(false == data.asyncreaper.joinable())
+    {
+        data.asyncreaper = std::thread(&eth::theNVmanager::Impl::reaper, this);
+    }
+    data.asynccv.notify_one();
+
+    data.unlock();
+
+    if(nullptr != signature)
+    {
+        *signature = assignedsignature;
+    }
+
+    // 2. the ROPs
+    bool sent = true;
+    if((eo_prot_ID32dummy != id32set) && (false == set(t, id32set, setvalue.data())))
+    {
+        sent = false;
+    }
+
+    for(size_t i=0; (i<id32s.size()) && (true == sent); i++)
+    {
+        if(false == t->addROPask(id32s[i], assignedsignature))
+        {
+            const AbstractEthResource::Properties & props = getboardproperties(t);
+            yError() << "theNVmanager::Impl::launch() fails t->addROPask() to BOARD" << props.boardnameString << "IP" << props.ipv4addrString << "for nv" << getid32string(id32s[i]);
+            sent = false;
+        }
+    }
+
+    if(false == sent)
+    {
+        // the transaction is withdrawn, if the reaper has not expired it in the meantime. it cannot have been completed
+        // by a reply because not all its ROPs were sent
+        data.lock();
+        asyncTransaction *withdrawn = data.extract(assignedsignature);
+        data.unlock();
+
+        if(nullptr != withdrawn)
+        {
+            withdrawn->callback = nullptr;
+            withdrawn->promise.set_value(false);
+            delete withdrawn;
+        }
+    }
+
+    return f;
+}
+
+
+void eth::theNVmanager::Impl::complete(asyncTransaction *transaction, bool replied)
+{
+    eth::HostTransceiver *t = transaction->t;
+
+    if(true == replied)
+    {
+        for(size_t i=0; i<transaction->id32s.size(); i++)
+        {
+            if(false == t->read(transaction->id32s[i], transaction->values[i]))
+            {
+                const AbstractEthResource::Properties & props = getboardproperties(t);
+                yError() << "theNVmanager::Impl::complete() fails t->read() for BOARD" << props.boardnameString << "IP" << props.ipv4addrString << "and nv" << getid32string(transaction->id32s[i]);
+                replied = false;
+            }
+        }
+
+        if((true == replied) && (false == transaction->expected.empty()))
+        {
+            replied = (0 == std::memcmp(transaction->expected.data(), transaction->readback.data(), transaction->expected.size()));
+        }
+    }
+
+    transaction->promise.set_value(replied);
+
+    if(transaction->callback)
+    {
+        transaction->callback(transaction->signature, replied);
+    }
+
+    delete transaction;
+}
+
+
+bool eth::theNVmanager::Impl::cancel(const std::uint32_t signature)
+{
+    data.lock();
+    asyncTransaction *transaction = data.extract(signature);
+    data.unlock();
+
+    if(nullptr == transaction)
+    {
+        return false;
+    }
+
+    complete(transaction, false);
+    return true;
+}
+
+
+void eth::theNVmanager::Impl::reaper()
+{
+    // it sleeps until the closest deadline and completes with false all the transactions which are expired.
+    // it is started by the first asynchronous transaction and it is stopped by the destructor of the singleton
+    std::unique_lock<std::mutex> lck(data.locker);
+
+    while(false == data.asyncreaperstop)
+    {
+        if(true == data.asyncdeadlines.empty())
+        {
+            data.asynccv.wait(lck);
+            continue;
+        }
+
+        double now = SystemClock::nowSystem();
+        double closest = (*data.asyncdeadlines.begin()).first;
+        if(closest > now)
+        {
+            data.asynccv.wait_for(lck, std::chrono::microseconds(static_cast<std::int64_t>(1000000.0 * (closest - now)) + 1));
+            continue;
+        }
+
+        std::vector<asyncTransaction*> expired;
+        while((false == data.asyncdeadlines.empty()) && ((*data.asyncdeadlines.begin()).first <= now))
+        {
+            asyncTransaction *transaction = data.extract((*data.asyncdeadlines.begin()).second);
+            if(nullptr == transaction)
+            {   // it should not happen, but i dont want to loop forever
+                data.asyncdeadlines.erase(data.asyncdeadlines.begin());
+                continue;
+            }
+            expired.push_back(transaction);
+        }
+
+        lck.unlock();
+        for(asyncTransaction *transaction : expired)
+        {
+            const AbstractEthResource::Properties & props = getboardproperties(transaction->t);
+            yError() << "theNVmanager::Impl::reaper() had a timeout for BOARD" << props.boardnameString << "IP" << props.ipv4addrString << "w/ signature" << transaction->signature << ". Received only" << transaction->receivedrops << "out of" << transaction->expectedrops << "replies";
+            complete(transaction, false);
+        }
+        lck.lock();
+    }
+}
+
+
 bool eth::theNVmanager::Impl::signatureisvalid(const std::uint32_t signature)
 {
     if((eo_rop_SIGNATUREdummy == signature) || (signature >= 0xaa000000))
@@ -1054,13 +1386,22 @@ bool eth::theNVmanager::Impl::onarrival(const ropCode ropcode, const eOprotIP_t
             return false;
         }
 
-        // 1. alert the thread which is waiting
+        // 1. alert the thread which is waiting or, if the transaction is asynchronous, complete it when it has all its replies
+        asyncTransaction *completed = nullptr;
         data.lock();
 
-        data.alert(signature);
+        if(false == data.alertasync(signature, completed))
+        {
+            data.alert(signature);
+        }
 
         data.unlock();
 
+        if(nullptr != completed)
+        {
+            complete(completed, true);
+        }
+
     }
     else if(ropCode::sig == ropcode)
     {
@@ -1089,15 +1430,11 @@ bool eth::theNVmanager::Impl::onarrival(const ropCode ropcode, const eOprotIP_t
 
 eth::theNVmanager& eth::theNVmanager::getInstance()
 {
-    static theNVmanager* p = nullptr;
+    // it is destroyed at exit, so that the thread of the asynchronous transactions is joined before the static objects
+    // which were created before it
+    static theNVmanager instance;
 
-    std::lock_guard<std::mutex> lck(eth::theNVmanager::Impl::mtx);
-    if(nullptr == p)
-    {
-        p = new theNVmanager();
-    }
-
-    return *p;
+    return instance;
 }
 
 
@@ -1109,6 +1446,11 @@ eth::theNVmanager::theNVmanager()
 
 }
 
+eth::theNVmanager::~theNVmanager()
+{
+    delete pImpl;
+}
+
          
 //bool eth::theNVmanager::initialise(const Config &config)
 //{
@@ -1194,6 +1536,17 @@ bool eth::theNVmanager::set(const eOprotIP_t ipv4, const eOprotID32_t id32, cons
     return pImpl->set(t, id32, value);
 }
 
+bool eth::theNVmanager::set(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values)
+{
+    return pImpl->set(t, id32s, values);
+}
+
+bool eth::theNVmanager::set(const eOprotIP_t ipv4, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values)
+{
+    eth::HostTransceiver *t = pImpl->transceiver(ipv4);
+    return pImpl->set(t, id32s, values);
+}
+
 
 bool eth::theNVmanager::check(eth::HostTransceiver *t, const eOprotID32_t id32, const void *value, const double timeout, const unsigned int retries)
 {
@@ -1223,6 +1576,44 @@ bool eth::theNVmanager::onarrival(const ropCode ropcode, const eOprotIP_t ipv4,
     return pImpl->onarrival(ropcode, ipv4, id32, signature);
 }
 
+std::shared_future<bool> eth::theNVmanager::ask_async(const eOprotIP_t ipv4, const eOprotID32_t id32, void *value, const double deadline, const onCompletion &callback, std::uint32_t *signature)
+{
+    eth::HostTransceiver *t = pImpl->transceiver(ipv4);
+    return pImpl->ask_async(t, std::vector<eOprotID32_t>(1, id32), std::vector<void*>(1, value), deadline, callback, signature);
+}
+
+std::shared_future<bool> eth::theNVmanager::ask_async(eth::HostTransceiver *t, const eOprotID32_t id32, void *value, const double deadline, const onCompletion &callback, std::uint32_t *signature)
+{
+    return pImpl->ask_async(t, std::vector<eOprotID32_t>(1, id32), std::vector<void*>(1, value), deadline, callback, signature);
+}
+
+std::shared_future<bool> eth::theNVmanager::ask_async(const eOprotIP_t ipv4, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const double deadline, const onCompletion &callback, std::uint32_t *signature)
+{
+    eth::HostTransceiver *t = pImpl->transceiver(ipv4);
+    return pImpl->ask_async(t, id32s, values, deadline, callback, signature);
+}
+
+std::shared_future<bool> eth::theNVmanager::ask_async(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const double deadline, const onCompletion &callback, std::uint32_t *signature)
+{
+    return pImpl->ask_async(t, id32s, values, deadline, callback, signature);
+}
+
+std::shared_future<bool> eth::theNVmanager::setcheck_async(const eOprotIP_t ipv4, const eOprotID32_t id32, const void *value, const double deadline, const onCompletion &callback, std::uint32_t *signature)
+{
+    eth::HostTransceiver *t = pImpl->transceiver(ipv4);
+    return pImpl->setcheck_async(t, id32, value, deadline, callback, signature);
+}
+
+std::shared_future<bool> eth::theNVmanager::setcheck_async(eth::HostTransceiver *t, const eOprotID32_t id32, const void *value, const double deadline, const onCompletion &callback, std::uint32_t *signature)
+{
+    return pImpl->setcheck_async(t, id32, value, deadline, callback, signature);
+}
+
+bool eth::theNVmanager::cancel(const std::uint32_t signature)
+{
+    return pImpl->cancel(signature);
+}
+
 //bool eth::theNVmanager::wait(const ropCode ropcode, const eOprotIP_t ipv4, const eOprotID32_t id32, const double timeout)
 //{
 //    return pImpl->wait(ropcode, ipv4, id32, timeout);
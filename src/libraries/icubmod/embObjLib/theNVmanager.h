@@ -26,6 +26,8 @@
 
 #include <vector>
 #include <cstdint>
+#include <functional>
+#include <future>
 
 #include "EoProtocol.h"
 #include <hostTransceiver.hpp>
@@ -97,6 +99,11 @@ namespace eth {
         bool ask(const eOprotIP_t ipv4, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const double timeout = 0.5);
         bool ask(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const double timeout = 0.5);
 
+        // imposes the values of many network variables of the same board. the set<> ROPs leave in the same UDP packet, hence the board
+        // applies them in the same cycle. it does not wait nor verify
+        bool set(const eOprotIP_t ipv4, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values);
+        bool set(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values);
+
 
         // tobedone: i want to group several requests before i start to wait.
         // i need:
@@ -120,8 +127,32 @@ namespace eth {
         bool group_ask(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values);
         bool group_stop(const double timeout = 0.5);
 
+
+        // asynchronous management of ask<> ROPs: the functions send the ROPs and return at once, so that many transactions
+        // towards many boards can be in flight at the same time. every transaction is identified by its own signature.
+        // a transaction completes with true when all its replies have arrived and with false when its deadline expires,
+        // where the deadline is an absolute time of yarp::os::SystemClock::nowSystem().
+        // the replies are copied into value / values at completion, thus the memory must stay valid until then.
+        // the result is given by the returned future and also by the callback, if not empty. the callback is executed by the thread
+        // which receives the last reply or detects the expiry of the deadline, thus it must be quick and it must not wait for replies.
+        // if the ROPs cannot be sent, the future is already completed with false and the callback is not called.
+        using onCompletion = std::function<void(const std::uint32_t signature, const bool replied)>;
+
+        std::shared_future<bool> ask_async(const eOprotIP_t ipv4, const eOprotID32_t id32, void *value, const double deadline, const onCompletion &callback = nullptr, std::uint32_t *signature = nullptr);
+        std::shared_future<bool> ask_async(eth::HostTransceiver *t, const eOprotID32_t id32, void *value, const double deadline, const onCompletion &callback = nullptr, std::uint32_t *signature = nullptr);
+        std::shared_future<bool> ask_async(const eOprotIP_t ipv4, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const double deadline, const onCompletion &callback = nullptr, std::uint32_t *signature = nullptr);
+        std::shared_future<bool> ask_async(eth::HostTransceiver *t, const std::vector<eOprotID32_t> &id32s, const std::vector<void*> &values, const double deadline, const onCompletion &callback = nullptr, std::uint32_t *signature = nullptr);
+        // it sends a set<> ROP followed by a ask<> ROP of the same variable, so that the board processes them in this order.
+        // the result is true only if the value read back is equal to value, which is copied inside and thus can be released at once.
+        // differently from setcheck() there are no retries: the caller can decide what to do with the transactions which fail.
+        std::shared_future<bool> setcheck_async(const eOprotIP_t ipv4, const eOprotID32_t id32, const void *value, const double deadline, const onCompletion &callback = nullptr, std::uint32_t *signature = nullptr);
+        std::shared_future<bool> setcheck_async(eth::HostTransceiver *t, const eOprotID32_t id32, const void *value, const double deadline, const onCompletion &callback = nullptr, std::uint32_t *signature = nullptr);
+        // it completes with false a transaction still in flight. it returns false if the transaction is not in flight anymore
+        bool cancel(const std::uint32_t signature);
+
     private:
         theNVmanager(); 
+        ~theNVmanager();
 
     public:
         // remove copy constructors and copy assignment operators
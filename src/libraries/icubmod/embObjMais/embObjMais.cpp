@@ -37,6 +37,7 @@
 
 #include <yarp/os/NetType.h>
 #include <yarp/conf/environment.h>
+#include <iCub/StartupTrace.h>
 
 #ifdef WIN32
 #pragma warning(once:4355)
@@ -175,6 +176,8 @@ bool embObjMais::initialised()
 
 bool embObjMais::open(yarp::os::Searchable &config)
 {
+    iCub::dev::TraceSpan span("open", "embObjMais::open");
+
     // - first thing to do is verify if the eth manager is available. then i parse info about the eth board.
 
     ethManager = eth::TheEthManager::instance();
@@ -33,6 +33,7 @@
 
 
 #include "eomcUtils.h"
+#include <iCub/StartupTrace.h>
 
 using namespace yarp::dev;
 using namespace yarp::os;
@@ -135,6 +136,10 @@ bool embObjMotionControl::alloc(int nj)
     _jointEncs.resize(nj);
     _motorEncs.resize(nj);
     _kalman_params.resize(nj);
+    _jointsCore.resize(nj);
+    _rxJointsCore.resize(nj);
+    _rxEncodersStamp.resize(nj);
+    _rxUpdated.assign(nj, 0);
     
     //debug purpose
 
@@ -332,6 +337,8 @@ bool embObjMotionControl::initializeInterfaces(measureConvFactors &f)
 
 bool embObjMotionControl::open(yarp::os::Searchable &config)
 {
+    iCub::dev::TraceSpan span("open", "embObjMotionControl::open");
+
     // - first thing to do is verify if the eth manager is available. then i parse info about the eth board.
 
     ethManager = eth::TheEthManager::instance();
@@ -451,6 +458,32 @@ bool embObjMotionControl::open(yarp::os::Searchable &config)
     }
 
 
+    // the snapshot of the joints starts from what we have locally, then update() refreshes it at every received status
+    {
+        std::lock_guard<std::mutex> lck(_mutex);
+        for(int j=0; j<_njoints; j++)
+        {
+            eOprotID32_t id32 = eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, j, eoprot_tag_mc_joint_status_core);
+            res->getLocalValue(id32, &_jointsCore[j]);
+        }
+    }
+
+    // the optional shared snapshot of the joints, e.g. GENERAL.sharedStateFile = /dev/shm/icub_left_arm
+    std::string sharedStateFile = config.findGroup("GENERAL").check("sharedStateFile", Value(""), "file of the snapshot of the joints shared with the local processes").asString();
+    if(!sharedStateFile.empty())
+    {
+        std::lock_guard<std::mutex> lck(_mutex);
+        _sharedSamples.assign(_njoints, iCub::dev::SharedJointSample());
+        if(_sharedState.open(sharedStateFile, _njoints))
+        {
+            yInfo() << getBoardInfo() << "shares the state of its joints in" << sharedStateFile;
+        }
+        else
+        {
+            yWarning() << getBoardInfo() << "cannot create" << sharedStateFile << "thus the state of its joints is not shared";
+        }
+    }
+
     opened = true;
 
 
@@ -1299,12 +1332,16 @@ bool embObjMotionControl::init()
     //////////////////////////////////////////
     // invia la configurazione dei GIUNTI   //
     //////////////////////////////////////////
+    // the configurations of all the joints are sent and verified together, thus they must stay valid until then
+    std::vector<eOmc_joint_config_t> jointconfigs(_njoints);
+    std::vector<eOprotID32_t> configids;
+    std::vector<void*> configvalues;
     for(int logico=0; logico< _njoints; logico++)
     {
         int fisico = _axisMap[logico];
         protid = eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, fisico, eoprot_tag_mc_joint_config);
 
-        eOmc_joint_config_t jconfig = {0};
+        eOmc_joint_config_t &jconfig = jointconfigs[logico];
         memset(&jconfig, 0, sizeof(eOmc_joint_config_t));
         yarp::dev::Pid tmp; 
         tmp = _measureConverter->convert_pid_to_machine(yarp::dev::VOCAB_PIDTYPE_POSITION,_trj_pids[logico].pid, fisico);
@@ -1358,17 +1395,20 @@ bool embObjMotionControl::init()
         jconfig.kalman_params.R = _kalman_params[logico].R;
         jconfig.kalman_params.P0 = _kalman_params[logico].P0;
 
-        if(false == res->setcheckRemoteValue(protid, &jconfig, 10, 0.010, 0.050))
-        {
-            yError() << "FATAL: embObjMotionControl::init() had an error while calling setcheckRemoteValue() for joint config fisico #" << fisico << "in "<< getBoardInfo();
-            return false;
-        }
-        else
+        configids.push_back(protid);
+        configvalues.push_back(&jconfig);
+    }
+
+    if(false == res->setcheckRemoteValues(configids, configvalues, 10, 0.010, 0.050))
+    {
+        yError() << "FATAL: embObjMotionControl::init() had an error while calling setcheckRemoteValues() for joint config in "<< getBoardInfo();
+        return false;
+    }
+    else
+    {
+        if(behFlags.verbosewhenok)
         {
-            if(behFlags.verbosewhenok)
-            {
-                yDebug() << "embObjMotionControl::init() correctly configured joint config fisico #" << fisico << "in "<< getBoardInfo();
-            }
+            yDebug() << "embObjMotionControl::init() correctly configured joint config of" << _njoints << "joints in "<< getBoardInfo();
         }
     }
 
@@ -1378,12 +1418,16 @@ bool embObjMotionControl::init()
     //////////////////////////////////////////
 
 
+    std::vector<eOmc_motor_config_t> motorconfigs(_njoints);
+    configids.clear();
+    configvalues.clear();
     for(int logico=0; logico<_njoints; logico++)
     {
         int fisico = _axisMap[logico];
 
         protid = eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_motor, fisico, eoprot_tag_mc_motor_config);
-        eOmc_motor_config_t motor_cfg = {0};
+        eOmc_motor_config_t &motor_cfg = motorconfigs[logico];
+        memset(&motor_cfg, 0, sizeof(eOmc_motor_config_t));
         motor_cfg.maxvelocityofmotor = 0;//_maxMotorVelocity[logico]; //unused yet!
         motor_cfg.currentLimits.nominalCurrent = _currentLimits[logico].nominalCurrent;
         motor_cfg.currentLimits.overloadCurrent = _currentLimits[logico].overloadCurrent;
@@ -1411,17 +1455,20 @@ bool embObjMotionControl::init()
         tmp = _measureConverter->convert_pid_to_machine(yarp::dev::VOCAB_PIDTYPE_VELOCITY, _spd_pids[logico].pid, fisico);
         copyPid_iCub2eo(&tmp, &motor_cfg.pidspeed);
 
-        if (false == res->setcheckRemoteValue(protid, &motor_cfg, 10, 0.010, 0.050))
-        {
-            yError() << "FATAL: embObjMotionControl::init() had an error while calling setcheckRemoteValue() for motor config fisico #" << fisico << "in "<< getBoardInfo();
-            return false;
-        }
-        else
+        configids.push_back(protid);
+        configvalues.push_back(&motor_cfg);
+    }
+
+    if (false == res->setcheckRemoteValues(configids, configvalues, 10, 0.010, 0.050))
+    {
+        yError() << "FATAL: embObjMotionControl::init() had an error while calling setcheckRemoteValues() for motor config in "<< getBoardInfo();
+        return false;
+    }
+    else
+    {
+        if (behFlags.verbosewhenok)
         {
-            if (behFlags.verbosewhenok)
-            {
-                yDebug() << "embObjMotionControl::init() correctly configured motor config fisico #" << fisico << "in "<< getBoardInfo();
-            }
+            yDebug() << "embObjMotionControl::init() correctly configured motor config of" << _njoints << "joints in "<< getBoardInfo();
         }
     }
 
@@ -1441,6 +1488,11 @@ bool embObjMotionControl::close()
 {
     yTrace() << " embObjMotionControl::close()";
 
+    {
+        std::lock_guard<std::mutex> lck(_mutex);
+        _sharedState.close();
+    }
+
     ImplementControlMode::uninitialize();
     ImplementEncodersTimed::uninitialize();
     ImplementMotorEncoders::uninitialize();
@@ -1523,11 +1575,28 @@ bool embObjMotionControl::update(eOprotID32_t id32, double timestamp, void *rxda
 
 
     // for the case of id32 which contains an encoder value .... we refresh the timestamp of that encoder
+    // and the snapshot of the status of the joint which is read by the getters. the board sends the status of all its
+    // joints in the same frame, hence we keep them here and onFrameParsed() publishes them with a single lock
 
-    if(true == initialised())
+    if((true == initialised()) && (joint < _rxUpdated.size()))
     {   // do it only if we already have opened the device
-        std::lock_guard<std::mutex> lck(_mutex);
-        _encodersStamp[joint] = timestamp;
+        _rxEncodersStamp[joint] = timestamp;
+        _rxUpdated[joint] |= rxStamp;
+
+        if(eoprot_entity_mc_joint == eoprot_ID2entity(id32))
+        {
+            eOprotTag_t tag = eoprot_ID2tag(id32);
+            if(eoprot_tag_mc_joint_status_core == tag)
+            {
+                _rxJointsCore[joint] = *reinterpret_cast<eOmc_joint_status_core_t*>(rxdata);
+                _rxUpdated[joint] |= rxCore;
+            }
+            else if(eoprot_tag_mc_joint_status == tag)
+            {
+                _rxJointsCore[joint] = reinterpret_cast<eOmc_joint_status_t*>(rxdata)->core;
+                _rxUpdated[joint] |= rxCore;
+            }
+        }
     }
 
 
@@ -1567,6 +1636,43 @@ bool embObjMotionControl::update(eOprotID32_t id32, double timestamp, void *rxda
 }
 
 
+void embObjMotionControl::onFrameParsed(double timestamp)
+{
+    std::lock_guard<std::mutex> lck(_mutex);
+    for(size_t j=0; j<_rxUpdated.size(); j++)
+    {
+        if(0 != (_rxUpdated[j] & rxStamp))
+        {
+            _encodersStamp[j] = _rxEncodersStamp[j];
+        }
+        if(0 != (_rxUpdated[j] & rxCore))
+        {
+            _jointsCore[j] = _rxJointsCore[j];
+        }
+        _rxUpdated[j] = 0;
+    }
+
+    if(_sharedState.isOpen())
+    {
+        // the same conversions of ImplementEncodersTimed and ImplementTorqueControl over the raw getters
+        for(int j=0; j<_njoints; j++)
+        {
+            const auto &m = _jointsCore[j].measures;
+            int k = 0;
+            double value = 0;
+            _measureConverter->posE2A((double) m.meas_position, j, value, k);
+            iCub::dev::SharedJointSample &s = _sharedSamples[k];
+            s.position = value;
+            _measureConverter->velE2A((double) m.meas_velocity, j, s.velocity, k);
+            _measureConverter->accE2A((double) m.meas_acceleration, j, s.acceleration, k);
+            _measureConverter->trqS2N(_measureConverter->trqS2N(m.meas_torque, j), j, s.torque, k);
+            s.stamp = _encodersStamp[j];
+        }
+        _sharedState.write(_sharedSamples.data());
+    }
+}
+
+
 ///////////// PID INTERFACE
 bool embObjMotionControl::setPidRaw(const PidControlTypeEnum& pidtype, int j, const Pid &pid)
 {
@@ -1920,7 +2026,7 @@ bool embObjMotionControl::setPidOffsetRaw(const PidControlTypeEnum& pidtype, int
 //    Velocity control interface raw  //
 ////////////////////////////////////////
 
-bool embObjMotionControl::velocityMoveRaw(int j, double sp)
+bool embObjMotionControl::helper_velocityMoveSetpoint(int j, double sp, eOmc_setpoint_t &setpoint)
 {
     int mode=0;
     getControlModeRaw(j, &mode);
@@ -1933,18 +2039,27 @@ bool embObjMotionControl::velocityMoveRaw(int j, double sp)
         {
             yError() << "velocityMoveRaw: skipping command because " << getBoardInfo() << " joint " << j << " is not in VOCAB_CM_VELOCITY mode";
         }
-        return true;
+        return false;
     }
 
-    eOprotID32_t protid = eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, j, eoprot_tag_mc_joint_cmmnds_setpoint);
-
     _ref_command_speeds[j] = sp ;   // save internally the new value of speed.
 
-    eOmc_setpoint_t setpoint;
     setpoint.type = eomc_setpoint_velocity;
     setpoint.to.velocity.value =  (eOmeas_velocity_t) S_32(_ref_command_speeds[j]);
     setpoint.to.velocity.withacceleration = (eOmeas_acceleration_t) S_32(_ref_accs[j]);
 
+    return true;
+}
+
+bool embObjMotionControl::velocityMoveRaw(int j, double sp)
+{
+    eOmc_setpoint_t setpoint;
+    if(false == helper_velocityMoveSetpoint(j, sp, setpoint))
+    {
+        return true;
+    }
+
+    eOprotID32_t protid = eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, j, eoprot_tag_mc_joint_cmmnds_setpoint);
 
     if(false == res->setRemoteValue(protid, &setpoint))
     {
@@ -1956,17 +2071,27 @@ bool embObjMotionControl::velocityMoveRaw(int j, double sp)
 
 bool embObjMotionControl::velocityMoveRaw(const double *sp)
 {
-    bool ret = true;
-    eOmc_setpoint_t setpoint;
-
-    setpoint.type = eomc_setpoint_velocity;
+    std::vector<int> joints;
+    std::vector<eOmc_setpoint_t> setpoints;
+    joints.reserve(_njoints);
+    setpoints.reserve(_njoints);
 
     for(int j=0; j<_njoints; j++)
     {
-        ret = velocityMoveRaw(j, sp[j]) && ret;
+        eOmc_setpoint_t setpoint;
+        if(true == helper_velocityMoveSetpoint(j, sp[j], setpoint))
+        {
+            joints.push_back(j);
+            setpoints.push_back(setpoint);
+        }
     }
 
-    return ret;
+    if(false == helper_setSetpoints(joints, setpoints))
+    {
+        yError() << "while setting velocity mode";
+        return false;
+    }
+    return true;
 }
 
 
@@ -2244,7 +2369,7 @@ bool embObjMotionControl::getAxes(int *ax)
     return true;
 }
 
-bool embObjMotionControl::positionMoveRaw(int j, double ref)
+bool embObjMotionControl::helper_positionMoveSetpoint(int j, double ref, eOmc_setpoint_t &setpoint)
 {
     if (yarp::os::Time::now()-_last_position_move_time[j]<MAX_POSITION_MOVE_INTERVAL)
     {
@@ -2263,30 +2388,66 @@ bool embObjMotionControl::positionMoveRaw(int j, double ref)
         {
             yError() << "positionMoveRaw: skipping command because " << getBoardInfo() << " joint " << j << " is not in VOCAB_CM_POSITION mode";
         }
-        return true;
+        return false;
     }
 
-    eOprotID32_t protid = eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, j, eoprot_tag_mc_joint_cmmnds_setpoint);
     _ref_command_positions[j] = ref;   // save internally the new value of pos.
 
-    eOmc_setpoint_t setpoint;
-
     setpoint.type = (eOenum08_t) eomc_setpoint_position;
     setpoint.to.position.value =  (eOmeas_position_t) S_32(_ref_command_positions[j]);
     setpoint.to.position.withvelocity = (eOmeas_velocity_t) S_32(_ref_speeds[j]);
 
+    return true;
+}
+
+bool embObjMotionControl::positionMoveRaw(int j, double ref)
+{
+    eOmc_setpoint_t setpoint;
+    if(false == helper_positionMoveSetpoint(j, ref, setpoint))
+    {
+        return true;
+    }
+
+    eOprotID32_t protid = eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, j, eoprot_tag_mc_joint_cmmnds_setpoint);
     return res->setRemoteValue(protid, &setpoint);
 }
 
 bool embObjMotionControl::positionMoveRaw(const double *refs)
 {
-    bool ret = true;
+    std::vector<int> joints;
+    std::vector<eOmc_setpoint_t> setpoints;
+    joints.reserve(_njoints);
+    setpoints.reserve(_njoints);
 
-    for(int j=0, index=0; j< _njoints; j++, index++)
+    for(int j=0; j< _njoints; j++)
+    {
+        eOmc_setpoint_t setpoint;
+        if(true == helper_positionMoveSetpoint(j, refs[j], setpoint))
+        {
+            joints.push_back(j);
+            setpoints.push_back(setpoint);
+        }
+    }
+
+    return helper_setSetpoints(joints, setpoints);
+}
+
+bool embObjMotionControl::helper_setSetpoints(const std::vector<int> &joints, std::vector<eOmc_setpoint_t> &setpoints)
+{
+    if(joints.empty())
+    {
+        return true;
+    }
+
+    std::vector<eOprotID32_t> id32s(joints.size());
+    std::vector<void*> values(joints.size());
+    for(size_t i=0; i<joints.size(); i++)
     {
-        ret &= positionMoveRaw(j, refs[index]);
+        id32s[i] = eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, joints[i], eoprot_tag_mc_joint_cmmnds_setpoint);
+        values[i] = &setpoints[i];
     }
-    return ret;
+
+    return res->setRemoteValues(id32s, values);
 }
 
 bool embObjMotionControl::relativeMoveRaw(int j, double delta)
@@ -2454,12 +2615,22 @@ bool embObjMotionControl::stopRaw()
 
 bool embObjMotionControl::positionMoveRaw(const int n_joint, const int *joints, const double *refs)
 {
-    bool ret = true;
+    std::vector<int> moved;
+    std::vector<eOmc_setpoint_t> setpoints;
+    moved.reserve(n_joint);
+    setpoints.reserve(n_joint);
+
     for(int j=0; j<n_joint; j++)
     {
-        ret = ret &&positionMoveRaw(joints[j], refs[j]);
+        eOmc_setpoint_t setpoint;
+        if(true == helper_positionMoveSetpoint(joints[j], refs[j], setpoint))
+        {
+            moved.push_back(joints[j]);
+            setpoints.push_back(setpoint);
+        }
     }
-    return ret;
+
+    return helper_setSetpoints(moved, setpoints);
 }
 
 bool embObjMotionControl::relativeMoveRaw(const int n_joint, const int *joints, const double *deltas)
@@ -2739,99 +2910,80 @@ bool embObjMotionControl::resetEncodersRaw()
 
 bool embObjMotionControl::getEncoderRaw(int j, double *value)
 {
-    eOmc_joint_status_core_t core;
-    eOprotID32_t protid = eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, j, eoprot_tag_mc_joint_status_core);
-
-    bool ret = res->getLocalValue(protid, &core);
-
-    if(ret)
-    {
-        *value = (double) core.measures.meas_position;
-    }
-    else
-    {
-        yError() << "embObjMotionControl while reading encoder";
-        *value = 0;
-    }
-
-    return ret;
+    if (j<0 || j>=_njoints) return false;
+    std::lock_guard<std::mutex> lck(_mutex);
+    *value = (double) _jointsCore[j].measures.meas_position;
+    return true;
 }
 
 bool embObjMotionControl::getEncodersRaw(double *encs)
 {
-    bool ret = true;
+    // all the joints are read from the same snapshot with one lock
+    std::lock_guard<std::mutex> lck(_mutex);
     for(int j=0; j< _njoints; j++)
     {
-        ret &= getEncoderRaw(j, &encs[j]);
-
+        encs[j] = (double) _jointsCore[j].measures.meas_position;
     }
-    return ret;
+    return true;
 }
 
 bool embObjMotionControl::getEncoderSpeedRaw(int j, double *sp)
 {
-    eOprotID32_t protid = eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, j, eoprot_tag_mc_joint_status_core);
-    eOmc_joint_status_core_t core;
-    *sp = 0;
-    if(!res->getLocalValue(protid, &core))
-    {
-        return false;
-    }
-    // extract requested data from status
-    *sp = (double) core.measures.meas_velocity;
+    if (j<0 || j>=_njoints) return false;
+    std::lock_guard<std::mutex> lck(_mutex);
+    *sp = (double) _jointsCore[j].measures.meas_velocity;
     return true;
 }
 
 bool embObjMotionControl::getEncoderSpeedsRaw(double *spds)
 {
-    bool ret = true;
+    std::lock_guard<std::mutex> lck(_mutex);
     for(int j=0; j< _njoints; j++)
     {
-        ret &= getEncoderSpeedRaw(j, &spds[j]);
+        spds[j] = (double) _jointsCore[j].measures.meas_velocity;
     }
-    return ret;
+    return true;
 }
 
 bool embObjMotionControl::getEncoderAccelerationRaw(int j, double *acc)
 {
-    eOprotID32_t protid = eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, j, eoprot_tag_mc_joint_status_core);
-    eOmc_joint_status_core_t core;
-    *acc = 0;
-    if(! res->getLocalValue(protid, &core))
-    {
-        return false;
-    }
-    *acc = (double) core.measures.meas_acceleration;
+    if (j<0 || j>=_njoints) return false;
+    std::lock_guard<std::mutex> lck(_mutex);
+    *acc = (double) _jointsCore[j].measures.meas_acceleration;
     return true;
 }
 
 bool embObjMotionControl::getEncoderAccelerationsRaw(double *accs)
 {
-    bool ret = true;
+    std::lock_guard<std::mutex> lck(_mutex);
     for(int j=0; j< _njoints; j++)
     {
-        ret &= getEncoderAccelerationRaw(j, &accs[j]);
+        accs[j] = (double) _jointsCore[j].measures.meas_acceleration;
     }
-    return ret;
+    return true;
 }
 
 ///////////////////////// END Encoder Interface
 
 bool embObjMotionControl::getEncodersTimedRaw(double *encs, double *stamps)
 {
-    bool ret = getEncodersRaw(encs);
+    // the positions and their stamps come from the same snapshot
     std::lock_guard<std::mutex> lck(_mutex);
     for(int i=0; i<_njoints; i++)
+    {
+        encs[i] = (double) _jointsCore[i].measures.meas_position;
         stamps[i] = _encodersStamp[i];
-    return ret;
+    }
+    return true;
 }
 
 bool embObjMotionControl::getEncoderTimedRaw(int j, double *encs, double *stamp)
 {
-    bool ret = getEncoderRaw(j, encs);
+    if (j<0 || j>=_njoints) return false;
     std::lock_guard<std::mutex> lck(_mutex);
+    *encs = (double) _jointsCore[j].measures.meas_position;
     *stamp = _encodersStamp[j];
-    return ret;
+    return true;
 }
 
 //////////////////////// BEGIN EncoderInterface
@@ -3800,18 +3952,21 @@ bool embObjMotionControl::updateVirtualAnalogSensorMeasure(int userLevel_jointNu
 // Torque control
 bool embObjMotionControl::getTorqueRaw(int j, double *t)
 {
-    eOmc_joint_status_core_t jstatus;
-    eOprotID32_t protoid = eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, j, eoprot_tag_mc_joint_status_core);
-    bool ret = res->getLocalValue(protoid, &jstatus);
-    *t = (double) _measureConverter->trqS2N(jstatus.measures.meas_torque, j);
-    return ret;
+    if (j<0 || j>=_njoints) return false;
+    eOmeas_torque_t meas_torque = 0;
+    {
+        std::lock_guard<std::mutex> lck(_mutex);
+        meas_torque = _jointsCore[j].measures.meas_torque;
+    }
+    *t = (double) _measureConverter->trqS2N(meas_torque, j);
+    return true;
 }
 
 bool embObjMotionControl::getTorquesRaw(double *t)
 {
-    bool ret = true;
+    std::lock_guard<std::mutex> lck(_mutex);
     for(int j=0; j<_njoints; j++)
-        ret = ret && getTorqueRaw(j, &t[j]);
+        t[j] = (double) _measureConverter->trqS2N(_jointsCore[j].measures.meas_torque, j);
     return true;
 }
 
@@ -3827,10 +3982,15 @@ bool embObjMotionControl::getTorqueRangesRaw(double *min, double *max)
 
 bool embObjMotionControl::setRefTorquesRaw(const double *t)
 {
-    bool ret = true;
-    for(int j=0; j<_njoints && ret; j++)
-        ret &= setRefTorqueRaw(j, t[j]);
-    return ret;
+    std::vector<int> joints(_njoints);
+    std::vector<eOmc_setpoint_t> setpoints(_njoints);
+    for(int j=0; j<_njoints; j++)
+    {
+        joints[j] = j;
+        setpoints[j].type = (eOenum08_t) eomc_setpoint_torque;
+        setpoints[j].to.torque.value =  (eOmeas_torque_t) S_32(t[j]);
+    }
+    return helper_setSetpoints(joints, setpoints);
 }
 
 bool embObjMotionControl::setRefTorqueRaw(int j, double t)
@@ -3845,12 +4005,14 @@ bool embObjMotionControl::setRefTorqueRaw(int j, double t)
 
 bool embObjMotionControl::setRefTorquesRaw(const int n_joint, const int *joints, const double *t)
 {
-    bool ret = true;
+    std::vector<int> js(joints, joints+n_joint);
+    std::vector<eOmc_setpoint_t> setpoints(n_joint);
     for(int j=0; j< n_joint; j++)
     {
-        ret &= setRefTorqueRaw(joints[j], t[j]);
+        setpoints[j].type = (eOenum08_t) eomc_setpoint_torque;
+        setpoints[j].to.torque.value =  (eOmeas_torque_t) S_32(t[j]);
     }
-    return ret;
+    return helper_setSetpoints(js, setpoints);
 }
 
 bool embObjMotionControl::getRefTorquesRaw(double *t)
@@ -4078,13 +4240,27 @@ bool embObjMotionControl::setMotorTorqueParamsRaw(int j, const MotorTorqueParame
 // IVelocityControl2
 bool embObjMotionControl::velocityMoveRaw(const int n_joint, const int *joints, const double *spds)
 {
-    bool ret = true;
+    std::vector<int> moved;
+    std::vector<eOmc_setpoint_t> setpoints;
+    moved.reserve(n_joint);
+    setpoints.reserve(n_joint);
 
     for(int j=0; j< n_joint; j++)
     {
-        ret &= velocityMoveRaw(joints[j], spds[j]);
+        eOmc_setpoint_t setpoint;
+        if(true == helper_velocityMoveSetpoint(joints[j], spds[j], setpoint))
+        {
+            moved.push_back(joints[j]);
+            setpoints.push_back(setpoint);
+        }
     }
-    return ret;
+
+    if(false == helper_setSetpoints(moved, setpoints))
+    {
+        yError() << "while setting velocity mode";
+        return false;
+    }
+    return true;
 }
 
 /*
@@ -4147,7 +4323,7 @@ bool embObjMotionControl::helper_getVelPidsRaw(Pid *pid)
 }
 
 // PositionDirect Interface
-bool embObjMotionControl::setPositionRaw(int j, double ref)
+bool embObjMotionControl::helper_setPositionSetpoint(int j, double ref, eOmc_setpoint_t &setpoint)
 {
     int mode = 0;
     getControlModeRaw(j, &mode);
@@ -4158,38 +4334,69 @@ bool embObjMotionControl::setPositionRaw(int j, double ref)
         {
             yError() << "setReferenceRaw: skipping command because" << getBoardInfo() << " joint " << j << " is not in VOCAB_CM_POSITION_DIRECT mode";
         }
-        return true;
+        return false;
     }
 
-    eOprotID32_t protoId = eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, j, eoprot_tag_mc_joint_cmmnds_setpoint);
-    eOmc_setpoint_t setpoint = {0};
+    memset(&setpoint, 0, sizeof(setpoint));
 
     _ref_positions[j] = ref;   // save internally the new value of pos.
     setpoint.type = (eOenum08_t) eomc_setpoint_positionraw;
     setpoint.to.position.value = (eOmeas_position_t) S_32(ref);
     setpoint.to.position.withvelocity = 0;
 
+    return true;
+}
+
+bool embObjMotionControl::setPositionRaw(int j, double ref)
+{
+    eOmc_setpoint_t setpoint;
+    if(false == helper_setPositionSetpoint(j, ref, setpoint))
+    {
+        return true;
+    }
+
+    eOprotID32_t protoId = eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, j, eoprot_tag_mc_joint_cmmnds_setpoint);
     return res->setRemoteValue(protoId, &setpoint);
 }
 
 bool embObjMotionControl::setPositionsRaw(const int n_joint, const int *joints, const double *refs)
 {
-    bool ret = true;
+    std::vector<int> moved;
+    std::vector<eOmc_setpoint_t> setpoints;
+    moved.reserve(n_joint);
+    setpoints.reserve(n_joint);
+
     for(int i=0; i<n_joint; i++)
     {
-        ret &= setPositionRaw(joints[i], refs[i]);
+        eOmc_setpoint_t setpoint;
+        if(true == helper_setPositionSetpoint(joints[i], refs[i], setpoint))
+        {
+            moved.push_back(joints[i]);
+            setpoints.push_back(setpoint);
+        }
     }
-    return ret;
+
+    return helper_setSetpoints(moved, setpoints);
 }
 
 bool embObjMotionControl::setPositionsRaw(const double *refs)
 {
-    bool ret = true;
+    std::vector<int> moved;
+    std::vector<eOmc_setpoint_t> setpoints;
+    moved.reserve(_njoints);
+    setpoints.reserve(_njoints);
+
     for (int i = 0; i<_njoints; i++)
     {
-        ret &= setPositionRaw(i, refs[i]);
+        eOmc_setpoint_t setpoint;
+        if(true == helper_setPositionSetpoint(i, refs[i], setpoint))
+        {
+            moved.push_back(i);
+            setpoints.push_back(setpoint);
+        }
     }
-    return ret;
+
+    return helper_setSetpoints(moved, setpoints);
 }
 
 
@@ -4948,12 +5155,15 @@ bool embObjMotionControl::setRefDutyCycleRaw(int j, double v)
 
 bool embObjMotionControl::setRefDutyCyclesRaw(const double *v)
 {
-    bool ret = true;
+    std::vector<int> joints(_njoints);
+    std::vector<eOmc_setpoint_t> setpoints(_njoints);
     for (int j = 0; j<_njoints; j++)
     {
-        ret = ret && setRefDutyCycleRaw(j, v[j]);
+        joints[j] = j;
+        setpoints[j].type = (eOenum08_t)eomc_setpoint_openloop;
+        setpoints[j].to.openloop.value = (eOmeas_pwm_t)S_16(v[j]);
     }
-    return ret;
+    return helper_setSetpoints(joints, setpoints);
 }
 
 bool embObjMotionControl::getRefDutyCycleRaw(int j, double *v)
@@ -5044,12 +5254,15 @@ bool embObjMotionControl::getCurrentRangesRaw(double *min, double *max)
 
 bool embObjMotionControl::setRefCurrentsRaw(const double *t)
 {
-    bool ret = true;
+    std::vector<int> joints(_njoints);
+    std::vector<eOmc_setpoint_t> setpoints(_njoints);
     for (int j = 0; j<_njoints; j++)
     {
-        ret = ret && setRefCurrentRaw(j, t[j]);
+        joints[j] = j;
+        setpoints[j].type = (eOenum08_t)eomc_setpoint_current;
+        setpoints[j].to.current.value = (eOmeas_pwm_t)S_16(t[j]);
     }
-    return ret;
+    return helper_setSetpoints(joints, setpoints);
 }
 
 bool embObjMotionControl::setRefCurrentRaw(int j, double t)
@@ -5066,12 +5279,14 @@ bool embObjMotionControl::setRefCurrentRaw(int j, double t)
 
 bool embObjMotionControl::setRefCurrentsRaw(const int n_joint, const int *joints, const double *t)
 {
-    bool ret = true;
+    std::vector<int> js(joints, joints+n_joint);
+    std::vector<eOmc_setpoint_t> setpoints(n_joint);
     for (int j = 0; j<n_joint; j++)
     {
-        ret = ret && setRefCurrentRaw(joints[j], t[j]);
+        setpoints[j].type = (eOenum08_t)eomc_setpoint_current;
+        setpoints[j].to.current.value = (eOmeas_pwm_t)S_16(t[j]);
     }
-    return ret;
+    return helper_setSetpoints(js, setpoints);
 }
 
 bool embObjMotionControl::getRefCurrentsRaw(double *t)
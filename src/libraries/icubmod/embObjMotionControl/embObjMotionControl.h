@@ -55,6 +55,7 @@ using namespace std;
 #include "measuresConverter.h"
 
 #include "mcEventDownsampler.h"
+#include <iCub/SharedJointState.h>
 
 
 #ifdef NETWORK_PERFORMANCE_BENCHMARK 
@@ -261,6 +262,13 @@ private:
     double  *_ref_positions;    // used for direct position control.
     double  *_ref_accs;         // for velocity control, in position min jerk eq is used.
     double  *_encodersStamp;                    /** keep information about acquisition time for encoders read */
+    std::vector<eOmc_joint_status_core_t> _jointsCore;  /** snapshot of the status of the joints refreshed by update(): it is protected by _mutex as _encodersStamp */
+    std::vector<eOmc_joint_status_core_t> _rxJointsCore; /** what update() has received in the current frame: it is used only by the ethReceiver thread */
+    std::vector<double> _rxEncodersStamp;
+    std::vector<uint8_t> _rxUpdated;                    /** per joint: rxStamp and/or rxCore if received in the current frame */
+    enum { rxStamp = 0x01, rxCore = 0x02 };
+    iCub::dev::SharedJointState _sharedState;           /** the snapshot, in user units, for the processes on the same machine: written by onFrameParsed() with _mutex held */
+    std::vector<iCub::dev::SharedJointSample> _sharedSamples;
     bool  *checking_motiondone;                 /* flag telling if I'm already waiting for motion done */
     #define MAX_POSITION_MOVE_INTERVAL 0.080
     double *_last_position_move_time;           /** time stamp for last received position move command*/    
@@ -342,6 +350,14 @@ private:
     bool helper_setSpdPidRaw(int j, const Pid &pid);
     bool helper_getSpdPidRaw(int j, Pid *pid);
     bool helper_getSpdPidsRaw(Pid *pid);
+
+    //used by the commands of the joints: they fill the setpoint of joint j and return false if the command must be skipped
+    //because the joint is not in the proper control mode
+    bool helper_positionMoveSetpoint(int j, double ref, eOmc_setpoint_t &setpoint);
+    bool helper_velocityMoveSetpoint(int j, double sp, eOmc_setpoint_t &setpoint);
+    bool helper_setPositionSetpoint(int j, double ref, eOmc_setpoint_t &setpoint);
+    //it sends the setpoints of many joints inside the same ropframe, so that the board applies them in the same cycle
+    bool helper_setSetpoints(const std::vector<int> &joints, std::vector<eOmc_setpoint_t> &setpoints);
     
 public:
 
@@ -356,6 +372,7 @@ public:
     virtual bool initialised();
     virtual eth::iethresType_t type();
     virtual bool update(eOprotID32_t id32, double timestamp, void *rxdata);
+    virtual void onFrameParsed(double timestamp);
 
     /////////   PID INTERFACE   /////////
     virtual bool setPidRaw(const PidControlTypeEnum& pidtype, int j, const Pid &pid) override;
@@ -144,7 +144,7 @@ bool Parser::parseControlsGroup(yarp::os::Searchable &config) // OK
 {
     Bottle xtmp;
 
-    Bottle controlsGroup = config.findGroup("CONTROLS", "Configuration of used control laws ");
+    Bottle &controlsGroup = findGroup(config, "CONTROLS");
     if(controlsGroup.isNull())
     {
         yError() << "embObjMC BOARD " << _boardname << " no CONTROLS group found in config file, returning";
@@ -204,7 +204,7 @@ bool Parser::parseSelectedCurrentPid(yarp::os::Searchable &config, bool pidisMan
         else
         {
             // 1) verify that selected control law is defined in file
-            Bottle botControlLaw = config.findGroup(_currentControlLaw[i]);
+            Bottle &botControlLaw = findGroup(config, _currentControlLaw[i]);
             if (botControlLaw.isNull())
             {
                 yError() << "embObjMC BOARD " << _boardname << "Missing " << i << " current control law " << _currentControlLaw[i].c_str();
@@ -270,7 +270,7 @@ bool Parser::parseSelectedSpeedPid(yarp::os::Searchable &config, bool pidisManda
         else
         {
             // 1) verify that selected control law is defined in file
-            Bottle botControlLaw = config.findGroup(_speedControlLaw[i]);
+            Bottle &botControlLaw = findGroup(config, _speedControlLaw[i]);
             if (botControlLaw.isNull())
             {
                 yError() << "embObjMC BOARD " << _boardname << "Missing " << i << " control law " << _speedControlLaw[i].c_str();
@@ -324,7 +324,7 @@ bool Parser::parseSelectedPositionControl(yarp::os::Searchable &config) // OK
     for(int i=0; i<_njoints; i++)
     {
         // 1) verify that selected control law is defined in file
-        Bottle botControlLaw = config.findGroup(_positionControlLaw[i]);
+        Bottle &botControlLaw = findGroup(config, _positionControlLaw[i]);
         if (botControlLaw.isNull())
         {
             yError() << "embObjMC BOARD " << _boardname << "Missing " << _positionControlLaw[i].c_str();
@@ -401,7 +401,7 @@ bool Parser::parseSelectedVelocityControl(yarp::os::Searchable &config) // OK
         }
 
         // 1) verify that selected control law is defined in file
-        Bottle botControlLaw = config.findGroup(_velocityControlLaw[i]);
+        Bottle &botControlLaw = findGroup(config, _velocityControlLaw[i]);
         if (botControlLaw.isNull())
         {
            yError() << "embObjMC BOARD " << _boardname << "Missing " << _velocityControlLaw[i].c_str();
@@ -478,7 +478,7 @@ bool Parser::parseSelectedMixedControl(yarp::os::Searchable &config) // OK
         }
 
   	// 1) verify that selected control law is defined in file
-        Bottle botControlLaw = config.findGroup(_mixedControlLaw[i]);
+        Bottle &botControlLaw = findGroup(config, _mixedControlLaw[i]);
         if (botControlLaw.isNull())
         {
             yError() << "embObjMC BOARD " << _boardname << "Missing " << _mixedControlLaw[i].c_str();
@@ -551,7 +551,7 @@ bool Parser::parseSelectedPosDirectControl(yarp::os::Searchable &config) // OK
     for (int i = 0; i<_njoints; i++)
     {
         // 1) verify that selected control law is defined in file
-        Bottle botControlLaw = config.findGroup(_posDirectControlLaw[i]);
+        Bottle &botControlLaw = findGroup(config, _posDirectControlLaw[i]);
         if (botControlLaw.isNull())
         {
             yError() << "embObjMC BOARD " << _boardname << "Missing " << _posDirectControlLaw[i].c_str();
@@ -623,7 +623,7 @@ bool Parser::parseSelectedVelDirectControl(yarp::os::Searchable &config) // OK
     for (int i = 0; i<_njoints; i++)
     {
         // 1) verify that selected control law is defined in file
-        Bottle botControlLaw = config.findGroup(_velDirectControlLaw[i]);
+        Bottle &botControlLaw = findGroup(config, _velDirectControlLaw[i]);
         if (botControlLaw.isNull())
         {
             yError() << "embObjMC BOARD " << _boardname << "Missing " << _velDirectControlLaw[i].c_str();
@@ -700,7 +700,7 @@ bool Parser::parseSelectedTorqueControl(yarp::os::Searchable &config) // OK
             continue;
         }
         // 1) verify that selected control law is defined in file
-        Bottle botControlLaw = config.findGroup(_torqueControlLaw[i]);
+        Bottle &botControlLaw = findGroup(config, _torqueControlLaw[i]);
         if (botControlLaw.isNull())
         {
             yError() << "embObjMC BOARD " << _boardname << "Missing " << _torqueControlLaw[i].c_str();
@@ -991,10 +991,17 @@ bool Parser::parsePidsGroup(Bottle& pidsGroup, Pid myPid[], string prefix)
 }
 */
 
+Bottle & Parser::findGroup(Searchable &config, const std::string &key)
+{
+    // all the parse functions are called with the config of the device: it is indexed once
+    _config.build(config);
+    return _config.findGroup(key);
+}
+
 bool Parser::extractGroup(Bottle &input, Bottle &out, const std::string &key1, const std::string &txt, int size, bool mandatory)
 {
     size++;
-    Bottle &tmp=input.findGroup(key1.c_str(), txt.c_str());
+    Bottle &tmp = _config.findGroup(input, key1);
     if (tmp.isNull())
     {
         std::string message = key1 + " parameter not found for board " + _boardname + " in bottle " + input.toString();
@@ -1354,7 +1361,7 @@ bool Parser::parsePidUnitsType(Bottle &bPid, yarp::dev::PidFeedbackUnitsEnum  &f
 
 bool Parser::parseFocGroup(yarp::os::Searchable &config, eomc::focBasedSpecificInfo_t *foc_based_info, std::string groupName)
 {
-     Bottle &focGroup=config.findGroup(groupName);
+     Bottle &focGroup = findGroup(config, groupName);
      if (focGroup.isNull() )
      {
         yError() << "embObjMC BOARD " << _boardname << " detected that Group " << groupName << " is not found in configuration file";
@@ -1495,7 +1502,7 @@ bool Parser::parseFocGroup(yarp::os::Searchable &config, eomc::focBasedSpecificI
 
 bool Parser::parseJointsetCfgGroup(yarp::os::Searchable &config, std::vector<JointsSet> &jsets, std::vector<int> &joint2set)
 {
-    Bottle jointsetcfg = config.findGroup("JOINTSET_CFG");
+    Bottle &jointsetcfg = findGroup(config, "JOINTSET_CFG");
     if (jointsetcfg.isNull())
     {
         yError() << "embObjMC BOARD " << _boardname << "Missing JOINTSET_CFG group";
@@ -1534,7 +1541,7 @@ bool Parser::parseJointsetCfgGroup(yarp::os::Searchable &config, std::vector<Joi
         bool formaterror = false;
 
 
-        Bottle &js_cfg = jointsetcfg.findGroup(jointset_string);
+        Bottle &js_cfg = _config.findGroup(jointsetcfg, jointset_string);
         if(js_cfg.isNull())
         {
             yError() << "embObjMC BOARD " << _boardname << "cannot find " << jointset_string;
@@ -1546,7 +1553,7 @@ bool Parser::parseJointsetCfgGroup(yarp::os::Searchable &config, std::vector<Joi
 
 
         //2) list of joints
-        Bottle &b_listofjoints=js_cfg.findGroup("listofjoints", "list of joints");
+        Bottle &b_listofjoints = _config.findGroup(js_cfg, "listofjoints");
         if (b_listofjoints.isNull())
         {
             yError() << "embObjMC BOARD " << _boardname << "listofjoints parameter not found";
@@ -1616,7 +1623,7 @@ bool Parser::parseTimeoutsGroup(yarp::os::Searchable &config, std::vector<timeou
 
     unsigned int i;
 
-    Bottle timeoutsGroup =config.findGroup("TIMEOUTS");
+    Bottle &timeoutsGroup = findGroup(config, "TIMEOUTS");
     if(timeoutsGroup.isNull())
     {
         yError() << "embObjMC BOARD " << _boardname << " no TIMEOUTS group found in config file.";
@@ -1643,7 +1650,7 @@ bool Parser::parseTimeoutsGroup(yarp::os::Searchable &config, std::vector<timeou
 
 bool Parser::parseCurrentLimits(yarp::os::Searchable &config, std::vector<motorCurrentLimits_t> &currLimits)
 {
-    Bottle &limits=config.findGroup("LIMITS");
+    Bottle &limits = findGroup(config, "LIMITS");
     if (limits.isNull())
     {
         yError() << "embObjMC BOARD " << _boardname << " detected that Group LIMITS is not found in configuration file";
@@ -1678,7 +1685,7 @@ bool Parser::parseCurrentLimits(yarp::os::Searchable &config, std::vector<motorC
 
 bool Parser::parseJointsLimits(yarp::os::Searchable &config, std::vector<jointLimits_t> &jointsLimits)
 {
-    Bottle &limits=config.findGroup("LIMITS");
+    Bottle &limits = findGroup(config, "LIMITS");
     if (limits.isNull())
     {
         yError() << "embObjMC BOARD " << _boardname << " detected that Group LIMITS is not found in configuration file";
@@ -1751,7 +1758,7 @@ bool Parser::parseJointsLimits(yarp::os::Searchable &config, std::vector<jointLi
 
 bool Parser::parseRotorsLimits(yarp::os::Searchable &config, std::vector<rotorLimits_t> &rotorsLimits)
 {
-    Bottle &limits=config.findGroup("LIMITS");
+    Bottle &limits = findGroup(config, "LIMITS");
     if (limits.isNull())
     {
         yError() << "embObjMC BOARD " << _boardname << " detected that Group LIMITS is not found in configuration file";
@@ -1798,7 +1805,7 @@ bool Parser::parseRotorsLimits(yarp::os::Searchable &config, std::vector<rotorLi
 
 bool Parser::parseCouplingInfo(yarp::os::Searchable &config, couplingInfo_t &couplingInfo)
 {
-    Bottle coupling_bottle = config.findGroup("COUPLINGS");
+    Bottle &coupling_bottle = findGroup(config, "COUPLINGS");
     if (coupling_bottle.isNull())
     {
         yError() << "embObjMC BOARD " << _boardname <<  "Missing Coupling group";
@@ -1854,13 +1861,13 @@ bool Parser::parseCouplingInfo(yarp::os::Searchable &config, couplingInfo_t &cou
 
 bool Parser::parseMotioncontrolVersion(yarp::os::Searchable &config, int &version)
 {
-    if (!config.findGroup("GENERAL").find("MotioncontrolVersion").isInt32())
+    if (!findGroup(config, "GENERAL").find("MotioncontrolVersion").isInt32())
     {
         yError() << "Missing MotioncontrolVersion parameter. RobotInterface cannot start. Please contact icub-support@iit.it";
         return false;
     }
 
-    version = config.findGroup("GENERAL").find("MotioncontrolVersion").asInt32();
+    version = findGroup(config, "GENERAL").find("MotioncontrolVersion").asInt32();
     return true;
 
 }
@@ -1868,14 +1875,14 @@ bool Parser::parseMotioncontrolVersion(yarp::os::Searchable &config, int &versio
 bool Parser::isVerboseEnabled(yarp::os::Searchable &config)
 {
     bool ret = false;
-    if(!config.findGroup("GENERAL").find("verbose").isBool())
+    if(!findGroup(config, "GENERAL").find("verbose").isBool())
     {
         yError() << "embObjMotionControl::open() detects that general->verbose bool param is different from accepted values (true / false). Assuming false";
         ret = false;
     }
     else
     {
-       ret = config.findGroup("GENERAL").find("verbose").asBool();
+       ret = findGroup(config, "GENERAL").find("verbose").asBool();
     }
     _verbosewhenok = ret;
     return ret;
@@ -1885,7 +1892,7 @@ bool Parser::parseBehaviourFalgs(yarp::os::Searchable &config, bool &useRawEncod
 {
 
     // Check useRawEncoderData = do not use calibration data!
-    Value use_raw = config.findGroup("GENERAL").find("useRawEncoderData");
+    Value use_raw = findGroup(config, "GENERAL").find("useRawEncoderData");
 
     if(use_raw.isNull())
     {
@@ -1912,7 +1919,7 @@ bool Parser::parseBehaviourFalgs(yarp::os::Searchable &config, bool &useRawEncod
     }
 
     // Check useRawEncoderData = do not use calibration data!
-    Value use_limitedPWM = config.findGroup("GENERAL").find("useLimitedPWM");
+    Value use_limitedPWM = findGroup(config, "GENERAL").find("useLimitedPWM");
     if(use_limitedPWM.isNull())
     {
         pwmIsLimited = false;
@@ -1939,7 +1946,7 @@ bool Parser::parseAxisInfo(yarp::os::Searchable &config, int axisMap[], std::vec
     unsigned int i;
     axisInfo.resize(_njoints);
 
-    Bottle general = config.findGroup("GENERAL");
+    Bottle &general = findGroup(config, "GENERAL");
     if (general.isNull())
     {
        yError() << "embObjMC BOARD " << _boardname << "Missing General group" ;
@@ -1995,7 +2002,7 @@ bool Parser::parseAxisInfo(yarp::os::Searchable &config, int axisMap[], std::vec
 
 bool Parser::parseEncoderFactor(yarp::os::Searchable &config, double encoderFactor[])
 {
-    Bottle general = config.findGroup("GENERAL");
+    Bottle &general = findGroup(config, "GENERAL");
     if (general.isNull())
     {
        yError() << "embObjMC BOARD " << _boardname << "Missing General group" ;
@@ -2026,7 +2033,7 @@ bool Parser::parseEncoderFactor(yarp::os::Searchable &config, double encoderFact
 
 bool Parser::parsefullscalePWM(yarp::os::Searchable &config, double dutycycleToPWM[])
 {
-    Bottle general = config.findGroup("GENERAL");
+    Bottle &general = findGroup(config, "GENERAL");
     if (general.isNull())
     {
         yError() << "embObjMC BOARD " << _boardname << "Missing General group";
@@ -2059,7 +2066,7 @@ bool Parser::parsefullscalePWM(yarp::os::Searchable &config, double dutycycleToP
 
 bool Parser::parseAmpsToSensor(yarp::os::Searchable &config, double ampsToSensor[])
 {
-    Bottle general = config.findGroup("GENERAL");
+    Bottle &general = findGroup(config, "GENERAL");
     if (general.isNull())
     {
         yError() << "embObjMC BOARD " << _boardname << "Missing General group";
@@ -2092,7 +2099,7 @@ bool Parser::parseAmpsToSensor(yarp::os::Searchable &config, double ampsToSensor
 
 bool Parser::parseGearboxValues(yarp::os::Searchable &config, double gearbox_M2J[], double gearbox_E2J[])
 {
-    Bottle general = config.findGroup("GENERAL");
+    Bottle &general = findGroup(config, "GENERAL");
     if (general.isNull())
     {
        yError() << "embObjMC BOARD " << _boardname << "Missing General group" ;
@@ -2149,7 +2156,7 @@ bool Parser::parseDeadzoneValue(yarp::os::Searchable &config, double deadzone[],
 //         return false;
 //     }
 
-    Bottle general = config.findGroup("OTHER_CONTROL_PARAMETERS");
+    Bottle &general = findGroup(config, "OTHER_CONTROL_PARAMETERS");
     if (general.isNull())
     {
         yWarning() << "embObjMC BOARD " << _boardname << "Missing OTHER_CONTROL_PARAMETERS.DeadZone parameter. I'll use default value. (see documentation for more datails)";
@@ -2178,7 +2185,7 @@ bool Parser::parseDeadzoneValue(yarp::os::Searchable &config, double deadzone[],
 
 bool Parser::parseKalmanFilterParams(yarp::os::Searchable &config, std::vector<kalmanFilterParams_t> &kalmanFilterParams)
 {
-    Bottle general = config.findGroup("KALMAN_FILTER");
+    Bottle &general = findGroup(config, "KALMAN_FILTER");
     if (general.isNull())
     {
         yWarning() << "embObjMC BOARD " << _boardname << "Missing KALMAN_FILTER group. Kalman Filter will be disabled by default.";
@@ -2277,7 +2284,7 @@ bool Parser::parseKalmanFilterParams(yarp::os::Searchable &config, std::vector<k
 
 bool Parser::parseMechanicalsFlags(yarp::os::Searchable &config, int useMotorSpeedFbk[])
 {
-    Bottle general = config.findGroup("GENERAL");
+    Bottle &general = findGroup(config, "GENERAL");
     if (general.isNull())
     {
        yError() << "embObjMC BOARD " << _boardname << "Missing General group" ;
@@ -2302,8 +2309,7 @@ bool Parser::parseMechanicalsFlags(yarp::os::Searchable &config, int useMotorSpe
 
 bool Parser::parseImpedanceGroup(yarp::os::Searchable &config,std::vector<impedanceParameters_t> &impedance)
 {
-    Bottle impedanceGroup;
-    impedanceGroup=config.findGroup("IMPEDANCE","IMPEDANCE parameters");
+    Bottle &impedanceGroup = findGroup(config, "IMPEDANCE");
 
     if(impedanceGroup.isNull())
     {
@@ -40,6 +40,8 @@
 #include "EoMotionControl.h"
 #include <yarp/os/LogStream.h>
 
+#include "configIndex.h"
+
 
 // - public #define  --------------------------------------------------------------------------------------------------
 
@@ -325,6 +327,7 @@ private:
     int _njoints;
     std::string _boardname;
     bool _verbosewhenok;
+    eth::ConfigIndex _config; // the groups of the config given to the parse functions, indexed at the first one
 
     std::map<std::string, Pid_Algorithm*> minjerkAlgoMap;
     //std::map<std::string, Pid_Algorithm*> directAlgoMap;
@@ -395,6 +398,7 @@ private:
     bool convert(yarp::os::Bottle &bottle, std::vector<double> &matrix, bool &formaterror, int targetsize);
 
     //general utils functions
+    yarp::os::Bottle & findGroup(yarp::os::Searchable &config, const std::string &key);
     bool extractGroup(yarp::os::Bottle &input, yarp::os::Bottle &out, const std::string &key1, const std::string &txt, int size, bool mandatory=true);
     template <class T>
     bool checkAndSetVectorSize(std::vector<T> &vec, int size, const std::string &funcName)
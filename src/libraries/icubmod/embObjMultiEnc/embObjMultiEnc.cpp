@@ -40,6 +40,7 @@
 
 #include <yarp/os/NetType.h>
 #include <yarp/conf/environment.h>
+#include <iCub/StartupTrace.h>
 
 #ifdef WIN32
 #pragma warning(once:4355)
@@ -194,6 +195,8 @@ bool embObjMultiEnc::initialised()
 
 bool embObjMultiEnc::open(yarp::os::Searchable &config)
 {
+    iCub::dev::TraceSpan span("open", "embObjMultiEnc::open");
+
     // - first thing to do is verify if the eth manager is available. then i parse info about the eth board.
 
     ethManager = eth::TheEthManager::instance();
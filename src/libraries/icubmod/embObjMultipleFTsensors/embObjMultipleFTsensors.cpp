@@ -20,6 +20,7 @@
 #include "EoProtocol.h"
 #include "EoProtocolAS.h"
 #include "EoProtocolMN.h"
+#include <iCub/StartupTrace.h>
 
 #ifdef WIN32
 #pragma warning(once : 4355)
@@ -51,10 +52,14 @@ bool embObjMultipleFTsensors::initialised()
 
 bool embObjMultipleFTsensors::open(yarp::os::Searchable &config)
 {
+    iCub::dev::TraceSpan span("open", "embObjMultipleFTsensors::open");
+
     yInfo() << "embObjMultipleFTsensors::open(): preparing ETH resource";
     if (!device_->prerareEthService(config, this))
         return false;
 
+    diagSource_ = eth::theDiagnosticsSink::getInstance().addSource(device_->getBoardInfo(), 10);
+
     yInfo() << device_->getBoardInfo() << " embObjMultipleFTsensors::open(): browsing xml files which describe the service";
     ServiceParserMultipleFt parser;
     if (!parser.parse(config))
@@ -235,23 +240,26 @@ bool embObjMultipleFTsensors::update(eOprotID32_t id32, double timestamp, void *
         return false;
 
     eOprotIndex_t eoprotIndex = eoprot_ID2index(id32);
-    if (eoprotIndex > 3)
+    if (eoprotIndex >= maxFtSensors_)
     {
-        yError() << device_->getBoardInfo() << " update() index too big";
+        int64_t arg = eoprotIndex;
+        eth::theDiagnosticsSink::getInstance().post(diagSource_, eth::theDiagnosticsSink::Level::error, &arg, 1, "update() index too big:");
         return false;
     }
 
     eOprotEntity_t entity = eoprot_ID2entity(id32);
     if (entity != eoprot_entity_as_ft)
     {
-        yError() << device_->getBoardInfo() << " update() wrong entity";
+        int64_t arg = entity;
+        eth::theDiagnosticsSink::getInstance().post(diagSource_, eth::theDiagnosticsSink::Level::error, &arg, 1, "update() wrong entity:");
         return false;
     }
 
     eOprotTag_t tag = eoprot_ID2tag(id32);
     if (tag != eoprot_tag_as_ft_status_timedvalue)
     {
-        yError() << device_->getBoardInfo() << " update() wrong tag";
+        int64_t arg = tag;
+        eth::theDiagnosticsSink::getInstance().post(diagSource_, eth::theDiagnosticsSink::Level::error, &arg, 1, "update() wrong tag:");
         return false;
     }
 
@@ -271,6 +279,18 @@ bool embObjMultipleFTsensors::update(eOprotID32_t id32, double timestamp, void *
 
     temperaturesensordata_[eoprotIndex].data_ = data->temperature;
     temperaturesensordata_[eoprotIndex].timeStamp_ = calculateBoardTime(data->age);
+    lck.unlock();
+
+    eth::SensorSample sample;
+    sample.type = 0;
+    sample.size = ftChannels_;
+    sample.sensor = eoprotIndex;
+    for (int index = 0; index < eoas_ft_6axis; ++index)
+    {
+        sample.values[index] = data->values[index];
+    }
+    sample.timestamp = data->age;
+    samples_.put(eoprotIndex, sample);
     return true;
 }
 
@@ -309,6 +329,24 @@ bool embObjMultipleFTsensors::getSixAxisForceTorqueSensorMeasure(size_t sensorIn
     return true;
 }
 
+bool embObjMultipleFTsensors::getLatestSensorSamples(std::vector<eth::SensorSample> &samples) const
+{
+    if (!device_->isOpen())
+        return false;
+
+    samples_.latest(samples);
+    return true;
+}
+
+bool embObjMultipleFTsensors::getNewSensorSamples(std::vector<eth::SensorSample> &samples, uint64_t &lost)
+{
+    if (!device_->isOpen())
+        return false;
+
+    samples_.history(samples, lost);
+    return true;
+}
+
 size_t embObjMultipleFTsensors::getNrOfSixAxisForceTorqueSensors() const
 {
     return ftSensorsData_.size();
@@ -394,7 +432,8 @@ bool embObjMultipleFTsensors::checkUpdateTimeout(eOprotID32_t id32, eOabstime_t
     eOabstime_t diff = current - timeoutUpdate_[id32];
     if (timeoutUpdate_[id32] != 0 && current > timeoutUpdate_[id32] + updateTimeout_)
     {
-        yError() << device_->getBoardInfo() << " update timeout for index:" << eoprot_ID2index(id32);
+        int64_t arg = eoprot_ID2index(id32);
+        eth::theDiagnosticsSink::getInstance().post(diagSource_, eth::theDiagnosticsSink::Level::error, &arg, 1, "update timeout for index:");
         timeoutUpdate_[id32] = current;
         masStatus_[eoprot_ID2index(id32)] = MAS_TIMEOUT;
         return false;
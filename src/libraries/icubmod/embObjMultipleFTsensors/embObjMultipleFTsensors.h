@@ -19,6 +19,8 @@
 #include <string>
 
 #include "embObjGeneralDevPrivData.h"
+#include "sensorsBuffer.h"
+#include "theDiagnosticsSink.h"
 #include "serviceParserMultipleFt.h"
 
 namespace yarp::dev
@@ -44,7 +46,7 @@ class TemperatureData
     double timeStamp_;
 };
 
-class yarp::dev::embObjMultipleFTsensors : public yarp::dev::DeviceDriver, public eth::IethResource, public yarp::dev::ITemperatureSensors, public yarp::dev::ISixAxisForceTorqueSensors
+class yarp::dev::embObjMultipleFTsensors : public yarp::dev::DeviceDriver, public eth::IethResource, public yarp::dev::ITemperatureSensors, public yarp::dev::ISixAxisForceTorqueSensors, public eth::IbulkSensors
 {
    public:
     embObjMultipleFTsensors();
@@ -74,12 +76,20 @@ class yarp::dev::embObjMultipleFTsensors : public yarp::dev::DeviceDriver, publi
     virtual bool getSixAxisForceTorqueSensorFrameName(size_t sensorindex, std::string& frameName) const override;
     virtual bool getSixAxisForceTorqueSensorMeasure(size_t sensorindex, yarp::sig::Vector& out, double& timestamp) const override;
 
+    // IbulkSensors: the six axis measures of all the sensors, without taking mutex_
+    virtual bool getLatestSensorSamples(std::vector<eth::SensorSample>& samples) const override;
+    virtual bool getNewSensorSamples(std::vector<eth::SensorSample>& samples, uint64_t& lost) override;
+
    protected:
     std::shared_ptr<yarp::dev::embObjDevPrivData> device_;
     mutable std::shared_mutex mutex_;
     std::map<eOprotID32_t, FtData> ftSensorsData_;
     std::map<eOprotID32_t, TemperatureData> temperaturesensordata_;
     std::map<eOprotID32_t, eOabstime_t> timeoutUpdate_;
+    static constexpr size_t maxFtSensors_{4};
+    static constexpr size_t samplesHistory_{4096};  // 1 s of 4 sensors at 1 kHz
+    eth::SensorsBuffer samples_{maxFtSensors_, samplesHistory_};
+    uint16_t diagSource_{eth::theDiagnosticsSink::noSource};  // the errors of update() are logged by the sink
 
     bool sendConfig2boards(ServiceParserMultipleFt& parser, eth::AbstractEthResource* deviceRes);
     bool sendStart2boards(ServiceParserMultipleFt& parser, eth::AbstractEthResource* deviceRes);
@@ -34,6 +34,7 @@
 #include "EoProtocolAS.h"
 
 #include <yarp/os/NetType.h>
+#include <iCub/StartupTrace.h>
 
 #ifdef WIN32
 #pragma warning(once:4355)
@@ -79,6 +80,8 @@ bool embObjPOS::initialised()
 
 bool embObjPOS::open(yarp::os::Searchable &config)
 {
+    iCub::dev::TraceSpan span("open", "embObjPOS::open");
+
     // 1) prepare eth service verifing if the eth manager is available and parsing info about the eth board.
 
     yInfo() << "embObjPOS::open(): preparing ETH resource";
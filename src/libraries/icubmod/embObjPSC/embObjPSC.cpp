@@ -34,6 +34,7 @@
 #include "EoProtocolAS.h"
 
 #include <yarp/os/NetType.h>
+#include <iCub/StartupTrace.h>
 
 #ifdef WIN32
 #pragma warning(once:4355)
@@ -82,6 +83,8 @@ bool embObjPSC::initialised()
 
 bool embObjPSC::open(yarp::os::Searchable &config)
 {
+    iCub::dev::TraceSpan span("open", "embObjPSC::open");
+
     // 1) prepare Eth service verifing if the eth manager is available and parsing info about the eth board.
 
     if(! m_PDdevice.prerareEthService(config, this))
@@ -25,6 +25,7 @@
 
 
 #include <ethResource.h>
+#include <theDiagnosticsSink.h>
 #include "../embObjLib/hostTransceiver.hpp"
 
 #include "EOnv.h"
@@ -33,10 +34,13 @@
 #include <yarp/conf/environment.h>
 
 #include "EoCommon.h"
+#include <iCub/StartupTrace.h>
 
 using namespace std;
 using namespace iCub::skin::diagnostics;
 
+static std::string formatDiagnostic(const eth::DiagnosticEvent &event);
+
 bool isCANaddressValid(int adr)
 {
     return ((adr>0) && (adr<15));
@@ -57,6 +61,8 @@ EmbObjSkin::EmbObjSkin() :  _isDiagnosticPresent(false)
 {
     res         = NULL;
     ethManager  = NULL;
+    listener    = NULL;
+    diagsource  = eth::theDiagnosticsSink::noSource;
     opened     = false;
     sensorsNum  = 0;
     _skCfg.numOfPatches = 0;
@@ -350,6 +356,7 @@ bool EmbObjSkin::fromConfig(yarp::os::Searchable& config)
     {
         this->skindata[i]=(double)240;
     }
+    this->skindirty.assign(sensorsNum/12, 1);
 
     mtx.unlock();
 
@@ -445,6 +452,8 @@ bool EmbObjSkin::fromConfig(yarp::os::Searchable& config)
 
 bool EmbObjSkin::open(yarp::os::Searchable& config)
 {
+    iCub::dev::TraceSpan span("open", "EmbObjSkin::open");
+
     // - first thing to do is verify if the eth manager is available. then i parse info about the eth board.
 
     ethManager = eth::TheEthManager::instance();
@@ -493,6 +502,7 @@ bool EmbObjSkin::open(yarp::os::Searchable& config)
     char name[80];
     snprintf(name, sizeof(name), "embObjSkin on BOARD %s IP %s", res->getProperties().boardnameString.c_str(), res->getProperties().ipv4addrString.c_str());
     _cfgReader.setName(name);
+    diagsource = eth::theDiagnosticsSink::getInstance().addSource(name, 10, formatDiagnostic);
 
 
     if(!res->verifyEPprotocol(eoprot_endpoint_skin))
@@ -583,6 +593,26 @@ int EmbObjSkin::read(yarp::sig::Vector &out)
     return yarp::dev::IAnalogSensor::AS_OK;
 }
 
+bool EmbObjSkin::readDelta(std::vector<uint8_t> &packet, int threshold, bool keyframe)
+{
+    std::lock_guard<std::mutex> lck(mtx);
+    skindelta.encode(skindata.data(), skindata.size(), skindirty, 12, threshold, keyframe, packet);
+    return true;
+}
+
+bool EmbObjSkin::setUpdateListener(iCub::skin::ISkinUpdateListener *l)
+{
+    std::lock_guard<std::mutex> lck(mtx);
+    listener = l;
+    return true;
+}
+
+yarp::os::Stamp EmbObjSkin::getLastInputStamp()
+{
+    std::lock_guard<std::mutex> lck(mtx);
+    return lastStamp;
+}
+
 int EmbObjSkin::getState(int ch)
 {
     return yarp::dev::IAnalogSensor::AS_OK;;
@@ -783,6 +813,25 @@ static uint32_t receivedpatches[2][16] = {0};
 static uint32_t counterpa = 0;
 #endif
 
+// the events of update(): a skin error code {net, board, sensor, error} or, with unknownMessage as text, an unknown
+// message {index, number of messages, frame id, length}
+static const char unknownMessage[] = "unknown";
+
+static std::string formatDiagnostic(const eth::DiagnosticEvent &event)
+{
+    std::stringstream ss;
+    if(0 == strcmp(event.text, unknownMessage))
+    {
+        ss << "Unknown Message received from skin (" << event.args[0] << "/" << event.args[1] << "): frameID=" << event.args[2] << " len=" << event.args[3];
+    }
+    else
+    {
+        ss << "error code: canDeviceNum: " << event.args[0] << " board: " << event.args[1] << " sensor: " << event.args[2] <<
+              " error: " << iCub::skin::diagnostics::printErrorCode(static_cast<int>(event.args[3]));
+    }
+    return ss.str();
+}
+
 bool EmbObjSkin::update(eOprotID32_t id32, double timestamp, void *rxdata)
 {
     uint8_t           msgtype = 0;
@@ -866,6 +915,11 @@ bool EmbObjSkin::update(eOprotID32_t id32, double timestamp, void *rxdata)
             // marco.accame: added lock to avoid concurrent access to this->skindata. i lock at triangle resolution ...
             mtx.lock();
 
+            if((index/12) < skindirty.size())
+            {
+                skindirty[index/12] = 1;
+            }
+
             if (msgtype == 0x40)
             {
 #if defined(DEBUG_PRINT_RX_STATS)
@@ -907,13 +961,8 @@ bool EmbObjSkin::update(eOprotID32_t id32, double timestamp, void *rxdata)
 
                         if (fullMsg != SkinErrorCode::StatusOK)
                         {
-                            yError() << "embObjSkin error code: " <<
-                                        "BOARD: " << res->getProperties().boardnameString  <<
-                                        "IP:"     << res->getProperties().ipv4addrString <<
-                                        "canDeviceNum: " << errors[i].net <<
-                                        "board: " <<  errors[i].board <<
-                                        "sensor: " << errors[i].sensor <<
-                                        "error: " << iCub::skin::diagnostics::printErrorCode(errors[i].error).c_str();
+                            int64_t args[4] = { errors[i].net, errors[i].board, errors[i].sensor, errors[i].error };
+                            eth::theDiagnosticsSink::getInstance().post(diagsource, eth::theDiagnosticsSink::Level::error, args, 4);
                         }
                     }
                     else
@@ -932,7 +981,10 @@ bool EmbObjSkin::update(eOprotID32_t id32, double timestamp, void *rxdata)
         else
         {
             if(error == 0)
-                yError() << "EMS: " << res->getProperties().ipv4addrString << " Unknown Message received from skin (" << i<<"/"<< sizeofarray <<"): frameID=" << canframeid11<< " len="<<canframesize << "canframe.data="<<canframedata[0] << " " <<canframedata[1] << " " <<canframedata[2] << " " <<canframedata[3] <<"\n" ;
+            {
+                int64_t args[4] = { i, sizeofarray, canframeid11, canframesize };
+                eth::theDiagnosticsSink::getInstance().post(diagsource, eth::theDiagnosticsSink::Level::error, args, 4, unknownMessage);
+            }
             error++;
             if (error == 10000)
                 error = 0;
@@ -953,6 +1005,15 @@ bool EmbObjSkin::update(eOprotID32_t id32, double timestamp, void *rxdata)
     }
 #endif
 
+    // the time the ropframe has been received, as a new sample of the skin
+    mtx.lock();
+    lastStamp.update(timestamp);
+    if(NULL != listener)
+    {
+        listener->skinUpdated(lastStamp);
+    }
+    mtx.unlock();
+
     return true;
 }
 
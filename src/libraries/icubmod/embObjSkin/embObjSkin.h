@@ -27,7 +27,9 @@
 #include <yarp/os/PeriodicThread.h>
 #include <yarp/dev/ControlBoardInterfaces.h>
 #include <yarp/dev/IAnalogSensor.h>
+#include <yarp/dev/IPreciselyTimed.h>
 #include <yarp/dev/PolyDriver.h>
+#include <yarp/os/Stamp.h>
 
 
 #include "IethResource.h"
@@ -37,6 +39,8 @@
 
 #include "SkinConfigReader.h"
 #include <SkinDiagnostics.h>
+#include <SkinDelta.h>
+#include <SkinUpdate.h>
 #include "serviceParser.h"
 
 using namespace yarp::os;
@@ -68,8 +72,11 @@ class SkinConfig
 // -- class EmbObjSkin
 
 class EmbObjSkin :  public yarp::dev::IAnalogSensor,
+                    public yarp::dev::IPreciselyTimed,
                     public DeviceDriver,
-                    public eth::IethResource
+                    public eth::IethResource,
+                    public iCub::skin::delta::ISkinDelta,
+                    public iCub::skin::ISkinUpdateNotifier
 {
 
 public:
@@ -93,6 +100,10 @@ protected:
     //std::vector<SkinPatchInfo> patchInfoList;
     size_t          sensorsNum;
     Vector          skindata;
+    std::vector<uint8_t> skindirty;     // one flag per triangle received since the last readDelta()
+    iCub::skin::delta::Encoder skindelta;
+    yarp::os::Stamp lastStamp;          // time of reception of the last data, and their sequence number
+    iCub::skin::ISkinUpdateListener *listener;  // told at the end of each update(), under mtx
     //uint8_t         numOfPatches; //currently one patch is made up by all skin boards connected to one can port of ems.
     SkinBoardCfgParam _brdCfg;
     SkinTriangleCfgParam _triangCfg;
@@ -129,6 +140,9 @@ private:
     /** The detected skin errors. These are used for diagnostics purposes. */
     std::vector<iCub::skin::diagnostics::DetectedError> errors;
 
+    /** The source of the events of update() in eth::theDiagnosticsSink, which logs them out of the ethReceiver thread. */
+    uint16_t diagsource;
+
 public:
 
     EmbObjSkin();
@@ -148,6 +162,13 @@ public:
     virtual int     calibrateSensor(const yarp::sig::Vector& v);
     virtual int     calibrateChannel(int ch);
 
+    virtual bool    readDelta(std::vector<uint8_t> &packet, int threshold, bool keyframe);
+
+    virtual bool    setUpdateListener(iCub::skin::ISkinUpdateListener *l);
+
+    // IPreciselyTimed: the analogServer puts it in the envelope of the skin port, so that the latency can be measured downstream
+    virtual yarp::os::Stamp getLastInputStamp();
+
     virtual bool initialised();
     virtual eth::iethresType_t type();
     virtual bool update(eOprotID32_t id32, double timestamp, void *rxdata);
@@ -30,6 +30,7 @@
 #endif
 
 #include <yarp/dev/ControlBoardInterfacesImpl.h>
+#include <iCub/CanCapture.h>
 
 // get the message types from the DSP code.
 #include "messages.h"
@@ -64,6 +65,8 @@ EsdMessageSnifferParameters::EsdMessageSnifferParameters(int nj)
 	_rxQueueSize = 2047;
 	_txTimeout = 20;
 	_rxTimeout = 20;
+
+    _captureFrames = 1<<20;
 }
 
 EsdMessageSnifferParameters::~EsdMessageSnifferParameters()
@@ -132,6 +135,7 @@ public:
 	bool writePacket (void);
 	bool printMessage (const CMSG& m);
 	bool dumpBuffers (void);
+	void capture (double stamp, const CMSG& m);
 	inline int getJoints (void) const { return _njoints; }
 	inline bool getErrorStatus (void) const { return _error_status; }
 	
@@ -169,6 +173,13 @@ public:
 												/// used to spy on can messages.
 	
 	char _printBuffer[16384];                   /// old-style static print buffer (should be used only for debugging).
+
+	iCub::dev::CanCaptureRing _capture;         /// raw frames, if a capture file is given.
+	iCub::dev::CanIdFilter _captureIds;         /// identifiers to capture.
+	double _stampScale;                         /// seconds per tick of the hardware timestamps, 0 if none.
+#ifdef NTCAN_IOCTL_GET_TIMESTAMP_FREQ
+	CMSG_T _readBufferT[BUF_SIZE];				/// read buffer, with the timestamps.
+#endif
 };
 
 EsdResources::EsdResources ()
@@ -194,6 +205,7 @@ EsdResources::EsdResources ()
 	_bcastRecvBuffer = NULL;
 
 	_error_status = false;
+	_stampScale = 0;
 }
 
 EsdResources::~EsdResources () 
@@ -256,12 +268,36 @@ bool EsdResources::initialize (const EsdMessageSnifferParameters& parms)
 	for (i = 0x100; i < 0x1ff; i++)
 		canIdAdd (_handle, i);
 
+	/// the raw frames are captured as they are read, the decoding is left to whoever reads the file.
+	_stampScale = 0;
+	if (!parms._captureFile.empty())
+        {
+            if (!parms._captureIds.empty() && !_captureIds.parse (parms._captureIds))
+                ACE_OS::fprintf (stderr, "Sniffer: cannot parse CanCaptureIds %s, capturing all\n", parms._captureIds.c_str());
+
+            if (!_capture.open (parms._captureFile, parms._captureFrames))
+                {
+                    ACE_OS::fprintf (stderr, "Sniffer: cannot create the capture file %s\n", parms._captureFile.c_str());
+                    canClose (_handle);
+                    _handle = ACE_INVALID_HANDLE;
+                    return false;
+                }
+
+#ifdef NTCAN_IOCTL_GET_TIMESTAMP_FREQ
+            uint64_t freq = 0;
+            if (canIoctl (_handle, NTCAN_IOCTL_GET_TIMESTAMP_FREQ, &freq) == NTCAN_SUCCESS && freq != 0)
+                _stampScale = 1.0 / (double)freq;
+#endif
+        }
+
 	return true;
 }
 
 
 bool EsdResources::uninitialize ()
 {
+	_capture.close ();
+
 	if (_bcastRecvBuffer != NULL) 
         {
             delete[] _bcastRecvBuffer;
@@ -288,14 +324,59 @@ bool EsdResources::read (void)
 	int32_t messages = BUF_SIZE;
 #endif
 
+#ifdef NTCAN_IOCTL_GET_TIMESTAMP_FREQ
+	if (_stampScale > 0)
+        {
+            int res = canTakeT (_handle, _readBufferT, &messages);
+            if (res != NTCAN_SUCCESS)
+                return false;
+
+            for (int i = 0; i < messages; i++)
+                {
+                    const CMSG_T& t = _readBufferT[i];
+                    CMSG& m = _readBuffer[i];
+                    m.id = t.id;
+                    m.len = t.len;
+                    m.msg_lost = t.msg_lost;
+                    ACE_OS::memcpy (m.data, t.data, sizeof(m.data));
+                    capture (t.timestamp * _stampScale, m);
+                }
+
+            _readMessages = messages;
+            return true;
+        }
+#endif
+
 	int res = canTake (_handle, _readBuffer, &messages); 
 	if (res != NTCAN_SUCCESS)
 		return false;
 
+	if (_capture.isOpen())
+        {
+            // no hardware timestamps, the frames of a read share its time
+            const double now = Time::now();
+            for (int i = 0; i < messages; i++)
+                capture (now, _readBuffer[i]);
+        }
+
 	_readMessages = messages;
 	return true;
 }
 
+void EsdResources::capture (double stamp, const CMSG& m)
+{
+	if (!_captureIds.accepts (m.id & 0x7ff))
+		return;
+
+	unsigned int flags = (_stampScale > 0) ? CAN_CAPTURE_HW_STAMP : 0;
+	if (m.msg_lost != 0)
+		flags |= CAN_CAPTURE_LOST;
+	if (m.len & NTCAN_NO_DATA)
+		flags |= CAN_CAPTURE_ERROR;
+
+	_capture.push (stamp, m.id & 0x7ff, m.len & 0x0f, m.data, flags);
+}
+
 bool EsdResources::startPacket (void)
 {
 	_writeMessages = 0;
@@ -453,6 +534,13 @@ bool EsdMessageSniffer::open(yarp::os::Searchable& config)
     xtmp = p.findGroup("CAN").findGroup("CanTimeout");
     params._timeout=xtmp.get(1).asInt32();
 
+    if (p.findGroup("CAN").check("CanCaptureFile"))
+        {
+            params._captureFile = p.findGroup("CAN").find("CanCaptureFile").asString();
+            params._captureFrames = p.findGroup("CAN").check("CanCaptureFrames", Value(params._captureFrames)).asInt32();
+            params._captureIds = p.findGroup("CAN").check("CanCaptureIds", Value("")).asString();
+        }
+
     xtmp = p.findGroup("CAN").findGroup("CanAddresses");
     for (i = 1; i < xtmp.size(); i++) params._destinations[i-1] = (unsigned char)(xtmp.get(i).asInt32());
    
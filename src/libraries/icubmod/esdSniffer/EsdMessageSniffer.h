@@ -16,6 +16,7 @@
 
 #include <mutex>
 #include <condition_variable>
+#include <string>
 
 #include <yarp/dev/DeviceDriver.h>
 #include <yarp/dev/ControlBoardInterfaces.h>
@@ -66,6 +67,10 @@ struct yarp::dev::EsdMessageSnifferParameters
     int *_axisMap;                              /** axis remapping lookup-table */
     double *_angleToEncoder;                    /** angle to encoder conversion factors */
     double *_zeros;                             /** encoder zeros */
+
+    std::string _captureFile;                   /** ring file for the raw frames, none if empty */
+    int _captureFrames;                         /** capacity of the ring file */
+    std::string _captureIds;                    /** identifiers to capture (e.g. 0x100-0x1ff), all if empty */
 };
 
 /**
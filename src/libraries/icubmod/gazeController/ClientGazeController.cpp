@@ -30,6 +30,16 @@
 #define GAZECTRL_ACK            Vocab32::encode("ack")
 #define GAZECTRL_NACK           Vocab32::encode("nack")
 
+// fields of the state streamed out by the server
+// (to be kept aligned with iKinGazeCtrl)
+#define GAZECTRL_STATE_X            0
+#define GAZECTRL_STATE_Q            1
+#define GAZECTRL_STATE_QDES         2
+#define GAZECTRL_STATE_QDOT         3
+#define GAZECTRL_STATE_MOTIONDONE   4
+#define GAZECTRL_STATE_SACCADEDONE  5
+#define GAZECTRL_STATE_NUM          6
+
 using namespace std;
 using namespace yarp::os;
 using namespace yarp::dev;
@@ -78,6 +88,9 @@ void ClientGazeController::init()
     timeout=GAZECTRL_DEFAULT_TMO;
     lastFpMsgArrivalTime=0.0;
     lastAngMsgArrivalTime=0.0;
+    lastStateMsgArrivalTime=0.0;
+    stateAvailable=false;
+    motionDoneStale=false;
 
     fixationPoint.resize(3,0.0);
     angles.resize(3,0.0);
@@ -114,6 +127,7 @@ bool ClientGazeController::open(Searchable &config)
     portStateFp.open(local+"/x:i");
     portStateAng.open(local+"/angles:i");
     portStateHead.open(local+"/q:i");
+    portStateFull.open(local+"/state_full:i");
     portEvents.open(local+"/events:i");
     portRpc.open(local+"/rpc");    
 
@@ -153,6 +167,11 @@ bool ClientGazeController::open(Searchable &config)
     ok&=Network::connect(remote+"/q:o",portStateHead.getName(),carrier);
     ok&=Network::connect(remote+"/events:o",portEvents.getName(),carrier);
 
+    // the getters fall back to rpc if the server does not stream its full state
+    stateAvailable=Network::connect(remote+"/state_full:o",portStateFull.getName(),carrier);
+    if (!stateAvailable)
+        yWarning("unable to connect to the server state_full port; getters will rely on rpc");
+
     return connected=ok;
 }
 
@@ -175,6 +194,7 @@ bool ClientGazeController::close()
     portStateFp.interrupt();
     portStateAng.interrupt();
     portStateHead.interrupt();
+    portStateFull.interrupt();
     portEvents.interrupt();
     portRpc.interrupt();
 
@@ -185,6 +205,7 @@ bool ClientGazeController::close()
     portStateFp.close();
     portStateAng.close();
     portStateHead.close();
+    portStateFull.close();
     portEvents.close();
     portRpc.close();
 
@@ -287,6 +308,37 @@ bool ClientGazeController::getStabilizationMode(bool *f)
 }
 
 
+/************************************************************************/
+bool ClientGazeController::getState()
+{
+    if (!stateAvailable)
+        return false;
+
+    double now=Time::now();
+
+    // receive from network in streaming mode (non-blocking)
+    if (Vector *v=portStateFull.read(false))
+    {
+        deque<Vector> fields;
+        if (iCub::iKin::CartesianHelper::unpackState(*v,fields) &&
+            (fields.size()>=GAZECTRL_STATE_NUM) &&
+            (fields[GAZECTRL_STATE_MOTIONDONE].length()>0) &&
+            (fields[GAZECTRL_STATE_SACCADEDONE].length()>0))
+        {
+            state=fields;
+            lastStateMsgArrivalTime=now;
+
+            // the server has handled the last motion command
+            // as soon as it reports a motion in progress
+            if (state[GAZECTRL_STATE_MOTIONDONE][0]==0.0)
+                motionDoneStale=false;
+        }
+    }
+
+    return (now-lastStateMsgArrivalTime<timeout);
+}
+
+
 /************************************************************************/
 bool ClientGazeController::getFixationPoint(Vector &fp, Stamp *stamp)
 {
@@ -345,6 +397,7 @@ bool ClientGazeController::lookAtFixationPoint(const Vector &fp)
     cmd.addFloat64(fp[2]);
 
     portCmdFp.writeStrict();
+    motionDoneStale=true;
     return true;
 }
 
@@ -364,6 +417,7 @@ bool ClientGazeController::lookAtAbsAngles(const Vector &ang)
     cmd.addFloat64(ang[2]);
 
     portCmdAng.writeStrict();
+    motionDoneStale=true;
     return true;
 }
 
@@ -383,6 +437,7 @@ bool ClientGazeController::lookAtRelAngles(const Vector &ang)
     cmd.addFloat64(ang[2]);
 
     portCmdAng.writeStrict();
+    motionDoneStale=true;
     return true;
 }
 
@@ -403,6 +458,7 @@ bool ClientGazeController::lookAtMonoPixel(const int camSel, const Vector &px,
     cmd.addFloat64(z);
 
     portCmdMono.writeStrict();
+    motionDoneStale=true;
     return true;
 }
 
@@ -425,6 +481,7 @@ bool ClientGazeController::lookAtMonoPixelWithVergence(const int camSel,
     cmd.addFloat64(ver);
 
     portCmdMono.writeStrict();
+    motionDoneStale=true;
     return true;
 }
 
@@ -444,6 +501,7 @@ bool ClientGazeController::lookAtStereoPixels(const Vector &pxl, const Vector &p
     cmd.addFloat64(pxr[1]);
 
     portCmdStereo.writeStrict();
+    motionDoneStale=true;
     return true;
 }
 
@@ -462,6 +520,7 @@ bool ClientGazeController::lookAtFixationPointSync(const Vector &fp)
     payLoad.addFloat64(fp[1]);
     payLoad.addFloat64(fp[2]);
 
+    motionDoneStale=true;
     if (!portRpc.write(command,reply))
     {
         yError("unable to get reply from server!");
@@ -486,6 +545,7 @@ bool ClientGazeController::lookAtAbsAnglesSync(const Vector &ang)
     for (size_t i=0; i<ang.length(); i++)
         payLoad.addFloat64(ang[i]);
 
+    motionDoneStale=true;
     if (!portRpc.write(command,reply))
     {
         yError("unable to get reply from server!");
@@ -510,6 +570,7 @@ bool ClientGazeController::lookAtRelAnglesSync(const Vector &ang)
     for (size_t i=0; i<ang.length(); i++)
         payLoad.addFloat64(ang[i]);
 
+    motionDoneStale=true;
     if (!portRpc.write(command,reply))
     {
         yError("unable to get reply from server!");
@@ -537,6 +598,7 @@ bool ClientGazeController::lookAtMonoPixelSync(const int camSel,
     payLoad.addFloat64(px[1]);
     payLoad.addFloat64(z);
 
+    motionDoneStale=true;
     if (!portRpc.write(command,reply))
     {
         yError("unable to get reply from server!");
@@ -565,6 +627,7 @@ bool ClientGazeController::lookAtMonoPixelWithVergenceSync(const int camSel,
     payLoad.addString("ver");
     payLoad.addFloat64(ver);
 
+    motionDoneStale=true;
     if (!portRpc.write(command,reply))
     {
         yError("unable to get reply from server!");
@@ -591,6 +654,7 @@ bool ClientGazeController::lookAtStereoPixelsSync(const Vector &pxl,
     payLoad.addFloat64(pxr[0]);
     payLoad.addFloat64(pxr[1]);    
 
+    motionDoneStale=true;
     if (!portRpc.write(command,reply))
     {
         yError("unable to get reply from server!");
@@ -785,7 +849,7 @@ bool ClientGazeController::getSaccadesActivationAngle(double *angle)
 
 /************************************************************************/
 bool ClientGazeController::getPose(const string &poseSel, Vector &x, Vector &o,
-                                   Stamp *stamp)
+                                   Stamp *stamp, const double *t)
 {
     if (!connected)
         return false;
@@ -794,6 +858,8 @@ bool ClientGazeController::getPose(const string &poseSel, Vector &x, Vector &o,
     command.addString("get");
     command.addString("pose");
     command.addString(poseSel);
+    if (t!=NULL)
+        command.addFloat64(*t);
 
     if (!portRpc.write(command,reply))
     {
@@ -857,6 +923,30 @@ bool ClientGazeController::getHeadPose(Vector &x, Vector &o, Stamp *stamp)
 }
 
 
+/************************************************************************/
+bool ClientGazeController::getLeftEyePoseAt(const double t, Vector &x, Vector &o,
+                                            Stamp *stamp)
+{
+    return getPose("left",x,o,stamp,&t);
+}
+
+
+/************************************************************************/
+bool ClientGazeController::getRightEyePoseAt(const double t, Vector &x, Vector &o,
+                                             Stamp *stamp)
+{
+    return getPose("right",x,o,stamp,&t);
+}
+
+
+/************************************************************************/
+bool ClientGazeController::getHeadPoseAt(const double t, Vector &x, Vector &o,
+                                         Stamp *stamp)
+{
+    return getPose("head",x,o,stamp,&t);
+}
+
+
 /************************************************************************/
 bool ClientGazeController::get2DPixel(const int camSel, const Vector &x,
                                       Vector &px)
@@ -1090,12 +1180,146 @@ bool ClientGazeController::triangulate3DPoint(const Vector &pxl, const Vector &p
 }
 
 
+/************************************************************************/
+bool ClientGazeController::get2DPixels(const int camSel, const Matrix &x,
+                                       Matrix &px)
+{
+    if (!connected || ((x.rows()>0) && (x.cols()<3)))
+        return false;
+
+    Bottle command, reply;
+    command.addString("get");
+    command.addString("2Ds");
+    Bottle &bOpt=command.addList();
+    bOpt.addString((camSel==0)?"left":"right");
+    Bottle &bPoints=bOpt.addList();
+    for (size_t r=0; r<x.rows(); r++)
+        for (size_t c=0; c<3; c++)
+            bPoints.addFloat64(x(r,c));
+
+    if (!portRpc.write(command,reply))
+    {
+        yError("unable to get reply from server!");
+        return false;
+    }
+
+    if ((reply.get(0).asVocab32()==GAZECTRL_ACK) && (reply.size()>1))
+    {
+        Bottle *bPixels=reply.get(1).asList();
+        if ((bPixels!=NULL) && (bPixels->size()==2*x.rows()))
+        {
+            px.resize(x.rows(),2);
+            for (size_t i=0; i<bPixels->size(); i++)
+                px(i/2,i%2)=bPixels->get(i).asFloat64();
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/************************************************************************/
+bool ClientGazeController::get3DPoints(const int camSel, const Matrix &px,
+                                       const Vector &z, Matrix &x)
+{
+    if (!connected || ((px.rows()>0) && (px.cols()<2)) || (z.length()!=px.rows()))
+        return false;
+
+    Bottle command, reply;
+    command.addString("get");
+    command.addString("3Ds");
+    command.addString("mono");
+    Bottle &bOpt=command.addList();
+    bOpt.addString((camSel==0)?"left":"right");
+    Bottle &bPixels=bOpt.addList();
+    for (size_t r=0; r<px.rows(); r++)
+    {
+        bPixels.addFloat64(px(r,0));
+        bPixels.addFloat64(px(r,1));
+        bPixels.addFloat64(z[r]);
+    }
+
+    if (!portRpc.write(command,reply))
+    {
+        yError("unable to get reply from server!");
+        return false;
+    }
+
+    if ((reply.get(0).asVocab32()==GAZECTRL_ACK) && (reply.size()>1))
+    {
+        Bottle *bPoints=reply.get(1).asList();
+        if ((bPoints!=NULL) && (bPoints->size()==3*px.rows()))
+        {
+            x.resize(px.rows(),3);
+            for (size_t i=0; i<bPoints->size(); i++)
+                x(i/3,i%3)=bPoints->get(i).asFloat64();
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+/************************************************************************/
+bool ClientGazeController::triangulate3DPoints(const Matrix &pxl, const Matrix &pxr,
+                                               Matrix &x)
+{
+    if (!connected || (pxl.rows()!=pxr.rows()) ||
+        ((pxl.rows()>0) && ((pxl.cols()<2) || (pxr.cols()<2))))
+        return false;
+
+    Bottle command, reply;
+    command.addString("get");
+    command.addString("3Ds");
+    command.addString("stereo");
+    Bottle &bOpt=command.addList();
+    for (size_t r=0; r<pxl.rows(); r++)
+    {
+        bOpt.addFloat64(pxl(r,0));
+        bOpt.addFloat64(pxl(r,1));
+        bOpt.addFloat64(pxr(r,0));
+        bOpt.addFloat64(pxr(r,1));
+    }
+
+    if (!portRpc.write(command,reply))
+    {
+        yError("unable to get reply from server!");
+        return false;
+    }
+
+    if ((reply.get(0).asVocab32()==GAZECTRL_ACK) && (reply.size()>1))
+    {
+        Bottle *bPoints=reply.get(1).asList();
+        if ((bPoints!=NULL) && (bPoints->size()==3*pxl.rows()))
+        {
+            x.resize(pxl.rows(),3);
+            for (size_t i=0; i<bPoints->size(); i++)
+                x(i/3,i%3)=bPoints->get(i).asFloat64();
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
 /************************************************************************/
 bool ClientGazeController::getJointsDesired(Vector &qdes)
 {
     if (!connected)
         return false;
 
+    if (getState())
+    {
+        qdes=state[GAZECTRL_STATE_QDES];
+        return true;
+    }
+
     Bottle command, reply;
     command.addString("get");
     command.addString("des");
@@ -1128,6 +1352,12 @@ bool ClientGazeController::getJointsVelocities(Vector &qdot)
     if (!connected)
         return false;
 
+    if (getState())
+    {
+        qdot=state[GAZECTRL_STATE_QDOT];
+        return true;
+    }
+
     Bottle command, reply;
     command.addString("get");
     command.addString("vel");
@@ -1656,6 +1886,14 @@ bool ClientGazeController::checkMotionDone(bool *f)
     if (!connected || (f==NULL))
         return false;
 
+    // the cached flag is not used until the server has
+    // handled the last motion command
+    if (getState() && !motionDoneStale)
+    {
+        *f=(state[GAZECTRL_STATE_MOTIONDONE][0]!=0.0);
+        return true;
+    }
+
     Bottle command, reply;
     command.addString("get");
     command.addString("done");
@@ -1669,6 +1907,8 @@ bool ClientGazeController::checkMotionDone(bool *f)
     if (reply.get(0).asVocab32()==GAZECTRL_ACK)
     {
         *f=(reply.get(1).asInt32()>0);
+        if (!*f)
+            motionDoneStale=false;
         return true;
     }
     else
@@ -1700,6 +1940,14 @@ bool ClientGazeController::checkSaccadeDone(bool *f)
     if (!connected || (f==NULL))
         return false;
 
+    // the cached flag is not used until the server has
+    // handled the last motion command
+    if (getState() && !motionDoneStale)
+    {
+        *f=(state[GAZECTRL_STATE_SACCADEDONE][0]!=0.0);
+        return true;
+    }
+
     Bottle command, reply;
     command.addString("get");
     command.addString("sdon");
@@ -22,11 +22,14 @@
 #include <string>
 #include <set>
 #include <map>
+#include <deque>
 
 #include <yarp/os/all.h>
 #include <yarp/sig/all.h>
 #include <yarp/dev/all.h>
 
+#include <iCub/iKin/iKinHlp.h>
+
 
 // forward declaration
 class ClientGazeController;
@@ -60,7 +63,9 @@ public:
 * | `clientgazecontroller` |
 */
 class ClientGazeController : public yarp::dev::DeviceDriver,
-                             public yarp::dev::IGazeControl
+                             public yarp::dev::IGazeControl,
+                             public iCub::iKin::IGazeBatchQuery,
+                             public iCub::iKin::IGazePoseHistory
 {
 protected:
     bool connected;
@@ -69,6 +74,9 @@ protected:
     double timeout;
     double lastFpMsgArrivalTime;
     double lastAngMsgArrivalTime;
+    double lastStateMsgArrivalTime;
+    bool   stateAvailable;
+    bool   motionDoneStale;
 
     yarp::sig::Vector fixationPoint;
     yarp::sig::Vector angles;
@@ -76,9 +84,12 @@ protected:
     yarp::os::Stamp   fpStamp;
     yarp::os::Stamp   anglesStamp;
 
+    std::deque<yarp::sig::Vector> state;
+
     yarp::os::BufferedPort<yarp::sig::Vector> portStateFp;
     yarp::os::BufferedPort<yarp::sig::Vector> portStateAng;
     yarp::os::BufferedPort<yarp::sig::Vector> portStateHead;
+    yarp::os::BufferedPort<yarp::sig::Vector> portStateFull;
 
     yarp::os::BufferedPort<yarp::os::Bottle>  portCmdFp;
     yarp::os::BufferedPort<yarp::os::Bottle>  portCmdAng;
@@ -93,13 +104,15 @@ protected:
 
     void init();
     bool deleteContexts();
-    bool getPose(const std::string &poseSel, yarp::sig::Vector &x, yarp::sig::Vector &o, yarp::os::Stamp *stamp=NULL);
+    bool getPose(const std::string &poseSel, yarp::sig::Vector &x, yarp::sig::Vector &o, yarp::os::Stamp *stamp=NULL,
+                 const double *t=NULL);
     bool blockNeckJoint(const std::string &joint, const double min, const double max);
     bool blockNeckJoint(const std::string &joint, const int j);
     bool getNeckJointRange(const std::string &joint, double *min, double *max);
     bool clearJoint(const std::string &joint);
     void eventHandling(yarp::os::Bottle &event);
     bool getInfoHelper(yarp::os::Bottle &info);
+    bool getState();
 
 public:
     ClientGazeController();
@@ -136,12 +149,18 @@ public:
     bool getLeftEyePose(yarp::sig::Vector &x, yarp::sig::Vector &o, yarp::os::Stamp *stamp=NULL);
     bool getRightEyePose(yarp::sig::Vector &x, yarp::sig::Vector &o, yarp::os::Stamp *stamp=NULL);
     bool getHeadPose(yarp::sig::Vector &x, yarp::sig::Vector &o, yarp::os::Stamp *stamp=NULL);
+    bool getLeftEyePoseAt(const double t, yarp::sig::Vector &x, yarp::sig::Vector &o, yarp::os::Stamp *stamp=NULL);
+    bool getRightEyePoseAt(const double t, yarp::sig::Vector &x, yarp::sig::Vector &o, yarp::os::Stamp *stamp=NULL);
+    bool getHeadPoseAt(const double t, yarp::sig::Vector &x, yarp::sig::Vector &o, yarp::os::Stamp *stamp=NULL);
     bool get2DPixel(const int camSel, const yarp::sig::Vector &x, yarp::sig::Vector &px);
     bool get3DPoint(const int camSel, const yarp::sig::Vector &px, const double z, yarp::sig::Vector &x);    
     bool get3DPointOnPlane(const int camSel, const yarp::sig::Vector &px, const yarp::sig::Vector &plane, yarp::sig::Vector &x);
     bool get3DPointFromAngles(const int mode, const yarp::sig::Vector &ang, yarp::sig::Vector &x);
     bool getAnglesFrom3DPoint(const yarp::sig::Vector &x, yarp::sig::Vector &ang);
     bool triangulate3DPoint(const yarp::sig::Vector &pxl, const yarp::sig::Vector &pxr, yarp::sig::Vector &x);
+    bool get2DPixels(const int camSel, const yarp::sig::Matrix &x, yarp::sig::Matrix &px);
+    bool get3DPoints(const int camSel, const yarp::sig::Matrix &px, const yarp::sig::Vector &z, yarp::sig::Matrix &x);
+    bool triangulate3DPoints(const yarp::sig::Matrix &pxl, const yarp::sig::Matrix &pxr, yarp::sig::Matrix &x);
     bool getJointsDesired(yarp::sig::Vector &qdes);
     bool getJointsVelocities(yarp::sig::Vector &qdot);
     bool getStereoOptions(yarp::os::Bottle &options);
@@ -7,7 +7,9 @@
 
 #include <yarp/os/Bottle.h>
 #include <yarp/os/Value.h>
+#include <yarp/os/Time.h>
 #include <iostream>
+#include <thread>
 #include <3dm_gx3.h>
 
 
@@ -20,7 +22,7 @@ using namespace yarp::dev;
 using namespace yarp::os;
 
 
-imu3DM_GX3::imu3DM_GX3() : PeriodicThread(0.006)
+imu3DM_GX3::imu3DM_GX3() : PeriodicThread(0.006), sample_version(0), useSamplesPort(false)
 {
     /* data to be transfered are:
             1  (request Euler) +
@@ -62,6 +64,8 @@ imu3DM_GX3::imu3DM_GX3() : PeriodicThread(0.006)
 
     cmd_ptr_map[CMD_ACCEL_ANGRATE_MAG]            = &CB_cmd;
     cmd_ptr_map[CMD_EULER]                        = &CE_cmd;
+
+    memset(&sample, 0, sizeof(sample));
 };
 
 imu3DM_GX3::~imu3DM_GX3()
@@ -85,6 +89,18 @@ bool imu3DM_GX3::open(yarp::os::Searchable &config)
 
     comPortName = serial->toString();
 
+    // every complete sample can also be streamed, not only the latest one when read() is called
+    if(config.check("samplesPort"))
+    {
+        std::string portName = config.find("samplesPort").asString();
+        if(!samplesPort.open(portName))
+        {
+            printf("can't open %s\n", portName.c_str());
+            return false;
+        }
+        useSamplesPort = true;
+    }
+
     int errNum = 0;
     /* open serial */
     printf("\n\nSerial opening %s\n\n\n", comPortName.c_str());
@@ -173,6 +189,9 @@ bool imu3DM_GX3::close()
 	if(fd_ser != 0)
 		::close(fd_ser);
 	fd_ser = 0;
+	if(useSamplesPort)
+		samplesPort.close();
+	useSamplesPort = false;
     printf("Closed %s\n", comPortName.c_str());
 
     return true;
@@ -196,30 +215,15 @@ bool imu3DM_GX3::calibrate(int ch, double v)
 
 bool imu3DM_GX3::read(yarp::sig::Vector &out)
 {
-    float tmp_eul[3];
-    float tmp_acc[3];
-    float tmp_gyro[3];
-    float tmp_mag[3];
-
-    uint64_t imu_timeStamp;
-
-    get_Euler(tmp_eul, &imu_timeStamp);
-    get_Acc_Ang_Mag(tmp_acc, tmp_gyro, tmp_mag, &imu_timeStamp);
+    sample_t s;
+    get_sample(s);
 
-    int out_idx = 0;
-    for(int i=0; i<3; i++, out_idx++)
-        out[out_idx] = (double) tmp_eul[i];
+    // euler, acc, gyro, mag: all of them from the same cycle of the thread
+    for(int i=0; i<nchannels; i++)
+        out[i] = s.values[i];
 
-    for(int i=0; i<3; i++, out_idx++)
-        out[out_idx] = (double) tmp_acc[i];
-
-    for(int i=0; i<3; i++, out_idx++)
-        out[out_idx] = (double) tmp_gyro[i];
-
-    for(int i=0; i<3; i++, out_idx++)
-        out[out_idx] = (double) tmp_mag[i];
-
-    lastStamp.update();
+    // the stamp is the one of the sample, not the one of the call
+    lastStamp = Stamp(s.count, s.time);
     return true;
 }
 
@@ -241,12 +245,23 @@ bool imu3DM_GX3::threadInit()
     return true;
 }
 
+static inline void put_vect(double *dst, const _3f_vect_t &v)
+{
+    dst[0] = (double) v.x;
+    dst[1] = (double) v.y;
+    dst[2] = (double) v.z;
+}
+
 void imu3DM_GX3::run()
 {
     int nbytes;
     static data_3DM_GX3_t   th_data;
     imu_cmd_t * tmp_cmd = NULL;
 
+    // the sample is published only if all the commands got a valid answer in this cycle
+    sample_t s;
+    bool complete = true;
+
     // ask data to device in polling, cycling within the map
     cmd_map_t::iterator it = cmd_ptr_map.begin();
     while(it != cmd_ptr_map.end())
@@ -262,11 +277,13 @@ void imu3DM_GX3::run()
         {
             printf("Error while reading imu response to command XXX\n");
             // skip parsing and try with the next command
+            complete = false;
         }
         else if ( nbytes != tmp_cmd->expSize )
         {
             printf("read %d instead of %d\n", nbytes, tmp_cmd->expSize);
             // skip parsing and try with the next command
+            complete = false;
         }
         else
         {
@@ -281,11 +298,67 @@ void imu3DM_GX3::run()
             }
 
             // copy for consumer ....
-            lock_guard<mutex> lck(data_mutex);
-            memcpy((void*)&tmp_cmd->data.buffer, &th_data.buffer, tmp_cmd->expSize);
+            {
+                lock_guard<mutex> lck(data_mutex);
+                memcpy((void*)&tmp_cmd->data.buffer, &th_data.buffer, tmp_cmd->expSize);
+            }
+
+            if (tmp_cmd == &CE_cmd)
+            {
+                put_vect(&s.values[0], th_data.eu.eul);
+            }
+            else if (tmp_cmd == &CB_cmd)
+            {
+                put_vect(&s.values[3], th_data.aam.acc);
+                put_vect(&s.values[6], th_data.aam.angRate);
+                put_vect(&s.values[9], th_data.aam.mag);
+                s.timer = th_data.aam.timer;
+            }
         }
         it++;
     }
+
+    if (!complete)
+        return;
+
+    s.time = Time::now();
+    s.count = sample.count + 1;
+    put_sample(s);
+
+    if (useSamplesPort)
+    {
+        Bottle &b = samplesPort.prepare();
+        b.clear();
+        for(int i=0; i<nchannels; i++)
+            b.addFloat64(s.values[i]);
+        b.addInt64((int64_t) s.timer);
+        samplesPort.setEnvelope(Stamp(s.count, s.time));
+        samplesPort.write();
+    }
+}
+
+// run() is the only writer: an odd version means that it is changing the sample
+void imu3DM_GX3::put_sample(const sample_t &s)
+{
+    unsigned int v = sample_version.load(std::memory_order_relaxed);
+    sample_version.store(v + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy((void*)&sample, &s, sizeof(sample_t));
+    sample_version.store(v + 2, std::memory_order_release);
+}
+
+void imu3DM_GX3::get_sample(sample_t &s)
+{
+    unsigned int v1, v2;
+    do
+    {
+        v1 = sample_version.load(std::memory_order_acquire);
+        memcpy((void*)&s, (const void*)&sample, sizeof(sample_t));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        v2 = sample_version.load(std::memory_order_relaxed);
+        if ((v1 & 1) || (v1 != v2))
+            std::this_thread::yield();
+    } while ((v1 & 1) || (v1 != v2));
 }
 
 void imu3DM_GX3::threadRelease()
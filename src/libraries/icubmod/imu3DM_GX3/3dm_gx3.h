@@ -24,6 +24,9 @@
 #include <yarp/os/Stamp.h>
 #include <yarp/dev/IPreciselyTimed.h>
 #include <yarp/os/PeriodicThread.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Bottle.h>
+#include <atomic>
 #include <mutex>
 #include <string.h>
 #include <dataTypes.h>
@@ -73,6 +76,24 @@ private:
 
     std::mutex          data_mutex;
 
+    // a complete sample: the euler angles (CE) and the acceleration, angular rate and magnetic field (CB) received
+    // in the same cycle of run(). It is written by run() and copied by the readers without locks (seqlock): a reader
+    // copies it again if run() has changed it in the meantime, thus it never sees a mix of two cycles.
+    struct sample_t
+    {
+        double      values[12];
+        double      time;           // when the last packet of the sample has been received
+        uint32_t    timer;          // the timer of the device, as found in the CB packet
+        int         count;
+    };
+
+    std::atomic<unsigned int>   sample_version;
+    sample_t                    sample;
+
+    // optional: every sample is also written here, with its time in the envelope
+    yarp::os::BufferedPort<yarp::os::Bottle>    samplesPort;
+    bool                                        useSamplesPort;
+
     std::string         comPortName;
     data_3DM_GX3_t      rawData;
     yarp::os::Stamp     lastStamp;
@@ -102,6 +123,8 @@ private:
 private:      // Device specific
 
     void stop_continuous(void);
+    void put_sample(const sample_t &s);
+    void get_sample(sample_t &s);
     // command 0xC2
     void get_Acc_Ang(float acc[3], float angRate[3], uint64_t *time);
     // command 0xC8
@@ -19,8 +19,14 @@
 #include <yarp/os/LogStream.h>
 #include <cstring>
 #include <cmath>
+#include <algorithm>
 
 #include <yarp/os/Time.h>
+#include <iCub/ctrl/math.h>
+
+#ifdef ICUB_IMUFILTER_BULK
+#include "EoAnalogSensors.h"
+#endif
 
 
 using namespace std;
@@ -43,7 +49,6 @@ void ImuFilter::run() {
 
     bool ok{true};
     double ts{0.0};
-    Vector gyroFiltered, magn;
 
     if (! PassThroughInertial::proxyIGyro ||
         ! PassThroughInertial::proxyIMagn) {
@@ -51,41 +56,77 @@ void ImuFilter::run() {
         this->askToStop();
         return;
     }
-    ok &= PassThroughInertial::proxyIGyro->getThreeAxisGyroscopeStatus(0) == MAS_OK;
-    ok &= PassThroughInertial::proxyIGyro->getThreeAxisGyroscopeMeasure(0, gyro, gyroTs);
 
-    if (!ok){
-        yError()<<"imuFilter: unable to get gyro";
-        return;
+    double t0=Time::now();
+    bool fresh{false};
+
+#ifdef ICUB_IMUFILTER_BULK
+    if (iBulk) {
+        // all the samples of the first imu received since the previous cycle, in order of arrival
+        uint64_t lost{0};
+        if (!iBulk->getNewSensorSamples(samples, lost)) {
+            yError()<<"imuFilter: unable to get the imu samples";
+            return;
+        }
+        if (lost>0) {
+            yWarning()<<"imuFilter:"<<lost<<"imu samples lost";
+        }
+
+        for (const auto &sample : samples) {
+            if (sample.sensor != 0 || sample.size < 3) {
+                continue;
+            }
+
+            if (sample.type == eoas_imu_mag) {
+                magn[0]=sample.values[0]; magn[1]=sample.values[1]; magn[2]=sample.values[2];
+                magTs=sample.timestamp;
+            }
+            else if (sample.type == eoas_imu_acc) {
+                acc[0]=sample.values[0]; acc[1]=sample.values[1]; acc[2]=sample.values[2];
+            }
+            else if (sample.type == eoas_imu_gyr && magTs > 0.0) {
+                gyroSample[0]=sample.values[0]; gyroSample[1]=sample.values[1]; gyroSample[2]=sample.values[2];
+                processGyro(gyroSample, sample.timestamp);
+                fresh=true;
+            }
+        }
     }
+    else
+#endif
+    {
+        ok &= PassThroughInertial::proxyIGyro->getThreeAxisGyroscopeStatus(0) == MAS_OK;
+        ok &= PassThroughInertial::proxyIGyro->getThreeAxisGyroscopeMeasure(0, gyroSample, ts);
 
-    if (std::fabs(gyroTs - prevTs) < 1e-6 ){
-        return;
-    }
+        if (!ok){
+            yError()<<"imuFilter: unable to get gyro";
+            return;
+        }
 
-    ok &= PassThroughInertial::proxyIMagn->getThreeAxisMagnetometerStatus(0) == MAS_OK;
-    ok &= PassThroughInertial::proxyIMagn->getThreeAxisMagnetometerMeasure(0, magn, ts);
+        if (std::fabs(ts - prevTs) < 1e-6 ){
+            return;
+        }
 
-    if (!ok){
-        yError()<<"imuFilter: unable to get magnetometer measures";
-        return;
-    }
+        ok &= PassThroughInertial::proxyIMagn->getThreeAxisMagnetometerStatus(0) == MAS_OK;
+        ok &= PassThroughInertial::proxyIMagn->getThreeAxisMagnetometerMeasure(0, magn, magTs);
 
-    stampBias.update(ts);
-    double t0=Time::now();
+        if (!ok){
+            yError()<<"imuFilter: unable to get magnetometer measures";
+            return;
+        }
 
-    m_mutex.lock();
-    gyroFiltered = gyroFilt.filt(gyro);
+        if (madgwick && PassThroughInertial::proxyIAccel) {
+            double accTs{0.0};
+            PassThroughInertial::proxyIAccel->getThreeAxisLinearAccelerometerMeasure(0, acc, accTs);
+        }
 
-    gyro -= gyroBias;
-    gyroFiltered -= gyroBias;
-    m_mutex.unlock();
+        processGyro(gyroSample, ts);
+        fresh=true;
+    }
 
-    Vector mag_filt=magFilt.filt(magn);
-    double magVel=yarp::math::norm(velEst.estimate(iCub::ctrl::AWPolyElement(mag_filt,stampBias.getTime())));
+    if (!fresh) {
+        return;
+    }
 
-    adaptGyroBias=adaptGyroBias?(magVel<mag_vel_thres_up):(magVel<mag_vel_thres_down);
-    gyroBias=biasInt.integrate(adaptGyroBias?gyroFiltered:Vector(3,0.0));
     double dt=Time::now()-t0;
 
     if (bPort.getOutputCount()>0)
@@ -103,8 +144,98 @@ void ImuFilter::run() {
         yInfo("imuFilter: dt       = %.0f [us]",dt*1e6);
         yInfo("\n");
     }
-    prevTs = gyroTs;
 }
+
+void ImuFilter::processGyro(const Vector &g, double ts) {
+
+    stampBias.update(magTs);
+
+    m_mutex.lock();
+    Vector gyroFiltered = gyroFilt.filt(g);
+
+    gyro = g;
+    gyroTs = ts;
+    gyro -= gyroBias;
+    gyroFiltered -= gyroBias;
+
+    if (madgwick) {
+        updateOrientation(gyro, ts-prevTs);
+        orientTs = ts;
+    }
+    m_mutex.unlock();
+
+    Vector mag_filt=magFilt.filt(magn);
+    magVel=yarp::math::norm(velEst.estimate(iCub::ctrl::AWPolyElement(mag_filt,stampBias.getTime())));
+
+    adaptGyroBias=adaptGyroBias?(magVel<mag_vel_thres_up):(magVel<mag_vel_thres_down);
+    gyroBias=biasInt.integrate(adaptGyroBias?gyroFiltered:Vector(3,0.0));
+
+    prevTs = ts;
+}
+
+void ImuFilter::updateOrientation(const Vector &g, double dt) {
+
+    // no temporaries: it runs on every gyro sample
+    double ax=acc[0], ay=acc[1], az=acc[2];
+    double an=std::sqrt(ax*ax+ay*ay+az*az);
+
+    if (!qValid) {
+        if (an <= 0.0) {
+            return;
+        }
+        // start from the tilt given by the gravity, with no yaw
+        double roll=std::atan2(ay,az);
+        double pitch=std::atan2(-ax,std::sqrt(ay*ay+az*az));
+        double cr=std::cos(0.5*roll), sr=std::sin(0.5*roll);
+        double cp=std::cos(0.5*pitch), sp=std::sin(0.5*pitch);
+        q[0]=cr*cp; q[1]=sr*cp; q[2]=cr*sp; q[3]=-sr*sp;
+        qValid=true;
+        return;
+    }
+
+    // too long since the previous sample to integrate it
+    if (dt <= 0.0 || dt > 0.5) {
+        return;
+    }
+
+    const double deg2rad=iCub::ctrl::CTRL_DEG2RAD;
+    double gx=g[0]*deg2rad, gy=g[1]*deg2rad, gz=g[2]*deg2rad;
+    double q0=q[0], q1=q[1], q2=q[2], q3=q[3];
+
+    // rate of change of the quaternion from the gyro
+    double qDot0=0.5*(-q1*gx-q2*gy-q3*gz);
+    double qDot1=0.5*( q0*gx+q2*gz-q3*gy);
+    double qDot2=0.5*( q0*gy-q1*gz+q3*gx);
+    double qDot3=0.5*( q0*gz+q1*gy-q2*gx);
+
+    // gradient descent step toward the gravity measured by the accelerometer
+    if (an > 0.0) {
+        ax/=an; ay/=an; az/=an;
+
+        double _2q0=2.0*q0, _2q1=2.0*q1, _2q2=2.0*q2, _2q3=2.0*q3;
+        double _4q0=4.0*q0, _4q1=4.0*q1, _4q2=4.0*q2;
+        double _8q1=8.0*q1, _8q2=8.0*q2;
+        double q0q0=q0*q0, q1q1=q1*q1, q2q2=q2*q2, q3q3=q3*q3;
+
+        double s0=_4q0*q2q2+_2q2*ax+_4q0*q1q1-_2q1*ay;
+        double s1=_4q1*q3q3-_2q3*ax+4.0*q0q0*q1-_2q0*ay-_4q1+_8q1*q1q1+_8q1*q2q2+_4q1*az;
+        double s2=4.0*q0q0*q2+_2q0*ax+_4q2*q3q3-_2q3*ay-_4q2+_8q2*q1q1+_8q2*q2q2+_4q2*az;
+        double s3=4.0*q1q1*q3-_2q1*ax+4.0*q2q2*q3-_2q2*ay;
+        double sn=std::sqrt(s0*s0+s1*s1+s2*s2+s3*s3);
+
+        if (sn > 0.0) {
+            qDot0-=beta*s0/sn;
+            qDot1-=beta*s1/sn;
+            qDot2-=beta*s2/sn;
+            qDot3-=beta*s3/sn;
+        }
+    }
+
+    q0+=qDot0*dt; q1+=qDot1*dt; q2+=qDot2*dt; q3+=qDot3*dt;
+    double qn=std::sqrt(q0*q0+q1*q1+q2*q2+q3*q3);
+    q[0]=q0/qn; q[1]=q1/qn; q[2]=q2/qn; q[3]=q3/qn;
+}
+
 void ImuFilter::threadRelease() {}
 
 //DEVICE DRIVER 
@@ -129,11 +260,16 @@ bool ImuFilter::open(yarp::os::Searchable& config)
     mag_vel_thres_down=config.check("mag-vel-thres-down",Value(0.02)).asFloat64();
     bias_gain=config.check("bias-gain",Value(0.001)).asFloat64();
     verbose=config.check("verbose");
+    madgwick=(config.check("orientation",Value("proxy")).asString()=="madgwick");
+    beta=config.check("madgwick-beta",Value(0.1)).asFloat64();
 
     gyroFilt.setOrder(gyro_order);
     magFilt.setOrder(mag_order);
     biasInt.setTs(bias_gain);
     gyroBias.resize(3,0.0);
+    gyroSample.resize(3,0.0);
+    magn.resize(3,0.0);
+    acc.resize(3,0.0);
     adaptGyroBias=false;
 
     m_period_ms=config.check("period",Value(20)).asInt32();
@@ -162,6 +298,16 @@ bool ImuFilter::close()
 bool ImuFilter::attachAll(const yarp::dev::PolyDriverList &p) {
 
     if(PassThroughInertial::attachAll(p)) {
+#ifdef ICUB_IMUFILTER_BULK
+        // the bulk interface is there only when attached straight to an embObjIMU
+        iBulk=dynamic_cast<eth::IbulkSensors*>(p[0]->poly->getImplementation());
+        if (iBulk) {
+            // start from the samples to come
+            uint64_t lost{0};
+            iBulk->getNewSensorSamples(samples, lost);
+            yInfo()<<"imuFilter: consuming all the imu samples through the bulk interface";
+        }
+#endif
         return this->start();
     }
     else{
@@ -171,6 +317,9 @@ bool ImuFilter::attachAll(const yarp::dev::PolyDriverList &p) {
 }
 bool ImuFilter::detachAll() {
     this->PeriodicThread::stop();
+#ifdef ICUB_IMUFILTER_BULK
+    iBulk=nullptr;
+#endif
     return PassThroughInertial::detachAll();
 }
 
@@ -189,5 +338,28 @@ bool ImuFilter::getThreeAxisGyroscopeMeasure(size_t sens_index, yarp::sig::Vecto
     return true;
 }
 
+bool ImuFilter::getOrientationSensorMeasureAsRollPitchYaw(size_t sens_index, yarp::sig::Vector& rpy, double& timestamp) const
+{
+    if (!madgwick)
+    {
+        return PassThroughInertial::getOrientationSensorMeasureAsRollPitchYaw(sens_index, rpy, timestamp);
+    }
+
+    if (sens_index != 0)
+    {
+        yError() << "imuFilter: sens_index must be equal to 0 as there exists only one sensor";
+        return false;
+    }
+
+    const double rad2deg=iCub::ctrl::CTRL_RAD2DEG;
+    std::lock_guard<std::mutex> lck(m_mutex);
+    rpy.resize(3);
+    rpy[0]=rad2deg*std::atan2(2.0*(q[0]*q[1]+q[2]*q[3]),1.0-2.0*(q[1]*q[1]+q[2]*q[2]));
+    rpy[1]=rad2deg*std::asin(std::max(-1.0,std::min(1.0,2.0*(q[0]*q[2]-q[3]*q[1]))));
+    rpy[2]=rad2deg*std::atan2(2.0*(q[0]*q[3]+q[1]*q[2]),1.0-2.0*(q[2]*q[2]+q[3]*q[3]));
+    timestamp = orientTs;
+    return qValid;
+}
+
 } // namespace dev
 } // namespace yarp
@@ -27,6 +27,10 @@
 
 #include "PassThroughInertial.h"
 
+#ifdef ICUB_IMUFILTER_BULK
+#include "sensorsBuffer.h"
+#endif
+
 #include <yarp/math/Math.h>
 
 #include <iCub/ctrl/adaptWinPolyEstimator.h>
@@ -73,12 +77,24 @@ or through a MultipleAnalogSensorClient(using the subdevice mechanism).
 
 --bias-gain(0.001)           // Gain to integrate gyro bias.
 
+--orientation("proxy")       // "proxy" gives the orientation of the attached imu, "madgwick" the one estimated
+                             // here out of the gyro (without bias) and the accelerometer.
+
+--madgwick-beta(0.1)         // Gain of the accelerometer correction of the madgwick filter.
+
 --verbose(false)             // If specified enable verbosity.
 
 --proxy-remote               // Required only if run with multipleanalgosensorsclient as subdevice, port prefix of the multipleanalogsensorsserver publishing the imu.
 
 --proxy-local                // Required only if run with multipleanalgosensorsclient as subdevice, port prefix of the multipleanalogsensorsclinet to be created.
 
+\subsection samples_sec samples
+
+When attached directly to an embObjIMU, the filter consumes every sample received since its
+previous cycle through the bulk interface of the device, rather than only the latest one;
+otherwise it polls the latest sample at each period. In both cases the estimates carry the
+timestamp of the gyro sample they refer to, not the time they were computed at.
+
 \subsection deployment how to run the imuFilter
 
 The `imuFilter` can be instantiated using the yarprobotinterface with the following xml files:
@@ -169,6 +185,7 @@ class yarp::dev::ImuFilter :  public yarp::os::PeriodicThread,
     yarp::dev::IThreeAxisGyroscopes *iGyro{nullptr};
 
     yarp::sig::Vector gyroBias, gyro;
+    yarp::sig::Vector gyroSample, magn, acc;
     double mag_vel_thres_up{0.0};
     double mag_vel_thres_down{0.0};
     double bias_gain{0.0};
@@ -179,6 +196,23 @@ class yarp::dev::ImuFilter :  public yarp::os::PeriodicThread,
     mutable std::mutex m_mutex;
     yarp::os::Stamp stampBias;
     double prevTs{0.0};
+    double magTs{0.0};
+    double magVel{0.0};
+
+    // orientation estimate (w,x,y,z) and the timestamp of its gyro sample
+    bool madgwick{false};
+    double beta{0.1};
+    double q[4]{1.0, 0.0, 0.0, 0.0};
+    bool qValid{false};
+    double orientTs{0.0};
+
+#ifdef ICUB_IMUFILTER_BULK
+    eth::IbulkSensors *iBulk{nullptr};
+    std::vector<eth::SensorSample> samples;
+#endif
+
+    void processGyro(const yarp::sig::Vector &g, double ts);
+    void updateOrientation(const yarp::sig::Vector &g, double dt);
 
 public:
     ImuFilter();
@@ -199,6 +233,7 @@ public:
 
 
     bool getThreeAxisGyroscopeMeasure(size_t sens_index, yarp::sig::Vector& out, double& timestamp) const override;
+    bool getOrientationSensorMeasureAsRollPitchYaw(size_t sens_index, yarp::sig::Vector& rpy, double& timestamp) const override;
 
 };
 
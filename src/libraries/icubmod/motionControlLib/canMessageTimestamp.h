@@ -0,0 +1,53 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 The RobotCub Consortium
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+
+#ifndef __CANMESSAGETIMESTAMP__
+#define __CANMESSAGETIMESTAMP__
+
+#include "yarp/dev/CanBusInterface.h"
+#include "yarp/os/Time.h"
+
+/**
+ * Implemented by the CanMessage of the drivers which know when a message was
+ * received (e.g. the kernel timestamp of socketcan). The timestamp is in seconds
+ * on the system clock, 0 if it is not available.
+ */
+class ICanMessageTimestamp
+{
+public:
+    virtual ~ICanMessageTimestamp() {}
+    virtual double getTimestamp() const = 0;
+};
+
+/**
+ * Return the time of reception of a message, or fallback if the driver does
+ * not provide it. The timestamp of the driver is used only if yarp runs on
+ * the system clock, otherwise it could not be compared with yarp::os::Time::now().
+ */
+inline double getRxTimestamp(const yarp::dev::CanMessage &m, double fallback)
+{
+    const ICanMessageTimestamp *t=dynamic_cast<const ICanMessageTimestamp *>(&m);
+    if ((t==0) || !yarp::os::Time::isSystemClock())
+        return fallback;
+
+    double stamp=t->getTimestamp();
+    return (stamp>0) ? stamp : fallback;
+}
+
+#endif
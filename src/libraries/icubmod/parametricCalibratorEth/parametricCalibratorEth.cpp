@@ -12,8 +12,13 @@
 #include <yarp/dev/PolyDriver.h>
 
 #include "parametricCalibratorEth.h"
+#include <iCub/StartupTrace.h>
 #include <math.h>
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
 
 #include <yarp/os/LogStream.h>
 
@@ -23,6 +28,61 @@ using namespace yarp::dev;
 const int       PARK_TIMEOUT            = 30;
 const double    GO_TO_ZERO_TIMEOUT      = 10;
 const int       CALIBRATE_JOINT_TIMEOUT = 20;
+const double    CHECK_PERIOD            = 0.1;     // period of the checks of the calibration and of the motion done
+const double    CALIBRATION_LEVEL_TIMEOUT = 300;   // default wait for the calibrators of the lower levels [s]
+
+// The calibrators of the parts of the robot can be started together (e.g. by actions of yarprobotinterface with the
+// same phase and level), each one in its own thread. Those with a calibrationLevel in GENERAL wait for all the ones
+// of a lower level to end their calibration before moving any joint, while those of the same level calibrate at the
+// same time: e.g. the torso at level 0, the head and the arms at level 1.
+class CalibrationLevels
+{
+public:
+    void add(int level)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        pending[level]++;
+    }
+
+    void remove(int level)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (--pending[level] <= 0)
+        {
+            pending.erase(level);
+        }
+        cond.notify_all();
+    }
+
+    // returns false if aborted or if the lower levels have not ended within timeout [s]; in the latter case missing
+    // is the lowest level still pending, otherwise -1
+    bool waitLowerLevels(int level, const std::atomic<bool> &abort, double timeout, int &missing)
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        missing = -1;
+        bool ready = cond.wait_for(lock, std::chrono::duration<double>(timeout),
+                                   [&]() { return abort || pending.empty() || pending.begin()->first >= level; });
+        if (!ready)
+        {
+            missing = pending.begin()->first;
+            return false;
+        }
+        return !abort;
+    }
+
+    void wakeUp()
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        cond.notify_all();
+    }
+
+private:
+    std::mutex               mtx;
+    std::condition_variable  cond;
+    std::map<int, int>       pending;   // level -> number of calibrators of the level which have not ended yet
+};
+
+static CalibrationLevels calibrationLevels;
 
 //#warning "Use extractGroup to verify size of parameters matches with number of joints, this will avoid crashes"
 static bool extractGroup(Bottle &input, Bottle &out, const std::string &key1, const std::string &txt, int size)
@@ -138,6 +198,9 @@ parametricCalibratorEth::parametricCalibratorEth() :
     startupPosThreshold(0),
     abortCalib(false),
     isCalibrated(false),
+    calibrationLevel(-1),
+    calibrationLevelTimeout(CALIBRATION_LEVEL_TIMEOUT),
+    levelPending(false),
     skipCalibration(false),
     clearHwFault(false),
     n_joints(0),
@@ -207,6 +270,30 @@ bool parametricCalibratorEth::open(yarp::os::Searchable& config)
         }
     }
 
+    // Check calibrationLevel, to be ordered with the calibrators of the other parts
+    Value val_calibLevel = config.findGroup("GENERAL").find("calibrationLevel");
+    if(!val_calibLevel.isNull())
+    {
+        if(!val_calibLevel.isInt32() || val_calibLevel.asInt32() < 0)
+        {
+            yError() << deviceName.c_str() << ": calibrationLevel param must be a non negative integer";
+            return false;
+        }
+        calibrationLevel = val_calibLevel.asInt32();
+    }
+
+    // Check calibrationLevelTimeout, the maximum wait for the calibrators of the lower levels
+    Value val_calibLevelTimeout = config.findGroup("GENERAL").find("calibrationLevelTimeout");
+    if(!val_calibLevelTimeout.isNull())
+    {
+        if(!val_calibLevelTimeout.isNumeric() || val_calibLevelTimeout.asFloat64() <= 0)
+        {
+            yError() << deviceName.c_str() << ": calibrationLevelTimeout param must be a positive number of seconds";
+            return false;
+        }
+        calibrationLevelTimeout = val_calibLevelTimeout.asFloat64();
+    }
+
     // Check useRawEncoderData, it robot is using raw data, force to skip the calibration because it will be dangerous!
     Value use_raw = config.findGroup("GENERAL").find("useRawEncoderData");
     bool useRawEncoderData;
@@ -420,12 +507,21 @@ bool parametricCalibratorEth::open(yarp::os::Searchable& config)
         }
         joints.push_back(tmp);
     }
+
+    if (calibrationLevel >= 0)
+    {
+        calibrationLevels.add(calibrationLevel);
+        levelPending = true;
+        yDebug() << deviceName << ": calibration level" << calibrationLevel;
+    }
     return true;
 }
 
 bool parametricCalibratorEth::close ()
 {
     yTrace();
+    releaseCalibrationLevel();
+
     if (calibParams != NULL) {
         delete[] calibParams;
         calibParams = NULL;
@@ -485,6 +581,7 @@ bool parametricCalibratorEth::calibrate(DeviceDriver *device)
     if (device==0)
     {
         yError() << deviceName << ": invalid device driver";
+        releaseCalibrationLevel();
         return false;
     }
 
@@ -516,13 +613,50 @@ bool parametricCalibratorEth::calibrate(DeviceDriver *device)
 
     if (!(iCalibrate && iEncoders && iPosition && iPids && iControlMode)) {
         yError() << deviceName << ": interface not found" << iCalibrate << iPosition << iPids << iControlMode;
+        releaseCalibrationLevel();
         return false;
     }
 
     return calibrate();
 }
 
+void parametricCalibratorEth::releaseCalibrationLevel()
+{
+    if (levelPending)
+    {
+        levelPending = false;
+        calibrationLevels.remove(calibrationLevel);
+    }
+}
+
 bool parametricCalibratorEth::calibrate()
+{
+    iCub::dev::TraceSpan span("calibration", "parametricCalibratorEth::calibrate " + deviceName);
+
+    if (levelPending)
+    {
+        iCub::dev::TraceSpan waitspan("calibration", "waiting for the lower levels " + deviceName);
+        yDebug() << deviceName << ": waiting for the calibrators of a level lower than" << calibrationLevel;
+        int missing = -1;
+        if (!calibrationLevels.waitLowerLevels(calibrationLevel, abortCalib, calibrationLevelTimeout, missing))
+        {
+            if (missing >= 0)
+                yError() << deviceName << ": the calibrators of level" << missing << "have not ended within"
+                         << calibrationLevelTimeout << "s, calibration failed";
+            else
+                yError() << deviceName << ": calibration has been aborted while waiting for the lower levels";
+            releaseCalibrationLevel();
+            return false;
+        }
+    }
+
+    // the calibrators of the higher levels can go on as soon as this one has ended, also if it fails
+    bool ret = calibrateSets();
+    releaseCalibrationLevel();
+    return ret;
+}
+
+bool parametricCalibratorEth::calibrateSets()
 {
     int  setOfJoint_idx = 0;
     totJointsToCalibrate = 0;
@@ -597,6 +731,7 @@ bool parametricCalibratorEth::calibrate()
     {
         
         setOfJoint_idx++;
+        iCub::dev::TraceSpan setspan("calibration", deviceName + " set " + std::to_string(setOfJoint_idx));
         currentSetList.clear();
         currentSetList = (*Bit);
         
@@ -737,14 +872,9 @@ bool parametricCalibratorEth::calibrate()
             Bit++;
             continue;
         }
-        Time::delay(1.0);     // needed?
 
-        //7) check joints are in position
-        bool goneToZero = true;
-        for(lit  = currentSetList.begin(); lit != currentSetList.end() && !abortCalib; lit++) //for each joint of set
-        {
-            goneToZero &= checkGoneToZeroThreshold(*lit);
-        }
+        //7) check joints are in position (the motion done is checked together with the distance from the target, no need to wait before)
+        bool goneToZero = checkGoneToZeroThreshold(currentSetList);
 
         if(abortCalib)
         {
@@ -800,40 +930,43 @@ bool parametricCalibratorEth::calibrateJoint(int j)
 
 bool parametricCalibratorEth::checkCalibrateJointEnded(std::list<int> set)
 {
+    // the joints of the set calibrate at the same time: they are all checked at each round, each one against its own
+    // timeout, until they are all done
     bool calibration_ok = true;
-    int timeout = 0;
-
-    std::list<int>::iterator lit;
-    std::list<int>::iterator lend;
+    double start_time = yarp::os::Time::now();
 
-    lit = set.begin();
-    lend = set.end();
-    
-    while (lit != lend)
+    while (!set.empty())
     {
         if (abortCalib)
         {
             yWarning() << deviceName << ": calibration aborted\n";
+            return false;
         }
 
-        if (iCalibrate->calibrationDone(*lit))
-        {
-            yDebug() << deviceName << ": calib joint " << (*lit) << "ended";
-            lit++;
-            timeout = 0;
-        }
-        else
+        double elapsed = yarp::os::Time::now() - start_time;
+        std::list<int>::iterator lit = set.begin();
+        while (lit != set.end())
         {
-            if (timeout > timeout_calibration[*lit])
+            if (iCalibrate->calibrationDone(*lit))
+            {
+                yDebug() << deviceName << ": calib joint " << (*lit) << "ended";
+                lit = set.erase(lit);
+            }
+            else if (elapsed > timeout_calibration[*lit])
             {
                 yError() << deviceName << ": Timeout while calibrating " << (*lit);
                 calibration_ok = false;
+                lit = set.erase(lit);
+            }
+            else
+            {
                 lit++;
-                timeout = 0;
             }
-            
-            yarp::os::Time::delay(1.0);
-            timeout++;
+        }
+
+        if (!set.empty())
+        {
+            yarp::os::Time::delay(CHECK_PERIOD);
         }
     }
 
@@ -907,69 +1040,99 @@ bool parametricCalibratorEth::goToStartupPosition(int j)
     return ret;
 }
 
-bool parametricCalibratorEth::checkGoneToZeroThreshold(int j)
+bool parametricCalibratorEth::checkGoneToZeroThreshold(std::list<int> set)
 {
-    if(std::find(calibJoints.begin(), calibJoints.end(), j) == calibJoints.end())
-    {
-        yError("%s cannot perform 'check gone to zero' operation because joint number %d is out of range [%s].", deviceName.c_str(), j, calibJointsString.toString().c_str());
-        return false;
-    }
+    bool finished = true;
 
-    if (disableStartupPosCheck[j])
+    std::list<int>::iterator lit = set.begin();
+    while (lit != set.end())
     {
-        yWarning() << deviceName << ": checkGoneToZeroThreshold, joint " << j << " is disabled on user request";
-        return true;
+        int j = *lit;
+        if(std::find(calibJoints.begin(), calibJoints.end(), j) == calibJoints.end())
+        {
+            yError("%s cannot perform 'check gone to zero' operation because joint number %d is out of range [%s].", deviceName.c_str(), j, calibJointsString.toString().c_str());
+            finished = false;
+            lit = set.erase(lit);
+        }
+        else if (disableStartupPosCheck[j])
+        {
+            yWarning() << deviceName << ": checkGoneToZeroThreshold, joint " << j << " is disabled on user request";
+            lit = set.erase(lit);
+        }
+        else
+        {
+            lit++;
+        }
     }
+    if (set.empty()) return finished;
     if (skipCalibration) return false;
 
-    // wait.
-    bool finished = false;
-//    double ang[4];
+    // wait, for all the joints of the set at the same time
     double angj = 0;
     double output = 0;
     double delta=0;
     int mode=0;
     bool done = false;
+    int round = 0;
 
     double start_time = yarp::os::Time::now();
-    while ( (!finished) && (!abortCalib))
+    while (!set.empty())
     {
-        iEncoders->getEncoder(j, &angj);
-        iPosition->checkMotionDone(j, &done);
-        iControlMode->getControlMode(j, &mode);
-        iPids->getPidOutput(VOCAB_PIDTYPE_POSITION,j, &output);
-        
-        delta = fabs(angj-legacyStartupPosition.positions[j]);
-        yDebug("%s: checkGoneToZeroThreshold: joint: %d curr: %.3f des: %.3f -> delta: %.3f threshold: %.3f output: %.3f mode: %s" , \
-               deviceName.c_str(), j, angj, legacyStartupPosition.positions[j], delta, startupPosThreshold[j], output, yarp::os::Vocab32::decode(mode).c_str());
-
-        if (delta < startupPosThreshold[j] && done)
-        {
-            yDebug("%s: checkGoneToZeroThreshold: joint: %d completed with delta: %.3f over: %.3f" ,deviceName.c_str(),j,delta, startupPosThreshold[j]);
-            finished=true;
-            break;
-        }
-        if (yarp::os::Time::now() - start_time > timeout_goToZero[j])
-        {
-            yError() <<  deviceName << ": checkGoneToZeroThreshold: joint " << j << " Timeout while going to zero!";
-            break;
-        }
-        if (mode == VOCAB_CM_IDLE)
+        if (abortCalib)
         {
-            yError() <<  deviceName << ": checkGoneToZeroThreshold: joint " << j << " is idle, skipping!";
-            break;
+            yWarning() << deviceName <<": checkGoneToZeroThreshold: Aborting wait while going to zero!\n";
+            return false;
         }
-        if (mode == VOCAB_CM_HW_FAULT)
+
+        lit = set.begin();
+        while (lit != set.end())
         {
-            yError() << deviceName <<": checkGoneToZeroThreshold: hardware fault on joint " << j << ", skipping!";
-            break;
+            int j = *lit;
+            iEncoders->getEncoder(j, &angj);
+            iPosition->checkMotionDone(j, &done);
+            iControlMode->getControlMode(j, &mode);
+            iPids->getPidOutput(VOCAB_PIDTYPE_POSITION,j, &output);
+
+            delta = fabs(angj-legacyStartupPosition.positions[j]);
+            if (round % 5 == 0)
+            {
+                yDebug("%s: checkGoneToZeroThreshold: joint: %d curr: %.3f des: %.3f -> delta: %.3f threshold: %.3f output: %.3f mode: %s" , \
+                       deviceName.c_str(), j, angj, legacyStartupPosition.positions[j], delta, startupPosThreshold[j], output, yarp::os::Vocab32::decode(mode).c_str());
+            }
+
+            if (delta < startupPosThreshold[j] && done)
+            {
+                yDebug("%s: checkGoneToZeroThreshold: joint: %d completed with delta: %.3f over: %.3f" ,deviceName.c_str(),j,delta, startupPosThreshold[j]);
+                lit = set.erase(lit);
+                continue;
+            }
+
+            if (yarp::os::Time::now() - start_time > timeout_goToZero[j])
+            {
+                yError() <<  deviceName << ": checkGoneToZeroThreshold: joint " << j << " Timeout while going to zero!";
+            }
+            else if (mode == VOCAB_CM_IDLE)
+            {
+                yError() <<  deviceName << ": checkGoneToZeroThreshold: joint " << j << " is idle, skipping!";
+            }
+            else if (mode == VOCAB_CM_HW_FAULT)
+            {
+                yError() << deviceName <<": checkGoneToZeroThreshold: hardware fault on joint " << j << ", skipping!";
+            }
+            else
+            {
+                lit++;
+                continue;
+            }
+            finished = false;
+            lit = set.erase(lit);
         }
-        if (abortCalib)
+
+        if (!set.empty())
         {
-            yWarning() << deviceName <<": checkGoneToZeroThreshold: joint " << j << " Aborting wait while going to zero!\n";
-            break;
+            Time::delay(CHECK_PERIOD);
+            round++;
         }
-        Time::delay(0.5);
     }
     return finished;
 }
@@ -1123,15 +1286,14 @@ bool parametricCalibratorEth::moveAndCheck(PositionSequence &data)
     iPosition->setRefSpeeds(data.velocities.data());
     iPosition->positionMove(data.positions.data());
 
-    bool done    = false;
-    int  timeout = 0;
+    bool   done       = false;
+    double start_time = Time::now();
     do
     {
-        Time::delay(1);
-        timeout++;
+        Time::delay(CHECK_PERIOD);
         iPosition->checkMotionDone(&done);
     }
-    while((!done) && (timeout < PARK_TIMEOUT) && (!abortParking));
+    while((!done) && (Time::now() - start_time < PARK_TIMEOUT) && (!abortParking));
 
     if(!done)
     {
@@ -1154,21 +1316,20 @@ bool parametricCalibratorEth::moveAndCheck_legacy(PositionSequence &data, std::v
         }
     }
 
-    // wait for the parking to be completed
+    // wait for the parking to be completed: the joints move together, hence the timeout is counted from now for all of them
     if (wait)
     {
+        double start_time = Time::now();
         for(auto joint  = calibJoints.begin(); joint != calibJoints.end() && !abortCalib; joint++) //for each joint of set
         {
-            int timeout = 0;
             if (cannotPark[(*joint)] ==false)
             {
                 yDebug() << deviceName.c_str() << ": Moving to park position, joint:" << (*joint);
                 done=false;
                 iPosition->checkMotionDone((*joint), &done);
-                while ((!done) && (timeout < PARK_TIMEOUT) && (!abortParking))
+                while ((!done) && (Time::now() - start_time < PARK_TIMEOUT) && (!abortParking))
                 {
-                    Time::delay(1);
-                    timeout++;
+                    Time::delay(CHECK_PERIOD);
                     iPosition->checkMotionDone((*joint), &done);
                 }
                 if(!done)
@@ -1185,6 +1346,7 @@ bool parametricCalibratorEth::quitCalibrate()
 {
     yDebug() << deviceName.c_str() << ": Quitting calibrate\n";
     abortCalib = true;
+    calibrationLevels.wakeUp();
     return true;
 }
 
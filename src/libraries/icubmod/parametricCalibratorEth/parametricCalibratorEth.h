@@ -38,6 +38,16 @@ namespace yarp {
  * @brief `parametricCalibrator`: implement calibration routines for the iCub arm(s) (version 1.2).
  * 
  * A calibrator interface implementation for the Arm of the robot iCub.
+ *
+ * The joints of a set of CALIB_ORDER calibrate together. The calibrators of
+ * different parts can calibrate at the same time when they are started
+ * together (e.g. calibrator actions with the same phase and level in
+ * yarprobotinterface); the optional GENERAL parameter calibrationLevel
+ * (non negative integer) orders them: a calibrator does not move any joint
+ * until all the opened calibrators with a lower level have ended their
+ * calibration, successfully or not. If they have not ended within the
+ * GENERAL parameter calibrationLevelTimeout (seconds, 300 by default) the
+ * calibration fails.
  */
 class yarp::dev::parametricCalibratorEth : public ICalibrator, public DeviceDriver, public IRemoteCalibrator
 {
@@ -107,10 +117,12 @@ private:
     };
 
     bool calibrate();
+    bool calibrateSets();
+    void releaseCalibrationLevel();
     bool calibrateJoint(int j);
     bool goToStartupPosition(int j);
     bool checkCalibrateJointEnded(std::list<int> set);
-    bool checkGoneToZeroThreshold(int j);
+    bool checkGoneToZeroThreshold(std::list<int> set);
     bool checkHwFault(int j);
 
     yarp::dev::PolyDriver *dev2calibrate;
@@ -136,13 +148,16 @@ private:
     PositionSequence legacyStartupPosition;     // upgraded old array to new struct; to be removed when old method will be deprecated
     PositionSequence legacyParkingPosition;     // upgraded old array to new struct; to be removed when old method will be deprecated
 
-    bool    abortCalib;
+    std::atomic<bool>    abortCalib;
     bool    abortParking;
     std::atomic<bool>    isCalibrated;
     bool    skipCalibration;
     int    *disableHomeAndPark;
     int    *disableStartupPosCheck;
     bool    clearHwFault;
+    int     calibrationLevel;                 // GENERAL calibrationLevel, -1 if not given
+    double  calibrationLevelTimeout;          // GENERAL calibrationLevelTimeout [s]
+    bool    levelPending;                     // this calibrator has not ended its calibration yet for the other levels
 
     int    *timeout_goToZero;
     int    *timeout_calibration;
@@ -7,8 +7,11 @@
  *
  */
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <yarp/os/Time.h>
@@ -30,16 +33,26 @@ public:
         mBufferSize=0;
         mCanDeviceNum=-1;
         mDevice="";
+        mEventDriven=false;
+        eventQuit=false;
 
         reqIdsUnion=new char[0x800];
 
         for (int i=0; i<0x800; ++i) reqIdsUnion[i]=UNREQ;
+
+        rebuildDispatchTableUnsafe();
     }
 
     ~SharedCanBus()
     {
         stop();
 
+        if (eventThread.joinable())
+        {
+            eventQuit=true;
+            eventThread.join();
+        }
+
         polyDriver.close();
 
         delete [] reqIdsUnion;
@@ -55,6 +68,11 @@ public:
         return mCanDeviceNum;
     }
 
+    bool isEventDriven()
+    {
+        return mEventDriven;
+    }
+
     bool IloveUmom(yarp::os::Searchable &config)
     {
         if (!config.check("physDevice"))
@@ -84,6 +102,7 @@ public:
     {
         std::lock_guard<std::mutex> lck(configMutex);
         accessPoints.push_back(ap);
+        rebuildDispatchTableUnsafe();
     }
 
     void detachAccessPoint(yarp::dev::CanBusAccessPoint* ap)
@@ -98,14 +117,22 @@ public:
         {
             if (ap==accessPoints[i])
             {
+                accessPoints[i]=accessPoints[n-1];
+                
+                accessPoints.pop_back();
+
+                // the access point is removed first, otherwise its own ids would keep them requested
                 for (int id=0; id<0x800; ++id)
                 {
                     if (ap->hasId(id)) canIdDeleteUnsafe(id);
                 }
-                
-                accessPoints[i]=accessPoints[n-1];
-                
-                accessPoints.pop_back();
+
+                // the caller may destroy ap as soon as we return: we wait until run() and canWrite() release the table which holds it
+                std::shared_ptr<const DispatchTable> old=std::atomic_load(&dispatchTable);
+
+                rebuildDispatchTableUnsafe();
+
+                while (old.use_count()>1) yarp::os::Time::delay(0.001);
 
                 break;
             }
@@ -120,26 +147,42 @@ public:
     void run()
     {
         static const bool NOWAIT=false;
-        unsigned int msgsNum=0;
 
-        std::lock_guard<std::mutex> lck(configMutex);
+        receive(NOWAIT);
+    }
+
+    // in place of run() if sharedCanEventDriven is set: the blocking read of the driver wakes it as soon as there are messages
+    void runEvents()
+    {
+        static const bool WAIT=true;
+
+        while (!eventQuit)
+        {
+            receive(WAIT);
+        }
+    }
+
+    void receive(bool wait)
+    {
+        unsigned int msgsNum=0;
 
-        bool ret=theCanBus->canRead(readBufferUnion,mBufferSize,&msgsNum,NOWAIT);
+        bool ret=theCanBus->canRead(readBufferUnion,mBufferSize,&msgsNum,wait);
 
         if (ret)
         {
+            std::shared_ptr<const DispatchTable> table=std::atomic_load(&dispatchTable);
+
             for (unsigned int i=0; i<msgsNum; ++i)
             {
                 unsigned int id=readBufferUnion[i].getId();
 
-                for (unsigned int p=0; p<accessPoints.size(); ++p)
+                if (id>=0x800) continue;
+
+                for (unsigned int p=table->first[id]; p<table->first[id+1]; ++p)
                 {
-                    if (accessPoints[p]->hasId(id))
+                    if (table->aps[p]->pushReadMsg(readBufferUnion[i])==false)
                     {
-                        if (accessPoints[p]->pushReadMsg(readBufferUnion[i])==false)
-                        {
-                            yError("run()-pushReadMsg() failed on CAN bus %d", mCanDeviceNum);
-                        }
+                        yError("run()-pushReadMsg() failed on CAN bus %d", mCanDeviceNum);
                     }
                 }
             }
@@ -152,21 +195,20 @@ public:
         bool ret=theCanBus->canWrite(msgs,size,sent,wait);
 
         //this allows other istances to read back the sent message (echo)
-        yarp::dev::CanBuffer buff=msgs;
+        std::shared_ptr<const DispatchTable> table=std::atomic_load(&dispatchTable);
+
         for (unsigned int m=0; m<size; ++m)
         {
-            unsigned int id=buff[m].getId();
-            if (reqIdsUnion[id])
+            const yarp::dev::CanMessage &msg=msgs[m];
+            unsigned int id=msg.getId();
+
+            if (id>=0x800) continue;
+
+            for (unsigned int p=table->first[id]; p<table->first[id+1]; ++p)
             {
-                for (unsigned int p=0; p<accessPoints.size(); ++p)
+                if (table->aps[p]!=pFrom && table->aps[p]->pushReadMsg(msg)==false)
                 {
-                    if (accessPoints[p]!=pFrom && accessPoints[p]->hasId(id))
-                    {
-                        if (accessPoints[p]->pushReadMsg(buff[m])==false)
-                        {
-                            yError("canWrite()-pushReadMsg() failed on CAN bus %d", mCanDeviceNum);
-                        }
-                    }
+                    yError("canWrite()-pushReadMsg() failed on CAN bus %d", mCanDeviceNum);
                 }
             }
         }
@@ -182,12 +224,14 @@ public:
             reqIdsUnion[id]=REQST;
             theCanBus->canIdAdd(id);
         }
+        rebuildDispatchTableUnsafe();
     }
 
     void canIdDelete(unsigned int id)
     {
         std::lock_guard<std::mutex> lck(configMutex);
         canIdDeleteUnsafe(id);
+        rebuildDispatchTableUnsafe();
     }
     
     yarp::dev::ICanBus* getCanBus()
@@ -268,7 +312,22 @@ public:
 
         readBufferUnion=theBufferFactory->createBuffer(mBufferSize);
 
-        bool started=start();
+        // the driver must return from a blocking canRead() after a timeout also if there are no messages, as socketcan does
+        if (config.findGroup("CAN").check("sharedCanEventDriven"))
+        {
+            mEventDriven=config.findGroup("CAN").find("sharedCanEventDriven").asBool();
+        }
+
+        bool started=true;
+
+        if (mEventDriven)
+        {
+            eventThread=std::thread(&SharedCanBus::runEvents, this);
+        }
+        else
+        {
+            started=start();
+        }
 
         mDevice=device;
 
@@ -281,6 +340,36 @@ public:
     }
 
 private:
+    // the access points which have requested each id, grouped by id: the ones of id are aps[first[id]] ... aps[first[id+1]-1].
+    // the table is rebuilt under configMutex at every change and published atomically, hence the dispatch of the messages in
+    // run() and canWrite() reads a consistent snapshot without taking configMutex
+    struct DispatchTable
+    {
+        unsigned int first[0x801];
+        std::vector<yarp::dev::CanBusAccessPoint*> aps;
+    };
+
+    void rebuildDispatchTableUnsafe()
+    {
+        std::shared_ptr<DispatchTable> table=std::make_shared<DispatchTable>();
+
+        for (unsigned int id=0; id<0x800; ++id)
+        {
+            table->first[id]=table->aps.size();
+
+            if (reqIdsUnion[id]==UNREQ) continue;
+
+            for (unsigned int p=0; p<accessPoints.size(); ++p)
+            {
+                if (accessPoints[p]->hasId(id)) table->aps.push_back(accessPoints[p]);
+            }
+        }
+
+        table->first[0x800]=table->aps.size();
+
+        std::atomic_store(&dispatchTable, std::shared_ptr<const DispatchTable>(table));
+    }
+
     void canIdDeleteUnsafe(unsigned int id)
     {
         if (reqIdsUnion[id]==REQST)
@@ -301,6 +390,10 @@ private:
 
     int mBufferSize;
 
+    bool mEventDriven;
+    std::thread eventThread;
+    std::atomic<bool> eventQuit;
+
     std::mutex writeMutex;
     std::mutex configMutex;
 
@@ -318,6 +411,8 @@ private:
     yarp::dev::CanBuffer readBufferUnion;
 
     char *reqIdsUnion; //[0x800];
+
+    std::shared_ptr<const DispatchTable> dispatchTable;
 };
 
 class SharedCanBusManager // singleton
@@ -358,7 +453,11 @@ public:
             return NULL;
         }
 
-        if (config.findGroup("CAN").check("sharedCanPeriod"))
+        if (scb->isEventDriven())
+        {
+            yDebug("SharedCanBus [%d] reads the messages as soon as they arrive\n", scb->getCanDeviceNum());
+        }
+        else if (config.findGroup("CAN").check("sharedCanPeriod"))
         {
             int sharedCanPeriod = config.findGroup("CAN").find("sharedCanPeriod").asInt32();
             scb->setPeriod((double)sharedCanPeriod/1000.0);
@@ -80,7 +80,7 @@ public:
         return reqIds[id]==REQST;
     }
 
-    bool pushReadMsg(CanMessage& msg)
+    bool pushReadMsg(const CanMessage& msg)
     {
         std::lock_guard<std::mutex> lck(synchroMutex);
 
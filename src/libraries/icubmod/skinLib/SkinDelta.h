@@ -0,0 +1,207 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+#ifndef SKIN_DELTA_DEFINITIONS
+#define SKIN_DELTA_DEFINITIONS
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+#include <yarp/sig/Vector.h>
+
+
+namespace iCub {
+    namespace skin {
+        namespace delta {
+
+            /**
+             * The compact encoding of the taxels which have changed since the previous packet.
+             * A packet is a sequence of bytes (multi-byte fields are little endian):
+             *      - uint32 numberOfTaxels: the size of the full vector of taxels
+             *      - uint8  flags: bit 0 is set if the packet is a keyframe, i.e. it carries all the taxels
+             *      - any number of runs of consecutive taxels: uint16 first, uint8 length (1..255), length values
+             * The values are the raw taxels of the skin, which are in [0, 255], and a device has at most 65536 taxels.
+             */
+            enum { headerSize = 5, runHeaderSize = 3, maxRunLength = 255 };
+            enum { flagKeyframe = 0x01 };
+
+
+            /**
+             * Implemented by the skin devices which can give the changed taxels rather than the full vector.
+             */
+            class ISkinDelta
+            {
+            public:
+                virtual ~ISkinDelta() {}
+
+                /**
+                 * It writes into packet the taxels which differ by at least threshold from the values of the
+                 * previous packet, or all of them if keyframe is true. The device keeps the values it has
+                 * published, hence it is meant for a single consumer.
+                 */
+                virtual bool readDelta(std::vector<uint8_t> &packet, int threshold, bool keyframe) = 0;
+            };
+
+
+            /**
+             * It keeps the published values and builds the packets. The taxels are compared only in the blocks
+             * flagged in dirty (e.g. the triangles received since the previous packet), whose flags are cleared.
+             */
+            class Encoder
+            {
+            public:
+
+                void encode(const double *taxels, size_t size, std::vector<uint8_t> &dirty, size_t block, int threshold, bool keyframe, std::vector<uint8_t> &packet)
+                {
+                    if(published.size() != size)
+                    {
+                        published.assign(size, 0);
+                        keyframe = true;
+                    }
+                    if(threshold < 1)
+                    {
+                        threshold = 1;
+                    }
+
+                    packet.clear();
+                    put32(packet, static_cast<uint32_t>(size));
+                    packet.push_back(keyframe ? flagKeyframe : 0);
+
+                    size_t run = 0;         // position in packet of the header of the open run, 0 if none
+                    size_t next = 0;        // the taxel which would extend the open run
+                    size_t blocks = (0 == block) ? 0 : ((size + block - 1) / block);
+                    for(size_t b=0; b<blocks; b++)
+                    {
+                        bool isdirty = (b < dirty.size()) && (0 != dirty[b]);
+                        if(!keyframe && !isdirty)
+                        {
+                            continue;
+                        }
+                        if(b < dirty.size())
+                        {
+                            dirty[b] = 0;
+                        }
+
+                        size_t last = (b+1)*block;
+                        if(last > size)
+                        {
+                            last = size;
+                        }
+                        for(size_t i=b*block; i<last; i++)
+                        {
+                            uint8_t v = toByte(taxels[i]);
+                            int diff = static_cast<int>(v) - static_cast<int>(published[i]);
+                            if(!keyframe && (diff < threshold) && (-diff < threshold))
+                            {
+                                continue;
+                            }
+                            published[i] = v;
+
+                            if((0 == run) || (next != i) || (maxRunLength == packet[run+2]))
+                            {
+                                run = packet.size();
+                                packet.push_back(i & 0xff);
+                                packet.push_back((i >> 8) & 0xff);
+                                packet.push_back(0);
+                            }
+                            packet.push_back(v);
+                            packet[run+2]++;
+                            next = i+1;
+                        }
+                    }
+                }
+
+            private:
+
+                std::vector<uint8_t> published;
+
+                static uint8_t toByte(double v)
+                {
+                    if(v <= 0)
+                    {
+                        return 0;
+                    }
+                    if(v >= 255)
+                    {
+                        return 255;
+                    }
+                    return static_cast<uint8_t>(v + 0.5);
+                }
+
+                static void put32(std::vector<uint8_t> &packet, uint32_t v)
+                {
+                    for(int i=0; i<4; i++)
+                    {
+                        packet.push_back((v >> (8*i)) & 0xff);
+                    }
+                }
+            };
+
+
+            /**
+             * It applies a packet to the full vector of taxels, which is resized if its size is not the one of the
+             * packet. It returns false, leaving some taxels unchanged, if the packet is malformed.
+             */
+            inline bool decode(const uint8_t *data, size_t size, yarp::sig::Vector &taxels, bool *keyframe = NULL)
+            {
+                if(size < headerSize)
+                {
+                    return false;
+                }
+
+                uint32_t numberOfTaxels = data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+                if(taxels.size() != numberOfTaxels)
+                {
+                    taxels.resize(numberOfTaxels, 0.0);
+                }
+                if(NULL != keyframe)
+                {
+                    *keyframe = (0 != (data[4] & flagKeyframe));
+                }
+
+                size_t pos = headerSize;
+                while(pos < size)
+                {
+                    if(pos + runHeaderSize > size)
+                    {
+                        return false;
+                    }
+                    size_t first = data[pos] | (data[pos+1] << 8);
+                    size_t length = data[pos+2];
+                    pos += runHeaderSize;
+                    if((pos + length > size) || (first + length > numberOfTaxels))
+                    {
+                        return false;
+                    }
+                    for(size_t k=0; k<length; k++)
+                    {
+                        taxels[first+k] = data[pos+k];
+                    }
+                    pos += length;
+                }
+
+                return true;
+            }
+
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,64 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+#ifndef SKIN_UPDATE_DEFINITIONS
+#define SKIN_UPDATE_DEFINITIONS
+
+#include <yarp/os/Stamp.h>
+
+
+namespace iCub {
+    namespace skin {
+
+        /**
+         * Told by a skin device that its taxels have been updated.
+         */
+        class ISkinUpdateListener
+        {
+        public:
+            virtual ~ISkinUpdateListener() {}
+
+            /**
+             * Called by the thread of the device which receives the data, with the lock of the data held, after a
+             * complete update (e.g. a ropframe or a batch of CAN frames). It must return at once and it must not
+             * call the device: the data are to be read, with read(), from another thread.
+             */
+            virtual void skinUpdated(const yarp::os::Stamp &stamp) = 0;
+        };
+
+
+        /**
+         * Implemented by the skin devices which can tell when their taxels are updated, so that they can be
+         * published only when there is something new rather than periodically.
+         */
+        class ISkinUpdateNotifier
+        {
+        public:
+            virtual ~ISkinUpdateNotifier() {}
+
+            /**
+             * It replaces the listener, NULL for none. When it returns, the previous listener is no longer called.
+             */
+            virtual bool setUpdateListener(ISkinUpdateListener *listener) = 0;
+        };
+
+    }
+}
+
+#endif
@@ -8,6 +8,8 @@
 #include <yarp/os/Thread.h>
 #include <yarp/os/RFModule.h>
 #include <yarp/os/Os.h>
+#include <yarp/os/ConnectionWriter.h>
+#include <yarp/dev/GenericVocabs.h>
 #include <iCub/FactoryInterface.h>
 
 #include "skinWrapper.h"
@@ -15,11 +17,220 @@
 using namespace yarp::sig;
 using namespace yarp::os;
 
+skinDeltaPublisher::skinDeltaPublisher(double period, iCub::skin::delta::ISkinDelta *d, int thr, int keyframe) :
+    PeriodicThread(period),
+    delta(d),
+    threshold(thr),
+    keyframePeriod(keyframe),
+    count(0)
+{ }
+
+bool skinDeltaPublisher::open(const std::string &name)
+{
+    if(!port.open(name))
+    {
+        yError() << "skinWrapper: cannot open port" << name;
+        return false;
+    }
+    return start();
+}
+
+void skinDeltaPublisher::close()
+{
+    stop();
+    port.interrupt();
+    port.close();
+}
+
+void skinDeltaPublisher::run()
+{
+    // a keyframe is sent periodically so that a consumer which connects late or has lost a packet resyncs
+    bool keyframe = (0 == count) || ((keyframePeriod > 0) && (0 == (count % keyframePeriod)));
+    count++;
+
+    if(!delta->readDelta(packet, threshold, keyframe))
+        return;
+
+    // nothing has changed: the header alone is not worth a message
+    if(!keyframe && (packet.size() <= iCub::skin::delta::headerSize))
+        return;
+
+    stamp.update();
+    Bottle &b=port.prepare();
+    b.clear();
+    b.add(Value(packet.data(), packet.size()));
+    port.setEnvelope(stamp);
+    port.write();
+}
+
+bool skinUpdatePublisher::rpcHandler::read(yarp::os::ConnectionReader &connection)
+{
+    Bottle in, out;
+    if(!in.read(connection))
+        return false;
+
+    bool ok=false;
+    if((in.size() >= 2) && (VOCAB_IANALOG == in.get(0).asVocab32()))
+    {
+        int code=in.get(1).asVocab32();
+        if(VOCAB_CALIBRATE == code)
+        {
+            ok=(yarp::dev::IAnalogSensor::AS_OK == analog->calibrateSensor());
+        }
+        else if((VOCAB_CALIBRATE_CHANNEL == code) && (in.size() >= 3))
+        {
+            ok=(yarp::dev::IAnalogSensor::AS_OK == analog->calibrateChannel(in.get(2).asInt32()));
+        }
+    }
+    out.addVocab32(ok ? VOCAB_OK : VOCAB_FAILED);
+
+    ConnectionWriter *writer=connection.getWriter();
+    if(NULL != writer)
+        out.write(*writer);
+    return true;
+}
+
+skinUpdatePublisher::skinUpdatePublisher(yarp::dev::IAnalogSensor *a, iCub::skin::ISkinUpdateNotifier *n) :
+    analog(a),
+    notifier(n),
+    fresh(false)
+{
+    handler.analog=a;
+}
+
+skinUpdatePublisher::~skinUpdatePublisher()
+{
+    close();
+}
+
+bool skinUpdatePublisher::addPort(const std::string &name, int offset, int length)
+{
+    outPort *p=new outPort;
+    p->offset=offset;
+    p->length=length;
+    ports.push_back(p);
+
+    if(!p->port.open(name) || !p->rpc.open(name+"/rpc:i"))
+    {
+        yError() << "skinWrapper: cannot open port" << name;
+        return false;
+    }
+    p->rpc.setReader(handler);
+    return true;
+}
+
+bool skinUpdatePublisher::open(const std::string &root, yarp::os::Searchable &params)
+{
+    // the same layout of the ports as the analogServer: <name> <first> <last> of the taxels of the wrapper,
+    // then the same range of the device
+    Bottle *list=params.find("ports").asList();
+    if(NULL == list)
+    {
+        if(!addPort(root, 0, analog->getChannels()))
+            return false;
+    }
+    else
+    {
+        for(size_t k=0; k<list->size(); k++)
+        {
+            std::string name=list->get(k).asString();
+            Bottle &range=params.findGroup(name);
+            if(range.size() != 5)
+            {
+                yError() << "skinWrapper: port" << name << "needs the first and the last taxel of the wrapper and of the device";
+                return false;
+            }
+            int first=range.get(1).asInt32();
+            int last=range.get(2).asInt32();
+            if(!addPort(root+"/"+name, first, last-first+1))
+                return false;
+        }
+    }
+
+    if(!start())
+        return false;
+    return notifier->setUpdateListener(this);
+}
+
+void skinUpdatePublisher::close()
+{
+    if(NULL != notifier)
+    {
+        notifier->setUpdateListener(NULL);
+        notifier=NULL;
+    }
+    if(isRunning())
+        stop();
+
+    for(size_t k=0; k<ports.size(); k++)
+    {
+        ports[k]->port.interrupt();
+        ports[k]->port.close();
+        ports[k]->rpc.interrupt();
+        ports[k]->rpc.close();
+        delete ports[k];
+    }
+    ports.clear();
+}
+
+void skinUpdatePublisher::skinUpdated(const yarp::os::Stamp &s)
+{
+    std::lock_guard<std::mutex> lck(mtx);
+    stamp=s;
+    fresh=true;
+    cv.notify_one();
+}
+
+void skinUpdatePublisher::onStop()
+{
+    std::lock_guard<std::mutex> lck(mtx);
+    cv.notify_one();
+}
+
+void skinUpdatePublisher::run()
+{
+    while(!isStopping())
+    {
+        Stamp s;
+        {
+            // the updates which arrive while the ports are written are merged into the next publication
+            std::unique_lock<std::mutex> lck(mtx);
+            cv.wait(lck, [this]{ return fresh || isStopping(); });
+            if(!fresh)
+                break;
+            fresh=false;
+            s=stamp;
+        }
+
+        analog->read(taxels);
+
+        for(size_t k=0; k<ports.size(); k++)
+        {
+            outPort *p=ports[k];
+            if(p->offset+p->length > (int)taxels.size())
+                continue;
+
+            Vector &v=p->port.prepare();
+            v.resize(p->length);
+            for(int i=0; i<p->length; i++)
+                v[i]=taxels[p->offset+i];
+            p->port.setEnvelope(s);
+            p->port.write();
+        }
+    }
+}
+
 skinWrapper::skinWrapper()
 {
     yTrace(); 
     multipleWrapper=NULL;
     analog=NULL;
+    deltaPeriod=0;
+    deltaThreshold=1;
+    deltaKeyframe=100;
+    deltaPublisher=NULL;
+    publishOnUpdate=false;
+    updatePublisher=NULL;
 		setId("undefinedPartName");
 }
 
@@ -70,13 +281,37 @@ bool skinWrapper::open(yarp::os::Searchable &params)
     root_name+="/skin";
 
 
-    Property option(params.toString().c_str());
-    option.put("name",root_name);
-    option.unput("device");
-    option.put("device","analogServer");
-    option.put("channels",total_taxels);
-    option.unput("total_taxels");
-    if(!driver.open(option))
+    // the stream of the changed taxels is optional, and it is available only if the attached device supports it
+    deltaPeriod=params.check("deltaPeriod", Value(0)).asInt32();
+    deltaThreshold=params.check("deltaThreshold", Value(1)).asInt32();
+    deltaKeyframe=params.check("deltaKeyframe", Value(100)).asInt32();
+    deltaName=root_name+"/"+id+"/delta:o";
+
+    // the data are published when the device receives them, rather than every period, if the device supports it
+    publishOnUpdate=params.check("publishOnUpdate", Value(false)).asBool();
+    rootName=root_name;
+
+    serverOptions.fromString(params.toString());
+    serverOptions.unput("deltaPeriod");
+    serverOptions.unput("deltaThreshold");
+    serverOptions.unput("deltaKeyframe");
+    serverOptions.unput("publishOnUpdate");
+    serverOptions.put("name",root_name);
+    serverOptions.unput("device");
+    serverOptions.put("device","analogServer");
+    serverOptions.put("channels",total_taxels);
+    serverOptions.unput("total_taxels");
+
+    // which one publishes is known only once the device is attached
+    if(publishOnUpdate)
+        return true;
+
+    return openServer();
+}
+
+bool skinWrapper::openServer()
+{
+    if(!driver.open(serverOptions))
     {
         yError()<<"skinWrapper: unable to open the device";
         return false;
@@ -91,6 +326,20 @@ bool skinWrapper::open(yarp::os::Searchable &params)
 
 bool skinWrapper::close()
 {
+    if (NULL != deltaPublisher)
+    {
+        deltaPublisher->close();
+        delete deltaPublisher;
+        deltaPublisher=NULL;
+    }
+
+    if (NULL != updatePublisher)
+    {
+        updatePublisher->close();
+        delete updatePublisher;
+        updatePublisher=NULL;
+    }
+
     if (NULL != analog)
         analog=0;
 
@@ -125,6 +374,31 @@ bool skinWrapper::attachAll(const yarp::dev::PolyDriverList &skinDev)
         yError() << "skinWrapper: The analog sensor is not correctly instantiated, cannot attach !!!";
         return false;
     }
+
+    if (publishOnUpdate)
+    {
+        iCub::skin::ISkinUpdateNotifier *notifier=NULL;
+        subdevice->view(notifier);
+        if (NULL != notifier)
+        {
+            updatePublisher=new skinUpdatePublisher(analog, notifier);
+            if (!updatePublisher->open(rootName, serverOptions))
+            {
+                updatePublisher->close();
+                delete updatePublisher;
+                updatePublisher=NULL;
+                return false;
+            }
+            return attachDelta(subdevice);
+        }
+
+        yWarning() << "skinWrapper: part" << id << "has publishOnUpdate but its device cannot tell when it is updated, so it is published periodically";
+        if (!driver.isValid() && !openServer())
+        {
+            return false;
+        }
+    }
+
     if(driver.isValid())
     {
         driver.view(multipleWrapper);
@@ -140,13 +414,51 @@ bool skinWrapper::attachAll(const yarp::dev::PolyDriverList &skinDev)
         return false;
     }
     multipleWrapper->attachAll(skinDev);
+
+    return attachDelta(subdevice);
+}
+
+bool skinWrapper::attachDelta(yarp::dev::PolyDriver *subdevice)
+{
+    if (deltaPeriod > 0)
+    {
+        iCub::skin::delta::ISkinDelta *delta=NULL;
+        subdevice->view(delta);
+        if (NULL == delta)
+        {
+            yWarning() << "skinWrapper: part" << id << "has deltaPeriod but its device cannot give the changed taxels, so" << deltaName << "is not opened";
+        }
+        else
+        {
+            deltaPublisher=new skinDeltaPublisher(deltaPeriod/1000.0, delta, deltaThreshold, deltaKeyframe);
+            if (!deltaPublisher->open(deltaName))
+            {
+                delete deltaPublisher;
+                deltaPublisher=NULL;
+                return false;
+            }
+        }
+    }
     return true;
 }
 
 bool skinWrapper::detachAll()
 {
     yTrace();
-    multipleWrapper->detachAll();
+    if (NULL != deltaPublisher)
+    {
+        deltaPublisher->close();
+        delete deltaPublisher;
+        deltaPublisher=NULL;
+    }
+    if (NULL != updatePublisher)
+    {
+        updatePublisher->close();
+        delete updatePublisher;
+        updatePublisher=NULL;
+    }
+    if (NULL != multipleWrapper)
+        multipleWrapper->detachAll();
 //    analogServer->stop();
     return true;
 }
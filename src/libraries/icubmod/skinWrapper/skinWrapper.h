@@ -35,11 +35,89 @@
 #include <yarp/sig/Vector.h>
 
 #include <yarp/os/PeriodicThread.h>
+#include <yarp/os/Thread.h>
 #include <yarp/os/BufferedPort.h>
+#include <yarp/os/PortReader.h>
 #include <yarp/os/Stamp.h>
 
+#include <mutex>
+#include <condition_variable>
+
 #include <yarp/os/LogStream.h>
 
+#include <SkinDelta.h>
+#include <SkinUpdate.h>
+
+// it publishes on <root>/<id>/delta:o the packets of iCub::skin::delta (as a blob in a Bottle) of the changed taxels
+class skinDeltaPublisher : public yarp::os::PeriodicThread
+{
+private:
+    iCub::skin::delta::ISkinDelta *delta;
+    yarp::os::BufferedPort<yarp::os::Bottle> port;
+    std::vector<uint8_t> packet;
+    int threshold;
+    int keyframePeriod;     // number of packets between two keyframes, 0 for only the first one
+    int count;
+    yarp::os::Stamp stamp;
+
+public:
+    skinDeltaPublisher(double period, iCub::skin::delta::ISkinDelta *d, int thr, int keyframe);
+    bool open(const std::string &name);
+    void close();
+    void run() override;
+};
+
+
+// it takes the place of the analogServer when the device tells when its taxels are updated: the ports have the same
+// names and the same data, but they are written only after an update rather than periodically. The thread of the
+// device just wakes up the publisher, which reads the taxels once and writes all the ports.
+class skinUpdatePublisher : public yarp::os::Thread,
+                            public iCub::skin::ISkinUpdateListener
+{
+private:
+    // it serves on <port>/rpc:i the calibration commands of the analogServer
+    class rpcHandler : public yarp::os::PortReader
+    {
+    public:
+        yarp::dev::IAnalogSensor *analog;
+        bool read(yarp::os::ConnectionReader &connection) override;
+    };
+
+    struct outPort
+    {
+        int offset;
+        int length;
+        yarp::os::BufferedPort<yarp::sig::Vector> port;
+        yarp::os::Port rpc;
+    };
+
+    yarp::dev::IAnalogSensor *analog;
+    iCub::skin::ISkinUpdateNotifier *notifier;
+    std::vector<outPort*> ports;
+    rpcHandler handler;
+    yarp::sig::Vector taxels;
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    bool fresh;
+    yarp::os::Stamp stamp;
+
+    bool addPort(const std::string &name, int offset, int length);
+
+public:
+    skinUpdatePublisher(yarp::dev::IAnalogSensor *a, iCub::skin::ISkinUpdateNotifier *n);
+    ~skinUpdatePublisher();
+
+    // the ports are the ones of the "ports" list of the configuration, or only root if there is none
+    bool open(const std::string &root, yarp::os::Searchable &params);
+    void close();
+
+    void skinUpdated(const yarp::os::Stamp &s) override;
+    void run() override;
+    void onStop() override;
+};
+
+
 class skinWrapper : public yarp::dev::DeviceDriver,
                     public yarp::dev::IMultipleWrapper
 {
@@ -50,6 +128,23 @@ private:
     int numPorts;
     yarp::dev::IMultipleWrapper *multipleWrapper;
 
+    // the optional stream of the changed taxels, enabled with deltaPeriod > 0
+    int deltaPeriod;
+    int deltaThreshold;
+    int deltaKeyframe;
+    std::string deltaName;
+    skinDeltaPublisher *deltaPublisher;
+
+    // with publishOnUpdate the data are published by updatePublisher, if the attached device supports it,
+    // otherwise by the analogServer, which is then opened by attachAll()
+    bool publishOnUpdate;
+    yarp::os::Property serverOptions;
+    std::string rootName;
+    skinUpdatePublisher *updatePublisher;
+
+    bool openServer();
+    bool attachDelta(yarp::dev::PolyDriver *subdevice);
+
 //    yarp::sig::Vector wholeData;      // may be useful if one the skin wrapper has to get data from more than one device...
 
 public:
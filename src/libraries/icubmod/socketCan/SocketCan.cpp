@@ -39,6 +39,10 @@
 #include <stdio.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <errno.h>
+#include <poll.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
 
 
 /* At time of writing, these constants are not defined in the headers */
@@ -58,9 +62,17 @@ using namespace yarp::os;
 const int TX_QUEUE_SIZE=2047;
 const int RX_QUEUE_SIZE=2047;
 
+// frames read with a single recvmmsg()
+const int RX_BATCH_SIZE=64;
+// room for the SCM_TIMESTAMPING control message of every frame
+const size_t RX_CONTROL_SIZE=CMSG_SPACE(sizeof(struct scm_timestamping));
+
 SocketCan::SocketCan()
 {
     skt = 0;
+    rxTimeout = 500;
+    rxBatching = true;
+    rxTimestamps = rxTimestampsOff;
 }
 
 SocketCan::~SocketCan()
@@ -118,6 +130,78 @@ bool SocketCan::canRead(CanBuffer &msgs,
 
     fprintf(stderr, "Error: canRead returned with code:%.8X\n", res);*/
 
+    *readout=0;
+
+    if (wait)
+    {
+        // it returns as soon as there is a frame, or after rxTimeout with no frames
+        struct pollfd pfd;
+        pfd.fd=skt;
+        pfd.events=POLLIN;
+        pfd.revents=0;
+        int ret=poll(&pfd, 1, rxTimeout);
+        if (ret<0 && errno!=EINTR)
+        {
+            fprintf(stderr, "Error: SocketCan::canRead() poll() failed: %s\n", strerror(errno));
+            return false;
+        }
+        if (ret<=0)
+            return true;
+    }
+
+    if (rxBatching)
+    {
+        unsigned int total=0;
+        while (total<size)
+        {
+            unsigned int n=size-total;
+            if (n>rxBatch.size()) n=rxBatch.size();
+
+            for (unsigned int k=0; k<n; k++)
+            {
+                rxIovecs[k].iov_base=msgs[total+k].getPointer();
+                rxIovecs[k].iov_len=sizeof(struct can_frame);
+
+                struct msghdr &hdr=rxBatch[k].msg_hdr;
+                memset(&hdr, 0, sizeof(hdr));
+                hdr.msg_iov=&rxIovecs[k];
+                hdr.msg_iovlen=1;
+                if (rxTimestamps!=rxTimestampsOff)
+                {
+                    hdr.msg_control=&rxControls[k*RX_CONTROL_SIZE];
+                    hdr.msg_controllen=RX_CONTROL_SIZE;
+                }
+                rxBatch[k].msg_len=0;
+            }
+
+            int got=recvmmsg(skt, &rxBatch[0], n, MSG_DONTWAIT, NULL);
+            if (got<=0)
+            {
+                if (got<0 && errno!=EAGAIN && errno!=EWOULDBLOCK && errno!=EINTR)
+                {
+                    fprintf(stderr, "Error: SocketCan::canRead() recvmmsg() failed: %s\n", strerror(errno));
+                }
+                break;
+            }
+
+            for (int k=0; k<got; k++)
+            {
+                double stamp=(rxTimestamps!=rxTimestampsOff) ? kernelTimestamp(rxBatch[k].msg_hdr) : 0;
+                reinterpret_cast<SocketCanFrame *>(msgs[total+k].getPointer())->timestamp=stamp;
+            }
+
+            total+=got;
+
+            // the socket is empty
+            if ((unsigned int)got<n) break;
+        }
+        *readout=total;
+        #if SOCK_DEBUG
+            printf("Read %d messages\n", *readout);
+        #endif
+        return true;
+    }
+
     int i=0;
     int bytes_read=0;
     #if SOCK_DEBUG
@@ -134,6 +218,8 @@ bool SocketCan::canRead(CanBuffer &msgs,
         #endif
         if (bytes_read<=0) break;
 
+        reinterpret_cast<SocketCanFrame *>(frm)->timestamp=0;
+
         #if SOCK_DEBUG
             printf("Read: %d \n ",bytes_read);
             printf("len %d ", frm->can_dlc);
@@ -172,6 +258,24 @@ bool SocketCan::canRead(CanBuffer &msgs,
 	*/
 }
 
+double SocketCan::kernelTimestamp(struct msghdr &hdr)
+{
+    for (struct cmsghdr *cmsg=CMSG_FIRSTHDR(&hdr); cmsg!=NULL; cmsg=CMSG_NXTHDR(&hdr, cmsg))
+    {
+        if ((cmsg->cmsg_level==SOL_SOCKET) && (cmsg->cmsg_type==SCM_TIMESTAMPING))
+        {
+            struct scm_timestamping ts;
+            memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+
+            // ts[2] is the time of the controller, ts[0] the time of the kernel: we fall back to it if the controller has none
+            const struct timespec &t=((rxTimestamps==rxTimestampsHardware) && (ts.ts[2].tv_sec!=0 || ts.ts[2].tv_nsec!=0)) ? ts.ts[2] : ts.ts[0];
+            return t.tv_sec + 1e-9*t.tv_nsec;
+        }
+    }
+
+    return 0;
+}
+
 bool SocketCan::canWrite(const CanBuffer &msgs,
                       unsigned int size,
                       unsigned int *sent,
@@ -258,6 +362,29 @@ bool SocketCan::open(yarp::os::Searchable &par)
                                       canRxQueue=par.check("CanRxQueue", Value(RX_QUEUE_SIZE), "length of rx buffer").asInt32() ;
     if  (canRxQueue == RX_QUEUE_SIZE) canRxQueue=par.check("canRxQueue", Value(RX_QUEUE_SIZE), "length of rx buffer").asInt32() ;
 
+    rxBatching=par.check("canRxBatching", Value(1), "read the frames in batches with recvmmsg()").asBool();
+
+    std::string stamps=par.check("canRxTimestamps", Value("off"), "timestamps of the received frames: off, software or hardware").asString();
+    if      (stamps == "software") rxTimestamps=rxTimestampsSoftware;
+    else if (stamps == "hardware") rxTimestamps=rxTimestampsHardware;
+    else if (stamps == "off")      rxTimestamps=rxTimestampsOff;
+    else
+    {
+        fprintf(stderr, "Error: SocketCan::open() canRxTimestamps must be off, software or hardware, not %s\n", stamps.c_str());
+        return false;
+    }
+
+    if (rxTimestamps!=rxTimestampsOff && !rxBatching)
+    {
+        fprintf(stderr, "Warning: SocketCan::open() canRxTimestamps needs canRxBatching: the frames will have no timestamp\n");
+    }
+
+    this->rxTimeout=rxTimeout;
+
+    rxBatch.resize(RX_BATCH_SIZE);
+    rxIovecs.resize(RX_BATCH_SIZE);
+    rxControls.resize(RX_BATCH_SIZE*RX_CONTROL_SIZE);
+
    int so_timestamping_flags = 0;
    /* Create the socket */
    skt = socket( PF_CAN, SOCK_RAW, CAN_RAW );
@@ -273,6 +400,19 @@ bool SocketCan::open(yarp::os::Searchable &par)
    addr.can_ifindex = ifr.ifr_ifindex;
    bind( skt, (struct sockaddr*)&addr, sizeof(addr) );
 
+   if (rxTimestamps!=rxTimestampsOff)
+   {
+       so_timestamping_flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+       if (rxTimestamps==rxTimestampsHardware)
+           so_timestamping_flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+
+       if (setsockopt(skt, SOL_SOCKET, SO_TIMESTAMPING, &so_timestamping_flags, sizeof(so_timestamping_flags)) < 0)
+       {
+           fprintf(stderr, "Warning: SocketCan::open() cannot enable SO_TIMESTAMPING on can%d: %s\n", netId, strerror(errno));
+           rxTimestamps=rxTimestampsOff;
+       }
+   }
+
     int flags;
     if (-1 == (flags = fcntl(skt, F_GETFL, 0))) flags = 0;
     fcntl(skt, F_SETFL, flags | O_NONBLOCK);
@@ -35,6 +35,10 @@
 #include <linux/can.h>
 #include <linux/can/raw.h>
 
+#include <vector>
+
+#include "canMessageTimestamp.h"
+
 namespace yarp{
     namespace dev{
         class SocketCan;
@@ -42,7 +46,14 @@ namespace yarp{
     }
 }
 
-class yarp::dev::SocketCanMessage:public yarp::dev::CanMessage
+// the element of the buffers: the frame must be the first member, because it is what the socket reads and writes
+struct SocketCanFrame
+{
+    struct can_frame frame;
+    double timestamp;       // time of reception [s] on the system clock, 0 if not available
+};
+
+class yarp::dev::SocketCanMessage:public yarp::dev::CanMessage, public ICanMessageTimestamp
 {
 public:
     struct can_frame *msg;
@@ -60,10 +71,16 @@ public:
     virtual CanMessage &operator=(const CanMessage &l)
     {
         const SocketCanMessage &tmp=dynamic_cast<const SocketCanMessage &>(l);
-        memcpy(msg, tmp.msg, sizeof(struct can_frame));
+        memcpy(msg, tmp.msg, sizeof(SocketCanFrame));
         return *this;
     }
 
+    virtual double getTimestamp() const
+    { return reinterpret_cast<const SocketCanFrame *>(msg)->timestamp; }
+
+    void setTimestamp(double t)
+    { reinterpret_cast<SocketCanFrame *>(msg)->timestamp=t; }
+
     virtual unsigned int getId() const
     { return msg->can_id;}
 
@@ -103,12 +120,25 @@ public:
  * |:-----------------:|
  * | `socketcan` |
  */
-class yarp::dev::SocketCan: public ImplementCanBufferFactory<SocketCanMessage, can_frame>,
+class yarp::dev::SocketCan: public ImplementCanBufferFactory<SocketCanMessage, SocketCanFrame>,
     public ICanBus, 
     public DeviceDriver
 {
 private:
     int skt;
+
+    int rxTimeout;          // [ms] for the blocking canRead()
+
+    // canRead() gets the frames with recvmmsg(), at most rxBatch.size() per call
+    bool rxBatching;
+    enum RxTimestamps { rxTimestampsOff=0, rxTimestampsSoftware=1, rxTimestampsHardware=2 };
+    RxTimestamps rxTimestamps;
+    std::vector<struct mmsghdr> rxBatch;
+    std::vector<struct iovec> rxIovecs;
+    std::vector<char> rxControls;
+
+    double kernelTimestamp(struct msghdr &hdr);
+
 public:
     SocketCan();
     ~SocketCan();
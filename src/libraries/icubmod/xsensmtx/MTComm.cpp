@@ -101,6 +101,7 @@ CMTComm::CMTComm()
 	m_retVal = MTRV_OK;
 	m_timeOut = TO_DEFAULT;
 	m_nTempBufferLen = 0;
+	m_inBufferStart = m_inBufferEnd = 0;
 	m_clkEnd = 0;
 	for (int i=0;i<MAXDEVICES+1;i++) {
 		m_storedOutputMode[i] = INVALIDSETTINGVALUE;
@@ -548,6 +549,42 @@ int CMTComm::readData(unsigned char* msgBuffer, const int nBytesToRead)
 #endif
 }
 
+////////////////////////////////////////////////////////////////////
+// readDataBuffered
+//
+// Same as readData, but the bytes are taken from an input buffer which is
+//   refilled with a single read of all the bytes available (up to
+//   INBUFFERSIZE). readMessageRaw asks for the preamble, the header and the
+//   data of each message separately: this way a system call serves many
+//   messages instead of each message needing 3 or 4 of them
+//
+// Input
+//   msgBuffer		: pointer to buffer in which next string will be stored
+//   nBytesToRead	: maximum number of bytes to copy in msgBuffer
+//
+// Output
+//   number of bytes actually copied
+int CMTComm::readDataBuffered(unsigned char* msgBuffer, const int nBytesToRead)
+{
+	if (m_inBufferStart == m_inBufferEnd) {
+		m_inBufferStart = m_inBufferEnd = 0;
+		int nBytesRead = readData(m_inBuffer, INBUFFERSIZE);
+		if (nBytesRead <= 0) {
+			return 0;	// m_retVal is set by readData
+		}
+		m_inBufferEnd = nBytesRead;
+	}
+
+	int nBytes = m_inBufferEnd - m_inBufferStart;
+	if (nBytes > nBytesToRead) {
+		nBytes = nBytesToRead;
+	}
+	memcpy(msgBuffer, m_inBuffer + m_inBufferStart, nBytes);
+	m_inBufferStart += nBytes;
+	m_retVal = MTRV_OK;
+	return nBytes;
+}
+
 ////////////////////////////////////////////////////////////////////
 // writeData
 //
@@ -596,6 +633,7 @@ void CMTComm::flush()
 #endif
 	}
 	m_nTempBufferLen = 0;
+	m_inBufferStart = m_inBufferEnd = 0;
 	m_retVal = MTRV_OK;
 }
 
@@ -650,12 +688,14 @@ short CMTComm::setFilePos(long relPos, unsigned long moveMethod)
 #ifdef WIN32
 	if (m_fileOpen) {
 		if(SetFilePointer(m_handle, relPos, NULL, moveMethod) != INVALID_SET_FILE_POINTER){
+			m_inBufferStart = m_inBufferEnd = 0;
 			return (m_retVal = MTRV_OK);
 		}
 	}
 #else
 	if (m_fileOpen) {
 		if (lseek(m_handle, relPos, moveMethod) != -1){
+			m_inBufferStart = m_inBufferEnd = 0;
 			return (m_retVal = MTRV_OK);
 		}
 	}
@@ -715,6 +755,7 @@ short CMTComm::close()
 	m_timeOut = TO_DEFAULT; // Restore timeout value (file input)
 	m_clkEnd = 0;
 	m_nTempBufferLen = 0;
+	m_inBufferStart = m_inBufferEnd = 0;
 	m_deviceError = 0;		// No error
 	for(int i=0;i<MAXDEVICES+1;i++){
 		m_storedOutputMode[i] = INVALIDSETTINGVALUE;
@@ -871,7 +912,7 @@ short CMTComm::readMessageRaw(unsigned char *msgBuffer, short *msgBufferLength)
 			
 			// Check if serial port buffer must be read
 			if (nBytesToRead > 0) {
-				nBytesRead = readData(msgBuffer+nOffset, nBytesToRead);
+				nBytesRead = readDataBuffered(msgBuffer+nOffset, nBytesToRead);
 				if (m_retVal == MTRV_ENDOFFILE) {
 					return (m_retVal = MTRV_ENDOFFILE);
 				}
@@ -137,6 +137,7 @@
 #define MAXDATALEN					(const unsigned short)2048
 #define MAXSHORTDATALEN				(const unsigned short)254
 #define MAXMSGLEN					(const unsigned short)(MAXDATALEN+7)
+#define INBUFFERSIZE				4096	// Size of the buffer of the bytes read from port/file in bulk
 #define MAXSHORTMSGLEN				(const unsigned short)(MAXSHORTDATALEN+5)
 
 
@@ -911,6 +912,7 @@ public:
 	bool	isPortOpen();
 	bool	isFileOpen();
 	int     readData(unsigned char* msgBuffer, const int nBytesToRead);
+	int     readDataBuffered(unsigned char* msgBuffer, const int nBytesToRead);
 	int		writeData(const unsigned char* msgBuffer, const int nBytesToWrite);
 	void	flush();
 	void	escape(unsigned long function);
@@ -998,6 +1000,11 @@ protected:
 	unsigned char	m_tempBuffer[MAXMSGLEN];
 	int				m_nTempBufferLen;
 
+	// Input buffer of readDataBuffered, holding the bytes from m_inBufferStart to m_inBufferEnd
+	unsigned char	m_inBuffer[INBUFFERSIZE];
+	int				m_inBufferStart;
+	int				m_inBufferEnd;
+
 private:
 };
 
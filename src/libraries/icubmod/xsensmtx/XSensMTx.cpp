@@ -11,7 +11,9 @@
 #include <yarp/os/Time.h>
 #include <yarp/os/Stamp.h>
 #include <string>
-#include <mutex>
+#include <atomic>
+#include <thread>
+#include <cstring>
 
 #include "MTComm.h"
 #include "XSensMTx.h"
@@ -31,19 +33,30 @@ constexpr size_t gyroStartIdx  = 6;
 constexpr size_t magnStartIdx  = 9;
 
 
+// The thread reads the messages of the MTx as they arrive and keeps the latest decoded sample, with its timestamp.
+// The sample is protected by a sequence counter (seqlock), as done in SensorsBuffer of embObjLib: run() never waits
+// for the readers, and a reader copies the sample again if run() has changed it in the meantime.
 class XSensMTxResources: public Thread
 {
 public:
+    struct Sample
+    {
+        double values[12];
+        double time;
+        int    count;
+        bool   error;
+    };
+
     explicit XSensMTxResources()
     {
         _bStreamStarted=false;
-        _bError=false;
-            
-        _last=0;
+        _version=0;
 
-        _last=new double [12];
         for(int k=0;k<12;k++)
-            _last[k]=0.0;
+            _latest.values[k]=0.0;
+        _latest.time=0.0;
+        _latest.count=0;
+        _latest.error=false;
     }
 
     virtual ~XSensMTxResources()
@@ -52,25 +65,44 @@ public:
             stop();
 
         _bStreamStarted=false;
+    }
 
-        if (_last!=0)
+    // copies the latest sample
+    void latest(Sample &sample) const
+    {
+        for(;;)
+        {
+            unsigned int v1=_version.load(std::memory_order_acquire);
+            if ((v1&1)==0)
             {
-                delete [] _last;
-                _last=0;
+                memcpy(&sample,&_latest,sizeof(Sample));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (v1==_version.load(std::memory_order_relaxed))
+                    return;
             }
+            // the writer holds the sample only for its copy
+            std::this_thread::yield();
+        }
     }
 
     bool _bStreamStarted;
-    bool _bError;
 
     CMTComm mtcomm;
-    
-    double *_last;
-    yarp::os::Stamp _lastStamp;
-
-    std::mutex _semaphore;
 
     virtual void run ();
+
+private:
+    void put(const Sample &sample)
+    {
+        unsigned int v=_version.load(std::memory_order_relaxed);
+        _version.store(v+1,std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&_latest,&sample,sizeof(Sample));
+        _version.store(v+2,std::memory_order_release);
+    }
+
+    std::atomic<unsigned int> _version;
+    Sample _latest;
 };
 
 void XSensMTxResources::run ()
@@ -83,10 +115,30 @@ void XSensMTxResources::run ()
     short datalen;
     int received;
 
+    Sample sample;
+    latest(sample);
+
     while (!Thread::isStopping ())
         {
             // Get data from the MTx device
             received = mtcomm.readDataMessage (data, datalen);
+
+            if (received != MTRV_OK)
+                {
+                    // the previous values are kept, flagged as not valid
+                    if (!sample.error)
+                        {
+                            sample.error=true;
+                            put(sample);
+                        }
+                    continue;
+                }
+
+            // the time of arrival, before the decoding
+            sample.time=Time::now();
+            sample.count++;
+            sample.error=false;
+
             // Parse and get value (EULER ORIENTATION)
             mtcomm.getValue (VALUE_ORIENT_EULER, euler_data, data, BID_MASTER);
             // Parse and get calibrated acceleration values
@@ -95,33 +147,26 @@ void XSensMTxResources::run ()
             mtcomm.getValue (VALUE_CALIB_GYR, gyro_data, data, BID_MASTER);
             // Parse and get calibrated magnetometer values
             mtcomm.getValue (VALUE_CALIB_MAG, magn_data, data, BID_MASTER);
-	    
-            std::lock_guard<std::mutex> lck(_semaphore);
-            
+
 			//euler_data are expressed in deg
-            _last[0]  = euler_data[0]; //roll
-            _last[1]  = euler_data[1]; //pitch
-            _last[2]  = euler_data[2]; //yaw
-
-            _last[3]  = accel_data[0]; //accel-X
-            _last[4]  = accel_data[1]; //accel-Y
-            _last[5]  = accel_data[2]; //accel-Z
-	    
+            sample.values[0]  = euler_data[0]; //roll
+            sample.values[1]  = euler_data[1]; //pitch
+            sample.values[2]  = euler_data[2]; //yaw
+
+            sample.values[3]  = accel_data[0]; //accel-X
+            sample.values[4]  = accel_data[1]; //accel-Y
+            sample.values[5]  = accel_data[2]; //accel-Z
+
 			//gyro_data are expressed in rad/s, so they have to be converted in deg/s
-            _last[6]  = gyro_data[0]*CTRL_RAD2DEG;  //gyro-X
-            _last[7]  = gyro_data[1]*CTRL_RAD2DEG;  //gyro-Y
-            _last[8]  = gyro_data[2]*CTRL_RAD2DEG;  //gyro-Z
-	    
-            _last[9]  = magn_data[0];  //magn-X
-            _last[10] = magn_data[1];  //magn-Y
-            _last[11] = magn_data[2];  //magn-Z
-
-            if (received == MTRV_OK)
-                _bError=false;
-            else
-                _bError=true;
-		
-            _lastStamp.update();
+            sample.values[6]  = gyro_data[0]*CTRL_RAD2DEG;  //gyro-X
+            sample.values[7]  = gyro_data[1]*CTRL_RAD2DEG;  //gyro-Y
+            sample.values[8]  = gyro_data[2]*CTRL_RAD2DEG;  //gyro-Z
+
+            sample.values[9]  = magn_data[0];  //magn-X
+            sample.values[10] = magn_data[1];  //magn-Y
+            sample.values[11] = magn_data[2];  //magn-Z
+
+            put(sample);
         }
 }
 
@@ -155,14 +200,15 @@ bool XSensMTx::read(Vector &out)
     
     if (d._bStreamStarted)
         {
-            std::lock_guard<std::mutex> lck(d._semaphore);
-            
+            XSensMTxResources::Sample sample;
+            d.latest(sample);
+
             // Euler+accel+gyro+magn orientation values
             for (int i = 0; i < nchannels; i++)
-                out[i]=d._last[i];
+                out[i]=sample.values[i];
 
-            lastStamp=d._lastStamp;
-            ret=!d._bError;
+            lastStamp=Stamp(sample.count,sample.time);
+            ret=!sample.error;
         }
     else
         ret=false;
@@ -490,12 +536,14 @@ bool XSensMTx::genericGetMeasure(size_t sens_index, yarp::sig::Vector &out, doub
     }
 
     auto &d= RES(system_resources);
+    XSensMTxResources::Sample sample;
+    d.latest(sample);
+
     out.resize(3);
-    std::lock_guard<std::mutex> lck(d._semaphore);
-    out[0] = d._last[startIdx];
-    out[1] = d._last[startIdx + 1];
-    out[2] = d._last[startIdx + 2];
+    out[0] = sample.values[startIdx];
+    out[1] = sample.values[startIdx + 1];
+    out[2] = sample.values[startIdx + 2];
 
-    timestamp = d._lastStamp.getTime();
+    timestamp = sample.time;
     return true;
 }
@@ -0,0 +1,423 @@
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+#ifndef LM_DATASETFILE__
+#define LM_DATASETFILE__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <yarp/sig/Vector.h>
+
+namespace iCub {
+namespace learningmachine {
+namespace dataset {
+
+/**
+ * \ingroup icub_libLM_support
+ *
+ * Binary dataset files, as written by the DatasetRecorder. A file starts with
+ * a Header, which gives the number of input and output columns and their
+ * element type, followed by any number of blocks. A block is a BlockHeader
+ * followed by all the columns of its samples, one after the other (first the
+ * inputs, then the outputs), padded to a multiple of 8 bytes. All the fields
+ * are in the byte order of the machine that wrote the file.
+ */
+
+/**
+ * Element types of the columns.
+ */
+enum { TYPE_FLOAT64 = 1, TYPE_FLOAT32 = 2 };
+
+/**
+ * Version of the format.
+ */
+const uint32_t VERSION = 1;
+
+/**
+ * The signature at the beginning of the file.
+ */
+extern const char MAGIC[8];
+
+/**
+ * The header of a dataset file.
+ */
+struct Header {
+    char     magic[8];
+    uint32_t version;
+    uint32_t inputs;      // number of input columns
+    uint32_t outputs;     // number of output columns
+    uint32_t type;        // element type of all the columns
+    uint32_t blockSize;   // nominal number of samples per block
+    uint32_t reserved;
+};
+
+/**
+ * The header of a block.
+ */
+struct BlockHeader {
+    uint32_t rows;        // number of samples in the block
+    uint32_t reserved;
+};
+
+/**
+ * Returns the size of an element of the given type, or 0 if unknown.
+ *
+ * @param type  the element type
+ * @return  the size in bytes
+ */
+size_t getElementSize(uint32_t type);
+
+/**
+ * Returns the size of a block, including its header and padding.
+ *
+ * @param rows  the number of samples
+ * @param columns  the number of columns
+ * @param type  the element type
+ * @return  the size in bytes
+ */
+size_t getBlockSize(size_t rows, size_t columns, uint32_t type);
+
+/**
+ * Encodes a block of samples, given column by column.
+ *
+ * @param columns  the values, column c of sample r at c * stride + r
+ * @param rows  the number of samples
+ * @param stride  the distance between the columns
+ * @param count  the number of columns
+ * @param type  the element type
+ * @param buffer  the buffer the block is appended to
+ */
+void encodeBlock(const double* columns, size_t rows, size_t stride, size_t count,
+                 uint32_t type, std::vector<char>& buffer);
+
+
+/**
+ * \ingroup icub_libLM_support
+ *
+ * Writes buffers to a file from a background thread, in the order they are
+ * given. A write only waits if several buffers are still pending.
+ */
+class AsyncFileWriter {
+private:
+    /**
+     * The file.
+     */
+    std::ofstream stream;
+
+    /**
+     * The name of the file, for the error messages.
+     */
+    std::string filename;
+
+    /**
+     * The writing thread.
+     */
+    std::thread worker;
+
+    /**
+     * Protects all the members below.
+     */
+    std::mutex mutex;
+
+    /**
+     * Signals changes of the queue.
+     */
+    std::condition_variable changed;
+
+    /**
+     * The buffers that still have to be written.
+     */
+    std::deque<std::vector<char> > queue;
+
+    /**
+     * Written buffers, kept to be reused.
+     */
+    std::vector<std::vector<char> > pool;
+
+    /**
+     * Whether the thread is writing a buffer.
+     */
+    bool busy;
+
+    /**
+     * Whether the thread has to terminate.
+     */
+    bool stop;
+
+    /**
+     * Whether a write has failed.
+     */
+    bool failed;
+
+    /**
+     * The body of the writing thread.
+     */
+    void run();
+
+    /**
+     * Throws if a write has failed; requires the lock.
+     */
+    void checkFailed();
+
+    AsyncFileWriter(const AsyncFileWriter&);
+    AsyncFileWriter& operator=(const AsyncFileWriter&);
+
+public:
+    /**
+     * Maximum number of pending buffers.
+     */
+    static const size_t MAX_PENDING = 8;
+
+    /**
+     * Constructor.
+     */
+    AsyncFileWriter() : busy(false), stop(false), failed(false) { }
+
+    /**
+     * Destructor, writes the pending buffers.
+     */
+    ~AsyncFileWriter();
+
+    /**
+     * Opens a file and starts the writing thread.
+     *
+     * @param name  the filename
+     * @param append  whether to append to an existing file
+     * @exception std::runtime_error the file cannot be opened
+     */
+    void open(const std::string& name, bool append);
+
+    /**
+     * Returns whether a file is open.
+     *
+     * @return true if a file is open
+     */
+    bool isOpen() const {
+        return this->stream.is_open();
+    }
+
+    /**
+     * Queues a buffer. Its content is moved and it is replaced by an empty
+     * buffer with some capacity, if any is available.
+     *
+     * @param buffer  the data to write
+     * @exception std::runtime_error a previous write has failed
+     */
+    void write(std::vector<char>& buffer);
+
+    /**
+     * Waits until all the pending buffers are written.
+     *
+     * @exception std::runtime_error a write has failed
+     */
+    void flush();
+
+    /**
+     * Writes the pending buffers and closes the file.
+     *
+     * @exception std::runtime_error a write has failed
+     */
+    void close();
+};
+
+
+/**
+ * \ingroup icub_libLM_support
+ *
+ * Reads binary dataset files. The file is mapped in memory where possible
+ * (otherwise it is read at once), so that the columns can be used in place.
+ * A truncated block at the end of the file, e.g. after a crash of the writer,
+ * is ignored.
+ */
+class BinaryDatasetReader {
+private:
+    /**
+     * The content of the file.
+     */
+    const char* data;
+
+    /**
+     * The size of the file.
+     */
+    size_t length;
+
+    /**
+     * Whether data is mapped, rather than owned by buffer.
+     */
+    bool mapped;
+
+    /**
+     * The content of the file when it is not mapped.
+     */
+    std::vector<char> buffer;
+
+    /**
+     * The header of the file.
+     */
+    Header header;
+
+    /**
+     * Offsets of the columns of each block.
+     */
+    std::vector<size_t> blockOffsets;
+
+    /**
+     * Index of the first sample of each block, plus the total size.
+     */
+    std::vector<size_t> blockFirst;
+
+    /**
+     * Returns a column of a block.
+     */
+    const char* getColumnData(size_t block, size_t column) const;
+
+    BinaryDatasetReader(const BinaryDatasetReader&);
+    BinaryDatasetReader& operator=(const BinaryDatasetReader&);
+
+public:
+    /**
+     * Constructor.
+     */
+    BinaryDatasetReader();
+
+    /**
+     * Destructor.
+     */
+    ~BinaryDatasetReader();
+
+    /**
+     * Opens a dataset file.
+     *
+     * @param filename  the name of the file
+     * @exception std::runtime_error the file cannot be read or is not a dataset
+     */
+    void open(const std::string& filename);
+
+    /**
+     * Releases the file.
+     */
+    void close();
+
+    /**
+     * Returns the number of samples.
+     *
+     * @return the number of samples
+     */
+    size_t size() const {
+        return this->blockFirst.empty() ? 0 : this->blockFirst.back();
+    }
+
+    /**
+     * Returns the number of input columns.
+     *
+     * @return the input size
+     */
+    unsigned int getInputSize() const {
+        return this->header.inputs;
+    }
+
+    /**
+     * Returns the number of output columns.
+     *
+     * @return the output size
+     */
+    unsigned int getOutputSize() const {
+        return this->header.outputs;
+    }
+
+    /**
+     * Returns the element type of the columns.
+     *
+     * @return TYPE_FLOAT64 or TYPE_FLOAT32
+     */
+    unsigned int getType() const {
+        return this->header.type;
+    }
+
+    /**
+     * Returns the number of blocks.
+     *
+     * @return the number of blocks
+     */
+    size_t getBlockCount() const {
+        return this->blockOffsets.size();
+    }
+
+    /**
+     * Returns the index of the first sample of a block.
+     *
+     * @param block  the index of the block
+     * @return the index of its first sample
+     */
+    size_t getBlockStart(size_t block) const {
+        return this->blockFirst.at(block);
+    }
+
+    /**
+     * Returns the number of samples of a block.
+     *
+     * @param block  the index of the block
+     * @return the number of samples
+     */
+    size_t getBlockRows(size_t block) const {
+        return this->blockFirst.at(block + 1) - this->blockFirst.at(block);
+    }
+
+    /**
+     * Returns a column of a block of a file of type TYPE_FLOAT64, in place.
+     * The inputs come first, then the outputs.
+     *
+     * @param block  the index of the block
+     * @param column  the index of the column
+     * @return a pointer to getBlockRows(block) values
+     * @exception std::runtime_error the type is not TYPE_FLOAT64
+     */
+    const double* getColumn(size_t block, size_t column) const;
+
+    /**
+     * Returns a column of a block of a file of type TYPE_FLOAT32, in place.
+     *
+     * @param block  the index of the block
+     * @param column  the index of the column
+     * @return a pointer to getBlockRows(block) values
+     * @exception std::runtime_error the type is not TYPE_FLOAT32
+     */
+    const float* getColumnFloat32(size_t block, size_t column) const;
+
+    /**
+     * Copies a sample.
+     *
+     * @param index  the index of the sample
+     * @param input  on output, the input of the sample
+     * @param output  on output, the output of the sample
+     * @exception std::out_of_range the index is not below size()
+     */
+    void getSample(size_t index, yarp::sig::Vector& input, yarp::sig::Vector& output) const;
+};
+
+} // dataset
+} // learningmachine
+} // iCub
+
+#endif
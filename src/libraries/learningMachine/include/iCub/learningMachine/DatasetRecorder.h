@@ -19,9 +19,11 @@
 #ifndef LM_DATASETRECORDER__
 #define LM_DATASETRECORDER__
 
-#include <fstream>
+#include <string>
+#include <vector>
 
 #include "iCub/learningMachine/IMachineLearner.h"
+#include "iCub/learningMachine/DatasetFile.h"
 
 
 namespace iCub {
@@ -33,6 +35,13 @@ namespace learningmachine {
  * This 'machine learner' demonstrates how the IMachineLearner interface can
  * be used to easily record samples to a file.
  *
+ * The samples are either written as text, one line per sample, or in the
+ * binary format of iCub::learningmachine::dataset, which can be read back
+ * without parsing by a BinaryDatasetReader. In both cases they are gathered
+ * in blocks and written by a background thread, hence the file is only
+ * complete after a reset (e.g. a change of filename), a flush or the
+ * destruction of the recorder.
+ *
  * \see iCub::contrib::IMachineLearner
  *
  * \author Arjan Gijsberts
@@ -46,25 +55,73 @@ private:
     std::string filename;
 
     /**
-     * The filestream.
+     * The format of the file: text, binary or binary32.
      */
-    std::ofstream stream;
+    std::string format;
+
+    /**
+     * The writer of the file.
+     */
+    dataset::AsyncFileWriter writer;
 
     /**
      * Precision for the serialization of the doubles.
      */
     int precision;
 
+    /**
+     * Number of samples which are gathered before being written.
+     */
+    unsigned int blockSize;
+
     /**
      * Number of recorded samples.
      */
     int sampleCount;
 
+    /**
+     * The text of the samples that have not been written yet.
+     */
+    std::vector<char> pending;
+
+    /**
+     * The binary samples that have not been written yet, column by column.
+     */
+    std::vector<double> block;
+
+    /**
+     * Number of samples in pending or block.
+     */
+    unsigned int blockRows;
+
+    /**
+     * Sizes of the inputs and the outputs of a binary file.
+     */
+    unsigned int inputSize;
+    unsigned int outputSize;
+
+    /**
+     * Opens the file with the first sample.
+     */
+    void open(const yarp::sig::Vector& input, const yarp::sig::Vector& output);
+
+    /**
+     * Hands the gathered samples over to the writer.
+     */
+    void writeBlock();
+
+    /**
+     * Returns the element type of the binary formats.
+     */
+    uint32_t getType() const;
+
 public:
     /**
      * Constructor.
      */
-    DatasetRecorder() : filename("dataset.dat"), precision(8), sampleCount(0) {
+    DatasetRecorder()
+      : filename("dataset.dat"), format("text"), precision(8), blockSize(256),
+        sampleCount(0), blockRows(0), inputSize(0), outputSize(0) {
         this->setName("Recorder");
     }
 
@@ -72,18 +129,15 @@ public:
      * Copy constructor.
      */
     DatasetRecorder(const DatasetRecorder& other)
-      : IMachineLearner(other), filename(other.filename),
-        precision(other.precision), sampleCount(other.sampleCount) {
+      : IMachineLearner(other), filename(other.filename), format(other.format),
+        precision(other.precision), blockSize(other.blockSize),
+        sampleCount(other.sampleCount), blockRows(0), inputSize(0), outputSize(0) {
     }
 
     /**
      * Destructor.
      */
-    virtual ~DatasetRecorder() {
-        if(!this->stream.is_open()) {
-            this->stream.close();
-        }
-    }
+    virtual ~DatasetRecorder();
 
     /**
      * Assignment operator.
@@ -110,10 +164,12 @@ public:
     /*
      * Inherited from IMachineLearner.
      */
-    void reset() {
-        this->stream.close();
-        this->sampleCount = 0;
-    }
+    void reset();
+
+    /**
+     * Writes the gathered samples and waits until they are in the file.
+     */
+    void flush();
 
     /*
      * Inherited from IMachineLearner.
@@ -21,8 +21,10 @@
 
 #include <string>
 #include <sstream>
+#include <stdexcept>
 
 #include <yarp/sig/Vector.h>
+#include <yarp/sig/Matrix.h>
 #include <yarp/os/IConfig.h>
 #include <yarp/os/Portable.h>
 #include <yarp/os/Bottle.h>
@@ -146,6 +148,55 @@ public:
      */
     virtual Prediction predict(const yarp::sig::Vector& input) = 0;
 
+    /**
+     * Provide the learning machine with a batch of examples, one per row. The
+     * default implementation feeds the rows one by one.
+     *
+     * @param inputs the sample inputs
+     * @param outputs the corresponding outputs
+     */
+    virtual void feedSamples(const yarp::sig::Matrix& inputs, const yarp::sig::Matrix& outputs) {
+        if(inputs.rows() != outputs.rows()) {
+            throw std::runtime_error("Number of inputs and outputs do not match");
+        }
+        for(size_t r = 0; r < inputs.rows(); r++) {
+            this->feedSample(inputs.getRow(r), outputs.getRow(r));
+        }
+    }
+
+    /**
+     * Ask the learning machine to predict the outputs for a batch of inputs,
+     * one per row. The default implementation predicts the rows one by one.
+     *
+     * @param inputs the inputs
+     * @param predictions on output, the expected outputs
+     * @param variances on output, the predictive variances, or an empty matrix
+     *                  if the machine does not provide them
+     */
+    virtual void predictSamples(const yarp::sig::Matrix& inputs,
+                                yarp::sig::Matrix& predictions, yarp::sig::Matrix& variances) {
+        predictions.resize(0, 0);
+        variances.resize(0, 0);
+        for(size_t r = 0; r < inputs.rows(); r++) {
+            Prediction prediction = this->predict(inputs.getRow(r));
+            yarp::sig::Vector expected = prediction.getPrediction();
+            if(r == 0) {
+                predictions.resize(inputs.rows(), expected.size());
+                if(prediction.hasVariance()) {
+                    variances.resize(inputs.rows(), expected.size());
+                }
+            }
+            if(expected.size() != predictions.cols() ||
+               prediction.hasVariance() != (variances.rows() > 0)) {
+                throw std::runtime_error("Predictions have inconsistent dimensionality");
+            }
+            predictions.setRow(r, expected);
+            if(prediction.hasVariance()) {
+                variances.setRow(r, prediction.getVariance());
+            }
+        }
+    }
+
     /**
      * Asks the learning machine to return a clone of its type.
      *
@@ -220,6 +271,32 @@ public:
         return true;
     }
 
+    /**
+     * Asks the machine to return a binary serialization, which is much
+     * faster to write and to parse than the string serialization.
+     *
+     * @return a binary serialization of the machine
+     */
+    virtual std::string toBinary() const {
+        yarp::os::Bottle model;
+        this->writeBottle(model);
+        size_t size = 0;
+        const char* data = model.toBinary(&size);
+        return std::string(data, size);
+    }
+
+    /**
+     * Asks the machine to initialize from a binary serialization.
+     *
+     * @return true on succes
+     */
+    virtual bool fromBinary(const std::string& data) {
+        yarp::os::Bottle model;
+        model.fromBinary(data.data(), data.size());
+        this->readBottle(model);
+        return true;
+    }
+
     /**
      * Retrieve the name of this machine learning technique.
      *
@@ -21,11 +21,13 @@
 
 #include <sstream>
 #include <string>
+#include <stdexcept>
 
 #include <yarp/os/IConfig.h>
 #include <yarp/os/Portable.h>
 #include <yarp/os/Bottle.h>
 #include <yarp/sig/Vector.h>
+#include <yarp/sig/Matrix.h>
 
 namespace iCub {
 namespace learningmachine {
@@ -107,6 +109,27 @@ public:
         return yarp::sig::Vector();
     }
 
+    /**
+     * Transforms a batch of input vectors, one per row. The default
+     * implementation transforms the rows one by one.
+     *
+     * @param input the input vectors
+     * @return the output vectors
+     */
+    virtual yarp::sig::Matrix transform(const yarp::sig::Matrix& input) {
+        yarp::sig::Matrix output;
+        for(size_t r = 0; r < input.rows(); r++) {
+            yarp::sig::Vector out = this->transform(input.getRow(r));
+            if(r == 0) {
+                output.resize(input.rows(), out.size());
+            } else if(out.size() != output.cols()) {
+                throw std::runtime_error("Transformed samples have inconsistent dimensionality");
+            }
+            output.setRow(r, out);
+        }
+        return output;
+    }
+
     /**
      * Asks the transformer to return a string containing statistics on its
      * operation so far.
@@ -209,6 +232,32 @@ public:
         return true;
     }
 
+    /**
+     * Asks the transformer to return a binary serialization, which is much
+     * faster to write and to parse than the string serialization.
+     *
+     * @return a binary serialization of the transformer
+     */
+    virtual std::string toBinary() const {
+        yarp::os::Bottle model;
+        this->writeBottle(model);
+        size_t size = 0;
+        const char* data = model.toBinary(&size);
+        return std::string(data, size);
+    }
+
+    /**
+     * Asks the transformer to initialize from a binary serialization.
+     *
+     * @return true on succes
+     */
+    virtual bool fromBinary(const std::string& data) {
+        yarp::os::Bottle model;
+        model.fromBinary(data.data(), data.size());
+        this->readBottle(model);
+        return true;
+    }
+
 };
 
 } // learningmachine
@@ -112,6 +112,10 @@ public:
  * efficiency the hyperparameters are shared among all outputs. Only the RBF
  * kernel function is supported.
  *
+ * Training factorizes the regularized kernel matrix in place (Cholesky, in
+ * blocks and on multiple threads), without inverting it, and derives the
+ * exact Leave-One-Out error from the factorization.
+ *
  * \see iCub::contrib::IMachineLearner
  * \see iCub::contrib::IFixedSizeLearner
  *
@@ -130,6 +134,22 @@ private:
      */
     std::vector<yarp::sig::Vector> outputs;
 
+    /**
+     * The input vectors of the trained model, minus their mean, stored
+     * contiguously on the columns (one row per input dimension).
+     */
+    yarp::sig::Matrix centeredInputs;
+
+    /**
+     * The mean of the input vectors of the trained model.
+     */
+    yarp::sig::Vector inputsMean;
+
+    /**
+     * The squared norms of the columns of centeredInputs.
+     */
+    yarp::sig::Vector inputsNorm;
+
     /**
      * The matrix of Lagrange multipliers, i.e. the coefficients.
      */
@@ -150,11 +170,39 @@ private:
      */
     double C;
 
+    /**
+     * The number of threads used for training and batch predictions, 0 for
+     * all cores.
+     */
+    unsigned int threads;
+
     /**
      * The kernel function.
      */
     RBFKernel* kernel;
 
+    /**
+     * Trains inverting the whole kernel matrix, in case its Cholesky
+     * factorization fails.
+     */
+    void trainLU();
+
+    /**
+     * Stores the input vectors for the kernel expansion.
+     */
+    void buildExpansion();
+
+    /**
+     * Returns the number of threads to use.
+     */
+    unsigned int getThreadCount();
+
+    /**
+     * Predicts the output for one input, using work (as many elements as
+     * the samples plus the inputs) as scratch.
+     */
+    void predictSample(const double* input, double* output, double* work);
+
 
 public:
     /**
@@ -186,6 +234,11 @@ public:
      */
     virtual void feedSample(const yarp::sig::Vector& input, const yarp::sig::Vector& output);
 
+    /*
+     * Inherited from IMachineLearner.
+     */
+    virtual void feedSamples(const yarp::sig::Matrix& inputs, const yarp::sig::Matrix& outputs);
+
     /*
      * Inherited from IMachineLearner.
      */
@@ -196,6 +249,21 @@ public:
      */
     Prediction predict(const yarp::sig::Vector& input);
 
+    /**
+     * Predicts the outputs for many inputs at once, evaluating the kernel
+     * expansions on multiple threads.
+     *
+     * @param input  a matrix with one input on each row
+     * @return  a matrix with the corresponding predicted outputs on its rows
+     */
+    yarp::sig::Matrix predict(const yarp::sig::Matrix& input);
+
+    /*
+     * Inherited from IMachineLearner.
+     */
+    virtual void predictSamples(const yarp::sig::Matrix& inputs,
+                                yarp::sig::Matrix& predictions, yarp::sig::Matrix& variances);
+
     /*
      * Inherited from IMachineLearner.
      */
@@ -219,7 +287,7 @@ public:
     /*
      * Inherited from IMachineLearner.
      */
-    virtual void writeBottle(yarp::os::Bottle& bot);
+    virtual void writeBottle(yarp::os::Bottle& bot) const;
 
     /*
      * Inherited from IMachineLearner.
@@ -259,6 +327,26 @@ public:
         return this->C;
     }
 
+    /**
+     * Mutator for the number of threads used for training and batch
+     * predictions.
+     *
+     * @param threads the new value, 0 for all cores
+     */
+    virtual void setThreads(unsigned int threads) {
+        this->threads = threads;
+    }
+
+    /**
+     * Accessor for the number of threads used for training and batch
+     * predictions.
+     *
+     * @returns the value of the parameter
+     */
+    virtual unsigned int getThreads() {
+        return this->threads;
+    }
+
     /**
      * Accessor for the kernel.
      *
@@ -21,6 +21,8 @@
 
 #include <string>
 #include <vector>
+#include <deque>
+#include <utility>
 
 #include <yarp/sig/Matrix.h>
 
@@ -36,7 +38,14 @@ namespace learningmachine {
  *
  * Standard linear Bayesian regression or, equivalently, Gaussian Process
  * Regression with a linear covariance function. It uses a rank 1 update rule to
- * incrementally update the Cholesky factor of the covariance matrix.
+ * incrementally update the Cholesky factor of the covariance matrix, and
+ * corrects the weights along the gain obtained from the updated factor, so
+ * that each sample costs O(d^2) regardless of the number of outputs.
+ *
+ * For long running online use, the influence of past samples can be bounded:
+ * with a sliding window only the last samples are used, the oldest one being
+ * removed by a rank 1 downdate, whereas a forgetting factor discounts the
+ * past samples (and the prior) exponentially.
  *
  * See:
  * Gaussian Processes for Machine Learning.
@@ -83,6 +92,41 @@ private:
      */
     int sampleCount;
 
+    /**
+     * Maximum number of samples in the sliding window, 0 for no window.
+     */
+    unsigned int windowSize;
+
+    /**
+     * Forgetting factor.
+     */
+    double forgettingFactor;
+
+    /**
+     * The samples in the sliding window, oldest first.
+     */
+    std::deque< std::pair<yarp::sig::Vector, yarp::sig::Vector> > window;
+
+    /**
+     * Number of samples since the weights were last recomputed from B.
+     */
+    unsigned int sinceRefresh;
+
+    /**
+     * Adds a weighted sample to the factor, to B and to the weights.
+     *
+     * @param input the input of the sample
+     * @param output the output of the sample
+     * @param weight the weight of the sample, negative to remove it
+     */
+    void updateSample(const yarp::sig::Vector& input, const yarp::sig::Vector& output, double weight);
+
+    /**
+     * Recomputes the factor and the weights from the prior and the samples in
+     * the window.
+     */
+    void rebuild();
+
 public:
     /**
      * Constructor.
@@ -148,7 +192,7 @@ public:
     /*
      * Inherited from IMachineLearner.
      */
-    virtual void writeBottle(yarp::os::Bottle& bot);
+    virtual void writeBottle(yarp::os::Bottle& bot) const;
 
     /*
      * Inherited from IMachineLearner.
@@ -180,6 +224,38 @@ public:
      */
     double getSigma();
 
+    /**
+     * Sets the size of the sliding window, i.e. the number of most recent
+     * samples that are used. This resets the machine.
+     *
+     * @param size the desired size, 0 to use all the samples.
+     */
+    void setWindowSize(unsigned int size);
+
+    /**
+     * Accessor for the size of the sliding window.
+     *
+     * @returns the value of the parameter
+     */
+    unsigned int getWindowSize();
+
+    /**
+     * Sets the forgetting factor, i.e. the weight of the past samples with
+     * respect to a new one. The default 1 weighs all the samples equally,
+     * whereas e.g. 0.99 tracks changes over about 100 samples (as the prior
+     * fades too). This resets the machine.
+     *
+     * @param f the desired value, in (0, 1].
+     */
+    void setForgettingFactor(double f);
+
+    /**
+     * Accessor for the forgetting factor.
+     *
+     * @returns the value of the parameter
+     */
+    double getForgettingFactor();
+
     /*
      * Inherited from IConfig.
      */
@@ -19,6 +19,8 @@
 #ifndef LM_MATH__
 #define LM_MATH__
 
+#include <cstddef>
+
 #include <gsl/gsl_linalg.h>
 
 #include <yarp/sig/Matrix.h>
@@ -73,6 +75,25 @@ void dchud(double* r, int ldr, int p, double* x, double* z, int ldz, int nz,
            double* y, double* rho, double* c, double* s,
            unsigned char rtrans = 0, unsigned char ztrans = 0);
 
+/*
+ * Rank-1 downdate of a Cholesky factor
+ *
+ * Input:
+ *   r: upper triangular cholesky factor (ldr x p, typically ldr == p)
+ *   x: downdate vector
+ * Output:
+ *   r: downdated cholesky factor, unchanged on failure
+ *   c: cosines of performed rotations
+ *   s: sines of performed rotations
+ * Returns:
+ *   0 on success, -1 if the downdated matrix is not positive definite
+ *
+ * Note: Follows LINPACKs' dchdd without the additional vectors z; accepts a
+ * transposed Cholesky factor R (non-transposed is faster).
+ */
+int dchdd(double* r, int ldr, int p, double* x, double* c, double* s,
+          unsigned char rtrans = 0);
+
 /*
  * GSL type wrapper function for C implementation of dchud.
  */
@@ -111,6 +132,20 @@ void cholupdate(yarp::sig::Matrix& R, const yarp::sig::Vector& x, yarp::sig::Vec
  */
 void cholupdate(yarp::sig::Matrix& R, const yarp::sig::Vector& x, bool rtrans = 0);
 
+/**
+ * Perform a rank-1 downdate to a Cholesky factor, i.e. remove x*x' from the
+ * factorized matrix.
+ *
+ * For more information, please see chapter 10.3 of the LINPACK User's Guide.
+ *
+ * @param R  an upper triangular Cholesky factor
+ * @param x  the vector used to downdate the Cholesky factor
+ * @param rtrans  flag indicating whether R is provided transposed
+ * @exception std::runtime_error the downdated matrix is not positive definite,
+ *                               in which case R is left unchanged
+ */
+void choldowndate(yarp::sig::Matrix& R, const yarp::sig::Vector& x, bool rtrans = 0);
+
 /**
  * Solves a system A*x=b for multiple row vectors in B using a precomputed
  * Cholesky factor R.
@@ -367,6 +402,28 @@ yarp::sig::Vector cosvec(const yarp::sig::Vector& v);
  */
 yarp::sig::Vector sinvec(const yarp::sig::Vector& v);
 
+/**
+ * Computes the sine and the cosine of an array element-wise. The arguments are
+ * reduced to [-pi, pi] and evaluated by polynomials without branches, so that
+ * the loop can be vectorized by the compiler; arguments larger than 1e6 in
+ * magnitude fall back to the standard functions.
+ *
+ * @param v  the array of arguments
+ * @param s  on output, the sines (must not overlap with v)
+ * @param c  on output, the cosines (must not overlap with v or s)
+ * @param n  the number of elements
+ */
+void sincosvec(const double* v, double* s, double* c, size_t n);
+
+/**
+ * Computes the cosine of an array element-wise, as sincosvec.
+ *
+ * @param v  the array of arguments
+ * @param c  on output, the cosines (must not overlap with v)
+ * @param n  the number of elements
+ */
+void cosvec(const double* v, double* c, size_t n);
+
 } // math
 } // learningmachine
 } // iCub
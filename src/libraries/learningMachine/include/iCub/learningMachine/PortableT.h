@@ -23,6 +23,7 @@
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <iterator>
 
 #include <yarp/os/Portable.h>
 #include <yarp/os/Bottle.h>
@@ -32,6 +33,11 @@
 namespace iCub {
 namespace learningmachine {
 
+/**
+ * The first line of a file written by PortableT in the binary format.
+ */
+const std::string BINARY_MODEL_SIGNATURE = "LMBINARY";
+
 /**
  * A templated portable class intended to wrap abstract base classes. This
  * template depends on an associated FactoryT for the specified type.
@@ -153,20 +159,30 @@ public:
     }
 
     /**
-     * Writes a wrapped object to a file.
+     * Writes a wrapped object to a file. The binary format is much faster to
+     * write and to load than the text format, but it depends on the byte order
+     * of the machine.
      *
      * @param filename the filename
+     * @param binary whether to use the binary format
      * @return true on success
      */
-    bool writeToFile(std::string filename) {
-        std::ofstream stream(filename.c_str());
+    bool writeToFile(std::string filename, bool binary = true) {
+        std::ofstream stream(filename.c_str(), std::ios_base::out | std::ios_base::binary);
 
         if(!stream.is_open()) {
             throw std::runtime_error(std::string("Could not open file '") + filename + "'");
         }
 
-        stream << this->getWrapped().getName() << std::endl;
-        stream << this->getWrapped().toString();
+        if(binary) {
+            std::string data = this->getWrapped().toBinary();
+            stream << BINARY_MODEL_SIGNATURE << std::endl;
+            stream << this->getWrapped().getName() << std::endl;
+            stream.write(data.data(), data.size());
+        } else {
+            stream << this->getWrapped().getName() << std::endl;
+            stream << this->getWrapped().toString();
+        }
 
         stream.close();
 
@@ -174,13 +190,14 @@ public:
     }
 
     /**
-     * Reads a wrapped object from a file.
+     * Reads a wrapped object from a file, in either the binary or the text
+     * format.
      *
      * @param filename the filename
      * @return true on success
      */
     bool readFromFile(std::string filename) {
-        std::ifstream stream(filename.c_str());
+        std::ifstream stream(filename.c_str(), std::ios_base::in | std::ios_base::binary);
 
         if(!stream.is_open()) {
             throw std::runtime_error(std::string("Could not open file '") + filename + "'");
@@ -189,10 +206,22 @@ public:
         std::string name;
         stream >> name;
 
+        bool binary = (name == BINARY_MODEL_SIGNATURE);
+        if(binary) {
+            stream >> name;
+        }
+
         this->setWrapped(name);
-        std::stringstream strstr;
-        strstr << stream.rdbuf();
-        this->getWrapped().fromString(strstr.str());
+        if(binary) {
+            // skip the end of line after the name
+            stream.get();
+            std::string data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+            this->getWrapped().fromBinary(data);
+        } else {
+            std::stringstream strstr;
+            strstr << stream.rdbuf();
+            this->getWrapped().fromString(strstr.str());
+        }
 
         return true;
     }
@@ -33,7 +33,10 @@ namespace learningmachine {
  *
  * Recursive Regularized Least Squares (a.k.a. ridge regression) learner. It
  * uses a rank 1 update rule to update the Cholesky factor of the covariance
- * matrix.
+ * matrix. The weights are then corrected by the prediction error along the
+ * gain obtained from the updated factor, so that each sample costs O(d^2)
+ * regardless of the number of outputs, without allocations. Past samples can
+ * be discounted by a forgetting factor.
  *
  * \see iCub::learningmachine::IMachineLearner
  * \see iCub::learningmachine::IFixedSizeLearner
@@ -60,6 +63,16 @@ private:
      */
     yarp::sig::Matrix W;
 
+    /**
+     * Scratch vector for the updates.
+     */
+    yarp::sig::Vector work;
+
+    /**
+     * The gain of the last update.
+     */
+    yarp::sig::Vector gain;
+
     /**
      * Number of samples during last training routine
      */
@@ -70,6 +83,11 @@ private:
      */
     double lambda;
 
+    /**
+     * Forgetting factor.
+     */
+    double forgettingFactor;
+
 public:
     /**
      * Constructor.
@@ -135,7 +153,7 @@ public:
     /*
      * Inherited from IMachineLearner.
      */
-    virtual void writeBottle(yarp::os::Bottle& bot);
+    virtual void writeBottle(yarp::os::Bottle& bot) const;
 
     /*
      * Inherited from IMachineLearner.
@@ -167,6 +185,23 @@ public:
      */
     double getLambda();
 
+    /**
+     * Sets the forgetting factor, i.e. the weight of the past samples with
+     * respect to a new one. The default 1 weighs all the samples equally,
+     * whereas e.g. 0.99 tracks changes over about 100 samples (as the
+     * regularization fades too).
+     *
+     * @param f the desired value, in (0, 1].
+     */
+    void setForgettingFactor(double f);
+
+    /**
+     * Accessor for the forgetting factor.
+     *
+     * @returns the value of the parameter
+     */
+    double getForgettingFactor();
+
     /*
      * Inherited from IConfig.
      */
@@ -86,7 +86,7 @@ protected:
     /*
      * Inherited from ITransformer.
      */
-    virtual void writeBottle(yarp::os::Bottle& bot);
+    virtual void writeBottle(yarp::os::Bottle& bot) const;
 
     /*
      * Inherited from ITransformer.
@@ -89,7 +89,8 @@ yarp::os::Bottle& operator<<(yarp::os::Bottle &out, double val);
 
 /**
  * Pushes a serialization of a vector to the end of a Bottle using the insertion
- * operator.
+ * operator. The elements are written as a single binary blob, followed by the
+ * size.
  *
  * @param bot  a reference to the bottle
  * @param v  a reference to the vector
@@ -99,7 +100,8 @@ yarp::os::Bottle& operator<<(yarp::os::Bottle &out, const yarp::sig::Vector& v);
 
 /**
  * Pushes a serialization of a matrix to the end of a Bottle using the insertion
- * operator.
+ * operator. The elements are written in row-major order as a single binary
+ * blob, followed by the number of rows and columns.
  *
  * @param bot  a reference to the bottle
  * @param M  a reference to the matrix
@@ -127,7 +129,8 @@ yarp::os::Bottle& operator>>(yarp::os::Bottle &in, double& val);
 
 /**
  * Pops a deserialization of a vector from the end of a Bottle using the
- * extraction operator.
+ * extraction operator. Vectors serialized element by element, as done by
+ * earlier versions, are read as well.
  *
  * @param bot  a reference to the bottle
  * @param v  a reference to the vector
@@ -137,7 +140,8 @@ yarp::os::Bottle& operator>>(yarp::os::Bottle &in, yarp::sig::Vector& v);
 
 /**
  * Pops a deserialization of a matrix from the end of a Bottle using the
- * extraction operator.
+ * extraction operator. Matrices serialized element by element, as done by
+ * earlier versions, are read as well.
  *
  * @param bot  a reference to the bottle
  * @param M  a reference to the matrix
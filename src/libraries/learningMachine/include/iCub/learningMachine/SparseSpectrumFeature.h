@@ -62,10 +62,23 @@ protected:
      */
     yarp::sig::Matrix W;
 
+    /**
+     * Transpose of W, so that a projection is built by contiguous updates.
+     */
+    yarp::sig::Matrix Wt;
+
+    /**
+     * Writes the features of a sample into caller storage.
+     *
+     * @param input  the input sample (domain size)
+     * @param output  the features (codomain size)
+     */
+    void transformSample(const double* input, double* output) const;
+
     /*
      * Inherited from ITransformer.
      */
-    virtual void writeBottle(yarp::os::Bottle& bot);
+    virtual void writeBottle(yarp::os::Bottle& bot) const;
 
     /*
      * Inherited from ITransformer.
@@ -101,6 +114,23 @@ public:
      */
     virtual yarp::sig::Vector transform(const yarp::sig::Vector& input);
 
+    /**
+     * Transforms an input vector into an output vector, which is only
+     * resized if it does not have the size of the codomain yet.
+     *
+     * @param input  the input vector
+     * @param output  the output vector
+     */
+    void transform(const yarp::sig::Vector& input, yarp::sig::Vector& output);
+
+    /**
+     * Transforms many inputs at once.
+     *
+     * @param input  a matrix with one input on each row
+     * @return  a matrix with the corresponding outputs on its rows
+     */
+    virtual yarp::sig::Matrix transform(const yarp::sig::Matrix& input);
+
     /*
      * Inherited from ITransformer.
      */
@@ -0,0 +1,332 @@
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+
+// the files are mapped with mmap(), which is available on posix systems only
+#if defined(__unix__) || defined(__APPLE__)
+#define LM_DATASETFILE_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "iCub/learningMachine/DatasetFile.h"
+
+namespace iCub {
+namespace learningmachine {
+namespace dataset {
+
+const char MAGIC[8] = {'L', 'M', 'D', 'A', 'T', 'A', 'S', 'T'};
+
+static_assert(sizeof(Header) == 32, "the header of a dataset file must have no padding");
+static_assert(sizeof(BlockHeader) == 8, "the header of a block must have no padding");
+
+size_t getElementSize(uint32_t type) {
+    switch(type) {
+        case TYPE_FLOAT64:
+            return sizeof(double);
+        case TYPE_FLOAT32:
+            return sizeof(float);
+        default:
+            return 0;
+    }
+}
+
+size_t getBlockSize(size_t rows, size_t columns, uint32_t type) {
+    size_t payload = rows * columns * getElementSize(type);
+    return sizeof(BlockHeader) + ((payload + 7) & ~(size_t)7);
+}
+
+void encodeBlock(const double* columns, size_t rows, size_t stride, size_t count,
+                 uint32_t type, std::vector<char>& buffer) {
+    size_t start = buffer.size();
+    buffer.resize(start + getBlockSize(rows, count, type), 0);
+    char* p = &buffer[start];
+
+    BlockHeader h;
+    h.rows = (uint32_t) rows;
+    h.reserved = 0;
+    std::memcpy(p, &h, sizeof(h));
+    p += sizeof(h);
+
+    for(size_t c = 0; c < count; c++) {
+        const double* column = columns + c * stride;
+        if(type == TYPE_FLOAT64) {
+            std::memcpy(p, column, rows * sizeof(double));
+            p += rows * sizeof(double);
+        } else {
+            for(size_t r = 0; r < rows; r++, p += sizeof(float)) {
+                float v = (float) column[r];
+                std::memcpy(p, &v, sizeof(v));
+            }
+        }
+    }
+}
+
+
+AsyncFileWriter::~AsyncFileWriter() {
+    try {
+        this->close();
+    } catch(const std::exception&) {
+        // a destructor cannot report the failure
+    }
+}
+
+void AsyncFileWriter::open(const std::string& name, bool append) {
+    this->close();
+
+    std::ios_base::openmode mode = std::ios_base::out | std::ios_base::binary;
+    mode |= append ? std::ios_base::app : std::ios_base::trunc;
+    this->stream.open(name.c_str(), mode);
+    if(!this->stream.is_open()) {
+        throw std::runtime_error(std::string("could not open file '" + name + "'"));
+    }
+    this->filename = name;
+    this->busy = false;
+    this->stop = false;
+    this->failed = false;
+    this->worker = std::thread(&AsyncFileWriter::run, this);
+}
+
+void AsyncFileWriter::run() {
+    std::unique_lock<std::mutex> lock(this->mutex);
+    for(;;) {
+        this->changed.wait(lock, [this] { return this->stop || !this->queue.empty(); });
+        if(this->queue.empty()) {
+            // stopping, and everything has been written
+            break;
+        }
+
+        std::vector<char> buffer;
+        buffer.swap(this->queue.front());
+        this->queue.pop_front();
+        this->busy = true;
+        bool last = this->queue.empty();
+        lock.unlock();
+
+        bool ok = true;
+        if(!buffer.empty()) {
+            ok = (bool) this->stream.write(&buffer[0], buffer.size());
+        }
+        if(last) {
+            // nothing else to merge the system call with
+            ok = ok && (bool) this->stream.flush();
+        }
+
+        lock.lock();
+        this->busy = false;
+        this->failed = this->failed || !ok;
+        buffer.clear();
+        if(this->pool.size() < MAX_PENDING) {
+            this->pool.push_back(std::vector<char>());
+            this->pool.back().swap(buffer);
+        }
+        this->changed.notify_all();
+    }
+}
+
+void AsyncFileWriter::checkFailed() {
+    if(this->failed) {
+        this->failed = false;
+        throw std::runtime_error(std::string("could not write to file '" + this->filename + "'"));
+    }
+}
+
+void AsyncFileWriter::write(std::vector<char>& buffer) {
+    if(!this->isOpen()) {
+        throw std::runtime_error("no file opened.");
+    }
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->checkFailed();
+    this->changed.wait(lock, [this] { return this->queue.size() < MAX_PENDING; });
+
+    this->queue.push_back(std::vector<char>());
+    this->queue.back().swap(buffer);
+    if(!this->pool.empty()) {
+        buffer.swap(this->pool.back());
+        this->pool.pop_back();
+    }
+    this->changed.notify_all();
+}
+
+void AsyncFileWriter::flush() {
+    if(!this->isOpen()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->changed.wait(lock, [this] { return this->queue.empty() && !this->busy; });
+    this->checkFailed();
+}
+
+void AsyncFileWriter::close() {
+    if(!this->isOpen()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stop = true;
+        this->changed.notify_all();
+    }
+    this->worker.join();
+    this->stream.close();
+    this->checkFailed();
+}
+
+
+BinaryDatasetReader::BinaryDatasetReader() : data((const char*) 0x0), length(0), mapped(false) {
+    this->close();
+}
+
+BinaryDatasetReader::~BinaryDatasetReader() {
+    this->close();
+}
+
+void BinaryDatasetReader::close() {
+#ifdef LM_DATASETFILE_USE_MMAP
+    if(this->mapped) {
+        munmap(const_cast<char*>(this->data), this->length);
+    }
+#endif
+    this->data = (const char*) 0x0;
+    this->length = 0;
+    this->mapped = false;
+    std::vector<char>().swap(this->buffer);
+    std::memset(&this->header, 0, sizeof(this->header));
+    this->blockOffsets.clear();
+    this->blockFirst.assign(1, 0);
+}
+
+void BinaryDatasetReader::open(const std::string& filename) {
+    this->close();
+
+#ifdef LM_DATASETFILE_USE_MMAP
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if(fd < 0) {
+        throw std::runtime_error(std::string("could not open file '" + filename + "'"));
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error(std::string("could not open file '" + filename + "'"));
+    }
+    if(st.st_size > 0) {
+        void* m = mmap(0x0, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(m != MAP_FAILED) {
+            this->data = static_cast<const char*>(m);
+            this->length = (size_t) st.st_size;
+            this->mapped = true;
+        }
+    }
+    ::close(fd);
+#endif
+
+    if(!this->mapped) {
+        std::ifstream f(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+        if(!f.is_open()) {
+            throw std::runtime_error(std::string("could not open file '" + filename + "'"));
+        }
+        this->buffer.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        this->data = this->buffer.empty() ? (const char*) 0x0 : &this->buffer[0];
+        this->length = this->buffer.size();
+    }
+
+    if(this->length < sizeof(Header)) {
+        this->close();
+        throw std::runtime_error(std::string("file '" + filename + "' is not a dataset"));
+    }
+    std::memcpy(&this->header, this->data, sizeof(Header));
+    size_t columns = (size_t) this->header.inputs + this->header.outputs;
+    if(std::memcmp(this->header.magic, MAGIC, sizeof(MAGIC)) != 0 || this->header.version != VERSION ||
+       getElementSize(this->header.type) == 0) {
+        this->close();
+        throw std::runtime_error(std::string("file '" + filename + "' is not a dataset"));
+    }
+
+    // index the blocks, stopping at the first one which is incomplete
+    size_t offset = sizeof(Header);
+    while(offset + sizeof(BlockHeader) <= this->length) {
+        BlockHeader h;
+        std::memcpy(&h, this->data + offset, sizeof(h));
+        size_t rowSize = columns * getElementSize(this->header.type);
+        if(rowSize > 0 && h.rows > (this->length - offset) / rowSize) {
+            break;
+        }
+        size_t size = getBlockSize(h.rows, columns, this->header.type);
+        if(size > this->length - offset) {
+            break;
+        }
+        this->blockOffsets.push_back(offset + sizeof(BlockHeader));
+        this->blockFirst.push_back(this->blockFirst.back() + h.rows);
+        offset += size;
+    }
+}
+
+const char* BinaryDatasetReader::getColumnData(size_t block, size_t column) const {
+    if(column >= (size_t) this->header.inputs + this->header.outputs) {
+        throw std::out_of_range("column out of range");
+    }
+    return this->data + this->blockOffsets.at(block) +
+           column * this->getBlockRows(block) * getElementSize(this->header.type);
+}
+
+const double* BinaryDatasetReader::getColumn(size_t block, size_t column) const {
+    if(this->header.type != TYPE_FLOAT64) {
+        throw std::runtime_error("dataset does not contain doubles");
+    }
+    return reinterpret_cast<const double*>(this->getColumnData(block, column));
+}
+
+const float* BinaryDatasetReader::getColumnFloat32(size_t block, size_t column) const {
+    if(this->header.type != TYPE_FLOAT32) {
+        throw std::runtime_error("dataset does not contain floats");
+    }
+    return reinterpret_cast<const float*>(this->getColumnData(block, column));
+}
+
+void BinaryDatasetReader::getSample(size_t index, yarp::sig::Vector& input, yarp::sig::Vector& output) const {
+    if(index >= this->size()) {
+        throw std::out_of_range("sample out of range");
+    }
+    size_t block = std::upper_bound(this->blockFirst.begin(), this->blockFirst.end(), index) -
+                   this->blockFirst.begin() - 1;
+    size_t row = index - this->blockFirst[block];
+
+    input.resize(this->header.inputs);
+    output.resize(this->header.outputs);
+    size_t columns = (size_t) this->header.inputs + this->header.outputs;
+    for(size_t c = 0; c < columns; c++) {
+        double v;
+        if(this->header.type == TYPE_FLOAT64) {
+            v = this->getColumn(block, c)[row];
+        } else {
+            v = this->getColumnFloat32(block, c)[row];
+        }
+        if(c < this->header.inputs) {
+            input[c] = v;
+        } else {
+            output[c - this->header.inputs] = v;
+        }
+    }
+}
+
+} // dataset
+} // learningmachine
+} // iCub
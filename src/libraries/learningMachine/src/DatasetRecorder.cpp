@@ -16,52 +16,157 @@
  * Public License for more details
  */
 
-#include <iomanip>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <sstream>
+#include <stdexcept>
 
 #include "iCub/learningMachine/DatasetRecorder.h"
 
 namespace iCub {
 namespace learningmachine {
 
+DatasetRecorder::~DatasetRecorder() {
+    try {
+        this->reset();
+    } catch(const std::exception&) {
+        // a destructor cannot report the failure
+    }
+}
+
 DatasetRecorder& DatasetRecorder::operator=(const DatasetRecorder& other) {
     if(this == &other) return *this; // handle self initialization
 
     this->IMachineLearner::operator=(other);
+    this->reset();
     this->filename = other.filename;
+    this->format = other.format;
     this->precision = other.precision;
+    this->blockSize = other.blockSize;
     this->sampleCount = other.sampleCount;
 
     return *this;
 }
 
+uint32_t DatasetRecorder::getType() const {
+    return (this->format == "binary32") ? dataset::TYPE_FLOAT32 : dataset::TYPE_FLOAT64;
+}
 
-void DatasetRecorder::feedSample(const yarp::sig::Vector& input, const yarp::sig::Vector& output) {
-    // open stream if not opened yet
-    if(!this->stream.is_open()) {
-        // perhaps check if file already exists
-        this->stream.open(this->filename.c_str(), std::ios_base::out | std::ios_base::app);
-        // set precision
-        this->stream.precision(this->precision);
+void DatasetRecorder::open(const yarp::sig::Vector& input, const yarp::sig::Vector& output) {
+    // text files are simply appended to
+    if(this->format == "text") {
+        this->writer.open(this->filename, true);
+        return;
     }
 
-    // first write inputs
-    for(size_t i = 0; i < input.size(); i++) {
-        if(i > 0) this->stream << " ";
-        this->stream << std::setw(this->precision + 4) << input[i];
+    // binary files are appended to only if they have the same layout
+    dataset::Header h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, dataset::MAGIC, sizeof(h.magic));
+    h.version = dataset::VERSION;
+    h.inputs = (uint32_t) input.size();
+    h.outputs = (uint32_t) output.size();
+    h.type = this->getType();
+    h.blockSize = this->blockSize;
+
+    std::ifstream existing(this->filename.c_str(), std::ios_base::in | std::ios_base::binary);
+    dataset::Header e;
+    bool append = false;
+    if(existing.is_open() && existing.read(reinterpret_cast<char*>(&e), sizeof(e))) {
+        if(std::memcmp(e.magic, h.magic, sizeof(h.magic)) != 0 || e.version != h.version ||
+           e.inputs != h.inputs || e.outputs != h.outputs || e.type != h.type) {
+            throw std::runtime_error(std::string("file '" + this->filename + "' contains a different dataset"));
+        }
+        append = true;
+    }
+    existing.close();
+
+    this->writer.open(this->filename, append);
+    this->inputSize = h.inputs;
+    this->outputSize = h.outputs;
+    this->block.resize((size_t) this->blockSize * (this->inputSize + this->outputSize));
+    if(!append) {
+        this->pending.resize(sizeof(h));
+        std::memcpy(&this->pending[0], &h, sizeof(h));
+        this->writer.write(this->pending);
+        this->pending.clear();
+    }
+}
+
+void DatasetRecorder::writeBlock() {
+    if(this->blockRows == 0) {
+        return;
+    }
+    if(this->format != "text") {
+        dataset::encodeBlock(&this->block[0], this->blockRows, this->blockSize,
+                             this->inputSize + this->outputSize, this->getType(), this->pending);
+    }
+    this->writer.write(this->pending);
+    this->pending.clear();
+    this->blockRows = 0;
+}
+
+void DatasetRecorder::feedSample(const yarp::sig::Vector& input, const yarp::sig::Vector& output) {
+    // open file if not opened yet
+    if(!this->writer.isOpen()) {
+        this->open(input, output);
     }
-    this->stream << "  ";
 
-    // then write outputs
-    for(size_t i = 0; i < output.size(); i++) {
-        if(i > 0) this->stream << " ";
-        this->stream << std::setw(this->precision + 4) << output[i] << " ";
+    if(this->format == "text") {
+        // same as setw(precision + 4) on a stream with the given precision
+        int width = this->precision + 4;
+        char value[64];
+
+        // first write inputs
+        for(size_t i = 0; i < input.size(); i++) {
+            int n = std::snprintf(value, sizeof(value), (i > 0) ? " %*.*g" : "%*.*g", width, this->precision, input[i]);
+            this->pending.insert(this->pending.end(), value, value + std::min<size_t>(n, sizeof(value) - 1));
+        }
+        this->pending.push_back(' ');
+        this->pending.push_back(' ');
+
+        // then write outputs
+        for(size_t i = 0; i < output.size(); i++) {
+            int n = std::snprintf(value, sizeof(value), (i > 0) ? " %*.*g " : "%*.*g ", width, this->precision, output[i]);
+            this->pending.insert(this->pending.end(), value, value + std::min<size_t>(n, sizeof(value) - 1));
+        }
+        this->pending.push_back('\n');
+    } else {
+        if(input.size() != this->inputSize || output.size() != this->outputSize) {
+            throw std::runtime_error("Sample has a different dimensionality than the dataset");
+        }
+        double* column = &this->block[this->blockRows];
+        for(size_t i = 0; i < input.size(); i++, column += this->blockSize) {
+            *column = input[i];
+        }
+        for(size_t i = 0; i < output.size(); i++, column += this->blockSize) {
+            *column = output[i];
+        }
     }
     this->sampleCount++;
 
-    this->stream << std::endl;
+    if(++this->blockRows >= this->blockSize) {
+        this->writeBlock();
+    }
+}
 
-    this->stream.flush();
+void DatasetRecorder::flush() {
+    if(this->writer.isOpen()) {
+        this->writeBlock();
+        this->writer.flush();
+    }
+}
+
+void DatasetRecorder::reset() {
+    if(this->writer.isOpen()) {
+        this->writeBlock();
+    }
+    this->pending.clear();
+    this->blockRows = 0;
+    this->sampleCount = 0;
+    this->writer.close();
 }
 
 
@@ -69,7 +174,9 @@ std::string DatasetRecorder::getInfo() {
     std::ostringstream buffer;
     buffer << this->IMachineLearner::getInfo();
     buffer << "Filename: " << this->filename << std::endl;
+    buffer << "Format: " << this->format << std::endl;
     buffer << "Precision: " << this->precision << std::endl;
+    buffer << "Block Size: " << this->blockSize << std::endl;
     buffer << "Sample Count: " << this->sampleCount << std::endl;
     return buffer.str();
 }
@@ -77,9 +184,13 @@ std::string DatasetRecorder::getInfo() {
 void DatasetRecorder::writeBottle(yarp::os::Bottle& bot) const  {
     bot.addString(this->filename.c_str());
     bot.addInt32(this->precision);
+    bot.addString(this->format.c_str());
+    bot.addInt32(this->blockSize);
 }
 
 void DatasetRecorder::readBottle(yarp::os::Bottle& bot) {
+    this->blockSize = bot.pop().asInt32();
+    this->format = bot.pop().asString().c_str();
     this->precision = bot.pop().asInt32();
     this->filename = bot.pop().asString().c_str();
 }
@@ -89,6 +200,8 @@ std::string DatasetRecorder::getConfigHelp() {
     buffer << this->IMachineLearner::getConfigHelp();
     buffer << "  filename name         Filename to write to" << std::endl;
     buffer << "  precision n           Number of digits precision for doubles" << std::endl;
+    buffer << "  format fmt            File format (text|binary|binary32)" << std::endl;
+    buffer << "  blocksize n           Number of samples written at once" << std::endl;
     return buffer.str();
 }
 
@@ -108,6 +221,27 @@ bool DatasetRecorder::configure(yarp::os::Searchable& config) {
         success = true;
     }
 
+    // set the format
+    if(config.find("format").isString()) {
+        std::string fmt = config.find("format").asString();
+        if(fmt != "text" && fmt != "binary" && fmt != "binary32") {
+            throw std::runtime_error("Unknown dataset format: " + fmt);
+        }
+        this->reset();
+        this->format = fmt;
+        success = true;
+    }
+
+    // set the block size
+    if(config.find("blocksize").isInt32()) {
+        if(config.find("blocksize").asInt32() < 1) {
+            throw std::runtime_error("Block size has to be positive");
+        }
+        this->reset();
+        this->blockSize = config.find("blocksize").asInt32();
+        success = true;
+    }
+
     return success;
 }
 
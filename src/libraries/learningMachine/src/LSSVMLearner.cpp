@@ -19,6 +19,11 @@
 #include <cassert>
 #include <sstream>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include <yarp/math/Math.h>
 #include <yarp/math/SVD.h>
@@ -32,6 +37,341 @@ using namespace iCub::learningmachine::serialization;
 namespace iCub {
 namespace learningmachine {
 
+/*
+ * The training works on the lower triangle of the (symmetric) kernel matrix,
+ * packed by rows: row i starts at i*(i+1)/2 and holds the columns 0..i.
+ */
+static inline double* packedRow(double* H, size_t i) {
+    return H + i * (i + 1) / 2;
+}
+
+static inline const double* packedRow(const double* H, size_t i) {
+    return H + i * (i + 1) / 2;
+}
+
+/*
+ * Runs work(item) for item = 0..items-1, pulling the items from a shared
+ * counter so that uneven items are balanced among the threads.
+ */
+template<class F>
+static void parallelFor(size_t items, unsigned int threads, const F& work) {
+    threads = std::max(1u, std::min(threads, (unsigned int)items));
+    if(threads == 1) {
+        for(size_t item = 0; item < items; item++) {
+            work(item);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next(0);
+    auto worker = [&]() {
+        for(size_t item = next++; item < items; item = next++) {
+            work(item);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for(unsigned int t = 1; t < threads; t++) {
+        workers.push_back(std::thread(worker));
+    }
+    worker();
+    for(auto& w : workers) {
+        w.join();
+    }
+}
+
+/*
+ * Evaluates the RBF kernel between x and the first n samples of ST, which
+ * holds the samples on its columns (d rows, stride ld), as
+ * exp(-gamma*(|x|^2 + |s_j|^2 - 2*x's_j)) given the squared norms. The dot
+ * products are accumulated along the rows of ST, so that they vectorize.
+ */
+static void rbfExpansion(const double* ST, size_t ld, const double* norms, size_t n, size_t d,
+                         const double* x, double xnorm, double gamma, double* k) {
+    for(size_t j = 0; j < n; j++) {
+        k[j] = 0.0;
+    }
+    for(size_t t = 0; t < d; t++) {
+        const double xt = 2.0 * x[t];
+        const double* st = ST + t * ld;
+        for(size_t j = 0; j < n; j++) {
+            k[j] += xt * st[j];
+        }
+    }
+    for(size_t j = 0; j < n; j++) {
+        k[j] = std::exp(-gamma * std::max(xnorm + norms[j] - k[j], 0.0));
+    }
+}
+
+/*
+ * Fills the packed RBF kernel matrix of the n samples on the columns of ST,
+ * adding ridge on the diagonal.
+ */
+static void rbfGram(const double* ST, const double* norms, size_t n, size_t d,
+                    double gamma, double ridge, double* H, unsigned int threads) {
+    const size_t rowsPerItem = 32;
+    parallelFor((n + rowsPerItem - 1) / rowsPerItem, threads, [&](size_t item) {
+        std::vector<double> x(d);
+        size_t last = std::min(n, (item + 1) * rowsPerItem);
+        for(size_t i = item * rowsPerItem; i < last; i++) {
+            for(size_t t = 0; t < d; t++) {
+                x[t] = ST[t * n + i];
+            }
+            double* h = packedRow(H, i);
+            rbfExpansion(ST, n, norms, i + 1, d, x.data(), norms[i], gamma, h);
+            h[i] += ridge;
+        }
+    });
+}
+
+/*
+ * Accumulates the dot products of 4 rows p, b long, with 8 columns of B
+ * (stride ld), keeping the 4x8 tile in registers.
+ */
+static inline void dotTile(const double* const p[4], const double* B, size_t ld, size_t b,
+                           double acc[4][8]) {
+    // a local tile, so that it is not aliased with the operands
+    double t[4][8] = {};
+    for(size_t l = 0; l < b; l++, B += ld) {
+        for(size_t r = 0; r < 4; r++) {
+            const double a = p[r][l];
+            for(size_t c = 0; c < 8; c++) {
+                t[r][c] += a * B[c];
+            }
+        }
+    }
+    for(size_t r = 0; r < 4; r++) {
+        for(size_t c = 0; c < 8; c++) {
+            acc[r][c] += t[r][c];
+        }
+    }
+}
+
+/*
+ * Subtracts from the rows [i0,i1) of H, columns [j0,i], the dot products of
+ * their panel columns [k,k+b) with the ones of the rows j, which are provided
+ * transposed in PT (b rows starting at column j0, stride ld). The columns are
+ * taken in chunks, so that the part of PT in use stays in cache.
+ */
+static void updateRows(double* H, size_t k, size_t b, const double* PT, size_t ld,
+                       size_t i0, size_t i1, size_t j0) {
+    const size_t chunk = 128;
+    for(size_t jc = j0; jc < i1; jc += chunk) {
+        const size_t jcEnd = jc + chunk;
+        for(size_t i = std::max(i0, jc); i < i1; i += 4) {
+            const size_t R = std::min((size_t)4, i1 - i);
+            const double* p[4];
+            double* h[4];
+            for(size_t r = 0; r < 4; r++) {
+                p[r] = packedRow(H, i + std::min(r, R - 1)) + k;
+                h[r] = packedRow(H, i + r);
+            }
+
+            // full tiles lie entirely below the diagonal
+            size_t j = jc;
+            if(R == 4) {
+                for(; (j + 8 <= i + 1) && (j + 8 <= jcEnd); j += 8) {
+                    double acc[4][8] = {};
+                    dotTile(p, PT + (j - j0), ld, b, acc);
+                    for(size_t r = 0; r < 4; r++) {
+                        for(size_t c = 0; c < 8; c++) {
+                            h[r][j + c] -= acc[r][c];
+                        }
+                    }
+                }
+            }
+
+            // the remainder, row by row up to the diagonal
+            for(size_t r = 0; r < R; r++) {
+                const size_t jEnd = std::min(jcEnd, i + r + 1);
+                for(size_t jj = j; jj < jEnd; jj++) {
+                    double acc = 0.0;
+                    const double* pt = PT + (jj - j0);
+                    for(size_t l = 0; l < b; l++, pt += ld) {
+                        acc += p[r][l] * (*pt);
+                    }
+                    h[r][jj] -= acc;
+                }
+            }
+        }
+    }
+}
+
+/*
+ * In place Cholesky factorization H = L*L' of the packed matrix, in blocks
+ * of columns: each block is factored, the rows below it are solved against
+ * it and then the trailing matrix is updated. Returns false if H is not
+ * (numerically) positive definite.
+ */
+static bool cholesky(double* H, size_t n, unsigned int threads) {
+    const size_t B = 64;
+    const size_t rowsPerItem = 64;
+    std::vector<double> PT;
+
+    for(size_t k = 0; k < n; k += B) {
+        const size_t b = std::min(B, n - k);
+
+        // factor the diagonal block
+        for(size_t j = k; j < k + b; j++) {
+            double* hj = packedRow(H, j);
+            double djj = hj[j];
+            for(size_t l = k; l < j; l++) {
+                djj -= hj[l] * hj[l];
+            }
+            if(!(djj > 0.0)) {
+                return false;
+            }
+            hj[j] = std::sqrt(djj);
+            for(size_t i = j + 1; i < k + b; i++) {
+                double* hi = packedRow(H, i);
+                double hij = hi[j];
+                for(size_t l = k; l < j; l++) {
+                    hij -= hi[l] * hj[l];
+                }
+                hi[j] = hij / hj[j];
+            }
+        }
+
+        const size_t m = n - k - b;
+        if(m == 0) {
+            break;
+        }
+
+        // solve the rows below against the factored block, working on
+        // them transposed so that each step is along contiguous rows
+        PT.resize(b * m);
+        parallelFor((m + rowsPerItem - 1) / rowsPerItem, threads, [&](size_t item) {
+            const size_t r0 = item * rowsPerItem;
+            const size_t r1 = std::min(m, r0 + rowsPerItem);
+            for(size_t r = r0; r < r1; r++) {
+                const double* hi = packedRow(H, k + b + r) + k;
+                for(size_t l = 0; l < b; l++) {
+                    PT[l * m + r] = hi[l];
+                }
+            }
+            for(size_t j = 0; j < b; j++) {
+                const double* hj = packedRow(H, k + j) + k;
+                double* x = &PT[j * m];
+                for(size_t l = 0; l < j; l++) {
+                    const double a = hj[l];
+                    const double* y = &PT[l * m];
+                    for(size_t r = r0; r < r1; r++) {
+                        x[r] -= a * y[r];
+                    }
+                }
+                const double inv = 1.0 / hj[j];
+                for(size_t r = r0; r < r1; r++) {
+                    x[r] *= inv;
+                }
+            }
+            for(size_t r = r0; r < r1; r++) {
+                double* hi = packedRow(H, k + b + r) + k;
+                for(size_t l = 0; l < b; l++) {
+                    hi[l] = PT[l * m + r];
+                }
+            }
+        });
+
+        // update the trailing matrix
+        parallelFor((m + rowsPerItem - 1) / rowsPerItem, threads, [&](size_t item) {
+            size_t first = k + b + item * rowsPerItem;
+            size_t last = std::min(n, first + rowsPerItem);
+            updateRows(H, k, b, PT.data(), m, first, last, k + b);
+        });
+    }
+
+    return true;
+}
+
+/*
+ * Solves L*L'*X = B in place for the nrhs columns of B, stored one after the
+ * other (i.e. B is nrhs x n, row major). The columns, i.e. the outputs, are
+ * independent and solved concurrently.
+ */
+static void cholSolve(const double* L, size_t n, double* B, size_t nrhs, unsigned int threads) {
+    parallelFor(nrhs, threads, [&](size_t c) {
+        double* x = B + c * n;
+        for(size_t i = 0; i < n; i++) {
+            const double* li = packedRow(L, i);
+            double xi = x[i];
+            for(size_t l = 0; l < i; l++) {
+                xi -= li[l] * x[l];
+            }
+            x[i] = xi / li[i];
+        }
+        for(size_t i = n; i-- > 0;) {
+            const double* li = packedRow(L, i);
+            x[i] /= li[i];
+            const double xi = x[i];
+            for(size_t l = 0; l < i; l++) {
+                x[l] -= li[l] * xi;
+            }
+        }
+    });
+}
+
+/*
+ * Computes the diagonal of (L*L')^-1, i.e. the squared norms of the columns
+ * of L^-1, solving L*X = I for blocks of columns. The rows of each block are
+ * computed 4 at a time: the products with the rows of X already known are
+ * done in tiles, then the 4x4 triangle is solved.
+ */
+static void cholInverseDiagonal(const double* L, size_t n, double* diag, unsigned int threads) {
+    const size_t C = 64;
+    parallelFor((n + C - 1) / C, threads, [&](size_t item) {
+        const size_t j0 = item * C;
+        const size_t rows = n - j0;
+        std::vector<double> X(rows * C);
+        std::vector<double> sum(C, 0.0);
+        for(size_t i0 = 0; i0 < rows; i0 += 4) {
+            const size_t R = std::min((size_t)4, rows - i0);
+            const double* p[4];
+            for(size_t r = 0; r < 4; r++) {
+                p[r] = packedRow(L, j0 + i0 + std::min(r, R - 1)) + j0;
+            }
+
+            // right hand side minus the known part
+            for(size_t r = 0; r < R; r++) {
+                double* x = &X[(i0 + r) * C];
+                if(i0 + r < C) {
+                    x[i0 + r] = 1.0;
+                }
+            }
+            for(size_t c = 0; c < C; c += 8) {
+                double acc[4][8] = {};
+                dotTile(p, &X[c], C, i0, acc);
+                for(size_t r = 0; r < R; r++) {
+                    double* x = &X[(i0 + r) * C + c];
+                    for(size_t cc = 0; cc < 8; cc++) {
+                        x[cc] -= acc[r][cc];
+                    }
+                }
+            }
+
+            // the triangle
+            for(size_t r = 0; r < R; r++) {
+                double* x = &X[(i0 + r) * C];
+                for(size_t l = 0; l < r; l++) {
+                    const double a = p[r][i0 + l];
+                    const double* xl = &X[(i0 + l) * C];
+                    for(size_t c = 0; c < C; c++) {
+                        x[c] -= a * xl[c];
+                    }
+                }
+                const double inv = 1.0 / p[r][i0 + r];
+                for(size_t c = 0; c < C; c++) {
+                    x[c] *= inv;
+                    sum[c] += x[c] * x[c];
+                }
+            }
+        }
+        for(size_t c = 0; c < C && j0 + c < n; c++) {
+            diag[j0 + c] = sum[c];
+        }
+    });
+}
+
+
 double RBFKernel::evaluate(const yarp::sig::Vector& v1, const yarp::sig::Vector& v2) {
     assert(v1.size() == v2.size());
     double result = 0.0;
@@ -49,6 +389,7 @@ double RBFKernel::evaluate(const yarp::sig::Vector& v1, const yarp::sig::Vector&
 LSSVMLearner::LSSVMLearner(unsigned int dom, unsigned int cod, double c) {
     this->setName("LSSVM");
     this->kernel = new RBFKernel();
+    this->threads = 0;
     // make sure to not use initialization list to constructor of base for
     // domain and codomain size, as it will not use overloaded mutators
     this->setDomainSize(dom);
@@ -58,8 +399,9 @@ LSSVMLearner::LSSVMLearner(unsigned int dom, unsigned int cod, double c) {
 
 LSSVMLearner::LSSVMLearner(const LSSVMLearner& other)
   : IFixedSizeLearner(other), inputs(other.inputs), outputs(other.outputs),
-    alphas(other.alphas), bias(other.bias), LOO(other.LOO), C(other.C),
-    kernel(new RBFKernel(*other.kernel)) {
+    centeredInputs(other.centeredInputs), inputsMean(other.inputsMean),
+    inputsNorm(other.inputsNorm), alphas(other.alphas), bias(other.bias), LOO(other.LOO), C(other.C),
+    threads(other.threads), kernel(new RBFKernel(*other.kernel)) {
 
 }
 
@@ -73,10 +415,14 @@ LSSVMLearner& LSSVMLearner::operator=(const LSSVMLearner& other) {
     this->IFixedSizeLearner::operator=(other);
     this->inputs = other.inputs;
     this->outputs = other.outputs;
+    this->centeredInputs = other.centeredInputs;
+    this->inputsMean = other.inputsMean;
+    this->inputsNorm = other.inputsNorm;
     this->alphas = other.alphas;
     this->bias = other.bias;
     this->LOO = other.LOO;
     this->C = other.C;
+    this->threads = other.threads;
     delete this->kernel;
     this->kernel = new RBFKernel(*other.kernel);
 
@@ -91,6 +437,23 @@ void LSSVMLearner::feedSample(const yarp::sig::Vector& input, const yarp::sig::V
     this->outputs.push_back(output);
 }
 
+void LSSVMLearner::feedSamples(const yarp::sig::Matrix& inputs, const yarp::sig::Matrix& outputs) {
+    if(inputs.rows() != outputs.rows()) {
+        throw std::runtime_error("Number of inputs and outputs do not match");
+    }
+    if(inputs.rows() == 0) {
+        return;
+    }
+    this->validateDomainSizes(inputs.getRow(0), outputs.getRow(0));
+
+    this->inputs.reserve(this->inputs.size() + inputs.rows());
+    this->outputs.reserve(this->outputs.size() + outputs.rows());
+    for(size_t r = 0; r < inputs.rows(); r++) {
+        this->inputs.push_back(inputs.getRow(r));
+        this->outputs.push_back(outputs.getRow(r));
+    }
+}
+
 void LSSVMLearner::train() {
     assert(this->inputs.size() == this->outputs.size());
 
@@ -99,6 +462,69 @@ void LSSVMLearner::train() {
         return;
     }
 
+    // the system [K+I/C 1; 1' 0] [alphas; bias'] = [Y; 0] is solved by block
+    // elimination on the Cholesky factor L of H = K+I/C: with H*eta = 1 and
+    // H*nu = Y, bias' = 1'*nu / 1'*eta and alphas = nu - eta*bias'
+    const size_t n = this->inputs.size();
+    const size_t m = this->getCoDomainSize();
+    const unsigned int threads = this->getThreadCount();
+
+    this->buildExpansion();
+    const size_t d = this->centeredInputs.rows();
+
+    std::vector<double> H(n * (n + 1) / 2);
+    rbfGram(this->centeredInputs.data(), this->inputsNorm.data(), n, d,
+            this->kernel->getGamma(), 1.0 / this->C, H.data(), threads);
+    if(!cholesky(H.data(), n, threads)) {
+        this->trainLU();
+        return;
+    }
+
+    // solve for the rows [1'; Y']
+    std::vector<double> B((m + 1) * n);
+    for(size_t i = 0; i < n; i++) {
+        B[i] = 1.0;
+        for(size_t c = 0; c < m; c++) {
+            B[(c + 1) * n + i] = this->outputs[i](c);
+        }
+    }
+    cholSolve(H.data(), n, B.data(), m + 1, threads);
+    const double* eta = B.data();
+    double s = 0.0;
+    for(size_t i = 0; i < n; i++) {
+        s += eta[i];
+    }
+
+    this->alphas.resize(n, m);
+    this->bias.resize(m);
+    for(size_t c = 0; c < m; c++) {
+        const double* nu = &B[(c + 1) * n];
+        double b = 0.0;
+        for(size_t i = 0; i < n; i++) {
+            b += nu[i];
+        }
+        this->bias(c) = b / s;
+        for(size_t i = 0; i < n; i++) {
+            this->alphas(i, c) = nu[i] - eta[i] * this->bias(c);
+        }
+    }
+
+    // compute LOO, the diagonal of the inverse being diag(H^-1) - eta.^2/s
+    std::vector<double> diag(n);
+    cholInverseDiagonal(H.data(), n, diag.data(), threads);
+    this->LOO = zeros(m);
+
+    for(size_t c = 0; c < m; c++) {
+        for(size_t j = 0; j < n; j++) {
+            double err = this->alphas(j, c) / (diag[j] - eta[j] * eta[j] / s);
+            this->LOO(c) += err * err;
+        }
+        this->LOO(c) /= n;
+    }
+
+}
+
+void LSSVMLearner::trainLU() {
     // create kernel matrix
     yarp::sig::Matrix K(inputs.size() + 1, inputs.size() + 1);
     for(int r = 0; r < K.rows() - 1; r++) {
@@ -139,28 +565,107 @@ void LSSVMLearner::train() {
         }
         this->LOO(i) /= alphas_i.size();
     }
+}
 
+void LSSVMLearner::buildExpansion() {
+    const size_t n = this->inputs.size();
+    const size_t d = (n > 0) ? this->inputs[0].size() : 0;
+
+    // centered, since the kernel is translation invariant and the norm
+    // trick is more accurate close to the origin
+    this->inputsMean = zeros(d);
+    for(size_t i = 0; i < n; i++) {
+        for(size_t t = 0; t < d; t++) {
+            this->inputsMean(t) += this->inputs[i](t) / n;
+        }
+    }
+    this->centeredInputs.resize(d, n);
+    this->inputsNorm = zeros(n);
+    for(size_t i = 0; i < n; i++) {
+        for(size_t t = 0; t < d; t++) {
+            const double x = this->inputs[i](t) - this->inputsMean(t);
+            this->centeredInputs(t, i) = x;
+            this->inputsNorm(i) += x * x;
+        }
+    }
+}
+
+unsigned int LSSVMLearner::getThreadCount() {
+    return (this->threads > 0) ? this->threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+void LSSVMLearner::predictSample(const double* input, double* output, double* work) {
+    const size_t n = this->centeredInputs.cols();
+    const size_t d = this->centeredInputs.rows();
+    const size_t m = this->bias.size();
+
+    double* k = work;
+    double* x = work + n;
+    double xnorm = 0.0;
+    for(size_t t = 0; t < d; t++) {
+        x[t] = input[t] - this->inputsMean(t);
+        xnorm += x[t] * x[t];
+    }
+    rbfExpansion(this->centeredInputs.data(), n, this->inputsNorm.data(), n, d,
+                 x, xnorm, this->kernel->getGamma(), k);
+
+    for(size_t c = 0; c < m; c++) {
+        output[c] = this->bias(c);
+    }
+    for(size_t i = 0; i < n; i++) {
+        const double* a = &this->alphas(i, 0);
+        for(size_t c = 0; c < m; c++) {
+            output[c] += a[c] * k[i];
+        }
+    }
 }
 
 Prediction LSSVMLearner::predict(const yarp::sig::Vector& input) {
     this->checkDomainSize(input);
 
-    if(this->inputs.size() == 0) {
+    if(this->centeredInputs.cols() == 0) {
         return zeros(this->getCoDomainSize());
     }
 
-    // compute kernel expansion
-    yarp::sig::Vector k(this->inputs.size());
-    for(size_t i = 0; i < k.size(); i++) {
-        k(i) = this->kernel->evaluate(this->inputs[i], input);
+    yarp::sig::Vector work(this->centeredInputs.cols() + this->centeredInputs.rows());
+    yarp::sig::Vector output(this->bias.size());
+    this->predictSample(input.data(), output.data(), work.data());
+    return Prediction(output);
+}
+
+yarp::sig::Matrix LSSVMLearner::predict(const yarp::sig::Matrix& input) {
+    yarp::sig::Matrix output = zeros(input.rows(), this->getCoDomainSize());
+    if((this->centeredInputs.cols() == 0) || (input.rows() == 0)) {
+        return output;
+    }
+    if(input.cols() != (int)this->getDomainSize()) {
+        throw std::runtime_error("Input sample has invalid dimensionality");
     }
 
-    return Prediction((this->alphas.transposed() * k) + this->bias);
+    const size_t rowsPerItem = 16;
+    const size_t rows = input.rows();
+    parallelFor((rows + rowsPerItem - 1) / rowsPerItem, this->getThreadCount(), [&](size_t item) {
+        std::vector<double> work(this->centeredInputs.cols() + this->centeredInputs.rows());
+        size_t last = std::min(rows, (item + 1) * rowsPerItem);
+        for(size_t r = item * rowsPerItem; r < last; r++) {
+            this->predictSample(input[r], output[r], work.data());
+        }
+    });
+    return output;
+}
+
+void LSSVMLearner::predictSamples(const yarp::sig::Matrix& inputs,
+                                  yarp::sig::Matrix& predictions, yarp::sig::Matrix& variances) {
+    predictions = this->predict(inputs);
+    variances.resize(0, 0);
 }
 
 void LSSVMLearner::reset() {
     this->inputs.clear();
     this->outputs.clear();
+    this->centeredInputs = yarp::sig::Matrix();
+    this->inputsMean.clear();
+    this->inputsNorm.clear();
     this->alphas = yarp::sig::Matrix();
     this->LOO.clear();
     this->bias.clear();
@@ -186,30 +691,28 @@ std::string LSSVMLearner::getConfigHelp() {
     buffer << this->IFixedSizeLearner::getConfigHelp();
     //buffer << "  kernel idx|all cfg    Kernel configuration" << std::endl;
     buffer << "  c val                 Tradeoff parameter C" << std::endl;
+    buffer << "  threads n             Threads for training and batch predictions (0: all cores)" << std::endl;
     buffer << this->kernel->getConfigHelp() << std::endl;
     return buffer.str();
 }
 
-void LSSVMLearner::writeBottle(yarp::os::Bottle& bot) {
+void LSSVMLearner::writeBottle(yarp::os::Bottle& bot) const {
     // write kernel gamma
-    bot << this->kernel->getGamma() << this->getC() << this->bias
+    bot << this->kernel->getGamma() << this->C << this->bias
         << this->alphas;
 
-    // write inputs
+    // write inputs and outputs as matrices, which are serialized in one blob
+    yarp::sig::Matrix X(this->inputs.size(), this->getDomainSize());
     for(unsigned int i = 0; i < this->inputs.size(); i++) {
-        for(unsigned int d = 0; d < this->getDomainSize(); d++) {
-            bot.addFloat64(this->inputs[i](d));
-        }
+        X.setRow(i, this->inputs[i]);
     }
-    bot.addInt32(this->inputs.size());
+    bot << X;
 
-    // write outputs
+    yarp::sig::Matrix Y(this->outputs.size(), this->getCoDomainSize());
     for(unsigned int i = 0; i < this->outputs.size(); i++) {
-        for(unsigned int d = 0; d < this->getCoDomainSize(); d++) {
-            bot.addFloat64(this->outputs[i](d));
-        }
+        Y.setRow(i, this->outputs[i]);
     }
-    bot.addInt32(this->outputs.size());
+    bot << Y;
 
     // make sure to call the superclass's method
     this->IFixedSizeLearner::writeBottle(bot);
@@ -219,21 +722,36 @@ void LSSVMLearner::readBottle(yarp::os::Bottle& bot) {
     // make sure to call the superclass's method
     this->IFixedSizeLearner::readBottle(bot);
 
-    // read outputs
-    this->outputs.resize(bot.pop().asInt32());
-    for(int i = this->outputs.size() - 1; i >= 0; i--) {
-        this->outputs[i].resize(this->getCoDomainSize());
-        for(int d = this->getCoDomainSize() - 1; d >= 0; d--) {
-            this->outputs[i](d) = bot.pop().asFloat64();
+    if(bot.size() >= 3 && bot.get(bot.size() - 3).isBlob()) {
+        yarp::sig::Matrix Y;
+        bot >> Y;
+        this->outputs.resize(Y.rows());
+        for(int i = 0; i < Y.rows(); i++) {
+            this->outputs[i] = Y.getRow(i);
         }
-    }
 
-    // read inputs
-    this->inputs.resize(bot.pop().asInt32());
-    for(int i = this->inputs.size() - 1; i >= 0; i--) {
-        this->inputs[i].resize(this->getDomainSize());
-        for(int d = this->getDomainSize() - 1; d >= 0; d--) {
-            this->inputs[i](d) = bot.pop().asFloat64();
+        yarp::sig::Matrix X;
+        bot >> X;
+        this->inputs.resize(X.rows());
+        for(int i = 0; i < X.rows(); i++) {
+            this->inputs[i] = X.getRow(i);
+        }
+    } else {
+        // samples written one element at a time by earlier versions
+        this->outputs.resize(bot.pop().asInt32());
+        for(int i = this->outputs.size() - 1; i >= 0; i--) {
+            this->outputs[i].resize(this->getCoDomainSize());
+            for(int d = this->getCoDomainSize() - 1; d >= 0; d--) {
+                this->outputs[i](d) = bot.pop().asFloat64();
+            }
+        }
+
+        this->inputs.resize(bot.pop().asInt32());
+        for(int i = this->inputs.size() - 1; i >= 0; i--) {
+            this->inputs[i].resize(this->getDomainSize());
+            for(int d = this->getDomainSize() - 1; d >= 0; d--) {
+                this->inputs[i](d) = bot.pop().asFloat64();
+            }
         }
     }
 
@@ -242,6 +760,7 @@ void LSSVMLearner::readBottle(yarp::os::Bottle& bot) {
     bot >> this->alphas >> this->bias >> c >> gamma;
     this->setC(c);
     this->kernel->setGamma(gamma);
+    this->buildExpansion();
 }
 
 void LSSVMLearner::setDomainSize(unsigned int size) {
@@ -265,6 +784,12 @@ bool LSSVMLearner::configure(yarp::os::Searchable& config) {
         }
     }
 
+    // format: set threads int
+    if(config.find("threads").isInt32() && config.find("threads").asInt32() >= 0) {
+        this->threads = config.find("threads").asInt32();
+        success = true;
+    }
+
     success |= this->kernel->configure(config);
 
     return success;
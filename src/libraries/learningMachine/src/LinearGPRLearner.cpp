@@ -41,6 +41,8 @@ namespace learningmachine {
 LinearGPRLearner::LinearGPRLearner(unsigned int dom, unsigned int cod, double sigma) {
     this->setName("LinearGPR");
     this->sampleCount = 0;
+    this->windowSize = 0;
+    this->forgettingFactor = 1.0;
     // make sure to not use initialization list to constructor of base for
     // domain and codomain size, as it will not use overloaded mutators
     this->setDomainSize(dom);
@@ -50,8 +52,10 @@ LinearGPRLearner::LinearGPRLearner(unsigned int dom, unsigned int cod, double si
 }
 
 LinearGPRLearner::LinearGPRLearner(const LinearGPRLearner& other)
-  : IFixedSizeLearner(other), sampleCount(other.sampleCount), R(other.R),
-    B(other.B), W(other.W), sigma(other.sigma) {
+  : IFixedSizeLearner(other), R(other.R), B(other.B), W(other.W),
+    sigma(other.sigma), sampleCount(other.sampleCount), windowSize(other.windowSize),
+    forgettingFactor(other.forgettingFactor), window(other.window),
+    sinceRefresh(other.sinceRefresh) {
 }
 
 LinearGPRLearner::~LinearGPRLearner() {
@@ -67,23 +71,99 @@ LinearGPRLearner& LinearGPRLearner::operator=(const LinearGPRLearner& other) {
     this->B = other.B;
     this->W = other.W;
     this->sigma = other.sigma;
+    this->windowSize = other.windowSize;
+    this->forgettingFactor = other.forgettingFactor;
+    this->window = other.window;
+    this->sinceRefresh = other.sinceRefresh;
 
     return *this;
 }
 
-void LinearGPRLearner::feedSample(const yarp::sig::Vector& input, const yarp::sig::Vector& output) {
-    this->IFixedSizeLearner::feedSample(input, output);
+void LinearGPRLearner::updateSample(const yarp::sig::Vector& input, const yarp::sig::Vector& output, double weight) {
+    const int d = this->getDomainSize();
+    const int cod = this->getCoDomainSize();
 
-    // update R
-    cholupdate(this->R, input);
+    // update (or downdate) R, which leaves everything unchanged on failure
+    yarp::sig::Vector x = input * std::sqrt(std::fabs(weight));
+    if(weight > 0.) {
+        cholupdate(this->R, x);
+    } else {
+        choldowndate(this->R, x);
+    }
 
-    // update B
-    this->B = this->B + outerprod(output, input);
+    // with the gain k = (R'*R)^-1 * input of the updated factor, the weights
+    // B*(R'*R)^-1 change by the prediction error along k
+    yarp::sig::Vector k = cholsolve(this->R, input);
+    for(int r = 0; r < cod; r++) {
+        double* Br = this->B[r];
+        double* Wr = this->W[r];
+        double e = output(r);
+        for(int c = 0; c < d; c++) {
+            e -= Wr[c] * input(c);
+        }
+        const double wy = weight * output(r);
+        const double we = weight * e;
+        for(int c = 0; c < d; c++) {
+            Br[c] += wy * input(c);
+            Wr[c] += we * k(c);
+        }
+    }
+}
 
-    // update W
+void LinearGPRLearner::rebuild() {
+    const int d = this->getDomainSize();
+    const double n = (double) this->window.size();
+
+    // the prior has been discounted once for every sample
+    this->R = eye(d, d) * (this->sigma * std::sqrt(std::pow(this->forgettingFactor, this->sampleCount)));
+    this->B = zeros(this->getCoDomainSize(), d);
+    for(size_t i = 0; i < this->window.size(); i++) {
+        double weight = std::pow(this->forgettingFactor, n - 1. - i);
+        cholupdate(this->R, this->window[i].first * std::sqrt(weight));
+        this->B = this->B + outerprod(this->window[i].second * weight, this->window[i].first);
+    }
     cholsolve(this->R, this->B, this->W);
+    this->sinceRefresh = 0;
+}
+
+void LinearGPRLearner::feedSample(const yarp::sig::Vector& input, const yarp::sig::Vector& output) {
+    this->IFixedSizeLearner::feedSample(input, output);
 
+    // remove the oldest sample in the window, which has been discounted once
+    // for every sample that followed it
+    if(this->windowSize > 0 && this->window.size() >= this->windowSize) {
+        double weight = std::pow(this->forgettingFactor, (double) this->window.size() - 1.);
+        bool failed = false;
+        try {
+            this->updateSample(this->window.front().first, this->window.front().second, -weight);
+        } catch(const std::runtime_error&) {
+            // lost definiteness to rounding errors
+            failed = true;
+        }
+        this->window.pop_front();
+        if(failed) {
+            this->rebuild();
+        }
+    }
+
+    // discount the past samples
+    if(this->forgettingFactor < 1.0) {
+        this->R = this->R * std::sqrt(this->forgettingFactor);
+        this->B = this->B * this->forgettingFactor;
+    }
+
+    this->updateSample(input, output, 1.0);
     this->sampleCount++;
+
+    if(this->windowSize > 0) {
+        this->window.push_back(std::make_pair(input, output));
+
+        // bound the rounding errors of the incremental corrections
+        if(++this->sinceRefresh >= this->windowSize) {
+            cholsolve(this->R, this->B, this->W);
+            this->sinceRefresh = 0;
+        }
+    }
 }
 
 void LinearGPRLearner::train() {
@@ -109,12 +189,18 @@ void LinearGPRLearner::reset() {
     this->R = eye(this->getDomainSize(), this->getDomainSize()) * this->sigma;
     this->B = zeros(this->getCoDomainSize(), this->getDomainSize());
     this->W = zeros(this->getCoDomainSize(), this->getDomainSize());
+    this->window.clear();
+    this->sinceRefresh = 0;
 }
 
 std::string LinearGPRLearner::getInfo() {
     std::ostringstream buffer;
     buffer << this->IFixedSizeLearner::getInfo();
     buffer << "Sigma: " << this->getSigma() << " | ";
+    if(this->getWindowSize() > 0) {
+        buffer << "Window: " << this->window.size() << "/" << this->getWindowSize() << " | ";
+    }
+    buffer << "Forgetting Factor: " << this->getForgettingFactor() << " | ";
     buffer << "Sample Count: " << this->sampleCount << std::endl;
     //for(unsigned int i = 0; i < this->machines.size(); i++) {
     //    buffer << "  [" << (i + 1) << "] ";
@@ -128,11 +214,22 @@ std::string LinearGPRLearner::getConfigHelp() {
     std::ostringstream buffer;
     buffer << this->IFixedSizeLearner::getConfigHelp();
     buffer << "  sigma val             Signal noise sigma" << std::endl;
+    buffer << "  window val            Number of recent samples to use (0 for all)" << std::endl;
+    buffer << "  forgetting val        Forgetting factor in (0, 1]" << std::endl;
     return buffer.str();
 }
 
-void LinearGPRLearner::writeBottle(yarp::os::Bottle& bot) {
+void LinearGPRLearner::writeBottle(yarp::os::Bottle& bot) const {
+    yarp::sig::Matrix inputs(this->window.size(), this->getDomainSize());
+    yarp::sig::Matrix outputs(this->window.size(), this->getCoDomainSize());
+    for(size_t i = 0; i < this->window.size(); i++) {
+        inputs.setRow(i, this->window[i].first);
+        outputs.setRow(i, this->window[i].second);
+    }
+
     bot << this->R << this->B << this->W << this->sigma << this->sampleCount;
+    bot << (int) this->windowSize << this->forgettingFactor << (int) this->sinceRefresh;
+    bot << inputs << outputs;
     // make sure to call the superclass's method
     this->IFixedSizeLearner::writeBottle(bot);
 }
@@ -140,7 +237,19 @@ void LinearGPRLearner::writeBottle(yarp::os::Bottle& bot) {
 void LinearGPRLearner::readBottle(yarp::os::Bottle& bot) {
     // make sure to call the superclass's method
     this->IFixedSizeLearner::readBottle(bot);
+    yarp::sig::Matrix inputs;
+    yarp::sig::Matrix outputs;
+    int size;
+    int since;
+    bot >> outputs >> inputs;
+    bot >> since >> this->forgettingFactor >> size;
     bot >> this->sampleCount >> this->sigma >> this->W >> this->B >> this->R;
+    this->windowSize = size;
+    this->sinceRefresh = since;
+    this->window.clear();
+    for(int i = 0; i < inputs.rows(); i++) {
+        this->window.push_back(std::make_pair(inputs.getRow(i), outputs.getRow(i)));
+    }
 }
 
 void LinearGPRLearner::setDomainSize(unsigned int size) {
@@ -166,6 +275,28 @@ double LinearGPRLearner::getSigma() {
     return this->sigma;
 }
 
+void LinearGPRLearner::setWindowSize(unsigned int size) {
+    this->windowSize = size;
+    this->reset();
+}
+
+unsigned int LinearGPRLearner::getWindowSize() {
+    return this->windowSize;
+}
+
+void LinearGPRLearner::setForgettingFactor(double f) {
+    if(f > 0.0 && f <= 1.0) {
+        this->forgettingFactor = f;
+        this->reset();
+    } else {
+        throw std::runtime_error("Forgetting factor has to be in (0, 1]");
+    }
+}
+
+double LinearGPRLearner::getForgettingFactor() {
+    return this->forgettingFactor;
+}
+
 
 bool LinearGPRLearner::configure(yarp::os::Searchable& config) {
     bool success = this->IFixedSizeLearner::configure(config);
@@ -176,6 +307,18 @@ bool LinearGPRLearner::configure(yarp::os::Searchable& config) {
         success = true;
     }
 
+    // format: set window val
+    if(config.find("window").isInt32() && config.find("window").asInt32() >= 0) {
+        this->setWindowSize(config.find("window").asInt32());
+        success = true;
+    }
+
+    // format: set forgetting val
+    if(config.find("forgetting").isFloat64() || config.find("forgetting").isInt32()) {
+        this->setForgettingFactor(config.find("forgetting").asFloat64());
+        success = true;
+    }
+
     return success;
 }
 
@@ -96,6 +96,51 @@ void dchud(double* r, int ldr, int p, double* x, double* z, int ldz, int nz,
     }
 }
 
+int dchdd(double* r, int ldr, int p, double* x, double* c, double* s,
+          unsigned char rtrans) {
+    int i, j;
+    double* a = (double*) 0x0;
+    double alpha, norm, scale, ca, sa, xx, t;
+
+    // solve R'*a = x
+    a = (double*) malloc(p * sizeof(double));
+    cblas_dcopy(p, x, 1, a, 1);
+    cblas_dtrsv(CblasRowMajor, rtrans ? CblasLower : CblasUpper, rtrans ? CblasNoTrans : CblasTrans,
+                CblasNonUnit, p, r, ldr, a, 1);
+
+    // the downdated matrix is positive definite iff |a| < 1
+    norm = cblas_dnrm2(p, a, 1);
+    if(!(norm < 1.)) {
+        free(a);
+        return -1;
+    }
+    alpha = sqrt((1. - norm) * (1. + norm));
+
+    // compute the rotations that reduce [a; alpha] to [0; 1]
+    for(i = p - 1; i >= 0; i--) {
+        scale = alpha + fabs(a[i]);
+        ca = alpha / scale;
+        sa = a[i] / scale;
+        norm = sqrt(ca * ca + sa * sa);
+        c[i] = ca / norm;
+        s[i] = sa / norm;
+        alpha = scale * norm;
+    }
+    free(a);
+
+    // apply the rotations to the columns of r
+    for(j = 0; j < p; j++) {
+        xx = 0.;
+        for(i = j; i >= 0; i--) {
+            double* rij = rtrans ? (r + j * ldr + i) : (r + i * ldr + j);
+            t = c[i] * xx + s[i] * (*rij);
+            *rij = c[i] * (*rij) - s[i] * xx;
+            xx = t;
+        }
+    }
+    return 0;
+}
+
 void gsl_linalg_cholesky_update(gsl_matrix* R, gsl_vector* x, gsl_vector* c, gsl_vector* s,
                                 gsl_matrix* Z, gsl_vector* y, gsl_vector* rho,
                                 unsigned char rtrans, unsigned char ztrans) {
@@ -164,6 +209,30 @@ void cholupdate(yarp::sig::Matrix& R, const yarp::sig::Vector& x, bool rtrans) {
     gsl_linalg_cholesky_update(Rgsl, xgsl, cgsl, sgsl, NULL, NULL, NULL, (unsigned char) rtrans, 0);
 }
 
+void choldowndate(yarp::sig::Matrix& R, const yarp::sig::Vector& x, bool rtrans) {
+    assert(R.rows() == R.cols());
+    assert(R.cols() == (int) x.size());
+    const int p = R.cols();
+    yarp::sig::Vector xc(x);
+    yarp::sig::Vector c(p);
+    yarp::sig::Vector s(p);
+
+    if(dchdd(R.data(), p, p, xc.data(), c.data(), s.data(), (unsigned char) rtrans) != 0) {
+        throw std::runtime_error("Cholesky downdate results in a matrix that is not positive definite");
+    }
+
+    // reflect, as the GSL functions expect duplicate information (see cholupdate)
+    for(int i = 0; i < p; i++) {
+        for(int j = 0; j < i; j++) {
+            if(rtrans) {
+                R(j, i) = R(i, j);
+            } else {
+                R(i, j) = R(j, i);
+            }
+        }
+    }
+}
+
 void cholsolve(const yarp::sig::Matrix& R, const yarp::sig::Matrix& B, yarp::sig::Matrix& X) {
     assert(B.rows() == X.rows());
     assert(B.cols() == X.cols());
@@ -368,6 +437,83 @@ yarp::sig::Matrix sinmat(const yarp::sig::Matrix& M) {
     return map(M, std::sin);
 }
 
+/*
+ * 2*pi split in three parts with 33 bits each (the ones of fdlibm for pi/2),
+ * so that k * TWOPI_1 is exact as long as |k| < 2^20.
+ */
+static const double TWOPI_1 = 6.28318530693650245667e+00;
+static const double TWOPI_2 = 2.43084020252158639064e-10;
+static const double TWOPI_3 = 8.08906499484466582320e-21;
+static const double INV_TWOPI = 1.59154943091895335768e-01;
+// adding and subtracting 1.5 * 2^52 rounds to the nearest integer
+static const double ROUND_MAGIC = 6755399441055744.0;
+static const double SINCOS_LIMIT = 1e6;
+
+/*
+ * Sine and cosine of h in [-pi/2, pi/2] by their Taylor series, truncated
+ * where the remaining terms are below 1e-18.
+ */
+static inline void halfSinCos(double h, double& s, double& c) {
+    double z = h * h;
+    s = 1.9572941063391263e-20;
+    s = s * z - 8.2206352466243295e-18;
+    s = s * z + 2.8114572543455206e-15;
+    s = s * z - 7.6471637318198164e-13;
+    s = s * z + 1.6059043836821613e-10;
+    s = s * z - 2.5052108385441720e-08;
+    s = s * z + 2.7557319223985893e-06;
+    s = s * z - 1.9841269841269841e-04;
+    s = s * z + 8.3333333333333332e-03;
+    s = s * z - 1.6666666666666666e-01;
+    s = (s * z + 1.0) * h;
+
+    c = -8.8967913924505741e-22;
+    c = c * z + 4.1103176233121648e-19;
+    c = c * z - 1.5619206968586225e-16;
+    c = c * z + 4.7794773323873853e-14;
+    c = c * z - 1.1470745597729725e-11;
+    c = c * z + 2.0876756987868100e-09;
+    c = c * z - 2.7557319223985888e-07;
+    c = c * z + 2.4801587301587302e-05;
+    c = c * z - 1.3888888888888889e-03;
+    c = c * z + 4.1666666666666664e-02;
+    c = c * z - 0.5;
+    c = c * z + 1.0;
+}
+
+void sincosvec(const double* v, double* s, double* c, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        double k = (v[i] * INV_TWOPI + ROUND_MAGIC) - ROUND_MAGIC;
+        double r = ((v[i] - k * TWOPI_1) - k * TWOPI_2) - k * TWOPI_3;
+        double sh, ch;
+        halfSinCos(0.5 * r, sh, ch);
+        s[i] = 2. * sh * ch;
+        c[i] = (ch - sh) * (ch + sh);
+    }
+    // kept apart, as a branch in the loop above prevents its vectorization
+    for(size_t i = 0; i < n; i++) {
+        if(!(std::fabs(v[i]) <= SINCOS_LIMIT)) {
+            s[i] = std::sin(v[i]);
+            c[i] = std::cos(v[i]);
+        }
+    }
+}
+
+void cosvec(const double* v, double* c, size_t n) {
+    for(size_t i = 0; i < n; i++) {
+        double k = (v[i] * INV_TWOPI + ROUND_MAGIC) - ROUND_MAGIC;
+        double r = ((v[i] - k * TWOPI_1) - k * TWOPI_2) - k * TWOPI_3;
+        double sh, ch;
+        halfSinCos(0.5 * r, sh, ch);
+        c[i] = (ch - sh) * (ch + sh);
+    }
+    for(size_t i = 0; i < n; i++) {
+        if(!(std::fabs(v[i]) <= SINCOS_LIMIT)) {
+            c[i] = std::cos(v[i]);
+        }
+    }
+}
+
 } // math
 } // learningmachine
 } // iCub
@@ -23,12 +23,10 @@
 #include <yarp/math/Math.h>
 
 #include "iCub/learningMachine/RLSLearner.h"
-#include "iCub/learningMachine/Math.h"
 #include "iCub/learningMachine/Serialization.h"
 
 using namespace yarp::math;
 using namespace iCub::learningmachine::serialization;
-using namespace iCub::learningmachine::math;
 
 namespace iCub {
 namespace learningmachine {
@@ -37,6 +35,7 @@ namespace learningmachine {
 RLSLearner::RLSLearner(unsigned int dom, unsigned int cod, double lambda) {
     this->setName("RLS");
     this->sampleCount = 0;
+    this->forgettingFactor = 1.0;
     // make sure to not use initialization list to constructor of base for
     // domain and codomain size, as it will not use overloaded mutators
     this->setDomainSize(dom);
@@ -46,8 +45,9 @@ RLSLearner::RLSLearner(unsigned int dom, unsigned int cod, double lambda) {
 }
 
 RLSLearner::RLSLearner(const RLSLearner& other)
-  : IFixedSizeLearner(other), sampleCount(other.sampleCount), R(other.R),
-    B(other.B), W(other.W), lambda(other.lambda) {
+  : IFixedSizeLearner(other), R(other.R), B(other.B), W(other.W),
+    work(other.work), gain(other.gain), sampleCount(other.sampleCount),
+    lambda(other.lambda), forgettingFactor(other.forgettingFactor) {
 }
 
 RLSLearner::~RLSLearner() {
@@ -62,7 +62,10 @@ RLSLearner& RLSLearner::operator=(const RLSLearner& other) {
     this->R = other.R;
     this->B = other.B;
     this->W = other.W;
+    this->work = other.work;
+    this->gain = other.gain;
     this->lambda = other.lambda;
+    this->forgettingFactor = other.forgettingFactor;
 
     return *this;
 }
@@ -70,14 +73,73 @@ RLSLearner& RLSLearner::operator=(const RLSLearner& other) {
 void RLSLearner::feedSample(const yarp::sig::Vector& input, const yarp::sig::Vector& output) {
     this->IFixedSizeLearner::feedSample(input, output);
 
-    // update R
-    cholupdate(this->R, input);
+    // only the upper triangle of R is kept up to date, see writeBottle()
+    const int d = this->getDomainSize();
+    const int cod = this->getCoDomainSize();
+
+    // discount the past samples
+    if(this->forgettingFactor < 1.0) {
+        const double sf = std::sqrt(this->forgettingFactor);
+        for(int i = 0; i < d; i++) {
+            double* Ri = this->R[i];
+            for(int j = i; j < d; j++) {
+                Ri[j] *= sf;
+            }
+        }
+        for(int r = 0; r < cod; r++) {
+            double* Br = this->B[r];
+            for(int c = 0; c < d; c++) {
+                Br[c] *= this->forgettingFactor;
+            }
+        }
+    }
 
-    // update B
-    this->B = this->B + outerprod(output, input);
+    // update R with the Givens rotations that zero the input appended below
+    // it, while solving R'*z = input on the updated rows (z is stored in k);
+    // then the gain k = (R'*R)^-1 * input follows from R*k = z
+    double* w = this->work.data();
+    double* k = this->gain.data();
+    for(int i = 0; i < d; i++) {
+        w[i] = input(i);
+        k[i] = input(i);
+    }
+    for(int i = 0; i < d; i++) {
+        double* Ri = this->R[i];
+        const double rho = std::hypot(Ri[i], w[i]);
+        const double c = Ri[i] / rho;
+        const double s = w[i] / rho;
+        Ri[i] = rho;
+        k[i] /= rho;
+        const double zi = k[i];
+        for(int j = i + 1; j < d; j++) {
+            const double t = c * Ri[j] + s * w[j];
+            w[j] = c * w[j] - s * Ri[j];
+            Ri[j] = t;
+            k[j] -= t * zi;
+        }
+    }
+    for(int i = d - 1; i >= 0; i--) {
+        const double* Ri = this->R[i];
+        double ki = k[i];
+        for(int j = i + 1; j < d; j++) {
+            ki -= Ri[j] * k[j];
+        }
+        k[i] = ki / Ri[i];
+    }
 
-    // update W
-    cholsolve(this->R, this->B, this->W);
+    // update B and correct W by the prediction error along the gain
+    for(int r = 0; r < cod; r++) {
+        double* Br = this->B[r];
+        double* Wr = this->W[r];
+        double e = output(r);
+        for(int c = 0; c < d; c++) {
+            Br[c] += output(r) * input(c);
+            e -= Wr[c] * input(c);
+        }
+        for(int c = 0; c < d; c++) {
+            Wr[c] += e * k[c];
+        }
+    }
 
     this->sampleCount++;
 }
@@ -99,12 +161,15 @@ void RLSLearner::reset() {
     this->R = eye(this->getDomainSize(), this->getDomainSize()) * sqrt(this->lambda);
     this->B = zeros(this->getCoDomainSize(), this->getDomainSize());
     this->W = zeros(this->getCoDomainSize(), this->getDomainSize());
+    this->work.resize(this->getDomainSize());
+    this->gain.resize(this->getDomainSize());
 }
 
 std::string RLSLearner::getInfo() {
     std::ostringstream buffer;
     buffer << this->IFixedSizeLearner::getInfo();
     buffer << "Lambda: " << this->getLambda() << " | ";
+    buffer << "Forgetting Factor: " << this->getForgettingFactor() << " | ";
     buffer << "Sample Count: " << this->sampleCount << std::endl;
     //for(unsigned int i = 0; i < this->machines.size(); i++) {
     //    buffer << "  [" << (i + 1) << "] ";
@@ -118,11 +183,21 @@ std::string RLSLearner::getConfigHelp() {
     std::ostringstream buffer;
     buffer << this->IFixedSizeLearner::getConfigHelp();
     buffer << "  lambda val            Regularization parameter lambda" << std::endl;
+    buffer << "  forgetting val        Forgetting factor in (0, 1]" << std::endl;
     return buffer.str();
 }
 
-void RLSLearner::writeBottle(yarp::os::Bottle& bot) {
-    bot << this->R << this->B << this->W << this->lambda << this->sampleCount;
+void RLSLearner::writeBottle(yarp::os::Bottle& bot) const {
+    // the updates only touch the upper triangle of R, whereas the full
+    // symmetric matrix is stored
+    yarp::sig::Matrix R = this->R;
+    for(int i = 0; i < R.rows(); i++) {
+        for(int j = 0; j < i; j++) {
+            R(i, j) = R(j, i);
+        }
+    }
+
+    bot << R << this->B << this->W << this->lambda << this->sampleCount;
     // make sure to call the superclass's method
     this->IFixedSizeLearner::writeBottle(bot);
 }
@@ -156,6 +231,18 @@ double RLSLearner::getLambda() {
     return this->lambda;
 }
 
+void RLSLearner::setForgettingFactor(double f) {
+    if(f > 0.0 && f <= 1.0) {
+        this->forgettingFactor = f;
+    } else {
+        throw std::runtime_error("Forgetting factor has to be in (0, 1]");
+    }
+}
+
+double RLSLearner::getForgettingFactor() {
+    return this->forgettingFactor;
+}
+
 
 bool RLSLearner::configure(yarp::os::Searchable& config) {
     bool success = this->IFixedSizeLearner::configure(config);
@@ -166,6 +253,12 @@ bool RLSLearner::configure(yarp::os::Searchable& config) {
         success = true;
     }
 
+    // format: set forgetting val
+    if(config.find("forgetting").isFloat64() || config.find("forgetting").isInt32()) {
+        this->setForgettingFactor(config.find("forgetting").asFloat64());
+        success = true;
+    }
+
     return success;
 }
 
@@ -17,7 +17,9 @@
  */
 
 #include <cassert>
+#include <stdexcept>
 #include <sstream>
+#include <algorithm>
 #include <cmath>
 
 #include <yarp/math/Math.h>
@@ -46,12 +48,58 @@ RandomFeature::RandomFeature(unsigned int dom, unsigned int cod, double gamma) {
 
 yarp::sig::Vector RandomFeature::transform(const yarp::sig::Vector& input) {
     yarp::sig::Vector output = this->IFixedSizeTransformer::transform(input);
+    this->transformSample(input.data(), output.data());
+    return output;
+}
 
-    // python: x_f = numpy.cos(numpy.dot(self.W, x) + self.bias) / math.sqrt(self.nproj)
-    output = cosvec((this->W * input) + this->b) * (1. / std::sqrt((double) this->getCoDomainSize()));
+void RandomFeature::transform(const yarp::sig::Vector& input, yarp::sig::Vector& output) {
+    this->ITransformer::transform(input);
+    if(output.size() != this->getCoDomainSize()) {
+        output.resize(this->getCoDomainSize());
+    }
+    this->validateDomainSizes(input, output);
+    this->transformSample(input.data(), output.data());
+}
+
+yarp::sig::Matrix RandomFeature::transform(const yarp::sig::Matrix& input) {
+    if(input.cols() != (int)this->getDomainSize()) {
+        throw std::runtime_error("Input sample has invalid dimensionality");
+    }
+    yarp::sig::Matrix output(input.rows(), this->getCoDomainSize());
+    for(int r = 0; r < input.rows(); r++) {
+        this->transformSample(input[r], output[r]);
+    }
+    this->sampleCount += input.rows();
     return output;
 }
 
+void RandomFeature::transformSample(const double* input, double* output) const {
+    // python: x_f = numpy.cos(numpy.dot(self.W, x) + self.bias) / math.sqrt(self.nproj)
+    const size_t cod = this->getCoDomainSize();
+    const size_t dom = this->getDomainSize();
+    const double factor = 1. / std::sqrt((double) cod);
+
+    // the projections are accumulated by rows of W^T in chunks that fit on the stack
+    const size_t chunk = 64;
+    double proj[chunk];
+    for(size_t first = 0; first < cod; first += chunk) {
+        const size_t len = std::min(chunk, cod - first);
+        std::copy(this->b.data() + first, this->b.data() + first + len, proj);
+        for(size_t j = 0; j < dom; j++) {
+            const double xj = input[j];
+            const double* wt = this->Wt[j] + first;
+            for(size_t i = 0; i < len; i++) {
+                proj[i] += xj * wt[i];
+            }
+        }
+
+        cosvec(proj, output + first, len);
+        for(size_t i = 0; i < len; i++) {
+            output[first + i] *= factor;
+        }
+    }
+}
+
 void RandomFeature::setDomainSize(unsigned int size) {
     // call method in base class
     this->IFixedSizeTransformer::setDomainSize(size);
@@ -77,6 +125,7 @@ void RandomFeature::reset() {
     this->W = sqrt(2 * this->gamma) * random(this->getCoDomainSize(), this->getDomainSize(), prng_normal);
 
     this->b = TWOPI * random(this->getCoDomainSize(), prng_uniform);
+    this->Wt = this->W.transposed();
 }
 
 void RandomFeature::writeBottle(yarp::os::Bottle& bot) const {
@@ -90,6 +139,7 @@ void RandomFeature::readBottle(yarp::os::Bottle& bot) {
     this->IFixedSizeTransformer::readBottle(bot);
     // do _not_ use public accessor, as it resets the matrix
     bot >> W >> this->b >> this->gamma;
+    this->Wt = this->W.transposed();
 }
 
 
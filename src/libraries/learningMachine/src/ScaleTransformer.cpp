@@ -146,11 +146,11 @@ std::string ScaleTransformer::getConfigHelp() {
     return buffer.str();
 }
 
-void ScaleTransformer::writeBottle(yarp::os::Bottle& bot) {
+void ScaleTransformer::writeBottle(yarp::os::Bottle& bot) const {
     // write all scalers
     for(unsigned int i = 0; i < this->getDomainSize(); i++) {
-        bot.addString(this->getAt(i)->toString().c_str());
-        bot.addString(this->getAt(i)->getName().c_str());
+        bot.addString(this->scalers[i]->toString().c_str());
+        bot.addString(this->scalers[i]->getName().c_str());
     }
 
     // make sure to call the superclass's method
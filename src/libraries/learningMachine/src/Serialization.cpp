@@ -16,12 +16,48 @@
  * Public License for more details
  */
 
+#include <cstring>
+#include <stdexcept>
+
+#include <yarp/os/Value.h>
+
 #include "iCub/learningMachine/Serialization.h"
 
 namespace iCub {
 namespace learningmachine {
 namespace serialization {
 
+/**
+ * Pushes an array of doubles as a single blob, which is much faster to write
+ * and to parse than one value per element.
+ */
+static void addBlob(yarp::os::Bottle &out, const double* data, size_t count) {
+    // a blob needs a valid pointer, even when it is empty
+    static double empty = 0.;
+    void* p = (count > 0) ? (void*) data : (void*) &empty;
+    out.add(yarp::os::Value(p, (int) (count * sizeof(double))));
+}
+
+/**
+ * Pops an array of doubles written by addBlob().
+ *
+ * @return false if the last element is not a blob
+ * @exception std::runtime_error if the blob does not have the expected size
+ */
+static bool popBlob(yarp::os::Bottle &in, double* data, size_t count) {
+    if(in.size() == 0 || !in.get(in.size() - 1).isBlob()) {
+        return false;
+    }
+    yarp::os::Value blob = in.pop();
+    if((size_t) blob.asBlobLength() != count * sizeof(double)) {
+        throw std::runtime_error("blob does not match the serialized dimensions");
+    }
+    if(count > 0) {
+        std::memcpy(data, blob.asBlob(), count * sizeof(double));
+    }
+    return true;
+}
+
 yarp::os::Bottle& operator<<(yarp::os::Bottle &out, int val) {
     out.addInt32(val);
     return out;
@@ -38,19 +74,13 @@ yarp::os::Bottle& operator<<(yarp::os::Bottle &out, double val) {
 }
 
 yarp::os::Bottle& operator<<(yarp::os::Bottle &out, const yarp::sig::Vector& v) {
-    for(size_t i = 0; i < v.size(); i++) {
-        out << v(i);
-    }
+    addBlob(out, v.data(), v.size());
     out << (int)v.size();
     return out;
 }
 
 yarp::os::Bottle& operator<<(yarp::os::Bottle &out, const yarp::sig::Matrix& M) {
-    for(int r = 0; r < M.rows(); r++) {
-        for(int c = 0; c < M.cols(); c++) {
-            out << M(r,c);
-        }
-    }
+    addBlob(out, M.data(), (size_t)M.rows() * M.cols());
     out << M.rows() << M.cols();
     return out;
 }
@@ -69,8 +99,11 @@ yarp::os::Bottle& operator>>(yarp::os::Bottle &in, yarp::sig::Vector& v) {
     int len;
     in >> len;
     v.resize(len);
-    for(int i = v.size() - 1; i >= 0; i--) {
-        in >> v(i);
+    if(!popBlob(in, v.data(), v.size())) {
+        // element-wise layout of older serializations
+        for(int i = v.size() - 1; i >= 0; i--) {
+            in >> v(i);
+        }
     }
     return in;
 }
@@ -79,16 +112,18 @@ yarp::os::Bottle& operator>>(yarp::os::Bottle &in, yarp::sig::Matrix& M) {
     int rows, cols;
     in >> cols >> rows;
     M.resize(rows, cols);
-    for(int r = M.rows() - 1; r >= 0; r--) {
-        for(int c = M.cols() - 1; c >= 0; c--) {
-            in >> M(r, c);
+    if(!popBlob(in, M.data(), (size_t)rows * cols)) {
+        // element-wise layout of older serializations
+        for(int r = M.rows() - 1; r >= 0; r--) {
+            for(int c = M.cols() - 1; c >= 0; c--) {
+                in >> M(r, c);
+            }
         }
     }
     return in;
 }
 
 
-
 } // serialization
 } // learningmachine
 } // iCub
@@ -51,17 +51,60 @@ SparseSpectrumFeature::SparseSpectrumFeature(unsigned int dom, unsigned int cod,
 
 yarp::sig::Vector SparseSpectrumFeature::transform(const yarp::sig::Vector& input) {
     yarp::sig::Vector output = this->IFixedSizeTransformer::transform(input);
+    this->transformSample(input.data(), output.data());
+    return output;
+}
 
-    yarp::sig::Vector inputW = (this->W * input);
-    int nproj = this->getCoDomainSize() >> 1;
-    double factor = this->sigma / sqrt((double)nproj);
-    for(int i = 0; i < nproj; i++) {
-        output(i)       = cos(inputW(i)) * factor;
-        output(i+nproj) = sin(inputW(i)) * factor;
+void SparseSpectrumFeature::transform(const yarp::sig::Vector& input, yarp::sig::Vector& output) {
+    this->ITransformer::transform(input);
+    if(output.size() != this->getCoDomainSize()) {
+        output.resize(this->getCoDomainSize());
     }
+    this->validateDomainSizes(input, output);
+    this->transformSample(input.data(), output.data());
+}
+
+yarp::sig::Matrix SparseSpectrumFeature::transform(const yarp::sig::Matrix& input) {
+    if(input.cols() != (int)this->getDomainSize()) {
+        throw std::runtime_error("Input sample has invalid dimensionality");
+    }
+    yarp::sig::Matrix output(input.rows(), this->getCoDomainSize());
+    for(int r = 0; r < input.rows(); r++) {
+        this->transformSample(input[r], output[r]);
+    }
+    this->sampleCount += input.rows();
     return output;
 }
 
+void SparseSpectrumFeature::transformSample(const double* input, double* output) const {
+    const size_t nproj = this->getCoDomainSize() >> 1;
+    const size_t dom = this->getDomainSize();
+    const double factor = this->sigma / sqrt((double)nproj);
+
+    // the projections are accumulated by rows of W^T in chunks that fit on the stack
+    const size_t chunk = 64;
+    double proj[chunk];
+    for(size_t first = 0; first < nproj; first += chunk) {
+        const size_t len = std::min(chunk, nproj - first);
+        std::fill(proj, proj + len, 0.);
+        for(size_t j = 0; j < dom; j++) {
+            const double xj = input[j];
+            const double* wt = this->Wt[j] + first;
+            for(size_t i = 0; i < len; i++) {
+                proj[i] += xj * wt[i];
+            }
+        }
+
+        double* cosines = output + first;
+        double* sines = output + nproj + first;
+        sincosvec(proj, sines, cosines, len);
+        for(size_t i = 0; i < len; i++) {
+            cosines[i] *= factor;
+            sines[i] *= factor;
+        }
+    }
+}
+
 void SparseSpectrumFeature::setDomainSize(unsigned int size) {
     // call method in base class
     this->IFixedSizeTransformer::setDomainSize(size);
@@ -95,10 +138,11 @@ void SparseSpectrumFeature::reset() {
             this->W(r, c) = prng_normal.get() / this->ell(c);
         }
     }
+    this->Wt = this->W.transposed();
 }
 
-void SparseSpectrumFeature::writeBottle(yarp::os::Bottle& bot) {
-    bot << this->getSigma() << this->ell << this->W;
+void SparseSpectrumFeature::writeBottle(yarp::os::Bottle& bot) const {
+    bot << this->sigma << this->ell << this->W;
 
     // make sure to call the superclass's method
     this->IFixedSizeTransformer::writeBottle(bot);
@@ -111,6 +155,7 @@ void SparseSpectrumFeature::readBottle(yarp::os::Bottle& bot) {
     // directly write to sigma to prevent resetting W
     bot >> this->W >> this->ell >> this->sigma;
     this->setSigma(sigma);
+    this->Wt = this->W.transposed();
 }
 
 void SparseSpectrumFeature::setEll(yarp::sig::Vector& ell) {
@@ -30,6 +30,7 @@
 #define __ICUB_OPT_AFFINITY_H__
 
 #include <deque>
+#include <vector>
 #include <yarp/os/all.h>
 #include <yarp/sig/all.h>
 #include <iCub/optimization/matrixTransformation.h>
@@ -44,8 +45,12 @@ namespace optimization
 * @ingroup Affinity
 *
 * A class that deals with the problem of determining the affine 
-* transformation matrix A between two sets of matching 3D points
-* employing IpOpt. 
+* transformation matrix A between two sets of matching 3D points. 
+*  
+* The linear least-squares solution is returned whenever it lies 
+* within the bounds; otherwise IpOpt is employed, starting both 
+* from the clamped least-squares solution and from the initial 
+* guess. 
 */
 class AffinityWithMatchedPoints : public MatrixTransformationWithMatchedPoints
 {
@@ -56,8 +61,9 @@ protected:
     int max_iter;
     double tol;
     
-    std::deque<yarp::sig::Vector> p0;
-    std::deque<yarp::sig::Vector> p1;
+    // the (x,y,z) triplets stored contiguously
+    std::vector<double> p0;
+    std::vector<double> p1;
 
     double evalError(const yarp::sig::Matrix &A);
 
@@ -92,7 +98,7 @@ public:
     * the internal database. 
     * @return the number of pairs. 
     */
-    virtual size_t getNumPoints() const { return p0.size(); }
+    virtual size_t getNumPoints() const { return p0.size()/3; }
 
     /**
     * Retrieve copies of the database of 3D-points pairs.
@@ -28,6 +28,7 @@
 #define __ICUB_OPT_CALIBREFERENCE_H__
 
 #include <deque>
+#include <vector>
 #include <yarp/os/all.h>
 #include <yarp/sig/all.h>
 #include <iCub/optimization/matrixTransformation.h>
@@ -43,13 +44,21 @@ namespace optimization
 *
 * A class that deals with the problem of determining the 
 * roto-translation matrix H and scaling factors S between two 
-* sets of matching 3D points employing IpOpt. 
+* sets of matching 3D points. 
 *  
 * The problem solved is of the form: 
 *  
 * \f[ 
 * (H,S)=\arg\min_{H\in SE\left(3\right),S\in diag\left(s_1,s_2,s_3,1\right)}\left(\frac{1}{N}\sum_{i=1}^{N} \left \| p_i^{O_1}-S \cdot H \cdot p_i^{O_2} \right \|^2 \right)
 * \f] 
+*  
+* Without scaling or with a scalar scaling factor the solution 
+* is found in closed form (Horn/Umeyama); IpOpt is employed only 
+* if this solution violates the bounds, starting both from the 
+* clamped closed-form solution and from the initial guess. With 
+* three scaling factors IpOpt is always employed. The cost and 
+* its gradient are computed from the moments of the points, 
+* which are accumulated once for all the iterations. 
 */
 class CalibReferenceWithMatchedPoints : public MatrixTransformationWithMatchedPoints
 {
@@ -64,8 +73,9 @@ protected:
     double max_s_scalar;
     double s0_scalar;
 
-    std::deque<yarp::sig::Vector> p0;
-    std::deque<yarp::sig::Vector> p1;
+    // the (x,y,z) triplets stored contiguously
+    std::vector<double> p0;
+    std::vector<double> p1;
 
     double evalError(const yarp::sig::Matrix &H);
 
@@ -143,7 +153,7 @@ public:
     * the internal database. 
     * @return the number of pairs. 
     */
-    virtual size_t getNumPoints() const { return p0.size(); }
+    virtual size_t getNumPoints() const { return p0.size()/3; }
 
     /**
     * Retrieve copies of the database of 3D-points pairs.
@@ -44,11 +44,19 @@ namespace iCub
 namespace optimization
 {
 
+class ff2LayNNTrainCost;
+
 /**
 * @ingroup nnTraining
 *
 * Class to deal with training of Feed-Forward 2 layers Neural 
 * Network using IpOpt. 
+*  
+* The samples are stored contiguously and the cost along with 
+* its gradient (by back-propagation) are evaluated splitting the
+* samples among threads. For large datasets a stochastic 
+* mini-batch optimizer (Adam, projected onto the bounds) can be 
+* employed in place of IpOpt. 
 */
 class ff2LayNNTrain: virtual public iCub::ctrl::ff2LayNN
 {
@@ -56,6 +64,13 @@ protected:
     yarp::os::Property bounds;
     void* App;
 
+    unsigned int threads;
+    int    batchSize;
+    int    epochs;
+    double learningRate;
+
+    friend class ff2LayNNTrainCost;
+
 public:
     /**
     * Default constructor.
@@ -71,6 +86,23 @@ public:
     */
     void setBounds(const yarp::os::Property &bounds);
 
+    /**
+    * Allow setting further options used during training.
+    * @param options a property-like object containing the options:
+    *                <b>threads</b> the number of threads the
+    *                samples are split among (0 for all the cores,
+    *                the default); <b>batch_size</b> the number of
+    *                samples of each step of the mini-batch
+    *                optimizer, which replaces IpOpt if positive and
+    *                lower than the number of samples (default 0);
+    *                <b>epochs</b> the number of passes of the
+    *                mini-batch optimizer over the samples (default
+    *                100); <b>learning_rate</b> its step size (default
+    *                0.001); <b>max_iter</b> and <b>tol</b> for
+    *                IpOpt.
+    */
+    void setTrainingOptions(const yarp::os::Property &options);
+
     /**
     * Train the network through optimization. 
     * @param numHiddenNodes is the number of hidden nodes. 
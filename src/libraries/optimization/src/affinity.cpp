@@ -15,9 +15,12 @@
  * Public License for more details
 */
 
+#include <cmath>
+#include <limits>
 #include <algorithm>
 
 #include <yarp/math/Math.h>
+#include <yarp/math/SVD.h>
 #include <iCub/ctrl/math.h>
 #include <iCub/optimization/affinity.h>
 
@@ -50,14 +53,97 @@ inline Matrix computeA(const Ipopt::Number *x)
 }
 
 
+/****************************************************************/
+class AffinityMoments
+{
+public:
+    // the mean squared error over the points depends on A only
+    // through the moments: N*f(A)=m11-2*<A,M10>+<A*M00,A>, with
+    // M00=sum(p0*p0'), M10=sum(p1*p0') and m11=sum(p1'*p1) in
+    // homogeneous form, which are thus accumulated once
+    double N;
+    double m11;
+    Matrix M00;
+    Matrix M10;
+
+    /****************************************************************/
+    AffinityMoments(const vector<double> &p0, const vector<double> &p1)
+    {
+        double m00[4][4]={{0.0}};
+        double m10[4][4]={{0.0}};
+
+        m11=0.0;
+        size_t n=p0.size()/3;
+        for (size_t i=0; i<n; i++)
+        {
+            const double *a=&p0[3*i];
+            const double *b=&p1[3*i];
+            for (int r=0; r<3; r++)
+            {
+                for (int c=0; c<3; c++)
+                {
+                    m00[r][c]+=a[r]*a[c];
+                    m10[r][c]+=b[r]*a[c];
+                }
+
+                m00[r][3]+=a[r];
+                m10[r][3]+=b[r];
+                m10[3][r]+=a[r];
+                m11+=b[r]*b[r];
+            }
+        }
+
+        N=(double)n;
+        m11+=N;
+
+        M00.resize(4,4); M10.resize(4,4);
+        for (int r=0; r<3; r++)
+        {
+            for (int c=0; c<4; c++)
+            {
+                M00(r,c)=m00[r][c];
+                M10(r,c)=m10[r][c];
+            }
+
+            M00(3,r)=m00[r][3];
+            M10(3,r)=m10[3][r];
+        }
+        M00(3,3)=M10(3,3)=N;
+    }
+
+    /****************************************************************/
+    double f(const Matrix &A) const
+    {
+        double ret=m11;
+        Matrix AM00=A*M00;
+        for (int r=0; r<4; r++)
+            for (int c=0; c<4; c++)
+                ret+=(AM00(r,c)-2.0*M10(r,c))*A(r,c);
+
+        return (N>0.0)?ret/N:0.0;
+    }
+
+    /****************************************************************/
+    Matrix df(const Matrix &A) const
+    {
+        return (N>0.0)?(2.0/N)*(A*M00-M10):zeros(4,4);
+    }
+
+    /****************************************************************/
+    Matrix leastSquares() const
+    {
+        // the unconstrained minimum solves A*M00=M10
+        return M10*pinv(M00);
+    }
+};
+
+
 /****************************************************************/
 class AffinityWithMatchedPointsNLP : public Ipopt::TNLP
 {
 protected:    
-    const deque<Vector> &p0;
-    const deque<Vector> &p1;
+    const AffinityMoments &moments;
 
-    deque<Matrix> dA;
     Matrix min;
     Matrix max;
     Matrix A0;
@@ -65,23 +151,13 @@ protected:
 
 public:
     /****************************************************************/
-    AffinityWithMatchedPointsNLP(const deque<Vector> &_p0,
-                                 const deque<Vector> &_p1,
+    AffinityWithMatchedPointsNLP(const AffinityMoments &_moments,
                                  const Matrix &_min, const Matrix &_max) :
-                                 p0(_p0), p1(_p1)
+                                 moments(_moments)
     {
         min=_min;
         max=_max;
         A0=0.5*(min+max);
-        
-        for (int c=0; c<A0.cols(); c++)
-        {
-            for (int r=0; r<A0.rows()-1; r++)
-            {
-                Matrix dA=zeros(4,4); dA(r,c)=1.0;
-                this->dA.push_back(dA);
-            }
-        }
     }
 
     /****************************************************************/
@@ -146,17 +222,7 @@ public:
     bool eval_f(Ipopt::Index n, const Ipopt::Number *x, bool new_x,
                 Ipopt::Number &obj_value)
     {
-        Matrix A=computeA(x);
-
-        obj_value=0.0;
-        if (p0.size()>0)
-        {
-            for (size_t i=0; i<p0.size(); i++)
-                obj_value+=norm2(p1[i]-A*p0[i]);
-
-            obj_value/=p0.size();
-        }
-
+        obj_value=moments.f(computeA(x));
         return true;
     }
     
@@ -164,21 +230,14 @@ public:
     bool eval_grad_f(Ipopt::Index n, const Ipopt::Number* x, bool new_x,
                      Ipopt::Number *grad_f)
     {
-        Matrix A=computeA(x);
-        for (Ipopt::Index i=0; i<n; i++)
-            grad_f[i]=0.0;
+        // the variables are the elements of A
+        Matrix G=moments.df(computeA(x));
 
-        if (p0.size()>0)
+        Ipopt::Index i=0;
+        for (int c=0; c<G.cols(); c++)
         {
-            for (size_t i=0; i<p0.size(); i++)
-            {
-                Vector d=p1[i]-A*p0[i];
-                for (Ipopt::Index j=0; j<n; j++)
-                    grad_f[j]-=2.0*dot(d,(dA[j]*p0[i]));
-            }
-
-            for (Ipopt::Index i=0; i<n; i++)
-                grad_f[i]/=p0.size();
+            for (int r=0; r<G.rows()-1; r++)
+                grad_f[i++]=G(r,c);
         }
 
         return true;
@@ -265,12 +324,25 @@ void AffinityWithMatchedPoints::setBounds(const Matrix &min,
 double AffinityWithMatchedPoints::evalError(const Matrix &A)
 {
     double error=0.0;
-    if (p0.size()>0)
+    size_t n=getNumPoints();
+    if (n>0)
     {
-        for (size_t i=0; i<p0.size(); i++)
-            error+=norm(p1[i]-A*p0[i]);
+        for (size_t i=0; i<n; i++)
+        {
+            const double *a=&p0[3*i];
+            const double *b=&p1[3*i];
+
+            double e2=0.0;
+            for (int r=0; r<3; r++)
+            {
+                double e=b[r]-(A(r,0)*a[0]+A(r,1)*a[1]+A(r,2)*a[2]+A(r,3));
+                e2+=e*e;
+            }
 
-        error/=p0.size();
+            error+=sqrt(e2);
+        }
+
+        error/=n;
     }
 
     return error;
@@ -283,11 +355,8 @@ bool AffinityWithMatchedPoints::addPoints(const Vector &p0,
 {
     if ((p0.length()>=3) && (p1.length()>=3))
     {
-        Vector _p0=p0.subVector(0,2); _p0.push_back(1.0);
-        Vector _p1=p1.subVector(0,2); _p1.push_back(1.0);
-
-        this->p0.push_back(_p0);
-        this->p1.push_back(_p1);
+        this->p0.insert(this->p0.end(),p0.data(),p0.data()+3);
+        this->p1.insert(this->p1.end(),p1.data(),p1.data()+3);
 
         return true;
     }
@@ -300,8 +369,17 @@ bool AffinityWithMatchedPoints::addPoints(const Vector &p0,
 void AffinityWithMatchedPoints::getPoints(deque<Vector> &p0,
                                           deque<Vector> &p1) const
 {
-    p0=this->p0;
-    p1=this->p1;
+    p0.clear();
+    p1.clear();
+
+    for (size_t i=0; i<getNumPoints(); i++)
+    {
+        Vector _p0(3,&this->p0[3*i]); _p0.push_back(1.0);
+        Vector _p1(3,&this->p1[3*i]); _p1.push_back(1.0);
+
+        p0.push_back(_p0);
+        p1.push_back(_p1);
+    }
 }
 
 
@@ -342,6 +420,34 @@ bool AffinityWithMatchedPoints::calibrate(Matrix &A, double &error)
 {
     if (p0.size()>0)
     {
+        AffinityMoments moments(p0,p1);
+
+        // the linear least-squares solution is the global minimum:
+        // IpOpt is needed only if it falls outside the bounds, and
+        // then it is run also from the clamped least-squares solution
+        Matrix Als=moments.leastSquares();
+        Matrix Aclamped=Als;
+        bool inBounds=true;
+        for (int c=0; c<Als.cols(); c++)
+        {
+            for (int r=0; r<Als.rows()-1; r++)
+            {
+                if ((Als(r,c)<min(r,c)) || (Als(r,c)>max(r,c)))
+                {
+                    Aclamped(r,c)=std::max(min(r,c),std::min(max(r,c),Als(r,c)));
+                    inBounds=false;
+                }
+            }
+        }
+
+        if (inBounds)
+        {
+            A=eye(4,4);
+            A.setSubmatrix(Als.submatrix(0,2,0,3),0,0);
+            error=evalError(A);
+            return true;
+        }
+
         Ipopt::SmartPtr<Ipopt::IpoptApplication> app=new Ipopt::IpoptApplication;
         app->Options()->SetNumericValue("tol",tol);
         app->Options()->SetIntegerValue("acceptable_iter",0);
@@ -356,18 +462,33 @@ bool AffinityWithMatchedPoints::calibrate(Matrix &A, double &error)
         app->Options()->SetStringValue("derivative_test","none");
         app->Initialize();
 
-        Ipopt::SmartPtr<AffinityWithMatchedPointsNLP> nlp=new AffinityWithMatchedPointsNLP(p0,p1,min,max);
+        Ipopt::SmartPtr<AffinityWithMatchedPointsNLP> nlp=new AffinityWithMatchedPointsNLP(moments,min,max);
+
+        Matrix starts[2]={Aclamped,A0};
+        Ipopt::ApplicationReturnStatus ret=Ipopt::Internal_Error;
+        double fBest=std::numeric_limits<double>::max();
+        for (int i=0; i<2; i++)
+        {
+            nlp->set_A0(starts[i]);
+            Ipopt::ApplicationReturnStatus status=app->OptimizeTNLP(GetRawPtr(nlp));
+
+            Matrix Ai=nlp->get_result();
+            if (Ai.rows()<4)
+                continue;
 
-        nlp->set_A0(A0);
-        Ipopt::ApplicationReturnStatus status=app->OptimizeTNLP(GetRawPtr(nlp));
+            double fi=moments.f(Ai);
+            if (fi<fBest)
+            {
+                fBest=fi;
+                A=Ai;
+                ret=status;
+            }
+        }
 
-        A=nlp->get_result();
         error=evalError(A);
 
-        return (status==Ipopt::Solve_Succeeded);
+        return (ret==Ipopt::Solve_Succeeded);
     }
     else
         return false;
 }
-
-
@@ -16,9 +16,11 @@
 */
 
 #include <cmath>
+#include <limits>
 #include <algorithm>
 
 #include <yarp/math/Math.h>
+#include <yarp/math/SVD.h>
 #include <iCub/ctrl/math.h>
 #include <iCub/optimization/calibReference.h>
 
@@ -60,28 +62,198 @@ inline Matrix computeH(const Ipopt::Number *x)
 }
 
 
+/****************************************************************/
+inline double innerProduct(const Matrix &A, const Matrix &B)
+{
+    double ret=0.0;
+    for (int r=0; r<A.rows(); r++)
+        for (int c=0; c<A.cols(); c++)
+            ret+=A(r,c)*B(r,c);
+
+    return ret;
+}
+
+
+/****************************************************************/
+class CalibReferenceMoments
+{
+public:
+    // the mean squared error over the points depends on the
+    // transformation A only through the moments:
+    // N*f(A)=m11-2*<A,M10>+<A*M00,A>, with M00=sum(p0*p0'),
+    // M10=sum(p1*p0') and m11=sum(p1'*p1) in homogeneous form,
+    // which are thus accumulated once over all the points
+    double N;
+    double m11;
+    Matrix M00;
+    Matrix M10;
+
+    /****************************************************************/
+    CalibReferenceMoments(const vector<double> &p0, const vector<double> &p1)
+    {
+        double m00[4][4]={{0.0}};
+        double m10[4][4]={{0.0}};
+
+        m11=0.0;
+        size_t n=p0.size()/3;
+        for (size_t i=0; i<n; i++)
+        {
+            const double *a=&p0[3*i];
+            const double *b=&p1[3*i];
+            for (int r=0; r<3; r++)
+            {
+                for (int c=0; c<3; c++)
+                {
+                    m00[r][c]+=a[r]*a[c];
+                    m10[r][c]+=b[r]*a[c];
+                }
+
+                m00[r][3]+=a[r];
+                m10[r][3]+=b[r];
+                m10[3][r]+=a[r];
+                m11+=b[r]*b[r];
+            }
+        }
+
+        N=(double)n;
+        m11+=N;
+
+        M00.resize(4,4); M10.resize(4,4);
+        for (int r=0; r<3; r++)
+        {
+            for (int c=0; c<4; c++)
+            {
+                M00(r,c)=m00[r][c];
+                M10(r,c)=m10[r][c];
+            }
+
+            M00(3,r)=m00[r][3];
+            M10(3,r)=m10[3][r];
+        }
+        M00(3,3)=M10(3,3)=N;
+    }
+
+    /****************************************************************/
+    double f(const Matrix &A) const
+    {
+        return (N>0.0)?(m11-2.0*innerProduct(A,M10)+innerProduct(A*M00,A))/N:0.0;
+    }
+
+    /****************************************************************/
+    Matrix df(const Matrix &A) const
+    {
+        return (N>0.0)?(2.0/N)*(A*M00-M10):zeros(4,4);
+    }
+
+    /****************************************************************/
+    Vector centroid0() const
+    {
+        Vector c(3);
+        for (int i=0; i<3; i++)
+            c[i]=M00(i,3)/N;
+
+        return c;
+    }
+
+    /****************************************************************/
+    Vector centroid1() const
+    {
+        Vector c(3);
+        for (int i=0; i<3; i++)
+            c[i]=M10(i,3)/N;
+
+        return c;
+    }
+
+    /****************************************************************/
+    bool umeyama(Matrix &R, double &s) const
+    {
+        // closed-form least-squares rotation and scalar scaling such
+        // that p1=s*R*p0+t (S. Umeyama, IEEE TPAMI 1991); the optimal
+        // translation is then t=c1-s*R*c0, or t=c1-R*c0 if unscaled
+        if (N<1.0)
+            return false;
+
+        Vector c0=centroid0();
+        Vector c1=centroid1();
+
+        Matrix Sigma(3,3);
+        double var0=0.0;
+        for (int r=0; r<3; r++)
+        {
+            for (int c=0; c<3; c++)
+                Sigma(r,c)=M10(r,c)/N-c1[r]*c0[c];
+
+            var0+=M00(r,r)/N-c0[r]*c0[r];
+        }
+
+        Matrix U(3,3),V(3,3); Vector d(3);
+        SVD(Sigma,U,d,V);
+
+        Matrix D=eye(3,3);
+        if (det(U)*det(V)<0.0)
+            D(2,2)=-1.0;
+
+        R=U*D*V.transposed();
+        s=(var0>0.0)?(d[0]*D(0,0)+d[1]*D(1,1)+d[2]*D(2,2))/var0:1.0;
+
+        return true;
+    }
+};
+
+
 /****************************************************************/
 class CalibReferenceWithMatchedPointsNLP : public Ipopt::TNLP
 {
 protected:
-    const deque<Vector> &p0;
-    const deque<Vector> &p1;
+    const CalibReferenceMoments &moments;
 
     Vector min;
     Vector max;
     Vector x0;
     Vector x;
+    double f;
+
+    /****************************************************************/
+    void computeDerivatives(const Ipopt::Number *x, Matrix dHdx[6]) const
+    {
+        double ca=cos(x[3]);  double sa=sin(x[3]);
+        double cb=cos(x[4]);  double sb=sin(x[4]);
+        double cg=cos(x[5]);  double sg=sin(x[5]);
+
+        Matrix Rza=eye(4,4);
+        Rza(0,0)=ca;   Rza(1,1)=ca;   Rza(1,0)=sa;   Rza(0,1)=-sa;
+        Matrix dRza=zeros(4,4);
+        dRza(0,0)=-sa; dRza(1,1)=-sa; dRza(1,0)=ca;  dRza(0,1)=-ca;
+
+        Matrix Rzg=eye(4,4);
+        Rzg(0,0)=cg;   Rzg(1,1)=cg;   Rzg(1,0)=sg;   Rzg(0,1)=-sg;
+        Matrix dRzg=zeros(4,4);
+        dRzg(0,0)=-sg; dRzg(1,1)=-sg; dRzg(1,0)=cg;  dRzg(0,1)=-cg;
+
+        Matrix Ryb=eye(4,4);
+        Ryb(0,0)=cb;   Ryb(2,2)=cb;   Ryb(2,0)=-sb;  Ryb(0,2)=sb;
+        Matrix dRyb=zeros(4,4);
+        dRyb(0,0)=-sb; dRyb(2,2)=-sb; dRyb(2,0)=-cb; dRyb(0,2)=cb;
+
+        dHdx[0]=zeros(4,4); dHdx[0](0,3)=1.0;
+        dHdx[1]=zeros(4,4); dHdx[1](1,3)=1.0;
+        dHdx[2]=zeros(4,4); dHdx[2](2,3)=1.0;
+        dHdx[3]=dRza*Ryb*Rzg;
+        dHdx[4]=Rza*dRyb*Rzg;
+        dHdx[5]=Rza*Ryb*dRzg;
+    }
 
 public:
     /****************************************************************/
-    CalibReferenceWithMatchedPointsNLP(const deque<Vector> &_p0,
-                                       const deque<Vector> &_p1,
+    CalibReferenceWithMatchedPointsNLP(const CalibReferenceMoments &_moments,
                                        const Vector &_min, const Vector &_max) :
-                                       p0(_p0), p1(_p1)
+                                       moments(_moments)
     {
         min=_min;
         max=_max;
         x0=0.5*(min+max);
+        f=std::numeric_limits<double>::max();
     }
 
     /****************************************************************/
@@ -90,6 +262,9 @@ public:
         size_t len=std::min(this->x0.length(),x0.length());
         for (size_t i=0; i<len; i++)
             this->x0[i]=x0[i];
+
+        x.resize(0);
+        f=std::numeric_limits<double>::max();
     }
 
     /****************************************************************/
@@ -98,6 +273,12 @@ public:
         return x;
     }
 
+    /****************************************************************/
+    virtual double get_cost() const
+    {
+        return f;
+    }
+
     /****************************************************************/
     bool get_nlp_info(Ipopt::Index &n, Ipopt::Index &m, Ipopt::Index &nnz_jac_g,
                       Ipopt::Index &nnz_h_lag, IndexStyleEnum &index_style)
@@ -137,17 +318,7 @@ public:
     bool eval_f(Ipopt::Index n, const Ipopt::Number *x, bool new_x,
                 Ipopt::Number &obj_value)
     {
-        Matrix H=computeH(x);
-
-        obj_value=0.0;
-        if (p0.size()>0)
-        {
-            for (size_t i=0; i<p0.size(); i++)
-                obj_value+=norm2(p1[i]-H*p0[i]);
-
-            obj_value/=p0.size();
-        }
-
+        obj_value=moments.f(computeH(x));
         return true;
     }
     
@@ -155,51 +326,12 @@ public:
     bool eval_grad_f(Ipopt::Index n, const Ipopt::Number* x, bool new_x,
                      Ipopt::Number *grad_f)
     {
-        double ca=cos(x[3]);  double sa=sin(x[3]);
-        double cb=cos(x[4]);  double sb=sin(x[4]);
-        double cg=cos(x[5]);  double sg=sin(x[5]);
+        Matrix dHdx[6];
+        computeDerivatives(x,dHdx);
 
-        Matrix Rza=eye(4,4);
-        Rza(0,0)=ca;   Rza(1,1)=ca;   Rza(1,0)=sa;   Rza(0,1)=-sa;
-        Matrix dRza=zeros(4,4);
-        dRza(0,0)=-sa; dRza(1,1)=-sa; dRza(1,0)=ca;  dRza(0,1)=-ca;
-
-        Matrix Rzg=eye(4,4);
-        Rzg(0,0)=cg;   Rzg(1,1)=cg;   Rzg(1,0)=sg;   Rzg(0,1)=-sg;
-        Matrix dRzg=zeros(4,4);
-        dRzg(0,0)=-sg; dRzg(1,1)=-sg; dRzg(1,0)=cg;  dRzg(0,1)=-cg;
-
-        Matrix Ryb=eye(4,4);
-        Ryb(0,0)=cb;   Ryb(2,2)=cb;   Ryb(2,0)=-sb;  Ryb(0,2)=sb;
-        Matrix dRyb=zeros(4,4);
-        dRyb(0,0)=-sb; dRyb(2,2)=-sb; dRyb(2,0)=-cb; dRyb(0,2)=cb;
-
-        Matrix dHdx0=zeros(4,4); dHdx0(0,3)=1.0;
-        Matrix dHdx1=zeros(4,4); dHdx1(1,3)=1.0;
-        Matrix dHdx2=zeros(4,4); dHdx2(2,3)=1.0;
-        Matrix dHdx3=dRza*Ryb*Rzg;
-        Matrix dHdx4=Rza*dRyb*Rzg;
-        Matrix dHdx5=Rza*Ryb*dRzg;
-
-        Matrix H=computeH(x);
-        grad_f[0]=grad_f[1]=grad_f[2]=0.0;
-        grad_f[3]=grad_f[4]=grad_f[5]=0.0;
-        if (p0.size()>0)
-        {
-            for (size_t i=0; i<p0.size(); i++)
-            {
-                Vector d=p1[i]-H*p0[i];
-                grad_f[0]-=2.0*dot(d,(dHdx0*p0[i]));
-                grad_f[1]-=2.0*dot(d,(dHdx1*p0[i]));
-                grad_f[2]-=2.0*dot(d,(dHdx2*p0[i]));
-                grad_f[3]-=2.0*dot(d,(dHdx3*p0[i]));
-                grad_f[4]-=2.0*dot(d,(dHdx4*p0[i]));
-                grad_f[5]-=2.0*dot(d,(dHdx5*p0[i]));
-            }
-
-            for (Ipopt::Index i=0; i<n; i++)
-                grad_f[i]/=p0.size();
-        }
+        Matrix G=moments.df(computeH(x));
+        for (Ipopt::Index i=0; i<6; i++)
+            grad_f[i]=innerProduct(G,dHdx[i]);
 
         return true;
     }
@@ -239,6 +371,8 @@ public:
         this->x.resize(n);
         for (Ipopt::Index i=0; i<n; i++)
             this->x[i]=x[i];
+
+        f=obj_value;
     }
 };
 
@@ -248,10 +382,9 @@ class CalibReferenceWithScaledMatchedPointsNLP : public CalibReferenceWithMatche
 {
 public:
     /****************************************************************/
-    CalibReferenceWithScaledMatchedPointsNLP(const deque<Vector> &_p0,
-                                             const deque<Vector> &_p1,
+    CalibReferenceWithScaledMatchedPointsNLP(const CalibReferenceMoments &_moments,
                                              const Vector &_min, const Vector &_max) :
-                                             CalibReferenceWithMatchedPointsNLP(_p0,_p1,_min,_max) { }
+                                             CalibReferenceWithMatchedPointsNLP(_moments,_min,_max) { }
 
     /****************************************************************/
     bool get_nlp_info(Ipopt::Index &n, Ipopt::Index &m, Ipopt::Index &nnz_jac_g,
@@ -267,22 +400,10 @@ public:
     bool eval_f(Ipopt::Index n, const Ipopt::Number *x, bool new_x,
                 Ipopt::Number &obj_value)
     {
-        Matrix H=computeH(x);
-        Vector s(4);
-        s[0]=x[6];
-        s[1]=x[7];
-        s[2]=x[8];
-        s[3]=1.0;
-
-        obj_value=0.0;
-        if (p0.size()>0)
-        {
-            for (size_t i=0; i<p0.size(); i++)
-                obj_value+=norm2(p1[i]-s*(H*p0[i]));
-
-            obj_value/=p0.size();
-        }
+        Matrix S=eye(4,4);
+        S(0,0)=x[6]; S(1,1)=x[7]; S(2,2)=x[8];
 
+        obj_value=moments.f(S*computeH(x));
         return true;
     }
     
@@ -290,64 +411,23 @@ public:
     bool eval_grad_f(Ipopt::Index n, const Ipopt::Number* x, bool new_x,
                      Ipopt::Number *grad_f)
     {
-        double ca=cos(x[3]);  double sa=sin(x[3]);
-        double cb=cos(x[4]);  double sb=sin(x[4]);
-        double cg=cos(x[5]);  double sg=sin(x[5]);
-
-        Matrix Rza=eye(4,4);
-        Rza(0,0)=ca;   Rza(1,1)=ca;   Rza(1,0)=sa;   Rza(0,1)=-sa;
-        Matrix dRza=zeros(4,4);
-        dRza(0,0)=-sa; dRza(1,1)=-sa; dRza(1,0)=ca;  dRza(0,1)=-ca;
-
-        Matrix Rzg=eye(4,4);
-        Rzg(0,0)=cg;   Rzg(1,1)=cg;   Rzg(1,0)=sg;   Rzg(0,1)=-sg;
-        Matrix dRzg=zeros(4,4);
-        dRzg(0,0)=-sg; dRzg(1,1)=-sg; dRzg(1,0)=cg;  dRzg(0,1)=-cg;
-
-        Matrix Ryb=eye(4,4);
-        Ryb(0,0)=cb;   Ryb(2,2)=cb;   Ryb(2,0)=-sb;  Ryb(0,2)=sb;
-        Matrix dRyb=zeros(4,4);
-        dRyb(0,0)=-sb; dRyb(2,2)=-sb; dRyb(2,0)=-cb; dRyb(0,2)=cb;
+        Matrix dHdx[6];
+        computeDerivatives(x,dHdx);
 
-        Matrix dHdx0=zeros(4,4); dHdx0(0,3)=1.0;
-        Matrix dHdx1=zeros(4,4); dHdx1(1,3)=1.0;
-        Matrix dHdx2=zeros(4,4); dHdx2(2,3)=1.0;
-        Matrix dHdx3=dRza*Ryb*Rzg;
-        Matrix dHdx4=Rza*dRyb*Rzg;
-        Matrix dHdx5=Rza*Ryb*dRzg;
+        Matrix S=eye(4,4);
+        S(0,0)=x[6]; S(1,1)=x[7]; S(2,2)=x[8];
 
         Matrix H=computeH(x);
-        Matrix dHdx6=zeros(4,4); dHdx6(0,0)=1.0; dHdx6*=H;
-        Matrix dHdx7=zeros(4,4); dHdx7(1,1)=1.0; dHdx7*=H;
-        Matrix dHdx8=zeros(4,4); dHdx8(2,2)=1.0; dHdx8*=H;
-
-        Vector s(4);
-        s[0]=x[6];
-        s[1]=x[7];
-        s[2]=x[8];
-        s[3]=1.0;
-
-        grad_f[0]=grad_f[1]=grad_f[2]=0.0;
-        grad_f[3]=grad_f[4]=grad_f[5]=0.0;
-        grad_f[6]=grad_f[7]=grad_f[8]=0.0;
-        if (p0.size()>0)
-        {
-            for (size_t i=0; i<p0.size(); i++)
-            {
-                Vector d=p1[i]-s*(H*p0[i]);
-                grad_f[0]-=2.0*dot(d,(dHdx0*p0[i]));
-                grad_f[1]-=2.0*dot(d,(dHdx1*p0[i]));
-                grad_f[2]-=2.0*dot(d,(dHdx2*p0[i]));
-                grad_f[3]-=2.0*dot(d,(dHdx3*p0[i]));
-                grad_f[4]-=2.0*dot(d,(dHdx4*p0[i]));
-                grad_f[5]-=2.0*dot(d,(dHdx5*p0[i]));
-                grad_f[6]-=2.0*dot(d,(dHdx6*p0[i]));
-                grad_f[7]-=2.0*dot(d,(dHdx7*p0[i]));
-                grad_f[8]-=2.0*dot(d,(dHdx8*p0[i]));
-            }
+        Matrix G=moments.df(S*H);
+        for (Ipopt::Index i=0; i<6; i++)
+            grad_f[i]=innerProduct(G,S*dHdx[i]);
 
-            for (Ipopt::Index i=0; i<n; i++)
-                grad_f[i]/=p0.size();
+        // d(S*H)/ds_i has only the i-th row of H
+        for (Ipopt::Index i=0; i<3; i++)
+        {
+            grad_f[6+i]=0.0;
+            for (int c=0; c<4; c++)
+                grad_f[6+i]+=G(i,c)*H(i,c);
         }
 
         return true;
@@ -360,10 +440,9 @@ class CalibReferenceWithScalarScaledMatchedPointsNLP : public CalibReferenceWith
 {
 public:
     /****************************************************************/
-    CalibReferenceWithScalarScaledMatchedPointsNLP(const deque<Vector> &_p0,
-                                                   const deque<Vector> &_p1,
+    CalibReferenceWithScalarScaledMatchedPointsNLP(const CalibReferenceMoments &_moments,
                                                    const Vector &_min, const Vector &_max) :
-                                                   CalibReferenceWithMatchedPointsNLP(_p0,_p1,_min,_max) { }
+                                                   CalibReferenceWithMatchedPointsNLP(_moments,_min,_max) { }
 
     /****************************************************************/
     bool get_nlp_info(Ipopt::Index &n, Ipopt::Index &m, Ipopt::Index &nnz_jac_g,
@@ -379,20 +458,10 @@ public:
     bool eval_f(Ipopt::Index n, const Ipopt::Number *x, bool new_x,
                 Ipopt::Number &obj_value)
     {
-        Matrix H=computeH(x);
-        Vector s(4);
-        s[0]=s[1]=s[2]=x[6];
-        s[3]=1.0;
-
-        obj_value=0.0;
-        if (p0.size()>0)
-        {
-            for (size_t i=0; i<p0.size(); i++)
-                obj_value+=norm2(p1[i]-s*(H*p0[i]));
-
-            obj_value/=p0.size();
-        }
+        Matrix S=eye(4,4);
+        S(0,0)=S(1,1)=S(2,2)=x[6];
 
+        obj_value=moments.f(S*computeH(x));
         return true;
     }
     
@@ -400,63 +469,106 @@ public:
     bool eval_grad_f(Ipopt::Index n, const Ipopt::Number* x, bool new_x,
                      Ipopt::Number *grad_f)
     {
-        double ca=cos(x[3]);  double sa=sin(x[3]);
-        double cb=cos(x[4]);  double sb=sin(x[4]);
-        double cg=cos(x[5]);  double sg=sin(x[5]);
+        Matrix dHdx[6];
+        computeDerivatives(x,dHdx);
 
-        Matrix Rza=eye(4,4);
-        Rza(0,0)=ca;   Rza(1,1)=ca;   Rza(1,0)=sa;   Rza(0,1)=-sa;
-        Matrix dRza=zeros(4,4);
-        dRza(0,0)=-sa; dRza(1,1)=-sa; dRza(1,0)=ca;  dRza(0,1)=-ca;
+        Matrix S=eye(4,4);
+        S(0,0)=S(1,1)=S(2,2)=x[6];
 
-        Matrix Rzg=eye(4,4);
-        Rzg(0,0)=cg;   Rzg(1,1)=cg;   Rzg(1,0)=sg;   Rzg(0,1)=-sg;
-        Matrix dRzg=zeros(4,4);
-        dRzg(0,0)=-sg; dRzg(1,1)=-sg; dRzg(1,0)=cg;  dRzg(0,1)=-cg;
+        Matrix H=computeH(x);
+        Matrix G=moments.df(S*H);
+        for (Ipopt::Index i=0; i<6; i++)
+            grad_f[i]=innerProduct(G,S*dHdx[i]);
 
-        Matrix Ryb=eye(4,4);
-        Ryb(0,0)=cb;   Ryb(2,2)=cb;   Ryb(2,0)=-sb;  Ryb(0,2)=sb;
-        Matrix dRyb=zeros(4,4);
-        dRyb(0,0)=-sb; dRyb(2,2)=-sb; dRyb(2,0)=-cb; dRyb(0,2)=cb;
+        // d(S*H)/ds has the first three rows of H
+        grad_f[6]=0.0;
+        for (int r=0; r<3; r++)
+            for (int c=0; c<4; c++)
+                grad_f[6]+=G(r,c)*H(r,c);
 
-        Matrix dHdx0=zeros(4,4); dHdx0(0,3)=1.0;
-        Matrix dHdx1=zeros(4,4); dHdx1(1,3)=1.0;
-        Matrix dHdx2=zeros(4,4); dHdx2(2,3)=1.0;
-        Matrix dHdx3=dRza*Ryb*Rzg;
-        Matrix dHdx4=Rza*dRyb*Rzg;
-        Matrix dHdx5=Rza*Ryb*dRzg;
+        return true;
+    }
+};
 
-        Matrix H=computeH(x);
-        Matrix dHdx6=zeros(4,4); dHdx6(0,0)=1.0; dHdx6*=H;
 
-        Vector s(4);
-        s[0]=s[1]=s[2]=x[6];
-        s[3]=1.0;
+/****************************************************************/
+inline bool isWithinBounds(const Vector &x, const Vector &min, const Vector &max)
+{
+    for (size_t i=0; i<x.length(); i++)
+        if ((x[i]<min[i]) || (x[i]>max[i]))
+            return false;
 
-        grad_f[0]=grad_f[1]=grad_f[2]=0.0;
-        grad_f[3]=grad_f[4]=grad_f[5]=0.0;
-        grad_f[6]=0.0;
-        if (p0.size()>0)
-        {
-            for (size_t i=0; i<p0.size(); i++)
-            {
-                Vector d=p1[i]-s*(H*p0[i]);
-                grad_f[0]-=2.0*dot(d,(dHdx0*p0[i]));
-                grad_f[1]-=2.0*dot(d,(dHdx1*p0[i]));
-                grad_f[2]-=2.0*dot(d,(dHdx2*p0[i]));
-                grad_f[3]-=2.0*dot(d,(dHdx3*p0[i]));
-                grad_f[4]-=2.0*dot(d,(dHdx4*p0[i]));
-                grad_f[5]-=2.0*dot(d,(dHdx5*p0[i]));
-                grad_f[6]-=2.0*dot(d,(dHdx6*p0[i]));
-            }
+    return true;
+}
 
-            for (Ipopt::Index i=0; i<n; i++)
-                grad_f[i]/=p0.size();
-        }
 
-        return true;
+/****************************************************************/
+inline Vector saturate(const Vector &x, const Vector &min, const Vector &max)
+{
+    Vector y=x;
+    for (size_t i=0; i<y.length(); i++)
+        y[i]=std::max(min[i],std::min(max[i],y[i]));
+
+    return y;
+}
+
+
+/****************************************************************/
+inline Vector closedForm(const CalibReferenceMoments &moments,
+                         const Matrix &R, const double s)
+{
+    // the NLP variables (H translation, euler angles)
+    // for the transformation p1=s*R*p0+t=S*H*p0
+    Matrix H=eye(4,4);
+    H.setSubmatrix(R,0,0);
+
+    Vector t=(moments.centroid1()-s*(R*moments.centroid0()))/s;
+    return cat(t,dcm2euler(H));
+}
+
+
+/****************************************************************/
+inline Ipopt::SmartPtr<Ipopt::IpoptApplication> createApp(const double tol,
+                                                         const int max_iter)
+{
+    Ipopt::SmartPtr<Ipopt::IpoptApplication> app=new Ipopt::IpoptApplication;
+    app->Options()->SetNumericValue("tol",tol);
+    app->Options()->SetIntegerValue("acceptable_iter",0);
+    app->Options()->SetStringValue("mu_strategy","adaptive");
+    app->Options()->SetIntegerValue("max_iter",max_iter);
+    app->Options()->SetStringValue("nlp_scaling_method","gradient-based");
+    app->Options()->SetStringValue("hessian_approximation","limited-memory");
+    app->Options()->SetIntegerValue("print_level",0);
+    app->Options()->SetStringValue("derivative_test","none");
+    app->Initialize();
+
+    return app;
+}
+
+
+/****************************************************************/
+inline Ipopt::ApplicationReturnStatus solve(Ipopt::SmartPtr<Ipopt::IpoptApplication> &app,
+                                            CalibReferenceWithMatchedPointsNLP *nlp,
+                                            const deque<Vector> &starts, Vector &x)
+{
+    // the best solution among the ones found by IpOpt
+    // from each starting point
+    Ipopt::ApplicationReturnStatus ret=Ipopt::Internal_Error;
+    double fBest=std::numeric_limits<double>::max();
+    for (size_t i=0; i<starts.size(); i++)
+    {
+        nlp->set_x0(starts[i]);
+        Ipopt::ApplicationReturnStatus status=app->OptimizeTNLP(nlp);
+        if ((nlp->get_result().length()>0) && (nlp->get_cost()<fBest))
+        {
+            fBest=nlp->get_cost();
+            x=nlp->get_result();
+            ret=status;
+        }
     }
-};
+
+    return ret;
+}
 
 }
 
@@ -551,12 +663,25 @@ void CalibReferenceWithMatchedPoints::setScalingBounds(const double min,
 double CalibReferenceWithMatchedPoints::evalError(const Matrix &H)
 {
     double error=0.0;
-    if (p0.size()>0)
+    size_t n=getNumPoints();
+    if (n>0)
     {
-        for (size_t i=0; i<p0.size(); i++)
-            error+=norm(p1[i]-H*p0[i]);
+        for (size_t i=0; i<n; i++)
+        {
+            const double *a=&p0[3*i];
+            const double *b=&p1[3*i];
+
+            double e2=0.0;
+            for (int r=0; r<3; r++)
+            {
+                double e=b[r]-(H(r,0)*a[0]+H(r,1)*a[1]+H(r,2)*a[2]+H(r,3));
+                e2+=e*e;
+            }
+
+            error+=sqrt(e2);
+        }
 
-        error/=p0.size();
+        error/=n;
     }
 
     return error;
@@ -569,11 +694,8 @@ bool CalibReferenceWithMatchedPoints::addPoints(const Vector &p0,
 {
     if ((p0.length()>=3) && (p1.length()>=3))
     {
-        Vector _p0=p0.subVector(0,2); _p0.push_back(1.0);
-        Vector _p1=p1.subVector(0,2); _p1.push_back(1.0);
-
-        this->p0.push_back(_p0);
-        this->p1.push_back(_p1);
+        this->p0.insert(this->p0.end(),p0.data(),p0.data()+3);
+        this->p1.insert(this->p1.end(),p1.data(),p1.data()+3);
 
         return true;
     }
@@ -586,8 +708,17 @@ bool CalibReferenceWithMatchedPoints::addPoints(const Vector &p0,
 void CalibReferenceWithMatchedPoints::getPoints(deque<Vector> &p0,
                                                 deque<Vector> &p1) const
 {
-    p0=this->p0;
-    p1=this->p1;
+    p0.clear();
+    p1.clear();
+
+    for (size_t i=0; i<getNumPoints(); i++)
+    {
+        Vector _p0(3,&this->p0[3*i]); _p0.push_back(1.0);
+        Vector _p1(3,&this->p1[3*i]); _p1.push_back(1.0);
+
+        p0.push_back(_p0);
+        p1.push_back(_p1);
+    }
 }
 
 
@@ -654,23 +785,35 @@ bool CalibReferenceWithMatchedPoints::calibrate(Matrix &H, double &error)
 {
     if (p0.size()>0)
     {
-        Ipopt::SmartPtr<Ipopt::IpoptApplication> app=new Ipopt::IpoptApplication;
-        app->Options()->SetNumericValue("tol",tol);
-        app->Options()->SetIntegerValue("acceptable_iter",0);
-        app->Options()->SetStringValue("mu_strategy","adaptive");
-        app->Options()->SetIntegerValue("max_iter",max_iter);
-        app->Options()->SetStringValue("nlp_scaling_method","gradient-based");
-        app->Options()->SetStringValue("hessian_approximation","limited-memory");
-        app->Options()->SetIntegerValue("print_level",0);
-        app->Options()->SetStringValue("derivative_test","none");
-        app->Initialize();
+        CalibReferenceMoments moments(p0,p1);
+
+        // the closed-form solution is the global minimum: IpOpt
+        // is needed only if it falls outside the bounds, and then
+        // it is run also from the clamped closed-form solution
+        deque<Vector> starts;
+        Matrix R; double s;
+        if (moments.umeyama(R,s))
+        {
+            Vector x=closedForm(moments,R,1.0);
+            if (isWithinBounds(x,min,max))
+            {
+                H=computeH(x);
+                error=evalError(H);
+                return true;
+            }
+
+            starts.push_back(saturate(x,min,max));
+        }
+        starts.push_back(x0);
 
-        Ipopt::SmartPtr<CalibReferenceWithMatchedPointsNLP> nlp=new CalibReferenceWithMatchedPointsNLP(p0,p1,min,max);
+        Ipopt::SmartPtr<Ipopt::IpoptApplication> app=createApp(tol,max_iter);
+        Ipopt::SmartPtr<CalibReferenceWithMatchedPointsNLP> nlp=new CalibReferenceWithMatchedPointsNLP(moments,min,max);
 
-        nlp->set_x0(x0);
-        Ipopt::ApplicationReturnStatus status=app->OptimizeTNLP(GetRawPtr(nlp));
+        Vector x;
+        Ipopt::ApplicationReturnStatus status=solve(app,GetRawPtr(nlp),starts,x);
+        if (x.length()==0)
+            return false;
 
-        Vector x=nlp->get_result();
         H=computeH(x);
         error=evalError(H);
 
@@ -687,23 +830,29 @@ bool CalibReferenceWithMatchedPoints::calibrate(Matrix &H, Vector &s,
 {
     if (p0.size()>0)
     {
-        Ipopt::SmartPtr<Ipopt::IpoptApplication> app=new Ipopt::IpoptApplication;
-        app->Options()->SetNumericValue("tol",tol);
-        app->Options()->SetIntegerValue("acceptable_iter",0);
-        app->Options()->SetStringValue("mu_strategy","adaptive");
-        app->Options()->SetIntegerValue("max_iter",max_iter);
-        app->Options()->SetStringValue("nlp_scaling_method","gradient-based");
-        app->Options()->SetStringValue("hessian_approximation","limited-memory");
-        app->Options()->SetIntegerValue("print_level",0);
-        app->Options()->SetStringValue("derivative_test","none");
-        app->Initialize();
+        CalibReferenceMoments moments(p0,p1);
+        Vector min=cat(this->min,min_s);
+        Vector max=cat(this->max,max_s);
+
+        // no closed form with three scaling factors: the one with
+        // the scalar scaling factor serves as starting point
+        deque<Vector> starts;
+        Matrix R; double s_;
+        if (moments.umeyama(R,s_) && (s_>0.0))
+        {
+            Vector x=cat(closedForm(moments,R,s_),Vector(3,s_));
+            starts.push_back(saturate(x,min,max));
+        }
+        starts.push_back(cat(x0,s0));
 
-        Ipopt::SmartPtr<CalibReferenceWithScaledMatchedPointsNLP> nlp=new CalibReferenceWithScaledMatchedPointsNLP(p0,p1,cat(min,min_s),cat(max,max_s));
+        Ipopt::SmartPtr<Ipopt::IpoptApplication> app=createApp(tol,max_iter);
+        Ipopt::SmartPtr<CalibReferenceWithScaledMatchedPointsNLP> nlp=new CalibReferenceWithScaledMatchedPointsNLP(moments,min,max);
 
-        nlp->set_x0(cat(x0,s0));
-        Ipopt::ApplicationReturnStatus status=app->OptimizeTNLP(GetRawPtr(nlp));
+        Vector x;
+        Ipopt::ApplicationReturnStatus status=solve(app,GetRawPtr(nlp),starts,x);
+        if (x.length()==0)
+            return false;
 
-        Vector x=nlp->get_result();
         H=computeH(x);
         s=x.subVector(6,8);
         Matrix S=eye(4,4);
@@ -723,23 +872,37 @@ bool CalibReferenceWithMatchedPoints::calibrate(Matrix &H, double &s,
 {
     if (p0.size()>0)
     {
-        Ipopt::SmartPtr<Ipopt::IpoptApplication> app=new Ipopt::IpoptApplication;
-        app->Options()->SetNumericValue("tol",tol);
-        app->Options()->SetIntegerValue("acceptable_iter",0);
-        app->Options()->SetStringValue("mu_strategy","adaptive");
-        app->Options()->SetIntegerValue("max_iter",max_iter);
-        app->Options()->SetStringValue("nlp_scaling_method","gradient-based");
-        app->Options()->SetStringValue("hessian_approximation","limited-memory");
-        app->Options()->SetIntegerValue("print_level",0);
-        app->Options()->SetStringValue("derivative_test","none");
-        app->Initialize();
+        CalibReferenceMoments moments(p0,p1);
+        Vector min=cat(this->min,min_s_scalar);
+        Vector max=cat(this->max,max_s_scalar);
+
+        deque<Vector> starts;
+        Matrix R; double s_;
+        if (moments.umeyama(R,s_) && (s_>0.0))
+        {
+            Vector x=cat(closedForm(moments,R,s_),s_);
+            if (isWithinBounds(x,min,max))
+            {
+                H=computeH(x);
+                s=s_;
+                Matrix S=eye(4,4);
+                S(0,0)=S(1,1)=S(2,2)=s;
+                error=evalError(S*H);
+                return true;
+            }
 
-        Ipopt::SmartPtr<CalibReferenceWithScalarScaledMatchedPointsNLP> nlp=new CalibReferenceWithScalarScaledMatchedPointsNLP(p0,p1,cat(min,min_s_scalar),cat(max,max_s_scalar));
+            starts.push_back(saturate(x,min,max));
+        }
+        starts.push_back(cat(x0,s0_scalar));
 
-        nlp->set_x0(cat(x0,s0_scalar));
-        Ipopt::ApplicationReturnStatus status=app->OptimizeTNLP(GetRawPtr(nlp));
+        Ipopt::SmartPtr<Ipopt::IpoptApplication> app=createApp(tol,max_iter);
+        Ipopt::SmartPtr<CalibReferenceWithScalarScaledMatchedPointsNLP> nlp=new CalibReferenceWithScalarScaledMatchedPointsNLP(moments,min,max);
+
+        Vector x;
+        Ipopt::ApplicationReturnStatus status=solve(app,GetRawPtr(nlp),starts,x);
+        if (x.length()==0)
+            return false;
 
-        Vector x=nlp->get_result();
         H=computeH(x);
         s=x[6];
         Matrix S=eye(4,4);
@@ -751,5 +914,3 @@ bool CalibReferenceWithMatchedPoints::calibrate(Matrix &H, double &s,
     else
         return false;
 }
-
-
@@ -15,8 +15,12 @@
  * Public License for more details
 */
 
+#include <cmath>
+#include <limits>
 #include <algorithm>
 #include <string>
+#include <vector>
+#include <thread>
 
 #include <yarp/math/Math.h>
 #include <yarp/math/Rand.h>
@@ -42,6 +46,212 @@ namespace iCub
 namespace optimization
 {
 
+/****************************************************************/
+class ff2LayNNTrainCost
+{
+protected:
+    const ff2LayNNTrain &net;
+    size_t I,H,O;
+    Matrix X1;
+    Matrix T;
+    unsigned int threads;
+
+    /****************************************************************/
+    double evalChunk(const Ipopt::Number *x, const size_t *idx, const size_t n,
+                     Ipopt::Number *grad) const
+    {
+        // x holds IW (HxI) and LW (OxH) by rows, then b1 and b2
+        const double *W=x;
+        const double *V=W+H*I;
+        const double *b1=V+O*H;
+        const double *b2=b1+H;
+
+        double *gW=grad;
+        double *gV=gW+H*I;
+        double *gb1=gV+O*H;
+        double *gb2=gb1+H;
+
+        // the samples are processed in blocks to bound the memory
+        const size_t B=256;
+        Matrix N1(B,H),A1(B,H),N2(B,O),A2(B,O);
+        Vector n1(H),n2(O),d1(H),d2(O);
+
+        double cost=0.0;
+        for (size_t k0=0; k0<n; k0+=B)
+        {
+            const size_t b=std::min(B,n-k0);
+            for (size_t k=0; k<b; k++)
+            {
+                const double *x1=X1[idx[k0+k]];
+                for (size_t h=0; h<H; h++)
+                {
+                    const double *w=W+h*I;
+                    double sum=b1[h];
+                    for (size_t i=0; i<I; i++)
+                        sum+=w[i]*x1[i];
+                    A1(k,h)=N1(k,h)=sum;
+                }
+            }
+            net.hiddenLayerFcnBatch(A1.data(),b,H);
+
+            for (size_t k=0; k<b; k++)
+            {
+                const double *a1=A1[k];
+                for (size_t o=0; o<O; o++)
+                {
+                    const double *v=V+o*H;
+                    double sum=b2[o];
+                    for (size_t h=0; h<H; h++)
+                        sum+=v[h]*a1[h];
+                    A2(k,o)=N2(k,o)=sum;
+                }
+            }
+            net.outputLayerFcnBatch(A2.data(),b,O);
+
+            for (size_t k=0; k<b; k++)
+            {
+                const double *t=T[idx[k0+k]];
+                const double *a2=A2[k];
+                for (size_t o=0; o<O; o++)
+                {
+                    // the error on the output postprocessed
+                    double e=net.outRatio[o]*(a2[o]-net.outMinY[o])+net.outMinX[o]-t[o];
+                    cost+=e*e;
+                    d2[o]=2.0*e*net.outRatio[o];
+                }
+
+                if (grad==NULL)
+                    continue;
+
+                // back-propagation through the output layer
+                for (size_t o=0; o<O; o++)
+                    n2[o]=N2(k,o);
+                Vector g2=net.outputLayerGrad(n2);
+
+                const double *a1=A1[k];
+                for (size_t h=0; h<H; h++)
+                    d1[h]=0.0;
+
+                for (size_t o=0; o<O; o++)
+                {
+                    d2[o]*=g2[o];
+
+                    const double *v=V+o*H;
+                    double *gv=gV+o*H;
+                    for (size_t h=0; h<H; h++)
+                    {
+                        gv[h]+=d2[o]*a1[h];
+                        d1[h]+=v[h]*d2[o];
+                    }
+                    gb2[o]+=d2[o];
+                }
+
+                // back-propagation through the hidden layer
+                for (size_t h=0; h<H; h++)
+                    n1[h]=N1(k,h);
+                Vector g1=net.hiddenLayerGrad(n1);
+
+                const double *x1=X1[idx[k0+k]];
+                for (size_t h=0; h<H; h++)
+                {
+                    double d=d1[h]*g1[h];
+
+                    double *gw=gW+h*I;
+                    for (size_t i=0; i<I; i++)
+                        gw[i]+=d*x1[i];
+                    gb1[h]+=d;
+                }
+            }
+        }
+
+        return cost;
+    }
+
+public:
+    /****************************************************************/
+    ff2LayNNTrainCost(const ff2LayNNTrain &_net, const deque<Vector> &in,
+                      const deque<Vector> &out, const unsigned int _threads) :
+                      net(_net)
+    {
+        I=net.inMinX.length();
+        H=net.IW.size();
+        O=net.LW.size();
+
+        // the inputs are stored already scaled in the net format
+        X1.resize(in.size(),I);
+        T.resize(out.size(),O);
+        for (size_t n=0; n<in.size(); n++)
+        {
+            double *x1=X1[n];
+            for (size_t i=0; i<I; i++)
+                x1[i]=net.inRatio[i]*(in[n][i]-net.inMinX[i])+net.inMinY[i];
+
+            double *t=T[n];
+            for (size_t o=0; o<O; o++)
+                t[o]=out[n][o];
+        }
+
+        threads=(_threads>0)?_threads:std::max(1u,std::thread::hardware_concurrency());
+    }
+
+    /****************************************************************/
+    size_t size() const
+    {
+        return (size_t)X1.rows();
+    }
+
+    /****************************************************************/
+    size_t numVariables() const
+    {
+        return H*I+O*H+H+O;
+    }
+
+    /****************************************************************/
+    double eval(const Ipopt::Number *x, const size_t *idx, const size_t n,
+                Ipopt::Number *grad) const
+    {
+        // the samples idx[0..n-1] are split among the threads, each
+        // one with its own gradient, summed up in a fixed order
+        const size_t nv=numVariables();
+        const size_t nt=std::max((size_t)1,std::min((size_t)threads,n/512));
+        vector<double> costs(nt,0.0);
+        vector<vector<double>> grads(nt,vector<double>(grad!=NULL?nv:0,0.0));
+
+        auto worker=[&](const size_t t)
+        {
+            const size_t first=(t*n)/nt;
+            const size_t last=((t+1)*n)/nt;
+            costs[t]=evalChunk(x,idx+first,last-first,
+                               grad!=NULL?grads[t].data():NULL);
+        };
+
+        vector<thread> workers;
+        for (size_t t=1; t<nt; t++)
+            workers.push_back(thread(worker,t));
+        worker(0);
+        for (size_t t=0; t<workers.size(); t++)
+            workers[t].join();
+
+        double cost=0.0;
+        for (size_t t=0; t<nt; t++)
+            cost+=costs[t];
+
+        if (grad!=NULL)
+        {
+            for (size_t j=0; j<nv; j++)
+            {
+                grad[j]=0.0;
+                for (size_t t=0; t<nt; t++)
+                    grad[j]+=grads[t][j];
+                grad[j]/=n;
+            }
+        }
+
+        return cost/n;
+    }
+};
+
+
 /****************************************************************/
 class ff2LayNNTrainNLP : public Ipopt::TNLP
 {
@@ -60,6 +270,9 @@ protected:
     deque<Vector> &pred;
     double error;
 
+    const ff2LayNNTrainCost &cost;
+    vector<size_t> all;
+
     /****************************************************************/
     bool getBounds(const string &tag, double &min, double &max)
     {
@@ -119,14 +332,67 @@ public:
     /****************************************************************/
     ff2LayNNTrainNLP(ff2LayNNTrain &_net, const Property &_bounds,
                      const bool _randomInit, const deque<Vector> &_in,
-                     const deque<Vector> &_out, deque<Vector> &_pred) :
+                     const deque<Vector> &_out, deque<Vector> &_pred,
+                     const ff2LayNNTrainCost &_cost) :
                      net(_net), bounds(_bounds), randomInit(_randomInit),
                      in(_in), out(_out), pred(_pred),
                      IW(_net.get_IW()), LW(_net.get_LW()),
-                     b1(_net.get_b1()), b2(_net.get_b2())
+                     b1(_net.get_b1()), b2(_net.get_b2()),
+                     cost(_cost)
     {
         pred.clear();
-        error=0.0;        
+        error=0.0;
+
+        all.resize(cost.size());
+        for (size_t i=0; i<all.size(); i++)
+            all[i]=i;
+    }
+
+    /****************************************************************/
+    Ipopt::ApplicationReturnStatus descend(const size_t batchSize, const int epochs,
+                                           const double learningRate)
+    {
+        // stochastic mini-batch optimization (Adam), with the
+        // variables projected onto the bounds after each step
+        Ipopt::Index n,m,nnz_jac_g,nnz_h_lag; IndexStyleEnum index_style;
+        get_nlp_info(n,m,nnz_jac_g,nnz_h_lag,index_style);
+
+        vector<double> x(n),x_l(n),x_u(n),g(n);
+        vector<double> mt(n,0.0),vt(n,0.0);
+        get_bounds_info(n,x_l.data(),x_u.data(),m,NULL,NULL);
+        get_starting_point(n,true,x.data(),false,NULL,NULL,m,false,NULL);
+
+        const double beta1=0.9;
+        const double beta2=0.999;
+        const double eps=1e-8;
+        double beta1t=1.0,beta2t=1.0;
+
+        vector<size_t> idx=all;
+        for (int epoch=0; epoch<epochs; epoch++)
+        {
+            for (size_t i=idx.size()-1; i>0; i--)
+                std::swap(idx[i],idx[std::min(i,(size_t)Rand::scalar(0.0,i+1.0))]);
+
+            for (size_t k=0; k<idx.size(); k+=batchSize)
+            {
+                cost.eval(x.data(),&idx[k],std::min(batchSize,idx.size()-k),g.data());
+
+                beta1t*=beta1;
+                beta2t*=beta2;
+                for (Ipopt::Index j=0; j<n; j++)
+                {
+                    mt[j]=beta1*mt[j]+(1.0-beta1)*g[j];
+                    vt[j]=beta2*vt[j]+(1.0-beta2)*g[j]*g[j];
+                    double step=learningRate*(mt[j]/(1.0-beta1t))/(sqrt(vt[j]/(1.0-beta2t))+eps);
+                    x[j]=std::min(x_u[j],std::max(x[j]-step,x_l[j]));
+                }
+            }
+        }
+
+        finalize_solution(Ipopt::SUCCESS,n,x.data(),NULL,NULL,m,NULL,NULL,
+                          cost.eval(x.data(),all.data(),all.size(),NULL),NULL,NULL);
+
+        return Ipopt::Solve_Succeeded;
     }
 
     /****************************************************************/
@@ -221,16 +487,7 @@ public:
     bool eval_f(Ipopt::Index n, const Ipopt::Number *x, bool new_x,
                 Ipopt::Number &obj_value)
     {
-        fillNet(x);
-
-        obj_value=0.0;
-        for (size_t i=0; i<in.size(); i++)
-        {
-            Vector pred=net.predict(in[i]);
-            obj_value+=norm2(out[i]-pred);
-        }
-
-        obj_value/=in.size();
+        obj_value=cost.eval(x,all.data(),all.size(),NULL);
         return true;
     }
 
@@ -238,6 +495,7 @@ public:
     bool eval_grad_f(Ipopt::Index n, const Ipopt::Number* x, bool new_x,
                      Ipopt::Number *grad_f)
     {
+        cost.eval(x,all.data(),all.size(),grad_f);
         return true;
     }
 
@@ -273,6 +531,8 @@ public:
                            Ipopt::Number obj_value, const Ipopt::IpoptData *ip_data,
                            Ipopt::IpoptCalculatedQuantities *ip_cq)
     {
+        fillNet(x);
+
         error=0.0;
         pred.clear();
         for (size_t i=0; i<in.size(); i++)
@@ -304,6 +564,11 @@ ff2LayNNTrain::ff2LayNNTrain()
     CAST_IPOPTAPP(App)->Options()->SetIntegerValue("print_level",0);
     CAST_IPOPTAPP(App)->Options()->SetStringValue("derivative_test","none");
     CAST_IPOPTAPP(App)->Initialize();
+
+    threads=0;
+    batchSize=0;
+    epochs=100;
+    learningRate=1e-3;
 }
 
 
@@ -314,6 +579,29 @@ void ff2LayNNTrain::setBounds(const Property &bounds)
 }
 
 
+/****************************************************************/
+void ff2LayNNTrain::setTrainingOptions(const Property &options)
+{
+    if (options.check("threads"))
+        threads=(unsigned int)std::max(0,options.find("threads").asInt32());
+
+    if (options.check("batch_size"))
+        batchSize=options.find("batch_size").asInt32();
+
+    if (options.check("epochs"))
+        epochs=options.find("epochs").asInt32();
+
+    if (options.check("learning_rate"))
+        learningRate=options.find("learning_rate").asFloat64();
+
+    if (options.check("max_iter"))
+        CAST_IPOPTAPP(App)->Options()->SetIntegerValue("max_iter",options.find("max_iter").asInt32());
+
+    if (options.check("tol"))
+        CAST_IPOPTAPP(App)->Options()->SetNumericValue("tol",options.find("tol").asFloat64());
+}
+
+
 /****************************************************************/
 bool ff2LayNNTrain::train(const unsigned int numHiddenNodes,
                           const deque<Vector> &in, const deque<Vector> &out,
@@ -391,8 +679,11 @@ bool ff2LayNNTrain::train(const unsigned int numHiddenNodes,
     prepare();
     configured=true;
 
-    Ipopt::SmartPtr<ff2LayNNTrainNLP> nlp=new ff2LayNNTrainNLP(*this,bounds,true,in,out,pred);
-    Ipopt::ApplicationReturnStatus status=CAST_IPOPTAPP(App)->OptimizeTNLP(GetRawPtr(nlp));
+    ff2LayNNTrainCost cost(*this,in,out,threads);
+    Ipopt::SmartPtr<ff2LayNNTrainNLP> nlp=new ff2LayNNTrainNLP(*this,bounds,true,in,out,pred,cost);
+    Ipopt::ApplicationReturnStatus status=((batchSize>0) && ((size_t)batchSize<in.size()))?
+                                          nlp->descend(batchSize,epochs,learningRate):
+                                          CAST_IPOPTAPP(App)->OptimizeTNLP(GetRawPtr(nlp));
 
     error=nlp->get_error();
     return (status==Ipopt::Solve_Succeeded);
@@ -406,8 +697,11 @@ bool ff2LayNNTrain::retrain(const deque<Vector> &in, const deque<Vector> &out,
     if ((in.size()==0) || (in.size()!=out.size()) || !configured)
         return false;
 
-    Ipopt::SmartPtr<ff2LayNNTrainNLP> nlp=new ff2LayNNTrainNLP(*this,bounds,false,in,out,pred);
-    Ipopt::ApplicationReturnStatus status=CAST_IPOPTAPP(App)->OptimizeTNLP(GetRawPtr(nlp));
+    ff2LayNNTrainCost cost(*this,in,out,threads);
+    Ipopt::SmartPtr<ff2LayNNTrainNLP> nlp=new ff2LayNNTrainNLP(*this,bounds,false,in,out,pred,cost);
+    Ipopt::ApplicationReturnStatus status=((batchSize>0) && ((size_t)batchSize<in.size()))?
+                                          nlp->descend(batchSize,epochs,learningRate):
+                                          CAST_IPOPTAPP(App)->OptimizeTNLP(GetRawPtr(nlp));
 
     error=nlp->get_error();
     return (status==Ipopt::Solve_Succeeded);    
@@ -38,6 +38,8 @@
 
 #include <string>
 #include <map>
+#include <vector>
+#include <mutex>
 #include <ostream>
 
 #include <yarp/os/Value.h>
@@ -57,6 +59,13 @@ namespace perception
 *  
 * An abstract class that provides basic methods for interfacing 
 * with the data acquisition. 
+*  
+* In push mode the model evaluates its nodes once for each new 
+* sample streamed by the sensors, rather than each time 
+* getOutput() is polled: getOutput() then returns the outputs 
+* of the latest sample, and the event callbacks attached to a 
+* node are raised as soon as its output rises above the contact
+* threshold, with a pointer to the node itself as argument.
 */
 class Model
 {
@@ -66,9 +75,41 @@ protected:
 
     std::map<std::string,Node*> nodes;
 
+    bool                pushMode;
+    std::vector<Node*>  pushNodes;
+    std::vector<double> pushThres;
+    std::vector<double> pushOutputs;
+    std::vector<bool>   pushContacts;
+    bool                pushValid;
+    mutable std::mutex  mtxPush;
+
     virtual void printMessage(const int logtype, const int level,
                               const char *format, ...) const;
 
+    /**
+    * Parse the push mode options: <b>push_mode</b> ("on"/"off") 
+    * and <b>contact_thres</b> (a double, or a list with one 
+    * threshold for each node). 
+    * @param options the model options. 
+    * @param nodes the nodes in the order of the model output. 
+    */
+    void configurePushMode(const yarp::os::Property &options,
+                           const std::vector<Node*> &nodes);
+
+    /**
+    * Store the outputs evaluated over a new sample and raise the 
+    * callbacks of the nodes that have just come into contact.
+    * @param outputs the output of each node. 
+    */
+    void pushSample(const std::vector<double> &outputs);
+
+    /**
+    * Retrieve the outputs of the latest sample.
+    * @param out a list with the output of each node. 
+    * @return false if no sample has been pushed yet. 
+    */
+    bool getPushedOutput(yarp::os::Value &out) const;
+
 public:
     /**
     * Constructor. 
@@ -153,6 +194,15 @@ public:
     */
     virtual bool getOutput(yarp::os::Value &out) const = 0;
 
+    /**
+    * Return the acquisition mode.
+    * @return true if the model is in push mode. 
+    */
+    bool isPushMode() const
+    {
+        return pushMode;
+    }
+
     /**
     * Destructor. 
     */
@@ -128,6 +128,12 @@ public:
     */
     void attachCallback(EventCallback &callback);
 
+    /**
+    * Execute all the attached event callbacks.
+    * @param ptr the pointer handed over to the callbacks. 
+    */
+    void raiseCallbacks(void *ptr);
+
     /**
     * Add a node as a neighbor for the process of building the 
     * architecture. 
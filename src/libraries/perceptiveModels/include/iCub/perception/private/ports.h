@@ -19,6 +19,7 @@
 #define __PERCEPTIVEMODELS_PORTS_H__
 
 #include <mutex>
+#include <functional>
 
 #include <yarp/os/Value.h>
 #include <yarp/os/Bottle.h>
@@ -36,11 +37,13 @@ class Port : public yarp::os::BufferedPort<yarp::os::Bottle>
 protected:
     std::mutex mtx;
     yarp::os::Bottle bottle;
+    std::function<void()> notifier;
 
     void onRead(yarp::os::Bottle &bottle);
 
 public:
     Port();
+    void setNotifier(const std::function<void()> &notifier);
     yarp::os::Value getValue(const int index);
 };
 
@@ -57,6 +57,7 @@
 #define __PERCEPTIVEMODELS_SPRINGYFINGERS_H__
 
 #include <mutex>
+#include <vector>
 
 #include <yarp/os/all.h>
 #include <yarp/dev/all.h>
@@ -90,6 +91,9 @@ protected:
     double  outputGain;
     bool    calibrated;
 
+    mutable yarp::sig::Vector bufIn,bufOut;
+    mutable std::mutex mtx;
+
     bool extractSensorsData(yarp::sig::Vector &in, yarp::sig::Vector &out) const;
 
 public:
@@ -165,6 +169,15 @@ public:
     */
     bool getOutput(yarp::os::Value &out) const;
 
+    /**
+    * Compute the finger output straight into a double, reusing the
+    * internal buffers. 
+    * @param out the finger output. 
+    * @return true/false on success/failure. 
+    * @see getOutput 
+    */
+    bool computeOutput(double &out) const;
+
     /**
     * Return the internal status of the calibration.
     * @return true/false on calibrated/uncalibrated-failure.
@@ -212,10 +225,12 @@ private:
     SensorPort      sensPort[12];
     SpringyFinger   fingers[5];
     bool configured;
+    bool calibrating;
 
     yarp::os::BufferedPort<yarp::os::Bottle> *port;
     yarp::dev::PolyDriver                     driver;
 
+    std::vector<double> samples;
     std::mutex mtx;
 
     class CalibThread : public yarp::os::Thread
@@ -257,6 +272,7 @@ private:
     
     void calibrateFinger(SpringyFinger &finger, const int joint,
                          const double min, const double max);
+    void onSample();
     void close();
 
 public:
@@ -277,6 +293,12 @@ public:
     * or "icubSim".\n 
     * <b>carrier</b>: the protocol used to connect yarp streaming 
     * ports; e.g. "udp", "mcast", "tcp". \n
+    * <b>push_mode</b>: it can be "on" or "off"; when "on" the 
+    * fingers are evaluated as soon as a new sample is streamed by 
+    * the analog port and getOutput() returns the latest outputs.\n 
+    * <b>contact_thres</b>: a double, or a list of five doubles, 
+    * above which a finger is in contact and its event callbacks 
+    * are raised in push mode.\n 
     * <b>verbosity</b>: an integer that accounts for the verbosity 
     * level of model print-outs. 
     * @return true/false on success/failure.
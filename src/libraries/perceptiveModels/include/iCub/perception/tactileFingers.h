@@ -37,6 +37,9 @@
 #ifndef __PERCEPTIVEMODELS_TACTILEFINGERS_H__
 #define __PERCEPTIVEMODELS_TACTILEFINGERS_H__
 
+#include <mutex>
+#include <vector>
+
 #include <yarp/os/all.h>
 #include <yarp/sig/all.h>
 
@@ -125,6 +128,15 @@ public:
     */
     bool getOutput(yarp::os::Value &out) const;    
 
+    /**
+    * Compute the finger output straight into a double, without 
+    * going through the sensors data representation. 
+    * @param out the finger output. 
+    * @return true/false on success/failure. 
+    * @see getOutput 
+    */
+    bool computeOutput(double &out) const;
+
     /**
     * Not available.
     * @return true.
@@ -162,6 +174,10 @@ private:
 
     yarp::os::BufferedPort<yarp::os::Bottle> *port;
 
+    std::vector<double> samples;
+    std::mutex mtx;
+
+    void onSample();
     void close();
 
 public:
@@ -186,6 +202,12 @@ public:
     * which ports to connect to for data acquisition. When false it 
     * collects the raw data, when true it connects to the 
     * compensated ports. \n
+    * <b>push_mode</b>: it can be "on" or "off"; when "on" the 
+    * fingers are evaluated as soon as a new sample is streamed by 
+    * the skin port and getOutput() returns the latest outputs.\n 
+    * <b>contact_thres</b>: a double, or a list of five doubles, 
+    * above which a finger is in contact and its event callbacks 
+    * are raised in push mode.\n 
     * <b>verbosity</b>: an integer that accounts for the verbosity 
     * level of model print-outs. 
     * @return true/false on success/failure.
@@ -17,6 +17,7 @@
 
 #include <cstdio>
 #include <cstdarg>
+#include <limits>
 
 #include <yarp/os/Log.h>
 
@@ -32,6 +33,8 @@ using namespace iCub::perception;
 Model::Model()
 {
     name="";
+    pushMode=false;
+    pushValid=false;
 }
 
 
@@ -84,3 +87,68 @@ Node* Model::getNode(const string &name) const
 }
 
 
+/************************************************************************/
+void Model::configurePushMode(const Property &options, const vector<Node*> &nodes)
+{
+    lock_guard<mutex> lck(mtxPush);
+
+    pushMode=(options.check("push_mode",Value("off")).asString()=="on");
+    pushNodes=nodes;
+    pushOutputs.assign(nodes.size(),0.0);
+    pushContacts.assign(nodes.size(),false);
+    pushValid=false;
+
+    // no event is raised without thresholds
+    pushThres.assign(nodes.size(),std::numeric_limits<double>::max());
+    Value &thres=options.find("contact_thres");
+    if (Bottle *b=thres.asList())
+    {
+        for (size_t i=0; (i<pushThres.size()) && (i<(size_t)b->size()); i++)
+            pushThres[i]=b->get(i).asFloat64();
+    }
+    else if (thres.isFloat64() || thres.isInt32())
+        pushThres.assign(nodes.size(),thres.asFloat64());
+}
+
+
+/************************************************************************/
+void Model::pushSample(const vector<double> &outputs)
+{
+    vector<Node*> raised;
+
+    {
+        lock_guard<mutex> lck(mtxPush);
+        for (size_t i=0; (i<outputs.size()) && (i<pushOutputs.size()); i++)
+        {
+            pushOutputs[i]=outputs[i];
+
+            bool contact=(outputs[i]>pushThres[i]);
+            if (contact && !pushContacts[i])
+                raised.push_back(pushNodes[i]);
+
+            pushContacts[i]=contact;
+        }
+
+        pushValid=true;
+    }
+
+    // out of the lock, the callbacks may read the outputs back
+    for (size_t i=0; i<raised.size(); i++)
+        raised[i]->raiseCallbacks(raised[i]);
+}
+
+
+/************************************************************************/
+bool Model::getPushedOutput(Value &out) const
+{
+    lock_guard<mutex> lck(mtxPush);
+    if (!pushValid)
+        return false;
+
+    Bottle bOut; Bottle &ins=bOut.addList();
+    for (size_t i=0; i<pushOutputs.size(); i++)
+        ins.addFloat64(pushOutputs[i]);
+
+    out=bOut.get(0);
+    return true;
+}
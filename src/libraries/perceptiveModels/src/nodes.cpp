@@ -50,6 +50,14 @@ void Node::attachCallback(EventCallback &callback)
 }
 
 
+/************************************************************************/
+void Node::raiseCallbacks(void *ptr)
+{
+    for (map<string,EventCallback*>::iterator it=callbacks.begin(); it!=callbacks.end(); ++it)
+        it->second->execute(ptr);
+}
+
+
 /************************************************************************/
 void Node::addNeighbor(Node &node)
 {
@@ -29,11 +29,25 @@ iCub::perception::Port::Port()
 }
 
 
+/************************************************************************/
+void iCub::perception::Port::setNotifier(const function<void()> &notifier)
+{
+    // to be set before the port is opened
+    this->notifier=notifier;
+}
+
+
 /************************************************************************/
 void iCub::perception::Port::onRead(Bottle &bottle)
 {
-    lock_guard<mutex> lck(mtx);
-    this->bottle=bottle;
+    {
+        lock_guard<mutex> lck(mtx);
+        this->bottle=bottle;
+    }
+
+    // outside the lock, the notified one reads the values back
+    if (notifier)
+        notifier();
 }
 
 
@@ -61,10 +61,11 @@ bool SensorEncoders::getOutput(Value &in) const
     if (!configured)
         return false;    
 
-    Vector vect(size);
-    static_cast<IEncoders*>(source)->getEncoders(vect.data());
-    in=Value(vect[index]);
+    double enc;
+    if (!static_cast<IEncoders*>(source)->getEncoder(index,&enc))
+        return false;
 
+    in=Value(enc);
     return true;
 }
 
@@ -124,6 +124,29 @@ bool SpringyFinger::toStream(ostream &str) const
 
 /************************************************************************/
 bool SpringyFinger::getSensorsData(Value &data) const
+{
+    Vector in,out;
+    if (!extractSensorsData(in,out))
+        return false;
+
+    Property prop;
+    Bottle b;
+
+    b.addList().read(in);
+    prop.put("in",b.get(0));
+
+    b.addList().read(out);
+    prop.put("out",b.get(1));
+
+    b.addList().read(prop);
+    data=b.get(2);
+
+    return true;
+}
+
+
+/************************************************************************/
+bool SpringyFinger::extractSensorsData(Vector &in, Vector &out) const
 {
     map<string,Sensor*>::const_iterator In_0=sensors.find("In_0");
     map<string,Sensor*>::const_iterator Out_0=sensors.find("Out_0");
@@ -146,10 +169,13 @@ bool SpringyFinger::getSensorsData(Value &data) const
     Out_0->second->getOutput(val_out[0]);
     Out_1->second->getOutput(val_out[1]);
 
-    Vector in(lssvm.getDomainSize());
+    // the sizes do not change once configured, hence no reallocation
+    if (in.length()!=(size_t)lssvm.getDomainSize())
+        in.resize(lssvm.getDomainSize());
     in[0]=val_in.asFloat64();
 
-    Vector out(lssvm.getCoDomainSize());
+    if (out.length()!=(size_t)lssvm.getCoDomainSize())
+        out.resize(lssvm.getCoDomainSize());
     out[0]=val_out[0].asFloat64();
     out[1]=val_out[1].asFloat64();
 
@@ -159,68 +185,41 @@ bool SpringyFinger::getSensorsData(Value &data) const
         out[2]=val_out[2].asFloat64();
     }
 
-    Property prop;
-    Bottle b;
-
-    b.addList().read(in);
-    prop.put("in",b.get(0));
-
-    b.addList().read(out);
-    prop.put("out",b.get(1));
-
-    b.addList().read(prop);
-    data=b.get(2);
-
     return true;
 }
 
 
 /************************************************************************/
-bool SpringyFinger::extractSensorsData(Vector &in, Vector &out) const
+bool SpringyFinger::computeOutput(double &out) const
 {
-    bool ret=false;
-
-    Value data;
-    if (getSensorsData(data))
-    {
-        if (Bottle *b1=data.asList())
-        {
-            if (Bottle *b2=b1->find("in").asList())
-            {
-                in.resize(b2->size());
-                for (size_t i=0; i<in.length(); i++)
-                    in[i]=b2->get(i).asFloat64();
-            }
+    lock_guard<mutex> lck(mtx);
+    if (!extractSensorsData(bufIn,bufOut))
+        return false;
 
-            if (Bottle *b2=b1->find("out").asList())
-            {
-                out.resize(b2->size());
-                for (size_t i=0; i<out.length(); i++)
-                    out[i]=b2->get(i).asFloat64();
+    bufIn[0]=scaler.transform(bufIn[0]);
+    Vector pred=lssvm.predict(bufIn).getPrediction();
 
-                ret=true;
-            }
-        }
+    double d=0.0;
+    for (size_t j=0; j<pred.length(); j++)
+    {
+        double e=bufOut[j]-scaler.unTransform(pred[j]);
+        d+=e*e;
     }
 
-    return ret;
+    out=outputGain*sqrt(d);
+
+    return true;
 }
 
 
 /************************************************************************/
 bool SpringyFinger::getOutput(Value &out) const
 {
-    Vector i,o;
-    if (!extractSensorsData(i,o))
+    double ret;
+    if (!computeOutput(ret))
         return false;
 
-    i[0]=scaler.transform(i[0]);
-    Vector pred=lssvm.predict(i).getPrediction();
-
-    for (size_t j=0; j<pred.length(); j++)
-        pred[j]=scaler.unTransform(pred[j]);
-
-    out=Value(outputGain*norm(o-pred));
+    out=Value(ret);
 
     return true;
 }
@@ -260,8 +259,13 @@ bool SpringyFinger::calibrate(const Property &options)
 /************************************************************************/
 SpringyFingersModel::SpringyFingersModel()
 {
-    port=new iCub::perception::Port;
+    iCub::perception::Port *p=new iCub::perception::Port;
+    p->setNotifier([this]() { onSample(); });
+    port=p;
+
+    samples.assign(5,0.0);
     configured=false;
+    calibrating=false;
 }
 
 
@@ -283,6 +287,11 @@ bool SpringyFingersModel::fromProperty(const Property &options)
     carrier=options.check("carrier",Value("udp")).asString();
     verbosity=options.check("verbosity",Value(0)).asInt32();
 
+    vector<Node*> fingerNodes;
+    for (int i=0; i<5; i++)
+        fingerNodes.push_back(&fingers[i]);
+    configurePushMode(options,fingerNodes);
+
     string part_motor=string(type+"_arm");
     string part_analog=string(type+"_hand");
 
@@ -410,6 +419,8 @@ bool SpringyFingersModel::fromProperty(const Property &options)
     attachNode(fingers[4]);
 
     printMessage(log::info,1,"configuration complete");
+
+    lock_guard<mutex> lck(mtx);
     return configured=true;
 }
 
@@ -452,6 +463,7 @@ void SpringyFingersModel::toProperty(Property &options) const
         options.put("name",name);
         options.put("type",type);
         options.put("robot",robot);
+        options.put("push_mode",pushMode?"on":"off");
         options.put("verbosity",verbosity);
     }
 }
@@ -465,6 +477,7 @@ bool SpringyFingersModel::toStream(ostream &str) const
         str<<"name      "<<name<<endl;
         str<<"type      "<<type<<endl;
         str<<"robot     "<<robot<<endl;
+        str<<"push_mode "<<(pushMode?"on":"off")<<endl;
         str<<"verbosity "<<verbosity<<endl;
 
         str<<endl;
@@ -514,6 +527,11 @@ bool SpringyFingersModel::calibrate(const Property &options)
         int nAxes; ienc->getAxes(&nAxes);
         Vector qmin(nAxes),qmax(nAxes),vel(nAxes),acc(nAxes);
 
+        // the fingers machines are reset and fed, they cannot be evaluated
+        mtx.lock();
+        calibrating=true;
+        mtx.unlock();
+
         printMessage(log::info,1,"steering the hand to a suitable starting configuration");
         for (int j=7; j<nAxes; j++)
         {
@@ -677,6 +695,10 @@ bool SpringyFingersModel::calibrate(const Property &options)
             ipos->setRefSpeed(j,vel[j]);
         }
 
+        mtx.lock();
+        calibrating=false;
+        mtx.unlock();
+
         return ok;
     }
     else
@@ -689,6 +711,10 @@ bool SpringyFingersModel::getOutput(Value &out) const
 {
     if (configured)
     {
+        // until the first sample comes, the fingers are polled as usual
+        if (pushMode && getPushedOutput(out))
+            return true;
+
         Value val[5];
         fingers[0].getOutput(val[0]);
         fingers[1].getOutput(val[1]);
@@ -796,6 +822,24 @@ void SpringyFingersModel::calibrateFinger(SpringyFinger &finger, const int joint
 }
 
 
+/************************************************************************/
+void SpringyFingersModel::onSample()
+{
+    // called by the analog port for each new sample
+    {
+        lock_guard<mutex> lck(mtx);
+        if (!configured || !pushMode || calibrating)
+            return;
+
+        for (int i=0; i<5; i++)
+            if (!fingers[i].computeOutput(samples[i]))
+                return;
+    }
+
+    pushSample(samples);
+}
+
+
 /************************************************************************/
 bool SpringyFingersModel::isCalibrated() const
 {
@@ -812,15 +856,18 @@ void SpringyFingersModel::close()
 {
     printMessage(log::info,1,"closing ...");
 
-    if (driver.isValid())
-        driver.close();
-
+    // the port first, as in push mode it reads the encoders
     if (!port->isClosed())
         port->close();
 
+    if (driver.isValid())
+        driver.close();
+
     nodes.clear();
 
+    mtx.lock();
     configured=false;
+    mtx.unlock();
 }
 
 
@@ -148,17 +148,38 @@ bool TactileFinger::extractSensorsData(Vector &in) const
 
 
 /************************************************************************/
-bool TactileFinger::getOutput(Value &out) const
+bool TactileFinger::computeOutput(double &out) const
 {
-    Vector i;
-    if (!extractSensorsData(i))
+    // the max does not depend on the order of the taxels,
+    // hence the sensors are visited as they are stored
+    if (sensors.size()!=12)
         return false;
 
     double ret=0.0;
-    for (size_t j=0; j<i.length(); j++)
-        ret=std::max(ret,directLogic?(255.0-i[j]):i[j]);
+    for (map<string,Sensor*>::const_iterator it=sensors.begin(); it!=sensors.end(); ++it)
+    {
+        Value val_in;
+        if (!it->second->getOutput(val_in))
+            return false;
+
+        double in=val_in.asFloat64();
+        ret=std::max(ret,directLogic?(255.0-in):in);
+    }
+
+    out=outputGain*ret;
+
+    return true;
+}
+
+
+/************************************************************************/
+bool TactileFinger::getOutput(Value &out) const
+{
+    double ret;
+    if (!computeOutput(ret))
+        return false;
 
-    out=Value(outputGain*ret);
+    out=Value(ret);
 
     return true;
 }
@@ -167,7 +188,11 @@ bool TactileFinger::getOutput(Value &out) const
 /************************************************************************/
 TactileFingersModel::TactileFingersModel()
 {
-    port=new iCub::perception::Port;
+    iCub::perception::Port *p=new iCub::perception::Port;
+    p->setNotifier([this]() { onSample(); });
+    port=p;
+
+    samples.assign(5,0.0);
     configured=false;
 }
 
@@ -191,6 +216,11 @@ bool TactileFingersModel::fromProperty(const Property &options)
     compensation=(options.check("compensation",Value("false")).asString()=="true");
     verbosity=options.check("verbosity",Value(0)).asInt32();
 
+    vector<Node*> fingerNodes;
+    for (int i=0; i<5; i++)
+        fingerNodes.push_back(&fingers[i]);
+    configurePushMode(options,fingerNodes);
+
     port->open("/"+name+"/"+type+"_hand:i");
     string skinPortName("/"+robot+"/skin/"+type+"_hand");
     if (compensation)
@@ -260,6 +290,8 @@ bool TactileFingersModel::fromProperty(const Property &options)
     attachNode(fingers[4]);
 
     printMessage(log::info,1,"configuration complete");
+
+    lock_guard<mutex> lck(mtx);
     return configured=true;
 }
 
@@ -303,6 +335,7 @@ void TactileFingersModel::toProperty(Property &options) const
         options.put("type",type);
         options.put("robot",robot);
         options.put("compensation",compensation?"true":"false");
+        options.put("push_mode",pushMode?"on":"off");
         options.put("verbosity",verbosity);
     }
 }
@@ -317,6 +350,7 @@ bool TactileFingersModel::toStream(ostream &str) const
         str<<"type         "<<type<<endl;
         str<<"robot        "<<robot<<endl;
         str<<"compensation "<<(compensation?"true":"false")<<endl;
+        str<<"push_mode    "<<(pushMode?"on":"off")<<endl;
         str<<"verbosity    "<<verbosity<<endl;
 
         str<<endl;
@@ -367,6 +401,10 @@ bool TactileFingersModel::getOutput(Value &out) const
 {
     if (configured)
     {
+        // until the first sample comes, the fingers are polled as usual
+        if (pushMode && getPushedOutput(out))
+            return true;
+
         Value val[5];
         fingers[0].getOutput(val[0]);
         fingers[1].getOutput(val[1]);
@@ -389,6 +427,24 @@ bool TactileFingersModel::getOutput(Value &out) const
 }
 
 
+/************************************************************************/
+void TactileFingersModel::onSample()
+{
+    // called by the skin port for each new sample
+    {
+        lock_guard<mutex> lck(mtx);
+        if (!configured || !pushMode)
+            return;
+
+        for (int i=0; i<5; i++)
+            if (!fingers[i].computeOutput(samples[i]))
+                return;
+    }
+
+    pushSample(samples);
+}
+
+
 /************************************************************************/
 void TactileFingersModel::close()
 {
@@ -399,7 +455,9 @@ void TactileFingersModel::close()
 
     nodes.clear();
 
+    mtx.lock();
     configured=false;
+    mtx.unlock();
 }
 
 
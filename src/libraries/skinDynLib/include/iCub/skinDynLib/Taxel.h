@@ -169,6 +169,13 @@ class Taxel
      */
     bool setWRFPosition(const yarp::sig::Vector &_WRFPosition);
 
+    /**
+     * Sets the Position of the taxel in the root FoR by transforming its Position in the limb's FoR.
+     * It does not allocate memory, so that it can be used on all the taxels at every cycle.
+     * @param _H is the roto-translation (4x4, stored by rows) from the limb's FoR to the root FoR
+     */
+    void updateWRFPosition(const double *_H);
+
     /**
      * Sets the u,v position of the taxel in one of the eyes
      * @return true/false in case of success/failure
@@ -84,6 +84,12 @@ protected:
         const yarp::sig::Vector &_Mu=yarp::sig::Vector(0), const yarp::sig::Vector &_Fdir=yarp::sig::Vector(0));
     bool checkVectorDim(const yarp::sig::Vector &v, unsigned int dim, const std::string &descr="");
 
+    // read the content of the list representing the dynContact, whose tag has already been read
+    bool readContent(yarp::os::ConnectionReader& connection);
+
+    // dynContactList reads and writes the fields directly in its compact encoding
+    friend class dynContactList;
+
 public:
     //~~~~~~~~~~~~~~~~~~~~~~
     //   CONSTRUCTORS
@@ -245,6 +251,12 @@ public:
      * @return true if the operation succeeded, false otherwise
      */
     virtual void setBodyPart(BodyPart _bodyPart);
+    /**
+     * Set the id of this contact, e.g. to keep the id of the contact it continues from a previous frame.
+     * New contacts get a unique id, hence the id should be taken from another contact.
+     * @param _id the contact id
+     */
+    virtual void setId(unsigned long _id);
 
     //~~~~~~~~~~~~~~~~~~~~~~
     //   FIX/UNFIX methods
@@ -26,6 +26,7 @@
 #define __DYNCONTLIST_H__
 
 #include <vector>
+#include <memory>
 #include <yarp/os/Portable.h>
 #include "iCub/skinDynLib/dynContact.h"
 
@@ -42,8 +43,18 @@ namespace skinDynLib
 class dynContactList : public std::vector<dynContact>, public yarp::os::Portable
 {
 protected:
-    
+    struct CompactStream;                           // the state of the compact encoding of a writer
+    std::shared_ptr<CompactStream> compactStream;   // null if write() uses the default encoding
+
+    bool readCompact(yarp::os::ConnectionReader& connection);
+    bool writeCompact(yarp::os::ConnectionWriter& connection) const;
+
 public:
+    /**
+    * Version of the compact binary encoding.
+    */
+    static const int COMPACT_VERSION = 1;
+
     //~~~~~~~~~~~~~~~~~~~~~~
     //   CONSTRUCTORS
     //~~~~~~~~~~~~~~~~~~~~~~
@@ -54,6 +65,24 @@ public:
     //~~~~~~~~~~~~~~~~~~~~~~~~~
     //   SERIALIZATION methods
     //~~~~~~~~~~~~~~~~~~~~~~~~~
+    /**
+    * Choose how write() encodes the list. By default it is a list of dynContact (see dynContact::write()),
+    * whereas the compact encoding is a list with a single blob. Every keyframePeriod seconds the blob is a
+    * keyframe with all the contacts; in between, it has the id of each contact and only the fields (CoP,
+    * force, moment, body part and link) which differ from the ones of the contact with the same id in the
+    * last keyframe. The deltas refer to the keyframe rather than to the previous blob, so that a lost blob
+    * costs nothing and all the connections of a port get the same data.
+    * read() accepts both encodings and keeps the last keyframe of each writer, hence only the writer has to
+    * choose; a reader that has not got the keyframe yet (e.g. it has just connected) fails to read until the
+    * next one. The compact encoding is not used on text mode connections.
+    * The copies of the list share the state of the encoding, so that the lists of a BufferedPort can be
+    * assigned from the one which has been set.
+    * @param compact if true use the compact encoding
+    * @param keyframePeriod the time between two keyframes [s]
+    */
+    void setCompactEncoding(bool compact, double keyframePeriod=1.0);
+    bool isCompactEncoding() const { return compactStream!=nullptr; }
+
     /*
     * Read dynContactList from a connection.
     * return true iff a dynContactList was read correctly
@@ -33,6 +33,7 @@
 
 #include "iCub/skinDynLib/skinPart.h"
 
+#include <map>
 #include <vector>
 
 namespace iCub
@@ -81,6 +82,17 @@ class iCubSkin
     bool configureSkinFromFile(const std::string &_from="skinManAll.ini",
                                const std::string &_context="skinGui");
 
+    /**
+     * Transforms the positions of the taxels of all the skin parts to the root FoR in a single pass.
+     * The kinematics is needed once per link rather than once per taxel: the roto-translations
+     * can be computed from the current joint angles with e.g. iKinChain::getH(), and then all the
+     * taxels of the link are transformed with the same matrix (see skinPart::updateWRFPositions()).
+     * @param _H    for each skin part, the roto-translation (4x4) from the FoR of its link to the root FoR;
+     *              the skin parts which are not in the map are left untouched
+     * @return the number of skin parts which have been updated
+     */
+    int updateWRFPositions(const std::map<SkinPart, yarp::sig::Matrix> &_H);
+
     /**
     * Print Method
     **/
@@ -0,0 +1,129 @@
+/**
+ * Copyright (C) 2026 iCub Facility, Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ *
+ *
+ * This file contains the definition of a neighborGrid, i.e. a class that finds the taxels close to each other.
+ *
+ * \section intro_sec Description
+ *
+ * The taxels are put in a uniform grid of cubic cells whose side is the maximum distance between two neighbors,
+ * hence the neighbors of a taxel are in its cell or in the 26 cells around it. The grid is built in O(N), a query
+ * costs as many distance checks as the taxels around the point, and moving a taxel is O(1).
+ *
+ * \section tested_os_sec Tested OS
+ *
+ * Windows, Linux
+ *
+ **/
+
+#ifndef __NEIGHBORGRID_H__
+#define __NEIGHBORGRID_H__
+
+#include <yarp/sig/Vector.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace iCub
+{
+namespace skinDynLib
+{
+
+/**
+* @ingroup skinDynLib
+*
+* Uniform grid of the positions of a set of taxels, to find the taxels closer than a maximum distance.
+*/
+class neighborGrid
+{
+  public:
+    /**
+    * Constructor
+    **/
+    neighborGrid();
+
+    /**
+    * Puts the taxels in the grid
+    * @param _positions are the positions {x, y, z} of the taxels, whose ids are their indexes
+    * @param _maxDist is the maximum distance between two neighbor taxels
+    **/
+    void build(const std::vector<yarp::sig::Vector> &_positions, double _maxDist);
+
+    /**
+    * Moves a taxel of the grid to a new position
+    * @param _id is the id of the taxel
+    * @param _position is its new position
+    * @return false if the taxel is not in the grid
+    **/
+    bool move(unsigned int _id, const yarp::sig::Vector &_position);
+
+    /**
+    * Finds the taxels not farther than the maximum distance from a taxel of the grid, excluded the taxel itself
+    * @param _id is the id of the taxel
+    * @param _neighbors gets the ids of the neighbors, in no particular order
+    **/
+    void getNeighbors(unsigned int _id, std::vector<int> &_neighbors) const;
+
+    /**
+    * Finds the neighbors of all the taxels of the grid, in compressed form: the neighbors of taxel i are
+    * _neighbors[_start[i]] ... _neighbors[_start[i+1]-1], in increasing order
+    **/
+    void getAllNeighbors(std::vector<int> &_start, std::vector<int> &_neighbors) const;
+
+    /**
+    * Gets the number of taxels in the grid
+    **/
+    size_t size() const { return positions.size(); }
+
+    /**
+    * Gets the maximum distance between two neighbors
+    **/
+    double getMaxDist() const { return maxDist; }
+
+  private:
+    struct Cell
+    {
+        int64_t x, y, z;
+        bool operator==(const Cell &c) const { return x==c.x && y==c.y && z==c.z; }
+    };
+
+    struct CellHash
+    {
+        size_t operator()(const Cell &c) const
+        {
+            return static_cast<size_t>(c.x*73856093) ^ static_cast<size_t>(c.y*19349663) ^ static_cast<size_t>(c.z*83492791);
+        }
+    };
+
+    double maxDist;
+    double cellSize;
+    std::vector<double> positions;          // {x, y, z} of each taxel, one after the other
+    std::vector<Cell> taxelCell;            // the cell of each taxel
+    std::unordered_map<Cell, std::vector<int>, CellHash> cells;
+
+    Cell cellOf(const double *p) const;
+    void add(unsigned int _id);
+    void remove(unsigned int _id);
+};
+
+}
+
+}//end namespace
+
+#endif
+
+// empty line to make gcc happy
@@ -62,6 +62,12 @@ protected:
     unsigned int activeTaxels;
     // list of active taxel ids
     std::vector<unsigned int> taxelList;
+
+    // read the content of the list representing the skinContact, whose tag has already been read
+    bool readContent(yarp::os::ConnectionReader& connection);
+
+    // skinContactList reads and writes the fields directly in its compact encoding
+    friend class skinContactList;
     
 public:
     //~~~~~~~~~~~~~~~~~~~~~~
@@ -44,8 +44,18 @@ namespace skinDynLib
 class skinContactList  : public std::vector<skinContact>, public yarp::os::Portable
 {
 protected:
-    
+    bool compactEncoding;       // if true write() uses the compact binary encoding
+    bool compactTaxelList;      // if true the compact encoding includes the taxel lists
+
+    bool readCompact(yarp::os::ConnectionReader& connection);
+    bool writeCompact(yarp::os::ConnectionWriter& connection) const;
+
 public:
+    /**
+    * Version of the compact binary encoding.
+    */
+    static const int COMPACT_VERSION = 1;
+
     //~~~~~~~~~~~~~~~~~~~~~~
     //   CONSTRUCTORS
     //~~~~~~~~~~~~~~~~~~~~~~
@@ -73,6 +83,18 @@ public:
     //~~~~~~~~~~~~~~~~~~~~~~~~~
     //   SERIALIZATION methods
     //~~~~~~~~~~~~~~~~~~~~~~~~~
+    /**
+    * Choose how write() encodes the list. By default it is a list of skinContact (see skinContact::write()),
+    * whereas the compact encoding is a list with a single blob holding a fixed-size record for each contact,
+    * optionally followed by the taxel lists. read() accepts both encodings, hence only the writer has to choose.
+    * The compact encoding is not used on text mode connections.
+    * @param compact if true use the compact encoding
+    * @param withTaxelList if false the taxel lists are not sent: the reader gets lists of zeros
+    *                      of the right length (see skinContact::setActiveTaxels())
+    */
+    void setCompactEncoding(bool compact, bool withTaxelList=true){ compactEncoding=compact; compactTaxelList=withTaxelList; }
+    bool isCompactEncoding() const { return compactEncoding; }
+
     /*
     * Read skinContactList from a connection.
     * return true iff a skinContactList was read correctly
@@ -34,6 +34,7 @@
 
 #include "iCub/skinDynLib/Taxel.h"
 #include "iCub/skinDynLib/common.h"
+#include "iCub/skinDynLib/neighborGrid.h"
 
 #include <yarp/os/RFModule.h>
 
@@ -140,15 +141,47 @@ class skinPartBase
 *
 * Class that encloses everything relate to a skinPart.
 * It consists of a std::vector of Taxel(s), and a number of methods for loading and populating these taxels from files.
+* The taxels are also kept in contiguous arrays (see TaxelArrays), on which the operations on the whole part run.
 * 
 */
 class skinPart : public skinPartBase
 {
   public:
+    /**
+    * The taxels of the skinPart, one array per coordinate: the element i of each array belongs to taxels[i].
+    * The loops over the whole part read them in sequence, with no pointer to chase, and the compiler can vectorize them.
+    **/
+    struct TaxelArrays
+    {
+        std::vector<int>    id;
+        std::vector<double> x,  y,  z;      // position w.r.t. the limb
+        std::vector<double> nx, ny, nz;     // normal   w.r.t. the limb
+        std::vector<double> wx, wy, wz;     // position w.r.t. the root FoR
+        std::vector<double> activation;     // the last value read from the skin (see setActivations())
+
+        /**
+         * Resizes all the arrays
+         * @param _n is the number of taxels
+         */
+        void resize(size_t _n);
+
+        /**
+         * @return the number of taxels
+         */
+        size_t size() const { return id.size(); }
+    };
+
     /**
     * List of taxels that belong to the skinPart.
     **/
     std::vector<Taxel*> taxels;
+
+    /**
+    * Contiguous copy of the taxels. It is filled when the taxels are loaded from file, and it is
+    * filled again by the operations on the whole part when the number of taxels has changed.
+    * If the taxels are modified in any other way, syncTaxelArrays() has to be called.
+    **/
+    TaxelArrays arrays;
       
     /**
      * Spatial_sampling used in building up the skinPart class. 
@@ -186,6 +219,11 @@ class skinPart : public skinPartBase
      */
     bool mapTaxelsOntoThemselves();
 
+    /**
+     * Calls syncTaxelArrays() if the number of taxels differs from the size of the arrays
+     */
+    void checkTaxelArrays();
+
   public:
     /**
      * Constructor
@@ -228,6 +266,61 @@ class skinPart : public skinPartBase
      */
     bool initRepresentativeTaxels();
 
+    /**
+     * Finds the neighbors of the taxels, i.e. the taxels whose distance is not greater than _maxDist
+     * @param  _maxDist   is the maximum distance between two neighbors
+     * @param  _neighbors gets, for each element of taxels, the indexes in taxels of its neighbors
+     */
+    void getTaxelNeighbors(double _maxDist, std::vector<std::vector<int> > &_neighbors);
+
+    /**
+     * Transforms the positions of all the taxels to the root FoR (see Taxel::getWRFPosition())
+     * @param  _H is the roto-translation (4x4) from the FoR of the link of the skin part to the root FoR
+     * @return true/false in case of success/failure (i.e. _H is not 4x4)
+     */
+    bool updateWRFPositions(const yarp::sig::Matrix &_H);
+
+    /**
+     * Fills the arrays again from the taxels (IDs, positions, normals and positions in the root FoR).
+     * The activations are set to zero.
+     */
+    void syncTaxelArrays();
+
+    /**
+     * Sets the activation of all the taxels from the values read from the skin port
+     * @param  _data is the output of the skin part, indexed by taxel ID (its size is getSize())
+     * @return true/false in case of success/failure (i.e. some ID is out of _data, whose taxel gets zero)
+     */
+    bool setActivations(const yarp::sig::Vector &_data);
+
+    /**
+     * Finds the taxels whose activation is greater than _thres
+     * @param  _thres  is the threshold of the activation
+     * @param  _active gets the indexes in taxels of the active taxels
+     * @return the number of active taxels
+     */
+    int getActiveTaxels(double _thres, std::vector<int> &_active);
+
+    /**
+     * Computes the center of the taxels weighted by their activation (the negative ones count as zero)
+     * @param  _center gets the center (3 elements)
+     * @param  _wrf    if true, the positions w.r.t. the root FoR are used, otherwise the ones w.r.t. the limb
+     * @return true/false in case of success/failure (i.e. no taxel is active)
+     */
+    bool getActivationCenter(yarp::sig::Vector &_center, bool _wrf=false);
+
+    /**
+     * Projects a point w.r.t. the limb onto all the taxels.
+     * The normals are taken as unit vectors, as they are in the taxel position files.
+     * @param  _point    is the point (3 elements) w.r.t. the limb
+     * @param  _distance gets, for each element of taxels, the distance between the point and the taxel
+     * @param  _height   gets, for each element of taxels, the component along the normal of the taxel
+     *                   of the vector from the taxel to the point
+     * @return true/false in case of success/failure (i.e. _point has not 3 elements)
+     */
+    bool getProjections(const yarp::sig::Vector &_point, std::vector<double> &_distance,
+                        std::vector<double> &_height);
+
     /**
      * gets the size of the taxel vector (it differs from skinPartBase::getSize())
      * @return the size of the taxel vector
@@ -0,0 +1,107 @@
+/**
+ * Copyright (C) 2026 iCub Facility, Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ *
+ *
+ * This file contains the definition of a taxelPositionFile, i.e. the content of a taxel position file
+ * (see icub-main/app/skinGui/conf/positions) together with its binary cache.
+ *
+ * \section intro_sec Description
+ *
+ * Parsing the text files with a ResourceFinder is slow, hence the first time a file is loaded its content
+ * is written into a binary file with the same name plus ".bin" (if the directory is writable). The cache is
+ * used as long as the size and the modification time of the text file are the ones it was built from, and
+ * its content is validated by a checksum. The layout of the cache is fixed (a header followed by the poses,
+ * the taxel2Repr mapping and the strings), so that it can also be mapped in memory.
+ *
+ * \section tested_os_sec Tested OS
+ *
+ * Windows, Linux
+ *
+ **/
+
+#ifndef __TAXELPOSITIONFILE_H__
+#define __TAXELPOSITIONFILE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace iCub
+{
+namespace skinDynLib
+{
+
+/**
+* @ingroup skinDynLib
+*
+* The content of a taxel position file which is used by skinPart and by the skinManager,
+* loaded from its binary cache when it is up to date.
+*/
+class taxelPositionFile
+{
+  public:
+    bool        hasName;
+    std::string name;               // the "name" field
+    bool        hasSpatialSampling;
+    std::string spatialSampling;    // the "spatial_sampling" field
+    bool        hasCalibration;     // false for the files with the old convention (one line per taxel, no groups)
+    std::vector<double> poses;      // 6 values (position and normal) for each line of the [calibration] group
+    bool        hasTaxel2Repr;
+    std::vector<int> taxel2Repr;    // the "taxel2Repr" list
+
+    /**
+    * Constructor
+    **/
+    taxelPositionFile();
+
+    /**
+    * Loads a taxel position file, from its cache if it is up to date, otherwise from the text file
+    * (and then the cache is written)
+    * @param _filePath is the full absolute path of the text file
+    * @return true if the file exists
+    **/
+    bool load(const std::string &_filePath);
+
+    /**
+    * Gets the number of lines of the [calibration] group
+    **/
+    size_t getPosesSize() const { return poses.size()/6; }
+
+    /**
+    * Gets the pose (position and normal) of a line of the [calibration] group
+    * @param _i is the index of the line
+    **/
+    const double *getPose(size_t _i) const { return &poses[6*_i]; }
+
+    /**
+    * Gets an element of taxel2Repr, or 0 if it is out of range (as reading beyond the end of the list in the file)
+    **/
+    int getTaxel2Repr(size_t _i) const { return _i<taxel2Repr.size() ? taxel2Repr[_i] : 0; }
+
+  protected:
+    void clear();
+    bool loadText(const std::string &_filePath);
+    bool loadCache(const std::string &_cachePath, uint64_t _size, int64_t _mtime);
+    bool saveCache(const std::string &_cachePath, uint64_t _size, int64_t _mtime) const;
+};
+
+}
+
+}//end namespace
+
+#endif
+
+// empty line to make gcc happy
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * CopyPolicy: Released under the terms of the GNU GPL v2.0.
+ *
+ */
+
+/**
+ * Fixed-layout binary message aggregating the output of the
+ * wholeBodyDynamics module in a single cycle.
+ *
+ * \section intro_sec Description
+ *
+ * \section tested_os_sec Tested OS
+ *
+ * Windows, Linux
+ *
+ **/
+
+#ifndef __WHOLEBODYSTATE_H__
+#define __WHOLEBODYSTATE_H__
+
+#include <cstdint>
+#include <yarp/os/Portable.h>
+
+namespace iCub
+{
+namespace skinDynLib
+{
+
+/**
+* @ingroup skinDynLib
+*
+* Snapshot of the whole-body estimates produced by wholeBodyDynamics
+* within one cycle: the joint torques of all the parts, the external
+* wrenches at the end-effectors, the COM and the time stamp.
+*
+* The message travels as a bottle made of a single blob, whose content
+* is the plain struct wholeBodyState::Data: the sender appends the
+* struct without copying it and the receiver reads it back with one
+* block transfer, so no field is parsed or converted on either side.
+* Since the struct is sent in the native binary representation, sender
+* and receiver are supposed to share the same endianness (as for all the
+* supported platforms); the version and size fields are checked during
+* reading and mismatching messages are rejected.
+*
+* Arrays of torques follow the joint ordering of the corresponding
+* Torques:o ports; wrenches are [force moment] with the same convention
+* of the endEffectorWrench:o ports; the COM is [x y z mass vx vy vz] as
+* in the com:o port of the whole body and is zero when the COM
+* computation is disabled.
+*/
+class wholeBodyState : public yarp::os::Portable
+{
+public:
+    /// version of the layout, to be increased whenever Data changes
+    static const int32_t VERSION = 1;
+
+    /**
+    * Layout of the message. Only doubles follow the two header words,
+    * hence the struct has no padding.
+    */
+    struct Data
+    {
+        int32_t version;                ///< layout version (VERSION)
+        int32_t count;                  ///< sequence number of the cycle
+        double  timestamp;              ///< time stamp of the cycle [s]
+        double  tau_head[3];            ///< neck joint torques [Nm]
+        double  tau_torso[3];           ///< torso joint torques [Nm]
+        double  tau_left_arm[7];        ///< left arm joint torques [Nm]
+        double  tau_right_arm[7];       ///< right arm joint torques [Nm]
+        double  tau_left_leg[6];        ///< left leg joint torques [Nm]
+        double  tau_right_leg[6];       ///< right leg joint torques [Nm]
+        double  wrench_left_arm[6];     ///< external wrench on the left hand
+        double  wrench_right_arm[6];    ///< external wrench on the right hand
+        double  wrench_left_leg[6];     ///< external wrench on the left leg end-effector
+        double  wrench_right_leg[6];    ///< external wrench on the right leg end-effector
+        double  wrench_left_foot[6];    ///< external wrench on the left foot
+        double  wrench_right_foot[6];   ///< external wrench on the right foot
+        double  com[7];                 ///< whole-body COM [x y z mass vx vy vz]
+    };
+
+    /// the content of the message
+    Data data;
+
+    /**
+    * Default constructor: all the fields are zeroed and the version set.
+    */
+    wholeBodyState();
+
+    /**
+    * Zeroes all the fields but the version.
+    */
+    void clear();
+
+    /**
+    * Read the message from a connection. Text mode is not supported.
+    * @return true iff the message has the expected version and size.
+    */
+    virtual bool read(yarp::os::ConnectionReader& connection) override;
+
+    /**
+    * Write the message to a connection.
+    * @return true iff the message was written successfully
+    */
+    virtual bool write(yarp::os::ConnectionWriter& connection) const override;
+};
+
+}
+}
+
+#endif
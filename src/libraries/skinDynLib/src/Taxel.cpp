@@ -159,6 +159,15 @@ using namespace iCub::skinDynLib;
         return true;
     }
 
+    void Taxel::updateWRFPosition(const double *_H)
+    {
+        // Position and WRFPosition have always 3 elements (see init() and the set methods)
+        double x=Position[0], y=Position[1], z=Position[2];
+        WRFPosition[0] = _H[0]*x + _H[1]*y + _H[2]*z  + _H[3];
+        WRFPosition[1] = _H[4]*x + _H[5]*y + _H[6]*z  + _H[7];
+        WRFPosition[2] = _H[8]*x + _H[9]*y + _H[10]*z + _H[11];
+    }
+
     bool Taxel::setPx(const yarp::sig::Vector &_px)
     {
         if (_px.size()!=2)
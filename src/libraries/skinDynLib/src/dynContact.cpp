@@ -161,6 +161,10 @@ void dynContact::setLinkNumber(unsigned int _linkNum){
 void dynContact::setBodyPart(BodyPart _bodyPart){
     bodyPart = _bodyPart;
 }
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+void dynContact::setId(unsigned long _id){
+    contactId = _id;
+}
 //~~~~~~~~~~~~~~~~~~~~~~
 //   FIX/UNFIX methods
 //~~~~~~~~~~~~~~~~~~~~~~ 
@@ -235,7 +239,13 @@ bool dynContact::read(ConnectionReader& connection){
     // - a list of 3 double, i.e. the CoP
     // - a list of 3 double, i.e. the force
     // - a list of 3 double, i.e. the moment
-    if(connection.expectInt32()!= BOTTLE_TAG_LIST || connection.expectInt32()!=4)
+    if(connection.expectInt32()!= BOTTLE_TAG_LIST)
+        return false;
+    return readContent(connection);
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool dynContact::readContent(ConnectionReader& connection){
+    if(connection.expectInt32()!=4)
         return false;
     // - a list of 3 int, i.e. contactId, bodyPart, linkNumber
     if(connection.expectInt32()!=BOTTLE_TAG_LIST+BOTTLE_TAG_INT32 || connection.expectInt32()!=3)
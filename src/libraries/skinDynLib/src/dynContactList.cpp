@@ -9,9 +9,16 @@
 #include <sstream>
 #include <iomanip>
 #include <string>
+#include <cstring>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <random>
+#include <stdint.h>
 
 #include <yarp/os/ConnectionReader.h>
 #include <yarp/os/ConnectionWriter.h>
+#include <yarp/os/Time.h>
 #include "iCub/skinDynLib/dynContactList.h"
 #include <iCub/ctrl/math.h>
 
@@ -19,6 +26,101 @@ using namespace std;
 using namespace yarp::os;
 using namespace iCub::skinDynLib;
 
+namespace {
+    // the compact encoding is a blob made of a header and an entry for each contact: the id, the
+    // flags of the fields which follow and then the fields, each one as a block (see CompactRecord)
+    const int32_t COMPACT_FLAG_KEYFRAME = 0x01;
+
+    const int32_t FIELD_LINK    = 0x01;     // body part and link number
+    const int32_t FIELD_COP     = 0x02;
+    const int32_t FIELD_FORCE   = 0x04;
+    const int32_t FIELD_MOMENT  = 0x08;
+    const int32_t FIELD_ALL     = FIELD_LINK | FIELD_COP | FIELD_FORCE | FIELD_MOMENT;
+
+    struct CompactHeader
+    {
+        int32_t  version;
+        int32_t  flags;
+        uint32_t stream;        // the writer
+        uint32_t seq;           // the blob, from the writer
+        uint32_t keySeq;        // the keyframe the entries refer to (seq itself in a keyframe)
+        int32_t  contacts;
+    };
+
+    struct CompactEntry
+    {
+        int32_t contactId;
+        int32_t fields;
+    };
+
+    // a contact as it is kept by the writer and by the readers
+    struct CompactRecord
+    {
+        int32_t contactId;
+        int32_t link[2];        // body part and link number
+        int32_t reserved;
+        double  CoP[3];
+        double  F[3];
+        double  Mu[3];
+    };
+
+    static_assert(sizeof(CompactHeader)==24 && sizeof(CompactEntry)==8 && sizeof(CompactRecord)==88,
+                  "the compact encoding must have no padding");
+
+    typedef map<int32_t, CompactRecord> Keyframe;      // by contact id, the first contact with that id
+
+    void append(vector<char> &blob, const void *data, size_t size)
+    {
+        const char *p = static_cast<const char*>(data);
+        blob.insert(blob.end(), p, p+size);
+    }
+
+    // the last keyframe of every writer, shared by all the readers of the process
+    struct KeyframeCache
+    {
+        struct Stream
+        {
+            uint32_t keySeq;
+            double   lastUse;
+            Keyframe contacts;
+        };
+
+        static const size_t maxStreams = 64;
+
+        mutex mtx;
+        map<uint32_t, Stream> streams;
+
+        // never destroyed, as the ports may read until the very end
+        static KeyframeCache& getInstance()
+        {
+            static KeyframeCache *cache = new KeyframeCache();
+            return *cache;
+        }
+    };
+}
+
+// the state of a writer: the last keyframe, which the deltas refer to, and the last blob, which is
+// written again as it is as long as the list does not change (e.g. on each connection of a port)
+struct dynContactList::CompactStream
+{
+    mutex mtx;
+    double keyframePeriod;
+    uint32_t id;
+    uint32_t seq;
+    uint32_t keySeq;
+    double keyTime;
+    Keyframe keyframe;
+    vector<CompactRecord> last;
+    vector<char> blob;
+
+    CompactStream(double _keyframePeriod)
+    :keyframePeriod(_keyframePeriod), seq(0), keySeq(0), keyTime(0.0)
+    {
+        random_device rd;
+        do { id = rd(); } while(id==0);
+    }
+};
+
 
 dynContactList::dynContactList()
 :vector<dynContact>(){}
@@ -26,25 +128,45 @@ dynContactList::dynContactList()
 dynContactList::dynContactList(const size_type &n, const dynContact& value)
 :vector<dynContact>(n, value){}
 
+void dynContactList::setCompactEncoding(bool compact, double keyframePeriod)
+{
+    if(compact)
+        compactStream = make_shared<CompactStream>(keyframePeriod);
+    else
+        compactStream.reset();
+}
+
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~
 //   SERIALIZATION methods
 //~~~~~~~~~~~~~~~~~~~~~~~~~~
 bool dynContactList::read(ConnectionReader& connection)
 {
-    // A dynContactList is represented as a list of list
-    // where each list is a skinContact
+    // A dynContactList is represented either as a list of list
+    // where each list is a dynContact, or as a list with a single blob (compact encoding)
     if(connection.expectInt32()!=BOTTLE_TAG_LIST)
         return false;
 
     int listLength = connection.expectInt32();
     if(listLength<0)
         return false;
+    if(listLength==0){
+        clear();
+        return !connection.isError();
+    }
+
+    // the tag of the first element tells the encoding
+    int tag = connection.expectInt32();
+    if(listLength==1 && tag==BOTTLE_TAG_BLOB)
+        return readCompact(connection);
+    if(tag!=BOTTLE_TAG_LIST)
+        return false;
+
     if(listLength!=size())
         resize(listLength);
 
     for(iterator it=begin(); it!=end(); it++)
-        if(!it->read(connection))
+        if(!(it==begin() ? it->readContent(connection) : it->read(connection)))
             return false;
 
     return !connection.isError();
@@ -52,6 +174,9 @@ bool dynContactList::read(ConnectionReader& connection)
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 bool dynContactList::write(ConnectionWriter& connection) const
 {
+    if(compactStream && !connection.isTextMode())
+        return writeCompact(connection);
+
     // A dynContactList is represented as a list of list
     // where each list is a skinContact
     connection.appendInt32(BOTTLE_TAG_LIST);
@@ -64,6 +189,196 @@ bool dynContactList::write(ConnectionWriter& connection) const
     return !connection.isError();
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool dynContactList::readCompact(ConnectionReader& connection)
+{
+    // the tag of the blob has already been read
+    int blobSize = connection.expectInt32();
+    CompactHeader h;
+    if(blobSize<(int)sizeof(h) || !connection.expectBlock(reinterpret_cast<char*>(&h), sizeof(h)))
+        return false;
+    if(h.version!=COMPACT_VERSION || h.contacts<0 || h.contacts>(blobSize-(int)sizeof(h))/(int)sizeof(CompactEntry))
+        return false;
+
+    vector<char> body(blobSize-sizeof(h));
+    if(!body.empty() && !connection.expectBlock(body.data(), body.size()))
+        return false;
+
+    bool keyframe = (h.flags & COMPACT_FLAG_KEYFRAME)!=0;
+    if(keyframe && h.keySeq!=h.seq)
+        return false;
+
+    KeyframeCache &cache = KeyframeCache::getInstance();
+    lock_guard<mutex> lck(cache.mtx);
+
+    const Keyframe *base = nullptr;
+    if(!keyframe){
+        map<uint32_t, KeyframeCache::Stream>::iterator s = cache.streams.find(h.stream);
+        if(s==cache.streams.end() || s->second.keySeq!=h.keySeq)
+            return false;
+        s->second.lastUse = Time::now();
+        base = &s->second.contacts;
+    }
+
+    vector<CompactRecord> records(h.contacts);
+    const char *p = body.data(), *end = body.data()+body.size();
+    for(size_t i=0; i<records.size(); i++){
+        CompactEntry e;
+        if(end-p<(ptrdiff_t)sizeof(e))
+            return false;
+        memcpy(&e, p, sizeof(e));
+        p += sizeof(e);
+
+        // the fields which are not in the entry are the ones of the keyframe
+        CompactRecord &r = records[i];
+        if(e.fields!=FIELD_ALL){
+            Keyframe::const_iterator k;
+            if(base==nullptr || (k=base->find(e.contactId))==base->end())
+                return false;
+            r = k->second;
+        }
+        r.contactId = e.contactId;
+        r.reserved  = 0;
+
+        struct { int32_t field; void *dst; size_t size; } parts[] = {
+            { FIELD_LINK,   r.link, sizeof(r.link) },
+            { FIELD_COP,    r.CoP,  sizeof(r.CoP) },
+            { FIELD_FORCE,  r.F,    sizeof(r.F) },
+            { FIELD_MOMENT, r.Mu,   sizeof(r.Mu) }
+        };
+        for(size_t j=0; j<sizeof(parts)/sizeof(parts[0]); j++){
+            if(e.fields & parts[j].field){
+                if(end-p<(ptrdiff_t)parts[j].size)
+                    return false;
+                memcpy(parts[j].dst, p, parts[j].size);
+                p += parts[j].size;
+            }
+        }
+    }
+    if(p!=end)
+        return false;
+
+    if(keyframe){
+        if(cache.streams.find(h.stream)==cache.streams.end() && cache.streams.size()>=KeyframeCache::maxStreams){
+            // the writer not heard of for the longest time makes room
+            map<uint32_t, KeyframeCache::Stream>::iterator oldest = cache.streams.begin();
+            for(map<uint32_t, KeyframeCache::Stream>::iterator s=cache.streams.begin(); s!=cache.streams.end(); s++)
+                if(s->second.lastUse<oldest->second.lastUse)
+                    oldest = s;
+            cache.streams.erase(oldest);
+        }
+        KeyframeCache::Stream &s = cache.streams[h.stream];
+        s.keySeq  = h.keySeq;
+        s.lastUse = Time::now();
+        s.contacts.clear();
+        for(size_t i=0; i<records.size(); i++)
+            s.contacts.insert(make_pair(records[i].contactId, records[i]));
+    }
+
+    resize(records.size());
+    for(size_t i=0; i<records.size(); i++){
+        dynContact &c = operator[](i);
+        const CompactRecord &r = records[i];
+        c.contactId     = r.contactId;
+        c.bodyPart      = (BodyPart)r.link[0];
+        c.linkNumber    = r.link[1];
+        for(int k=0;k<3;k++){
+            c.CoP[k]    = r.CoP[k];
+            c.F[k]      = r.F[k];
+            c.Mu[k]     = r.Mu[k];
+        }
+        c.setForce(c.F);
+    }
+
+    return !connection.isError();
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool dynContactList::writeCompact(ConnectionWriter& connection) const
+{
+    vector<CompactRecord> records(size());
+    for(size_t i=0; i<size(); i++){
+        const dynContact &c = operator[](i);
+        CompactRecord &r = records[i];
+        r.contactId     = (int32_t)c.contactId;
+        r.link[0]       = c.bodyPart;
+        r.link[1]       = c.linkNumber;
+        r.reserved      = 0;
+        for(int k=0;k<3;k++){
+            r.CoP[k]    = c.CoP[k];
+            r.F[k]      = c.F[k];
+            r.Mu[k]     = c.Mu[k];
+        }
+    }
+
+    CompactStream &s = *compactStream;
+    lock_guard<mutex> lck(s.mtx);
+
+    double now = Time::now();
+    bool keyframe = s.blob.empty() || (now-s.keyTime>=s.keyframePeriod);
+    bool changed = (records.size()!=s.last.size()) ||
+                   (!records.empty() && memcmp(records.data(), s.last.data(), records.size()*sizeof(CompactRecord))!=0);
+    if(keyframe || changed){
+        s.seq++;
+        if(keyframe){
+            s.keySeq  = s.seq;
+            s.keyTime = now;
+            s.keyframe.clear();
+            for(size_t i=0; i<records.size(); i++)
+                s.keyframe.insert(make_pair(records[i].contactId, records[i]));
+        }
+
+        CompactHeader h;
+        h.version   = COMPACT_VERSION;
+        h.flags     = keyframe ? COMPACT_FLAG_KEYFRAME : 0;
+        h.stream    = s.id;
+        h.seq       = s.seq;
+        h.keySeq    = s.keySeq;
+        h.contacts  = (int32_t)records.size();
+
+        s.blob.clear();
+        append(s.blob, &h, sizeof(h));
+        for(size_t i=0; i<records.size(); i++){
+            const CompactRecord &r = records[i];
+            CompactEntry e;
+            e.contactId = r.contactId;
+            e.fields    = FIELD_ALL;
+            if(!keyframe){
+                Keyframe::const_iterator k = s.keyframe.find(r.contactId);
+                if(k!=s.keyframe.end()){
+                    const CompactRecord &b = k->second;
+                    e.fields = 0;
+                    if(memcmp(r.link, b.link, sizeof(r.link))!=0)
+                        e.fields |= FIELD_LINK;
+                    if(memcmp(r.CoP, b.CoP, sizeof(r.CoP))!=0)
+                        e.fields |= FIELD_COP;
+                    if(memcmp(r.F, b.F, sizeof(r.F))!=0)
+                        e.fields |= FIELD_FORCE;
+                    if(memcmp(r.Mu, b.Mu, sizeof(r.Mu))!=0)
+                        e.fields |= FIELD_MOMENT;
+                }
+            }
+
+            append(s.blob, &e, sizeof(e));
+            if(e.fields & FIELD_LINK)
+                append(s.blob, r.link, sizeof(r.link));
+            if(e.fields & FIELD_COP)
+                append(s.blob, r.CoP, sizeof(r.CoP));
+            if(e.fields & FIELD_FORCE)
+                append(s.blob, r.F, sizeof(r.F));
+            if(e.fields & FIELD_MOMENT)
+                append(s.blob, r.Mu, sizeof(r.Mu));
+        }
+        s.last.swap(records);
+    }
+
+    connection.appendInt32(BOTTLE_TAG_LIST);
+    connection.appendInt32(1);
+    connection.appendInt32(BOTTLE_TAG_BLOB);
+    connection.appendInt32((int32_t)s.blob.size());
+    connection.appendBlock(s.blob.data(), s.blob.size());
+
+    return !connection.isError();
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 string dynContactList::toString(const int &precision) const{
     stringstream ss;
     for(const_iterator it=begin();it!=end();it++)
@@ -88,6 +88,20 @@ using namespace iCub::skinDynLib;
         return true;
     }
 
+int iCubSkin::updateWRFPositions(const std::map<SkinPart, yarp::sig::Matrix> &_H)
+{
+    int updated = 0;
+    for (size_t i = 0; i < skin.size(); ++i)
+    {
+        std::map<SkinPart, yarp::sig::Matrix>::const_iterator it = _H.find(getSkinPartFromString(skin[i].getName()));
+        if (it!=_H.end() && skin[i].updateWRFPositions(it->second))
+        {
+            updated++;
+        }
+    }
+    return updated;
+}
+
 void iCubSkin::print(int verbosity)
 {
     yDebug("********************\n");
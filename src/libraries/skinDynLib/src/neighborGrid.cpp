@@ -0,0 +1,147 @@
+#include "iCub/skinDynLib/neighborGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace iCub::skinDynLib;
+
+/****************************************************************/
+/* NEIGHBORGRID WRAPPER
+*****************************************************************/
+    neighborGrid::neighborGrid() : maxDist(0.0), cellSize(1.0) {}
+
+    neighborGrid::Cell neighborGrid::cellOf(const double *p) const
+    {
+        // the coordinates are clamped so that far away (or not finite) positions do not overflow the cell index
+        const double lim = 1.0e15;
+        Cell c;
+        int64_t *idx[3] = {&c.x, &c.y, &c.z};
+        for (int k = 0; k < 3; k++)
+        {
+            double v = p[k]/cellSize;
+            if (!(v > -lim))    v = -lim;
+            else if (v > lim)   v = lim;
+            *idx[k] = static_cast<int64_t>(std::floor(v));
+        }
+        return c;
+    }
+
+    void neighborGrid::add(unsigned int _id)
+    {
+        Cell c = cellOf(&positions[3*_id]);
+        taxelCell[_id] = c;
+        cells[c].push_back(_id);
+    }
+
+    void neighborGrid::remove(unsigned int _id)
+    {
+        std::unordered_map<Cell, std::vector<int>, CellHash>::iterator it = cells.find(taxelCell[_id]);
+        if (it == cells.end())
+        {
+            return;
+        }
+
+        std::vector<int> &v = it->second;
+        std::vector<int>::iterator t = std::find(v.begin(), v.end(), int(_id));
+        if (t != v.end())
+        {
+            *t = v.back();
+            v.pop_back();
+        }
+        if (v.empty())
+        {
+            cells.erase(it);
+        }
+    }
+
+    void neighborGrid::build(const std::vector<yarp::sig::Vector> &_positions, double _maxDist)
+    {
+        maxDist  = std::max(_maxDist, 0.0);
+        // with a zero distance only the taxels in the same position are neighbors: any cell size is fine
+        cellSize = (maxDist > 0.0) ? maxDist : 1.0;
+
+        positions.assign(3*_positions.size(), 0.0);
+        taxelCell.resize(_positions.size());
+        cells.clear();
+        cells.reserve(_positions.size());
+        for (size_t i = 0; i < _positions.size(); i++)
+        {
+            for (size_t k = 0; (k < 3) && (k < _positions[i].size()); k++)
+            {
+                positions[3*i+k] = _positions[i][k];
+            }
+            add(i);
+        }
+    }
+
+    bool neighborGrid::move(unsigned int _id, const yarp::sig::Vector &_position)
+    {
+        if (_id >= taxelCell.size())
+        {
+            return false;
+        }
+
+        remove(_id);
+        for (size_t k = 0; k < 3; k++)
+        {
+            positions[3*_id+k] = (k < _position.size()) ? _position[k] : 0.0;
+        }
+        add(_id);
+        return true;
+    }
+
+    void neighborGrid::getNeighbors(unsigned int _id, std::vector<int> &_neighbors) const
+    {
+        _neighbors.clear();
+        if (_id >= taxelCell.size())
+        {
+            return;
+        }
+
+        const double *p = &positions[3*_id];
+        const double d2 = maxDist*maxDist;
+        const Cell &c = taxelCell[_id];
+        for (int64_t dx = -1; dx <= 1; dx++)
+        for (int64_t dy = -1; dy <= 1; dy++)
+        for (int64_t dz = -1; dz <= 1; dz++)
+        {
+            Cell n = {c.x+dx, c.y+dy, c.z+dz};
+            std::unordered_map<Cell, std::vector<int>, CellHash>::const_iterator it = cells.find(n);
+            if (it == cells.end())
+            {
+                continue;
+            }
+            for (size_t t = 0; t < it->second.size(); t++)
+            {
+                int j = it->second[t];
+                if (j == int(_id))
+                {
+                    continue;
+                }
+                const double *q = &positions[3*j];
+                double v[3] = {p[0]-q[0], p[1]-q[1], p[2]-q[2]};
+                if (v[0]*v[0] + v[1]*v[1] + v[2]*v[2] <= d2)
+                {
+                    _neighbors.push_back(j);
+                }
+            }
+        }
+    }
+
+    void neighborGrid::getAllNeighbors(std::vector<int> &_start, std::vector<int> &_neighbors) const
+    {
+        std::vector<int> n;
+        _start.resize(size()+1);
+        _neighbors.clear();
+        for (size_t i = 0; i < size(); i++)
+        {
+            _start[i] = _neighbors.size();
+            getNeighbors(i, n);
+            std::sort(n.begin(), n.end());
+            _neighbors.insert(_neighbors.end(), n.begin(), n.end());
+        }
+        _start[size()] = _neighbors.size();
+    }
+
+// empty line to make gcc happy
@@ -165,7 +165,13 @@ bool skinContact::read(ConnectionReader& connection){
     // - a list of 3 double, i.e. the normal direction
     // - a list of N int, i.e. the active taxel ids
     // - a double, i.e. the pressure
-    if(connection.expectInt32() != BOTTLE_TAG_LIST || connection.expectInt32() != 8)
+    if(connection.expectInt32() != BOTTLE_TAG_LIST)
+        return false;
+    return readContent(connection);
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool skinContact::readContent(ConnectionReader& connection){
+    if(connection.expectInt32() != 8)
         return false;
 
     // - a list of 4 int, i.e. contactId, bodyPart, linkNumber, skinPart
@@ -9,6 +9,8 @@
 #include <sstream>
 #include <iomanip>
 #include <string>
+#include <cstring>
+#include <stdint.h>
 
 #include <yarp/os/ConnectionReader.h>
 #include <yarp/os/ConnectionWriter.h>
@@ -20,15 +22,48 @@ using namespace std;
 using namespace yarp::os;
 using namespace iCub::skinDynLib;
 
+namespace {
+    // the compact encoding is a blob made of a header, a record for each contact and then,
+    // if the flag is set, the taxel ids of all the contacts one after the other
+    const int32_t COMPACT_FLAG_TAXEL_LIST = 0x01;
+
+    struct CompactHeader
+    {
+        int32_t version;
+        int32_t flags;
+        int32_t contacts;
+        int32_t taxels;         // number of taxel ids after the records
+    };
+
+    struct CompactContact
+    {
+        double CoP[3];
+        double F[3];
+        double Mu[3];
+        double geoCenter[3];
+        double normalDir[3];
+        double pressure;
+        int32_t contactId;
+        int32_t bodyPart;
+        int32_t linkNumber;
+        int32_t skinPart;
+        int32_t activeTaxels;
+        int32_t reserved;
+    };
+
+    static_assert(sizeof(CompactHeader)==16 && sizeof(CompactContact)==152, "the compact encoding must have no padding");
+    static_assert(sizeof(unsigned int)==sizeof(int32_t), "the taxel ids are copied as blocks of int32");
+}
+
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 //   CONSTRUCTORS
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 skinContactList::skinContactList()
-:vector<skinContact>(){}
+:vector<skinContact>(), compactEncoding(false), compactTaxelList(true){}
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 skinContactList::skinContactList(const size_type &n, const skinContact& value)
-:vector<skinContact>(n, value){}
+:vector<skinContact>(n, value), compactEncoding(false), compactTaxelList(true){}
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 skinContactList skinContactList::filterBodyPart(const BodyPart &bp)
 {
@@ -59,19 +94,31 @@ map<SkinPart, skinContactList> skinContactList::splitPerSkinPart()
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 bool skinContactList::read(ConnectionReader& connection)
 {
-    // A skinContactList is represented as a list of list
-    // where each list is a skinContact
+    // A skinContactList is represented either as a list of list
+    // where each list is a skinContact, or as a list with a single blob (compact encoding)
     if(connection.expectInt32()!=BOTTLE_TAG_LIST)
         return false;
 
     int listLength = connection.expectInt32();
     if(listLength<0)
         return false;
+    if(listLength==0){
+        clear();
+        return !connection.isError();
+    }
+
+    // the tag of the first element tells the encoding
+    int tag = connection.expectInt32();
+    if(listLength==1 && tag==BOTTLE_TAG_BLOB)
+        return readCompact(connection);
+    if(tag!=BOTTLE_TAG_LIST)
+        return false;
+
     if(listLength!=size())
         resize(listLength);
 
     for(iterator it=begin(); it!=end(); it++)
-        if(!it->read(connection))
+        if(!(it==begin() ? it->readContent(connection) : it->read(connection)))
             return false;
 
     return !connection.isError();
@@ -79,6 +126,9 @@ bool skinContactList::read(ConnectionReader& connection)
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 bool skinContactList::write(ConnectionWriter& connection) const
 {
+    if(compactEncoding && !connection.isTextMode())
+        return writeCompact(connection);
+
     // A skinContactList is represented as a list of list
     // where each list is a skinContact
     connection.appendInt32(BOTTLE_TAG_LIST);
@@ -91,6 +141,107 @@ bool skinContactList::write(ConnectionWriter& connection) const
     return !connection.isError();
 }
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool skinContactList::readCompact(ConnectionReader& connection)
+{
+    // the tag of the blob has already been read
+    int blobSize = connection.expectInt32();
+    CompactHeader h;
+    if(blobSize<(int)sizeof(h) || !connection.expectBlock(reinterpret_cast<char*>(&h), sizeof(h)))
+        return false;
+
+    bool withTaxelList = (h.flags & COMPACT_FLAG_TAXEL_LIST)!=0;
+    if(h.version!=COMPACT_VERSION || h.contacts<0 || h.taxels<0 || (!withTaxelList && h.taxels>0) ||
+       h.contacts>blobSize/(int)sizeof(CompactContact) || h.taxels>blobSize/(int)sizeof(int32_t) ||
+       (size_t)blobSize!=sizeof(h) + h.contacts*sizeof(CompactContact) + h.taxels*sizeof(int32_t))
+        return false;
+
+    resize(h.contacts);
+    int32_t taxels = 0;
+    CompactContact c;
+    for(iterator it=begin(); it!=end(); it++){
+        if(!connection.expectBlock(reinterpret_cast<char*>(&c), sizeof(c)) || c.activeTaxels<0 ||
+           (withTaxelList && c.activeTaxels>h.taxels-taxels))
+            return false;
+        for(int i=0;i<3;i++){
+            it->CoP[i]          = c.CoP[i];
+            it->F[i]            = c.F[i];
+            it->Mu[i]           = c.Mu[i];
+            it->geoCenter[i]    = c.geoCenter[i];
+            it->normalDir[i]    = c.normalDir[i];
+        }
+        it->setForce(it->F);
+        it->pressure    = c.pressure;
+        it->contactId   = c.contactId;
+        it->bodyPart    = (BodyPart)c.bodyPart;
+        it->linkNumber  = c.linkNumber;
+        it->skinPart    = (SkinPart)c.skinPart;
+        it->setActiveTaxels(c.activeTaxels);
+        taxels += c.activeTaxels;
+    }
+    if(withTaxelList){
+        if(taxels!=h.taxels)
+            return false;
+        // the taxel ids are written straight into the lists, resized by setActiveTaxels()
+        for(iterator it=begin(); it!=end(); it++)
+            if(it->activeTaxels>0 && !connection.expectBlock(reinterpret_cast<char*>(it->taxelList.data()), it->activeTaxels*sizeof(int32_t)))
+                return false;
+    }
+
+    return !connection.isError();
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+bool skinContactList::writeCompact(ConnectionWriter& connection) const
+{
+    CompactHeader h;
+    h.version   = COMPACT_VERSION;
+    h.flags     = compactTaxelList ? COMPACT_FLAG_TAXEL_LIST : 0;
+    h.contacts  = size();
+    h.taxels    = 0;
+    if(compactTaxelList)
+        for(auto it=begin(); it!=end(); it++)
+            h.taxels += it->activeTaxels;
+
+    // the blob is built here and copied by appendBlock()
+    vector<char> blob(sizeof(h) + size()*sizeof(CompactContact) + h.taxels*sizeof(int32_t));
+    char* p = blob.data();
+    memcpy(p, &h, sizeof(h));
+    p += sizeof(h);
+
+    CompactContact c;
+    for(auto it=begin(); it!=end(); it++){
+        for(int i=0;i<3;i++){
+            c.CoP[i]        = it->CoP[i];
+            c.F[i]          = it->F[i];
+            c.Mu[i]         = it->Mu[i];
+            c.geoCenter[i]  = it->geoCenter[i];
+            c.normalDir[i]  = it->normalDir[i];
+        }
+        c.pressure      = it->pressure;
+        c.contactId     = it->contactId;
+        c.bodyPart      = it->bodyPart;
+        c.linkNumber    = it->linkNumber;
+        c.skinPart      = it->skinPart;
+        c.activeTaxels  = it->activeTaxels;
+        c.reserved      = 0;
+        memcpy(p, &c, sizeof(c));
+        p += sizeof(c);
+    }
+    if(compactTaxelList){
+        for(auto it=begin(); it!=end(); it++){
+            memcpy(p, it->taxelList.data(), it->activeTaxels*sizeof(int32_t));
+            p += it->activeTaxels*sizeof(int32_t);
+        }
+    }
+
+    connection.appendInt32(BOTTLE_TAG_LIST);
+    connection.appendInt32(1);
+    connection.appendInt32(BOTTLE_TAG_BLOB);
+    connection.appendInt32((int32_t)blob.size());
+    connection.appendBlock(blob.data(), blob.size());
+
+    return !connection.isError();
+}
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 dynContactList skinContactList::toDynContactList() const
 {
     dynContactList res(this->size());
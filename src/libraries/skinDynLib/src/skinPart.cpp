@@ -1,4 +1,7 @@
 #include "iCub/skinDynLib/skinPart.h"
+#include "iCub/skinDynLib/taxelPositionFile.h"
+
+#include <cmath>
 
 using namespace yarp::math;
 using namespace iCub::skinDynLib;
@@ -73,6 +76,18 @@ using namespace iCub::skinDynLib;
         return res.str();
     }
 
+/****************************************************************/
+/* SKINPART TAXEL ARRAYS
+*****************************************************************/
+    void skinPart::TaxelArrays::resize(size_t _n)
+    {
+        id.resize(_n);
+        x.resize(_n);  y.resize(_n);  z.resize(_n);
+        nx.resize(_n); ny.resize(_n); nz.resize(_n);
+        wx.resize(_n); wy.resize(_n); wz.resize(_n);
+        activation.resize(_n);
+    }
+
 /****************************************************************/
 /* SKINPART TAXEL WRAPPER
 *****************************************************************/
@@ -111,6 +126,7 @@ using namespace iCub::skinDynLib;
         {
             taxels.push_back(new Taxel(*(*it)));
         }
+        arrays = _sp.arrays;
 
         return *this;
     }
@@ -123,14 +139,13 @@ using namespace iCub::skinDynLib;
         filename = strrchr(_filePath.c_str(), '/');
         filename = filename.c_str() ? filename.c_str() + 1 : _filePath.c_str();
 
-        yarp::os::ResourceFinder rf;
-        rf.setDefaultContext("skinGui");            //overridden by --context parameter
-        rf.setDefaultConfigFile(_filePath.c_str()); //overridden by --from parameter
-        rf.configure(0,NULL);
+        // the file is parsed once, then it is read from its binary cache
+        taxelPositionFile file;
+        file.load(_filePath);
         
-        if (rf.check("name"))
+        if (file.hasName)
         {
-            setName(rf.find("name").asString());
+            setName(file.name);
         }
         else
         {
@@ -155,9 +170,9 @@ using namespace iCub::skinDynLib;
         }
         yTrace("[skinPart] name set to %s",name.c_str());
 
-        if (rf.check("spatial_sampling"))
+        if (file.hasSpatialSampling)
         {
-            std::string _ss=rf.find("spatial_sampling").asString();
+            std::string _ss=file.spatialSampling;
 
             // This lets us override the field without touching the .ini file
             if (_spatial_sampling=="default" && (_ss=="taxel" || _ss=="triangle"))
@@ -180,8 +195,7 @@ using namespace iCub::skinDynLib;
             spatial_sampling = _spatial_sampling;
         }
 
-        yarp::os::Bottle &calibration = rf.findGroup("calibration");
-        if (calibration.isNull())
+        if (!file.hasCalibration)
         {
             yWarning("[skinPart::setTaxelPosesFromFile] No calibration group found!");
             yWarning("[skinPart::setTaxelPosesFromFile] Using old convention");
@@ -189,34 +203,34 @@ using namespace iCub::skinDynLib;
             return setTaxelPosesFromFileOld(_filePath);
         }
 
-        // First item of the bottle is "calibration", so we should not use it
-        setSize(calibration.size()-1);
+        setSize(file.getPosesSize());
         yarp::sig::Vector taxelPos(3,0.0);
         yarp::sig::Vector taxelNrm(3,0.0);
-        yarp::sig::Vector taxelPosNrm(6,0.0);
 
         for (int i = 1; i < getSize(); i++)
         {
-            taxelPosNrm = vectorFromBottle(*(calibration.get(i).asList()),0,6);
-            taxelPos = taxelPosNrm.subVector(0,2);
-            taxelNrm = taxelPosNrm.subVector(3,5);
+            const double *pose = file.getPose(i-1);
+            for (int j = 0; j < 3; j++)
+            {
+                taxelPos[j] = pose[j];
+                taxelNrm[j] = pose[3+j];
+            }
             // the NULL taxels will be automatically discarded 
             if (norm(taxelNrm) != 0 || norm(taxelPos) != 0)
             {
                 taxels.push_back(new Taxel(taxelPos,taxelNrm,i-1));
             }
         }
+        syncTaxelArrays();
 
         // Let's read the mapping of the taxels onto the center of their triangle
         // even if the spatial_sampling variable is "taxel"
         // (it might come useful later)
-        if (rf.check("taxel2Repr"))
+        if (file.hasTaxel2Repr)
         {
-            yarp::os::Bottle b = *(rf.find("taxel2Repr").asList());
-            
             for (int i = 0; i < getSize(); i++)
             {
-                taxel2Repr.push_back(b.get(i).asInt32());
+                taxel2Repr.push_back(file.getTaxel2Repr(i));
             }
             initRepresentativeTaxels();
         }
@@ -278,6 +292,7 @@ using namespace iCub::skinDynLib;
             else
                 setSize(getSize()+1);
         }
+        syncTaxelArrays();
 
         return mapTaxelsOntoThemselves() && initRepresentativeTaxels();
     }
@@ -327,6 +342,189 @@ using namespace iCub::skinDynLib;
         return true;
     }
 
+    void skinPart::getTaxelNeighbors(double _maxDist, std::vector<std::vector<int> > &_neighbors)
+    {
+        std::lock_guard<std::recursive_mutex> rlg(recursive_mtx);
+        std::vector<yarp::sig::Vector> positions(taxels.size());
+        for (size_t i = 0; i < taxels.size(); i++)
+        {
+            positions[i] = taxels[i]->getPosition();
+        }
+
+        neighborGrid grid;
+        grid.build(positions, _maxDist);
+        _neighbors.resize(taxels.size());
+        for (size_t i = 0; i < taxels.size(); i++)
+        {
+            grid.getNeighbors(i, _neighbors[i]);
+        }
+    }
+
+    bool skinPart::updateWRFPositions(const yarp::sig::Matrix &_H)
+    {
+        if (_H.rows()!=4 || _H.cols()!=4)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::recursive_mutex> rlg(recursive_mtx);
+        checkTaxelArrays();
+
+        // the matrix is read once, so that the loop does not reload it through the output arrays
+        const double *H = _H.data();
+        const double h0 = H[0], h1 = H[1], h2  = H[2],  h3  = H[3];
+        const double h4 = H[4], h5 = H[5], h6  = H[6],  h7  = H[7];
+        const double h8 = H[8], h9 = H[9], h10 = H[10], h11 = H[11];
+
+        const size_t n = arrays.size();
+        const double *x = arrays.x.data(), *y = arrays.y.data(), *z = arrays.z.data();
+        double *wx = arrays.wx.data(), *wy = arrays.wy.data(), *wz = arrays.wz.data();
+        for (size_t i = 0; i < n; i++)
+        {
+            wx[i] = h0*x[i] + h1*y[i] + h2*z[i]  + h3;
+            wy[i] = h4*x[i] + h5*y[i] + h6*z[i]  + h7;
+            wz[i] = h8*x[i] + h9*y[i] + h10*z[i] + h11;
+        }
+
+        // the taxels give the same positions through getWRFPosition()
+        yarp::sig::Vector wrf(3);
+        for (size_t i = 0; i < n; i++)
+        {
+            wrf[0] = wx[i]; wrf[1] = wy[i]; wrf[2] = wz[i];
+            taxels[i]->setWRFPosition(wrf);
+        }
+        return true;
+    }
+
+    void skinPart::checkTaxelArrays()
+    {
+        if (arrays.size() != taxels.size())
+        {
+            syncTaxelArrays();
+        }
+    }
+
+    void skinPart::syncTaxelArrays()
+    {
+        std::lock_guard<std::recursive_mutex> rlg(recursive_mtx);
+        const size_t n = taxels.size();
+        arrays.resize(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            yarp::sig::Vector pos = taxels[i]->getPosition();
+            yarp::sig::Vector nrm = taxels[i]->getNormal();
+            yarp::sig::Vector wrf = taxels[i]->getWRFPosition();
+
+            arrays.id[i] = taxels[i]->getID();
+            arrays.x[i]  = pos[0]; arrays.y[i]  = pos[1]; arrays.z[i]  = pos[2];
+            arrays.nx[i] = nrm[0]; arrays.ny[i] = nrm[1]; arrays.nz[i] = nrm[2];
+            arrays.wx[i] = wrf[0]; arrays.wy[i] = wrf[1]; arrays.wz[i] = wrf[2];
+            arrays.activation[i] = 0.0;
+        }
+    }
+
+    bool skinPart::setActivations(const yarp::sig::Vector &_data)
+    {
+        std::lock_guard<std::recursive_mutex> rlg(recursive_mtx);
+        checkTaxelArrays();
+
+        bool ret = true;
+        const size_t n = arrays.size();
+        for (size_t i = 0; i < n; i++)
+        {
+            int id = arrays.id[i];
+            if (id >= 0 && (size_t)id < _data.size())
+            {
+                arrays.activation[i] = _data[id];
+            }
+            else
+            {
+                arrays.activation[i] = 0.0;
+                ret = false;
+            }
+        }
+        return ret;
+    }
+
+    int skinPart::getActiveTaxels(double _thres, std::vector<int> &_active)
+    {
+        std::lock_guard<std::recursive_mutex> rlg(recursive_mtx);
+        checkTaxelArrays();
+
+        _active.clear();
+        const size_t n = arrays.size();
+        const double *a = arrays.activation.data();
+        for (size_t i = 0; i < n; i++)
+        {
+            if (a[i] > _thres)
+            {
+                _active.push_back((int)i);
+            }
+        }
+        return (int)_active.size();
+    }
+
+    bool skinPart::getActivationCenter(yarp::sig::Vector &_center, bool _wrf)
+    {
+        std::lock_guard<std::recursive_mutex> rlg(recursive_mtx);
+        checkTaxelArrays();
+
+        const size_t n = arrays.size();
+        const double *a = arrays.activation.data();
+        const double *x = _wrf ? arrays.wx.data() : arrays.x.data();
+        const double *y = _wrf ? arrays.wy.data() : arrays.y.data();
+        const double *z = _wrf ? arrays.wz.data() : arrays.z.data();
+
+        double sum = 0.0, cx = 0.0, cy = 0.0, cz = 0.0;
+        for (size_t i = 0; i < n; i++)
+        {
+            double w = a[i] > 0.0 ? a[i] : 0.0;
+            sum += w;
+            cx  += w*x[i];
+            cy  += w*y[i];
+            cz  += w*z[i];
+        }
+
+        if (sum <= 0.0)
+        {
+            return false;
+        }
+
+        _center.resize(3);
+        _center[0] = cx/sum;
+        _center[1] = cy/sum;
+        _center[2] = cz/sum;
+        return true;
+    }
+
+    bool skinPart::getProjections(const yarp::sig::Vector &_point, std::vector<double> &_distance,
+                                  std::vector<double> &_height)
+    {
+        if (_point.size() != 3)
+        {
+            return false;
+        }
+
+        std::lock_guard<std::recursive_mutex> rlg(recursive_mtx);
+        checkTaxelArrays();
+
+        const size_t n = arrays.size();
+        _distance.resize(n);
+        _height.resize(n);
+
+        const double px = _point[0], py = _point[1], pz = _point[2];
+        const double *x  = arrays.x.data(),  *y  = arrays.y.data(),  *z  = arrays.z.data();
+        const double *nx = arrays.nx.data(), *ny = arrays.ny.data(), *nz = arrays.nz.data();
+        double *d = _distance.data(), *h = _height.data();
+        for (size_t i = 0; i < n; i++)
+        {
+            double dx = px - x[i], dy = py - y[i], dz = pz - z[i];
+            d[i] = sqrt(dx*dx + dy*dy + dz*dz);
+            h[i] = dx*nx[i] + dy*ny[i] + dz*nz[i];
+        }
+        return true;
+    }
+
     int skinPart::getTaxelsSize()
     {
          return taxels.size();
@@ -344,6 +542,7 @@ using namespace iCub::skinDynLib;
             taxels.pop_back();
         }
         taxels.clear();
+        arrays.resize(0);
     }
 
     void skinPart::print(int verbosity)
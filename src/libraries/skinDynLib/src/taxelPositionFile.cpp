@@ -0,0 +1,258 @@
+#include "iCub/skinDynLib/taxelPositionFile.h"
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Log.h>
+#include <yarp/os/ResourceFinder.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using namespace iCub::skinDynLib;
+
+namespace
+{
+    const char     CACHE_MAGIC[8] = {'S','K','I','N','P','O','S','E'};
+    const uint32_t CACHE_VERSION  = 1;
+
+    enum { FLAG_NAME=0x01, FLAG_SPATIAL_SAMPLING=0x02, FLAG_CALIBRATION=0x04, FLAG_TAXEL2REPR=0x08 };
+
+    // the header of the cache, followed by the poses (double), taxel2Repr (int32), the name and the spatial sampling
+    struct CacheHeader
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t flags;
+        uint64_t sourceSize;    // size of the text file
+        int64_t  sourceMtime;   // modification time of the text file
+        uint32_t poses;         // number of doubles
+        uint32_t taxel2Repr;    // number of int32
+        uint32_t nameLength;
+        uint32_t spatialSamplingLength;
+        uint64_t checksum;      // of everything after the header
+        uint64_t reserved;
+    };
+    static_assert(sizeof(CacheHeader)==64, "the header of the cache must have no padding");
+
+    // FNV-1a
+    uint64_t checksum(const char *_data, size_t _size)
+    {
+        uint64_t h = 14695981039346656037ULL;
+        for (size_t i = 0; i < _size; i++)
+        {
+            h ^= (unsigned char)_data[i];
+            h *= 1099511628211ULL;
+        }
+        return h;
+    }
+}
+
+/****************************************************************/
+/* TAXELPOSITIONFILE WRAPPER
+*****************************************************************/
+    taxelPositionFile::taxelPositionFile()
+    {
+        clear();
+    }
+
+    void taxelPositionFile::clear()
+    {
+        hasName = hasSpatialSampling = hasCalibration = hasTaxel2Repr = false;
+        name.clear();
+        spatialSampling.clear();
+        poses.clear();
+        taxel2Repr.clear();
+    }
+
+    bool taxelPositionFile::load(const std::string &_filePath)
+    {
+        clear();
+
+        struct stat st;
+        if (stat(_filePath.c_str(),&st)!=0)
+        {
+            // let the ResourceFinder try to locate it, as the loaders used to do
+            return loadText(_filePath);
+        }
+
+        std::string cachePath = _filePath + ".bin";
+        uint64_t size  = (uint64_t)st.st_size;
+        int64_t  mtime = (int64_t)st.st_mtime;
+        if (loadCache(cachePath,size,mtime))
+        {
+            yDebug("[taxelPositionFile] %s loaded from its cache",_filePath.c_str());
+            return true;
+        }
+
+        clear();
+        loadText(_filePath);
+        if (saveCache(cachePath,size,mtime))
+        {
+            yDebug("[taxelPositionFile] cache of %s written into %s",_filePath.c_str(),cachePath.c_str());
+        }
+        return true;
+    }
+
+    bool taxelPositionFile::loadText(const std::string &_filePath)
+    {
+        yarp::os::ResourceFinder rf;
+        rf.setDefaultContext("skinGui");            //overridden by --context parameter
+        rf.setDefaultConfigFile(_filePath.c_str()); //overridden by --from parameter
+        rf.configure(0,NULL);
+
+        if (rf.check("name"))
+        {
+            hasName = true;
+            name = rf.find("name").asString();
+        }
+
+        if (rf.check("spatial_sampling"))
+        {
+            hasSpatialSampling = true;
+            spatialSampling = rf.find("spatial_sampling").asString();
+        }
+
+        // First item of the bottle is "calibration", so we should not use it
+        yarp::os::Bottle &calibration = rf.findGroup("calibration");
+        if (!calibration.isNull())
+        {
+            hasCalibration = true;
+            poses.assign(6*(calibration.size()-1),0.0);
+            for (size_t i = 1; i < calibration.size(); i++)
+            {
+                yarp::os::Bottle *line = calibration.get(i).asList();
+                for (size_t j = 0; line!=NULL && j < 6; j++)
+                {
+                    poses[6*(i-1)+j] = line->get(j).asFloat64();
+                }
+            }
+        }
+
+        if (rf.check("taxel2Repr") && rf.find("taxel2Repr").asList()!=NULL)
+        {
+            hasTaxel2Repr = true;
+            yarp::os::Bottle *b = rf.find("taxel2Repr").asList();
+            for (size_t i = 0; i < b->size(); i++)
+            {
+                taxel2Repr.push_back(b->get(i).asInt32());
+            }
+        }
+
+        return hasName || hasSpatialSampling || hasCalibration || hasTaxel2Repr;
+    }
+
+    bool taxelPositionFile::loadCache(const std::string &_cachePath, uint64_t _size, int64_t _mtime)
+    {
+        std::ifstream f(_cachePath.c_str(), std::ios::in | std::ios::binary);
+        if (!f.is_open())
+        {
+            return false;
+        }
+
+        CacheHeader h;
+        if (!f.read(reinterpret_cast<char*>(&h),sizeof(h)) || memcmp(h.magic,CACHE_MAGIC,sizeof(CACHE_MAGIC))!=0 ||
+            h.version!=CACHE_VERSION || h.sourceSize!=_size || h.sourceMtime!=_mtime)
+        {
+            return false;
+        }
+
+        size_t payloadSize = (size_t)h.poses*sizeof(double) + (size_t)h.taxel2Repr*sizeof(int32_t) +
+                             (size_t)h.nameLength + (size_t)h.spatialSamplingLength;
+        std::vector<char> payload(payloadSize);
+        if ((payloadSize>0 && !f.read(payload.data(),payloadSize)) || f.peek()!=EOF ||
+            checksum(payload.data(),payloadSize)!=h.checksum || h.poses%6!=0)
+        {
+            yWarning("[taxelPositionFile] %s is corrupted, it will be rewritten",_cachePath.c_str());
+            return false;
+        }
+
+        const char *p = payload.data();
+        poses.resize(h.poses);
+        for (size_t i = 0; i < poses.size(); i++, p += sizeof(double))
+        {
+            memcpy(&poses[i],p,sizeof(double));
+        }
+
+        taxel2Repr.resize(h.taxel2Repr);
+        for (size_t i = 0; i < taxel2Repr.size(); i++, p += sizeof(int32_t))
+        {
+            int32_t v;
+            memcpy(&v,p,sizeof(v));
+            taxel2Repr[i] = v;
+        }
+
+        name.assign(p,h.nameLength);
+        p += h.nameLength;
+        spatialSampling.assign(p,h.spatialSamplingLength);
+
+        hasName            = (h.flags & FLAG_NAME)!=0;
+        hasSpatialSampling = (h.flags & FLAG_SPATIAL_SAMPLING)!=0;
+        hasCalibration     = (h.flags & FLAG_CALIBRATION)!=0;
+        hasTaxel2Repr      = (h.flags & FLAG_TAXEL2REPR)!=0;
+        return true;
+    }
+
+    bool taxelPositionFile::saveCache(const std::string &_cachePath, uint64_t _size, int64_t _mtime) const
+    {
+        std::vector<char> payload(poses.size()*sizeof(double) + taxel2Repr.size()*sizeof(int32_t) +
+                                  name.size() + spatialSampling.size());
+        char *p = payload.data();
+        for (size_t i = 0; i < poses.size(); i++, p += sizeof(double))
+        {
+            memcpy(p,&poses[i],sizeof(double));
+        }
+        for (size_t i = 0; i < taxel2Repr.size(); i++, p += sizeof(int32_t))
+        {
+            int32_t v = taxel2Repr[i];
+            memcpy(p,&v,sizeof(v));
+        }
+        name.copy(p,name.size());
+        p += name.size();
+        spatialSampling.copy(p,spatialSampling.size());
+
+        CacheHeader h;
+        memset(&h,0,sizeof(h));
+        memcpy(h.magic,CACHE_MAGIC,sizeof(CACHE_MAGIC));
+        h.version               = CACHE_VERSION;
+        h.flags                 = (hasName ? FLAG_NAME : 0) | (hasSpatialSampling ? FLAG_SPATIAL_SAMPLING : 0) |
+                                  (hasCalibration ? FLAG_CALIBRATION : 0) | (hasTaxel2Repr ? FLAG_TAXEL2REPR : 0);
+        h.sourceSize            = _size;
+        h.sourceMtime           = _mtime;
+        h.poses                 = (uint32_t)poses.size();
+        h.taxel2Repr            = (uint32_t)taxel2Repr.size();
+        h.nameLength            = (uint32_t)name.size();
+        h.spatialSamplingLength = (uint32_t)spatialSampling.size();
+        h.checksum              = checksum(payload.data(),payload.size());
+
+        // the cache is written aside and then renamed, so that a concurrent reader never sees half of it;
+        // failures are silent because the directory of the text file may not be writable
+        std::string tmpPath = _cachePath + ".tmp";
+        {
+            std::ofstream f(tmpPath.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!f.is_open())
+            {
+                return false;
+            }
+            f.write(reinterpret_cast<const char*>(&h),sizeof(h));
+            f.write(payload.data(),payload.size());
+            if (!f.good())
+            {
+                f.close();
+                std::remove(tmpPath.c_str());
+                return false;
+            }
+        }
+
+        std::remove(_cachePath.c_str());    // rename() does not overwrite on Windows
+        if (std::rename(tmpPath.c_str(),_cachePath.c_str())!=0)
+        {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+// empty line to make gcc happy
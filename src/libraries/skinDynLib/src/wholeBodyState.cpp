@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * CopyPolicy: Released under the terms of the GNU GPL v2.0.
+ *
+ */
+
+#include <cstring>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/ConnectionReader.h>
+#include <yarp/os/ConnectionWriter.h>
+#include "iCub/skinDynLib/wholeBodyState.h"
+
+using namespace yarp::os;
+using namespace iCub::skinDynLib;
+
+
+//~~~~~~~~~~~~~~~~~~~~~~
+//   WHOLE BODY STATE
+//~~~~~~~~~~~~~~~~~~~~~~
+wholeBodyState::wholeBodyState()
+{
+    clear();
+}
+
+void wholeBodyState::clear()
+{
+    memset(&data,0,sizeof(data));
+    data.version=VERSION;
+}
+
+bool wholeBodyState::write(ConnectionWriter& connection) const
+{
+    // represent the message as a list with a single blob,
+    // whose content is the Data struct
+    connection.appendInt32(BOTTLE_TAG_LIST);
+    connection.appendInt32(1);
+    connection.appendInt32(BOTTLE_TAG_BLOB);
+    connection.appendInt32((int32_t)sizeof(data));
+    // the struct is referenced, not copied, until the message is sent
+    connection.appendExternalBlock(reinterpret_cast<const char*>(&data),sizeof(data));
+
+    return !connection.isError();
+}
+
+bool wholeBodyState::read(ConnectionReader& connection)
+{
+    // a blob has no meaningful text representation
+    if(connection.isTextMode())
+        return false;
+
+    if(connection.expectInt32()!=BOTTLE_TAG_LIST || connection.expectInt32()!=1)
+        return false;
+    if(connection.expectInt32()!=BOTTLE_TAG_BLOB || connection.expectInt32()!=(int32_t)sizeof(data))
+        return false;
+
+    // fill the struct straight from the connection
+    if(!connection.expectBlock(reinterpret_cast<char*>(&data),sizeof(data)))
+        return false;
+
+    return (data.version==VERSION) && !connection.isError();
+}
@@ -31,6 +31,7 @@
 #include <opencv2/core/core_c.h>
 
 #include <mutex>
+#include <future>
 #include <string>
 #include <deque>
 #include <map>
@@ -94,6 +95,7 @@ private:
     mutex                       motMutex;
     mutex                       MILMutex;
     mutex                       trackMutex;
+    mutex                       targetMutex;
 
     unsigned int                minMotionBufSize;
     unsigned int                minTrackBufSize;
@@ -172,6 +174,11 @@ public:
 
     bool getTarget(Value &type, Bottle &target);
 
+    // localizes the target in the background, so that the caller can keep on
+    // doing something else meanwhile; the bottle of the future holds what
+    // getTarget() would have appended to the options
+    shared_future<Bottle> requestTarget(const Value &type);
+
     Bottle recogMSR(string &obj_name);
 
 
@@ -437,6 +437,8 @@ void VisuoThread::threadRelease()
 //get the action target point in the images reference frame
 bool VisuoThread::getTarget(Value &type, Bottle &options)
 {
+    // the requests share the input ports, one at a time
+    lock_guard<mutex> lck(targetMutex);
     bool ok=false;
 
     Bottle &bNewTarget=options.addList();
@@ -539,6 +541,18 @@ bool VisuoThread::getTarget(Value &type, Bottle &options)
 }
 
 
+shared_future<Bottle> VisuoThread::requestTarget(const Value &type)
+{
+    return async(launch::async,[this,type]() -> Bottle
+    {
+        Value _type(type);
+        Bottle options;
+        getTarget(_type,options);
+        return options;
+    }).share();
+}
+
+
 bool VisuoThread::getFixation(Bottle &bStereo)
 {
     Vector stereo(4);
@@ -710,11 +710,17 @@ public:
                         {
                             if(command.size()>2)
                             {
+                                // all the targets are requested beforehand, so that
+                                // the next one gets localized while the current one
+                                // is being converted into cartesian coordinates
+                                deque<shared_future<Bottle> > targets;
                                 for(int target_idx=2; target_idx<command.size(); target_idx++)
+                                    targets.push_back(visuoThr->requestTarget(command.get(target_idx)));
+
+                                for(size_t target_idx=0; target_idx<targets.size(); target_idx++)
                                 {
                                     Vector xd;
-                                    Bottle tmp_command;
-                                    visuoThr->getTarget(command.get(target_idx),tmp_command);
+                                    Bottle tmp_command=targets[target_idx].get();
 
                                     Bottle &tmp_reply=reply.addList();
                                     if(motorThr->targetToCartesian(tmp_command.find("target").asList(),xd))
@@ -1137,11 +1143,15 @@ public:
                     case CMD_DROP:
                     {
                         idle = false;
+                        shared_future<Bottle> target;
                         if(check(command,"over") && command.size()>2)
-                            visuoThr->getTarget(command.get(2),command);
+                            target=visuoThr->requestTarget(command.get(2));
 
                         motorThr->setGazeIdle();
 
+                        if(target.valid())
+                            command.append(target.get());
+
                         motorThr->deploy(command);
                         motorThr->keepFixation(command);
                         motorThr->goUp(command);
@@ -28,6 +28,16 @@ public:
 
     virtual void apply(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in,
                        yarp::sig::ImageOf<yarp::sig::PixelRgb> & out) = 0;    
+
+    /** Apply calibration together with a saturation gain, in a single pass. */
+    virtual void apply(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in,
+                       yarp::sig::ImageOf<yarp::sig::PixelRgb> & out,
+                       const double saturation) = 0;
+
+    /** Start the calibration of in in the background, if the tool can;
+      * the result is retrieved by the next apply() on the same image.
+      */
+    virtual void submit(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in) = 0;
 };
 
 
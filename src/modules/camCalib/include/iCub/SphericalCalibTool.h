@@ -21,6 +21,7 @@
 // iCub
 #include <iCub/ICalibTool.h>
 #include <iCub/spherical_projection.h>
+#include <iCub/RemapKernel.h>
 
 
 /**
@@ -33,6 +34,8 @@ private:
     IplImage        *_mapX;
     IplImage        *_mapY;
 
+    RemapKernel     _kernel;
+
     double          _fx, _fx_scaled;
     double          _fy, _fy_scaled;
     double          _cx, _cx_scaled;
@@ -66,6 +69,12 @@ public:
     // ICalibTool
     void apply(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in,
                yarp::sig::ImageOf<yarp::sig::PixelRgb> & out);    
+    void apply(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in,
+               yarp::sig::ImageOf<yarp::sig::PixelRgb> & out,
+               const double saturation);
+
+    /** Queue the calibration on the GPU, when it is used. */
+    void submit(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in);
 };
 
 
@@ -5,13 +5,11 @@
  */
 
 #include <utility>
-#include <yarp/cv/Cv.h>
 #include <iCub/PinholeCalibTool.h>
 
 using namespace std;
 using namespace yarp::os;
 using namespace yarp::sig;
-using namespace yarp::cv;
 
 PinholeCalibTool::PinholeCalibTool(){
     _mapUndistortX = NULL;
@@ -129,6 +127,16 @@ bool PinholeCalibTool::configure (Searchable &config){
     CV_MAT_ELEM( *_distortion_coeffs, float, 0, 3) = (float)config.check("p2",
                                                         Value(0.0),
                                                         "Tangential distortion 2(double)").asFloat64();
+
+    _kernel.setThreads(config.check("threads",
+                                    Value(1),
+                                    "Number of stripes of rows undistorted in parallel (int)").asInt32());
+
+    bool gpu = config.check("gpu",
+                            Value("off"),
+                            "Undistort on the GPU through OpenCL [on|off] (string)").asString()=="on";
+    if (!_kernel.setGpu(gpu))
+        fprintf(stdout,"OpenCL is not available, the CPU will be used\n");
     _needInit = true;
 
     return true;
@@ -182,12 +190,24 @@ bool PinholeCalibTool::init(CvSize currImgSize, CvSize calibImgSize){
     cv::initUndistortRectifyMap(cv::cvarrToMat(_intrinsic_matrix_scaled), cv::cvarrToMat(_distortion_coeffs), cv::Mat(),
                                 cv::cvarrToMat(_intrinsic_matrix_scaled), cv::Size(currImgSize.width, currImgSize.height),
                                 CV_32FC1,cv::cvarrToMat(_mapUndistortX), cv::cvarrToMat(_mapUndistortY));
+    _kernel.setMaps(cv::cvarrToMat(_mapUndistortX), cv::cvarrToMat(_mapUndistortY));
 
     _needInit = false;
     return true;
 }
 
+void PinholeCalibTool::submit(const ImageOf<PixelRgb> & in){
+    // the maps are rebuilt by apply() when the size changes,
+    // meanwhile the image is just not queued
+    _kernel.submit(in);
+}
+
 void PinholeCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> & out){
+    apply(in, out, 1.0);
+}
+
+void PinholeCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> & out,
+                             const double saturation){
 
     CvSize inSize = cvSize(in.width(),in.height());
 
@@ -197,11 +217,8 @@ void PinholeCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> & o
         _needInit)
         init(inSize,_calibImgSize);
 
-    cv::Mat outMat;
-    cv::remap( toCvMat(const_cast<ImageOf<PixelRgb>&>(in)), outMat,
-               cv::cvarrToMat(_mapUndistortX), cv::cvarrToMat(_mapUndistortY),
-               cv::INTER_LINEAR );
-    out=fromCvMat<PixelRgb>(outMat);
+    // undistort straight into the output buffer
+    _kernel.apply(in, out, saturation);
 
     // painting crosshair at calibration center
     if (_drawCenterCross){
@@ -0,0 +1,176 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * CopyPolicy: Released under the terms of the GNU GPL v2.0.
+ *
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <opencv2/core/ocl.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+#include <yarp/cv/Cv.h>
+#include <iCub/RemapKernel.h>
+
+using namespace yarp::sig;
+using namespace yarp::cv;
+
+// saturation gain in fixed point
+#define SAT_SHIFT   10
+#define SAT_ONE     (1<<SAT_SHIFT)
+
+namespace
+{
+    // the whole computation is carried out in integer arithmetic
+    // on plain loops, so that the compiler can vectorize them: the
+    // mean is divided by 3 through a multiplication and the gain is
+    // applied with a shift
+    void saturateRow(unsigned char *p, const int width, const int gain)
+    {
+        for (int c=0; c<width; c++, p+=3)
+        {
+            int mean=((p[0]+p[1]+p[2])*21846)>>16;
+            for (int i=0; i<3; i++)
+            {
+                int v=mean+((gain*(p[i]-mean))>>SAT_SHIFT);
+                p[i]=(unsigned char)std::min(std::max(v,0),255);
+            }
+        }
+    }
+
+    class RemapBody : public cv::ParallelLoopBody
+    {
+        const cv::Mat *src, &dst, &map1, &map2;
+        int stripes, gain;
+
+    public:
+        // with no source only the saturation is applied
+        RemapBody(const cv::Mat *_src, const cv::Mat &_dst, const cv::Mat &_map1,
+                  const cv::Mat &_map2, const int _stripes, const int _gain) :
+                  src(_src), dst(_dst), map1(_map1), map2(_map2),
+                  stripes(_stripes), gain(_gain) { }
+
+        void operator()(const cv::Range &range) const
+        {
+            for (int s=range.start; s<range.end; s++)
+            {
+                int r0=(s*dst.rows)/stripes;
+                int r1=((s+1)*dst.rows)/stripes;
+
+                // the view wraps the output buffer, hence
+                // remap() writes in place with no allocation
+                cv::Mat stripe=dst.rowRange(r0,r1);
+                if (src!=NULL)
+                    cv::remap(*src,stripe,map1.rowRange(r0,r1),map2.rowRange(r0,r1),
+                              cv::INTER_LINEAR);
+
+                if (gain!=SAT_ONE)
+                    for (int r=0; r<stripe.rows; r++)
+                        saturateRow(stripe.ptr<unsigned char>(r),stripe.cols,gain);
+            }
+        }
+    };
+}
+
+RemapKernel::RemapKernel(){
+    _threads = 1;
+    _gpu = false;
+    _pending = NULL;
+}
+
+void RemapKernel::setMaps(const cv::Mat &mapX, const cv::Mat &mapY){
+    cv::convertMaps(mapX, mapY, _map1, _map2, CV_16SC2, false);
+
+    // the maps are uploaded once
+    if (_gpu){
+        _map1.copyTo(_gpuMap1);
+        _map2.copyTo(_gpuMap2);
+    }
+    _pending = NULL;
+}
+
+void RemapKernel::setThreads(const int threads){
+    _threads = std::max(threads,1);
+}
+
+bool RemapKernel::setGpu(const bool gpu){
+    _gpu = false;
+    _pending = NULL;
+    _gpuMap1.release();
+    _gpuMap2.release();
+
+    if (gpu){
+        if (!cv::ocl::haveOpenCL())
+            return false;
+
+        cv::ocl::setUseOpenCL(true);
+        _gpu = cv::ocl::useOpenCL();
+        if (_gpu && isReady()){
+            _map1.copyTo(_gpuMap1);
+            _map2.copyTo(_gpuMap2);
+        }
+        return _gpu;
+    }
+
+    return true;
+}
+
+void RemapKernel::submit(const ImageOf<PixelRgb> & in){
+    submit(toCvMat(const_cast<ImageOf<PixelRgb>&>(in)));
+}
+
+void RemapKernel::submit(const cv::Mat & in){
+    if (!_gpu || !isReady() || (_map1.size() != in.size()))
+        return;
+
+    // the remap is enqueued on the OpenCL device, which does
+    // not block until the result is downloaded
+    in.copyTo(_gpuSrc);
+    cv::remap(_gpuSrc, _gpuDst, _gpuMap1, _gpuMap2, cv::INTER_LINEAR);
+    _pending = in.data;
+}
+
+void RemapKernel::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> & out,
+                        const double saturation){
+
+    out.resize(in.width(), in.height());
+    cv::Mat dst=toCvMat(out);
+    apply(toCvMat(const_cast<ImageOf<PixelRgb>&>(in)), dst, saturation);
+}
+
+void RemapKernel::apply(const cv::Mat & in, cv::Mat & out, const double saturation){
+
+    if (!isReady() || (_map1.size() != in.size())){
+        in.copyTo(out);
+        return;
+    }
+
+    if (!_gpu){
+        process(&in, out, saturation);
+        return;
+    }
+
+    if (_pending != in.data)
+        submit(in);
+    _pending = NULL;
+
+    // download straight into the output buffer, then
+    // only the saturation is left to the cpu
+    _gpuDst.copyTo(out);
+    process(NULL, out, saturation);
+}
+
+void RemapKernel::process(const cv::Mat *in, cv::Mat & out, const double saturation) const{
+
+    int gain=(int)std::lround(saturation*SAT_ONE);
+    if ((in==NULL) && (gain==SAT_ONE))
+        return;
+
+    int stripes=std::min(_threads, out.rows);
+    RemapBody body(in, out, _map1, _map2, stripes, gain);
+    if (stripes>1)
+        cv::parallel_for_(cv::Range(0,stripes), body, stripes);
+    else
+        body(cv::Range(0,1));
+}
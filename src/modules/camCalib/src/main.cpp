@@ -80,8 +80,15 @@
  * k2 0.180303
  * p1 4.08465e-005
  * p2 0.000456613
+ * threads 1
+ * gpu off
  *
  * </pre>
+ *
+ * The parameter \c threads sets the number of stripes of rows that are
+ * undistorted and saturated in parallel, while \c gpu [on|off] moves the
+ * undistortion onto the GPU through OpenCL, falling back to the CPU when
+ * OpenCL is not available.
  * \section portsc_sec Ports Created
  *
  * Input port 
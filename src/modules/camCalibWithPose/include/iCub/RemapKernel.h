@@ -0,0 +1,90 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * CopyPolicy: Released under the terms of the GNU GPL v2.0.
+ *
+ */
+
+#ifndef __REMAPKERNEL__
+#define __REMAPKERNEL__
+
+// opencv
+#include <opencv2/core/core.hpp>
+
+// yarp
+#include <yarp/sig/Image.h>
+
+
+/**
+ * Undistortion of an rgb image along with the saturation adjustment
+ * in a single pass.\n
+ * The maps are stored in fixed-point format and the image is remapped
+ * straight into the output buffer; each stripe of rows is saturated
+ * right after being remapped, while it is still in cache.\n
+ * Optionally, the remap is carried out on the GPU through OpenCL: the
+ * maps are uploaded once and submit() queues the upload and the remap
+ * of an image, so that the GPU can process it while the caller goes on
+ * (e.g. submitting the other camera); apply() then waits for the result.
+ * Without OpenCL the kernel falls back to the CPU.
+ */
+class RemapKernel
+{
+private:
+
+    cv::Mat _map1;      // fixed-point coordinates (CV_16SC2)
+    cv::Mat _map2;      // interpolation table indexes (CV_16UC1)
+    int     _threads;
+
+    bool        _gpu;
+    cv::UMat    _gpuMap1;
+    cv::UMat    _gpuMap2;
+    cv::UMat    _gpuSrc;
+    cv::UMat    _gpuDst;
+    const void *_pending;
+
+    // remap (if in is given) and saturate stripe by stripe
+    void process(const cv::Mat *in, cv::Mat & out, const double saturation) const;
+
+public:
+
+    RemapKernel();
+
+    /** Convert the floating-point maps into the fixed-point format. */
+    void setMaps(const cv::Mat &mapX, const cv::Mat &mapY);
+
+    /** Set the number of stripes of rows processed in parallel. */
+    void setThreads(const int threads);
+
+    /** Enable the GPU; return false if OpenCL is not available. */
+    bool setGpu(const bool gpu);
+
+    /** Return true if the remap runs on the GPU. */
+    bool isGpu() const { return _gpu; }
+
+    /** Return true once the maps are available. */
+    bool isReady() const { return !_map1.empty(); }
+
+    /** Queue the remap of in on the GPU without waiting for it;
+      * it does nothing when the CPU is used.
+      */
+    void submit(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in);
+    void submit(const cv::Mat & in);
+
+    /** Remap in into out and apply the saturation gain, retrieving
+      * the result of a previous submit() of the same image if any.
+      * The output image is resized to match the input.
+      */
+    void apply(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in,
+               yarp::sig::ImageOf<yarp::sig::PixelRgb> & out,
+               const double saturation=1.0);
+
+    /** Same as above, where in and out can be views of larger images
+      * (e.g. the halves of a stereo frame): out has to be allocated
+      * with the size of in and is written in place.
+      */
+    void apply(const cv::Mat & in, cv::Mat & out, const double saturation=1.0);
+};
+
+
+#endif
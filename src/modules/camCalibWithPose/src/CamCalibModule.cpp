@@ -28,6 +28,7 @@ CamCalibPort::CamCalibPort() :
     cf1(10.514),
     cf2(0.809),
     t0(Time::now()),
+    currSat(1.0),
     useIMU(false),
     useTorso(false),
     useEyes(false),
@@ -102,27 +103,8 @@ void CamCalibPort::onRead(ImageOf<PixelRgb> &yrpImgIn)
         double t1=Time::now();
 
         if (calibTool!=NULL) {
-            calibTool->apply(yrpImgIn,yrpImgOut);
-
-            for (int r =0; r <yrpImgOut.height(); r++) {
-                for (int c=0; c<yrpImgOut.width(); c++) {
-                    unsigned char *pixel = yrpImgOut.getPixelAddress(c,r);
-                    double mean = (1.0/3.0)*(pixel[0]+pixel[1]+pixel[2]);
-
-                    for(int i=0; i<3; i++) {
-                        double s=pixel[i]-mean;
-                        double sn=currSat*s;
-                        sn+=mean;
-
-                        if(sn<0.0)
-                            sn=0.0;
-                        else if(sn>255.0)
-                            sn=255.0;
-
-                        pixel[i]=(unsigned char)sn;
-                    }
-                }
-            }
+            // undistortion and saturation are fused in one pass
+            calibTool->apply(yrpImgIn,yrpImgOut,currSat);
 
             if (verbose)
                 yDebug("calibrated in %g [s]\n",Time::now()-t1);
@@ -7,14 +7,12 @@
  */
 
 #include <utility>
-#include <yarp/cv/Cv.h>
 #include <iCub/SphericalCalibTool.h>
 #include <stdio.h>
 
 using namespace std;
 using namespace yarp::os;
 using namespace yarp::sig;
-using namespace yarp::cv;
 
 SphericalCalibTool::SphericalCalibTool(){
     _mapX = NULL;
@@ -68,6 +66,9 @@ bool SphericalCalibTool::configure (Searchable &config){
     _k2 = config.check("k2", Value(0.0), "Radial distortion (second parameter) (double)").asFloat64();
     _p1 = config.check("p1", Value(0.0), "Tangential distortion (first parameter) (double)").asFloat64();
     _p2 = config.check("p2", Value(0.0), "Tangential distortion (second parameter) (double)").asFloat64();
+    _kernel.setThreads(config.check("threads", Value(1), "Number of stripes of rows projected in parallel (int)").asInt32());
+    if (!_kernel.setGpu(config.check("gpu", Value("off"), "Project on the GPU through OpenCL [on|off] (string)").asString()=="on"))
+        fprintf(stdout,"OpenCL is not available, the CPU will be used\n");
 
     //check to see if the value is read correctly without caring about the default values.
     if ( !config.check("drawCenterCross") ) { stopConfig("drawCenterCross"); return false; }
@@ -133,12 +134,22 @@ bool SphericalCalibTool::init(CvSize currImgSize, CvSize calibImgSize){
                         _k1, _k2, _p1, _p2,
                         (float*)_mapX->imageData, (float*)_mapY->imageData))
         return false;
+    _kernel.setMaps(cv::cvarrToMat(_mapX), cv::cvarrToMat(_mapY));
 
     _needInit = false;
     return true;
 }
 
+void SphericalCalibTool::submit(const ImageOf<PixelRgb> & in){
+    _kernel.submit(in);
+}
+
 void SphericalCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> & out){
+    apply(in, out, 1.0);
+}
+
+void SphericalCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> & out,
+                               const double saturation){
 
     CvSize inSize = cvSize(in.width(),in.height());
 
@@ -148,13 +159,8 @@ void SphericalCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> &
         _needInit)
         init(inSize,_calibImgSize);
 
-    out.resize(inSize.width, inSize.height);
-
-    cv::Mat outMat=toCvMat(out);
-    cv::remap( toCvMat(const_cast<ImageOf<PixelRgb>&>(in)), outMat,
-               cv::cvarrToMat(_mapX), cv::cvarrToMat(_mapY),
-               cv::INTER_LINEAR );
-    out=fromCvMat<PixelRgb>(outMat);
+    // project straight into the output buffer
+    _kernel.apply(in, out, saturation);
 
     // painting crosshair at calibration center
     if (_drawCenterCross){
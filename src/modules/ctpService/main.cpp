@@ -58,6 +58,18 @@ or
 
 [ctpf] filename (in yarpdatadumper format)
 
+or
+
+[ctps] [off] j [traj] ((TIME1 list1) (TIME2 list2) ...)
+
+Stream a block of waypoints. Waypoint k is reached TIMEk seconds after
+waypoint k-1 (or after the command, for the first one of the block); the
+references in between are interpolated linearly and sent in position direct
+mode with the period given by --stream_period. A block received while the
+previous one is still being streamed is appended to it, thus a trajectory
+can be sent in pieces without stopping between them. A [ctpn] command
+erases the waypoints not yet reached.
+
 Example:
 This requires 1 second movement of joints 5,6,7 to 10 10 10 respectively:
 [ctpn] [time] 1 [off] 5 [pos] (10 10 10)
@@ -66,7 +78,7 @@ This requires 1 second movement of joints 5,6,7 to 10 10 10 respectively:
 Run as:
 
 ctpService --robot robotname --part part [--name modulename]
-[--autochange_control_mode_enable]
+[--autochange_control_mode_enable] [--stream_period ms]
 
 robot: name of robot (e.g. icub)
 
@@ -75,7 +87,11 @@ part: prefix for part name (e.g. right_arm)
 name: [optional] module name (used to form port names)
 
 autochange_control_mode_enable: [optional] sets the joints to position mode when
-trying to execute the command (default off)
+trying to execute the command (default off); when streaming, the joints are
+switched to position direct mode and back to position mode at the end
+
+stream_period: [optional] period in ms of the references sent while
+streaming waypoints (default 10)
 
 \section lib_sec Libraries
 - YARP libraries.
@@ -128,6 +144,8 @@ using namespace iCub::ctrl;
 #define VCTP_CMD_FILE   yarp::os::createVocab32('c','t','p','f')
 #define VCTP_POSITION   yarp::os::createVocab32('p','o','s')
 #define VCTP_WAIT       yarp::os::createVocab32('w','a','i','t')
+#define VCTP_CMD_STREAM yarp::os::createVocab32('c','t','p','s')
+#define VCTP_TRAJ       yarp::os::createVocab32('t','r','a','j')
 
 #define VEL_FILT_SIZE   10
 #define VEL_FILT_THRES  1.0
@@ -203,10 +221,29 @@ protected:
     PolyDriver       *drv;
     IControlMode     *mode;
     IPositionControl *pos;
+    IPositionDirect  *dir;
     IEncoders        *enc;
     Actions actions;
     mutex mtx;
 
+    // waypoints being streamed in position direct mode
+    deque<ActionItem> waypoints;
+    std::vector<int>  streamJoints;
+    Vector            streamStart;
+    double            streamT0;
+    bool              streaming;
+
+    void _stopStream()
+    {
+        waypoints.clear();
+        if (streaming && autochange_control_mode_enable)
+        {
+            std::vector<int> modes(streamJoints.size(),VOCAB_CM_POSITION);
+            mode->setControlModes(streamJoints.size(), streamJoints.data(), modes.data());
+        }
+        streaming=false;
+    }
+
     void _send(const ActionItem *x)
     {
         if (!connected)
@@ -293,8 +330,11 @@ public:
     {
         drvOptions.clear();
         drv=0;
+        dir=0;
         verbose=1;
         connected=false;
+        streamT0=0.0;
+        streaming=false;
     }
 
     void send(ActionItem *tmp)
@@ -340,9 +380,114 @@ public:
     {
         lock_guard<mutex> lck(mtx);
         actions.clear();
+        _stopStream();
         _send(item);
     }
 
+    bool stream(const deque<ActionItem> &items)
+    {
+        lock_guard<mutex> lck(mtx);
+        if (!connected || (dir==0) || items.empty())
+        {
+            cerr<<"Error: position direct not available, cannot stream"<<endl;
+            return false;
+        }
+
+        int offset=items.front().getOffset();
+        int size=items.front().getCmd().size();
+        int nJoints=0;
+        enc->getAxes(&nJoints);
+        if ((size==0) || (offset<0) || ((offset+size)>nJoints))
+        {
+            cerr<<"Error: detected possible overflow, skipping"<<endl;
+            return false;
+        }
+
+        for (size_t k=0; k<items.size(); k++)
+        {
+            if ((int)items[k].getCmd().size()!=size)
+            {
+                cerr<<"Error: waypoints of different length, skipping"<<endl;
+                return false;
+            }
+        }
+
+        if (streaming)
+        {
+            // append to the current trajectory
+            if ((offset!=streamJoints.front()) || (size!=(int)streamJoints.size()))
+            {
+                cerr<<"Error: joints differ from the ones being streamed, skipping"<<endl;
+                return false;
+            }
+        }
+        else
+        {
+            Vector q(nJoints);
+            if (!enc->getEncoders(q.data()))
+            {
+                cerr<<"Error: encoders timed out, cannot rely on encoder feedback, aborted"<<endl;
+                return false;
+            }
+
+            streamJoints.clear();
+            for (int i=0; i<size; i++)
+                streamJoints.push_back(offset+i);
+
+            std::vector<int> modes(size,VOCAB_CM_POSITION_DIRECT);
+            if (autochange_control_mode_enable)
+            {
+                mode->setControlModes(size, streamJoints.data(), modes.data());
+                yarp::os::Time::delay(0.01);  // give time to update control modes value
+            }
+
+            mode->getControlModes(size, streamJoints.data(), modes.data());
+            for (int i=0; i<size; i++)
+            {
+                if (modes[i]!=VOCAB_CM_POSITION_DIRECT)
+                {
+                    yError() << "Joint " << offset+i << " not in position direct mode";
+                }
+            }
+
+            streamStart=q.subVector(offset,offset+size-1);
+            streamT0=Time::now();
+            streaming=true;
+        }
+
+        waypoints.insert(waypoints.end(),items.begin(),items.end());
+        return true;
+    }
+
+    // to be called periodically: sends the references of the
+    // whole block of joints being streamed at once
+    void streamStep()
+    {
+        lock_guard<mutex> lck(mtx);
+        if (!streaming)
+            return;
+
+        double t=Time::now()-streamT0;
+        while (!waypoints.empty() && (t>=waypoints.front().getTime()))
+        {
+            t-=waypoints.front().getTime();
+            streamT0+=waypoints.front().getTime();
+            streamStart=waypoints.front().getCmd();
+            waypoints.pop_front();
+        }
+
+        if (waypoints.empty())
+        {
+            dir->setPositions(streamJoints.size(), streamJoints.data(), streamStart.data());
+            _stopStream();
+            return;
+        }
+
+        const Vector &target=waypoints.front().getCmd();
+        Vector ref=streamStart+(t/waypoints.front().getTime())*(target-streamStart);
+        dir->setPositions(streamJoints.size(), streamJoints.data(), ref.data());
+    }
+
     ActionItem *pop()
     {
         lock_guard<mutex> lck(mtx);
@@ -355,9 +500,15 @@ public:
         drv=new PolyDriver(drvOptions);
 
         if (drv->isValid())
+        {
             connected=drv->view(mode) &&
                       drv->view(pos) && 
                       drv->view(enc);
+
+            // optional, needed only for streaming
+            if (!drv->view(dir))
+                dir=0;
+        }
         else
             connected=false;
 
@@ -411,6 +562,31 @@ public:
     }
 };
 
+class StreamingThread: public PeriodicThread
+{
+private:
+    scriptPosPort *posPort;
+public:
+    StreamingThread(int period=10): PeriodicThread((double)period/1000.0), posPort(0)
+    {}
+
+    void attachPosPort(scriptPosPort *p)
+    {
+        if (p)
+            posPort=p;
+    }
+
+    bool threadInit()
+    {
+        return (posPort!=0);
+    }
+
+    void run()
+    {
+        posPort->streamStep();
+    }
+};
+
 class VelocityThread: public Thread
 {
 private:
@@ -711,6 +887,7 @@ protected:
     Port            velPort;
     Port            velInitPort;
     WorkingThread   thread;
+    StreamingThread streamThread;
     VelocityThread  velThread;
 
 public:
@@ -744,6 +921,21 @@ public:
         return ret;
     }
 
+    bool handle_ctp_stream(const Bottle &cmd, Bottle &reply)
+    {
+        deque<ActionItem> items;
+        bool ret=parseStreamCmd(cmd, items) && posPort.stream(items);
+        if (ret)
+        {
+            reply.addVocab32("ack");
+        }
+        else
+        {
+            reply.addVocab32("nack");
+        }
+        return ret;
+    }
+
     bool handle_ctp_file(const Bottle &cmd, Bottle &reply)
     {
         if (cmd.size()<2)
@@ -818,6 +1010,42 @@ public:
         return false;
     }
 
+    bool parseStreamCmd(const Bottle &cmd, deque<ActionItem> &items)
+    {
+        const int expectedMsgSize=5;
+        if (cmd.size()!=expectedMsgSize)
+            return false;
+
+        if ((cmd.get(1).asVocab32()!=VCTP_OFFSET) || (cmd.get(3).asVocab32()!=VCTP_TRAJ))
+            return false;
+
+        int offset=cmd.get(2).asInt32();
+        Bottle *traj=cmd.get(4).asList();
+        if (!traj || (traj->size()==0))
+            return false;
+
+        for (int i=0; i<traj->size(); i++)
+        {
+            Bottle *wp=traj->get(i).asList();
+            if (!wp || (wp->size()<2))
+                return false;
+
+            ActionItem item;
+            item.getOffset()=offset;
+            item.getTime()=wp->get(0).asFloat64();
+            item.getCmd().resize(wp->size()-1);
+            for (int k=1; k<wp->size(); k++)
+                item.getCmd()[k-1]=wp->get(k).asFloat64();
+            items.push_back(item);
+        }
+
+        if (verbose)
+        {
+            cout<<"Received "<<items.size()<<" waypoints, offset: "<<offset<<endl;
+        }
+        return true;
+    }
+
     virtual bool configure(ResourceFinder &rf)
     {
         this->rf=&rf;
@@ -862,6 +1090,14 @@ public:
             //The robot could eventually break something!
             posPort.autochange_control_mode_enable=true;
         }
+
+        streamThread.setPeriod(rf.check("stream_period",Value(10)).asInt32()/1000.0);
+        streamThread.attachPosPort(&posPort);
+        if (!streamThread.start())
+        {
+            cerr<<"Streaming thread did not start, streaming will not work"<<endl;
+        }
+
         velPort.open(name+string("/")+rf.find("part").asString()+"/vc:o");
         velInitPort.open(name+string("/")+rf.find("part").asString()+"/vcInit:o");
         velThread.attachVelPort(&velPort);
@@ -890,6 +1126,8 @@ public:
                     cout<<"[ctpn] [time] seconds [off] j [pos] (list)\n";
                     cout<<"Load sequence from file:\n";
                     cout<<"[ctpf] filename\n";
+                    cout<<"Stream a block of waypoints (appended to the running one):\n";
+                    cout<<"[ctps] [off] j [traj] ((seconds list) ...)\n";
                     reply.addVocab32("ack");
                     return true;
                 }
@@ -908,6 +1146,11 @@ public:
                         ret=handle_ctp_file(command, reply);
                         return ret;
                     }
+                case VCTP_CMD_STREAM:
+                    {
+                        ret=handle_ctp_stream(command, reply);
+                        return ret;
+                    }
                 case VCTP_WAIT:
                     {
                         ret=handle_wait(command, reply);
@@ -929,6 +1172,8 @@ public:
         rpcPort.close();
         thread.stop();
 
+        streamThread.stop();
+
         velThread.stop();
         velPort.interrupt();
         velPort.close();
@@ -959,6 +1204,7 @@ int main(int argc, char *argv[])
         cout << "\t--from   fileName: input configuration file" << endl;
         cout << "\t--context dirName: resource finder context"  << endl;
         cout << "\t--autochange_control_mode_enable: sets the joints to position mode when trying to execute the command (default off)" << endl;
+        cout << "\t--stream_period ms: period of the references sent while streaming waypoints (default 10)" << endl;
 
         return 0;
     }
@@ -51,9 +51,14 @@ private:
     ICalibTool *    calibToolRight;
     double requested_fps;
     double time_lastOut;
-    
-    yarp::sig::ImageOf<yarp::sig::PixelRgb> calibratedImgLeft;
-    yarp::sig::ImageOf<yarp::sig::PixelRgb> calibratedImgRight;
+
+    // syncTol: if non negative, the two separated ports are read in pairs whose
+    // timestamps differ at most by syncTol seconds, otherwise they are read as they come.
+    double syncTol;
+    yarp::os::Stamp leftStamp;
+    yarp::os::Stamp rightStamp;
+
+    bool readSyncPair();
 
 
 public:
@@ -9,6 +9,9 @@
 #ifndef __UZH_ICALIBTOOL__
 #define __UZH_ICALIBTOOL__
 
+// opencv
+#include <opencv2/core/core.hpp>
+
 // yarp
 #include <yarp/sig/Image.h>
 #include <yarp/os/IConfig.h>
@@ -28,6 +31,22 @@ public:
 
     virtual void apply(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in,
                        yarp::sig::ImageOf<yarp::sig::PixelRgb> & out) = 0;    
+
+    /** Apply calibration together with a saturation gain, in a single pass. */
+    virtual void apply(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in,
+                       yarp::sig::ImageOf<yarp::sig::PixelRgb> & out,
+                       const double saturation) = 0;
+
+    /** Start the calibration of in in the background, if the tool can;
+      * the result is retrieved by the next apply() on the same image.
+      */
+    virtual void submit(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in) = 0;
+
+    /** Apply calibration on views, e.g. the halves of a stereo frame, so
+      * that no intermediate copy is made; out has the size of in.
+      */
+    virtual void apply(const cv::Mat & in, cv::Mat & out, const double saturation) = 0;
+    virtual void submit(const cv::Mat & in) = 0;
 };
 
 
@@ -29,6 +29,7 @@
 
 // iCub
 #include <iCub/ICalibTool.h>
+#include <iCub/RemapKernel.h>
 
 
 /**
@@ -47,6 +48,8 @@ class PinholeCalibTool : public ICalibTool
     IplImage        *_mapUndistortX;
     IplImage        *_mapUndistortY;
 
+    RemapKernel     _kernel;
+
     bool _needInit;
 
     CvSize          _calibImgSize;
@@ -88,6 +91,10 @@ public:
       k2 0.2467\n
       p1 -0.00195\n
       p2 0.00185\n
+
+      Optionally, "threads" gives the number of stripes of rows that are
+      undistorted in parallel (default 1), while "gpu" [on|off] selects
+      the OpenCL remap, with the CPU as fallback (default off).\n
     */ 
     virtual bool configure (yarp::os::Searchable &config);
 
@@ -100,6 +107,18 @@ public:
     */
     void apply(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in,
                yarp::sig::ImageOf<yarp::sig::PixelRgb> & out);    
+
+    /** Apply calibration and saturation in a single pass. */
+    void apply(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in,
+               yarp::sig::ImageOf<yarp::sig::PixelRgb> & out,
+               const double saturation);
+
+    /** Queue the calibration on the GPU, when it is used. */
+    void submit(const yarp::sig::ImageOf<yarp::sig::PixelRgb> & in);
+
+    /** Apply calibration on views, writing out in place. */
+    void apply(const cv::Mat & in, cv::Mat & out, const double saturation);
+    void submit(const cv::Mat & in);
     
 };
 
@@ -4,12 +4,18 @@
 // Author: Marco Randazzo <marco.randazzo@iit.it>
 // CopyPolicy: Released under the terms of the GNU GPL v2.0.
 
+#include <cmath>
+#include <yarp/cv/Cv.h>
 #include <iCub/DualCamCalibModule.h>
 #include <yarp/os/Network.h>
 
+// maximum number of frames dropped while looking for a synchronized pair
+#define DUALCAMCALIB_SYNC_MAX_READS  10
+
 using namespace std;
 using namespace yarp::os;
 using namespace yarp::sig;
+using namespace yarp::cv;
 
 CamCalibModule::CamCalibModule()
 {
@@ -19,6 +25,9 @@ CamCalibModule::CamCalibModule()
     requested_fps=0;
     time_lastOut=yarp::os::Time::now();
     dualImage_mode = false;
+    syncTol = -1.0;
+    leftImage = NULL;
+    rightImage = NULL;
 }
 
 CamCalibModule::~CamCalibModule()
@@ -111,9 +120,6 @@ bool CamCalibModule::configure(yarp::os::ResourceFinder &rf)
 
     if(dualImage_mode)
     {
-        leftImage  = new yarp::sig::ImageOf<yarp::sig::PixelRgb>;
-        rightImage = new yarp::sig::ImageOf<yarp::sig::PixelRgb>;
-
         // open a single port with name /dual:i
         if (yarp::os::Network::exists(getName("/dual:i")))
         {
@@ -137,6 +143,12 @@ bool CamCalibModule::configure(yarp::os::ResourceFinder &rf)
         imageInRight.open(getName("/right:i"));
         imageInLeft.setStrict(false);
         imageInRight.setStrict(false);
+
+        if (rf.check("sync"))
+        {
+            syncTol = rf.find("sync").asFloat64();
+            yInfo() << "Left and right images will be paired within" << syncTol << "[s]";
+        }
     }
 
     if (yarp::os::Network::exists(getName("/out")))
@@ -186,139 +198,142 @@ bool CamCalibModule::interruptModule()
     return true;
 }
 
+bool CamCalibModule::readSyncPair()
+{
+    leftImage  = imageInLeft.read();
+    rightImage = imageInRight.read();
+    if (leftImage==NULL || rightImage==NULL)
+        return false;
+
+    imageInLeft.getEnvelope(leftStamp);
+    imageInRight.getEnvelope(rightStamp);
+
+    // the older frame is dropped until the other one is caught up
+    for (int i=0; i<DUALCAMCALIB_SYNC_MAX_READS; i++)
+    {
+        double dt = leftStamp.getTime()-rightStamp.getTime();
+        if (fabs(dt)<=syncTol)
+            return true;
+
+        if (dt<0.0)
+        {
+            if ((leftImage = imageInLeft.read()) == NULL)
+                return false;
+            imageInLeft.getEnvelope(leftStamp);
+        }
+        else
+        {
+            if ((rightImage = imageInRight.read()) == NULL)
+                return false;
+            imageInRight.getEnvelope(rightStamp);
+        }
+    }
+
+    yWarning() << "Unable to pair left and right images within" << syncTol << "[s]";
+    return false;
+}
+
 bool CamCalibModule::updateModule()
 {
     bool lready=false;
     bool rready=false;
-    bool init=false;
-
-    int dual_rowsize_pixels, dual_height_pixels, single_rowsize_pixels;
-    int dual_rowsize_bytes,  single_rowsize_bytes;
 
-    int outw = 0;
-    int outh = 0;
-
-    unsigned char *left_raw, *right_raw, *dual_raw;
+    // the left and right frames are views that are calibrated straight
+    // into the two halves of the output, which is the only copy made
+    cv::Mat inLeft, inRight;
+    yarp::os::Stamp stamp;
 
     if(dualImage_mode)
     {
-        // read the dual image and split it up into 2 separated images for calibration
+        // the dual image is split up as views on its two halves
         yarp::sig::ImageOf<yarp::sig::PixelRgb>* dual = imageInLeft.read();
         if(dual == NULL)
         {
             yarp::os::Time::delay(0.001);
             return true;
         }
+        imageInLeft.getEnvelope(stamp);
 
-        dual_rowsize_pixels = dual->width();
-        single_rowsize_pixels = dual_rowsize_pixels/2;
-        dual_height_pixels = dual->height();
-
-        dual_rowsize_bytes = dual->getRowSize();
-        single_rowsize_bytes = dual_rowsize_bytes/2;
-
-        leftImage->resize(dual_rowsize_pixels/2, dual_height_pixels);
-        rightImage->resize(dual_rowsize_pixels/2, dual_height_pixels);
-
-        leftImage->setQuantum(dual->getQuantum());
-        rightImage->setQuantum(dual->getQuantum());
-
-        left_raw  = leftImage->getRawImage();
-        right_raw = rightImage->getRawImage();
-        dual_raw  = dual->getRawImage();
+        cv::Mat dualMat = toCvMat(*dual);
+        int single_rowsize_pixels = dualMat.cols/2;
+        inLeft  = dualMat.colRange(0, single_rowsize_pixels);
+        inRight = dualMat.colRange(single_rowsize_pixels, 2*single_rowsize_pixels);
+    }
+    else
+    {
+        if (syncTol>=0.0)
+        {
+            if (!readSyncPair())
+                return true;
+        }
+        else
+        {
+            leftImage  = imageInLeft.read(false);
+            rightImage = imageInRight.read(false);
+            if (leftImage!=NULL)
+                imageInLeft.getEnvelope(leftStamp);
+            if (rightImage!=NULL)
+                imageInRight.getEnvelope(rightStamp);
+        }
 
-        for(int h=0; h<dual_height_pixels; h++)
+        if (leftImage!=NULL)
+        {
+            inLeft = toCvMat(*leftImage);
+            stamp = leftStamp;
+        }
+        if (rightImage!=NULL)
         {
-            memcpy(left_raw+(h*single_rowsize_bytes),  dual_raw+(h*dual_rowsize_bytes),                         single_rowsize_bytes);
-            memcpy(right_raw+(h*single_rowsize_bytes), dual_raw+(h*dual_rowsize_bytes) + single_rowsize_bytes,  single_rowsize_bytes);
+            inRight = toCvMat(*rightImage);
+            if (leftImage==NULL)
+                stamp = rightStamp;
         }
     }
-    else
+
+    if (inLeft.empty() && inRight.empty())
     {
-        leftImage  = imageInLeft.read(false);
-        rightImage = imageInRight.read(false);
+        yarp::os::Time::delay(0.001);
+        return true;
     }
 
-    yarp::sig::ImageOf<yarp::sig::PixelRgb> &calibratedImgOut=imageOut.prepare();
+    int w = inLeft.empty() ? inRight.cols : inLeft.cols;
+    int h = inLeft.empty() ? inRight.rows : inLeft.rows;
 
-    if (calibToolLeft!=NULL && leftImage!=NULL)
-    {
-        calibToolLeft->apply(*leftImage,calibratedImgLeft);
-        lready=true;
-
-        if (init==false)
-        {
-            if (align == ALIGN_WIDTH)
-            {
-                outw = calibratedImgLeft.width()*2;
-                outh = calibratedImgLeft.height();
-            }
-            else if (align==ALIGN_HEIGHT)
-            {
-                outw = calibratedImgLeft.width();
-                outh = calibratedImgLeft.height()*2;
-            }
-            else
-            {
-                yError() << "Invalid alignment";
-            }
-            calibratedImgOut.copy(calibratedImgLeft,outw,outh);
-            init=true;
-        }
+    yarp::sig::ImageOf<yarp::sig::PixelRgb> &calibratedImgOut=imageOut.prepare();
+    if (align == ALIGN_WIDTH)
+        calibratedImgOut.resize(2*w, h);
+    else
+        calibratedImgOut.resize(w, 2*h);
 
-        calibratedImgOut.resize(outw, outh);
-        for (int r=0; r<calibratedImgLeft.height(); r++)
-        for (int c=0; c<calibratedImgLeft.width(); c++)
-        {
-            unsigned char *pixel = calibratedImgOut.getPixelAddress(c,r);
+    cv::Mat outMat = toCvMat(calibratedImgOut);
+    cv::Mat outLeft  = (align == ALIGN_WIDTH) ? outMat.colRange(0, w) : outMat.rowRange(0, h);
+    cv::Mat outRight = (align == ALIGN_WIDTH) ? outMat.colRange(w, 2*w) : outMat.rowRange(h, 2*h);
 
-            pixel[0] = *(calibratedImgLeft.getPixelAddress(c,r)+0);
-            pixel[1] = *(calibratedImgLeft.getPixelAddress(c,r)+1);
-            pixel[2] = *(calibratedImgLeft.getPixelAddress(c,r)+2);
-        }
+    // with the GPU, the right image is uploaded and rectified
+    // while the left one is being retrieved
+    if (calibToolLeft!=NULL && !inLeft.empty())
+        calibToolLeft->submit(inLeft);
+    if (calibToolRight!=NULL && !inRight.empty())
+        calibToolRight->submit(inRight);
 
+    if (!inLeft.empty() && (inLeft.size() == outLeft.size()))
+    {
+        if (calibToolLeft!=NULL)
+            calibToolLeft->apply(inLeft, outLeft, 1.0);
+        else
+            inLeft.copyTo(outLeft);
+        lready=true;
     }
-    if (calibToolRight!=NULL && rightImage!=NULL)
+    if (!inRight.empty() && (inRight.size() == outRight.size()))
     {
-        calibToolRight->apply(*rightImage,calibratedImgRight);
+        if (calibToolRight!=NULL)
+            calibToolRight->apply(inRight, outRight, 1.0);
+        else
+            inRight.copyTo(outRight);
         rready=true;
-
-        if (init==false)
-        {
-            int outw = 0;
-            int outh = 0;
-            if (align == ALIGN_WIDTH)
-            {
-                outw = calibratedImgLeft.width()*2;
-                outh = calibratedImgLeft.height();
-            }
-            else if (align==ALIGN_HEIGHT)
-            {
-                outw = calibratedImgLeft.width();
-                outh = calibratedImgLeft.height()*2;
-            }
-            else
-            {
-                yError() << "Invalid alignment";
-            }
-            calibratedImgOut.copy(calibratedImgRight,outw,outh);
-            init=true;
-        }
-
-        for (int r=0; r<calibratedImgLeft.height(); r++)
-        for (int c=0; c<calibratedImgLeft.width(); c++)
-        {
-            int cp = 0;
-            int rp = 0;
-            if      (align == ALIGN_WIDTH)  {cp = c+calibratedImgLeft.width();  rp = r;}
-            else if (align == ALIGN_HEIGHT) {cp = c; rp = r+calibratedImgLeft.height();}
-            unsigned char *pixel = calibratedImgOut.getPixelAddress(cp,rp);
-            pixel[0] = *(calibratedImgRight.getPixelAddress(c,r)+0);
-            pixel[1] = *(calibratedImgRight.getPixelAddress(c,r)+1);
-            pixel[2] = *(calibratedImgRight.getPixelAddress(c,r)+2);
-        }
     }
 
+    imageOut.setEnvelope(stamp);
+
     if (requested_fps==0)
     {
         if (lready==true || rready==true)
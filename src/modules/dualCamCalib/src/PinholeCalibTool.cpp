@@ -5,6 +5,7 @@
  */
 
 #include <utility>
+#include <opencv2/imgproc/imgproc.hpp>
 #include <yarp/cv/Cv.h>
 #include <iCub/PinholeCalibTool.h>
 
@@ -129,6 +130,16 @@ bool PinholeCalibTool::configure (Searchable &config){
     CV_MAT_ELEM( *_distortion_coeffs, float, 0, 3) = (float)config.check("p2",
                                                         Value(0.0),
                                                         "Tangential distortion 2(double)").asFloat64();
+
+    _kernel.setThreads(config.check("threads",
+                                    Value(1),
+                                    "Number of stripes of rows undistorted in parallel (int)").asInt32());
+
+    bool gpu = config.check("gpu",
+                            Value("off"),
+                            "Undistort on the GPU through OpenCL [on|off] (string)").asString()=="on";
+    if (!_kernel.setGpu(gpu))
+        fprintf(stdout,"OpenCL is not available, the CPU will be used\n");
     _needInit = true;
 
     return true;
@@ -182,13 +193,36 @@ bool PinholeCalibTool::init(CvSize currImgSize, CvSize calibImgSize){
     cv::initUndistortRectifyMap(cv::cvarrToMat(_intrinsic_matrix_scaled), cv::cvarrToMat(_distortion_coeffs), cv::Mat(),
                                 cv::cvarrToMat(_intrinsic_matrix_scaled), cv::Size(currImgSize.width, currImgSize.height),
                                 CV_32FC1,cv::cvarrToMat(_mapUndistortX), cv::cvarrToMat(_mapUndistortY));
+    _kernel.setMaps(cv::cvarrToMat(_mapUndistortX), cv::cvarrToMat(_mapUndistortY));
     _needInit = false;
     return true;
 }
 
+void PinholeCalibTool::submit(const ImageOf<PixelRgb> & in){
+    submit(toCvMat(const_cast<ImageOf<PixelRgb>&>(in)));
+}
+
+void PinholeCalibTool::submit(const cv::Mat & in){
+    // the maps are rebuilt by apply() when the size changes,
+    // meanwhile the image is just not queued
+    _kernel.submit(in);
+}
+
 void PinholeCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> & out){
+    apply(in, out, 1.0);
+}
+
+void PinholeCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> & out,
+                             const double saturation){
+
+    out.resize(in.width(), in.height());
+    cv::Mat outMat=toCvMat(out);
+    apply(toCvMat(const_cast<ImageOf<PixelRgb>&>(in)), outMat, saturation);
+}
+
+void PinholeCalibTool::apply(const cv::Mat & in, cv::Mat & out, const double saturation){
 
-    CvSize inSize = cvSize(in.width(),in.height());
+    CvSize inSize = cvSize(in.cols,in.rows);
 
     // check if reallocation required
     if ( inSize.width  != _oldImgSize.width || 
@@ -196,22 +230,18 @@ void PinholeCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> & o
         _needInit)
         init(inSize,_calibImgSize);
 
-    cv::Mat outMat;
-    cv::remap( toCvMat(const_cast<ImageOf<PixelRgb>&>(in)), outMat,
-             cv::cvarrToMat(_mapUndistortX), cv::cvarrToMat(_mapUndistortY),
-             cv::INTER_LINEAR );
-    out=fromCvMat<PixelRgb>(outMat);
+    // remap straight into the output buffer
+    _kernel.apply(in, out, saturation);
 
     // painting crosshair at calibration center
     if (_drawCenterCross){
-        yarp::sig::PixelRgb pix = yarp::sig::PixelRgb(255,255,255);
-        yarp::sig::draw::addCrossHair(out, pix, (int)CV_MAT_ELEM( *_intrinsic_matrix_scaled , float, 0, 2),
-                                            (int)CV_MAT_ELEM( *_intrinsic_matrix_scaled , float, 1, 2),
-                                            10);
+        int x = (int)CV_MAT_ELEM( *_intrinsic_matrix_scaled , float, 0, 2);
+        int y = (int)CV_MAT_ELEM( *_intrinsic_matrix_scaled , float, 1, 2);
+        cv::line(out, cv::Point(x-10,y), cv::Point(x+10,y), cv::Scalar(255,255,255));
+        cv::line(out, cv::Point(x,y-10), cv::Point(x,y+10), cv::Scalar(255,255,255));
     }
 
     // buffering old image size
     _oldImgSize.width  = inSize.width;
     _oldImgSize.height = inSize.height;
 }
-
@@ -7,6 +7,7 @@
  */
 
 #include <utility>
+#include <opencv2/imgproc/imgproc.hpp>
 #include <yarp/cv/Cv.h>
 #include <iCub/SphericalCalibTool.h>
 #include <stdio.h>
@@ -68,6 +69,9 @@ bool SphericalCalibTool::configure (Searchable &config){
     _k2 = config.check("k2", Value(0.0), "Radial distortion (second parameter) (double)").asFloat64();
     _p1 = config.check("p1", Value(0.0), "Tangential distortion (first parameter) (double)").asFloat64();
     _p2 = config.check("p2", Value(0.0), "Tangential distortion (second parameter) (double)").asFloat64();
+    _kernel.setThreads(config.check("threads", Value(1), "Number of stripes of rows projected in parallel (int)").asInt32());
+    if (!_kernel.setGpu(config.check("gpu", Value("off"), "Project on the GPU through OpenCL [on|off] (string)").asString()=="on"))
+        fprintf(stdout,"OpenCL is not available, the CPU will be used\n");
 
     //check to see if the value is read correctly without caring about the default values.
     if ( !config.check("drawCenterCross") ) { stopConfig("drawCenterCross"); return false; }
@@ -133,14 +137,37 @@ bool SphericalCalibTool::init(CvSize currImgSize, CvSize calibImgSize){
                         _k1, _k2, _p1, _p2, 
                         (float*)_mapX->imageData, (float*)_mapY->imageData))
         return false;
+    _kernel.setMaps(cv::cvarrToMat(_mapX), cv::cvarrToMat(_mapY));
 
     _needInit = false;
     return true;
 }
 
+void SphericalCalibTool::submit(const ImageOf<PixelRgb> & in){
+    submit(toCvMat(const_cast<ImageOf<PixelRgb>&>(in)));
+}
+
+void SphericalCalibTool::submit(const cv::Mat & in){
+    // the maps are rebuilt by apply() when the size changes,
+    // meanwhile the image is just not queued
+    _kernel.submit(in);
+}
+
 void SphericalCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> & out){
+    apply(in, out, 1.0);
+}
+
+void SphericalCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> & out,
+                               const double saturation){
 
-    CvSize inSize = cvSize(in.width(),in.height());
+    out.resize(in.width(), in.height());
+    cv::Mat outMat=toCvMat(out);
+    apply(toCvMat(const_cast<ImageOf<PixelRgb>&>(in)), outMat, saturation);
+}
+
+void SphericalCalibTool::apply(const cv::Mat & in, cv::Mat & out, const double saturation){
+
+    CvSize inSize = cvSize(in.cols,in.rows);
 
     // check if reallocation required
     if ( inSize.width  != _oldImgSize.width || 
@@ -148,18 +175,15 @@ void SphericalCalibTool::apply(const ImageOf<PixelRgb> & in, ImageOf<PixelRgb> &
         _needInit)
         init(inSize,_calibImgSize);
 
-    out.resize(inSize.width, inSize.height);
-
-    cv::Mat outMat=toCvMat(out);
-    cv::remap( toCvMat(const_cast<ImageOf<PixelRgb>&>(in)), outMat,
-               cv::cvarrToMat(_mapX), cv::cvarrToMat(_mapY),
-               cv::INTER_LINEAR );
-    out=fromCvMat<PixelRgb>(outMat);
+    // remap straight into the output buffer
+    _kernel.apply(in, out, saturation);
 
     // painting crosshair at calibration center
     if (_drawCenterCross){
-        yarp::sig::PixelRgb pix = yarp::sig::PixelRgb(255,255,255);
-        yarp::sig::draw::addCrossHair(out, pix, (int)_cx_scaled, (int)_cy_scaled, 10);
+        int x = (int)_cx_scaled;
+        int y = (int)_cy_scaled;
+        cv::line(out, cv::Point(x-10,y), cv::Point(x+10,y), cv::Scalar(255,255,255));
+        cv::line(out, cv::Point(x,y-10), cv::Point(x,y+10), cv::Scalar(255,255,255));
     }
 
     // buffering old image size
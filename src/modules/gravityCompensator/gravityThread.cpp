@@ -233,6 +233,8 @@ gravityCompensatorThread::gravityCompensatorThread(string _wholeBodyName, int _r
     iTqs_leg_right        = nullptr;
     isCalibrated = false;
     inertial_enabled=_inertial_enabled;
+    fast_gravity = false;
+    fast_gravity_thres = 0.0;
     icub = new iCubWholeBody (icub_type,DYNAMIC, VERBOSE);
     thread_status=STATUS_DISCONNECTED;
     port_inertial        = nullptr;
@@ -253,6 +255,33 @@ gravityCompensatorThread::gravityCompensatorThread(string _wholeBodyName, int _r
     torso_gravity_torques     = nullptr;
 
 }
+
+void gravityCompensatorThread::setFastGravity(bool enable, double thres)
+{
+    fast_gravity = enable;
+    fast_gravity_thres = thres;
+    input_LA.valid = input_RA.valid = input_LL.valid = input_RL.valid = input_TO.valid = false;
+}
+
+bool gravityInput::changed(const Vector &_q, const Vector &_ddp, const double thres)
+{
+    if (valid && (_q.length()==q.length()))
+    {
+        // joints in [deg], base orientation through the small-angle
+        // displacement of the gravity vector
+        bool moved = (norm(_ddp-ddp) > CTRL_DEG2RAD*thres*norm(ddp));
+        for (size_t i=0; (i<q.length()) && !moved; i++)
+            moved = (fabs(_q[i]-q[i]) > thres);
+
+        if (!moved)
+            return false;
+    }
+
+    q = _q;
+    ddp = _ddp;
+    valid = true;
+    return true;
+}
     
 void gravityCompensatorThread::setZeroJntAngVelAcc()
 {
@@ -649,6 +678,86 @@ void gravityCompensatorThread::feedFwdGravityControl(int part_ctrlJnt, const str
     }
 }
 
+void gravityCompensatorThread::computeGravityTorques()
+{
+    Vector F_up(6,0.0);
+    icub->upperTorso->setInertialMeasure(w0,dw0,d2p0);
+    icub->upperTorso->solveKinematics();
+    icub->upperTorso->solveWrench();
+
+    //compute the arm torques
+    Matrix F_sens_up = icub->upperTorso->estimateSensorsWrench(F_ext_up,false);
+    gravity_torques_LA = icub->upperTorso->left->getTorques();
+    gravity_torques_RA = icub->upperTorso->right->getTorques();
+
+    //compute the torso torques
+    icub->attachLowerTorso(F_up,F_up);
+    icub->lowerTorso->solveKinematics();
+    icub->lowerTorso->solveWrench();
+    Vector tmp; tmp.resize(3);
+    tmp = icub->lowerTorso->getTorques("torso");
+    gravity_torques_TO[0] = tmp [2];
+    gravity_torques_TO[1] = tmp [1];
+    gravity_torques_TO[2] = tmp [0];
+
+    //compute the leg torques
+    Matrix F_sens_low = icub->lowerTorso->estimateSensorsWrench(F_ext_low,false);
+    gravity_torques_LL = icub->lowerTorso->getTorques("left_leg");
+    gravity_torques_RL = icub->lowerTorso->getTorques("right_leg");
+}
+
+void gravityCompensatorThread::computeGravityTorquesFast()
+{
+    // gravity-only recursion: with null velocities only the direction of
+    // gravity matters, hence the inertial acceleration is just rotated
+    // down to the base of each limb and the torques come from the
+    // composite masses of the limb links. The upper body weighs on the
+    // torso as a point mass placed in its COM.
+    iDynSensorTorsoNode *upper = icub->upperTorso;
+    iDynSensorTorsoNode *lower = icub->lowerTorso;
+
+    Vector ddp_up = upper->getHUp().submatrix(0,2,0,2) * (upper->up->getH().submatrix(0,2,0,2) * d2p0);
+
+    Vector ddp_la = upper->getHLeft().submatrix(0,2,0,2).transposed() * ddp_up;
+    if (input_LA.changed(q_larm,ddp_la,fast_gravity_thres))
+        gravity_torques_LA = upper->left->computeGravityTorques(ddp_la);
+
+    Vector ddp_ra = upper->getHRight().submatrix(0,2,0,2).transposed() * ddp_up;
+    if (input_RA.changed(q_rarm,ddp_ra,fast_gravity_thres))
+        gravity_torques_RA = upper->right->computeGravityTorques(ddp_ra);
+
+    // the torso end-effector is the upper torso node
+    Vector ddp_to = lower->up->getH().submatrix(0,2,0,2) * ddp_up;
+    if (input_TO.changed(cat(q_torso,all_q_up),ddp_to,fast_gravity_thres))
+    {
+        iDynLimb *limbs[3] = { upper->up, upper->left, upper->right };
+        Matrix H[3] = { upper->getHUp(), upper->getHLeft(), upper->getHRight() };
+        double m_up = 0.0;
+        Vector s_up(3,0.0), s;
+        for (int k=0; k<3; k++)
+        {
+            double m = limbs[k]->computeFirstMomentOfMass(s);
+            s_up += H[k].submatrix(0,2,0,2)*s + m*H[k].subcol(0,3,3);
+            m_up += m;
+        }
+
+        Vector tmp = lower->up->computeGravityTorques(ddp_to,m_up,s_up);
+        gravity_torques_TO[0] = tmp [2];
+        gravity_torques_TO[1] = tmp [1];
+        gravity_torques_TO[2] = tmp [0];
+    }
+
+    Vector ddp_low = lower->getHUp().submatrix(0,2,0,2) * ddp_to;
+
+    Vector ddp_ll = lower->getHLeft().submatrix(0,2,0,2).transposed() * ddp_low;
+    if (input_LL.changed(q_lleg,ddp_ll,fast_gravity_thres))
+        gravity_torques_LL = lower->left->computeGravityTorques(ddp_ll);
+
+    Vector ddp_rl = lower->getHRight().submatrix(0,2,0,2).transposed() * ddp_low;
+    if (input_RL.changed(q_rleg,ddp_rl,fast_gravity_thres))
+        gravity_torques_RL = lower->right->computeGravityTorques(ddp_rl);
+}
+
 void gravityCompensatorThread::run()
 {  
     thread_status = STATUS_OK;
@@ -670,31 +779,11 @@ void gravityCompensatorThread::run()
             delay_check = 0;
         }
 
-        Vector F_up(6,0.0);
-        icub->upperTorso->setInertialMeasure(w0,dw0,d2p0);
-        icub->upperTorso->solveKinematics();
-        icub->upperTorso->solveWrench();
-
-        //compute the arm torques
-        Matrix F_sens_up = icub->upperTorso->estimateSensorsWrench(F_ext_up,false);
-        gravity_torques_LA = icub->upperTorso->left->getTorques();
-        gravity_torques_RA = icub->upperTorso->right->getTorques();
-
-        //compute the torso torques
-        icub->attachLowerTorso(F_up,F_up);
-        icub->lowerTorso->solveKinematics();
-        icub->lowerTorso->solveWrench();
-        Vector tmp; tmp.resize(3);
-        tmp = icub->lowerTorso->getTorques("torso");
-        gravity_torques_TO[0] = tmp [2];
-        gravity_torques_TO[1] = tmp [1];
-        gravity_torques_TO[2] = tmp [0];
+        if (fast_gravity)
+            computeGravityTorquesFast();
+        else
+            computeGravityTorques();
 
-        //compute the leg torques
-        Matrix F_sens_low = icub->lowerTorso->estimateSensorsWrench(F_ext_low,false);
-        gravity_torques_LL = icub->lowerTorso->getTorques("left_leg");
-        gravity_torques_RL = icub->lowerTorso->getTorques("right_leg");  
-        
 //#define DEBUG_TORQUES
 #ifdef  DEBUG_TORQUES
     yDebug ("TORQUES:     %s ***  \n\n", torques_TO.toString().c_str());
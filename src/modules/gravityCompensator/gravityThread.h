@@ -42,6 +42,17 @@ enum thread_status_enum {STATUS_OK=0, STATUS_DISCONNECTED};
 enum{GRAVITY_COMPENSATION_OFF = 0, GRAVITY_COMPENSATION_ON = 1};
 enum{EXTERNAL_TRQ_OFF = 0, EXTERNAL_TRQ_ON = 1};
 
+// inputs of the last gravity torques computed for a limb, used to
+// skip the computation while the limb and its base stand still
+struct gravityInput
+{
+    Vector q;
+    Vector ddp;
+    bool   valid=false;
+
+    bool changed(const Vector &_q, const Vector &_ddp, const double thres);
+};
+
 class gravityCompensatorThread: public yarp::os::PeriodicThread
 {
 private:
@@ -150,6 +161,9 @@ private:
     Vector ampli_LA, ampli_RA, ampli_LL, ampli_RL, ampli_TO;
     bool isCalibrated;
     bool inertial_enabled;
+    bool fast_gravity;
+    double fast_gravity_thres;
+    gravityInput input_LA, input_RA, input_LL, input_RL, input_TO;
     
     Vector evalVelUp(const Vector &x);
     Vector evalVelLow(const Vector &x);
@@ -160,6 +174,8 @@ private:
     void init_lower();
     void setLowerMeasure();
     void setUpperMeasure();
+    void computeGravityTorques();
+    void computeGravityTorquesFast();
 
 public:
     
@@ -168,6 +184,7 @@ public:
 
     gravityCompensatorThread(std::string _wholeBodyName, int _rate, PolyDriver *_ddLA, PolyDriver *_ddRA, PolyDriver *_ddH, PolyDriver *_ddLL, PolyDriver *_ddRL, PolyDriver *_ddT, version_tag icub_type, bool _inertial_enabled);
 
+    void setFastGravity(bool enable, double thres);
     void setZeroJntAngVelAcc();
     bool readAndUpdate(bool waitMeasure=false);
     bool getLowerEncodersSpeedAndAcceleration();
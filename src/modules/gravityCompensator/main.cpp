@@ -34,6 +34,17 @@ http://wiki.icub.org/wiki/Force_Control
 --no_legs
 - This option disables the gravity compensation for the legs joints.
 
+--fast_gravity
+- This option computes the gravity torques through a dedicated
+  gravity-only recursion (no velocity terms) instead of solving the
+  full dynamics of the body; the torques of a limb are recomputed only
+  when its joints or the orientation of its base moved beyond a
+  threshold since the last computation.
+
+--fast_gravity_threshold \e t
+- The threshold \e t [deg] used with the \e fast_gravity option. If
+  not specified \e 0.1 deg is assumed.
+
 \section portsa_sec Ports Accessed
 The port the service is listening to.
 
@@ -367,10 +378,22 @@ public:
             yInfo("'no_inertial' option found. Disabling inertial measurment.\n");
         }
 
+        //------------------CHECK FOR FAST GRAVITY -----------//
+        bool fast_gravity=false;
+        double fast_gravity_thres=0.1;
+        if (rf.check("fast_gravity"))
+        {
+            fast_gravity=true;
+            if (rf.check("fast_gravity_threshold"))
+                fast_gravity_thres=rf.find("fast_gravity_threshold").asFloat64();
+            yInfo("'fast_gravity' option found. Using the gravity-only recursion (threshold %g deg).\n",fast_gravity_thres);
+        }
+
         //--------------------------THREAD--------------------------
 
         g_comp = new gravityCompensatorThread(wholeBodyName, rate, dd_left_arm, dd_right_arm, dd_head, dd_left_leg, dd_right_leg, dd_torso, icub_type, inertial_enabled);
         yInfo("ft thread istantiated...\n");
+        g_comp->setFastGravity(fast_gravity,fast_gravity_thres);
         g_comp->start();
         yInfo("thread started\n");
 
@@ -542,6 +565,8 @@ int main(int argc, char * argv[])
         yInfo() << "--no_head          disables the head";
         yInfo() << "--wholebody_name   the wholeBodyDyanmics port prefix (e.g. 'wholeBodyDynamics' / 'wholeBodyDynamicsTree')";
         yInfo() << "--no_inertial      disables the inertial";
+        yInfo() << "--fast_gravity     uses the gravity-only recursion, skipping the limbs standing still";
+        yInfo() << "--fast_gravity_threshold t  the threshold [deg] of the fast_gravity option (default 0.1)";
         yInfo() << "--gravity_on       enables gravity compensation (default)";
         yInfo() << "--gravity_off      disables gravity compensation";
         yInfo() << "--external_on      enables external torque command (default)";
@@ -0,0 +1,370 @@
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+#include <cmath>
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+#include <yarp/math/Math.h>
+
+#include "controller.h"
+
+#define BIMANUAL_SOLVER_TOL         1e-4
+#define BIMANUAL_SOLVER_CONSTR_TOL  1e-6
+#define BIMANUAL_SOLVER_MAXITER     200
+#define BIMANUAL_WEIGHT_3RD_TASK    0.01
+#define BIMANUAL_INTARGET_TOL       (0.1*CTRL_DEG2RAD)
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace yarp::sig;
+using namespace yarp::math;
+using namespace iCub::ctrl;
+using namespace iCub::iKin;
+
+// parts indexes
+enum { TORSO=0, LEFT=1, RIGHT=2 };
+
+
+/************************************************************************/
+BimanualController::BimanualController(PolyDriver *drvTorso, PolyDriver *drvLeft,
+                                       PolyDriver *drvRight, BufferedPort<Bottle> *_portXd,
+                                       BufferedPort<Bottle> *_portX, const string &_armVersion,
+                                       const double period) :
+                                       PeriodicThread(period), portXd(_portXd), portX(_portX),
+                                       armVersion(_armVersion)
+{
+    drv[TORSO]=drvTorso;
+    drv[LEFT]=drvLeft;
+    drv[RIGHT]=drvRight;
+
+    armL=armR=nullptr;
+    slv=nullptr;
+    gen=nullptr;
+
+    trajTime=2.0;
+    solverTime=0.05;
+    weight3rdTask=BIMANUAL_WEIGHT_3RD_TASK;
+    newTarget=false;
+    ctrlActive=false;
+}
+
+
+/************************************************************************/
+bool BimanualController::threadInit()
+{
+    for (int i=0; i<3; i++)
+    {
+        if (!drv[i]->view(enc[i]) || !drv[i]->view(mod[i]) ||
+            !drv[i]->view(pos[i]) || !drv[i]->view(lim[i]))
+        {
+            yError("Unable to retrieve the motor interfaces!");
+            return false;
+        }
+
+        enc[i]->getAxes(&nAxes[i]);
+    }
+
+    if ((nAxes[TORSO]<BIMANUAL_TORSO_JOINTS) || (nAxes[LEFT]<BIMANUAL_ARM_JOINTS) ||
+        (nAxes[RIGHT]<BIMANUAL_ARM_JOINTS))
+    {
+        yError("Unexpected number of joints!");
+        return false;
+    }
+
+    armL=new iCubArm("left_v"+armVersion);
+    armR=new iCubArm("right_v"+armVersion);
+
+    // the torso is controlled too
+    for (unsigned int i=0; i<BIMANUAL_TORSO_JOINTS; i++)
+    {
+        armL->releaseLink(i);
+        armR->releaseLink(i);
+    }
+
+    deque<IControlLimits*> limL,limR;
+    limL.push_back(lim[TORSO]); limL.push_back(lim[LEFT]);
+    limR.push_back(lim[TORSO]); limR.push_back(lim[RIGHT]);
+    if (!armL->alignJointsBounds(limL) || !armR->alignJointsBounds(limR))
+    {
+        yError("Unable to retrieve joints limits!");
+        return false;
+    }
+
+    slv=new iKinBimanualIpOptMin(*armL->asChain(),*armR->asChain(),BIMANUAL_TORSO_JOINTS,
+                                 BIMANUAL_SOLVER_TOL,BIMANUAL_SOLVER_CONSTR_TOL,
+                                 BIMANUAL_SOLVER_MAXITER);
+    slv->setMaxCpuTime(solverTime);
+
+    unsigned int dim=slv->getDOF();
+    q.resize(dim,0.0);
+    qd.resize(dim,0.0);
+
+    // keep the torso close to the rest posture
+    qRest.resize(dim,0.0);
+    wRest.resize(dim,0.0);
+    for (unsigned int i=0; i<BIMANUAL_TORSO_JOINTS; i++)
+        wRest[i]=1.0;
+
+    if (!getFeedback())
+    {
+        yError("Unable to read the encoders!");
+        return false;
+    }
+
+    qd=q;
+    gen=new minJerkTrajGen(q,getPeriod(),trajTime);
+
+    return true;
+}
+
+
+/************************************************************************/
+bool BimanualController::getFeedback()
+{
+    Vector fb[3];
+    for (int i=0; i<3; i++)
+    {
+        fb[i].resize(nAxes[i]);
+        if (!enc[i]->getEncoders(fb[i].data()))
+            return false;
+    }
+
+    // the torso joints are in reversed order within the arm chains
+    for (int i=0; i<BIMANUAL_TORSO_JOINTS; i++)
+        q[i]=CTRL_DEG2RAD*fb[TORSO][BIMANUAL_TORSO_JOINTS-1-i];
+
+    for (int i=0; i<BIMANUAL_ARM_JOINTS; i++)
+    {
+        q[BIMANUAL_TORSO_JOINTS+i]=CTRL_DEG2RAD*fb[LEFT][i];
+        q[BIMANUAL_TORSO_JOINTS+BIMANUAL_ARM_JOINTS+i]=CTRL_DEG2RAD*fb[RIGHT][i];
+    }
+
+    return true;
+}
+
+
+/************************************************************************/
+bool BimanualController::parseTarget(const Bottle &b, Vector &_xdL, Vector &_xdR)
+{
+    // format: (<left pose>) (<right pose>), where each pose
+    // is given either as position or as position+axis-angle
+    if (b.size()<2)
+        return false;
+
+    Bottle *bL=b.get(0).asList();
+    Bottle *bR=b.get(1).asList();
+    if ((bL==nullptr) || (bR==nullptr))
+        return false;
+
+    Vector *x[2]={&_xdL,&_xdR};
+    Bottle *bx[2]={bL,bR};
+    for (int j=0; j<2; j++)
+    {
+        int len=bx[j]->size();
+        if ((len!=3) && (len!=7))
+            return false;
+
+        x[j]->resize(len);
+        for (int i=0; i<len; i++)
+            (*x[j])[i]=bx[j]->get(i).asFloat64();
+    }
+
+    return true;
+}
+
+
+/************************************************************************/
+void BimanualController::setDirectMode()
+{
+    for (int i=0; i<3; i++)
+    {
+        int n=(i==TORSO)?BIMANUAL_TORSO_JOINTS:BIMANUAL_ARM_JOINTS;
+        vector<int> joints(n),modes(n,VOCAB_CM_POSITION_DIRECT);
+        for (int j=0; j<n; j++)
+            joints[j]=j;
+
+        mod[i]->setControlModes(n,joints.data(),modes.data());
+    }
+}
+
+
+/************************************************************************/
+void BimanualController::sendReferences(const Vector &qref)
+{
+    Vector refs[3];
+    refs[TORSO].resize(BIMANUAL_TORSO_JOINTS);
+    refs[LEFT].resize(BIMANUAL_ARM_JOINTS);
+    refs[RIGHT].resize(BIMANUAL_ARM_JOINTS);
+
+    for (int i=0; i<BIMANUAL_TORSO_JOINTS; i++)
+        refs[TORSO][BIMANUAL_TORSO_JOINTS-1-i]=CTRL_RAD2DEG*qref[i];
+
+    for (int i=0; i<BIMANUAL_ARM_JOINTS; i++)
+    {
+        refs[LEFT][i]=CTRL_RAD2DEG*qref[BIMANUAL_TORSO_JOINTS+i];
+        refs[RIGHT][i]=CTRL_RAD2DEG*qref[BIMANUAL_TORSO_JOINTS+BIMANUAL_ARM_JOINTS+i];
+    }
+
+    // all the parts are commanded within the same cycle
+    for (int i=0; i<3; i++)
+    {
+        int n=(int)refs[i].length();
+        vector<int> joints(n);
+        for (int j=0; j<n; j++)
+            joints[j]=j;
+
+        pos[i]->setPositions(n,joints.data(),refs[i].data());
+    }
+}
+
+
+/************************************************************************/
+bool BimanualController::goTo(const Bottle &target)
+{
+    lock_guard<mutex> lck(mtx);
+    if (parseTarget(target,xdL,xdR))
+    {
+        newTarget=true;
+        return true;
+    }
+    else
+        return false;
+}
+
+
+/************************************************************************/
+void BimanualController::stopControl()
+{
+    lock_guard<mutex> lck(mtx);
+    newTarget=false;
+    ctrlActive=false;
+}
+
+
+/************************************************************************/
+bool BimanualController::isMotionDone()
+{
+    lock_guard<mutex> lck(mtx);
+    return !ctrlActive && !newTarget;
+}
+
+
+/************************************************************************/
+void BimanualController::setTrajTime(const double t)
+{
+    lock_guard<mutex> lck(mtx);
+    trajTime=std::max(t,getPeriod());
+    if (gen!=nullptr)
+        gen->setT(trajTime);
+}
+
+
+/************************************************************************/
+double BimanualController::getTrajTime()
+{
+    lock_guard<mutex> lck(mtx);
+    return trajTime;
+}
+
+
+/************************************************************************/
+void BimanualController::getPoses(Vector &xL, Vector &xR)
+{
+    lock_guard<mutex> lck(mtx);
+
+    Vector qL(BIMANUAL_TORSO_JOINTS+BIMANUAL_ARM_JOINTS);
+    Vector qR(BIMANUAL_TORSO_JOINTS+BIMANUAL_ARM_JOINTS);
+    for (size_t i=0; i<qL.length(); i++)
+    {
+        qL[i]=q[i];
+        qR[i]=q[(i<BIMANUAL_TORSO_JOINTS)?i:(i+BIMANUAL_ARM_JOINTS)];
+    }
+
+    xL=armL->EndEffPose(qL);
+    xR=armR->EndEffPose(qR);
+}
+
+
+/************************************************************************/
+void BimanualController::getSolution(Vector &_qd)
+{
+    lock_guard<mutex> lck(mtx);
+    _qd=CTRL_RAD2DEG*qd;
+}
+
+
+/************************************************************************/
+void BimanualController::run()
+{
+    {
+        lock_guard<mutex> lck(mtx);
+        if (!getFeedback())
+            return;
+
+        Bottle *target=portXd->read(false);
+        if ((target!=nullptr) && parseTarget(*target,xdL,xdR))
+            newTarget=true;
+
+        if (newTarget)
+        {
+            // a new target is solved starting from the current reference,
+            // so that the trajectory gets updated smoothly
+            newTarget=false;
+            qd=slv->solve(ctrlActive?gen->getPos():q,xdL,xdR,weight3rdTask,qRest,wRest);
+
+            if (!ctrlActive)
+            {
+                gen->init(q);
+                setDirectMode();
+                ctrlActive=true;
+            }
+        }
+
+        if (ctrlActive)
+        {
+            gen->computeNextValues(qd);
+            sendReferences(gen->getPos());
+
+            if (norm(qd-gen->getPos())<BIMANUAL_INTARGET_TOL)
+                ctrlActive=false;
+        }
+    }
+
+    if (portX->getOutputCount()>0)
+    {
+        Vector xL,xR;
+        getPoses(xL,xR);
+
+        Bottle &b=portX->prepare();
+        b.clear();
+        b.addList().read(xL);
+        b.addList().read(xR);
+        portX->write();
+    }
+}
+
+
+/************************************************************************/
+void BimanualController::threadRelease()
+{
+    delete slv;
+    delete gen;
+    delete armL;
+    delete armR;
+}
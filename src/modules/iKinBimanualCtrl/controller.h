@@ -0,0 +1,94 @@
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+#ifndef __BIMANUALCONTROLLER_H__
+#define __BIMANUALCONTROLLER_H__
+
+#include <mutex>
+#include <string>
+
+#include <yarp/os/all.h>
+#include <yarp/sig/all.h>
+#include <yarp/dev/all.h>
+
+#include <iCub/ctrl/math.h>
+#include <iCub/ctrl/minJerkCtrl.h>
+#include <iCub/iKin/iKinFwd.h>
+#include <iCub/iKin/iKinIpOpt.h>
+
+#define BIMANUAL_TORSO_JOINTS   3
+#define BIMANUAL_ARM_JOINTS     7
+
+
+// The thread which solves the inverse kinematics of both arms
+// and the torso as one problem and commands all the joints
+// within the same control cycle.
+class BimanualController : public yarp::os::PeriodicThread
+{
+protected:
+    yarp::dev::PolyDriver      *drv[3];
+    yarp::dev::IEncoders       *enc[3];
+    yarp::dev::IControlMode    *mod[3];
+    yarp::dev::IPositionDirect *pos[3];
+    yarp::dev::IControlLimits  *lim[3];
+    int nAxes[3];
+
+    iCub::iKin::iCubArm              *armL;
+    iCub::iKin::iCubArm              *armR;
+    iCub::iKin::iKinBimanualIpOptMin *slv;
+    iCub::ctrl::minJerkTrajGen       *gen;
+
+    yarp::os::BufferedPort<yarp::os::Bottle> *portXd;
+    yarp::os::BufferedPort<yarp::os::Bottle> *portX;
+    std::mutex mtx;
+
+    std::string armVersion;
+    double trajTime;
+    double solverTime;
+    double weight3rdTask;
+    bool   newTarget;
+    bool   ctrlActive;
+
+    yarp::sig::Vector xdL, xdR;
+    yarp::sig::Vector q, qd, qRest, wRest;
+
+    bool getFeedback();
+    bool parseTarget(const yarp::os::Bottle &b, yarp::sig::Vector &_xdL,
+                     yarp::sig::Vector &_xdR);
+    void setDirectMode();
+    void sendReferences(const yarp::sig::Vector &qref);
+
+public:
+    BimanualController(yarp::dev::PolyDriver *drvTorso, yarp::dev::PolyDriver *drvLeft,
+                       yarp::dev::PolyDriver *drvRight,
+                       yarp::os::BufferedPort<yarp::os::Bottle> *_portXd,
+                       yarp::os::BufferedPort<yarp::os::Bottle> *_portX,
+                       const std::string &_armVersion, const double period);
+
+    bool   goTo(const yarp::os::Bottle &target);
+    void   stopControl();
+    bool   isMotionDone();
+    void   setTrajTime(const double t);
+    double getTrajTime();
+    void   getPoses(yarp::sig::Vector &xL, yarp::sig::Vector &xR);
+    void   getSolution(yarp::sig::Vector &_qd);
+    bool   threadInit() override;
+    void   run() override;
+    void   threadRelease() override;
+};
+
+
+#endif
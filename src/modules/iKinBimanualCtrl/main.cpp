@@ -0,0 +1,287 @@
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+/**
+@ingroup icub_module
+
+\defgroup iKinBimanualCtrl iKinBimanualCtrl
+
+Controller of the two arms along with the torso, which reaches
+for a pair of targets as one problem.
+
+CopyPolicy: Released under the terms of the GNU GPL v2.0.
+
+\section intro_sec Description
+Running one \ref icub_cartesian_interface "Cartesian Interface"
+per arm entails that both solvers and controllers make use of
+the torso joints, contending them for bimanual tasks. This
+module owns the torso and both arms instead: the inverse
+kinematics is solved as one problem through the \ref iKinIpOpt
+"iKinBimanualIpOptMin" class, where the torso serves both hands
+at once, and then a single control thread drives all the joints
+along minimum-jerk trajectories in position direct mode, sending
+the references to the three parts within the same cycle.
+
+The positions of the targets are attained as constraints, while
+the orientations, if given, are minimized along with the
+distance of the torso from its rest posture.
+
+\section lib_sec Libraries
+- YARP libraries.
+- \ref ctrlLib "ctrlLib" library.
+- \ref iKin "iKin" library (it requires IPOPT).
+
+\section parameters_sec Parameters
+--robot \e name
+- select the robot to connect to; by default "icub".
+
+--name \e name
+- select the stem-name of the module used to open up ports; by
+  default "iKinBimanualCtrl".
+
+--arm_version \e ver
+- select the kinematics version of the arms; by default "1.0".
+
+--period \e T
+- the period in [ms] of the control thread; by default 10 ms.
+
+--T \e time
+- the trajectory execution time in [s]; by default 2.0 s.
+
+\section portsa_sec Ports Accessed
+The ports of the robot parts torso, left_arm and right_arm.
+
+\section portsc_sec Ports Created
+- \e /<name>/xd:i receives the targets in streaming, in the
+  format (<left pose>) (<right pose>), where each pose is given
+  either as the position (x y z) in meters or as the position
+  along with the orientation in axis-angle representation (x y z
+  ax ay az theta), with theta in radians, both wrt the root
+  reference frame.
+
+- \e /<name>/x:o streams out the current poses of the two hands
+  in the format (<left pose>) (<right pose>).
+
+- \e /<name>/rpc remote procedure call. \n
+    Recognized remote commands:
+    - [go] (<left pose>) (<right pose>): reaches for the targets.
+    - [stop]: stops the motion.
+    - [done]: returns 1 if the motion is over, 0 otherwise.
+    - [set] [T] <time>: sets the trajectory execution time.
+    - [get] [T]: returns the trajectory execution time.
+    - [get] [x]: returns the current poses of the two hands.
+    - [get] [qd]: returns the last solution in degrees, arranged
+      as the torso (pitch roll yaw), the left arm and the right
+      arm joints.
+
+\section tested_os_sec Tested OS
+Linux.
+*/
+
+#include <string>
+
+#include <yarp/os/all.h>
+#include <yarp/dev/all.h>
+#include <yarp/sig/all.h>
+
+#include "controller.h"
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace yarp::sig;
+
+
+/************************************************************************/
+class BimanualModule : public RFModule
+{
+protected:
+    PolyDriver drvTorso, drvLeft, drvRight;
+    BufferedPort<Bottle> portXd, portX;
+    RpcServer portRpc;
+    BimanualController *ctrl;
+
+    /************************************************************************/
+    bool openPart(PolyDriver &drv, const string &robot, const string &name,
+                  const string &part)
+    {
+        Property option("(device remote_controlboard)");
+        option.put("remote","/"+robot+"/"+part);
+        option.put("local","/"+name+"/"+part);
+        if (!drv.open(option))
+        {
+            yError("Unable to connect to %s!",part.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+public:
+    /************************************************************************/
+    BimanualModule() : ctrl(nullptr) { }
+
+    /************************************************************************/
+    bool configure(ResourceFinder &rf) override
+    {
+        string robot=rf.check("robot",Value("icub")).asString();
+        string name=rf.check("name",Value("iKinBimanualCtrl")).asString();
+        string armVersion=rf.check("arm_version",Value("1.0")).asString();
+        int period=rf.check("period",Value(10)).asInt32();
+        double T=rf.check("T",Value(2.0)).asFloat64();
+
+        if (!openPart(drvTorso,robot,name,"torso") ||
+            !openPart(drvLeft,robot,name,"left_arm") ||
+            !openPart(drvRight,robot,name,"right_arm"))
+        {
+            close();
+            return false;
+        }
+
+        portXd.open("/"+name+"/xd:i");
+        portX.open("/"+name+"/x:o");
+
+        ctrl=new BimanualController(&drvTorso,&drvLeft,&drvRight,&portXd,&portX,
+                                    armVersion,(double)period/1000.0);
+        ctrl->setTrajTime(T);
+        if (!ctrl->start())
+        {
+            delete ctrl;
+            ctrl=nullptr;
+            close();
+            return false;
+        }
+
+        portRpc.open("/"+name+"/rpc");
+        attach(portRpc);
+
+        return true;
+    }
+
+    /************************************************************************/
+    bool respond(const Bottle &command, Bottle &reply) override
+    {
+        string cmd=command.get(0).asString();
+        if ((cmd=="go") && (command.size()>=3))
+        {
+            if (ctrl->goTo(command.tail()))
+                reply.addVocab32("ack");
+            else
+                reply.addVocab32("nack");
+        }
+        else if (cmd=="stop")
+        {
+            ctrl->stopControl();
+            reply.addVocab32("ack");
+        }
+        else if (cmd=="done")
+        {
+            reply.addVocab32("ack");
+            reply.addInt32(ctrl->isMotionDone()?1:0);
+        }
+        else if ((cmd=="set") && (command.size()>=3) && (command.get(1).asString()=="T"))
+        {
+            ctrl->setTrajTime(command.get(2).asFloat64());
+            reply.addVocab32("ack");
+        }
+        else if ((cmd=="get") && (command.size()>=2))
+        {
+            string opt=command.get(1).asString();
+            if (opt=="T")
+            {
+                reply.addVocab32("ack");
+                reply.addFloat64(ctrl->getTrajTime());
+            }
+            else if (opt=="x")
+            {
+                Vector xL,xR;
+                ctrl->getPoses(xL,xR);
+                reply.addVocab32("ack");
+                reply.addList().read(xL);
+                reply.addList().read(xR);
+            }
+            else if (opt=="qd")
+            {
+                Vector qd;
+                ctrl->getSolution(qd);
+                reply.addVocab32("ack");
+                reply.addList().read(qd);
+            }
+            else
+                reply.addVocab32("nack");
+        }
+        else
+            return RFModule::respond(command,reply);
+
+        return true;
+    }
+
+    /************************************************************************/
+    bool close() override
+    {
+        if (ctrl!=nullptr)
+        {
+            ctrl->stopControl();
+            ctrl->stop();
+            delete ctrl;
+            ctrl=nullptr;
+        }
+
+        portRpc.close();
+        portXd.close();
+        portX.close();
+
+        if (drvTorso.isValid())
+            drvTorso.close();
+        if (drvLeft.isValid())
+            drvLeft.close();
+        if (drvRight.isValid())
+            drvRight.close();
+
+        return true;
+    }
+
+    /************************************************************************/
+    double getPeriod() override
+    {
+        return 1.0;
+    }
+
+    /************************************************************************/
+    bool updateModule() override
+    {
+        return true;
+    }
+};
+
+
+/************************************************************************/
+int main(int argc, char *argv[])
+{
+    Network yarp;
+    if (!yarp.checkNetwork())
+    {
+        yError("YARP server not available!");
+        return 1;
+    }
+
+    ResourceFinder rf;
+    rf.setDefaultContext("iKinBimanualCtrl");
+    rf.configure(argc,argv);
+
+    BimanualModule mod;
+    return mod.runModule(rf);
+}
@@ -24,6 +24,7 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <deque>
 
 #include <yarp/os/all.h>
 #include <yarp/sig/all.h>
@@ -32,12 +33,25 @@
 
 #include <iCub/ctrl/minJerkCtrl.h>
 #include <iCub/ctrl/pids.h>
+#include <iCub/ctrl/telemetry.h>
+#include <iCub/iKin/iKinHlp.h>
 #include <iCub/utils.h>
 
 constexpr int32_t GAZECTRL_SWOFFCOND_DISABLESLOT   = 10;      // [-]
 constexpr double  GAZECTRL_MOTIONDONE_NECK_QTHRES  = 0.500;   // [deg]
 constexpr double  GAZECTRL_MOTIONDONE_EYES_QTHRES  = 0.100;   // [deg]
 constexpr double  GAZECTRL_CRITICVER_STABILIZATION = 4.0;     // [deg]
+constexpr double  GAZECTRL_DEFAULT_POSE_HISTORY    = 1.0;     // [s]
+
+// fields of the state streamed out to the clients
+// (to be kept aligned with the gazecontrollerclient)
+constexpr int GAZECTRL_STATE_X           = 0;
+constexpr int GAZECTRL_STATE_Q           = 1;
+constexpr int GAZECTRL_STATE_QDES        = 2;
+constexpr int GAZECTRL_STATE_QDOT        = 3;
+constexpr int GAZECTRL_STATE_MOTIONDONE  = 4;
+constexpr int GAZECTRL_STATE_SACCADEDONE = 5;
+constexpr int GAZECTRL_STATE_NUM         = 6;
 
 using namespace std;
 using namespace yarp::os;
@@ -71,14 +85,21 @@ protected:
 
     BufferedPort<Vector> port_x;
     BufferedPort<Vector> port_q;
+    BufferedPort<Vector> port_state;
     BufferedPort<Bottle> port_event;
     BufferedPort<Bottle> port_debug;
     Stamp txInfo_x;
     Stamp txInfo_q;
+    Stamp txInfo_state;
     Stamp txInfo_pose;
     Stamp txInfo_event;
     Stamp txInfo_debug;
 
+    CycleTelemetry telemetry;
+    int tmSectionFk;
+    int tmSectionCtrl;
+    int tmSectionIO;
+
     mutex mutexRun;
     mutex mutexChain;
     mutex mutexCtrl;
@@ -113,6 +134,10 @@ protected:
     vector<int> neckJoints,eyesJoints;
     vector<int> jointsToSet;
 
+    // joints feedback (torso and head) of the last cycles,
+    // used to compute the poses at past time instants
+    deque<pair<double,Vector>> poseHistory;
+
     multiset<double> motionOngoingEvents;
     multiset<double> motionOngoingEventsCurrent;
 
@@ -126,6 +151,7 @@ protected:
     void   motionOngoingEventsHandling();
     void   motionOngoingEventsFlush();
     void   stopControlHelper();
+    void   setPoseChainAng(iKinChain *chain, const Vector &torso, const Vector &head);
 
 public:
     Controller(PolyDriver *_drvTorso, PolyDriver *_drvHead, ExchangeData *_commData,
@@ -158,9 +184,12 @@ public:
     bool   getDesired(Vector &des);
     bool   getVelocity(Vector &vel);
     bool   getPose(const string &poseSel, Vector &x, Stamp &stamp);
+    bool   getPose(const string &poseSel, const double t, Vector &x, Stamp &stamp);
     bool   registerMotionOngoingEvent(const double checkPoint);
     bool   unregisterMotionOngoingEvent(const double checkPoint);
     Bottle listMotionOngoingEvents();
+    void   getTelemetry(Bottle &info);
+    void   resetTelemetry();
 };
 
 
@@ -36,6 +36,17 @@ using namespace iCub::ctrl;
 using namespace iCub::iKin;
 
 
+// Outcome of the last solve
+struct GazeSolveInfo
+{
+    double time;        // wall-clock time to solution [s]
+    int    iter;        // number of iterations
+    bool   converged;   // IPOPT reached the tolerances
+    bool   deadline;    // the solve was cut by the deadline
+    bool   feasible;    // the returned solution is feasible
+};
+
+
 // Solve through IPOPT the nonlinear problem 
 class GazeIpOptMin : public iKinIpOptMin
 {
@@ -44,16 +55,33 @@ private:
     GazeIpOptMin(const GazeIpOptMin&);
     GazeIpOptMin &operator=(const GazeIpOptMin&);
 
+protected:
+    double constrTol;
+    double deadline;
+    bool   warmStartOk;
+    Vector warm_x;
+    Vector warm_zL;
+    Vector warm_zU;
+    Vector warm_lambda;
+    GazeSolveInfo info;
+
 public:
     GazeIpOptMin(iKinChain &_chain, const double tol, const double constr_tol,
                  const int max_iter=IKINCTRL_DISABLED,
-                 const unsigned int verbose=0) :
-                 iKinIpOptMin(_chain,IKINCTRL_POSE_XYZ,tol,constr_tol,
-                              max_iter,verbose,false) { }
+                 const unsigned int verbose=0);
 
     void   set_ctrlPose(const unsigned int _ctrlPose) { }
     bool   set_posePriority(const string &priority)   { return false; }
     void   setHessianOpt(const bool useHessian)       { }   // Hessian not implemented
+
+    // A positive deadline [s] enables the real-time mode: each solve
+    // is warm-started from the previous solution (multipliers included)
+    // and is cut when the deadline expires, returning the best feasible
+    // iterate found so far.
+    void   setDeadline(const double _deadline);
+    double getDeadline() const { return deadline; }
+    void   resetWarmStart()    { warmStartOk=false; }
+    const GazeSolveInfo &getSolveInfo() const { return info; }
     Vector solve(const Vector &q0, Vector &xd, const Vector &gDir);
 };
 
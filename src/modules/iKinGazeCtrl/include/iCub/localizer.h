@@ -72,6 +72,7 @@ protected:
     void handleStereoInput();
     void handleAnglesInput();
     void handleAnglesOutput();
+    Vector getEyeJoints(const Vector &torso, const Vector &head, const bool isLeft);
 
 public:
     Localizer(ExchangeData *_commData, const unsigned int _period);
@@ -86,6 +87,9 @@ public:
     bool   projectPoint(const string &type, const double u, const double v,
                         const Vector &plane, Vector &x);
     bool   triangulatePoint(const Vector &pxl, const Vector &pxr, Vector &x);
+    bool   projectPoints(const string &type, const Matrix &x, Matrix &px);
+    bool   projectPoints(const string &type, const Matrix &px, const Vector &z, Matrix &x);
+    bool   triangulatePoints(const Matrix &pxl, const Matrix &pxr, Matrix &x);
     Vector getAbsAngles(const Vector &x);
     Vector get3DPoint(const string &type, const Vector &ang);
     bool   getIntrinsicsMatrix(const string &type, Matrix &M, int &w, int &h);
@@ -130,6 +130,20 @@ protected:
     Controller         *ctrl;    
     mutex               mtx;
 
+    CycleTelemetry telemetry;
+    int tmSectionIpOpt;
+    int tmSectionFk;
+    int tmSectionIO;
+
+    // statistics of the neck solves
+    unsigned long slvCnt;
+    unsigned long slvConverged;
+    unsigned long slvDeadlineHits;
+    unsigned long slvInfeasible;
+    unsigned long slvIterSum;
+    double        slvTimeSum;
+    double        slvTimeMax;
+
     unsigned int period;
     int nJointsTorso;
     int nJointsHead;
@@ -151,6 +165,7 @@ protected:
     double neckYawMax;
 
     void   updateAngles();
+    void   resetSolveStats();
     Vector computeTargetUserTolerance(const Vector &xd);
 
 public:
@@ -178,6 +193,8 @@ public:
     void   run() override;
     void   suspend();
     void   resume();
+    void   getTelemetry(Bottle &info);
+    void   resetTelemetry();
 };
 
 
@@ -20,6 +20,7 @@
 #define __UTILS_H__
 
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
 #include <string>
 #include <algorithm>
@@ -33,6 +34,8 @@
 
 #include <iCub/gazeNlp.h>
 
+#define SNAPSHOT_CAPACITY   32
+
 using namespace std;
 using namespace yarp::os;
 using namespace yarp::dev;
@@ -89,17 +92,60 @@ public:
 };
 
 
+// Identifiers of the fields shared through ExchangeData.
+constexpr int32_t EXCHANGE_XD       = 0;
+constexpr int32_t EXCHANGE_QD       = 1;
+constexpr int32_t EXCHANGE_X        = 2;
+constexpr int32_t EXCHANGE_Q        = 3;
+constexpr int32_t EXCHANGE_TORSO    = 4;
+constexpr int32_t EXCHANGE_V        = 5;
+constexpr int32_t EXCHANGE_COUNTERV = 6;
+constexpr int32_t EXCHANGE_FPFRAME  = 7;
+constexpr int32_t EXCHANGE_NUM      = 8;
+
+
+// This class holds a snapshot of a vector or a matrix
+// protected by a sequence lock: readers never block and
+// retry their copy whenever it overlaps with an update,
+// while writers are only serialized among themselves.
+// Each update bumps a version and records a timestamp,
+// so that readers can skip data that did not change.
+// Data larger than SNAPSHOT_CAPACITY are rejected.
+class Snapshot
+{
+protected:
+    mutex mtx_write;
+    atomic<unsigned long> seq;
+    atomic<int>    rows;
+    atomic<int>    cols;
+    atomic<double> stamp;
+    atomic<double> data[SNAPSHOT_CAPACITY];
+
+    void beginWrite();
+    void endWrite();
+    bool store(const double *val, const int r, const int c, const double _stamp);
+    void storeLocked(const double *val, const int r, const int c, const double _stamp);
+
+public:
+    Snapshot();
+
+    bool          set(const Vector &v, const double _stamp);
+    bool          set(const Matrix &M, const double _stamp);
+    void          set(const int i, const double val, const double _stamp);
+    bool          resize(const int sz, const double val, const double _stamp);
+    Vector        getVector(double *_stamp=nullptr) const;
+    Matrix        getMatrix(double *_stamp=nullptr) const;
+    double        getStamp() const   { return stamp.load(memory_order_acquire); }
+    unsigned long getVersion() const { return seq.load(memory_order_acquire)>>1; }
+};
+
+
 // This class handles the data exchange among components.
 class ExchangeData
 {
 protected:
-    mutex  mtx[8];
-    Vector xd,qd;
-    Vector x,q,torso;
-    Vector v,counterv;
-    Matrix S;
-    Vector imu;
-    double x_stamp;
+    Snapshot data[EXCHANGE_NUM];
+    Vector   imu;
 
 public:
     ExchangeData();
@@ -128,6 +174,11 @@ public:
     Vector  get_counterv();
     Matrix  get_fpFrame();
 
+    // timestamp and version of the last update of one field
+    // (see the EXCHANGE_* identifiers)
+    double        get_stamp(const int32_t field) const;
+    unsigned long get_version(const int32_t field) const;
+
     std::pair<Vector,bool>  get_gyro();
     std::pair<Vector,bool>  get_accel();
 
@@ -143,6 +194,8 @@ public:
     iKinLimbVersion head_version;
     double          saccadesInhibitionPeriod;
     double          saccadesActivationAngle;
+    double          poseHistory;
+    double          neckSolverDeadline;
     int             neckSolveCnt;
     bool            ctrlActive;
     bool            trackingModeOn;
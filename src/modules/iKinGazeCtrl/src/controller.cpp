@@ -31,8 +31,12 @@ Controller::Controller(PolyDriver *_drvTorso, PolyDriver *_drvHead, ExchangeData
                        PeriodicThread((double)_period/1000.0), drvTorso(_drvTorso), drvHead(_drvHead),
                        commData(_commData),                    neckTime(_neckTime), eyesTime(_eyesTime),
                        min_abs_vel(_min_abs_vel),              period(_period),     Ts(_period/1000.0),
-                       printAccTime(0.0)
+                       printAccTime(0.0),                      telemetry(_period/1000.0)
 {
+    tmSectionFk=telemetry.addSection("fk");
+    tmSectionCtrl=telemetry.addSection("ctrl");
+    tmSectionIO=telemetry.addSection("io");
+
     // Instantiate objects
     neck=new iCubHeadCenter("right_v"+commData->head_version.get_version());
     eyeL=new iCubEye("left_v"+commData->head_version.get_version());
@@ -363,6 +367,7 @@ bool Controller::threadInit()
 {
     port_x.open(commData->localStemName+"/x:o");
     port_q.open(commData->localStemName+"/q:o");
+    port_state.open(commData->localStemName+"/state_full:o");
     port_event.open(commData->localStemName+"/events:o");
 
     if (commData->debugInfoEnabled)
@@ -387,6 +392,9 @@ void Controller::threadRelease()
     port_q.interrupt();
     port_q.close();
 
+    port_state.interrupt();
+    port_state.close();
+
     port_event.interrupt();
     port_event.close();
 
@@ -641,6 +649,7 @@ bool Controller::getGazeStabilization() const
 /************************************************************************/
 void Controller::run()
 {
+    telemetry.beginCycle();
     lock_guard<mutex> lg(mutexRun);
     
     mutexCtrl.lock();
@@ -677,38 +686,41 @@ void Controller::run()
 
     // read feedbacks
     q_stamp=Time::now();
+    telemetry.tic(tmSectionIO);
     if (!getFeedback(fbTorso,fbHead,drvTorso,drvHead,commData,&q_stamp))
     {
+        telemetry.toc(tmSectionIO);
+        telemetry.endCycle();
         yError("Communication timeout detected!");
         notifyEvent("comm-timeout");        
         suspend();
         return;
     }
+    telemetry.toc(tmSectionIO);
 
     // update pose information
+    telemetry.tic(tmSectionFk);
     {
         mutexChain.lock();
-        for (int i=0; i<nJointsTorso; i++)
-        {
-            chainNeck->setAng(i,fbTorso[i]);
-            chainEyeL->setAng(i,fbTorso[i]);
-            chainEyeR->setAng(i,fbTorso[i]);
-        }
-        for (int i=0; i<3; i++)
-        {
-            chainNeck->setAng(nJointsTorso+i,fbHead[i]);
-            chainEyeL->setAng(nJointsTorso+i,fbHead[i]);
-            chainEyeR->setAng(nJointsTorso+i,fbHead[i]);
-        }
-
-        chainEyeL->setAng(nJointsTorso+3,fbHead[3]);               
-        chainEyeL->setAng(nJointsTorso+4,fbHead[4]+fbHead[5]/2.0);
-        chainEyeR->setAng(nJointsTorso+3,fbHead[3]);
-        chainEyeR->setAng(nJointsTorso+4,fbHead[4]-fbHead[5]/2.0);
+        setPoseChainAng(chainNeck,fbTorso,fbHead);
+        setPoseChainAng(chainEyeL,fbTorso,fbHead);
+        setPoseChainAng(chainEyeR,fbTorso,fbHead);
 
         txInfo_pose.update(q_stamp);
+
+        // keep track of the feedback within the history window
+        if (commData->poseHistory>0.0)
+        {
+            if (!poseHistory.empty() && (q_stamp<=poseHistory.back().first))
+                poseHistory.clear();    // the time source has been reset
+
+            poseHistory.push_back(make_pair(q_stamp,cat(fbTorso,fbHead)));
+            while (poseHistory.front().first<q_stamp-commData->poseHistory)
+                poseHistory.pop_front();
+        }
         mutexChain.unlock();
     }
+    telemetry.toc(tmSectionFk);
 
     IntState->reset(fbHead);
 
@@ -822,6 +834,7 @@ void Controller::run()
     pathPerc=(dist>IKIN_ALMOST_ZERO)?norm(fbHead-q0)/dist:1.0;
     pathPerc=sat(pathPerc,0.0,1.0);
 
+    telemetry.tic(tmSectionCtrl);
     if (commData->ctrlActive)
     {
         // control
@@ -883,6 +896,7 @@ void Controller::run()
         vNeck=0.0;
         vEyes=0.0;
     }
+    telemetry.toc(tmSectionCtrl);
 
     v.setSubvector(0,vNeck);
     v.setSubvector(3,vEyes);
@@ -901,6 +915,7 @@ void Controller::run()
     mutexData.unlock();
 
     // send commands to the robot
+    telemetry.tic(tmSectionIO);
     if (commData->ctrlActive || stabilizeGaze)
     {
         mutexCtrl.lock();
@@ -978,6 +993,25 @@ void Controller::run()
         port_q.write();
     }
 
+    // stream out the full state, which the clients
+    // cache to serve the getters without rpc
+    txInfo_state.update(q_stamp);
+    if (port_state.getOutputCount()>0)
+    {
+        deque<Vector> fields(GAZECTRL_STATE_NUM);
+        fields[GAZECTRL_STATE_X]=x;
+        fields[GAZECTRL_STATE_Q]=q;
+        fields[GAZECTRL_STATE_QDES]=qddeg;
+        fields[GAZECTRL_STATE_QDOT]=vdeg;
+        fields[GAZECTRL_STATE_MOTIONDONE]=Vector(1,motionDone?1.0:0.0);
+        fields[GAZECTRL_STATE_SACCADEDONE]=Vector(1,commData->saccadeUnderway?0.0:1.0);
+
+        CartesianHelper::packState(fields,port_state.prepare());
+        port_state.setEnvelope(txInfo_state);
+        port_state.write();
+    }
+    telemetry.toc(tmSectionIO);
+
     if (event=="motion-onset")
         notifyEvent(event);
 
@@ -994,6 +1028,8 @@ void Controller::run()
     commData->set_q(fbHead);
     commData->set_torso(fbTorso);
     commData->set_v(v);
+
+    telemetry.endCycle();
 }
 
 
@@ -1118,6 +1154,28 @@ bool Controller::getVelocity(Vector &vel)
 }
 
 
+/************************************************************************/
+void Controller::setPoseChainAng(iKinChain *chain, const Vector &torso,
+                                 const Vector &head)
+{
+    for (int i=0; i<nJointsTorso; i++)
+        chain->setAng(i,torso[i]);
+    for (int i=0; i<3; i++)
+        chain->setAng(nJointsTorso+i,head[i]);
+
+    if (chain==chainEyeL)
+    {
+        chain->setAng(nJointsTorso+3,head[3]);
+        chain->setAng(nJointsTorso+4,head[4]+head[5]/2.0);
+    }
+    else if (chain==chainEyeR)
+    {
+        chain->setAng(nJointsTorso+3,head[3]);
+        chain->setAng(nJointsTorso+4,head[4]-head[5]/2.0);
+    }
+}
+
+
 /************************************************************************/
 bool Controller::getPose(const string &poseSel, Vector &x, Stamp &stamp)
 {
@@ -1145,6 +1203,55 @@ bool Controller::getPose(const string &poseSel, Vector &x, Stamp &stamp)
 }
 
 
+/************************************************************************/
+bool Controller::getPose(const string &poseSel, const double t, Vector &x,
+                         Stamp &stamp)
+{
+    lock_guard<mutex> lg(mutexChain);
+
+    iKinChain *chain=nullptr;
+    if (poseSel=="left")
+        chain=chainEyeL;
+    else if (poseSel=="right")
+        chain=chainEyeR;
+    else if (poseSel=="head")
+        chain=chainNeck;
+
+    // requests older than the history cannot be served
+    if ((chain==nullptr) || poseHistory.empty() || (t<poseHistory.front().first))
+        return false;
+
+    // interpolate the joints between the two closest
+    // samples; newer requests get the latest sample
+    Vector q;
+    double tq=t;
+    if (t>=poseHistory.back().first)
+    {
+        q=poseHistory.back().second;
+        tq=poseHistory.back().first;
+    }
+    else
+    {
+        auto it=upper_bound(poseHistory.begin(),poseHistory.end(),t,
+                            [](const double t, const pair<double,Vector> &sample)
+                            { return (t<sample.first); });
+        auto prev=it-1;
+        double a=(t-prev->first)/(it->first-prev->first);
+        q=prev->second+a*(it->second-prev->second);
+    }
+
+    // the chain is brought back to the current configuration
+    Vector q0=chain->getAng();
+    setPoseChainAng(chain,q.subVector(0,nJointsTorso-1),
+                    q.subVector(nJointsTorso,(unsigned int)q.length()-1));
+    x=chain->EndEffPose();
+    chain->setAng(q0);
+
+    stamp=Stamp(txInfo_pose.getCount(),tq);
+    return true;
+}
+
+
 /************************************************************************/
 bool Controller::registerMotionOngoingEvent(const double checkPoint)
 {
@@ -1192,3 +1299,17 @@ Bottle Controller::listMotionOngoingEvents()
 }
 
 
+/************************************************************************/
+void Controller::getTelemetry(Bottle &info)
+{
+    telemetry.getInfo(info);
+}
+
+
+/************************************************************************/
+void Controller::resetTelemetry()
+{
+    telemetry.reset();
+}
+
+
@@ -18,6 +18,7 @@
 
 #include <cmath>
 #include <limits>
+#include <chrono>
 #include <algorithm>
 
 #include <IpTNLP.hpp>
@@ -62,6 +63,20 @@ protected:
     double upperBoundInf;
     bool   firstGo;
 
+    // real-time mode
+    bool   warmStart;
+    Vector zL0, zU0, lambda0;
+    Vector zL1, zU1, lambda1;
+    bool   useDeadline;
+    std::chrono::steady_clock::time_point t_deadline;
+    double constrTol;
+    double bestObj;
+    Vector qBest;
+    bool   bestFound;
+    int    lastIter;
+    bool   converged;
+    bool   deadlineHit;
+
     /************************************************************************/
     void computeQuantities(const Ipopt::Number *x)
     {
@@ -124,11 +139,51 @@ public:
         upperBoundInf=std::numeric_limits<double>::max();
 
         qRest.resize(dim,0.0);
+
+        warmStart=false;
+        useDeadline=false;
+        constrTol=0.0;
+        bestObj=std::numeric_limits<double>::max();
+        bestFound=false;
+        lastIter=0;
+        converged=false;
+        deadlineHit=false;
     }
 
     /************************************************************************/
     Vector get_qd() { return qd; }
 
+    /************************************************************************/
+    void set_warm_start(const Vector &_zL, const Vector &_zU, const Vector &_lambda)
+    {
+        zL0=_zL;
+        zU0=_zU;
+        lambda0=_lambda;
+        warmStart=true;
+    }
+
+    /************************************************************************/
+    void set_deadline(const std::chrono::steady_clock::time_point &t, const double tol)
+    {
+        t_deadline=t;
+        constrTol=tol;
+        useDeadline=true;
+    }
+
+    /************************************************************************/
+    void get_multipliers(Vector &_zL, Vector &_zU, Vector &_lambda) const
+    {
+        _zL=zL1;
+        _zU=zU1;
+        _lambda=lambda1;
+    }
+
+    /************************************************************************/
+    int  get_iter() const         { return lastIter; }
+    bool is_converged() const     { return converged; }
+    bool is_deadline_hit() const  { return deadlineHit; }
+    bool is_feasible() const      { return converged || bestFound; }
+
     /************************************************************************/
     void set_scaling(double _obj_scaling, double _x_scaling, double _g_scaling)
     {
@@ -183,6 +238,22 @@ public:
         for (Ipopt::Index i=0; i<n; i++)
             x[i]=q0[i];
 
+        // the multipliers are requested only when warm-starting
+        if (init_z)
+        {
+            for (Ipopt::Index i=0; i<n; i++)
+            {
+                z_L[i]=(warmStart && ((int)zL0.length()==n))?zL0[i]:0.0;
+                z_U[i]=(warmStart && ((int)zU0.length()==n))?zU0[i]:0.0;
+            }
+        }
+
+        if (init_lambda)
+        {
+            for (Ipopt::Index j=0; j<m; j++)
+                lambda[j]=(warmStart && ((int)lambda0.length()==m))?lambda0[j]:0.0;
+        }
+
         return true;
     }
 
@@ -223,6 +294,26 @@ public:
         g[1]=(chain(1).getMin()-qRest[1])*fPitch-(x[1]-qRest[1]);
         g[2]=x[1]-qRest[1]-(chain(1).getMax()-qRest[1])*fPitch;
 
+        // keep track of the best feasible point, in case
+        // the solve gets cut by the deadline
+        if (useDeadline && (fabs(g[0]+1.0)<=constrTol) &&
+            (g[1]<=constrTol) && (g[2]<=constrTol))
+        {
+            double obj=0.0;
+            for (Ipopt::Index i=0; i<n; i++)
+            {
+                double tmp=x[i]-qRest[i];
+                obj+=tmp*tmp;
+            }
+
+            if (obj<bestObj)
+            {
+                bestObj=obj;
+                qBest=q;
+                bestFound=true;
+            }
+        }
+
         return true;
     }
 
@@ -296,6 +387,25 @@ public:
         return true;
     }
 
+    /************************************************************************/
+    bool intermediate_callback(Ipopt::AlgorithmMode mode, Ipopt::Index iter,
+                               Ipopt::Number obj_value, Ipopt::Number inf_pr,
+                               Ipopt::Number inf_du, Ipopt::Number mu, Ipopt::Number d_norm,
+                               Ipopt::Number regularization_size, Ipopt::Number alpha_du,
+                               Ipopt::Number alpha_pr, Ipopt::Index ls_trials,
+                               const Ipopt::IpoptData* ip_data,
+                               Ipopt::IpoptCalculatedQuantities* ip_cq) override
+    {
+        lastIter=iter;
+        if (useDeadline && (std::chrono::steady_clock::now()>=t_deadline))
+        {
+            deadlineHit=true;
+            return false;
+        }
+
+        return true;
+    }
+
     /************************************************************************/
     void finalize_solution(Ipopt::SolverReturn status, Ipopt::Index n,
                            const Ipopt::Number* x, const Ipopt::Number* z_L,
@@ -303,10 +413,28 @@ public:
                            const Ipopt::Number* lambda, Ipopt::Number obj_value,
                            const Ipopt::IpoptData* ip_data, Ipopt::IpoptCalculatedQuantities* ip_cq) override
     {
-        for (Ipopt::Index i=0; i<n; i++)
-            qd[i]=x[i];
+        converged=(status==Ipopt::SUCCESS);
+
+        if (converged || !bestFound)
+        {
+            for (Ipopt::Index i=0; i<n; i++)
+                qd[i]=x[i];
+        }
+        else
+            qd=qBest;
 
         qd=chain.setAng(qd);
+
+        zL1.resize(n); zU1.resize(n);
+        for (Ipopt::Index i=0; i<n; i++)
+        {
+            zL1[i]=z_L[i];
+            zU1[i]=z_U[i];
+        }
+
+        lambda1.resize(m);
+        for (Ipopt::Index j=0; j<m; j++)
+            lambda1[j]=lambda[j];
     }
 
     /************************************************************************/
@@ -328,18 +456,79 @@ public:
 };
 
 
+/************************************************************************/
+GazeIpOptMin::GazeIpOptMin(iKinChain &_chain, const double tol, const double constr_tol,
+                           const int max_iter, const unsigned int verbose) :
+                           iKinIpOptMin(_chain,IKINCTRL_POSE_XYZ,tol,constr_tol,
+                                        max_iter,verbose,false),
+                           constrTol(constr_tol), deadline(0.0), warmStartOk(false)
+{
+    info.time=0.0;
+    info.iter=0;
+    info.converged=false;
+    info.deadline=false;
+    info.feasible=false;
+}
+
+
+/************************************************************************/
+void GazeIpOptMin::setDeadline(const double _deadline)
+{
+    deadline=std::max(_deadline,0.0);
+    warmStartOk=false;
+
+    if (deadline>0.0)
+    {
+        // the previous solution lies close to the bounds already
+        Ipopt::IpoptApplication *app=static_cast<Ipopt::IpoptApplication*>(App);
+        app->Options()->SetNumericValue("warm_start_bound_push",1e-6);
+        app->Options()->SetNumericValue("warm_start_mult_bound_push",1e-6);
+    }
+}
+
+
 /************************************************************************/
 Vector GazeIpOptMin::solve(const Vector &q0, Vector &xd, const Vector &gDir)
 {
+    Ipopt::IpoptApplication *app=static_cast<Ipopt::IpoptApplication*>(App);
+    bool warm=(deadline>0.0) && warmStartOk;
+
     Ipopt::SmartPtr<HeadCenter_NLP> nlp;
-    nlp=new HeadCenter_NLP(chain,q0,xd);
+    nlp=new HeadCenter_NLP(chain,warm?warm_x:q0,xd);
 
     nlp->set_scaling(obj_scaling,x_scaling,g_scaling);
     nlp->set_bound_inf(lowerBoundInf,upperBoundInf);
     nlp->setGravityDirection(gDir);
-    
-    static_cast<Ipopt::IpoptApplication*>(App)->OptimizeTNLP(GetRawPtr(nlp));
-    return nlp->get_qd();
+
+    auto t0=std::chrono::steady_clock::now();
+    if (deadline>0.0)
+    {
+        auto dt=std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(deadline));
+        nlp->set_deadline(t0+dt,constrTol);
+        if (warm)
+            nlp->set_warm_start(warm_zL,warm_zU,warm_lambda);
+    }
+    app->Options()->SetStringValue("warm_start_init_point",warm?"yes":"no");
+
+    app->OptimizeTNLP(GetRawPtr(nlp));
+
+    info.time=std::chrono::duration<double>(std::chrono::steady_clock::now()-t0).count();
+    info.iter=nlp->get_iter();
+    info.converged=nlp->is_converged();
+    info.deadline=nlp->is_deadline_hit();
+    info.feasible=nlp->is_feasible();
+
+    Vector qd=nlp->get_qd();
+
+    // warm-start the next solve only from feasible solutions
+    warmStartOk=(deadline>0.0) && info.feasible;
+    if (warmStartOk)
+    {
+        warm_x=qd;
+        nlp->get_multipliers(warm_zL,warm_zU,warm_lambda);
+    }
+
+    return qd;
 }
 
 
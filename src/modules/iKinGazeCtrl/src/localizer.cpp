@@ -292,6 +292,24 @@ Vector Localizer::get3DPoint(const string &type, const Vector &ang)
 }
 
 
+/************************************************************************/
+Vector Localizer::getEyeJoints(const Vector &torso, const Vector &head,
+                               const bool isLeft)
+{
+    Vector q(8);
+    q[0]=torso[0];
+    q[1]=torso[1];
+    q[2]=torso[2];
+    q[3]=head[0];
+    q[4]=head[1];
+    q[5]=head[2];
+    q[6]=head[3];
+    q[7]=head[4]+head[5]/(isLeft?2.0:-2.0);
+
+    return q;
+}
+
+
 /************************************************************************/
 bool Localizer::projectPoint(const string &type, const Vector &x, Vector &px)
 {
@@ -309,18 +327,7 @@ bool Localizer::projectPoint(const string &type, const Vector &x, Vector &px)
 
     if (Prj!=nullptr)
     {
-        Vector torso=commData->get_torso();
-        Vector head=commData->get_q();
-
-        Vector q(8);
-        q[0]=torso[0];
-        q[1]=torso[1];
-        q[2]=torso[2];
-        q[3]=head[0];
-        q[4]=head[1];
-        q[5]=head[2];
-        q[6]=head[3];
-        q[7]=head[4]+head[5]/(isLeft?2.0:-2.0);
+        Vector q=getEyeJoints(commData->get_torso(),commData->get_q(),isLeft);
         
         Vector xo=x;
         // impose homogeneous coordinates
@@ -361,18 +368,7 @@ bool Localizer::projectPoint(const string &type, const double u, const double v,
 
     if (invPrj!=nullptr)
     {
-        Vector torso=commData->get_torso();
-        Vector head=commData->get_q();
-
-        Vector q(8);
-        q[0]=torso[0];
-        q[1]=torso[1];
-        q[2]=torso[2];
-        q[3]=head[0];
-        q[4]=head[1];
-        q[5]=head[2];
-        q[6]=head[3];
-        q[7]=head[4]+head[5]/(isLeft?2.0:-2.0);
+        Vector q=getEyeJoints(commData->get_torso(),commData->get_q(),isLeft);
 
         Vector p(3);
         p[0]=z*u;
@@ -461,19 +457,9 @@ bool Localizer::triangulatePoint(const Vector &pxl, const Vector &pxr, Vector &x
         Vector torso=commData->get_torso();
         Vector head=commData->get_q();
 
-        Vector qL(8);
-        qL[0]=torso[0];
-        qL[1]=torso[1];
-        qL[2]=torso[2];
-        qL[3]=head[0];
-        qL[4]=head[1];
-        qL[5]=head[2];
-        qL[6]=head[3];
-        qL[7]=head[4]+head[5]/2.0;
-
-        Vector qR=qL;
-        qR[7]-=head[5];
-        
+        Vector qL=getEyeJoints(torso,head,true);
+        Vector qR=getEyeJoints(torso,head,false);
+
         Matrix HL=SE3inv(eyeL->getH(qL));
         Matrix HR=SE3inv(eyeR->getH(qR));
 
@@ -511,6 +497,146 @@ bool Localizer::triangulatePoint(const Vector &pxl, const Vector &pxr, Vector &x
 }
 
 
+/************************************************************************/
+bool Localizer::projectPoints(const string &type, const Matrix &x, Matrix &px)
+{
+    lock_guard<mutex> lck(mtx);
+    if ((x.rows()>0) && (x.cols()<3))
+    {
+        yError("Not enough values given for the points!");
+        return false;
+    }
+
+    bool isLeft=(type=="left");
+
+    Matrix  *Prj=(isLeft?PrjL:PrjR);
+    iCubEye *eye=(isLeft?eyeL:eyeR);
+
+    if (Prj!=nullptr)
+    {
+        // the eye pose is computed once for all the points
+        Vector q=getEyeJoints(commData->get_torso(),commData->get_q(),isLeft);
+        Matrix M=*Prj*SE3inv(eye->getH(q));
+
+        px.resize(x.rows(),2);
+        for (size_t r=0; r<x.rows(); r++)
+        {
+            double p[3];
+            for (int i=0; i<3; i++)
+                p[i]=M(i,0)*x(r,0)+M(i,1)*x(r,1)+M(i,2)*x(r,2)+M(i,3);
+
+            px(r,0)=p[0]/p[2];
+            px(r,1)=p[1]/p[2];
+        }
+
+        return true;
+    }
+    else
+    {
+        yError("Unspecified projection matrix for %s camera!",type.c_str());
+        return false;
+    }
+}
+
+
+/************************************************************************/
+bool Localizer::projectPoints(const string &type, const Matrix &px, const Vector &z,
+                              Matrix &x)
+{
+    lock_guard<mutex> lck(mtx);
+    if (((px.rows()>0) && (px.cols()<2)) || (z.length()!=px.rows()))
+    {
+        yError("Not enough values given for the pixels!");
+        return false;
+    }
+
+    bool isLeft=(type=="left");
+
+    Matrix  *invPrj=(isLeft?invPrjL:invPrjR);
+    iCubEye *eye=(isLeft?eyeL:eyeR);
+
+    if (invPrj!=nullptr)
+    {
+        // x=R*invPrj*(z*u,z*v,z)+p, with the eye pose
+        // computed once for all the points
+        Vector q=getEyeJoints(commData->get_torso(),commData->get_q(),isLeft);
+        Matrix H=eye->getH(q);
+        Matrix M=H.submatrix(0,2,0,2)*invPrj->submatrix(0,2,0,2);
+
+        x.resize(px.rows(),3);
+        for (size_t r=0; r<px.rows(); r++)
+        {
+            double u=z[r]*px(r,0);
+            double v=z[r]*px(r,1);
+            for (int i=0; i<3; i++)
+                x(r,i)=M(i,0)*u+M(i,1)*v+M(i,2)*z[r]+H(i,3);
+        }
+
+        return true;
+    }
+    else
+    {
+        yError("Unspecified projection matrix for %s camera!",type.c_str());
+        return false;
+    }
+}
+
+
+/************************************************************************/
+bool Localizer::triangulatePoints(const Matrix &pxl, const Matrix &pxr, Matrix &x)
+{
+    lock_guard<mutex> lck(mtx);
+    if ((pxl.rows()!=pxr.rows()) || ((pxl.rows()>0) && ((pxl.cols()<2) || (pxr.cols()<2))))
+    {
+        yError("Not enough values given for the pixels!");
+        return false;
+    }
+
+    if (PrjL && PrjR)
+    {
+        // the eyes poses are computed once for all the points
+        Vector torso=commData->get_torso();
+        Vector head=commData->get_q();
+
+        Matrix HL=SE3inv(eyeL->getH(getEyeJoints(torso,head,true)));
+        Matrix HR=SE3inv(eyeR->getH(getEyeJoints(torso,head,false)));
+        Matrix ML=*PrjL*HL;
+        Matrix MR=*PrjR*HR;
+
+        // same system as in triangulatePoint(), where the
+        // rows of (Prj-tmp)*H are given by M.row(i)-px[i]*H.row(2)
+        Matrix A(4,3);
+        Vector b(4);
+
+        x.resize(pxl.rows(),3);
+        for (size_t r=0; r<pxl.rows(); r++)
+        {
+            for (int i=0; i<2; i++)
+            {
+                b[i]=-(ML(i,3)-pxl(r,i)*HL(2,3));
+                b[i+2]=-(MR(i,3)-pxr(r,i)*HR(2,3));
+
+                for (int j=0; j<3; j++)
+                {
+                    A(i,j)=ML(i,j)-pxl(r,i)*HL(2,j);
+                    A(i+2,j)=MR(i,j)-pxr(r,i)*HR(2,j);
+                }
+            }
+
+            // solve the least-squares problem
+            x.setRow(r,pinv(A)*b);
+        }
+
+        return true;
+    }
+    else
+    {
+        yError("Unspecified projection matrix for at least one camera!");
+        return false;
+    }
+}
+
+
 /************************************************************************/
 double Localizer::getDistFromVergence(const double ver)
 {
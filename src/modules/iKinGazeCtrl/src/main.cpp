@@ -189,6 +189,21 @@ Factors</a>.
   starting up the robot before connecting to it; by default we
   have a timeout of 40.0 [s].
 
+--pose_history \e T
+- The parameter \e T specifies the time window (in seconds)
+  during which the joints feedback is retained to compute the
+  poses at past time instants; by default we have a window of
+  1.0 [s], while 0.0 disables the history.
+
+--neck_solver_deadline \e T
+- The parameter \e T specifies the wall-clock time (in seconds)
+  granted to each solve of the neck. A positive value enables
+  the real-time mode, where the solver is warm-started from the
+  previous solution and is cut when the deadline expires,
+  returning the best feasible configuration found; by default
+  0.0 disables it, letting IPOPT run up to convergence or to
+  the iterations limit.
+
 --eye_tilt::min \e min
 - The parameter \e min specifies the minimum eye tilt angle
   [deg] in order to prevent the eye from being covered by the
@@ -344,6 +359,10 @@ following ports:
      suspended because of a communication timeout; comprise the
      time instant of the source when the event took place.
 
+- \e /<ctrlName>/telemetry:o streams out once per second the
+  timing statistics of the controller and solver threads, in
+  the same format returned by the [get] [tele] rpc command.
+
 - \e /<ctrlName>/rpc remote procedure call. \n
     Recognized remote commands (be careful, <b>commands dealing
     with geometric projections will only work if the cameras
@@ -399,6 +418,11 @@ following ports:
       as further list accounting for the time (second element of
       the list) relative to the encoders positions used to
       compute the pose.
+    - [get] [pose] <type> <time>: returns the pose as above at
+      the given time instant, by interpolating the encoders
+      positions retained within the window specified by
+      --pose_history; a [nack] is returned if the time instant
+      is older than the window.
     - [get] [2D] (<type> <x> <y> <z>): returns the 2D pixel
       point whose cartesian coordinates (x,y,z) are given wrt
       the root reference frame as the result of its projection
@@ -414,6 +438,14 @@ following ports:
       @note The triangulation is deeply affected by
       uncertainties in the cameras extrinsic parameters and
       cameras alignment.
+    - [get] [2Ds] (<type> (<x0> <y0> <z0> <x1> <y1> <z1> ...)):
+      the batch version of [get] [2D], which projects all the
+      points with the same eye pose and returns the list (<u0>
+      <v0> <u1> <v1> ...).
+    - [get] [3Ds] [mono] (<type> (<u0> <v0> <z0> <u1> <v1> <z1>
+      ...)), [get] [3Ds] [stereo] (<ul0> <vl0> <ur0> <vr0> ...):
+      the batch versions of [get] [3D] [mono] and [get] [3D]
+      [stereo], which return the list (<x0> <y0> <z0> <x1> ...).
     - [get] [3D] [proj] (<type> < u> <v> < a> < b> < c> <d>):
       returns the 3D point with projected pixel coordinates
       (u,v) in the image plane <type> ["left"|"right"] that
@@ -437,6 +469,17 @@ following ports:
     - [get] [tweak]: returns (enclosed in a list) a
       property-like bottle containing low-level information on
       the current controller's configuration.
+    - [get] [tele]: returns (enclosed in a list) a property-like
+      bottle containing the timing statistics of the
+      "controller" and "solver" threads: the histograms of the
+      run durations and of the period jitter, the number of
+      overruns and the time spent in the "fk", "ctrl", "ipopt"
+      and "io" sections of the cycle. The solver also reports
+      the "neck_solver" statistics: the deadline, the number of
+      solves that converged, hit the deadline or could not find
+      a feasible configuration, along with the mean iterations
+      and the mean and maximum time to solution. Times are in
+      [ms].
     - [set] [Tneck] <val>: sets a new movements execution time
       for neck movements.
     - [set] [Teyes] <val>: sets a new movements execution time
@@ -465,6 +508,7 @@ following ports:
     - [set] [tweak] ((prop0 (<val> <val> ...)) (prop1) (<val>
       <val> ...)): sets parameters for the low-level
       controller's configuration.
+    - [set] [tele] reset: clears the timing statistics.
     - [look] [3D] (<x> <y> <z>): yields gazing at target specified
       as 3D point. Distances are in meters.
     - [look] [mono] (<type> < u> <v> <z>): yields gazing at target
@@ -607,6 +651,7 @@ protected:
     IThreeAxisLinearAccelerometers* iAccel;
 
     RpcServer rpcPort;
+    BufferedPort<Bottle> telemetryPort;
 
     struct Context
     {
@@ -758,6 +803,18 @@ protected:
             return false;
     }
 
+    /************************************************************************/
+    void getTelemetry(Bottle &info)
+    {
+        Bottle &ctrlInfo=info.addList();
+        ctrlInfo.addString("controller");
+        ctrl->getTelemetry(ctrlInfo.addList());
+
+        Bottle &slvInfo=info.addList();
+        slvInfo.addString("solver");
+        slv->getTelemetry(slvInfo.addList());
+    }
+
     /************************************************************************/
     bool getInfo(Bottle &info)
     {
@@ -1157,6 +1214,8 @@ public:
         commData.stabilizationGain=imuGroup.check("stabilization_gain",Value(11.0)).asFloat64();
         commData.gyro_noise_threshold=CTRL_DEG2RAD*imuGroup.check("gyro_noise_threshold",Value(5.0)).asFloat64();
         commData.debugInfoEnabled=rf.check("debugInfo",Value("off")).asString()=="on";
+        commData.poseHistory=rf.check("pose_history",Value(GAZECTRL_DEFAULT_POSE_HISTORY)).asFloat64();
+        commData.neckSolverDeadline=rf.check("neck_solver_deadline",Value(0.0)).asFloat64();
 
         if (commData.stabilizationOn)
         {
@@ -1296,6 +1355,8 @@ public:
         rpcPort.open(commData.localStemName+"/rpc");
         attach(rpcPort);
 
+        telemetryPort.open(commData.localStemName+"/telemetry:o");
+
         contextIdCnt=0;
 
         // reserve id==0 for start-up context
@@ -1460,7 +1521,11 @@ public:
                             Vector x;
                             Stamp  stamp;
 
-                            if (ctrl->getPose(poseSel,x,stamp))
+                            bool ok=(command.size()>3)?
+                                    ctrl->getPose(poseSel,command.get(3).asFloat64(),x,stamp):
+                                    ctrl->getPose(poseSel,x,stamp);
+
+                            if (ok)
                             {
                                 reply.addVocab32(ack);
                                 reply.addList().read(x);
@@ -1494,6 +1559,84 @@ public:
                                 }
                             }
                         }
+                        else if ((type==createVocab32('2','D','s')) && (command.size()>2))
+                        {
+                            Bottle *bOpt=command.get(2).asList();
+                            if ((bOpt!=nullptr) && (bOpt->size()>1))
+                            {
+                                Bottle *bPoints=bOpt->get(1).asList();
+                                if ((bPoints!=nullptr) && (bPoints->size()%3==0))
+                                {
+                                    string eye=bOpt->get(0).asString();
+                                    Matrix x(bPoints->size()/3,3);
+                                    for (size_t i=0; i<bPoints->size(); i++)
+                                        x(i/3,i%3)=bPoints->get(i).asFloat64();
+
+                                    Matrix px;
+                                    if (loc->projectPoints(eye,x,px))
+                                    {
+                                        reply.addVocab32(ack);
+                                        Bottle &bPixels=reply.addList();
+                                        for (size_t r=0; r<px.rows(); r++)
+                                        {
+                                            bPixels.addFloat64(px(r,0));
+                                            bPixels.addFloat64(px(r,1));
+                                        }
+                                        return true;
+                                    }
+                                }
+                            }
+                        }
+                        else if ((type==createVocab32('3','D','s')) && (command.size()>3))
+                        {
+                            int subType=command.get(2).asVocab32();
+                            Bottle *bOpt=command.get(3).asList();
+                            Matrix x;
+                            bool ok=false;
+
+                            if ((subType==createVocab32('m','o','n','o')) && (bOpt!=nullptr) && (bOpt->size()>1))
+                            {
+                                Bottle *bPixels=bOpt->get(1).asList();
+                                if ((bPixels!=nullptr) && (bPixels->size()%3==0))
+                                {
+                                    string eye=bOpt->get(0).asString();
+                                    Matrix px(bPixels->size()/3,2);
+                                    Vector z(px.rows());
+                                    for (size_t r=0; r<px.rows(); r++)
+                                    {
+                                        px(r,0)=bPixels->get(3*r).asFloat64();
+                                        px(r,1)=bPixels->get(3*r+1).asFloat64();
+                                        z[r]=bPixels->get(3*r+2).asFloat64();
+                                    }
+
+                                    ok=loc->projectPoints(eye,px,z,x);
+                                }
+                            }
+                            else if ((subType==createVocab32('s','t','e','r')) && (bOpt!=nullptr) &&
+                                     (bOpt->size()%4==0))
+                            {
+                                Matrix pxl(bOpt->size()/4,2),pxr(bOpt->size()/4,2);
+                                for (size_t r=0; r<pxl.rows(); r++)
+                                {
+                                    pxl(r,0)=bOpt->get(4*r).asFloat64();
+                                    pxl(r,1)=bOpt->get(4*r+1).asFloat64();
+                                    pxr(r,0)=bOpt->get(4*r+2).asFloat64();
+                                    pxr(r,1)=bOpt->get(4*r+3).asFloat64();
+                                }
+
+                                ok=loc->triangulatePoints(pxl,pxr,x);
+                            }
+
+                            if (ok)
+                            {
+                                reply.addVocab32(ack);
+                                Bottle &bPoints=reply.addList();
+                                for (size_t r=0; r<x.rows(); r++)
+                                    for (size_t c=0; c<x.cols(); c++)
+                                        bPoints.addFloat64(x(r,c));
+                                return true;
+                            }
+                        }
                         else if ((type==createVocab32('3','D')) && (command.size()>3))
                         {
                             int subType=command.get(2).asVocab32();
@@ -1632,6 +1775,15 @@ public:
                                 return true;
                             }
                         }
+                        else if (type==createVocab32('t','e','l','e'))
+                        {
+                            Bottle info;
+                            getTelemetry(info);
+
+                            reply.addVocab32(ack);
+                            reply.addList()=info;
+                            return true;
+                        }
                     }
 
                     break;
@@ -1730,6 +1882,14 @@ public:
                                 return true;
                             }
                         }
+                        else if ((type==createVocab32('t','e','l','e')) &&
+                                 (command.get(2).asString()=="reset"))
+                        {
+                            ctrl->resetTelemetry();
+                            slv->resetTelemetry();
+                            reply.addVocab32(ack);
+                            return true;
+                        }
                     }
 
                     break;
@@ -2109,6 +2269,8 @@ public:
                 commData.port_xd->close();
         if (rpcPort.asPort().isOpen())
             rpcPort.close();
+        if (!telemetryPort.isClosed())
+            telemetryPort.close();
 
         // this switch-off order does matter !!
         delete commData.port_xd;
@@ -2130,6 +2292,7 @@ public:
         if (commData.port_xd!=nullptr)
             commData.port_xd->interrupt();
         rpcPort.interrupt();
+        telemetryPort.interrupt();
 
         return true;
     }
@@ -2157,6 +2320,14 @@ public:
             doSaveTweakFile=false;
         }
 
+        if ((ctrl!=nullptr) && (slv!=nullptr) && (telemetryPort.getOutputCount()>0))
+        {
+            Bottle &info=telemetryPort.prepare();
+            info.clear();
+            getTelemetry(info);
+            telemetryPort.write();
+        }
+
         return true;
     }
 };
@@ -462,8 +462,14 @@ Solver::Solver(PolyDriver *_drvTorso, PolyDriver *_drvHead, ExchangeData *_commD
                const unsigned int _period) :
                PeriodicThread((double)_period/1000.0), drvTorso(_drvTorso),     drvHead(_drvHead),
                commData(_commData),                    eyesRefGen(_eyesRefGen), loc(_loc),
-               ctrl(_ctrl),                            period(_period),         Ts(_period/1000.0)
+               ctrl(_ctrl),                            period(_period),         Ts(_period/1000.0),
+               telemetry(_period/1000.0)
 {
+    tmSectionIpOpt=telemetry.addSection("ipopt");
+    tmSectionFk=telemetry.addSection("fk");
+    tmSectionIO=telemetry.addSection("io");
+    resetSolveStats();
+
     // Instantiate objects
     neck=new iCubHeadCenter("right_v"+commData->head_version.get_version());
     eyeL=new iCubEye("left_v"+commData->head_version.get_version());
@@ -485,6 +491,7 @@ Solver::Solver(PolyDriver *_drvTorso, PolyDriver *_drvHead, ExchangeData *_commD
     chainEyeR=eyeR->asChain();
 
     invNeck=new GazeIpOptMin(*chainNeck,1e-3,1e-3,20);
+    invNeck->setDeadline(commData->neckSolverDeadline);
 
     // add aligning matrices read from configuration file
     getAlignHN(commData->rf_cameras,"ALIGN_KIN_LEFT",eyeL->asChain());
@@ -565,6 +572,15 @@ Solver::~Solver()
 }
 
 
+/************************************************************************/
+void Solver::resetSolveStats()
+{
+    slvCnt=slvConverged=slvDeadlineHits=slvInfeasible=0;
+    slvIterSum=0;
+    slvTimeSum=slvTimeMax=0.0;
+}
+
+
 /************************************************************************/
 void Solver::bindNeckPitch(const double min_deg, const double max_deg)
 {
@@ -574,6 +590,7 @@ void Solver::bindNeckPitch(const double min_deg, const double max_deg)
 
     (*chainNeck)(0).setMin(min_rad);
     (*chainNeck)(0).setMax(max_rad);    
+    invNeck->resetWarmStart();
 
     yInfo("neck pitch constrained in [%g,%g] deg",min_deg,max_deg);
 }
@@ -588,6 +605,7 @@ void Solver::bindNeckRoll(const double min_deg, const double max_deg)
 
     (*chainNeck)(1).setMin(min_rad);
     (*chainNeck)(1).setMax(max_rad);
+    invNeck->resetWarmStart();
 
     yInfo("neck roll constrained in [%g,%g] deg",min_deg,max_deg);
 }
@@ -602,6 +620,7 @@ void Solver::bindNeckYaw(const double min_deg, const double max_deg)
 
     (*chainNeck)(2).setMin(min_rad);
     (*chainNeck)(2).setMax(max_rad);
+    invNeck->resetWarmStart();
 
     yInfo("neck yaw constrained in [%g,%g] deg",min_deg,max_deg);
 }
@@ -640,6 +659,7 @@ void Solver::clearNeckPitch()
     lock_guard<mutex> lck(mtx);
     (*chainNeck)(0).setMin(neckPitchMin);
     (*chainNeck)(0).setMax(neckPitchMax);
+    invNeck->resetWarmStart();
 
     yInfo("neck pitch cleared");
 }
@@ -651,6 +671,7 @@ void Solver::clearNeckRoll()
     lock_guard<mutex> lck(mtx);
     (*chainNeck)(1).setMin(neckRollMin);
     (*chainNeck)(1).setMax(neckRollMax);
+    invNeck->resetWarmStart();
 
     yInfo("neck roll cleared");
 }
@@ -662,6 +683,7 @@ void Solver::clearNeckYaw()
     lock_guard<mutex> lck(mtx);
     (*chainNeck)(2).setMin(neckYawMin);
     (*chainNeck)(2).setMax(neckYawMax);
+    invNeck->resetWarmStart();
 
     yInfo("neck yaw cleared");
 }
@@ -776,6 +798,7 @@ void Solver::run()
     typedef enum { ctrl_off, ctrl_wait, ctrl_on } cstate;
     static cstate state_=ctrl_off;
 
+    telemetry.beginCycle();
     lock_guard<mutex> lck(mtx);
 
     // get the current target
@@ -785,7 +808,11 @@ void Solver::run()
     commData->set_xd(xd);
 
     // read encoders
+    telemetry.tic(tmSectionIO);
     getFeedback(fbTorso,fbHead,drvTorso,drvHead,commData);
+    telemetry.toc(tmSectionIO);
+
+    telemetry.tic(tmSectionFk);
     updateTorsoBlockedJoints(chainNeck,fbTorso);
     updateTorsoBlockedJoints(chainEyeL,fbTorso);
     updateTorsoBlockedJoints(chainEyeR,fbTorso);
@@ -798,6 +825,7 @@ void Solver::run()
     updateNeckBlockedJoints(chainEyeL,fbHead);
     updateNeckBlockedJoints(chainEyeR,fbHead);
     chainNeck->setAng(neckPos);
+    telemetry.toc(tmSectionFk);
 
     // hereafter accumulate solving conditions: the order does matter
 
@@ -835,7 +863,18 @@ void Solver::run()
         }
 
         Vector xdUserTol=computeTargetUserTolerance(xd);
+        telemetry.tic(tmSectionIpOpt);
         neckPos=invNeck->solve(neckPos,xdUserTol,gDir);
+        telemetry.toc(tmSectionIpOpt);
+
+        const GazeSolveInfo &info=invNeck->getSolveInfo();
+        slvCnt++;
+        slvConverged+=info.converged?1:0;
+        slvDeadlineHits+=info.deadline?1:0;
+        slvInfeasible+=info.feasible?0:1;
+        slvIterSum+=info.iter;
+        slvTimeSum+=info.time;
+        slvTimeMax=std::max(slvTimeMax,info.time);
 
         // update neck pitch,roll,yaw        
         commData->set_qd(0,neckPos[0]);
@@ -865,6 +904,8 @@ void Solver::run()
         if (!commData->ctrlActive)
             state_=ctrl_off;
     }
+
+    telemetry.endCycle();
 }
 
 
@@ -897,6 +938,7 @@ void Solver::resume()
     chainEyeL->setAng(nJointsTorso+4,gazePos[1]+gazePos[2]/2.0); chainEyeR->setAng(nJointsTorso+4,gazePos[1]-gazePos[2]/2.0);
 
     torsoVel->reset();       
+    invNeck->resetWarmStart();
     commData->port_xd->unlock();
 
     PeriodicThread::resume();
@@ -904,4 +946,57 @@ void Solver::resume()
 }
 
 
+/************************************************************************/
+void Solver::getTelemetry(Bottle &info)
+{
+    telemetry.getInfo(info);
+
+    lock_guard<mutex> lck(mtx);
+    Bottle &bneck=info.addList();
+    bneck.addString("neck_solver");
+    Bottle &list=bneck.addList();
+
+    Bottle &bdeadline=list.addList();
+    bdeadline.addString("deadline");
+    bdeadline.addFloat64(1e3*invNeck->getDeadline());
+
+    Bottle &bsolves=list.addList();
+    bsolves.addString("solves");
+    bsolves.addInt64((int64_t)slvCnt);
+
+    Bottle &bconverged=list.addList();
+    bconverged.addString("converged");
+    bconverged.addInt64((int64_t)slvConverged);
+
+    Bottle &bhits=list.addList();
+    bhits.addString("deadline_hits");
+    bhits.addInt64((int64_t)slvDeadlineHits);
+
+    Bottle &binfeasible=list.addList();
+    binfeasible.addString("infeasible");
+    binfeasible.addInt64((int64_t)slvInfeasible);
+
+    Bottle &biter=list.addList();
+    biter.addString("iter_mean");
+    biter.addFloat64((slvCnt>0)?(double)slvIterSum/slvCnt:0.0);
+
+    Bottle &bmean=list.addList();
+    bmean.addString("time_mean");
+    bmean.addFloat64((slvCnt>0)?1e3*slvTimeSum/slvCnt:0.0);
+
+    Bottle &bmax=list.addList();
+    bmax.addString("time_max");
+    bmax.addFloat64(1e3*slvTimeMax);
+}
+
+
+/************************************************************************/
+void Solver::resetTelemetry()
+{
+    telemetry.reset();
+
+    lock_guard<mutex> lck(mtx);
+    resetSolveStats();
+}
+
 
@@ -23,14 +23,6 @@
 #include <iCub/utils.h>
 #include <iCub/solver.h>
 
-constexpr int32_t MUTEX_XD       = 0;
-constexpr int32_t MUTEX_QD       = 1;
-constexpr int32_t MUTEX_X        = 2;
-constexpr int32_t MUTEX_Q        = 3;
-constexpr int32_t MUTEX_TORSO    = 4;
-constexpr int32_t MUTEX_V        = 5;
-constexpr int32_t MUTEX_COUNTERV = 6;
-constexpr int32_t MUTEX_FPFRAME  = 7;
 
 /************************************************************************/
 xdPort::xdPort(void *_slv) : slv(_slv)
@@ -134,6 +126,170 @@ void xdPort::run()
 }
 
 
+/************************************************************************/
+Snapshot::Snapshot() : seq(0), rows(0), cols(0), stamp(0.0)
+{
+    for (int i=0; i<SNAPSHOT_CAPACITY; i++)
+        data[i].store(0.0,memory_order_relaxed);
+}
+
+
+/************************************************************************/
+void Snapshot::beginWrite()
+{
+    // an odd sequence tells readers that an update is in progress
+    seq.store(seq.load(memory_order_relaxed)+1,memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+
+/************************************************************************/
+void Snapshot::endWrite()
+{
+    seq.store(seq.load(memory_order_relaxed)+1,memory_order_release);
+}
+
+
+/************************************************************************/
+void Snapshot::storeLocked(const double *val, const int r, const int c, const double _stamp)
+{
+    // to be called with mtx_write held
+    int n=r*c;
+    beginWrite();
+    for (int i=0; i<n; i++)
+        data[i].store(val[i],memory_order_relaxed);
+    rows.store(r,memory_order_relaxed);
+    cols.store(c,memory_order_relaxed);
+    stamp.store(_stamp,memory_order_relaxed);
+    endWrite();
+}
+
+
+/************************************************************************/
+bool Snapshot::store(const double *val, const int r, const int c, const double _stamp)
+{
+    if (r*c>SNAPSHOT_CAPACITY)
+    {
+        yError("Snapshot: data of size %d exceed the capacity %d, update rejected",r*c,SNAPSHOT_CAPACITY);
+        return false;
+    }
+
+    lock_guard<mutex> lg(mtx_write);
+    storeLocked(val,r,c,_stamp);
+    return true;
+}
+
+
+/************************************************************************/
+bool Snapshot::set(const Vector &v, const double _stamp)
+{
+    return store(v.data(),(int)v.length(),1,_stamp);
+}
+
+
+/************************************************************************/
+bool Snapshot::set(const Matrix &M, const double _stamp)
+{
+    return store(M.data(),M.rows(),M.cols(),_stamp);
+}
+
+
+/************************************************************************/
+void Snapshot::set(const int i, const double val, const double _stamp)
+{
+    lock_guard<mutex> lg(mtx_write);
+    if ((i>=0) && (i<rows.load(memory_order_relaxed)*cols.load(memory_order_relaxed)))
+    {
+        beginWrite();
+        data[i].store(val,memory_order_relaxed);
+        stamp.store(_stamp,memory_order_relaxed);
+        endWrite();
+    }
+}
+
+
+/************************************************************************/
+bool Snapshot::resize(const int sz, const double val, const double _stamp)
+{
+    if ((sz<0) || (sz>SNAPSHOT_CAPACITY))
+    {
+        yError("Snapshot: size %d out of the capacity %d, resize rejected",sz,SNAPSHOT_CAPACITY);
+        return false;
+    }
+
+    // the read-modify-write is serialized with the other writers
+    lock_guard<mutex> lg(mtx_write);
+    int n=rows.load(memory_order_relaxed)*cols.load(memory_order_relaxed);
+    double v[SNAPSHOT_CAPACITY];
+    for (int i=0; i<sz; i++)
+        v[i]=(i<n)?data[i].load(memory_order_relaxed):val;
+    storeLocked(v,sz,1,_stamp);
+    return true;
+}
+
+
+/************************************************************************/
+Vector Snapshot::getVector(double *_stamp) const
+{
+    Vector v;
+    while (true)
+    {
+        unsigned long s0=seq.load(memory_order_acquire);
+        if (s0&1)
+            continue;
+
+        // sizes may be inconsistent while overlapping with a writer
+        int n=std::min(rows.load(memory_order_relaxed)*cols.load(memory_order_relaxed),
+                       SNAPSHOT_CAPACITY);
+        if ((int)v.length()!=n)
+            v.resize(n);
+        for (int i=0; i<n; i++)
+            v[i]=data[i].load(memory_order_relaxed);
+        double st=stamp.load(memory_order_relaxed);
+
+        atomic_thread_fence(memory_order_acquire);
+        if (seq.load(memory_order_relaxed)==s0)
+        {
+            if (_stamp!=nullptr)
+                *_stamp=st;
+            return v;
+        }
+    }
+}
+
+
+/************************************************************************/
+Matrix Snapshot::getMatrix(double *_stamp) const
+{
+    Matrix M;
+    while (true)
+    {
+        unsigned long s0=seq.load(memory_order_acquire);
+        if (s0&1)
+            continue;
+
+        int r=rows.load(memory_order_relaxed);
+        int c=cols.load(memory_order_relaxed);
+        if (r*c>SNAPSHOT_CAPACITY)
+            continue;
+        if ((M.rows()!=r) || (M.cols()!=c))
+            M.resize(r,c);
+        double *m=M.data();
+        for (int i=0; i<r*c; i++)
+            m[i]=data[i].load(memory_order_relaxed);
+        double st=stamp.load(memory_order_relaxed);
+
+        atomic_thread_fence(memory_order_acquire);
+        if (seq.load(memory_order_relaxed)==s0)
+        {
+            if (_stamp!=nullptr)
+                *_stamp=st;
+            return M;
+        }
+    }
+}
+
+
 /************************************************************************/
 ExchangeData::ExchangeData()
 {
@@ -149,6 +305,8 @@ ExchangeData::ExchangeData()
 
     saccadesInhibitionPeriod=SACCADES_INHIBITION_PERIOD;
     saccadesActivationAngle=SACCADES_ACTIVATION_ANGLE;
+    poseHistory=0.0;
+    neckSolverDeadline=0.0;
 
     eyeTiltLim.resize(2);
     eyeTiltLim[0]=-std::numeric_limits<double>::max();
@@ -167,180 +325,164 @@ ExchangeData::ExchangeData()
 /************************************************************************/
 void ExchangeData::resize_v(const int sz, const double val)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_V]);
-    v.resize(sz,val);
+    data[EXCHANGE_V].resize(sz,val,Time::now());
 }
 
 
 /************************************************************************/
 void ExchangeData::resize_counterv(const int sz, const double val)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_COUNTERV]);
-    counterv.resize(sz,val);
+    data[EXCHANGE_COUNTERV].resize(sz,val,Time::now());
 }
 
 
 /************************************************************************/
 void ExchangeData::set_xd(const Vector &_xd)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_XD]);
-    xd=_xd;
+    data[EXCHANGE_XD].set(_xd,Time::now());
 }
 
 
 /************************************************************************/
 void ExchangeData::set_qd(const Vector &_qd)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_QD]);
-    qd=_qd;
+    data[EXCHANGE_QD].set(_qd,Time::now());
 }
 
 
 /************************************************************************/
 void ExchangeData::set_qd(const int i, const double val)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_QD]);
-    qd[i]=val;
+    data[EXCHANGE_QD].set(i,val,Time::now());
 }
 
 
 /************************************************************************/
 void ExchangeData::set_x(const Vector &_x)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_X]);
-    x=_x;
+    data[EXCHANGE_X].set(_x,Time::now());
 }
 
 
 /************************************************************************/
 void ExchangeData::set_x(const Vector &_x, const double stamp)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_X]);
-    x=_x;
-    x_stamp=stamp;
+    data[EXCHANGE_X].set(_x,stamp);
 }
 
 
 /************************************************************************/
 void ExchangeData::set_q(const Vector &_q)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_Q]);
-    q=_q;
+    data[EXCHANGE_Q].set(_q,Time::now());
 }
 
 
 /************************************************************************/
 void ExchangeData::set_torso(const Vector &_torso)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_TORSO]);
-    torso=_torso;
+    data[EXCHANGE_TORSO].set(_torso,Time::now());
 }
 
 
 /************************************************************************/
 void ExchangeData::set_v(const Vector &_v)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_V]);
-    v=_v;
+    data[EXCHANGE_V].set(_v,Time::now());
 }
 
 
 /************************************************************************/
 void ExchangeData::set_counterv(const Vector &_counterv)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_COUNTERV]);
-    counterv=_counterv;
+    data[EXCHANGE_COUNTERV].set(_counterv,Time::now());
 }
 
 
 /************************************************************************/
 void ExchangeData::set_fpFrame(const Matrix &_S)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_FPFRAME]);
-    S=_S;
+    data[EXCHANGE_FPFRAME].set(_S,Time::now());
 }
 
+
 /************************************************************************/
 Vector ExchangeData::get_xd()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_XD]);
-    Vector _xd=xd;
-    return _xd;
+    return data[EXCHANGE_XD].getVector();
 }
 
 
 /************************************************************************/
 Vector ExchangeData::get_qd()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_QD]);
-    Vector _qd=qd;
-    return _qd;
+    return data[EXCHANGE_QD].getVector();
 }
 
 
 /************************************************************************/
 Vector ExchangeData::get_x()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_X]);
-    Vector _x=x;
-    return _x;
+    return data[EXCHANGE_X].getVector();
 }
 
 
 /************************************************************************/
 Vector ExchangeData::get_x(double &stamp)
 {
-    lock_guard<mutex> lg(mtx[MUTEX_X]);
-    Vector _x=x;
-    stamp=x_stamp;
-    return _x;
+    return data[EXCHANGE_X].getVector(&stamp);
 }
 
 
 /************************************************************************/
 Vector ExchangeData::get_q()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_Q]);
-    Vector _q=q;
-    return _q;
+    return data[EXCHANGE_Q].getVector();
 }
 
 
 /************************************************************************/
 Vector ExchangeData::get_torso()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_TORSO]);
-    Vector _torso=torso;
-    return _torso;
+    return data[EXCHANGE_TORSO].getVector();
 }
 
 
 /************************************************************************/
 Vector ExchangeData::get_v()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_V]);
-    Vector _v=v;
-    return _v;
+    return data[EXCHANGE_V].getVector();
 }
 
 
 /************************************************************************/
 Vector ExchangeData::get_counterv()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_COUNTERV]);
-    Vector _counterv=counterv;
-    return _counterv;
+    return data[EXCHANGE_COUNTERV].getVector();
 }
 
 
 /************************************************************************/
 Matrix ExchangeData::get_fpFrame()
 {
-    lock_guard<mutex> lg(mtx[MUTEX_FPFRAME]);
-    Matrix _S=S;
-    return _S;
+    return data[EXCHANGE_FPFRAME].getMatrix();
 }
 
+
+/************************************************************************/
+double ExchangeData::get_stamp(const int32_t field) const
+{
+    return data[field].getStamp();
+}
+
+
+/************************************************************************/
+unsigned long ExchangeData::get_version(const int32_t field) const
+{
+    return data[field].getVersion();
+}
+
+
 /************************************************************************/
 std::pair<Vector,bool>  ExchangeData::get_gyro() {
     std::pair<Vector, bool> ret;
@@ -20,8 +20,10 @@
 #define LM_EVENTDISPATCHER__
 
 #include <list>
+#include <mutex>
 
 #include "iCub/learningMachine/IEventListener.h"
+#include "iCub/learningMachine/EventQueue.h"
 
 namespace iCub {
 namespace learningmachine {
@@ -34,6 +36,10 @@ namespace learningmachine {
  * a double dispatching mechanism that allows extension of both IEventListeners
  * and IEvents.
  *
+ * Each IEventListener is serviced by an EventQueue with a thread of its own,
+ * hence raising an event only copies it and the listeners cannot slow down
+ * the module that raises it.
+ *
  * \see iCub::learningmachine::IEventListener
  * \see iCub::learningmachine::IEvent
  *
@@ -44,9 +50,14 @@ namespace learningmachine {
 class EventDispatcher {
 private:
     /**
-     * The list of IEventListeners.
+     * The list of the queues of the IEventListeners.
      */
-    std::list<IEventListener*> listeners;
+    std::list<EventQueue*> queues;
+
+    /**
+     * Protects the list against changes while an event is raised.
+     */
+    mutable std::mutex mutex;
 
     /**
      * Constructor (empty).
@@ -90,9 +101,7 @@ public:
      * over responsibility of the pointer and its deconstruction.
      * @param  listener The IEventListener that is to be add.
      */
-    virtual void addListener(IEventListener* listener) {
-        this->listeners.push_back(listener);
-    }
+    virtual void addListener(IEventListener* listener);
 
     /**
      * Removes an IEventListener from the list.
@@ -122,6 +131,13 @@ public:
      */
     virtual IEventListener& getAt(int idx) const;
 
+    /**
+     * Returns the EventQueue of the IEventListener at a specified index.
+     * @return the EventQueue
+     * @param  idx The index of the IEventListener.
+     */
+    virtual EventQueue& getQueueAt(int idx);
+
     /**
      * Clears all the IEventListeners from the EventDispatcher.
      */
@@ -131,7 +147,8 @@ public:
      * Raises an IEvent, causing it to be dispatched to each registered
      * IEventListener. Note that a double dispatching mechanism is used to
      * determine the proper runtime types of both the IEvent and the
-     * IEventListener using dynamic binding.
+     * IEventListener using dynamic binding. The listeners receive a copy of
+     * the event from their own threads.
      * @param  event The IEvent instance that is to be raised.
      */
     virtual void raise(IEvent& event);
@@ -142,7 +159,8 @@ public:
      * @return the number of registered listeners
      */
     virtual int countListeners() const {
-        return this->listeners.size();
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return this->queues.size();
     }
 
     /**
@@ -151,7 +169,8 @@ public:
      * @return true if there are one of more registered IEventListeners.
      */
     virtual bool hasListeners() {
-        return (!this->listeners.empty());
+        std::lock_guard<std::mutex> lock(this->mutex);
+        return (!this->queues.empty());
     }
 
 };
@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+#ifndef LM_EVENTQUEUE__
+#define LM_EVENTQUEUE__
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+#include "iCub/learningMachine/IEvent.h"
+#include "iCub/learningMachine/IEventListener.h"
+
+namespace iCub {
+namespace learningmachine {
+
+
+/**
+ * The EventQueue delivers the events raised for one IEventListener from a
+ * thread of its own, so that a slow listener does not stall the module that
+ * raises the events. The events are copied in a bounded ring buffer, which is
+ * lock free between the raising threads and the delivering thread. What
+ * happens when the ring is full depends on the policy:
+ *  - drop: the new event is discarded;
+ *  - coalesce: only the latest event is kept, the ones which have not been
+ *    delivered yet are discarded;
+ *  - block: the raising thread waits for the listener, as if the events were
+ *    delivered synchronously.
+ *
+ * \see iCub::learningmachine::EventDispatcher
+ */
+
+class EventQueue {
+public:
+    /**
+     * The policies for a full queue.
+     */
+    enum Policy { DROP, COALESCE, BLOCK };
+
+    /**
+     * Default capacity of the ring buffer.
+     */
+    static const size_t DEFAULT_CAPACITY = 256;
+
+private:
+    /**
+     * The listener the events are delivered to.
+     */
+    IEventListener* listener;
+
+    /**
+     * The ring buffer.
+     */
+    std::vector<IEvent*> ring;
+
+    /**
+     * Index of the next event to deliver, only written by the delivering thread.
+     */
+    std::atomic<size_t> head;
+
+    /**
+     * Index of the next free slot, only written by the raising threads.
+     */
+    std::atomic<size_t> tail;
+
+    /**
+     * The latest event, for the coalesce policy.
+     */
+    std::atomic<IEvent*> latest;
+
+    /**
+     * The policy for a full queue.
+     */
+    std::atomic<int> policy;
+
+    /**
+     * Serializes the raising threads, which are usually just one.
+     */
+    std::mutex producer;
+
+    /**
+     * Lets the delivering thread sleep while the queue is empty.
+     */
+    std::mutex sleeper;
+    std::condition_variable wakeup;
+    std::atomic<bool> sleeping;
+
+    /**
+     * Tells the delivering thread to terminate.
+     */
+    std::atomic<bool> stop;
+
+    /**
+     * The delivering thread.
+     */
+    std::thread worker;
+
+    /**
+     * Statistics.
+     */
+    std::atomic<unsigned long> raised;
+    std::atomic<unsigned long> delivered;
+    std::atomic<unsigned long> dropped;
+    std::atomic<size_t> maxDepth;
+
+    /**
+     * The body of the delivering thread.
+     */
+    void run();
+
+    /**
+     * Delivers an event and deletes it.
+     *
+     * @return false if there was no event
+     */
+    bool deliver(IEvent* event);
+
+    /**
+     * Wakes up the delivering thread if it is sleeping.
+     */
+    void notify();
+
+    /**
+     * Copy Constructor (private and unimplemented on purpose).
+     */
+    EventQueue(const EventQueue& other);
+
+    /**
+     * Assignment operator (private and unimplemented on purpose).
+     */
+    EventQueue& operator=(const EventQueue& other);
+
+public:
+    /**
+     * Constructor, which starts the delivering thread.
+     *
+     * @param l the listener, which remains owned by the caller
+     * @param capacity the size of the ring buffer
+     */
+    EventQueue(IEventListener* l, size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Destructor, which delivers the pending events and stops the thread.
+     */
+    ~EventQueue();
+
+    /**
+     * Queues a copy of an event for the listener, if it is enabled.
+     *
+     * @param event the event
+     */
+    void push(const IEvent& event);
+
+    /**
+     * Returns the listener.
+     *
+     * @return the listener
+     */
+    IEventListener* getListener() const {
+        return this->listener;
+    }
+
+    /**
+     * Returns the policy for a full queue.
+     *
+     * @return the policy
+     */
+    Policy getPolicy() const {
+        return Policy(this->policy.load());
+    }
+
+    /**
+     * Sets the policy for a full queue.
+     *
+     * @param p the policy
+     */
+    void setPolicy(Policy p) {
+        this->policy.store(p);
+    }
+
+    /**
+     * Sets the policy for a full queue from its name.
+     *
+     * @param name drop, coalesce or block
+     * @return true if the name is known
+     */
+    bool setPolicy(const std::string& name);
+
+    /**
+     * Returns the number of events waiting to be delivered.
+     *
+     * @return the depth of the queue
+     */
+    size_t getDepth() const;
+
+    /**
+     * Returns a line with the policy and the statistics of the queue.
+     *
+     * @return the information on the queue
+     */
+    std::string getInfo() const;
+};
+
+} // learningmachine
+} // iCub
+
+#endif
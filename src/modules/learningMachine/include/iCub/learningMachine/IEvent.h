@@ -38,6 +38,11 @@ protected:
 
 
 public:
+    /**
+     * Destructor (empty).
+     */
+    virtual ~IEvent() { }
+
     /**
      * Returns a string representation of the Event.
      * @return string  the string representation
@@ -52,6 +57,13 @@ public:
      */
     virtual void visit(IEventListener& listener) = 0;
 
+    /**
+     * Returns a copy of the Event, so that it can be dispatched after the
+     * caller has moved on. Child classes _need_ to override this function.
+     * @return a copy on the heap, owned by the caller
+     */
+    virtual IEvent* clone() const = 0;
+
 };
 
 } // learningmachine
@@ -73,6 +73,13 @@ public:
      */
     virtual void visit(IEventListener& listener);
 
+    /*
+     * Inherited from IEvent.
+     */
+    virtual PredictEvent* clone() const {
+        return new PredictEvent(*this);
+    }
+
     /*
      * Inherited from IEvent.
      */
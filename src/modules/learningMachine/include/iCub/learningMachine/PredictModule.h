@@ -19,6 +19,8 @@
 #ifndef LM_PREDICTMODULE__
 #define LM_PREDICTMODULE__
 
+#include <yarp/sig/Matrix.h>
+
 #include "iCub/learningMachine/IMachineLearnerModule.h"
 #include "iCub/learningMachine/MachinePortable.h"
 
@@ -96,6 +98,31 @@ public:
 };
 
 
+/**
+ * Reply processor helper class for batches of predictions. A request is a
+ * matrix with one input on each row; the reply is a pair of matrices with the
+ * corresponding predictions and variances on their rows. The variances are
+ * empty for machines that do not provide them.
+ *
+ * \see iCub::learningmachine::PredictModule
+ * \see iCub::learningmachine::PredictProcessor
+ */
+class PredictBatchProcessor : public IMachineProcessor, public yarp::os::PortReader {
+public:
+    /**
+     * Constructor.
+     *
+     * @param mp a reference to a machine portable.
+     */
+    PredictBatchProcessor(MachinePortable& mp) : IMachineProcessor(mp) { }
+
+    /*
+     * Inherited from PortReader.
+     */
+    virtual bool read(yarp::os::ConnectionReader& connection);
+};
+
+
 /**
  * \ingroup icub_libLM_modules
  *
@@ -118,6 +145,12 @@ protected:
      */
     yarp::os::BufferedPort<yarp::sig::Vector> predict_inout;
 
+    /**
+     * Buffered port for the incoming batches of samples and corresponding
+     * replies.
+     */
+    yarp::os::BufferedPort<yarp::sig::Matrix> predictBatch_inout;
+
     /**
      * A concrete wrapper around a learning machine.
      */
@@ -128,6 +161,11 @@ protected:
      */
     PredictProcessor predictProcessor;
 
+    /**
+     * The processor handling batches of prediction requests.
+     */
+    PredictBatchProcessor predictBatchProcessor;
+
     /**
      * Incoming port for the models from the train module.
      */
@@ -166,7 +204,7 @@ public:
      */
     PredictModule(std::string pp = "/lm/predict")
       : IMachineLearnerModule(pp), machinePortable((IMachineLearner*) 0),
-        predictProcessor(machinePortable) { }
+        predictProcessor(machinePortable), predictBatchProcessor(machinePortable) { }
 
     /**
      * Destructor (empty).
@@ -78,6 +78,13 @@ public:
      */
     virtual void visit(IEventListener& listener);
 
+    /*
+     * Inherited from IEvent.
+     */
+    virtual TrainEvent* clone() const {
+        return new TrainEvent(*this);
+    }
+
     /*
      * Inherited from IEvent.
      */
@@ -19,6 +19,8 @@
 #ifndef LM_TRAINMODULE__
 #define LM_TRAINMODULE__
 
+#include <mutex>
+
 #include <yarp/os/PortablePair.h>
 
 #include "iCub/learningMachine/PredictModule.h"
@@ -29,7 +31,9 @@ namespace learningmachine {
 
 
 /**
- * Port processor helper class for incoming training samples.
+ * Port processor helper class for incoming training samples. Besides single
+ * samples, it accepts batches of samples as a pair of matrices with the inputs
+ * and the corresponding outputs on their rows.
  *
  * \see iCub::learningmachine::TrainModule
  * \see iCub::learningmachine::IMachineProcessor
@@ -37,13 +41,20 @@ namespace learningmachine {
  * \author Arjan Gijsberts
  *
  */
-class TrainProcessor : public IMachineProcessor, public yarp::os::TypedReaderCallback< yarp::os::PortablePair<yarp::sig::Vector,yarp::sig::Vector> > {
+class TrainProcessor : public IMachineProcessor,
+                       public yarp::os::TypedReaderCallback< yarp::os::PortablePair<yarp::sig::Vector,yarp::sig::Vector> >,
+                       public yarp::os::TypedReaderCallback< yarp::os::PortablePair<yarp::sig::Matrix,yarp::sig::Matrix> > {
 private:
     /**
      * Boolean switch to disable and enable the sample stream to the machine.
      */
     bool enabled;
 
+    /**
+     * Serializes the samples and batches, which arrive on different ports.
+     */
+    std::mutex mutex;
+
 public:
     /**
      * Constructor.
@@ -66,6 +77,11 @@ public:
      */
     virtual void onRead(yarp::os::PortablePair<yarp::sig::Vector,yarp::sig::Vector>& sample);
 
+    /*
+     * Inherited from TypedReaderCallback.
+     */
+    virtual void onRead(yarp::os::PortablePair<yarp::sig::Matrix,yarp::sig::Matrix>& batch);
+
 };
 
 
@@ -94,6 +110,11 @@ private:
      */
     yarp::os::BufferedPort< yarp::os::PortablePair<yarp::sig::Vector,yarp::sig::Vector> > train_in;
 
+    /**
+     * Buffered port for the incoming batches of training samples.
+     */
+    yarp::os::BufferedPort< yarp::os::PortablePair<yarp::sig::Matrix,yarp::sig::Matrix> > trainBatch_in;
+
     /**
      * Port for the outgoing models to the predict module.
      */
@@ -19,7 +19,10 @@
 #ifndef LM_TRANSFORMMODULE__
 #define LM_TRANSFORMMODULE__
 
+#include <mutex>
+
 #include <yarp/os/PortablePair.h>
+#include <yarp/sig/Matrix.h>
 
 #include "iCub/learningMachine/IMachineLearnerModule.h"
 #include "iCub/learningMachine/TransformerPortable.h"
@@ -117,7 +120,52 @@ public:
 
 
 /**
- * Port processor helper class for incoming training samples.
+ * Reply processor helper class for batches of predictions. This processor
+ * receives a matrix with one sample on each row, transforms all of them and
+ * relays the batch to the associated port. The reply contains the predictions
+ * and variances, one per row.
+ *
+ * \see iCub::learningmachine::TransformPredictProcessor
+ * \see iCub::learningmachine::PredictBatchProcessor
+ */
+class TransformPredictBatchProcessor : public ITransformProcessor, public yarp::os::PortReader {
+protected:
+    /**
+     * The relay port.
+     */
+    yarp::os::Port& predictRelay_inout;
+
+public:
+    /**
+     * Constructor.
+     *
+     * @param tp a reference to a transformer.
+     * @param p a reference to the relay port.
+     */
+    TransformPredictBatchProcessor(TransformerPortable& tp, yarp::os::Port& p)
+      : ITransformProcessor(tp), predictRelay_inout(p) { }
+
+    /*
+     * Inherited from PortReader.
+     */
+    virtual bool read(yarp::os::ConnectionReader& connection);
+
+    /**
+     * Accessor for the prediction output port.
+     *
+     * @return a reference to the output port.
+     */
+    virtual yarp::os::Port& getOutputPort() {
+        return this->predictRelay_inout;
+    }
+
+};
+
+
+/**
+ * Port processor helper class for incoming training samples. Batches of
+ * samples, as a pair of matrices with the inputs and the outputs on their
+ * rows, are relayed as batches.
  *
  * \see iCub::learningmachine::TrainModule
  * \see iCub::learningmachine::IMachineProcessor
@@ -126,28 +174,48 @@ public:
  *
  */
 class TransformTrainProcessor
-  : public ITransformProcessor, public yarp::os::TypedReaderCallback< yarp::os::PortablePair<yarp::sig::Vector,yarp::sig::Vector> > {
+  : public ITransformProcessor,
+    public yarp::os::TypedReaderCallback< yarp::os::PortablePair<yarp::sig::Vector,yarp::sig::Vector> >,
+    public yarp::os::TypedReaderCallback< yarp::os::PortablePair<yarp::sig::Matrix,yarp::sig::Matrix> > {
 private:
     /**
      * The relay port.
      */
     yarp::os::BufferedPort<yarp::os::PortablePair<yarp::sig::Vector,yarp::sig::Vector> >& train_out;
 
+    /**
+     * The relay port for the batches.
+     */
+    yarp::os::BufferedPort<yarp::os::PortablePair<yarp::sig::Matrix,yarp::sig::Matrix> >& trainBatch_out;
+
+    /**
+     * Serializes the samples and batches, which arrive on different ports.
+     */
+    std::mutex mutex;
+
 public:
     /**
      * Constructor.
      *
      * @param tp a reference to a transformer.
+     * @param p a reference to the relay port.
+     * @param bp a reference to the relay port for the batches.
      */
     TransformTrainProcessor(TransformerPortable& tp,
-                            yarp::os::BufferedPort< yarp::os::PortablePair<yarp::sig::Vector,yarp::sig::Vector> >& p)
-      : ITransformProcessor(tp), train_out(p) { }
+                            yarp::os::BufferedPort< yarp::os::PortablePair<yarp::sig::Vector,yarp::sig::Vector> >& p,
+                            yarp::os::BufferedPort< yarp::os::PortablePair<yarp::sig::Matrix,yarp::sig::Matrix> >& bp)
+      : ITransformProcessor(tp), train_out(p), trainBatch_out(bp) { }
 
     /*
      * Inherited from TypedReaderCallback.
      */
     virtual void onRead(yarp::os::PortablePair<yarp::sig::Vector,yarp::sig::Vector>& input);
 
+    /*
+     * Inherited from TypedReaderCallback.
+     */
+    virtual void onRead(yarp::os::PortablePair<yarp::sig::Matrix,yarp::sig::Matrix>& input);
+
     /**
      * Retrieve the training output port.
      *
@@ -157,6 +225,15 @@ public:
         return this->train_out;
     }
 
+    /**
+     * Retrieve the output port for the batches of training samples.
+     *
+     * @return a reference to the output port.
+     */
+    virtual yarp::os::BufferedPort<yarp::os::PortablePair<yarp::sig::Matrix,yarp::sig::Matrix> >& getBatchOutputPort() {
+        return this->trainBatch_out;
+    }
+
 };
 
 
@@ -200,6 +277,26 @@ private:
      */
     yarp::os::Port predictRelay_inout;
 
+    /**
+     * Buffered port for the incoming batches of training samples.
+     */
+    yarp::os::BufferedPort<yarp::os::PortablePair<yarp::sig::Matrix,yarp::sig::Matrix> > trainBatch_in;
+
+    /**
+     * Buffered port for the outgoing batches of training samples.
+     */
+    yarp::os::BufferedPort<yarp::os::PortablePair<yarp::sig::Matrix,yarp::sig::Matrix> > trainBatch_out;
+
+    /**
+     * Buffered port for the incoming batches of prediction samples.
+     */
+    yarp::os::BufferedPort<yarp::sig::Matrix> predictBatch_inout;
+
+    /**
+     * Port for the outgoing batches of prediction samples.
+     */
+    yarp::os::Port predictBatchRelay_inout;
+
     /**
      * The processor handling incoming training samples.
      */
@@ -210,6 +307,11 @@ private:
      */
     TransformPredictProcessor predictProcessor;
 
+    /**
+     * The processor handling batches of prediction requests.
+     */
+    TransformPredictBatchProcessor predictBatchProcessor;
+
     /**
      * Copy constructor (private and unimplemented on purpose).
      */
@@ -248,8 +350,9 @@ public:
      */
     TransformModule(std::string pp = "/lm/transform")
       : IMachineLearnerModule(pp), transformerPortable((ITransformer*) 0),
-        trainProcessor(transformerPortable, train_out),
-        predictProcessor(transformerPortable, predictRelay_inout) {
+        trainProcessor(transformerPortable, train_out, trainBatch_out),
+        predictProcessor(transformerPortable, predictRelay_inout),
+        predictBatchProcessor(transformerPortable, predictBatchRelay_inout) {
     }
 
     /**
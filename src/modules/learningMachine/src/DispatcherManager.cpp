@@ -49,6 +49,7 @@ bool DispatcherManager::respond(const yarp::os::Bottle& cmd, yarp::os::Bottle& r
                 reply.addString("  add type [type2 ...]  Adds one or more event listeners");
                 reply.addString("  remove [all|idx]      Removes event listener at an index or all");
                 reply.addString("  set [all|idx]         Configures a listener");
+                reply.addString("  policy [all|idx] p    Policy for a full queue (drop|coalesce|block)");
                 reply.addString("  stats                 Prints information");
                 success = true;
                 break;
@@ -126,6 +127,28 @@ bool DispatcherManager::respond(const yarp::os::Bottle& cmd, yarp::os::Bottle& r
                 break;
                 }
 
+            case yarp::os::createVocab32('p','o','l','i'): // policy
+                { // prevent identifier initialization to cross borders of case
+                std::string policy = cmd.get(2).asString();
+                if(cmd.get(1).isInt32() && cmd.get(1).asInt32() >= 1 &&
+                   cmd.get(1).asInt32() <= this->dispatcher->countListeners()) {
+                    if(!this->dispatcher->getQueueAt(cmd.get(1).asInt32()-1).setPolicy(policy)) {
+                        throw std::runtime_error("Unknown policy!");
+                    }
+                } else if(cmd.get(1).asString() == "all") {
+                    for(int i = 0; i < this->dispatcher->countListeners(); i++) {
+                        if(!this->dispatcher->getQueueAt(i).setPolicy(policy)) {
+                            throw std::runtime_error("Unknown policy!");
+                        }
+                    }
+                } else {
+                    throw std::runtime_error("Illegal index!");
+                }
+                reply.addString("Successfully set policy.");
+                success = true;
+                break;
+                }
+
             case yarp::os::createVocab32('i','n','f','o'): // information
             case yarp::os::createVocab32('s','t','a','t'): // statistics
                 { // prevent identifier initialization to cross borders of case
@@ -135,7 +158,8 @@ bool DispatcherManager::respond(const yarp::os::Bottle& cmd, yarp::os::Bottle& r
                 reply.addString(buffer.str().c_str());
                 for(int i = 0; i < this->dispatcher->countListeners(); i++) {
                     buffer.str(""); // why isn't there a proper reset method?
-                    buffer << "  [" << (i + 1) << "] " << this->dispatcher->getAt(i).getInfo();
+                    buffer << "  [" << (i + 1) << "] " << this->dispatcher->getAt(i).getInfo()
+                           << " " << this->dispatcher->getQueueAt(i).getInfo();
                     reply.addString(buffer.str().c_str());
                 }
 
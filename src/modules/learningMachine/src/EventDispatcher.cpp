@@ -48,27 +48,59 @@ EventDispatcher::~EventDispatcher() {
     this->clear();
 }
 
+void EventDispatcher::addListener(IEventListener* listener) {
+    EventQueue* queue = new EventQueue(listener);
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->queues.push_back(queue);
+}
+
 void EventDispatcher::removeListener(int idx) {
-    assert(idx >= 0 && idx < int(this->listeners.size()));
-    std::list<IEventListener*>::iterator it = this->listeners.begin();
-    std::advance(it, idx);
-    delete *it;
-    this->listeners.erase(it);
+    EventQueue* queue;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        assert(idx >= 0 && idx < int(this->queues.size()));
+        std::list<EventQueue*>::iterator it = this->queues.begin();
+        std::advance(it, idx);
+        queue = *it;
+        this->queues.erase(it);
+    }
+    // the pending events are delivered before the listener is deleted
+    IEventListener* listener = queue->getListener();
+    delete queue;
+    delete listener;
 }
 
 void EventDispatcher::removeListener(IEventListener* listener) {
-    this->listeners.remove(listener);
+    EventQueue* queue = (EventQueue*) 0;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        std::list<EventQueue*>::iterator it;
+        for(it = this->queues.begin(); it != this->queues.end(); it++) {
+            if((*it)->getListener() == listener) {
+                queue = *it;
+                this->queues.erase(it);
+                break;
+            }
+        }
+    }
+    delete queue;
     //delete listener;
 }
 
 IEventListener& EventDispatcher::getAt(int idx) {
-    std::list<IEventListener*>::iterator it = this->listeners.begin();
-    std::advance(it, idx);
-    return **it;
+    return *(this->getQueueAt(idx).getListener());
 }
 
 IEventListener& EventDispatcher::getAt(int idx) const {
-    std::list<IEventListener*>::const_iterator it = this->listeners.begin();
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::list<EventQueue*>::const_iterator it = this->queues.begin();
+    std::advance(it, idx);
+    return *((*it)->getListener());
+}
+
+EventQueue& EventDispatcher::getQueueAt(int idx) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::list<EventQueue*>::iterator it = this->queues.begin();
     std::advance(it, idx);
     return **it;
 }
@@ -81,11 +113,10 @@ void EventDispatcher::clear() {
 }
 
 void EventDispatcher::raise(IEvent& event) {
-    std::list<IEventListener*>::iterator it;
-    for(it = listeners.begin(); it != listeners.end(); it++) {
-        if((*it)->isEnabled()) {
-            event.visit(**it);
-        }
+    std::lock_guard<std::mutex> lock(this->mutex);
+    std::list<EventQueue*>::iterator it;
+    for(it = this->queues.begin(); it != this->queues.end(); it++) {
+        (*it)->push(event);
     }
 }
 
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+ */
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <chrono>
+
+#include "iCub/learningMachine/EventQueue.h"
+
+namespace iCub {
+namespace learningmachine {
+
+EventQueue::EventQueue(IEventListener* l, size_t capacity)
+  : listener(l), ring(capacity > 0 ? capacity : 1, (IEvent*) 0), head(0), tail(0),
+    latest((IEvent*) 0), policy(DROP), sleeping(false), stop(false),
+    raised(0), delivered(0), dropped(0), maxDepth(0) {
+    this->worker = std::thread(&EventQueue::run, this);
+}
+
+EventQueue::~EventQueue() {
+    this->stop.store(true);
+    {
+        std::lock_guard<std::mutex> lock(this->sleeper);
+        this->wakeup.notify_one();
+    }
+    this->worker.join();
+}
+
+bool EventQueue::setPolicy(const std::string& name) {
+    if(name == "drop") {
+        this->setPolicy(DROP);
+    } else if(name == "coalesce") {
+        this->setPolicy(COALESCE);
+    } else if(name == "block") {
+        this->setPolicy(BLOCK);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+size_t EventQueue::getDepth() const {
+    return this->tail.load() - this->head.load() + (this->latest.load() != (IEvent*) 0 ? 1 : 0);
+}
+
+void EventQueue::notify() {
+    if(this->sleeping.exchange(false)) {
+        std::lock_guard<std::mutex> lock(this->sleeper);
+        this->wakeup.notify_one();
+    }
+}
+
+void EventQueue::push(const IEvent& event) {
+    if(!this->listener->isEnabled()) {
+        return;
+    }
+    this->raised++;
+
+    if(this->getPolicy() == COALESCE) {
+        // the delivering thread takes the latest event with an exchange, hence
+        // whatever is replaced here has not been delivered
+        IEvent* old = this->latest.exchange(event.clone());
+        if(old != (IEvent*) 0) {
+            delete old;
+            this->dropped++;
+        }
+        this->notify();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(this->producer);
+    size_t t = this->tail.load(std::memory_order_relaxed);
+    while(t - this->head.load(std::memory_order_acquire) >= this->ring.size()) {
+        if(this->getPolicy() != BLOCK || this->stop.load()) {
+            this->dropped++;
+            return;
+        }
+        this->notify();
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    this->ring[t % this->ring.size()] = event.clone();
+    this->tail.store(t + 1, std::memory_order_release);
+    lock.unlock();
+
+    size_t depth = t + 1 - this->head.load(std::memory_order_relaxed);
+    size_t max = this->maxDepth.load(std::memory_order_relaxed);
+    while(depth > max && !this->maxDepth.compare_exchange_weak(max, depth)) { }
+    this->notify();
+}
+
+bool EventQueue::deliver(IEvent* event) {
+    if(event == (IEvent*) 0) {
+        return false;
+    }
+    try {
+        event->visit(*this->listener);
+    } catch(const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+    }
+    delete event;
+    this->delivered++;
+    return true;
+}
+
+void EventQueue::run() {
+    for(;;) {
+        bool busy = false;
+
+        size_t h = this->head.load(std::memory_order_relaxed);
+        if(h != this->tail.load(std::memory_order_acquire)) {
+            IEvent* event = this->ring[h % this->ring.size()];
+            this->head.store(h + 1, std::memory_order_release);
+            busy = this->deliver(event);
+        }
+        busy = this->deliver(this->latest.exchange((IEvent*) 0)) || busy;
+
+        if(!busy) {
+            // the pending events are delivered before terminating
+            if(this->stop.load()) {
+                break;
+            }
+            std::unique_lock<std::mutex> lock(this->sleeper);
+            this->sleeping.store(true);
+            if(this->head.load() == this->tail.load() && this->latest.load() == (IEvent*) 0 && !this->stop.load()) {
+                // the timeout only covers a wakeup that raced with going to sleep
+                this->wakeup.wait_for(lock, std::chrono::milliseconds(10));
+            }
+            this->sleeping.store(false);
+        }
+    }
+}
+
+std::string EventQueue::getInfo() const {
+    static const char* names[] = { "drop", "coalesce", "block" };
+    std::ostringstream buffer;
+    buffer << "[queue: " << names[this->getPolicy()] << ", depth " << this->getDepth()
+           << "/" << this->ring.size() << " (max " << this->maxDepth.load() << "), raised "
+           << this->raised.load() << ", delivered " << this->delivered.load()
+           << ", dropped " << this->dropped.load() << "]";
+    return buffer.str();
+}
+
+} // learningmachine
+} // iCub
@@ -22,6 +22,7 @@
 
 #include <yarp/os/Network.h>
 #include <yarp/os/Vocab.h>
+#include <yarp/os/PortablePair.h>
 
 #include "iCub/learningMachine/Prediction.h"
 #include "iCub/learningMachine/PredictModule.h"
@@ -63,6 +64,44 @@ bool PredictProcessor::read(yarp::os::ConnectionReader& connection) {
     return true;
 }
 
+bool PredictBatchProcessor::read(yarp::os::ConnectionReader& connection) {
+    if(!this->getMachinePortable().hasWrapped()) {
+        return false;
+    }
+
+    yarp::sig::Matrix inputs;
+    yarp::os::PortablePair<yarp::sig::Matrix,yarp::sig::Matrix> predictions;
+    bool ok = inputs.read(connection);
+    if(!ok) {
+        return false;
+    }
+    try {
+        this->getMachine().predictSamples(inputs, predictions.head, predictions.body);
+
+        // Event Code
+        if(EventDispatcher::instance().hasListeners()) {
+            for(size_t r = 0; r < inputs.rows(); r++) {
+                Prediction prediction(predictions.head.getRow(r));
+                if(predictions.body.rows() > 0) {
+                    prediction.setVariance(predictions.body.getRow(r));
+                }
+                PredictEvent pe(inputs.getRow(r), prediction);
+                EventDispatcher::instance().raise(pe);
+            }
+        }
+        // Event Code
+    } catch(const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return false;
+    }
+
+    yarp::os::ConnectionWriter* replier = connection.getWriter();
+    if(replier != (yarp::os::ConnectionWriter*) 0) {
+        predictions.write(*replier);
+    }
+    return true;
+}
+
 
 void PredictModule::printOptions(std::string error) {
     if(error != "") {
@@ -80,6 +119,8 @@ void PredictModule::registerAllPorts() {
     this->registerPort(this->model_in, this->portPrefix + "/model:i");
     this->registerPort(this->predict_inout, this->portPrefix + "/predict:io");
     this->predict_inout.setStrict();
+    this->registerPort(this->predictBatch_inout, this->portPrefix + "/predict_batch:io");
+    this->predictBatch_inout.setStrict();
     this->registerPort(this->cmd_in, this->portPrefix + "/cmd:i");
 }
 
@@ -87,11 +128,13 @@ void PredictModule::unregisterAllPorts() {
     this->model_in.close();
     this->cmd_in.close();
     this->predict_inout.close();
+    this->predictBatch_inout.close();
 }
 
 bool PredictModule::interruptModule() {
     this->cmd_in.interrupt();
     this->predict_inout.interrupt();
+    this->predictBatch_inout.interrupt();
     this->model_in.interrupt();
     return true;
 }
@@ -133,6 +176,7 @@ bool PredictModule::configure(yarp::os::ResourceFinder& opt) {
 
     // add replier for incoming data (prediction requests)
     this->predict_inout.setReplier(this->predictProcessor);
+    this->predictBatch_inout.setReplier(this->predictBatchProcessor);
 
     // and finally load command file
     if(opt.check("commands", val)) {
@@ -31,6 +31,7 @@ namespace learningmachine {
 
 void TrainProcessor::onRead(yarp::os::PortablePair<yarp::sig::Vector,yarp::sig::Vector>& sample) {
     if(this->getMachinePortable().hasWrapped() && this->enabled) {
+        std::lock_guard<std::mutex> lock(this->mutex);
         try {
             // Event Code
             if(EventDispatcher::instance().hasListeners()) {
@@ -50,6 +51,36 @@ void TrainProcessor::onRead(yarp::os::PortablePair<yarp::sig::Vector,yarp::sig::
     return;
 }
 
+void TrainProcessor::onRead(yarp::os::PortablePair<yarp::sig::Matrix,yarp::sig::Matrix>& batch) {
+    if(this->getMachinePortable().hasWrapped() && this->enabled) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        try {
+            // Event Code
+            if(EventDispatcher::instance().hasListeners()) {
+                yarp::sig::Matrix predictions;
+                yarp::sig::Matrix variances;
+                this->getMachine().predictSamples(batch.head, predictions, variances);
+                for(size_t r = 0; r < batch.head.rows(); r++) {
+                    Prediction prediction(predictions.getRow(r));
+                    if(variances.rows() > 0) {
+                        prediction.setVariance(variances.getRow(r));
+                    }
+                    TrainEvent te(batch.head.getRow(r), batch.body.getRow(r), prediction);
+                    EventDispatcher::instance().raise(te);
+                }
+            }
+            // Event Code
+
+            this->getMachine().feedSamples(batch.head, batch.body);
+
+        } catch(const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+        }
+    }
+
+    return;
+}
+
 
 void TrainModule::printOptions(std::string error) {
     if(error != "") {
@@ -79,22 +110,28 @@ void TrainModule::registerAllPorts() {
     //this->registerPort(this->model_in, "/" + this->portPrefix + "/model:i");
     this->registerPort(this->predict_inout, this->portPrefix + "/predict:io");
     this->predict_inout.setStrict();
+    this->registerPort(this->predictBatch_inout, this->portPrefix + "/predict_batch:io");
+    this->predictBatch_inout.setStrict();
     this->registerPort(this->cmd_in, this->portPrefix + "/cmd:i");
 
     this->registerPort(this->model_out, this->portPrefix + "/model:o");
     this->registerPort(this->train_in, this->portPrefix + "/train:i");
     this->train_in.setStrict();
+    this->registerPort(this->trainBatch_in, this->portPrefix + "/train_batch:i");
+    this->trainBatch_in.setStrict();
 }
 
 void TrainModule::unregisterAllPorts() {
     PredictModule::unregisterAllPorts();
     this->train_in.close();
+    this->trainBatch_in.close();
     this->model_out.close();
 }
 
 bool TrainModule::interruptModule() {
     PredictModule::interruptModule();
     train_in.interrupt();
+    trainBatch_in.interrupt();
     return true;
 }
 
@@ -151,9 +188,11 @@ bool TrainModule::configure(yarp::os::ResourceFinder& opt) {
 
     // add replier for incoming data (prediction requests)
     this->predict_inout.setReplier(this->predictProcessor);
+    this->predictBatch_inout.setReplier(this->predictBatchProcessor);
 
     // add processor for incoming data (training samples)
     this->train_in.useCallback(trainProcessor);
+    this->trainBatch_in.useCallback(trainProcessor);
 
     // register ports before connecting
     this->registerAllPorts();
@@ -191,7 +230,7 @@ bool TrainModule::respond(const yarp::os::Bottle& cmd, yarp::os::Bottle& reply)
                 reply.addString("  continue              Enable passing the samples to the machine");
                 reply.addString("  set key val           Sets a configuration option for the machine");
                 reply.addString("  load fname            Loads a machine from a file");
-                reply.addString("  save fname            Saves the current machine to a file");
+                reply.addString("  save fname [text]     Saves the current machine to a file (binary by default)");
                 reply.addString("  event [cmd ...]       Sends commands to event dispatcher (see: event help)");
                 reply.addString("  cmd fname             Loads commands from a file");
                 reply.addString(this->getMachine().getConfigHelp().c_str());
@@ -265,7 +304,8 @@ bool TrainModule::respond(const yarp::os::Bottle& cmd, yarp::os::Bottle& reply)
                 if(!cmd.get(1).isString()) {
                     replymsg += "failed";
                 } else {
-                    this->getMachinePortable().writeToFile(cmd.get(1).asString().c_str());
+                    bool binary = !(cmd.size() > 2 && cmd.get(2).asString() == "text");
+                    this->getMachinePortable().writeToFile(cmd.get(1).asString().c_str(), binary);
                     replymsg += "succeeded";
                 }
                 reply.addString(replymsg.c_str());
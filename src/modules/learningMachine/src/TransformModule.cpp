@@ -57,8 +57,38 @@ bool TransformPredictProcessor::read(yarp::os::ConnectionReader& connection) {
 }
 
 
+bool TransformPredictBatchProcessor::read(yarp::os::ConnectionReader& connection) {
+    if(!this->getTransformerPortable().hasWrapped()) {
+        return false;
+    }
+
+    yarp::sig::Matrix input;
+    yarp::os::PortablePair<yarp::sig::Matrix,yarp::sig::Matrix> predictions;
+    bool ok = input.read(connection);
+    if(!ok) {
+        return false;
+    }
+
+    try {
+        yarp::sig::Matrix trans_input = this->getTransformer().transform(input);
+        this->getOutputPort().write(trans_input, predictions);
+    } catch(const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return false;
+    }
+
+    yarp::os::ConnectionWriter* replier = connection.getWriter();
+    if(replier != (yarp::os::ConnectionWriter*) 0) {
+        predictions.write(*replier);
+    }
+
+    return true;
+}
+
+
 void TransformTrainProcessor::onRead(yarp::os::PortablePair<yarp::sig::Vector,yarp::sig::Vector>& input) {
     if(this->getTransformerPortable().hasWrapped()) {
+        std::lock_guard<std::mutex> lock(this->mutex);
         try {
             yarp::os::PortablePair<yarp::sig::Vector,yarp::sig::Vector>& output = this->getOutputPort().prepare();
             output.head = this->getTransformer().transform(input.head);
@@ -72,6 +102,22 @@ void TransformTrainProcessor::onRead(yarp::os::PortablePair<yarp::sig::Vector,ya
     return;
 }
 
+void TransformTrainProcessor::onRead(yarp::os::PortablePair<yarp::sig::Matrix,yarp::sig::Matrix>& input) {
+    if(this->getTransformerPortable().hasWrapped()) {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        try {
+            yarp::os::PortablePair<yarp::sig::Matrix,yarp::sig::Matrix>& output = this->getBatchOutputPort().prepare();
+            output.head = this->getTransformer().transform(input.head);
+            output.body = input.body;
+            this->getBatchOutputPort().writeStrict();
+        } catch(const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+        }
+    }
+
+    return;
+}
+
 
 void TransformModule::printOptions(std::string error) {
     if(error != "") {
@@ -84,6 +130,8 @@ void TransformModule::printOptions(std::string error) {
     std::cout << "--transformer type     Desired type of transformer" << std::endl;
     std::cout << "--trainport port       Data port for the training samples" << std::endl;
     std::cout << "--predictport port     Data port for the prediction samples" << std::endl;
+    std::cout << "--trainbatchport port  Data port for the batches of training samples" << std::endl;
+    std::cout << "--predictbatchport port Data port for the batches of prediction samples" << std::endl;
     std::cout << "--port pfx             Prefix for registering the ports" << std::endl;
     std::cout << "--commands file        Load configuration commands from a file" << std::endl;
 }
@@ -111,6 +159,17 @@ void TransformModule::registerAllPorts() {
     this->registerPort(this->predictRelay_inout, this->portPrefix + "/predict_relay:io");
     //this->predict_relay_inout.setStrict();
 
+    this->registerPort(this->trainBatch_in, this->portPrefix + "/train_batch:i");
+    this->trainBatch_in.setStrict();
+
+    this->registerPort(this->trainBatch_out, this->portPrefix + "/train_batch:o");
+    this->trainBatch_out.setStrict();
+
+    this->registerPort(this->predictBatch_inout, this->portPrefix + "/predict_batch:io");
+    this->predictBatch_inout.setStrict();
+
+    this->registerPort(this->predictBatchRelay_inout, this->portPrefix + "/predict_batch_relay:io");
+
     this->registerPort(this->cmd_in, this->portPrefix + "/cmd:i");
 }
 
@@ -120,6 +179,10 @@ void TransformModule::unregisterAllPorts() {
     this->train_out.close();
     this->predict_inout.close();
     this->predictRelay_inout.close();
+    this->trainBatch_in.close();
+    this->trainBatch_out.close();
+    this->predictBatch_inout.close();
+    this->predictBatchRelay_inout.close();
 }
 
 bool TransformModule::interruptModule() {
@@ -128,6 +191,10 @@ bool TransformModule::interruptModule() {
     train_out.interrupt();
     predict_inout.interrupt();
     predictRelay_inout.interrupt();
+    trainBatch_in.interrupt();
+    trainBatch_out.interrupt();
+    predictBatch_inout.interrupt();
+    predictBatchRelay_inout.interrupt();
     return true;
 }
 
@@ -176,9 +243,11 @@ bool TransformModule::configure(yarp::os::ResourceFinder& opt) {
 
     // add processor for incoming data (training samples)
     this->train_in.useCallback(trainProcessor);
+    this->trainBatch_in.useCallback(trainProcessor);
 
     // add replier for incoming data (prediction requests)
     this->predict_inout.setReplier(this->predictProcessor);
+    this->predictBatch_inout.setReplier(this->predictBatchProcessor);
 
     // register ports
     this->registerAllPorts();
@@ -199,6 +268,16 @@ bool TransformModule::configure(yarp::os::ResourceFinder& opt) {
         // add message here if necessary
     }
 
+    // check for the ports of the batches
+    if(opt.check("trainbatchport", val)) {
+        yarp::os::Network::connect(this->trainBatch_out.where().getName().c_str(),
+                         val->asString().c_str());
+    }
+    if(opt.check("predictbatchport", val)) {
+        yarp::os::Network::connect(this->predictBatchRelay_inout.where().getName().c_str(),
+                         val->asString().c_str());
+    }
+
     // and finally load command file
     if(opt.check("commands", val)) {
         std::string full_fname = this->findFile(val->asString().c_str());
@@ -228,7 +307,7 @@ bool TransformModule::respond(const yarp::os::Bottle& cmd, yarp::os::Bottle& rep
                 reply.addString("  reset                 Resets the machine to its current state");
                 reply.addString("  info                  Outputs information about the transformer");
                 reply.addString("  load fname            Loads a transformer from a file");
-                reply.addString("  save fname            Saves the current transformer to a file");
+                reply.addString("  save fname [text]     Saves the current transformer to a file (binary by default)");
                 reply.addString("  set key val           Sets a configuration option for the transformer");
                 reply.addString("  cmd fname             Loads commands from a file");
                 reply.addString(this->getTransformer().getConfigHelp().c_str());
@@ -297,7 +376,8 @@ bool TransformModule::respond(const yarp::os::Bottle& cmd, yarp::os::Bottle& rep
                 if(!cmd.get(1).isString()) {
                     replymsg += "failed";
                 } else {
-                    this->getTransformerPortable().writeToFile(cmd.get(1).asString().c_str());
+                    bool binary = !(cmd.size() > 2 && cmd.get(2).asString() == "text");
+                    this->getTransformerPortable().writeToFile(cmd.get(1).asString().c_str(), binary);
                     replymsg += "succeeded";
                 }
                 reply.addString(replymsg.c_str());
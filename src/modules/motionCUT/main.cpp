@@ -35,6 +35,9 @@
 #define NODE_OFF    Scalar(0,0,255)
 #define NODE_ON     Scalar(0,255,0)
 
+// minimum number of nodes tracked by one worker
+#define MIN_NODES_PER_STRIPE    64
+
 using namespace std;
 using namespace cv;
 using namespace yarp::os;
@@ -77,13 +80,16 @@ protected:
     int blobMinSizeThres;
     int framesPersistence;
     int cropSize;
+    int numThreads;
+    int fullScanPeriod;
+    int fullScanCnt;
     bool verbosity;
     bool inhibition;
     int nodesX;
     int nodesY;
+    int pyrWinSize;
 
     ImageOf<PixelMono> imgMonoIn;
-    ImageOf<PixelMono> imgMonoPrev;
     vector<Mat>        pyrPrev;
     vector<Mat>        pyrCurr;
 
@@ -92,6 +98,8 @@ protected:
     vector<uchar>      featuresFound;
     vector<float>      featuresErrors;
     vector<int>        nodesPersistence;
+    vector<uchar>      nodesMoving;
+    vector<int>        nodesTracked;
 
     set<int>           activeNodesIndexSet;
     deque<Blob>        blobSortedList;
@@ -119,6 +127,8 @@ public:
         adjNodesThres=rf.check("adjNodesThres",Value(4)).asInt32();
         blobMinSizeThres=rf.check("blobMinSizeThres",Value(10)).asInt32();
         framesPersistence=rf.check("framesPersistence",Value(3)).asInt32();
+        numThreads=std::max(rf.check("numThreads",Value(1)).asInt32(),1);
+        fullScanPeriod=std::max(rf.check("fullScanPeriod",Value(0)).asInt32(),0);
         verbosity=rf.check("verbosity");
 
         cropSize=0;
@@ -169,15 +179,93 @@ public:
                 yInfo("cropSize          = %d",cropSize);
             else
                 yInfo("cropSize          = auto");
+            yInfo("numThreads        = %d",numThreads);
+            yInfo("fullScanPeriod    = %d",fullScanPeriod);
             yInfo("verbosity         = %s",verbosity?"on":"off");
         }
         else
             yError("Process did not start");
     }
 
+    /************************************************************************/
+    void selectNodes()
+    {
+        nodesTracked.clear();
+
+        // scan the whole grid periodically, so that new
+        // movements in still regions get detected too
+        if ((fullScanPeriod==0) || (--fullScanCnt<=0))
+        {
+            fullScanCnt=fullScanPeriod;
+            for (int i=0; i<(int)nodesPrev.size(); i++)
+                nodesTracked.push_back(i);
+            return;
+        }
+
+        // retrack only the nodes in the neighbourhood
+        // of those that moved in the previous frame
+        for (int i=0; i<(int)nodesPrev.size(); i++)
+        {
+            int row=i/nodesX;
+            int col=i%nodesX;
+            bool moving=false;
+
+            for (int y=std::max(row-1,0); (y<=std::min(row+1,nodesY-1)) && !moving; y++)
+                for (int x=std::max(col-1,0); (x<=std::min(col+1,nodesX-1)) && !moving; x++)
+                    moving=(nodesMoving[y*nodesX+x]!=0);
+
+            if (moving)
+                nodesTracked.push_back(i);
+            else
+            {
+                featuresFound[i]=0;
+                featuresErrors[i]=0.0f;
+            }
+        }
+    }
+
+    /************************************************************************/
+    void trackNodes(const Size &ws, const int maxLevel)
+    {
+        int n=(int)nodesTracked.size();
+        if (n==0)
+            return;
+
+        // each worker tracks its own slice of the selected nodes
+        int stripes=std::max(1,std::min(numThreads,n/MIN_NODES_PER_STRIPE));
+        parallel_for_(Range(0,stripes),[&](const Range &r)
+        {
+            vector<Point2f> prev,curr;
+            vector<uchar> found;
+            vector<float> err;
+
+            for (int s=r.start; s<r.end; s++)
+            {
+                int i0=(n*s)/stripes;
+                int i1=(n*(s+1))/stripes;
+
+                prev.clear();
+                for (int i=i0; i<i1; i++)
+                    prev.push_back(nodesPrev[nodesTracked[i]]);
+
+                calcOpticalFlowPyrLK(pyrPrev,pyrCurr,prev,curr,found,err,ws,maxLevel,
+                                     TermCriteria(TermCriteria::COUNT+TermCriteria::EPS,30,0.3));
+
+                for (int i=i0; i<i1; i++)
+                {
+                    int j=nodesTracked[i];
+                    nodesCurr[j]=curr[i-i0];
+                    featuresFound[j]=found[i-i0];
+                    featuresErrors[j]=err[i-i0];
+                }
+            }
+        },stripes);
+    }
+
     /************************************************************************/
     void run()
     {
+        constexpr int maxLevel=5;
         double latch_t, dt0, dt1, dt2;
 
         while (!isStopping())
@@ -195,12 +283,11 @@ public:
 
             // consistency check
             if (firstConsistencyCheck || (pImgBgrIn->width()!=imgMonoIn.width()) ||
-                (pImgBgrIn->height()!=imgMonoIn.height()))
+                (pImgBgrIn->height()!=imgMonoIn.height()) || (winSize!=pyrWinSize))
             {
                 firstConsistencyCheck=false;
 
                 imgMonoIn.resize(*pImgBgrIn);
-                imgMonoPrev.resize(*pImgBgrIn);
 
                 int min_x=(int)(((1.0-coverXratio)/2.0)*imgMonoIn.width());
                 int min_y=(int)(((1.0-coverYratio)/2.0)*imgMonoIn.height());
@@ -214,6 +301,8 @@ public:
                 featuresFound.assign(nodesNum,0);
                 featuresErrors.assign(nodesNum,0.0f);
                 nodesPersistence.assign(nodesNum,0);
+                nodesMoving.assign(nodesNum,0);
+                fullScanCnt=0;
 
                 // populate grid
                 size_t cnt=0;
@@ -221,8 +310,11 @@ public:
                     for (int x=min_x; x<=(imgMonoIn.width()-min_x); x+=nodesStep)
                         nodesPrev[cnt++]=Point2f((float)x,(float)y);
 
-                // convert to gray-scale
-                cvtColor(toCvMat(*pImgBgrIn),toCvMat(imgMonoPrev),CV_BGR2GRAY);
+                // convert to gray-scale and build the pyramid
+                // the next frame will be tracked against
+                cvtColor(toCvMat(*pImgBgrIn),toCvMat(imgMonoIn),CV_BGR2GRAY);
+                pyrWinSize=winSize;
+                buildOpticalFlowPyramid(toCvMat(imgMonoIn),pyrPrev,Size(pyrWinSize,pyrWinSize),maxLevel);
 
                 if (verbosity)
                 {
@@ -260,15 +352,13 @@ public:
             activeNodesIndexSet.clear();
             blobSortedList.clear();
 
-            // compute optical flow
+            // compute optical flow; the pyramid of the
+            // previous frame is retained from the last cycle
             latch_t=Time::now();
-            constexpr int maxLevel=5;
             Size ws(winSize,winSize);
-            buildOpticalFlowPyramid(toCvMat(imgMonoPrev),pyrPrev,ws,maxLevel);
             buildOpticalFlowPyramid(toCvMat(imgMonoIn),pyrCurr,ws,maxLevel);
-            calcOpticalFlowPyrLK(pyrPrev,pyrCurr,nodesPrev,nodesCurr,
-                                 featuresFound,featuresErrors,ws,maxLevel,
-                                 TermCriteria(TermCriteria::COUNT+TermCriteria::EPS,30,0.3));
+            selectNodes();
+            trackNodes(ws,maxLevel);
             dt0=Time::now()-latch_t;
 
             // assign status to the grid nodes
@@ -300,6 +390,7 @@ public:
                 // do not consider the border nodes and skip if inhibition is on
                 int row=i%nodesX;
                 bool skip=inhibition || (i<nodesX) || (i>=(nodesPrev.size()-nodesX)) || (row==0) || (row==(nodesX-1));
+                nodesMoving[i]=(uchar)((featuresFound[i]!=0) && (featuresErrors[i]>recogThresAbs));
 
                 if (!skip && (featuresFound[i]!=0) && (featuresErrors[i]>recogThresAbs))
                 {
@@ -409,7 +500,7 @@ public:
             }
 
             // save data for next cycle
-            imgMonoPrev=imgMonoIn;
+            std::swap(pyrPrev,pyrCurr);
 
             double t1=Time::now();
             if (verbosity)
@@ -556,6 +647,11 @@ public:
 
                     reply.addString("ack");
                 }
+                else if (subcmd=="fullScanPeriod")
+                {
+                    fullScanPeriod=std::max(req.get(2).asInt32(),0);
+                    reply.addString("ack");
+                }
                 else if (subcmd=="verbosity")
                 {
                     verbosity=req.get(2).asString()=="on";
@@ -593,6 +689,8 @@ public:
                     else
                         reply.addString("auto");
                 }
+                else if (subcmd=="fullScanPeriod")
+                    reply.addInt32(fullScanPeriod);
                 else if (subcmd=="verbosity")
                     reply.addString(verbosity?"on":"off");
                 else if (subcmd=="inhibition")
@@ -697,6 +795,8 @@ int main(int argc, char *argv[])
         cout<<"\t--blobMinSizeThres  <int>"<<endl;
         cout<<"\t--framesPersistence <int>"<<endl;
         cout<<"\t--cropSize          \"auto\" or <int>"<<endl;
+        cout<<"\t--numThreads        <int>"<<endl;
+        cout<<"\t--fullScanPeriod    <int>"<<endl;
         cout<<"\t--verbosity"<<endl;
         cout<<endl;
         return 0;
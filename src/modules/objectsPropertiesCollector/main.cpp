@@ -164,6 +164,37 @@ this is not a real limitation since nested conditions can be
 properly expanded: indeed, the previous example can be cast back 
 to (cond1)&&(cond2) || (cond1)&&(cond3). 
  
+<b>batch</b> \n
+<i>Format</i>: [batch] (([cmd0] <args0>) ([cmd1] <args1>) ...) \n 
+<i>Reply</i>: [nack]/[ack] ((<reply0>) (<reply1>) ...) \n 
+<i>Action</i>: execute in one round trip the given list of item 
+commands (i.e. add, del, get, set, lock, unlock, owner, time, 
+ask, watch and unwatch), in order and without interleaving with 
+the requests of other agents. The list of the single replies is 
+returned and the first vocab is [ack] only if all the commands 
+succeeded; the commands following a failed one are executed 
+anyway. 
+ 
+<b>watch</b> \n
+<i>Format</i>: [watch] ("prop0" "prop1" ...) \n 
+<i>Reply</i>: [nack]; [ack] \n 
+<i>Action</i>: ask to be notified through the port 
+/<moduleName>/notify:o whenever the given properties of any item 
+are added, modified or removed, thus without polling the 
+database with [ask]. The notifications are in the form 
+"add"/"set" ("id" <num>) (("prop0" <val0>) ...) and "del" ("id" 
+<num>) (("prop0") ...), contain only the watched properties and 
+are sent once the change has been applied. The changes received 
+through the /<moduleName>/modify:i port and the count-down of 
+\e lifeTimer are not notified. 
+ 
+<b>unwatch</b> \n
+<i>Format</i>: [unwatch] ("prop0" "prop1" ...) \n 
+<i>Reply</i>: [nack]; [ack] \n 
+<i>Action</i>: stop watching the given properties; the special 
+command "[unwatch] (all)" removes all the properties watched by 
+the agent. 
+ 
 <b>quit</b> \n 
 <i>Format</i>: [quit] \n 
 <i>Reply</i>: [ack] \n 
@@ -193,6 +224,22 @@ to (cond1)&&(cond2) || (cond1)&&(cond3).
 - If this option is given then the content of database is not 
   saved at shutdown.
  
+--no-journal 
+- By default, the changes are appended to the journal file
+  <dbFileName>.journal as they occur and replayed at startup, and
+  the whole content is stored only at shutdown or once the journal
+  has grown enough; this option disables the journal, so that the
+  whole content is stored each 15 minutes.
+ 
+--index "(prop0 prop1 ...)"
+- The list of properties that are indexed to speed up the [ask]
+  queries: a query is served by the indexes whenever each group
+  of conditions in \e and contains at least one indexed property.
+  Indexes support the relational operators over strings, integers
+  and doubles, hence also ranges such as ((x > 0.1) && (x < 0.3)).
+  If not specified, the properties \e name and \e type are
+  indexed.
+ 
 --sync-bc <T> 
 - Broadcast the database content each \e T seconds. If not 
   specified, a period of 1.0 second is assumed.
@@ -209,11 +256,16 @@ None.
 \section portsc_sec Ports Created
  
 - \e /<moduleName>/rpc the remote procedure call port used to 
-  send requests to the database and receive replies.
+  send requests to the database and receive replies. The queries
+  coming from different connections are served concurrently,
+  whereas the changes are serialized.
 
 - \e /<moduleName>/broadcast:o the port used to broadcast the 
   database content in synchronous and asynchronous mode.
  
+- \e /<moduleName>/notify:o the port used to notify the changes
+  of the watched properties.
+ 
 - \e /<moduleName>/modify:i the port used to modify the database
   content complying with the data format implemented for the
   broadcast port.
@@ -250,6 +302,9 @@ reply: [ack] ((name octopus) (color blue) (x 3))
  
 command: [ask] ((x < 10) && (color == blue)) 
 reply: [ack] (id (1))
+ 
+command: [batch] (([set] ((id 0) (x 4))) ([get] ((id 0) (propSet (x))))) 
+reply: [ack] (([ack]) ([ack] ((x 4))))
 \endcode 
  
 \author Ugo Pattacini
@@ -258,10 +313,15 @@ reply: [ack] (id (1))
 #include <cstdio>
 #include <cstdarg>
 #include <mutex>
+#include <shared_mutex>
 #include <sstream>
+#include <fstream>
 #include <string>
 #include <map>
+#include <set>
 #include <deque>
+#include <vector>
+#include <algorithm>
 
 #include <yarp/os/all.h>
 
@@ -282,6 +342,9 @@ using namespace yarp::os;
 #define CMD_ASYNC                       createVocab32('a','s','y','n')
 #define CMD_QUIT                        createVocab32('q','u','i','t')
 #define CMD_BYE                         createVocab32('b','y','e')
+#define CMD_BATCH                       createVocab32('b','a','t','c')
+#define CMD_WATCH                       createVocab32('w','a','t','c')
+#define CMD_UNWATCH                     createVocab32('u','n','w','a')
                                         
 #define REP_ACK                         createVocab32('a','c','k')
 #define REP_NACK                        createVocab32('n','a','c','k')
@@ -297,6 +360,12 @@ using namespace yarp::os;
 #define BCTAG_EMPTY                     ("empty")
 #define BCTAG_SYNC                      ("sync")
 #define BCTAG_ASYNC                     ("async")
+#define NTFTAG_ADD                      ("add")
+#define NTFTAG_SET                      ("set")
+#define NTFTAG_DEL                      ("del")
+                                        
+#define JOURNAL_EXT                     (".journal")
+#define JOURNAL_COMPACT_MIN             1000
 
 
 namespace relationalOperators
@@ -415,21 +484,54 @@ protected:
     struct Condition
     {
         string prop;
+        string op;
         bool (*compare)(Value&,Value&);
         Value val;
     };
 
+    /************************************************************************/
+    // values are kept per type, since the relational
+    // operators never match values of different types
+    struct Index
+    {
+        set<int>             present;
+        map<double,set<int>> floats;
+        map<int,set<int>>    ints;
+        map<string,set<int>> strings;
+    };
+
+    /************************************************************************/
+    // the queries hold the database in shared mode and are
+    // served concurrently, whereas the changes are serialized
+    enum Access
+    {
+        ACCESS_NONE,
+        ACCESS_SHARED,
+        ACCESS_EXCLUSIVE
+    };
+
     ResourceFinder *rf;
     map<int,Item> itemsMap;
-    mutex mtx;
+    map<string,Index> indexes;
+    shared_mutex mtx;
     int  idCnt;
     bool initialized;
     bool nosavedb;
     bool quitting;
 
+    FILE *pJournal;
+    int   journalEntries;
+
     BufferedPort<Bottle> *pBroadcastPort;
+    mutex bcMtx;
     bool asyncBroadcast;
 
+    // watched property -> agents watching it
+    map<string,set<string>> watchers;
+    BufferedPort<Bottle> *pNotifyPort;
+    deque<Bottle> notifications;
+    mutex notifyMtx;
+
     /************************************************************************/
     void clear()
     {
@@ -437,15 +539,314 @@ protected:
             delete it->second.prop;
 
         itemsMap.clear();
+        for (map<string,Index>::iterator it=indexes.begin(); it!=indexes.end(); it++)
+            it->second=Index();
     }
 
     /************************************************************************/
     void eraseItem(map<int,Item>::iterator &it)
     {
+        unindexItem(it->first,it->second.prop);
         delete it->second.prop;
         itemsMap.erase(it);
     }
 
+    /************************************************************************/
+    void putItem(const int id, Property *prop)
+    {
+        Item &item=itemsMap[id];
+        if (item.prop!=NULL)
+        {
+            unindexItem(id,item.prop);
+            delete item.prop;
+        }
+
+        item.prop=prop;
+        indexItem(id,prop);
+    }
+
+    /************************************************************************/
+    template<typename T>
+    static void insertKey(map<T,set<int>> &m, const T &key, const int id)
+    {
+        m[key].insert(id);
+    }
+
+    /************************************************************************/
+    template<typename T>
+    static void eraseKey(map<T,set<int>> &m, const T &key, const int id)
+    {
+        typename map<T,set<int>>::iterator it=m.find(key);
+        if (it!=m.end())
+        {
+            it->second.erase(id);
+            if (it->second.empty())
+                m.erase(it);
+        }
+    }
+
+    /************************************************************************/
+    void indexItem(const int id, Property *prop)
+    {
+        for (map<string,Index>::iterator it=indexes.begin(); it!=indexes.end(); it++)
+        {
+            if (!prop->check(it->first))
+                continue;
+
+            Index &index=it->second;
+            Value &val=prop->find(it->first);
+            index.present.insert(id);
+
+            if (val.isFloat64())
+                insertKey(index.floats,val.asFloat64(),id);
+            else if (val.isInt32())
+                insertKey(index.ints,val.asInt32(),id);
+            else if (val.isString())
+                insertKey(index.strings,val.asString(),id);
+        }
+    }
+
+    /************************************************************************/
+    void unindexItem(const int id, Property *prop)
+    {
+        for (map<string,Index>::iterator it=indexes.begin(); it!=indexes.end(); it++)
+        {
+            if (!prop->check(it->first))
+                continue;
+
+            Index &index=it->second;
+            Value &val=prop->find(it->first);
+            index.present.erase(id);
+
+            if (val.isFloat64())
+                eraseKey(index.floats,val.asFloat64(),id);
+            else if (val.isInt32())
+                eraseKey(index.ints,val.asInt32(),id);
+            else if (val.isString())
+                eraseKey(index.strings,val.asString(),id);
+        }
+    }
+
+    /************************************************************************/
+    template<typename T>
+    static void collectRange(const map<T,set<int>> &m, const string &op,
+                             const T &key, set<int> &ids)
+    {
+        typename map<T,set<int>>::const_iterator first=m.begin();
+        typename map<T,set<int>>::const_iterator last=m.end();
+        if (op=="==")
+        {
+            first=m.lower_bound(key);
+            last=m.upper_bound(key);
+        }
+        else if (op==">")
+            first=m.upper_bound(key);
+        else if (op==">=")
+            first=m.lower_bound(key);
+        else if (op=="<")
+            last=m.lower_bound(key);
+        else if (op=="<=")
+            last=m.upper_bound(key);
+
+        for (typename map<T,set<int>>::const_iterator it=first; it!=last; it++)
+            if ((op!="!=") || (it->first!=key))
+                ids.insert(it->second.begin(),it->second.end());
+    }
+
+    /************************************************************************/
+    // retrieve a superset of the items satisfying the condition;
+    // return false if the condition cannot be served by an index
+    bool lookup(Condition &cond, set<int> &ids)
+    {
+        map<string,Index>::iterator it=indexes.find(cond.prop);
+        if (it==indexes.end())
+            return false;
+
+        Index &index=it->second;
+        ids.clear();
+        if (cond.op.empty())
+            ids=index.present;
+        else if (cond.val.isFloat64())
+            collectRange(index.floats,cond.op,cond.val.asFloat64(),ids);
+        else if (cond.val.isInt32())
+            collectRange(index.ints,cond.op,cond.val.asInt32(),ids);
+        else if (cond.val.isString() && ((cond.op=="==") || (cond.op=="!=")))
+            collectRange(index.strings,cond.op,cond.val.asString(),ids);
+
+        return true;
+    }
+
+    /************************************************************************/
+    void journalWrite(const string &op, const int id, const Bottle *payload=NULL)
+    {
+        if (pJournal==NULL)
+            return;
+
+        Bottle entry;
+        entry.addString(op);
+        entry.addInt32(id);
+        if (payload!=NULL)
+            entry.addList()=*payload;
+
+        fprintf(pJournal,"%s\n",entry.toString().c_str());
+        fflush(pJournal);
+        journalEntries++;
+    }
+
+    /************************************************************************/
+    int replayJournal(const string &journalFileName)
+    {
+        ifstream fin(journalFileName.c_str());
+        if (!fin.is_open())
+            return 0;
+
+        int cnt=0;
+        string line;
+        while (getline(fin,line))
+        {
+            Bottle entry(line);
+            if (entry.size()<2)
+                continue;
+
+            string op=entry.get(0).asString();
+            int id=entry.get(1).asInt32();
+            Bottle *payload=entry.get(2).asList();
+            map<int,Item>::iterator it=itemsMap.find(id);
+
+            if ((op=="add") && (payload!=NULL))
+            {
+                putItem(id,new Property(payload->toString().c_str()));
+                if (idCnt<=id)
+                    idCnt=id+1;
+            }
+            else if ((op=="set") && (payload!=NULL) && (it!=itemsMap.end()))
+            {
+                Property *pProp=it->second.prop;
+                unindexItem(id,pProp);
+                for (int i=0; i<payload->size(); i++)
+                {
+                    if (Bottle *option=payload->get(i).asList())
+                    {
+                        if (option->size()<2)
+                            continue;
+
+                        string prop=option->get(0).asString();
+                        pProp->unput(prop);
+                        pProp->put(prop,option->get(1));
+                    }
+                }
+                indexItem(id,pProp);
+            }
+            else if ((op=="unput") && (payload!=NULL) && (it!=itemsMap.end()))
+            {
+                Property *pProp=it->second.prop;
+                unindexItem(id,pProp);
+                for (int i=0; i<payload->size(); i++)
+                    pProp->unput(payload->get(i).asString());
+                indexItem(id,pProp);
+            }
+            else if ((op=="del") && (it!=itemsMap.end()))
+                eraseItem(it);
+            else if (op=="clear")
+                clear();
+            else
+                continue;
+
+            cnt++;
+        }
+
+        return cnt;
+    }
+
+    /************************************************************************/
+    string getJournalFileName()
+    {
+        return rf->getHomeContextPath()+"/"+rf->find("db").asString()+JOURNAL_EXT;
+    }
+
+    /************************************************************************/
+    // queue a notification listing the watched properties among the
+    // given ones, either as (prop val) pairs or as names only;
+    // it requires the exclusive lock
+    void notifyChange(const string &event, const int id, const Bottle &props,
+                      const bool values)
+    {
+        if (watchers.empty())
+            return;
+
+        Bottle changes;
+        for (int i=0; i<props.size(); i++)
+        {
+            Bottle *option=props.get(i).asList();
+            string prop=(option!=NULL)?option->get(0).asString():props.get(i).asString();
+            if ((prop==PROP_ID) || (watchers.find(prop)==watchers.end()))
+                continue;
+
+            if (values && (option!=NULL) && (option->size()>=2))
+                changes.addList()=*option;
+            else
+                changes.addList().addString(prop);
+        }
+
+        if (changes.size()==0)
+            return;
+
+        Bottle notification;
+        notification.addString(event);
+        Bottle &idList=notification.addList();
+        idList.addString(PROP_ID);
+        idList.addInt32(id);
+        notification.addList()=changes;
+
+        lock_guard<mutex> lck(notifyMtx);
+        notifications.push_back(notification);
+    }
+
+    /************************************************************************/
+    void notifyErase(const int id, Property *prop)
+    {
+        if (watchers.empty())
+            return;
+
+        Bottle props;
+        props.read(*prop);
+        notifyChange(NTFTAG_DEL,id,props,false);
+    }
+
+    /************************************************************************/
+    // deliver the queued notifications; it is called once the
+    // database has been released, so that the slow readers do
+    // not stall the requests
+    void flushNotifications()
+    {
+        lock_guard<mutex> lck(notifyMtx);
+        while (!notifications.empty())
+        {
+            if ((pNotifyPort!=NULL) && (pNotifyPort->getOutputCount()>0))
+            {
+                pNotifyPort->prepare()=notifications.front();
+                pNotifyPort->writeStrict();
+            }
+
+            notifications.pop_front();
+        }
+    }
+
+    /************************************************************************/
+    bool checkCondition(Property *item, Condition &cond)
+    {
+        if (item->check(cond.prop))
+        {
+            // take the current value of the item's property under test
+            Value &val=item->find(cond.prop);
+
+            // compute the condition over the current value
+            return (*cond.compare)(val,cond.val);
+        }
+        else
+            return false;
+    }
+
     /************************************************************************/
     void write(FILE *stream)
     {
@@ -514,11 +915,14 @@ public:
     DataBase() : PeriodicThread(1.0)
     {
         pBroadcastPort=NULL;
+        pNotifyPort=NULL;
         asyncBroadcast=false;
         initialized=false;
         nosavedb=false;
         quitting=false;
         idCnt=0;
+        pJournal=NULL;
+        journalEntries=0;
     }
 
     /************************************************************************/
@@ -529,6 +933,9 @@ public:
 
         save();
         clear();
+
+        if (pJournal!=NULL)
+            fclose(pJournal);
     }
 
     /************************************************************************/
@@ -542,9 +949,26 @@ public:
         }
 
         nosavedb=rf.check("no-save-db");
-        if (!rf.check("no-load-db"))
+
+        // the indexes must be in place before the items are loaded
+        if (Bottle *indexList=rf.find("index").asList())
+        {
+            for (int i=0; i<indexList->size(); i++)
+                indexes[indexList->get(i).asString()];
+        }
+        else
+        {
+            indexes["name"];
+            indexes["type"];
+        }
+
+        bool loaddb=!rf.check("no-load-db");
+        if (loaddb)
             load();
 
+        if (!nosavedb && !rf.check("no-journal"))
+            openJournal(loaddb);
+
         dump();
         initialized=true;
         yInfo("database ready ...");
@@ -564,6 +988,12 @@ public:
         pBroadcastPort=&broadcastPort;
     }
 
+    /************************************************************************/
+    void setNotifyPort(BufferedPort<Bottle> &notifyPort)
+    {
+        pNotifyPort=&notifyPort;
+    }
+
     /************************************************************************/
     void load()
     {
@@ -576,7 +1006,7 @@ public:
 
         yInfo("loading database from %s ...",dbFileName.c_str());
 
-        lock_guard<mutex> lck(mtx);
+        lock_guard<shared_mutex> lck(mtx);
         clear();
         idCnt=0;
 
@@ -614,7 +1044,7 @@ public:
             }
 
             int id=b2->get(1).asInt32();
-            itemsMap[id].prop=new Property(b3->toString().c_str());
+            putItem(id,new Property(b3->toString().c_str()));
 
             if (idCnt<=id)
                 idCnt=id+1;
@@ -624,28 +1054,82 @@ public:
     }
 
     /************************************************************************/
-    void save()
+    void openJournal(const bool replay)
+    {
+        string journalFileName=getJournalFileName();
+        bool keep=false;
+        if (replay)
+        {
+            mtx.lock();
+            int cnt=replayJournal(journalFileName);
+            mtx.unlock();
+
+            // fold the replayed changes into the database file
+            if (cnt>0)
+            {
+                yInfo("replayed %d changes from %s",cnt,journalFileName.c_str());
+                keep=!save();
+            }
+        }
+
+        // the journal refers to the database file, hence it is
+        // restarted unless the replayed changes could not be stored
+        pJournal=fopen(journalFileName.c_str(),keep?"a":"w");
+        if (pJournal==NULL)
+            yWarning("unable to open the journal %s!",journalFileName.c_str());
+    }
+
+    /************************************************************************/
+    bool save(const bool force=true)
     {
         if (nosavedb)
-            return;
+            return false;
+
+        lock_guard<shared_mutex> lck(mtx);
+
+        // with the journal on, the whole content is stored only
+        // when requested or once the journal has grown enough
+        if ((pJournal!=NULL) && !force &&
+            (journalEntries<std::max(JOURNAL_COMPACT_MIN,(int)itemsMap.size())))
+            return true;
 
-        lock_guard<mutex> lck(mtx);
         string dbFileName=rf->getHomeContextPath();
         dbFileName+="/";
         dbFileName+=rf->find("db").asString();
         yInfo("saving database in %s ...",dbFileName.c_str());
 
-        FILE *fout=fopen(dbFileName.c_str(),"w");
+        string tmpFileName=dbFileName+".tmp";
+        FILE *fout=fopen(tmpFileName.c_str(),"w");
+        if (fout==NULL)
+        {
+            yError("unable to write %s!",tmpFileName.c_str());
+            return false;
+        }
         write(fout);
         fclose(fout);
 
+        if (std::rename(tmpFileName.c_str(),dbFileName.c_str())!=0)
+        {
+            std::remove(dbFileName.c_str());
+            std::rename(tmpFileName.c_str(),dbFileName.c_str());
+        }
+
+        // the changes are now part of the database file
+        if (pJournal!=NULL)
+        {
+            fclose(pJournal);
+            pJournal=fopen(getJournalFileName().c_str(),"w");
+            journalEntries=0;
+        }
+
         yInfo("database stored");
+        return true;
     }
 
     /************************************************************************/
     void dump()
     {
-        lock_guard<mutex> lck(mtx);
+        shared_lock<shared_mutex> lck(mtx);
         yInfo("dumping database content ...");
 
         if (itemsMap.size()==0)
@@ -661,7 +1145,8 @@ public:
         {
             if (pBroadcastPort->getOutputCount()>0)
             {
-                lock_guard<mutex> lck(mtx);
+                shared_lock<shared_mutex> lck(mtx);
+                lock_guard<mutex> bcLck(bcMtx);
                 Bottle &bottle=pBroadcastPort->prepare();
                 bottle.clear();
 
@@ -695,9 +1180,10 @@ public:
             return false;
         }
 
-        lock_guard<mutex> lck(mtx);
-        itemsMap[idCnt].prop=new Property(content->toString().c_str());
+        putItem(idCnt,new Property(content->toString().c_str()));
         itemsMap[idCnt].lastUpdate=Time::now();
+        journalWrite("add",idCnt,content);
+        notifyChange(NTFTAG_ADD,idCnt,*content,true);
 
         return true;
     }
@@ -714,8 +1200,11 @@ public:
             {
                 if (content->get(0).asVocab32()==OPT_ALL)
                 {
-                    lock_guard<mutex> lck(mtx);
+                    for (map<int,Item>::iterator it=itemsMap.begin(); it!=itemsMap.end(); it++)
+                        notifyErase(it->first,it->second.prop);
+
                     clear();
+                    journalWrite("clear",0);
                     yInfo("database cleared");
                     return true;
                 }
@@ -730,20 +1219,27 @@ public:
 
         int id=content->find(PROP_ID).asInt32();
 
-        lock_guard<mutex> lck(mtx);
         map<int,Item>::iterator it=itemsMap.find(id);
         if (it!=itemsMap.end())
         {
             Bottle *propSet=content->find(PROP_SET).asList();
             if (propSet!=NULL)
             {
+                unindexItem(id,it->second.prop);
                 for (int i=0; i<propSet->size(); i++)
                     it->second.prop->unput(propSet->get(i).asString());
+                indexItem(id,it->second.prop);
 
                 it->second.lastUpdate=Time::now();
+                journalWrite("unput",id,propSet);
+                notifyChange(NTFTAG_DEL,id,*propSet,false);
             }
             else
+            {
+                notifyErase(id,it->second.prop);
                 eraseItem(it);
+                journalWrite("del",id);
+            }
 
             return true;
         }
@@ -765,7 +1261,6 @@ public:
 
         int id=content->find(PROP_ID).asInt32();
 
-        lock_guard<mutex> lck(mtx);
         map<int,Item>::iterator it=itemsMap.find(id);
         if (it!=itemsMap.end())
         {
@@ -808,7 +1303,6 @@ public:
 
         int id=content->find(PROP_ID).asInt32();
 
-        lock_guard<mutex> lck(mtx);
         map<int,Item>::iterator it=itemsMap.find(id);
         if (it!=itemsMap.end())
         {
@@ -816,6 +1310,8 @@ public:
             if ((owner==OPT_OWNERSHIP_ALL) || (owner==agent))
             {
                 Property *pProp=it->second.prop;
+                Bottle changes;
+                unindexItem(id,pProp);
                 for (int i=0; i<content->size(); i++)
                 {
                     if (Bottle *option=content->get(i).asList())
@@ -831,12 +1327,16 @@ public:
 
                         pProp->unput(prop);
                         pProp->put(prop,val);
+                        changes.addList()=*option;
                     }
                     else
                         continue;
                 }
+                indexItem(id,pProp);
 
                 it->second.lastUpdate=Time::now();
+                journalWrite("set",id,&changes);
+                notifyChange(NTFTAG_SET,id,changes,true);
                 return true;
             }
         }
@@ -858,7 +1358,6 @@ public:
 
         int id=content->find(PROP_ID).asInt32();
 
-        lock_guard<mutex> lck(mtx);
         map<int,Item>::iterator it=itemsMap.find(id);
         if (it!=itemsMap.end())
         {
@@ -887,7 +1386,6 @@ public:
 
         int id=content->find(PROP_ID).asInt32();
 
-        lock_guard<mutex> lck(mtx);
         map<int,Item>::iterator it=itemsMap.find(id);
         if (it!=itemsMap.end())
         {
@@ -916,7 +1414,6 @@ public:
 
         int id=content->find(PROP_ID).asInt32();
 
-        lock_guard<mutex> lck(mtx);
         map<int,Item>::iterator it=itemsMap.find(id);
         if (it!=itemsMap.end())
         {
@@ -943,7 +1440,6 @@ public:
 
         int id=content->find(PROP_ID).asInt32();
 
-        lock_guard<mutex> lck(mtx);
         map<int,Item>::iterator it=itemsMap.find(id);
         if (it!=itemsMap.end())
         {
@@ -961,13 +1457,66 @@ public:
         return false;
     }
 
+    /************************************************************************/
+    bool watch(Bottle *content, const string &agent)
+    {
+        if (content==NULL)
+            return false;
+
+        for (int i=0; i<content->size(); i++)
+        {
+            string prop=content->get(i).asString();
+            if (prop.empty() || (prop==PROP_ID))
+                return false;
+        }
+
+        for (int i=0; i<content->size(); i++)
+            watchers[content->get(i).asString()].insert(agent);
+
+        return true;
+    }
+
+    /************************************************************************/
+    bool unwatch(Bottle *content, const string &agent)
+    {
+        if (content==NULL)
+            return false;
+
+        bool all=false;
+        if (content->size()==1)
+            if (content->get(0).isVocab32() || content->get(0).isString())
+                all=(content->get(0).asVocab32()==OPT_ALL);
+
+        for (map<string,set<string>>::iterator it=watchers.begin(); it!=watchers.end();)
+        {
+            if (all || hasString(*content,it->first))
+                it->second.erase(agent);
+
+            if (it->second.empty())
+                it=watchers.erase(it);
+            else
+                it++;
+        }
+
+        return true;
+    }
+
+    /************************************************************************/
+    static bool hasString(const Bottle &list, const string &str)
+    {
+        for (int i=0; i<list.size(); i++)
+            if (list.get(i).asString()==str)
+                return true;
+
+        return false;
+    }
+
     /************************************************************************/
     bool ask(Bottle *content, Bottle &response)
     {
         if (content==NULL)
             return false;
 
-        lock_guard<mutex> lck(mtx);
         if (content->size()==1)
         {
             if (content->get(0).isVocab32() || content->get(0).isString())
@@ -1012,6 +1561,7 @@ public:
                 {
                     condition.prop=b->get(0).asString();
                     operation=b->get(1).asString();
+                    condition.op=operation;
                     condition.val=b->get(2);
 
                     if (operation==">")
@@ -1061,6 +1611,15 @@ public:
 
         response.clear();
 
+        set<int> ids;
+        if (plan(condList,opList,ids))
+        {
+            for (set<int>::iterator it=ids.begin(); it!=ids.end(); it++)
+                response.addInt32(*it);
+
+            return true;
+        }
+
         // apply the conditions to each item
         for (map<int,Item>::iterator it=itemsMap.begin(); it!=itemsMap.end(); it++)
         {
@@ -1073,6 +1632,64 @@ public:
         return true;
     }
 
+    /************************************************************************/
+    // serve the query through the indexes: each group of conditions
+    // in "&&" is narrowed down by its most selective indexed condition
+    // and then checked in full over the candidates only; return false
+    // if any group lacks an indexed condition
+    bool plan(deque<Condition> &condList, deque<string> &opList, set<int> &ids)
+    {
+        if (indexes.empty())
+            return false;
+
+        vector<vector<size_t>> groups(1);
+        for (size_t i=0; i<condList.size(); i++)
+        {
+            groups.back().push_back(i);
+            if ((i<opList.size()) && (opList[i]=="||"))
+                groups.push_back(vector<size_t>());
+        }
+
+        vector<set<int>> candidates(groups.size());
+        for (size_t g=0; g<groups.size(); g++)
+        {
+            bool found=false;
+            for (size_t i=0; i<groups[g].size(); i++)
+            {
+                set<int> tmp;
+                if (lookup(condList[groups[g][i]],tmp))
+                {
+                    if (!found || (tmp.size()<candidates[g].size()))
+                        candidates[g].swap(tmp);
+                    found=true;
+                }
+            }
+
+            if (!found)
+                return false;
+        }
+
+        ids.clear();
+        for (size_t g=0; g<groups.size(); g++)
+        {
+            for (set<int>::iterator it=candidates[g].begin(); it!=candidates[g].end(); it++)
+            {
+                map<int,Item>::iterator item=itemsMap.find(*it);
+                if ((item==itemsMap.end()) || (ids.find(*it)!=ids.end()))
+                    continue;
+
+                bool result=true;
+                for (size_t i=0; (i<groups[g].size()) && result; i++)
+                    result=checkCondition(item->second.prop,condList[groups[g][i]]);
+
+                if (result)
+                    ids.insert(*it);
+            }
+        }
+
+        return true;
+    }
+
     /************************************************************************/
     void periodicHandler(const double dt)   // manage the items life-timers
     {
@@ -1086,19 +1703,32 @@ public:
                 double lifeTimer=pProp->find(PROP_LIFETIMER).asFloat64()-dt;
                 if (lifeTimer<=0.0)
                 {
+                    int id=it->first;
+                    notifyErase(id,pProp);
                     eraseItem(it);
+                    journalWrite("del",id);
                     erased=true;
                     break;
                 }
                 else
                 {
+                    // the count-down is not journaled, as it
+                    // would produce one entry per second
+                    bool indexed=(indexes.find(PROP_LIFETIMER)!=indexes.end());
+                    if (indexed)
+                        unindexItem(it->first,pProp);
+
                     pProp->unput(PROP_LIFETIMER);
                     pProp->put(PROP_LIFETIMER,lifeTimer);
+
+                    if (indexed)
+                        indexItem(it->first,pProp);
                 }
             }
         }
         mtx.unlock();
 
+        flushNotifications();
         if (asyncBroadcast && erased)
             broadcast(BCTAG_ASYNC);
     }
@@ -1109,6 +1739,45 @@ public:
         return quitting;
     }
 
+    /************************************************************************/
+    Access getAccess(const Bottle &command)
+    {
+        switch (command.get(0).asVocab32())
+        {
+            case CMD_GET:
+            case CMD_OWNER:
+            case CMD_TIME:
+            case CMD_ASK:
+                return ACCESS_SHARED;
+
+            case CMD_ADD:
+            case CMD_DEL:
+            case CMD_SET:
+            case CMD_LOCK:
+            case CMD_UNLOCK:
+            case CMD_WATCH:
+            case CMD_UNWATCH:
+                return ACCESS_EXCLUSIVE;
+
+            case CMD_BATCH:
+            {
+                Access access=ACCESS_SHARED;
+                if (Bottle *commands=command.get(1).asList())
+                {
+                    for (int i=0; i<commands->size(); i++)
+                        if (Bottle *subCommand=commands->get(i).asList())
+                            if (getAccess(*subCommand)==ACCESS_EXCLUSIVE)
+                                access=ACCESS_EXCLUSIVE;
+                }
+
+                return access;
+            }
+
+            default:
+                return ACCESS_NONE;
+        }
+    }
+
     /************************************************************************/
     void respond(ConnectionReader &connection, const Bottle &command, Bottle &reply)
     {
@@ -1119,6 +1788,38 @@ public:
             return;
         }
 
+        bool changed=false;
+        Access access=getAccess(command);
+        if (access==ACCESS_EXCLUSIVE)
+        {
+            lock_guard<shared_mutex> lck(mtx);
+            execute(agent,command,reply,changed);
+        }
+        else if (access==ACCESS_SHARED)
+        {
+            shared_lock<shared_mutex> lck(mtx);
+            execute(agent,command,reply,changed);
+        }
+        else
+            execute(agent,command,reply,changed);
+
+        flushNotifications();
+        if (asyncBroadcast && changed)
+            broadcast(BCTAG_ASYNC);
+    }
+
+    /************************************************************************/
+    // the commands that access the items are executed while
+    // the caller holds the database as given by getAccess()
+    void execute(const string &agent, const Bottle &command, Bottle &reply,
+                 bool &changed)
+    {
+        if (command.size()<1)
+        {
+            reply.addVocab32(REP_NACK);
+            return;
+        }
+
         reply.clear();
         int cmd=command.get(0).asVocab32();
         switch(cmd)
@@ -1141,8 +1842,7 @@ public:
                     b.addInt32(idCnt);
                     idCnt++;
 
-                    if (asyncBroadcast)
-                        broadcast(BCTAG_ASYNC);
+                    changed=true;
                 }
                 else
                     reply.addVocab32(REP_NACK);
@@ -1163,8 +1863,7 @@ public:
                 if (remove(content))
                 {
                     reply.addVocab32(REP_ACK);
-                    if (asyncBroadcast)
-                        broadcast(BCTAG_ASYNC);
+                    changed=true;
                 }
                 else
                     reply.addVocab32(REP_NACK);
@@ -1207,8 +1906,7 @@ public:
                 if (set(content,agent))
                 {
                     reply.addVocab32(REP_ACK);
-                    if (asyncBroadcast)
-                        broadcast(BCTAG_ASYNC);
+                    changed=true;
                 }
                 else
                     reply.addVocab32(REP_NACK);
@@ -1389,6 +2087,54 @@ public:
                 break;
             }
 
+            //-----------------
+            case CMD_WATCH:
+            case CMD_UNWATCH:
+            {
+                if (command.size()<2)
+                {
+                    reply.addVocab32(REP_NACK);
+                    break;
+                }
+
+                Bottle *content=command.get(1).asList();
+                bool ok=(cmd==CMD_WATCH)?watch(content,agent):unwatch(content,agent);
+                reply.addVocab32(ok?REP_ACK:REP_NACK);
+                break;
+            }
+
+            //-----------------
+            case CMD_BATCH:
+            {
+                Bottle *commands=(command.size()>=2)?command.get(1).asList():NULL;
+                if (commands==NULL)
+                {
+                    reply.addVocab32(REP_NACK);
+                    break;
+                }
+
+                // all the sub-commands run under the same lock, hence
+                // no other agent can observe the intermediate states
+                bool ok=true;
+                Bottle replies;
+                for (int i=0; i<commands->size(); i++)
+                {
+                    Bottle &subReply=replies.addList();
+                    Bottle *subCommand=commands->get(i).asList();
+                    if ((subCommand==NULL) || (subCommand->get(0).asVocab32()==CMD_BATCH) ||
+                        (getAccess(*subCommand)==ACCESS_NONE))
+                        subReply.addVocab32(REP_NACK);
+                    else
+                        execute(agent,*subCommand,subReply,changed);
+
+                    ok=ok && (subReply.get(0).asVocab32()==REP_ACK);
+                }
+
+                reply.addVocab32(ok?REP_ACK:REP_NACK);
+                reply.addList()=replies;
+                break;
+            }
+
             //-----------------
             case CMD_QUIT:
             case CMD_BYE:
@@ -1419,6 +2165,7 @@ public:
 
         mtx.lock();
         clear();
+        journalWrite("clear",0);
 
         if (type!=BCTAG_EMPTY)
         {
@@ -1434,7 +2181,9 @@ public:
                             if (idList->get(0).asString()==PROP_ID)
                             {
                                 int id=idList->get(1).asInt32();
-                                itemsMap[id].prop=new Property(item->tail().toString().c_str());
+                                Bottle props=item->tail();
+                                putItem(id,new Property(props.toString().c_str()));
+                                journalWrite("add",id,&props);
 
                                 if (idCnt<=id)
                                     idCnt=id+1;
@@ -1456,13 +2205,42 @@ public:
 
 
 /************************************************************************/
-class RpcProcessor : public PortReader
+class RpcStats
 {
 protected:
-    DataBase *pDataBase;
+    mutex mtx;
     unsigned int nCalls;
     double cumTime;
 
+public:
+    /************************************************************************/
+    RpcStats() : nCalls(0), cumTime(0.0) { }
+
+    /************************************************************************/
+    void update(const double dt)
+    {
+        lock_guard<mutex> lck(mtx);
+        cumTime+=dt;
+        nCalls++;
+    }
+
+    /************************************************************************/
+    void getStats(unsigned int &nCalls, double &cumTime)
+    {
+        lock_guard<mutex> lck(mtx);
+        nCalls=this->nCalls;
+        cumTime=this->cumTime;
+    }
+};
+
+
+/************************************************************************/
+class RpcProcessor : public PortReader
+{
+protected:
+    DataBase *pDataBase;
+    RpcStats *pStats;
+
     /************************************************************************/
     bool read(ConnectionReader &connection)
     {
@@ -1473,8 +2251,8 @@ protected:
         Bottle reply;
         double t0=Time::now();
         pDataBase->respond(connection,command,reply);
-        cumTime+=Time::now()-t0;
-        nCalls++;
+        if (pStats!=NULL)
+            pStats->update(Time::now()-t0);
 
         if (ConnectionWriter *writer=connection.getWriter())
             reply.write(*writer);
@@ -1484,12 +2262,23 @@ protected:
 
 public:
     /************************************************************************/
-    RpcProcessor()
-    {
-        pDataBase=NULL;
-        nCalls=0;
-        cumTime=0.0;
-    }
+    RpcProcessor(DataBase *pDataBase, RpcStats *pStats) :
+                 pDataBase(pDataBase), pStats(pStats) { }
+};
+
+
+/************************************************************************/
+// each connection to the rpc port is given its own reader, so that
+// the requests coming from different agents are served concurrently
+class RpcProcessorCreator : public PortReaderCreator
+{
+protected:
+    DataBase         *pDataBase;
+    mutable RpcStats  stats;
+
+public:
+    /************************************************************************/
+    RpcProcessorCreator() : pDataBase(NULL) { }
 
     /************************************************************************/
     void setDataBase(DataBase &dataBase)
@@ -1498,10 +2287,15 @@ public:
     }
 
     /************************************************************************/
-    void getStats(unsigned int &nCalls, double &cumTime) const
+    PortReader *create() const
     {
-        nCalls=this->nCalls;
-        cumTime=this->cumTime;
+        return new RpcProcessor(pDataBase,&stats);
+    }
+
+    /************************************************************************/
+    void getStats(unsigned int &nCalls, double &cumTime)
+    {
+        stats.getStats(nCalls,cumTime);
     }
 };
 
@@ -1536,10 +2330,11 @@ class objectsPropertiesCollectorModule: public RFModule
 {
 private:
     DataBase             dataBase;
-    RpcProcessor         rpcProcessor;
+    RpcProcessorCreator  rpcCreator;
     DataBaseModifyPort   modifyPort;
     RpcServer            rpcPort;
     BufferedPort<Bottle> bcPort;
+    BufferedPort<Bottle> notifyPort;
 
     int cnt;
     bool stats;
@@ -1555,12 +2350,14 @@ public:
 
         string name=rf.check("name",Value("objectsPropertiesCollector")).asString();
         dataBase.setBroadcastPort(bcPort);
-        rpcProcessor.setDataBase(dataBase);
-        rpcPort.setReader(rpcProcessor);
+        dataBase.setNotifyPort(notifyPort);
+        rpcCreator.setDataBase(dataBase);
+        rpcPort.setReaderCreator(rpcCreator);
         modifyPort.setDataBase(dataBase);
         modifyPort.useCallback();
         rpcPort.open("/"+name+"/rpc");
         bcPort.open("/"+name+"/broadcast:o");
+        notifyPort.open("/"+name+"/notify:o");
         modifyPort.open("/"+name+"/modify:i");
 
         cnt=0;
@@ -1578,10 +2375,12 @@ public:
 
         rpcPort.interrupt();
         bcPort.interrupt();
+        notifyPort.interrupt();
         modifyPort.interrupt();
 
         rpcPort.close();
         bcPort.close();
+        notifyPort.close();
         modifyPort.close();
 
         return true;
@@ -1595,14 +2394,14 @@ public:
         // back-up straightaway the database each 15 minutes
         if ((++cnt)*getPeriod()>(15.0*60.0))
         {
-            dataBase.save();
+            dataBase.save(false);
             cnt=0;
         }
 
         if (stats)
         {
             unsigned int nCalls; double cumTime;
-            rpcProcessor.getStats(nCalls,cumTime);
+            rpcCreator.getStats(nCalls,cumTime);
 
             unsigned int calls=nCalls-nCallsOld;
             double timeSpent=cumTime-cumTimeOld;
@@ -1642,6 +2441,8 @@ int main(int argc, char *argv[])
         printf("\t--context  <context>: context to search for database file (default: objectsPropertiesCollector)\n");
         printf("\t--no-load-db        : start an empty database\n");
         printf("\t--no-save-db        : prevent from saving the content of database at shutdown\n");
+        printf("\t--no-journal        : save the whole content of database instead of journaling changes\n");
+        printf("\t--index  \"(<props>)\": properties to be indexed (default: (name type))\n");
         printf("\t--sync-bc        <T>: broadcast the database content each T seconds\n");
         printf("\t--async-bc          : broadcast the database content whenever a change occurs\n");
         printf("\t--stats             : enable statistics printouts\n");
@@ -7,6 +7,7 @@
 #include "positionDirectThread.h"
 #include <cstring>
 #include <string>
+#include <vector>
 #include <cmath>
 
 #include <yarp/os/Log.h>
@@ -67,33 +68,24 @@ void positionDirectControlThread::run()
         return;
     }
 
-    //apply the joints limits
+    //get the current position of the whole part with one request
+    ienc->getEncoders(part_encoders.data());
+
     for (unsigned int i=0; i< control_joints; i++)
     {
+        encoders[i]=part_encoders[control_joints_list[i]];
+
+        //apply the joints limits
         if (targets[i]>max_limits[i]) targets[i]=max_limits[i];
         if (targets[i]<min_limits[i]) targets[i]=min_limits[i];
-    }
 
-    //get the current position
-    for (unsigned int i=0; i< control_joints; i++)
-    {
-        double val =0;
-        ienc->getEncoder(control_joints_list[i],&val);
-        encoders[i]=val;
-    }
-
-    //apply a limit on the difference between prev target and current target
-    for (unsigned int i=0; i< control_joints; i++)
-    {
+        //apply a limit on the difference between prev target and current target
         double diff = (targets[i]-prev_targets[i]);
         if      (diff > +target_limiter) targets[i]=prev_targets[i]+ target_limiter;
         else if (diff < -target_limiter) targets[i]=prev_targets[i]- target_limiter;
-    }
 
-    //slew rate limiter
-    for(unsigned int i = 0; i<control_joints; i++)
-    {
-        double diff = (targets[i]-encoders[i]);
+        //slew rate limiter
+        diff = (targets[i]-encoders[i]);
         if      (diff > +joints_limiter) targets[i]=encoders[i]+ joints_limiter;
         else if (diff < -joints_limiter) targets[i]=encoders[i]- joints_limiter;
     }
@@ -119,10 +111,8 @@ bool positionDirectControlThread::threadInit()
 
 void positionDirectControlThread::threadRelease()
 {
-    for(unsigned int i=0; i<control_joints; i++)
-    {
-       imod->setControlMode(control_joints_list[i], VOCAB_CM_POSITION);
-    }
+    std::vector<int> modes(control_joints,VOCAB_CM_POSITION);
+    imod->setControlModes(control_joints, control_joints_list, modes.data());
 
     suspended = true;
     command_port.close();
@@ -190,11 +180,9 @@ bool positionDirectControlThread::init(PolyDriver *d, std::string moduleName, st
     Vector speeds;
     speeds.resize(control_joints);
     speeds=10.0;
-    for (unsigned int i=0; i<control_joints; i++)
-    {
-        ipos->setRefSpeed(control_joints_list[i],speeds[i]);
-    }
+    ipos->setRefSpeeds(control_joints, control_joints_list, speeds.data());
 
+    part_encoders.resize(part_joints);
     encoders.resize(control_joints);
     targets.resize(control_joints);
     prev_targets.resize(control_joints);
@@ -215,17 +203,15 @@ bool positionDirectControlThread::init(PolyDriver *d, std::string moduleName, st
         max_limits[i]=max;
     }
 
-    for (unsigned int i=0; i<control_joints; i++)
-    {
-        imod->setControlMode(control_joints_list[i],VOCAB_CM_POSITION_DIRECT);
-    }
+    std::vector<int> modes(control_joints,VOCAB_CM_POSITION_DIRECT);
+    imod->setControlModes(control_joints, control_joints_list, modes.data());
 
     //get the current position
+    part_encoders.zero();
+    ienc->getEncoders(part_encoders.data());
     for (unsigned int i=0; i< control_joints; i++)
     {
-        double val =0;
-        ienc->getEncoder(control_joints_list[i],&val);
-        targets[i] = encoders[i] = val;
+        targets[i] = encoders[i] = part_encoders[control_joints_list[i]];
         prev_targets[i] = encoders[i];
     }
 
@@ -34,6 +34,7 @@ private:
 
     yarp::sig::Vector min_limits;
     yarp::sig::Vector max_limits;
+    yarp::sig::Vector part_encoders;
     yarp::sig::Vector encoders;
     
     yarp::sig::Vector targets;
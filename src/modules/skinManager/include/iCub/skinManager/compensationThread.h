@@ -21,6 +21,8 @@
 #define __COMPTHREAD_H__
 
 #include <mutex>
+#include <condition_variable>
+#include <thread>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -46,6 +48,24 @@ namespace iCub{
 
 namespace skinManager{
 
+/**
+ * The last samples of a latency, to compute its percentiles.
+ */
+class LatencyStats
+{
+public:
+    LatencyStats(size_t n=1000): samples(n, 0.0), next(0), count(0) {}
+    void add(double s);
+    // the values of the percentiles p (in [0, 1]) of the samples, 0 if there are none
+    void getPercentiles(const double *p, size_t n, double *values);
+
+private:
+    vector<double> samples;             // the last samples, in a ring buffer
+    size_t next;                        // position of the next sample
+    size_t count;                       // number of samples, up to samples.size()
+    vector<double> sorted;
+};
+
 class CompensationThread : public PeriodicThread
 {
 public:
@@ -136,9 +156,30 @@ private:
     vector<bool> compEnable;            // true if the related compensator is enabled, false otherwise
     vector<bool> compWorking;           // true if the related compensator is working, false otherwise
     unsigned int compensatorCounter;    // count the number of compensators that are working 
+    vector<skinContactList> portContacts;   // contacts of each compensator in the last cycle, merged by sendSkinEvents()
+
+    // WORKER POOL: the compensators are independent, so each of them can be run on a different thread
+    vector<thread> workers;             // the run thread works too, so with n workers there are n+1 parallel tasks
+    mutex poolSem;
+    condition_variable poolStart;       // signaled when a new cycle starts (or the pool is stopped)
+    condition_variable poolDone;        // signaled when the last task of a cycle is done
+    unsigned int poolCycle;             // incremented at every cycle
+    unsigned int nextTask;              // next compensator to process in the current cycle
+    unsigned int tasksDone;             // compensators processed in the current cycle
+    bool poolStop;
 
     // SKIN EVENTS
     bool skinEventsOn;
+    bool skinEventsCompact;             // if true the skin events are sent with the compact binary encoding
+    bool skinEventsTaxelList;           // if false the compact encoding does not include the taxel lists
+
+    // LATENCY of the skin data from the time the device has received them (the envelope of the input ports, which
+    // EmbObjSkin and CanBusSkin set to the time of reception) to the read by the compensator (input), to the contacts
+    // (compensation) and to the write of the skin events (output)
+    enum { LATENCY_INPUT, LATENCY_COMPENSATION, LATENCY_OUTPUT, LATENCY_STAGES };
+    LatencyStats latency[LATENCY_STAGES];
+    vector<int> latencySeq;             // sequence number of the last data of each port whose latency has been taken
+    vector<double> compensationEnd;     // time at which compensate() has finished with each port
 
     /* ports */
     BufferedPort<skinContactList> skinEventsPort;   // skin events output port
@@ -155,6 +196,13 @@ private:
     void sendDebugMsg(string msg);
     void sendErrorMsg(string msg);
     void sendSkinEvents();
+    void updateLatency(double outputTime);
+    void compensate(unsigned int i);
+    void compensateAll();
+    bool runTasks();
+    void workerLoop();
+    void startWorkers(unsigned int n);
+    void stopWorkers();
 
 };
 
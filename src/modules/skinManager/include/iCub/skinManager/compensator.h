@@ -20,6 +20,7 @@
 #define __COMP_H__
 
 #include <mutex>
+#include <memory>
 #include <iostream>
 #include <string>
 #include <sstream>
@@ -41,6 +42,7 @@
 #include "iCub/skinDynLib/skinContactList.h"
 #include "iCub/skinDynLib/rpcSkinManager.h"
 #include "iCub/skinDynLib/common.h"
+#include "iCub/skinDynLib/neighborGrid.h"
 
 using namespace std;
 using namespace yarp::os; 
@@ -71,17 +73,52 @@ private:
     unsigned int linkNum;                       // number of the link
 
     // SKIN CONTACTS
-    vector< list<int> >     neighborsXtaxel;    // list of neighbors for each taxel    
-    vector<Vector>          taxelPos;           // taxel positions {xPos, yPos, zPos}
-    vector<Vector>          taxelOri;           // taxel normals {xOri, yOri, zOri}
-    Vector                  taxelPoseConfidence;// taxels pose estimation confidence
-    double                  maxNeighDist;       // max distance between two neighbor taxels
-    mutex                   poseSem;            // mutex to access taxel poses
+    // the taxel geometry is never modified once published: the setters build a new one and swap it in,
+    // so that getContacts() and the getters never wait for them
+    struct TaxelGeometry {
+        vector<Vector>          taxelPos;           // taxel positions {xPos, yPos, zPos}
+        vector<Vector>          taxelOri;           // taxel normals {xOri, yOri, zOri}
+        Vector                  taxelPoseConfidence;// taxels pose estimation confidence
+        double                  maxNeighDist;       // max distance between two neighbor taxels
+        neighborGrid            taxelGrid;          // the taxel positions in a grid, to find the neighbors
+        vector< vector<int> >   neighborsXtaxel;    // list of neighbors for each taxel
+        bool                    neighborsAll;       // true if every taxel is neighbor with all the other taxels (neighborsXtaxel is not filled)
+        vector<int>             neighborsStart;     // neighbors of taxel i: neighbors[neighborsStart[i]] ... neighbors[neighborsStart[i+1]-1]
+        vector<int>             neighbors;          // neighbors of all the taxels, one after the other (CSR), as used by getContacts()
+    };
+    shared_ptr<const TaxelGeometry> geometry;   // the published geometry, accessed only through atomic_load/atomic_store
+    mutex                   poseSem;            // mutex to serialize the setters of the taxel poses
+
+    // accumulators of the contacts of a taxel patch
+    struct ContactAccumulator {
+        double CoP[3], geoCenter[3], normal[3];
+        double pressure, pressureCoP, pressureNormal;
+        int activeTaxelsGeo;
+    };
+
+    // work buffers of getContacts(), kept to avoid allocations at every cycle
+    vector<int>             contactParent;      // union-find of the active taxels: -1 if not active, the root is the smallest taxel of the contact
+    vector<int>             contactOfTaxel;     // index of the contact of a root taxel
+    vector<int>             contactStart;       // taxels of contact c: contactTaxels[contactStart[c]] ... contactTaxels[contactStart[c+1]-1]
+    vector<unsigned int>    contactTaxels;
+    vector<ContactAccumulator> contactAcc;
+
+    // contact tracking: a contact keeps the id of the contact of the previous cycle it shares most taxels with
+    struct ContactMatch {
+        int overlap;                            // number of taxels shared by the two contacts
+        unsigned int contact;                   // index of the contact in the list of this cycle
+        unsigned long id;                       // id of the contact of the previous cycle
+    };
+    vector<unsigned long>   taxelContactId;     // id of the contact of each taxel in the previous cycle, 0 if none
+    vector<unsigned int>    trackedTaxels;      // the taxels with a non-zero taxelContactId
+    vector<unsigned long>   overlapIds;
+    vector<ContactMatch>    contactMatches;
 
     // COMPENSATION
-    vector<bool> touchDetected;                 // true if touch has been detected in the last read of the taxel
-    vector<bool> touchDetectedFilt;             // true if touch has been detected after applying the filtering
-    vector<bool> subTouchDetected;              // true if the taxel value has gone under the baseline (because of touch in neighbouring taxels)
+    // the flags are bytes rather than vector<bool> so that the compensation loop is not slowed down by the bit packing
+    vector<unsigned char> touchDetected;        // true if touch has been detected in the last read of the taxel
+    vector<unsigned char> touchDetectedFilt;    // true if touch has been detected after applying the filtering
+    vector<unsigned char> subTouchDetected;     // true if the taxel value has gone under the baseline (because of touch in neighbouring taxels)
     Vector rawData;                             // data read from the skin
     Vector touchThresholds;                     // thresholds for discriminating between "touch" and "no touch"
     mutex touchThresholdSem;                    // semaphore for controlling the access to the touchThreshold
@@ -115,20 +152,27 @@ private:
     bool smoothFilter;                  // if true the smooth filter is on, otherwise it is off
     float smoothFactor;                 // intensity of the smooth filter action
     mutex smoothFactorSem;
+    static mutex infoPortSem;           // the info port is shared by all the compensators, which may run in parallel
 
     /* ports */
     BufferedPort<Vector> compensatedTactileDataPort;    // output port
     BufferedPort<Bottle>* infoPort;                     // info output port
     BufferedPort<Vector> inputPort;
     Stamp timestamp;                                    // timestamp of last data read from inputPort
+    double readTime;                                    // time at which the last data have been read from inputPort
 
     
     /* class private methods */        
     bool init(string name, string robotName, string outputPortName, string inputPortName);
     bool readInputData(Vector& skin_values);
     void sendInfoMsg(string msg);
-    void computeNeighbors();
-    void updateNeighbors(unsigned int taxelId);
+    shared_ptr<const TaxelGeometry> getGeometry() const { return atomic_load(&geometry); }
+    shared_ptr<TaxelGeometry> editGeometry();
+    void publishGeometry(const shared_ptr<TaxelGeometry> &geo);
+    void computeNeighbors(TaxelGeometry &geo);
+    void updateNeighbors(TaxelGeometry &geo, unsigned int taxelId);
+    int findContactRoot(int taxel);
+    void trackContacts(skinContactList &contacts);
 
     /* class methods */
 public:
@@ -184,6 +228,7 @@ public:
     Vector getRawData(){        return rawData; }
     Vector getCompData(){       return compensatedData; }
     Stamp getTimestamp(){       return timestamp; }
+    double getReadTime(){       return readTime; }
     
     string getName(){           return name; }
     string getInputPortName(){  return tactileSensorDevice->getValue("remote").asString().c_str(); }
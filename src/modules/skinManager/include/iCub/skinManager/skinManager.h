@@ -103,6 +103,9 @@ The following key-value pairs can be specified as command-line parameters by pre
     \t- y(t) = (1-alpha)*x(t) + alpha*y(t-1)
  - \c smoothFactor \c [0.5] \n
    alpha value of the smoothing filter, in [0, 1] where 0 is no smoothing at all and 1 is the max smoothing possible.
+ - \c workers \c [0] \n
+   number of additional threads used to compensate the input ports (and compute their skin events) in parallel;
+   with 0 the ports are processed one after the other by the compensation thread.
 .
 An optional section called SKIN_EVENTS may be specified in the configuration file.
 These are the parameters of this section:
@@ -125,6 +128,11 @@ These are the parameters of this section:
     missing calibration procedure for that skin part).
  - \c maxNeighborDist \c 0.015 \n
     maximum distance between two neighbor tactile sensors (in meters).
+ - \c compactEncoding \c [false] \n
+    if true the skin events are sent with the compact binary encoding of skinContactList (see skinContactList::setCompactEncoding()),
+    which is much smaller and faster to parse; the readers need a skinDynLib which supports it.
+ - \c omitTaxelList \c [false] \n
+    if true the compact encoding does not include the lists of the active taxels, but only their number.
  
 
 \section portsa_sec Ports Accessed
@@ -144,7 +152,11 @@ will be accessed.
 - "/"+moduleName+"/monitor:o": \n 
     outputs a yarp::os::Bottle containing streaming information regarding the compensation status 
     (used to communicate with the skinManagerGui). The first value is the data frequency, while
-    all the following ones represent the drift compensated so far for each taxel.
+    all the following ones represent the drift compensated so far for each taxel, then the raw data of each taxel.
+    The last 12 values are the latencies of the skin data (median, 90th and 99th percentile, max, in ms, over
+    the last 1000 samples) from the time they have been received by the device (the envelope of the input ports)
+    to their read by the compensator, from their read to the contacts, and from the device to the skin events.
+    The device and the skinManager must run on the same clock.
 - "/"+moduleName+"/info:o": \n 
     outputs a yarp::os::Bottle containing occasional information regarding the compensation status 
     such as warning or error messages (used to communicate with the skinManagerGui). Possible messages may regard 
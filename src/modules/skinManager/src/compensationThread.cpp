@@ -20,6 +20,7 @@
 #include <yarp/math/Math.h>
 #include "math.h"
 #include "memory.h"
+#include <algorithm>
 #include "iCub/skinManager/compensationThread.h"
 
 #define FOR_ALL_PORTS(i) for(unsigned int i=0;i<portNum;i++)
@@ -30,6 +31,24 @@ using namespace yarp::sig;
 using namespace yarp::math;
 using namespace iCub::skinManager;
 
+void LatencyStats::add(double s){
+    samples[next] = s;
+    next = (next+1) % samples.size();
+    if(count < samples.size())
+        count++;
+}
+
+void LatencyStats::getPercentiles(const double *p, size_t n, double *values){
+    sorted.assign(samples.begin(), samples.begin()+count);
+    sort(sorted.begin(), sorted.end());
+    for(size_t k=0; k<n; k++){
+        if(sorted.empty())
+            values[k] = 0.0;
+        else
+            values[k] = sorted[min(sorted.size()-1, (size_t)(p[k]*(sorted.size()-1) + 0.5))];
+    }
+}
+
 
 CompensationThread::CompensationThread(string name, ResourceFinder* rf, string robotName, double _compensationGain, double _contactCompensationGain, 
                                        int addThreshold, float minBaseline, bool zeroUpRawData, 
@@ -135,6 +154,8 @@ bool CompensationThread::threadInit()
 
     // configure the SKIN_EVENT if the corresponding section exists
     skinEventsOn = false;
+    skinEventsCompact = false;
+    skinEventsTaxelList = true;
     Bottle &skinEventsConf = rf->findGroup("SKIN_EVENTS");
     if(!skinEventsConf.isNull()){
         yDebug("SKIN_EVENTS section found");
@@ -144,6 +165,12 @@ bool CompensationThread::threadInit()
         else
             skinEventsOn = true;
 
+        skinEventsCompact = skinEventsConf.check("compactEncoding", Value(false)).asBool();
+        skinEventsTaxelList = !skinEventsConf.check("omitTaxelList", Value(false)).asBool();
+        if(skinEventsCompact)
+            sendDebugMsg(skinEventsTaxelList ? "Skin events sent with the compact encoding." :
+                                               "Skin events sent with the compact encoding, without the taxel lists.");
+
         if(skinEventsConf.check("skinParts")){
             Bottle* skinPartList = skinEventsConf.find("skinParts").asList();
             if(skinPartList->size() != portNum){
@@ -189,6 +216,19 @@ bool CompensationThread::threadInit()
         sendDebugMsg("Skin events ENABLED.");
     else
         sendDebugMsg("Skin events DISABLED.");
+    portContacts.resize(portNum);
+    latencySeq.assign(portNum, -1);
+    compensationEnd.assign(portNum, 0.0);
+
+    // with more than one port the compensators can run in parallel
+    int workerNum = rf->check("workers", Value(0)).asInt32();
+    if(workerNum >= (int)compensatorCounter)
+        workerNum = compensatorCounter-1;
+    if(workerNum > 0){
+        startWorkers(workerNum);
+        stringstream msg; msg<< "Compensating the "<< compensatorCounter<< " ports with "<< workerNum+1<< " parallel tasks.";
+        sendDebugMsg(msg.str());
+    }
 
     initializationFinished = true;
     return true;
@@ -208,18 +248,12 @@ void CompensationThread::run(){
     if( state == compensation){
         // It reads the raw data, computes the difference between the read values and the baseline 
         // and outputs these values
-        FOR_ALL_PORTS(i){
-            if(compWorking[i]){
-                if(compensators[i]->readRawAndWriteCompensatedData()){
-                    //If the read succeeded, update the baseline
-                    compensators[i]->updateBaseline();
-                }
-            }
-        }
+        compensateAll();
 
         if(skinEventsOn){
             sendSkinEvents();
         }
+        updateLatency(Time::now());
     }
     else if(state == calibration){
         FOR_ALL_PORTS(i){    
@@ -251,14 +285,14 @@ void CompensationThread::run(){
 void CompensationThread::sendSkinEvents(){
     skinContactList &skinEvents = skinEventsPort.prepare();
     skinEvents.clear();
+    skinEvents.setCompactEncoding(skinEventsCompact, skinEventsTaxelList);
 
-    skinContactList temp;
+    // the contacts have been computed by compensate(), here they are only merged
     Stamp timestamp;
     FOR_ALL_PORTS(i){
         if(compWorking[i] && compEnable[i]){
-            temp = compensators[i]->getContacts();
             timestamp = compensators[i]->getTimestamp();
-            skinEvents.insert(skinEvents.end(), temp.begin(), temp.end());
+            skinEvents.insert(skinEvents.end(), portContacts[i].begin(), portContacts[i].end());
         }
     }
 #ifdef _DEBUG
@@ -271,6 +305,120 @@ void CompensationThread::sendSkinEvents(){
     skinEventsPort.write();     // send something anyway (if there is no contact the bottle is empty)
 }
 
+// the work of a single port in the compensation state: read, compensate, update the baseline and compute the contacts
+void CompensationThread::compensate(unsigned int i){
+    if(!compWorking[i])
+        return;
+    if(compensators[i]->readRawAndWriteCompensatedData()){
+        //If the read succeeded, update the baseline
+        compensators[i]->updateBaseline();
+    }
+    if(skinEventsOn && compEnable[i])
+        portContacts[i] = compensators[i]->getContacts();
+    compensationEnd[i] = Time::now();
+}
+
+// the latencies of the ports which have read new data in this cycle
+void CompensationThread::updateLatency(double outputTime){
+    FOR_ALL_PORTS(i){
+        if(!compWorking[i])
+            continue;
+        Stamp stamp = compensators[i]->getTimestamp();
+        if(stamp.getCount()==latencySeq[i] || stamp.getTime()<=0.0)
+            continue;           // no new data, or the source does not give the timestamp
+        latencySeq[i] = stamp.getCount();
+
+        double readTime = compensators[i]->getReadTime();
+        latency[LATENCY_INPUT].add(readTime - stamp.getTime());
+        latency[LATENCY_COMPENSATION].add(compensationEnd[i] - readTime);
+        if(skinEventsOn && compEnable[i])
+            latency[LATENCY_OUTPUT].add(outputTime - stamp.getTime());
+    }
+}
+
+void CompensationThread::compensateAll(){
+    if(workers.empty()){
+        FOR_ALL_PORTS(i)
+            compensate(i);
+        return;
+    }
+
+    {
+        lock_guard<mutex> lck(poolSem);
+        nextTask = 0;
+        tasksDone = 0;
+        poolCycle++;
+    }
+    poolStart.notify_all();
+
+    // the run thread takes its share of the tasks, then it waits for the ones still running on the workers
+    while(runTasks());
+    unique_lock<mutex> lck(poolSem);
+    poolDone.wait(lck, [this]{ return tasksDone == portNum; });
+}
+
+// it processes the next task of the current cycle, it returns false if there are no more tasks to start
+bool CompensationThread::runTasks(){
+    unsigned int i;
+    {
+        lock_guard<mutex> lck(poolSem);
+        if(nextTask >= portNum)
+            return false;
+        i = nextTask++;
+    }
+
+    compensate(i);
+
+    bool last;
+    {
+        lock_guard<mutex> lck(poolSem);
+        last = (++tasksDone == portNum);
+    }
+    if(last)
+        poolDone.notify_one();
+    return true;
+}
+
+void CompensationThread::workerLoop(){
+    unsigned int cycle;
+    {
+        lock_guard<mutex> lck(poolSem);
+        cycle = poolCycle;
+    }
+    while(true){
+        {
+            unique_lock<mutex> lck(poolSem);
+            poolStart.wait(lck, [&]{ return poolStop || poolCycle != cycle; });
+            if(poolStop)
+                return;
+            cycle = poolCycle;
+        }
+        while(runTasks());
+    }
+}
+
+void CompensationThread::startWorkers(unsigned int n){
+    poolCycle = 0;
+    nextTask = portNum;     // no task until the first cycle
+    tasksDone = portNum;
+    poolStop = false;
+    for(unsigned int w=0; w<n; w++)
+        workers.push_back(thread(&CompensationThread::workerLoop, this));
+}
+
+void CompensationThread::stopWorkers(){
+    if(workers.empty())
+        return;
+    {
+        lock_guard<mutex> lck(poolSem);
+        poolStop = true;
+    }
+    poolStart.notify_all();
+    for(size_t w=0; w<workers.size(); w++)
+        workers[w].join();
+    workers.clear();
+}
+
 void CompensationThread::checkErrors(){
     FOR_ALL_PORTS(i){
         if(compWorking[i]){
@@ -317,6 +465,7 @@ bool CompensationThread::doesBaselineExceed(unsigned int &compInd, unsigned int
 
 void CompensationThread::threadRelease() 
 {
+    stopWorkers();
     FOR_ALL_PORTS(i){
         delete compensators[i];
     }
@@ -339,7 +488,7 @@ void CompensationThread::sendMonitorData(){
 
         Vector &b = monitorPort.prepare();
         b.clear();        
-        b.resize(1+ 2*originalSkinDim);
+        b.resize(1+ 2*originalSkinDim + 4*LATENCY_STAGES, 0.0);
         b[0] = 1.0/getEstimatedPeriod(); // thread frequency
         
         stateSem.lock();
@@ -360,6 +509,15 @@ void CompensationThread::sendMonitorData(){
             }
         }
         stateSem.unlock();
+
+        // for each stage the median, the 90th and the 99th percentiles and the max of the latency, in ms
+        const double p[4] = { 0.5, 0.9, 0.99, 1.0 };
+        double values[4];
+        for(int s=0; s<LATENCY_STAGES; s++){
+            latency[s].getPercentiles(p, 4, values);
+            for(int k=0; k<4; k++)
+                b[1+ 2*originalSkinDim + 4*s + k] = 1e3*values[k];
+        }
         //printf("Writing %d data on monitor port\n", b.size());
         monitorPort.write();
     }
@@ -21,6 +21,7 @@
 #include "math.h"
 #include <algorithm>
 #include "iCub/skinManager/compensator.h"
+#include "iCub/skinDynLib/taxelPositionFile.h"
 
 
 using namespace std;
@@ -33,6 +34,8 @@ using namespace iCub::skinDynLib;
 const double Compensator::BIN_TOUCH     = 100.0;
 const double Compensator::BIN_NO_TOUCH  = 0.0;
 
+mutex Compensator::infoPortSem;
+
 Compensator::Compensator(string _name, string _robotName, string outputPortName, string inputPortName, BufferedPort<Bottle>* _infoPort, 
                          double _compensationGain, double _contactCompensationGain, int addThreshold, float _minBaseline, bool _zeroUpRawData, 
                          bool _binarization, bool _smoothFilter, float _smoothFactor, unsigned int _linkNum)
@@ -59,6 +62,14 @@ Compensator::~Compensator(){
 bool Compensator::init(string name, string robotName, string outputPortName, string inputPortName){
     skinPart = SKIN_PART_UNKNOWN;
     bodyPart = BODY_PART_UNKNOWN;
+    readTime = 0.0;
+    {
+        // no taxels until their number is known
+        shared_ptr<TaxelGeometry> geo = make_shared<TaxelGeometry>();
+        geo->maxNeighDist = MAX_NEIGHBOR_DISTANCE;
+        geo->neighborsAll = true;
+        publishGeometry(geo);
+    }
 
     if (!compensatedTactileDataPort.open(outputPortName.c_str())) {
         stringstream msg; msg<< "Unable to open output port "<< outputPortName;
@@ -129,16 +140,14 @@ bool Compensator::init(string name, string robotName, string outputPortName, str
     compensatedData.resize(skinDim);
     compensatedDataOld.resize(skinDim);
     compensatedDataFilt.resize(skinDim);
-    taxelPos.resize(skinDim, zeros(3));
-    taxelOri.resize(skinDim, zeros(3));
-    taxelPoseConfidence.resize(skinDim,0.0);
-    maxNeighDist = MAX_NEIGHBOR_DISTANCE;
-    // by default every taxel is neighbor with all the other taxels
-    list<int> defaultNeighbors(skinDim);
-    int i=0;
-    for(list<int>::iterator it=defaultNeighbors.begin();it!=defaultNeighbors.end();it++, i++) 
-        *it = i;
-    neighborsXtaxel.resize(skinDim, defaultNeighbors);
+    shared_ptr<TaxelGeometry> geo = make_shared<TaxelGeometry>();
+    geo->taxelPos.resize(skinDim, zeros(3));
+    geo->taxelOri.resize(skinDim, zeros(3));
+    geo->taxelPoseConfidence.resize(skinDim,0.0);
+    geo->maxNeighDist = MAX_NEIGHBOR_DISTANCE;
+    // by default every taxel is neighbor with all the other taxels (as all the positions are zero)
+    geo->neighborsAll = true;
+    publishGeometry(geo);
 
     // test read to check if the skin is broken (all taxel output is 0)
     if(robotName!="icubSim" && readInputData(compensatedData)){
@@ -284,6 +293,7 @@ bool Compensator::readInputData(Vector& skin_values){
     }
     //try to read envelope of input data port
     inputPort.getEnvelope(timestamp);
+    readTime = Time::now();
 
     skin_values = *tmp; // copy data
 
@@ -334,6 +344,44 @@ bool Compensator::readInputData(Vector& skin_values){
     return true;*/
 }
 
+// the compensation of a block of taxels. the options are template parameters, so that the loops have no branch. the first loop
+// uses only doubles and the second one computes the flags, so that the compiler can vectorize the first one (and also the second
+// one if the target has wide enough registers). the blocks are small enough to stay in the cache between the two loops.
+template<bool smooth, bool binarize>
+static void compensateBlock(unsigned int n, const double * __restrict raw, const double * __restrict baselines, const double * __restrict thresholds,
+                            double addThreshold, double rawSign, double rawOffset, double maxSkin, double smoothNew, double smoothOld,
+                            double binTouch, double binNoTouch, double * __restrict comp, double * __restrict compOld, double * __restrict compFilt,
+                            double * __restrict out, unsigned char * __restrict touch, unsigned char * __restrict subTouch, unsigned char * __restrict touchFilt)
+{
+    for(unsigned int i=0; i<n; i++){
+        // baseline compensation
+        double d = rawOffset + rawSign*raw[i] - baselines[i];
+        d = (d < maxSkin) ? d : maxSkin;
+        comp[i] = d;                // save the data before applying filtering
+
+        // smooth filter
+        if(smooth){
+            d = smoothNew*d + smoothOld*compOld[i];
+            compOld[i] = d;         // update old value
+        }
+        compFilt[i] = d;
+
+        // binarization filter: it uses the filtered values
+        if(binarize)
+            d = (d > thresholds[i] + addThreshold) ? binTouch : binNoTouch;
+
+        out[i] = (d > 0.0) ? d : 0.0;   // trim only data to send because you need negative values for update baseline
+    }
+
+    for(unsigned int i=0; i<n; i++){
+        // touch and subtouch are detected before applying filtering, so the compensation algorithm is not affected by the filters
+        double thr = thresholds[i] + addThreshold;
+        touch[i] = (comp[i] > thr);
+        subTouch[i] = (comp[i] < -thr);
+        touchFilt[i] = (compFilt[i] > thr);
+    }
+}
+
 bool Compensator::readRawAndWriteCompensatedData(){    
     if(!readInputData(rawData))
         return false;
@@ -341,106 +389,63 @@ bool Compensator::readRawAndWriteCompensatedData(){
     Vector& compensatedData2Send = compensatedTactileDataPort.prepare();
     compensatedData2Send.resize(skinDim);   // local variable with data to send
     compensatedData.resize(skinDim);        // global variable with data to store
-    
-    double d;
-    for(unsigned int i=0; i<skinDim; i++){
-        // baseline compensation
-        d =  (double)( zeroUpRawData ? rawData(i)-baselines[i] : MAX_SKIN-rawData(i)-baselines[i] );
-        d =   min<double>( MAX_SKIN, d);
-        compensatedData[i] = d;     // save the data before applying filtering
 
-        // detect touch (before applying filtering, so the compensation algorithm is not affected by the filters)
-        touchDetected[i] = (d > touchThresholds[i] + addThreshold);
-        
-        // detect subtouch
-        subTouchDetected[i] = (d < -touchThresholds[i] - addThreshold);
-        
-        // smooth filter
-        if(smoothFilter){
-            lock_guard<mutex> lck(smoothFactorSem);
-            d = (1-smoothFactor)*d + smoothFactor*compensatedDataOld(i);
-            compensatedDataOld(i) = d;    // update old value
-        }
-        compensatedDataFilt[i] = d;
-
-        // binarization filter
-        // here we don't use the touchDetected array because, if the smooth filter is on,
-        // we want to use the filtered values
-        touchDetectedFilt[i] = (d > touchThresholds[i] + addThreshold);
-        if(binarization)
-            d = ( touchDetectedFilt[i] ? BIN_TOUCH : BIN_NO_TOUCH );
-        
-        compensatedData2Send[i] = max<double>(0.0, d); // trim only data to send because you need negative values for update baseline
+    // zeroUpRawData: raw-baseline, otherwise MAX_SKIN-raw-baseline
+    double rawSign   = zeroUpRawData ? 1.0 : -1.0;
+    double rawOffset = zeroUpRawData ? 0.0 : (double)MAX_SKIN;
+    double smoothNew, smoothOld;
+    {
+        lock_guard<mutex> lck(smoothFactorSem);
+        smoothNew = (1-smoothFactor);
+        smoothOld = smoothFactor;
+    }
+
+    typedef void (*kernel_t)(unsigned int, const double*, const double*, const double*, double, double, double, double, double, double, double, double,
+                             double*, double*, double*, double*, unsigned char*, unsigned char*, unsigned char*);
+    kernel_t kernel = smoothFilter ? (binarization ? compensateBlock<true, true> : compensateBlock<true, false>)
+                                   : (binarization ? compensateBlock<false, true> : compensateBlock<false, false>);
+    const unsigned int block = 256;
+    for(unsigned int i=0; i<skinDim; i+=block){
+        unsigned int n = min(block, skinDim-i);
+        kernel(n, &rawData[i], &baselines[i], &touchThresholds[i], (double)addThreshold,
+               rawSign, rawOffset, (double)MAX_SKIN, smoothNew, smoothOld, BIN_TOUCH, BIN_NO_TOUCH,
+               &compensatedData[i], &compensatedDataOld[i], &compensatedDataFilt[i], &compensatedData2Send[i],
+               &touchDetected[i], &subTouchDetected[i], &touchDetectedFilt[i]);
     }
 
+    compensatedTactileDataPort.setEnvelope(timestamp);  // the timestamp of the source, not of the compensation
     compensatedTactileDataPort.write();
     return true;
 }
 
 void Compensator::updateBaseline(){
-    double mean_change = 0, change, gain;
-    unsigned int non_touching_taxels = 0;
-    double d; 
+    // *** Algorithm 1 and 2 (removed): see the history of this file
+    const double touchGain   = contactCompensationGain*0.02;
+    const double noTouchGain = compensationGain*0.02;
+    double *b = baselines.data();
+    const double *d = compensatedData.data();
+    const double *thr = touchThresholds.data();
+    const unsigned char *touch = touchDetected.data();
+    bool negative = false;
 
     for(unsigned int j=0; j<skinDim; j++) {
-        // *** Algorithm 1
-        /*if(!touchDetected[j]){
-            if(d > 0.5) {
-                baselines[j]        += compensationGain;
-                mean_change            += compensationGain;                //for changing the taxels where we detected touch
-            }else if(d < -0.5) {
-                baselines[j]        -= compensationGain;
-                mean_change            -= compensationGain;                //for changing the taxels where we detected touch
-            }
-        }*/
-
-        // *** Algorithm 2
-        /*if(!(touchDetected[j] || subTouchDetected[j])){
-            non_touching_taxels++;                                        //for changing the taxels where we detected touch
-            d = compensatedData(j);
-            if(fabs(d)>0.5){
-                change          = (compensationGain/50)*d/touchThresholds[j];
-                baselines[j]    += change;
-                mean_change     += change;
-            }
-        }*/
-    
-        d = compensatedData(j);
-        if(touchDetected[j]){
-            gain            = contactCompensationGain*0.02;                
-        }else{
-            gain            = compensationGain*0.02;
-            non_touching_taxels++;
-        }
-        change          = gain*d/touchThresholds[j];
-        baselines[j]    += change;
-        mean_change     += change;
-
-    //        if(j<5)
-    //        printf("%d touch detected %s, change %.6f, gain: %.3f\n", j, touchDetected[j]?"yes":"no", change, touchDetected[j]?contactCompensationGain:compensationGain);
-
-        if(baselines[j]<0){
-            char* temp = new char[300];
-            sprintf(temp, "ERROR-Negative baseline. Port %s; tax %d; baseline %.2f; gain: %.4f; d: %.2f; raw: %.2f; change: %f; touchThr: %.2f", 
-                SkinPart_s[skinPart].c_str(), j, baselines[j], gain, d, rawData[j], change, touchThresholds[j]);
-            sendInfoMsg(temp);
-        }      
+        double gain = touch[j] ? touchGain : noTouchGain;
+        b[j] += gain*d[j]/thr[j];
+        negative |= (b[j] < 0);
     }
-    
-    //for compensating the taxels where we detected touch
-    /*if (non_touching_taxels>0 && non_touching_taxels<skinDim && mean_change!=0){
-        mean_change /= non_touching_taxels;
+
+    if(negative){
         for(unsigned int j=0; j<skinDim; j++) {
-            if (touchDetected[j]) {
-                baselines[j]        += mean_change;
-                if(baselines[j]<0){
-                    char* temp = new char[300];
-                    sprintf(temp, "ERROR-Negative baseline. Taxel %d; baseline %.2f; meanchange: %f", j, baselines[j], mean_change);
-                    sendInfoMsg(temp);
-                }
+            if(baselines[j]<0){
+                double gain = touchDetected[j] ? touchGain : noTouchGain;
+                double change = gain*compensatedData[j]/touchThresholds[j];
+                char* temp = new char[300];
+                sprintf(temp, "ERROR-Negative baseline. Port %s; tax %d; baseline %.2f; gain: %.4f; d: %.2f; raw: %.2f; change: %f; touchThr: %.2f", 
+                    SkinPart_s[skinPart].c_str(), j, baselines[j], gain, compensatedData[j], rawData[j], change, touchThresholds[j]);
+                sendInfoMsg(temp);
             }
         }
-    }*/
+    }
 }
 
 bool Compensator::doesBaselineExceed(unsigned int &taxelIndex, double &baseline, double &initialBaseline){
@@ -461,100 +466,196 @@ bool Compensator::doesBaselineExceed(unsigned int &taxelIndex, double &baseline,
     return false;
 }
 
-skinContactList Compensator::getContacts(){    
-    vector<int>         contactXtaxel(skinDim, -1);     // contact for each taxel (-1 means no contact)
-    deque<deque<int> >  taxelsXcontact;                 // taxels for each contact
-    int                 contactId = 0;                  // id of the next contact to create
-    int                 neighCont;                      // id of the contact of the current neighbor
+int Compensator::findContactRoot(int taxel){
+    // path halving: every visited taxel is linked to its grandparent
+    while(contactParent[taxel] != taxel){
+        contactParent[taxel] = contactParent[contactParent[taxel]];
+        taxel = contactParent[taxel];
+    }
+    return taxel;
+}
 
-    poseSem.lock();
-    {
-        for(unsigned int i=0; i<skinDim; i++){
-            if(touchDetectedFilt[i] ){ // && contactXtaxel[i]<0 (second condition should always be true)
-                list<int> *neighbors = &(neighborsXtaxel[i]);
-                //printf("Taxel %d active. Going to check its %d neighbors\n", i, neighbors->size());
-                for(list<int>::iterator it=neighbors->begin(); it!=neighbors->end(); it++){
-                    neighCont = contactXtaxel[(*it)];
-                    if(neighCont >= 0){                                     // ** if neighbor belongs to a contact
-                        if(contactXtaxel[i]<0){                             // ** add taxel to pre-existing contact
-                            contactXtaxel[i] = neighCont;
-                            taxelsXcontact[neighCont].push_back(i);
-                            //printf("Add taxel to pre existing contact %d (neighbor %d)\n", neighCont, (*neighbors)[n]);
-                        }else if(contactXtaxel[i]!=neighCont){              // ** merge 2 contacts
-                            //mergeContacts(contactXtaxel[i], neighCont);
-                            int newId = min(contactXtaxel[i], neighCont);
-                            int oldId = max(contactXtaxel[i], neighCont);
-                            deque<int> tax2move = taxelsXcontact[oldId];
-                            for(deque<int>::iterator it=tax2move.begin(); it!=tax2move.end(); it++){
-                                contactXtaxel[(*it)] = newId;               // assign new contact id
-                                taxelsXcontact[newId].push_back((*it));     // add taxel ids to contact
-                            }
-                            taxelsXcontact[oldId].clear();      // clear the list of taxels belonging to the merged contact
-                            //printf("Merge two contacts: %d and %d\n", oldId, newId);
-                        }
-                    }
+skinContactList Compensator::getContacts(){
+    skinContactList contactList;
+    contactParent.assign(skinDim, -1);
+    contactOfTaxel.resize(skinDim);
+    contactTaxels.resize(skinDim);
+    int contactNum = 0;
+
+    // the geometry of this cycle: the setters may publish a new one in the meantime
+    shared_ptr<const TaxelGeometry> geo = getGeometry();
+    const bool neighborsAll = geo->neighborsAll;
+    const vector<int> &neighborsStart = geo->neighborsStart;
+    const vector<int> &neighbors = geo->neighbors;
+    unsigned int taxelNum = min<size_t>(skinDim, touchDetectedFilt.size());
+    taxelNum = min<size_t>(taxelNum, min(geo->taxelPos.size(), geo->taxelOri.size()));
+    if(!neighborsAll && neighborsStart.size()<taxelNum+1)
+        taxelNum = neighborsStart.size()>0 ? neighborsStart.size()-1 : 0;
+
+    // ** the contacts are the connected sets of active taxels: each active taxel is joined with its active neighbors.
+    // the root of a set is always its smallest taxel, thus the contacts come out in order of their first taxel
+    int firstActive = -1;
+    for(unsigned int i=0; i<taxelNum; i++){
+        if(!touchDetectedFilt[i])
+            continue;
+        contactParent[i] = i;
+        if(neighborsAll){                               // ** all the active taxels make a single contact
+            if(firstActive < 0)     firstActive = i;
+            else                    contactParent[i] = firstActive;
+            continue;
+        }
+        for(int n=neighborsStart[i]; n<neighborsStart[i+1]; n++){
+            int j = neighbors[n];
+            if((unsigned int)j >= taxelNum || contactParent[j] < 0)    // neighbor not active (yet)
+                continue;
+            int ri = findContactRoot(i);
+            int rj = findContactRoot(j);
+            if(ri < rj)         contactParent[rj] = ri;
+            else if(rj < ri)    contactParent[ri] = rj;
+        }
+    }
 
-                }
-                if(contactXtaxel[i]<0){            // ** if no neighbor belongs to a contact -> create new contact
-                    contactXtaxel[i] = contactId;
-                    taxelsXcontact.resize(contactId+1);
-                    taxelsXcontact[contactId].push_back(i);
-                    contactId++;
-                    //printf("New contact created: %d\n", contactId-1);
-                }
+    // ** the contact of each active taxel: the roots get the contact ids in increasing order
+    for(unsigned int i=0; i<taxelNum; i++){
+        if(contactParent[i] < 0)
+            continue;
+        int r = findContactRoot(i);
+        contactParent[i] = r;                           // from now on the parent of a taxel is its root
+        contactOfTaxel[i] = (r == (int)i) ? contactNum++ : contactOfTaxel[r];
+    }
+    if(contactNum == 0){
+        trackContacts(contactList);
+        return contactList;
+    }
+
+    // ** the taxels of each contact, with a counting sort on the contact id
+    contactStart.assign(contactNum+1, 0);
+    for(unsigned int i=0; i<taxelNum; i++){
+        if(contactParent[i] >= 0)
+            contactStart[contactOfTaxel[i]+1]++;
+    }
+    for(int c=0; c<contactNum; c++)
+        contactStart[c+1] += contactStart[c];
+
+    ContactAccumulator zero;
+    for(int k=0; k<3; k++)
+        zero.CoP[k] = zero.geoCenter[k] = zero.normal[k] = 0.0;
+    zero.pressure = zero.pressureCoP = zero.pressureNormal = 0.0;
+    zero.activeTaxelsGeo = 0;
+    contactAcc.assign(contactNum, zero);
+
+    // ** the accumulators of CoP, normal and pressure of each contact. contactStart[c] is moved to the end of
+    // the taxels of contact c while filling them, then it is moved back
+    for(unsigned int i=0; i<taxelNum; i++){
+        if(contactParent[i] < 0)
+            continue;
+        int c = contactOfTaxel[i];
+        contactTaxels[contactStart[c]++] = i;
+
+        ContactAccumulator &acc = contactAcc[c];
+        double out = max(compensatedDataFilt[i], 0.0);
+        const Vector &pos = geo->taxelPos[i];
+        const Vector &ori = geo->taxelOri[i];
+        if(pos[0]!=0.0 || pos[1]!=0.0 || pos[2]!=0.0){     // if the taxel position estimate exists
+            for(int k=0; k<3; k++){
+                acc.CoP[k]       += pos[k] * out;
+                acc.geoCenter[k] += pos[k];
             }
+            acc.pressureCoP += out;
+            acc.activeTaxelsGeo++;
+        }
+        if(ori[0]!=0.0 || ori[1]!=0.0 || ori[2]!=0.0){     // if the taxel orientation estimate exists
+            for(int k=0; k<3; k++)
+                acc.normal[k] += ori[k] * out;
+            acc.pressureNormal += out;
         }
+        acc.pressure += out;
     }
-    poseSem.unlock();
+    for(int c=contactNum; c>0; c--)
+        contactStart[c] = contactStart[c-1];
+    contactStart[0] = 0;
 
-    skinContactList contactList;
-    Vector CoP(3), geoCenter(3), normal(3);
-    double pressure, pressureCoP, pressureNormal, out;
-    int activeTaxels, activeTaxelsGeo;
     vector<unsigned int> taxelList;
-    for( deque<deque<int> >::iterator it=taxelsXcontact.begin(); it!=taxelsXcontact.end(); it++){
-        activeTaxels = it->size();
-        if(activeTaxels==0) continue;
-        
-        taxelList.resize(activeTaxels);
-        CoP.zero();
-        geoCenter.zero();
-        normal.zero();
-        pressure = pressureCoP = pressureNormal = 0.0;
-        activeTaxelsGeo = 0;
-        int i=0;
-        for( deque<int>::iterator tax=it->begin(); tax!=it->end(); tax++, i++){
-            out         = max(compensatedDataFilt[(*tax)], 0.0);
-            if(norm(taxelPos[(*tax)])!=0.0){  // if the taxel position estimate exists
-                CoP         += taxelPos[(*tax)] * out;
-                pressureCoP += out;
-                activeTaxelsGeo++;
-                geoCenter   += taxelPos[(*tax)];
-            }
-            if(norm(taxelOri[(*tax)])!=0.0){  // if the taxel orientation estimate exists
-                normal          += taxelOri[(*tax)] * out;
-                pressureNormal  += out;
-            }
-            pressure    += out;
-            taxelList[i] = *tax;
-        }
+    Vector CoP(3), geoCenter(3), normal(3);
+    for(int c=0; c<contactNum; c++){
+        const ContactAccumulator &acc = contactAcc[c];
+        int activeTaxels = contactStart[c+1] - contactStart[c];
         // if this is not the only contact and no taxel in this contact has a position => discard it
-        if(taxelsXcontact.size()>1 && activeTaxelsGeo==0)
+        if(contactNum>1 && acc.activeTaxelsGeo==0)
             continue;
-        if(pressureCoP!=0.0)        CoP         /= pressureCoP;
-        if(pressureNormal!=0.0)     normal      /= pressureNormal;
-        if(activeTaxelsGeo!=0)      geoCenter   /= activeTaxelsGeo;
-        pressure    /= activeTaxels;
-        skinContact c(bodyPart, skinPart, linkNum, CoP, geoCenter, taxelList, pressure, normal);
+        for(int k=0; k<3; k++){
+            CoP[k]       = (acc.pressureCoP!=0.0)       ? acc.CoP[k]/acc.pressureCoP : acc.CoP[k];
+            normal[k]    = (acc.pressureNormal!=0.0)    ? acc.normal[k]/acc.pressureNormal : acc.normal[k];
+            geoCenter[k] = (acc.activeTaxelsGeo!=0)     ? acc.geoCenter[k]/acc.activeTaxelsGeo : acc.geoCenter[k];
+        }
+        double pressure = acc.pressure / activeTaxels;
+        taxelList.assign(contactTaxels.begin()+contactStart[c], contactTaxels.begin()+contactStart[c+1]);
+        skinContact sc(bodyPart, skinPart, linkNum, CoP, geoCenter, taxelList, pressure, normal);
         // set an estimate of the force that is with normal direction and intensity equal to the pressure
-        c.setForce(-0.05*activeTaxels*pressure*normal);
-        contactList.push_back(c);
+        sc.setForce(-0.05*activeTaxels*pressure*normal);
+        contactList.push_back(sc);
     }
     //printf("ContactList: %s\n", contactList.toString().c_str());
-    
+
+    trackContacts(contactList);
     return contactList;
 }
 
+void Compensator::trackContacts(skinContactList &contacts){
+    taxelContactId.resize(skinDim, 0);
+
+    // ** the overlaps between the contacts of this cycle and the ones of the previous cycle
+    contactMatches.clear();
+    for(unsigned int c=0; c<contacts.size(); c++){
+        overlapIds.clear();
+        vector<unsigned int> taxels = contacts[c].getTaxelList();
+        for(size_t t=0; t<taxels.size(); t++)
+            if(taxels[t]<taxelContactId.size() && taxelContactId[taxels[t]]!=0)
+                overlapIds.push_back(taxelContactId[taxels[t]]);
+        sort(overlapIds.begin(), overlapIds.end());
+        for(size_t i=0; i<overlapIds.size(); ){
+            size_t j = i;
+            while(j<overlapIds.size() && overlapIds[j]==overlapIds[i])
+                j++;
+            ContactMatch m = { (int)(j-i), c, overlapIds[i] };
+            contactMatches.push_back(m);
+            i = j;
+        }
+    }
+
+    // ** the largest overlaps first: each old id goes to at most one contact, each contact gets at most one old id,
+    // the contacts without a match keep their new id
+    sort(contactMatches.begin(), contactMatches.end(), [](const ContactMatch &a, const ContactMatch &b){
+        if(a.overlap != b.overlap)  return a.overlap > b.overlap;
+        if(a.contact != b.contact)  return a.contact < b.contact;
+        return a.id < b.id;
+    });
+    vector<bool> matched(contacts.size(), false);
+    overlapIds.clear();                          // from now on the old ids already taken
+    for(size_t m=0; m<contactMatches.size(); m++){
+        const ContactMatch &cm = contactMatches[m];
+        if(matched[cm.contact] || find(overlapIds.begin(), overlapIds.end(), cm.id)!=overlapIds.end())
+            continue;
+        matched[cm.contact] = true;
+        overlapIds.push_back(cm.id);
+        contacts[cm.contact].setId(cm.id);
+    }
+
+    // ** the taxels of this cycle replace the ones of the previous cycle
+    for(size_t t=0; t<trackedTaxels.size(); t++)
+        taxelContactId[trackedTaxels[t]] = 0;
+    trackedTaxels.clear();
+    for(unsigned int c=0; c<contacts.size(); c++){
+        vector<unsigned int> taxels = contacts[c].getTaxelList();
+        for(size_t t=0; t<taxels.size(); t++){
+            if(taxels[t]<taxelContactId.size()){
+                taxelContactId[taxels[t]] = contacts[c].getId();
+                trackedTaxels.push_back(taxels[t]);
+            }
+        }
+    }
+}
+
 void Compensator::setSmoothFilter(bool value){
     if(smoothFilter != value){
         smoothFilter = value;
@@ -619,106 +720,108 @@ float Compensator::getSmoothFactor(){
     return smoothFactor;
 }
 Vector Compensator::getTaxelPosition(unsigned int taxelId){
-    if(taxelId>=skinDim)
+    shared_ptr<const TaxelGeometry> geo = getGeometry();
+    if(taxelId>=geo->taxelPos.size())
         return zeros(0);
-    lock_guard<mutex> lck(poseSem);
-    Vector res = taxelPos[taxelId];
-    res.push_back(taxelPoseConfidence[taxelId]);
+    Vector res = geo->taxelPos[taxelId];
+    res.push_back(geo->taxelPoseConfidence[taxelId]);
     return res;
 }
 vector<Vector> Compensator::getTaxelPositions(){
-    lock_guard<mutex> lck(poseSem);
-    vector<Vector> res = taxelPos;
+    shared_ptr<const TaxelGeometry> geo = getGeometry();
+    vector<Vector> res = geo->taxelPos;
     for(unsigned int i=0; i<res.size(); i++)
-        res[i].push_back(taxelPoseConfidence[i]);
+        res[i].push_back(geo->taxelPoseConfidence[i]);
     return res;
 }
 Vector Compensator::getTaxelOrientation(unsigned int taxelId){
-    if(taxelId>=skinDim)
+    shared_ptr<const TaxelGeometry> geo = getGeometry();
+    if(taxelId>=geo->taxelOri.size())
         return zeros(0);
-    lock_guard<mutex> lck(poseSem);
-    Vector res = taxelOri[taxelId];
-    res.push_back(taxelPoseConfidence[taxelId]);
+    Vector res = geo->taxelOri[taxelId];
+    res.push_back(geo->taxelPoseConfidence[taxelId]);
     return res;
 }
 vector<Vector> Compensator::getTaxelOrientations(){
-    lock_guard<mutex> lck(poseSem);
-    vector<Vector> res = taxelOri;
+    shared_ptr<const TaxelGeometry> geo = getGeometry();
+    vector<Vector> res = geo->taxelOri;
     for(unsigned int i=0; i<res.size(); i++)
-        res[i].push_back(taxelPoseConfidence[i]);
+        res[i].push_back(geo->taxelPoseConfidence[i]);
     return res;
 }
 Vector Compensator::getTaxelPose(unsigned int taxelId){
-    if(taxelId>=skinDim)
+    shared_ptr<const TaxelGeometry> geo = getGeometry();
+    if(taxelId>=geo->taxelPos.size())
         return zeros(0);
-    lock_guard<mutex> lck(poseSem);
-    Vector res = cat(taxelPos[taxelId], taxelOri[taxelId]);
-    res.push_back(taxelPoseConfidence[taxelId]);
+    Vector res = cat(geo->taxelPos[taxelId], geo->taxelOri[taxelId]);
+    res.push_back(geo->taxelPoseConfidence[taxelId]);
     return res;
 }
 vector<Vector> Compensator::getTaxelPoses(){
-    vector<Vector> res(skinDim);
-    lock_guard<mutex> lck(poseSem);
-    for(unsigned int i=0; i<skinDim; i++){
-        res[i] = cat(taxelPos[i], taxelOri[i]);
-        res[i].push_back(taxelPoseConfidence[i]);
+    shared_ptr<const TaxelGeometry> geo = getGeometry();
+    vector<Vector> res(geo->taxelPos.size());
+    for(unsigned int i=0; i<res.size(); i++){
+        res[i] = cat(geo->taxelPos[i], geo->taxelOri[i]);
+        res[i].push_back(geo->taxelPoseConfidence[i]);
     }
     return res;
 }
 
 double Compensator::getPoseConfidence(unsigned int taxelId){
-    if(taxelId>=skinDim)
+    shared_ptr<const TaxelGeometry> geo = getGeometry();
+    if(taxelId>=geo->taxelPoseConfidence.size())
         return -1.0;
-    lock_guard<mutex> lck(poseSem);
-    return taxelPoseConfidence[taxelId];
+    return geo->taxelPoseConfidence[taxelId];
 }
 
 Vector Compensator::getPoseConfidences(){
-    lock_guard<mutex> lck(poseSem);
-    return taxelPoseConfidence;
+    return getGeometry()->taxelPoseConfidence;
 }
 
 bool Compensator::setMaxNeighborDistance(double d){
     if(d<0.0)
         return false;
-    maxNeighDist = d;
     lock_guard<mutex> lck(poseSem);
-    computeNeighbors();
+    shared_ptr<TaxelGeometry> geo = editGeometry();
+    geo->maxNeighDist = d;
+    computeNeighbors(*geo);
+    publishGeometry(geo);
     return true;
 }
 
 bool Compensator::setTaxelPosesFromFile(const char *filePath){
-    yarp::os::ResourceFinder rf;
-    rf.setDefaultContext("skinGui");   //overridden by --context parameter
-    rf.setDefaultConfigFile(filePath); //overridden by --from parameter
-    rf.configure(0,NULL);
+    // the file is parsed once, then it is read from its binary cache
+    taxelPositionFile file;
+    file.load(filePath);
 
-    yarp::os::Bottle &calibration = rf.findGroup("calibration");
-    if (calibration.isNull())
+    if (!file.hasCalibration)
     {
         return setTaxelPosesFromFileOld(filePath);
     }
     else
     {
         lock_guard<mutex> lck(poseSem);
-        int size=calibration.size()-1;
+        shared_ptr<TaxelGeometry> geo = editGeometry();
+        int size=file.getPosesSize();
         skinDim=size;
-        taxelPos.resize(skinDim, zeros(3));
-        taxelOri.resize(skinDim, zeros(3));
-        taxelPoseConfidence.resize(skinDim, 0.0);
+        geo->taxelPos.resize(skinDim, zeros(3));
+        geo->taxelOri.resize(skinDim, zeros(3));
+        geo->taxelPoseConfidence.resize(skinDim, 0.0);
         for (int i = 0; i < size; ++i)
         {
-            if (i<(int)taxelPos.size())
+            if (i<(int)geo->taxelPos.size())
             {
-                Vector taxelPosNrm(6,0.0);
-                taxelPosNrm = iCub::skinDynLib::vectorFromBottle(*(calibration.get(i+1).asList()),0,6);
-                taxelPos[i] = taxelPosNrm.subVector(0,2);
-                taxelOri[i] = taxelPosNrm.subVector(3,5);
+                const double *pose = file.getPose(i);
+                for (int j = 0; j < 3; j++){
+                    geo->taxelPos[i][j] = pose[j];
+                    geo->taxelOri[i][j] = pose[3+j];
+                }
             }
-            if(norm(taxelPos[i])>0.0)
-                taxelPoseConfidence[i] = 1.0;
+            if(norm(geo->taxelPos[i])>0.0)
+                geo->taxelPoseConfidence[i] = 1.0;
         }
-        computeNeighbors();
+        computeNeighbors(*geo);
+        publishGeometry(geo);
     }
 
     return true;
@@ -746,6 +849,7 @@ bool Compensator::setTaxelPosesFromFileOld(const char *filePath){
     }
     lock_guard<mutex> lck(poseSem);
     {
+        shared_ptr<TaxelGeometry> geo = editGeometry();
         for(unsigned int i= 0; getline(posFile,posLine); i++) {
             posLine.erase(posLine.find_last_not_of(" \n\r\t")+1);
             if(posLine.empty())
@@ -753,17 +857,18 @@ bool Compensator::setTaxelPosesFromFileOld(const char *filePath){
             string number;
             istringstream iss(posLine, istringstream::in);
             for(unsigned int j = 0; iss >> number; j++ ){
-                if(i<taxelPos.size()){
+                if(i<geo->taxelPos.size()){
                     if(j<3)
-                        taxelPos[i][j] = strtod(number.c_str(),NULL);
+                        geo->taxelPos[i][j] = strtod(number.c_str(),NULL);
                     else
-                        taxelOri[i][j-3] = strtod(number.c_str(),NULL);
+                        geo->taxelOri[i][j-3] = strtod(number.c_str(),NULL);
                 }
             }
-            if(norm(taxelPos[i])>0.0)
-                taxelPoseConfidence[i] = 1.0;
+            if(i<geo->taxelPos.size() && norm(geo->taxelPos[i])>0.0)
+                geo->taxelPoseConfidence[i] = 1.0;
         }
-        computeNeighbors();
+        computeNeighbors(*geo);
+        publishGeometry(geo);
     }
     return true;
 }
@@ -771,47 +876,53 @@ bool Compensator::setTaxelPoses(const vector<Vector> &poses){
     if(poses.size()!=skinDim)
         return false;
     lock_guard<mutex> lck(poseSem);
+    shared_ptr<TaxelGeometry> geo = editGeometry();
     {
         for(unsigned int i=0; i<skinDim; i++){
-            taxelPos[i] = poses[i].subVector(0,2);
-            taxelOri[i] = poses[i].subVector(3,5);
+            geo->taxelPos[i] = poses[i].subVector(0,2);
+            geo->taxelOri[i] = poses[i].subVector(3,5);
             if(poses[i].size() == 7)
-                taxelPoseConfidence[i] = poses[i][6];
+                geo->taxelPoseConfidence[i] = poses[i][6];
         }
     }
-    computeNeighbors();
+    computeNeighbors(*geo);
+    publishGeometry(geo);
     return true;
 }
 bool Compensator::setTaxelPose(unsigned int taxelId, const Vector &pose){
     if(taxelId>=skinDim || pose.size()!=6)
         return false;
     lock_guard<mutex> lck(poseSem);
+    shared_ptr<TaxelGeometry> geo = editGeometry();
     {
-        taxelPos[taxelId] = pose.subVector(0,2);
-        taxelOri[taxelId] = pose.subVector(3,5);
+        geo->taxelPos[taxelId] = pose.subVector(0,2);
+        geo->taxelOri[taxelId] = pose.subVector(3,5);
         if(pose.size() == 7)
-                taxelPoseConfidence[taxelId] = pose[6];
+                geo->taxelPoseConfidence[taxelId] = pose[6];
     }
-    updateNeighbors(taxelId);
+    updateNeighbors(*geo, taxelId);
+    publishGeometry(geo);
     return true;
 }
 bool Compensator::setTaxelPositions(const Vector &positions){
     lock_guard<mutex> lck(poseSem);
+    shared_ptr<TaxelGeometry> geo = editGeometry();
     if(skinDim*3 == positions.size()){
         for(unsigned int j=0; j<skinDim; j++){
-            taxelPos[j] = positions.subVector(3*j, 3*j+2);
+            geo->taxelPos[j] = positions.subVector(3*j, 3*j+2);
         }    
     }    
     else if(skinDim*4 == positions.size()){
         for(unsigned int j=0; j<skinDim; j++){
-            taxelPos[j] = positions.subVector(4*j, 4*j+2);
-            taxelPoseConfidence[j] = positions[4*j+3];
+            geo->taxelPos[j] = positions.subVector(4*j, 4*j+2);
+            geo->taxelPoseConfidence[j] = positions[4*j+3];
         }    
     }
     else
         return false;
 
-    computeNeighbors();
+    computeNeighbors(*geo);
+    publishGeometry(geo);
     return true;
 }
 
@@ -819,78 +930,96 @@ bool Compensator::setTaxelPosition(unsigned int taxelId, const Vector &position)
      if(taxelId>=skinDim || (position.size()!=3 && position.size()!=4))
         return false;
     lock_guard<mutex> lck(poseSem);
-    taxelPos[taxelId] = position.subVector(0,2);
+    shared_ptr<TaxelGeometry> geo = editGeometry();
+    geo->taxelPos[taxelId] = position.subVector(0,2);
     if(position.size()==4)
-        taxelPoseConfidence[taxelId] = position[3];
-    updateNeighbors(taxelId);
+        geo->taxelPoseConfidence[taxelId] = position[3];
+    updateNeighbors(*geo, taxelId);
+    publishGeometry(geo);
     return true;
 }
 bool Compensator::setTaxelOrientations(const vector<Vector> &orientations){
     if(orientations.size()!=skinDim)
         return false;
     lock_guard<mutex> lck(poseSem);
-    taxelOri = orientations;
+    shared_ptr<TaxelGeometry> geo = editGeometry();
+    geo->taxelOri = orientations;
+    publishGeometry(geo);
     return true;
 }
 bool Compensator::setTaxelOrientation(unsigned int taxelId, const Vector &orientation){
      if(taxelId>=skinDim || (orientation.size()!=3 && orientation.size()!=4))
         return false;
     lock_guard<mutex> lck(poseSem);
-    taxelOri[taxelId] = orientation.subVector(0,2);
+    shared_ptr<TaxelGeometry> geo = editGeometry();
+    geo->taxelOri[taxelId] = orientation.subVector(0,2);
     if(orientation.size()==4)
-        taxelPoseConfidence[taxelId] = orientation[3];
+        geo->taxelPoseConfidence[taxelId] = orientation[3];
+    publishGeometry(geo);
     return true;
 }
-void Compensator::computeNeighbors(){
-    neighborsXtaxel.clear();
-    neighborsXtaxel.resize(skinDim, list<int>(0));
-    Vector v;
-    double d2 = maxNeighDist*maxNeighDist;
-    for(unsigned int i=0; i<skinDim; i++){
-        for(unsigned int j=i+1; j<skinDim; j++){
-            //if(taxelPos[i][0]!=0.0 || taxelPos[i][1]!=0.0 || taxelPos[i][2]!=0.0){  // if the taxel exists
-            v = taxelPos[i]-taxelPos[j];
-            if( dot(v,v) <= d2){
-                neighborsXtaxel[i].push_back(j);
-                neighborsXtaxel[j].push_back(i);
-                //printf("Taxels %d (%s) and %d (%s) are neighbors\n", i, taxelPos[i].toString().c_str(), j, taxelPos[j].toString().c_str());
-            }
-            //}
-        }
+shared_ptr<Compensator::TaxelGeometry> Compensator::editGeometry(){
+    // a private copy of the published geometry, which is modified while getContacts() keeps using the old one
+    shared_ptr<TaxelGeometry> geo = make_shared<TaxelGeometry>(*getGeometry());
+    geo->taxelPos.resize(skinDim, zeros(3));
+    geo->taxelOri.resize(skinDim, zeros(3));
+    geo->taxelPoseConfidence.resize(skinDim, 0.0);
+    return geo;
+}
+void Compensator::publishGeometry(const shared_ptr<TaxelGeometry> &geo){
+    // compress the lists of neighbors, as they are read by getContacts()
+    geo->neighborsStart.resize(geo->neighborsXtaxel.size()+1);
+    geo->neighbors.clear();
+    for(size_t i=0; i<geo->neighborsXtaxel.size(); i++){
+        geo->neighborsStart[i] = geo->neighbors.size();
+        geo->neighbors.insert(geo->neighbors.end(), geo->neighborsXtaxel[i].begin(), geo->neighborsXtaxel[i].end());
     }
-
+    geo->neighborsStart[geo->neighborsXtaxel.size()] = geo->neighbors.size();
+    atomic_store(&geometry, shared_ptr<const TaxelGeometry>(geo));
+}
+void Compensator::computeNeighbors(TaxelGeometry &geo){
+    geo.taxelGrid.build(geo.taxelPos, geo.maxNeighDist);
+    geo.neighborsXtaxel.resize(skinDim);
     int minNeighbors=skinDim, maxNeighbors=0, ns;
     for(unsigned int i=0; i<skinDim; i++){
+        geo.taxelGrid.getNeighbors(i, geo.neighborsXtaxel[i]);
         //if(taxelPos[i][0]!=0.0 || taxelPos[i][1]!=0.0 || taxelPos[i][2]!=0.0){  // if the taxel exists
-        ns = neighborsXtaxel[i].size();
+        ns = geo.neighborsXtaxel[i].size();
         if(ns>maxNeighbors) maxNeighbors = ns;
         if(ns<minNeighbors) minNeighbors = ns;
     }
+    geo.neighborsAll = false;
     stringstream ss;
     ss<<"Neighbors computed. Min neighbors: "<<minNeighbors<<"; max neighbors: "<<maxNeighbors;
     sendInfoMsg(ss.str());
 }
-void Compensator::updateNeighbors(unsigned int taxelId){
-    Vector v;
-    double d2 = maxNeighDist*maxNeighDist;
-    // remove all the neighbors of the taxel with id=taxelId
-    neighborsXtaxel[taxelId].clear();
+void Compensator::updateNeighbors(TaxelGeometry &geo, unsigned int taxelId){
+    if(geo.neighborsAll || geo.taxelGrid.size()!=skinDim || geo.neighborsXtaxel.size()!=skinDim){
+        computeNeighbors(geo);
+        return;
+    }
 
-    for(unsigned int i=0; i<skinDim; i++){
-        //if(taxelPos[i][0]!=0.0 || taxelPos[i][1]!=0.0 || taxelPos[i][2]!=0.0){  // if the taxel exists
-        // remove taxelId from the neighbor list (if there is)
-        neighborsXtaxel[i].remove(taxelId);
-        // check whether they are neighbors
-        v = taxelPos[i]-taxelPos[taxelId];
-        if( dot(v,v) <= d2){
-            neighborsXtaxel[i].push_back(taxelId);
-            neighborsXtaxel[taxelId].push_back(i);
+    // remove the taxel with id=taxelId from the lists of its old neighbors
+    vector<int> &mine = geo.neighborsXtaxel[taxelId];
+    for(size_t n=0; n<mine.size(); n++){
+        vector<int> &other = geo.neighborsXtaxel[mine[n]];
+        vector<int>::iterator it = find(other.begin(), other.end(), (int)taxelId);
+        if(it!=other.end()){
+            *it = other.back();
+            other.pop_back();
         }
     }
+
+    // and add it to the lists of the new ones
+    geo.taxelGrid.move(taxelId, geo.taxelPos[taxelId]);
+    geo.taxelGrid.getNeighbors(taxelId, mine);
+    for(size_t n=0; n<mine.size(); n++)
+        geo.neighborsXtaxel[mine[n]].push_back(taxelId);
 }
 
 void Compensator::sendInfoMsg(string msg){
     yInfo("[%s]: %s", getInputPortName().c_str(), msg.c_str());
+    lock_guard<mutex> lck(infoPortSem);
     Bottle& b = infoPort->prepare();
     b.clear();
     b.addString(getInputPortName().c_str());
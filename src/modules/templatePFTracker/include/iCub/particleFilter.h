@@ -40,6 +40,9 @@
 #include <iostream>
 #include <iomanip>
 #include <deque>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
 #include <opencv2/core/core_c.h>
 #include <opencv2/imgproc/imgproc_c.h>
 
@@ -134,7 +137,6 @@ private:
     IplImage* frame, *frame_blob;
     int width, height, tpl_width, tpl_height, res_width, res_height;
     double scale;
-    IplImage* img_hsv;
     gsl_rng* rng;
     bool firstFrame;
     CvScalar color;
@@ -168,25 +170,31 @@ private:
     int total;
 
     histogram** ref_histos;
-    particle* particles, * new_particles;    
+    /* preallocated particle buffers, swapped at each resampling */
+    std::vector<particle> particles, new_particles;
+
+    /* HSV conversion buffers and histogram bin of each pixel */
+    cv::Mat img_bgr32f, img_hsv, img_bins;
+    /* integral histogram, one plane per bin, covering integral_roi */
+    std::vector<cv::Mat> integral_histo;
+    cv::Rect integral_roi;
 
     void free_histos( histogram** histo, int n );
     void free_regions( CvRect** regions, int n);
 
-    histogram** compute_ref_histos( IplImage* img, CvRect* rect, int n );
-    histogram* calc_histogram( IplImage** imgs, int n );
+    histogram** compute_ref_histos( CvRect* rect, int n );
+    void compute_integral_histo( IplImage* img, const cv::Rect &roi );
+    void region_histogram( const cv::Rect &rect, histogram* histo );
+    cv::Rect particle_region( const particle &p );
     particle transition( const particle &p, int w, int h, gsl_rng* rng );
-    particle* init_distribution( CvRect* regions, histogram** histos, int n, int p);
-    IplImage* bgr2hsv( IplImage* bgr );
-    float likelihood( IplImage* img, int r, int c, int w, int h, histogram* ref_histo );
+    void init_distribution( CvRect* regions, histogram** histos, int n, int p);
+    float likelihood( const particle &p );
     void normalize_weights( particle* particles, int n );
     float histo_dist_sq( histogram* h1, histogram* h2 );
     int histo_bin( float h, float s, float v );
-    float pixval32f(IplImage* img, int r, int c);
-    void setpix32f(IplImage* img, int r, int c, float val);
     int get_regions( IplImage* frame, CvRect** regions );
     int get_regionsImage( IplImage* frame, CvRect** regions );
-    particle* resample( particle* particles, int n );
+    void resample( int n );
     void display_particle( IplImage* img, const particle &p, CvScalar color, yarp::sig::Vector& target );
     void display_particleBlob( IplImage* img, const particle &p, yarp::sig::Vector& target );
     void trace_template( IplImage* img, const particle &p );
@@ -204,6 +212,7 @@ public:
     void threadRelease();
     void run(); 
     void setName(std::string module);
+    void setParticles(int n);
     void setTemplate(yarp::sig::ImageOf<yarp::sig::PixelRgb> *tpl);
     void pushTarget(yarp::sig::Vector &target, yarp::os::Stamp &stamp);
     float getAverage();
@@ -228,6 +237,7 @@ private:
 
     yarp::sig::ImageOf<yarp::sig::PixelRgb> *tpl;
     std::string moduleName;
+    int numParticles;
     
 
 public:
@@ -236,6 +246,7 @@ public:
     bool            shouldSend;
 
     void setName(std::string module);
+    void setParticles(int n);
     bool threadInit();     
     void threadRelease();
     void run(); 
@@ -55,6 +55,11 @@ changed to suit your needs; the default values are shown below.
 - \c name \c templatePFTracker \n
   specifies the name of the module (used to form the stem of module port names)
 
+- \c particles \c 1000 \n
+  specifies the number of particles used by each tracker; the likelihoods
+  are evaluated in parallel on an integral histogram of the predicted area,
+  hence each particle costs the same regardless of its size
+
 <b>Configuration File Parameters </b>
 
 The following key-value pairs can be specified as parameters in the
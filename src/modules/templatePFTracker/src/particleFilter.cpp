@@ -20,6 +20,7 @@
  */
 
 #include <utility>
+#include <algorithm>
 #include <yarp/cv/Cv.h>
 #include <iCub/particleFilter.h>
 
@@ -50,8 +51,6 @@ PARTICLEThread::~PARTICLEThread()
 
     gsl_rng_free ( rng );
     free_histos ( ref_histos, num_objects);  
-    if(particles != NULL)
-        free ( particles);
 
     if (temp)
     {
@@ -74,8 +73,6 @@ PARTICLEThread::PARTICLEThread()
     gotTemplate = false;
     sendTarget = false;
     getImage = false;
-    particles = NULL;
-    new_particles = NULL;
     temp = NULL;
     ref_histos = NULL;
     tpl = NULL;
@@ -86,6 +83,11 @@ void PARTICLEThread::setName(string module)
 {
     this->moduleName = module;
 }
+/**********************************************************/
+void PARTICLEThread::setParticles(int n) 
+{
+    num_particles = std::max(n, 1);
+}
 
 /**********************************************************/
 bool PARTICLEThread::threadInit() 
@@ -227,7 +229,7 @@ void PARTICLEThread::initAll()
 /**********************************************************/
 void PARTICLEThread::runAll(IplImage *img)
 {
-    img_hsv = bgr2hsv( img );
+    cv::Rect image( 0, 0, img->width, img->height );
     if (firstFrame)
     {
         w = img->width;
@@ -242,32 +244,42 @@ void PARTICLEThread::runAll(IplImage *img)
         if (ref_histos!=NULL)
             free_histos ( ref_histos, num_objects);        
 
-        ref_histos = compute_ref_histos( img_hsv, *regions, num_objects );
-        if (particles != NULL)
-            free (particles);
+        cv::Rect roi;
+        for( j = 0; j < num_objects; j++ )
+        {
+            cv::Rect r( (*regions)[j].x, (*regions)[j].y, (*regions)[j].width, (*regions)[j].height );
+            roi = ( j == 0 ) ? r : ( roi | r );
+        }
+        compute_integral_histo( img, roi & image );
+        ref_histos = compute_ref_histos( *regions, num_objects );
 
-        particles= init_distribution( *regions, ref_histos, num_objects, num_particles );
+        init_distribution( *regions, ref_histos, num_objects, num_particles );
     }
     else
     {
-        // perform prediction and measurement for each particle
+        // perform prediction, then build the integral histogram over
+        // the area covered by the predicted particles only
+        cv::Rect roi;
         for( j = 0; j < num_particles; j++ ) 
         {
             particles[j] = transition( particles[j], w, h, rng );
-            s = particles[j].s;
-            particles[j].w = likelihood( img_hsv, cvRound(particles[j].y),
-            cvRound( particles[j].x ),
-            cvRound( particles[j].width * s ),
-            cvRound( particles[j].height * s ),
-            particles[j].histo );
+            cv::Rect r = particle_region( particles[j] );
+            roi = ( j == 0 ) ? r : ( roi | r );
         }
+        compute_integral_histo( img, roi & image );
+
+        // the measurements are independent of each other
+        cv::parallel_for_( cv::Range( 0, num_particles ), [&]( const cv::Range &range )
+        {
+            for( int n = range.start; n < range.end; n++ )
+                particles[n].w = likelihood( particles[n] );
+        });
+
         // normalize weights and resample a set of unweighted particles
-        normalize_weights( particles, num_particles );
-        new_particles = resample( particles, num_particles );
-        free( particles );
-        particles = new_particles;
+        normalize_weights( &particles[0], num_particles );
+        resample( num_particles );
     }
-    qsort( particles, num_particles, sizeof( PARTICLEThread::particle ), &particle_cmp );
+    qsort( &particles[0], num_particles, sizeof( PARTICLEThread::particle ), &particle_cmp );
 
     averageMutex.lock();
     for( j = 0; j < num_particles; j++ ) 
@@ -287,8 +299,6 @@ void PARTICLEThread::runAll(IplImage *img)
         display_particleBlob( frame_blob, particles[0], targetTemp );
     targetMutex.unlock();
     trace_template( frame, particles[0] );
-
-    cvReleaseImage(&img_hsv);
 }
 /**********************************************************/
 void PARTICLEThread::setTemplate(ImageOf<PixelRgb> *_tpl)
@@ -346,60 +356,96 @@ int PARTICLEThread::get_regionsImage( IplImage* frame, CvRect** regions )
     return p.n;
 }
 /**********************************************************/
-PARTICLEThread::histogram** PARTICLEThread::compute_ref_histos( IplImage* frame, CvRect* regions, int n )
+PARTICLEThread::histogram** PARTICLEThread::compute_ref_histos( CvRect* regions, int n )
 {
     histogram** histos = (histogram**) malloc( n * sizeof( histogram* ) );
-    IplImage* tmp;
     int i;
 
-    // extract each region from frame and compute its histogram 
+    // compute the histogram of each region from the integral histogram
     for( i = 0; i < n; i++ )
     {
-        cvSetImageROI( frame, regions[i]);
-        tmp = cvCreateImage( cvGetSize(frame), IPL_DEPTH_32F, 3 );
-        cvCopy( frame, tmp, NULL );
-        cvResetImageROI( frame );
-        histos[i] = calc_histogram( &tmp, 1 );
+        cv::Rect r( regions[i].x, regions[i].y, regions[i].width, regions[i].height );
+        histos[i] = (histogram*) malloc( sizeof(histogram) );
+        region_histogram( r & integral_roi, histos[i] );
         normalize_histogram( histos[i] );
-        cvReleaseImage( &tmp );
     }
     return histos;
 }
 /**********************************************************/
-PARTICLEThread::histogram* PARTICLEThread::calc_histogram( IplImage** imgs, int n ) 
+void PARTICLEThread::compute_integral_histo( IplImage* img, const cv::Rect &roi )
+{
+    cv::Mat bgr = cv::cvarrToMat( img );
+    int nb = NH*NS + NV;
+
+    // the buffers are allocated once and used through headers
+    // sized as the roi, so that no allocation occurs per frame
+    if( img_bins.size() != bgr.size() )
+    {
+        img_bgr32f.create( bgr.size(), CV_32FC3 );
+        img_hsv.create( bgr.size(), CV_32FC3 );
+        img_bins.create( bgr.size(), CV_8UC1 );
+    }
+    integral_histo.resize( nb );
+    integral_roi = roi;
+    if( roi.area() == 0 )
+        return;
+
+    cv::Rect origin( 0, 0, roi.width, roi.height );
+    cv::Mat bgr32f = img_bgr32f( origin );
+    cv::Mat hsv = img_hsv( origin );
+    cv::Mat bins = img_bins( origin );
+    bgr( roi ).convertTo( bgr32f, CV_32F, 1.0 / 255.0 );
+    cv::cvtColor( bgr32f, hsv, cv::COLOR_BGR2HSV );
+
+    for( int r = 0; r < hsv.rows; r++ )
+    {
+        const float* src = hsv.ptr<float>( r );
+        uchar* dst = bins.ptr<uchar>( r );
+        for( int c = 0; c < hsv.cols; c++, src += 3 )
+            dst[c] = (uchar)histo_bin( src[0], src[1], src[2] );
+    }
+
+    // the planes grow to the largest roi seen so far; the masks are
+    // 255 where the bin matches, a scale the normalization removes
+    for( int b = 0; b < nb; b++ )
+    {
+        cv::Mat &plane = integral_histo[b];
+        if( ( plane.rows < roi.height + 1 ) || ( plane.cols < roi.width + 1 ) )
+            plane.create( std::max( plane.rows, roi.height + 1 ), std::max( plane.cols, roi.width + 1 ), CV_32SC1 );
+    }
+    cv::parallel_for_( cv::Range( 0, nb ), [&]( const cv::Range &range )
+    {
+        cv::Mat mask;
+        for( int b = range.start; b < range.end; b++ )
+        {
+            cv::Mat plane = integral_histo[b]( cv::Rect( 0, 0, roi.width + 1, roi.height + 1 ) );
+            cv::compare( bins, cv::Scalar( b ), mask, cv::CMP_EQ );
+            cv::integral( mask, plane, CV_32S );
+        }
+    });
+}
+/**********************************************************/
+void PARTICLEThread::region_histogram( const cv::Rect &rect, PARTICLEThread::histogram* histo )
 {
-    IplImage* img;
-    histogram* histo;
-    IplImage* h, * s, * v;
-    float* hist;
-    int i, r, c, bin;
-    histo = (histogram*) malloc( sizeof(histogram) );
     histo->n = NH*NS + NV;
-    hist = histo->histo;
-    memset( hist, 0, histo->n * sizeof(float) );
-    for( i = 0; i < n; i++ )
+    if( rect.area() == 0 )
     {
-        // extract individual HSV planes from image 
-        img = imgs[i];
-        h = cvCreateImage( cvGetSize(img), IPL_DEPTH_32F, 1 );
-        s = cvCreateImage( cvGetSize(img), IPL_DEPTH_32F, 1 );
-        v = cvCreateImage( cvGetSize(img), IPL_DEPTH_32F, 1 );
-        cvSplit( img, h, s, v, NULL );
-
-        // increment appropriate histogram bin for each pixel 
-        for( r = 0; r < img->height; r++ )
-            for( c = 0; c < img->width; c++ )
-            {
-                bin = histo_bin( pixval32f( h, r, c ),
-                pixval32f( s, r, c ),
-                pixval32f( v, r, c ) );
-                hist[bin] += 1;
-            }
-        cvReleaseImage( &h );
-        cvReleaseImage( &s );
-        cvReleaseImage( &v );
+        memset( histo->histo, 0, histo->n * sizeof(float) );
+        return;
+    }
+
+    // rect is expected within integral_roi
+    int x0 = rect.x - integral_roi.x;
+    int y0 = rect.y - integral_roi.y;
+    int x1 = x0 + rect.width;
+    int y1 = y0 + rect.height;
+    for( int b = 0; b < histo->n; b++ )
+    {
+        const cv::Mat &plane = integral_histo[b];
+        const int* top = plane.ptr<int>( y0 );
+        const int* bottom = plane.ptr<int>( y1 );
+        histo->histo[b] = (float)( bottom[x1] - bottom[x0] - top[x1] + top[x0] );
     }
-    return histo;
 }
 /**********************************************************/
 void PARTICLEThread::free_histos( PARTICLEThread::histogram** histo, int n) 
@@ -450,14 +496,14 @@ int PARTICLEThread::histo_bin( float h, float s, float v )
     return sd * NH + hd;
 }
 /**********************************************************/
-PARTICLEThread::particle* PARTICLEThread::init_distribution( CvRect* regions, histogram** histos, int n, int p) 
+void PARTICLEThread::init_distribution( CvRect* regions, histogram** histos, int n, int p) 
 {
-    particle* particles;
     int np;
     float x, y;
     int i, j, width, height, k = 0;
 
-    particles = (particle* )malloc( p * sizeof( particle ) );
+    particles.resize( p );
+    new_particles.resize( p );
     np = p / n;
 
     // create particles at the centers of each of n regions 
@@ -494,7 +540,6 @@ PARTICLEThread::particle* PARTICLEThread::init_distribution( CvRect* regions, hi
         particles[k++].w = 0;
         i = ( i + 1 ) % n;
     }
-    return particles;
 }
 /**********************************************************/
 PARTICLEThread::particle PARTICLEThread::transition( const PARTICLEThread::particle &p, int w, int h, gsl_rng* rng ) 
@@ -526,24 +571,28 @@ PARTICLEThread::particle PARTICLEThread::transition( const PARTICLEThread::parti
     return pn;
 }
 /**********************************************************/
-float PARTICLEThread::likelihood( IplImage* img, int r, int c, int w, int h, histogram* ref_histo ) 
+cv::Rect PARTICLEThread::particle_region( const PARTICLEThread::particle &p ) 
+{
+    int w = cvRound( p.width * p.s );
+    int h = cvRound( p.height * p.s );
+    return cv::Rect( cvRound( p.x ) - w / 2, cvRound( p.y ) - h / 2, w, h );
+}
+/**********************************************************/
+float PARTICLEThread::likelihood( const PARTICLEThread::particle &p ) 
 {
-    IplImage* tmp;
-    histogram* histo;
+    histogram histo;
     float d_sq;
 
-    // extract region around (r,c) and compute and normalize its histogram 
-    cvSetImageROI( img, cvRect( c - w / 2, r - h / 2, w, h ) );
-    tmp = cvCreateImage( cvGetSize(img), IPL_DEPTH_32F, 3 );
-    cvCopy( img, tmp, NULL );
-    cvResetImageROI( img );
-    histo = calc_histogram( &tmp, 1 );
-    cvReleaseImage( &tmp );
-    normalize_histogram( histo );
+    // extract the histogram of the region of the particle in O(bins)
+    cv::Rect rect = particle_region( p ) & integral_roi;
+    if( rect.area() == 0 )
+        return exp( -LAMBDA );
+
+    region_histogram( rect, &histo );
+    normalize_histogram( &histo );
 
     // compute likelihood as e^{\lambda D^2(h, h^*)} 
-    d_sq = histo_dist_sq( histo, ref_histo );
-    free( histo );
+    d_sq = histo_dist_sq( &histo, p.histo );
     return exp( -LAMBDA * d_sq );
 }
 /**********************************************************/
@@ -583,30 +632,28 @@ void PARTICLEThread::normalize_weights( particle* particles, int n )
         particles[i].w /= sum;
 }
 /**********************************************************/
-PARTICLEThread::particle* PARTICLEThread::resample( particle* particles, int n ) 
+void PARTICLEThread::resample( int n ) 
 {
-    particle* _new_particles;
     int i, j, np, k = 0;
 
-    //new_particles = (particle* )malloc( sizeof( particle ) );
-    qsort( particles, n, sizeof( particle ), &particle_cmp );
-    _new_particles = (particle* ) malloc( n * sizeof( particle ) );
+    qsort( &particles[0], n, sizeof( particle ), &particle_cmp );
+    new_particles.resize( n );
 
     for( i = 0; i < n; i++ ) 
     {
         np = cvRound( particles[i].w * n );
         for( j = 0; j < np; j++ ) 
         {
-            _new_particles[k++] = particles[i];
+            new_particles[k++] = particles[i];
         if( k == n )
             goto exit;
         }
     }
     while( k < n )
-        _new_particles[k++] = particles[0];
+        new_particles[k++] = particles[0];
 
     exit:
-    return _new_particles;
+    particles.swap( new_particles );
 }
 /**********************************************************/
 void PARTICLEThread::display_particle( IplImage* img, const PARTICLEThread::particle &p, CvScalar color, Vector& target ) 
@@ -709,22 +756,6 @@ void PARTICLEThread::trace_template( IplImage* img, const particle &p )
     }
 }
 /**********************************************************/
-float PARTICLEThread::pixval32f(IplImage* img, int r, int c) 
-{
-    return ( (float*)(img->imageData + img->widthStep*r) )[c];
-}
-/**********************************************************/
-IplImage* PARTICLEThread::bgr2hsv( IplImage* bgr ) 
-{
-    IplImage* bgr32f, * hsv;
-
-    bgr32f = cvCreateImage( cvGetSize(bgr), IPL_DEPTH_32F, 3 );
-    hsv = cvCreateImage( cvGetSize(bgr), IPL_DEPTH_32F, 3 );
-    cvConvertScale( bgr, bgr32f, 1.0 / 255.0, 0 );
-    cvCvtColor( bgr32f, hsv, CV_BGR2HSV );
-    cvReleaseImage( &bgr32f );
-    return hsv;
-}
 /**********************************************************/
 TemplateStruct PARTICLEThread::getBestTemplate()
 {
@@ -745,6 +776,7 @@ TemplateStruct PARTICLEThread::getBestTemplate()
 PARTICLEManager::PARTICLEManager() : PeriodicThread(0.02) 
 {
     tpl = NULL;
+    numParticles = PARTICLES;
 }
 /**********************************************************/
 PARTICLEManager::~PARTICLEManager() { }
@@ -754,6 +786,11 @@ void PARTICLEManager::setName(string module)
     this->moduleName = module;
 }
 /**********************************************************/
+void PARTICLEManager::setParticles(int n) 
+{
+    numParticles = n;
+}
+/**********************************************************/
 bool PARTICLEManager::threadInit() 
 {
     //create all ports
@@ -772,6 +809,9 @@ bool PARTICLEManager::threadInit()
     particleThreadLeft->setName((moduleName + "/left").c_str());
     particleThreadRight->setName((moduleName + "/right").c_str());
 
+    particleThreadLeft->setParticles(numParticles);
+    particleThreadRight->setParticles(numParticles);
+
     shouldSend = false;
     particleThreadLeft->start();
     particleThreadRight->start();
@@ -887,6 +927,10 @@ bool PARTICLEModule::configure(yarp::os::ResourceFinder &rf)
 
     setName(moduleName.c_str());
 
+    int numParticles      = rf.check("particles", 
+                           Value(PARTICLES), 
+                           "number of particles (int)").asInt32();
+
     handlerPortName =  "/";
     handlerPortName += getName();         // use getName() rather than a literal 
  
@@ -903,6 +947,7 @@ bool PARTICLEModule::configure(yarp::os::ResourceFinder &rf)
 
     /*pass the name of the module in order to create ports*/
     particleManager->setName(moduleName);    
+    particleManager->setParticles(numParticles);
     /* now start the thread to do the work */
     particleManager->start();
     
@@ -7,6 +7,7 @@
 #include "velControlThread.h"
 #include <string.h>
 #include <string>
+#include <vector>
 #include <math.h>
 #include <yarp/os/Log.h>
 #include <yarp/os/LogStream.h>
@@ -171,13 +172,10 @@ bool velControlThread::threadInit()
 
 void velControlThread::threadRelease()
 {
-    for(int k=0;k<nJoints;k++)
-    {
-        ivel->stop();
-        for (int k = 0; k < nJoints; k++)
-            imod->setControlMode(k, VOCAB_CM_POSITION);
-        suspended = true;
-    }
+    ivel->stop();
+    std::vector<int> modes(nJoints,VOCAB_CM_POSITION);
+    imod->setControlModes(modes.data());
+    suspended = true;
 
     command_port.close();
     command_port2.close();
@@ -276,10 +274,11 @@ void velControlThread::halt()
 void velControlThread::go()
 {
     suspended=false;
-    int mode=0;
+    std::vector<int> modes(nJoints,0);
+    imod->getControlModes(modes.data());
     for(int k = 0; k < nJoints; k++)
     {
-        imod->getControlMode(k, &mode);
+        int mode=modes[k];
         if (mode!=VOCAB_CM_MIXED && mode!=VOCAB_CM_VELOCITY)
         {
             std::string s = yarp::os::Vocab32::decode(mode);
@@ -113,6 +113,12 @@ The port the service is listening to.
 
 - \e <name>/acc:o (e.g. /velObs/acc:o) provides the estimated 
   second derivatives.
+
+- \e <name>/latency:o (e.g. /velObs/latency:o) provides for 
+  each input message the time spent in the estimation and the 
+  delay from the time stamp of the message to the publication 
+  of its derivatives, both in seconds (the delay is zero if the 
+  envelope is not available). 
  
 - \e <name>/rpc remote procedure call port useful to shut down 
   the module remotely by sending to this port the 'quit'
@@ -173,21 +179,28 @@ using namespace iCub::ctrl;
 // A class which handles the incoming data.
 // The estimated derivatives are returned at once
 // since they are computed within the onRead method.
+// All the components go through the incremental
+// estimators together.
 class dataCollector : public BufferedPort<Bottle>
 {
 private:
-    AWLinEstimator       *linEst;
-    AWQuadEstimator      *quadEst;
+    FastAWLinEstimator   *linEst;
+    FastAWQuadEstimator  *quadEst;
     BufferedPort<Vector> &port_vel;
     BufferedPort<Vector> &port_acc;
+    BufferedPort<Vector> &port_lat;
+
+    Vector x;
 
     virtual void onRead(Bottle &b)
     {
+        double t0=Time::now();
+
         Stamp info;
         BufferedPort<Bottle>::getEnvelope(info);
 
         size_t sz=b.size();
-        Vector x(sz);
+        x.resize(sz);
 
         for (unsigned int i=0; i<sz; i++)
             x[i]=b.get(i).asFloat64();
@@ -196,7 +209,7 @@ private:
         // is required. If not present within the
         // packet, the actual machine time is 
         // attached to it.
-        AWPolyElement el(x,info.isValid()?info.getTime():Time::now());
+        AWPolyElement el(x,info.isValid()?info.getTime():t0);
         port_vel.prepare()=linEst->estimate(el);
         port_acc.prepare()=quadEst->estimate(el);
 
@@ -217,15 +230,27 @@ private:
         }
         else
             port_acc.unprepare();
+
+        if (port_lat.getOutputCount()>0)
+        {
+            double t1=Time::now();
+            Vector &lat=port_lat.prepare();
+            lat.resize(2);
+            lat[0]=t1-t0;
+            lat[1]=info.isValid()?t1-info.getTime():0.0;
+            port_lat.setEnvelope(info);
+            port_lat.write();
+        }
     }
 
 public:
     dataCollector(unsigned int NVel, double DVel, BufferedPort<Vector> &_port_vel,
-                  unsigned int NAcc, double DAcc, BufferedPort<Vector> &_port_acc) :
-                  port_vel(_port_vel), port_acc(_port_acc)
+                  unsigned int NAcc, double DAcc, BufferedPort<Vector> &_port_acc,
+                  BufferedPort<Vector> &_port_lat) :
+                  port_vel(_port_vel), port_acc(_port_acc), port_lat(_port_lat)
     {
-        linEst =new AWLinEstimator(NVel,DVel);
-        quadEst=new AWQuadEstimator(NAcc,DAcc);
+        linEst =new FastAWLinEstimator(NVel,DVel);
+        quadEst=new FastAWQuadEstimator(NAcc,DAcc);
     }
 
     ~dataCollector()
@@ -244,6 +269,7 @@ private:
     dataCollector        *port_pos;
     BufferedPort<Vector>  port_vel;
     BufferedPort<Vector>  port_acc;
+    BufferedPort<Vector>  port_lat;
     Port                  rpcPort;
 
 public:
@@ -283,8 +309,9 @@ public:
 
         port_vel.open(portName+"/vel:o");
         port_acc.open(portName+"/acc:o");
+        port_lat.open(portName+"/latency:o");
 
-        port_pos=new dataCollector(NVel,DVel,port_vel,NAcc,DAcc,port_acc);
+        port_pos=new dataCollector(NVel,DVel,port_vel,NAcc,DAcc,port_acc,port_lat);
         port_pos->useCallback();
         port_pos->open(portName+"/pos:i");
 
@@ -299,11 +326,13 @@ public:
         port_pos->interrupt();
         port_vel.interrupt();
         port_acc.interrupt();
+        port_lat.interrupt();
         rpcPort.interrupt();
 
         port_pos->close();
         port_vel.close();
         port_acc.close();
+        port_lat.close();
         rpcPort.close();
 
         delete port_pos;
@@ -69,6 +69,19 @@ http://wiki.icub.org/wiki/Force_Control
 --no_legs   
 - this option disables the dynamics computation for the legs joints
 
+--threads \e n 
+- The parameter \e n identifies the number of threads solving the 
+  limbs of the whole body concurrently. If not specified the
+  computation is sequential. 
+
+--no_pipeline
+- The sensors are read, the dynamics is computed and the output ports
+  are written serially within the same thread. By default, the sensors
+  are read by a dedicated thread into a double buffer and the ports are
+  written asynchronously, so that slow ports or network stalls do not
+  delay the computation. The rpc command \e stats returns the timing
+  of each stage, \e stats \e reset clears it.
+
 \section portsa_sec Ports Accessed
 The port the service is listening to.
 
@@ -76,6 +89,12 @@ The port the service is listening to.
  
 - \e <name>/<part>/FT:i (e.g. /wholeBodyDynamics/right_arm/FT:i) 
   receives the input data vector.
+
+- \e <name>/state:o streams, once per cycle, the joint torques of all
+  the parts, the external wrenches at the end-effectors, the COM and the
+  time stamp in a single fixed-layout binary message (see
+  iCub::skinDynLib::wholeBodyState). The message is filled only while
+  the port is connected.
  
 \section in_files_sec Input Data Files
 None.
@@ -215,6 +234,8 @@ private:
     bool     dummy_ft;
     bool     dump_vel_enabled;
     bool     auto_drift_comp;
+    int      n_threads;
+    bool     pipeline_enabled;
     bool     default_ee_cont;       // true: when skin detects no contact, the ext contact is supposed at the end effector
                                     // false: ext contact is supposed at the last location where skin detected a contact
 
@@ -256,6 +277,8 @@ public:
         dump_vel_enabled = false;
         auto_drift_comp = false;
         default_ee_cont = false;
+        n_threads = 1;
+        pipeline_enabled = true;
     }
 
     virtual bool createDriver(PolyDriver *&_dd, Property options)
@@ -338,6 +361,22 @@ public:
                 reply.addString("calib arms");
                 reply.addString("calib legs");
                 reply.addString("calib feet");
+                reply.addString("stats");
+                reply.addString("stats reset");
+                return true;
+            }
+            else if (command.get(0).asString()=="stats")
+            {
+                if (inv_dyn)
+                {
+                    if (command.get(1).asString()=="reset")
+                    {
+                        inv_dyn->resetStats();
+                        reply.addString("Stats reset");
+                    }
+                    else
+                        inv_dyn->getStats(reply);
+                }
                 return true;
             }
             else if (command.get(0).asString()=="calib")
@@ -543,6 +582,12 @@ public:
             yInfo("Default contact at the end effector\n");
         }
 
+        if (rf.check("no_pipeline"))
+        {
+            pipeline_enabled = false;
+            yInfo("'no_pipeline' option found. Sensors, dynamics and ports will be processed serially.\n");
+        }
+
         //---------------------DEVICES--------------------------//
         if(head_enabled)
         {
@@ -658,6 +703,12 @@ public:
         rpcPort.open(rpcPortName);
         attach(rpcPort);                  
 
+        if (rf.check("threads"))
+        {
+            n_threads = rf.find("threads").asInt32();
+            yInfo("Solving the whole body dynamics with %d threads\n", n_threads);
+        }
+
         //---------------OPEN INERTIAL PORTS--------------------//
         port_filtered_output.open("/"+local_name+"/filtered/inertial:o");
         inertialFilter = new dataFilter(port_filtered_output, m_iGyro, m_iAcc);
@@ -671,6 +722,8 @@ public:
         inv_dyn->w0_dw0_enabled=w0_dw0_enabled;
         inv_dyn->dumpvel_enabled=dump_vel_enabled;
         inv_dyn->default_ee_cont=default_ee_cont;
+        inv_dyn->pipeline_enabled=pipeline_enabled;
+        inv_dyn->setNumThreads(n_threads>1?n_threads:1);
 
         yInfo("ft thread istantiated...\n");
         Time::delay(5.0);
@@ -834,6 +887,8 @@ int main(int argc, char * argv[])
         cout << "\t--dumpvel         dumps joint velocities and accelerations (debug use only)"                                  << endl;
         cout << "\t--experimental_com_vel  enables com velocity computation (experimental)"                                      << endl;
         cout << "\t--auto_drift_comp  enables automatic drift compensation  (experimental, under debug)"                         << endl;
+        cout << "\t--threads    n: the number of threads solving the whole body dynamics. default: 1"                            << endl;
+        cout << "\t--no_pipeline     reads sensors, computes and writes ports serially in the same thread"                       << endl;
         return 0;
     }
 
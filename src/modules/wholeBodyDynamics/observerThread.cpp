@@ -19,6 +19,7 @@
 #include <cmath>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 #include <string>
 
 #include <yarp/os/all.h>
@@ -176,6 +177,12 @@ void inverseDynamics::init_lower()
     FM_sens_low.resize(6,2); FM_sens_low.zero();
 }
 
+void inverseDynamics::setNumThreads(unsigned int nThreads)
+{
+    // the estimation of the sensors wrench (icub_sens) is left sequential
+    icub->setNumThreads(nThreads);
+}
+
 void inverseDynamics::setStiffMode()
 {
      if (iint_arm_left)
@@ -250,7 +257,7 @@ void inverseDynamics::setStiffMode()
      }
 }
 
-inverseDynamics::inverseDynamics(int _rate, PolyDriver *_ddAL, PolyDriver *_ddAR, PolyDriver *_ddH, PolyDriver *_ddLL, PolyDriver *_ddLR, PolyDriver *_ddT, string _robot_name, string _local_name, version_tag _icub_type, bool _autoconnect) : PeriodicThread((double)_rate/1000.0), ddAL(_ddAL), ddAR(_ddAR), ddH(_ddH), ddLL(_ddLL), ddLR(_ddLR), ddT(_ddT), robot_name(_robot_name), icub_type(_icub_type), local_name(_local_name), zero_sens_tolerance (1e-12)
+inverseDynamics::inverseDynamics(int _rate, PolyDriver *_ddAL, PolyDriver *_ddAR, PolyDriver *_ddH, PolyDriver *_ddLL, PolyDriver *_ddLR, PolyDriver *_ddT, string _robot_name, string _local_name, version_tag _icub_type, bool _autoconnect) : PeriodicThread((double)_rate/1000.0), ddAL(_ddAL), ddAR(_ddAR), ddH(_ddH), ddLL(_ddLL), ddLR(_ddLR), ddT(_ddT), robot_name(_robot_name), icub_type(_icub_type), local_name(_local_name), zero_sens_tolerance (1e-12), telemetry((double)_rate/1000.0)
 {
     status_queue_size = 10;
     autoconnect = _autoconnect;
@@ -261,6 +268,14 @@ inverseDynamics::inverseDynamics(int _rate, PolyDriver *_ddAL, PolyDriver *_ddAR
     dumpvel_enabled = false;
     auto_drift_comp = false;
     add_legs_once = false;
+    pipeline_enabled = true;
+
+    reader    = nullptr;
+    publisher = nullptr;
+    tmSectionInput  = telemetry.addSection("input");
+    tmSectionSolver = telemetry.addSection("solver");
+    tmSectionOutput = telemetry.addSection("output");
+    staleInputs = 0;
 
     icub      = new iCubWholeBody(icub_type, DYNAMIC, VERBOSE);
     icub_sens = new iCubWholeBody(icub_type, DYNAMIC, VERBOSE);
@@ -336,6 +351,7 @@ inverseDynamics::inverseDynamics(int _rate, PolyDriver *_ddAL, PolyDriver *_ddAR
     port_com_all_foot = new BufferedPort<Vector>;
     port_monitor = new BufferedPort<Vector>;
     port_contacts = new BufferedPort<skinContactList>;
+    port_state = new BufferedPort<wholeBodyState>;
     port_dumpvel = new BufferedPort<Vector>;
     port_external_ft_arm_left = new BufferedPort<Vector>;
     port_external_ft_arm_right = new BufferedPort<Vector>;
@@ -395,6 +411,7 @@ inverseDynamics::inverseDynamics(int _rate, PolyDriver *_ddAL, PolyDriver *_ddAR
     port_skin_contacts->open(string("/"+local_name+"/skin_contacts:i").c_str());
     port_monitor->open(string("/"+local_name+"/monitor:o").c_str());
     port_contacts->open(string("/"+local_name+"/contacts:o").c_str());
+    port_state->open(string("/"+local_name+"/state:o").c_str());
     port_dumpvel->open(string("/"+local_name+"/va:o").c_str());
     port_external_ft_arm_left->open(string("/"+local_name+"/left_arm/ext_ft_sens:o").c_str());
     port_external_ft_arm_right->open(string("/"+local_name+"/right_arm/ext_ft_sens:o").c_str());
@@ -441,11 +458,11 @@ inverseDynamics::inverseDynamics(int _rate, PolyDriver *_ddAL, PolyDriver *_ddAR
     if (ddLR) {ddLR->view(iencs_leg_right); ddLR->view(iint_leg_right); ddLR->view(icmd_leg_right);}
     if (ddT)  {ddT->view(iencs_torso);      ddT ->view(iint_torso);      ddT ->view(icmd_torso);}
 
-    linEstUp =new AWLinEstimator(16,1.0);
-    quadEstUp=new AWQuadEstimator(25,1.0);
-    linEstLow =new AWLinEstimator(16,1.0);
-    quadEstLow=new AWQuadEstimator(25,1.0);
-    InertialEst = new AWLinEstimator(16,1.0);
+    linEstUp =new FastAWLinEstimator(16,1.0);
+    quadEstUp=new FastAWQuadEstimator(25,1.0);
+    linEstLow =new FastAWLinEstimator(16,1.0);
+    quadEstLow=new FastAWQuadEstimator(25,1.0);
+    InertialEst = new FastAWLinEstimator(16,1.0);
 
     //-----------parts INIT VARIABLES----------------//
     init_upper();
@@ -498,6 +515,28 @@ bool inverseDynamics::threadInit()
     // the queue previous_status now contains status_queue_size elements, and we can calibrate
     calibrateOffset();
 
+    if (pipeline_enabled)
+    {
+        // from now on the sensors are read and the ports are written by the
+        // stages, so that network stalls do not delay the computation
+        reader = new sensorReader(this, getPeriod());
+        reader->init(current_status);
+        publisher = new asyncPublisher(getPeriod());
+        if (!publisher->start() || !reader->start())
+        {
+            yError("Unable to start the pipeline stages, stopping... \n");
+            reader->stop();
+            publisher->stop();
+            delete reader;
+            delete publisher;
+            reader = nullptr;
+            publisher = nullptr;
+            thread_status = STATUS_DISCONNECTED;
+            return false;
+        }
+        yInfo("Pipeline stages started\n");
+    }
+
     thread_status = STATUS_OK;
     return true;
 }
@@ -540,11 +579,33 @@ void iCubStatus::dump (FILE* f)
 
 void inverseDynamics::run()
 {
+    telemetry.beginCycle();
     timestamp.update();
 
     thread_status = STATUS_OK;
     static int delay_check=0;
-    if(!readAndUpdate(false))
+    bool ok;
+    bool fresh=true;
+    telemetry.tic(tmSectionInput);
+    if (reader)
+    {
+        // take the latest status acquired by the reader stage
+        fresh=reader->getLatest(current_status, ok);
+        if (!fresh)
+        {
+            lock_guard<mutex> lck(mtxStats);
+            staleInputs++;
+        }
+        updateStatus(false);
+
+        lock_guard<mutex> lck(mtxStats);
+        inputAge.add(Time::now()-current_status.timestamp);
+    }
+    else
+        ok = readAndUpdate(false);
+    telemetry.toc(tmSectionInput);
+
+    if(!ok)
     {
         delay_check++;
         yWarning ("network delays detected (%d/10)\n", delay_check);
@@ -573,7 +634,9 @@ void inverseDynamics::run()
     current_status.iCub_not_moving = current_status.checkIcubNotMoving();
     if (current_status.iCub_not_moving)
     {
-        not_moving_status.push_front(current_status);
+        // a sample already taken by the previous cycle is not counted twice
+        if (fresh)
+            not_moving_status.push_front(current_status);
         if (not_moving_status.size()>status_queue_size) 
             {
                 not_moving_status.pop_back();
@@ -605,12 +668,16 @@ void inverseDynamics::run()
     static double startTime = 0;
     startTime = Time::now();
 #endif
+    telemetry.tic(tmSectionSolver);
     icub->upperTorso->solveKinematics();
     addSkinContacts();
-    icub->upperTorso->solveWrench();
+    // upper torso wrench, then lower torso kinematics and wrench
+    // (the first two overlap if several threads are in use)
+    icub->solveAfterUpperKinematics(F_RLeg,F_LLeg);
+    telemetry.toc(tmSectionSolver);
 #ifdef DEBUG_PERFORMANCE
     meanTime += Time::now()-startTime;
-    yDebug("Mean uppertorso NE time: %.4f\n", meanTime/getIterations());
+    yDebug("Mean wholebody NE time: %.4f\n", meanTime/getIterations());
 #endif
 
 //#define DEBUG_KINEMATICS
@@ -621,10 +688,6 @@ void inverseDynamics::run()
     yDebug ("UPTORSO: %s \n", icub->upperTorso->getTorsoLinAcc().toString().c_str());
 #endif
 
-    icub->attachLowerTorso(F_RLeg,F_LLeg);
-    icub->lowerTorso->solveKinematics();
-    icub->lowerTorso->solveWrench();
-
 //#define DEBUG_KINEMATICS
 #ifdef DEBUG_KINEMATICS
     //DEBUG ONLY
@@ -684,6 +747,8 @@ void inverseDynamics::run()
     yDebug ("TORQUES:     %s ***  \n\n", TOTorques.toString().c_str());
 #endif
 
+    telemetry.tic(tmSectionOutput);
+
     writeTorque(RATorques, 1, port_RATorques); //arm
     writeTorque(LATorques, 1, port_LATorques); //arm
     writeTorque(TOTorques, 4, port_TOTorques); //torso
@@ -694,6 +759,21 @@ void inverseDynamics::run()
     writeTorque(RATorques, 3, port_RWTorques); //wrist
     writeTorque(LATorques, 3, port_LWTorques); //wrist
 
+    // the aggregated state is filled only when somebody reads it
+    bool state_requested = (port_state->getOutputCount()>0);
+    if (state_requested)
+    {
+        state.clear();
+        state.data.count     = timestamp.getCount();
+        state.data.timestamp = timestamp.getTime();
+        copyToArray(HDTorques, state.data.tau_head,      3);
+        copyToArray(TOTorques, state.data.tau_torso,     3);
+        copyToArray(LATorques, state.data.tau_left_arm,  7);
+        copyToArray(RATorques, state.data.tau_right_arm, 7);
+        if (ddLL) copyToArray(LLTorques, state.data.tau_left_leg,  6);
+        if (ddLR) copyToArray(RLTorques, state.data.tau_right_leg, 6);
+    }
+
     Vector com_all(7), com_ll(7), com_rl(7), com_la(7),com_ra(7), com_hd(7), com_to(7), com_lb(7), com_ub(7);
     double mass_all  , mass_ll  , mass_rl  , mass_la  ,mass_ra  , mass_hd,   mass_to, mass_lb, mass_ub;
     Vector com_v; com_v.resize(3); com_v.zero();
@@ -726,10 +806,11 @@ void inverseDynamics::run()
 
         if (com_vel_enabled)
         {
-            icub->EXPERIMENTAL_computeCOMjacobian();
-            icub->EXPERIMENTAL_getCOMjacobian(BODY_PART_ALL,com_jac);
-            icub->EXPERIMENTAL_getCOMvelocity(BODY_PART_ALL,com_v,all_dq);
+            icub->computeCOMJacobian();
+            icub->getCOMJacobian(com_jac);
+            icub->getAllVelocities(all_dq);
             icub->getAllPositions(all_q);
+            com_v = com_jac*all_dq;
         }
 
         icub->getCOM(BODY_PART_ALL,     com_all, mass_all);
@@ -1005,10 +1086,41 @@ void inverseDynamics::run()
 
     broadcastData<Matrix> (foot_root_mat,                           port_root_position_mat);
     broadcastData<Vector> (foot_root_vec,                           port_root_position_vec);
+
+    if (state_requested)
+    {
+        copyToArray(F_ext_left_arm,   state.data.wrench_left_arm,   6);
+        copyToArray(F_ext_right_arm,  state.data.wrench_right_arm,  6);
+        copyToArray(F_ext_left_leg,   state.data.wrench_left_leg,   6);
+        copyToArray(F_ext_right_leg,  state.data.wrench_right_leg,  6);
+        copyToArray(F_ext_left_foot,  state.data.wrench_left_foot,  6);
+        copyToArray(F_ext_right_foot, state.data.wrench_right_foot, 6);
+        copyToArray(com_all,          state.data.com,               7);
+        broadcastData<wholeBodyState> (state,                       port_state);
+    }
+
+    if (publisher)
+        publisher->post(frame);
+    telemetry.toc(tmSectionOutput);
+    telemetry.endCycle();
 }
 
 void inverseDynamics::threadRelease()
 {
+    yInfo( "Stopping the pipeline stages\n");
+    if (reader)
+    {
+        reader->stop();
+        delete reader;
+        reader = nullptr;
+    }
+    if (publisher)
+    {
+        publisher->stop();
+        delete publisher;
+        publisher = nullptr;
+    }
+
     yInfo( "Closing the linear estimator\n");
     if(linEstUp)
     {
@@ -1120,6 +1232,8 @@ void inverseDynamics::threadRelease()
     closePort(port_dumpvel);
     yInfo( "Closing contacts port\n");
     closePort(port_contacts);
+    yInfo( "Closing state port\n");
+    closePort(port_state);
     yInfo( "Closing external_ft_arm_left port\n");
     closePort(port_external_ft_arm_left);
     yInfo( "Closing external_ft_arm_right port\n");
@@ -1156,13 +1270,33 @@ void inverseDynamics::closePort(Contactable *_port)
     }
 }
 
+void inverseDynamics::copyToArray(const Vector &_values, double *_array, size_t _n)
+{
+    size_t n = std::min(_n,_values.length());
+    for (size_t i=0; i<n; i++)
+        _array[i] = _values[i];
+}
+
+template <class T> void inverseDynamics::writeData(const T &_values, const Stamp &_stamp, BufferedPort<T> *_port)
+{
+    _port->setEnvelope(_stamp);
+    _port->prepare()  = _values ;
+    _port->write();
+}
+
 template <class T> void inverseDynamics::broadcastData(T& _values, BufferedPort<T> *_port)
 {
     if (_port && _port->getOutputCount()>0)
     {
-        _port->setEnvelope(this->timestamp);
-        _port->prepare()  = _values ;
-        _port->write();
+        if (publisher)
+        {
+            // data and timestamp are copied, since they change at the next cycle
+            Stamp stamp = this->timestamp;
+            T values = _values;
+            frame.push_back([values,stamp,_port]() { writeData<T>(values,stamp,_port); });
+        }
+        else
+            writeData<T>(_values,this->timestamp,_port);
     }
 }
 
@@ -1172,6 +1306,13 @@ void inverseDynamics::writeTorque(Vector _values, int _address, BufferedPort<Bot
     a.addInt32(_address);
     for(size_t i=0;i<_values.length();i++)
         a.addFloat64(_values(i));
+
+    if (publisher)
+    {
+        frame.push_back([a,_port]() { _port->prepare() = a; _port->write(); });
+        return;
+    }
+
     _port->prepare() = a;
     _port->write();
 }
@@ -1250,6 +1391,13 @@ void inverseDynamics::calibrateOffset(calib_enum calib_code)
 }
 
 bool inverseDynamics::readAndUpdate(bool waitMeasure, bool _init)
+{
+    bool b = readSensors(current_status, waitMeasure);
+    updateStatus(_init);
+    return b;
+}
+
+bool inverseDynamics::readSensors(iCubStatus &status, bool waitMeasure)
 {
     bool b = true;
     
@@ -1263,12 +1411,12 @@ bool inverseDynamics::readAndUpdate(bool waitMeasure, bool _init)
             tmp = port_ft_arm_left->read(waitMeasure);
             if (tmp != nullptr)
             {
-                current_status.ft_arm_left  = *tmp;
+                status.ft_arm_left  = *tmp;
             }
         }
         else
         {
-            current_status.ft_arm_left.zero();
+            status.ft_arm_left.zero();
         }
         if (waitMeasure) yDebug("done. \n");
     }
@@ -1282,17 +1430,16 @@ bool inverseDynamics::readAndUpdate(bool waitMeasure, bool _init)
             tmp = port_ft_arm_right->read(waitMeasure);
             if (tmp != nullptr)
             {
-                current_status.ft_arm_right = *tmp;
+                status.ft_arm_right = *tmp;
             }
         }
         else
         {
-            current_status.ft_arm_right.zero();
+            status.ft_arm_right.zero();
         }
         if (waitMeasure) yInfo("done. \n");
     }
-    b &= getUpperEncodersSpeedAndAcceleration();
-    setUpperMeasure(_init);
+    b &= getUpperEncodersSpeedAndAcceleration(status);
 
     // legs
     if (ddLL)
@@ -1304,12 +1451,12 @@ bool inverseDynamics::readAndUpdate(bool waitMeasure, bool _init)
             tmp = port_ft_leg_left->read(waitMeasure);
             if (tmp != nullptr)
             {
-                current_status.ft_leg_left  = *tmp;
+                status.ft_leg_left  = *tmp;
             }
         }
         else
         {
-            current_status.ft_leg_left.zero();
+            status.ft_leg_left.zero();
         }
         if (waitMeasure) yInfo("done. \n");
     }
@@ -1322,12 +1469,12 @@ bool inverseDynamics::readAndUpdate(bool waitMeasure, bool _init)
             tmp = port_ft_leg_right->read(waitMeasure);
             if (tmp != nullptr)
             {
-                current_status.ft_leg_right = *tmp;
+                status.ft_leg_right = *tmp;
             }
         }
         else
         {
-            current_status.ft_leg_right.zero();
+            status.ft_leg_right.zero();
         }
         if (waitMeasure) yInfo("done. \n");
     }
@@ -1342,12 +1489,12 @@ bool inverseDynamics::readAndUpdate(bool waitMeasure, bool _init)
             tmp = port_ft_foot_left->read(false); //not all the robot versions have the FT sensors installed in the feet
             if (tmp != nullptr)
             {
-                current_status.ft_foot_left  = *tmp;
+                status.ft_foot_left  = *tmp;
             }
         }
         else
         {
-            current_status.ft_foot_left.zero();
+            status.ft_foot_left.zero();
         }
         if (waitMeasure) yInfo("done. \n");
     }
@@ -1360,18 +1507,17 @@ bool inverseDynamics::readAndUpdate(bool waitMeasure, bool _init)
             tmp = port_ft_foot_right->read(false); //not all the robot versions have the FT sensors installed in the feet
             if (tmp != nullptr)
             {
-                current_status.ft_foot_right = *tmp;
+                status.ft_foot_right = *tmp;
             }
         }
         else
         {
-            current_status.ft_foot_right.zero();
+            status.ft_foot_right.zero();
         }
         if (waitMeasure) yInfo("done. \n");
     }
 
-    b &= getLowerEncodersSpeedAndAcceleration();
-    setLowerMeasure(_init);
+    b &= getLowerEncodersSpeedAndAcceleration(status);
 
     //inertial sensor
     if (waitMeasure) yInfo("Trying to connect to inertial sensor...");
@@ -1390,29 +1536,40 @@ bool inverseDynamics::readAndUpdate(bool waitMeasure, bool _init)
          (*inertial)[4] = 0;
          (*inertial)[5] = 0;
 #endif
-        current_status.inertial_d2p0[0] = (*inertial)[0];
-        current_status.inertial_d2p0[1] = (*inertial)[1];
-        current_status.inertial_d2p0[2] = (*inertial)[2];
-        current_status.inertial_w0 [0] =  (*inertial)[3]*CTRL_DEG2RAD;
-        current_status.inertial_w0 [1] =  (*inertial)[4]*CTRL_DEG2RAD;
-        current_status.inertial_w0 [2] =  (*inertial)[5]*CTRL_DEG2RAD;
-        current_status.inertial_dw0 = this->eval_domega(current_status.inertial_w0);
-        //yDebug ("%3.3f, %3.3f, %3.3f \n",current_status.inertial_d2p0[0],current_status.inertial_d2p0[1],current_status.inertial_d2p0[2]);
+        status.inertial_d2p0[0] = (*inertial)[0];
+        status.inertial_d2p0[1] = (*inertial)[1];
+        status.inertial_d2p0[2] = (*inertial)[2];
+        status.inertial_w0 [0] =  (*inertial)[3]*CTRL_DEG2RAD;
+        status.inertial_w0 [1] =  (*inertial)[4]*CTRL_DEG2RAD;
+        status.inertial_w0 [2] =  (*inertial)[5]*CTRL_DEG2RAD;
+        status.inertial_dw0 = this->eval_domega(status.inertial_w0);
+        //yDebug ("%3.3f, %3.3f, %3.3f \n",status.inertial_d2p0[0],status.inertial_d2p0[1],status.inertial_d2p0[2]);
 #ifdef DEBUG_PRINT_INERTIAL
         yDebug ("meas_w  (rad/s):  %3.3f, %3.3f, %3.3f \n", w0[0],   w0[1],   w0[2]);
         yDebug ("meas_dwo(rad/s):  %3.3f, %3.3f, %3.3f \n", dw0[0],  dw0[1],  dw0[2]);
 #endif
     }
 
-    //update the status memory
-    current_status.timestamp=Time::now();
-    previous_status.push_front(current_status);
-    if (previous_status.size()>status_queue_size) previous_status.pop_back();
+    status.timestamp=Time::now();
 
     return b;
 }
 
-bool inverseDynamics::getLowerEncodersSpeedAndAcceleration()
+void inverseDynamics::updateStatus(bool _init)
+{
+    setUpperMeasure(_init);
+    setLowerMeasure(_init);
+
+    //update the status memory, only with a new sample: the pipeline may hand
+    //the same status over to consecutive cycles
+    if (previous_status.empty() || (previous_status.front().timestamp!=current_status.timestamp))
+    {
+        previous_status.push_front(current_status);
+        if (previous_status.size()>status_queue_size) previous_status.pop_back();
+    }
+}
+
+bool inverseDynamics::getLowerEncodersSpeedAndAcceleration(iCubStatus &status)
 {
     bool b = true;
     if (iencs_leg_left)
@@ -1432,24 +1589,24 @@ bool inverseDynamics::getLowerEncodersSpeedAndAcceleration()
 
     for (size_t i=0;i<3;i++)
     {
-        current_status.all_q_low(i) = encoders_torso(2-i);
+        status.all_q_low(i) = encoders_torso(2-i);
     }
     for (size_t i=0;i<6;i++)
     {
-        current_status.all_q_low(3+i) = encoders_leg_left(i);
+        status.all_q_low(3+i) = encoders_leg_left(i);
     }
     for (size_t i=0;i<6;i++)
     {
-        current_status.all_q_low(3+6+i) = encoders_leg_right(i);
+        status.all_q_low(3+6+i) = encoders_leg_right(i);
     }
-    current_status.all_dq_low = evalVelLow(current_status.all_q_low);
-    current_status.all_d2q_low = evalAccLow(current_status.all_q_low);
+    status.all_dq_low = evalVelLow(status.all_q_low);
+    status.all_d2q_low = evalAccLow(status.all_q_low);
 
     return b;
 }
 
 
-bool inverseDynamics::getUpperEncodersSpeedAndAcceleration()
+bool inverseDynamics::getUpperEncodersSpeedAndAcceleration(iCubStatus &status)
 {
     bool b = true;
     if (iencs_arm_left) b &= iencs_arm_left->getEncoders(encoders_arm_left.data());
@@ -1461,18 +1618,18 @@ bool inverseDynamics::getUpperEncodersSpeedAndAcceleration()
 
     for (size_t i=0;i<3;i++)
     {
-        current_status.all_q_up(i) = encoders_head(i);
+        status.all_q_up(i) = encoders_head(i);
     }
     for (size_t i=0;i<7;i++)
     {
-        current_status.all_q_up(3+i) = encoders_arm_left(i);
+        status.all_q_up(3+i) = encoders_arm_left(i);
     }
     for (size_t i=0;i<7;i++)
     {
-        current_status.all_q_up(3+7+i) = encoders_arm_right(i);
+        status.all_q_up(3+7+i) = encoders_arm_right(i);
     }
-    current_status.all_dq_up = evalVelUp(current_status.all_q_up);
-    current_status.all_d2q_up = evalAccUp(current_status.all_q_up);
+    status.all_dq_up = evalVelUp(status.all_q_up);
+    status.all_d2q_up = evalAccUp(status.all_q_up);
 
     return b;
 }
@@ -1648,3 +1805,185 @@ void inverseDynamics::sendVelAccData()
     }
 }
 
+
+void inverseDynamics::getStats(Bottle &info)
+{
+    Bottle &bcompute = info.addList();
+    bcompute.addString("compute");
+    Bottle &c = bcompute.addList();
+    Bottle &ctm = c.addList();
+    ctm.addString("telemetry");
+    telemetry.getInfo(ctm.addList());
+    {
+        lock_guard<mutex> lck(mtxStats);
+        Bottle &age = c.addList();
+        age.addString("input_age");
+        inputAge.toBottle(age.addList());
+        Bottle &stale = c.addList();
+        stale.addString("stale_inputs");
+        stale.addInt64((int64_t)staleInputs);
+    }
+
+    if (reader)
+    {
+        Bottle &breader = info.addList();
+        breader.addString("reader");
+        Bottle &rtm = breader.addList().addList();
+        rtm.addString("telemetry");
+        reader->telemetry.getInfo(rtm.addList());
+    }
+
+    if (publisher)
+    {
+        Bottle &bpublisher = info.addList();
+        bpublisher.addString("publisher");
+        publisher->getInfo(bpublisher.addList());
+    }
+}
+
+void inverseDynamics::resetStats()
+{
+    telemetry.reset();
+    {
+        lock_guard<mutex> lck(mtxStats);
+        inputAge.reset();
+        staleInputs = 0;
+    }
+    if (reader)
+        reader->telemetry.reset();
+    if (publisher)
+        publisher->reset();
+}
+
+void latencyStat::toBottle(Bottle &b) const
+{
+    Bottle &bmean = b.addList();
+    bmean.addString("mean");
+    bmean.addFloat64((cnt>0)?1e3*sum/cnt:0.0);
+    Bottle &bmax = b.addList();
+    bmax.addString("max");
+    bmax.addFloat64(1e3*max);
+}
+
+sensorReader::sensorReader(inverseDynamics *_obs, double _period) : PeriodicThread(_period), obs(_obs), front(0), fresh(false), telemetry(_period)
+{
+    ok[0] = ok[1] = true;
+}
+
+void sensorReader::init(const iCubStatus &status)
+{
+    lock_guard<mutex> lck(mtx);
+    buffer[0] = buffer[1] = status;
+    ok[0] = ok[1] = true;
+    front = 0;
+    fresh = false;
+}
+
+bool sensorReader::getLatest(iCubStatus &status, bool &_ok)
+{
+    lock_guard<mutex> lck(mtx);
+    status = buffer[front];
+    _ok = ok[front];
+    bool ret = fresh;
+    fresh = false;
+    return ret;
+}
+
+void sensorReader::run()
+{
+    telemetry.beginCycle();
+
+    // the back buffer is filled without locking, since the consumer only
+    // accesses the front one; it starts from the latest status, so that
+    // the sensors not providing new data keep their previous values
+    int back = 1-front;
+    buffer[back] = buffer[front];
+    ok[back] = obs->readSensors(buffer[back]);
+
+    {
+        lock_guard<mutex> lck(mtx);
+        front = back;
+        fresh = true;
+    }
+
+    telemetry.endCycle();
+}
+
+asyncPublisher::asyncPublisher(double _period) : tPending(0.0), hasPending(false), dropped(0), telemetry(_period)
+{
+}
+
+void asyncPublisher::post(vector<function<void()>> &frame)
+{
+    {
+        lock_guard<mutex> lck(mtx);
+        if (hasPending)
+            dropped++;
+        pending.swap(frame);
+        tPending = SystemClock::nowSystem();
+        hasPending = true;
+    }
+    cv.notify_one();
+
+    // release the dropped frame (if any) outside the lock
+    frame.clear();
+}
+
+void asyncPublisher::run()
+{
+    vector<function<void()>> writing;
+    while (!isStopping())
+    {
+        double t0;
+        {
+            unique_lock<mutex> lck(mtx);
+            cv.wait(lck,[this]() { return hasPending || isStopping(); });
+            if (!hasPending)
+                break;
+            writing.swap(pending);
+            t0 = tPending;
+            hasPending = false;
+        }
+
+        // each run writes one frame: the jitter of the telemetry reflects
+        // the rate of the frames rather than a fixed period
+        telemetry.beginCycle();
+        for (auto &write : writing)
+            write();
+        telemetry.endCycle();
+        writing.clear();
+
+        lock_guard<mutex> lck(mtx);
+        latency.add(SystemClock::nowSystem()-t0);
+    }
+}
+
+void asyncPublisher::onStop()
+{
+    // locking prevents the wake-up from getting lost
+    lock_guard<mutex> lck(mtx);
+    cv.notify_all();
+}
+
+void asyncPublisher::getInfo(Bottle &info)
+{
+    Bottle &btm = info.addList();
+    btm.addString("telemetry");
+    telemetry.getInfo(btm.addList());
+
+    lock_guard<mutex> lck(mtx);
+    Bottle &blatency = info.addList();
+    blatency.addString("latency");
+    latency.toBottle(blatency.addList());
+    Bottle &bdropped = info.addList();
+    bdropped.addString("dropped");
+    bdropped.addInt64((int64_t)dropped);
+}
+
+void asyncPublisher::reset()
+{
+    telemetry.reset();
+    lock_guard<mutex> lck(mtx);
+    latency.reset();
+    dropped = 0;
+}
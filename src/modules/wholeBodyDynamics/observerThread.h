@@ -24,14 +24,20 @@
 #include <yarp/dev/all.h>
 #include <iCub/ctrl/math.h>
 #include <iCub/ctrl/adaptWinPolyEstimator.h>
+#include <iCub/ctrl/telemetry.h>
 #include <iCub/iDyn/iDyn.h>
 #include <iCub/iDyn/iDynBody.h>
 #include <iCub/skinDynLib/skinContactList.h>
+#include <iCub/skinDynLib/wholeBodyState.h>
 
 #include <iostream>
 #include <iomanip>
 #include <cstring>
 #include <list>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
 
 using namespace yarp::os;
 using namespace yarp::sig;
@@ -125,9 +131,71 @@ class iCubStatus
 
 };
 
+class inverseDynamics;
+
+// mean and max of a latency [s]
+struct latencyStat
+{
+    unsigned long cnt;
+    double sum;
+    double max;
+
+    latencyStat() { reset(); }
+    void reset() { cnt=0; sum=max=0.0; }
+    void add(double x) { cnt++; sum+=x; if (x>max) max=x; }
+    void toBottle(Bottle &b) const;
+};
+
+// reader stage: acquires encoders, F/T and inertial sensors at the thread rate
+// and stores the timestamped status in a double buffer
+class sensorReader: public PeriodicThread
+{
+    inverseDynamics *obs;
+    std::mutex mtx;
+    iCubStatus buffer[2];
+    bool       ok[2];
+    int        front;
+    bool       fresh;
+
+public:
+    CycleTelemetry telemetry;
+
+    sensorReader(inverseDynamics *_obs, double _period);
+    void init(const iCubStatus &status);
+    // returns true if the status is newer than the one of the previous call
+    bool getLatest(iCubStatus &status, bool &_ok);
+    void run() override;
+};
+
+// publisher stage: writes the output ports out of the computation thread;
+// if a frame is still pending when a new one is posted, the old one is dropped
+class asyncPublisher: public Thread
+{
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<std::function<void()>> pending;
+    double tPending;
+    bool hasPending;
+    unsigned long dropped;
+    latencyStat latency;
+
+public:
+    CycleTelemetry telemetry;
+
+    asyncPublisher(double _period);
+    void post(std::vector<std::function<void()>> &frame);
+    void run() override;
+    void onStop() override;
+    void getInfo(Bottle &info);
+    void reset();
+};
+
 // class inverseDynamics: class for reading from Vrow and providing FT on an output port
 class inverseDynamics: public PeriodicThread
 {
+    friend class sensorReader;
+
+
 public:
     bool       com_enabled;
     bool       com_vel_enabled;
@@ -137,6 +205,7 @@ public:
     bool       auto_drift_comp;
     bool       default_ee_cont;
     bool       add_legs_once;
+    bool       pipeline_enabled;
 
 private:
     string      robot_name;
@@ -223,6 +292,7 @@ private:
     BufferedPort<Vector> *port_com_to;
     BufferedPort<Vector> *port_monitor;
     BufferedPort<iCub::skinDynLib::skinContactList> *port_contacts;
+    BufferedPort<iCub::skinDynLib::wholeBodyState> *port_state;
     BufferedPort<Vector> *port_dumpvel;
     BufferedPort<Vector> *port_COM_vel;
     BufferedPort<Matrix> *port_COM_Jacobian;
@@ -237,15 +307,16 @@ private:
     BufferedPort<Vector> *port_external_ft_leg_left;
     BufferedPort<Vector> *port_external_ft_leg_right;
     yarp::os::Stamp timestamp;
+    iCub::skinDynLib::wholeBodyState state;
 
     bool first;
     thread_status_enum thread_status;
 
-    AWLinEstimator  *InertialEst;
-    AWLinEstimator  *linEstUp;
-    AWQuadEstimator *quadEstUp;
-    AWLinEstimator  *linEstLow;
-    AWQuadEstimator *quadEstLow;
+    FastAWLinEstimator  *InertialEst;
+    FastAWLinEstimator  *linEstUp;
+    FastAWQuadEstimator *quadEstUp;
+    FastAWLinEstimator  *linEstLow;
+    FastAWQuadEstimator *quadEstLow;
 
     int ctrlJnt;
     int allJnt;
@@ -295,6 +366,18 @@ private:
     //COM Jacobian Matrix
     Matrix com_jac;
 
+    // pipeline stages and telemetry of the computation stage
+    sensorReader   *reader;
+    asyncPublisher *publisher;
+    std::vector<std::function<void()>> frame;
+    CycleTelemetry telemetry;
+    int tmSectionInput;
+    int tmSectionSolver;
+    int tmSectionOutput;
+    std::mutex mtxStats;
+    latencyStat inputAge;
+    unsigned long staleInputs;
+
     Vector evalVelUp(const Vector &x);
     Vector evalVelLow(const Vector &x);
     Vector eval_domega(const Vector &x);
@@ -307,11 +390,16 @@ private:
     void setLowerMeasure(bool _init=false);
 
     void addSkinContacts();
+    bool readSensors(iCubStatus &status, bool waitMeasure=false);
+    void updateStatus(bool _init=false);
+    template <class T> static void writeData(const T &_values, const Stamp &_stamp, BufferedPort<T> *_port);
+    static void copyToArray(const Vector &_values, double *_array, size_t _n);
 
 public:
     inverseDynamics(int _rate, PolyDriver *_ddAL, PolyDriver *_ddAR, PolyDriver *_ddH, PolyDriver *_ddLL, PolyDriver *_ddLR, PolyDriver *_ddT, string _robot_name, string _local_name, version_tag icub_type, bool _autoconnect=false );
     bool threadInit() override;
     void setStiffMode();
+    void setNumThreads(unsigned int nThreads);
     inline thread_status_enum getThreadStatus() 
     {
         return thread_status;
@@ -324,8 +412,10 @@ public:
     template <class T> void broadcastData(T& _values, BufferedPort<T> *_port);
     void calibrateOffset(calib_enum calib_code=CALIB_ALL);
     bool readAndUpdate(bool waitMeasure=false, bool _init=false);
-    bool getLowerEncodersSpeedAndAcceleration();
-    bool getUpperEncodersSpeedAndAcceleration();
+    bool getLowerEncodersSpeedAndAcceleration(iCubStatus &status);
+    bool getUpperEncodersSpeedAndAcceleration(iCubStatus &status);
+    void getStats(Bottle &info);
+    void resetStats();
     void setZeroJntAngVelAcc();
     void sendMonitorData();
     void sendVelAccData();
@@ -73,6 +73,19 @@
  *  torso_covers on
  *  left_arm_covers on
  *  right_arm_covers on
+ *
+ * The following options, given on the command line, are meant for batch runs
+ * (e.g. the collection of data or the training of controllers):
+ * - --headless : no window is opened and nothing is rendered, hence the
+ *   cameras are not streamed
+ * - --fast : the simulation steps as fast as possible instead of in
+ *   real-time; the devices of the simulator are timed by the simulated time,
+ *   which is streamed on /icubSim/clock
+ * - --lockstep : as --fast, but each step waits to be granted through
+ *   /icubSim/clock/rpc ("step [n]" replies once the n steps are done)
+ *
+ * The clients share the simulated time when started with
+ * YARP_CLOCK=/icubSim/clock.
  * 
  * 
  * \section portsa_sec Ports Accessed
@@ -127,6 +140,8 @@
  * - /icubSim/touch : streams out a sequence the touch sensors for both hands
  * - /icubSim/inertial : streams out a sequence of inertial data taken from the head
  * - /icubSim/texture : port to receive texture data to place on an object (e.g. data from a webcam etc...)
+ * - /icubSim/clock : streams out the simulated time (with --fast or --lockstep)
+ * - /icubSim/clock/rpc : grants the steps in lockstep mode ("step [n]", "time")
  *
  * \section in_files_sec Input Data Files
  * iCubSimulator expects the following configuration files:
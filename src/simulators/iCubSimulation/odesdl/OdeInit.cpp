@@ -20,6 +20,7 @@
 
 #include "OdeInit.h"
 #include <yarp/os/LogStream.h>
+#include <yarp/os/SystemClock.h>
 
 OdeInit *OdeInit::_odeinit = NULL;
 
@@ -44,6 +45,36 @@ OdeInit::OdeInit(RobotConfig *config) : robot_config(config)
     // The default value is zero. Increasing this to some small value (e.g. 0.001) can help prevent jittering 
     // problems due to contacts being repeatedly made and broken. 
     dWorldSetContactSurfaceLayer(world, config->getContactSurfaceLayer());
+
+    // dWorldStep solves the constraints of an island exactly, at a cost which is cubic in their number;
+    // dWorldQuickStep iterates a fixed number of times, linear in their number but less accurate
+    // (the higher the iterations, the closer to dWorldStep)
+    quickStep = (config->getWorldStepper() == "quickstep");
+    if (quickStep) {
+        dWorldSetQuickStepNumIterations(world, config->getQuickStepIterations());
+        dWorldSetQuickStepW(world, config->getQuickStepSOR());
+    } else if (config->getWorldStepper() != "step") {
+        yWarning("unknown stepper %s in ode_params.ini, using step\n", config->getWorldStepper().c_str());
+    }
+    stepDuration = 0.0;
+
+    // the independent islands (e.g. the robot and the objects it does not touch) can be stepped by several threads
+    int threads = config->getWorldThreads();
+#ifdef ICUB_SIM_ODE_THREADING
+    threading = NULL;
+    threadPool = NULL;
+    if (threads > 1) {
+        threading = dThreadingAllocateMultiThreadedImplementation();
+        threadPool = dThreadingAllocateThreadPool(threads, 0, dAllocateFlagBasicData, NULL);
+        dThreadingThreadPoolServeMultiListener(threadPool, threading);
+        dWorldSetStepThreadingImplementation(world, dThreadingImplementationGetFunctions(threading), threading);
+        dWorldSetStepIslandsProcessingMaxThreadCount(world, threads);
+    }
+#else
+    if (threads > 1) {
+        yWarning("this ODE has no support for threads, the world is stepped by one thread\n");
+    }
+#endif
     
     //Contact joints can simulate friction at the contact by applying special forces in the two friction directions that are perpendicular to the normal.
     //This value sets the friction coefficient, mju, for both directions. High means that the colliding surfaces will not slide along one another. 
@@ -107,6 +138,15 @@ OdeInit::~OdeInit()
     delete _wrld;
     delete _iCub;
     delete[] _controls;
+
+#ifdef ICUB_SIM_ODE_THREADING
+    if (threading != NULL) {
+        dWorldSetStepThreadingImplementation(world, NULL, NULL);
+        dThreadingImplementationShutdownProcessing(threading);
+        dThreadingFreeThreadPool(threadPool);
+        dThreadingFreeImplementation(threading);
+    }
+#endif
     
     dGeomDestroy(ground);
     dJointGroupDestroy(contactgroup);
@@ -114,6 +154,17 @@ OdeInit::~OdeInit()
     dWorldDestroy(world);
 }
 
+void OdeInit::worldStep(double dt)
+{
+    double start = yarp::os::SystemClock::nowSystem();
+    if (quickStep) {
+        dWorldQuickStep(world, dt);
+    } else {
+        dWorldStep(world, dt);
+    }
+    stepDuration = 0.99*stepDuration + 0.01*(yarp::os::SystemClock::nowSystem() - start);
+}
+
 OdeInit& OdeInit::init(RobotConfig *config)
 {
     if (_odeinit==NULL)
@@ -42,6 +42,10 @@
 #include <mutex>
 #include <list>
 
+#ifdef ICUB_SIM_ODE_THREADING
+#include <ode/threading_impl.h>
+#endif
+
 using namespace std;
 using namespace yarp::dev;
 
@@ -84,6 +88,9 @@ public:
         dJointID contact_joint;
     };
     list<contactOnSkin_t> listOfSkinContactInfos;
+
+    bool quickStep;         // dWorldQuickStep instead of dWorldStep
+    double stepDuration;    // average wall time of worldStep() in seconds
   
 
     void setName( string module ){
@@ -102,6 +109,12 @@ public:
     static OdeInit& init(RobotConfig *config);
     void sendHomePos();
 
+    /**
+     * Steps the world with the stepper chosen in ode_params.ini.
+     * @param dt the step in seconds
+     */
+    void worldStep(double dt);
+
     static OdeInit& get();
 
     static void destroy();
@@ -115,6 +128,11 @@ private:
     static OdeInit *_odeinit;
 
     RobotConfig *robot_config;
+
+#ifdef ICUB_SIM_ODE_THREADING
+    dThreadingImplementationID threading;
+    dThreadingThreadPoolID threadPool;
+#endif
 };
 
 #endif
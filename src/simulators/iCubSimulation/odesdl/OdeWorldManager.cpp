@@ -31,6 +31,22 @@
 using namespace yarp::os;
 using namespace std;
 
+// set while the thread holds the ODE state for a batch of ops
+static thread_local bool batchOpen = false;
+
+// locks the ODE state for one op, unless a batch already holds it
+class OdeLock {
+    bool owner;
+public:
+    OdeLock() : owner(!batchOpen) {
+        if (owner) OdeInit::get().mtx.lock();
+    }
+
+    ~OdeLock() {
+        if (owner) OdeInit::get().mtx.unlock();
+    }
+};
+
 class OdeLink {
     std::mutex ODE_access;
 public:
@@ -170,14 +186,14 @@ void OdeLink::doGet() {
 
     if (!checkObject()) return;
     if (bid!=NULL) {
-        lock_guard<mutex> lck(odeinit.mtx);
+        OdeLock lck;
         const dReal *coords = dBodyGetPosition(bid);
         result.location = WorldOpTriplet(coords[0],coords[1],coords[2]);
         result.setOk();
         return;
     }
     if (gid!=NULL) {
-        lock_guard<mutex> lck(odeinit.mtx);
+        OdeLock lck;
         const dReal *coords = dGeomGetPosition(gid);
         result.location = WorldOpTriplet(coords[0],coords[1],coords[2]);
         result.setOk();
@@ -207,7 +223,7 @@ void OdeLink::doSet() {
         return;
     }
     if (bid!=NULL) {
-        lock_guard<mutex> lck(odeinit.mtx);
+        OdeLock lck;
         dBodySetPosition(bid,
                          op.location.get(0),
                          op.location.get(1),
@@ -218,7 +234,7 @@ void OdeLink::doSet() {
         return;
     }
     if (gid!=NULL) {
-        lock_guard<mutex> lck(odeinit.mtx);
+        OdeLock lck;
         dGeomSetPosition(gid,
                          op.location.get(0),
                          op.location.get(1),
@@ -235,8 +251,12 @@ void OdeLink::doMake() {
         result.setFail("cannot create that kind of object");
         return;
     }
-    OdeInit& odeinit = OdeInit::get();
-    lock_guard<mutex> lck(odeinit.mtx);
+    if (batchOpen && op.kind.get()=="model") {
+        // the render thread loads the texture of one model at a time
+        result.setFail("models cannot be created in a batch");
+        return;
+    }
+    OdeLock lck;
     if (store->create(op,result)) {
         result.setOk();
     }
@@ -274,7 +294,7 @@ void OdeLink::doGrab() {
         return;
     }
 
-    lock_guard<mutex> lck(odeinit.mtx);
+    OdeLock lck;
     if (active) {
         if (bid!=NULL) {
             if (left) {
@@ -312,14 +332,14 @@ void OdeLink::doRotate() {
     // We want to get the object rotation
     if (!op.rotation.isValid()) {
         if (bid!=NULL) {
-            lock_guard<mutex> lck(odeinit.mtx);
+            OdeLock lck;
             const dReal *R = dBodyGetRotation(bid);
             result.rotation = WorldOpTriplet(atan2(R[9], R[10])*180/M_PI, asin(-R[8])*180/M_PI, atan2(R[4], R[0])*180/M_PI);
             result.setOk();
             return;
         }
         if (gid!=NULL) {
-            lock_guard<mutex> lck(odeinit.mtx);
+            OdeLock lck;
             const dReal *R = dGeomGetRotation(gid);
             result.rotation = WorldOpTriplet(atan2(R[9], R[10])*180/M_PI, asin(-R[8])*180/M_PI, atan2(R[4], R[0])*180/M_PI);
             result.setOk();
@@ -345,7 +365,7 @@ void OdeLink::doRotate() {
         
         dMultiply0 (Rtmp1,Rty,Rtz,3,3,3);
         dMultiply0 (Rtmp2,Rtx,Rtmp1,3,3,3);
-        lock_guard<mutex> lck(odeinit.mtx);
+        OdeLock lck;
         dGeomSetRotation(object->getGeometry(),Rtmp2);
         result.setOk();
     }
@@ -380,7 +400,7 @@ void OdeLink::doDelete() {
     OdeInit& odeinit = OdeInit::get();
 
     if (op.kind.get() == "all") {
-        lock_guard<mutex> lck(odeinit.mtx);
+        OdeLock lck;
         odeinit._wrld->box_dynamic.clear();
         odeinit._wrld->box_static.clear();
         odeinit._wrld->cylinder_dynamic.clear();
@@ -406,7 +426,7 @@ void OdeLink::doNumber() {
         return;
     }
     OdeInit& odeinit = OdeInit::get();
-    lock_guard<mutex> lck(odeinit.mtx);
+    OdeLock lck;
     int ct = store->length();
     result.count = WorldOpIndex(ct);
     result.setOk();
@@ -452,3 +472,94 @@ void OdeWorldManager::apply(const WorldOp& op, WorldResult& result) {
     OdeLink link(op,result);
     link.apply();
 }
+
+void OdeWorldManager::beginBatch() {
+    OdeInit::get().mtx.lock();
+    batchOpen = true;
+}
+
+void OdeWorldManager::endBatch() {
+    batchOpen = false;
+    OdeInit::get().mtx.unlock();
+}
+
+// the angles of the "rot" command, which composes Rx*Ry*Rz
+static void getRotation(const dReal *R, Bottle& op) {
+    op.addFloat64(atan2(-R[6], R[10])*180/M_PI);
+    op.addFloat64(asin(R[2])*180/M_PI);
+    op.addFloat64(atan2(-R[1], R[0])*180/M_PI);
+}
+
+static void addObject(Bottle& scene, const char *kind, WorldObjectList& store,
+                      int index, Bottle& mk) {
+    OdeInit& odeinit = OdeInit::get();
+    WorldObject& obj = store.get(index);
+    dGeomID geom = obj.getGeometry();
+    const dReal *pos = dGeomGetPosition(geom);
+    mk.addFloat64(pos[0]);
+    mk.addFloat64(pos[1]);
+    mk.addFloat64(pos[2]);
+    mk.addFloat64(store.colors[index][0]);
+    mk.addFloat64(store.colors[index][1]);
+    mk.addFloat64(store.colors[index][2]);
+    mk.addInt32(dGeomGetSpace(geom)==odeinit.space);
+    scene.addList() = mk;
+
+    Bottle& rot = scene.addList();
+    rot.addString("rot");
+    rot.addString(kind);
+    rot.addInt32(index+1);
+    getRotation(dGeomGetRotation(geom),rot);
+}
+
+bool OdeWorldManager::snapshot(Bottle& scene) {
+    OdeInit& odeinit = OdeInit::get();
+    worldSim& w = *odeinit._wrld;
+    lock_guard<mutex> lck(odeinit.mtx);
+
+    // the objects are recreated in the same order, hence with the same
+    // indices; the velocities and the models are not saved
+    scene.clear();
+    Bottle& del = scene.addList();
+    del.addString("del");
+    del.addString("all");
+    for (int k=0; k<2; k++) {
+        bool dynamic = (k==0);
+        WorldObjectList *boxes = dynamic?(&w.box_dynamic):(&w.box_static);
+        WorldObjectList *cyls = dynamic?(&w.cylinder_dynamic):(&w.cylinder_static);
+        WorldObjectList *sphs = dynamic?(&w.sphere_dynamic):(&w.sphere_static);
+        worldSim::MyObject *box = dynamic?w.obj:w.s_obj;
+        worldSim::MyObject1 *cyl = dynamic?w.cyl_obj:w.s_cyl_obj;
+        worldSim::MyObject3 *sph = dynamic?w.sph:w.s_sph;
+
+        for (int i=0; i<boxes->length(); i++) {
+            Bottle mk;
+            mk.addString("mk");
+            mk.addString(dynamic?"box":"sbox");
+            mk.addFloat64(box[i].size[0]);
+            mk.addFloat64(box[i].size[1]);
+            mk.addFloat64(box[i].size[2]);
+            addObject(scene,dynamic?"box":"sbox",*boxes,i,mk);
+        }
+        for (int i=0; i<cyls->length(); i++) {
+            Bottle mk;
+            mk.addString("mk");
+            mk.addString(dynamic?"cyl":"scyl");
+            mk.addFloat64(cyl[i].radius);
+            mk.addFloat64(cyl[i].length);
+            addObject(scene,dynamic?"cyl":"scyl",*cyls,i,mk);
+        }
+        for (int i=0; i<sphs->length(); i++) {
+            Bottle mk;
+            mk.addString("mk");
+            mk.addString(dynamic?"sph":"ssph");
+            mk.addFloat64(sph[i].radius);
+            addObject(scene,dynamic?"sph":"ssph",*sphs,i,mk);
+        }
+    }
+    int models = w.model_dynamic.length() + w.model_static.length();
+    if (models>0) {
+        yWarning("%d models are not saved in the scene\n", models);
+    }
+    return true;
+}
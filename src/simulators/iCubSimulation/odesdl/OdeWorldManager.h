@@ -42,6 +42,12 @@ public:
     // will only be used when respond() is removed.
     virtual void apply(const WorldOp& op, WorldResult& result);
 
+    virtual void beginBatch();
+
+    virtual void endBatch();
+
+    virtual bool snapshot(yarp::os::Bottle& scene);
+
 private:
     int num;
     int a, b, c;
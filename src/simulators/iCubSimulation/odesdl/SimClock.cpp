@@ -0,0 +1,147 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+* Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+* website: www.robotcub.org
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* A copy of the license can be found at
+* http://www.robotcub.org/icub/license/gpl.txt
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "SimClock.h"
+
+#include <yarp/os/ConnectionReader.h>
+#include <yarp/os/ConnectionWriter.h>
+#include <yarp/os/LogStream.h>
+
+#include <cmath>
+#include <chrono>
+
+using namespace yarp::os;
+
+SimClock::SimClock() :
+    time(0.0), lockstep(false), closing(false), stepsGranted(0), stepsDone(0) {
+}
+
+bool SimClock::open(const std::string& name, bool lockstep) {
+    this->lockstep = lockstep;
+    if (!clockPort.open(name + "/clock")) {
+        return false;
+    }
+    rpcPort.setReader(*this);
+    if (!rpcPort.open(name + "/clock/rpc")) {
+        clockPort.close();
+        return false;
+    }
+    return true;
+}
+
+void SimClock::close() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        interrupt();
+        granted.notify_all();
+        stepped.notify_all();
+    }
+    rpcPort.interrupt();
+    clockPort.interrupt();
+    rpcPort.close();
+    clockPort.close();
+}
+
+bool SimClock::waitStep() {
+    std::unique_lock<std::mutex> lock(mtx);
+    while (lockstep && !closing && stepsGranted <= stepsDone) {
+        // the timeout lets an interrupt() from a signal handler through
+        granted.wait_for(lock, std::chrono::milliseconds(100));
+    }
+    return !closing;
+}
+
+void SimClock::advance(double dt) {
+    // only the ODE thread writes the time
+    double t = time.load() + dt;
+    time.store(t);
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stepsDone++;
+        stepped.notify_all();
+    }
+
+    // published in the format of the network clock: (seconds nanoseconds);
+    // in lockstep mode no tick is dropped, the clients wait for it anyway
+    Bottle& tick = clockPort.prepare();
+    tick.clear();
+    double sec = std::floor(t);
+    tick.addInt32((int)sec);
+    tick.addInt32((int)((t - sec)*1e9));
+    clockPort.write(lockstep);
+}
+
+double SimClock::now() {
+    return time.load();
+}
+
+void SimClock::delay(double seconds) {
+    double target = time.load() + seconds;
+    std::unique_lock<std::mutex> lock(mtx);
+    while (!closing && time.load() < target) {
+        stepped.wait_for(lock, std::chrono::milliseconds(100));
+    }
+}
+
+bool SimClock::isValid() const {
+    return true;
+}
+
+bool SimClock::read(ConnectionReader& connection) {
+    Bottle cmd, reply;
+    if (!cmd.read(connection)) {
+        return false;
+    }
+
+    std::string tag = cmd.get(0).asString();
+    if (tag == "step") {
+        int n = cmd.size() > 1 ? cmd.get(1).asInt32() : 1;
+        if (!lockstep) {
+            reply.addString("fail");
+            reply.addString("the simulator is not in lockstep mode");
+        } else if (n < 1) {
+            reply.addString("fail");
+            reply.addString("the number of steps must be positive");
+        } else {
+            std::unique_lock<std::mutex> lock(mtx);
+            stepsGranted += n;
+            long target = stepsGranted;
+            granted.notify_all();
+            while (!closing && stepsDone < target) {
+                stepped.wait_for(lock, std::chrono::milliseconds(100));
+            }
+            lock.unlock();
+            reply.addString("ok");
+            reply.addFloat64(now());
+        }
+    } else if (tag == "time") {
+        reply.addFloat64(now());
+    } else if (tag == "help") {
+        reply.addString("step [n] : run n steps (default 1) and reply with the time, lockstep mode only");
+        reply.addString("time : reply with the simulated time in seconds");
+    } else {
+        reply.addString("fail");
+        reply.addString("unknown command");
+    }
+
+    ConnectionWriter *writer = connection.getWriter();
+    if (writer != NULL) {
+        reply.write(*writer);
+    }
+    return true;
+}
@@ -0,0 +1,112 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+* Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+* website: www.robotcub.org
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* A copy of the license can be found at
+* http://www.robotcub.org/icub/license/gpl.txt
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef __SIM_CLOCK__
+#define __SIM_CLOCK__
+
+/**
+ * \file SimClock.h
+ * \brief Header file for the clock of a simulation which is not paced by the wall clock
+ **/
+
+#include <yarp/os/Clock.h>
+#include <yarp/os/PortReader.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/RpcServer.h>
+#include <yarp/os/Bottle.h>
+
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ *
+ * The simulated time, advanced by the ODE thread of one step length per step.
+ * Once installed with yarp::os::Time::useCustomClock() the devices of the
+ * simulator are timed and stamped by it, and it is streamed on the
+ * <name>/clock port in the format of the network clock of YARP, so that the
+ * clients started with YARP_CLOCK=<name>/clock share it.
+ *
+ * In lockstep mode the steps are granted by the clients through the
+ * <name>/clock/rpc port, and the ODE thread waits for them.
+ *
+ */
+class SimClock : public yarp::os::Clock, public yarp::os::PortReader {
+public:
+    SimClock();
+
+    /**
+     * Opens the ports.
+     * @param name the prefix of the ports (e.g. /icubSim)
+     * @param lockstep true if the steps are granted through the rpc port
+     */
+    bool open(const std::string& name, bool lockstep);
+
+    /**
+     * Wakes up whoever waits on the clock and closes the ports.
+     */
+    void close();
+
+    /**
+     * Tells whoever waits on the clock to give up, within 100 ms. It only
+     * sets a flag, hence it can be called by a signal handler.
+     */
+    void interrupt() { closing = true; }
+
+    /**
+     * Called by the ODE thread before a step: in lockstep mode it waits until
+     * the step is granted.
+     * @return false if the clock is being closed
+     */
+    bool waitStep();
+
+    /**
+     * Called by the ODE thread after a step: advances and publishes the time.
+     * @param dt the length of the step in seconds
+     */
+    void advance(double dt);
+
+    bool isLockstep() const { return lockstep; }
+
+    // yarp::os::Clock
+    virtual double now();
+    virtual void delay(double seconds);
+    virtual bool isValid() const;
+
+    // yarp::os::PortReader, serves the rpc port
+    virtual bool read(yarp::os::ConnectionReader& connection);
+
+private:
+    std::atomic<double> time;
+    bool lockstep;
+
+    std::atomic<bool> closing;
+
+    // granted and executed steps
+    std::mutex mtx;
+    std::condition_variable granted;
+    std::condition_variable stepped;
+    long stepsGranted;
+    long stepsDone;
+
+    yarp::os::BufferedPort<yarp::os::Bottle> clockPort;
+    yarp::os::RpcServer rpcPort;
+};
+
+#endif
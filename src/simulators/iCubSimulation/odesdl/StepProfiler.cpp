@@ -0,0 +1,128 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+* Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+* website: www.robotcub.org
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* A copy of the license can be found at
+* http://www.robotcub.org/icub/license/gpl.txt
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#include "StepProfiler.h"
+
+#include <yarp/os/SystemClock.h>
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace yarp::os;
+
+static const char *phaseNames[StepProfiler::PHASES+2] = {
+    "collision", "step", "controllers", "sensors", "streaming", "total", "contacts"
+};
+
+StepProfiler::StepProfiler(int window) :
+    window(window>0 ? window : 1), mark(0.0) {
+    for (int i=0; i<PHASES+2; i++) {
+        samples[i].resize(this->window);
+    }
+    for (int i=0; i<PHASES; i++) {
+        current[i] = 0.0;
+    }
+    reset();
+}
+
+void StepProfiler::reset() {
+    std::lock_guard<std::mutex> lock(mtx);
+    next = 0;
+    count = 0;
+    steps = 0;
+    for (int i=0; i<=PHASES; i++) {
+        sums[i] = 0.0;
+    }
+}
+
+void StepProfiler::start() {
+    // the system clock, since the simulated time does not move within a step
+    mark = SystemClock::nowSystem();
+    for (int i=0; i<PHASES; i++) {
+        current[i] = 0.0;
+    }
+}
+
+void StepProfiler::lap(Phase phase) {
+    double now = SystemClock::nowSystem();
+    current[phase] += now - mark;
+    mark = now;
+}
+
+void StepProfiler::finish(int contacts) {
+    std::lock_guard<std::mutex> lock(mtx);
+    double total = 0.0;
+    for (int i=0; i<PHASES; i++) {
+        samples[i][next] = (float)current[i];
+        sums[i] += current[i];
+        total += current[i];
+    }
+    samples[PHASES][next] = (float)total;
+    samples[PHASES+1][next] = (float)contacts;
+    sums[PHASES] += total;
+    steps++;
+    next = (next+1) % window;
+    if (count<window) {
+        count++;
+    }
+}
+
+std::string StepProfiler::summary() {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::string line;
+    char buf[64];
+    for (int i=0; i<=PHASES; i++) {
+        sprintf(buf, "%s%s %.3f", i>0 ? ", " : "", phaseNames[i], steps>0 ? 1e3*sums[i]/steps : 0.0);
+        line += buf;
+        sums[i] = 0.0;
+    }
+    line += " ms per step";
+    steps = 0;
+    return line;
+}
+
+void StepProfiler::getStats(Bottle& stats) {
+    std::vector<float> sorted;
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        sorted.reserve(count*(PHASES+2));
+        for (int i=0; i<PHASES+2; i++) {
+            sorted.insert(sorted.end(), samples[i].begin(), samples[i].begin()+count);
+        }
+    }
+    for (int i=0; i<PHASES+2; i++) {
+        Bottle& phase = stats.addList();
+        phase.addString(phaseNames[i]);
+        if (count==0) {
+            continue;
+        }
+        std::vector<float>::iterator begin = sorted.begin()+i*count;
+        std::vector<float>::iterator end = begin+count;
+        double scale = (i<=PHASES) ? 1e3 : 1.0;
+        double sum = 0.0;
+        for (std::vector<float>::iterator it=begin; it!=end; it++) {
+            sum += *it;
+        }
+        std::sort(begin, end);
+        phase.addFloat64(scale*sum/count);
+        phase.addFloat64(scale*begin[count/2]);
+        phase.addFloat64(scale*begin[(count*9)/10]);
+        phase.addFloat64(scale*begin[(count*99)/100]);
+        phase.addFloat64(scale*begin[count-1]);
+    }
+}
@@ -0,0 +1,101 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+* Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+* website: www.robotcub.org
+* Permission is granted to copy, distribute, and/or modify this program
+* under the terms of the GNU General Public License, version 2 or any
+* later version published by the Free Software Foundation.
+*
+* A copy of the license can be found at
+* http://www.robotcub.org/icub/license/gpl.txt
+*
+* This program is distributed in the hope that it will be useful, but
+* WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+* Public License for more details
+*/
+
+#ifndef __STEP_PROFILER__
+#define __STEP_PROFILER__
+
+/**
+ * \file StepProfiler.h
+ * \brief Header file for the timing of the phases of the simulation steps
+ **/
+
+#include <yarp/os/Bottle.h>
+
+#include <string>
+#include <vector>
+#include <mutex>
+
+/**
+ *
+ * Times the phases of the steps of the ODE thread. The thread marks the
+ * start of a step, then the end of each phase with lap(); the durations of
+ * the last steps are kept for the percentiles, the sums since the last
+ * summary for the periodic report.
+ *
+ */
+class StepProfiler {
+public:
+    enum Phase {
+        COLLISION,      // dSpaceCollide, including the creation of the contact joints
+        WORLD_STEP,     // the ODE stepper
+        CONTROLLERS,    // jointStep() of the parts
+        SENSORS,        // inertial, touch and skin emulation
+        STREAMING,      // the ports written by the ODE thread
+        PHASES
+    };
+
+    /**
+     * @param window the number of steps kept for the percentiles
+     */
+    StepProfiler(int window = 1000);
+
+    /**
+     * Called by the ODE thread at the beginning of a step.
+     */
+    void start();
+
+    /**
+     * Called by the ODE thread at the end of a phase: the time since the
+     * previous mark goes to the phase.
+     */
+    void lap(Phase phase);
+
+    /**
+     * Called by the ODE thread at the end of a step.
+     * @param contacts the number of contact joints created in the step
+     */
+    void finish(int contacts);
+
+    /**
+     * The average duration of the phases since the previous summary.
+     */
+    std::string summary();
+
+    /**
+     * One list per phase, then the total and the contacts: (name mean p50
+     * p90 p99 max), in milliseconds, over the last steps.
+     */
+    void getStats(yarp::os::Bottle& stats);
+
+    void reset();
+
+private:
+    int window;
+    double mark;
+    double current[PHASES];
+
+    std::mutex mtx;
+    // the last durations of each phase, then of the steps, then the contacts
+    std::vector<float> samples[PHASES+2];
+    int next;
+    int count;
+    double sums[PHASES+1];
+    long steps;
+};
+
+#endif
@@ -21,11 +21,16 @@
 #include "iCub_Sim.h"
 
 #include "OdeInit.h"
+#include "SimClock.h"
+#include "StepProfiler.h"
 #include <yarp/os/LogStream.h>
 #include <mutex>
+#include <condition_variable>
 #include <cstdlib>
 #include <csignal>
 #include <set>
+#include <vector>
+#include <cstring>
 
 using namespace yarp::sig;
 
@@ -37,6 +42,10 @@ static double dstep = 10.0/1000.0;     // step size in ODE's dWorldStep in secon
 
 static bool glrun;  // draw gl
 static bool simrun; // run simulator thread
+static bool headless = false;       // no window, no rendering and no vision
+static SimClock *simClock = NULL;   // simulated time, when not paced by the wall clock
+static StepProfiler profiler;       // timing of the phases of the ODE steps
+static int nContacts = 0;           // contact joints created in the current step
 
 static int stop = 0;
 static int v = 0;
@@ -96,6 +105,79 @@ static double fov_right;
 static int cameraSizeWidth;
 static int cameraSizeHeight;
 
+// pixel buffer objects let glReadPixels() return before the transfer is
+// over, so that reading back a camera overlaps with rendering the next one
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#endif
+#ifndef GL_STREAM_READ
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_READ_ONLY
+#define GL_READ_ONLY 0x88B8
+#endif
+
+typedef void (APIENTRY *pboGenBuffers_t)(GLsizei n, GLuint *buffers);
+typedef void (APIENTRY *pboBindBuffer_t)(GLenum target, GLuint buffer);
+typedef void (APIENTRY *pboBufferData_t)(GLenum target, ptrdiff_t size, const GLvoid *data, GLenum usage);
+typedef GLvoid* (APIENTRY *pboMapBuffer_t)(GLenum target, GLenum access);
+typedef GLboolean (APIENTRY *pboUnmapBuffer_t)(GLenum target);
+
+static pboGenBuffers_t pboGenBuffers = NULL;
+static pboBindBuffer_t pboBindBuffer = NULL;
+static pboBufferData_t pboBufferData = NULL;
+static pboMapBuffer_t pboMapBuffer = NULL;
+static pboUnmapBuffer_t pboUnmapBuffer = NULL;
+
+static int pboState = 0;    // 0: not checked yet, 1: available, -1: not available
+static GLuint pboNames[Simulation::IMAGE_SLOTS];
+static int pboSize[Simulation::IMAGE_SLOTS];
+static int pboWidth[Simulation::IMAGE_SLOTS];
+static int pboHeight[Simulation::IMAGE_SLOTS];
+static bool pboPending[Simulation::IMAGE_SLOTS];
+
+// a framebuffer object lets the cameras be rendered off the window, so that
+// their images are not spoiled by the windows over it
+#ifndef GL_FRAMEBUFFER_EXT
+#define GL_FRAMEBUFFER_EXT 0x8D40
+#endif
+#ifndef GL_RENDERBUFFER_EXT
+#define GL_RENDERBUFFER_EXT 0x8D41
+#endif
+#ifndef GL_COLOR_ATTACHMENT0_EXT
+#define GL_COLOR_ATTACHMENT0_EXT 0x8CE0
+#endif
+#ifndef GL_DEPTH_ATTACHMENT_EXT
+#define GL_DEPTH_ATTACHMENT_EXT 0x8D00
+#endif
+#ifndef GL_FRAMEBUFFER_COMPLETE_EXT
+#define GL_FRAMEBUFFER_COMPLETE_EXT 0x8CD5
+#endif
+#ifndef GL_DEPTH_COMPONENT24
+#define GL_DEPTH_COMPONENT24 0x81A6
+#endif
+
+typedef void (APIENTRY *fboGenFramebuffers_t)(GLsizei n, GLuint *framebuffers);
+typedef void (APIENTRY *fboBindFramebuffer_t)(GLenum target, GLuint framebuffer);
+typedef void (APIENTRY *fboGenRenderbuffers_t)(GLsizei n, GLuint *renderbuffers);
+typedef void (APIENTRY *fboBindRenderbuffer_t)(GLenum target, GLuint renderbuffer);
+typedef void (APIENTRY *fboRenderbufferStorage_t)(GLenum target, GLenum internalformat, GLsizei width, GLsizei height);
+typedef void (APIENTRY *fboFramebufferRenderbuffer_t)(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer);
+typedef GLenum (APIENTRY *fboCheckFramebufferStatus_t)(GLenum target);
+
+static fboGenFramebuffers_t fboGenFramebuffers = NULL;
+static fboBindFramebuffer_t fboBindFramebuffer = NULL;
+static fboGenRenderbuffers_t fboGenRenderbuffers = NULL;
+static fboBindRenderbuffer_t fboBindRenderbuffer = NULL;
+static fboRenderbufferStorage_t fboRenderbufferStorage = NULL;
+static fboFramebufferRenderbuffer_t fboFramebufferRenderbuffer = NULL;
+static fboCheckFramebufferStatus_t fboCheckFramebufferStatus = NULL;
+
+static int fboState = 0;    // 0: not checked yet, 1: available, -1: not available
+static GLuint fboName;
+static GLuint fboBuffers[2];    // color and depth
+static bool initFbo();
+
 struct contactICubSkinEmul_t{
     bool coverTouched;
     bool indivTaxelResolution; 
@@ -103,6 +185,31 @@ struct contactICubSkinEmul_t{
 };
     
 static std::map<SkinPart,contactICubSkinEmul_t> contactICubSkinEmulMap;
+
+// what getSkinAndBodyPartFromSpaceAndGeomID() tells about a geom, which does not change during the simulation
+struct skinGeom_t{
+    SkinPart skinPart;
+    BodyPart bodyPart;
+    HandPart handPart;
+    bool skinCoverFlag;
+    bool fingertipFlag;
+};
+
+// filled the first time each geom of the robot is in contact
+static std::map<dGeomID,skinGeom_t> skinGeomMap;
+
+// the skin reports are built and sent by a thread of their own, the physics only leaves
+// the contacts and the touched taxels of the last step here
+static SDL_Thread *skin_thread = NULL;
+static std::mutex skinReportMtx;
+static std::condition_variable skinReportCond;
+static bool skinReportPending = false;
+static bool skinReportStop = false;
+static skinContactList skinReportContacts;
+static std::map<SkinPart,contactICubSkinEmul_t> skinReportParts;
+
+static void postSkinReport(skinContactList& contacts);
+static void sendSkinReport(skinContactList& contacts, std::map<SkinPart,contactICubSkinEmul_t>& parts);
     
 /* For every collision detected by ODE, contact joints (up to MAX_CONTACTS per collison) are created and a feedback structs may be associated with them - that will carry information about the contact.
  * The number of collisions and contact joints may vary, but we allocate these as a static array for performance issues.
@@ -145,6 +252,12 @@ void OdeSdlSimulation::printStats() {
     //yDebug("test[0] %f  test[1] %f  test[2] %f\n",test[0],test[1],test[2]);
     if( duration - starting_time_stamp >= 1){
         //yDebug("Frames: %.2lf   Duration: %.2lf   fps: %3.1f \n",frames,duration,FPS);
+        if (odeinit.verbosity > 0) {
+            yDebug("fps: %3.1f   %s: %.2f ms per step (%.0f%% of the timestep)\n", FPS,
+                   odeinit.quickStep ? "quickstep" : "step", odeinit.stepDuration*1e3,
+                   100.0*odeinit.stepDuration/dstep);
+            yDebug("%s\n", profiler.summary().c_str());
+        }
         starting_time_stamp = duration;
     }
     //yDebug("%lf %lf %lf %lf %lf %lf\n", odeinit._iCub->ra_speed[0],odeinit._iCub->ra_speed[1],odeinit._iCub->ra_speed[2],odeinit._iCub->ra_speed[3],odeinit._iCub->ra_speed[4],odeinit._iCub->ra_speed[5]);
@@ -347,16 +460,20 @@ void OdeSdlSimulation::nearCallback (void *data, dGeomID o1, dGeomID o2) {
     string indentString("");
     std::map<dGeomID,string>::iterator geom1namesIt;
     std::map<dGeomID,string>::iterator geom2namesIt;
+    //this is called for every candidate pair at every step: the names are only looked up for the printouts
+    bool debug = (odeinit.verbosity > 2);
     
     if (dGeomIsSpace(o1)){
        space1 = (dSpaceID)o1;
     } else {
        space1 = dGeomGetSpace(o1);
-       indentString = indentString + " --- "; //extra indentation level because it is a geom in that space
+       if (debug) indentString = indentString + " --- "; //extra indentation level because it is a geom in that space
     }
-    subLevel1 = dSpaceGetSublevel(space1);
-    for (int i=1;i<=subLevel1;i++){ //start from i=1, for sublevel==0 we don't add any indentation
-      indentString = indentString + " --- ";
+    if (debug) {
+        subLevel1 = dSpaceGetSublevel(space1);
+        for (int i=1;i<=subLevel1;i++){ //start from i=1, for sublevel==0 we don't add any indentation
+          indentString = indentString + " --- ";
+        }
     }
      
     if (odeinit.verbosity > 3) yDebug("%s nearCallback()\n",indentString.c_str());
@@ -367,6 +484,9 @@ void OdeSdlSimulation::nearCallback (void *data, dGeomID o1, dGeomID o2) {
           yDebug("%s Object nr. 1: %s, sublevel: %d, contained within: %s, nr. geoms: %d. \n",indentString.c_str(),odeinit._iCub->dSpaceNames[space1].c_str(),dSpaceGetSublevel(space1),odeinit._iCub->dSpaceNames[dGeomGetSpace(o1)].c_str(),dSpaceGetNumGeoms(space1));
         }
     }
+    else if (!debug){
+        superSpace1 = dGeomGetSpace(o1);
+    }
     else{ //it's a geom
         getGeomClassName(dGeomGetClass(o1),geom1className);
         superSpace1 = dGeomGetSpace(o1);
@@ -385,6 +505,8 @@ void OdeSdlSimulation::nearCallback (void *data, dGeomID o1, dGeomID o2) {
         if (odeinit.verbosity > 3){
                yDebug("%s Object nr. 2: %s, sublevel: %d, contained within: %s, nr. geoms: %d. \n",indentString.c_str(),odeinit._iCub->dSpaceNames[space2].c_str(),dSpaceGetSublevel(space2),odeinit._iCub->dSpaceNames[dGeomGetSpace(o2)].c_str(),dSpaceGetNumGeoms(space2));
         }
+    } else if (!debug) {
+        superSpace2 = dGeomGetSpace(o2);
     } else {
         getGeomClassName(dGeomGetClass(o2),geom2ClassName);
         superSpace2 = dGeomGetSpace(o2);
@@ -433,14 +555,8 @@ void OdeSdlSimulation::nearCallback (void *data, dGeomID o1, dGeomID o2) {
       if (odeinit.verbosity > 3) yDebug("%s Collision ignored: the bodies of o1 and o2 are connected by a joint.\n",indentString.c_str());
       return;
     }
-    // list of self-collisions to ignore
-    if (selfCollisionOnIgnoreList(geom1name,geom2name)){
-       if (odeinit.verbosity > 3){
-           yDebug("%s geom: %s (class: %s, contained within %s) AND geom: %s (class: %s, contained within %s).\n",indentString.c_str(),geom1name.c_str(),geom1className.c_str(),odeinit._iCub->dSpaceNames[superSpace1].c_str(),geom2name.c_str(),geom2ClassName.c_str(),odeinit._iCub->dSpaceNames[superSpace2].c_str());
-           yDebug("%s Collision ignored (ignore list).\n",indentString.c_str());
-       }
-       return;
-    }
+    // the self-collisions on the ignore list never get here, they are filtered out
+    // by the spaces through the category and collide bits (see initSelfCollisionFilter())
        
     if (odeinit.verbosity > 3) yDebug("%s Collision candidate. Preparing contact joints.\n",indentString.c_str());
     dContact contact[MAX_CONTACTS];   // up to MAX_CONTACTS contacts per box-box
@@ -469,6 +585,7 @@ void OdeSdlSimulation::nearCallback (void *data, dGeomID o1, dGeomID o2) {
         for (i=0; i<numc; i++) {
             if (odeinit.verbosity > 4) yDebug("%s	Contact joint nr. %d (index:%d): at (%f,%f,%f), depth: %f \n",indentString.c_str(),i+1,i,contact[i].geom.pos[0],contact[i].geom.pos[1],contact[i].geom.pos[2],contact[i].geom.depth);
             dJointID c = dJointCreateContact (odeinit.world,odeinit.contactgroup,contact+i);
+            nContacts++;
             dJointAttach (c,b1,b2);
             // if (show_contacts) dsDrawBox (contact[i].geom.pos,RI,ss);
             // check if the bodies are touch sensitive.
@@ -545,64 +662,55 @@ void OdeSdlSimulation::nearCallback (void *data, dGeomID o1, dGeomID o2) {
 }
 
 
-bool OdeSdlSimulation::selfCollisionOnIgnoreList(string geom1_string, string geom2_string)
+// pairs of geoms, by name, whose self-collisions are ignored
+static const char *selfCollisionIgnoreList[][2] = {
+    /** left arm vs. torso ********/
+    { "upper left arm cover", "torsoGeom[4]" },
+    { "upper left arm cover", "torso cover" },
+    { "geom[2]", "torso cover" },       //geom[2] is the cylinder in at shoulder joint (when it is "on" - part activated, it may collide ; when off (different geom name), it will not go into the torso, so no need to handle this)
+    { "geom[4]", "torso cover" },       //geom[4] is the cylinder in upper left arm (similarly, no need to test for the version with part off (ICubSim::initLeftArmOff))
+    { "geom[4]", "torsoGeom[5]" },      //upper arm cylinder colliding with torso box
+    /** right arm vs. torso ********/
+    { "upper right arm cover", "torsoGeom[5]" },
+    { "upper right arm cover", "torso cover" },
+    { "geom[3]", "torso cover" },       //geom[3] is the cylinder in at shoulder joint
+    { "geom[5]", "torso cover" },       //geom[5] is the cylinder in upper right arm
+    { "geom[5]", "torsoGeom[5]" }       //upper arm cylinder colliding with torso box
+};
+
+void OdeSdlSimulation::initSelfCollisionFilter()
 {
-  /** left arm vs. torso ********/  
- if ( ( (geom1_string.compare("upper left arm cover")==0)  &&  (geom2_string.compare("torsoGeom[4]")==0) )  || ( (geom2_string.compare("upper left arm cover")==0)  &&  (geom1_string.compare("torsoGeom[4]")==0) ) ){
-      return true; 
-  }
-  if ( ( (geom1_string.compare("upper left arm cover")==0)  &&  (geom2_string.compare("torso cover")==0) )  || ( (geom2_string.compare("upper left arm cover")==0)  &&  (geom1_string.compare("torso cover")==0) ) ){
-      return true; 
-  }
-  if ( ( (geom1_string.compare("geom[2]")==0)  &&  (geom2_string.compare("torso cover")==0) )  || ( (geom2_string.compare("geom[2]")==0)  &&  (geom1_string.compare("torso cover")==0) ) ){
-      return true; 
-  } //geom[2] is the cylinder in at shoulder joint (when it is "on" - part activated, it may collide ; when off (different geom name), it will not go into the torso, so no need to handle this)
-  
-  if ( ( (geom1_string.compare("geom[4]")==0)  &&  (geom2_string.compare("torso cover")==0) )  || ( (geom2_string.compare("geom[4]")==0)  &&  (geom1_string.compare("torso cover")==0) ) ){
-      return true; 
-  } //geom[4] is the cylinder in upper left arm (similarly, no need to test for the version with part off (ICubSim::initLeftArmOff))
-  if ( ( (geom1_string.compare("geom[4]")==0)  &&  (geom2_string.compare("torsoGeom[5]")==0) )  || ( (geom2_string.compare("geom[4]")==0)  &&  (geom1_string.compare("torsoGeom[5]")==0) ) ){
-      return true; 
-  } //upper arm cylinder colliding with torso box
-    
-  /** right arm vs. torso ********/
-  if ( ( (geom1_string.compare("upper right arm cover")==0)  &&  (geom2_string.compare("torsoGeom[5]")==0) )  || ( (geom2_string.compare("upper right arm cover")==0)  &&  (geom1_string.compare("torsoGeom[5]")==0) ) ){
-      return true; 
-  }
-  if ( ( (geom1_string.compare("upper right arm cover")==0)  &&  (geom2_string.compare("torso cover")==0) )  || ( (geom2_string.compare("upper right arm cover")==0)  &&  (geom1_string.compare("torso cover")==0) ) ){
-      return true; 
-  }
-  if ( ( (geom1_string.compare("geom[3]")==0)  &&  (geom2_string.compare("torso cover")==0) )  || ( (geom2_string.compare("geom[3]")==0)  &&  (geom1_string.compare("torso cover")==0) ) ){
-      return true; 
-  } //geom[3] is the cylinder in at shoulder joint (when it is "on" - part activated, it may collide ; when off (different geom name), it will not go into the torso, so no need to handle this)
-  if ( ( (geom1_string.compare("geom[5]")==0)  &&  (geom2_string.compare("torso cover")==0) )  || ( (geom2_string.compare("geom[5]")==0)  &&  (geom1_string.compare("torso cover")==0) ) ){
-      return true; 
-  } //geom[5] is the cylinder in upper right arm (similarly, no need to test for the version with part off (ICubSim::initRightArmOff))
-  if ( ( (geom1_string.compare("geom[5]")==0)  &&  (geom2_string.compare("torsoGeom[5]")==0) )  || ( (geom2_string.compare("geom[5]")==0)  &&  (geom1_string.compare("torsoGeom[5]")==0) ) ){
-      return true; 
-  } //upper arm cylinder colliding with torso box
-  
-   /** left arm vs. torso ********/  
- if ( ( (geom1_string.compare("upper left arm cover")==0)  &&  (geom2_string.compare("torsoGeom[4]")==0) )  || ( (geom2_string.compare("upper left arm cover")==0)  &&  (geom1_string.compare("torsoGeom[4]")==0) ) ){
-      return true; 
-  }
-  if ( ( (geom1_string.compare("upper left arm cover")==0)  &&  (geom2_string.compare("torso cover")==0) )  || ( (geom2_string.compare("upper left arm cover")==0)  &&  (geom1_string.compare("torso cover")==0) ) ){
-      return true; 
-  }
-  if ( ( (geom1_string.compare("geom[2]")==0)  &&  (geom2_string.compare("torso cover")==0) )  || ( (geom2_string.compare("geom[2]")==0)  &&  (geom1_string.compare("torso cover")==0) ) ){
-      return true; 
-  } //geom[2] is the cylinder in at shoulder joint (when it is "on" - part activated, it may collide ; when off (different geom name), it will not go into the torso, so no need to handle this)
-  
-  if ( ( (geom1_string.compare("geom[4]")==0)  &&  (geom2_string.compare("torso cover")==0) )  || ( (geom2_string.compare("geom[4]")==0)  &&  (geom1_string.compare("torso cover")==0) ) ){
-      return true; 
-  } //geom[4] is the cylinder in upper left arm (similarly, no need to test for the version with part off (ICubSim::initLeftArmOff))
-  if ( ( (geom1_string.compare("geom[4]")==0)  &&  (geom2_string.compare("torsoGeom[5]")==0) )  || ( (geom2_string.compare("geom[4]")==0)  &&  (geom1_string.compare("torsoGeom[5]")==0) ) ){
-      return true; 
-  } //upper arm cylinder colliding with torso box
+    OdeInit& odeinit = OdeInit::get();
+    const int n = sizeof(selfCollisionIgnoreList)/sizeof(selfCollisionIgnoreList[0]);
+
+    // every name in the list gets a category bit of its own, and its collide bits
+    // lack the bits of the names it is paired with; ODE tests two geoms only if
+    // (category1 & collide2) || (category2 & collide1), while all the other geoms
+    // keep the default of all bits set, and collide with everything
+    std::map<string,unsigned long> category;
+    std::map<string,unsigned long> ignored;
+    for (int i=0; i<n; i++) {
+        for (int j=0; j<2; j++) {
+            string name = selfCollisionIgnoreList[i][j];
+            if (category.find(name) == category.end()) {
+                unsigned long bit = 1UL << category.size();
+                category[name] = bit;
+            }
+        }
+    }
+    for (int i=0; i<n; i++) {
+        ignored[selfCollisionIgnoreList[i][0]] |= category[selfCollisionIgnoreList[i][1]];
+        ignored[selfCollisionIgnoreList[i][1]] |= category[selfCollisionIgnoreList[i][0]];
+    }
 
-  
-  return false;  
-} 
+    for (std::map<dGeomID,string>::iterator it = odeinit._iCub->dGeomNames.begin(); it != odeinit._iCub->dGeomNames.end(); ++it) {
+        std::map<string,unsigned long>::iterator c = category.find(it->second);
+        if (c != category.end()) {
+            dGeomSetCategoryBits(it->first, c->second);
+            dGeomSetCollideBits(it->first, ~ignored[it->second]);
+        }
+    }
+}
  
 // returns true if the body with the bodyID is a touch-sensitive body, returns false otherwise.
 bool OdeSdlSimulation::isBodyTouchSensitive (dBodyID bodyID) {
@@ -1015,6 +1123,17 @@ int OdeSdlSimulation::thread_ode(void *unused) {
     bool realTime = true;
     long temp;
 
+    if (simClock != NULL) {
+        // fast or lockstep mode: the steps follow each other (or the grants
+        // of the clients) with no pacing, and the simulated time advances
+        // of dstep per step whatever the wall clock says
+        while (simrun && simClock->waitStep()) {
+            ODE_process(1, (void*)1);
+            simClock->advance(dstep);
+        }
+        return(0);
+    }
+
     while (simrun) {
         temp = (long) (clock()*cpms);
         timeCache += temp - lastTimeCacheUpdate;
@@ -1043,7 +1162,7 @@ int OdeSdlSimulation::thread_ode(void *unused) {
             // check if the desired timestep is achieved, if not, print a warning msg
             if(count % (10000/ode_step_length)==0){
                 if(avg_ode_step_length >= ode_step_length+1)
-                    yWarning("the simulation is too slow to run in real-time, you should increase the timestep in ode_params.ini (current value: %ld, suggested value: %.0f)\n", 
+                    yWarning("the simulation is too slow to run in real-time, you should increase the timestep (current value: %ld, suggested value: %.0f) or use the quickstep stepper in ode_params.ini\n", 
                         ode_step_length, avg_ode_step_length);
                 else if(avg_ode_step_length <= ode_step_length-1)
                     yWarning("you could get a more accurate dynamics simulation by decreasing the timestep in ode_params.ini (current value: %ld, suggested value: %.0f)\n", 
@@ -1060,7 +1179,9 @@ Uint32 OdeSdlSimulation::ODE_process(Uint32 interval, void *param) {
     //startTimeODE = clock();
 
     odeinit.mtx.lock();
+    profiler.start();
     nFeedbackStructs=0;
+    nContacts=0;
     
     if (odeinit.verbosity > 3) yDebug("\n ***info code collision detection ***"); 
     if (odeinit.verbosity > 3) yDebug("OdeSdlSimulation::ODE_process: dSpaceCollide(odeinit.space,0,&nearCallback): will test iCub space against the rest of the world (e.g. ground).\n");
@@ -1074,14 +1195,17 @@ Uint32 OdeSdlSimulation::ODE_process(Uint32 interval, void *param) {
         }
     }
     if (odeinit.verbosity > 3) yDebug("***END OF info code collision detection\n ***"); 
+    profiler.lap(StepProfiler::COLLISION);
     
-    dWorldStep(odeinit.world, dstep);
+    odeinit.worldStep(dstep);
+    profiler.lap(StepProfiler::WORLD_STEP);
     // do 1 TIMESTEP in controllers (ok to run at same rate as ODE: 1 iteration takes about 300 times less computation time than dWorldStep)
     for (int ipart = 0; ipart<MAX_PART; ipart++) {
         if (odeinit._controls[ipart] != NULL) {
             odeinit._controls[ipart]->jointStep();
         }
     }
+    profiler.lap(StepProfiler::CONTROLLERS);
 
     // UPDATE INERTIAL
 
@@ -1121,41 +1245,10 @@ Uint32 OdeSdlSimulation::ODE_process(Uint32 interval, void *param) {
                     if (odeinit.verbosity > 2) yDebug("OdeSdlSimulation::ODE_process():There were %lu iCub collisions to process.", odeinit.listOfSkinContactInfos.size());
                     inspectWholeBodyContactsAndSendTouch(); 
                }
-               else{ //someone is reading but no contacts, we send empty lists
-                   if(robot_streamer->shouldSendSkinEvents()){
-                        skinContactList emptySkinContactList;
-                        emptySkinContactList.clear();
-                        robot_streamer->sendSkinEvents(emptySkinContactList); 
-                   }
-                   if(robot_streamer->shouldSendTouchLeftHand()){
-                         Bottle bottleLeftHand = Bottle(odeinit._iCub->emptySkinActivationHand);    
-                         robot_streamer->sendTouchLeftHand(bottleLeftHand);
-                   }
-                   if(robot_streamer->shouldSendTouchRightHand()){
-                         Bottle bottleRightHand = Bottle(odeinit._iCub->emptySkinActivationHand);  
-                         robot_streamer->sendTouchRightHand(bottleRightHand);
-                   }
-                   if(robot_streamer->shouldSendTouchLeftArm()){
-                         Bottle bottleLeftArm = Bottle(odeinit._iCub->emptySkinActivationUpperArm); 
-                         robot_streamer->sendTouchLeftArm(bottleLeftArm);
-                   }
-                   if(robot_streamer->shouldSendTouchLeftForearm()){
-                         Bottle bottleLeftForearm = Bottle(odeinit._iCub->emptySkinActivationForearm);    
-                         robot_streamer->sendTouchLeftForearm(bottleLeftForearm);
-                   }
-                   if(robot_streamer->shouldSendTouchRightArm()){
-                         Bottle bottleRightArm = Bottle(odeinit._iCub->emptySkinActivationUpperArm);
-                         robot_streamer->sendTouchRightArm(bottleRightArm);
-                   }
-                   if(robot_streamer->shouldSendTouchRightForearm()){
-                         Bottle bottleRightForearm = Bottle(odeinit._iCub->emptySkinActivationForearm);
-                         robot_streamer->sendTouchRightForearm(bottleRightForearm);
-                   }
-                   if(robot_streamer->shouldSendTouchTorso()){
-                        Bottle bottleTorso = Bottle(odeinit._iCub->emptySkinActivationTorso);
-                        robot_streamer->sendTouchTorso(bottleTorso);
-                   }
-              }
+               else{ //someone is reading but no contacts, we send empty lists: no part is touched
+                   skinContactList emptySkinContactList;
+                   postSkinReport(emptySkinContactList);
+               }
         }
         odeinit.listOfSkinContactInfos.clear();
         if(odeinit.verbosity > 4){
@@ -1170,6 +1263,7 @@ Uint32 OdeSdlSimulation::ODE_process(Uint32 interval, void *param) {
     }
     
     dJointGroupEmpty (odeinit.contactgroup);
+    profiler.lap(StepProfiler::SENSORS);
 
     if (robot_streamer->shouldSendInertial()) {
         Bottle inertialReport;
@@ -1181,6 +1275,8 @@ Uint32 OdeSdlSimulation::ODE_process(Uint32 interval, void *param) {
     robot_streamer->checkTorques();
 
     odeinit._iCub->setJointControlAction();
+    profiler.lap(StepProfiler::STREAMING);
+    profiler.finish(nContacts);
     
     //finishTimeODE = clock() ;
     //SPS();
@@ -1223,6 +1319,9 @@ Uint32 OdeSdlSimulation::ODE_process(Uint32 interval, void *param) {
 void OdeSdlSimulation::sighandler(int sig) {
     OdeInit& odeinit = OdeInit::get();
     odeinit.stop = true;
+    if (simClock != NULL) {
+        simClock->interrupt();
+    }
     yInfo() << "\nCAUGHT Ctrl-c";
 }
 
@@ -1230,16 +1329,28 @@ void OdeSdlSimulation::simLoop(int h,int w) {
     yDebug("***** OdeSdlSimulation::simLoop \n");
     OdeInit& odeinit = OdeInit::get();
 
-    SDL_Init(SDL_INIT_TIMER | SDL_GL_ACCELERATED_VISUAL);
-    SDL_SetVideoMode(h,w,32,SDL_OPENGL | SDL_RESIZABLE);// | SDL_SWSURFACE| SDL_ANYFORMAT); // on init 
+    if (headless) {
+        SDL_Init(SDL_INIT_TIMER);
+        dAllocateODEDataForThread(dAllocateMaskAll);
+    } else {
+        SDL_Init(SDL_INIT_TIMER | SDL_GL_ACCELERATED_VISUAL);
+        SDL_SetVideoMode(h,w,32,SDL_OPENGL | SDL_RESIZABLE);// | SDL_SWSURFACE| SDL_ANYFORMAT); // on init 
+
+        dAllocateODEDataForThread(dAllocateMaskAll);
+        string logo = robot_config->getFinder().findFile("logo");
 
-    dAllocateODEDataForThread(dAllocateMaskAll);
-    string logo = robot_config->getFinder().findFile("logo");
+        image = SDL_LoadBMP(robot_config->getFinder().findFile(logo.c_str()).c_str());
+        SDL_WM_SetIcon(image,0);
+        SDL_FreeSurface(image);
+        SDL_WM_SetCaption("iCub Simulator", "image");
+    }
 
-    image = SDL_LoadBMP(robot_config->getFinder().findFile(logo.c_str()).c_str());
-    SDL_WM_SetIcon(image,0);
-    SDL_FreeSurface(image);
-    SDL_WM_SetCaption("iCub Simulator", "image");
+    initSelfCollisionFilter();
+
+    if (odeinit._iCub->actSkinEmul == "on") {
+        skinReportStop = false;
+        skin_thread = SDL_CreateThread(thread_skin, NULL);
+    }
 
     //SDL_Thread *thread;
     SDL_Thread *ode_thread = SDL_CreateThread(thread_ode, NULL);
@@ -1249,10 +1360,16 @@ void OdeSdlSimulation::simLoop(int h,int w) {
         yError("Unable to create thread: %s\n", SDL_GetError());
         return;
     }
+    if (simClock != NULL) {
+        // only now, the simulated time does not advance before the ODE thread runs
+        Time::useCustomClock(simClock);
+    }
 
     initViewpoint();
-    bool ok = setup_opengl(robot_config->getFinder());
-    if (!ok) return;
+    if (!headless) {
+        bool ok = setup_opengl(robot_config->getFinder());
+        if (!ok) return;
+    }
     startTime = (long) clock();
     odeinit.stop = false;
 
@@ -1270,8 +1387,13 @@ void OdeSdlSimulation::simLoop(int h,int w) {
     }
     if (odeinit._iCub->actSelfCol == "on") {
        if (odeinit._iCub->actStartHomePos == "on"){
-           Time::delay(2.0); //we want to set this trigger on only after the robot is in home pos -
-            //it's initial configuration is with arms inside the thighs - generating many self-collisions
+           //we want to set this trigger on only after the robot is in home pos -
+           //it's initial configuration is with arms inside the thighs - generating many self-collisions;
+           //the wait is on yarp's clock, i.e. on the simulated time in fast and lockstep mode
+           double homeTime = Time::now();
+           while (!odeinit.stop && Time::now()-homeTime < 2.0) {
+               SDL_Delay(10);
+           }
            START_SELF_COLLISION_DETECTION = true;
        }
        else{
@@ -1280,6 +1402,16 @@ void OdeSdlSimulation::simLoop(int h,int w) {
        }
     }
     
+    while(!odeinit.stop && headless) {
+        // nothing to draw: the objects only need their textures when rendered
+        if (odeinit._wrld->WAITLOADING) {
+            odeinit._wrld->WAITLOADING = false;
+            odeinit._wrld->static_model = false;
+        }
+        printStats();
+        SDL_Delay(100);
+    }
+
     while(!odeinit.stop) {
         /* Process incoming events. */
         process_events();
@@ -1289,6 +1421,7 @@ void OdeSdlSimulation::simLoop(int h,int w) {
                 odeinit.mtxTexture.lock();
                 draw_screen();  
                 odeinit.mtxTexture.unlock();
+                printStats();
                 // check for framerate
                 timeLeft = (prevTime - (long) clock()) + gl_frame_length;
                 //yDebug() << "check for framerate " << timeLeft;
@@ -1320,8 +1453,23 @@ void OdeSdlSimulation::simLoop(int h,int w) {
     //Stop the thread
     //SDL_KillThread( thread );
     simrun = false;
+    if (simClock != NULL) {
+        // wakes up the ODE thread if it waits for a grant; the clock object
+        // is kept until the destruction, other threads may still call it
+        simClock->close();
+        Time::useSystemClock();
+    }
     //SDL_WaitThread( thread, NULL );
     SDL_WaitThread( ode_thread, NULL );
+    if (skin_thread != NULL) {
+        {
+            std::lock_guard<std::mutex> lock(skinReportMtx);
+            skinReportStop = true;
+            skinReportCond.notify_one();
+        }
+        SDL_WaitThread( skin_thread, NULL );
+        skin_thread = NULL;
+    }
     //SDL_Quit();
 }
 
@@ -1329,6 +1477,11 @@ void OdeSdlSimulation::drawView(bool left, bool right, bool wide) {
     OdeInit& odeinit = OdeInit::get();
     const dReal *pos;
     const dReal *rot;
+    // until clearBuffer()
+    if (initFbo()) {
+        fboBindFramebuffer(GL_FRAMEBUFFER_EXT,fboName);
+        glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT);
+    }
     glViewport(0,0,cameraSizeWidth,cameraSizeHeight);
     glMatrixMode (GL_PROJECTION);
     
@@ -1395,6 +1548,9 @@ void OdeSdlSimulation::drawView(bool left, bool right, bool wide) {
 
 void OdeSdlSimulation::clearBuffer() {
     glClear(GL_COLOR_BUFFER_BIT|GL_DEPTH_BUFFER_BIT); // refresh opengl
+    if (fboState>0) {
+        fboBindFramebuffer(GL_FRAMEBUFFER_EXT,0);
+    }
 }
 
 OdeSdlSimulation::OdeSdlSimulation() {
@@ -1415,6 +1571,26 @@ void OdeSdlSimulation::init(RobotStreamer *streamer,
 
     video = new VideoTexture;
     string moduleName = odeinit.getName();
+
+    // batch runs: with --fast the steps are not paced by the wall clock, with
+    // --lockstep they are granted by the clients; in both cases the devices
+    // use the simulated time
+    headless = robot_config->getFinder().check("headless");
+    bool lockstep = robot_config->getFinder().check("lockstep");
+    if (lockstep || robot_config->getFinder().check("fast")) {
+        simClock = new SimClock;
+        if (simClock->open(moduleName, lockstep)) {
+            yInfo("Running %s, the simulated time is streamed on %s/clock\n",
+                  lockstep ? "in lockstep" : "faster than real-time", moduleName.c_str());
+        } else {
+            yError("Unable to open the ports of the simulated clock, running in real-time\n");
+            delete simClock;
+            simClock = NULL;
+        }
+    }
+    if (headless) {
+        yInfo("Running headless: nothing is rendered and the cameras are not streamed\n");
+    }
     video->setName( moduleName ); 
     odeinit._iCub->eyeLidsPortName = moduleName;
     Property options;
@@ -1610,6 +1786,8 @@ void OdeSdlSimulation::printContactICubSkinEmulMap(void)
 
 OdeSdlSimulation::~OdeSdlSimulation() {
     delete video;
+    delete simClock;
+    simClock = NULL;
 }
 
 
@@ -1622,6 +1800,15 @@ bool OdeSdlSimulation::checkSync(bool reset) {
 }
 
 
+bool OdeSdlSimulation::getStats(Bottle& stats, bool reset) {
+    if (reset) {
+        profiler.reset();
+    } else {
+        profiler.getStats(stats);
+    }
+    return true;
+}
+
 bool OdeSdlSimulation::getTrqData(Bottle data) {
     OdeInit& odeinit = OdeInit::get();
     for (int s=0; s<data.size(); s++){
@@ -1633,31 +1820,136 @@ bool OdeSdlSimulation::getTrqData(Bottle data) {
 
 
 
+// OpenGL starts from the bottom row
+static void flipImage(const unsigned char *src, int w, int h, ImageOf<PixelRgb>& target) {
+    target.resize(w,h);
+    const size_t rowSize = 3*(size_t)w;
+    for (int y=0; y<h; y++) {
+        memcpy(target.getRow(y), src+(h-1-y)*rowSize, rowSize);
+    }
+}
+
+static bool initPbo() {
+    if (pboState==0) {
+        pboGenBuffers = (pboGenBuffers_t)SDL_GL_GetProcAddress("glGenBuffersARB");
+        pboBindBuffer = (pboBindBuffer_t)SDL_GL_GetProcAddress("glBindBufferARB");
+        pboBufferData = (pboBufferData_t)SDL_GL_GetProcAddress("glBufferDataARB");
+        pboMapBuffer = (pboMapBuffer_t)SDL_GL_GetProcAddress("glMapBufferARB");
+        pboUnmapBuffer = (pboUnmapBuffer_t)SDL_GL_GetProcAddress("glUnmapBufferARB");
+
+        const char *ext = (const char*)glGetString(GL_EXTENSIONS);
+        bool supported = (ext!=NULL) && (strstr(ext,"GL_ARB_pixel_buffer_object")!=NULL);
+        if (supported && pboGenBuffers && pboBindBuffer && pboBufferData && pboMapBuffer && pboUnmapBuffer) {
+            pboGenBuffers(Simulation::IMAGE_SLOTS,pboNames);
+            for (int i=0; i<Simulation::IMAGE_SLOTS; i++) {
+                pboSize[i] = 0;
+                pboPending[i] = false;
+            }
+            pboState = 1;
+        } else {
+            yInfo("pixel buffer objects not available, cameras are read back synchronously");
+            pboState = -1;
+        }
+    }
+    return (pboState>0);
+}
+
+static bool initFbo() {
+    if (fboState==0) {
+        fboGenFramebuffers = (fboGenFramebuffers_t)SDL_GL_GetProcAddress("glGenFramebuffersEXT");
+        fboBindFramebuffer = (fboBindFramebuffer_t)SDL_GL_GetProcAddress("glBindFramebufferEXT");
+        fboGenRenderbuffers = (fboGenRenderbuffers_t)SDL_GL_GetProcAddress("glGenRenderbuffersEXT");
+        fboBindRenderbuffer = (fboBindRenderbuffer_t)SDL_GL_GetProcAddress("glBindRenderbufferEXT");
+        fboRenderbufferStorage = (fboRenderbufferStorage_t)SDL_GL_GetProcAddress("glRenderbufferStorageEXT");
+        fboFramebufferRenderbuffer = (fboFramebufferRenderbuffer_t)SDL_GL_GetProcAddress("glFramebufferRenderbufferEXT");
+        fboCheckFramebufferStatus = (fboCheckFramebufferStatus_t)SDL_GL_GetProcAddress("glCheckFramebufferStatusEXT");
+
+        const char *ext = (const char*)glGetString(GL_EXTENSIONS);
+        bool supported = (ext!=NULL) && (strstr(ext,"GL_EXT_framebuffer_object")!=NULL);
+        fboState = -1;
+        if (supported && fboGenFramebuffers && fboBindFramebuffer && fboGenRenderbuffers && fboBindRenderbuffer &&
+            fboRenderbufferStorage && fboFramebufferRenderbuffer && fboCheckFramebufferStatus) {
+            // all the cameras have the size of the left one
+            fboGenFramebuffers(1,&fboName);
+            fboGenRenderbuffers(2,fboBuffers);
+            fboBindFramebuffer(GL_FRAMEBUFFER_EXT,fboName);
+            fboBindRenderbuffer(GL_RENDERBUFFER_EXT,fboBuffers[0]);
+            fboRenderbufferStorage(GL_RENDERBUFFER_EXT,GL_RGB8,cameraSizeWidth,cameraSizeHeight);
+            fboFramebufferRenderbuffer(GL_FRAMEBUFFER_EXT,GL_COLOR_ATTACHMENT0_EXT,GL_RENDERBUFFER_EXT,fboBuffers[0]);
+            fboBindRenderbuffer(GL_RENDERBUFFER_EXT,fboBuffers[1]);
+            fboRenderbufferStorage(GL_RENDERBUFFER_EXT,GL_DEPTH_COMPONENT24,cameraSizeWidth,cameraSizeHeight);
+            fboFramebufferRenderbuffer(GL_FRAMEBUFFER_EXT,GL_DEPTH_ATTACHMENT_EXT,GL_RENDERBUFFER_EXT,fboBuffers[1]);
+            fboBindRenderbuffer(GL_RENDERBUFFER_EXT,0);
+            if (fboCheckFramebufferStatus(GL_FRAMEBUFFER_EXT)==GL_FRAMEBUFFER_COMPLETE_EXT) {
+                fboState = 1;
+            }
+            fboBindFramebuffer(GL_FRAMEBUFFER_EXT,0);
+        }
+        if (fboState<0) {
+            yInfo("framebuffer objects not available, cameras are rendered in the window");
+        }
+    }
+    return (fboState>0);
+}
+
 bool OdeSdlSimulation::getImage(ImageOf<PixelRgb>& target) {
     int w = cameraSizeWidth;
     int h = cameraSizeHeight;
-    int p = 3;
-
-    char *buf=new char[w * h * p];
-    glReadPixels( 0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, buf);
-    ImageOf<PixelRgb> img;
-    img.setQuantum(1);
-    img.setExternal(buf,w,h);
-
-    // inefficient flip!
-    target.resize(img);
-    int ww = img.width();
-    int hh = img.height();
-    for (int x=0; x<ww; x++) {
-        for (int y=0; y<hh; y++) {
-            target(x,y) = img(x,hh-1-y);
-        }
+
+    static std::vector<unsigned char> buf;
+    buf.resize(3*(size_t)w*h);
+    glPixelStorei(GL_PACK_ALIGNMENT,1);
+    glReadPixels( 0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, &buf[0]);
+    flipImage(&buf[0],w,h,target);
+
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    return true;
+}
+
+bool OdeSdlSimulation::startImage(int slot) {
+    if (slot<0 || slot>=IMAGE_SLOTS || !initPbo()) {
+        return Simulation::startImage(slot);
     }
+
+    int w = cameraSizeWidth;
+    int h = cameraSizeHeight;
+    int size = 3*w*h;
+
+    glPixelStorei(GL_PACK_ALIGNMENT,1);
+    pboBindBuffer(GL_PIXEL_PACK_BUFFER,pboNames[slot]);
+    if (pboSize[slot]!=size) {
+        pboBufferData(GL_PIXEL_PACK_BUFFER,size,NULL,GL_STREAM_READ);
+        pboSize[slot] = size;
+    }
+    // with a pack buffer bound, the last argument is an offset into it
+    glReadPixels( 0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, (GLvoid*)0);
+    pboBindBuffer(GL_PIXEL_PACK_BUFFER,0);
+
+    pboWidth[slot] = w;
+    pboHeight[slot] = h;
+    pboPending[slot] = true;
+
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    delete[] buf;
     return true;
 }
 
+bool OdeSdlSimulation::collectImage(int slot, ImageOf<PixelRgb>& target) {
+    if (slot<0 || slot>=IMAGE_SLOTS || (pboState<=0) || !pboPending[slot]) {
+        return Simulation::collectImage(slot,target);
+    }
+
+    pboBindBuffer(GL_PIXEL_PACK_BUFFER,pboNames[slot]);
+    const unsigned char *src = (const unsigned char*)pboMapBuffer(GL_PIXEL_PACK_BUFFER,GL_READ_ONLY);
+    if (src!=NULL) {
+        flipImage(src,pboWidth[slot],pboHeight[slot],target);
+        pboUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    pboBindBuffer(GL_PIXEL_PACK_BUFFER,0);
+    pboPending[slot] = false;
+
+    return (src!=NULL);
+}
+
 void OdeSdlSimulation::inspectWholeBodyContactsAndSendTouch()
 {
       //SkinDynLib enums
@@ -1716,9 +2008,16 @@ void OdeSdlSimulation::inspectWholeBodyContactsAndSendTouch()
       if (odeinit.verbosity > 4) yDebug("OdeSdlSimulation::inspectWholeBodyContactsAndSendTouch:There were %lu iCub collisions to process.", odeinit.listOfSkinContactInfos.size());
       //main loop through all the contacts
       for (list<OdeInit::contactOnSkin_t>::iterator it = odeinit.listOfSkinContactInfos.begin(); it!=odeinit.listOfSkinContactInfos.end(); it++){
-          skinPart = SKIN_PART_UNKNOWN; bodyPart = BODY_PART_UNKNOWN;  handPart = ALL_HAND_PARTS; skinCoverFlag = false; fingertipFlag = false;
           taxel_list.clear();
-          odeinit._iCub->getSkinAndBodyPartFromSpaceAndGeomID((*it).body_geom_space_id,(*it).body_geom_id,skinPart,bodyPart,handPart,skinCoverFlag,fingertipFlag);
+          std::map<dGeomID,skinGeom_t>::iterator geomIt = skinGeomMap.find((*it).body_geom_id);
+          if (geomIt == skinGeomMap.end()){
+              skinGeom_t info;
+              info.skinPart = SKIN_PART_UNKNOWN; info.bodyPart = BODY_PART_UNKNOWN; info.handPart = ALL_HAND_PARTS; info.skinCoverFlag = false; info.fingertipFlag = false;
+              odeinit._iCub->getSkinAndBodyPartFromSpaceAndGeomID((*it).body_geom_space_id,(*it).body_geom_id,info.skinPart,info.bodyPart,info.handPart,info.skinCoverFlag,info.fingertipFlag);
+              geomIt = skinGeomMap.insert(std::make_pair((*it).body_geom_id,info)).first;
+          }
+          skinPart = geomIt->second.skinPart; bodyPart = geomIt->second.bodyPart; handPart = geomIt->second.handPart;
+          skinCoverFlag = geomIt->second.skinCoverFlag; fingertipFlag = geomIt->second.fingertipFlag;
           if(upper_body_transforms_available){
               geoCenter_SIM_FoR_forHomo.zero(); geoCenter_SIM_FoR_forHomo(3)=1.0; //setting the extra row to 1 - for multiplication by homogenous rototransl. matrix
               normal_SIM_FoR_forHomo.zero(); normal_SIM_FoR_forHomo(3)=1.0; 
@@ -1849,11 +2148,47 @@ void OdeSdlSimulation::inspectWholeBodyContactsAndSendTouch()
           }
       } //cycle through odeinit.listOfSkinContactInfos
       
-      //all contacts have been processed, now we produce the output
-      
+      //all contacts have been processed, the output is produced by the skin thread
+      postSkinReport(mySkinContactList);
+}
+
+static void postSkinReport(skinContactList& contacts)
+{
+    // the physics does not wait for the ports: a report which has not been sent yet is replaced by the newer one
+    std::lock_guard<std::mutex> lock(skinReportMtx);
+    skinReportContacts.swap(contacts);
+    skinReportParts = contactICubSkinEmulMap;
+    skinReportPending = true;
+    skinReportCond.notify_one();
+}
+
+int OdeSdlSimulation::thread_skin(void *unused) {
+    skinContactList contacts;
+    std::map<SkinPart,contactICubSkinEmul_t> parts;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(skinReportMtx);
+            skinReportCond.wait(lock, []{ return skinReportPending || skinReportStop; });
+            if (!skinReportPending) {
+                break;
+            }
+            contacts.swap(skinReportContacts);
+            parts.swap(skinReportParts);
+            skinReportPending = false;
+        }
+        sendSkinReport(contacts, parts);
+        contacts.clear();
+    }
+    return(0);
+}
+
+static void sendSkinReport(skinContactList& contacts, std::map<SkinPart,contactICubSkinEmul_t>& parts)
+{
+      OdeInit& odeinit = OdeInit::get();
+
       if(robot_streamer->shouldSendSkinEvents()){ //note that these are generated here for any body parts - not only those that have tactile sensors in the real robot
         // the contacts can be visualized using the icubGui (not skinGui) 
-          robot_streamer->sendSkinEvents(mySkinContactList); //we send even if empty
+          robot_streamer->sendSkinEvents(contacts); //we send even if empty
       }  
    
       //for hands, this is now done differently than in the original inspectTouch_icubSensors, where finger bodies were inspected, whether they have contact joints attached to them
@@ -1863,12 +2198,12 @@ void OdeSdlSimulation::inspectWholeBodyContactsAndSendTouch()
       int y=0;
       if(robot_streamer->shouldSendTouchLeftHand()){
             Bottle bottleLeftHand;
-            if (contactICubSkinEmulMap[SKIN_LEFT_HAND].coverTouched){ 
+            if (parts[SKIN_LEFT_HAND].coverTouched){ 
                 //prepare the bottle
                 //first 60 are fingers
-                if (contactICubSkinEmulMap[SKIN_LEFT_HAND].indivTaxelResolution){
+                if (parts[SKIN_LEFT_HAND].indivTaxelResolution){
                     for (y = 0; y<=59; y++){ 
-                        if (contactICubSkinEmulMap[SKIN_LEFT_HAND].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
+                        if (parts[SKIN_LEFT_HAND].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
                             bottleLeftHand.addFloat64(255.0); 
                         }
                         else{
@@ -1887,9 +2222,9 @@ void OdeSdlSimulation::inspectWholeBodyContactsAndSendTouch()
                 }
                 
                 //pam - positions 97-144 palm taxels; taxel IDs have index by one lower (inside these, IDs 107, 119, 131, and 139 are thermal pads ~ 0s); 
-                    if (contactICubSkinEmulMap[SKIN_LEFT_HAND].indivTaxelResolution){
+                    if (parts[SKIN_LEFT_HAND].indivTaxelResolution){
                     for (y = 96; y<=143; y++){ 
-                            if (contactICubSkinEmulMap[SKIN_LEFT_HAND].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
+                            if (parts[SKIN_LEFT_HAND].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
                                 bottleLeftHand.addFloat64(255.0); 
                             }
                             else{
@@ -1916,12 +2251,12 @@ void OdeSdlSimulation::inspectWholeBodyContactsAndSendTouch()
       
       if(robot_streamer->shouldSendTouchRightHand()){
           Bottle bottleRightHand;
-            if (contactICubSkinEmulMap[SKIN_RIGHT_HAND].coverTouched){ 
+            if (parts[SKIN_RIGHT_HAND].coverTouched){ 
                 //prepare the bottle
                 //first 60 are fingers
-                if (contactICubSkinEmulMap[SKIN_RIGHT_HAND].indivTaxelResolution){
+                if (parts[SKIN_RIGHT_HAND].indivTaxelResolution){
                     for (y = 0; y<=59; y++){ 
-                        if (contactICubSkinEmulMap[SKIN_RIGHT_HAND].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
+                        if (parts[SKIN_RIGHT_HAND].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
                             bottleRightHand.addFloat64(255.0); 
                           }
                           else{
@@ -1940,9 +2275,9 @@ void OdeSdlSimulation::inspectWholeBodyContactsAndSendTouch()
               }
                 
                 //pam - positions 97-144 palm taxels; taxel IDs have index by one lower (inside these, IDs 107, 119, 131, and 139 are thermal pads ~ 0s); 
-                  if (contactICubSkinEmulMap[SKIN_RIGHT_HAND].indivTaxelResolution){
+                  if (parts[SKIN_RIGHT_HAND].indivTaxelResolution){
                     for (y = 96; y<=143; y++){ 
-                          if (contactICubSkinEmulMap[SKIN_RIGHT_HAND].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
+                          if (parts[SKIN_RIGHT_HAND].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
                                 bottleRightHand.addFloat64(255.0); 
                             }
                             else{
@@ -1971,10 +2306,10 @@ void OdeSdlSimulation::inspectWholeBodyContactsAndSendTouch()
         
      if(robot_streamer->shouldSendTouchLeftArm()){
          Bottle bottleLeftArm;
-         if (contactICubSkinEmulMap[SKIN_LEFT_UPPER_ARM].coverTouched){
-             if (contactICubSkinEmulMap[SKIN_LEFT_UPPER_ARM].indivTaxelResolution){
+         if (parts[SKIN_LEFT_UPPER_ARM].coverTouched){
+             if (parts[SKIN_LEFT_UPPER_ARM].indivTaxelResolution){
                 for (int y = 0; y<=767; y++){ 
-                    if (contactICubSkinEmulMap[SKIN_LEFT_UPPER_ARM].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
+                    if (parts[SKIN_LEFT_UPPER_ARM].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
                              bottleLeftArm.addFloat64(255.0); 
                     }
                     else{
@@ -1993,10 +2328,10 @@ void OdeSdlSimulation::inspectWholeBodyContactsAndSendTouch()
      }
      if(robot_streamer->shouldSendTouchLeftForearm()){
          Bottle bottleLeftForearm;
-          if (contactICubSkinEmulMap[SKIN_LEFT_FOREARM].coverTouched){
-             if (contactICubSkinEmulMap[SKIN_LEFT_FOREARM].indivTaxelResolution){
+          if (parts[SKIN_LEFT_FOREARM].coverTouched){
+             if (parts[SKIN_LEFT_FOREARM].indivTaxelResolution){
                 for (int y = 0; y<=383; y++){ 
-                    if (contactICubSkinEmulMap[SKIN_LEFT_FOREARM].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
+                    if (parts[SKIN_LEFT_FOREARM].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
                              bottleLeftForearm.addFloat64(255.0); 
                     }
                     else{
@@ -2015,10 +2350,10 @@ void OdeSdlSimulation::inspectWholeBodyContactsAndSendTouch()
      }
      if(robot_streamer->shouldSendTouchRightArm()){
          Bottle bottleRightArm;
-         if (contactICubSkinEmulMap[SKIN_RIGHT_UPPER_ARM].coverTouched){
-             if (contactICubSkinEmulMap[SKIN_RIGHT_UPPER_ARM].indivTaxelResolution){
+         if (parts[SKIN_RIGHT_UPPER_ARM].coverTouched){
+             if (parts[SKIN_RIGHT_UPPER_ARM].indivTaxelResolution){
                 for (int y = 0; y<=767; y++){ 
-                    if (contactICubSkinEmulMap[SKIN_RIGHT_UPPER_ARM].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
+                    if (parts[SKIN_RIGHT_UPPER_ARM].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
                         bottleRightArm.addFloat64(255.0); 
                     }
                     else{
@@ -2037,10 +2372,10 @@ void OdeSdlSimulation::inspectWholeBodyContactsAndSendTouch()
       }
       if(robot_streamer->shouldSendTouchRightForearm()){
          Bottle bottleRightForearm;
-          if (contactICubSkinEmulMap[SKIN_RIGHT_FOREARM].coverTouched){
-             if (contactICubSkinEmulMap[SKIN_RIGHT_FOREARM].indivTaxelResolution){
+          if (parts[SKIN_RIGHT_FOREARM].coverTouched){
+             if (parts[SKIN_RIGHT_FOREARM].indivTaxelResolution){
                 for (int y = 0; y<=383; y++){ 
-                    if (contactICubSkinEmulMap[SKIN_RIGHT_FOREARM].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
+                    if (parts[SKIN_RIGHT_FOREARM].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
                              bottleRightForearm.addFloat64(255.0); 
                     }
                     else{
@@ -2059,10 +2394,10 @@ void OdeSdlSimulation::inspectWholeBodyContactsAndSendTouch()
       }
       if(robot_streamer->shouldSendTouchTorso()){
          Bottle bottleTorso;
-         if (contactICubSkinEmulMap[SKIN_FRONT_TORSO].coverTouched){
-             if (contactICubSkinEmulMap[SKIN_FRONT_TORSO].indivTaxelResolution){
+         if (parts[SKIN_FRONT_TORSO].coverTouched){
+             if (parts[SKIN_FRONT_TORSO].indivTaxelResolution){
                 for (int y = 0; y<=767; y++){ 
-                    if (contactICubSkinEmulMap[SKIN_FRONT_TORSO].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
+                    if (parts[SKIN_FRONT_TORSO].taxelsTouched.count(y)){ // if element (taxel ID) is in the set, count returns 1
                              bottleTorso.addFloat64(255.0); 
                     }
                     else{
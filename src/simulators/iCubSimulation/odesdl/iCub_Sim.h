@@ -110,8 +110,14 @@ public:
 
     virtual bool getImage(yarp::sig::ImageOf<yarp::sig::PixelRgb>& target);
 
+    virtual bool startImage(int slot);
+
+    virtual bool collectImage(int slot, yarp::sig::ImageOf<yarp::sig::PixelRgb>& target);
+
     virtual bool getTrqData(Bottle data);
 
+    virtual bool getStats(Bottle& stats, bool reset = false);
+
 private:
     static void draw();
 
@@ -147,16 +153,20 @@ private:
     //static int thread_func(void *unused);
     static int thread_ode(void *unused);
 
+    static int thread_skin(void *unused);
+
     static void sighandler(int sig);
     
     static void initContactICubSkinEmulMap(void);
     static void resetContactICubSkinEmulMap(void);
     static void printContactICubSkinEmulMap(void); //for debugging
     
-    // in the self_collisions regime, this is to ignore collisions between certain geoms, such as upper arm covers colliding with torso
-    static bool selfCollisionOnIgnoreList(string geom1_string, string geom2_string);
+    // in the self_collisions regime, this is to ignore collisions between certain geoms, such as upper arm covers colliding with torso;
+    // it sets their category and collide bits once, so that the spaces filter the pairs out
+    static void initSelfCollisionFilter();
     
     static void inspectWholeBodyContactsAndSendTouch();      //We emulate the skin of the iCub - covers + fingertips;  the rest of the geoms will only be processed by the skinEvents
+                                                             //the reports are built and sent by thread_skin()
     static void mapPositionIntoTaxelList(const SkinPart skin_part,const Vector geo_center_link_FoR,std::vector<unsigned int>& list_of_taxels);
     static void pushTriangleToTaxelList(const int startingTaxelID,std::vector<unsigned int>& list_of_taxels);
     static void mapFingertipIntoTaxelList(const HandPart hand_part,std::vector<unsigned int>& list_of_taxels);
@@ -468,6 +468,25 @@ void DrawX (dTriMeshX trim, int whichtexture){
 
     glBindTexture(GL_TEXTURE_2D, Texture[whichtexture]);
 
+    // normals and texture coordinates are indexed as the vertices, so that
+    // the whole mesh is drawn by a single call from the arrays
+    if (trim->NormCoord != NULL && trim->NormCount >= trim->VertexCount &&
+        trim->MeshCoord != NULL && trim->MeshCoordCount >= trim->VertexCount) {
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_NORMAL_ARRAY);
+        glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+        glVertexPointer(3, GL_FLOAT, 0, trim->Vertices);
+        glNormalPointer(GL_FLOAT, 0, trim->NormCoord);
+        glTexCoordPointer(2, GL_FLOAT, 0, trim->MeshCoord);
+        glDrawElements(GL_TRIANGLES, trim->IndexCount, GL_UNSIGNED_INT, trim->Indices);
+        glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+        glDisableClientState(GL_NORMAL_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glEnable( GL_CULL_FACE );
+        glDisable(GL_TEXTURE_2D);
+        return;
+    }
+
     glBegin(GL_TRIANGLES);
     for (int i=0; i<(int) (trim->IndexCount); )
     {
@@ -28,6 +28,13 @@
 
 #include "xloader.h"
 #include <yarp/os/LogStream.h>
+#include <yarp/os/Os.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
 
 #if _MSC_VER
 #pragma warning(disable:4996 4244 4305)
@@ -36,9 +43,9 @@
 const float ModelScale = 1.01;
 //---------------------------------------------------------------
 //---------------------------------------------------------------
-dxTriMeshX *dLoadMeshFromX(const char* FileName)
+static dxTriMeshX *parseMeshFromX(const char* FileName)
 {
-    dxTriMeshX *tmpTriMesh = new dxTriMeshX;
+    dxTriMeshX *tmpTriMesh = new dxTriMeshX();
     char buff[256];
     char* word = buff;
     char*  symbol;
@@ -202,6 +209,173 @@ dxTriMeshX *dLoadMeshFromX(const char* FileName)
     fclose(in);
     return tmpTriMesh;
 }
+
+//---------------------------------------------------------------
+// The parsed meshes are cached in binary form, in files named after the hash
+// of the .x file: a changed model is just parsed again.
+//---------------------------------------------------------------
+struct MeshCacheHeader {
+    char magic[8];
+    unsigned long long hash;
+    int VertexCount;
+    int IndexCount;
+    int MeshCoordCount;
+    int NormCount;
+};
+
+// bump it whenever the parsing (e.g. ModelScale) or the layout change
+static const char MeshCacheMagic[8] = { 'I','C','U','B','M','S','H','1' };
+
+static std::string meshCacheDir()
+{
+    const char *dir = yarp::os::getenv("ICUBSIM_MESH_CACHE");
+    if (dir != NULL) {
+        return dir;
+    }
+#ifdef _WIN32
+    dir = yarp::os::getenv("LOCALAPPDATA");
+    if (dir != NULL) {
+        return std::string(dir) + "\\icubSim\\meshes";
+    }
+#else
+    dir = yarp::os::getenv("XDG_CACHE_HOME");
+    if (dir != NULL) {
+        return std::string(dir) + "/icubSim/meshes";
+    }
+    dir = yarp::os::getenv("HOME");
+    if (dir != NULL) {
+        return std::string(dir) + "/.cache/icubSim/meshes";
+    }
+#endif
+    return "";
+}
+
+static bool readFile(const char *FileName, std::vector<char>& data)
+{
+    FILE *in = fopen(FileName, "rb");
+    if (in == NULL) {
+        return false;
+    }
+    fseek(in, 0, SEEK_END);
+    long len = ftell(in);
+    fseek(in, 0, SEEK_SET);
+    data.resize(len > 0 ? len : 0);
+    bool ok = (len <= 0) || (fread(&data[0], 1, len, in) == (size_t)len);
+    fclose(in);
+    return ok;
+}
+
+// FNV-1a, 64 bits
+static unsigned long long hashData(const std::vector<char>& data)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < data.size(); i++) {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static float *takeArray(const std::vector<char>& data, size_t& offset, int count)
+{
+    size_t len = count * sizeof(float);
+    float *array = (float *)malloc(len > 0 ? len : sizeof(float));
+    if (len > 0) {
+        memcpy(array, &data[offset], len);
+        offset += len;
+    }
+    return array;
+}
+
+static dxTriMeshX *readMeshCache(const std::string& cacheName, unsigned long long hash)
+{
+    std::vector<char> data;
+    if (!readFile(cacheName.c_str(), data) || data.size() < sizeof(MeshCacheHeader)) {
+        return NULL;
+    }
+    MeshCacheHeader header;
+    memcpy(&header, &data[0], sizeof(header));
+    if (memcmp(header.magic, MeshCacheMagic, sizeof(header.magic)) != 0 || header.hash != hash ||
+        header.VertexCount < 0 || header.IndexCount < 0 || header.MeshCoordCount < 0 || header.NormCount < 0) {
+        return NULL;
+    }
+    size_t expected = sizeof(header) + sizeof(float) * (header.VertexCount * 3 + header.MeshCoordCount * 2 + header.NormCount * 3)
+                      + sizeof(int) * header.IndexCount;
+    if (data.size() != expected) {
+        return NULL;
+    }
+
+    dxTriMeshX *tmpTriMesh = new dxTriMeshX();
+    size_t offset = sizeof(header);
+    tmpTriMesh->VertexCount = header.VertexCount;
+    tmpTriMesh->Vertices = takeArray(data, offset, header.VertexCount * 3);
+    tmpTriMesh->IndexCount = header.IndexCount;
+    tmpTriMesh->Indices = (int *)takeArray(data, offset, header.IndexCount);
+    tmpTriMesh->MeshCoordCount = header.MeshCoordCount;
+    tmpTriMesh->MeshCoord = takeArray(data, offset, header.MeshCoordCount * 2);
+    tmpTriMesh->NormCount = header.NormCount;
+    tmpTriMesh->NormCoord = takeArray(data, offset, header.NormCount * 3);
+    return tmpTriMesh;
+}
+
+static void writeMeshCache(const std::string& cacheName, unsigned long long hash, const dxTriMeshX *trimesh)
+{
+    MeshCacheHeader header;
+    memcpy(header.magic, MeshCacheMagic, sizeof(header.magic));
+    header.hash = hash;
+    header.VertexCount = trimesh->VertexCount;
+    header.IndexCount = trimesh->IndexCount;
+    header.MeshCoordCount = trimesh->MeshCoord != NULL ? trimesh->MeshCoordCount : 0;
+    header.NormCount = trimesh->NormCoord != NULL ? trimesh->NormCount : 0;
+
+    // written aside and renamed, so that a concurrent start never reads half
+    // a file; the name is per process, since parallel runs share the cache
+    char suffix[32];
+    sprintf(suffix, ".%d.tmp", yarp::os::getpid());
+    std::string tmpName = cacheName + suffix;
+    FILE *out = fopen(tmpName.c_str(), "wb");
+    if (out == NULL) {
+        return;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, out) == 1;
+    ok = ok && fwrite(trimesh->Vertices, sizeof(float), header.VertexCount * 3, out) == (size_t)(header.VertexCount * 3);
+    ok = ok && fwrite(trimesh->Indices, sizeof(int), header.IndexCount, out) == (size_t)header.IndexCount;
+    ok = ok && fwrite(trimesh->MeshCoord, sizeof(float), header.MeshCoordCount * 2, out) == (size_t)(header.MeshCoordCount * 2);
+    ok = ok && fwrite(trimesh->NormCoord, sizeof(float), header.NormCount * 3, out) == (size_t)(header.NormCount * 3);
+    ok = (fclose(out) == 0) && ok;
+    remove(cacheName.c_str());
+    if (!ok || rename(tmpName.c_str(), cacheName.c_str()) != 0) {
+        remove(tmpName.c_str());
+    }
+}
+
+dxTriMeshX *dLoadMeshFromX(const char* FileName)
+{
+    std::vector<char> data;
+    std::string dir = meshCacheDir();
+    if (dir == "" || !readFile(FileName, data)) {
+        return parseMeshFromX(FileName);
+    }
+
+    unsigned long long hash = hashData(data);
+    char name[32];
+    sprintf(name, "%016llx.mesh", hash);
+    std::string cacheName = dir + "/" + name;
+
+    dxTriMeshX *tmpTriMesh = readMeshCache(cacheName, hash);
+    if (tmpTriMesh != NULL) {
+        yDebug("Loaded mesh data of '%s' from the cache\n", FileName);
+        return tmpTriMesh;
+    }
+
+    tmpTriMesh = parseMeshFromX(FileName);
+    if (tmpTriMesh != NULL) {
+        yarp::os::mkdir_p(cacheName.c_str(), 1);
+        writeMeshCache(cacheName, hash, tmpTriMesh);
+    }
+    return tmpTriMesh;
+}
+
 void dTriMeshXDestroy(dTriMeshX TriMesh)
 {
     free (TriMesh->Vertices);
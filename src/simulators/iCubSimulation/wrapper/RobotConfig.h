@@ -50,6 +50,10 @@ public:
     double motorMaxTorque;
     double motorDryFriction;
     double jointStopBouncyness;
+    std::string worldStepper;   // "step" or "quickstep"
+    int    quickStepIterations;
+    double quickStepSOR;
+    int    worldThreads;
 };
 
 class RobotConfig {
@@ -66,6 +70,10 @@ public:
     virtual int getWorldTimestep() = 0;
     virtual double getWorldCFM() = 0;
     virtual double getWorldERP() = 0;
+    virtual std::string getWorldStepper() = 0;
+    virtual int getQuickStepIterations() = 0;
+    virtual double getQuickStepSOR() = 0;
+    virtual int getWorldThreads() = 0;
 
     virtual double getFudgeFactor() = 0;
     virtual double getStopCFM() = 0;
@@ -86,6 +86,22 @@ public:
         readOdeParams();
         return p.worldERP;
     }
+    virtual std::string getWorldStepper() {
+        readOdeParams();
+        return p.worldStepper;
+    }
+    virtual int getQuickStepIterations() {
+        readOdeParams();
+        return p.quickStepIterations;
+    }
+    virtual double getQuickStepSOR() {
+        readOdeParams();
+        return p.quickStepSOR;
+    }
+    virtual int getWorldThreads() {
+        readOdeParams();
+        return p.worldThreads;
+    }
     virtual double getFudgeFactor(){
         readOdeParams();
         return p.fudgeFactor;
@@ -158,6 +174,10 @@ private:
         p.worldTimestep   = bParamWorld.check("timestep", Value(10)).asInt32();
         p.worldCFM        = bParamWorld.check("worldCFM", Value(0.00001)).asFloat64();
         p.worldERP        = bParamWorld.check("worldERP", Value(0.2)).asFloat64();
+        p.worldStepper    = bParamWorld.check("stepper", Value("step")).asString();
+        p.quickStepIterations = bParamWorld.check("quickStepIterations", Value(20)).asInt32();
+        p.quickStepSOR    = bParamWorld.check("quickStepSOR", Value(1.3)).asFloat64();
+        p.worldThreads    = bParamWorld.check("threads", Value(1)).asInt32();
         
         p.maxContactCorrectingVel = bParamContacts.check("maxContactCorrectingVel", Value(1e6)).asFloat64();
         p.contactFrictionCoefficient = bParamContacts.check("contactFrictionCoefficient",Value(1.0)).asFloat64();
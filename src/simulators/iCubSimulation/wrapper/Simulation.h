@@ -53,6 +53,41 @@ public:
 
     virtual bool getImage(yarp::sig::ImageOf<yarp::sig::PixelRgb>& img) = 0;
 
+    /**
+     *
+     * Number of views that can be read back at the same time.
+     *
+     */
+    enum { IMAGE_SLOTS = 3 };
+
+    /**
+     *
+     * Start reading back the view just rendered into a slot; the
+     * image is retrieved later through collectImage(), so that the
+     * transfer can go on while the next view is rendered.  By
+     * default the image is read back straight away.
+     *
+     */
+    virtual bool startImage(int slot) {
+        if (slot<0 || slot>=IMAGE_SLOTS) {
+            return false;
+        }
+        return getImage(images[slot]);
+    }
+
+    /**
+     *
+     * Retrieve the image whose read back was started in a slot.
+     *
+     */
+    virtual bool collectImage(int slot, yarp::sig::ImageOf<yarp::sig::PixelRgb>& img) {
+        if (slot<0 || slot>=IMAGE_SLOTS) {
+            return false;
+        }
+        img.copy(images[slot]);
+        return true;
+    }
+
     /**
      *
      * Signal that we're done with a view.
@@ -73,6 +108,19 @@ public:
     virtual bool checkSync(bool reset = false) = 0;
 
     virtual bool getTrqData(yarp::os::Bottle data) = 0;
+
+    /**
+     *
+     * Statistics on the duration of the phases of the simulation
+     * steps, cleared when reset is true.  By default there are none.
+     *
+     */
+    virtual bool getStats(yarp::os::Bottle& stats, bool reset = false) {
+        return false;
+    }
+
+protected:
+    yarp::sig::ImageOf<yarp::sig::PixelRgb> images[IMAGE_SLOTS];
 };
 
 #endif
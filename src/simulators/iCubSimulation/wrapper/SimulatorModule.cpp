@@ -69,6 +69,10 @@ SimulatorModule::SimulatorModule(WorldManager& world, RobotConfig& config,
     viewParam2 = false;	
     sim = NULL;
     sloth = 0;
+    for (int i=0; i<3; i++) {
+        cameraPeriod[i] = 0.0;
+        cameraDue[i] = 0.0;
+    }
     iCubLArm = NULL;
     iCubRArm = NULL;
     iCubHead = NULL; 
@@ -312,8 +316,20 @@ bool SimulatorModule::respond(const Bottle &command, Bottle &reply) {
         yInfo("\tright\n");
         yInfo("\twide\n");
         yInfo("\tworld\n");
+        yInfo("\tstats [reset]\n");
         reply.fromString("world etc");
         done = true;
+    } else if (cmd=="stats") {
+        // (phase mean p50 p90 p99 max) in ms over the last steps
+        bool reset = (command.get(1).asString()=="reset");
+        if (sim!=NULL && sim->getStats(reply,reset)) {
+            if (reset) {
+                reply.addString("ok");
+            }
+        } else {
+            reply.addString("fail");
+        }
+        done = true;
     } else if (cmd=="left") {
         viewParam1 = true;
         viewParam2 = false;
@@ -531,6 +547,13 @@ void SimulatorModule::initImagePorts() {
                       Value("/cam/right"),
                       "Name of right camera port").asString();
 
+    // the cameras are rendered at most at the frame rate of the window
+    const char *rates[3] = { "rate_left", "rate_right", "rate_wide" };
+    for (int i=0; i<3; i++) {
+        double rate = options.check(rates[i],Value(0.0),"Frame rate of the camera, 0 for the frame rate of the window").asFloat64();
+        cameraPeriod[i] = (rate>0) ? 1.0/rate : 0.0;
+    }
+
 #ifndef OMIT_LOGPOLAR
     string nameLeftFov = 
         options.check("name_leftFov",
@@ -705,62 +728,47 @@ void SimulatorModule::displayStep(int pause) {
 
         camerasStamp.update(Time::now());
 
+        // indexed by the image slot of each camera
+        bool needNormal[3] = { needLeft, needRight, needWide };
+#ifndef OMIT_LOGPOLAR
+        bool needFov[3] = { needLeftFov, needRightFov, false };
+        bool needLog[3] = { needLeftLog, needRightLog, false };
+#else
+        bool needFov[3] = { false, false, false };
+        bool needLog[3] = { false, false, false };
+#endif
+
+        // each camera is rendered and read back once whatever the number of
+        // its outputs, and its image is collected only after the next camera
+        // has been rendered, so that the transfer overlaps with the rendering
+        double stamp = camerasStamp.getTime();
+        int pending = -1;
         for (int i=0; i<3; i++) {
             char ch = order[i];
-            switch (ch) {
-            case 'l':
-                if (needLeft) {
-                    sim->drawView(true,false,false);
-                    getImage();
-                    sendImage(portLeft);
-                    sim->clearBuffer();
-                }
-#ifndef OMIT_LOGPOLAR    
-                if (needLeftFov) {
-                    sim->drawView(true,false,false);
-                    getImage();
-                    sendImageFov(portLeftFov);
-                    sim->clearBuffer();
-                }
-                if (needLeftLog) {
-                    sim->drawView(true,false,false);
-                    getImage();
-                    sendImageLog(portLeftLog);
-                    sim->clearBuffer();
-                }
-#endif
-                break;
-            case 'r':
-                if (needRight) {
-                    sim->drawView(false,true,false);
-                    getImage();
-                    sendImage(portRight);
-                    sim->clearBuffer();
-                }
-#ifndef OMIT_LOGPOLAR    
-                if (needRightFov) {
-                    sim->drawView(false,true,false);
-                    getImage();
-                    sendImageFov(portRightFov);
-                    sim->clearBuffer();
-                }
-                if (needRightLog) {
-                    sim->drawView(false,true,false);
-                    getImage();
-                    sendImageLog(portRightLog);
-                    sim->clearBuffer();
+            int slot = (ch=='l') ? 0 : ((ch=='r') ? 1 : 2);
+            if (!needNormal[slot] && !needFov[slot] && !needLog[slot]) {
+                continue;
+            }
+            if (cameraPeriod[slot]>0) {
+                if (stamp<cameraDue[slot]) {
+                    continue;
                 }
-#endif
-                break;
-            case 'w':
-                if (needWide) {
-                    sim->drawView(false,false,true);
-                    getImage();
-                    sendImage(portWide);
-                    sim->clearBuffer();
+                // a camera which fell behind restarts from now
+                cameraDue[slot] += cameraPeriod[slot];
+                if (cameraDue[slot]<stamp) {
+                    cameraDue[slot] = stamp+cameraPeriod[slot];
                 }
-                break;
             }
+            sim->drawView(slot==0,slot==1,slot==2);
+            sim->startImage(slot);
+            sim->clearBuffer();
+            if (pending>=0) {
+                sendCamera(pending,needNormal[pending],needFov[pending],needLog[pending]);
+            }
+            pending = slot;
+        }
+        if (pending>=0) {
+            sendCamera(pending,needNormal[pending],needFov[pending],needLog[pending]);
         }
 #else
         // per-image operations can be done here
@@ -781,34 +789,51 @@ void SimulatorModule::displayStep(int pause) {
     }
 }
 
-void SimulatorModule::getImage(){
-    sim->getImage(buffer);
-}
+void SimulatorModule::sendCamera(int slot, bool needNormal, bool needFov, bool needLog) {
+    BufferedPort<ImageOf<PixelRgb> >& port = (slot==0) ? portLeft : ((slot==1) ? portRight : portWide);
+
+    // the image goes straight into the outgoing buffer, the other
+    // outputs of the camera are computed from it before it is sent
+    ImageOf<PixelRgb>& img = needNormal ? port.prepare() : buffer;
+    if (!sim->collectImage(slot,img)) {
+        if (needNormal) {
+            port.unprepare();
+        }
+        return;
+    }
+
+#ifndef OMIT_LOGPOLAR
+    if (needFov) {
+        sendImageFov((slot==0) ? portLeftFov : portRightFov, img);
+    }
+    if (needLog) {
+        sendImageLog((slot==0) ? portLeftLog : portRightLog, img);
+    }
+#endif
 
-void SimulatorModule::sendImage(BufferedPort<ImageOf<PixelRgb> >& port) {
-    ImageOf<PixelRgb>& normal = port.prepare();
-    normal.copy( buffer );
-    port.setEnvelope(camerasStamp);
-    port.write();
+    if (needNormal) {
+        port.setEnvelope(camerasStamp);
+        port.write();
+    }
 }
 
 #ifndef OMIT_LOGPOLAR    
 
-void SimulatorModule::sendImageFov(BufferedPort<ImageOf<PixelRgb> >& portFov) {
-    static ImageOf<PixelRgb> fov;
+void SimulatorModule::sendImageFov(BufferedPort<ImageOf<PixelRgb> >& portFov,
+                                   const ImageOf<PixelRgb>& src) {
     ImageOf<PixelRgb>& targetFov = portFov.prepare();
-    subsampleFovea( fov, buffer );
-    targetFov.copy( fov );
+    subsampleFovea( targetFov, src );
+    portFov.setEnvelope(camerasStamp);
     portFov.write();
 }
 
-void SimulatorModule::sendImageLog(BufferedPort<ImageOf<PixelRgb> >& portLog) {
-    static ImageOf<PixelRgb> lp;
-    lp.resize (252, 152);
-    lp.zero();
+void SimulatorModule::sendImageLog(BufferedPort<ImageOf<PixelRgb> >& portLog,
+                                   const ImageOf<PixelRgb>& src) {
     ImageOf<PixelRgb>& targetLog = portLog.prepare();
-    cartToLogPolar( lp , buffer );
-    targetLog.copy( lp );
+    targetLog.resize (252, 152);
+    targetLog.zero();
+    cartToLogPolar( targetLog , src );
+    portLog.setEnvelope(camerasStamp);
     portLog.write();
 }
 
@@ -98,8 +98,10 @@ private:
     bool subsampleFovea(yarp::sig::ImageOf<yarp::sig::PixelRgb>& dst, 
                         const yarp::sig::ImageOf<yarp::sig::PixelRgb>& src);
 
-    void sendImageFov(yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelRgb> >& port);
-    void sendImageLog(yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelRgb> >& port);
+    void sendImageFov(yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelRgb> >& port,
+                      const yarp::sig::ImageOf<yarp::sig::PixelRgb>& src);
+    void sendImageLog(yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelRgb> >& port,
+                      const yarp::sig::ImageOf<yarp::sig::PixelRgb>& src);
 #endif
 
     void displayStep(int pause);
@@ -107,8 +109,7 @@ private:
     virtual void checkTorques();
     void getTorques( yarp::os::BufferedPort<yarp::os::Bottle>& Port );
 
-    void getImage();
-    void sendImage(yarp::os::BufferedPort<yarp::sig::ImageOf<yarp::sig::PixelRgb> >& port);
+    void sendCamera(int slot, bool needNormal, bool needFov, bool needLog);
 
     std::string moduleName;
     yarp::dev::IRobotDescription* idesc;
@@ -121,6 +122,9 @@ private:
     bool firstpass;
 
     yarp::os::Stamp  camerasStamp;
+    // indexed by the image slot of each camera: 0 renders it at every frame
+    double cameraPeriod[3];
+    double cameraDue[3];
     yarp::os::Stamp generalStamp;
     yarp::sig::ImageOf<yarp::sig::PixelRgb> buffer;
 
@@ -23,6 +23,8 @@
 #include <cstdio>
 #include <cstring>
 #include <string>
+#include <vector>
+#include <fstream>
 
 #include <yarp/os/Value.h>
 
@@ -373,6 +375,121 @@ bool doNumber(ManagerState& state) {
 
 bool WorldManager::respond(const yarp::os::Bottle& command, 
                            yarp::os::Bottle& reply) {
+    std::string tag = command.get(1).asString();
+    if (tag=="batch") {
+        // world batch (mk box ...) (rot box 1 ...) ...
+        yarp::os::Bottle ops = command.tail().tail();
+        return respondBatch(ops,reply);
+    } else if (tag=="load" || tag=="save") {
+        reply.clear();
+        if (!command.get(2).isString()) {
+            reply.addVocab32(yarp::os::createVocab32('f','a','i','l'));
+            reply.addString("file name not set");
+            return true;
+        }
+        std::string fileName = command.get(2).asString();
+        return (tag=="load")?loadScene(fileName,reply):saveScene(fileName,reply);
+    }
+    return respondOp(command,reply);
+}
+
+bool WorldManager::respondBatch(const yarp::os::Bottle& ops,
+                                yarp::os::Bottle& reply) {
+    // the commands are those of the world port, so they are rebuilt with
+    // their leading "world" and parsed while the batch is open: it is
+    // cheap compared with the round trip of one rpc per op
+    reply.clear();
+    beginBatch();
+    for (size_t i=0; i<ops.size(); i++) {
+        yarp::os::Bottle command, opReply;
+        command.addString("world");
+        if (ops.get(i).isList()) {
+            command.append(*ops.get(i).asList());
+        }
+        respondOp(command,opReply);
+        reply.addList() = opReply;
+    }
+    endBatch();
+    return true;
+}
+
+bool WorldManager::loadScene(const std::string& fileName,
+                             yarp::os::Bottle& reply) {
+    std::ifstream fin(fileName.c_str());
+    if (!fin.is_open()) {
+        reply.addVocab32(yarp::os::createVocab32('f','a','i','l'));
+        reply.addString("cannot open the scene file");
+        return true;
+    }
+
+    // one world command per line, with or without the leading "world";
+    // the empty lines and the ones starting by # are skipped
+    yarp::os::Bottle ops;
+    std::vector<int> lines;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(fin,line)) {
+        lineNumber++;
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start==std::string::npos || line[start]=='#') {
+            continue;
+        }
+        yarp::os::Bottle op(line);
+        if (op.get(0).asString()=="world") {
+            op = op.tail();
+        }
+        ops.addList() = op;
+        lines.push_back(lineNumber);
+    }
+
+    yarp::os::Bottle replies;
+    respondBatch(ops,replies);
+
+    // all the ops are applied anyway, the first failure is reported
+    for (size_t i=0; i<replies.size(); i++) {
+        yarp::os::Bottle *opReply = replies.get(i).asList();
+        if (opReply!=NULL && opReply->get(0).asVocab32()==yarp::os::createVocab32('f','a','i','l')) {
+            char buf[64];
+            sprintf(buf,"line %d:",lines[i]);
+            reply.addVocab32(yarp::os::createVocab32('f','a','i','l'));
+            reply.addString(buf);
+            reply.append(opReply->tail());
+            return true;
+        }
+    }
+    reply.addVocab32(yarp::os::createVocab32('o','k'));
+    reply.addInt32((int)ops.size());
+    return true;
+}
+
+bool WorldManager::saveScene(const std::string& fileName,
+                             yarp::os::Bottle& reply) {
+    yarp::os::Bottle scene;
+    if (!snapshot(scene)) {
+        reply.addVocab32(yarp::os::createVocab32('f','a','i','l'));
+        reply.addString("the world cannot be saved");
+        return true;
+    }
+    std::ofstream fout(fileName.c_str());
+    if (!fout.is_open()) {
+        reply.addVocab32(yarp::os::createVocab32('f','a','i','l'));
+        reply.addString("cannot write the scene file");
+        return true;
+    }
+    fout << "# iCub_SIM scene, load it with: world load " << fileName << std::endl;
+    for (size_t i=0; i<scene.size(); i++) {
+        yarp::os::Bottle *op = scene.get(i).asList();
+        if (op!=NULL) {
+            fout << op->toString() << std::endl;
+        }
+    }
+    reply.addVocab32(yarp::os::createVocab32('o','k'));
+    reply.addInt32((int)scene.size());
+    return true;
+}
+
+bool WorldManager::respondOp(const yarp::os::Bottle& command,
+                             yarp::os::Bottle& reply) {
     WorldOp op;
     WorldResult result;
     ManagerState state(command,op,result,*this);
@@ -25,6 +25,8 @@
 
 #include "WorldOp.h"
 
+#include <string>
+
 class WorldManager {
 public:
     virtual ~WorldManager() {}
@@ -37,6 +39,33 @@ public:
 
     virtual void apply(const WorldOp& op, WorldResult& result) = 0;
 
+    // the ops applied between beginBatch() and endBatch() must reach the
+    // simulation at once, between two of its steps
+    virtual void beginBatch() {
+    }
+
+    virtual void endBatch() {
+    }
+
+    // fills the scene with one list per world command (without the leading
+    // "world") recreating the objects in their current state
+    virtual bool snapshot(yarp::os::Bottle& scene) {
+        return false;
+    }
+
+private:
+    bool respondOp(const yarp::os::Bottle &command,
+                   yarp::os::Bottle &reply);
+
+    bool respondBatch(const yarp::os::Bottle &ops,
+                      yarp::os::Bottle &reply);
+
+    bool loadScene(const std::string& fileName,
+                   yarp::os::Bottle &reply);
+
+    bool saveScene(const std::string& fileName,
+                   yarp::os::Bottle &reply);
+
 };
 
 #endif
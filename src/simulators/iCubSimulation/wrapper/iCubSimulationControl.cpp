@@ -134,14 +134,13 @@ bool iCubSimulationControl::open(yarp::os::Searchable& config) {
     current_jnt_pos = allocAndCheck<double>(njoints);
     current_jnt_vel = allocAndCheck<double>(njoints);
     current_jnt_acc = allocAndCheck<double>(njoints);
-    estimated_jnt_vel = allocAndCheck<double>(njoints);
     estimated_jnt_acc = allocAndCheck<double>(njoints);
+    step_ctrl = allocAndCheck<LogicalJoint*>(njoints);
+    step_axes = allocAndCheck<int>(njoints);
     current_jnt_torques = allocAndCheck<double>(njoints);
     current_mot_pos = allocAndCheck<double>(njoints);
     current_mot_vel = allocAndCheck<double>(njoints);
     current_mot_acc = allocAndCheck<double>(njoints);
-    estimated_mot_vel = allocAndCheck<double>(njoints);
-    estimated_mot_acc = allocAndCheck<double>(njoints);
     current_mot_torques = allocAndCheck<double>(njoints);
     pwm = allocAndCheck<double>(njoints);
     pwm_ref = allocAndCheck<double>(njoints);
@@ -171,10 +170,7 @@ bool iCubSimulationControl::open(yarp::os::Searchable& config) {
     hasRotorEncoder = allocAndCheck<bool>(njoints);
     rotorIndexOffset = allocAndCheck<int>(njoints);
     motorPoles = allocAndCheck<int>(njoints);
-    linEstJnt = new iCub::ctrl::AWLinEstimator(25, 2.0);
     quadEstJnt = new iCub::ctrl::AWQuadEstimator(50, 2.0);
-    linEstMot = new iCub::ctrl::AWLinEstimator(25, 2.0);
-    quadEstMot = new iCub::ctrl::AWQuadEstimator(50, 2.0);
 
 //  joint_dev = new DeviceTag[njoints];
 
@@ -383,10 +379,9 @@ bool iCubSimulationControl::close (void)
     checkAndDestroy<double>(current_mot_vel);
     checkAndDestroy<double>(current_jnt_acc);
     checkAndDestroy<double>(current_mot_acc);
-    checkAndDestroy<double>(estimated_jnt_vel);
-    checkAndDestroy<double>(estimated_mot_vel);
     checkAndDestroy<double>(estimated_jnt_acc);
-    checkAndDestroy<double>(estimated_mot_acc);
+    checkAndDestroy<LogicalJoint*>(step_ctrl);
+    checkAndDestroy<int>(step_axes);
     checkAndDestroy<double>(next_pos);
     checkAndDestroy<double>(next_vel);
     checkAndDestroy<double>(next_torques);
@@ -432,10 +427,7 @@ bool iCubSimulationControl::close (void)
     checkAndDestroy<double>(dutycycleToPwm);
     //  delete[] jointNames;
 
-    delete linEstJnt;
     delete quadEstJnt;
-    delete linEstMot;
-    delete quadEstMot;
 
     _opened = false;
     return true;
@@ -449,24 +441,52 @@ void iCubSimulationControl::compute_mot_pos_from_jnt_pos(double *mot_pos, const
     }
 }
 
-void iCubSimulationControl::compute_mot_vel_and_acc(double *mot_vel, double *mot_acc, const double *mot_pos, int size_joints)
+void iCubSimulationControl::compute_mot_acc_from_jnt_acc(double *mot_acc, const double *jnt_acc, int size_joints)
 {
-    iCub::ctrl::AWPolyElement el(yarp::sig::Vector(size_joints, mot_pos), Time::now());
-    yarp::sig::Vector speeds = linEstMot->estimate(el);
-    yarp::sig::Vector accs = quadEstMot->estimate(el);
-    for (int i = 0; i < size_joints; i++) mot_vel[i] = speeds[i];
-    for (int i = 0; i < size_joints; i++) mot_acc[i] = accs[i];
+    // the coupling is linear, hence the accelerations are mapped as the
+    // positions instead of being estimated twice
+    for (int i = 0; i < size_joints; i++)
+    {
+        mot_acc[i] = jnt_acc[i]; //use coupling matrix here
+    }
 }
 
-void iCubSimulationControl::compute_jnt_vel_and_acc(double *jnt_vel, double *jnt_acc, const double *jnt_pos, int size_joints)
+void iCubSimulationControl::compute_jnt_acc(double *jnt_acc, const double *jnt_pos, int size_joints)
 {
+    // the velocities are read from the joints, only the accelerations
+    // need the estimator
     iCub::ctrl::AWPolyElement el(yarp::sig::Vector(size_joints, jnt_pos), Time::now());
-    yarp::sig::Vector speeds = linEstJnt->estimate(el);
     yarp::sig::Vector accs = quadEstJnt->estimate(el);
-    for (int i = 0; i < size_joints; i++) jnt_vel[i] = speeds[i];
     for (int i = 0; i < size_joints; i++) jnt_acc[i] = accs[i];
 }
 
+// the control modes sharing the same update of the joints
+enum { STEP_VELOCITY=0, STEP_POSITION, STEP_POSITION_DIRECT, STEP_TORQUE, STEP_PWM, STEP_CURRENT, STEP_GROUPS };
+
+static int stepGroup(int mode)
+{
+    switch (mode)
+    {
+        case MODE_VELOCITY:
+        case VOCAB_CM_MIXED:
+        case MODE_IMPEDANCE_VEL:
+            return STEP_VELOCITY;
+        case MODE_POSITION:
+        case MODE_IMPEDANCE_POS:
+            return STEP_POSITION;
+        case VOCAB_CM_POSITION_DIRECT:
+            return STEP_POSITION_DIRECT;
+        case MODE_TORQUE:
+            return STEP_TORQUE;
+        case MODE_PWM:
+            return STEP_PWM;
+        case MODE_CURRENT:
+            return STEP_CURRENT;
+        default:
+            return -1;
+    }
+}
+
 void iCubSimulationControl::jointStep() {
     lock_guard<mutex> lck(_mutex);
     if (manager==NULL) {
@@ -474,10 +494,14 @@ void iCubSimulationControl::jointStep() {
     }
     if (partSelec<=6)
     {   
+        // read the feedback and count the joints of each group
+        int groupEnd[STEP_GROUPS+1] = {0};
         for (int axis=0; axis<njoints; axis++)
         {
             LogicalJoint& ctrl = manager->control(partSelec,axis); 
+            step_ctrl[axis] = NULL;
             if (!ctrl.isValid()) continue;
+            step_ctrl[axis] = &ctrl;
             current_jnt_pos[axis] = ctrl.getAngle();
             current_jnt_vel[axis] = ctrl.getVelocity();
             current_jnt_torques[axis] = (controlMode[axis]==MODE_TORQUE) ? ctrl.getTorque() : 0.0;  // if not torque ctrl, set torque feedback to 0
@@ -488,89 +512,122 @@ void iCubSimulationControl::jointStep() {
                 controlMode[axis]= VOCAB_CM_HW_FAULT;
                 motor_on[axis] = false;
             }
-            
+
             //motor_on[axis] = true; // no reason to turn motors off, for now
 
-            if (controlMode[axis]==MODE_VELOCITY || controlMode[axis]==VOCAB_CM_MIXED || controlMode[axis]==MODE_IMPEDANCE_VEL)
-            {
-                if(((current_jnt_pos[axis]<limitsMin[axis])&&(next_vel[axis]<0)) || ((current_jnt_pos[axis]>limitsMax[axis])&&(next_vel[axis]>0)))
-                {
-                    ctrl.setVelocity(0.0);
-                }
-                else
-                {
-                    ctrl.setVelocity(next_vel[axis]);
-                }
-            }
-            else if (controlMode[axis]==MODE_POSITION || controlMode[axis]==MODE_IMPEDANCE_POS)
+            int group = stepGroup(controlMode[axis]);
+            if (group>=0) groupEnd[group+1]++;
+        }
+
+        // lay out the axes of each group one after the other
+        int groupNext[STEP_GROUPS];
+        for (int g=0; g<STEP_GROUPS; g++)
+        {
+            groupEnd[g+1] += groupEnd[g];
+            groupNext[g] = groupEnd[g];
+        }
+        for (int axis=0; axis<njoints; axis++)
+        {
+            if (step_ctrl[axis]==NULL) continue;
+            int group = stepGroup(controlMode[axis]);
+            if (group>=0) step_axes[groupNext[group]++] = axis;
+        }
+
+        for (int i=groupEnd[STEP_VELOCITY]; i<groupEnd[STEP_VELOCITY+1]; i++)
+        {
+            int axis = step_axes[i];
+            LogicalJoint& ctrl = *step_ctrl[axis];
+            if(((current_jnt_pos[axis]<limitsMin[axis])&&(next_vel[axis]<0)) || ((current_jnt_pos[axis]>limitsMax[axis])&&(next_vel[axis]>0)))
             {
-                ctrl.setControlParameters(vels[axis],1);
-                ctrl.setPosition(next_pos[axis]);
+                ctrl.setVelocity(0.0);
             }
-            else if (controlMode[axis]==VOCAB_CM_POSITION_DIRECT)
+            else
             {
-                ctrl.setControlParameters(5,1);
-                ctrl.setPosition(next_pos[axis]);
+                ctrl.setVelocity(next_vel[axis]);
             }
-            else if (controlMode[axis]==MODE_TORQUE)
+        }
+
+        for (int i=groupEnd[STEP_POSITION]; i<groupEnd[STEP_POSITION+1]; i++)
+        {
+            int axis = step_axes[i];
+            LogicalJoint& ctrl = *step_ctrl[axis];
+            ctrl.setControlParameters(vels[axis],1);
+            ctrl.setPosition(next_pos[axis]);
+        }
+
+        for (int i=groupEnd[STEP_POSITION_DIRECT]; i<groupEnd[STEP_POSITION_DIRECT+1]; i++)
+        {
+            int axis = step_axes[i];
+            LogicalJoint& ctrl = *step_ctrl[axis];
+            ctrl.setControlParameters(5,1);
+            ctrl.setPosition(next_pos[axis]);
+        }
+
+        for (int i=groupEnd[STEP_TORQUE]; i<groupEnd[STEP_TORQUE+1]; i++)
+        {
+            int axis = step_axes[i];
+            step_ctrl[axis]->setTorque(next_torques[axis]);
+        }
+
+        for (int i=groupEnd[STEP_PWM]; i<groupEnd[STEP_PWM+1]; i++)
+        {
+            int axis = step_axes[i];
+            LogicalJoint& ctrl = *step_ctrl[axis];
+            pwm[axis] = pwm_ref[axis];
+            //currently identical to velocity control, with fixed velocity
+            if (((current_jnt_pos[axis]<limitsMin[axis]) && (pwm_ref[axis]<0)) || ((current_jnt_pos[axis]>limitsMax[axis]) && (pwm_ref[axis]>0)))
             {
-                ctrl.setTorque(next_torques[axis]);
+                ctrl.setVelocity(0.0);
             }
-            else if (controlMode[axis]==MODE_PWM)
+            else
             {
-                pwm[axis] = pwm_ref[axis];
-                //currently identical to velocity control, with fixed velocity
-                if (((current_jnt_pos[axis]<limitsMin[axis]) && (pwm_ref[axis]<0)) || ((current_jnt_pos[axis]>limitsMax[axis]) && (pwm_ref[axis]>0)))
+                if (pwm_ref[axis]>0.001)
                 {
-                    ctrl.setVelocity(0.0);
+                    ctrl.setVelocity(3);
+                }
+                else if (pwm_ref[axis]<-0.001)
+                {
+                    ctrl.setVelocity(-3);
                 }
                 else
                 {
-                    if (pwm_ref[axis]>0.001)
-                    {
-                        ctrl.setVelocity(3);
-                    }
-                    else if (pwm_ref[axis]<-0.001)
-                    {
-                        ctrl.setVelocity(-3);
-                    }
-                    else
-                    {
-                        ctrl.setVelocity(0.0);
-                    }
+                    ctrl.setVelocity(0.0);
                 }
             }
-            else if (controlMode[axis] == MODE_CURRENT)
+        }
+
+        for (int i=groupEnd[STEP_CURRENT]; i<groupEnd[STEP_CURRENT+1]; i++)
+        {
+            int axis = step_axes[i];
+            LogicalJoint& ctrl = *step_ctrl[axis];
+            current_ampere[axis] = current_ampere_ref[axis];
+            //currently identical to velocity control, with fixed velocity
+            if (((current_jnt_pos[axis]<limitsMin[axis]) && (current_ampere_ref[axis]<0)) || ((current_jnt_pos[axis]>limitsMax[axis]) && (current_ampere_ref[axis]>0)))
+            {
+                ctrl.setVelocity(0.0);
+            }
+            else
             {
-                current_ampere[axis] = current_ampere_ref[axis];
-                //currently identical to velocity control, with fixed velocity
-                if (((current_jnt_pos[axis]<limitsMin[axis]) && (current_ampere_ref[axis]<0)) || ((current_jnt_pos[axis]>limitsMax[axis]) && (current_ampere_ref[axis]>0)))
+                if (current_ampere_ref[axis]>0.001)
                 {
-                    ctrl.setVelocity(0.0);
+                    ctrl.setVelocity(3);
+                }
+                else if (current_ampere_ref[axis]<-0.001)
+                {
+                    ctrl.setVelocity(-3);
                 }
                 else
                 {
-                    if (current_ampere_ref[axis]>0.001)
-                    {
-                        ctrl.setVelocity(3);
-                    }
-                    else if (current_ampere_ref[axis]<-0.001)
-                    {
-                        ctrl.setVelocity(-3);
-                    }
-                    else
-                    {
-                        ctrl.setVelocity(0.0);
-                    }
+                    ctrl.setVelocity(0.0);
                 }
             }
         }
+
         compute_mot_pos_from_jnt_pos(current_mot_pos, current_jnt_pos, njoints);
-        compute_mot_vel_and_acc(estimated_mot_vel, estimated_mot_acc, current_mot_pos, njoints);
-        compute_jnt_vel_and_acc(estimated_jnt_vel, estimated_jnt_acc, current_jnt_pos, njoints);
+        compute_jnt_acc(estimated_jnt_acc, current_jnt_pos, njoints);
+        compute_mot_acc_from_jnt_acc(current_mot_acc, estimated_jnt_acc, njoints);
         for (int axis = 0; axis < njoints; axis++)
         {
-            current_mot_acc[axis] = estimated_mot_acc[axis];
             current_jnt_acc[axis] = estimated_jnt_acc[axis];
         }
     }
@@ -367,8 +367,8 @@ class yarp::dev::iCubSimulationControl :
 
 private:
     void compute_mot_pos_from_jnt_pos(double *mot_pos, const double *jnt_pos, int size_joints);
-    void compute_mot_vel_and_acc     (double *mot_vel, double *mot_acc, const double *mot_pos, int size_joints);
-    void compute_jnt_vel_and_acc     (double *jnt_vel, double *jnt_acc, const double *jnt_pos, int size_joints);
+    void compute_mot_acc_from_jnt_acc(double *mot_acc, const double *jnt_acc, int size_joints);
+    void compute_jnt_acc             (double *jnt_acc, const double *jnt_pos, int size_joints);
 
 protected:
     yarp::dev::PolyDriver joints;
@@ -399,18 +399,16 @@ protected:
     //current velocity of the joints
     double *current_jnt_vel;
     double *current_mot_vel;
-    double *estimated_jnt_vel;
-    double *estimated_mot_vel;
     
     //current acceleration of the joints
     double *current_jnt_acc;
     double *current_mot_acc;
     double *estimated_jnt_acc;
-    double *estimated_mot_acc;
-    iCub::ctrl::AWLinEstimator       *linEstJnt;
     iCub::ctrl::AWQuadEstimator      *quadEstJnt;
-    iCub::ctrl::AWLinEstimator       *linEstMot;
-    iCub::ctrl::AWQuadEstimator      *quadEstMot;
+
+    //joints of the current step, with their axes grouped by control mode
+    LogicalJoint **step_ctrl;
+    int *step_axes;
 
     //next position of the joints
     double *next_pos;
@@ -109,13 +109,23 @@ bool simFaceExp::updateModule()
     expressionVals.read(bot);
     string message = bot.toString();
     yInfo("Message received: %s\n",message.c_str());
-    setSubSystem(message.c_str());
+    //emotionInterface sends the commands of an expression in the same message, e.g. L02R02M0BS24
+    bool eyeLidsChanged = false;
+    size_t k = 0;
+    while (message.size() - k > 3 && strchr("LRMS", message[k]) != NULL)
+    {
+        eyeLidsChanged |= (message[k] == 'S');
+        setSubSystem(message.substr(k, 3).c_str());
+        k += 3;
+    }
+    eyeLidsChanged |= (message[k] == 'S');
+    setSubSystem(message.c_str() + k);
     generateTexture();
 
     imgOut.prepare() = image;
     imgOut.write();
     //send eyelids position
-    if ((bot.toString().c_str())[0]=='S')
+    if (eyeLidsChanged)
     {
         bot.clear();
         bot.addInt32((int)eyeLidPos);
@@ -691,13 +691,9 @@ void CalibrationWindow::setCalibration()
 
 
     if(matrix_changed[0]){
-        for (int ri=0; ri<CHANNEL_COUNT; ri++){
-            for (int ci=0; ci<CHANNEL_COUNT; ci++){
-                string msg;
-                core->getDownloader()->strain_set_matrix_rc(bus,id,ri,ci,calib_matrix[index][ri][ci], cDownloader::strain_regset_inuse, &msg);
-                appendLogMsg(msg.c_str());
-            }
-        }
+        string msg;
+        core->getDownloader()->strain_set_matrix(bus,id,calib_matrix[index], cDownloader::strain_regset_inuse, &msg);
+        appendLogMsg(msg.c_str());
     }
 
 
@@ -719,12 +715,10 @@ void CalibrationWindow::setCalibration()
     int ci=0;
 
     drv_sleep (1000);
-    for (ri=0;ri<CHANNEL_COUNT;ri++){
-        for (ci=0;ci<CHANNEL_COUNT;ci++){
-            string msg;
-            core->getDownloader()->strain_get_matrix_rc(bus,id,ri,ci,matrix[index][ri][ci], cDownloader::strain_regset_inuse, &msg);
-            appendLogMsg(msg.c_str());
-        }
+    {
+        string msg;
+        core->getDownloader()->strain_get_matrix(bus,id,matrix[index], cDownloader::strain_regset_inuse, &msg);
+        appendLogMsg(msg.c_str());
     }
     setMatrix(index);
     setFullScale();
@@ -1541,27 +1535,15 @@ void CalibrationWindow::onTimeout()
         }
         updateTitle();
 
-        for (int i=0;i<CHANNEL_COUNT;i++){
-            if(i==0){
-                ret  = core->getDownloader()->strain_get_offset (core->getDownloader()->board_list[selected].bus, core->getDownloader()->board_list[selected].pid, i, offset[i], cDownloader::strain_regset_inuse, &msg);
-            }else{
-                ret |= core->getDownloader()->strain_get_offset (core->getDownloader()->board_list[selected].bus, core->getDownloader()->board_list[selected].pid, i, offset[i], cDownloader::strain_regset_inuse, &msg);
-            }
-            appendLogMsg(msg.c_str());
-        }
+        ret = core->getDownloader()->strain_get_offsets (core->getDownloader()->board_list[selected].bus, core->getDownloader()->board_list[selected].pid, offset, cDownloader::strain_regset_inuse, &msg);
+        appendLogMsg(msg.c_str());
         if (ret!=0){
             qDebug() <<"debug: message 'strain_get_offset' lost.";
         }
 
 
-        for (int i=0;i<CHANNEL_COUNT;i++){
-            if(i==0){
-                ret  = core->getDownloader()->strain_get_adc (core->getDownloader()->board_list[selected].bus, core->getDownloader()->board_list[selected].pid, i, adc[i], bUseCalibration,&msg);
-            }else{
-                ret |= core->getDownloader()->strain_get_adc (core->getDownloader()->board_list[selected].bus, core->getDownloader()->board_list[selected].pid, i, adc[i], bUseCalibration,&msg);
-            }
-            appendLogMsg(msg.c_str());
-        }
+        ret = core->getDownloader()->strain_get_adcs (core->getDownloader()->board_list[selected].bus, core->getDownloader()->board_list[selected].pid, adc, bUseCalibration,&msg);
+        appendLogMsg(msg.c_str());
 
         if (ret!=0){
             qDebug() <<"debug: message 'strain_get_adc' lost.";
@@ -1579,14 +1561,10 @@ void CalibrationWindow::onTimeout()
 
         for(int mi=0;mi<MATRIX_COUNT;mi++){
             if (matrix_changed[mi] == false){
-                for (ri=0;ri<CHANNEL_COUNT;ri++){
-                    for (ci=0;ci<CHANNEL_COUNT;ci++){
-                        core->getDownloader()->strain_get_matrix_rc(core->getDownloader()->board_list[selected].bus,
-                                                                    core->getDownloader()->board_list[selected].pid,
-                                                                    ri, ci, matrix[mi][ri][ci], cDownloader::strain_regset_inuse, &msg);
-                        appendLogMsg(msg.c_str());
-                    }
-                }
+                core->getDownloader()->strain_get_matrix(core->getDownloader()->board_list[selected].bus,
+                                                         core->getDownloader()->board_list[selected].pid,
+                                                         matrix[mi], cDownloader::strain_regset_inuse, &msg);
+                appendLogMsg(msg.c_str());
                 setMatrix(mi);
 //                core->getDownloader()->strain_get_matrix_gain(core->getDownloader()->board_list[selected].bus,
 //                                                              core->getDownloader()->board_list[selected].pid,
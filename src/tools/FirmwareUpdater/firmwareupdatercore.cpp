@@ -104,6 +104,15 @@ bool FirmwareUpdaterCore::init(Searchable& config, int port, QString address, in
         
     }
 
+    // the acks of a window of lines of the .hex file are collected together
+    Bottle &canProgramming = config.findGroup("CAN_PROGRAMMING");
+    if(!canProgramming.isNull()){
+        int window = canProgramming.check("ackWindow", Value(1)).asInt32();
+        double gap = canProgramming.check("frameGap", Value(5.0)).asFloat64();
+        downloader.set_programming_pace(window, gap);
+        if(verbosity>0) qDebug() << "CAN programming: ack window" << window << "lines, frame gap" << gap << "ms";
+    }
+
     if(!gMNT.open(hostIPaddress, port))
     {
         if(verbosity>0) qDebug("Can't open socket, aborting.");
@@ -1077,6 +1086,11 @@ bool FirmwareUpdaterCore::uploadCanApplication(QString filename,QString *resultS
         if (ret==-1)
         {
             *resultString = "Fatal Error during download, terminate";
+            std::string failed = downloader.get_failed_boards();
+            if (!failed.empty())
+            {
+                *resultString += QString(" - no ack from the boards (bus:id) %1").arg(failed.c_str());
+            }
             finished = 1;
         }
         if (ret==0)
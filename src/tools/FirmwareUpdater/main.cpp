@@ -1524,11 +1524,9 @@ int saveDatFileStrain2(FirmwareUpdaterCore *core,QString device,QString id,QStri
 
         for(int mi=0;mi<1;mi++){
 
+            core->getDownloader()->strain_get_matrix(canLine.toInt(),canId.toInt(), matrix[mi], cDownloader::strain_regset_inuse, &msg);
             for (int ri=0;ri<CHANNEL_COUNT;ri++){
-                for (int ci=0;ci<CHANNEL_COUNT;ci++){
-                    core->getDownloader()->strain_get_matrix_rc(canLine.toInt(),canId.toInt(), ri, ci, matrix[mi][ri][ci], cDownloader::strain_regset_inuse, &msg);
-                    core->getDownloader()->strain_get_full_scale(canLine.toInt(),canId.toInt(), ri, full_scale_const[mi][ri], cDownloader::strain_regset_inuse, &msg);
-                }
+                core->getDownloader()->strain_get_full_scale(canLine.toInt(),canId.toInt(), ri, full_scale_const[mi][ri], cDownloader::strain_regset_inuse, &msg);
             }
         }
     
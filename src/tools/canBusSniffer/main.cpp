@@ -18,6 +18,23 @@ Connect to a canbus network and dump all messages to file.
 \section parameters_sec Parameters
 --device device_name: name of the device (e.g. ecan/pcan...)
 
+--port n: the number of the CAN network (default 0)
+
+--capture file: write the frames in a memory mapped ring file instead of
+  just counting them; the frames are stamped with the time they are read
+  at, since ICanBus does not give the hardware timestamps
+
+--frames n: the capacity of the ring file (default 1048576 frames, 24 MB)
+
+--ids list: capture only the identifiers in the list, e.g.
+  0x100-0x1ff,0x35a (default all)
+
+--print: decode and print the captured frames from a thread of their own,
+  which never slows down the capture: the frames it cannot keep up with
+  are reported as lost
+
+--decode file: print the frames kept in a capture file and quit
+
 \section tested_os_sec Tested OS
 Linux and Windows.
 
@@ -37,10 +54,13 @@ This file can be edited at src/canBusSniffer/main.cpp.
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/CanBusInterface.h>
 #include <yarp/os/Time.h>
+#include <yarp/os/Property.h>
 #include <yarp/sig/Vector.h>
 
 #include <yarp/os/PeriodicThread.h>
 
+#include <iCub/CanCapture.h>
+
 #include <iostream>
 #include <string>
 
@@ -48,10 +68,25 @@ using namespace yarp::dev;
 using namespace yarp::sig;
 using namespace yarp::os;
 using namespace yarp;
+using namespace iCub::dev;
 
-const int SNIFFER_THREAD_RATE=50;
+const int SNIFFER_THREAD_RATE=10;
+const int PRINTER_THREAD_RATE=50;
 const int CAN_DRIVER_BUFFER_SIZE=2047;
-const int localBufferSize=512;
+const int localBufferSize=2047;
+const int defaultCaptureFrames=1<<20;
+
+static void printFrame(const CanCaptureFrame& f)
+{
+    char buffer[128];
+    int ret=sprintf(buffer, "%.6f %03x class: %d s: %2x d: %2x l: %d", f.stamp, f.id,
+                    (f.id & 0x700) >> 8, (f.id & 0xf0) >> 4, (f.id & 0x0f), f.len);
+    for (int j=0; j<f.len; j++)
+        ret+=sprintf(buffer+ret, " %02x", f.data[j]);
+    if (f.flags & CAN_CAPTURE_LOST)
+        ret+=sprintf(buffer+ret, " (lost before)");
+    printf("%s\n", buffer);
+}
 
 class SnifferThread: public PeriodicThread
 {
@@ -61,11 +96,19 @@ class SnifferThread: public PeriodicThread
     CanBuffer readBuffer;
     std::string devname;
     int port;
+
+    CanCaptureRing *ring;
+    const CanIdFilter& filter;
+    unsigned long readMessages;
+    unsigned long rejectedMessages;
 public:
-    SnifferThread(std::string dname, int p, int r=SNIFFER_THREAD_RATE): PeriodicThread((double)r/1000.0)
+    SnifferThread(std::string dname, int p, CanCaptureRing *r, const CanIdFilter& f, int rate=SNIFFER_THREAD_RATE):
+        PeriodicThread((double)rate/1000.0), ring(r), filter(f)
     {
         port=p;
-        devname=dname;   
+        devname=dname;
+        readMessages=0;
+        rejectedMessages=0;
     }
 
     bool threadInit()
@@ -94,28 +137,112 @@ public:
 
         iCanBus->canSetBaudRate(0); //default 1MB/s
 
+        // the driver drops the other identifiers, the filter is checked
+        // again on the frames since not every driver filters them
+        for (unsigned int id=0; id<CanIdFilter::MAX_ID; id++)
+            if (filter.accepts(id))
+                iCanBus->canIdAdd(id);
+
         readBuffer=iBufferFactory->createBuffer(localBufferSize);
         return true;
     }
 
     void run()
     {
-        unsigned int messages=localBufferSize;
-        unsigned int readMessages=0;
-        bool res=iCanBus->canRead(readBuffer, messages, &readMessages);
-        if (res)
-            fprintf(stderr, "Read %u messages\n", readMessages);
-        else
-            fprintf(stderr, "Failed (read %u messages)\n", readMessages);
+        // the queue of the driver is emptied before waiting for the next
+        // period, so that a burst does not overflow it
+        unsigned int read;
+        do
+        {
+            read=0;
+            if (!iCanBus->canRead(readBuffer, localBufferSize, &read))
+            {
+                fprintf(stderr, "Failed (read %u messages)\n", read);
+                return;
+            }
+            readMessages+=read;
+
+            if (ring==NULL)
+                continue;
+
+            double stamp=Time::now();
+            for (unsigned int i=0; i<read; i++)
+            {
+                CanMessage& m=readBuffer[i];
+                if (!filter.accepts(m.getId()))
+                {
+                    rejectedMessages++;
+                    continue;
+                }
+                ring->push(stamp, m.getId(), m.getLen(), m.getData());
+            }
+        } while (read==(unsigned int)localBufferSize);
     }
 
     void threadRelease()
     {
+        fprintf(stderr, "Read %lu messages, %lu filtered out\n", readMessages, rejectedMessages);
         iBufferFactory->destroyBuffer(readBuffer);
         driver.close();
     }
 };
 
+class PrinterThread: public PeriodicThread
+{
+    const CanCaptureRing& ring;
+    uint64_t next;
+    uint64_t lost;
+public:
+    PrinterThread(const CanCaptureRing& r, int rate=PRINTER_THREAD_RATE):
+        PeriodicThread((double)rate/1000.0), ring(r), next(0), lost(0)
+    {
+    }
+
+    void run()
+    {
+        uint64_t n=ring.written();
+        CanCaptureFrame f;
+        for (; next<n; next++)
+        {
+            if (!ring.read(next, f))
+            {
+                // the capture went a whole ring ahead
+                uint64_t oldest=ring.oldest();
+                lost+=oldest-next;
+                fprintf(stderr, "%lu frames not printed\n", (unsigned long)(oldest-next));
+                next=oldest-1;
+                continue;
+            }
+            printFrame(f);
+        }
+    }
+
+    void threadRelease()
+    {
+        run();
+        if (lost>0)
+            fprintf(stderr, "%lu frames not printed in total\n", (unsigned long)lost);
+    }
+};
+
+static int decode(const std::string& fileName)
+{
+    CanCaptureRing ring;
+    if (!ring.openForReading(fileName))
+    {
+        std::cerr<<"Error "<<fileName<<" is not a capture file\n";
+        return -1;
+    }
+
+    CanCaptureFrame f;
+    uint64_t n=ring.written();
+    for (uint64_t i=ring.oldest(); i<n; i++)
+        if (ring.read(i, f))
+            printFrame(f);
+    fprintf(stderr, "%lu frames captured, %lu kept\n", (unsigned long)n, (unsigned long)(n-ring.oldest()));
+    return 0;
+}
+
 #ifdef USE_ICUB_MOD
 #include "drivers.h"
 #endif
@@ -128,39 +255,52 @@ int main(int argc, char *argv[])
 	yarp::dev::DriverCollection dev;
 #endif
 
-    if (argc!=3 && argc!=5)
+    Property options;
+    options.fromCommand(argc, argv);
+
+    if (options.check("decode"))
+        return decode(options.find("decode").asString());
+
+    if (!options.check("device"))
     {
         std::cout<<"Usage: --device device_name {ecan|pcan|...}\n";
         std::cout<<"Optional: --port {int} (default 0)\n";
+        std::cout<<"          --capture file [--frames n] [--ids list] [--print]\n";
+        std::cout<<"          --decode file\n";
         return -1;
     }
 
-    std::string p1=std::string(argv[1]);
-    std::string p2=std::string(argv[2]);
-
-    int port=0;
-    if (argc==5)
-        {
-            std::string tmp=std::string(argv[3]);
-            if (tmp=="--port")
-                {
-                    port=atoi(argv[4]);
-                }
-        }
+    int port=options.check("port", Value(0)).asInt32();
 
-    if (p1!="--device")
+    CanIdFilter filter;
+    if (options.check("ids") && !filter.parse(options.find("ids").asString()))
     {
-        std::cout<<"Usage: --device device_name {ecan|pcan}\n";
+        std::cerr<<"Error cannot parse the list of identifiers "<<options.find("ids").asString()<<"\n";
         return -1;
     }
-  
-    SnifferThread thread(p2, port);
+
+    CanCaptureRing ring;
+    bool capture=options.check("capture");
+    if (capture)
+    {
+        int frames=options.check("frames", Value(defaultCaptureFrames)).asInt32();
+        if (!ring.open(options.find("capture").asString(), frames))
+        {
+            std::cerr<<"Error cannot create the capture file "<<options.find("capture").asString()<<"\n";
+            return -1;
+        }
+    }
+
+    SnifferThread thread(options.find("device").asString(), port, capture?&ring:NULL, filter);
+    PrinterThread printer(ring);
 
     if (!thread.start())
     {
         std::cerr<<"Error thread did not start, quitting\n";
         return -1;
     }
+    if (capture && options.check("print"))
+        printer.start();
 
     std::string input;
     bool done=false;
@@ -172,5 +312,7 @@ int main(int argc, char *argv[])
     }
 
     thread.stop();
+    printer.stop();
+    ring.close();
     return 0;
 }
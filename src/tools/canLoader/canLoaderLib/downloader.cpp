@@ -92,6 +92,9 @@ cDownloader::cDownloader(bool verbose)
     connected = false;
     m_idriver=NULL;
     sprsPage=0;
+    ack_window=1;
+    pending_lines=0;
+    frame_gap=5;
     set_canbus_id(-1);
 }
 
@@ -100,6 +103,28 @@ void cDownloader::set_verbose(bool verbose)
     _verbose = verbose;
 }
 
+void cDownloader::set_programming_pace(int window, double gap_ms)
+{
+    ack_window = (window < 1) ? 1 : window;
+    frame_gap = (gap_ms < 0) ? 0 : gap_ms;
+}
+
+std::string cDownloader::get_failed_boards()
+{
+    std::string failed;
+    char board[16];
+    for (int i=0; i<board_list_size; i++)
+        {
+            if (board_list[i].selected==true &&
+                (board_list[i].status == BOARD_WAITING_ACK || board_list[i].status == BOARD_ERR))
+                {
+                    snprintf(board, sizeof(board), "%s%d:%d", failed.empty() ? "" : " ", board_list[i].bus, board_list[i].pid);
+                    failed += board;
+                }
+        }
+    return failed;
+}
+
 void cDownloader::set_external_logger(void *caller, void (*logger)(void *, const std::string &))
 {
     _externalLoggerFptr = logger;
@@ -1348,6 +1373,174 @@ int cDownloader::strain_set_offset(int bus, int target_id, char channel, unsigne
 }
 
 
+//*****************************************************************/
+// sends the requests strain_batch_window at a time and waits for all their replies before the next window
+int cDownloader::strain_transact(int bus, int target_id, vector<strain_request_t> &requests, string *errorstring)
+{
+    const double TOUT = 1.0;
+    size_t next = 0;
+
+    clean_rx();
+    while (next < requests.size())
+    {
+        size_t first = next;
+        int waiting = 0;
+        for (; next < requests.size() && waiting < strain_batch_window; next++, waiting++)
+        {
+            txBuffer[0].setId((2 << 8) + target_id);
+            txBuffer[0].setLen(requests[next].len);
+            memcpy(txBuffer[0].getData(), requests[next].data, requests[next].len);
+            set_bus(txBuffer[0], bus);
+            if (m_idriver->send_message(txBuffer, 1) == 0)
+            {
+                if(_verbose) yError ("Unable to send message\n");
+                return -1;
+            }
+        }
+
+        double start = Time::now();
+        while (waiting > 0)
+        {
+            double left = TOUT - (Time::now() - start);
+            if (left <= 0) break;
+            int read_messages = m_idriver->receive_message(rxBuffer, waiting, left);
+            if (read_messages <= 0) break;
+
+            for (int i=0; i<read_messages; i++)
+            {
+                if (rxBuffer[i].getId() != (2 << 8) + (target_id<<4)) continue;
+                unsigned char *d = rxBuffer[i].getData();
+                for (size_t r=first; r<next; r++)
+                {
+                    strain_request_t &req = requests[r];
+                    if (req.done || d[0] != req.data[0] || (d[1] & 0x0f) != (req.data[1] & 0x0f)) continue;
+                    if (req.keylen > 1 && d[2] != req.data[2]) continue;
+                    memcpy(req.reply, d, rxBuffer[i].getLen());
+                    req.done = true;
+                    waiting--;
+                    break;
+                }
+            }
+        }
+
+        if (waiting > 0)
+        {
+            if(_verbose) yError ("strain_transact : %d requests of opcode 0x%02X got no reply\n", waiting, requests[first].data[0]);
+            if (errorstring) *errorstring += "no reply from the strain to some requests\n";
+            return -1;
+        }
+    }
+    return 0;
+}
+
+//*****************************************************************/
+int cDownloader::strain_get_matrix(int bus, int target_id, unsigned int matrix[6][6], int regset, string *errorstring)
+{
+    if (m_idriver == NULL)
+       {
+           if(_verbose) yError ("Driver not ready\n");
+           return -1;
+       }
+
+    vector<strain_request_t> requests(36);
+    for (int r=0; r<6; r++)
+        for (int c=0; c<6; c++)
+        {
+            strain_request_t &req = requests[r*6+c];
+            req.len = 3;
+            req.keylen = 2;
+            req.data[0] = 0x0A;
+            req.data[1] = ((regset << 4) & 0xf0) | (r & 0x0f);
+            req.data[2] = c;
+        }
+
+    if (strain_transact(bus, target_id, requests, errorstring) != 0) return -1;
+
+    for (int r=0; r<6; r++)
+        for (int c=0; c<6; c++)
+            matrix[r][c] = requests[r*6+c].reply[3]<<8 | requests[r*6+c].reply[4];
+    return 0;
+}
+
+//*****************************************************************/
+int cDownloader::strain_set_matrix(int bus, int target_id, const unsigned int matrix[6][6], int regset, string *errorstring)
+{
+    if (m_idriver == NULL)
+       {
+           if(_verbose) yError ("Driver not ready\n");
+           return -1;
+       }
+
+    // the writes have no reply: they keep the pace of strain_set_matrix_rc() and are verified at the end
+    for (int r=0; r<6; r++)
+        for (int c=0; c<6; c++)
+            strain_set_matrix_rc(bus, target_id, r, c, matrix[r][c], regset, errorstring);
+
+    unsigned int readback[6][6];
+    if (strain_get_matrix(bus, target_id, readback, regset, errorstring) != 0) return -1;
+
+    int errors = 0;
+    for (int r=0; r<6; r++)
+        for (int c=0; c<6; c++)
+            if (readback[r][c] != (matrix[r][c] & 0xffff)) errors++;
+    if (errors > 0)
+    {
+        if(_verbose) yError ("strain_set_matrix : %d elements were not written\n", errors);
+        if (errorstring) *errorstring += "some elements of the matrix were not written\n";
+        return -1;
+    }
+    return 0;
+}
+
+//*****************************************************************/
+int cDownloader::strain_get_offsets(int bus, int target_id, unsigned int offset[6], int regset, string *errorstring)
+{
+    if (m_idriver == NULL)
+       {
+           if(_verbose) yError ("Driver not ready\n");
+           return -1;
+       }
+
+    vector<strain_request_t> requests(6);
+    for (int c=0; c<6; c++)
+    {
+        requests[c].len = 2;
+        requests[c].data[0] = 0x0B;
+        requests[c].data[1] = ((regset << 4) & 0xf0) | (c & 0x0f);
+    }
+
+    if (strain_transact(bus, target_id, requests, errorstring) != 0) return -1;
+
+    for (int c=0; c<6; c++)
+        offset[c] = requests[c].reply[2]<<8 | requests[c].reply[3];
+    return 0;
+}
+
+//*****************************************************************/
+int cDownloader::strain_get_adcs(int bus, int target_id, unsigned int adc[6], int type, string *errorstring)
+{
+    if (m_idriver == NULL)
+       {
+           if(_verbose) yError ("Driver not ready\n");
+           return -1;
+       }
+
+    vector<strain_request_t> requests(6);
+    for (int c=0; c<6; c++)
+    {
+        requests[c].len = 3;
+        requests[c].data[0] = 0x0C;
+        requests[c].data[1] = c;
+        requests[c].data[2] = type;
+    }
+
+    if (strain_transact(bus, target_id, requests, errorstring) != 0) return -1;
+
+    for (int c=0; c<6; c++)
+        adc[c] = requests[c].reply[3]<<8 | requests[c].reply[4];
+    return 0;
+}
+
 int cDownloader::strain_acquire_start(int bus, int target_id, uint8_t txratemilli, bool calibmode, strain_acquisition_mode_t acqmode, string *errorstring)
 {
     // check if driver is running
@@ -1459,6 +1652,9 @@ int cDownloader::strain_acquire_get(int bus, int target_id, vector<strain_value_
         return -1;
     }
 
+    // the samples go in place, without reallocations during the acquisition
+    values.reserve(howmany);
+
     unsigned int errorcount = 0;
     
 
@@ -1474,22 +1670,21 @@ int cDownloader::strain_acquire_get(int bus, int target_id, vector<strain_value_
             cDownloader::strain_value_t sv;
             sv.valid = true;
 
-            for (int c = 0; c < 6; c++)
+            // the six channels in one batch
+            unsigned int adc[6] = {0};
+            if (-1 == strain_get_adcs(bus, target_id, adc, 0))
             {
-                //drv_sleep(3);
-                unsigned int adc = 0;
-                int rr = strain_get_adc(bus, target_id, c, adc, 0);
-                if (-1 == rr)
+                errorcount++;
+                yDebug() << "error in acquisition of the adc channels, incrementing error counter to" << errorcount;
+                if (errorcount >= maxerrors)
                 {
-                    errorcount++;
-                    yDebug() << "error in acquisition of an adc channel " << c << "incrementing error counter to" << errorcount;
-                    if (errorcount >= maxerrors)
-                    {
-                        yError() << "reached" << maxerrors << "reception errors in adc acquisition: must quit";
-                        return -1;
-                    }
+                    yError() << "reached" << maxerrors << "reception errors in adc acquisition: must quit";
+                    return -1;
                 }
-                sv.channel[c] = adc;
+            }
+            for (int c = 0; c < 6; c++)
+            {
+                sv.channel[c] = adc[c];
             }
             values.push_back(sv);
 
@@ -2959,6 +3154,77 @@ int cDownloader::verify_ack(int command, int read_messages)
 
 
 
+//*****************************************************************/
+// Collects the acks of the lines sent since the last check: each selected
+// board must have acked all of them
+int cDownloader::verify_pending_acks(int command)
+{
+    int expected = pending_lines;
+    pending_lines = 0;
+    if (expected == 0) return 0;
+
+    int i,k;
+    vector<int> acks(board_list_size, 0);
+    int missing = 0;
+    for (i=0; i<board_list_size; i++)
+        {
+            if (board_list[i].selected==true &&
+                (board_list[i].status == BOARD_WAITING || board_list[i].status == BOARD_DOWNLOADING))
+                {
+                    board_list[i].status = BOARD_WAITING_ACK;
+                    missing += expected;
+                }
+        }
+
+    const double timeout = 10;
+    double start = Time::now();
+    while (missing > 0)
+        {
+            double left = timeout - (Time::now() - start);
+            if (left <= 0) break;
+            int howmany = (missing < MAX_READ_MSG) ? missing : MAX_READ_MSG;
+            int read_messages = m_idriver->receive_message(rxBuffer, howmany, left);
+            if (read_messages <= 0) break;
+
+            for (k=0; k<read_messages; k++)
+                {
+                    if ((rxBuffer[k].getData()[0]!=command) ||
+                        (rxBuffer[k].getLen() != 2) ||
+                        (rxBuffer[k].getData()[1]!=1))
+                        continue;
+
+                    for (i=0; i<board_list_size; i++)
+                        {
+                            if (board_list[i].selected==true &&
+                                board_list[i].status == BOARD_WAITING_ACK &&
+                                board_list[i].pid == get_src_from_id(rxBuffer[k].getId()) &&
+                                #if defined(DOWNLOADER_USE_IDRIVER2)
+                                board_list[i].bus == rxBuffer[k].getCanBus() &&
+                                #endif
+                                acks[i] < expected)
+                                {
+                                    acks[i]++;
+                                    missing--;
+                                    break;
+                                }
+                        }
+                }
+        }
+
+    int ret = 0;
+    for (i=0; i<board_list_size; i++)
+        {
+            if (board_list[i].selected==true && board_list[i].status == BOARD_WAITING_ACK)
+                {
+                    if (acks[i] == expected)
+                        board_list[i].status = BOARD_DOWNLOADING;
+                    else
+                        ret = -1;
+                }
+        }
+    return ret;
+}
+
 //*****************************************************************/
 // Return values:
 // 0  one line downloaded, continuing the download...
@@ -3363,7 +3629,13 @@ int cDownloader::download_hexintel_line(char* line, int len, int bus, int board_
                                 return -1;
                             }
                         //pause
-                        drv_sleep(5);
+                        drv_sleep(frame_gap);
+                    }
+                    //the acks of a window of lines are collected together
+                    if (ack_window > 1)
+                    {
+                        if (++pending_lines < ack_window) return 0;
+                        return verify_pending_acks(ICUBCANPROTO_BL_DATA);
                     }
                     //receive one ack for the whole line
                     read_messages = m_idriver->receive_message(rxBuffer,nSelectedBoards, 10);
@@ -3376,6 +3648,13 @@ int cDownloader::download_hexintel_line(char* line, int len, int bus, int board_
 
                 case SPRS_TYPE_1:
 
+                    //the data must be acked before the start
+                    if (verify_pending_acks(ICUBCANPROTO_BL_DATA) != 0)
+                    {
+                        if(_verbose) yError ("Missing acks of the data\n");
+                        return -1;
+                    }
+
                     //SEND
                     txBuffer[0].setId(build_id(ID_MASTER,board_pid));
                     txBuffer[0].setLen(5);
@@ -3428,6 +3707,7 @@ int cDownloader::download_hexintel_line(char* line, int len, int bus, int board_
 int cDownloader::open_file(std::string file)
 {
     progress=0;
+    pending_lines=0;
     filestr.close();
     filestr.clear();
     filestr.open (file.c_str(), fstream::in);
@@ -3540,6 +3820,11 @@ int cDownloader::download_file(int bus, int board_pid, int download_type, bool b
         {
             filestr.close();
             filestr.clear();
+            if (verify_pending_acks(ICUBCANPROTO_BL_DATA) != 0)
+                {
+                    if(_verbose) yError("missing acks at the end of the download: abort\n");
+                    return -1;
+                }
             //download terminated OK
             return 0;
         }
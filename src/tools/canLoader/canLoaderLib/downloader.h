@@ -14,6 +14,7 @@
 #include <yarp/dev/CanBusInterface.h>
 
 #include <fstream>
+#include <cstring>
 #include "stdint.h"
 
 
@@ -137,6 +138,13 @@ int get_src_from_id (int id);
 int get_dst_from_id (int id);
 
 int verify_ack(int command, int read_messages);
+int verify_pending_acks(int command);
+
+// lines of the hex file sent before waiting for their acks, and pause in ms
+// between two data frames of a line
+int ack_window;
+int pending_lines;
+double frame_gap;
 
 //Luca
 enum { ampl_gain_numberOf = 13 };
@@ -210,6 +218,13 @@ int strain_set_offset		 (int bus, int target_id, char channel, unsigned int  off
 int strain_get_matrix_rc	 (int bus, int target_id, char r, char c, unsigned int& elem, int regset = strain_regset_inuse, string *errorstring = NULL);
 int strain_set_matrix_rc	 (int bus, int target_id, char r, char c, unsigned int  elem, int regset = strain_regset_inuse, string *errorstring = NULL);
 
+// batched versions of the above: the requests are queued on the bus a few at a time and the replies are
+// matched as they come, instead of one round trip per element. the writes are read back and verified.
+int strain_get_matrix        (int bus, int target_id, unsigned int matrix[6][6], int regset = strain_regset_inuse, string *errorstring = NULL);
+int strain_set_matrix        (int bus, int target_id, const unsigned int matrix[6][6], int regset = strain_regset_inuse, string *errorstring = NULL);
+int strain_get_offsets       (int bus, int target_id, unsigned int offset[6], int regset = strain_regset_inuse, string *errorstring = NULL);
+int strain_get_adcs          (int bus, int target_id, unsigned int adc[6], int type, string *errorstring = NULL);
+
 int strain_get_matrix_gain	 (int bus, int target_id, unsigned int& gain, int regset = strain_regset_inuse, string *errorstring = NULL);
 int strain_set_matrix_gain	 (int bus, int target_id, unsigned int  gain, int regset = strain_regset_inuse, string *errorstring = NULL);
 
@@ -267,6 +282,14 @@ cDownloader(bool verbose = true);
 
 void set_verbose(bool verbose);
 
+// with window > 1 the boards are sent up to window lines of the hex file
+// before their acks are collected, instead of one line at a time
+void set_programming_pace(int window, double gap_ms = 5);
+
+// the selected boards which did not ack the last programming step, as
+// "bus:id" separated by spaces
+std::string get_failed_boards();
+
 void set_external_logger(void *caller = NULL, void (*logger)(void *, const std::string &) = NULL);
 
 
@@ -290,6 +313,20 @@ private:
     
     int readADC(int bus, int target_id, int channel, int nmeasures = 2);
 
+    // a request to the strain and its reply, which carries the same opcode and the same
+    // channel (low nibble of byte 1) and, if keylen is 2, the same byte 2
+    struct strain_request_t
+    {
+        uint8_t data[8];
+        uint8_t len;
+        uint8_t keylen;
+        uint8_t reply[8];
+        bool    done;
+        strain_request_t() : len(0), keylen(1), done(false) { memset(data, 0, sizeof(data)); memset(reply, 0, sizeof(reply)); }
+    };
+    enum { strain_batch_window = 6 };
+    int strain_transact(int bus, int target_id, vector<strain_request_t> &requests, string *errorstring);
+
     void (*_externalLoggerFptr)(void *caller, const std::string &output);
     void * _externalLoggerCaller;
 
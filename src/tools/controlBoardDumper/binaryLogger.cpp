@@ -0,0 +1,269 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+#include "binaryLogger.h"
+
+#include <cstring>
+#include <stdint.h>
+
+static const char logMagic[8] = { 'C','B','D','L','O','G','1','\0' };
+
+static void putInt32(std::vector<unsigned char> &out, int32_t v)
+{
+    uint32_t u = (uint32_t)v;
+    for (int i = 0; i < 4; i++)
+        out.push_back((unsigned char)(u >> (8*i)));
+}
+
+static int32_t getInt32(const unsigned char *in)
+{
+    uint32_t u = 0;
+    for (int i = 0; i < 4; i++)
+        u |= ((uint32_t)in[i]) << (8*i);
+    return (int32_t)u;
+}
+
+static uint64_t toBits(double v)
+{
+    uint64_t u;
+    memcpy(&u, &v, sizeof(u));
+    return u;
+}
+
+static double fromBits(uint64_t u)
+{
+    double v;
+    memcpy(&v, &u, sizeof(v));
+    return v;
+}
+
+// a byte with the number of leading (high nibble) and trailing (low nibble)
+// zero bytes of the XOR with the previous value, then the bytes in between
+static void encodeColumn(const double *column, int n, std::vector<unsigned char> &out)
+{
+    uint64_t prev = 0;
+    for (int i = 0; i < n; i++)
+    {
+        uint64_t bits = toBits(column[i]);
+        uint64_t x = bits ^ prev;
+        prev = bits;
+
+        int lead = 0, trail = 0;
+        if (x == 0)
+        {
+            lead = 8;
+        }
+        else
+        {
+            while (((x >> (8*(7-lead))) & 0xff) == 0) lead++;
+            while (((x >> (8*trail)) & 0xff) == 0) trail++;
+        }
+        out.push_back((unsigned char)((lead << 4) | trail));
+        for (int b = trail; b < 8-lead; b++)
+            out.push_back((unsigned char)(x >> (8*b)));
+    }
+}
+
+static bool decodeColumn(const unsigned char *&in, const unsigned char *end, double *column, int n)
+{
+    uint64_t prev = 0;
+    for (int i = 0; i < n; i++)
+    {
+        if (in >= end)
+            return false;
+        int lead = *in >> 4;
+        int trail = *in & 0x0f;
+        in++;
+        if (lead > 8 || trail > 8 || lead+trail > 8 || (lead < 8 && in+(8-lead-trail) > end))
+            return false;
+        uint64_t x = 0;
+        for (int b = trail; b < 8-lead; b++)
+            x |= ((uint64_t)*in++) << (8*b);
+        prev ^= x;
+        column[i] = fromBits(prev);
+    }
+    return true;
+}
+
+BinaryLogger::BinaryLogger() : file(0), joints(0), records(0), closing(false)
+{
+}
+
+BinaryLogger::~BinaryLogger()
+{
+    close();
+}
+
+bool BinaryLogger::open(const std::string &fileName, int joints)
+{
+    file = fopen(fileName.c_str(), "wb");
+    if (file == 0)
+        return false;
+
+    this->joints = joints;
+    std::vector<unsigned char> header(logMagic, logMagic+8);
+    putInt32(header, joints);
+    fwrite(&header[0], 1, header.size(), file);
+
+    chunk.assign((joints+2)*CHUNK_RECORDS, 0.0);
+    records = 0;
+    closing = false;
+    writer = std::thread(&BinaryLogger::write, this);
+    return true;
+}
+
+void BinaryLogger::close()
+{
+    if (file == 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (records > 0)
+        {
+            // the last chunk is shorter, its columns are packed
+            std::vector<double> last;
+            for (int c = 0; c < joints+2; c++)
+                last.insert(last.end(), chunk.begin()+c*CHUNK_RECORDS, chunk.begin()+c*CHUNK_RECORDS+records);
+            full.push_back(last);
+            records = 0;
+        }
+        closing = true;
+        ready.notify_one();
+    }
+    writer.join();
+    fclose(file);
+    file = 0;
+}
+
+void BinaryLogger::push(int count, double time, const double *values)
+{
+    chunk[records] = count;
+    chunk[CHUNK_RECORDS+records] = time;
+    for (int j = 0; j < joints; j++)
+        chunk[(j+2)*CHUNK_RECORDS+records] = values[j];
+
+    if (++records == CHUNK_RECORDS)
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        full.push_back(std::vector<double>());
+        full.back().swap(chunk);
+        chunk.assign((joints+2)*CHUNK_RECORDS, 0.0);
+        records = 0;
+        ready.notify_one();
+    }
+}
+
+void BinaryLogger::write()
+{
+    std::vector<unsigned char> out;
+    for (;;)
+    {
+        std::vector<double> columns;
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            while (full.empty() && !closing)
+                ready.wait(lock);
+            if (full.empty())
+                break;
+            columns.swap(full.front());
+            full.pop_front();
+        }
+
+        int n = (int)columns.size() / (joints+2);
+        out.clear();
+        putInt32(out, n);
+        putInt32(out, 0);
+        for (int c = 0; c < joints+2; c++)
+            encodeColumn(&columns[c*n], n, out);
+        int32_t bytes = (int32_t)(out.size()-8);
+        for (int i = 0; i < 4; i++)
+            out[4+i] = (unsigned char)(((uint32_t)bytes) >> (8*i));
+        fwrite(&out[0], 1, out.size(), file);
+    }
+    fflush(file);
+}
+
+bool BinaryLogger::convert(const std::string &inName, const std::string &outName, char separator)
+{
+    FILE *in = fopen(inName.c_str(), "rb");
+    if (in == 0)
+    {
+        fprintf(stderr, "cannot open %s\n", inName.c_str());
+        return false;
+    }
+
+    unsigned char header[12];
+    if (fread(header, 1, 12, in) != 12 || memcmp(header, logMagic, 8) != 0)
+    {
+        fprintf(stderr, "%s is not a binary log of controlBoardDumper\n", inName.c_str());
+        fclose(in);
+        return false;
+    }
+    int joints = getInt32(header+8);
+
+    FILE *out = fopen(outName.c_str(), "w");
+    if (out == 0)
+    {
+        fprintf(stderr, "cannot write %s\n", outName.c_str());
+        fclose(in);
+        return false;
+    }
+
+    bool ok = true;
+    std::vector<unsigned char> bytes;
+    std::vector<double> columns;
+    unsigned char chunkHeader[8];
+    while (ok && fread(chunkHeader, 1, 8, in) == 8)
+    {
+        int n = getInt32(chunkHeader);
+        int size = getInt32(chunkHeader+4);
+        if (n <= 0 || size < 0)
+        {
+            ok = false;
+            break;
+        }
+        bytes.resize(size);
+        if (size > 0 && fread(&bytes[0], 1, size, in) != (size_t)size)
+        {
+            ok = false;
+            break;
+        }
+
+        columns.resize((joints+2)*n);
+        const unsigned char *p = bytes.empty() ? 0 : &bytes[0];
+        const unsigned char *end = p+size;
+        for (int c = 0; ok && c < joints+2; c++)
+            ok = decodeColumn(p, end, &columns[c*n], n);
+
+        for (int r = 0; ok && r < n; r++)
+        {
+            // as the lines of --logToFile: count, time, values
+            fprintf(out, "%d%c%f", (int)columns[r], separator, columns[n+r]);
+            for (int j = 0; j < joints; j++)
+                fprintf(out, "%c%.15g", separator, columns[(j+2)*n+r]);
+            fputs("\n", out);
+        }
+    }
+    if (!ok)
+        fprintf(stderr, "%s is truncated or corrupted\n", inName.c_str());
+
+    fclose(out);
+    fclose(in);
+    return ok;
+}
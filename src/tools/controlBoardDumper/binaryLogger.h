@@ -0,0 +1,80 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+#ifndef __BINARY_LOGGER__
+#define __BINARY_LOGGER__
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/*
+ * Binary log of a dumper: one record per cycle, made of the count and the
+ * time of the stamp and of the values of the joints.
+ *
+ * The records are gathered in chunks of CHUNK_RECORDS, which are written by
+ * a thread of its own, so that the periodic thread never waits for the disk.
+ * Within a chunk the data are stored by column: each value is XORed with the
+ * previous one in its column, and only the bytes between the leading and the
+ * trailing zero bytes of the result are written. Slowly varying signals take
+ * a few bytes per sample instead of the ~10 characters of the text log.
+ *
+ * File layout (little endian):
+ *   "CBDLOG1\0", int32 number of joints
+ *   chunks: int32 records, int32 bytes, the encoded columns
+ */
+class BinaryLogger
+{
+public:
+    static const int CHUNK_RECORDS = 256;
+
+    BinaryLogger();
+    ~BinaryLogger();
+
+    bool open(const std::string &fileName, int joints);
+    void close();
+
+    // called by the periodic thread, does not touch the disk
+    void push(int count, double time, const double *values);
+
+    // writes a binary log as text, one record per line, the separator being
+    // ' ' (the format of --logToFile) or ','
+    static bool convert(const std::string &inName, const std::string &outName, char separator);
+
+private:
+    FILE *file;
+    int joints;
+
+    // the chunk being filled, column by column
+    std::vector<double> chunk;
+    int records;
+
+    std::mutex mtx;
+    std::condition_variable ready;
+    std::deque<std::vector<double> > full;
+    bool closing;
+    std::thread writer;
+
+    void write();
+};
+
+#endif
@@ -92,12 +92,18 @@ void boardDumperThread::setGetter(GetData *g)
     getter = g;
 }
 
+void boardDumperThread::setBinaryLog(bool logOnDisk)
+{
+    logToBinary = logOnDisk;
+}
+
 bool boardDumperThread::threadInit()
 {
     char buff [255];
     strcpy(buff, this->portName.c_str());
     for (size_t i=0; i<strlen(buff); i++)
         if (buff[i]=='/') buff[i]='_';
+    std::string binName = std::string(buff) + ".bin";
     strcat(buff,".log");
 
     if (logToFile)
@@ -112,6 +118,21 @@ bool boardDumperThread::threadInit()
             printf ("logfile opened: %s\n",this->portName.c_str());
         }
     }
+
+    if (logToBinary)
+    {
+        binaryLog = new BinaryLogger;
+        if (!binaryLog->open(binName, numberOfJointsRead))
+        {
+            printf ("error opening binary logfile: %s\n",binName.c_str());
+            delete binaryLog;
+            binaryLog = 0;
+        }
+        else
+        {
+            printf ("binary logfile opened: %s\n",binName.c_str());
+        }
+    }
     return 1;
 }
 
@@ -134,6 +155,8 @@ boardDumperThread::boardDumperThread():PeriodicThread(0.5)
     logFile  = 0;
     imot     = 0;
     logToFile = false;
+    binaryLog = 0;
+    logToBinary = false;
 }
 
 void boardDumperThread::threadRelease()
@@ -150,6 +173,14 @@ void boardDumperThread::threadRelease()
         fprintf(stderr, "Closing logFile \n");
         fclose (logFile);
     }
+
+    if (binaryLog)
+    {
+        fprintf(stderr, "Closing binary logFile \n");
+        binaryLog->close();
+        delete binaryLog;
+        binaryLog = 0;
+    }
 }
 
 void boardDumperThread::run()
@@ -207,6 +238,9 @@ void boardDumperThread::run()
             fputs (bData.toString().c_str(),logFile);
             fputs ("\n",logFile);
         }
+
+        if (binaryLog)
+            binaryLog->push(stmp.getCount(), stmp.getTime(), dataRead);
         
         port->write(bData);
     }
@@ -29,6 +29,7 @@
 #include <yarp/os/PeriodicThread.h>
 
 #include "genericControlBoardDumper.h"
+#include "binaryLogger.h"
 
 class boardDumperThread: public PeriodicThread
 {
@@ -41,6 +42,7 @@ public:
   void threadRelease();
   void run();
   void setGetter(GetData *);
+  void setBinaryLog(bool logOnDisk);
     
 private:
   PolyDriver *board_dd;
@@ -52,6 +54,8 @@ private:
   Port *port;
   FILE * logFile;
   bool   logToFile;
+  BinaryLogger *binaryLog;
+  bool   logToBinary;
 
   IPositionControl *pos;
   IVelocityControl *vel;
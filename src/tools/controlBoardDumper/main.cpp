@@ -82,6 +82,8 @@
  *
  * logToFile                     //if present, this options creates a log file for each data port
  *
+ * logToBinary                   //if present, this options creates a compressed binary log file for each data port
+ *
  * \endcode
  * 
  * If no such file can be found, the application is started
@@ -114,6 +116,15 @@
  * a thread controlBoardDumper which does not depend on the specific
  * interface (e.g. IPositionControl) or function (e.g. getEncoders).
  *
+ * With logToBinary the samples are stored in <port name>.bin, one record (count, time, values) per
+ * cycle, compressed by chunks in a thread of its own. The binary logs are converted offline with:
+ * \code
+ *
+ * controlBoardDumper --convert _icub_head_getEncoders.bin [--csv]
+ *
+ * \endcode
+ * which writes _icub_head_getEncoders.log, in the format of logToFile, or _icub_head_getEncoders.csv.
+ *
  * Please note that for dumping the getRototxxx data the debugInterface is required. This means the robot must instantiate the
  * debugInterfaceWrapper in order to have remote access to those data.
  *
@@ -558,6 +569,7 @@ public:
 
         bool logToFile = false;
         if (rf.check("logToFile")) logToFile = true;
+        bool logToBinary = rf.check("logToBinary");
 
         portPrefix= dumpername + part.asString() + "/";
         //boardDumperThread *myDumper = new boardDumperThread(&dd, rate, portPrefix, dataToDump[0]);
@@ -885,7 +897,10 @@ public:
             }
         Time::delay(1);
         for (int i = 0; i < nData; i++)
+        {
+            myDumper[i].setBinaryLog(logToBinary);
             myDumper[i].start();
+        }
 
         return true;
     }
@@ -962,8 +977,27 @@ int main(int argc, char *argv[])
         printf (" getTemperatures         (motor temperatures)\n");
         printf ("\n3) controlBoardDumper --robot icub --part left_arm --rate 10  --joints \"(0 1 2)\" --dataToDumpAll\n");
         printf ("   All data from the controlBoarWrapper will be dumped, including data from the debugInterface (getRotorxxx).\n");
-        printf ("\n --logToFile can be used to create log files storing the data\n\n");
+        printf ("\n --logToFile can be used to create log files storing the data\n");
+        printf (" --logToBinary can be used to create compressed binary log files storing the data\n");
+        printf ("\n4) controlBoardDumper --convert file.bin [--csv]\n");
+        printf ("   Converts a binary log to file.log, in the format of --logToFile, or to file.csv.\n\n");
+
+        return 0;
+    }
 
+    if (rf.check("convert"))
+    {
+        std::string inName = rf.find("convert").asString();
+        bool csv = rf.check("csv");
+        std::string outName = inName;
+        size_t dot = outName.rfind(".bin");
+        if (dot != std::string::npos && dot == outName.size()-4)
+            outName.erase(dot);
+        outName += csv ? ".csv" : ".log";
+
+        if (!BinaryLogger::convert(inName, outName, csv ? ',' : ' '))
+            return 1;
+        yInfo("%s written\n", outName.c_str());
         return 0;
     }
 
@@ -35,6 +35,12 @@ protected:
     std::string type;
     std::deque<yarp::sig::Vector> in,out;
 
+    // the outcome of the last calibration, which holds
+    // until the points get changed
+    bool upToDate;
+    bool lastResult;
+    double lastError;
+
     struct SpatialCompetence
     {
         yarp::sig::Matrix A;
@@ -55,8 +61,11 @@ protected:
     virtual bool computeSpatialTransformation();
     virtual bool computeSpatialCompetence(const std::deque<yarp::sig::Vector> &points);
     void copySuperClassData(const Calibrator &src);
+    bool isUpToDate(double &error) const;
+    bool setUpToDate(const bool result, const double error);
 
 public:
+    Calibrator() : upToDate(false), lastResult(false), lastError(0.0) { }
     virtual std::string getType() const { return type; }
     virtual bool getExtrapolation() const { return spatialCompetence.extrapolation; }
     virtual void setExtrapolation(const bool extrapolation) { spatialCompetence.extrapolation=extrapolation; }
@@ -67,6 +76,8 @@ public:
     virtual bool calibrate(double &error)=0;
     virtual bool retrieve(const yarp::sig::Vector &in, yarp::sig::Vector &out)=0;
     virtual double getSpatialCompetence(const yarp::sig::Vector &point);
+    virtual void getSpatialCompetence(const std::deque<yarp::sig::Vector> &points,
+                                      yarp::sig::Vector &competence);
     virtual bool toProperty(yarp::os::Property &info) const;
     virtual bool fromProperty(const yarp::os::Property &info);
     virtual ~Calibrator() { }
@@ -126,6 +137,9 @@ public:
     virtual Calibrator *operator[](const size_t i);
     virtual LocallyWeightedExperts &operator<<(Calibrator &c);
     virtual bool retrieve(const yarp::sig::Vector &in, yarp::sig::Vector &out);
+    virtual bool retrieve(const std::deque<yarp::sig::Vector> &in,
+                          std::deque<yarp::sig::Vector> &out,
+                          const unsigned int threads=0);
     virtual void clear();
     virtual ~LocallyWeightedExperts();
 };
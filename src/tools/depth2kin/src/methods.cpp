@@ -16,6 +16,10 @@
 */
 
 #include <cmath>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
 
 #include <yarp/math/Math.h>
 #include <yarp/math/SVD.h>
@@ -37,6 +41,30 @@ using namespace iCub::optimization;
 using namespace iCub::learningmachine;
 
 
+/************************************************************************/
+template<typename F>
+static void parallelFor(const size_t items, unsigned int threads, const F &work)
+{
+    if (threads==0)
+        threads=thread::hardware_concurrency();
+    threads=std::max(1U,std::min(threads,(unsigned int)items));
+
+    atomic<size_t> next(0);
+    auto worker=[&]()
+    {
+        for (size_t item=next++; item<items; item=next++)
+            work(item);
+    };
+
+    vector<thread> workers;
+    for (unsigned int t=1; t<threads; t++)
+        workers.push_back(thread(worker));
+    worker();
+    for (auto &w:workers)
+        w.join();
+}
+
+
 /************************************************************************/
 bool Calibrator::computeSpatialTransformation()
 {
@@ -83,6 +111,28 @@ void Calibrator::copySuperClassData(const Calibrator &src)
     in=src.in;
     out=src.out;
     spatialCompetence=src.spatialCompetence;
+    upToDate=src.upToDate;
+    lastResult=src.lastResult;
+    lastError=src.lastError;
+}
+
+
+/************************************************************************/
+bool Calibrator::isUpToDate(double &error) const
+{
+    if (upToDate)
+        error=lastError;
+    return upToDate;
+}
+
+
+/************************************************************************/
+bool Calibrator::setUpToDate(const bool result, const double error)
+{
+    upToDate=true;
+    lastResult=result;
+    lastError=error;
+    return result;
 }
 
 
@@ -126,6 +176,52 @@ double Calibrator::getSpatialCompetence(const Vector &point)
 }
 
 
+/************************************************************************/
+void Calibrator::getSpatialCompetence(const deque<Vector> &points, Vector &competence)
+{
+    // the inner test is run over contiguous coordinates,
+    // resorting to the single point only for extrapolation
+    size_t n=points.size();
+    vector<double> x(n,0.0),y(n,0.0),z(n,0.0);
+    vector<char> valid(n,0);
+
+    const Vector &c=spatialCompetence.c;
+    double scale=spatialCompetence.scale;
+    for (size_t i=0; i<n; i++)
+    {
+        if (points[i].length()>=3)
+        {
+            x[i]=(points[i][0]-c[0])/scale;
+            y[i]=(points[i][1]-c[1])/scale;
+            z[i]=(points[i][2]-c[2])/scale;
+            valid[i]=1;
+        }
+    }
+
+    const Matrix &A=spatialCompetence.A;
+    double a00=A(0,0),a01=A(0,1),a02=A(0,2);
+    double a10=A(1,0),a11=A(1,1),a12=A(1,2);
+    double a20=A(2,0),a21=A(2,1),a22=A(2,2);
+
+    competence.resize(n,0.0);
+    for (size_t i=0; i<n; i++)
+    {
+        double q=x[i]*(a00*x[i]+a01*y[i]+a02*z[i])+
+                 y[i]*(a10*x[i]+a11*y[i]+a12*z[i])+
+                 z[i]*(a20*x[i]+a21*y[i]+a22*z[i]);
+
+        if (!valid[i])
+            competence[i]=0.0;
+        else if (q<=1.0)
+            competence[i]=1.0;
+        else if (spatialCompetence.extrapolation)
+            competence[i]=getSpatialCompetence(points[i]);
+        else
+            competence[i]=0.0;
+    }
+}
+
+
 /************************************************************************/
 bool Calibrator::toProperty(Property &info) const
 {
@@ -176,6 +272,7 @@ bool Calibrator::fromProperty(const Property &info)
     }
 
     computeSpatialTransformation();
+    upToDate=false;
     return true;
 }
 
@@ -230,6 +327,7 @@ bool MatrixCalibrator::addPoints(const Vector &in, const Vector &out)
 
         this->in.push_back(_in);
         this->out.push_back(_out);
+        upToDate=false;
         return impl->addPoints(_in,_out);
     }
     else
@@ -243,6 +341,7 @@ bool MatrixCalibrator::clearPoints()
     impl->clearPoints();
     in.clear();
     out.clear();    
+    upToDate=false;
     return true;
 }
 
@@ -259,16 +358,17 @@ bool MatrixCalibrator::getPoints(deque<Vector> &in, deque<Vector> &out) const
 /************************************************************************/
 bool MatrixCalibrator::calibrate(double &error)
 {
+    if (isUpToDate(error))
+        return lastResult;
+
     (type=="se3+scale")?dynamic_cast<CalibReferenceWithMatchedPoints*>(impl)->calibrate(H,scale,error):
                         impl->calibrate(H,error);
 
-    if (computeSpatialCompetence(in))
-    {
+    bool ret=computeSpatialCompetence(in);
+    if (ret)
         spatialCompetence.scale=1.2;
-        return true;
-    }
-    else
-        return false;
+
+    return setUpToDate(ret,error);
 }
 
 
@@ -382,6 +482,7 @@ bool LSSVMCalibrator::addPoints(const Vector &in, const Vector &out)
 
         this->in.push_back(_in);
         this->out.push_back(_out);
+        upToDate=false;
         return true;
     }
     else
@@ -395,6 +496,7 @@ bool LSSVMCalibrator::clearPoints()
     impl->reset();
     in.clear();
     out.clear();
+    upToDate=false;
     return true;
 }
 
@@ -414,6 +516,9 @@ bool LSSVMCalibrator::calibrate(double &error)
     if (getNumPoints()==0)
         return false;
 
+    if (isUpToDate(error))
+        return lastResult;
+
     impl->train();
 
     error=0.0;
@@ -425,13 +530,11 @@ bool LSSVMCalibrator::calibrate(double &error)
     }
     error/=getNumPoints();
 
-    if (computeSpatialCompetence(in))
-    {
+    bool ret=computeSpatialCompetence(in);
+    if (ret)
         spatialCompetence.scale=1.0;
-        return true;
-    }
-    else
-        return false;
+
+    return setUpToDate(ret,error);
 }
 
 
@@ -567,6 +670,62 @@ bool LocallyWeightedExperts::retrieve(const Vector &in, Vector &out)
 }
 
 
+/************************************************************************/
+bool LocallyWeightedExperts::retrieve(const deque<Vector> &in, deque<Vector> &out,
+                                      const unsigned int threads)
+{
+    // each model goes through the whole batch on its own,
+    // thus the models can be queried in parallel; their
+    // contributions are then summed up in the same order
+    // as in the single point retrieve
+    size_t n=in.size();
+    vector<Vector> competences(models.size());
+    vector<deque<Vector>> preds(models.size());
+    parallelFor(models.size(),threads,[&](const size_t j)
+    {
+        models[j]->getSpatialCompetence(in,competences[j]);
+        preds[j].resize(n);
+        for (size_t i=0; i<n; i++)
+            if (competences[j][i]>0.0)
+                models[j]->retrieve(in[i].subVector(0,2),preds[j][i]);
+    });
+
+    out.assign(n,Vector());
+    bool ret=true;
+    for (size_t i=0; i<n; i++)
+    {
+        Vector outExperts(3,0.0);
+        Vector outExtrapolators(3,0.0);
+        double sumExperts=0.0;
+        double sumExtrapolators=0.0;
+
+        for (size_t j=0; j<models.size(); j++)
+        {
+            double competence=competences[j][i];
+            if (competence>0.0)
+            {
+                outExtrapolators+=competence*preds[j][i];
+                sumExtrapolators+=competence;
+                if (competence>=1.0)
+                {
+                    outExperts+=competence*preds[j][i];
+                    sumExperts+=competence;
+                }
+            }
+        }
+
+        if (sumExperts!=0.0)
+            out[i]=outExperts/sumExperts;
+        else if (sumExtrapolators!=0.0)
+            out[i]=outExtrapolators/sumExtrapolators;
+        else
+            ret=false;
+    }
+
+    return ret;
+}
+
+
 /************************************************************************/
 void LocallyWeightedExperts::clear()
 {
@@ -1242,12 +1242,22 @@ bool CalibModule::log(const string &type)
     bool useExperts=(type=="experts");
     if (fout.is_open())
     {
+        // the experts go through all the points at once
+        deque<Vector> p_experts;
+        if (useExperts)
+            experts->retrieve(p_depth,p_experts);
+
         size_t i;
         for (i=0; i<p_depth.size(); i++)
         {
             Vector x;
-            if (!(useExperts?experts->retrieve(p_depth[i],x):
-                             calibrator->retrieve(p_depth[i],x)))
+            if (useExperts)
+            {
+                x=p_experts[i];
+                if (x.length()==0)
+                    break;
+            }
+            else if (!calibrator->retrieve(p_depth[i],x))
                 break;
 
             fout<<p_depth[i].toString(3,3);
@@ -0,0 +1,81 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+#include "loadProbe.h"
+
+#include <cstring>
+#include <time.h>
+
+
+uint64_t ethLoadBench::monotonicNow()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec)*1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+
+ethLoadBench::LoadProbe::LoadProbe(eth::iethresType_t type, size_t stampoffset)
+: probetype(type), stampoffset(stampoffset)
+{
+    counters.latency.reset();
+}
+
+
+bool ethLoadBench::LoadProbe::update(eOprotID32_t id32, double timestamp, void *rxdata)
+{
+    uint64_t now = monotonicNow();
+    uint64_t stamp = 0;
+    if(nullptr != rxdata)
+    {
+        memcpy(&stamp, static_cast<const uint8_t*>(rxdata) + stampoffset, sizeof(stamp));
+    }
+
+    std::lock_guard<std::mutex> lck(mtx);
+    counters.updates++;
+    if((stamp > 0) && (now >= stamp))
+    {
+        counters.latency.add((now - stamp)/1000);
+    }
+    return true;
+}
+
+
+void ethLoadBench::LoadProbe::onFrameParsed(double timestamp)
+{
+    std::lock_guard<std::mutex> lck(mtx);
+    counters.frames++;
+}
+
+
+void ethLoadBench::LoadProbe::get(Counters &c, bool reset)
+{
+    std::lock_guard<std::mutex> lck(mtx);
+    c = counters;
+    if(true == reset)
+    {
+        counters.updates = 0;
+        counters.frames = 0;
+        counters.latency.reset();
+    }
+}
+
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
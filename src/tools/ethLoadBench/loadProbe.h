@@ -0,0 +1,78 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+// - include guard ----------------------------------------------------------------------------------------------------
+
+#ifndef _LOADPROBE_H_
+#define _LOADPROBE_H_
+
+// -- class LoadProbe
+// -- it takes the place of a device (embObjMotionControl, embObjMultipleFTsensors, embObjSkin, embObjIMU) for one board: the
+// -- ethReceiver thread calls its update() for every ROP of its kind, as it would do with the device, and the probe measures the
+// -- latency from the time stamped by the VirtualBoard in the data of the ROP (see VirtualBoard::stampOffset()) to the call of
+// -- update().
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "IethResource.h"
+#include "ethStatistics.h"
+
+
+namespace ethLoadBench {
+
+    // it is the clock of the stamps, which is shared by the processes of the same machine: CLOCK_MONOTONIC in nanoseconds
+    uint64_t monotonicNow();
+
+    class LoadProbe : public eth::IethResource
+    {
+    public:
+
+        struct Counters
+        {
+            uint64_t updates {0};                   // the ROPs received
+            uint64_t frames {0};                    // the frames with at least one of the ROPs
+            eth::EthRXstatistics::Histogram latency;
+        };
+
+        LoadProbe(eth::iethresType_t type, size_t stampoffset);
+        ~LoadProbe() override = default;
+
+        bool initialised() override { return true; }
+        bool update(eOprotID32_t id32, double timestamp, void *rxdata) override;
+        void onFrameParsed(double timestamp) override;
+        eth::iethresType_t type() override { return probetype; }
+
+        void get(Counters &counters, bool reset);
+
+    private:
+        eth::iethresType_t probetype;
+        size_t stampoffset;
+        std::mutex mtx;
+        Counters counters;
+    };
+
+} // namespace ethLoadBench
+
+
+#endif  // include-guard
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
@@ -0,0 +1,562 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+/**
+ * @ingroup icub_tools
+ *
+ * \defgroup icub_ethLoadBench ethLoadBench
+ *
+ * A load generator for the reception of the ETH boards: it measures how the
+ * host side of the embObj stack scales with the number of boards and with
+ * their rate, without any board.
+ *
+ * \section intro_sec Description
+ *
+ * The tool hosts the real stack of the robot interface (TheEthManager, its
+ * EthReceiver threads, one EthResource and one HostTransceiver per board) and
+ * feeds it over the loopback with the frames of up to
+ * TheEthManager::maxBoards virtual boards. Every virtual board sends a
+ * ropframe of sig<> ROPs at a fixed rate, formed by an embobj transceiver as a
+ * board in its running mode would do: the status core of some joints, the
+ * timed values of some FT sensors, the can frames of a skin patch and the
+ * items of an IMU.
+ *
+ * The devices of the robot (embObjMotionControl, embObjMultipleFTsensors,
+ * embObjSkin, embObjIMU) cannot run without a board which answers to the
+ * protocol of their services, thus they are replaced by probes which receive
+ * the same update() calls and measure the latency of the data from their
+ * sending by the virtual board.
+ *
+ * The virtual boards run in a child process, i.e. the tool itself launched
+ * with --emit, because the protocol of a board exists once per process and
+ * the host already uses it for the same board. The board k (1 ... 32) sends
+ * from 127.0.1.k, hence the tool runs on Linux, where all of 127.0.0.0/8 is
+ * the loopback.
+ *
+ * For every configuration (number of boards x rate) it prints a row with:
+ * - the frames sent and received, and the drop rate;
+ * - the disordered frames, which are one per board from the second
+ *   configuration on as the virtual boards start again from sequence number 1
+ *   (the host also logs an error of sequence number for them);
+ * - the CPU used by the host, in percentage of a core and per received frame,
+ *   after the removal of the CPU used with no traffic;
+ * - the parsing time of a frame and the latency from the send() of the
+ *   virtual board to the update() of the probe (mean, 99th percentile, max).
+ *   The percentiles come from the power-of-two histograms of EthRXstatistics,
+ *   thus they are upper bounds.
+ *
+ * \section lib_sec Libraries
+ * YARP libraries, the ethResources library and icub-firmware-shared.
+ *
+ * \section parameters_sec Parameters
+ * \code
+ * --boards (n1 n2 ...)     // the numbers of boards of the configurations [default: (1 4 8 16 32)]
+ * --rate (r1 r2 ...)       // [Hz] the rates of the frames of every board [default: (1000)]
+ * --duration d             // [s] the duration of every configuration [default: 5]
+ * --joints j               // the joints of every board [default: 4]
+ * --fts f                  // the FT sensors of every board [default: 0]
+ * --skin s                 // the can frames of the skin of every board, 0 is no skin [default: 0]
+ * --imu i                  // the items of the IMU of every board, 0 is no IMU [default: 0]
+ * --maxSizeROP m           // the maxSizeROP of the boards [default: 384]
+ * --port p                 // the port of the host and of the boards [default: 12345]
+ * --rxrate r               // [ms] PC104RXrate [default: 1]
+ * --rxmode periodic|event  // PC104RXmode [default: periodic]
+ * --rxshards n             // PC104RXshards [default: 1]
+ * --rxcore c               // PC104RXcore [default: -1]
+ * --csv file               // it also writes the rows in a csv file
+ * \endcode
+ * For example:
+ * \code
+ * ethLoadBench --boards "(8 16 32)" --rate "(500 1000)" --joints 12 --fts 2 --skin 8 --rxmode event
+ * \endcode
+ *
+ * \section portsa_sec Ports Accessed
+ * None
+ *
+ * \section portsc_sec Ports Created
+ * None. It uses the UDP port of the host and of the boards on the loopback.
+ *
+ * \section tested_os_sec Tested OS
+ * Linux
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/ResourceFinder.h>
+#include <yarp/os/LogStream.h>
+
+#include "ethManager.h"
+#include "ethStatistics.h"
+
+#include "virtualBoard.h"
+#include "loadProbe.h"
+
+using namespace ethLoadBench;
+
+
+namespace {
+
+    // the prefix of the line by which the emitter tells what it has sent
+    const char *resultTag = "ethLoadBench-emitter:";
+
+    const uint16_t defaultPort = 12345;
+
+    eOipv4addr_t hostAddress()
+    {
+        return eo_common_ipv4addr(127, 0, 0, 1);
+    }
+
+    // the board k takes the place k-1 in EthBoards
+    eOipv4addr_t boardAddress(int k)
+    {
+        return eo_common_ipv4addr(127, 0, 1, k);
+    }
+
+    // the option may be a number or a list of numbers
+    std::vector<int> toList(yarp::os::Searchable &opt, const std::string &key, const std::string &defaults)
+    {
+        yarp::os::Bottle b(defaults);
+        const yarp::os::Value &v = opt.check(key) ? opt.find(key) : b.get(0);
+        std::vector<int> list;
+        if(v.isList())
+        {
+            for(size_t i=0; i<v.asList()->size(); i++)
+            {
+                list.push_back(v.asList()->get(i).asInt32());
+            }
+        }
+        else
+        {
+            list.push_back(v.asInt32());
+        }
+        return list;
+    }
+
+    Payload readPayload(yarp::os::Searchable &opt)
+    {
+        Payload p;
+        p.joints = opt.check("joints", yarp::os::Value(4)).asInt32();
+        p.fts = opt.check("fts", yarp::os::Value(0)).asInt32();
+        p.skinframes = opt.check("skin", yarp::os::Value(0)).asInt32();
+        p.imuitems = opt.check("imu", yarp::os::Value(0)).asInt32();
+        return p;
+    }
+
+    // [sec] of cpu used by the whole process
+    double cpuTime()
+    {
+        struct rusage ru;
+        getrusage(RUSAGE_SELF, &ru);
+        return (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) + 1e-6*(ru.ru_utime.tv_usec + ru.ru_stime.tv_usec);
+    }
+
+    double seconds(uint64_t ns)
+    {
+        return 1e-9*ns;
+    }
+
+    void sleepUntil(uint64_t ns)
+    {
+        struct timespec ts;
+        ts.tv_sec = ns / 1000000000ULL;
+        ts.tv_nsec = ns % 1000000000ULL;
+        while(EINTR == clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr)) {}
+    }
+
+    void merge(eth::EthRXstatistics::Histogram &into, const eth::EthRXstatistics::Histogram &from)
+    {
+        for(int i=0; i<eth::EthRXstatistics::numberofbins; i++)
+        {
+            into.bins[i] += from.bins[i];
+        }
+        into.count += from.count;
+        into.sum += from.sum;
+        into.max = std::max(into.max, from.max);
+    }
+
+    // the upper edge of the bin which holds the q-th quantile, never beyond the max
+    double percentile(const eth::EthRXstatistics::Histogram &h, double q)
+    {
+        if(0 == h.count)
+        {
+            return 0;
+        }
+        uint64_t target = static_cast<uint64_t>(std::ceil(q*h.count));
+        uint64_t sum = 0;
+        for(int i=0; i<eth::EthRXstatistics::numberofbins-1; i++)
+        {
+            sum += h.bins[i];
+            if(sum >= target)
+            {
+                return std::min(static_cast<double>(1ULL << i), static_cast<double>(h.max));
+            }
+        }
+        return static_cast<double>(h.max);
+    }
+
+    // the configuration of a board as embObjMotionControl and the other devices receive it from the xml files
+    std::string boardConfig(int k, yarp::os::Searchable &opt)
+    {
+        char ip[20];
+        eo_common_ipv4addr_to_string(boardAddress(k), ip, sizeof(ip));
+        int port = opt.check("port", yarp::os::Value(defaultPort)).asInt32();
+
+        std::string cfg;
+        cfg += "(PC104 (PC104IpAddress \"127.0.0.1\") (PC104IpPort " + std::to_string(port) + ") (PC104TXrate 1)";
+        cfg += " (PC104RXrate " + std::to_string(opt.check("rxrate", yarp::os::Value(1)).asInt32()) + ")";
+        cfg += " (PC104RXmode " + opt.check("rxmode", yarp::os::Value("periodic")).asString() + ")";
+        cfg += " (PC104RXshards " + std::to_string(opt.check("rxshards", yarp::os::Value(1)).asInt32()) + ")";
+        cfg += " (PC104RXcore " + std::to_string(opt.check("rxcore", yarp::os::Value(-1)).asInt32()) + ")";
+        cfg += " (PC104BringUpWorkers 0))";
+        cfg += " (ETH_BOARD";
+        cfg += " (ETH_BOARD_PROPERTIES (IpAddress \"" + std::string(ip) + "\") (IpPort " + std::to_string(port) + ") (Type EMS4)";
+        cfg += " (maxSizeRXpacket 768) (maxSizeROP " + std::to_string(opt.check("maxSizeROP", yarp::os::Value(384)).asInt32()) + "))";
+        cfg += " (ETH_BOARD_SETTINGS (Name \"virtual-" + std::to_string(k) + "\"))";
+        cfg += " (ETH_BOARD_ACTIONS (MONITOR_ITS_PRESENCE (enabled false))))";
+        return cfg;
+    }
+
+
+    // --emit: the virtual boards. they send for the duration and then print what they have sent
+    int emit(yarp::os::Searchable &opt)
+    {
+        int numberofboards = opt.check("boards", yarp::os::Value(1)).asInt32();
+        double rate = opt.check("rate", yarp::os::Value(1000)).asFloat64();
+        double duration = opt.check("duration", yarp::os::Value(5)).asFloat64();
+        uint16_t maxsizeofrop = opt.check("maxSizeROP", yarp::os::Value(384)).asInt32();
+        eOipv4addressing_t host;
+        host.addr = hostAddress();
+        host.port = opt.check("port", yarp::os::Value(defaultPort)).asInt32();
+        Payload payload = readPayload(opt);
+
+        // it initialises the embobj system. TheEthManager opens nothing before the first requestResource2()
+        eth::TheEthManager::instance();
+
+        std::vector<std::unique_ptr<VirtualBoard>> boards;
+        for(int k=1; k<=numberofboards; k++)
+        {
+            boards.emplace_back(new VirtualBoard);
+            if(false == boards.back()->init(boardAddress(k), host, payload, maxsizeofrop, eth::TheEthManager::maxRXpacketsize))
+            {
+                fprintf(stderr, "ethLoadBench: the virtual board %d cannot start: %s\n", k, boards.back()->getLastError().c_str());
+                return 1;
+            }
+        }
+
+        // the boards are spread over the period, as real boards which are not synchronised
+        const uint64_t period = static_cast<uint64_t>(1e9/rate);
+        const uint64_t start = monotonicNow() + 10000000ULL;
+        const uint64_t end = start + static_cast<uint64_t>(1e9*duration);
+        std::vector<uint64_t> due(numberofboards);
+        for(int k=0; k<numberofboards; k++)
+        {
+            due[k] = start + (period*k)/numberofboards;
+        }
+
+        double cpu0 = cpuTime();
+        uint64_t late = 0;
+        for(;;)
+        {
+            size_t k = std::min_element(due.begin(), due.end()) - due.begin();
+            if(due[k] >= end)
+            {
+                break;
+            }
+            sleepUntil(due[k]);
+            if(monotonicNow() > (due[k] + period))
+            {
+                late++;
+            }
+            boards[k]->send();
+            due[k] += period;
+        }
+        double cpu = cpuTime() - cpu0;
+        double elapsed = seconds(monotonicNow() - start);
+
+        VirtualBoard::Counters total;
+        for(const auto &b : boards)
+        {
+            total.frames += b->getCounters().frames;
+            total.bytes += b->getCounters().bytes;
+            total.failures += b->getCounters().failures;
+        }
+
+        printf("%s frames %llu bytes %llu failures %llu late %llu cpu %.6f elapsed %.6f\n", resultTag,
+               static_cast<unsigned long long>(total.frames), static_cast<unsigned long long>(total.bytes),
+               static_cast<unsigned long long>(total.failures), static_cast<unsigned long long>(late), cpu, elapsed);
+        fflush(stdout);
+        return 0;
+    }
+
+
+    struct Emitted
+    {
+        unsigned long long frames {0};
+        unsigned long long bytes {0};
+        unsigned long long failures {0};
+        unsigned long long late {0};
+        double cpu {0};
+        double elapsed {0};
+    };
+
+    bool runEmitter(const std::string &command, Emitted &emitted)
+    {
+        FILE *pipe = popen(command.c_str(), "r");
+        if(nullptr == pipe)
+        {
+            return false;
+        }
+
+        bool found = false;
+        char line[512];
+        size_t taglen = strlen(resultTag);
+        while(nullptr != fgets(line, sizeof(line), pipe))
+        {
+            if(0 == strncmp(line, resultTag, taglen))
+            {
+                found = (6 == sscanf(line + taglen, " frames %llu bytes %llu failures %llu late %llu cpu %lf elapsed %lf",
+                                     &emitted.frames, &emitted.bytes, &emitted.failures, &emitted.late, &emitted.cpu, &emitted.elapsed));
+            }
+        }
+
+        return (0 == pclose(pipe)) && found;
+    }
+
+
+    // the host: the stack of the robot interface w/ the probes in place of the devices
+    int drive(yarp::os::Searchable &opt)
+    {
+        std::vector<int> boardsList = toList(opt, "boards", "(1 4 8 16 32)");
+        std::vector<int> rateList = toList(opt, "rate", "(1000)");
+        double duration = opt.check("duration", yarp::os::Value(5)).asFloat64();
+        Payload payload = readPayload(opt);
+
+        int maxnumberofboards = *std::max_element(boardsList.begin(), boardsList.end());
+        if((maxnumberofboards < 1) || (maxnumberofboards > eth::TheEthManager::maxBoards) || (*std::min_element(boardsList.begin(), boardsList.end()) < 1))
+        {
+            yError() << "ethLoadBench: the number of boards must be in [ 1," << eth::TheEthManager::maxBoards << "] because a board is identified by the last byte of its address";
+            return 1;
+        }
+        if(0 == payload.rops())
+        {
+            yError() << "ethLoadBench: the virtual boards have nothing to send";
+            return 1;
+        }
+
+        char self[1024] = {0};
+        if(readlink("/proc/self/exe", self, sizeof(self)-1) <= 0)
+        {
+            yError() << "ethLoadBench: cannot find its own executable, which runs the virtual boards";
+            return 1;
+        }
+
+        FILE *csv = nullptr;
+        if(opt.check("csv"))
+        {
+            csv = fopen(opt.find("csv").asString().c_str(), "w");
+            if(nullptr == csv)
+            {
+                yError() << "ethLoadBench: cannot create" << opt.find("csv").asString();
+                return 1;
+            }
+            fprintf(csv, "boards,rate,rops,sent,received,lost,drop,disordered,late,cpu,cpuperframe,parsemean,parsep99,parsemax,latencymean,latencyp99,latencymax\n");
+        }
+
+        eth::TheEthManager *ethManager = eth::TheEthManager::instance();
+        ethManager->enableRXstatistics(true);
+
+        // one probe for every kind of the payload of every board. they are deleted only after TheEthManager
+        std::vector<std::unique_ptr<LoadProbe>> probes;
+        for(int k=1; k<=maxnumberofboards; k++)
+        {
+            yarp::os::Property cfg;
+            cfg.fromString(boardConfig(k, opt));
+            for(int i=0; i<numberOfKinds; i++)
+            {
+                Kind kind = static_cast<Kind>(i);
+                if(0 == payload.rops(kind))
+                {
+                    continue;
+                }
+                probes.emplace_back(new LoadProbe(toIethresType(kind), stampOffset(kind)));
+                if(nullptr == ethManager->requestResource2(probes.back().get(), cfg))
+                {
+                    yError() << "ethLoadBench: cannot create the resource of the virtual board" << k;
+                    eth::TheEthManager::killYourself();
+                    return 1;
+                }
+            }
+        }
+        size_t probesperboard = probes.size() / maxnumberofboards;
+
+        // the cpu of the threads of the host w/out traffic
+        double cpu0 = cpuTime();
+        double time0 = seconds(monotonicNow());
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        double idle = (cpuTime() - cpu0) / (seconds(monotonicNow()) - time0);
+
+        printf("\nethLoadBench: %d joints, %d fts, %d skin frames, %d imu items per frame. the host uses %.2f%% of a core when idle\n\n",
+               payload.joints, payload.fts, payload.skinframes, payload.imuitems, 100.0*idle);
+        printf("%6s %6s %4s | %9s %9s %7s %7s %5s %5s | %7s %9s | %31s | %31s\n", "boards", "rate", "rops", "sent", "received", "lost",
+               "drop%", "disor", "late", "cpu%", "us/frame", "parsing [us] mean p99 max", "latency [us] mean p99 max");
+
+        int ret = 0;
+        for(int numberofboards : boardsList)
+        {
+            for(int rate : rateList)
+            {
+                eth::EthRXstatistics::Board b;
+                LoadProbe::Counters c;
+                for(int k=1; k<=maxnumberofboards; k++)
+                {
+                    ethManager->getRXstatistics(boardAddress(k), b, true);
+                }
+                for(auto &p : probes)
+                {
+                    p->get(c, true);
+                }
+
+                std::string command = std::string("'") + self + "' --emit --boards " + std::to_string(numberofboards) +
+                                      " --rate " + std::to_string(rate) + " --duration " + std::to_string(duration) +
+                                      " --joints " + std::to_string(payload.joints) + " --fts " + std::to_string(payload.fts) +
+                                      " --skin " + std::to_string(payload.skinframes) + " --imu " + std::to_string(payload.imuitems) +
+                                      " --maxSizeROP " + std::to_string(opt.check("maxSizeROP", yarp::os::Value(384)).asInt32()) +
+                                      " --port " + std::to_string(opt.check("port", yarp::os::Value(defaultPort)).asInt32());
+
+                Emitted emitted;
+                cpu0 = cpuTime();
+                time0 = seconds(monotonicNow());
+                bool ok = runEmitter(command, emitted);
+                // the last frames are still in the socket
+                std::this_thread::sleep_for(std::chrono::milliseconds(200));
+                double cpu = cpuTime() - cpu0;
+                double wall = seconds(monotonicNow()) - time0;
+
+                if(false == ok)
+                {
+                    yError() << "ethLoadBench: the virtual boards have failed for" << numberofboards << "boards at" << rate << "Hz";
+                    ret = 1;
+                    break;
+                }
+
+                uint64_t received = 0;
+                uint64_t lost = 0;
+                uint64_t disordered = 0;
+                eth::EthRXstatistics::Histogram parsing;
+                eth::EthRXstatistics::Histogram latency;
+                parsing.reset();
+                latency.reset();
+                for(int k=1; k<=numberofboards; k++)
+                {
+                    if(true == ethManager->getRXstatistics(boardAddress(k), b, false))
+                    {
+                        received += b.frames;
+                        lost += b.lost;
+                        disordered += b.disordered;
+                        merge(parsing, b.parsing);
+                    }
+                }
+                for(size_t i=0; i<numberofboards*probesperboard; i++)
+                {
+                    probes[i]->get(c, false);
+                    merge(latency, c.latency);
+                }
+
+                double drop = (emitted.frames > 0) ? (100.0*(emitted.frames - std::min<uint64_t>(received, emitted.frames)))/emitted.frames : 0.0;
+                double rxcpu = std::max(0.0, cpu - idle*wall);
+                double cpupercent = 100.0*rxcpu/wall;
+                double cpuperframe = (received > 0) ? (1e6*rxcpu/received) : 0.0;
+
+                printf("%6d %6d %4d | %9llu %9llu %7llu %7.3f %5llu %5llu | %7.2f %9.2f | %9.1f %10.0f %10.0f | %9.1f %10.0f %10.0f\n",
+                       numberofboards, rate, payload.rops(), emitted.frames, static_cast<unsigned long long>(received),
+                       static_cast<unsigned long long>(lost), drop, static_cast<unsigned long long>(disordered), emitted.late,
+                       cpupercent, cpuperframe,
+                       parsing.mean(), percentile(parsing, 0.99), static_cast<double>(parsing.max),
+                       latency.mean(), percentile(latency, 0.99), static_cast<double>(latency.max));
+                fflush(stdout);
+
+                if(nullptr != csv)
+                {
+                    fprintf(csv, "%d,%d,%d,%llu,%llu,%llu,%.3f,%llu,%llu,%.3f,%.3f,%.3f,%.0f,%llu,%.3f,%.0f,%llu\n",
+                            numberofboards, rate, payload.rops(), emitted.frames, static_cast<unsigned long long>(received),
+                            static_cast<unsigned long long>(lost), drop, static_cast<unsigned long long>(disordered), emitted.late,
+                            cpupercent, cpuperframe,
+                            parsing.mean(), percentile(parsing, 0.99), static_cast<unsigned long long>(parsing.max),
+                            latency.mean(), percentile(latency, 0.99), static_cast<unsigned long long>(latency.max));
+                    fflush(csv);
+                }
+            }
+            if(0 != ret)
+            {
+                break;
+            }
+        }
+
+        if(nullptr != csv)
+        {
+            fclose(csv);
+        }
+
+        // the resources are not released: releaseResource2() stops the services of the boards, and waits for their answers
+        eth::TheEthManager::killYourself();
+        return ret;
+    }
+}
+
+
+int main(int argc, char *argv[])
+{
+    yarp::os::Network yarp;
+
+    yarp::os::ResourceFinder rf;
+    rf.configure(argc, argv);
+
+    if(rf.check("help"))
+    {
+        printf("ethLoadBench [--boards (n1 n2 ...)] [--rate (r1 r2 ...)] [--duration sec] [--joints j] [--fts f] [--skin s] [--imu i]\n");
+        printf("             [--maxSizeROP m] [--port p] [--rxrate ms] [--rxmode periodic|event] [--rxshards n] [--rxcore c] [--csv file]\n");
+        return 0;
+    }
+
+    if(rf.check("emit"))
+    {
+        return emit(rf);
+    }
+
+    return drive(rf);
+}
+
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
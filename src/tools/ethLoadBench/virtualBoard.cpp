@@ -0,0 +1,345 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+
+#include "virtualBoard.h"
+#include "loadProbe.h"
+
+#include <cerrno>
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "EOtransceiver.h"
+#include "EOpacket.h"
+#include "EOrop.h"
+#include "EOarray.h"
+#include "EoProtocolMC.h"
+#include "EoProtocolAS.h"
+#include "EoProtocolSK.h"
+
+
+namespace {
+
+    // the head of a ROP w/out signature and time. the data follows it
+    constexpr uint16_t ropheadsize = 8;
+
+    // the head of the EOarray which the skin and the inertial3 carry
+    constexpr size_t arrayheadsize = 4;
+
+    constexpr size_t stampsize = sizeof(uint64_t);
+
+    std::string toString(eOipv4addr_t ipv4)
+    {
+        char str[20];
+        eo_common_ipv4addr_to_string(ipv4, str, sizeof(str));
+        return str;
+    }
+
+    struct sockaddr_in toSockaddr(eOipv4addr_t ipv4, uint16_t port)
+    {
+        uint8_t ip1, ip2, ip3, ip4;
+        eo_common_ipv4addr_to_decimal(ipv4, &ip1, &ip2, &ip3, &ip4);
+        struct sockaddr_in sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sin_family = AF_INET;
+        sa.sin_addr.s_addr = htonl((ip1 << 24) | (ip2 << 16) | (ip3 << 8) | (ip4));
+        sa.sin_port = htons(port);
+        return sa;
+    }
+}
+
+
+int ethLoadBench::Payload::rops(Kind kind) const
+{
+    switch(kind)
+    {
+        case Kind::mc:      return joints;
+        case Kind::ft:      return fts;
+        case Kind::skin:    return (skinframes > 0) ? 1 : 0;
+        case Kind::imu:     return (imuitems > 0) ? 1 : 0;
+    }
+    return 0;
+}
+
+int ethLoadBench::Payload::rops() const
+{
+    return rops(Kind::mc) + rops(Kind::ft) + rops(Kind::skin) + rops(Kind::imu);
+}
+
+eth::iethresType_t ethLoadBench::toIethresType(Kind kind)
+{
+    switch(kind)
+    {
+        case Kind::mc:      return eth::iethres_motioncontrol;
+        case Kind::ft:      return eth::iethres_analogft;
+        case Kind::skin:    return eth::iethres_skin;
+        case Kind::imu:     return eth::iethres_analoginertial3;
+    }
+    return eth::iethres_none;
+}
+
+size_t ethLoadBench::stampOffset(Kind kind)
+{
+    // the stamp is in the first item of the arrays
+    switch(kind)
+    {
+        case Kind::skin:    return arrayheadsize;
+        case Kind::imu:     return offsetof(eOas_inertial3_status_t, arrayofdata) + arrayheadsize;
+        default:            return 0;
+    }
+}
+
+const char * ethLoadBench::toString(Kind kind)
+{
+    static const char * names[numberOfKinds] = { "mc", "ft", "skin", "imu" };
+    return names[static_cast<uint8_t>(kind)];
+}
+
+
+ethLoadBench::VirtualBoard::VirtualBoard()
+: boardnumber(0), hosttxrx(nullptr), txrx(nullptr), socketfd(-1)
+{
+    memset(&nvsetbrdconfig, 0, sizeof(nvsetbrdconfig));
+    memset(&destination, 0, sizeof(destination));
+}
+
+ethLoadBench::VirtualBoard::~VirtualBoard()
+{
+    if(socketfd >= 0)
+    {
+        ::close(socketfd);
+    }
+    if(nullptr != hosttxrx)
+    {
+        eo_hosttransceiver_Delete(hosttxrx);
+    }
+}
+
+bool ethLoadBench::VirtualBoard::init(eOipv4addr_t address, const eOipv4addressing_t &host, const Payload &payload, uint16_t maxsizeofrop, uint16_t maxsizeofframe)
+{
+    // as the HostTransceiver, the number of the board in the protocol is the last byte of its address
+    uint8_t ip4 = 0;
+    eo_common_ipv4addr_to_decimal(address, NULL, NULL, NULL, &ip4);
+    boardnumber = ip4;
+    addressstring = ::toString(address);
+    destination = host;
+
+    if(eores_OK != eoprot_config_board_reserve(boardnumber))
+    {
+        lasterror = "the protocol cannot reserve board " + std::to_string(boardnumber);
+        return false;
+    }
+
+    // a transceiver as the one of the HostTransceiver but w/ the capacities of the board, which sends only occasionals
+    eOhosttransceiver_cfg_t cfg;
+    memcpy(&cfg, &eo_hosttransceiver_cfg_default, sizeof(eOhosttransceiver_cfg_t));
+    cfg.remoteboardipv4addr = host.addr;
+    cfg.remoteboardipv4port = host.port;
+    cfg.sizes.capacityoftxpacket            = maxsizeofframe;
+    cfg.sizes.capacityofrop                 = maxsizeofrop;
+    cfg.sizes.capacityofropframeregulars    = eo_ropframe_sizeforZEROrops;
+    cfg.sizes.capacityofropframereplies     = eo_ropframe_sizeforZEROrops;
+    cfg.sizes.capacityofropframeoccasionals = (maxsizeofframe - eo_ropframe_sizeforZEROrops) - cfg.sizes.capacityofropframeregulars - cfg.sizes.capacityofropframereplies;
+    cfg.sizes.maxnumberofregularrops        = 0;
+
+    memcpy(&nvsetbrdconfig, &eonvset_BRDcfgMax, sizeof(eOnvset_BRDcfg_t));
+    nvsetbrdconfig.boardnum = boardnumber;
+    cfg.nvsetbrdcfg = &nvsetbrdconfig;
+    cfg.mutex_fn_new = NULL;
+    cfg.transprotection = eo_trans_protection_none;
+    cfg.nvsetprotection = eo_nvset_protection_none;
+
+    hosttxrx = eo_hosttransceiver_New(&cfg);
+    txrx = (nullptr == hosttxrx) ? nullptr : eo_hosttransceiver_GetTransceiver(hosttxrx);
+    if(nullptr == txrx)
+    {
+        lasterror = "the transceiver cannot be created";
+        return false;
+    }
+
+    // the variables of the payload
+    for(int j=0; j<payload.joints; j++)
+    {
+        if(false == addVariable(Kind::mc, eoprot_ID_get(eoprot_endpoint_motioncontrol, eoprot_entity_mc_joint, j, eoprot_tag_mc_joint_status_core), 0, maxsizeofrop))
+        {
+            return false;
+        }
+    }
+    for(int f=0; f<payload.fts; f++)
+    {
+        if(false == addVariable(Kind::ft, eoprot_ID_get(eoprot_endpoint_analogsensors, eoprot_entity_as_ft, f, eoprot_tag_as_ft_status_timedvalue), 0, maxsizeofrop))
+        {
+            return false;
+        }
+    }
+    if(payload.skinframes > 0)
+    {
+        if(false == addVariable(Kind::skin, eoprot_ID_get(eoprot_endpoint_skin, eoprot_entity_sk_skin, 0, eoprot_tag_sk_skin_status_arrayofcandata), payload.skinframes, maxsizeofrop))
+        {
+            return false;
+        }
+    }
+    if(payload.imuitems > 0)
+    {
+        if(false == addVariable(Kind::imu, eoprot_ID_get(eoprot_endpoint_analogsensors, eoprot_entity_as_inertial3, 0, eoprot_tag_as_inertial3_status), payload.imuitems, maxsizeofrop))
+        {
+            return false;
+        }
+    }
+
+    size_t framesize = eo_ropframe_sizeforZEROrops;
+    for(const auto &v : variables)
+    {
+        framesize += ropheadsize + v.data.size();
+    }
+    if(framesize > maxsizeofframe)
+    {
+        lasterror = "the ROPs of the payload need " + std::to_string(framesize) + " bytes but a frame has " + std::to_string(maxsizeofframe);
+        return false;
+    }
+
+    // the socket has the address of the board, hence the host recognises the board from where the frames come
+    socketfd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if(socketfd < 0)
+    {
+        lasterror = std::string("socket() fails: ") + strerror(errno);
+        return false;
+    }
+    struct sockaddr_in local = toSockaddr(address, host.port);
+    if(0 != ::bind(socketfd, reinterpret_cast<struct sockaddr*>(&local), sizeof(local)))
+    {
+        lasterror = "bind() to " + addressstring + " fails: " + strerror(errno);
+        return false;
+    }
+
+    return true;
+}
+
+bool ethLoadBench::VirtualBoard::addVariable(Kind kind, eOprotID32_t id32, int items, uint16_t maxsizeofrop)
+{
+    if(eobool_false == eoprot_id_isvalid(boardnumber, id32))
+    {
+        char nvinfo[128];
+        eoprot_ID2information(id32, nvinfo, sizeof(nvinfo));
+        lasterror = std::string("the protocol of the board has not the variable ") + nvinfo;
+        return false;
+    }
+
+    uint16_t size = eoprot_variable_sizeof_get(boardnumber, id32);
+    if((ropheadsize + size) > maxsizeofrop)
+    {
+        lasterror = std::string("a ROP of ") + toString(kind) + " needs " + std::to_string(ropheadsize + size) + " bytes but maxSizeROP is " + std::to_string(maxsizeofrop);
+        return false;
+    }
+
+    variables.emplace_back();
+    Variable &v = variables.back();
+    v.id32 = id32;
+    v.stamp = stampOffset(kind);
+    v.data.assign(size, 0);
+
+    if((Kind::skin == kind) || (Kind::imu == kind))
+    {
+        size_t arrayoffset = stampOffset(kind) - arrayheadsize;
+        size_t arraysize = (Kind::skin == kind) ? size : sizeof(static_cast<eOas_inertial3_status_t*>(nullptr)->arrayofdata);
+        size_t itemsize = (Kind::skin == kind) ? sizeof(eOsk_candata_t) : sizeof(eOas_inertial3_data_t);
+        size_t capacity = (arraysize - arrayheadsize) / itemsize;
+        if(capacity > 255)
+        {
+            capacity = 255;
+        }
+        if(static_cast<size_t>(items) > capacity)
+        {
+            lasterror = std::string("the ") + toString(kind) + " variable has room for " + std::to_string(capacity) + " items, not " + std::to_string(items);
+            return false;
+        }
+
+        EOarray *array = eo_array_New(static_cast<uint8_t>(capacity), static_cast<uint8_t>(itemsize), &v.data[arrayoffset]);
+        std::vector<uint8_t> item(itemsize, 0);
+        for(int i=0; i<items; i++)
+        {
+            eo_array_PushBack(array, item.data());
+        }
+    }
+
+    if((v.stamp + stampsize) > v.data.size())
+    {
+        lasterror = std::string("the ") + toString(kind) + " variable has no room for the stamp";
+        return false;
+    }
+
+    return true;
+}
+
+bool ethLoadBench::VirtualBoard::send()
+{
+    // the stamp is taken before the frame is formed, as a board would sample its data
+    uint64_t now = monotonicNow();
+
+    for(auto &v : variables)
+    {
+        memcpy(&v.data[v.stamp], &now, stampsize);
+
+        eOropdescriptor_t ropdesc = {0};
+        memcpy(&ropdesc, &eok_ropdesc_basic, sizeof(eOropdescriptor_t));
+        ropdesc.control.plustime    = 0;
+        ropdesc.control.plussign    = 0;
+        ropdesc.ropcode             = eo_ropcode_sig;
+        ropdesc.id32                = v.id32;
+        ropdesc.size                = 0;        // the size is internally computed from the id32
+        ropdesc.data                = v.data.data();
+        ropdesc.signature           = eo_rop_SIGNATUREdummy;
+
+        if(eores_OK != eo_transceiver_OccasionalROP_Load(txrx, &ropdesc))
+        {
+            counters.failures++;
+            return false;
+        }
+    }
+
+    uint16_t numberofrops = 0;
+    EOpacket *pkt = nullptr;
+    uint8_t *data = nullptr;
+    uint16_t size = 0;
+    if((eores_OK != eo_transceiver_outpacket_Prepare(txrx, &numberofrops, NULL)) ||
+       (eores_OK != eo_transceiver_outpacket_Get(txrx, &pkt)) ||
+       (eores_OK != eo_packet_Payload_Get(pkt, &data, &size)))
+    {
+        counters.failures++;
+        return false;
+    }
+
+    struct sockaddr_in to = toSockaddr(destination.addr, destination.port);
+    if(::sendto(socketfd, data, size, 0, reinterpret_cast<struct sockaddr*>(&to), sizeof(to)) != static_cast<ssize_t>(size))
+    {
+        counters.failures++;
+        return false;
+    }
+
+    counters.frames++;
+    counters.bytes += size;
+    return true;
+}
+
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
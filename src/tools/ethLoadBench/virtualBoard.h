@@ -0,0 +1,129 @@
+// -*- mode:C++; tab-width:4; c-basic-offset:4; indent-tabs-mode:nil -*-
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * website: www.robotcub.org
+ * Permission is granted to copy, distribute, and/or modify this program
+ * under the terms of the GNU General Public License, version 2 or any
+ * later version published by the Free Software Foundation.
+ *
+ * A copy of the license can be found at
+ * http://www.robotcub.org/icub/license/gpl.txt
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General
+ * Public License for more details
+*/
+
+// - include guard ----------------------------------------------------------------------------------------------------
+
+#ifndef _VIRTUALBOARD_H_
+#define _VIRTUALBOARD_H_
+
+// -- struct Payload
+// -- what a virtual board sends in each of its frames: the status of some joints, of some FT sensors, of a skin patch and of
+// -- an IMU, i.e. the regulars which embObjMotionControl, embObjMultipleFTsensors, embObjSkin and embObjIMU ask to the boards.
+// -- class VirtualBoard
+// -- it plays an ETH board in its running mode: every send() forms a ropframe with a sig<> ROP for every variable of its payload
+// -- and sends it to the host from the address of the board. the ropframe is formed by an embobj transceiver configured as the
+// -- one of the host, hence it has the same format and the same sequence numbers as the one of a real board. the first 8 bytes
+// -- of the items of every variable (see stampOffset()) carry the CLOCK_MONOTONIC time of the send(), for the LoadProbe.
+// -- it uses the protocol of the board with the same number in its own process, thus it cannot live in the process of the host.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "EoCommon.h"
+#include "EoProtocol.h"
+#include "EOhostTransceiver.h"
+
+#include "IethResource.h"
+
+
+namespace ethLoadBench {
+
+    enum class Kind : uint8_t { mc = 0, ft = 1, skin = 2, imu = 3 };
+    enum { numberOfKinds = 4 };
+
+    struct Payload
+    {
+        int joints {4};         // eoprot_tag_mc_joint_status_core of the joints 0 ... joints-1
+        int fts {0};            // eoprot_tag_as_ft_status_timedvalue of the FT sensors 0 ... fts-1
+        int skinframes {0};     // the can frames in eoprot_tag_sk_skin_status_arrayofcandata of the skin 0. 0 is no skin
+        int imuitems {0};       // the items in eoprot_tag_as_inertial3_status of the inertial3 0. 0 is no imu
+
+        // the ROPs of a frame of the given kind, and of all kinds
+        int rops(Kind kind) const;
+        int rops() const;
+    };
+
+    // the device which receives the variables of a kind
+    eth::iethresType_t toIethresType(Kind kind);
+
+    // the offset of the stamp inside the data of the variables of a kind
+    size_t stampOffset(Kind kind);
+
+    const char * toString(Kind kind);
+
+
+    class VirtualBoard
+    {
+    public:
+
+        struct Counters
+        {
+            uint64_t frames {0};        // the frames sent
+            uint64_t bytes {0};
+            uint64_t failures {0};      // the frames which could not be formed or sent
+        };
+
+        VirtualBoard();
+        ~VirtualBoard();
+
+        // address is the one of the board, from which it sends to the host. maxsizeofrop and maxsizeofframe are the properties
+        // maxSizeROP and the capacity of the tx packet of the board. it fails if the payload does not fit them
+        bool init(eOipv4addr_t address, const eOipv4addressing_t &host, const Payload &payload, uint16_t maxsizeofrop, uint16_t maxsizeofframe);
+
+        bool send();
+
+        const Counters & getCounters() const { return counters; }
+
+        const std::string & getLastError() const { return lasterror; }
+
+    private:
+
+        struct Variable
+        {
+            eOprotID32_t id32;
+            size_t stamp;
+            std::vector<uint8_t> data;
+        };
+
+        bool addVariable(Kind kind, eOprotID32_t id32, int items, uint16_t maxsizeofrop);
+
+        eOprotBRD_t boardnumber;
+        std::string addressstring;
+        EOhostTransceiver *hosttxrx;
+        EOtransceiver *txrx;
+        eOnvset_BRDcfg_t nvsetbrdconfig;
+        int socketfd;
+        eOipv4addressing_t destination;
+        std::vector<Variable> variables;
+        Counters counters;
+        std::string lasterror;
+
+        VirtualBoard(const VirtualBoard&) = delete;
+        VirtualBoard& operator=(const VirtualBoard&) = delete;
+    };
+
+} // namespace ethLoadBench
+
+
+#endif  // include-guard
+
+
+// - end-of-file (leave a blank line after)----------------------------------------------------------------------------
+
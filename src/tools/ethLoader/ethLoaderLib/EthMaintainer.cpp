@@ -659,15 +659,25 @@ bool EthMaintainer::isInApplication(eOipv4addr_t ipv4, EthBoardList &boardlist)
 }
 
 
-string EthMaintainer::processDiscoveryReplies2(EthBoardList &boardlist, double waittimeout)
+string EthMaintainer::processDiscoveryReplies2(EthBoardList &boardlist, double waittimeout, map<uint64_t, InventoryItem> *found, const set<eOipv4addr_t> *expected)
 {
     string info;
 
     eOipv4addr_t rxipv4addr;
     eOipv4port_t rxipv4port;
 
-    while(mSocket.ReceiveFrom(rxipv4addr, rxipv4port, mRxBuffer, sizeof(mRxBuffer), waittimeout*1000.0) > 0)
+    // when all the expected boards have replied, we wait only for some more which may reply at the same time
+    const double gracetimeout = 0.05;
+    size_t missing = (NULL == expected) ? 0 : expected->size();
+    set<eOipv4addr_t> arrived;
+
+    while(mSocket.ReceiveFrom(rxipv4addr, rxipv4port, mRxBuffer, sizeof(mRxBuffer), ((NULL != expected) && (0 == missing)) ? (gracetimeout*1000.0) : (waittimeout*1000.0)) > 0)
     {
+        if((NULL != expected) && (expected->count(rxipv4addr) > 0) && (arrived.insert(rxipv4addr).second))
+        {
+            missing--;
+        }
+
         eOuprot_cmd_DISCOVER_REPLY_t * disc = (eOuprot_cmd_DISCOVER_REPLY_t*) mRxBuffer;
         eOuprot_cmd_LEGACY_SCAN_REPLY_t * scan = (eOuprot_cmd_LEGACY_SCAN_REPLY_t*) mRxBuffer;
 
@@ -707,6 +717,13 @@ string EthMaintainer::processDiscoveryReplies2(EthBoardList &boardlist, double w
 
                 boardlist.add(binfo, rxipv4addr);
 
+                if(NULL != found)
+                {
+                    InventoryItem &item = (*found)[binfo.macaddress];
+                    item.ipv4 = rxipv4addr;
+                    item.info = binfo;
+                }
+
                 // now we add into the string
                 {
                     info += binfo.moreinfostring;
@@ -789,6 +806,13 @@ string EthMaintainer::processDiscoveryReplies2(EthBoardList &boardlist, double w
 
                 boardlist.add(binfo, rxipv4addr);
 
+                if(NULL != found)
+                {
+                    InventoryItem &item = (*found)[binfo.macaddress];
+                    item.ipv4 = rxipv4addr;
+                    item.info = binfo;
+                }
+
 
                 if(_verbose)
                 {
@@ -1176,22 +1200,70 @@ EthBoardList EthMaintainer::discover(bool clearbeforediscovery, int numberofdisc
     cmd->opc = uprot_OPC_LEGACY_SCAN;
     cmd->opc2 = uprot_OPC_DISCOVER;
     cmd->jump2updater = (true == forceUpdatingMode) ? (1) : (0);
+
+    // the boards of the former discovery: once they have all replied, we dont wait for the others any longer
+    set<eOipv4addr_t> expected;
+    for(map<uint64_t, InventoryItem>::iterator it = _inventory.begin(); it != _inventory.end(); ++it)
+    {
+        expected.insert(it->second.ipv4);
+    }
+
+    map<uint64_t, InventoryItem> found;
+    set<eOipv4addr_t> replied;
+
 #define ETH_MAINTAINER_DISCOVER_UNICASTMODE
     for(int i=0; i<numberofdiscoveries; i++)
     {
 #if defined(ETH_MAINTAINER_DISCOVER_UNICASTMODE)
-        eOipv4addr_t adr = EO_COMMON_IPV4ADDR(10, 0, 1, 99);
-        sendCommand(adr, cmd, sizeof(eOuprot_cmd_DISCOVER_t), list2use);
-        for(int i=1; i<=32; i++)
+        // the address of a board w/out a programmed one and then all the others. after the first round only who has not replied
+        vector<eOipv4addr_t> targets;
+        targets.push_back(EO_COMMON_IPV4ADDR(10, 0, 1, 99));
+        for(int n=1; n<=32; n++)
         {
-            adr = EO_COMMON_IPV4ADDR(10, 0, 1, i);
-            sendCommand(adr, cmd, sizeof(eOuprot_cmd_DISCOVER_t), list2use);
+            targets.push_back(EO_COMMON_IPV4ADDR(10, 0, 1, n));
+        }
+        for(int t=0; t<targets.size(); t++)
+        {
+            if(0 == replied.count(targets[t]))
+            {
+                sendCommand(targets[t], cmd, sizeof(eOuprot_cmd_DISCOVER_t), list2use);
+            }
         }
 #else
         sendCommand(ipv4Broadcast, cmd, sizeof(eOuprot_cmd_DISCOVER_t), list2use);
 #endif
 
-        processDiscoveryReplies2(*list2use, waittimeout);
+        processDiscoveryReplies2(*list2use, waittimeout, &found, (expected.empty()) ? (NULL) : (&expected));
+
+        for(map<uint64_t, InventoryItem>::iterator it = found.begin(); it != found.end(); ++it)
+        {
+            replied.insert(it->second.ipv4);
+        }
+
+        // a rescan is complete when all the known boards have replied
+        bool allreplied = !expected.empty();
+        for(set<eOipv4addr_t>::iterator it = expected.begin(); it != expected.end(); ++it)
+        {
+            allreplied = allreplied && (replied.count(*it) > 0);
+        }
+        if(allreplied)
+        {
+            break;
+        }
+    }
+
+    // the boards which have not replied are forgotten
+    _inventory = found;
+
+    if(_verbose)
+    {
+        int known = 0;
+        for(set<eOipv4addr_t>::iterator it = expected.begin(); it != expected.end(); ++it)
+        {
+            known += (replied.count(*it) > 0) ? 1 : 0;
+        }
+        printf("EthMaintainer::discover() has found %d boards, %d of the %d of the former discovery\n", (int)found.size(), known, (int)expected.size());
+        fflush(stdout);
     }
 
     return *list2use;
@@ -1217,6 +1289,11 @@ bool EthMaintainer::boards_clr(void)
     return true;
 }
 
+void EthMaintainer::inventory_clr(void)
+{
+    _inventory.clear();
+}
+
 bool EthMaintainer::boards_select(eOipv4addr_t ipv4, bool on)
 {
     _internalboardlist.select(on, ipv4);
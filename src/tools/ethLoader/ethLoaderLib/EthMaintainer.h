@@ -28,6 +28,8 @@
 #include "DSocket.h"
 #include "EthBoard.h"
 
+#include <map>
+#include <set>
 #include <vector>
 using namespace std;
 
@@ -106,6 +108,9 @@ public:
     // it removes the specified board(s). it can be a single value, ipv4Broadcast or ipv4OfAllSelected
     int boards_rem(eOipv4addr_t ipv4);
 
+    // it forgets the boards found by the former discoveries, hence the next discover() is a full one.
+    void inventory_clr(void);
+
 
     // in here there are complex operations which can group many methods such as discover() or the likes.
     // all these methods are self-organised and can be used as single command without the need to perform any discovery or else before.
@@ -116,6 +121,9 @@ public:
     // it does NOT attempt to send in maintenance, but old versions of eApplication jump to eUpddater when they receive the uprot_OPC_DISCOVER command.
     // if clearbeforediscovery is true, it clears the used boardlist.
     // then the uprot_OPC_DISCOVER command is sent numberofdiscoveries times (1 is enough) with a wait timeout of waittimeout seconds each.
+    // the requests of a round are all sent before any reply is collected, and a later round is sent only to the addresses which have
+    // not replied yet. the boards found are kept in an inventory keyed by MAC: a rescan stops waiting as soon as all of them have replied,
+    // it does not repeat the rounds for them, and it forgets those which do not reply anymore.
     // the returned EthBoardList is guaranteed to contain unique MAC addresses. if two boards have the same IP address but different MAC they are counted twice.
     EthBoardList discover(bool clearbeforediscovery = true, int numberofdiscoveries = 1, double waittimeout = 1.0);
 
@@ -217,7 +225,16 @@ protected:
     bool isInMaintenance(eOipv4addr_t ipv4, EthBoardList &boardlist);
     bool isInApplication(eOipv4addr_t ipv4, EthBoardList &boardlist);
 
-    string processDiscoveryReplies2(EthBoardList &boardlist, double waittimeout = 1.0);
+    // the board of a reply to uprot_OPC_DISCOVER
+    struct InventoryItem
+    {
+        eOipv4addr_t ipv4;
+        boardInfo2_t info;
+    };
+
+    // it waits the replies until none comes for waittimeout seconds. if found is not NULL the replying boards are also put inside it,
+    // and if expected is not NULL the wait is cut short as soon as all the addresses in expected have replied.
+    string processDiscoveryReplies2(EthBoardList &boardlist, double waittimeout = 1.0, map<uint64_t, InventoryItem> *found = NULL, const set<eOipv4addr_t> *expected = NULL);
 
     std::string processMoreInfoReplies(EthBoardList &boardlist);
 
@@ -259,6 +276,9 @@ protected:
     bool _useofinternalboardlist;
     EthBoardList _internalboardlist;
 
+    // the boards which have replied to the last discover(), keyed by MAC
+    map<uint64_t, InventoryItem> _inventory;
+
 
     unsigned char mRxBuffer[uprot_UDPmaxsize];
     unsigned char mTxBuffer[uprot_UDPmaxsize];
@@ -41,6 +41,20 @@ service fingersTuner_IDL
   * @return true/false on success/failure.
   */
   bool tune(1:string part, 2:Value val);
+
+  /**
+  * Tune PID of a set of joints, running concurrently
+  * the experiments of the joints that do not interfere
+  * through their idling joints.
+  * @param part specifies the part name as per
+  * configuration file.
+  * @param val accounts for a single joint if
+  * the corresponding integer is given or a set
+  * of joints if the corresponding alias is provided
+  * as defined within the configuration file.
+  * @return true/false on success/failure.
+  */
+  bool tune_parallel(1:string part, 2:Value val);
   
   /**
   * Save the PID parameters on configuration file.
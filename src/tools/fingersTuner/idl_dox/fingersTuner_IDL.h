@@ -40,6 +40,19 @@ public:
    * @return true/false on success/failure.
    */
   virtual bool tune(const std::string& part, const yarp::os::Value& val);
+  /**
+   * Tune PID of a set of joints, running concurrently
+   * the experiments of the joints that do not interfere
+   * through their idling joints.
+   * @param part specifies the part name as per
+   * configuration file.
+   * @param val accounts for a single joint if
+   * the corresponding integer is given or a set
+   * of joints if the corresponding alias is provided
+   * as defined within the configuration file.
+   * @return true/false on success/failure.
+   */
+  virtual bool tune_parallel(const std::string& part, const yarp::os::Value& val);
   /**
    * Save the PID parameters on configuration file.
    * @return true/false on success/failure.
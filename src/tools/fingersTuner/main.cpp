@@ -71,13 +71,20 @@ The option <b>idling</b> allows putting in idle specific coupled joints that
 should be not controlled in position during the tuning of the joint under
 subject.
 
+With <i>tune_parallel</i> the joints are tuned in batches whose experiments
+run concurrently: two joints go in different batches if one of them idles the
+other or if they idle the same joint. During the experiments of a batch, the
+relevant joints neither under tuning nor idle must stay at rest: if one of them
+moves by more than <b>interference_thres</b> degrees (5.0 by default, in the
+[general] group), the batch is stopped and its joints are tuned one at a time.
+
 \section portsif_sec Ports Interface
 The interface to this module is implemented through
 \ref fingersTuner_IDL . \n
 Be careful that from the console a yarp::os::Value must be typed
 by the user enclosed between parentheses, so that typical
-commands are <i>tune left_hand (12)</i> or <i>tune left_hand
-(index)</i>.
+commands are <i>tune left_hand (12)</i>, <i>tune left_hand
+(index)</i> or <i>tune_parallel left_hand (all)</i>.
 
 \section tested_os_sec Tested OS
 Windows, Linux
@@ -86,10 +93,12 @@ Windows, Linux
 */
 
 #include <cmath>
+#include <algorithm>
 #include <string>
 #include <sstream>
 #include <fstream>
 #include <vector>
+#include <deque>
 #include <map>
 
 #include <yarp/os/all.h>
@@ -147,6 +156,7 @@ protected:
 
     static unsigned int instances;
     bool interrupting;
+    double interference_thres;
     string name,robot,part,device;
     PolyDriver *driver;
 
@@ -249,26 +259,125 @@ protected:
     }
 
     /************************************************************************/
-    bool tune(const int i)
+    Property getDesignerOptions(const Bottle &bGeneral)
+    {
+        Bottle bPlantEstimation,bStictionEstimation;
+        bPlantEstimation.fromString("(plant_estimation (Ts 0.01) (Q 1.0) (R 1.0) (P0 100000.0) (tau 1.0) (K 1.0) (max_pwm 800.0))");
+        bStictionEstimation.fromString("(stiction_estimation (Ts 0.01) (T 2.0) (vel_thres 5.0) (e_thres 1.0) (gamma (10.0 10.0)) (stiction (0.0 0.0)))");
+
+        Bottle bConf=bGeneral;
+        bConf.append(bPlantEstimation);
+        bConf.append(bStictionEstimation);
+
+        return Property(bConf.toString().c_str());
+    }
+
+    /************************************************************************/
+    double designController(OnlineCompensatorDesign &designer, const int i,
+                            const Property &pResults)
     {
         PidData &pid=pids[i];
 
+        double tau=pResults.find("tau_mean").asFloat64();
+        double K=pResults.find("K_mean").asFloat64();
+        yInfo("plant of joint %d = %g/s * 1/(1+s*%g)",i,K,tau);
+
+        Property pControllerRequirements,pController;
+        pControllerRequirements.put("tau",tau);
+        pControllerRequirements.put("K",K);
+        pControllerRequirements.put("f_c",0.75);
+
+        if (i!=15)
+        {
+            pControllerRequirements.put("T_dr",1.0);
+            pControllerRequirements.put("type","PI");
+        }
+        else
+            pControllerRequirements.put("type","P");
+
+        designer.tuneController(pControllerRequirements,pController);
+        yInfo("tuning results of joint %d: %s",i,pController.toString().c_str());
+        double Kp=pController.find("Kp").asFloat64();
+        double Ki=pController.find("Ki").asFloat64();
+        pid.scale=4.0;
+        int scale=(int)pid.scale; int shift=1<<scale;
+        double fwKp=floor(Kp*pid.encs_ratio*shift);
+        double fwKi=floor(Ki*pid.encs_ratio*shift/1000.0);
+        pid.Kp=yarp::math::sign(pid.Kp*fwKp)>0.0?fwKp:-fwKp;
+        pid.Ki=yarp::math::sign(pid.Ki*fwKi)>0.0?fwKi:-fwKi;
+        pid.Kd=0.0;
+        yInfo("joint %d: Kp (FW) = %g; Ki (FW) = %g; Kd (FW) = %g; shift factor = %d",
+              i,pid.Kp,pid.Ki,pid.Kd,scale);
+
+        return Kp;
+    }
+
+    /************************************************************************/
+    void setStiction(const int i, const Property &pResults)
+    {
+        PidData &pid=pids[i];
+        pid.st_up=floor(pResults.find("stiction").asList()->get(0).asFloat64());
+        pid.st_down=floor(pResults.find("stiction").asList()->get(1).asFloat64());
+        yInfo("Stiction values of joint %d: up = %g; down = %g",i,pid.st_up,pid.st_down);
+    }
+
+    /************************************************************************/
+    bool driveBack(const vector<int> &joints)
+    {
+        IControlMode *imod;
+        IPositionControl *ipos;
+        IEncoders *ienc;
+        driver->view(imod);
+        driver->view(ipos);
+        driver->view(ienc);
+        for (size_t k=0; k<joints.size(); k++)
+        {
+            imod->setControlMode(joints[k],VOCAB_CM_POSITION);
+            ipos->setRefSpeed(joints[k],50.0);
+            ipos->positionMove(joints[k],0.0);
+        }
+        yInfo("Driving back to rest... ");
+        double t0=Time::now();
+        while (Time::now()-t0<5.0)
+        {
+            bool rest=true;
+            for (size_t k=0; k<joints.size(); k++)
+            {
+                double enc;
+                ienc->getEncoder(joints[k],&enc);
+                if (fabs(enc)>=1.0)
+                {
+                    rest=false;
+                    break;
+                }
+            }
+
+            if (rest)
+                break;
+
+            if (interrupting)
+                return false;
+
+            Time::delay(0.2);
+        }
+        yInfo("done!");
+
+        return true;
+    }
+
+    /************************************************************************/
+    bool tune(const int i)
+    {
         Property pGeneral;
         pGeneral.put("joint",i);
         string sGeneral="(general ";
         sGeneral+=pGeneral.toString();
         sGeneral+=')';
 
-        Bottle bGeneral,bPlantEstimation,bStictionEstimation;
+        Bottle bGeneral;
         bGeneral.fromString(sGeneral);
-        bPlantEstimation.fromString("(plant_estimation (Ts 0.01) (Q 1.0) (R 1.0) (P0 100000.0) (tau 1.0) (K 1.0) (max_pwm 800.0))");
-        bStictionEstimation.fromString("(stiction_estimation (Ts 0.01) (T 2.0) (vel_thres 5.0) (e_thres 1.0) (gamma (10.0 10.0)) (stiction (0.0 0.0)))");
-
-        Bottle bConf=bGeneral;
-        bConf.append(bPlantEstimation);
-        bConf.append(bStictionEstimation);
 
-        Property pOptions(bConf.toString().c_str());
+        Property pOptions=getDesignerOptions(bGeneral);
         OnlineCompensatorDesign designer;
         if (!designer.configure(*driver,pOptions))
         {
@@ -300,35 +409,7 @@ protected:
 
         Property pResults;
         designer.getResults(pResults);
-        double tau=pResults.find("tau_mean").asFloat64();
-        double K=pResults.find("K_mean").asFloat64();
-        yInfo("plant = %g/s * 1/(1+s*%g)",K,tau);
-
-        Property pControllerRequirements,pController;
-        pControllerRequirements.put("tau",tau);
-        pControllerRequirements.put("K",K);
-        pControllerRequirements.put("f_c",0.75);
-
-        if (i!=15)
-        {
-            pControllerRequirements.put("T_dr",1.0);
-            pControllerRequirements.put("type","PI");
-        }
-        else
-            pControllerRequirements.put("type","P");
-
-        designer.tuneController(pControllerRequirements,pController);
-        yInfo("tuning results: %s",pController.toString().c_str());
-        double Kp=pController.find("Kp").asFloat64();
-        double Ki=pController.find("Ki").asFloat64();
-        pid.scale=4.0;
-        int scale=(int)pid.scale; int shift=1<<scale;
-        double fwKp=floor(Kp*pid.encs_ratio*shift);
-        double fwKi=floor(Ki*pid.encs_ratio*shift/1000.0);
-        pid.Kp=yarp::math::sign(pid.Kp*fwKp)>0.0?fwKp:-fwKp;
-        pid.Ki=yarp::math::sign(pid.Ki*fwKi)>0.0?fwKi:-fwKi;
-        pid.Kd=0.0;
-        yInfo("Kp (FW) = %g; Ki (FW) = %g; Kd (FW) = %g; shift factor = %d",pid.Kp,pid.Ki,pid.Kd,scale);
+        double Kp=designController(designer,i,pResults);
 
         Property pStictionEstimation;
         pStictionEstimation.put("max_time",60.0);
@@ -353,45 +434,203 @@ protected:
         }
 
         designer.getResults(pResults);
-        pid.st_up=floor(pResults.find("stiction").asList()->get(0).asFloat64());
-        pid.st_down=floor(pResults.find("stiction").asList()->get(1).asFloat64());
-        yInfo("Stiction values: up = %g; down = %g",pid.st_up,pid.st_down);
+        setStiction(i,pResults);
 
-        IControlMode *imod;
-        IPositionControl *ipos;
+        bool ret=driveBack(vector<int>(1,i));
+        idlingCoupledJoints(i,false);
+        return ret;
+    }
+
+    /************************************************************************/
+    bool interfere(const int i, const int j)
+    {
+        // two joints interfere if one of them idles the other
+        // or if they idle the same joint
+        const vector<int> &idling_i=pids[i].idling_joints;
+        const vector<int> &idling_j=pids[j].idling_joints;
+        if (find(idling_i.begin(),idling_i.end(),j)!=idling_i.end())
+            return true;
+        if (find(idling_j.begin(),idling_j.end(),i)!=idling_j.end())
+            return true;
+        for (size_t k=0; k<idling_i.size(); k++)
+            if (find(idling_j.begin(),idling_j.end(),idling_i[k])!=idling_j.end())
+                return true;
+
+        return false;
+    }
+
+    /************************************************************************/
+    bool waitUntilDone(OnlineCompensatorDesignBank &bank,
+                       const map<int,double> &watched, bool &interference)
+    {
         IEncoders *ienc;
-        driver->view(imod);
-        driver->view(ipos);
         driver->view(ienc);
-        imod->setControlMode(i,VOCAB_CM_POSITION);
-        ipos->setRefSpeed(i,50.0);
-        ipos->positionMove(i,0.0);
-        yInfo("Driving the joint back to rest... ");
-        t0=Time::now();
-        while (Time::now()-t0<5.0)
+
+        double t0=Time::now();
+        for (int cnt=0; !bank.isDone(); cnt++)
         {
-            double enc;
-            ienc->getEncoder(i,&enc);
-            if (fabs(enc)<1.0)
-                break;
+            if (cnt%5==0)
+                yInfo("elapsed %d [s]",(int)(Time::now()-t0));
+            Time::delay(0.2);
 
             if (interrupting)
-            {
-                idlingCoupledJoints(i,false);
                 return false;
+
+            // the joints at rest must stay where they are
+            for (map<int,double>::const_iterator it=watched.begin(); it!=watched.end(); ++it)
+            {
+                double enc;
+                ienc->getEncoder(it->first,&enc);
+                if (fabs(enc-it->second)>interference_thres)
+                {
+                    yWarning("joint %d moved by %g [deg] while at rest",
+                             it->first,enc-it->second);
+                    interference=true;
+                    return false;
+                }
             }
+        }
 
-            Time::delay(0.2);
+        return true;
+    }
+
+    /************************************************************************/
+    bool tuneParallel(const vector<int> &batch, bool &interference)
+    {
+        interference=false;
+
+        Bottle bGeneral;
+        Bottle &bGroup=bGeneral.addList();
+        bGroup.addString("general");
+        Bottle &bJoints=bGroup.addList();
+        bJoints.addString("joints");
+        Bottle &bList=bJoints.addList();
+        for (size_t k=0; k<batch.size(); k++)
+            bList.addInt32(batch[k]);
+
+        Property pOptions=getDesignerOptions(bGeneral);
+        OnlineCompensatorDesignBank bank;
+        if (!bank.configure(*driver,pOptions))
+        {
+            yError("designers configuration failed!");
+            return false;
         }
-        yInfo("done!");
 
-        idlingCoupledJoints(i,false);
+        for (size_t k=0; k<batch.size(); k++)
+            idlingCoupledJoints(batch[k],true);
+
+        // the relevant joints neither tuned nor idle are kept at rest
+        IEncoders *ienc;
+        driver->view(ienc);
+        map<int,double> watched;
+        for (int l=0; l<rJoints.size(); l++)
+        {
+            int j=rJoints.get(l).asInt32();
+            bool busy=(find(batch.begin(),batch.end(),j)!=batch.end());
+            for (size_t k=0; (k<batch.size()) && !busy; k++)
+            {
+                const vector<int> &idling=pids[batch[k]].idling_joints;
+                busy=(find(idling.begin(),idling.end(),j)!=idling.end());
+            }
+
+            double enc;
+            if (!busy && ienc->getEncoder(j,&enc))
+                watched[j]=enc;
+        }
+
+        Property pPlantEstimation;
+        pPlantEstimation.put("max_time",20.0);
+        pPlantEstimation.put("switch_timeout",2.0);
+        bool ok=bank.startPlantEstimation(pPlantEstimation);
+
+        ostringstream sBatch;
+        for (size_t k=0; k<batch.size(); k++)
+            sBatch<<" "<<batch[k];
+        yInfo("Estimating plant for joints%s: max duration = %g seconds",
+              sBatch.str().c_str(),pPlantEstimation.find("max_time").asFloat64());
+
+        deque<Property> results;
+        vector<double> Kp(batch.size());
+        if (ok && (ok=waitUntilDone(bank,watched,interference)))
+        {
+            bank.getResults(results);
+            for (size_t k=0; k<batch.size(); k++)
+                Kp[k]=designController(bank[k],batch[k],results[k]);
+
+            // the stiction is estimated with the proportional gain of each joint
+            Bottle bStictionEstimation;
+            bStictionEstimation.fromString("(max_time 60.0) (Ki 0.0) (Kd 0.0)");
+            for (size_t k=0; k<batch.size(); k++)
+            {
+                ostringstream tag;
+                tag<<"joint_"<<batch[k];
+                Bottle &bJoint=bStictionEstimation.addList();
+                bJoint.addString(tag.str());
+                Bottle &bKp=bJoint.addList();
+                bKp.addString("Kp");
+                bKp.addFloat64(Kp[k]);
+            }
+
+            Property pStictionEstimation(bStictionEstimation.toString().c_str());
+            ok=bank.startStictionEstimation(pStictionEstimation);
+
+            yInfo("Estimating stiction for joints%s: max duration = %g seconds",
+                  sBatch.str().c_str(),pStictionEstimation.find("max_time").asFloat64());
+
+            if (ok && (ok=waitUntilDone(bank,watched,interference)))
+            {
+                bank.getResults(results);
+                for (size_t k=0; k<batch.size(); k++)
+                    setStiction(batch[k],results[k]);
+            }
+        }
+
+        bank.stopOperation();
+        if (!interrupting)
+            ok&=driveBack(batch);
+
+        for (size_t k=0; k<batch.size(); k++)
+            idlingCoupledJoints(batch[k],false);
+
+        return ok;
+    }
+
+    /************************************************************************/
+    bool getJoints(const Value &sel, Bottle &joints)
+    {
+        if (sel.isInt32())
+            joints.addInt32(sel.asInt32());
+        else if (sel.isString())
+        {
+            map<string,Bottle>::iterator it=alias.find(sel.asString());
+            if (it!=alias.end())
+                joints=it->second;
+            else
+                return false;
+        }
+        else
+            return false;
+
         return true;
     }
 
+    /************************************************************************/
+    void upload(const int j)
+    {
+        IPidControl *ipid;
+        driver->view(ipid);
+        Pid _pid;
+        ipid->getPid(VOCAB_PIDTYPE_POSITION,j,&_pid);
+
+        PidData &pid=pids[j];
+        pid.toRobot(_pid);
+        ipid->setPid(VOCAB_PIDTYPE_POSITION,j,_pid);
+        pid.status=synced;
+    }
+
 public:
     /************************************************************************/
-    Tuner() : interrupting(false), driver(NULL)
+    Tuner() : interrupting(false), interference_thres(5.0), driver(NULL)
     {
         instances++;
     }
@@ -423,6 +662,7 @@ public:
         name=bGeneral.check("name",Value("fingersTuner")).asString();
         robot=bGeneral.check("robot",Value("icub")).asString();
         double ping_robot_tmo=bGeneral.check("ping_robot_tmo",Value(0.0)).asFloat64();
+        interference_thres=bGeneral.check("interference_thres",Value(5.0)).asFloat64();
         device=bPart.find("device").asString();
 
         if (Bottle *rj=bGeneral.find("relevantJoints").asList())
@@ -521,37 +761,86 @@ public:
     bool tune(const Value &sel)
     {
         Bottle joints;
-        if (sel.isInt32())
-            joints.addInt32(sel.asInt32());
-        else if (sel.isString())
+        if (!getJoints(sel,joints))
+            return false;
+
+        for (int i=0; i<joints.size(); i++)
         {
-            map<string,Bottle>::iterator it=alias.find(sel.asString());
-            if (it!=alias.end())
-                joints=it->second;
-            else
+            int j=joints.get(i).asInt32();
+            if (pids.find(j)==pids.end())
+                continue;
+
+            if (tune(j))
+                upload(j);
+
+            if (interrupting)
                 return false;
         }
-        else
+
+        return true;
+    }
+
+    /************************************************************************/
+    bool tuneParallel(const Value &sel)
+    {
+        Bottle joints;
+        if (!getJoints(sel,joints))
             return false;
 
+        // greedy partition into batches of joints that do not interfere
+        vector<vector<int> > batches;
         for (int i=0; i<joints.size(); i++)
         {
             int j=joints.get(i).asInt32();
-            map<int,PidData>::iterator it=pids.find(j);
-            if (it==pids.end())
+            if (pids.find(j)==pids.end())
                 continue;
 
-            if (tune(j))
+            bool listed=false;
+            for (size_t b=0; (b<batches.size()) && !listed; b++)
+                listed=(find(batches[b].begin(),batches[b].end(),j)!=batches[b].end());
+            if (listed)
+                continue;
+
+            size_t b;
+            for (b=0; b<batches.size(); b++)
             {
-                IPidControl *ipid;
-                driver->view(ipid);
-                Pid _pid;
-                ipid->getPid(VOCAB_PIDTYPE_POSITION,j,&_pid);
+                size_t k;
+                for (k=0; k<batches[b].size(); k++)
+                    if (interfere(batches[b][k],j))
+                        break;
 
-                PidData &pid=it->second;
-                pid.toRobot(_pid);
-                ipid->setPid(VOCAB_PIDTYPE_POSITION,j,_pid);
-                pid.status=synced;
+                if (k>=batches[b].size())
+                    break;
+            }
+
+            if (b>=batches.size())
+                batches.push_back(vector<int>());
+            batches[b].push_back(j);
+        }
+
+        for (size_t b=0; b<batches.size(); b++)
+        {
+            vector<int> &batch=batches[b];
+            if (batch.size()==1)
+            {
+                if (tune(batch[0]))
+                    upload(batch[0]);
+            }
+            else
+            {
+                bool interference;
+                if (tuneParallel(batch,interference))
+                {
+                    for (size_t k=0; k<batch.size(); k++)
+                        upload(batch[k]);
+                }
+                else if (interference)
+                {
+                    yWarning("interference detected: tuning the joints one at a time");
+                    for (size_t k=0; (k<batch.size()) && !interrupting; k++)
+                        if (tune(batch[k]))
+                            upload(batch[k]);
+                }
             }
 
             if (interrupting)
@@ -719,6 +1008,17 @@ public:
         return false;
     }
 
+    /************************************************************************/
+    bool tune_parallel(const string &part, const Value &val)
+    {
+        map<string,Tuner*>::iterator it=tuners.find(part);
+        if (it!=tuners.end())
+            if (it->second->tuneParallel(val))
+                return true;
+
+        return false;
+    }
+
     /************************************************************************/
     bool save()
     {
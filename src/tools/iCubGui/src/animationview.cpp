@@ -43,6 +43,7 @@
 AnimationView::AnimationView(QWidget* parent) : QGLWidget(parent)
 {
     m_bInitialized=false;
+    mDataThread=NULL;
 
     // fake glut initialization
     int args=1;
@@ -96,10 +97,17 @@ void AnimationView::init(yarp::os::ResourceFinder& config)
     if (!pBVH->Create(config)){
         exit(-1);
     }
+
+    mDataThread=new DataThread(pBVH,mObjectsManager,mSubtitlesManager);
+    mDataThread->start();
 }
 
 AnimationView::~AnimationView()
 {
+    if (mDataThread){
+        mDataThread->stop();
+        delete mDataThread;
+    }
     if (mObjectsManager){
         delete mObjectsManager;
     }
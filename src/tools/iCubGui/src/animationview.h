@@ -25,6 +25,7 @@
 #include "bvh.h"
 #include "objectsthread.h"
 #include "subtitilessthread.h"
+#include "datathread.h"
 
 
 //#include "rotation.h"
@@ -77,7 +78,8 @@ signals:
 
     public slots:
         void resetCamera();
-        void timerTimeout(){ repaint(); }
+        // the frame is redrawn only if the data thread has received anything
+        void timerTimeout(){ if (!mDataThread || mDataThread->takeFresh()) repaint(); }
 
         protected slots:
             void draw();
@@ -108,6 +110,7 @@ protected:
     BVH* pBVH;
     ObjectsManager* mObjectsManager;
     SubtitlesManager* mSubtitlesManager;
+    DataThread* mDataThread;
 
     QPoint clickPos;           // holds the mouse click position for dragging
     QPoint returnPos;          // holds the mouse position to return to after dragging
@@ -29,6 +29,9 @@
 
 #include <yarp/sig/Vector.h>
 
+#include <mutex>
+#include <string.h>
+
 //#include <yarp/dev/IGenericSensor.h>
 //#include <yarp/dev/ControlBoardInterfaces.h>
 //#include <yarp/dev/PolyDriver.h>
@@ -64,8 +67,13 @@ public:
 
     QStringList partNames,bvhChannelName;
 
-    void draw()
+    // called by the data thread: reads the encoders in the buffer drawn by
+    // draw(), returns true if any port had new data
+    bool readEncoders()
     {
+        std::lock_guard<std::mutex> lock(mEncMutex);
+        bool bFresh=false;
+
         yarp::sig::Vector *enc =NULL;
         yarp::sig::Vector *encV=NULL;
 
@@ -75,6 +83,8 @@ public:
 
             while (enc=portEncBase.read(false)) encV=enc;
 
+            bFresh=bFresh||encV;
+
             if (encV) for (int i=0; i<6; ++i) dEncBase[i]=(*encV)[i];
 
             //mObjectsManager->readEncoders(dEncBase);
@@ -86,6 +96,8 @@ public:
 
             while (enc=portEncTorso.read(false)) encV=enc;
 
+            bFresh=bFresh||encV;
+
             if (encV) for (int i=0; i<nJTorso; ++i) dEncTorso[i]=(*encV)[i];
         }
 
@@ -95,6 +107,8 @@ public:
 
             while (enc=portEncHead.read(false)) encV=enc;
 
+            bFresh=bFresh||encV;
+
             if (encV)
             {
                 for (int i=0; i<nJHead; ++i) dEncHead[i]=(*encV)[i];
@@ -113,6 +127,8 @@ public:
 
             while (enc=portEncLeftArm.read(false)) encV=enc;
 
+            bFresh=bFresh||encV;
+
             if (encV) for (int i=0; i<nJLeftArm; ++i) dEncLeftArm[i]=(*encV)[i];
         }
 
@@ -122,6 +138,8 @@ public:
 
             while (enc=portEncRightArm.read(false)) encV=enc;
 
+            bFresh=bFresh||encV;
+
             if (encV) for (int i=0; i<nJRightArm; ++i) dEncRightArm[i]=(*encV)[i];
         }
 
@@ -131,6 +149,8 @@ public:
 
             while (enc=portEncLeftLeg.read(false)) encV=enc;
 
+            bFresh=bFresh||encV;
+
             if (encV) for (int i=0; i<nJLeftLeg; ++i) dEncLeftLeg[i]=(*encV)[i];
         }
 
@@ -140,9 +160,22 @@ public:
 
             while (enc=portEncRightLeg.read(false)) encV=enc;
 
+            bFresh=bFresh||encV;
+
             if (encV) for (int i=0; i<nJRightLeg; ++i) dEncRightLeg[i]=(*encV)[i];
         }
 
+        return bFresh;
+    }
+
+    void draw()
+    {
+        double dEncSnapshot[59];
+        {
+            std::lock_guard<std::mutex> lock(mEncMutex);
+            memcpy(dEncSnapshot,dEncBuffer,sizeof(dEncBuffer));
+        }
+
         glShadeModel(GL_SMOOTH);
         GLfloat ambientA[]={0.9,0.667,0.561,1};
         GLfloat diffuseA[]={0.9,0.667,0.561,0};
@@ -169,7 +202,7 @@ public:
         // visual compensation
         glTranslated(0.0,3.5,0.0);
 
-        pRoot->draw(dEncBuffer,NULL);
+        pRoot->draw(dEncSnapshot,NULL);
 
         glPopMatrix();
     }
@@ -209,6 +242,7 @@ public:
     yarp::os::BufferedPort<yarp::sig::Vector> portEncLeftLeg;
     yarp::os::BufferedPort<yarp::sig::Vector> portEncRightLeg;
 
+    std::mutex mEncMutex;
     double dEncBuffer[59];
     double *dEncTorso,*dEncHead,*dEncLeftArm,*dEncRightArm,*dEncLeftLeg,*dEncRightLeg,*dEncBase;
 };
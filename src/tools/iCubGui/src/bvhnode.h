@@ -38,6 +38,7 @@
 #include <QList>
 
 #include "mesh.h"
+#include "glshapes.h"
 
 #include <yarp/os/Network.h>
 #include <yarp/os/BufferedPort.h>
@@ -65,8 +66,6 @@ public:
             fm=mForceGain*f-20.0;
             if (fm<0.0) fm=0.0;
 
-            nFSec=2+int(0.005*fm);
-
             double a=fx*fx+fy*fy;
 
             if (a>0.0)
@@ -103,8 +102,6 @@ public:
             mm=mTorqueGain*m-20.0;
             if (mm<0.0) mm=0.0;
 
-            nTSec=2+int(0.005*mm);
-
             double a=mx*mx+my*my;
 
             if (a>0.0)
@@ -123,18 +120,10 @@ public:
                 maz=0.0;
             }
         }
-
-        gluQuadricDrawStyle(cyl=gluNewQuadric(),GLU_FILL);
-    }
-    ~ForceArrow()
-    {
-        if (cyl) gluDeleteQuadric(cyl);
     }
 
     void draw()
     {
-        if (!cyl) return;
-
         if (bForce)
         {
             glPushMatrix();
@@ -142,9 +131,9 @@ public:
             glTranslated(px,py,pz);
             glRotated(fth,fax,fay,faz);
             glTranslated(0.0,0.0,-20.0); // cone base
-            glutSolidCone(5.0,20.0,16,4);
+            GLShapes::cone(5.0,20.0);
             glTranslated(0.0,0.0,-fm);
-            gluCylinder(cyl,2.5,2.5,fm,16,nFSec);
+            GLShapes::tube(2.5,fm);
             glPopMatrix();
         }
 
@@ -155,9 +144,9 @@ public:
             glTranslated(px,py,pz);
             glRotated(mth,max,may,maz);
             glTranslated(0.0,0.0,-20.0); // cone base
-            glutSolidCone(5.0,20.0,16,4);
+            GLShapes::cone(5.0,20.0);
             glTranslated(0.0,0.0,-mm);
-            gluCylinder(cyl,2.5,2.5,mm,16,nTSec);
+            GLShapes::tube(2.5,mm);
             glPopMatrix();
         }
     }
@@ -171,10 +160,6 @@ public:
     }
 
 protected:
-    GLUquadricObj *cyl;
-
-    int nFSec,nTSec;
-
     double px,py,pz;
 
     double fm,fth,fax,fay,faz;
@@ -255,11 +240,8 @@ protected:
     virtual void drawJoint()
     {
         glTranslated(0.0,0.0,-12.7);
-        gluDisk(cyl,0.0,10.16,16,16);
-        gluCylinder(cyl,10.16,10.16,25.4,16,16);
-        glTranslated(0.0,0.0,25.4);
-        gluDisk(cyl,0.0,10.16,16,16);
-        glTranslated(0.0,0.0,-12.7);
+        GLShapes::cylinder(10.16,25.4);
+        glTranslated(0.0,0.0,12.7);
     }
 
     void drawArrows()
@@ -86,7 +86,7 @@ protected:
             glRotated(dOmega*dRad2Deg,0.0,0.0,1.0);
             glTranslated(-dRadius,0.0,0.0);
             glRotated(dNeg*90.0,1.0,0.0,0.0);
-            glutSolidCone(7.5,30.0,16,16);
+            GLShapes::cone(7.5,30.0);
         }
     }
 
@@ -99,7 +99,7 @@ protected:
 
         glTranslated(0.0,0.0,dMag);
         glRotated(dMag<0.0?180.0:0.0,1.0,0.0,0.0);
-        glutSolidCone(7.5,30.0,16,16);
+        GLShapes::cone(7.5,30.0);
     }
 
     double dA,dD,dAlpha,dTheta0;
@@ -30,10 +30,10 @@ public:
     virtual void drawJoint()
     {
         glColor4f(1.0,1.0,1.0,1.0);
-        gluSphere(cyl,20.32,16,16);
+        GLShapes::sphere(20.32);
         glTranslated(0.0,0.0,20.32);
         glColor4f(0.0,0.0,0.0,1.0);
-        gluSphere(cyl,5.08,16,16);
+        GLShapes::sphere(5.08);
     }
 };
 
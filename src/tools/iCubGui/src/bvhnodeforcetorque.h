@@ -59,11 +59,8 @@ class BVHNodeForceTorque : public BVHNodeDH
         glColor4f(0.4,0.4,1.0,1.0);
         glPushMatrix();
         glTranslated(0.0,0.0,15.0);
-        gluDisk(cyl,0.0,27.5,16,16);
-        gluCylinder(cyl,27.5,27.5,18.0,16,16);
-        glTranslated(0.0,0.0,18.0);
-        gluDisk(cyl,0.0,27.5,16,16);
-        glTranslated(0.0,0.0,-9.0);
+        GLShapes::cylinder(27.5,18.0);
+        glTranslated(0.0,0.0,9.0);
 
         glDisable(GL_DEPTH_TEST);
 
@@ -30,11 +30,8 @@ public:
     void FingerSegment(double length)
     {
         length-=1.0;
-        gluDisk(cyl,0.0,5.0,16,16);
-        gluCylinder(cyl,5.0,5.0,length,16,16);
-        glTranslated(0.0,0.0,length);
-        gluDisk(cyl,0.0,5.0,16,16);
-        glTranslated(0.0,0.0,1.0);
+        GLShapes::cylinder(5.0,length);
+        glTranslated(0.0,0.0,length+1.0);
     }
 
     virtual void draw(double* encoders,BVHNode* pSelected)
@@ -0,0 +1,59 @@
+/*
+ * datathread.h
+ */
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * CopyPolicy: Released under the terms of the GNU GPL v2.0.
+ */
+
+#ifndef DATATHREAD_H
+#define DATATHREAD_H
+
+#include <atomic>
+
+#include <yarp/os/PeriodicThread.h>
+
+#include "bvh.h"
+#include "objectsthread.h"
+#include "subtitilessthread.h"
+
+// Reads all the input ports of the gui out of the drawing thread, so that
+// drawing never waits for the network, and tells the view whether there is
+// anything new to draw.
+class DataThread : public yarp::os::PeriodicThread
+{
+public:
+    DataThread(BVH *bvh,ObjectsManager *objects,SubtitlesManager *subtitles,double period=0.01)
+        : yarp::os::PeriodicThread(period),
+          mBVH(bvh),mObjects(objects),mSubtitles(subtitles),bFresh(true)
+    {
+    }
+
+    // true if there is new data since the last call
+    bool takeFresh()
+    {
+        return bFresh.exchange(false);
+    }
+
+protected:
+    virtual void run()
+    {
+        bool bNew=mBVH->readEncoders();
+        bNew=mObjects->receive() || bNew;
+        bNew=mSubtitles->receive() || bNew;
+
+        if (bNew)
+        {
+            bFresh=true;
+        }
+    }
+
+    BVH *mBVH;
+    ObjectsManager *mObjects;
+    SubtitlesManager *mSubtitles;
+
+    std::atomic<bool> bFresh;
+};
+
+#endif
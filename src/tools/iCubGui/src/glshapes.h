@@ -0,0 +1,114 @@
+/*
+ * glshapes.h
+ */
+
+/*
+ * Copyright (C) 2026 iCub Facility - Istituto Italiano di Tecnologia
+ * CopyPolicy: Released under the terms of the GNU GPL v2.0.
+ */
+
+#ifndef GLSHAPES_H
+#define GLSHAPES_H
+
+#ifdef __APPLE__
+#include <OpenGL/glu.h>
+#include <GLUT/glut.h>
+#else
+#if defined(WIN32) || defined(WIN64)
+#include <windows.h>
+#endif
+#include <GL/glu.h>
+#include <GL/glut.h>
+#endif
+
+// The shapes repeated all over the body (joints, finger segments, arrows, eyes)
+// are tessellated once in a display list of unit size, and every instance is a
+// call of the list with its own scale: the tessellation is no longer redone on
+// each frame. GL_NORMALIZE keeps the normals right under the scale.
+class GLShapes
+{
+public:
+    // closed cylinder along z, from 0 to length
+    static void cylinder(double radius,double length)
+    {
+        glPushMatrix();
+        glScaled(radius,radius,length);
+        call(CYLINDER);
+        glPopMatrix();
+    }
+
+    // same as cylinder, without the disks at the ends
+    static void tube(double radius,double length)
+    {
+        glPushMatrix();
+        glScaled(radius,radius,length);
+        call(TUBE);
+        glPopMatrix();
+    }
+
+    // cone along z, base at 0
+    static void cone(double radius,double height)
+    {
+        glPushMatrix();
+        glScaled(radius,radius,height);
+        call(CONE);
+        glPopMatrix();
+    }
+
+    static void sphere(double radius)
+    {
+        glPushMatrix();
+        glScaled(radius,radius,radius);
+        call(SPHERE);
+        glPopMatrix();
+    }
+
+protected:
+    enum { CYLINDER, TUBE, CONE, SPHERE, NUM_SHAPES };
+
+    static void call(int shape)
+    {
+        // compiled in the context of the first frame, the only one of the gui
+        static GLuint base=0;
+
+        if (!base)
+        {
+            base=compile();
+        }
+
+        glCallList(base+shape);
+    }
+
+    static GLuint compile()
+    {
+        GLuint base=glGenLists(NUM_SHAPES);
+        GLUquadricObj *quad=gluNewQuadric();
+        gluQuadricDrawStyle(quad,GLU_FILL);
+
+        glNewList(base+CYLINDER,GL_COMPILE);
+        gluDisk(quad,0.0,1.0,16,16);
+        gluCylinder(quad,1.0,1.0,1.0,16,16);
+        glTranslated(0.0,0.0,1.0);
+        gluDisk(quad,0.0,1.0,16,16);
+        glTranslated(0.0,0.0,-1.0);
+        glEndList();
+
+        glNewList(base+TUBE,GL_COMPILE);
+        gluCylinder(quad,1.0,1.0,1.0,16,16);
+        glEndList();
+
+        glNewList(base+CONE,GL_COMPILE);
+        glutSolidCone(1.0,1.0,16,16);
+        glEndList();
+
+        glNewList(base+SPHERE,GL_COMPILE);
+        gluSphere(quad,1.0,16,16);
+        glEndList();
+
+        gluDeleteQuadric(quad);
+
+        return base;
+    }
+};
+
+#endif
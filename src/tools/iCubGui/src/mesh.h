@@ -28,6 +28,8 @@
 #include <GL/glu.h>
 #endif
 
+#include <QGLBuffer>
+
 #include <math.h>
 #include <stdlib.h>
 
@@ -54,8 +56,11 @@ class iCubMesh
 {
 public:
     iCubMesh(QString fileName,double rz=0.0,double ry=0.0,double rx=0.0,double tx=0.0,double ty=0.0,double tz=0.0)
+        : mBuffer(QGLBuffer::VertexBuffer)
     {
         nFaces=0;
+        mVertices=NULL;
+        bUploaded=false;
 
         QFile objFile(fileName);
         if(!objFile.open(QIODevice::ReadOnly))
@@ -174,43 +179,83 @@ public:
             }
         }
         objFile.close();
-    }
 
-    ~iCubMesh()
-    {
+        // the faces are unrolled in the N3F_V3F layout of glInterleavedArrays,
+        // the indices are not needed any more
+        mVertices=new float[nFaces*18];
+        float *p=mVertices;
+        for(int f=0; f<nFaces; ++f)
+        {
+            p=unroll(p,an[f],av[f]);
+            p=unroll(p,bn[f],bv[f]);
+            p=unroll(p,cn[f],cv[f]);
+        }
+
         delete [] vx; delete [] vy; delete [] vz;
         delete [] nx; delete [] ny; delete [] nz;
         delete [] av; delete [] bv; delete [] cv;
         delete [] an; delete [] bn; delete [] cn;
     }
 
+    ~iCubMesh()
+    {
+        if (mVertices) delete [] mVertices;
+    }
+
     void Draw()
     {
-        short v,n;
-        glBegin(GL_TRIANGLES);
-        for(int f=0; f<nFaces; ++f)
+        if (!mVertices) return;
+
+        // the mesh is copied once in a vertex buffer of the card, the first
+        // time it is drawn since there is a current context only then; the
+        // client array is drawn if the driver has no vertex buffers
+        if (!bUploaded)
         {
-            v=av[f]; n=an[f];
-            glNormal3f(nx[n],ny[n],nz[n]);
-            glVertex3f(vx[v],vy[v],vz[v]);
+            bUploaded=true;
 
-            v=bv[f]; n=bn[f];
-            glNormal3f(nx[n],ny[n],nz[n]);
-            glVertex3f(vx[v],vy[v],vz[v]);
+            if (mBuffer.create())
+            {
+                mBuffer.setUsagePattern(QGLBuffer::StaticDraw);
+                mBuffer.bind();
+                mBuffer.allocate(mVertices,nFaces*18*sizeof(float));
+                mBuffer.release();
+            }
+        }
 
-            v=cv[f]; n=cn[f];
-            glNormal3f(nx[n],ny[n],nz[n]);
-            glVertex3f(vx[v],vy[v],vz[v]);
+        if (mBuffer.isCreated())
+        {
+            mBuffer.bind();
+            glInterleavedArrays(GL_N3F_V3F,0,NULL);
+            glDrawArrays(GL_TRIANGLES,0,3*nFaces);
+            mBuffer.release();
+        }
+        else
+        {
+            glInterleavedArrays(GL_N3F_V3F,0,mVertices);
+            glDrawArrays(GL_TRIANGLES,0,3*nFaces);
         }
-        glEnd();
+
+        glDisableClientState(GL_NORMAL_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
     }
 
 protected:
+    float* unroll(float *p,short n,short v)
+    {
+        *p++=nx[n]; *p++=ny[n]; *p++=nz[n];
+        *p++=vx[v]; *p++=vy[v]; *p++=vz[v];
+        return p;
+    }
+
     int nFaces;
     float *vx,*vy,*vz;
     float *nx,*ny,*nz;
     short *av,*bv,*cv;
     short *an,*bn,*cn;
+
+    float *mVertices;
+    QGLBuffer mBuffer;
+    bool bUploaded;
 };
 
 #endif
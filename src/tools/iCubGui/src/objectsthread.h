@@ -22,6 +22,8 @@
 #include <qstring.h>
 #include <qthread.h>
 #include <vector>
+#include <deque>
+#include <mutex>
 #include <yarp/os/Log.h>
 #include <yarp/sig/Vector.h>
 #include <iCub/skinDynLib/skinContactList.h>
@@ -50,6 +52,8 @@ public:
         mTexPort.setStrict();
         mForcePort.setStrict();
 
+        bForces=false;
+
         /*
         mPx=mPy=mPz=0.0;
         mRx=mRy=mRz=0.0;
@@ -127,23 +131,70 @@ public:
     }
     */
 
-    void update()
+    // called by the data thread: queues what has been received, since the
+    // objects own textures and can be changed only by the drawing thread;
+    // returns true if anything has been received
+    bool receive()
     {
+        std::lock_guard<std::mutex> lock(mMutex);
+        bool bFresh=false;
+
         // objects
         for (yarp::os::Bottle *botObj; botObj=mObjPort.read(false);)
         {
-            manage(botObj);
+            mObjQueue.push_back(*botObj);
+            bFresh=true;
         }
 
         // textures
         for (yarp::sig::VectorOf<unsigned char> *imgTex; imgTex=mTexPort.read(false);)
         {
-            manage(imgTex);
+            mTexQueue.push_back(*imgTex);
+            bFresh=true;
         }
 
+        // each list of contacts replaces the previous one, only the latest is kept
         for (iCub::skinDynLib::skinContactList *forces; forces=mForcePort.read(false);)
         {
-            manage(*forces);
+            mForces=*forces;
+            bForces=bFresh=true;
+        }
+
+        return bFresh;
+    }
+
+    // called by the drawing thread: applies what has been received
+    void update()
+    {
+        std::deque<yarp::os::Bottle> objQueue;
+        std::deque<yarp::sig::VectorOf<unsigned char> > texQueue;
+        iCub::skinDynLib::skinContactList forces;
+        bool bNewForces=false;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            objQueue.swap(mObjQueue);
+            texQueue.swap(mTexQueue);
+            if (bForces)
+            {
+                forces.swap(mForces);
+                bForces=false;
+                bNewForces=true;
+            }
+        }
+
+        for (size_t i=0; i<objQueue.size(); ++i)
+        {
+            manage(&objQueue[i]);
+        }
+
+        for (size_t i=0; i<texQueue.size(); ++i)
+        {
+            manage(&texQueue[i]);
+        }
+
+        if (bNewForces)
+        {
+            manage(forces);
         }
     }
 
@@ -188,6 +239,12 @@ protected:
     yarp::os::BufferedPort<yarp::os::Bottle> mObjPort;
     yarp::os::BufferedPort<yarp::sig::VectorOf<unsigned char> > mTexPort;
     yarp::os::BufferedPort<iCub::skinDynLib::skinContactList> mForcePort;
+
+    std::mutex mMutex;
+    std::deque<yarp::os::Bottle> mObjQueue;
+    std::deque<yarp::sig::VectorOf<unsigned char> > mTexQueue;
+    iCub::skinDynLib::skinContactList mForces;
+    bool bForces;
 };
 
 void ObjectsManager::manage(yarp::os::Bottle *msg)
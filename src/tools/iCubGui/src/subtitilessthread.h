@@ -5,6 +5,9 @@
 #include <yarp/os/BufferedPort.h>
 #include <qgl.h>
 
+#include <mutex>
+#include <string>
+
 
 #ifdef __APPLE__
 #include <OpenGL/glu.h>
@@ -20,6 +23,12 @@ class SubtitlesManager
     yarp::os::BufferedPort<yarp::os::Bottle> mTxtMsgPort;
     yarp::os::BufferedPort<yarp::os::Bottle> mTxtDbgPort;
 
+    std::mutex mMutex;
+    double txtWatchDogStart;
+    double dbgWatchDogStart;
+    std::string txtMsg;
+    std::string dbgMsg;
+
 public:
     SubtitlesManager(const char *objPortName,const char *texPortName)
     {
@@ -29,6 +38,8 @@ public:
         mTxtMsgPort.setStrict();
         mTxtDbgPort.setStrict();
 
+        txtWatchDogStart=dbgWatchDogStart=yarp::os::Time::now();
+
         /*
         mPx=mPy=mPz=0.0;
         mRx=mRy=mRz=0.0;
@@ -47,12 +58,12 @@ public:
         mTxtDbgPort.close();
     }
 
-    void draw()
+    // called by the data thread: returns true if a message is received, or
+    // if a message shown has just expired
+    bool receive()
     {
-        static double txtWatchDogStart = yarp::os::Time::now();
-        static double dbgWatchDogStart = yarp::os::Time::now();
-        static std::string txtMsg;
-        static std::string dbgMsg;
+        std::lock_guard<std::mutex> lock(mMutex);
+        bool bFresh=false;
 
         Bottle* msg = mTxtMsgPort.read(false);
         Bottle* dbg = mTxtDbgPort.read(false);
@@ -61,21 +72,46 @@ public:
         {
             txtMsg= msg->get(0).asString().c_str();
             txtWatchDogStart = yarp::os::Time::now();
+            bFresh=true;
         }
         if (dbg !=0)
         {
             dbgMsg = dbg->get(0).asString().c_str();
             dbgWatchDogStart = yarp::os::Time::now();
+            bFresh=true;
+        }
+
+        if (!txtMsg.empty() && yarp::os::Time::now()-txtWatchDogStart >= 3.0)
+        {
+            txtMsg.clear();
+            bFresh=true;
+        }
+        if (!dbgMsg.empty() && yarp::os::Time::now()-dbgWatchDogStart >= 3.0)
+        {
+            dbgMsg.clear();
+            bFresh=true;
+        }
+
+        return bFresh;
+    }
+
+    void draw()
+    {
+        std::string txt,dbg;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            txt=txtMsg;
+            dbg=dbgMsg;
         }
 
-        if (yarp::os::Time::now()-txtWatchDogStart < 3.0 && !txtMsg.empty())
+        if (!txt.empty())
         {
-            drawText("iCub: ",txtMsg.c_str(),1.0f,1.0f,1.0f);
+            drawText("iCub: ",txt.c_str(),1.0f,1.0f,1.0f);
         }
 
-        if (yarp::os::Time::now()-dbgWatchDogStart < 3.0 && !dbgMsg.empty())
+        if (!dbg.empty())
         {
-            drawText("Dbg: ",dbgMsg.c_str(),1.0f,1.0f,1.0f);
+            drawText("Dbg: ",dbg.c_str(),1.0f,1.0f,1.0f);
         }
 
     }
@@ -12,6 +12,7 @@
 
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include <yarp/os/PeriodicThread.h>
 #include <yarp/dev/ControlBoardInterfaces.h>
@@ -44,6 +45,7 @@ protected:
     TouchSensor *sensor[16];
 
     std::mutex mtx;
+    std::vector<unsigned char> outline;
 
     int cardId;
     int sensorsNum;
@@ -180,6 +182,24 @@ public:
         {
             if (sensor[t]) sensor[t]->resize(width,height,40);
         }
+
+        // the outlines only move on resize, they are drawn once here
+        outline.assign(3*width*height,0);
+        for (int t=0; t<16; ++t)
+        {
+            if (sensor[t]) sensor[t]->draw(outline.data());
+        }
+    }
+
+    // true if some patch has to be evaluated again
+    bool changed()
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        for (int t=0; t<16; ++t)
+        {
+            if (sensor[t] && sensor[t]->isDirty()) return true;
+        }
+        return false;
     }
 
     void eval(unsigned char *image)
@@ -203,10 +223,13 @@ public:
 
     void draw(unsigned char *image)
     {
-        for (int t=0; t<16; ++t)
+        // the outlines are dithered with max(), compositing them is the same
+        std::lock_guard<std::mutex> lck(mtx);
+        const unsigned char *src=outline.data();
+        for (size_t i=0; i<outline.size(); ++i)
         {
-            if (sensor[t]) sensor[t]->draw(image);
-        }        
+            if (image[i]<src[i]) image[i]=src[i];
+        }
     }
 };
 
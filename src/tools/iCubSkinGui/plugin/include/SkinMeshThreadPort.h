@@ -44,6 +44,7 @@ protected:
     TouchSensor *sensor[MAX_SENSOR_NUM];
 
     std::mutex mtx;
+    std::vector<unsigned char> outline;
 
     int sensorsNum;
     bool mbSimpleDraw;
@@ -74,6 +75,24 @@ public:
         {
             if (sensor[t]) sensor[t]->resize(width,height,40);
         }
+
+        // the outlines only move on resize, they are drawn once here
+        outline.assign(3*width*height,0);
+        for (int t=0; t<MAX_SENSOR_NUM; ++t)
+        {
+            if (sensor[t]) sensor[t]->draw(outline.data());
+        }
+    }
+
+    // true if some patch has to be evaluated again
+    bool changed()
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        for (int t=0; t<MAX_SENSOR_NUM; ++t)
+        {
+            if (sensor[t] && sensor[t]->isDirty()) return true;
+        }
+        return false;
     }
 
     void eval(unsigned char *image)
@@ -97,9 +116,12 @@ public:
 
     void draw(unsigned char *image)
     {
-        for (int t=0; t<MAX_SENSOR_NUM; ++t)
+        // the outlines are dithered with max(), compositing them is the same
+        std::lock_guard<std::mutex> lck(mtx);
+        const unsigned char *src=outline.data();
+        for (size_t i=0; i<outline.size(); ++i)
         {
-            if (sensor[t]) sensor[t]->draw(image);
+            if (image[i]<src[i]) image[i]=src[i];
         }
     }
 };
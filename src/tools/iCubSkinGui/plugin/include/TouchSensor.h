@@ -11,6 +11,8 @@
 #include <memory.h>
 
 #include <stdio.h>
+#include <vector>
+#include <algorithm>
 
 #ifndef __ALE_TOUCHSENSOR_H__
 #define __ALE_TOUCHSENSOR_H__
@@ -28,16 +30,33 @@ protected:
         for (int n = 0; n < MAX_TAXELS; ++n)
         {
             connected[n] = true;
+            activation[n] = 0.0;
         }
+
+        R_MAX = G_MAX = B_MAX = 0;
+        m_Width = m_Height = m_maxRangeLight = 0;
+        m_TileX0 = m_TileY0 = m_TileW = m_TileH = m_TileRange = 0;
+        m_bDirty = true;
+        m_bTileLight = false;
     }
 
 public:
 
     void setColor(unsigned char r, unsigned char g, unsigned char b)
     {
-        R_MAX = r;
-        G_MAX = g;
-        B_MAX = b;
+        if (r!=R_MAX || g!=G_MAX || b!=B_MAX)
+        {
+            R_MAX = r;
+            G_MAX = g;
+            B_MAX = b;
+            m_bDirty = true;
+        }
+    }
+
+    // true if the heatmap has to be recomputed
+    bool isDirty() const
+    {
+        return m_bDirty;
     }
 
     void setCalibrationFlag (bool use_calibrated_skin)
@@ -83,13 +102,26 @@ public:
             m_maxRange=maxRange;
 
             delete [] Exponential;
-            Exponential=new double[maxRange];
+            Exponential=new double[maxRange+1];
 
             double k=-0.5/(sigma*sigma);
-            for (int x=0; x<maxRange; ++x)
+            for (int x=0; x<=maxRange; ++x)
             {
                 Exponential[x]=exp(k*double(x*x));
             }
+
+            // the weights of the whole neighbourhood of a taxel, shared by all
+            // the taxels since they are all scaled the same
+            int side=2*maxRange+1;
+            delete [] Kernel;
+            Kernel=new double[side*side];
+            for (int dy=-maxRange; dy<=maxRange; ++dy)
+            {
+                for (int dx=-maxRange; dx<=maxRange; ++dx)
+                {
+                    Kernel[(dy+maxRange)*side+dx+maxRange]=Exponential[Abs(dy)]*Exponential[Abs(dx)];
+                }
+            }
         }
 
         xMin=w2+int(scale*(dXc-dXmid-15.0))-maxRange;
@@ -104,6 +136,8 @@ public:
 
         m_Width=width;
         m_Height=height;
+
+        placeTile();
     }
 
     virtual ~TouchSensor()
@@ -113,6 +147,12 @@ public:
             delete [] Exponential;
             Exponential=0;
         }
+        if (Kernel)
+        {
+            delete [] Kernel;
+            Kernel=0;
+        }
+        m_maxRange=0;
     }
 
     int Abs(int x)
@@ -125,110 +165,44 @@ public:
         return nTaxels;
     }
 
+    // the heatmap is kept in a tile of the patch, recomputed only when the
+    // activations change, and blended in the image on each frame
     void eval_light(unsigned char *image)
     {
-        int act;
-        int dx,dy;
-        int Y0,Y1;
-        int dya,dyb,dxa,dxb;
+        updateTile(true);
 
-        switch (ilayoutNum)
+        for (int r=0; r<m_TileH; ++r)
         {
-            case 0:
-                for (int i=0; i<nTaxels; ++i)  remapped_activation[i]=activation[i];
-                break;
-            case 1:
-                for (int i=0; i<nTaxels; ++i)  remapped_activation[nTaxels-1-i]=activation[i];
-                break;
-            default:
-                for (int i=0; i<nTaxels; ++i)  remapped_activation[i]=activation[i];
-                printf("WARN: unkwnown layout number.\n");
-                break;
-        }
-
-        int maxRange2=m_maxRangeLight*m_maxRangeLight;
+            unsigned char *dst=image+((m_TileY0+r)*m_Width+m_TileX0)*3;
+            const unsigned char *src=&m_Tile[r*m_TileW*3];
 
-        for (int i=0; i<nTaxels; ++i) if (connected[i] && remapped_activation[i]>0.0)
-        {
-            act=int(dGain*remapped_activation[i]);
-            Y0=(m_Height-y[i]-1)*m_Width+x[i];
-
-            dya=(y[i]>=m_maxRangeLight)?-m_maxRangeLight:-y[i];
-            dyb=(y[i]+m_maxRangeLight<m_Height)?m_maxRangeLight:m_Height-y[i]-1;
-
-            dxa=(x[i]>=m_maxRangeLight)?-m_maxRangeLight:-x[i];
-            dxb=(x[i]+m_maxRangeLight<m_Width)?m_maxRangeLight:m_Width-x[i]-1;
-
-            for (dy=dya; dy<=dyb; ++dy)
+            for (int c=0; c<m_TileW; ++c,dst+=3,src+=3)
             {
-                Y1=Y0-dy*m_Width;
-
-                for (dx=dxa; dx<=dxb; ++dx)
-                {
-                    if (dx*dx+dy*dy<=maxRange2)
-                    {
-                        image[(dx+Y1)*3]=act<255?act:255;
-                    }
-                }
+                if (src[0]) dst[0]=src[0];
             }
         }
     }
 
     void eval(unsigned char *image)
     {
-        int act;
-        int dx,dy;
-        int Y0,Y1;
-        int index;
-        double k0,k1;
-        int dya,dyb,dxa,dxb;
+        updateTile(false);
 
-        switch (ilayoutNum)
+        for (int r=0; r<m_TileH; ++r)
         {
-            case 0:
-                for (int i=0; i<nTaxels; ++i)  remapped_activation[i]=activation[i];
-                break;
-            case 1:
-                for (int i=0; i<nTaxels; ++i)  remapped_activation[nTaxels-1-i]=activation[i];
-                break;
-            default:
-                for (int i=0; i<nTaxels; ++i)  remapped_activation[i]=activation[i];
-                printf("WARN: unkwnown layout number.\n");
-                break;
-        }
+            unsigned char *dst=image+((m_TileY0+r)*m_Width+m_TileX0)*3;
+            const unsigned char *src=&m_Tile[r*m_TileW*3];
 
-        for (int i=0; i<nTaxels; ++i) if (connected[i] && remapped_activation[i]>0.0)
-        {
-            k0=dGain*remapped_activation[i];
-            Y0=(m_Height-y[i]-1)*m_Width+x[i];
-
-            dya=(y[i]>=m_maxRange)?-m_maxRange:-y[i];
-            dyb=(y[i]+m_maxRange<m_Height)?m_maxRange:m_Height-y[i]-1;
-
-            dxa=(x[i]>=m_maxRange)?-m_maxRange:-x[i];
-            dxb=(x[i]+m_maxRange<m_Width)?m_maxRange:m_Width-x[i]-1;
-
-            for (dy=dya; dy<=dyb; ++dy)
+            for (int c=0; c<m_TileW; ++c,dst+=3,src+=3)
             {
-                k1=k0*Exponential[Abs(dy)];
-                Y1=Y0-dy*m_Width;
-
-                for (dx=dxa; dx<=dxb; ++dx)
+                if (src[0] || src[1] || src[2])
                 {
-                    index=(dx+Y1)*3;
+                    int actR=dst[0]+src[0];
+                    int actG=dst[1]+src[1];
+                    int actB=dst[2]+src[2];
 
-                    if (image[index]<R_MAX || image[index+1]<G_MAX || image[index+2]<B_MAX)
-                    {
-                        act=int(k1*Exponential[Abs(dx)]);
-
-                        int actR=image[index  ]+(act*R_MAX)/255;
-                        int actG=image[index+1]+(act*G_MAX)/255;
-                        int actB=image[index+2]+(act*B_MAX)/255;
-
-                        image[index  ]=actR<R_MAX?actR:R_MAX;
-                        image[index+1]=actG<G_MAX?actG:G_MAX;
-                        image[index+2]=actB<B_MAX?actB:B_MAX;
-                    }
+                    dst[0]=actR<R_MAX?actR:R_MAX;
+                    dst[1]=actG<G_MAX?actG:G_MAX;
+                    dst[2]=actB<B_MAX?actB:B_MAX;
                 }
             }
         }
@@ -238,14 +212,14 @@ public:
     {
         for (int i=0; i<7; ++i)
         {
-            activation[i]=data[i+1]<=244?double(244-data[i+1]):0.0;
+            setActivation(i,data[i+1]<=244?double(244-data[i+1]):0.0);
         }
     }
     void setActivationLast5(unsigned char* data)
     {
         for (int i=1; i<=5; ++i)
         {
-            activation[i+6]=data[i]<=244?double(244-data[i]):0.0;
+            setActivation(i+6,data[i]<=244?double(244-data[i]):0.0);
         }
     }
 
@@ -255,20 +229,20 @@ public:
         {
             if (val>244.0)
             {
-                activation[id]=244.0;
+                setActivation(id,244.0);
             }
             else if (val<0.0)
             {
-                activation[id]=0.0;
+                setActivation(id,0.0);
             }
             else
             {
-                activation[id]=val;
+                setActivation(id,val);
             }
         }
         else
         {
-            activation[id]=val<=244?double(244-val):0.0;
+            setActivation(id,val<=244?double(244-val):0.0);
         }
     }
 
@@ -286,6 +260,149 @@ public:
     }
 
 protected:
+    void setActivation(int id,double val)
+    {
+        if (activation[id]!=val)
+        {
+            activation[id]=val;
+            m_bDirty=true;
+        }
+    }
+
+    void remapActivation()
+    {
+        switch (ilayoutNum)
+        {
+            case 0:
+                for (int i=0; i<nTaxels; ++i)  remapped_activation[i]=activation[i];
+                break;
+            case 1:
+                for (int i=0; i<nTaxels; ++i)  remapped_activation[nTaxels-1-i]=activation[i];
+                break;
+            default:
+                for (int i=0; i<nTaxels; ++i)  remapped_activation[i]=activation[i];
+                printf("WARN: unkwnown layout number.\n");
+                break;
+        }
+    }
+
+    // the tile covers the neighbourhoods of all the taxels
+    void placeTile()
+    {
+        int range=m_maxRange>m_maxRangeLight?m_maxRange:m_maxRangeLight;
+        int x0=m_Width,x1=-1,y0=m_Height,y1=-1;
+
+        for (int i=0; i<nTaxels; ++i)
+        {
+            int row=m_Height-y[i]-1;
+            x0=std::min(x0,x[i]-range); x1=std::max(x1,x[i]+range);
+            y0=std::min(y0,row-range);  y1=std::max(y1,row+range);
+        }
+
+        x0=std::max(x0,0); x1=std::min(x1,m_Width-1);
+        y0=std::max(y0,0); y1=std::min(y1,m_Height-1);
+
+        m_TileX0=x0;
+        m_TileY0=y0;
+        m_TileW=x1>=x0?x1-x0+1:0;
+        m_TileH=y1>=y0?y1-y0+1:0;
+        m_TileRange=range;
+        m_Tile.assign(3*m_TileW*m_TileH,0);
+        m_bDirty=true;
+    }
+
+    void updateTile(bool light)
+    {
+        // m_maxRange is shared, a patch resized later may have widened it
+        if (m_TileRange<m_maxRange) placeTile();
+
+        if (!m_bDirty && light==m_bTileLight) return;
+
+        m_bDirty=false;
+        m_bTileLight=light;
+
+        std::fill(m_Tile.begin(),m_Tile.end(),(unsigned char)0);
+        if (m_TileW==0 || m_TileH==0) return;
+
+        remapActivation();
+
+        int act;
+        int dx,dy;
+        int dya,dyb,dxa,dxb;
+
+        if (light)
+        {
+            int maxRange2=m_maxRangeLight*m_maxRangeLight;
+
+            for (int i=0; i<nTaxels; ++i) if (connected[i] && remapped_activation[i]>0.0)
+            {
+                act=int(dGain*remapped_activation[i]);
+                if (act>255) act=255;
+
+                int row=m_Height-y[i]-1;
+
+                dya=(y[i]>=m_maxRangeLight)?-m_maxRangeLight:-y[i];
+                dyb=(y[i]+m_maxRangeLight<m_Height)?m_maxRangeLight:m_Height-y[i]-1;
+
+                dxa=(x[i]>=m_maxRangeLight)?-m_maxRangeLight:-x[i];
+                dxb=(x[i]+m_maxRangeLight<m_Width)?m_maxRangeLight:m_Width-x[i]-1;
+
+                for (dy=dya; dy<=dyb; ++dy)
+                {
+                    unsigned char *p=&m_Tile[((row-dy-m_TileY0)*m_TileW+x[i]-m_TileX0)*3];
+
+                    for (dx=dxa; dx<=dxb; ++dx)
+                    {
+                        if (dx*dx+dy*dy<=maxRange2)
+                        {
+                            p[dx*3]=(unsigned char)act;
+                        }
+                    }
+                }
+            }
+
+            return;
+        }
+
+        const int side=2*m_maxRange+1;
+
+        for (int i=0; i<nTaxels; ++i) if (connected[i] && remapped_activation[i]>0.0)
+        {
+            double k0=dGain*remapped_activation[i];
+            int row=m_Height-y[i]-1;
+
+            dya=(y[i]>=m_maxRange)?-m_maxRange:-y[i];
+            dyb=(y[i]+m_maxRange<m_Height)?m_maxRange:m_Height-y[i]-1;
+
+            dxa=(x[i]>=m_maxRange)?-m_maxRange:-x[i];
+            dxb=(x[i]+m_maxRange<m_Width)?m_maxRange:m_Width-x[i]-1;
+
+            for (dy=dya; dy<=dyb; ++dy)
+            {
+                const double *w=Kernel+(dy+m_maxRange)*side+m_maxRange;
+                unsigned char *p=&m_Tile[((row-dy-m_TileY0)*m_TileW+x[i]-m_TileX0)*3];
+
+                for (dx=dxa; dx<=dxb; ++dx)
+                {
+                    unsigned char *q=p+dx*3;
+
+                    if (q[0]<R_MAX || q[1]<G_MAX || q[2]<B_MAX)
+                    {
+                        act=int(k0*w[dx]);
+
+                        int actR=q[0]+(act*R_MAX)/255;
+                        int actG=q[1]+(act*G_MAX)/255;
+                        int actB=q[2]+(act*B_MAX)/255;
+
+                        q[0]=actR<R_MAX?actR:R_MAX;
+                        q[1]=actG<G_MAX?actG:G_MAX;
+                        q[2]=actB<B_MAX?actB:B_MAX;
+                    }
+                }
+            }
+        }
+    }
+
     void dither(int x,int y,unsigned char *image)
     {
         static const unsigned char R1=0x80,G1=0x50,B1=0x00;
@@ -397,6 +514,13 @@ protected:
     int m_maxRangeLight;
     static int m_maxRange;
     static double *Exponential;
+    static double *Kernel;
+
+    // heatmap of the patch
+    std::vector<unsigned char> m_Tile;
+    int m_TileX0,m_TileY0,m_TileW,m_TileH,m_TileRange;
+    bool m_bDirty;
+    bool m_bTileLight;
 
     // scaled
     int x[MAX_TAXELS],y[MAX_TAXELS];
@@ -305,6 +305,10 @@ bool QtICubSkinGuiPlugin::parseParameters(QStringList params)
     // TODO
     /***********/
 
+    // the refresh is bounded by fps, whatever the period of the skin thread
+    int fps=rf.check("fps")?rf.find("fps").asInt32():20;
+    if (fps<1) fps=1;
+    timer.setInterval(1000/fps);
     timer.start();
 
     connect(this,SIGNAL(init()),this,SLOT(onInit()),Qt::QueuedConnection);
@@ -324,6 +328,10 @@ bool QtICubSkinGuiPlugin::parseParameters(QStringList params)
 
 void QtICubSkinGuiPlugin::onTimeout()
 {
+    // no repaint as long as no taxel has changed
+    if (TheadType==TYPE_CAN && gpSkinMeshThreadCan && !gpSkinMeshThreadCan->changed()) return;
+    if (TheadType==TYPE_PORT && gpSkinMeshThreadPort && !gpSkinMeshThreadPort->changed()) return;
+
     update();
 }
 
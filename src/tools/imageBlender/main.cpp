@@ -7,14 +7,31 @@
 #include <yarp/sig/Image.h>
 #include <yarp/os/all.h>
 
+#include <algorithm>
 #include <iostream>
 #include <math.h>
+#include <string.h>
+#include <thread>
+#include <vector>
 
 using namespace yarp::os;
 using namespace yarp::sig;
 void printFrame(int h, int w, int c);
 
-void merge(const ImageOf<PixelRgb> &imgR, const ImageOf<PixelRgb> &imgL, ImageOf<PixelRgb> &out, size_t start_lx, size_t start_ly, size_t start_rx, size_t start_ry, double alpha1,double alpha2)
+// the contribution of a pixel of an image is (unsigned char)(value*alpha): it is tabulated once for all the frames
+void makeTable(double alpha, unsigned char *table)
+{
+    for (int v = 0; v < 256; v++)
+        table[v] = (unsigned char)(double(v) * alpha);
+}
+
+inline void addRow(unsigned char *dst, const unsigned char *src, size_t n, const unsigned char *table)
+{
+    for (size_t i = 0; i < n; i++)
+        dst[i] = (unsigned char)(dst[i] + table[src[i]]);
+}
+
+void merge(const ImageOf<PixelRgb> &imgR, const ImageOf<PixelRgb> &imgL, ImageOf<PixelRgb> &out, size_t start_lx, size_t start_ly, size_t start_rx, size_t start_ry, const unsigned char *table1, const unsigned char *table2, size_t threads)
 {
     size_t max_w = (imgR.width() > imgL.width()) ? imgR.width() : imgL.width();
     size_t max_h = (imgR.height() > imgL.height()) ? imgR.height() : imgL.height();
@@ -29,46 +46,35 @@ void merge(const ImageOf<PixelRgb> &imgR, const ImageOf<PixelRgb> &imgL, ImageOf
     size_t end_rx = (start_rx + imgR.width() < max_w) ? (start_rx + imgR.width()) : max_w;
     size_t end_ry = (start_ry + imgR.height() < max_h) ? (start_ry + imgR.height()) : max_h;
 
-    //canvas
-    for (size_t r_dst = 0; r_dst < max_h; r_dst++)
+    // every row of the output is the canvas plus the rows of the two images which fall on it, thus the rows are
+    // independent and they are split among the threads
+    auto rows = [&](size_t r_begin, size_t r_end)
     {
-        unsigned char       *tmp_dst = out.getRow(r_dst);
-
-        for (size_t c_dst = 0; c_dst < max_w; c_dst++)
+        for (size_t r_dst = r_begin; r_dst < r_end; r_dst++)
         {
-            tmp_dst[0 + c_dst * 3] = 0;
-            tmp_dst[1 + c_dst * 3] = 0;
-            tmp_dst[2 + c_dst * 3] = 0;
-        }
-    }
+            unsigned char *tmp_dst = out.getRow(r_dst);
 
-    //left image
-    for (size_t r_dst = start_ly, r_src = 0; r_dst < end_ly; r_dst++, r_src++)
-    {
-        unsigned char       *tmp_dst = out.getRow(r_dst);
-        const unsigned char *tmp_src = imgL.getRow(r_src);
+            //canvas
+            memset(tmp_dst, 0, max_w * 3);
 
-        for (size_t c_dst = start_lx, c_src = 0; c_dst < end_lx; c_dst++, c_src++)
-        {
-            tmp_dst[0 + c_dst * 3] = tmp_dst[0 + c_dst * 3] + (unsigned char)(double(tmp_src[0 + c_src * 3]) * alpha1);
-            tmp_dst[1 + c_dst * 3] = tmp_dst[1 + c_dst * 3] + (unsigned char)(double(tmp_src[1 + c_src * 3]) * alpha1);
-            tmp_dst[2 + c_dst * 3] = tmp_dst[2 + c_dst * 3] + (unsigned char)(double(tmp_src[2 + c_src * 3]) * alpha1);
-        }
-    }
-    
-    //right image
-    for (size_t r_dst = start_ry, r_src = 0; r_dst < end_ry; r_dst++, r_src++)
-    {
-        unsigned char       *tmp_dst = out.getRow(r_dst);
-        const unsigned char *tmp_src = imgR.getRow(r_src);
+            //left image
+            if (r_dst >= start_ly && r_dst < end_ly)
+                addRow(tmp_dst + start_lx * 3, imgL.getRow(r_dst - start_ly), (end_lx - start_lx) * 3, table1);
 
-        for (size_t c_dst = start_rx, c_src = 0; c_dst < end_rx; c_dst++, c_src++)
-        {
-            tmp_dst[0 + c_dst * 3] = tmp_dst[0 + c_dst * 3] + (unsigned char)(double(tmp_src[0 + c_src * 3]) * alpha2);
-            tmp_dst[1 + c_dst * 3] = tmp_dst[1 + c_dst * 3] + (unsigned char)(double(tmp_src[1 + c_src * 3]) * alpha2);
-            tmp_dst[2 + c_dst * 3] = tmp_dst[2 + c_dst * 3] + (unsigned char)(double(tmp_src[2 + c_src * 3]) * alpha2);
+            //right image
+            if (r_dst >= start_ry && r_dst < end_ry)
+                addRow(tmp_dst + start_rx * 3, imgR.getRow(r_dst - start_ry), (end_rx - start_rx) * 3, table2);
         }
-    }
+    };
+
+    if (threads < 1) threads = 1;
+    size_t chunk = (max_h + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads && t * chunk < max_h; t++)
+        workers.emplace_back(rows, t * chunk, std::min(max_h, (t + 1) * chunk));
+    rows(0, std::min(max_h, chunk));
+    for (auto &w : workers)
+        w.join();
 }
 
 int main(int argc, char *argv[])
@@ -93,13 +99,15 @@ int main(int argc, char *argv[])
     size_t start_ly = 0;
     double alpha1 = 0.5;
     double alpha2 = 0.5;
+    size_t threads = std::min(4u, std::max(1u, std::thread::hardware_concurrency()));
     if (rf.check("rx")) start_rx = (size_t) rf.find("rx").asFloat64();
     if (rf.check("ry")) start_ry = (size_t) rf.find("ry").asFloat64();
     if (rf.check("lx")) start_lx = (size_t) rf.find("lx").asFloat64();
     if (rf.check("ly")) start_ly = (size_t) rf.find("ly").asFloat64();
     if (rf.check("alpha1")) alpha1 = rf.find("alpha1").asFloat64();
     if (rf.check("alpha2")) alpha2 = rf.find("alpha2").asFloat64();
-    yDebug("left offset:%lu,%lu right offset:%lu,%lu, alpha1:%f, alpha2:%f", start_lx, start_ly, start_rx, start_ry, alpha1, alpha2);
+    if (rf.check("threads")) threads = (size_t) rf.find("threads").asInt32();
+    yDebug("left offset:%lu,%lu right offset:%lu,%lu, alpha1:%f, alpha2:%f, threads:%lu", start_lx, start_ly, start_rx, start_ry, alpha1, alpha2, threads);
     if (rf.check("help"))
     {
         yDebug() << "Available options:";
@@ -109,24 +117,33 @@ int main(int argc, char *argv[])
         yDebug() << "ly";
         yDebug() << "alpha1";
         yDebug() << "alpha2";
+        yDebug() << "threads";
         return 0;
     }
 
+    unsigned char table1[256];
+    unsigned char table2[256];
+    makeTable(alpha1, table1);
+    makeTable(alpha2, table2);
+
     while(true)
     {
         ImageOf< PixelRgb> *imgR=right.read(true);
         ImageOf< PixelRgb> *imgL=left.read(true);
 
-        ImageOf< PixelRgb> &outImg=out.prepare();
+        // the frames are consumed anyway, but nobody would see the blended one
+        if (out.getOutputCount() == 0)
+            continue;
 
         if (imgR!=0 && imgL!=0)
         {
-            merge(*imgR, *imgL, outImg, start_lx, start_ly, start_rx, start_ry,alpha1,alpha2);
+            ImageOf< PixelRgb> &outImg=out.prepare();
+            merge(*imgR, *imgL, outImg, start_lx, start_ly, start_rx, start_ry, table1, table2, threads);
 
             out.write();
             c++;
+            printFrame(outImg.height(), outImg.width(), c);
         }
-        printFrame(outImg.height(), outImg.width(), c);
     }
     return 0;
 }
@@ -9,6 +9,7 @@
 
 #include <iostream>
 #include <math.h>
+#include <string.h>
 
 using namespace yarp::os;
 using namespace yarp::sig;
@@ -16,21 +17,16 @@ void printFrame(int h, int w, int c);
 
 void crop(const ImageOf<PixelRgb> &inImg, ImageOf<PixelRgb> &outImg, size_t start_x, size_t start_y, size_t width, size_t height)
 {
+    start_x = (start_x < size_t(inImg.width())) ? start_x : inImg.width();
+    start_y = (start_y < size_t(inImg.height())) ? start_y : inImg.height();
     size_t end_x = (start_x + width)  < size_t(inImg.width()) ? (start_x + width) : (inImg.width());
     size_t end_y = (start_y + height) < size_t(inImg.height()) ? (start_y + height) : (inImg.height());
-    outImg.resize(end_x-start_x, end_y-start_y);
+    if (outImg.width() != end_x-start_x || outImg.height() != end_y-start_y) outImg.resize(end_x-start_x, end_y-start_y);
 
+    // the pixels of a row of the crop are contiguous in both images
     for (size_t r_src = start_y, r_dst = 0; r_src < end_y; r_dst++, r_src++)
     {
-        unsigned char       *tmp_dst = outImg.getRow(r_dst);
-        const unsigned char *tmp_src = inImg.getRow(r_src);
-
-        for (size_t c_src = start_x, c_dst = 0; c_src < end_x; c_dst++, c_src++)
-        {
-            tmp_dst[0 + c_dst * 3] = tmp_src[0 + c_src * 3];
-            tmp_dst[1 + c_dst * 3] = tmp_src[1 + c_src * 3];
-            tmp_dst[2 + c_dst * 3] = tmp_src[2 + c_src * 3];
-        }
+        memcpy(outImg.getRow(r_dst), inImg.getRow(r_src) + start_x * 3, (end_x - start_x) * 3);
     }
 }
 
@@ -69,15 +65,19 @@ int main(int argc, char *argv[])
     while(true)
     {
         ImageOf< PixelRgb> *inImg = input.read(true);
-        ImageOf< PixelRgb> &outImg=out.prepare();
+
+        // the frames are consumed anyway, but nobody would see the crop
+        if (out.getOutputCount() == 0)
+            continue;
 
         if (inImg != 0)
         {
+            ImageOf< PixelRgb> &outImg=out.prepare();
             crop(*inImg, outImg, start_x, start_y, width, height);
             out.write();
             c++;
+            printFrame(outImg.height(), outImg.width(), c);
         }
-        printFrame(outImg.height(), outImg.width(), c);
     }
     return 0;
 }
@@ -37,6 +37,7 @@ bool ImageSplitter::configure(yarp::os::ResourceFinder &rf)
         cout<<"nameLeft   name of the output port for the 'left image', if not specified by default is <local> + '/left:o'"<<endl;
         cout<<"nameRight  name of the output port for the 'right image', if not specified by default is <local> + '/right:o'"<<endl;
         cout<<"remote     name of the source port, if specified it connects automatically to the module's input port"<<endl;
+        cout<<"m          method used to fill the output images: 'pixel', 'pixel2', 'line', 'whole' or 'view' (no copy, vertical alignment only)"<<endl;
         std::exit(1);
     }
     // Check input parameters
@@ -144,9 +145,18 @@ bool ImageSplitter::configure(yarp::os::ResourceFinder &rf)
                 yError() << "Cannot use 'whole' method for input image horizontally aligned";
             method = 3;
         }
+        else if(align == "view")
+        {
+            if(horizontal)
+            {
+                yError() << "Cannot use 'view' method for input image horizontally aligned";
+                return false;
+            }
+            method = 4;
+        }
         else
         {
-            yError() << "Methods are pixel, line, whole; got " << align;
+            yError() << "Methods are pixel, line, whole, view; got " << align;
             return false;
         }
     }
@@ -191,8 +201,11 @@ bool ImageSplitter::updateModule()
 
     outLeftImage.setQuantum(inputImage->getQuantum());
     outRightImage.setQuantum(inputImage->getQuantum());
-    outLeftImage.resize(outWidth, outHeight);
-    outRightImage.resize(outWidth, outHeight);
+    if(method != 4)
+    {
+        outLeftImage.resize(outWidth, outHeight);
+        outRightImage.resize(outWidth, outHeight);
+    }
 
     // alloc and compute some vars for efficency
     int h2, w2;
@@ -329,6 +342,19 @@ bool ImageSplitter::updateModule()
             }
         } break;
 
+        case 4: // no copy, the output images point to the halves of the input one
+        {
+            if(horizontal)
+            {
+                yError() << "Cannot use this copy method with horizontally aligned source image.";
+            }
+            else
+            {
+                outLeftImage.setExternal(pixelInput, outWidth, outHeight);
+                outRightImage.setExternal(pixelInput + outHeight*dualImage_rowSizeByte, outWidth, outHeight);
+            }
+        } break;
+
         default:
         {
             yError() << " @line " << __LINE__ << "unhandled switch case, we should not be here!";
@@ -352,6 +378,14 @@ bool ImageSplitter::updateModule()
 
     outLeftPort.write();
     outRightPort.write();
+
+    // the views are valid as long as the input image is; the
+    // next read releases it, hence the writes must be over
+    if(method == 4)
+    {
+        outLeftPort.waitForWrite();
+        outRightPort.waitForWrite();
+    }
     return true;
 }
 
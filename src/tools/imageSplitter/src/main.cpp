@@ -10,6 +10,8 @@ Split a single image with 2 frames in it into 2 images left/right
 Parameters
 \code
   align horizontal / vertical  :  input images are coupled on the horizontal / vertical way  -- default horizontal
+  m pixel / pixel2 / line / whole / view  :  how the output images are filled  -- default line;
+    view makes no copy at all, since the outputs point to the halves of the input image (vertical alignment only)
 \endcode
 */ 
 
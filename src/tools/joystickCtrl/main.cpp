@@ -55,6 +55,24 @@ the number of axes specified in the configuration file) containing the readings.
 The port /joystickCtrl/axis:o contains the axis output only (raw data).
 The port /joystickCtrl/buttons:o contains the buttons output only (raw data).
 
+The following options of the GENERAL group reduce the latency and the
+jitter of the stream:
+- \e sendOnChange: the ports are written only when an output moves by more
+  than \e sendDeadband (in output units, default 0), when a button changes,
+  or at least every \e keepAlivePeriod seconds (default 0.1).
+- \e eventDriven (SDL 2 only): the thread waits for the joystick events
+  instead of polling it every rateThread ms.
+- \e vectorPortName: the outputs are also sent as a yarp::sig::Vector, a
+  compact binary message, on the port with this name; the string outputs
+  are left out.
+
+If the group VELOCITY_CONTROL is present the outputs are also sent directly
+as velocity commands to a control board, with no module in between:
+- \e remote: the control board, e.g. /icub/head
+- \e local: the prefix of the local ports, default /joystickCtrl/velocity
+- \e joints: the joint driven by each output, -1 for the outputs not used
+- \e gain: the factor from the output to deg/s, default 1.0
+
 \section in_files_sec Input Data Files
 None.
 
@@ -85,6 +103,7 @@ Windows, Linux
 
 #include <yarp/dev/Drivers.h>
 #include <yarp/dev/CartesianControl.h>
+#include <yarp/dev/ControlBoardInterfaces.h>
 #include <yarp/dev/PolyDriver.h>
 
 //#include <gsl/gsl_math.h>
@@ -92,6 +111,7 @@ Windows, Linux
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <vector>
 #include <math.h>
 #include <SDL.h>
 
@@ -120,9 +140,27 @@ protected:
     BufferedPort<Bottle> port_command;
     BufferedPort<Bottle> port_axis_only;
     BufferedPort<Bottle> port_buttons_only;
+    BufferedPort<Vector> port_vector;
     bool                 silent;
     bool                 force_cfg;
 
+    //streaming options
+    bool   send_on_change;
+    bool   event_driven;
+    double send_deadband;
+    double keepalive_period;
+    double t_last_send;
+    bool   sent_once;
+    double* lastOutAxes;
+
+    //direct velocity output
+    PolyDriver         velocity_driver;
+    IVelocityControl*  ivel;
+    IControlMode*      imode;
+    vector<int>        vel_joints;
+    vector<int>        vel_outputs;
+    double             vel_gain;
+
     double defaultExecTime;
     double t0;
     int numAxes;
@@ -180,6 +218,95 @@ public:
         jointProperties=0;
         silent = false;
         force_cfg = false;
+        send_on_change = false;
+        event_driven = false;
+        send_deadband = 0.0;
+        keepalive_period = 0.1;
+        t_last_send = 0.0;
+        sent_once = false;
+        lastOutAxes = 0;
+        ivel = 0;
+        imode = 0;
+        vel_gain = 1.0;
+    }
+
+    bool openVelocityControl(Bottle& group)
+    {
+        if (!group.check("remote") || !group.check("joints"))
+        {
+            yError ( "VELOCITY_CONTROL needs the remote and joints options\n");
+            return false;
+        }
+
+        Bottle* joints = group.find("joints").asList();
+        if (joints == 0 || joints->size() > num_outputs)
+        {
+            yError ( "Configuration error: invalid number of entries 'joints' in VELOCITY_CONTROL\n");
+            return false;
+        }
+        for (int i = 0; i < joints->size(); i++)
+        {
+            int j = joints->get(i).asInt32();
+            if (j < 0) continue;
+            if (jointProperties[i].type == JTYPE_STRING)
+            {
+                yError ( "Output %d is a string, it cannot drive joint %d\n", i, j);
+                return false;
+            }
+            vel_outputs.push_back(i);
+            vel_joints.push_back(j);
+        }
+        vel_gain = group.check("gain", Value(1.0)).asFloat64();
+
+        Property options;
+        options.put("device", "remote_controlboard");
+        options.put("remote", group.find("remote").asString());
+        options.put("local", group.check("local", Value("/joystickCtrl/velocity")).asString());
+        if (!velocity_driver.open(options) ||
+            !velocity_driver.view(ivel) || !velocity_driver.view(imode))
+        {
+            yError ( "Unable to connect to %s\n", group.find("remote").asString().c_str());
+            return false;
+        }
+
+        vector<int> modes(vel_joints.size(), VOCAB_CM_VELOCITY);
+        imode->setControlModes((int)vel_joints.size(), vel_joints.data(), modes.data());
+        yInfo ( "Sending velocity commands to %d joints of %s\n", (int)vel_joints.size(), group.find("remote").asString().c_str());
+        return true;
+    }
+
+    void sendVelocities(bool zero)
+    {
+        if (ivel == 0 || vel_joints.empty()) return;
+
+        vector<double> speeds(vel_joints.size(), 0.0);
+        if (!zero)
+        {
+            for (size_t i = 0; i < vel_outputs.size(); i++)
+                speeds[i] = vel_gain * outAxes[vel_outputs[i]];
+        }
+        ivel->velocityMove((int)vel_joints.size(), vel_joints.data(), speeds.data());
+    }
+
+    // true if the outputs have to be written, always unless sendOnChange is set
+    bool outputsChanged(double t)
+    {
+        if (!send_on_change || !sent_once) return true;
+        if (t - t_last_send >= keepalive_period) return true;
+
+        for (int i = 0; i < num_outputs; i++)
+        {
+            if (fabs(outAxes[i] - lastOutAxes[i]) > send_deadband) return true;
+        }
+        for (int i = 0; i < numButtons; i++)
+        {
+            if (rawButtons[i] != rawButtonsOld[i]) return true;
+        }
+        for (int i = 0; i < numHats; i++)
+        {
+            if (rawHats[i] != rawHatsOld[i]) return true;
+        }
+        return false;
     }
 
     virtual bool threadInit()
@@ -197,6 +324,24 @@ public:
             force_cfg=true;
         }
 
+        Bottle& general = rf.findGroup("GENERAL");
+        if (general.check("sendOnChange"))
+        {
+            send_on_change = true;
+            send_deadband = general.check("sendDeadband", Value(0.0)).asFloat64();
+            keepalive_period = general.check("keepAlivePeriod", Value(0.1)).asFloat64();
+            yInfo ( "Sending only on change (deadband %f, keep alive every %f s)\n", send_deadband, keepalive_period);
+        }
+        if (general.check("eventDriven"))
+        {
+#if (SDL_MAJOR_VERSION == 2)
+            event_driven = true;
+            yInfo ( "Waiting for the joystick events\n");
+#else
+            yWarning ( "eventDriven needs SDL 2, polling the joystick every rateThread ms\n");
+#endif
+        }
+
         if (rf.findGroup("INPUTS").check("InputsNumber"))
         {
             num_inputs = rf.findGroup("INPUTS").find("InputsNumber").asInt32();
@@ -332,12 +477,22 @@ public:
         //@@@ TO BE COMPLETED: port name prefix to be set in the ini file
         ret &= port_axis_only.open("/joystickCtrl/raw_axis:o");
         ret &= port_buttons_only.open("/joystickCtrl/raw_buttons:o");
+        if (general.check("vectorPortName"))
+        {
+            ret &= port_vector.open(general.find("vectorPortName").asString().c_str());
+        }
         if (ret==false)
         {
             yError() << "Unable to open module ports";
             return false;
         }
 
+        Bottle& velocity_group = rf.findGroup("VELOCITY_CONTROL");
+        if (!velocity_group.isNull() && !openVelocityControl(velocity_group))
+        {
+            return false;
+        }
+
         //get the list of the commands to be executed with the buttons
         Bottle& exec_comm_bottle = rf.findGroup("BUTTONS_EXECUTE");
         if (!exec_comm_bottle.isNull())
@@ -488,6 +643,21 @@ public:
         rawButtons    = new int    [MAX_AXES];
         rawButtonsOld = new int    [MAX_AXES];
         outAxes       = new double [MAX_AXES];
+        lastOutAxes   = new double [MAX_AXES];
+
+        for (int i=0; i<MAX_AXES; i++)
+        {
+            rawButtons[i] = rawButtonsOld[i] = 0;
+            rawHats[i] = rawHatsOld[i] = SDL_HAT_CENTERED;
+            outAxes[i] = lastOutAxes[i] = 0.0;
+        }
+
+#if (SDL_MAJOR_VERSION == 2)
+        if (event_driven)
+        {
+            SDL_JoystickEventState ( SDL_ENABLE );
+        }
+#endif
 
         /*
         // check: selected joint MUST have at least one button
@@ -523,6 +693,20 @@ public:
         */
 
         // Updates the joystick status
+#if (SDL_MAJOR_VERSION == 2)
+        if (event_driven)
+        {
+            // the thread sleeps until the joystick moves, the keep alive
+            // bounds the wait; the events themselves are not needed, pumping
+            // them updates the state read below
+            SDL_Event event;
+            if (SDL_WaitEventTimeout ( &event, (int)(keepalive_period*1000.0) ))
+            {
+                while (SDL_PollEvent ( &event )) { }
+            }
+        }
+        else
+#endif
         SDL_JoystickUpdate ();
 
         // Reading joystick data (axes/buttons...)
@@ -716,20 +900,39 @@ public:
         }
 
         // Sending data on the yarp ports
-        if (port_command.getOutputCount()>0)
-        {
-            port_command.prepare() = data;
-            port_command.write();
-        }
-        if (port_axis_only.getOutputCount()>0)
-        {
-            port_axis_only.prepare() = axis_data;
-            port_axis_only.write();
-        }
-        if (port_buttons_only.getOutputCount()>0)
+        double t_now = Time::now();
+        if (outputsChanged(t_now))
         {
-            port_buttons_only.prepare() = buttons_data;
-            port_buttons_only.write();
+            if (port_command.getOutputCount()>0)
+            {
+                port_command.prepare() = data;
+                port_command.write();
+            }
+            if (port_axis_only.getOutputCount()>0)
+            {
+                port_axis_only.prepare() = axis_data;
+                port_axis_only.write();
+            }
+            if (port_buttons_only.getOutputCount()>0)
+            {
+                port_buttons_only.prepare() = buttons_data;
+                port_buttons_only.write();
+            }
+            if (port_vector.getOutputCount()>0)
+            {
+                Vector& v = port_vector.prepare();
+                v.clear();
+                for (int i=0;i<num_outputs;i++)
+                {
+                    if (jointProperties[i].type != JTYPE_STRING) v.push_back(outAxes[i]);
+                }
+                port_vector.write();
+            }
+            sendVelocities(false);
+
+            for (int i=0;i<num_outputs;i++) lastOutAxes[i] = outAxes[i];
+            t_last_send = t_now;
+            sent_once = true;
         }
 
         // Displaying status
@@ -738,10 +941,15 @@ public:
 
     virtual void threadRelease()
     {    
+        // the joints must not keep the last speed
+        if (ivel) sendVelocities(true);
+        velocity_driver.close();
+
         if (rawAxes)         delete [] rawAxes;
         if (rawHats)         delete [] rawHats;
         if (rawHatsOld)      delete [] rawHatsOld;
         if (outAxes)         delete [] outAxes;
+        if (lastOutAxes)     delete [] lastOutAxes;
         if (rawButtons)      delete [] rawButtons;
         if (inputMax)        delete [] inputMax;
         if (inputMin)        delete [] inputMin;
@@ -756,6 +964,8 @@ public:
         port_axis_only.close();
         port_buttons_only.interrupt();
         port_buttons_only.close();
+        port_vector.interrupt();
+        port_vector.close();
     }
 
 
@@ -46,6 +46,20 @@ MainWindow::MainWindow(ResourceFinder *rf,QWidget *parent) :
     updateTimer.setInterval(1000/currentSampleFreq);
     connect(&updateTimer,SIGNAL(timeout()),this,SLOT(onUpdateTimer()));
 
+    // the plot is refreshed at its own pace, whatever the sample frequency
+    currentSampleNum = rf->check("plotSamples", Value(36000)).asInt32();
+    plotStartTime = Time::now();
+    driftPlot = new QCustomPlot();
+    driftPlot->xAxis->setLabel("time (s)");
+    driftPlot->yAxis->setLabel("mean drift");
+    driftPlot->legend->setVisible(true);
+    ui->tabWidget->addTab(driftPlot, "Drift Plot");
+
+    plotTimer.setSingleShot(false);
+    plotTimer.setInterval(rf->check("plotPeriod", Value(250)).asInt32());
+    connect(&plotTimer,SIGNAL(timeout()),this,SLOT(onPlotTimer()));
+    plotTimer.start();
+
 
 }
 
@@ -94,7 +108,6 @@ void MainWindow::onPortCreated()
 void MainWindow::initGui()
 {
     currentSampleFreq = 5;
-    currentSampleNum = 100;
 
     // if the rpc port is connected, then initialize the gui status
     initDone = false;
@@ -639,6 +652,11 @@ void MainWindow::onUpdateTimer()
                     meanPort = sumPort/(portDim[i]/12);
                     portItem->setText(0, portNames[i].c_str());
                     portItem->setText(3, QString("%L1").arg(meanPort,0,'f',3));
+
+                    if(driftHistory.size() != portNames.size()){
+                        initDriftPlot();
+                    }
+                    driftHistory[i].push(Time::now()-plotStartTime, meanPort);
                 }
 
             }
@@ -681,3 +699,54 @@ void MainWindow::setMsgFreq(bool freqUpdated, double freq){
         prevFreq = auxFreq;
     }
 }
+
+void MainWindow::initDriftPlot()
+{
+    static const Qt::GlobalColor colors[] = { Qt::blue, Qt::red, Qt::darkGreen, Qt::magenta,
+                                              Qt::darkCyan, Qt::darkYellow, Qt::black, Qt::gray };
+
+    driftPlot->clearGraphs();
+    driftHistory.assign(portNames.size(), PlotBuffer(currentSampleNum));
+
+    for(size_t i=0; i<portNames.size(); i++){
+        QCPGraph *graph = driftPlot->addGraph();
+        graph->setName(portNames[i].c_str());
+        graph->setPen(QPen(colors[i%(sizeof(colors)/sizeof(colors[0]))]));
+    }
+}
+
+void MainWindow::onPlotTimer()
+{
+    if(!driftPlot->isVisible() || driftHistory.empty()){
+        return;
+    }
+
+    double from=0, to=0;
+    bool empty = true;
+    for(size_t i=0; i<driftHistory.size(); i++){
+        if(driftHistory[i].size()==0){
+            continue;
+        }
+        if(empty || driftHistory[i].firstKey()<from) from = driftHistory[i].firstKey();
+        if(empty || driftHistory[i].lastKey()>to)    to   = driftHistory[i].lastKey();
+        empty = false;
+    }
+    if(empty){
+        return;
+    }
+    if(to<=from){
+        to = from+1.0;
+    }
+
+    // no more than two points for each column of pixels
+    int columns = driftPlot->axisRect()->width();
+    QVector<double> keys, values;
+    for(size_t i=0; i<driftHistory.size() && (int)i<driftPlot->graphCount(); i++){
+        driftHistory[i].decimate(from, to, columns, keys, values);
+        driftPlot->graph(i)->setData(keys, values);
+    }
+
+    driftPlot->xAxis->setRange(from, to);
+    driftPlot->yAxis->rescale();
+    driftPlot->replot();
+}
@@ -4,6 +4,8 @@
 #include <QMainWindow>
 #include "portthread.h"
 #include "loadingwidget.h"
+#include "plotbuffer.h"
+#include "qcustomplot.h"
 
 #include <QTimer>
 
@@ -52,6 +54,7 @@ public:
 private:
     void changeSmooth(int val);
     void setMsgFreq(bool freqUpdated, double freq);
+    void initDriftPlot();
 
 private:
     Ui::MainWindow *ui;
@@ -60,6 +63,8 @@ private:
     LoadingWidget loadingWidget;
     QTimer calibratingTimer;
     QTimer updateTimer;
+    QTimer plotTimer;
+    QCustomPlot *driftPlot;
     bool smoothSliderPressed;
     double prevFreq;
 
@@ -75,6 +80,8 @@ private:
     double                  currentMaxNeighDist;    // current max neighbor distance
     int                     currentSampleFreq;
     int                     currentSampleNum;       // size of the dataPlot array
+    vector<PlotBuffer>      driftHistory;           // mean drift of each port over time
+    double                  plotStartTime;          // time of the first sample of the plot
 
 
 private slots:
@@ -94,6 +101,7 @@ private slots:
     void onSpinCompGainChanged(double);
     void onSpinThresholdChanged(int);
     void onSampleFreqChanged(int);
+    void onPlotTimer();
 
 };
 
@@ -0,0 +1,136 @@
+#ifndef PLOTBUFFER_H
+#define PLOTBUFFER_H
+
+#include <QVector>
+
+#include <vector>
+
+// The samples of a curve, kept in a ring of fixed capacity so that the memory
+// does not grow however long the gui is monitoring. The plot never gets the
+// whole ring: decimate() reduces it to the min and the max of each column of
+// pixels, which is all that can be seen anyway.
+class PlotBuffer
+{
+public:
+    explicit PlotBuffer(int capacity=1) : first(0), count(0)
+    {
+        setCapacity(capacity);
+    }
+
+    // drops all the samples
+    void setCapacity(int capacity)
+    {
+        keys.assign(capacity>0?capacity:1,0.0);
+        values.assign(keys.size(),0.0);
+        first=count=0;
+    }
+
+    int capacity() const { return (int)keys.size(); }
+    int size() const { return count; }
+
+    // the keys must be pushed in increasing order
+    void push(double key, double value)
+    {
+        int cap=capacity();
+        int last=(first+count)%cap;
+
+        keys[last]=key;
+        values[last]=value;
+
+        if (count<cap)
+        {
+            count++;
+        }
+        else
+        {
+            first=(first+1)%cap;
+        }
+    }
+
+    double firstKey() const { return count>0?keys[first]:0.0; }
+    double lastKey() const { return count>0?keys[(first+count-1)%capacity()]:0.0; }
+
+    // fills outKeys/outValues with the samples whose key is in [from,to],
+    // keeping at most the min and the max (in their order) of each of the
+    // columns the range is split into
+    void decimate(double from, double to, int columns,
+                  QVector<double> &outKeys, QVector<double> &outValues) const
+    {
+        outKeys.clear();
+        outValues.clear();
+
+        if (count==0 || to<=from || columns<1)
+        {
+            return;
+        }
+
+        outKeys.reserve(2*columns+2);
+        outValues.reserve(2*columns+2);
+
+        const int cap=capacity();
+        const double scale=columns/(to-from);
+
+        int column=-1;
+        int iMin=0,iMax=0;
+
+        for (int n=0; n<count; n++)
+        {
+            int i=(first+n)%cap;
+
+            if (keys[i]<from || keys[i]>to)
+            {
+                continue;
+            }
+
+            int c=(int)((keys[i]-from)*scale);
+
+            if (c!=column)
+            {
+                if (column>=0)
+                {
+                    flush(iMin,iMax,outKeys,outValues);
+                }
+                column=c;
+                iMin=iMax=i;
+            }
+            else
+            {
+                if (values[i]<values[iMin]) iMin=i;
+                if (values[i]>values[iMax]) iMax=i;
+            }
+        }
+
+        if (column>=0)
+        {
+            flush(iMin,iMax,outKeys,outValues);
+        }
+    }
+
+private:
+    void flush(int iMin, int iMax, QVector<double> &outKeys, QVector<double> &outValues) const
+    {
+        if (iMin==iMax)
+        {
+            outKeys.push_back(keys[iMin]);
+            outValues.push_back(values[iMin]);
+            return;
+        }
+
+        // kept in time order, otherwise the line goes back and forth
+        bool minFirst=keys[iMin]<=keys[iMax];
+        int a=minFirst?iMin:iMax;
+        int b=minFirst?iMax:iMin;
+
+        outKeys.push_back(keys[a]);
+        outValues.push_back(values[a]);
+        outKeys.push_back(keys[b]);
+        outValues.push_back(values[b]);
+    }
+
+    std::vector<double> keys;
+    std::vector<double> values;
+    int first;
+    int count;
+};
+
+#endif // PLOTBUFFER_H
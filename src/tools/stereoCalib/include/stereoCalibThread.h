@@ -1,7 +1,11 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <deque>
 #include <mutex>
+#include <thread>
+#include <condition_variable>
 
 #include <opencv2/calib3d/calib3d_c.h>
 #include <opencv2/calib3d.hpp>
@@ -30,6 +34,9 @@ using namespace iCub::iKin;
 #define LEFT    0
 #define RIGHT   1
 
+// time [s] given to move the pattern to a new pose after a detection
+#define STEREOCALIB_POSE_DELAY  2.0
+
 class stereoCalibThread : public Thread
 {
 private:
@@ -72,9 +79,28 @@ private:
     string outNameLeft;
     string camCalibFile;
     string currentPathDir;
-    std::vector<string> imageListR;
-    std::vector<string> imageListL;
-    std::vector<string> imageListLR;
+
+    // the pattern detection runs on a pool of workers as frames arrive,
+    // and the detected corners are kept for the final calibration
+    struct DetectionJob
+    {
+        Mat image[2];
+        int views;
+        double stamp;
+    };
+
+    std::vector<std::thread> detectors;
+    std::deque<DetectionJob> detectionJobs;
+    mutex detectionMtx;
+    condition_variable detectionCond;
+    bool detectorsStop;
+    int busyDetectors;
+    int numOfDetectors;
+
+    std::vector<std::vector<Point2f> > cornersL;
+    std::vector<std::vector<Point2f> > cornersR;
+    Size cornersImageSize;
+    double lastPoseStamp;
 
     BufferedPort<ImageOf<PixelRgb> > imagePortInLeft;
     BufferedPort<ImageOf<PixelRgb> > imagePortInRight;
@@ -88,14 +114,20 @@ private:
     int boardHeight;
     float squareSize;
     string boardType;
-    char pathL[256];
-    char pathR[256];
     void printMatrix(Mat &matrix);
     bool checkTS(double TSLeft, double TSRight, double th=0.08);
     void preparePath(const char * imageDir, char* pathL, char* pathR, int num);
     void saveStereoImage(const char * imageDir, const Mat& left, const Mat& right, int num);
-    void monoCalibration(const vector<string>& imageList, int boardWidth, int boardHeight, Mat &K, Mat &Dist);
-    void stereoCalibration(const vector<string>& imagelist, int boardWidth, int boardHeight,float sqsizee);
+    void monoCalibration(const vector<vector<Point2f> >& imagePoints, const Size& imageSize, int boardWidth, int boardHeight, Mat &K, Mat &Dist);
+    void stereoCalibration(const vector<vector<Point2f> >& imagePointsL, const vector<vector<Point2f> >& imagePointsR, const Size& imageSize, int boardWidth, int boardHeight,float sqsizee);
+    bool findPattern(const Mat& image, vector<Point2f>& corners);
+    void startDetectors();
+    void stopDetectors();
+    bool submitDetection(ImageOf<PixelRgb> *left, ImageOf<PixelRgb> *right);
+    int countDetections();
+    void drainDetectors();
+    void detectionLoop();
+    void drawLastDetection(ImageOf<PixelRgb> &image, int view);
     void saveCalibration(const string& extrinsicFilePath, const string& intrinsicFilePath);
     void calcChessboardCorners(Size boardSize, float squareSize, vector<Point3f>& corners);
     bool updateIntrinsics( int width, int height, double fx, double fy,double cx, double cy, double k1, double k2, double p1, double p2, const string& groupname);
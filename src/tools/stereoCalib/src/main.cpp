@@ -45,6 +45,7 @@ boardHeight H
 boardSize S
 numberOfImages N
 MonoCalib value
+detectionThreads value
 \endcode
 
 This is the ONLY group used by the module. Other groups in your config file will
@@ -83,6 +84,13 @@ before the stereo calibration (default 30).
 calibration (Val=0) or the mono calibration (Val=1). For the mono calibration
 connect only the camera that you want to calibrate.
 
+--detectionThreads \e Num
+- The parameter \e Num identifies the number of workers detecting the pattern
+while the images are collected (default 2). The detected corners are retained
+and used directly for the calibration; the images are saved only for later
+inspection. After each detection, \e 2 seconds are given to move the pattern
+to a new pose.
+
 \section portsc_sec Ports Created
 - <i> /stereoCalib/cam/left:i </i> accepts the incoming images from the left
 eye.
@@ -1,4 +1,5 @@
 #include <utility>
+#include <algorithm>
 #include <yarp/cv/Cv.h>
 #include "stereoCalibThread.h"
 
@@ -26,6 +27,7 @@ stereoCalibThread::stereoCalibThread(ResourceFinder &rf, Port* commPort, const c
     this->numOfPairs= stereoCalibOpts.check("numberOfPairs", Value(30)).asInt32();
     this->squareSize= (float)stereoCalibOpts.check("boardSize", Value(0.09241)).asFloat64();
     this->boardType=  stereoCalibOpts.check("boardType", Value("CHESSBOARD")).asString();
+    this->numOfDetectors= std::max(stereoCalibOpts.check("detectionThreads", Value(2)).asInt32(),1);
     this->commandPort=commPort;
     this->imageDir=imageDir;
     this->startCalibration=0;
@@ -37,6 +39,10 @@ stereoCalibThread::stereoCalibThread(ResourceFinder &rf, Port* commPort, const c
     string fileName= "outputCalib.ini"; //rf.find("from").asString().c_str();
 
     this->camCalibFile=this->camCalibFile+"/"+fileName.c_str();
+
+    this->detectorsStop=false;
+    this->busyDetectors=0;
+    this->lastPoseStamp=-STEREOCALIB_POSE_DELAY;
 }
 
 bool stereoCalibThread::threadInit()
@@ -119,6 +125,8 @@ bool stereoCalibThread::threadInit()
 }
 void stereoCalibThread::run(){
 
+    startDetectors();
+
     if(stereo)
     {
         yInfo("Running Stereo Calibration Mode... \n");
@@ -141,11 +149,6 @@ void stereoCalibThread::stereoCalibRun()
     bool initL=false;
     bool initR=false;
 
-    int count=1;
-    Size boardSize, imageSize;
-    boardSize.width=this->boardWidth;
-    boardSize.height=this->boardHeight;
-
     while (!isStopping()) {
         ImageOf<PixelRgb> *tmpL = imagePortInLeft.read(false);
         ImageOf<PixelRgb> *tmpR = imagePortInRight.read(false);
@@ -165,89 +168,59 @@ void stereoCalibThread::stereoCalibRun()
 
         if(initL && initR && checkTS(TSLeft.getTime(),TSRight.getTime())){
 
-            bool foundL=false;
-            bool foundR=false;
-
             mtx.lock();
             if(startCalibration>0) {
 
-                string pathImg=imageDir;
-                preparePath(pathImg.c_str(),pathL,pathR,count);
-                string iml(pathL);
-                string imr(pathR);
-                Left=yarp::cv::toCvMat(*imageL);
-                Right=yarp::cv::toCvMat(*imageR);
-
-                std::vector<Point2f> pointbufL;
-                std::vector<Point2f> pointbufR;
-                if(boardType == "CIRCLES_GRID") {
-                    foundL = findCirclesGrid(Left, boardSize, pointbufL, CALIB_CB_SYMMETRIC_GRID  | CALIB_CB_CLUSTERING);
-                    foundR = findCirclesGrid(Right, boardSize, pointbufR, CALIB_CB_SYMMETRIC_GRID  | CALIB_CB_CLUSTERING);
-                } else if(boardType == "ASYMMETRIC_CIRCLES_GRID") {
-                    foundL = findCirclesGrid(Left, boardSize, pointbufL, CALIB_CB_ASYMMETRIC_GRID | CALIB_CB_CLUSTERING);
-                    foundR = findCirclesGrid(Right, boardSize, pointbufR, CALIB_CB_ASYMMETRIC_GRID | CALIB_CB_CLUSTERING);
-                } else {
-                    foundL = findChessboardCorners(Left, boardSize, pointbufL, CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_FAST_CHECK | CV_CALIB_CB_NORMALIZE_IMAGE);
-                    foundR = findChessboardCorners(Right, boardSize, pointbufR, CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_FAST_CHECK | CV_CALIB_CB_NORMALIZE_IMAGE);
-                }
+                // the pair is dropped if all the detectors are busy
+                submitDetection(imageL,imageR);
 
-                if(foundL && foundR) {
-                        cvtColor(Left,Left,CV_RGB2BGR);
-                        cvtColor(Right,Right,CV_RGB2BGR);
-                        saveStereoImage(pathImg.c_str(),Left,Right,count);
-
-                        imageListR.push_back(imr);
-                        imageListL.push_back(iml);
-                        imageListLR.push_back(iml);
-                        imageListLR.push_back(imr);
-                        Mat cL(pointbufL);
-                        Mat cR(pointbufR);
-                        drawChessboardCorners(Left, boardSize, cL, foundL);
-                        drawChessboardCorners(Right, boardSize, cR, foundR);
-                        count++;
-                }
+                if(countDetections()>=numOfPairs) {
+                    drainDetectors();
+
+                    vector<vector<Point2f> > imagePointsL, imagePointsR;
+                    Size imageSize;
+                    {
+                        lock_guard<mutex> lck(detectionMtx);
+                        imagePointsL.swap(cornersL);
+                        imagePointsR.swap(cornersR);
+                        imageSize=cornersImageSize;
+                    }
 
-                if(count>numOfPairs) {
                     yInfo(" Running Left Camera Calibration... \n");
-                    monoCalibration(imageListL,this->boardWidth,this->boardHeight,this->Kleft,this->DistL);
+                    monoCalibration(imagePointsL,imageSize,this->boardWidth,this->boardHeight,this->Kleft,this->DistL);
 
                     yInfo(" Running Right Camera Calibration... \n");
-                    monoCalibration(imageListR,this->boardWidth,this->boardHeight,this->Kright,this->DistR);
+                    monoCalibration(imagePointsR,imageSize,this->boardWidth,this->boardHeight,this->Kright,this->DistR);
 
-                    stereoCalibration(imageListLR, this->boardWidth,this->boardHeight,this->squareSize);
+                    stereoCalibration(imagePointsL,imagePointsR,imageSize,this->boardWidth,this->boardHeight,this->squareSize);
 
                     yInfo(" Saving Calibration Results... \n");
-                    updateIntrinsics(Right.cols,Right.rows,Kright.at<double>(0,0),Kright.at<double>(1,1),Kright.at<double>(0,2),Kright.at<double>(1,2),DistR.at<double>(0,0),DistR.at<double>(0,1),DistR.at<double>(0,2),DistR.at<double>(0,3),"CAMERA_CALIBRATION_RIGHT");
-                    updateIntrinsics(Left.cols,Left.rows,Kleft.at<double>(0,0),Kleft.at<double>(1,1),Kleft.at<double>(0,2),Kleft.at<double>(1,2),DistL.at<double>(0,0),DistL.at<double>(0,1),DistL.at<double>(0,2),DistL.at<double>(0,3),"CAMERA_CALIBRATION_LEFT");
-
-                    Mat Rot=Mat::eye(3,3,CV_64FC1);
-                    Mat Tr=Mat::zeros(3,1,CV_64FC1);
+                    updateIntrinsics(imageSize.width,imageSize.height,Kright.at<double>(0,0),Kright.at<double>(1,1),Kright.at<double>(0,2),Kright.at<double>(1,2),DistR.at<double>(0,0),DistR.at<double>(0,1),DistR.at<double>(0,2),DistR.at<double>(0,3),"CAMERA_CALIBRATION_RIGHT");
+                    updateIntrinsics(imageSize.width,imageSize.height,Kleft.at<double>(0,0),Kleft.at<double>(1,1),Kleft.at<double>(0,2),Kleft.at<double>(1,2),DistL.at<double>(0,0),DistL.at<double>(0,1),DistL.at<double>(0,2),DistL.at<double>(0,3),"CAMERA_CALIBRATION_LEFT");
 
                     updateExtrinsics(this->R,this->T,"STEREO_DISPARITY");
 
                     yInfo("Calibration Results Saved in %s \n", camCalibFile.c_str());
 
                     startCalibration=0;
-                    count=1;
-                    imageListR.clear();
-                    imageListL.clear();
-                    imageListLR.clear();
                 }
             }
             mtx.unlock();
             ImageOf<PixelRgb>& outimL=outPortLeft.prepare();
             outimL=*imageL;
+            drawLastDetection(outimL,LEFT);
             outPortLeft.write();
 
             ImageOf<PixelRgb>& outimR=outPortRight.prepare();
             outimR=*imageR;
+            drawLastDetection(outimR,RIGHT);
             outPortRight.write();
 
-            if(foundL && foundR && startCalibration==1)
-                Time::delay(2.0);
             initL=initR=false;
             cout.flush();
         }
+        else
+            Time::delay(0.005);
    }
 
    delete imageL;
@@ -279,14 +252,6 @@ void stereoCalibThread::monoCalibRun()
 
     yInfo("CALIBRATING %s CAMERA \n",cameraName.c_str());
 
-
-    int count=1;
-    Size boardSize, imageSize;
-    boardSize.width=this->boardWidth;
-    boardSize.height=this->boardHeight;
-
-
-
     while (!isStopping()) {
        if(left)
             imageL = imagePortInLeft.read(false);
@@ -294,62 +259,51 @@ void stereoCalibThread::monoCalibRun()
             imageL = imagePortInRight.read(false);
 
        if(imageL!=NULL){
-            bool foundL=false;
             mtx.lock();
             if(startCalibration>0) {
 
-                string pathImg=imageDir;
-                preparePath(pathImg.c_str(),pathL,pathR,count);
-                string iml(pathL);
-                Left=yarp::cv::toCvMat(*imageL);
-                std::vector<Point2f> pointbufL;
-
-                if(boardType == "CIRCLES_GRID") {
-                    foundL = findCirclesGrid(Left, boardSize, pointbufL, CALIB_CB_SYMMETRIC_GRID  | CALIB_CB_CLUSTERING);
-                } else if(boardType == "ASYMMETRIC_CIRCLES_GRID") {
-                    foundL = findCirclesGrid(Left, boardSize, pointbufL, CALIB_CB_ASYMMETRIC_GRID | CALIB_CB_CLUSTERING);
-                } else {
-                    foundL = findChessboardCorners(Left, boardSize, pointbufL, CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_FAST_CHECK | CV_CALIB_CB_NORMALIZE_IMAGE);
-                }
+                // the frame is dropped if all the detectors are busy
+                submitDetection(imageL,NULL);
 
-                if(foundL) {
-                        cvtColor(Left,Left,CV_RGB2BGR);
-                        saveImage(pathImg.c_str(),Left,count);
-                        imageListL.push_back(iml);
-                        Mat cL(pointbufL);
-                        drawChessboardCorners(Left, boardSize, cL, foundL);
-                        count++;
-                }
+                if(countDetections()>=numOfPairs) {
+                    drainDetectors();
+
+                    vector<vector<Point2f> > imagePoints;
+                    Size imageSize;
+                    {
+                        lock_guard<mutex> lck(detectionMtx);
+                        imagePoints.swap(cornersL);
+                        imageSize=cornersImageSize;
+                    }
 
-                if(count>numOfPairs) {
                     yInfo(" Running %s Camera Calibration... \n", cameraName.c_str());
-                    monoCalibration(imageListL,this->boardWidth,this->boardHeight,this->Kleft,this->DistL);
+                    monoCalibration(imagePoints,imageSize,this->boardWidth,this->boardHeight,this->Kleft,this->DistL);
 
                     yInfo(" Saving Calibration Results... \n");
-                    updateIntrinsics(Left.cols,Left.rows,Kleft.at<double>(0,0),Kleft.at<double>(1,1),Kleft.at<double>(0,2),
+                    updateIntrinsics(imageSize.width,imageSize.height,Kleft.at<double>(0,0),Kleft.at<double>(1,1),Kleft.at<double>(0,2),
                                      Kleft.at<double>(1,2),DistL.at<double>(0,0),DistL.at<double>(0,1),DistL.at<double>(0,2),
                                      DistL.at<double>(0,3),left?"CAMERA_CALIBRATION_LEFT":"CAMERA_CALIBRATION_RIGHT");
                     yInfo("Calibration Results Saved in %s \n", camCalibFile.c_str());
 
                     startCalibration=0;
-                    count=1;
-                    imageListL.clear();
                 }
             }
             mtx.unlock();
             ImageOf<PixelRgb>& outimL=outPortLeft.prepare();
             outimL=*imageL;
+            drawLastDetection(outimL,LEFT);
             outPortLeft.write();
 
             ImageOf<PixelRgb>& outimR=outPortRight.prepare();
             outimR=*imageL;
+            drawLastDetection(outimR,LEFT);
             outPortRight.write();
 
-            if(foundL && startCalibration==1)
-                Time::delay(2.0);
             cout.flush();
 
         }
+        else
+            Time::delay(0.005);
    }
 
 
@@ -362,6 +316,8 @@ void stereoCalibThread::threadRelease()
     outPortRight.close();
     commandPort->close();
 
+    stopDetectors();
+
     if (polyHead.isValid())
         polyHead.close();
 
@@ -403,6 +359,133 @@ void stereoCalibThread::printMatrix(Mat &matrix) {
 }
 
 
+bool stereoCalibThread::findPattern(const Mat& image, vector<Point2f>& corners) {
+    bool found=false;
+    if(boardType == "CIRCLES_GRID") {
+        found = findCirclesGrid(image, Size(boardWidth,boardHeight), corners, CALIB_CB_SYMMETRIC_GRID  | CALIB_CB_CLUSTERING);
+    } else if(boardType == "ASYMMETRIC_CIRCLES_GRID") {
+        found = findCirclesGrid(image, Size(boardWidth,boardHeight), corners, CALIB_CB_ASYMMETRIC_GRID | CALIB_CB_CLUSTERING);
+    } else {
+        found = findChessboardCorners(image, Size(boardWidth,boardHeight), corners, CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_FAST_CHECK | CV_CALIB_CB_NORMALIZE_IMAGE);
+        if(found) {
+            // the corners are not detected again before the calibration,
+            // hence they get refined here once for all
+            Mat gray;
+            cvtColor(image, gray, CV_RGB2GRAY);
+            cornerSubPix(gray, corners, Size(11,11), Size(-1,-1),
+                         TermCriteria(TermCriteria::MAX_ITER+TermCriteria::EPS, 30, 0.01));
+        }
+    }
+    return found;
+}
+
+void stereoCalibThread::startDetectors() {
+    detectorsStop=false;
+    for (int i=0; i<numOfDetectors; i++)
+        detectors.push_back(std::thread(&stereoCalibThread::detectionLoop,this));
+}
+
+void stereoCalibThread::stopDetectors() {
+    {
+        lock_guard<mutex> lck(detectionMtx);
+        detectorsStop=true;
+        detectionJobs.clear();
+        detectionCond.notify_all();
+    }
+    for (size_t i=0; i<detectors.size(); i++)
+        detectors[i].join();
+    detectors.clear();
+}
+
+bool stereoCalibThread::submitDetection(ImageOf<PixelRgb> *left, ImageOf<PixelRgb> *right) {
+    lock_guard<mutex> lck(detectionMtx);
+    double now=Time::now();
+    if (((int)detectionJobs.size()+busyDetectors>=(int)detectors.size()) ||
+        (now<lastPoseStamp+STEREOCALIB_POSE_DELAY))
+        return false;
+
+    DetectionJob job;
+    job.image[0]=yarp::cv::toCvMat(*left).clone();
+    job.views=1;
+    if (right!=NULL) {
+        job.image[1]=yarp::cv::toCvMat(*right).clone();
+        job.views=2;
+    }
+    job.stamp=now;
+    detectionJobs.push_back(job);
+    detectionCond.notify_all();
+    return true;
+}
+
+int stereoCalibThread::countDetections() {
+    lock_guard<mutex> lck(detectionMtx);
+    return (int)cornersL.size();
+}
+
+void stereoCalibThread::drainDetectors() {
+    unique_lock<mutex> lck(detectionMtx);
+    detectionCond.wait(lck,[this]() { return detectionJobs.empty() && (busyDetectors==0); });
+}
+
+void stereoCalibThread::detectionLoop() {
+    unique_lock<mutex> lck(detectionMtx);
+    while (true) {
+        detectionCond.wait(lck,[this]() { return detectorsStop || !detectionJobs.empty(); });
+        if (detectorsStop)
+            break;
+
+        DetectionJob job=detectionJobs.front();
+        detectionJobs.pop_front();
+        busyDetectors++;
+        lck.unlock();
+
+        vector<Point2f> corners[2];
+        bool found=true;
+        for (int k=0; (k<job.views) && found; k++)
+            found=findPattern(job.image[k],corners[k]);
+
+        lck.lock();
+        // a job submitted within the delay from the last accepted
+        // one shows the pattern in the same pose, hence it is dropped
+        if (found && (job.stamp>=lastPoseStamp+STEREOCALIB_POSE_DELAY) &&
+            ((int)cornersL.size()<numOfPairs)) {
+            lastPoseStamp=job.stamp;
+            cornersL.push_back(corners[0]);
+            if (job.views>1)
+                cornersR.push_back(corners[1]);
+            cornersImageSize=job.image[0].size();
+            int num=(int)cornersL.size();
+            lck.unlock();
+
+            // images are saved only for inspection
+            for (int k=0; k<job.views; k++)
+                cvtColor(job.image[k],job.image[k],CV_RGB2BGR);
+            if (job.views>1)
+                saveStereoImage(imageDir.c_str(),job.image[0],job.image[1],num);
+            else
+                saveImage(imageDir.c_str(),job.image[0],num);
+
+            lck.lock();
+        }
+        busyDetectors--;
+        detectionCond.notify_all();
+    }
+}
+
+void stereoCalibThread::drawLastDetection(ImageOf<PixelRgb> &image, int view) {
+    vector<Point2f> corners;
+    {
+        lock_guard<mutex> lck(detectionMtx);
+        vector<vector<Point2f> > &cache=(view==LEFT)?cornersL:cornersR;
+        if (cache.empty() || (Time::now()>lastPoseStamp+STEREOCALIB_POSE_DELAY))
+            return;
+        corners=cache.back();
+    }
+
+    Mat img=yarp::cv::toCvMat(image);
+    drawChessboardCorners(img, Size(boardWidth,boardHeight), Mat(corners), true);
+}
+
 bool stereoCalibThread::checkTS(double TSLeft, double TSRight, double th) {
     double diff=fabs(TSLeft-TSRight);
     if(diff <th)
@@ -444,6 +527,7 @@ void stereoCalibThread::saveStereoImage(const char * imageDir, const Mat& left,
 
 void stereoCalibThread::saveImage(const char * imageDir, const Mat& left, int num) {
     char pathL[256];
+    char pathR[256];
     preparePath(imageDir, pathL,pathR,num);
 
     yInfo("Saving images number %d \n",num);
@@ -597,44 +681,15 @@ bool stereoCalibThread::updateIntrinsics(int width, int height, double fx, doubl
     return true;
 }
 
-void stereoCalibThread::monoCalibration(const vector<string>& imageList, int boardWidth, int boardHeight, Mat &K, Mat &Dist)
+void stereoCalibThread::monoCalibration(const vector<vector<Point2f> >& imagePoints, const Size& imageSize, int boardWidth, int boardHeight, Mat &K, Mat &Dist)
 {
-    vector<vector<Point2f> > imagePoints;
-    Size boardSize, imageSize;
+    Size boardSize;
     boardSize.width=boardWidth;
     boardSize.height=boardHeight;
     int flags=0;
-    int i;
 
     float squareSize = 1.f, aspectRatio = 1.f;
 
-      Mat view, viewGray;
-
-    for(i = 0; i<(int)imageList.size();i++)
-    {
-
-         view = cv::imread(imageList[i], 1);
-         imageSize = view.size();
-         vector<Point2f> pointbuf;
-         cvtColor(view, viewGray, CV_BGR2GRAY);
-
-         bool found = false;
-         if(boardType == "CIRCLES_GRID") {
-             found = findCirclesGrid(view, boardSize, pointbuf, CALIB_CB_SYMMETRIC_GRID  | CALIB_CB_CLUSTERING);
-         } else if(boardType == "ASYMMETRIC_CIRCLES_GRID") {
-             found = findCirclesGrid(view, boardSize, pointbuf, CALIB_CB_ASYMMETRIC_GRID | CALIB_CB_CLUSTERING);
-         } else {
-             found = findChessboardCorners( view, boardSize, pointbuf,
-                                            CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_FAST_CHECK | CV_CALIB_CB_NORMALIZE_IMAGE);
-         }
-
-         if(found)
-         {
-            drawChessboardCorners( view, boardSize, Mat(pointbuf), found );
-            imagePoints.push_back(pointbuf);
-         }
-
-    }
     std::vector<Mat> rvecs, tvecs;
     std::vector<float> reprojErrs;
     double totalAvgErr = 0;
@@ -656,84 +711,25 @@ void stereoCalibThread::monoCalibration(const vector<string>& imageList, int boa
 }
 
 
-void stereoCalibThread::stereoCalibration(const vector<string>& imagelist, int boardWidth, int boardHeight,float sqsize)
+void stereoCalibThread::stereoCalibration(const vector<vector<Point2f> >& imagePointsL, const vector<vector<Point2f> >& imagePointsR, const Size& imageSize, int boardWidth, int boardHeight,float sqsize)
 {
     Size boardSize;
     boardSize.width=boardWidth;
     boardSize.height=boardHeight;
-    if( imagelist.size() % 2 != 0 )
+    if( imagePointsL.size() != imagePointsR.size() )
     {
-        cout << "Error: the image list contains odd (non-even) number of elements\n";
+        cout << "Error: the left and right corners differ in number\n";
         return;
     }
 
-    const int maxScale = 2;
-    // ARRAY AND VECTOR STORAGE:
-
+    // the corners come from the detections cached while the pairs were collected
     std::vector<std::vector<Point2f> > imagePoints[2];
-    Size imageSize;
-
-    int i, j, k, nimages = (int)imagelist.size()/2;
+    imagePoints[0]=imagePointsL;
+    imagePoints[1]=imagePointsR;
 
-    imagePoints[0].resize(nimages);
-    imagePoints[1].resize(nimages);
-    std::vector<string> goodImageList;
-    bool differentSizes = false;
-
-    for( i = j = 0; i < nimages; i++ )
-    {
-        for( k = 0; k < 2; k++ )
-        {
-            const string& filename = imagelist[i*2+k];
-            Mat img = cv::imread(filename, 0);
-            if(img.empty())
-                break;
-            if( imageSize == Size() )
-                imageSize = img.size();
-            else if( img.size() != imageSize )
-            {
-                yWarning() <<"The image " << filename << " has the size different from the first image size.\n";
-                differentSizes = true;
-            }
-            bool found = false;
-            std::vector<Point2f>& corners = imagePoints[k][j];
-            for( int scale = 1; scale <= maxScale; scale++ )
-            {
-                Mat timg;
-                if( scale == 1 )
-                    timg = img;
-                else
-                    resize(img, timg, Size(), scale, scale);
-
-                if(boardType == "CIRCLES_GRID") {
-                    found = findCirclesGrid(timg, boardSize, corners, CALIB_CB_SYMMETRIC_GRID  | CALIB_CB_CLUSTERING);
-                } else if(boardType == "ASYMMETRIC_CIRCLES_GRID") {
-                    found = findCirclesGrid(timg, boardSize, corners, CALIB_CB_ASYMMETRIC_GRID | CALIB_CB_CLUSTERING);
-                } else {
-                    found = findChessboardCorners(timg, boardSize, corners,
-                                                  CV_CALIB_CB_ADAPTIVE_THRESH | CV_CALIB_CB_NORMALIZE_IMAGE);
-                }
+    int i, j, k, nimages;
+    j = (int)imagePointsL.size();
 
-                if( found )
-                {
-                    if( scale > 1 )
-                    {
-                        Mat cornersMat(corners);
-                        cornersMat *= 1./scale;
-                    }
-                    break;
-                }
-            }
-            if( !found )
-                break;
-            }
-        if( k == 2 )
-        {
-            goodImageList.push_back(imagelist[i*2]);
-            goodImageList.push_back(imagelist[i*2+1]);
-            j++;
-        }
-    }
     yInfo("%i pairs have been successfully detected.\n",j);
     nimages = j;
     if( nimages < 2 )
@@ -742,11 +738,8 @@ void stereoCalibThread::stereoCalibration(const vector<string>& imagelist, int b
         return;
     }
 
-    imagePoints[0].resize(nimages);
-    imagePoints[1].resize(nimages);
-
     std::vector<std::vector<Point3f> > objectPoints(1);
-    calcChessboardCorners(boardSize, squareSize, objectPoints[0]);
+    calcChessboardCorners(boardSize, sqsize, objectPoints[0]);
     objectPoints.resize(nimages, objectPoints[0]);
 
     yInfo("Running stereo calibration ...\n");
@@ -755,10 +748,6 @@ void stereoCalibThread::stereoCalibration(const vector<string>& imagelist, int b
     Mat E, F;
     if(this->Kleft.empty() || this->Kright.empty())
     {
-        if (differentSizes){
-            yError("Images have different sizes. Please make sure to compute intrinsic parameters before running stereo calibration. Quitting...");
-            exit (-1);
-        }
         double rms = stereoCalibrate(objectPoints, imagePoints[0], imagePoints[1],
                         this->Kleft, this->DistL,
                         this->Kright, this->DistR,
@@ -206,17 +206,11 @@ public:
         if (!driver) return false;
         if (!enable_execute_joint_command) return true;
 
-        double *ll = actions.action_vector[action_id].q_joints;
-        int nj = actions.action_vector[action_id].get_n_joints();
-
-        for (int j = 0; j < nj; j++)
-        {
-            driver->setPosition(j, ll[j]);
-        }
-        return true;
+        //all the joints in one command
+        return driver->setPositions(actions.action_vector[action_id].q_joints);
     }
 
-    void compute_and_send_command(int action_id)
+    void compute_and_send_command(int action_id, bool execute=true)
     {
         //prepare the output command
         Bottle& bot = port_command_out.prepare();
@@ -228,7 +222,7 @@ public:
 
         //send the output command
         port_command_out.write();
-        if (!execute_joint_command(action_id))
+        if (execute && !execute_joint_command(action_id))
         {
             yError("failed to execute command");
         }
@@ -301,6 +295,31 @@ public:
                 return;
             }
 
+            //the interpolated trajectory is commanded at every cycle, the
+            //waypoints are only reported on the ports
+            if (actions.interpolation != INTERP_NONE &&
+                (actions.compiled_samples > 0 || actions.compile(getPeriod())))
+            {
+                double elapsed_time = current_time - start_time;
+                size_t k = (size_t)(elapsed_time / actions.compiled_period);
+                if (k < actions.compiled_samples)
+                {
+                    double t0 = actions.action_vector[0].time;
+                    while (actions.current_action < last_action-1 &&
+                           actions.action_vector[actions.current_action+1].time - t0 <= elapsed_time)
+                    {
+                        actions.current_action++;
+                        compute_and_send_command(actions.current_action, false);
+                    }
+                    if (enable_execute_joint_command && !driver->setPositions(actions.compiled_row(k)))
+                    {
+                        yError("failed to execute command");
+                    }
+                    return;
+                }
+                actions.current_action = last_action-1;
+            }
+
             //if it's not the last action
             if (actions.current_action < last_action-1)
             {
@@ -341,6 +360,11 @@ public:
         {
             if (actions.action_vector.size()>0)
             {
+                if (actions.interpolation != INTERP_NONE && !actions.compile(getPeriod()))
+                {
+                    yWarning() << "unable to interpolate the sequence, playing the waypoints";
+                }
+
                 double *ll = actions.action_vector[0].q_joints;
                 int nj = actions.action_vector[0].get_n_joints();
                 for (int j = 0; j < nj; j++)
@@ -492,6 +516,17 @@ public:
             yInfo() << "Thread period set to " << period << "ms";
             w_thread.setPeriod((double)period/1000.0);
         }
+
+        string interpolation = rf.check("interpolation", Value("none")).asString();
+        if (interpolation == "cubic")
+            w_thread.actions.interpolation = INTERP_CUBIC;
+        else if (interpolation == "minjerk")
+            w_thread.actions.interpolation = INTERP_MINJERK;
+        else if (interpolation != "none")
+        {
+            yError() << "Unknown interpolation" << interpolation << ", use none, cubic or minjerk";
+            return false;
+        }
         yInfo() << "Using parameters:"  << rf.toString();
 
         //*** open the position file
@@ -708,6 +743,7 @@ int main(int argc, char *argv[])
         yInfo() << "\t--filename     <filename>:   the positions file";
         yInfo() << "\t--execute      activate the iPid->setReference() control";
         yInfo() << "\t--period       <period>: the period in ms of the internal thread (default 5)";
+        yInfo() << "\t--interpolation <none|cubic|minjerk>: resample the sequence at the period of the thread (default none)";
         yInfo() << "\t--verbose      to display additional infos";
         return 0;
     }
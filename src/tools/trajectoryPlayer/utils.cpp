@@ -103,13 +103,96 @@ void action_class::clear()
     current_action = 0;
     current_status = ACTION_IDLE;
     action_vector.clear();
+    compiled.clear();
+    compiled_samples = 0;
 }
 
 action_class::action_class()
 {
+    interpolation = INTERP_NONE;
+    compiled_period = 0.0;
     clear();
 }
 
+bool action_class::compile(double period)
+{
+    compiled.clear();
+    compiled_samples = 0;
+    compiled_period = period;
+
+    size_t n = action_vector.size();
+    if (n == 0 || period <= 0.0) return false;
+    for (size_t i = 1; i < n; i++)
+    {
+        if (action_vector[i].time < action_vector[i-1].time)
+        {
+            yError("the sequence is not sorted by time, unable to interpolate it\n");
+            return false;
+        }
+    }
+
+    int nj = action_vector[0].get_n_joints();
+    double t0 = action_vector[0].time;
+    compiled_samples = (size_t)((action_vector[n-1].time - t0) / period) + 1;
+    compiled.resize(compiled_samples*nj);
+
+    //the velocities at the waypoints, zero at the two ends
+    std::vector<double> vel(n*nj, 0.0);
+    for (size_t i = 1; i+1 < n; i++)
+    {
+        double dt = action_vector[i+1].time - action_vector[i-1].time;
+        if (dt <= 0.0) continue;
+        for (int j = 0; j < nj; j++)
+            vel[i*nj+j] = (action_vector[i+1].q_joints[j] - action_vector[i-1].q_joints[j]) / dt;
+    }
+
+    size_t seg = 0;
+    for (size_t k = 0; k < compiled_samples; k++)
+    {
+        double* row = &compiled[k*nj];
+        if (n == 1)
+        {
+            for (int j = 0; j < nj; j++) row[j] = action_vector[0].q_joints[j];
+            continue;
+        }
+
+        double t = t0 + k*period;
+        while (seg+2 < n && action_vector[seg+1].time <= t) seg++;
+        double ta = action_vector[seg].time;
+        double h = action_vector[seg+1].time - ta;
+        double s = (h > 0.0) ? (t - ta) / h : 1.0;
+        if (s > 1.0) s = 1.0;
+
+        //hermite segment through the waypoints: a cubic, or the quintic
+        //with zero accelerations at the ends (minimum jerk)
+        double s2 = s*s, s3 = s2*s;
+        double h00, h10, h01, h11;
+        if (interpolation == INTERP_MINJERK)
+        {
+            double s4 = s3*s, s5 = s4*s;
+            h00 = 1.0 - 10.0*s3 + 15.0*s4 - 6.0*s5;
+            h10 = s - 6.0*s3 + 8.0*s4 - 3.0*s5;
+            h01 = 10.0*s3 - 15.0*s4 + 6.0*s5;
+            h11 = -4.0*s3 + 7.0*s4 - 3.0*s5;
+        }
+        else
+        {
+            h00 = 2.0*s3 - 3.0*s2 + 1.0;
+            h10 = s3 - 2.0*s2 + s;
+            h01 = -2.0*s3 + 3.0*s2;
+            h11 = s3 - s2;
+        }
+
+        const double* qa = action_vector[seg].q_joints;
+        const double* qb = action_vector[seg+1].q_joints;
+        const double* va = &vel[seg*nj];
+        const double* vb = &vel[(seg+1)*nj];
+        for (int j = 0; j < nj; j++)
+            row[j] = h00*qa[j] + h10*h*va[j] + h01*qb[j] + h11*h*vb[j];
+    }
+    return true;
+}
+
 void action_class::print()
 {
     for (action_it=action_vector.begin(); action_it<action_vector.end(); action_it++)
@@ -161,6 +244,7 @@ bool action_class::parseCommandLineFixTime(const char* command_line, int line, d
     static int count = 0;
     static double time =0.0;
     action_struct tmp_action(n_joints);
+    compiled_samples = 0;
 
     tmp_action.counter = count; count = count + 1;
     tmp_action.time    = time;  time = time+fixTime;
@@ -203,6 +287,7 @@ bool action_class::parseCommandLineFixTime(const char* command_line, int line, d
 bool action_class::parseCommandLine(const char* command_line, int line, int n_joints)
 {
     action_struct tmp_action(n_joints);
+    compiled_samples = 0;
     //use strtok for runtime-defined number of entries
     char command_line_format [1000];
     sprintf(command_line_format, "%%d %%lf    ");
@@ -330,6 +415,17 @@ bool robotDriver::setPosition(int j, double ref)
     return iposdir_ll->setPosition(joints_map[j], ref);
 }
 
+bool robotDriver::setPositions(const double *refs)
+{
+    if (!iposdir_ll) return false;
+    if ((int)joints_list.size() != n_joints)
+    {
+        joints_list.resize(n_joints);
+        for (int j = 0; j < n_joints; j++) joints_list[j] = joints_map[j];
+    }
+    return iposdir_ll->setPositions(n_joints, joints_list.data(), refs);
+}
+
 bool robotDriver::getEncoder(int j, double *v)
 {
     if (!ienc_ll) return false;
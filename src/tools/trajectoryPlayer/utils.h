@@ -57,6 +57,10 @@ using namespace yarp::math;
 #define ACTION_STOP    3
 #define ACTION_RESET   4
 
+#define INTERP_NONE    0
+#define INTERP_CUBIC   1
+#define INTERP_MINJERK 2
+
 // ******************** ACTION CLASS
 class action_struct
 {
@@ -84,7 +88,16 @@ public:
     std::deque<action_struct> action_vector;
     std::deque<action_struct>::iterator action_it;
 
+    // the trajectory resampled at the period of the thread, one row of
+    // joints per sample, filled by compile()
+    int                 interpolation;
+    std::vector<double> compiled;
+    size_t              compiled_samples;
+    double              compiled_period;
+
     void clear();
+    bool compile(double period);
+    const double* compiled_row(size_t k) { return &compiled[k*action_vector[0].get_n_joints()]; }
     action_class();
     void print();
     bool openFile(string filename, int n_joints);
@@ -107,6 +120,7 @@ private:
     IControlMode     *icmd_ll;
     IEncoders        *ienc_ll;
     IMotorEncoders   *imotenc_ll;
+    std::vector<int>  joints_list;
 
 public:
     int              n_joints;
@@ -119,6 +133,7 @@ public:
     ~robotDriver();
     bool setControlMode(const int j, const int mode);
     bool setPosition(int j, double ref);
+    bool setPositions(const double *refs);
     bool getEncoder(int j, double *v);
     bool positionMove(int j, double ref);
 };
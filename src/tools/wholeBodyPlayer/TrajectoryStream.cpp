@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "TrajectoryStream.h"
+
+#include <algorithm>
+#include <sstream>
+
+TrajectoryStream::~TrajectoryStream()
+{
+    close();
+}
+
+bool TrajectoryStream::open(const std::string& fileName, size_t depth)
+{
+    m_file.open(fileName);
+    if (!m_file.is_open()) {
+        return false;
+    }
+    m_depth = std::max<size_t>(depth, 1);
+    m_eof = false;
+    m_closing = false;
+    m_prefetch = std::thread(&TrajectoryStream::run, this);
+    return true;
+}
+
+void TrajectoryStream::close()
+{
+    if (!m_prefetch.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_closing = true;
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+    }
+    m_prefetch.join();
+    m_file.close();
+}
+
+void TrajectoryStream::run()
+{
+    std::string line;
+    while (!m_closing && std::getline(m_file, line)) {
+        // the values may be written as a list
+        std::replace(line.begin(), line.end(), '(', ' ');
+        std::replace(line.begin(), line.end(), ')', ' ');
+        std::istringstream fields(line);
+        double counter;
+        Sample sample;
+        if (!(fields >> counter >> sample.time)) {
+            continue;
+        }
+        double v;
+        while (fields >> v) {
+            sample.values.push_back(v);
+        }
+        if (sample.values.empty()) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_closing && m_queue.size() >= m_depth) {
+            m_notFull.wait(lock);
+        }
+        m_queue.push_back(std::move(sample));
+        m_notEmpty.notify_all();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_eof = true;
+    m_notEmpty.notify_all();
+}
+
+bool TrajectoryStream::firstTime(double& time)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_closing && !m_eof && m_queue.empty()) {
+        m_notEmpty.wait(lock);
+    }
+    if (m_queue.empty()) {
+        return false;
+    }
+    time = m_queue.front().time;
+    return true;
+}
+
+bool TrajectoryStream::next(double time, std::vector<double>& values)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    bool due{false};
+    // the samples older than the latest due are skipped, as they would have
+    // been overwritten within the same tick anyway
+    while (!m_queue.empty() && m_queue.front().time <= time) {
+        values.swap(m_queue.front().values);
+        m_queue.pop_front();
+        due = true;
+    }
+    if (due) {
+        m_notFull.notify_all();
+    }
+    return due;
+}
+
+bool TrajectoryStream::isFinished()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_eof && m_queue.empty();
+}
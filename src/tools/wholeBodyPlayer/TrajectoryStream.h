@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef WHOLEBODYPLAYER_TRAJECTORYSTREAM_H
+#define WHOLEBODYPLAYER_TRAJECTORYSTREAM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Reads the log of one part while it is played back: a thread parses the
+ * lines ahead of the playback and keeps at most depth samples in memory, so
+ * that a long recording neither takes long to load nor fills the memory.
+ *
+ * The lines are the ones written by the dataDumper (or by the text log of the
+ * controlBoardDumper): a counter, a time stamp and the joint positions.
+ */
+class TrajectoryStream
+{
+public:
+    struct Sample {
+        double time{0.0};
+        std::vector<double> values;
+    };
+
+    ~TrajectoryStream();
+
+    bool open(const std::string& fileName, size_t depth = 1000);
+    void close();
+
+    /**
+     * Waits for the first sample.
+     * @param time filled with its time stamp
+     * @return false if the log has no samples
+     */
+    bool firstTime(double& time);
+
+    /**
+     * Takes the samples due at a given time, without waiting.
+     * @param time the time of the log
+     * @param values filled with the latest sample due
+     * @return false if no sample is due, or if the prefetch is late
+     */
+    bool next(double time, std::vector<double>& values);
+
+    /**
+     * @return true once all the samples have been taken
+     */
+    bool isFinished();
+
+private:
+    std::ifstream m_file;
+    size_t m_depth{0};
+    std::deque<Sample> m_queue;
+    bool m_eof{false};
+    std::atomic<bool> m_closing{false};
+    std::mutex m_mutex;
+    std::condition_variable m_notFull;
+    std::condition_variable m_notEmpty;
+    std::thread m_prefetch;
+
+    void run();
+};
+
+#endif
@@ -8,6 +8,7 @@
 
 #include "WholeBodyPlayerModule.h"
 #include <algorithm>
+#include <limits>
 #include <yarp/dev/GenericVocabs.h>
 
 using namespace yarp::os;
@@ -17,12 +18,71 @@ using namespace std;
 
 static const std::vector<std::string> partsVec {"head","torso","left_arm","right_arm","left_leg","right_leg"};
 
+bool ReplayThread::threadInit() {
+    m_logStart = std::numeric_limits<double>::max();
+    for (auto& rep : m_replayers) {
+        double t;
+        if (rep.m_stream && rep.m_stream->firstTime(t)) {
+            m_logStart = std::min(m_logStart, t);
+        }
+    }
+    m_wallStart = Time::now();
+    return true;
+}
+
+void ReplayThread::run() {
+    std::lock_guard<std::mutex> lck(m_mutex);
+    if (m_paused) {
+        return;
+    }
+
+    bool finished{true};
+    double t = m_logStart + Time::now() - m_wallStart;
+    for (auto& rep : m_replayers) {
+        if (!rep.m_stream) {
+            finished = false;
+            continue;
+        }
+        if (rep.m_stream->next(t, m_sample)) {
+            rep.m_replayPort->setTarget(m_sample);
+        }
+        finished &= rep.m_stream->isFinished();
+    }
+
+    // the commands of all the parts leave together
+    for (auto& rep : m_replayers) {
+        rep.m_replayPort->send();
+    }
+    m_finished = finished;
+}
+
+void ReplayThread::pausePlayback() {
+    std::lock_guard<std::mutex> lck(m_mutex);
+    if (!m_paused) {
+        m_paused = true;
+        m_pausedAt = Time::now();
+    }
+}
+
+void ReplayThread::resumePlayback() {
+    std::lock_guard<std::mutex> lck(m_mutex);
+    if (m_paused) {
+        m_paused = false;
+        m_wallStart += Time::now() - m_pausedAt;
+    }
+}
+
 double WholeBodyPlayerModule::getPeriod() {
     return 0.001;
 }
 
 bool WholeBodyPlayerModule::updateModule() {
 
+    if (m_replayThread->isFinished()) {
+        yInfo()<<"wholeBodyPlayer: the playback of the dataset is over.. closing";
+        return false;
+    }
+
     for (auto& rep : m_replayerVec){
         if (rep.m_replayPort->m_state == state::fatal_error) {
             yError()<<"wholeBodyPlayer: the port"<<rep.m_replayPort->getName()<<"is closed because something went wrong.. closing";
@@ -31,8 +91,12 @@ bool WholeBodyPlayerModule::updateModule() {
             bool ok{true};
             response.clear();
             // pause
-            ok &= m_rpcPort.write(reqPause, response);
-            if (!ok || response.get(0).asVocab32() != VOCAB_OK) {
+            if (m_dataset) {
+                m_replayThread->pausePlayback();
+            } else {
+                ok &= m_rpcPort.write(reqPause, response);
+            }
+            if (!ok || (!m_dataset && response.get(0).asVocab32() != VOCAB_OK)) {
                 yError()<<"wholeBodyPlayer: the port"<<rep.m_replayPort->getName()<<"is closed because the pause request failed.. closing";
                 return false;
             }
@@ -46,8 +110,12 @@ bool WholeBodyPlayerModule::updateModule() {
 
             // start
             response.clear();
-            ok &= m_rpcPort.write(reqPlay, response);
-            if (!ok || response.get(0).asVocab32() != VOCAB_OK) {
+            if (m_dataset) {
+                m_replayThread->resumePlayback();
+            } else {
+                ok &= m_rpcPort.write(reqPlay, response);
+            }
+            if (!ok || (!m_dataset && response.get(0).asVocab32() != VOCAB_OK)) {
                 yError()<<"wholeBodyPlayer: the port"<<rep.m_replayPort->getName()<<"is closed because the start request failed.. closing";
                 return false;
             }
@@ -61,6 +129,10 @@ bool WholeBodyPlayerModule::updateModule() {
 bool WholeBodyPlayerModule::configure(yarp::os::ResourceFinder& rf) {
     auto robot = rf.check("robot",Value("icub")).asString();
     auto name = rf.check("name",Value("wholeBodyPlayerModule")).asString();
+    auto period = rf.check("period",Value(0.005)).asFloat64();
+    auto dataset = rf.check("dataset",Value("")).asString();
+    auto prefetch = rf.check("prefetch",Value(1000)).asInt32();
+    m_dataset = !dataset.empty();
 
     auto partsBot = rf.find("parts").asList();
     if (!partsBot || partsBot->isNull())
@@ -83,15 +155,31 @@ bool WholeBodyPlayerModule::configure(yarp::os::ResourceFinder& rf) {
             yError()<<"wholeBodyPlayerModule: failed to open one replayer.. closing.";
             return false;
         }
+        if (m_dataset) {
+            auto fileName = dataset+"/"+partStr+"/data.log";
+            m_replayerVec[i].m_stream = std::make_unique<TrajectoryStream>();
+            if (!m_replayerVec[i].m_stream->open(fileName, prefetch)) {
+                yError()<<"wholeBodyPlayerModule: failed to open"<<fileName;
+                return false;
+            }
+        }
     }
 
-    if (!m_rpcPort.open("/"+name+"/rpc:o")) {
-        yError()<<"wholeBodyPlayerModule: failed to open"<<m_rpcPort.getName();
-        return false;
+    if (!m_dataset) {
+        if (!m_rpcPort.open("/"+name+"/rpc:o")) {
+            yError()<<"wholeBodyPlayerModule: failed to open"<<m_rpcPort.getName();
+            return false;
+        }
+
+        if (!Network::connect(m_rpcPort.getName(), "/yarpdataplayer/rpc:i")) {
+            yError()<<"wholeBodyPlayerModule: failed to connect to the yarpdataplayer, is it running?";
+            return false;
+        }
     }
 
-    if (!Network::connect(m_rpcPort.getName(), "/yarpdataplayer/rpc:i")) {
-        yError()<<"wholeBodyPlayerModule: failed to connect to the yarpdataplayer, is it running?";
+    m_replayThread = std::make_unique<ReplayThread>(m_replayerVec, period);
+    if (!m_replayThread->start()) {
+        yError()<<"wholeBodyPlayerModule: failed to start the replay thread";
         return false;
     }
 
@@ -111,6 +199,9 @@ bool WholeBodyPlayerModule::interruptModule() {
 }
 
 bool WholeBodyPlayerModule::close() {
+    if (m_replayThread) {
+        m_replayThread->stop();
+    }
     for (auto& rep : m_replayerVec){
         rep.close();
     }
@@ -28,6 +28,10 @@
  * --robot  The name of the robot to be controlled (e.g icub, icubSim, cer). icub is the default value.
  * --name   The prefix to be given to the ports of the module. wholeBodyPlayer is the default value.
  * --parts  List of parts to be controlled. It has to be from one to all the following parts: "(head torso left_arm right_arm left_leg right_arm)"
+ * --period The period in seconds of the thread which commands all the parts in the same tick. 0.005 is the default value.
+ * --dataset The directory of a dataset of the dataDumper, with one <part>/data.log for each part. If given, the module
+ *           plays it back by itself instead of receiving the data from yarpdataplayer: the logs are read while they
+ *           are played, a few seconds ahead (--prefetch samples, 1000 by default).
  *
  * \section ports Ports
  * This module open one port for each part controlled, from which it receive data from yarpdataplayer.
@@ -52,12 +56,16 @@
 #include <yarp/dev/IControlLimits.h>
 #include <yarp/dev/PolyDriver.h>
 
+#include <algorithm>
 #include <atomic>
 #include <vector>
 #include <cmath>
 #include <memory>
 #include <mutex>
 #include <yarp/os/RpcClient.h>
+#include <yarp/os/PeriodicThread.h>
+
+#include "TrajectoryStream.h"
 
 constexpr double tolerance = 5.0; //degrees
 
@@ -92,6 +100,7 @@ public:
             // Allocate vectors
             m_currState.resize(m_numAxes);
             m_nextState.resize(m_numAxes);
+            m_toSend.resize(m_numAxes);
             max.resize(m_numAxes);
             min.resize(m_numAxes);
             for (size_t i = 0; i<m_numAxes; i++) {
@@ -106,12 +115,27 @@ public:
     using yarp::os::TypedReaderCallback<yarp::os::Bottle>::onRead;
     void onRead(yarp::os::Bottle& datum) override
     {
-        if (m_state==state::ok && m_posDir && !datum.isNull()) {
+        if (!datum.isNull()) {
+            m_sample.resize(datum.size());
+            for (size_t i=0; i<datum.size(); i++) {
+                m_sample[i] = datum.get(i).asFloat64();
+            }
+            setTarget(m_sample);
+        }
+    }
+
+    /**
+     * Checks the next target of the part, which is commanded by send().
+     */
+    void setTarget(const std::vector<double>& target)
+    {
+        if (m_state==state::ok && m_posDir) {
 
             bool ok = m_enc->getEncoders(m_currState.data());
+            size_t n = std::min(target.size(), (size_t)m_numAxes);
             m_mutex.lock();
-            for (size_t i=0; i<datum.size(); i++) {
-                m_nextState[i] = datum.get(i).asFloat64();
+            for (size_t i=0; i<n; i++) {
+                m_nextState[i] = target[i];
                 if (m_nextState[i]<min[i] || m_nextState[i]> max[i]) {
                     yWarning()<<"ReplayPort: trying to move joint"<<i<<"of"<<m_partName<<" to "<<m_nextState[i]<<", it exceeds the limits, skipping...";
                     continue;
@@ -120,7 +144,7 @@ public:
                 ok &= delta < tolerance; // TODO improve the check calculating the distance between the 2 vector !!!
                 if (!ok && !m_simulator && (!m_isArm || i < 5)) { // 5 is for ignoring the hands in the security check
                     yWarning()<<"ReplayPort: joint"<<i<<"of"<<m_partName<<"is too far to the target position";
-                    yWarning()<<"Desired: "<<datum.get(i).asFloat64()<<"current: "<<m_currState[i]
+                    yWarning()<<"Desired: "<<target[i]<<"current: "<<m_currState[i]
                     <<"delta: "<<delta<<"Trying to reach "
                                                                                                         "it in Position Control, "
                                                                                                         "the playback will be paused";
@@ -131,11 +155,24 @@ public:
             }
             m_mutex.unlock();
             if (m_state == state::ok) {
-                m_posDir->setPositions(m_nextState.data());
+                m_fresh = true;
             }
         }
     }
 
+    /**
+     * Commands the last target set, if it has not been sent yet.
+     */
+    void send()
+    {
+        if (m_state == state::ok && m_posDir && m_fresh.exchange(false)) {
+            m_mutex.lock();
+            m_toSend = m_nextState;
+            m_mutex.unlock();
+            m_posDir->setPositions(m_toSend.data());
+        }
+    }
+
     bool positionMoveFallback(){
         bool ok = true;
         std::vector<int> cms (m_numAxes, VOCAB_CM_POSITION);
@@ -193,7 +230,8 @@ private:
     std::mutex m_mutex;
 
 
-    std::vector<double> m_currState, m_nextState;
+    std::vector<double> m_currState, m_nextState, m_toSend, m_sample;
+    std::atomic<bool> m_fresh{false};
     int m_numAxes{0};
     bool m_simulator;
     bool m_isArm{false};
@@ -202,6 +240,7 @@ private:
 struct Replayer {
     std::unique_ptr<ReplayPort> m_replayPort{nullptr};
     std::unique_ptr<yarp::dev::PolyDriver> m_remoteControlBoard{nullptr};
+    std::unique_ptr<TrajectoryStream> m_stream{nullptr};
 
     bool open(const std::string& robot, const std::string& part, const std::string& moduleName="wholeBodyPlayer") {
         yarp::os::Property conf {{"device", yarp::os::Value("remote_controlboard")},
@@ -240,11 +279,42 @@ struct Replayer {
     }
 
     void close() {
+        if (m_stream) {
+            m_stream->close();
+        }
         m_replayPort->close();
         m_remoteControlBoard->close();
     }
 };
 
+/**
+ * Commands all the parts in the same tick: the targets received by the ports,
+ * or the samples of the dataset which are due at the time of the playback.
+ */
+class ReplayThread : public yarp::os::PeriodicThread
+{
+public:
+    ReplayThread(std::vector<Replayer>& replayers, double period) :
+        yarp::os::PeriodicThread(period), m_replayers(replayers) {}
+
+    bool threadInit() override;
+    void run() override;
+
+    void pausePlayback();
+    void resumePlayback();
+    bool isFinished() const { return m_finished; }
+
+private:
+    std::vector<Replayer>& m_replayers;
+    std::vector<double> m_sample;
+    std::mutex m_mutex;
+    double m_logStart{0.0};
+    double m_wallStart{0.0};
+    double m_pausedAt{0.0};
+    bool m_paused{false};
+    std::atomic<bool> m_finished{false};
+};
+
 
 class WholeBodyPlayerModule : public yarp::os::RFModule {
 public:
@@ -264,6 +334,8 @@ public:
 
 private:
     std::vector<Replayer> m_replayerVec;
+    std::unique_ptr<ReplayThread> m_replayThread{nullptr};
+    bool m_dataset{false};
     yarp::os::RpcClient   m_rpcPort;
     yarp::os::Bottle reqPause{"pause"}, reqPlay{"play"}, response;
 
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Network.h>
+#include <yarp/os/Portable.h>
+#include <yarp/sig/Vector.h>
+
+#include <iCub/skinDynLib/skinContactList.h>
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "EoProtocolAS.h"
+#include "embObjBattery.h"
+#include "embObjMultipleFTsensors.h"
+#include "perfUtils.h"
+
+// The cost of update(), i.e. of one ROP received by the ethReceiver thread, and of the read paths of the wrappers
+
+namespace
+{
+// not a gmock mock: the cost of the expectations would be timed with the device
+class embObjDevPrivData_Open : public yarp::dev::embObjDevPrivData
+{
+   public:
+	bool isOpen() const override { return true; }
+
+	embObjDevPrivData_Open() : yarp::dev::embObjDevPrivData("perf"){};
+};
+
+class embObjMultipleFTsensors_Perf : public yarp::dev::embObjMultipleFTsensors
+{
+   public:
+	using yarp::dev::embObjMultipleFTsensors::update;
+
+	embObjMultipleFTsensors_Perf(std::shared_ptr<yarp::dev::embObjDevPrivData> device) : yarp::dev::embObjMultipleFTsensors(device){};
+};
+
+class embObjBattery_Perf : public yarp::dev::embObjBattery
+{
+   public:
+	using yarp::dev::embObjBattery::update;
+
+	embObjBattery_Perf(std::shared_ptr<yarp::dev::embObjDevPrivData> device) : yarp::dev::embObjBattery(device){};
+};
+
+iCub::skinDynLib::skinContactList skinContacts()
+{
+	// ten contacts of twenty taxels each, as on a forearm touched in several places
+	iCub::skinDynLib::skinContactList contacts;
+	yarp::sig::Vector cop(3, 0.01);
+	yarp::sig::Vector geo(3, 0.02);
+	std::vector<unsigned int> taxels(20);
+	for (size_t c = 0; c < 10; c++)
+	{
+		for (size_t t = 0; t < taxels.size(); t++)
+			taxels[t] = (unsigned int)(c * 20 + t);
+		contacts.push_back(iCub::skinDynLib::skinContact(iCub::skinDynLib::LEFT_ARM, iCub::skinDynLib::SKIN_LEFT_FOREARM, 4, cop, geo, taxels, 12.5));
+	}
+	return contacts;
+}
+}  // namespace
+
+TEST(PerfMultipleFTsensors, update)
+{
+	yarp::os::Network::init();
+	embObjMultipleFTsensors_Perf device(std::make_shared<embObjDevPrivData_Open>());
+	uint32_t id32 = eoprot_ID_get(eoprot_endpoint_analogsensors, eoprot_entity_as_ft, 0, eoprot_tag_as_ft_status_timedvalue);
+	eOas_ft_timedvalue_t data = {100, 1, 2, 3, {5, 6, 7, 8, 9, 10}};
+	ASSERT_TRUE(device.update(id32, 1, (void *)&data));
+
+	perf::checkPerformance(
+		[&]()
+		{
+			data.age += 1000;
+			device.update(id32, 1, (void *)&data);
+		},
+		10000);
+}
+
+TEST(PerfMultipleFTsensors, getSixAxisForceTorqueSensorMeasure)
+{
+	yarp::os::Network::init();
+	embObjMultipleFTsensors_Perf device(std::make_shared<embObjDevPrivData_Open>());
+	uint32_t id32 = eoprot_ID_get(eoprot_endpoint_analogsensors, eoprot_entity_as_ft, 0, eoprot_tag_as_ft_status_timedvalue);
+	eOas_ft_timedvalue_t data = {100, 1, 2, 3, {5, 6, 7, 8, 9, 10}};
+	device.update(id32, 1, (void *)&data);
+
+	yarp::sig::Vector out(6);
+	double timestamp;
+	ASSERT_TRUE(device.getSixAxisForceTorqueSensorMeasure(0, out, timestamp));
+
+	perf::checkPerformance([&]() { device.getSixAxisForceTorqueSensorMeasure(0, out, timestamp); }, 10000);
+}
+
+TEST(PerfBattery, update)
+{
+	yarp::os::Network::init();
+	embObjBattery_Perf device(std::make_shared<embObjDevPrivData_Open>());
+	uint32_t id32 = eoprot_ID_get(eoprot_endpoint_analogsensors, eoprot_entity_as_battery, 0, eoprot_tag_as_battery_status_timedvalue);
+	eOas_battery_timedvalue_t data = {0 /*age*/, 10 /*temperature in dec C*/, 2, 3, 4, 5, 6};
+	ASSERT_TRUE(device.update(id32, 1, (void *)&data));
+
+	perf::checkPerformance(
+		[&]()
+		{
+			data.age += 1000;
+			device.update(id32, 1, (void *)&data);
+		},
+		10000);
+}
+
+TEST(PerfBattery, getBatterySnapshot)
+{
+	yarp::os::Network::init();
+	embObjBattery_Perf device(std::make_shared<embObjDevPrivData_Open>());
+	iCub::dev::BatterySnapshot snapshot;
+	ASSERT_TRUE(device.getBatterySnapshot(snapshot));
+
+	perf::checkPerformance([&]() { device.getBatterySnapshot(snapshot); }, 10000);
+}
+
+TEST(PerfSkinContactList, roundtrip_bottle)
+{
+	iCub::skinDynLib::skinContactList contacts = skinContacts();
+	iCub::skinDynLib::skinContactList received;
+	ASSERT_TRUE(yarp::os::Portable::copyPortable(contacts, received));
+	ASSERT_EQ(contacts.size(), received.size());
+
+	perf::checkPerformance([&]() { yarp::os::Portable::copyPortable(contacts, received); }, 200);
+}
+
+TEST(PerfSkinContactList, roundtrip_compact)
+{
+	iCub::skinDynLib::skinContactList contacts = skinContacts();
+	contacts.setCompactEncoding(true);
+	iCub::skinDynLib::skinContactList received;
+	ASSERT_TRUE(yarp::os::Portable::copyPortable(contacts, received));
+	ASSERT_EQ(contacts.size(), received.size());
+
+	perf::checkPerformance([&]() { yarp::os::Portable::copyPortable(contacts, received); }, 1000);
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Property.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "eomcParser.h"
+#include "serviceParserCanBattery.h"
+#include "serviceParserMultipleFt.h"
+#include "perfUtils.h"
+
+// The configurations are the ones of multiple-ft.xml and battery.xml, as yarprobotinterface gives them to the devices
+
+namespace
+{
+const char *multipleFtConfig =
+	"(SERVICE (type eomn_serv_AS_ft) "
+	"(PROPERTIES "
+	"(CANBOARDS (type strain2 strain) (PROTOCOL (major 2 1) (minor 0 0)) (FIRMWARE (major 2 1) (minor 0 1) (build 9 3))) "
+	"(SENSORS (id l_foot_ft1 l_foot_ft2 l_foot_ft3) (board strain2 strain2 strain) (location CAN2:13 CAN1:12 CAN2:11))) "
+	"(SETTINGS (enabledSensors l_foot_ft1 l_foot_ft2 l_foot_ft3) (ftPeriod 10 10 10) (temperaturePeriod 1000 1000 0) "
+	"(useCalibration true false true)) "
+	"(CANMONITOR (checkPeriod 100) (reportMode ALL) (ratePeriod 20000)))";
+
+const char *canBatteryConfig =
+	"(SERVICE (type eomn_serv_AS_battery) "
+	"(PROPERTIES "
+	"(CANBOARDS (type bms) (PROTOCOL (major 0) (minor 0)) (FIRMWARE (major 0) (minor 0) (build 0))) "
+	"(SENSORS (id battery1) (board bms) (location CAN2:13))) "
+	"(SETTINGS (enabledSensors battery1) (acquisitionRate 1000)))";
+
+// the groups of a board with four joints that eomc::Parser looks up once per parameter
+const int eomcJoints = 4;
+const char *eomcConfig =
+	"(GENERAL (Gearbox_M2J 100 100 100 100) (Gearbox_E2J 1 1 1 1) (verbose 0)) "
+	"(LIMITS (jntPosMax 90 90 90 90) (jntPosMin -90 -90 -90 -90) (hardwareJntPosMax 100 100 100 100) "
+	"(hardwareJntPosMin -100 -100 -100 -100) (jntVelMax 200 200 200 200) (rotorPosMax 0 0 0 0) (rotorPosMin 0 0 0 0))";
+}  // namespace
+
+TEST(PerfServiceParser, multipleft_parse)
+{
+	yarp::os::Property config(multipleFtConfig);
+	ASSERT_TRUE(ServiceParserMultipleFt().parse(config));
+
+	perf::checkPerformance(
+		[&config]()
+		{
+			ServiceParserMultipleFt parser;
+			parser.parse(config);
+		},
+		200);
+}
+
+TEST(PerfServiceParser, canbattery_parse)
+{
+	yarp::os::Property config(canBatteryConfig);
+	ASSERT_TRUE(ServiceParserCanBattery().parse(config));
+
+	perf::checkPerformance(
+		[&config]()
+		{
+			ServiceParserCanBattery parser;
+			parser.parse(config);
+		},
+		500);
+}
+
+TEST(PerfEomcParser, limits_and_gearbox)
+{
+	yarp::os::Property config(eomcConfig);
+	std::vector<yarp::dev::eomc::jointLimits_t> limits;
+	double m2j[eomcJoints];
+	double e2j[eomcJoints];
+	{
+		yarp::dev::eomc::Parser parser(eomcJoints, "perf");
+		ASSERT_TRUE(parser.parseJointsLimits(config, limits));
+		ASSERT_TRUE(parser.parseGearboxValues(config, m2j, e2j));
+	}
+
+	// a parser per operation, as every device has its own: the index of the config is built every time
+	perf::checkPerformance(
+		[&]()
+		{
+			yarp::dev::eomc::Parser parser(eomcJoints, "perf");
+			parser.parseJointsLimits(config, limits);
+			parser.parseGearboxValues(config, m2j, e2j);
+		},
+		200);
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2026 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#pragma once
+
+// The harness of the performance tests: an operation is timed in several batches, the median time per operation
+// and its spread (MAD) are compared with the ones of the baseline file, and the test fails only if the slowdown is
+// both larger than the tolerance and statistically significant.
+//
+// Environment:
+// - ICUB_PERF_BASELINE    the baseline file (default perf-baseline.txt in the working directory)
+// - ICUB_PERF_UPDATE      if 1 the timings are written to the baseline file instead of being checked
+// - ICUB_PERF_TOLERANCE   the slowdown, relative to the baseline, which is accepted (default 0.10)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace perf
+{
+
+struct Timing
+{
+	double median{0};	// ns per operation
+	double mad{0};		// median absolute deviation of the batches, ns per operation
+	int samples{0};		// the number of batches
+};
+
+class Baseline
+{
+   public:
+	static Baseline &instance()
+	{
+		static Baseline baseline;
+		return baseline;
+	}
+
+	bool updating() const { return update_; }
+	double tolerance() const { return tolerance_; }
+	const std::string &path() const { return path_; }
+
+	bool find(const std::string &name, Timing &timing) const
+	{
+		auto it = timings_.find(name);
+		if (it == timings_.end())
+			return false;
+		timing = it->second;
+		return true;
+	}
+
+	void record(const std::string &name, const Timing &timing)
+	{
+		timings_[name] = timing;
+		dirty_ = true;
+	}
+
+	// the entries which have not been measured again are kept
+	bool save()
+	{
+		if (!update_ || !dirty_)
+			return true;
+
+		std::ofstream file(path_);
+		if (!file)
+			return false;
+
+		file << "# name median_ns mad_ns samples\n";
+		for (const auto &[name, timing] : timings_)
+			file << name << " " << timing.median << " " << timing.mad << " " << timing.samples << "\n";
+		dirty_ = false;
+		return true;
+	}
+
+   private:
+	Baseline()
+	{
+		const char *path = std::getenv("ICUB_PERF_BASELINE");
+		path_ = (path != nullptr && *path != 0) ? path : "perf-baseline.txt";
+
+		const char *update = std::getenv("ICUB_PERF_UPDATE");
+		update_ = (update != nullptr && std::string(update) == "1");
+
+		const char *tolerance = std::getenv("ICUB_PERF_TOLERANCE");
+		if (tolerance != nullptr)
+			tolerance_ = std::atof(tolerance);
+
+		std::ifstream file(path_);
+		std::string line;
+		while (std::getline(file, line))
+		{
+			if (line.empty() || line[0] == '#')
+				continue;
+			std::istringstream ss(line);
+			std::string name;
+			Timing timing;
+			if (ss >> name >> timing.median >> timing.mad >> timing.samples)
+				timings_[name] = timing;
+		}
+	}
+
+	std::string path_;
+	bool update_{false};
+	bool dirty_{false};
+	double tolerance_{0.10};
+	std::map<std::string, Timing> timings_;
+};
+
+inline double median(std::vector<double> values)
+{
+	if (values.empty())
+		return 0;
+	size_t n = values.size() / 2;
+	std::nth_element(values.begin(), values.begin() + n, values.end());
+	double m = values[n];
+	if ((values.size() % 2) == 0)
+		m = (m + *std::max_element(values.begin(), values.begin() + n)) / 2;
+	return m;
+}
+
+// times samples batches of iterations calls of op, after one batch to warm the caches up
+template <class Op>
+Timing measure(Op op, int iterations, int samples = 31)
+{
+	std::vector<double> perop(samples);
+	for (int s = -1; s < samples; s++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++)
+			op();
+		auto end = std::chrono::steady_clock::now();
+		if (s >= 0)
+			perop[s] = std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+	}
+
+	Timing timing;
+	timing.samples = samples;
+	timing.median = median(perop);
+	for (auto &t : perop)
+		t = std::fabs(t - timing.median);
+	timing.mad = median(perop);
+	return timing;
+}
+
+// the slowdown of current over base in standard errors: sigma is estimated as 1.4826*MAD and the standard error of the
+// median of n samples is 1.2533*sigma/sqrt(n)
+inline double significance(const Timing &current, const Timing &base)
+{
+	double diff = current.median - base.median;
+	double se = 1.2533 * 1.4826 * std::sqrt(current.mad * current.mad / current.samples + base.mad * base.mad / base.samples);
+	if (se <= 0)
+		return (diff > 0) ? INFINITY : 0;
+	return diff / se;
+}
+
+constexpr double significanceThreshold = 3.0;
+
+// measures op within the current test and checks it against the baseline with the name of the test
+template <class Op>
+void checkPerformance(Op op, int iterations, int samples = 31)
+{
+	const ::testing::TestInfo *info = ::testing::UnitTest::GetInstance()->current_test_info();
+	std::string name = std::string(info->test_suite_name()) + "." + info->name();
+
+	Timing current = measure(op, iterations, samples);
+	Baseline &baseline = Baseline::instance();
+	::testing::Test::RecordProperty("median_ns", std::to_string(current.median));
+
+	if (baseline.updating())
+	{
+		baseline.record(name, current);
+		std::cout << "[ PERF     ] " << name << " " << current.median << " ns (recorded)" << std::endl;
+		return;
+	}
+
+	Timing base;
+	if (!baseline.find(name, base))
+	{
+		std::cout << "[ PERF     ] " << name << " " << current.median << " ns (no baseline in " << baseline.path() << ")" << std::endl;
+		return;
+	}
+
+	double z = significance(current, base);
+	double slowdown = (base.median > 0) ? current.median / base.median - 1 : 0;
+	std::cout << "[ PERF     ] " << name << " " << current.median << " ns, baseline " << base.median << " ns (" << std::showpos
+			  << 100 * slowdown << std::noshowpos << "%, z=" << z << ")" << std::endl;
+
+	EXPECT_FALSE(slowdown > baseline.tolerance() && z > significanceThreshold)
+		<< name << " is " << 100 * slowdown << "% slower than the baseline (" << current.median << " ns against " << base.median
+		<< " ns, " << z << " standard errors)";
+}
+
+// it writes the baseline file at the end of the run
+class BaselineEnvironment : public ::testing::Environment
+{
+   public:
+	void TearDown() override
+	{
+		if (!Baseline::instance().save())
+			std::cerr << "cannot write the baseline file " << Baseline::instance().path() << std::endl;
+	}
+};
+
+}  // namespace perf
@@ -13,6 +13,7 @@
 #include "EoProtocolAS.h"
 #include "testUtils.h"
 #include "embObjBattery.h"
+#include <iCub/BatterySnapshot.h>
 
 using ::testing::_;
 using ::testing::An;
@@ -221,6 +222,119 @@ TEST(CanBatterysensor, update_simple_negative_001)
     EXPECT_NE(expected, device.canBatteryData_);
 }
 
+TEST(CanBatterysensor, update_sequence_unchanged_001)
+{
+    // Setup
+    yarp::os::Network::init();
+    std::shared_ptr<embObjDevPrivData_Mock> privateData = std::make_shared<embObjDevPrivData_Mock>("test");
+    embObjCanBatterysensor_Mock device(privateData);
+    uint32_t id32First = eoprot_ID_get(eoprot_endpoint_analogsensors, eoprot_entity_as_battery, 0, eoprot_tag_as_ft_status_timedvalue);
+    eOas_battery_timedvalue_t data = {0 /*age*/, 10 /*temperature in dec C*/, 2, 3, 4, 5, 6};
+
+    EXPECT_CALL(*privateData, isOpen()).WillRepeatedly(Return(true));
+    EXPECT_CALL(device, calculateBoardTime(_)).WillOnce(Return(7)).WillOnce(Return(8));
+
+    // Test
+    iCub::dev::BatterySnapshot first;
+    iCub::dev::BatterySnapshot second;
+    EXPECT_TRUE(device.update(id32First, 1, (void *)&data));
+    EXPECT_TRUE(device.getBatterySnapshot(first));
+    EXPECT_TRUE(device.update(id32First, 1, (void *)&data));
+    EXPECT_TRUE(device.getBatterySnapshot(second));
+
+    // only the time stamp has changed
+    EXPECT_EQ(first.sequence, second.sequence);
+    EXPECT_EQ(7, first.stamp);
+    EXPECT_EQ(8, second.stamp);
+}
+
+TEST(CanBatterysensor, update_sequence_changed_001)
+{
+    // Setup
+    yarp::os::Network::init();
+    std::shared_ptr<embObjDevPrivData_Mock> privateData = std::make_shared<embObjDevPrivData_Mock>("test");
+    embObjCanBatterysensor_Mock device(privateData);
+    uint32_t id32First = eoprot_ID_get(eoprot_endpoint_analogsensors, eoprot_entity_as_battery, 0, eoprot_tag_as_ft_status_timedvalue);
+    eOas_battery_timedvalue_t data = {0 /*age*/, 10 /*temperature in dec C*/, 2, 3, 4, 5, 6};
+
+    EXPECT_CALL(*privateData, isOpen()).WillRepeatedly(Return(true));
+    EXPECT_CALL(device, calculateBoardTime(_)).WillRepeatedly(Return(7));
+
+    // Test
+    iCub::dev::BatterySnapshot first;
+    iCub::dev::BatterySnapshot second;
+    EXPECT_TRUE(device.update(id32First, 1, (void *)&data));
+    EXPECT_TRUE(device.getBatterySnapshot(first));
+    data.voltage = 4.5;
+    EXPECT_TRUE(device.update(id32First, 1, (void *)&data));
+    EXPECT_TRUE(device.getBatterySnapshot(second));
+
+    EXPECT_EQ(first.sequence + 1, second.sequence);
+    EXPECT_FLOAT_EQ(4.5, second.voltage);
+}
+
+TEST(CanBatterysensor, getBatterySnapshot_positive_001)
+{
+    // Setup
+    std::shared_ptr<embObjDevPrivData_Mock> privateData = std::make_shared<embObjDevPrivData_Mock>("test");
+    embObjCanBatterysensor_Mock device(privateData);
+
+    device.canBatteryData_ = {1, 2, 3, 4, 5, 6, ""};
+
+    EXPECT_CALL(*privateData, isOpen()).WillRepeatedly(Return(true));
+
+    // Test
+    iCub::dev::BatterySnapshot snapshot;
+    bool ret = device.getBatterySnapshot(snapshot);
+
+    // the same values of the single getters
+    double voltage, current, charge, temperature;
+    IBattery::Battery_status status;
+    device.getBatteryVoltage(voltage);
+    device.getBatteryCurrent(current);
+    device.getBatteryCharge(charge);
+    device.getBatteryTemperature(temperature);
+    device.getBatteryStatus(status);
+
+    EXPECT_TRUE(ret);
+    EXPECT_EQ(2, snapshot.voltage);
+    EXPECT_EQ(3, snapshot.current);
+    EXPECT_EQ(4, snapshot.charge);
+    EXPECT_EQ(1, snapshot.temperature);
+    EXPECT_EQ(5, (int)snapshot.status);
+    EXPECT_EQ(6, snapshot.stamp);
+    EXPECT_EQ(voltage, snapshot.voltage);
+    EXPECT_EQ(current, snapshot.current);
+    EXPECT_EQ(charge, snapshot.charge);
+    EXPECT_EQ(temperature, snapshot.temperature);
+    EXPECT_EQ(status, snapshot.status);
+}
+
+TEST(BatteryPublisher, publish_on_change_001)
+{
+    // Setup
+    yarp::os::Network::init();
+    yarp::os::Network::setLocalMode(true);
+    iCub::dev::BatteryPublisher publisher;
+    iCub::dev::BatterySnapshot snapshot;
+    snapshot.voltage = 24;
+    snapshot.sequence = 3;
+
+    // Test
+    EXPECT_FALSE(publisher.publish(snapshot));  // not open
+    ASSERT_TRUE(publisher.open("/unittest/battery:o", 5.0));
+
+    EXPECT_TRUE(publisher.publish(snapshot));   // the first one
+    EXPECT_FALSE(publisher.publish(snapshot));  // unchanged, within the heartbeat
+    snapshot.stamp = 1;
+    EXPECT_FALSE(publisher.publish(snapshot));  // only the stamp has changed
+    snapshot.sequence++;
+    EXPECT_TRUE(publisher.publish(snapshot));   // changed
+
+    publisher.close();
+    yarp::os::Network::setLocalMode(false);
+}
+
 TEST(CanBatterysensor, getBatteryVoltage_positive_001)
 {
     // Setup
@@ -341,3 +341,71 @@ TEST(MultiplembObjMultipleFTsensor, calculateBoardTime_positive_001)
 
 	EXPECT_DOUBLE_EQ(1.0,diff);
 }
+
+TEST(MultiplembObjMultipleFTsensor, getLatestSensorSamples_double_positive_001)
+{
+	// Setup
+	yarp::os::Network::init();
+	std::shared_ptr<embObjDevPrivData_Mock> privateData = std::make_shared<embObjDevPrivData_Mock>("test");
+	embObjMultipleFTsensor_Mock device(privateData);
+	uint32_t id32First = eoprot_ID_get(eoprot_endpoint_analogsensors, eoprot_entity_as_ft, 0, eoprot_tag_as_ft_status_timedvalue);
+	uint32_t id32Second = eoprot_ID_get(eoprot_endpoint_analogsensors, eoprot_entity_as_ft, 1, eoprot_tag_as_ft_status_timedvalue);
+	eOas_ft_timedvalue_t data = {100, 1, 2, 3, {5, 6, 7, 8, 9, 10}};
+	eOas_ft_timedvalue_t dataSecond = {200, 1, 2, 3, {50, 60, 70, 80, 90, 100}};
+	eOas_ft_timedvalue_t dataNewer = {300, 1, 2, 3, {15, 16, 17, 18, 19, 20}};
+
+	EXPECT_CALL(*privateData, isOpen()).WillRepeatedly(Return(true));
+
+	// Test
+	device.update(id32First, 1, (void *)&data);
+	device.update(id32Second, 1, (void *)&dataSecond);
+	device.update(id32First, 1, (void *)&dataNewer);
+
+	std::vector<eth::SensorSample> samples;
+	bool ret = device.getLatestSensorSamples(samples);
+
+	EXPECT_TRUE(ret);
+	ASSERT_EQ(2, samples.size());
+	EXPECT_EQ(0, samples[0].sensor);
+	EXPECT_EQ(6, samples[0].size);
+	EXPECT_EQ(15, samples[0].values[0]);
+	EXPECT_EQ(20, samples[0].values[5]);
+	EXPECT_EQ(300, samples[0].timestamp);
+	EXPECT_EQ(1, samples[1].sensor);
+	EXPECT_EQ(50, samples[1].values[0]);
+	EXPECT_EQ(200, samples[1].timestamp);
+}
+
+TEST(MultiplembObjMultipleFTsensor, getNewSensorSamples_positive_001)
+{
+	// Setup
+	yarp::os::Network::init();
+	std::shared_ptr<embObjDevPrivData_Mock> privateData = std::make_shared<embObjDevPrivData_Mock>("test");
+	embObjMultipleFTsensor_Mock device(privateData);
+	uint32_t id32First = eoprot_ID_get(eoprot_endpoint_analogsensors, eoprot_entity_as_ft, 0, eoprot_tag_as_ft_status_timedvalue);
+	eOas_ft_timedvalue_t data = {100, 1, 2, 3, {5, 6, 7, 8, 9, 10}};
+	eOas_ft_timedvalue_t dataNewer = {300, 1, 2, 3, {15, 16, 17, 18, 19, 20}};
+
+	EXPECT_CALL(*privateData, isOpen()).WillRepeatedly(Return(true));
+
+	// Test
+	device.update(id32First, 1, (void *)&data);
+	device.update(id32First, 1, (void *)&dataNewer);
+
+	std::vector<eth::SensorSample> samples;
+	uint64_t lost = 1;
+	bool ret = device.getNewSensorSamples(samples, lost);
+
+	EXPECT_TRUE(ret);
+	EXPECT_EQ(0, lost);
+	ASSERT_EQ(2, samples.size());
+	EXPECT_EQ(5, samples[0].values[0]);
+	EXPECT_EQ(100, samples[0].timestamp);
+	EXPECT_EQ(15, samples[1].values[0]);
+	EXPECT_EQ(300, samples[1].timestamp);
+
+	// the samples already read are not given again
+	ret = device.getNewSensorSamples(samples, lost);
+	EXPECT_TRUE(ret);
+	EXPECT_EQ(0, samples.size());
+}